@@ -155,6 +155,8 @@ void Debugger::setIsDebuggerAttached(bool isAttached) {
 }
 
 void Debugger::setEventObserver(EventObserver *observer) {
+  if (observer)
+    impl_->activate();
   eventObserver_ = observer;
 }
 
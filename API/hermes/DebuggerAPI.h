@@ -217,6 +217,8 @@ class Debugger {
   /// and if non-empty, will be executed to determine whether to actually
   /// pause on the breakpoint; only if ToBoolean(condition) is true
   /// and does not throw will the debugger pause on \p breakpoint.
+  /// The condition is compiled once and evaluated without pausing, so a
+  /// condition such as `print(x), false` serves as a logpoint.
   /// \param condition the code to execute to determine whether to break;
   /// if empty, the condition is considered to not be set.
   void setBreakpointCondition(BreakpointID breakpoint, const String &condition);
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "RuntimePool.h"
+
+#include "hermes/Support/OSCompat.h"
+
+#include <cassert>
+#include <deque>
+#include <exception>
+#include <thread>
+
+namespace facebook {
+namespace hermes {
+
+struct RuntimePool::Worker {
+  std::thread thread;
+  /// Guards the queues.
+  std::mutex mtx;
+  /// Tasks any worker may run. The owner takes the oldest, thieves the
+  /// newest.
+  std::deque<Task> tasks;
+  /// Tasks only this worker runs, oldest first.
+  std::deque<Task> pinned;
+  /// The size of pinned, which is read by the worker under the pool's mutex
+  /// before it sleeps.
+  std::atomic<int64_t> numPinned{0};
+  /// The exception the initialization of the runtime threw, if any.
+  std::exception_ptr initError;
+
+  std::atomic<uint64_t> tasksRun{0};
+  std::atomic<uint64_t> tasksStolen{0};
+  std::atomic<uint64_t> tasksFailed{0};
+  std::atomic<uint64_t> busyMicros{0};
+};
+
+RuntimePool::RuntimePool(Config config) {
+  assert(config.numRuntimes > 0 && "A pool needs at least one runtime");
+  for (unsigned i = 0; i < config.numRuntimes; ++i)
+    workers_.push_back(std::make_unique<Worker>());
+  for (unsigned i = 0; i < config.numRuntimes; ++i) {
+    workers_[i]->thread = std::thread([this, i, &config] {
+      if (!config.cpus.empty())
+        ::hermes::oscompat::set_thread_affinity(
+            config.cpus[i % config.cpus.size()]);
+      std::unique_ptr<HermesRuntime> runtime;
+      try {
+        runtime = makeHermesRuntime(config.runtimeConfig);
+        if (config.init)
+          config.init(*runtime);
+      } catch (const jsi::JSError &error) {
+        // The error holds a value of the runtime, which is destroyed.
+        workers_[i]->initError =
+            std::make_exception_ptr(jsi::JSINativeException(error.what()));
+      } catch (...) {
+        workers_[i]->initError = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> lk(mtx_);
+        ++initialized_;
+      }
+      cv_.notify_all();
+      if (workers_[i]->initError)
+        return;
+      workerMain(i, *runtime);
+    });
+  }
+
+  // config is captured by reference, so every thread must be done with it
+  // before this returns.
+  std::exception_ptr initError;
+  {
+    std::unique_lock<std::mutex> lk(mtx_);
+    cv_.wait(lk, [this] { return initialized_ == workers_.size(); });
+  }
+  for (auto &worker : workers_) {
+    if (worker->initError) {
+      initError = worker->initError;
+      break;
+    }
+  }
+  if (initError) {
+    shutdown();
+    std::rethrow_exception(initError);
+  }
+}
+
+RuntimePool::~RuntimePool() {
+  shutdown();
+}
+
+void RuntimePool::shutdown() {
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    if (worker->thread.joinable())
+      worker->thread.join();
+  }
+}
+
+void RuntimePool::submit(Task task) {
+  Worker &worker = *workers_[next_++ % workers_.size()];
+  {
+    std::lock_guard<std::mutex> lk(worker.mtx);
+    worker.tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    ++stealable_;
+  }
+  // Any idle worker can take the task.
+  cv_.notify_one();
+}
+
+void RuntimePool::submitTo(unsigned index, Task task) {
+  assert(index < workers_.size() && "No such runtime");
+  Worker &worker = *workers_[index];
+  {
+    std::lock_guard<std::mutex> lk(worker.mtx);
+    worker.pinned.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    ++worker.numPinned;
+  }
+  // The workers share the condition variable, so wake them all to be sure
+  // the one the task is pinned to sees it.
+  cv_.notify_all();
+}
+
+std::future<void> RuntimePool::evaluatePreparedJavaScript(
+    std::shared_ptr<const jsi::PreparedJavaScript> js) {
+  return run([js](HermesRuntime &rt) {
+    try {
+      rt.evaluatePreparedJavaScript(js);
+    } catch (const jsi::JSError &error) {
+      // The error holds a value of the runtime, which must not escape it.
+      throw jsi::JSINativeException(error.what());
+    }
+  });
+}
+
+RuntimePool::Stats RuntimePool::getStats() const {
+  Stats stats;
+  int64_t pending = stealable_;
+  for (const auto &worker : workers_) {
+    pending += worker->numPinned;
+    RuntimeStats runtimeStats;
+    runtimeStats.tasksRun = worker->tasksRun;
+    runtimeStats.tasksStolen = worker->tasksStolen;
+    runtimeStats.tasksFailed = worker->tasksFailed;
+    runtimeStats.busy = std::chrono::microseconds(worker->busyMicros);
+    stats.runtimes.push_back(runtimeStats);
+  }
+  // The counts are read one after the other, and may be briefly negative.
+  stats.tasksPending = pending > 0 ? pending : 0;
+  return stats;
+}
+
+bool RuntimePool::takeTask(unsigned index, Task &task, bool &stolen) {
+  Worker &worker = *workers_[index];
+  stolen = false;
+  {
+    std::lock_guard<std::mutex> lk(worker.mtx);
+    if (!worker.pinned.empty()) {
+      task = std::move(worker.pinned.front());
+      worker.pinned.pop_front();
+      --worker.numPinned;
+      return true;
+    }
+    if (!worker.tasks.empty()) {
+      task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+      --stealable_;
+      return true;
+    }
+  }
+  if (stealable_ <= 0)
+    return false;
+  // Start with the next worker, so that thieves spread over the victims.
+  for (size_t i = 1, e = workers_.size(); i < e; ++i) {
+    Worker &victim = *workers_[(index + i) % e];
+    std::lock_guard<std::mutex> lk(victim.mtx);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.back());
+      victim.tasks.pop_back();
+      --stealable_;
+      stolen = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+void RuntimePool::workerMain(unsigned index, HermesRuntime &runtime) {
+  Worker &worker = *workers_[index];
+  Task task;
+  bool stolen;
+  for (;;) {
+    if (!takeTask(index, task, stolen)) {
+      std::unique_lock<std::mutex> lk(mtx_);
+      if (stopping_ && stealable_ <= 0 && worker.numPinned <= 0)
+        return;
+      cv_.wait(lk, [this, &worker] {
+        return stopping_ || stealable_ > 0 || worker.numPinned > 0;
+      });
+      continue;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    try {
+      task(runtime);
+    } catch (...) {
+      ++worker.tasksFailed;
+    }
+    task = nullptr;
+    auto busy = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    worker.busyMicros += busy.count();
+    ++worker.tasksRun;
+    if (stolen)
+      ++worker.tasksStolen;
+  }
+}
+
+} // namespace hermes
+} // namespace facebook
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_RUNTIMEPOOL_H
+#define HERMES_RUNTIMEPOOL_H
+
+#include <hermes/hermes.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace facebook {
+namespace hermes {
+
+/// A fixed set of HermesRuntimes, each created, used and destroyed on a
+/// thread of its own, which run the tasks submitted to the pool. Every
+/// runtime has a queue of tasks; a runtime with nothing left in its queue
+/// steals from the queue of another, so a long task doesn't hold back the
+/// tasks queued behind it. Tasks can also be pinned to a runtime, e.g. when
+/// they use state that an earlier task left in it.
+class RuntimePool {
+ public:
+  /// A task may use the runtime it is given until it returns. It must not
+  /// let JSI values escape, as the next task may run on another thread.
+  using Task = std::function<void(HermesRuntime &)>;
+
+  struct Config {
+    /// The number of runtimes, and of threads.
+    unsigned numRuntimes = 1;
+    /// The configuration of each runtime. When the VM is built with
+    /// HERMESVM_SERIALIZE, a DeserializeFile holding the heap of a runtime
+    /// serialized after initialization starts each runtime from it.
+    ::hermes::vm::RuntimeConfig runtimeConfig{};
+    /// Called on the thread of each runtime once it is created, before it
+    /// runs any task, e.g. to load the application bundle.
+    std::function<void(HermesRuntime &)> init{};
+    /// If not empty, the thread of runtime i only runs on CPU
+    /// cpus[i % cpus.size()], where the OS supports it.
+    std::vector<unsigned> cpus{};
+  };
+
+  struct RuntimeStats {
+    /// Tasks this runtime ran, including the stolen ones.
+    uint64_t tasksRun = 0;
+    /// Tasks this runtime took from the queue of another.
+    uint64_t tasksStolen = 0;
+    /// Tasks that threw an exception out of the task.
+    uint64_t tasksFailed = 0;
+    /// The time spent running tasks.
+    std::chrono::microseconds busy{0};
+  };
+
+  struct Stats {
+    /// Tasks submitted that have not started yet.
+    uint64_t tasksPending = 0;
+    /// The stats of each runtime, by index.
+    std::vector<RuntimeStats> runtimes{};
+  };
+
+  /// Create the runtimes, and return once all of them are initialized.
+  /// If the initialization of a runtime throws, the pool is shut down and
+  /// the exception is rethrown.
+  explicit RuntimePool(Config config);
+
+  /// Wait for the tasks submitted to finish, then destroy the runtimes.
+  /// No tasks may be submitted once this has started.
+  ~RuntimePool();
+
+  RuntimePool(const RuntimePool &) = delete;
+  RuntimePool &operator=(const RuntimePool &) = delete;
+
+  /// \return the number of runtimes.
+  unsigned size() const {
+    return workers_.size();
+  }
+
+  /// Run \p task on the first runtime to get to it. An exception thrown out
+  /// of the task is dropped, and counted in tasksFailed.
+  void submit(Task task);
+
+  /// Run \p task on runtime \p index, after the tasks pinned to it before.
+  void submitTo(unsigned index, Task task);
+
+  /// Run \p f on the first runtime to get to it.
+  /// \return the future of its result, or of the exception it throws.
+  template <typename F>
+  auto run(F f)
+      -> std::future<decltype(f(std::declval<HermesRuntime &>()))> {
+    using Result = decltype(f(std::declval<HermesRuntime &>()));
+    auto task =
+        std::make_shared<std::packaged_task<Result(HermesRuntime &)>>(
+            std::move(f));
+    auto future = task->get_future();
+    submit([task](HermesRuntime &rt) { (*task)(rt); });
+    return future;
+  }
+
+  /// Evaluate \p js on the first runtime to get to it. Prepared JavaScript
+  /// is shared by the runtimes, so only its evaluation is repeated.
+  /// \return the future of the completion, or of the JSIException thrown.
+  /// A JS error becomes a JSINativeException with the same message.
+  std::future<void> evaluatePreparedJavaScript(
+      std::shared_ptr<const jsi::PreparedJavaScript> js);
+
+  /// \return the stats of the pool so far.
+  Stats getStats() const;
+
+ private:
+  struct Worker;
+
+  /// Run the tasks of the worker at \p index on \p runtime until the pool
+  /// shuts down.
+  void workerMain(unsigned index, HermesRuntime &runtime);
+
+  /// Take the next task the worker at \p index should run into \p task: a
+  /// task pinned to it, then the oldest task in its queue, then the newest
+  /// in the queue of another worker, in which case \p stolen is set.
+  /// \return whether there was one.
+  bool takeTask(unsigned index, Task &task, bool &stolen);
+
+  /// Let the workers finish the tasks submitted, and join their threads.
+  void shutdown();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  /// Guards stopping_, the count of initialized workers, and the sleep of
+  /// idle workers on cv_.
+  mutable std::mutex mtx_;
+  std::condition_variable cv_;
+  bool stopping_{false};
+  unsigned initialized_{0};
+
+  /// The number of tasks in the unpinned queues. It is incremented after a
+  /// task is queued, so it can be briefly negative.
+  std::atomic<int64_t> stealable_{0};
+  /// Where the next unpinned task is queued.
+  std::atomic<unsigned> next_{0};
+};
+
+} // namespace hermes
+} // namespace facebook
+
+#endif // HERMES_RUNTIMEPOOL_H
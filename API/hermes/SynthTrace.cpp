@@ -92,7 +92,11 @@ SynthTrace::TraceValue SynthTrace::encodeString(const std::string &value) {
 }
 
 const std::string &SynthTrace::decodeString(TraceValue value) const {
-  return stringTable_[reinterpret_cast<uintptr_t>(value.getString())];
+  return stringTable_[decodeStringIndex(value)];
+}
+
+size_t SynthTrace::decodeStringIndex(TraceValue value) {
+  return reinterpret_cast<uintptr_t>(value.getString());
 }
 
 SynthTrace::TraceValue SynthTrace::encodeObject(ObjectID objID) {
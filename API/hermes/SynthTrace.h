@@ -141,13 +141,34 @@ class SynthTrace {
         const SynthTrace &trace) const;
   };
 
+  /// A RecordStream takes each record as it is added to a trace, which
+  /// then doesn't keep it. This lets a long trace be written as it is
+  /// recorded, instead of held in memory until the end.
+  class RecordStream {
+   public:
+    virtual ~RecordStream() = default;
+    /// Take \p rec, whose strings are in the string table of \p trace.
+    virtual void write(const Record &rec, const SynthTrace &trace) = 0;
+  };
+
   explicit SynthTrace(ObjectID globalObjID) : globalObjID_(globalObjID) {}
 
   template <typename T, typename... Args>
   void emplace_back(Args &&... args) {
+    if (stream_) {
+      stream_->write(T(std::forward<Args>(args)...), *this);
+      return;
+    }
     records_.emplace_back(new T(std::forward<Args>(args)...));
   }
 
+  /// Send the records added from now on to \p stream instead of keeping
+  /// them, or keep them again if it is null. The stream must outlive its
+  /// use by the trace.
+  void setRecordStream(RecordStream *stream) {
+    stream_ = stream;
+  }
+
   const std::vector<std::unique_ptr<Record>> &records() const {
     return records_;
   }
@@ -180,6 +201,9 @@ class SynthTrace {
   /// Extracts a string from a trace value.
   /// \pre The value must be a string.
   const std::string &decodeString(TraceValue value) const;
+  /// Extracts the index in the string table of a trace value.
+  /// \pre The value must be a string.
+  static size_t decodeStringIndex(TraceValue value);
 
   static bool equal(TraceValue x, TraceValue y) {
     // We are encoding random numbers into strings, and can't use the library
@@ -202,6 +226,8 @@ class SynthTrace {
   /// strings forever).
   /// Strings are stored in the trace objects as an index into this table.
   ::hermes::StringSetVector stringTable_;
+  /// Where records go instead of records_, if set.
+  RecordStream *stream_{nullptr};
 
  public:
   /// @name Record classes
@@ -0,0 +1,604 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifdef HERMESVM_API_TRACE
+
+#include "SynthTraceBinary.h"
+
+#include "hermes/Support/OSCompat.h"
+
+#include "llvm/Support/Endian.h"
+
+#include <cassert>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace facebook {
+namespace hermes {
+namespace tracing {
+
+using RecordType = SynthTrace::RecordType;
+
+namespace {
+
+constexpr char kMagic[4] = {'H', 'S', 'T', 'B'};
+constexpr uint32_t kBinaryVersion = 1;
+
+/// The tags of the values in a binary trace.
+enum ValueTag : uint8_t {
+  kUndefined,
+  kNull,
+  kFalse,
+  kTrue,
+  kNumber,
+  kObject,
+  /// A string written before, by its index.
+  kStringRef,
+  /// The first appearance of a string: its index, then the string.
+  kStringDef,
+};
+
+} // namespace
+
+BinaryTraceWriter::BinaryTraceWriter(
+    std::unique_ptr<llvm::raw_ostream> os,
+    SynthTrace::ObjectID globalObjID,
+    const ::hermes::vm::RuntimeConfig &conf)
+    : os_(std::move(os)) {
+  chunk_.reserve(kChunkSize);
+  chunk_.append(kMagic, sizeof(kMagic));
+  char version[4];
+  llvm::support::endian::write32le(version, kBinaryVersion);
+  chunk_.append(version, sizeof(version));
+  writeVarint(globalObjID);
+
+  const ::hermes::vm::GCConfig &gcConf = conf.getGCConfig();
+  writeVarint(gcConf.getMinHeapSize());
+  writeVarint(gcConf.getInitHeapSize());
+  writeVarint(gcConf.getMaxHeapSize());
+  writeDouble(gcConf.getOccupancyTarget());
+  writeVarint(gcConf.getEffectiveOOMThreshold());
+  writeByte(gcConf.getShouldReleaseUnused());
+  writeString(gcConf.getName());
+  writeByte(gcConf.getAllocInYoung());
+  writeByte(gcConf.getRevertToYGAtTTI());
+  writeVarint(conf.getMaxNumRegisters());
+  writeByte(conf.getES6Symbol());
+  writeByte(conf.getEnableSampledStats());
+  writeVarint(conf.getVMExperimentFlags());
+
+  writer_ = std::thread([this] { writerMain(); });
+}
+
+BinaryTraceWriter::~BinaryTraceWriter() {
+  if (!finished_)
+    finish(::hermes::vm::MockedEnvironment{});
+}
+
+void BinaryTraceWriter::writeByte(uint8_t byte) {
+  chunk_.push_back(static_cast<char>(byte));
+}
+
+void BinaryTraceWriter::writeVarint(uint64_t value) {
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    writeByte(value ? byte | 0x80 : byte);
+  } while (value);
+}
+
+void BinaryTraceWriter::writeDouble(double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  char bytes[8];
+  llvm::support::endian::write64le(bytes, bits);
+  chunk_.append(bytes, sizeof(bytes));
+}
+
+void BinaryTraceWriter::writeString(llvm::StringRef str) {
+  writeVarint(str.size());
+  chunk_.append(str.data(), str.size());
+}
+
+void BinaryTraceWriter::writeValue(
+    SynthTrace::TraceValue value,
+    const SynthTrace &trace) {
+  if (value.isUndefined()) {
+    writeByte(kUndefined);
+  } else if (value.isNull()) {
+    writeByte(kNull);
+  } else if (value.isBool()) {
+    writeByte(value.getBool() ? kTrue : kFalse);
+  } else if (value.isNumber()) {
+    writeByte(kNumber);
+    writeDouble(value.getNumber());
+  } else if (value.isObject()) {
+    writeByte(kObject);
+    writeVarint(SynthTrace::decodeObject(value));
+  } else {
+    assert(value.isString() && "Unknown trace value");
+    size_t idx = SynthTrace::decodeStringIndex(value);
+    if (idx < stringWritten_.size() && stringWritten_[idx]) {
+      writeByte(kStringRef);
+      writeVarint(idx);
+      return;
+    }
+    if (idx >= stringWritten_.size())
+      stringWritten_.resize(idx + 1);
+    stringWritten_[idx] = true;
+    writeByte(kStringDef);
+    writeVarint(idx);
+    writeString(trace.decodeString(value));
+  }
+}
+
+void BinaryTraceWriter::write(
+    const SynthTrace::Record &rec,
+    const SynthTrace &trace) {
+  assert(!finished_ && "Record written after the end of the trace");
+  // Zero ends the records, so types are written plus one.
+  writeByte(static_cast<uint8_t>(rec.getType()) + 1);
+  writeVarint(rec.time_.count());
+  switch (rec.getType()) {
+    case RecordType::BeginExecJS: {
+      const auto &begin =
+          static_cast<const SynthTrace::BeginExecJSRecord &>(rec);
+      writeString(begin.sourceURL());
+      chunk_.append(
+          reinterpret_cast<const char *>(begin.sourceHash().data()),
+          begin.sourceHash().size());
+      break;
+    }
+    case RecordType::EndExecJS:
+      writeValue(
+          static_cast<const SynthTrace::EndExecJSRecord &>(rec).retVal_, trace);
+      break;
+    case RecordType::Marker:
+      writeString(static_cast<const SynthTrace::MarkerRecord &>(rec).tag_);
+      break;
+    case RecordType::CreateObject:
+    case RecordType::CreateHostObject:
+    case RecordType::CreateHostFunction:
+      writeVarint(
+          static_cast<const SynthTrace::CreateObjectRecord &>(rec).objID_);
+      break;
+    case RecordType::GetProperty:
+    case RecordType::SetProperty: {
+      const auto &prop =
+          static_cast<const SynthTrace::GetOrSetPropertyRecord &>(rec);
+      writeVarint(prop.objID_);
+      writeString(prop.propName_);
+      writeValue(prop.value_, trace);
+      break;
+    }
+    case RecordType::HasProperty: {
+      const auto &has = static_cast<const SynthTrace::HasPropertyRecord &>(rec);
+      writeVarint(has.objID_);
+      writeString(has.propName_);
+      break;
+    }
+    case RecordType::GetPropertyNames: {
+      const auto &names =
+          static_cast<const SynthTrace::GetPropertyNamesRecord &>(rec);
+      writeVarint(names.objID_);
+      writeVarint(names.propNamesID_);
+      break;
+    }
+    case RecordType::CreateArray: {
+      const auto &arr = static_cast<const SynthTrace::CreateArrayRecord &>(rec);
+      writeVarint(arr.objID_);
+      writeVarint(arr.length_);
+      break;
+    }
+    case RecordType::ArrayRead:
+    case RecordType::ArrayWrite: {
+      const auto &elem =
+          static_cast<const SynthTrace::ArrayReadOrWriteRecord &>(rec);
+      writeVarint(elem.objID_);
+      writeVarint(elem.index_);
+      writeValue(elem.value_, trace);
+      break;
+    }
+    case RecordType::CallFromNative:
+    case RecordType::ConstructFromNative:
+    case RecordType::CallToNative: {
+      const auto &call = static_cast<const SynthTrace::CallRecord &>(rec);
+      writeVarint(call.functionID_);
+      writeValue(call.thisArg_, trace);
+      writeVarint(call.args_.size());
+      for (SynthTrace::TraceValue arg : call.args_)
+        writeValue(arg, trace);
+      break;
+    }
+    case RecordType::ReturnFromNative:
+      writeValue(
+          static_cast<const SynthTrace::ReturnFromNativeRecord &>(rec).retVal_,
+          trace);
+      break;
+    case RecordType::ReturnToNative:
+      writeValue(
+          static_cast<const SynthTrace::ReturnToNativeRecord &>(rec).retVal_,
+          trace);
+      break;
+    case RecordType::GetPropertyNative: {
+      const auto &get =
+          static_cast<const SynthTrace::GetPropertyNativeRecord &>(rec);
+      writeVarint(get.hostObjectID_);
+      writeString(get.propName_);
+      break;
+    }
+    case RecordType::GetPropertyNativeReturn:
+      writeValue(
+          static_cast<const SynthTrace::GetPropertyNativeReturnRecord &>(rec)
+              .retVal_,
+          trace);
+      break;
+    case RecordType::SetPropertyNative: {
+      const auto &set =
+          static_cast<const SynthTrace::SetPropertyNativeRecord &>(rec);
+      writeVarint(set.hostObjectID_);
+      writeString(set.propName_);
+      writeValue(set.value_, trace);
+      break;
+    }
+    case RecordType::SetPropertyNativeReturn:
+      break;
+  }
+  if (chunk_.size() >= kChunkSize)
+    flush();
+}
+
+void BinaryTraceWriter::flush() {
+  if (chunk_.empty())
+    return;
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    chunks_.push_back(std::move(chunk_));
+  }
+  cv_.notify_one();
+  chunk_.clear();
+  chunk_.reserve(kChunkSize);
+}
+
+void BinaryTraceWriter::finish(const ::hermes::vm::MockedEnvironment &env) {
+  assert(!finished_ && "Trace finished twice");
+  finished_ = true;
+  writeByte(0);
+  writeVarint(env.mathRandomSeed);
+  writeVarint(env.callsToDateNow.size());
+  for (uint64_t time : env.callsToDateNow)
+    writeVarint(time);
+  writeVarint(env.callsToNewDate.size());
+  for (uint64_t time : env.callsToNewDate)
+    writeVarint(time);
+  writeVarint(env.callsToDateAsFunction.size());
+  for (const std::string &date : env.callsToDateAsFunction)
+    writeString(date);
+  flush();
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    done_ = true;
+  }
+  cv_.notify_one();
+  writer_.join();
+}
+
+void BinaryTraceWriter::writerMain() {
+  for (;;) {
+    std::string chunk;
+    {
+      std::unique_lock<std::mutex> lk(mtx_);
+      cv_.wait(lk, [this] { return done_ || !chunks_.empty(); });
+      if (chunks_.empty())
+        break;
+      chunk = std::move(chunks_.front());
+      chunks_.pop_front();
+    }
+    os_->write(chunk.data(), chunk.size());
+  }
+  os_->flush();
+}
+
+namespace {
+
+/// Reads the parts of a binary trace in order.
+class BinaryTraceReader {
+ public:
+  BinaryTraceReader(const char *begin, const char *end)
+      : cur_(begin), end_(end) {}
+
+  const char *readBytes(size_t n) {
+    if (static_cast<size_t>(end_ - cur_) < n)
+      throw std::invalid_argument("Binary trace is truncated");
+    const char *bytes = cur_;
+    cur_ += n;
+    return bytes;
+  }
+
+  uint8_t readByte() {
+    return static_cast<uint8_t>(*readBytes(1));
+  }
+
+  bool readBool() {
+    return readByte() != 0;
+  }
+
+  uint64_t readVarint() {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = readByte();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return value;
+    }
+    throw std::invalid_argument("Binary trace has an invalid integer");
+  }
+
+  double readDouble() {
+    uint64_t bits = llvm::support::endian::read64le(readBytes(8));
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  std::string readString() {
+    size_t size = readVarint();
+    return std::string(readBytes(size), size);
+  }
+
+  SynthTrace::TraceValue readValue(SynthTrace &trace) {
+    switch (readByte()) {
+      case kUndefined:
+        return SynthTrace::encodeUndefined();
+      case kNull:
+        return SynthTrace::encodeNull();
+      case kFalse:
+        return SynthTrace::encodeBool(false);
+      case kTrue:
+        return SynthTrace::encodeBool(true);
+      case kNumber:
+        return SynthTrace::encodeNumber(readDouble());
+      case kObject:
+        return SynthTrace::encodeObject(readVarint());
+      case kStringRef: {
+        auto it = strings_.find(readVarint());
+        if (it == strings_.end())
+          throw std::invalid_argument("Binary trace uses an unknown string");
+        return it->second;
+      }
+      case kStringDef: {
+        uint64_t idx = readVarint();
+        SynthTrace::TraceValue str = trace.encodeString(readString());
+        strings_.emplace(idx, str);
+        return str;
+      }
+      default:
+        throw std::invalid_argument("Binary trace has an invalid value tag");
+    }
+  }
+
+  std::vector<SynthTrace::TraceValue> readValues(SynthTrace &trace) {
+    std::vector<SynthTrace::TraceValue> values(readVarint());
+    for (auto &value : values)
+      value = readValue(trace);
+    return values;
+  }
+
+ private:
+  const char *cur_;
+  const char *end_;
+  /// The strings of the trace being read, by their index in the trace that
+  /// was written.
+  std::unordered_map<uint64_t, SynthTrace::TraceValue> strings_;
+};
+
+::hermes::vm::RuntimeConfig readRuntimeConfig(BinaryTraceReader &in) {
+  ::hermes::vm::GCConfig::Builder gcconf;
+  gcconf.withMinHeapSize(in.readVarint());
+  gcconf.withInitHeapSize(in.readVarint());
+  gcconf.withMaxHeapSize(in.readVarint());
+  gcconf.withOccupancyTarget(in.readDouble());
+  gcconf.withEffectiveOOMThreshold(in.readVarint());
+  gcconf.withShouldReleaseUnused(
+      static_cast<::hermes::vm::ReleaseUnused>(in.readByte()));
+  gcconf.withName(in.readString());
+  gcconf.withAllocInYoung(in.readBool());
+  gcconf.withRevertToYGAtTTI(in.readBool());
+
+  ::hermes::vm::RuntimeConfig::Builder conf;
+  conf.withGCConfig(gcconf.build());
+  conf.withMaxNumRegisters(in.readVarint());
+  conf.withES6Symbol(in.readBool());
+  conf.withEnableSampledStats(in.readBool());
+  conf.withVMExperimentFlags(in.readVarint());
+  return conf.build();
+}
+
+void readRecords(BinaryTraceReader &in, SynthTrace &trace) {
+  for (uint8_t type; (type = in.readByte()) != 0;) {
+    if (type > static_cast<uint8_t>(RecordType::SetPropertyNativeReturn) + 1)
+      throw std::invalid_argument("Binary trace has an invalid record type");
+    SynthTrace::TimeSinceStart time(in.readVarint());
+    switch (static_cast<RecordType>(type - 1)) {
+      case RecordType::BeginExecJS: {
+        std::string sourceURL = in.readString();
+        ::hermes::SHA1 hash{};
+        std::memcpy(hash.data(), in.readBytes(hash.size()), hash.size());
+        trace.emplace_back<SynthTrace::BeginExecJSRecord>(
+            time, std::move(sourceURL), std::move(hash));
+        break;
+      }
+      case RecordType::EndExecJS:
+        trace.emplace_back<SynthTrace::EndExecJSRecord>(
+            time, in.readValue(trace));
+        break;
+      case RecordType::Marker:
+        trace.emplace_back<SynthTrace::MarkerRecord>(time, in.readString());
+        break;
+      case RecordType::CreateObject:
+        trace.emplace_back<SynthTrace::CreateObjectRecord>(
+            time, in.readVarint());
+        break;
+      case RecordType::CreateHostObject:
+        trace.emplace_back<SynthTrace::CreateHostObjectRecord>(
+            time, in.readVarint());
+        break;
+      case RecordType::CreateHostFunction:
+        trace.emplace_back<SynthTrace::CreateHostFunctionRecord>(
+            time, in.readVarint());
+        break;
+      case RecordType::GetProperty: {
+        SynthTrace::ObjectID objID = in.readVarint();
+        std::string propName = in.readString();
+        trace.emplace_back<SynthTrace::GetPropertyRecord>(
+            time, objID, propName, in.readValue(trace));
+        break;
+      }
+      case RecordType::SetProperty: {
+        SynthTrace::ObjectID objID = in.readVarint();
+        std::string propName = in.readString();
+        trace.emplace_back<SynthTrace::SetPropertyRecord>(
+            time, objID, propName, in.readValue(trace));
+        break;
+      }
+      case RecordType::HasProperty: {
+        SynthTrace::ObjectID objID = in.readVarint();
+        trace.emplace_back<SynthTrace::HasPropertyRecord>(
+            time, objID, in.readString());
+        break;
+      }
+      case RecordType::GetPropertyNames: {
+        SynthTrace::ObjectID objID = in.readVarint();
+        trace.emplace_back<SynthTrace::GetPropertyNamesRecord>(
+            time, objID, in.readVarint());
+        break;
+      }
+      case RecordType::CreateArray: {
+        SynthTrace::ObjectID objID = in.readVarint();
+        trace.emplace_back<SynthTrace::CreateArrayRecord>(
+            time, objID, in.readVarint());
+        break;
+      }
+      case RecordType::ArrayRead: {
+        SynthTrace::ObjectID objID = in.readVarint();
+        size_t index = in.readVarint();
+        trace.emplace_back<SynthTrace::ArrayReadRecord>(
+            time, objID, index, in.readValue(trace));
+        break;
+      }
+      case RecordType::ArrayWrite: {
+        SynthTrace::ObjectID objID = in.readVarint();
+        size_t index = in.readVarint();
+        trace.emplace_back<SynthTrace::ArrayWriteRecord>(
+            time, objID, index, in.readValue(trace));
+        break;
+      }
+      case RecordType::CallFromNative: {
+        SynthTrace::ObjectID funcID = in.readVarint();
+        SynthTrace::TraceValue thisArg = in.readValue(trace);
+        trace.emplace_back<SynthTrace::CallFromNativeRecord>(
+            time, funcID, thisArg, in.readValues(trace));
+        break;
+      }
+      case RecordType::ConstructFromNative: {
+        SynthTrace::ObjectID funcID = in.readVarint();
+        SynthTrace::TraceValue thisArg = in.readValue(trace);
+        trace.emplace_back<SynthTrace::ConstructFromNativeRecord>(
+            time, funcID, thisArg, in.readValues(trace));
+        break;
+      }
+      case RecordType::CallToNative: {
+        SynthTrace::ObjectID funcID = in.readVarint();
+        SynthTrace::TraceValue thisArg = in.readValue(trace);
+        trace.emplace_back<SynthTrace::CallToNativeRecord>(
+            time, funcID, thisArg, in.readValues(trace));
+        break;
+      }
+      case RecordType::ReturnFromNative:
+        trace.emplace_back<SynthTrace::ReturnFromNativeRecord>(
+            time, in.readValue(trace));
+        break;
+      case RecordType::ReturnToNative:
+        trace.emplace_back<SynthTrace::ReturnToNativeRecord>(
+            time, in.readValue(trace));
+        break;
+      case RecordType::GetPropertyNative: {
+        SynthTrace::ObjectID hostObjID = in.readVarint();
+        trace.emplace_back<SynthTrace::GetPropertyNativeRecord>(
+            time, hostObjID, in.readString());
+        break;
+      }
+      case RecordType::GetPropertyNativeReturn:
+        trace.emplace_back<SynthTrace::GetPropertyNativeReturnRecord>(
+            time, in.readValue(trace));
+        break;
+      case RecordType::SetPropertyNative: {
+        SynthTrace::ObjectID hostObjID = in.readVarint();
+        std::string propName = in.readString();
+        trace.emplace_back<SynthTrace::SetPropertyNativeRecord>(
+            time, hostObjID, propName, in.readValue(trace));
+        break;
+      }
+      case RecordType::SetPropertyNativeReturn:
+        trace.emplace_back<SynthTrace::SetPropertyNativeReturnRecord>(time);
+        break;
+    }
+  }
+}
+
+::hermes::vm::MockedEnvironment readMockedEnvironment(BinaryTraceReader &in) {
+  auto seed = static_cast<std::minstd_rand::result_type>(in.readVarint());
+  std::deque<uint64_t> callsToDateNow(in.readVarint());
+  for (uint64_t &time : callsToDateNow)
+    time = in.readVarint();
+  std::deque<uint64_t> callsToNewDate(in.readVarint());
+  for (uint64_t &time : callsToNewDate)
+    time = in.readVarint();
+  std::deque<std::string> callsToDateAsFunction(in.readVarint());
+  for (std::string &date : callsToDateAsFunction)
+    date = in.readString();
+  return ::hermes::vm::MockedEnvironment(
+      seed, callsToDateNow, callsToNewDate, callsToDateAsFunction);
+}
+
+} // namespace
+
+bool isBinarySynthTrace(const llvm::MemoryBuffer &buf) {
+  return buf.getBufferSize() >= sizeof(kMagic) &&
+      std::memcmp(buf.getBufferStart(), kMagic, sizeof(kMagic)) == 0;
+}
+
+std::tuple<
+    SynthTrace,
+    ::hermes::vm::RuntimeConfig,
+    ::hermes::vm::MockedEnvironment>
+parseBinarySynthTrace(const llvm::MemoryBuffer &buf) {
+  if (!isBinarySynthTrace(buf))
+    throw std::invalid_argument("Not a binary trace");
+  BinaryTraceReader in(buf.getBufferStart(), buf.getBufferEnd());
+  in.readBytes(sizeof(kMagic));
+  uint32_t version = llvm::support::endian::read32le(in.readBytes(4));
+  if (version != kBinaryVersion) {
+    throw std::invalid_argument(
+        "Binary trace version mismatch, expected " +
+        ::hermes::oscompat::to_string(kBinaryVersion) +
+        ", actual: " + ::hermes::oscompat::to_string(version));
+  }
+  SynthTrace trace(in.readVarint());
+  ::hermes::vm::RuntimeConfig conf = readRuntimeConfig(in);
+  readRecords(in, trace);
+  ::hermes::vm::MockedEnvironment env = readMockedEnvironment(in);
+  return std::make_tuple(std::move(trace), std::move(conf), std::move(env));
+}
+
+} // namespace tracing
+} // namespace hermes
+} // namespace facebook
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SYNTHTRACEBINARY_H
+#define HERMES_SYNTHTRACEBINARY_H
+
+#ifdef HERMESVM_API_TRACE
+
+#include "hermes/Public/RuntimeConfig.h"
+#include "hermes/SynthTrace.h"
+#include "hermes/VM/MockedEnvironment.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace facebook {
+namespace hermes {
+namespace tracing {
+
+/// The binary trace format is a compact alternative to the JSON one, which
+/// can be written as the trace is recorded instead of at the end:
+///   "HSTB" version:u32 globalObjID:varint runtimeConfig
+///   (type:u8 time:varint fields)* 0:u8 env
+/// Integers are LEB128 varints unless noted, doubles are 8 little-endian
+/// bytes, and strings are a length followed by their bytes. A value is a
+/// tag byte and its payload. String values are numbered in the order they
+/// first appear, and only their first appearance includes the string.
+class BinaryTraceWriter final : public SynthTrace::RecordStream {
+ public:
+  /// The size at which a chunk of encoded records is handed to the thread
+  /// that writes them out.
+  static constexpr size_t kChunkSize = 64 * 1024;
+
+  /// Write the header of the trace of a runtime with \p conf and global
+  /// object \p globalObjID to \p os, and start the thread writing to it.
+  BinaryTraceWriter(
+      std::unique_ptr<llvm::raw_ostream> os,
+      SynthTrace::ObjectID globalObjID,
+      const ::hermes::vm::RuntimeConfig &conf);
+
+  /// Finish the trace with an empty environment if finish() was not called.
+  ~BinaryTraceWriter() override;
+
+  BinaryTraceWriter(const BinaryTraceWriter &) = delete;
+  BinaryTraceWriter &operator=(const BinaryTraceWriter &) = delete;
+
+  /// Encode \p rec, whose strings are in the string table of \p trace.
+  void write(const SynthTrace::Record &rec, const SynthTrace &trace) override;
+
+  /// Hand the records encoded so far to the writer thread.
+  void flush();
+
+  /// Write the end of the records and \p env, and wait until all of the
+  /// trace is written. No records may be written after this.
+  void finish(const ::hermes::vm::MockedEnvironment &env);
+
+ private:
+  void writeByte(uint8_t byte);
+  void writeVarint(uint64_t value);
+  void writeDouble(double value);
+  void writeString(llvm::StringRef str);
+  void writeValue(SynthTrace::TraceValue value, const SynthTrace &trace);
+
+  /// Write the chunks handed over to os_ until finish() is called.
+  void writerMain();
+
+  std::unique_ptr<llvm::raw_ostream> os_;
+  /// The chunk being encoded on the thread of the runtime.
+  std::string chunk_;
+  /// Which entries of the string table of the trace were written.
+  std::vector<bool> stringWritten_;
+  bool finished_{false};
+
+  /// Guards chunks_ and done_.
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::deque<std::string> chunks_;
+  bool done_{false};
+  std::thread writer_;
+};
+
+/// \return whether \p buf starts like a binary trace.
+bool isBinarySynthTrace(const llvm::MemoryBuffer &buf);
+
+/// Parse a binary trace stored in \p buf.
+/// \throws invalid_argument if it is not a valid binary trace.
+std::tuple<
+    SynthTrace,
+    ::hermes::vm::RuntimeConfig,
+    ::hermes::vm::MockedEnvironment>
+parseBinarySynthTrace(const llvm::MemoryBuffer &buf);
+
+} // namespace tracing
+} // namespace hermes
+} // namespace facebook
+
+#endif // HERMESVM_API_TRACE
+
+#endif // HERMES_SYNTHTRACEBINARY_H
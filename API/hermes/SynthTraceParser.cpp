@@ -8,6 +8,7 @@
 #ifdef HERMESVM_API_TRACE
 
 #include "hermes/SynthTraceParser.h"
+#include "hermes/SynthTraceBinary.h"
 
 #include "hermes/Parser/JSLexer.h"
 #include "hermes/Parser/JSONParser.h"
@@ -369,6 +370,9 @@ std::tuple<
     ::hermes::vm::RuntimeConfig,
     ::hermes::vm::MockedEnvironment>
 parseSynthTrace(std::unique_ptr<llvm::MemoryBuffer> trace) {
+  if (isBinarySynthTrace(*trace)) {
+    return parseBinarySynthTrace(*trace);
+  }
   JSLexer::Allocator alloc;
   JSONObject *root = llvm::cast<JSONObject>(parseJSON(alloc, std::move(trace)));
   if (!llvm::dyn_cast_or_null<JSONNumber>(root->get("globalObjID"))) {
@@ -20,14 +20,16 @@ namespace facebook {
 namespace hermes {
 namespace tracing {
 
-/// Parse a trace from a JSON string stored in a MemoryBuffer.
+/// Parse a trace from a JSON string, or a binary trace, stored in a
+/// MemoryBuffer.
 std::tuple<
     SynthTrace,
     ::hermes::vm::RuntimeConfig,
     ::hermes::vm::MockedEnvironment>
 parseSynthTrace(std::unique_ptr<llvm::MemoryBuffer> trace);
 
-/// Parse a trace from a JSON string stored in the given file name.
+/// Parse a trace from a JSON string, or a binary trace, stored in the given
+/// file name.
 std::tuple<
     SynthTrace,
     ::hermes::vm::RuntimeConfig,
@@ -373,6 +373,22 @@ TracingHermesRuntime::TracingHermesRuntime(
     const ::hermes::vm::RuntimeConfig &runtimeConfig)
     : TracingRuntime(std::move(runtime), globalID), conf_(runtimeConfig) {}
 
+TracingHermesRuntime::~TracingHermesRuntime() {
+  if (binaryWriter_) {
+    binaryWriter_->finish(hermesRuntime().getMockedEnvironment());
+    trace().setRecordStream(nullptr);
+  }
+}
+
+void TracingHermesRuntime::streamBinaryTrace(
+    std::unique_ptr<llvm::raw_ostream> os) {
+  assert(!binaryWriter_ && "The trace is already streamed");
+  assert(trace().records().empty() && "Records would be missing");
+  binaryWriter_ = std::make_unique<BinaryTraceWriter>(
+      std::move(os), trace().globalObjID(), conf_);
+  trace().setRecordStream(binaryWriter_.get());
+}
+
 void TracingHermesRuntime::writeTrace(llvm::raw_ostream &os) const {
   os << SynthTrace::Printable(
       trace(), hermesRuntime().getMockedEnvironment(), conf_);
@@ -442,6 +458,17 @@ std::unique_ptr<TracingHermesRuntime> makeTracingHermesRuntime(
   return ret;
 }
 
+std::unique_ptr<TracingHermesRuntime> makeTracingHermesRuntime(
+    std::unique_ptr<HermesRuntime> hermesRuntime,
+    const ::hermes::vm::RuntimeConfig &runtimeConfig,
+    std::unique_ptr<llvm::raw_ostream> traceStream) {
+  auto ret = std::make_unique<TracingHermesRuntime>(
+      std::move(hermesRuntime), runtimeConfig);
+  ret->streamBinaryTrace(std::move(traceStream));
+  addRecordMarker(*ret);
+  return ret;
+}
+
 } // namespace tracing
 } // namespace hermes
 } // namespace facebook
@@ -11,6 +11,7 @@
 #ifdef HERMESVM_API_TRACE
 
 #include "SynthTrace.h"
+#include "SynthTraceBinary.h"
 
 #include <hermes/hermes.h>
 #include <jsi/decorator.h>
@@ -125,6 +126,14 @@ class TracingHermesRuntime final : public TracingRuntime {
       std::unique_ptr<HermesRuntime> runtime,
       const ::hermes::vm::RuntimeConfig &runtimeConfig);
 
+  /// Finishes the binary trace being streamed, if any.
+  ~TracingHermesRuntime() override;
+
+  /// Write the records from now on as a binary trace to \p os, on a thread
+  /// of its own, instead of keeping them for writeTrace. The trace ends with
+  /// the mocked environment when the runtime is destroyed.
+  void streamBinaryTrace(std::unique_ptr<llvm::raw_ostream> os);
+
   SynthTrace::ObjectID getUniqueID(const jsi::Object &o) override {
     return static_cast<SynthTrace::ObjectID>(hermesRuntime().getUniqueID(o));
   }
@@ -160,12 +169,22 @@ class TracingHermesRuntime final : public TracingRuntime {
       const ::hermes::vm::RuntimeConfig &runtimeConfig);
 
   const ::hermes::vm::RuntimeConfig conf_;
+  /// Writes the records, if the trace is streamed.
+  std::unique_ptr<BinaryTraceWriter> binaryWriter_;
 };
 
 std::unique_ptr<TracingHermesRuntime> makeTracingHermesRuntime(
     std::unique_ptr<HermesRuntime> hermesRuntime,
     const ::hermes::vm::RuntimeConfig &runtimeConfig);
 
+/// Make a runtime that streams its trace to \p traceStream in the binary
+/// format, which costs less to record than the JSON one and holds no
+/// records in memory.
+std::unique_ptr<TracingHermesRuntime> makeTracingHermesRuntime(
+    std::unique_ptr<HermesRuntime> hermesRuntime,
+    const ::hermes::vm::RuntimeConfig &runtimeConfig,
+    std::unique_ptr<llvm::raw_ostream> traceStream);
+
 } // namespace tracing
 } // namespace hermes
 } // namespace facebook
@@ -38,12 +38,15 @@
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
 #include "hermes/VM/JSLib/RuntimeJSONUtils.h"
 #include "hermes/VM/Operations.h"
+#include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/Profiler/SamplingProfiler.h"
 #include "hermes/VM/Runtime.h"
+#include "hermes/VM/StorageProvider.h"
 #include "hermes/VM/StringPrimitive.h"
 #include "hermes/VM/StringView.h"
 #include "hermes/VM/TimeLimitMonitor.h"
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Support/ConvertUTF.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
@@ -52,7 +55,6 @@
 
 #include <atomic>
 #include <limits>
-#include <list>
 #include <mutex>
 #include <system_error>
 
@@ -153,6 +155,18 @@ void raw_ostream_append(llvm::raw_ostream &os, Arg0 &&arg0, Args &&... args) {
   raw_ostream_append(os, args...);
 }
 
+/// \return \p view encoded as UTF-8. ASCII strings already are, so they are
+/// copied as they are instead of being widened to UTF-16 first.
+std::string viewToStdString(const vm::StringView &view) {
+  if (view.isASCII())
+    return std::string(view.castToCharPtr(), view.length());
+  vm::SmallU16String<32> allocator;
+  std::string ret;
+  ::hermes::convertUTF16ToUTF8WithReplacements(
+      ret, view.getUTF16Ref(allocator));
+  return ret;
+}
+
 template <typename... Args>
 jsi::JSError makeJSError(jsi::Runtime &rt, Args &&... args) {
   std::string s;
@@ -227,7 +241,9 @@ class StackRuntime {
 
     llvm::Optional<::hermes::vm::StackRuntime> rt;
 
-    stack->provider_ = vm::StorageProvider::mmapProvider();
+    stack->provider_ = config.getPooledStorage()
+        ? vm::StorageProvider::pooledProvider(config.getHugePages())
+        : vm::StorageProvider::mmapProvider(config.getHugePages());
     stack->runtime_ = &rt;
     stack->startup_.set_value();
     stack->shutdown_.get_future().wait();
@@ -259,8 +275,6 @@ class HermesRuntimeImpl final : public HermesRuntime,
                                 private InstallHermesFatalErrorHandler,
                                 private jsi::Instrumentation {
  public:
-  static constexpr int64_t kSentinelNativeValue = 0x6ef71fe1;
-
   HermesRuntimeImpl(const vm::RuntimeConfig &runtimeConfig)
       :
 #ifdef HERMESJSI_ON_STACK
@@ -276,6 +290,9 @@ class HermesRuntimeImpl final : public HermesRuntime,
 #endif
         crashMgr_(runtimeConfig.getCrashMgr()) {
     compileFlags_.optimize = false;
+    // Time limits and interrupts are taken at the async break checks.
+    compileFlags_.emitAsyncBreakCheck = true;
+    compileFlags_.lazyCacheDir = runtimeConfig.getLazyCacheDir();
 #ifdef HERMES_ENABLE_DEBUGGER
     compileFlags_.debug = true;
 #endif
@@ -286,27 +303,18 @@ class HermesRuntimeImpl final : public HermesRuntime,
 #endif
     runtime_.addCustomRootsFunction(
         [this](vm::GC *, vm::SlotAcceptor &acceptor) {
-          for (auto it = hermesValues_->begin(); it != hermesValues_->end();) {
-            if (it->get() == 0) {
-              it = hermesValues_->erase(it);
-            } else {
-              acceptor.accept(const_cast<vm::PinnedHermesValue &>(it->phv));
-              ++it;
-            }
-          }
+          hermesValues_.forEach([&acceptor](HermesPointerValue &value) {
+            acceptor.accept(const_cast<vm::PinnedHermesValue &>(value.phv));
+          });
+          for (PropNameCacheEntry &entry : propNameCache_)
+            entry.mark(acceptor);
         });
     runtime_.addCustomWeakRootsFunction(
         [this](vm::GC *, vm::WeakRefAcceptor &acceptor) {
-          for (auto it = weakHermesValues_->begin();
-               it != weakHermesValues_->end();) {
-            if (it->get() == 0) {
-              it = weakHermesValues_->erase(it);
-            } else {
-              acceptor.accept(
-                  const_cast<vm::WeakRef<vm::HermesValue> &>(it->wr));
-              ++it;
-            }
-          }
+          weakHermesValues_.forEach([&acceptor](WeakRefPointerValue &value) {
+            acceptor.accept(
+                const_cast<vm::WeakRef<vm::HermesValue> &>(value.wr));
+          });
         });
   }
 
@@ -404,13 +412,11 @@ class HermesRuntimeImpl final : public HermesRuntime,
   T add(::hermes::vm::HermesValue hv) {
     static_assert(
         std::is_base_of<jsi::Pointer, T>::value, "this type cannot be added");
-    hermesValues_->emplace_front(hv);
-    return make<T>(&(hermesValues_->front()));
+    return make<T>(&hermesValues_.add(hv));
   }
 
   jsi::WeakObject addWeak(::hermes::vm::WeakRef<vm::HermesValue> wr) {
-    weakHermesValues_->emplace_front(wr);
-    return make<jsi::WeakObject>(&(weakHermesValues_->front()));
+    return make<jsi::WeakObject>(&weakHermesValues_.add(wr));
   }
 
   // overriden from jsi::Instrumentation
@@ -483,6 +489,43 @@ class HermesRuntimeImpl final : public HermesRuntime,
 
 #undef BRIDGE_GEN_INFO
 
+    jsInfo["hermes_yg_promotedBytes"] = info.youngGenStats.promotedBytes.sum();
+
+    // The times of the phases of collections are in microseconds, and their
+    // histograms are keyed by the upper limit, in microseconds, of each
+    // non-empty bucket.
+    auto bridgePhaseInfo =
+        [&jsInfo](
+            const std::string &prefix,
+            const std::array<vm::GCBase::PhaseHistogram, vm::kNumGCPhases>
+                &phaseTimes) {
+          using Histogram = vm::GCBase::PhaseHistogram;
+          for (unsigned i = 0; i < vm::kNumGCPhases; ++i) {
+            const Histogram &hist = phaseTimes[i];
+            if (hist.wallTime.count() == 0) {
+              continue;
+            }
+            const std::string name =
+                prefix + vm::gcPhaseName(static_cast<vm::GCPhase>(i));
+            jsInfo[name + "Time"] = hist.wallTime.sum() * 1e6;
+            jsInfo[name + "MaxTime"] = hist.wallTime.max() * 1e6;
+            jsInfo[name + "CPUTime"] = hist.cpuTime.sum() * 1e6;
+            for (unsigned b = 0; b < Histogram::kNumBuckets; ++b) {
+              if (hist.buckets[b] == 0) {
+                continue;
+              }
+              // The last bucket is unbounded: key it by its lower limit.
+              const bool last = b == Histogram::kNumBuckets - 1;
+              const auto limitUs = static_cast<int64_t>(
+                  Histogram::bucketLimitSecs(last ? b - 1 : b) * 1e6);
+              jsInfo[name + (last ? "TimeAtLeast" : "TimeBelow") +
+                     std::to_string(limitUs)] = hist.buckets[b];
+            }
+          }
+        };
+    bridgePhaseInfo("hermes_full_", info.fullStats.phaseTimes);
+    bridgePhaseInfo("hermes_yg_", info.youngGenStats.phaseTimes);
+
     return jsInfo;
   }
 
@@ -697,6 +740,38 @@ class HermesRuntimeImpl final : public HermesRuntime,
       jsi::Object &,
       const jsi::String &name,
       const jsi::Value &value) override;
+  jsi::Object createIndexedHostObject(std::shared_ptr<IndexedHostObject> ho);
+  void setInterruptHandler(std::function<void(HermesRuntime &)> handler);
+  jsi::ArrayBuffer createExternalArrayBuffer(
+      uint8_t *data,
+      size_t size,
+      std::function<void()> release);
+  template <typename T>
+  jsi::String createExternalString(
+      const T *chars,
+      size_t length,
+      std::function<void()> release);
+  void getProperties(
+      const jsi::Object &obj,
+      const jsi::PropNameID *names,
+      size_t count,
+      jsi::Value *values);
+  void setProperties(
+      jsi::Object &obj,
+      const jsi::PropNameID *names,
+      const jsi::Value *values,
+      size_t count);
+
+  /// Get the property \p name of \p obj, through propNameCache_.
+  vm::CallResult<vm::HermesValue> getNamedOrIndexedCached(
+      vm::Handle<vm::JSObject> obj,
+      vm::SymbolID name);
+  /// Set the property \p name of \p obj to \p value, through
+  /// propNameCache_, throwing on failure.
+  vm::ExecutionStatus putNamedOrIndexedCached(
+      vm::Handle<vm::JSObject> obj,
+      vm::SymbolID name,
+      const jsi::Value &value);
   bool isArray(const jsi::Object &) const override;
   bool isArrayBuffer(const jsi::Object &) const override;
   bool isFunction(const jsi::Object &) const override;
@@ -754,15 +829,22 @@ class HermesRuntimeImpl final : public HermesRuntime,
 
   struct JsiProxy final : public JsiProxyBase {
     using JsiProxyBase::JsiProxyBase;
-    vm::CallResult<vm::HermesValue> get(vm::SymbolID id) override {
-      auto &stats = rt_.runtime_.getRuntimeStats();
-      const vm::instrumentation::RAIITimer timer{
-          "HostObject.get", stats, stats.hostFunction};
-      jsi::PropNameID sym =
-          rt_.add<jsi::PropNameID>(vm::HermesValue::encodeSymbolValue(id));
-      jsi::Value ret;
+
+    JsiProxy(HermesRuntimeImpl &rt, std::shared_ptr<IndexedHostObject> ho)
+        : JsiProxyBase(rt, ho),
+          indexed_(ho.get()),
+          indexedNames_(ho->getIndexedPropertyNames(rt)) {
+      // The first of duplicate names wins.
+      for (unsigned i = 0, e = indexedNames_.size(); i < e; ++i)
+        indexOf_.insert({phv(indexedNames_[i]).getSymbol(), i});
+    }
+
+    /// Call \p f, turning a C++ exception it throws into a JS exception
+    /// thrown by HostObject::\p method.
+    template <typename T, typename F>
+    vm::CallResult<T> rethrowAsJS(const char *method, const F &f) {
       try {
-        ret = ho_->get(rt_, sym);
+        return f();
       } catch (const jsi::JSError &error) {
         return rt_.runtime_.setThrownValue(hvFromValue(error.value()));
       } catch (const std::exception &ex) {
@@ -771,43 +853,61 @@ class HermesRuntimeImpl final : public HermesRuntime,
                             .getPropertyAsFunction(rt_, "Error")
                             .call(
                                 rt_,
-                                std::string("Exception in HostObject::get: ") +
-                                    ex.what())));
+                                std::string("Exception in HostObject::") +
+                                    method + ": " + ex.what())));
       } catch (...) {
         return rt_.runtime_.setThrownValue(hvFromValue(
             rt_.global()
                 .getPropertyAsFunction(rt_, "Error")
-                .call(rt_, "Exception in HostObject::get: <unknown>")));
+                .call(
+                    rt_,
+                    std::string("Exception in HostObject::") + method +
+                        ": <unknown>")));
       }
+    }
 
-      return hvFromValue(ret);
+    /// \return the index of \p id in the indexed property names, if it is
+    /// one of them.
+    llvm::Optional<unsigned> indexOf(vm::SymbolID id) const {
+      if (!indexed_)
+        return llvm::None;
+      auto it = indexOf_.find(id);
+      if (it == indexOf_.end())
+        return llvm::None;
+      return it->second;
+    }
+
+    vm::CallResult<vm::HermesValue> get(vm::SymbolID id) override {
+      if (auto index = indexOf(id)) {
+        return rethrowAsJS<vm::HermesValue>("get", [&] {
+          return hvFromValue(indexed_->getIndexed(rt_, *index));
+        });
+      }
+      auto &stats = rt_.runtime_.getRuntimeStats();
+      const vm::instrumentation::RAIITimer timer{
+          "HostObject.get", stats, stats.hostFunction};
+      jsi::PropNameID sym =
+          rt_.add<jsi::PropNameID>(vm::HermesValue::encodeSymbolValue(id));
+      return rethrowAsJS<vm::HermesValue>(
+          "get", [&] { return hvFromValue(ho_->get(rt_, sym)); });
     }
 
     vm::CallResult<bool> set(vm::SymbolID id, vm::HermesValue value) override {
+      if (auto index = indexOf(id)) {
+        return rethrowAsJS<bool>("set", [&] {
+          indexed_->setIndexed(rt_, *index, rt_.valueFromHermesValue(value));
+          return true;
+        });
+      }
       auto &stats = rt_.runtime_.getRuntimeStats();
       const vm::instrumentation::RAIITimer timer{
           "HostObject.set", stats, stats.hostFunction};
       jsi::PropNameID sym =
           rt_.add<jsi::PropNameID>(vm::HermesValue::encodeSymbolValue(id));
-      try {
+      return rethrowAsJS<bool>("set", [&] {
         ho_->set(rt_, sym, rt_.valueFromHermesValue(value));
-      } catch (const jsi::JSError &error) {
-        return rt_.runtime_.setThrownValue(hvFromValue(error.value()));
-      } catch (const std::exception &ex) {
-        return rt_.runtime_.setThrownValue(
-            hvFromValue(rt_.global()
-                            .getPropertyAsFunction(rt_, "Error")
-                            .call(
-                                rt_,
-                                std::string("Exception in HostObject::set: ") +
-                                    ex.what())));
-      } catch (...) {
-        return rt_.runtime_.setThrownValue(hvFromValue(
-            rt_.global()
-                .getPropertyAsFunction(rt_, "Error")
-                .call(rt_, "Exception in HostObject::set: <unknown>")));
-      }
-      return true;
+        return true;
+      });
     }
 
     vm::CallResult<vm::Handle<vm::JSArray>> getHostPropertyNames() override {
@@ -853,6 +953,15 @@ class HermesRuntimeImpl final : public HermesRuntime,
                     "Exception in HostObject::getPropertyNames: <unknown>")));
       }
     };
+
+    /// Set if ho_ is an IndexedHostObject, whose indexed properties are
+    /// dispatched to by index, without timing the call or creating a
+    /// PropNameID.
+    IndexedHostObject *const indexed_{nullptr};
+    /// The indexed property names, which keeps their symbols alive.
+    const std::vector<jsi::PropNameID> indexedNames_{};
+    /// Maps the symbol of each indexed property name to its index.
+    llvm::DenseMap<vm::SymbolID, unsigned> indexOf_{};
   };
 
   struct HFContextBase {
@@ -913,43 +1022,171 @@ class HermesRuntimeImpl final : public HermesRuntime,
     }
   };
 
+  /// The values handed out to JSI, allocated in chunks of fixed size so that
+  /// creating a value does not call malloc. The slot of a value that is no
+  /// longer referenced goes on a free list, to be reused by the next value.
+  /// Unreferenced values are found by sweeping the chunks, when the GC marks
+  /// the values and when the free list runs out. The list then grows until
+  /// at least half of its slots are free, so that the sweeps cost O(1) per
+  /// value created, amortized.
   template <typename T>
-  struct ManagedValues {
-#ifdef ASSERT_ON_DANGLING_VM_REFS
-    // If we have active HermesValuePointers whhen deconstructing, these will
-    // now be dangling. We deliberately allocate and immediately leak heap
-    // memory to hold the internal list. This keeps alive memory holding the
-    // ref-count of the now dangling references, allowing them to detect the
-    // dangling case safely and assert when they are eventually released. By
-    // deferring the assert it's a bit easier to see what's holding the pointers
-    // for too long.
-    ~ManagedValues() {
+  class ManagedChunkedList {
+   public:
+    ManagedChunkedList() = default;
+    ManagedChunkedList(const ManagedChunkedList &) = delete;
+    ManagedChunkedList &operator=(const ManagedChunkedList &) = delete;
+
+    ~ManagedChunkedList() {
       bool anyDangling = false;
-      for (auto it = values.begin(); it != values.end();) {
-        if (it->get() == 0) {
-          it = values.erase(it);
-        } else {
+      for (auto &chunk : chunks_) {
+        for (Slot &slot : chunk->slots) {
+          if (!slot.occupied)
+            continue;
+          if (slot.value.get() == 0) {
+            slot.value.~T();
+            continue;
+          }
           anyDangling = true;
-          it->markDangling();
-          ++it;
+#ifdef ASSERT_ON_DANGLING_VM_REFS
+          slot.value.markDangling();
+#endif
         }
       }
+#ifdef ASSERT_ON_DANGLING_VM_REFS
+      // If we have active HermesValuePointers when deconstructing, these will
+      // now be dangling. We deliberately leak the chunks holding them. This
+      // keeps alive memory holding the ref-count of the now dangling
+      // references, allowing them to detect the dangling case safely and
+      // assert when they are eventually released. By deferring the assert
+      // it's a bit easier to see what's holding the pointers for too long.
       if (anyDangling) {
-        // This is the deliberate memory leak described above.
-        new std::list<T>(std::move(values));
+        for (auto &chunk : chunks_)
+          (void)chunk.release();
       }
-    }
+#else
+      (void)anyDangling;
 #endif
+    }
 
-    std::list<T> *operator->() {
-      return &values;
+    /// Construct a value from \p args in a free slot.
+    /// \return the value, with a reference count of 1.
+    template <typename... Args>
+    T &add(Args &&... args) {
+      if (LLVM_UNLIKELY(!freeList_))
+        collectOrGrow();
+      Slot *slot = freeList_;
+      freeList_ = slot->nextFree;
+      new (&slot->value) T(std::forward<Args>(args)...);
+      slot->occupied = true;
+      ++size_;
+      if (!scopes_.empty())
+        scopeLog_.push_back(slot);
+      return slot->value;
     }
 
-    const std::list<T> *operator->() const {
-      return &values;
+    /// Free the values that are no longer referenced, and call \p f on the
+    /// others.
+    template <typename F>
+    void forEach(F f) {
+      for (auto &chunk : chunks_) {
+        for (Slot &slot : chunk->slots) {
+          if (!slot.occupied)
+            continue;
+          if (slot.value.get() == 0)
+            free(&slot);
+          else
+            f(slot.value);
+        }
+      }
+    }
+
+    /// \return the number of values that have not been freed yet.
+    size_t size() const {
+      return size_;
+    }
+
+    /// Start recording the values added, which popScope() will free if they
+    /// are no longer referenced by then.
+    /// \return the depth of the scope, which is never 0.
+    size_t pushScope() {
+      scopes_.push_back(scopeLog_.size());
+      return scopes_.size();
+    }
+
+    /// End the scope at \p depth, freeing the values added since it started
+    /// that are no longer referenced.
+    /// \return false if it is not the innermost scope.
+    bool popScope(size_t depth) {
+      if (depth != scopes_.size())
+        return false;
+      size_t start = scopes_.back();
+      scopes_.pop_back();
+      // A slot may have been freed by a sweep and reused since it was
+      // recorded, which does not matter: an occupied slot can be freed once
+      // its value is no longer referenced, whichever value it holds.
+      for (size_t i = scopeLog_.size(); i-- > start;) {
+        Slot *slot = scopeLog_[i];
+        if (slot->occupied && slot->value.get() == 0)
+          free(slot);
+      }
+      scopeLog_.resize(start);
+      return true;
+    }
+
+   private:
+    static constexpr size_t kChunkSize = 512;
+
+    /// Holds either a value or, when it is free, the next free slot.
+    struct Slot {
+      union {
+        T value;
+        Slot *nextFree;
+      };
+      bool occupied{false};
+
+      Slot() : nextFree(nullptr) {}
+      ~Slot() {}
+    };
+
+    struct Chunk {
+      Slot slots[kChunkSize];
+    };
+
+    size_t capacity() const {
+      return chunks_.size() * kChunkSize;
+    }
+
+    void free(Slot *slot) {
+      slot->value.~T();
+      slot->occupied = false;
+      slot->nextFree = freeList_;
+      freeList_ = slot;
+      --size_;
+    }
+
+    /// Refill the free list, by sweeping the chunks and, if too few slots
+    /// were freed, by adding chunks.
+    void collectOrGrow() {
+      forEach([](T &) {});
+      while (!freeList_ || size_ * 2 > capacity()) {
+        chunks_.emplace_back(new Chunk());
+        Slot *slots = chunks_.back()->slots;
+        // Thread the slots in reverse, so they are used in address order.
+        for (size_t i = kChunkSize; i-- > 0;) {
+          slots[i].nextFree = freeList_;
+          freeList_ = &slots[i];
+        }
+      }
     }
 
-    std::list<T> values;
+    std::vector<std::unique_ptr<Chunk>> chunks_;
+    Slot *freeList_{nullptr};
+    /// Number of occupied slots.
+    size_t size_{0};
+    /// The slots filled while a scope is open, oldest first.
+    std::vector<Slot *> scopeLog_;
+    /// For each open scope, innermost last, its start in scopeLog_.
+    std::vector<size_t> scopes_;
   };
 
  protected:
@@ -962,8 +1199,47 @@ class HermesRuntimeImpl final : public HermesRuntime,
       unsigned int paramCount);
 
  public:
-  ManagedValues<HermesPointerValue> hermesValues_;
-  ManagedValues<WeakRefPointerValue> weakHermesValues_;
+  ManagedChunkedList<HermesPointerValue> hermesValues_;
+  ManagedChunkedList<WeakRefPointerValue> weakHermesValues_;
+
+  /// The property caches of the accesses by PropNameID, which have no call
+  /// site to own a cache, so they share one per name. Names are mapped
+  /// directly to entries, a name evicting the one that held its entry.
+  struct PropNameCacheEntry {
+    vm::SymbolID name;
+    vm::PropertyCacheEntry read;
+    vm::PropertyCacheEntry write;
+
+    /// Mark the name and the cached classes. Classes are held strongly, as
+    /// the fixed property caches of the runtime hold theirs, which keeps at
+    /// most a few per entry alive.
+    void mark(vm::SlotAcceptor &acceptor) {
+      if (name.isValid())
+        acceptor.accept(name);
+      for (vm::PropertyCacheEntry *cache : {&read, &write}) {
+        acceptor.accept(cache->clazz);
+        for (auto &clazz : cache->polyClazz)
+          acceptor.accept(clazz);
+        for (auto &clazz : cache->protoClazz)
+          acceptor.accept(clazz);
+      }
+    }
+  };
+  static constexpr size_t kPropNameCacheSize = 64;
+  PropNameCacheEntry propNameCache_[kPropNameCacheSize];
+
+  /// \return the entry of propNameCache_ for \p name, emptied if it held
+  /// another name.
+  PropNameCacheEntry &propNameCacheEntry(vm::SymbolID name) {
+    PropNameCacheEntry &entry =
+        propNameCache_[name.unsafeGetIndex() % kPropNameCacheSize];
+    if (entry.name != name) {
+      entry.name = name;
+      entry.read = vm::PropertyCacheEntry();
+      entry.write = vm::PropertyCacheEntry();
+    }
+    return entry;
+  }
 #ifdef HERMESJSI_ON_STACK
   StackRuntime stackRuntime_;
 #else
@@ -1028,6 +1304,14 @@ void HermesRuntime::enableSamplingProfiler() {
   ::hermes::vm::SamplingProfiler::getInstance()->enable();
 }
 
+void HermesRuntime::enableSamplingProfilerStreaming(
+    uint32_t maxNodes,
+    std::chrono::milliseconds flushInterval,
+    std::function<void(const std::string &chunk)> sink) {
+  ::hermes::vm::SamplingProfiler::getInstance()->enableStreaming(
+      maxNodes, flushInterval, std::move(sink));
+}
+
 void HermesRuntime::disableSamplingProfiler() {
   ::hermes::vm::SamplingProfiler::getInstance()->disable();
 }
@@ -1041,6 +1325,26 @@ void HermesRuntime::dumpSampledTraceToFile(const std::string &fileName) {
   ::hermes::vm::SamplingProfiler::getInstance()->dumpChromeTrace(os);
 }
 
+void HermesRuntime::dumpSampledOpCodeAndBuiltinHistograms(std::ostream &os) {
+  llvm::raw_os_ostream ros(os);
+  const auto &profiler = ::hermes::vm::SamplingProfiler::getInstance();
+  profiler->dumpOpCodeAndBuiltinHistograms(ros);
+}
+
+void HermesRuntime::configureStoragePool(
+    size_t maxBytes,
+    ::hermes::vm::StoragePoolZeroing zeroing) {
+  ::hermes::vm::StorageProvider::configureStoragePool(maxBytes, zeroing);
+}
+
+size_t HermesRuntime::drainStoragePool() {
+  return ::hermes::vm::StorageProvider::drainStoragePool();
+}
+
+uint64_t HermesRuntime::getFastTeardownLeakedBytes() {
+  return ::hermes::vm::Runtime::getFastTeardownLeakedBytes();
+}
+
 void HermesRuntime::setFatalHandler(void (*handler)(const std::string &)) {
   detail::sApiFatalHandler = handler;
 }
@@ -1133,29 +1437,169 @@ void HermesRuntime::debugJavaScript(
 #endif
 
 void HermesRuntime::registerForProfiling() {
-  ::hermes::vm::SamplingProfiler::getInstance()->registerRuntime(
-      &(impl(this)->runtime_));
+  vm::Runtime &runtime = impl(this)->runtime_;
+  runtime.getSamplingProfiler()->registerRuntime(&runtime);
 }
 
 void HermesRuntime::unregisterForProfiling() {
-  ::hermes::vm::SamplingProfiler::getInstance()->unregisterRuntime(
-      &(impl(this)->runtime_));
+  vm::Runtime &runtime = impl(this)->runtime_;
+  runtime.getSamplingProfiler()->unregisterRuntime(&runtime);
+}
+
+void HermesRuntime::enableOwnSamplingProfiler(
+    std::chrono::microseconds samplingInterval) {
+  vm::Runtime &runtime = impl(this)->runtime_;
+  if (runtime.getSamplingProfiler() ==
+      ::hermes::vm::SamplingProfiler::getInstance()) {
+    runtime.setSamplingProfiler(::hermes::vm::SamplingProfiler::create());
+  }
+  runtime.getSamplingProfiler()->setSamplingInterval(samplingInterval);
+  runtime.getSamplingProfiler()->enable();
+}
+
+void HermesRuntime::disableOwnSamplingProfiler() {
+  vm::Runtime &runtime = impl(this)->runtime_;
+  if (runtime.getSamplingProfiler() !=
+      ::hermes::vm::SamplingProfiler::getInstance()) {
+    runtime.getSamplingProfiler()->disable();
+  }
+}
+
+void HermesRuntime::dumpOwnSampledTrace(std::ostream &os) {
+  vm::Runtime &runtime = impl(this)->runtime_;
+  if (runtime.getSamplingProfiler() !=
+      ::hermes::vm::SamplingProfiler::getInstance()) {
+    llvm::raw_os_ostream ros(os);
+    runtime.getSamplingProfiler()->dumpChromeTrace(ros);
+  }
+}
+
+void HermesRuntime::enableAllocationSampling(uint64_t samplingInterval) {
+  impl(this)->runtime_.enableAllocationSampling(samplingInterval);
+}
+
+void HermesRuntime::disableAllocationSampling() {
+  impl(this)->runtime_.disableAllocationSampling();
+}
+
+void HermesRuntime::dumpSampledAllocations(std::ostream &os) {
+  llvm::raw_os_ostream ros(os);
+  impl(this)->runtime_.dumpSampledAllocations(ros);
+}
+
+void HermesRuntime::enableFunctionProfiling() {
+  impl(this)->runtime_.enableFunctionProfiling();
+}
+
+void HermesRuntime::disableFunctionProfiling() {
+  impl(this)->runtime_.disableFunctionProfiling();
+}
+
+void HermesRuntime::dumpFunctionProfile(std::ostream &os) {
+  llvm::raw_os_ostream ros(os);
+  impl(this)->runtime_.dumpFunctionProfile(ros);
+}
+
+void HermesRuntime::dumpFunctionProfileSummary(std::ostream &os) {
+  llvm::raw_os_ostream ros(os);
+  impl(this)->runtime_.dumpFunctionProfileSummary(ros);
+}
+
+void HermesRuntime::dumpPropertyCacheStats(std::ostream &os) {
+  llvm::raw_os_ostream ros(os);
+  impl(this)->runtime_.dumpPropertyCacheStats(ros);
 }
 
 void HermesRuntime::watchTimeLimit(uint32_t timeoutInMs) {
-  impl(this)->compileFlags_.emitAsyncBreakCheck = true;
   ::hermes::vm::TimeLimitMonitor::getInstance().watchRuntime(
       &(impl(this)->runtime_), timeoutInMs);
 }
 
 void HermesRuntime::unwatchTimeLimit() {
-  impl(this)->compileFlags_.emitAsyncBreakCheck = false;
   ::hermes::vm::TimeLimitMonitor::getInstance().unwatchRuntime(
       &(impl(this)->runtime_));
 }
 
+void HermesRuntime::requestInterrupt() {
+  impl(this)->runtime_.triggerInterruptAsyncBreak();
+}
+
+void HermesRuntime::setInterruptHandler(
+    std::function<void(HermesRuntime &)> handler) {
+  impl(this)->setInterruptHandler(std::move(handler));
+}
+
+size_t HermesRuntime::notifyMemoryPressure(
+    ::hermes::vm::MemoryPressureLevel level) {
+  return impl(this)->runtime_.getHeap().notifyMemoryPressure(level);
+}
+
+jsi::ArrayBuffer HermesRuntime::createExternalArrayBuffer(
+    uint8_t *data,
+    size_t size,
+    std::function<void()> release) {
+  return impl(this)->createExternalArrayBuffer(data, size, std::move(release));
+}
+
+void HermesRuntime::detachArrayBuffer(const jsi::ArrayBuffer &buffer) {
+  vm::Runtime &runtime = impl(this)->runtime_;
+  impl(this)->arrayBufferHandle(buffer)->detach(&runtime.getHeap());
+}
+
+jsi::Object HermesRuntime::createIndexedHostObject(
+    std::shared_ptr<IndexedHostObject> ho) {
+  return impl(this)->createIndexedHostObject(std::move(ho));
+}
+
+void IndexedHostObject::setIndexed(
+    jsi::Runtime &rt,
+    unsigned index,
+    const jsi::Value &) {
+  std::string msg("TypeError: Cannot assign to indexed property ");
+  msg += std::to_string(index);
+  msg += " on HostObject with default setter";
+  throw jsi::JSError(rt, msg);
+}
+
+jsi::String HermesRuntime::createExternalStringFromAscii(
+    const char *chars,
+    size_t length,
+    std::function<void()> release) {
+#ifndef NDEBUG
+  for (size_t i = 0; i < length; ++i) {
+    assert(
+        static_cast<unsigned char>(chars[i]) < 128 &&
+        "non-ASCII character in string");
+  }
+#endif
+  return impl(this)->createExternalString(chars, length, std::move(release));
+}
+
+jsi::String HermesRuntime::createExternalStringFromUtf16(
+    const char16_t *chars,
+    size_t length,
+    std::function<void()> release) {
+  return impl(this)->createExternalString(chars, length, std::move(release));
+}
+
+void HermesRuntime::getProperties(
+    const jsi::Object &obj,
+    const jsi::PropNameID *names,
+    size_t count,
+    jsi::Value *values) {
+  impl(this)->getProperties(obj, names, count, values);
+}
+
+void HermesRuntime::setProperties(
+    jsi::Object &obj,
+    const jsi::PropNameID *names,
+    const jsi::Value *values,
+    size_t count) {
+  impl(this)->setProperties(obj, names, values, count);
+}
+
 size_t HermesRuntime::rootsListLength() const {
-  return impl(this)->hermesValues_->size();
+  return impl(this)->hermesValues_.size();
 }
 
 namespace {
@@ -1256,6 +1700,44 @@ jsi::Value HermesRuntimeImpl::evaluateJavaScript(
   return evaluatePreparedJavaScript(prepareJavaScript(buffer, sourceURL));
 }
 
+jsi::Value HermesRuntime::evaluateSharedBytecode(
+    std::shared_ptr<const jsi::Buffer> buffer,
+    const std::string &sourceURL) {
+  if (!isHermesBytecode(buffer->data(), buffer->size())) {
+    throw jsi::JSINativeException("Shared buffer does not hold bytecode");
+  }
+  auto bcErr = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+      std::make_unique<BufferAdapter>(std::move(buffer)));
+  if (!bcErr.first) {
+    throw jsi::JSINativeException(std::move(bcErr.second));
+  }
+  vm::RuntimeModuleFlags runtimeFlags{};
+  runtimeFlags.persistent = true;
+  runtimeFlags.sharedBytecode = true;
+  return evaluatePreparedJavaScript(
+      std::make_shared<const HermesPreparedJavaScript>(
+          std::move(bcErr.first), runtimeFlags, sourceURL));
+}
+
+std::shared_ptr<const jsi::PreparedJavaScript> HermesRuntime::prepareBytecode(
+    std::shared_ptr<const jsi::Buffer> buffer,
+    std::string sourceURL) {
+  if (!isHermesBytecode(buffer->data(), buffer->size())) {
+    throw jsi::JSINativeException("Buffer does not hold bytecode");
+  }
+  auto bcErr = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+      std::make_unique<BufferAdapter>(std::move(buffer)));
+  if (!bcErr.first) {
+    throw jsi::JSINativeException(std::move(bcErr.second));
+  }
+  // Wait for the reads here rather than on the JS thread.
+  bcErr.first->readInForLoad();
+  vm::RuntimeModuleFlags runtimeFlags{};
+  runtimeFlags.persistent = true;
+  return std::make_shared<const HermesPreparedJavaScript>(
+      std::move(bcErr.first), runtimeFlags, std::move(sourceURL));
+}
+
 jsi::Object HermesRuntimeImpl::global() {
   return add<jsi::Object>(runtime_.getGlobal().getHermesValue());
 }
@@ -1345,12 +1827,8 @@ jsi::PropNameID HermesRuntimeImpl::createPropNameIDFromString(
 std::string HermesRuntimeImpl::utf8(const jsi::PropNameID &sym) {
   vm::GCScope gcScope(&runtime_);
   vm::SymbolID id = phv(sym).getSymbol();
-  auto view = runtime_.getIdentifierTable().getStringView(&runtime_, id);
-  vm::SmallU16String<32> allocator;
-  std::string ret;
-  ::hermes::convertUTF16ToUTF8WithReplacements(
-      ret, view.getUTF16Ref(allocator));
-  return ret;
+  return viewToStdString(
+      runtime_.getIdentifierTable().getStringView(&runtime_, id));
 }
 
 bool HermesRuntimeImpl::compare(
@@ -1364,12 +1842,8 @@ namespace {
 std::string toStdString(
     vm::Runtime *runtime,
     vm::Handle<vm::StringPrimitive> handle) {
-  auto view = vm::StringPrimitive::createStringView(runtime, handle);
-  vm::SmallU16String<32> allocator;
-  std::string ret;
-  ::hermes::convertUTF16ToUTF8WithReplacements(
-      ret, view.getUTF16Ref(allocator));
-  return ret;
+  return viewToStdString(
+      vm::StringPrimitive::createStringView(runtime, handle));
 }
 
 } // namespace
@@ -1409,6 +1883,55 @@ jsi::String HermesRuntimeImpl::createStringFromUtf8(
   });
 }
 
+template <typename T>
+jsi::String HermesRuntimeImpl::createExternalString(
+    const T *chars,
+    size_t length,
+    std::function<void()> release) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    if (length < vm::StringPrimitive::EXTERNAL_STRING_MIN_SIZE) {
+      // Too short to be external: copy it into the GC heap.
+      auto res = vm::StringPrimitive::createEfficient(
+          &runtime_, llvm::makeArrayRef(chars, length));
+      if (release)
+        release();
+      checkStatus(res.getStatus());
+      return add<jsi::String>(*res);
+    }
+    if (length > vm::StringPrimitive::MAX_STRING_LENGTH) {
+      if (release)
+        release();
+      checkStatus(runtime_.raiseRangeError("String length exceeds limit"));
+    }
+    auto res = vm::ExternalStringPrimitive<T>::createForeign(
+        &runtime_, chars, static_cast<uint32_t>(length), std::move(release));
+    checkStatus(res.getStatus());
+    return add<jsi::String>(*res);
+  });
+}
+
+jsi::ArrayBuffer HermesRuntimeImpl::createExternalArrayBuffer(
+    uint8_t *data,
+    size_t size,
+    std::function<void()> release) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    auto res = vm::JSArrayBuffer::create(
+        &runtime_,
+        vm::Handle<vm::JSObject>::vmcast(&runtime_.arrayBufferPrototype));
+    if (LLVM_UNLIKELY(res == vm::ExecutionStatus::EXCEPTION)) {
+      if (release)
+        release();
+      checkStatus(res.getStatus());
+    }
+    auto buffer = runtime_.makeHandle<vm::JSArrayBuffer>(*res);
+    checkStatus(buffer->setExternalDataBlock(
+        &runtime_, data, size, std::move(release)));
+    return add<jsi::Object>(buffer.getHermesValue()).getArrayBuffer(*this);
+  });
+}
+
 std::string HermesRuntimeImpl::utf8(const jsi::String &str) {
   vm::GCScope gcScope(&runtime_);
   return maybeRethrow([&] {
@@ -1472,6 +1995,47 @@ jsi::Object HermesRuntimeImpl::createObject(
   });
 }
 
+void HermesRuntimeImpl::setInterruptHandler(
+    std::function<void(HermesRuntime &)> handler) {
+  if (!handler) {
+    runtime_.setInterruptHandler(nullptr);
+    return;
+  }
+  runtime_.setInterruptHandler([this, handler]() -> vm::ExecutionStatus {
+    try {
+      handler(*this);
+    } catch (const jsi::JSError &error) {
+      return runtime_.setThrownValue(hvFromValue(error.value()));
+    } catch (const std::exception &ex) {
+      return runtime_.setThrownValue(hvFromValue(
+          global()
+              .getPropertyAsFunction(*this, "Error")
+              .call(
+                  *this,
+                  std::string("Exception in interrupt handler: ") +
+                      ex.what())));
+    } catch (...) {
+      return runtime_.setThrownValue(hvFromValue(
+          global()
+              .getPropertyAsFunction(*this, "Error")
+              .call(*this, "Exception in interrupt handler: <unknown>")));
+    }
+    return vm::ExecutionStatus::RETURNED;
+  });
+}
+
+jsi::Object HermesRuntimeImpl::createIndexedHostObject(
+    std::shared_ptr<IndexedHostObject> ho) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+
+    auto objRes = vm::HostObject::createWithoutPrototype(
+        &runtime_, std::make_shared<JsiProxy>(*this, std::move(ho)));
+    checkStatus(objRes.getStatus());
+    return add<jsi::Object>(*objRes);
+  });
+}
+
 std::shared_ptr<jsi::HostObject> HermesRuntimeImpl::getHostObject(
     const jsi::Object &obj) {
   return std::static_pointer_cast<JsiProxyBase>(
@@ -1500,8 +2064,7 @@ jsi::Value HermesRuntimeImpl::getProperty(
         "jsi-hermes-getProperty-nameid");
     vm::GCScope gcScope(&runtime_);
     auto h = handle(obj);
-    vm::SymbolID nameID = phv(name).getSymbol();
-    auto res = h->getNamedOrIndexed(h, &runtime_, nameID);
+    auto res = getNamedOrIndexedCached(h, phv(name).getSymbol());
     checkStatus(res.getStatus());
     return valueFromHermesValue(*res);
   });
@@ -1552,17 +2115,110 @@ void HermesRuntimeImpl::setPropertyValue(
   return maybeRethrow([&] {
     vm::GCScope gcScope(&runtime_);
     auto h = handle(obj);
-    vm::SymbolID nameID = phv(name).getSymbol();
-    checkStatus(h->putNamedOrIndexed(
-                     h,
-                     &runtime_,
-                     nameID,
-                     vmHandleFromValue(value),
-                     vm::PropOpFlags().plusThrowOnError())
-                    .getStatus());
+    checkStatus(putNamedOrIndexedCached(h, phv(name).getSymbol(), value));
+  });
+}
+
+void HermesRuntimeImpl::getProperties(
+    const jsi::Object &obj,
+    const jsi::PropNameID *names,
+    size_t count,
+    jsi::Value *values) {
+  return maybeRethrow([&] {
+    ::hermes::instrumentation::PerfMarker m("jsi-hermes-getProperties");
+    vm::GCScope gcScope(&runtime_);
+    auto h = handle(obj);
+    vm::GCScopeMarkerRAII marker{gcScope};
+    for (size_t i = 0; i < count; ++i) {
+      auto res = getNamedOrIndexedCached(h, phv(names[i]).getSymbol());
+      checkStatus(res.getStatus());
+      values[i] = valueFromHermesValue(*res);
+      marker.flush();
+    }
   });
 }
 
+void HermesRuntimeImpl::setProperties(
+    jsi::Object &obj,
+    const jsi::PropNameID *names,
+    const jsi::Value *values,
+    size_t count) {
+  return maybeRethrow([&] {
+    ::hermes::instrumentation::PerfMarker m("jsi-hermes-setProperties");
+    vm::GCScope gcScope(&runtime_);
+    auto h = handle(obj);
+    vm::GCScopeMarkerRAII marker{gcScope};
+    for (size_t i = 0; i < count; ++i) {
+      checkStatus(
+          putNamedOrIndexedCached(h, phv(names[i]).getSymbol(), values[i]));
+      marker.flush();
+    }
+  });
+}
+
+vm::CallResult<vm::HermesValue> HermesRuntimeImpl::getNamedOrIndexedCached(
+    vm::Handle<vm::JSObject> obj,
+    vm::SymbolID name) {
+  // An index-like name may refer to the indexed storage, which is not cached.
+  if (LLVM_UNLIKELY(obj->hasIndexedStorage()))
+    return vm::JSObject::getNamedOrIndexed(obj, &runtime_, name);
+
+  vm::PropertyCacheEntry &cacheEntry = propNameCacheEntry(name).read;
+  vm::SlotIndex slot;
+  if (LLVM_LIKELY(
+          cacheEntry.find(obj->getClassGCPtr().getStorageType(), slot))) {
+    ++cacheEntry.hits;
+    return vm::JSObject::getNamedSlotValue(*obj, &runtime_, slot);
+  }
+  if (vm::JSObject *holder =
+          vm::JSObject::getCachedPrototypeHolder(*obj, &runtime_, cacheEntry)) {
+    ++cacheEntry.hits;
+    return vm::JSObject::getNamedSlotValue(
+        holder, &runtime_, cacheEntry.protoSlot);
+  }
+  ++cacheEntry.misses;
+  return vm::JSObject::getNamed_RJS(
+      obj, &runtime_, name, vm::PropOpFlags(), &cacheEntry);
+}
+
+vm::ExecutionStatus HermesRuntimeImpl::putNamedOrIndexedCached(
+    vm::Handle<vm::JSObject> obj,
+    vm::SymbolID name,
+    const jsi::Value &value) {
+  if (LLVM_LIKELY(!obj->hasIndexedStorage())) {
+    vm::PropertyCacheEntry &cacheEntry = propNameCacheEntry(name).write;
+    auto clazzGCPtr = obj->getClassGCPtr();
+    vm::SlotIndex slot;
+    if (LLVM_LIKELY(cacheEntry.find(clazzGCPtr.getStorageType(), slot))) {
+      ++cacheEntry.hits;
+      vm::JSObject::setNamedSlotValue(
+          *obj, &runtime_, slot, hvFromValue(value));
+      return vm::ExecutionStatus::RETURNED;
+    }
+    ++cacheEntry.misses;
+    // Only own writable data properties can be cached, as in PutById.
+    vm::NamedPropertyDescriptor desc;
+    ::hermes::OptValue<bool> hasOwnProp =
+        vm::JSObject::tryGetOwnNamedDescriptorFast(*obj, &runtime_, name, desc);
+    if (hasOwnProp.hasValue() && hasOwnProp.getValue() &&
+        !desc.flags.accessor && desc.flags.writable &&
+        !desc.flags.internalSetter) {
+      if (LLVM_LIKELY(!clazzGCPtr.getNonNull(&runtime_)->isDictionary()))
+        cacheEntry.update(clazzGCPtr.getStorageType(), desc.slot);
+      vm::JSObject::setNamedSlotValue(
+          *obj, &runtime_, desc.slot, hvFromValue(value));
+      return vm::ExecutionStatus::RETURNED;
+    }
+  }
+  return vm::JSObject::putNamedOrIndexed(
+             obj,
+             &runtime_,
+             name,
+             vmHandleFromValue(value),
+             vm::PropOpFlags().plusThrowOnError())
+      .getStatus();
+}
+
 bool HermesRuntimeImpl::isArray(const jsi::Object &obj) const {
   return vm::vmisa<vm::JSArray>(phv(obj));
 }
@@ -1881,39 +2537,16 @@ bool HermesRuntimeImpl::instanceOf(
 }
 
 jsi::Runtime::ScopeState *HermesRuntimeImpl::pushScope() {
-  hermesValues_->emplace_front(
-      vm::HermesValue::encodeNativeValue(kSentinelNativeValue));
-  return reinterpret_cast<ScopeState *>(&hermesValues_->front());
+  // The state is the depth of the scope, so scopes cost no allocation.
+  return reinterpret_cast<ScopeState *>(
+      static_cast<uintptr_t>(hermesValues_.pushScope()));
 }
 
 void HermesRuntimeImpl::popScope(ScopeState *prv) {
-  HermesPointerValue *sentinel = reinterpret_cast<HermesPointerValue *>(prv);
-  assert(sentinel->phv.isNativeValue());
-  assert(sentinel->phv.getNativeValue() == kSentinelNativeValue);
-
-  for (auto it = hermesValues_->begin(); it != hermesValues_->end();) {
-    auto &value = *it;
-
-    if (&value == sentinel) {
-      hermesValues_->erase(it);
-      return;
-    }
-
-    if (value.phv.isNativeValue()) {
-      // We reached another sentinel value or we started added another native
-      // value to the hermesValue_ list. This should not happen.
-      std::terminate();
-    }
-
-    if (value.get() == 0) {
-      it = hermesValues_->erase(it);
-    } else {
-      ++it;
-    }
+  if (!hermesValues_.popScope(reinterpret_cast<uintptr_t>(prv))) {
+    // Scopes must be popped in the reverse order they were pushed.
+    std::terminate();
   }
-
-  // We did not find a sentinel value.
-  std::terminate();
 }
 
 void HermesRuntimeImpl::checkStatus(vm::ExecutionStatus status) {
@@ -8,12 +8,16 @@
 #ifndef HERMES_HERMES_H
 #define HERMES_HERMES_H
 
+#include <chrono>
 #include <exception>
+#include <functional>
 #include <list>
 #include <memory>
 #include <string>
 
+#include <hermes/Public/MemoryPressure.h>
 #include <hermes/Public/RuntimeConfig.h>
+#include <hermes/Public/StoragePool.h>
 #include <jsi/jsi.h>
 
 struct HermesTestHelper;
@@ -45,6 +49,26 @@ class Debugger;
 
 class HermesRuntimeImpl;
 
+/// A HostObject with a fixed set of property names that are accessed often.
+/// Accesses to them are dispatched to getIndexed() and setIndexed() with the
+/// index of the name, without creating a PropNameID or timing the call.
+/// Other names go to get() and set() as usual.
+class IndexedHostObject : public jsi::HostObject {
+ public:
+  /// \return the indexed property names, the index of each being its
+  /// position. This is called once, when the object is created.
+  virtual std::vector<jsi::PropNameID> getIndexedPropertyNames(
+      jsi::Runtime &rt) = 0;
+
+  /// \return the value of the indexed property \p index.
+  virtual jsi::Value getIndexed(jsi::Runtime &rt, unsigned index) = 0;
+
+  /// Set the indexed property \p index to \p value. By default this throws
+  /// a type error, as HostObject::set() does.
+  virtual void
+  setIndexed(jsi::Runtime &rt, unsigned index, const jsi::Value &value);
+};
+
 /// Represents a Hermes JS runtime.
 class HermesRuntime : public jsi::Runtime {
  public:
@@ -62,6 +86,16 @@ class HermesRuntime : public jsi::Runtime {
       std::string *errorMessage = nullptr);
   static void setFatalHandler(void (*handler)(const std::string &));
 
+  /// Prepare the bytecode in \p buffer for evaluatePreparedJavaScript(),
+  /// without a runtime. Unlike prepareJavaScript(), this may be called on any
+  /// thread, so that the bytecode is checked and the parts of it needed to
+  /// load and start it are read in while the JS thread does other work. The
+  /// result may be evaluated by any HermesRuntime.
+  /// \throw JSINativeException if \p buffer doesn't hold valid bytecode.
+  static std::shared_ptr<const jsi::PreparedJavaScript> prepareBytecode(
+      std::shared_ptr<const jsi::Buffer> buffer,
+      std::string sourceURL);
+
   // Assuming that \p data is valid HBC bytecode data, returns a pointer to then
   // first element of the epilogue, data append to the end of the bytecode
   // stream. Return pair contain ptr to data and header.
@@ -72,12 +106,42 @@ class HermesRuntime : public jsi::Runtime {
   /// Enable sampling profiler.
   static void enableSamplingProfiler();
 
+  /// Enable the sampling profiler in streaming mode: samples are merged into
+  /// a call tree of at most \p maxNodes frames, which is handed to \p sink
+  /// as folded stacks ("root;...;leaf count" lines) whenever it fills up,
+  /// \p flushInterval passes, or the profiler is disabled. \p sink runs on
+  /// the sampling thread and must not call back into the profiler.
+  static void enableSamplingProfilerStreaming(
+      uint32_t maxNodes,
+      std::chrono::milliseconds flushInterval,
+      std::function<void(const std::string &chunk)> sink);
+
   /// Disable the sampling profiler
   static void disableSamplingProfiler();
 
   /// Dump sampled stack trace to the given file name.
   static void dumpSampledTraceToFile(const std::string &fileName);
 
+  /// Dump to \p os how often the sampling profiler caught each opcode and
+  /// each builtin executing, most frequent first. Call it before
+  /// dumpSampledTraceToFile, which discards the samples.
+  static void dumpSampledOpCodeAndBuiltinHistograms(std::ostream &os);
+
+  /// Limit the heap storage retained, for reuse by later runtimes, when
+  /// runtimes created with GCConfig::PooledStorage are destroyed, to \p
+  /// maxBytes, and choose what is done to its contents with \p zeroing.
+  static void configureStoragePool(
+      size_t maxBytes,
+      ::hermes::vm::StoragePoolZeroing zeroing);
+
+  /// Return the heap storage retained for reuse by later runtimes to the OS.
+  /// \return the number of bytes released.
+  static size_t drainStoragePool();
+
+  /// \return the number of bytes of native memory leaked so far by
+  /// destroying runtimes created with RuntimeConfig::FastTeardown.
+  static uint64_t getFastTeardownLeakedBytes();
+
   // The base class declares most of the interesting methods.  This
   // just declares new methods which are specific to HermesRuntime.
   // The actual implementations of the pure virtual methods are
@@ -91,6 +155,72 @@ class HermesRuntime : public jsi::Runtime {
       std::unique_ptr<const jsi::Buffer> buffer,
       const jsi::Value &context);
 
+  /// Evaluate the bytecode in \p buffer, which is immutable and may be shared
+  /// with other processes, e.g. a file mapped read-only. Nothing is ever
+  /// written into it, so its pages stay clean and shareable; only the state
+  /// derived from it, such as the identifier map, is in private memory.
+  /// Unlike evaluateJavaScript(), \p buffer must hold bytecode.
+  jsi::Value evaluateSharedBytecode(
+      std::shared_ptr<const jsi::Buffer> buffer,
+      const std::string &sourceURL);
+
+  /// Create a string of the \p length ASCII characters at \p chars, using
+  /// them in place rather than copying them when the string is long enough
+  /// for that to pay off. \p release is called once the runtime no longer
+  /// needs the characters, which must not change until then. It may be called
+  /// before this returns, and is called on the thread running the runtime.
+  /// The characters count towards the external memory of the GC heap.
+  jsi::String createExternalStringFromAscii(
+      const char *chars,
+      size_t length,
+      std::function<void()> release);
+
+  /// Like createExternalStringFromAscii, for \p length UTF-16 code units.
+  jsi::String createExternalStringFromUtf16(
+      const char16_t *chars,
+      size_t length,
+      std::function<void()> release);
+
+  /// Create an ArrayBuffer of the \p size bytes at \p data, which JS reads
+  /// and writes in place rather than in a copy. \p release is called once
+  /// the runtime no longer accesses the bytes: when the buffer is detached or
+  /// collected, or before this returns if it fails. It is called on the
+  /// thread running the runtime, possibly during a collection, so it must not
+  /// call into the runtime. The bytes count towards the external memory of
+  /// the GC heap.
+  jsi::ArrayBuffer createExternalArrayBuffer(
+      uint8_t *data,
+      size_t size,
+      std::function<void()> release);
+
+  /// Detach \p buffer from its bytes, as transferring it does: it then has
+  /// no bytes, its typed arrays are empty, and its bytes are freed, or
+  /// released if they are external.
+  void detachArrayBuffer(const jsi::ArrayBuffer &buffer);
+
+  /// Create an object whose properties are those of \p ho, like
+  /// createObject() does, that dispatches to its indexed properties by index.
+  jsi::Object createIndexedHostObject(std::shared_ptr<IndexedHostObject> ho);
+
+  /// Get the properties \p names of \p obj into \p values, which has room
+  /// for \p count values. This is what calling obj.getProperty() with each
+  /// name in turn does, in a single call into the VM. If a getter throws,
+  /// the values before it have been stored.
+  void getProperties(
+      const jsi::Object &obj,
+      const jsi::PropNameID *names,
+      size_t count,
+      jsi::Value *values);
+
+  /// Set the properties \p names of \p obj to the \p count values in
+  /// \p values, in order, in a single call into the VM. If a setter throws,
+  /// the properties before it have been set.
+  void setProperties(
+      jsi::Object &obj,
+      const jsi::PropNameID *names,
+      const jsi::Value *values,
+      size_t count);
+
   /// Gets a guaranteed unique id for an object, which is assigned at
   /// allocation time and is static throughout that object's lifetime.
   uint64_t getUniqueID(const jsi::Object &o) const;
@@ -139,6 +269,48 @@ class HermesRuntime : public jsi::Runtime {
   /// Unregister this runtime for sampling profiler.
   void unregisterForProfiling();
 
+  /// Sample this runtime with a sampling profiler of its own, waiting
+  /// \p samplingInterval between samples, rather than with the process-wide
+  /// one. Its samples are kept apart and it is enabled and disabled
+  /// independently of the process-wide profiler and of other runtimes.
+  /// Must be called on the thread running this runtime.
+  void enableOwnSamplingProfiler(
+      std::chrono::microseconds samplingInterval =
+          std::chrono::milliseconds(1));
+  /// Disable the profiler started by enableOwnSamplingProfiler.
+  void disableOwnSamplingProfiler();
+  /// Dump the samples taken by this runtime's own sampling profiler to \p os
+  /// in Chrome trace format.
+  void dumpOwnSampledTrace(std::ostream &os);
+
+  /// Sample the allocations of this runtime, on average one every
+  /// \p samplingInterval bytes, attributing each to the JS stack that made
+  /// it. Samples taken before are discarded.
+  void enableAllocationSampling(uint64_t samplingInterval);
+  /// Stop sampling allocations and discard the samples.
+  void disableAllocationSampling();
+  /// Dump the allocations sampled so far to \p os in the Chrome sampling
+  /// heap profile format, with the bytes still alive and allocated in total
+  /// by each stack.
+  void dumpSampledAllocations(std::ostream &os);
+
+  /// Measure the wall and CPU time and count the calls of every JS function
+  /// run by this runtime, interpreted or JIT compiled. Measurements taken
+  /// before are discarded.
+  void enableFunctionProfiling();
+  /// Stop measuring the JS functions and discard the measurements.
+  void disableFunctionProfiling();
+  /// Dump the self wall time of every call stack measured so far to \p os as
+  /// flame graph folded stacks, in microseconds.
+  void dumpFunctionProfile(std::ostream &os);
+  /// Dump the calls, and the self and total wall and CPU times of every
+  /// function measured so far to \p os as JSON.
+  void dumpFunctionProfileSummary(std::ostream &os);
+
+  /// Dump the hits, misses and evictions of every property cache entry used
+  /// so far to \p os as JSON, with the source location of its accesses.
+  void dumpPropertyCacheStats(std::ostream &os);
+
   /// Register this runtime for execution time limit monitoring, with a time
   /// limit of \p timeoutInMs milliseconds.
   /// All JS compiled to bytecode via prepareJS, or evaluateJS, will support the
@@ -149,6 +321,29 @@ class HermesRuntime : public jsi::Runtime {
   /// Unregister this runtime for execution time limit monitoring.
   void unwatchTimeLimit();
 
+  /// Ask the runtime to call the interrupt handler at the next loop
+  /// iteration or function entry of the JS it runs. This is cheap and may be
+  /// called from any thread, or a signal handler. Bytecode that was not
+  /// compiled by the runtime only checks for interrupts if it was compiled
+  /// with -emit-async-break-check.
+  void requestInterrupt();
+
+  /// Set the function called on the thread running the runtime to take the
+  /// interrupts requested by requestInterrupt(), e.g. to run microtasks and
+  /// timers. It may call into the runtime; if it throws, the exception is
+  /// thrown in JS where the interrupt was taken. Interrupts requested while
+  /// it runs are taken after it returns. Without a handler, interrupts are
+  /// ignored.
+  void setInterruptHandler(std::function<void(HermesRuntime &)> handler);
+
+  /// Tell the runtime that the system is short of memory.  Does a full
+  /// collection, then shrinks the heap and returns its unused memory to the OS
+  /// as \p level calls for.
+  /// \return the number of bytes released.
+  size_t notifyMemoryPressure(
+      ::hermes::vm::MemoryPressureLevel level =
+          ::hermes::vm::MemoryPressureLevel::Critical);
+
  private:
   // Only HermesRuntimeImpl can subclass this.
   HermesRuntime() = default;
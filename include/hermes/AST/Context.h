@@ -13,6 +13,9 @@
 #include "hermes/Support/SourceErrorManager.h"
 #include "hermes/Support/StringTable.h"
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+
 namespace hermes {
 
 namespace hbc {
@@ -37,6 +40,10 @@ struct CodeGenerationSettings {
   bool dumpUseList{false};
   /// Dump IR after every pass.
   bool dumpIRBetweenPasses{false};
+  /// Constants replacing the reads of global names, or of properties of them
+  /// like "process.env.NODE_ENV", keyed by the dotted name. The values are
+  /// true, false, null, undefined, a number, or an optionally quoted string.
+  llvm::StringMap<std::string> globalDefines{};
 };
 
 struct OutliningSettings {
@@ -53,6 +60,11 @@ struct OutliningSettings {
   unsigned maxParameters{5};
 };
 
+/// The number of calls to each function in a profiling run, keyed by the line
+/// and column of the start of the function.
+using FunctionEntryCounts =
+    llvm::DenseMap<std::pair<unsigned, unsigned>, uint64_t>;
+
 struct OptimizationSettings {
   /// Enable constant property optimization
   bool constantPropertyOptimizations{false};
@@ -81,12 +93,21 @@ struct OptimizationSettings {
   /// Reuse property cache entries for same property name.
   bool reusePropCache{true};
 
+  /// Let functions whose scope holds no captured variables use the environment
+  /// they were created in instead of creating one, and resolve the outer
+  /// environments a function accesses more than once on entry.
+  bool flattenEnvironments{false};
+
   /// Recognize calls to global functions like Object.keys() and turn them
   /// into builtin calls.
   bool staticBuiltins{false};
 
   /// Attempt to resolve CommonJS require() calls at compile time.
   bool staticRequire{false};
+
+  /// Function entry counts read from a profile, used to inline hot functions.
+  /// Empty without a profile.
+  FunctionEntryCounts functionEntryCounts{};
 };
 
 enum class DebugInfoSetting {
@@ -639,6 +639,10 @@ NodeList &getParams(FunctionLikeNode *node);
 /// functions.
 BlockStatementNode *getBlockStatement(FunctionLikeNode *node);
 
+/// Replace each label in the tree rooted at \p root by the label with the
+/// same name in \p table, e.g. to use a tree parsed in another Context.
+void reinternLabels(NodePtr root, StringTable &table);
+
 } // namespace ESTree
 } // namespace hermes
 
@@ -32,6 +32,20 @@ class MovElimination : public FunctionPass {
   RegisterAllocator &RA_;
 };
 
+/// Renumbers the registers after the passes that eliminate instructions, so
+/// that the registers they left unused don't take space in the frame.
+class CompactRegisters : public FunctionPass {
+ public:
+  explicit CompactRegisters(RegisterAllocator &RA)
+      : FunctionPass("CompactRegisters"), RA_(RA) {}
+  ~CompactRegisters() override = default;
+
+  bool runOnFunction(Function *F) override;
+
+ private:
+  RegisterAllocator &RA_;
+};
+
 } // namespace hermes
 
 #endif
@@ -229,6 +229,17 @@ class BytecodeModule {
   /// Element i contains the function index for module i + cjsModuleOffset.
   std::vector<uint32_t> cjsModuleTableStatic_{};
 
+  /// The statically resolved CommonJS modules of each segment of the bundle,
+  /// if it was split into several segments.
+  std::vector<SegmentTableEntry> segmentTable_{};
+
+  /// Element i is the index in cjsModuleDependencies_ of the first dependency
+  /// of module i + cjsModuleOffset. Empty if no module has dependencies.
+  std::vector<uint32_t> cjsModuleDependencyOffsets_{};
+
+  /// The IDs of the modules statically required by each resolved module.
+  std::vector<uint32_t> cjsModuleDependencies_{};
+
   /// Storing information about the bytecode, needed when it is loaded by the
   /// runtime.
   BytecodeOptions options_{};
@@ -250,6 +261,9 @@ class BytecodeModule {
       uint32_t cjsModuleOffset,
       std::vector<std::pair<uint32_t, uint32_t>> &&cjsModuleTable,
       std::vector<uint32_t> &&cjsModuleTableStatic,
+      std::vector<SegmentTableEntry> &&segmentTable,
+      std::vector<uint32_t> &&cjsModuleDependencyOffsets,
+      std::vector<uint32_t> &&cjsModuleDependencies,
       BytecodeOptions options)
       : globalFunctionIndex_(globalFunctionIndex),
         stringKinds_(std::move(stringKinds)),
@@ -264,6 +278,9 @@ class BytecodeModule {
         cjsModuleOffset_(cjsModuleOffset),
         cjsModuleTable_(std::move(cjsModuleTable)),
         cjsModuleTableStatic_(std::move(cjsModuleTableStatic)),
+        segmentTable_(std::move(segmentTable)),
+        cjsModuleDependencyOffsets_(std::move(cjsModuleDependencyOffsets)),
+        cjsModuleDependencies_(std::move(cjsModuleDependencies)),
         options_(options) {
     functions_.resize(functionCount);
   }
@@ -342,6 +359,18 @@ class BytecodeModule {
     return cjsModuleTableStatic_;
   }
 
+  llvm::ArrayRef<SegmentTableEntry> getSegmentTable() const {
+    return segmentTable_;
+  }
+
+  llvm::ArrayRef<uint32_t> getCJSModuleDependencyOffsets() const {
+    return cjsModuleDependencyOffsets_;
+  }
+
+  llvm::ArrayRef<uint32_t> getCJSModuleDependencies() const {
+    return cjsModuleDependencies_;
+  }
+
   DebugInfo &getDebugInfo() {
     return debugInfo_;
   }
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_BCGEN_HBC_BYTECODECOMPRESSION_H
+#define HERMES_BCGEN_HBC_BYTECODECOMPRESSION_H
+
+#include "hermes/BCGen/HBC/BytecodeFileFormat.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+
+namespace hermes {
+namespace hbc {
+
+/// Write the bytecode file in execution form \p bytecode to \p OS in
+/// compressed form (see CompressedBytecodeHeader), which BCProviderFromBuffer
+/// expands as it is used.
+/// \return true if successful, false if \p bytecode could not be interpreted,
+/// in which case an error is returned in \p outError.
+bool compressBytecode(
+    llvm::ArrayRef<uint8_t> bytecode,
+    llvm::raw_ostream &OS,
+    std::string *outError);
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMES_BCGEN_HBC_BYTECODECOMPRESSION_H
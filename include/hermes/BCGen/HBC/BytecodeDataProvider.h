@@ -19,7 +19,9 @@
 
 #include "llvm/ADT/ArrayRef.h"
 
+#include <algorithm>
 #include <atomic>
+#include <mutex>
 #include <thread>
 
 #ifdef HERMESVM_SERIALIZE
@@ -137,6 +139,21 @@ class BCProviderBase {
   /// Vector of function indexes.
   llvm::ArrayRef<uint32_t> cjsModuleTableStatic_{};
 
+  /// The statically resolved CommonJS modules of each segment of the bundle.
+  llvm::ArrayRef<hbc::SegmentTableEntry> segmentTable_{};
+
+  /// For each statically resolved CommonJS module, the index in
+  /// cjsModuleDependencies_ of its first dependency. Empty if the modules have
+  /// no dependencies.
+  llvm::ArrayRef<uint32_t> cjsModuleDependencyOffsets_{};
+
+  /// The IDs of the CommonJS modules statically required by each module.
+  llvm::ArrayRef<uint32_t> cjsModuleDependencies_{};
+
+  /// The ranges of the file read during a traced startup, in the order they
+  /// were first touched. Only files loaded from a buffer have them.
+  llvm::ArrayRef<hbc::PrefetchRange> prefetchTable_{};
+
   /// Pointer to the global debug info. This will not be eagerly initialized
   /// when loading bytecode from a buffer. Instead it will be constructed
   /// when first needed. Most likely we should never need to use it.
@@ -196,6 +213,27 @@ class BCProviderBase {
   llvm::ArrayRef<uint32_t> getCJSModuleTableStatic() const {
     return cjsModuleTableStatic_;
   }
+  llvm::ArrayRef<hbc::SegmentTableEntry> getSegmentTable() const {
+    return segmentTable_;
+  }
+  llvm::ArrayRef<hbc::PrefetchRange> getPrefetchTable() const {
+    return prefetchTable_;
+  }
+  /// \return the IDs of the CommonJS modules statically required by the
+  /// module at \p index in the static module table, in the order they are
+  /// first required.
+  llvm::ArrayRef<uint32_t> getCJSModuleDependencies(uint32_t index) const {
+    auto offsets = cjsModuleDependencyOffsets_;
+    if (index >= offsets.size())
+      return {};
+    // Loading doesn't check the offsets, so keep them in bounds.
+    size_t size = cjsModuleDependencies_.size();
+    size_t end = index + 1 < offsets.size()
+        ? std::min<size_t>(offsets[index + 1], size)
+        : size;
+    size_t begin = std::min<size_t>(offsets[index], end);
+    return cjsModuleDependencies_.slice(begin, end - begin);
+  }
   const std::string getErrorStr() const {
     return errstr_;
   }
@@ -255,9 +293,17 @@ class BCProviderBase {
   /// Check whether the whole data provider is lazy.
   virtual bool isLazy() const = 0;
 
-  /// Read some bytecode into OS page cache (only implemented for buffers).
+  /// Read some bytecode into OS page cache (only implemented for buffers):
+  /// the ranges of the prefetch table if there is one, else the first
+  /// \p percent of the file.
   virtual void startWarmup(uint8_t percent) {}
 
+  /// Read in the parts of the bytecode which loading it into a runtime and
+  /// running its global function touch, and wait for the reads to complete
+  /// (only implemented for buffers). Meant to be called on a thread other
+  /// than the one that will run the bytecode.
+  virtual void readInForLoad() {}
+
   /// Issue an madvise call (only implemented for buffers).
   virtual void madvise(oscompat::MAdvice advice) {}
 
@@ -273,6 +319,11 @@ class BCProviderBase {
   /// soon.  Only forwards this information to the OS for buffers.
   virtual void willNeedStringTable() {}
 
+  /// Advise the provider that the function \p functionID is going to be run
+  /// soon, so that its bytecode can be read in ahead of time. Only forwards
+  /// this information to the OS for buffers.
+  virtual void willNeedFunction(uint32_t functionID) {}
+
   /// Advise the provider that identifier translations are no longer needed.
   /// Only forwards this information to the OS for buffers.
   virtual void dontNeedIdentifierTranslations() {}
@@ -343,11 +394,38 @@ class BCProviderFromBuffer final : public BCProviderBase {
 
   std::unique_ptr<volatile PageAccessTracker> tracker_;
 
+  /// If the file is in compressed form, the file itself. buffer_ then holds
+  /// the execution form it expands to, whose blocks of function bodies are
+  /// only expanded when one of their functions is first needed.
+  std::unique_ptr<const Buffer> compressed_;
+
+  /// For each block of a compressed file, whether it has been expanded.
+  std::unique_ptr<std::atomic<bool>[]> expandedBlocks_;
+
+  /// Held while expanding a block, so a block is only expanded once when
+  /// several threads need it.
+  mutable std::mutex expandMutex_;
+
   /// Tells any running warmup thread to abort and then joins that thread.
   void stopWarmup();
 
   explicit BCProviderFromBuffer(std::unique_ptr<const Buffer> buffer);
 
+  /// Replace the compressed file in buffer_ with the execution form it
+  /// expands to, expanding every block that isn't made only of function
+  /// bodies. 
+eturn false and set errstr_ if the file is malformed.
+  bool openCompressed();
+
+  /// Expand block \p index of the compressed file into buffer_.
+  /// 
+eturn false if the block is malformed.
+  bool expandBlock(uint32_t index) const;
+
+  /// Make sure the blocks holding the \p size bytes at \p offset in the
+  /// execution form of a compressed file have been expanded.
+  void expandBlocks(uint32_t offset, uint32_t size) const;
+
   void createDebugInfo() override;
 
   /// Helper function to fetch the exception table data given \p functionID.
@@ -367,8 +445,11 @@ class BCProviderFromBuffer final : public BCProviderBase {
     return {errstr.empty() ? std::move(ret) : nullptr, errstr};
   }
 
-  /// Checks whether the data is actually bytecode.
+  /// Checks whether the data is actually bytecode, in execution or compressed
+  /// form.
   static bool isBytecodeStream(llvm::ArrayRef<uint8_t> aref) {
+    if (isCompressedBytecodeStream(aref))
+      return true;
     const auto *header =
         reinterpret_cast<const hbc::BytecodeFileHeader *>(aref.data());
     return (
@@ -376,6 +457,15 @@ class BCProviderFromBuffer final : public BCProviderBase {
         header->magic == hbc::MAGIC);
   }
 
+  /// Checks whether the data is bytecode in compressed form.
+  static bool isCompressedBytecodeStream(llvm::ArrayRef<uint8_t> aref) {
+    const auto *header =
+        reinterpret_cast<const hbc::CompressedBytecodeHeader *>(aref.data());
+    return (
+        aref.size() >= sizeof(hbc::CompressedBytecodeHeader) &&
+        header->magic == hbc::COMPRESSED_MAGIC);
+  }
+
   /// Checks whether the buffer is actually bytecode.
   static bool isBytecodeStream(const Buffer &buffer) {
     return isBytecodeStream(
@@ -400,6 +490,15 @@ class BCProviderFromBuffer final : public BCProviderBase {
       llvm::ArrayRef<uint8_t> aref,
       std::string *errorMessage = nullptr);
 
+  /// Like bytecodeStreamSanityCheck(), but also checks that every string,
+  /// function header, exception table and instruction in aref is in bounds.
+  /// Loading only checks the file header, so that its cost doesn't grow with
+  /// the number of functions; this is meant for validating untrusted bytecode
+  /// offline.
+  static bool bytecodeStreamStrictCheck(
+      llvm::ArrayRef<uint8_t> aref,
+      std::string *errorMessage = nullptr);
+
   /// Returns the arrayref to small function headers;
   /// this is also the start of the function header section.
   const llvm::ArrayRef<hbc::SmallFuncHeader> getSmallFunctionHeaders() const {
@@ -445,7 +544,10 @@ class BCProviderFromBuffer final : public BCProviderBase {
   }
 
   const uint8_t *getBytecode(uint32_t functionID) const override {
-    return bufferPtr_ + getFunctionHeader(functionID).offset();
+    RuntimeFunctionHeader header = getFunctionHeader(functionID);
+    if (LLVM_UNLIKELY(compressed_))
+      expandBlocks(header.offset(), header.bytecodeSizeInBytes());
+    return bufferPtr_ + header.offset();
   }
 
   llvm::ArrayRef<hbc::HBCExceptionHandlerInfo> getExceptionTable(
@@ -461,11 +563,13 @@ class BCProviderFromBuffer final : public BCProviderBase {
   SHA1 getSourceHash() const override;
 
   void startWarmup(uint8_t percent) override;
+  void readInForLoad() override;
 
   void madvise(oscompat::MAdvice advice) override;
   void adviseStringTableSequential() override;
   void adviseStringTableRandom() override;
   void willNeedStringTable() override;
+  void willNeedFunction(uint32_t functionID) override;
   void dontNeedIdentifierTranslations() override;
 
   void startPageAccessTracker() override;
@@ -296,6 +296,9 @@ class BytecodeDisassembler {
   /// if it contains any entries.
   void disassembleCJSModuleTable(raw_ostream &OS);
 
+  /// Print the ranges of the prefetch table to \p OS, if there are any.
+  void disassemblePrefetchTable(raw_ostream &OS);
+
   /// Print the content of the exception handler table into \p OS.
   void disassembleExceptionHandlers(unsigned funcId, raw_ostream &OS);
 
@@ -15,6 +15,7 @@
 #include "hermes/Support/StringTableEntry.h"
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 
@@ -28,9 +29,19 @@ const static uint64_t MAGIC = 0x1F1903C103BC1FC6;
 // bytecode file is in a form suitable for delta diffing, not execution.
 const static uint64_t DELTA_MAGIC = ~MAGIC;
 
+// The compressed form: a bytecode file in execution form, split into blocks
+// which are compressed separately so they can be expanded on demand.
+const static uint64_t COMPRESSED_MAGIC = MAGIC ^ 0x504D4F43;
+
+/// Number of bytes of the execution form held by each compressed block.
+static constexpr uint32_t COMPRESSED_BLOCK_SIZE = 64 * 1024;
+
+// A patch turning one bytecode file in delta form into another.
+const static uint64_t PATCH_MAGIC = MAGIC ^ 0x48435450;
+
 // Bytecode version generated by this version of the compiler.
-// Updated: Nov 21, 2019
-const static uint32_t BYTECODE_VERSION = 72;
+// Updated: Oct 15, 2026
+const static uint32_t BYTECODE_VERSION = 87;
 
 /// Property cache index which indicates no caching.
 static constexpr uint8_t PROPERTY_CACHING_DISABLED = 0;
@@ -87,12 +98,19 @@ struct BytecodeFileHeader {
   uint32_t objValueBufferSize;
   uint32_t cjsModuleOffset; // The starting module ID in this segment.
   uint32_t cjsModuleCount; // Number of modules.
+  uint32_t segmentCount; // Number of entries in the segment table.
+  uint32_t cjsModuleDependencyCount; // Number of module dependencies.
+  uint32_t prefetchRangeCount; // Number of entries in the prefetch table.
   uint32_t debugInfoOffset;
+  uint32_t prefetchTableOffset;
   BytecodeOptions options;
+  // Checksum of the fields from version up to this one, which locate every
+  // section of the file. See computeLayoutChecksum().
+  uint32_t layoutChecksum;
 
   // Insert any padding to make function headers that follow this file header
   // less likely to cross cache lines.
-  uint8_t padding[31];
+  uint8_t padding[11];
 
   BytecodeFileHeader(
       uint64_t magic,
@@ -113,7 +131,11 @@ struct BytecodeFileHeader {
       uint32_t objValueBufferSize,
       uint32_t cjsModuleOffset,
       uint32_t cjsModuleCount,
+      uint32_t segmentCount,
+      uint32_t cjsModuleDependencyCount,
+      uint32_t prefetchRangeCount,
       uint32_t debugInfoOffset,
+      uint32_t prefetchTableOffset,
       BytecodeOptions options)
       : magic(magic),
         version(version),
@@ -133,10 +155,30 @@ struct BytecodeFileHeader {
         objValueBufferSize(objValueBufferSize),
         cjsModuleOffset(cjsModuleOffset),
         cjsModuleCount(cjsModuleCount),
+        segmentCount(segmentCount),
+        cjsModuleDependencyCount(cjsModuleDependencyCount),
+        prefetchRangeCount(prefetchRangeCount),
         debugInfoOffset(debugInfoOffset),
+        prefetchTableOffset(prefetchTableOffset),
         options(options) {
     std::copy(sourceHash.begin(), sourceHash.end(), this->sourceHash);
     std::fill(padding, padding + sizeof(padding), 0);
+    layoutChecksum = computeLayoutChecksum();
+  }
+
+  /// \return the FNV-1a hash of the header from version up to layoutChecksum.
+  /// The magic number is left out so converting between bytecode forms
+  /// doesn't invalidate the checksum.
+  uint32_t computeLayoutChecksum() const {
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(this);
+    uint32_t hash = 2166136261u;
+    for (size_t i = sizeof(magic),
+                e = offsetof(BytecodeFileHeader, layoutChecksum);
+         i < e;
+         ++i) {
+      hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
   }
 };
 
@@ -343,7 +385,9 @@ struct ExceptionHandlerTableHeader {
 };
 
 /// We need HBCExceptionHandlerInfo other than using ExceptionHandlerInfo
-/// directly because we don't need depth in HBC.
+/// directly because we don't need depth in HBC. The handlers of a function
+/// don't overlap and are sorted by their start, so that the handler of an
+/// offset can be found with a binary search.
 struct HBCExceptionHandlerInfo {
   uint32_t start;
   uint32_t end;
@@ -365,6 +409,24 @@ struct DebugInfoHeader {
   uint32_t debugDataSize;
 };
 
+/// An entry of the segment table: the statically resolved CommonJS modules
+/// compiled into one segment of a split bundle. Every segment of the bundle
+/// lists all of them, so that the runtime can find the segment to load when a
+/// module is required before its segment has been loaded.
+struct SegmentTableEntry {
+  uint32_t segment;
+  uint32_t firstModule;
+  uint32_t moduleCount;
+};
+
+/// A range of the file read during startup. The prefetch table at the end of
+/// the file lists them in the order they were first touched in a traced run,
+/// so that warmup reads exactly them instead of a prefix of the file.
+struct PrefetchRange {
+  uint32_t offset;
+  uint32_t length;
+};
+
 // The string id of files for given offsets in debug info.
 struct DebugFileRegion {
   uint32_t fromAddress;
@@ -372,6 +434,57 @@ struct DebugFileRegion {
   uint32_t sourceMappingUrlId;
 };
 
+/// Header of a bytecode file in compressed form. It is followed by blockCount
+/// CompressedBlockEntry and then by the LZ4 compressed blocks. Block i expands
+/// to the bytes [i * blockSize, (i + 1) * blockSize) of the execution form
+/// file, the last block holding whatever remains of its fileLength bytes.
+struct CompressedBytecodeHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint8_t sourceHash[SHA1_NUM_BYTES];
+  // Length of the execution form file once expanded.
+  uint32_t fileLength;
+  // Length of the compressed file, which may be followed by an epilogue.
+  uint32_t compressedLength;
+  uint32_t blockSize;
+  uint32_t blockCount;
+  // The range of the execution form holding function bodies. Blocks entirely
+  // inside it are expanded when a function in them is first needed, all
+  // others when the file is loaded.
+  uint32_t lazyStart;
+  uint32_t lazyEnd;
+};
+
+// The location of a compressed block, relative to the start of the file.
+struct CompressedBlockEntry {
+  uint32_t offset;
+  uint32_t size;
+};
+
+/// Header of a patch turning a base bytecode file into an updated one. It is
+/// followed by chunkCount BytecodePatchChunk, in order. Each chunk supplies the
+/// next bytes of the updated file in delta form, either copied from the base
+/// file in delta form or stored in the patch right after the chunk.
+struct BytecodePatchHeader {
+  uint64_t magic;
+  uint32_t version;
+  // Identify the base file the patch applies to.
+  uint8_t baseSourceHash[SHA1_NUM_BYTES];
+  uint32_t baseFileLength;
+  // Length of the updated file.
+  uint32_t fileLength;
+  uint32_t chunkCount;
+};
+
+struct BytecodePatchChunk {
+  // Offset of the bytes in the base file, or ADDED_BYTES if they follow the
+  // chunk in the patch.
+  uint32_t baseOffset;
+  uint32_t length;
+
+  static constexpr uint32_t ADDED_BYTES = UINT32_MAX;
+};
+
 LLVM_PACKED_END
 
 /// Visit each segment in a bytecode file in order.
@@ -390,6 +503,8 @@ void visitBytecodeSegmentsInOrder(Visitor &visitor) {
   visitor.visitRegExpTable();
   visitor.visitRegExpStorage();
   visitor.visitCJSModuleTable();
+  visitor.visitSegmentTable();
+  visitor.visitCJSModuleDependencyTable();
 }
 
 /// BytecodeFileFields represents direct byte-level access to the structured
@@ -450,6 +565,20 @@ struct BytecodeFileFields {
   /// List of resolved CJS modules.
   Array<uint32_t> cjsModuleTableStatic;
 
+  /// The modules of each segment of the bundle.
+  Array<SegmentTableEntry> segmentTable;
+
+  /// For each resolved CJS module, the index in cjsModuleDependencies of its
+  /// first dependency. Its dependencies end where those of the next module
+  /// start.
+  Array<uint32_t> cjsModuleDependencyOffsets;
+
+  /// The IDs of the CJS modules statically required by each resolved module.
+  Array<uint32_t> cjsModuleDependencies;
+
+  /// The ranges of the file to read ahead during startup.
+  Array<PrefetchRange> prefetchTable;
+
   /// Populate bytecode file fields from a buffer. The fields will point
   /// directly into the buffer and it is the caller's responsibility to ensure
   /// the result does not outlive the buffer.
@@ -67,7 +67,8 @@ class BytecodeFunctionGenerator : public BytecodeInstructionGenerator {
   // The bytecode module generator.
   BytecodeModuleGenerator &BMGen_;
 
-  /// Exception handler table.
+  /// Exception handler table. The first handler covering an offset handles
+  /// it; the table is sorted when the function is generated.
   std::vector<HBCExceptionHandlerInfo> exceptionHandlers_{};
 
   /// Size of the frame on stack (i.e. number of virtual registers used).
@@ -273,6 +274,16 @@ class BytecodeModuleGenerator {
   /// List of function indices.
   std::vector<uint32_t> cjsModulesStatic_;
 
+  /// For each resolved CJS module, the index of its first dependency in
+  /// cjsModuleDependencies_.
+  std::vector<uint32_t> cjsModuleDependencyOffsets_;
+
+  /// The IDs of the modules statically required by the resolved CJS modules.
+  std::vector<uint32_t> cjsModuleDependencies_;
+
+  /// The statically resolved CJS modules of each segment of the bundle.
+  std::vector<SegmentTableEntry> segmentTable_;
+
   /// Table of constants used to initialize constant arrays.
   /// They are stored as chars in order to shorten bytecode size.
   std::vector<unsigned char> arrayBuffer_{};
@@ -360,7 +371,18 @@ class BytecodeModuleGenerator {
 
   /// Adds a statically-resolved CJS module entry to the table.
   /// \param moduleID the index of the CJS module (incremented each call).
-  void addCJSModuleStatic(uint32_t moduleID, uint32_t functionID);
+  /// \param dependencies the IDs of the modules it statically requires.
+  void addCJSModuleStatic(
+      uint32_t moduleID,
+      uint32_t functionID,
+      llvm::ArrayRef<uint32_t> dependencies = {});
+
+  /// Adds the statically resolved CJS modules [firstModule, firstModule +
+  /// moduleCount) of \p segment to the segment table.
+  void
+  addSegment(uint32_t segment, uint32_t firstModule, uint32_t moduleCount) {
+    segmentTable_.push_back({segment, firstModule, moduleCount});
+  }
 
   /// Returns the starting offset of the elements.
   uint32_t addArrayBuffer(ArrayRef<Literal *> elements);
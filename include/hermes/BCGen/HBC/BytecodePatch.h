@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_BCGEN_HBC_BYTECODEPATCH_H
+#define HERMES_BCGEN_HBC_BYTECODEPATCH_H
+
+#include "hermes/BCGen/HBC/BytecodeFileFormat.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+
+namespace hermes {
+namespace hbc {
+
+/// Write to \p OS a patch (see BytecodePatchHeader) turning the bytecode file
+/// \p base into \p updated, both in execution form. The files are compared in
+/// delta form one section at a time, and only the bytes which differ between
+/// the start and the end of a section are stored in the patch.
+/// \return true if successful, false if a file could not be interpreted, in
+/// which case an error is returned in \p outError.
+bool createBytecodePatch(
+    llvm::ArrayRef<uint8_t> base,
+    llvm::ArrayRef<uint8_t> updated,
+    llvm::raw_ostream &OS,
+    std::string *outError);
+
+/// Apply \p patch to the bytecode file in execution form at \p basePath, and
+/// write the updated file in execution form to \p outPath, which may be
+/// \p basePath. The files are mapped rather than read into memory, and the
+/// updated file is written next to \p outPath, then renamed over it once
+/// complete, so that \p outPath always holds a whole file.
+/// \return true if successful, false if the patch doesn't apply to the base
+/// file or a file could not be accessed, in which case an error is returned
+/// in \p outError.
+bool applyBytecodePatch(
+    llvm::StringRef basePath,
+    llvm::ArrayRef<uint8_t> patch,
+    llvm::StringRef outPath,
+    std::string *outError);
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMES_BCGEN_HBC_BYTECODEPATCH_H
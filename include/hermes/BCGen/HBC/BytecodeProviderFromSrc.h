@@ -10,9 +10,15 @@
 
 #include "hermes/BCGen/HBC/Bytecode.h"
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+#include "hermes/Support/SHA1.h"
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Optional.h"
 
+#include <memory>
+#include <mutex>
+#include <string>
+
 namespace hermes {
 namespace hbc {
 
@@ -36,6 +42,10 @@ struct CompileFlags {
   /// Include libhermes declarations when compiling the file. This is done in
   /// normal compilation, but not for eval().
   bool includeLibHermes{true};
+  /// If not empty, the directory where the lazily compiled functions are
+  /// stored, so that later compilations of the same source can load them
+  /// instead of compiling them again. It must already exist.
+  std::string lazyCacheDir{};
 };
 
 // The minimum code size in bytes before enabling lazy compilation.
@@ -46,6 +56,84 @@ struct CompileFlags {
 static constexpr unsigned kDefaultSizeThresholdForLazyCompilation = 1 << 16;
 
 #ifndef HERMESVM_LEAN
+class BCProviderFromSrc;
+
+/// The compiled lazy functions of a module compiled from source. Every
+/// runtime running the module, possibly on another thread, uses the bytecode
+/// compiled by the first one that called the function, and keeps only its own
+/// GC-owned state, such as the CodeBlocks and string IDs.
+///
+/// The lazy functions of a source share the compiler state of its Context, so
+/// their compilations are serialized by the lock from \c lockCompiler().
+///
+/// If a directory is set with \c setDiskCacheDir(), the compiled functions
+/// are also stored there as bytecode files, named after a hash of the
+/// source, the compiler settings and the range of the function in the
+/// source. A later run of the same source loads them instead of compiling
+/// them again. Functions which contain lazy functions themselves are not
+/// stored, since those can only be compiled with the state of this run.
+class LazyFunctionCache {
+ public:
+  /// \return the lock that must be held to use the compiler state shared by
+  /// the lazy functions, such as their SourceErrorManager.
+  std::unique_lock<std::mutex> lockCompiler() {
+    return std::unique_lock<std::mutex>(compilerMtx_);
+  }
+
+  /// \return the compiled lazy function with the data \p lazyData, or null if
+  /// it hasn't been compiled yet.
+  std::shared_ptr<BCProviderBase> find(LazyCompilationData *lazyData);
+
+  /// Record \p compiled as the compiled lazy function with the data \p
+  /// lazyData.
+  /// \return the compiled function to use, which is the one recorded first if
+  /// several runtimes compiled it concurrently.
+  std::shared_ptr<BCProviderBase> insert(
+      LazyCompilationData *lazyData,
+      std::unique_ptr<BCProviderBase> compiled);
+
+  /// Store the lazy functions compiled from now on in the directory \p dir,
+  /// which must exist, and load them from there.
+  void setDiskCacheDir(std::string dir) {
+    diskCacheDir_ = std::move(dir);
+  }
+
+  /// \return the lazy function with the data \p lazyData stored on disk by
+  /// an earlier compilation of the same source, or null if there is none.
+  /// Acquires the compiler lock.
+  std::unique_ptr<BCProviderBase> load(LazyCompilationData *lazyData);
+
+  /// Store \p bcMod, compiled from \p lazyData, on disk. Failing to write it
+  /// is not an error. Acquires the compiler lock.
+  void store(LazyCompilationData *lazyData, BytecodeModule &bcMod);
+
+ private:
+  /// \return the hash identifying the function with the data \p lazyData
+  /// on disk, from the source, the compiler settings and the range of the
+  /// function. Requires the compiler lock.
+  SHA1 getDiskCacheKey(LazyCompilationData *lazyData);
+
+  /// \return the path of the file storing the function with the key \p key.
+  std::string getDiskCachePath(const SHA1 &key) const;
+
+  /// Held during every compilation.
+  std::mutex compilerMtx_;
+
+  /// Protects compiled_.
+  std::mutex mtx_;
+
+  /// The lazy functions compiled so far.
+  llvm::DenseMap<LazyCompilationData *, std::shared_ptr<BCProviderBase>>
+      compiled_{};
+
+  /// The directory where the compiled functions are stored, or empty.
+  std::string diskCacheDir_{};
+
+  /// The hash of every source buffer whose functions were stored or loaded,
+  /// by buffer ID. Protected by the compiler lock.
+  llvm::DenseMap<uint32_t, SHA1> sourceHashes_{};
+};
+
 /// BCProviderFromSrc is used when we are construction the bytecode from
 /// source compilation, i.e. we generate BytecodeModule/BytecodeFunction
 /// in this code path, and all the data are stored in those classes.
@@ -58,6 +146,10 @@ class BCProviderFromSrc final : public BCProviderBase {
   /// Whether the module constitutes a single function
   bool singleFunction_;
 
+  /// The compiled lazy functions of this module and of the functions compiled
+  /// from it, when this module was compiled from the source.
+  LazyFunctionCache lazyFunctions_{};
+
   explicit BCProviderFromSrc(std::unique_ptr<hbc::BytecodeModule> module);
 
   /// No need to do anything since it's already created as part of
@@ -163,6 +255,13 @@ class BCProviderFromSrc final : public BCProviderBase {
     return module_.get();
   }
 
+  /// \return the cache of the compiled lazy functions, shared by the runtimes
+  /// running this module. Lazy functions compiled from it use the cache of
+  /// the module of the source.
+  LazyFunctionCache &getLazyFunctionCache() {
+    return lazyFunctions_;
+  }
+
 #ifdef HERMESVM_SERIALIZE
   /// Serialize this BCProviderFromSrc.
   void serialize(vm::Serializer &s) const override;
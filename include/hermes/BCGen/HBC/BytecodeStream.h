@@ -52,6 +52,11 @@ class BytecodeSerializer {
   uint32_t debugInfoOffset_{0};
   /// Count of overflow string entries, computed during layout phase.
   uint32_t overflowStringEntryCount_{0};
+  /// Offset of the prefetch table.
+  uint32_t prefetchTableOffset_{0};
+  /// The entries of the prefetch table. Their number is the same in both
+  /// passes, but function bodies only have their final offsets in the second.
+  std::vector<PrefetchRange> prefetchRanges_{};
 
   /// Each subsection of a function's `info' section is aligned thusly.
   static constexpr uint32_t INFO_ALIGNMENT = 4;
@@ -98,6 +103,15 @@ class BytecodeSerializer {
 
   void serializeDebugOffsets(BytecodeFunction &BF);
 
+  /// \return the ranges of options_.startupReads in the file being written.
+  std::vector<PrefetchRange> getPrefetchRanges(BytecodeModule &BM) const;
+
+  void serializePrefetchTable();
+
+  /// \return the IDs of the functions of \p BM in the order their bodies are
+  /// laid out, which starts with options_.functionLayoutOrder.
+  std::vector<uint32_t> getFunctionLayoutOrder(BytecodeModule &BM) const;
+
   void serializeFunctionsBytecode(BytecodeModule &BM);
   void serializeFunctionInfo(BytecodeFunction &BF);
 
@@ -115,6 +129,8 @@ class BytecodeSerializer {
   void visitRegExpTable();
   void visitRegExpStorage();
   void visitCJSModuleTable();
+  void visitSegmentTable();
+  void visitCJSModuleDependencyTable();
 
  public:
   explicit BytecodeSerializer(
@@ -17,8 +17,11 @@
 #include "hermes/Support/OptValue.h"
 #include "hermes/Support/StringTable.h"
 #include "hermes/Support/UTF8.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Support/Format.h"
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -134,9 +137,26 @@ class DebugInfo {
   uint32_t lexicalDataOffset_ = 0;
   StreamVector<uint8_t> data_{};
 
+  /// The decoded locations of the functions which have been looked up, keyed
+  /// by their debug offset, so that each function is decoded at most once.
+  /// Lookups may come from several runtimes sharing this debug info, or from
+  /// a profiler thread, hence the mutex.
+  struct LocationCache {
+    std::mutex mutex;
+    llvm::DenseMap<uint32_t, std::vector<DebugSourceLocation>> functions;
+  };
+  std::unique_ptr<LocationCache> locationCache_{new LocationCache()};
+
+  /// The filenameId of a decoded location that is in no file.
+  static constexpr uint32_t kNoFilename = UINT32_MAX;
+
   /// Get source filename as string id.
   OptValue<uint32_t> getFilenameForAddress(uint32_t debugOffset) const;
 
+  /// Decode every location of the function at \p debugOffset, with a
+  /// filenameId of kNoFilename for the locations that are in no file.
+  std::vector<DebugSourceLocation> decodeLocations(uint32_t debugOffset) const;
+
  public:
   explicit DebugInfo() = default;
   /*implicit*/ DebugInfo(DebugInfo &&that) = default;
@@ -192,11 +212,17 @@ class DebugInfo {
   }
 
   /// Get the location of \p offsetInFunction, given the function's debug
-  /// offset.
+  /// offset. The function's locations are decoded on its first lookup and
+  /// binary searched afterwards.
   OptValue<DebugSourceLocation> getLocationForAddress(
       uint32_t debugOffset,
       uint32_t offsetInFunction) const;
 
+  /// Get every location of the function, given the function's debug offset.
+  /// \return the locations sorted by address.
+  std::vector<DebugSourceLocation> getLocationsForFunction(
+      uint32_t debugOffset) const;
+
   /// Given a \p targetLine and optional \p targetColumn,
   /// find a bytecode address at which that location is listed in debug info.
   /// If \p targetColumn is None, then it tries to match at the first location
@@ -16,6 +16,7 @@
 #include "hermes/Utils/Dumper.h"
 #include "hermes/Utils/Options.h"
 
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/DenseMap.h"
 
 namespace hermes {
@@ -61,6 +62,10 @@ class HBCISel {
     /// The i'th index indicates which basic block should be jumped to for value
     /// i
     std::vector<BasicBlock *> table;
+
+    /// The key of every slot of a hashed jump table, emitted before the table.
+    /// Empty for SwitchImm.
+    std::vector<uint32_t> keys;
   };
 
   /// The function that we are compiling.
@@ -94,25 +99,61 @@ class HBCISel {
   /// Mapping from CatchInst to the catch coverage information.
   CatchInfoMap catchInfoMap_{};
 
-  /// Map from SwitchImm -> (inst offset, default block, jump table).
-  llvm::DenseMap<SwitchImmInst *, SwitchImmInfo> switchImmInfo_{};
+  /// The registers live at the start of each basic block, computed on the
+  /// first SaveAndYieldInst of a generator function.
+  llvm::DenseMap<BasicBlock *, llvm::BitVector> liveRegistersIn_{};
+
+  /// Map from SwitchImm or SwitchHash -> (inst offset, default block, jump
+  /// table, keys).
+  llvm::DenseMap<TerminatorInst *, SwitchImmInfo> switchImmInfo_{};
   using switchInfoEntry =
-      llvm::DenseMap<SwitchImmInst *, SwitchImmInfo>::iterator::value_type;
+      llvm::DenseMap<TerminatorInst *, SwitchImmInfo>::iterator::value_type;
 
   /// Saved identifier of "__proto__" for fast comparisons.
   Identifier protoIdent_{};
 
+  /// Whether to thread jumps, fold branches on constants, drop redundant Movs
+  /// and fuse environment accesses while emitting the instructions.
+  bool peephole_;
+
+  /// Whether to read the properties of object literals created in the same
+  /// function with GetByIdSlot, at the slot they have in the literal.
+  bool literalSlots_;
+
+  /// The location right after the last emitted Mov, or ~0 if it can't be
+  /// relied on, and the registers it copied between.
+  offset_t lastMovEnd_{~offset_t(0)};
+  param_t lastMovDest_{0};
+  param_t lastMovSrc_{0};
+
+  /// The next instruction of the block, if it was already emitted as part of
+  /// a fused instruction.
+  Instruction *fusedNext_{nullptr};
+
   /// Encode a value into a param_t type.
   unsigned encodeValue(Value *);
 
+  /// Compute liveRegistersIn_ from the final instructions and registers. An
+  /// exception may leave any instruction covered by a catch, so the registers
+  /// live at the catch are live throughout the covered blocks.
+  void computeLiveRegisters();
+
+  /// \return the number of registers, counted from the first one, that hold
+  /// all the values live at the start of \p BB.
+  unsigned getLiveRegisterCount(BasicBlock *BB);
+
   /// Resolve the offset of every relocation.
   void resolveRelocations();
 
   /// Add long jump instruction to the relocation list.
   void registerLongJump(offset_t loc, BasicBlock *target);
 
+  /// \return the block that a jump to \p BB ends up at, skipping the blocks
+  /// which do nothing but jump elsewhere, if peephole optimizations are on.
+  BasicBlock *getJumpTarget(BasicBlock *BB);
+
   /// Add a jump table switch to relocation list.
-  void registerSwitchImm(offset_t loc, SwitchImmInst *target);
+  void registerSwitchImm(offset_t loc, TerminatorInst *target);
 
   /// Resolve all exception handlers.
   void resolveExceptionHandlers();
@@ -140,6 +181,16 @@ class HBCISel {
   /// Emit a mov, or none if it would be a no-op.
   void emitMovIfNeeded(param_t dest, param_t src);
 
+  /// If the instruction after \p Inst loads from or stores to the environment
+  /// it resolves, emit both as one instruction which puts the environment in
+  /// \p envReg, \p level levels up the stack, and record the access in
+  /// fusedNext_.
+  /// \return whether the instructions were fused.
+  bool fuseEnvironmentAccess(
+      HBCResolveEnvironment *Inst,
+      param_t envReg,
+      uint8_t level);
+
   /// Emit an Unreachable opcode in debug builds, otherwise do nothing.
   void emitUnreachableIfDebug();
 
@@ -159,6 +210,12 @@ class HBCISel {
   uint8_t acquirePropertyReadCacheIndex(unsigned id);
   uint8_t acquirePropertyWriteCacheIndex(unsigned id);
 
+  /// Try to emit a GetByIdSlot for the load \p Inst of the property with the
+  /// identifier \p id. \return false if its object isn't a literal which has
+  /// the property in a known slot, or no cache index is left.
+  bool
+  tryEmitGetByIdSlot(LoadPropertyInst *Inst, LiteralString *prop, unsigned id);
+
   // Looking up filename/sourcemap id for each instruction is pretty slow,
   // and it's almost always from the same bufId every time. Cache the previous
   // result here, to reuse it when possible.
@@ -172,12 +229,24 @@ class HBCISel {
   /// C'tor.
   /// \p F is the function that we are constructing.
   /// \p OS is the output stream.
+  /// \p peephole enables peephole optimizations of the emitted instructions,
+  /// unless full debug info is emitted.
+  /// \p literalSlots enables GetByIdSlot for the loads from object literals.
   HBCISel(
       Function *F,
       BytecodeFunctionGenerator *BCFGen,
       HVMRegisterAllocator &RA,
-      FunctionScopeAnalysis &scopeAnalysis)
-      : F_(F), BCFGen_(BCFGen), RA_(RA), scopeAnalysis_(scopeAnalysis) {
+      FunctionScopeAnalysis &scopeAnalysis,
+      bool peephole = false,
+      bool literalSlots = false)
+      : F_(F),
+        BCFGen_(BCFGen),
+        RA_(RA),
+        scopeAnalysis_(scopeAnalysis),
+        peephole_(
+            peephole &&
+            F->getContext().getDebugInfoSetting() != DebugInfoSetting::ALL),
+        literalSlots_(literalSlots) {
     protoIdent_ = F->getContext().getIdentifier("__proto__");
   }
 
@@ -201,6 +270,11 @@ class HBCISel {
 
   /// Generate the bytecode stream for the function.
   void generate(SourceMapGenerator *outSourceMap);
+
+  /// \return whether the builtin call \p Inst is emitted as an instruction
+  /// which computes the result inline, like MathFloor, rather than as a
+  /// CallBuiltin. Its arguments then stay in their own registers.
+  static bool isInlineBuiltinCall(CallBuiltinInst *Inst);
 };
 
 } // namespace hbc
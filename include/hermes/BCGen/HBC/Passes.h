@@ -48,12 +48,23 @@ class LoadParameters : public FunctionPass {
 };
 
 /// Lower LoadFrameInst, StoreFrameInst and CreateFunctionInst.
+///
+/// With the flattenEnvironments optimization setting, a function whose scope
+/// holds no captured variables uses the environment it was created in instead
+/// of creating its own, and the environments of the outer scopes accessed more
+/// than once are resolved once, on entry.
 class LowerLoadStoreFrameInst : public FunctionPass {
+  /// The environments of outer scopes resolved on entry to the function being
+  /// lowered.
+  llvm::DenseMap<VariableScope *, Instruction *> entryEnvironments_{};
+
   /// Decide the correct scope to use when dealing with given variable.
-  Instruction *getScope(
-      IRBuilder &builder,
-      Variable *var,
-      HBCCreateEnvironmentInst *captureScope);
+  Instruction *
+  getScope(IRBuilder &builder, Variable *var, Instruction *captureScope);
+
+  /// Resolve on entry to \p F the environments of the outer scopes which
+  /// it accesses more than once, into entryEnvironments_.
+  void resolveEntryEnvironments(IRBuilder &builder, Function *F);
 
  public:
   explicit LowerLoadStoreFrameInst()
@@ -67,6 +78,12 @@ class LowerArgumentsArray : public FunctionPass {
  private:
   CreateArgumentsInst *getCreateArgumentsInst(Function *F);
 
+  /// Replace the calls that only pass \p createArguments along, like
+  /// `fn.apply(this, arguments)`, with builtin calls that read the parameters
+  /// from the frame, if nothing else can observe the arguments object.
+  /// \return true if anything changed.
+  bool forwardArguments(Function *F, CreateArgumentsInst *createArguments);
+
  public:
   explicit LowerArgumentsArray() : FunctionPass("LowerArgumentsArray") {}
   ~LowerArgumentsArray() override = default;
@@ -177,8 +194,9 @@ class SpillRegisters : public FunctionPass {
 
 /// Attempt to lower a switch statement into a jump table.
 /// Must be run prior to the pass lowering switches into linear search.
-/// Currently this only affects switches that are suffciently dense and with
-/// positive cases.
+/// Switches that are suffciently dense and with positive cases are indexed
+/// directly. Other switches on only strings or only int32 numbers use a hashed
+/// table, when their cases hash to different slots of a small enough one.
 class LowerSwitchIntoJumpTables : public FunctionPass {
  public:
   explicit LowerSwitchIntoJumpTables()
@@ -188,6 +206,7 @@ class LowerSwitchIntoJumpTables : public FunctionPass {
 
  private:
   bool lowerIntoJumpTable(SwitchInst *switchInst);
+  bool lowerIntoHashTable(SwitchInst *switchInst);
 };
 
 } // namespace hbc
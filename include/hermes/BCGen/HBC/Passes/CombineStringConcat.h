@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_BCGEN_HBC_PASSES_COMBINESTRINGCONCAT_H
+#define HERMES_BCGEN_HBC_PASSES_COMBINESTRINGCONCAT_H
+
+#include "hermes/Optimizer/PassManager/Pass.h"
+
+namespace hermes {
+namespace hbc {
+
+/// Replace chains of additions producing strings, like `a + ", " + b + "!"`,
+/// with a single StringConcatInst, which allocates only the final string
+/// instead of one for every addition.
+class CombineStringConcat : public FunctionPass {
+ public:
+  explicit CombineStringConcat() : FunctionPass("CombineStringConcat") {}
+
+  bool runOnFunction(Function *F) override;
+};
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMES_BCGEN_HBC_PASSES_COMBINESTRINGCONCAT_H
@@ -28,7 +28,7 @@ namespace hbc {
 ///    ...
 ///   -3    callee local0    : HermesValue
 ///   -2    scratch          : HermesValue
-///   -1    debugEnvironment : Environment*
+///   -1    debugEnvironment : Environment*              -- debugger only
 ///    ----------------------------------------------
 ///    0    previousFrame    : NativeValue(HermesValue*) -- calleeFramePtr
 ///    1    savedIP          : NativeValue(void*)
@@ -67,7 +67,8 @@ namespace hbc {
 /// - The caller saves the current CodeBlock, IP and frame offset in the
 /// corresponding fields.
 /// - "debugEnvironment" is initialized to "undefined". (It will be populated
-/// later by the callee.)
+/// later by the callee.) The slot only exists when the debugger is enabled;
+/// without it "scratch" is at -1 and the locals start at -2.
 /// - Execution is transferred to callee.
 /// - The callee updates the global "frame" register to point to the top of the
 /// stack, i.e. the row labelled "0" in the table.
@@ -82,6 +83,7 @@ namespace hbc {
 ///
 struct StackFrameLayout {
   enum {
+#ifdef HERMES_ENABLE_DEBUGGER
     /// Offset of the first local register.
     FirstLocal = -3,
     /// A scratch register for use by the VM.
@@ -94,6 +96,13 @@ struct StackFrameLayout {
     /// is stored in the call frame so that the debugger can gain access to the
     /// Environment at arbitrary frames. Note this is managed by the GC.
     DebugEnvironment = -1,
+#else
+    /// Without the debugger nothing reads the debug environment, so the slot
+    /// is left out and every call allocates and initializes one register
+    /// less.
+    FirstLocal = -2,
+    Scratch = -1,
+#endif
     /// Saved value of the caller's "frame" register, which points to the first
     /// register of the caller's stack frame.
     PreviousFrame = 0,
@@ -128,7 +137,7 @@ struct StackFrameLayout {
 
     /// The number of additional registers the callee needs to allocate in the
     /// beginning of its frame.
-    CalleeExtraRegistersAtStart = DebugEnvironment - Scratch + 1,
+    CalleeExtraRegistersAtStart = -FirstLocal - 1,
 
     /// Direction of the stack.
     StackIncrement = -1,
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file defines how the cases of the SwitchStr and SwitchSparse
+/// instructions are laid out in their hashed jump tables. It must be shared
+/// between the compiler and the VM.
+//===----------------------------------------------------------------------===//
+#ifndef HERMES_BCGEN_HBC_SWITCHHASH_H
+#define HERMES_BCGEN_HBC_SWITCHHASH_H
+
+#include "hermes/Support/HashString.h"
+#include "hermes/Support/UTF8.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <cstdint>
+#include <iterator>
+
+namespace hermes {
+namespace hbc {
+
+/// The largest number of slots of a hashed jump table, for every case in it.
+/// A switch whose cases don't hash to distinct slots within this limit is not
+/// lowered into one.
+constexpr uint32_t SWITCH_HASH_MAX_SLOTS_PER_CASE = 8;
+
+/// \return the hash of the string \p str in a hashed jump table. A case is in
+/// slot hash & (numSlots - 1). This is the hash stored for identifiers in the
+/// string table, so it is the same for ASCII and UTF-16 strings.
+template <typename T>
+inline uint32_t hashSwitchString(llvm::ArrayRef<T> str) {
+  return hashString(str);
+}
+
+/// \return the hash of the UTF-8 string \p str, which may contain encoded
+/// surrogates, as it is computed by the VM once the string is loaded.
+inline uint32_t hashSwitchString(llvm::StringRef str) {
+  if (isAllASCII(str.begin(), str.end()))
+    return hashSwitchString(llvm::ArrayRef<char>(str.data(), str.size()));
+  llvm::SmallVector<char16_t, 32> utf16;
+  convertUTF8WithSurrogatesToUTF16(
+      std::back_inserter(utf16), str.begin(), str.end());
+  return hashSwitchString(llvm::ArrayRef<char16_t>(utf16));
+}
+
+/// \return the hash of the integer \p key in a hashed jump table. The key is
+/// mixed so that the low bits depend on all of it, since sparse cases are
+/// often multiples of each other.
+/// NOTE: If this is changed, the bytecode version must be bumped.
+inline uint32_t hashSwitchInt32(int32_t key) {
+  uint32_t hash = (uint32_t)key;
+  hash = (hash ^ (hash >> 16)) * 0x45d9f3b;
+  hash = (hash ^ (hash >> 16)) * 0x45d9f3b;
+  return hash ^ (hash >> 16);
+}
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMES_BCGEN_HBC_SWITCHHASH_H
@@ -78,9 +78,10 @@ class Register {
 /// live registers and knows how to recycle registers.
 class RegisterFile {
   // Notice that in a few places we rely on the fact that the register file
-  // can only grow (and not shrink). This is how we keep track of the max number
-  // of allocated register. There is no need to shrink the register file because
-  // the compile time wins are negligable.
+  // can only grow (and not shrink) during allocation. This is how we keep track
+  // of the max number of allocated register. There is no need to shrink the
+  // register file because the compile time wins are negligable. It only
+  // shrinks when registers are compacted after allocation.
   llvm::BitVector registers;
 
  public:
@@ -104,6 +105,9 @@ class RegisterFile {
   /// Free the register \p reg and make it available for re-allocation.
   void killRegister(Register reg);
 
+  /// Drop all but the first \p n registers, which must all be free.
+  void shrink(unsigned n);
+
   /// \returns the number of currently allocated registers.
   unsigned getNumLiveRegisters() {
     return registers.size() - registers.count();
@@ -407,6 +411,15 @@ class RegisterAllocator {
   /// \return true if the value \p V has been allocated.
   bool isAllocated(Value *I);
 
+  /// Renumber the registers of the instructions in the function so that the
+  /// registers of the register file which none of them uses anymore, e.g.
+  /// because MovElimination removed the Movs that wrote them, are dropped.
+  /// Registers above the register file, which the target allocates itself,
+  /// move down by the number of registers dropped. Must be called after
+  /// allocate(), once no register is reserved.
+  /// \returns the number of registers dropped.
+  unsigned compactRegisters();
+
   /// \returns the highest number of registers that are used concurrently.
   /// In here we assume that the registers are allocated consecutively
   /// and that allocating this number of registers will cover all of the
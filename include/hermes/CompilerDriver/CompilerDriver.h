@@ -10,6 +10,7 @@
 
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
 #include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace hermes {
@@ -77,8 +78,11 @@ struct CompileResult {
 };
 
 /// Drive the Hermes compiler according to the command line options.
+/// \param commandLine the arguments the options were parsed from, starting
+///   with the name of the program. Only needed for -compile-cache.
 /// \return an exit status.
-CompileResult compileFromCommandLineOptions();
+CompileResult compileFromCommandLineOptions(
+    llvm::ArrayRef<const char *> commandLine = {});
 
 /// Print the Hermes version (with VM) to the given stream \p s.
 void printHermesCompilerVMVersion(llvm::raw_ostream &s);
@@ -60,6 +60,33 @@ struct ExecuteOptions {
   std::string profilerSymbolsFile;
 #endif
 
+  /// Maximum call tree size of the streaming sampling profiler, or 0 to keep
+  /// every sample for a final Chrome trace.
+  unsigned sampleProfilingStreamNodes{0};
+
+  /// Print the opcode and builtin histograms of the sampling profiler.
+  bool sampleProfilingHistograms{false};
+
+  /// Print the hits and misses of the property caches after the run.
+  bool dumpPropertyCacheStats{false};
+
+  /// Print the function profile of the run as flame graph folded stacks.
+  bool functionProfiling{false};
+
+  /// Print the per-function summary of the function profile of the run.
+  bool functionProfilingSummary{false};
+
+  /// File to write the trace events of the run to, in the Chrome trace event
+  /// format, or empty not to record them.
+  std::string traceEventsFile;
+
+  /// The trace::Category bits of the events to record.
+  uint32_t traceEventCategories{0};
+
+  /// Mean number of bytes between allocation samples, or 0 not to sample
+  /// allocations.
+  unsigned allocationSamplingInterval{0};
+
   /// Exectuion time limit.
   uint32_t timeLimit{0};
 
@@ -97,12 +97,75 @@ static opt<double> OccupancyTarget(
     cat(GCCategory),
     init(GCConfig::getDefaultOccupancyTarget()));
 
+static opt<double> GCTimeTarget(
+    "gc-time-target",
+    desc("Sizing heuristic: if non-zero, adapt the occupancy target so that "
+         "this fraction of the time is spent in the GC."),
+    cat(GCCategory),
+    init(GCConfig::getDefaultGCTimeTarget()));
+
 static opt<bool> SampleProfiling(
     "sample-profiling",
     init(false),
     desc("Enable sampling profiler"),
     cat(RuntimeCategory));
 
+static opt<unsigned> AllocationSamplingInterval(
+    "allocation-sampling-interval",
+    init(0),
+    desc("Sample allocations on average every this many bytes, and print "
+         "a Chrome heap profile of them to stderr at exit"),
+    cat(RuntimeCategory));
+
+static opt<unsigned> SampleProfilingStreamNodes(
+    "sample-profiling-stream-nodes",
+    init(0),
+    desc("With -sample-profiling, stream folded stacks to stderr from a call "
+         "tree of at most this many frames instead of a final Chrome trace"),
+    cat(RuntimeCategory));
+
+static opt<bool> SampleProfilingHistograms(
+    "sample-profiling-histograms",
+    init(false),
+    desc("With -sample-profiling, print to stderr how often each opcode and "
+         "builtin was caught executing"),
+    cat(RuntimeCategory));
+
+static opt<bool> DumpPropertyCacheStats(
+    "dump-property-cache-stats",
+    init(false),
+    desc("Print to stderr the hits and misses of each property cache entry "
+         "as JSON at exit, with the source locations of its accesses"),
+    cat(RuntimeCategory));
+
+static opt<bool> FunctionProfiling(
+    "function-profiling",
+    init(false),
+    desc("Measure every call to a JS function, and print to stderr at exit "
+         "the self wall time in microseconds of each call stack as flame "
+         "graph folded stacks"),
+    cat(RuntimeCategory));
+
+static opt<bool> FunctionProfilingSummary(
+    "function-profiling-summary",
+    init(false),
+    desc("Measure every call to a JS function, and print to stderr at exit "
+         "the calls and wall and CPU times of each function as JSON"),
+    cat(RuntimeCategory));
+
+static opt<std::string> TraceEvents(
+    "trace-events",
+    init(""),
+    desc("Record the trace events of the run and write them to this file in "
+         "the Chrome trace event format, which the Perfetto UI loads"),
+    cat(RuntimeCategory));
+
+static opt<std::string> TraceEventCategories(
+    "trace-event-categories",
+    init("execution,gc,compile"),
+    desc("Comma separated categories of the events -trace-events records"),
+    cat(RuntimeCategory));
+
 #ifdef HERMESVM_SERIALIZE
 static opt<std::string> SerializeAfterInitFile(
     "serialize-after-init-file",
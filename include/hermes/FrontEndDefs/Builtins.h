@@ -25,6 +25,39 @@ enum Enum : unsigned char {
 
 static_assert(BuiltinMethod::_count <= 256, "More than 256 builtin methods");
 
+/// The methods of Array.prototype whose calls with a known callback are
+/// lowered to loops, checked by HermesBuiltin.isArrayCallbackMethod().
+namespace ArrayCallbackMethod {
+enum Enum : unsigned char {
+  forEach,
+  map,
+  filter,
+  reduce,
+  _count,
+};
+} // namespace ArrayCallbackMethod
+
+/// The element types of the DataView.prototype get and set methods, whose
+/// calls are emitted as DataViewGet and DataViewSet, in the order of the
+/// TypedArray kinds without Uint8Clamped.
+namespace DataViewType {
+enum Enum : unsigned char {
+  Int8,
+  Int16,
+  Int32,
+  Uint8,
+  Uint16,
+  Uint32,
+  Float32,
+  Float64,
+  _count,
+};
+
+/// Set in the type operand of DataViewGet and DataViewSet when the call
+/// passes the littleEndian argument.
+constexpr unsigned char LittleEndianArg = 0x80;
+} // namespace DataViewType
+
 /// Return a string representation of the builtin method name.
 const char *getBuiltinMethodName(int method);
 
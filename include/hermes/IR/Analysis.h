@@ -138,7 +138,8 @@ class FunctionScopeAnalysis {
     Function *parent;
 
     /// The depth in the scope chain. The global scope has depth 0, each
-    /// function nesting level increases this by 1. Placeholder functions (which
+    /// function nesting level increases this by 1, except for functions with
+    /// a flattened environment. Placeholder functions (which
     /// represent the lexical environment in local eval) have negative depths.
     int32_t depth;
 
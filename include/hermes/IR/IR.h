@@ -26,6 +26,7 @@
 #include "hermes/Support/Conversions.h"
 #include "hermes/Support/ScopeChain.h"
 
+#include <algorithm>
 #include <deque>
 #include <unordered_map>
 #include <vector>
@@ -1331,6 +1332,11 @@ class Function : public ilist_node_with_parent<Function, Module>, public Value {
   /// and have cleared it in preparation for lowering steps.
   OptValue<uint32_t> statementCount_{0};
 
+  /// Whether the function uses the environment it was created in as its own
+  /// instead of creating one, because nothing is stored in its scope. Its
+  /// scope then has the depth of its lexical parent's.
+  bool environmentFlattened_{false};
+
 #ifndef HERMESVM_LEAN
   /// The source of a function, containing function type, range and buffer ID.
   LazySource lazySource_;
@@ -1458,6 +1464,15 @@ class Function : public ilist_node_with_parent<Function, Module>, public Value {
     return strictMode_;
   }
 
+  /// \return whether the function uses the environment it was created in as
+  /// its own.
+  bool isEnvironmentFlattened() const {
+    return environmentFlattened_;
+  }
+  void setEnvironmentFlattened() {
+    environmentFlattened_ = true;
+  }
+
   /// Return the source range covered by the function.
   SMRange getSourceRange() const {
     return SourceRange;
@@ -1684,6 +1699,9 @@ class Module : public Value {
     Identifier filename;
     /// Pointer to the wrapper function for the module.
     Function *function;
+    /// IDs of the modules this module statically requires, in the order they
+    /// are first required.
+    llvm::SmallVector<uint32_t, 2> dependencies{};
   };
 
  private:
@@ -1890,6 +1908,16 @@ class Module : public Value {
     return it == cjsModuleFilenameMap_.end() ? nullptr : it->second;
   }
 
+  /// Record that the CommonJS module with ID \p id statically requires the
+  /// module with ID \p dependency.
+  void addCJSModuleDependency(uint32_t id, uint32_t dependency) {
+    auto &dependencies = cjsModules_[id].dependencies;
+    if (std::find(dependencies.begin(), dependencies.end(), dependency) ==
+        dependencies.end()) {
+      dependencies.push_back(dependency);
+    }
+  }
+
   /// \return the registered CommonJS modules.
   llvm::iterator_range<CJSModuleIterator> getCJSModules() {
     return {cjsModules_.begin(), cjsModules_.end()};
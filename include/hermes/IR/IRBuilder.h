@@ -453,6 +453,13 @@ class IRBuilder {
       const SwitchImmInst::ValueListType &values,
       const SwitchImmInst::BasicBlockListType &blocks);
 
+  SwitchHashInst *createSwitchHashInst(
+      Value *input,
+      BasicBlock *defaultBlock,
+      LiteralNumber *numSlots,
+      const SwitchHashInst::ValueListType &values,
+      const SwitchHashInst::BasicBlockListType &blocks);
+
   HBCLoadConstInst *createHBCLoadConstInst(Literal *value);
 
   HBCLoadParamInst *createHBCLoadParamInst(LiteralNumber *value);
@@ -484,6 +491,7 @@ class IRBuilder {
   CallBuiltinInst *createCallBuiltinInst(
       BuiltinMethod::Enum builtinIndex,
       ArrayRef<Value *> arguments);
+  StringConcatInst *createStringConcatInst(ArrayRef<Value *> operands);
   HBCCallDirectInst *createHBCCallDirectInst(
       Function *callee,
       Value *thisValue,
@@ -776,6 +776,46 @@ class CallBuiltinInst : public CallInst {
   }
 };
 
+/// Convert each of its operands to a string, in order, and concatenate them,
+/// allocating only the result. It takes the form of a call whose arguments,
+/// starting with "this", are the operands, so that the backend can pass them
+/// the way it passes call arguments.
+class StringConcatInst : public CallInst {
+  StringConcatInst(const StringConcatInst &) = delete;
+  void operator=(const StringConcatInst &) = delete;
+
+ public:
+  static constexpr unsigned MAX_OPERANDS = UINT8_MAX;
+
+  explicit StringConcatInst(
+      LiteralUndefined *callee,
+      Value *first,
+      ArrayRef<Value *> rest)
+      : CallInst(ValueKind::StringConcatInstKind, callee, first, rest) {
+    assert(
+        getNumArguments() <= MAX_OPERANDS &&
+        "Too many operands to StringConcat");
+    setType(Type::createString());
+  }
+  explicit StringConcatInst(
+      const StringConcatInst *src,
+      llvm::ArrayRef<Value *> operands)
+      : CallInst(src, operands) {}
+
+  bool canSetOperandImpl(ValueKind kind, unsigned index) const {
+    switch (index) {
+      case CallInst::CalleeIdx:
+        return kindIsA(kind, ValueKind::LiteralUndefinedKind);
+      default:
+        return index < CallInst::ThisIdx + MAX_OPERANDS;
+    }
+  }
+
+  static bool classof(const Value *V) {
+    return kindIsA(V->getKind(), ValueKind::StringConcatInstKind);
+  }
+};
+
 class HBCCallNInst : public CallInst {
  public:
   /// The minimum number of args supported by a CallN instruction, including
@@ -2707,6 +2747,103 @@ class SwitchImmInst : public TerminatorInst {
   void setSuccessor(unsigned idx, BasicBlock *B);
 };
 
+/// A switch over string cases, or integer cases too sparse for SwitchImmInst,
+/// which dispatches through a hashed jump table.
+class SwitchHashInst : public TerminatorInst {
+  SwitchHashInst(const SwitchHashInst &) = delete;
+  void operator=(const SwitchHashInst &) = delete;
+
+ public:
+  enum { InputIdx, DefaultBlockIdx, NumSlotsIdx, FirstCaseIdx };
+
+  using ValueListType = llvm::SmallVector<Literal *, 8>;
+  using BasicBlockListType = llvm::SmallVector<BasicBlock *, 8>;
+
+  /// \returns the number of switch case values.
+  unsigned getNumCasePair() const {
+    return (getNumOperands() - FirstCaseIdx) / 2;
+  }
+
+  /// Returns the n'th pair of value-basicblock that represent a case
+  /// destination.
+  std::pair<Literal *, BasicBlock *> getCasePair(unsigned i) const {
+    unsigned base = i * 2 + FirstCaseIdx;
+    return std::make_pair(
+        cast<Literal>(getOperand(base)),
+        cast<BasicBlock>(getOperand(base + 1)));
+  }
+
+  /// \returns the destination of the default target.
+  BasicBlock *getDefaultDestination() const {
+    return cast<BasicBlock>(getOperand(DefaultBlockIdx));
+  }
+
+  /// \returns the input value. This is the value we switch on.
+  Value *getInputValue() const {
+    return getOperand(InputIdx);
+  }
+
+  /// \returns whether the cases are strings, rather than int32 numbers.
+  bool hasStringCases() const {
+    return isa<LiteralString>(getOperand(FirstCaseIdx));
+  }
+
+  /// \returns the number of slots of the jump table, a power of 2 in which
+  /// every case hashes to a different slot.
+  uint32_t getNumSlots() const {
+    return cast<LiteralNumber>(getOperand(NumSlotsIdx))->asUInt32();
+  }
+
+  /// \p input is the discriminator value.
+  /// \p defaultBlock is the block to jump to if nothing matches.
+  /// \p numSlots is the number of slots of the jump table.
+  /// \p values are either all strings or all int32 numbers.
+  explicit SwitchHashInst(
+      Value *input,
+      BasicBlock *defaultBlock,
+      LiteralNumber *numSlots,
+      const ValueListType &values,
+      const BasicBlockListType &blocks);
+  explicit SwitchHashInst(
+      const SwitchHashInst *src,
+      llvm::ArrayRef<Value *> operands)
+      : TerminatorInst(src, operands) {}
+
+  SideEffectKind getSideEffect() {
+    return SideEffectKind::None;
+  }
+
+  WordBitSet<> getChangedOperandsImpl() {
+    return {};
+  }
+
+  bool canSetOperandImpl(ValueKind kind, unsigned index) const {
+    switch (index) {
+      case InputIdx:
+        return true;
+      case DefaultBlockIdx:
+        return kindIsA(kind, ValueKind::BasicBlockKind);
+      case NumSlotsIdx:
+        return kindIsA(kind, ValueKind::LiteralNumberKind);
+      default:
+        if ((index - FirstCaseIdx) % 2 == 0)
+          return kindIsA(kind, ValueKind::LiteralStringKind) ||
+              kindIsA(kind, ValueKind::LiteralNumberKind);
+        return kindIsA(kind, ValueKind::BasicBlockKind);
+    }
+  }
+
+  static bool classof(const Value *V) {
+    return kindIsA(V->getKind(), ValueKind::SwitchHashInstKind);
+  }
+
+  unsigned getNumSuccessors() const {
+    return getNumCasePair() + 1;
+  }
+  BasicBlock *getSuccessor(unsigned idx) const;
+  void setSuccessor(unsigned idx, BasicBlock *B);
+};
+
 class SaveAndYieldInst : public TerminatorInst {
   SaveAndYieldInst(const SaveAndYieldInst &) = delete;
   void operator=(const SaveAndYieldInst &) = delete;
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_OPTIMIZER_SCALAR_CJSEXPORTS_H
+#define HERMES_OPTIMIZER_SCALAR_CJSEXPORTS_H
+
+#include "hermes/IR/IR.h"
+#include "hermes/IR/Instrs.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+
+#include <vector>
+
+namespace hermes {
+
+/// The functions that CommonJS modules export, and their calls in the modules
+/// that require them. It is only computed once every require() call has been
+/// resolved statically, and only for the modules whose exports object can't
+/// be reached by any code but the loads of its properties in the requiring
+/// modules, which are then the only way to get to the exported functions.
+///
+/// Like the rest of the static require support, this assumes that nothing
+/// outside the bundle requires its modules but its entry point. It also
+/// assumes that the bundle doesn't define setters on Object.prototype for the
+/// exported names.
+class CJSExports {
+ public:
+  explicit CJSExports(Module *M);
+
+  /// \return the calls in the requiring modules of the function stored by
+  ///   \p store into an exports object, or null if they aren't all known.
+  const llvm::DenseSet<CallInst *> *getImportingCalls(
+      StorePropertyInst *store) const;
+
+  /// \return the functions that \p call may call, if it calls a property of
+  ///   an exports object which always holds a function of its module, or
+  ///   null otherwise.
+  const llvm::DenseSet<Function *> *getCallees(CallInst *call) const;
+
+ private:
+  /// A property of an exports object which only functions are stored into.
+  struct Export {
+    /// The calls of the property in the requiring modules.
+    llvm::DenseSet<CallInst *> calls{};
+    /// The functions stored into the property.
+    llvm::DenseSet<Function *> functions{};
+  };
+
+  /// All the tracked exports.
+  std::vector<Export> exports_{};
+  /// The index in exports_ of each store whose importing calls are known.
+  llvm::DenseMap<StorePropertyInst *, unsigned> storeExports_{};
+  /// The index in exports_ of each call whose callees are known.
+  llvm::DenseMap<CallInst *, unsigned> callExports_{};
+};
+
+} // namespace hermes
+
+#endif // HERMES_OPTIMIZER_SCALAR_CJSEXPORTS_H
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_OPTIMIZER_SCALAR_INLINEARRAYCALLBACKS_H
+#define HERMES_OPTIMIZER_SCALAR_INLINEARRAYCALLBACKS_H
+
+#include "hermes/IR/IR.h"
+#include "hermes/Optimizer/PassManager/Pass.h"
+
+namespace hermes {
+
+/// Lowers calls of Array.prototype.forEach, map, filter and reduce whose
+/// callback is a function expression used by nothing else, to a loop over the
+/// array with the body of the callback inlined into it. The loop is only
+/// entered when HermesBuiltin.isArrayCallbackMethod() finds that the receiver
+/// is an array and the method is the original one. Otherwise the method is
+/// called as before.
+class InlineArrayCallbacks : public FunctionPass {
+ public:
+  explicit InlineArrayCallbacks() : FunctionPass("InlineArrayCallbacks") {}
+  ~InlineArrayCallbacks() override = default;
+
+  bool runOnFunction(Function *F) override;
+};
+
+} // namespace hermes
+
+#endif // HERMES_OPTIMIZER_SCALAR_INLINEARRAYCALLBACKS_H
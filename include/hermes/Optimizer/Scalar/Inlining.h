@@ -13,6 +13,26 @@
 
 namespace hermes {
 
+class CallInst;
+class IRBuilder;
+
+/// \return true if the function \p F satisfies the conditions for being
+///   inlined into \p intoFunction.
+bool canBeInlined(Function *F, Function *intoFunction);
+
+/// Inline a function into the current insertion point, which must be at the
+/// end of a basic block because a branch will be inserted.
+/// \param F the function to inline
+/// \param CI the call instruction being replaced. Note that this call
+///   will not actually replace it.
+/// \param nextBlock the block to branch after the inlining
+/// \return the return value of the inlined function
+Value *inlineFunction(
+    IRBuilder &builder,
+    Function *F,
+    CallInst *CI,
+    BasicBlock *nextBlock);
+
 /// Inline single use functions.
 class Inlining : public ModulePass {
  public:
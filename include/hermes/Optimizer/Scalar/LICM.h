@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_OPTIMIZER_SCALAR_LICM_H
+#define HERMES_OPTIMIZER_SCALAR_LICM_H
+
+#include "hermes/IR/IR.h"
+#include "hermes/Optimizer/PassManager/Pass.h"
+
+namespace hermes {
+
+/// Loop-invariant code motion: moves instructions whose result can't change
+/// between iterations of a loop into the preheader of the loop. Besides
+/// side-effect free computations, this covers loads of variables and of the
+/// length of array literals, as long as nothing in the loop may write them,
+/// and closures which are only called, so that a single closure is allocated
+/// for all the iterations.
+class LICM : public FunctionPass {
+ public:
+  explicit LICM() : FunctionPass("LICM") {}
+  ~LICM() override = default;
+
+  bool runOnFunction(Function *F) override;
+};
+
+} // namespace hermes
+
+#endif // HERMES_OPTIMIZER_SCALAR_LICM_H
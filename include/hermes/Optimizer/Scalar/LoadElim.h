@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_OPTIMIZER_SCALAR_LOADELIM_H
+#define HERMES_OPTIMIZER_SCALAR_LOADELIM_H
+
+#include "hermes/IR/IR.h"
+#include "hermes/Optimizer/PassManager/Pass.h"
+
+namespace hermes {
+
+/// Redundant load elimination: replaces a load with a value it is known to
+/// produce, because the same location was loaded or stored earlier on every
+/// path to it and nothing in between may have written it. This covers loads
+/// of variables, and loads of properties which are known to be own data
+/// properties: those defined by an object literal, and the length of an array
+/// literal. Other property loads may reach a getter, so they are never
+/// removed.
+class LoadElim : public FunctionPass {
+ public:
+  explicit LoadElim() : FunctionPass("LoadElim") {}
+  ~LoadElim() override = default;
+
+  bool runOnFunction(Function *F) override;
+};
+
+} // namespace hermes
+
+#endif // HERMES_OPTIMIZER_SCALAR_LOADELIM_H
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_OPTIMIZER_SCALAR_SCALARREPLACEMENT_H
+#define HERMES_OPTIMIZER_SCALAR_SCALARREPLACEMENT_H
+
+#include "hermes/IR/IR.h"
+#include "hermes/Optimizer/PassManager/Pass.h"
+
+namespace hermes {
+
+/// Replaces the properties of objects that never escape the function with
+/// stack allocations, which Mem2Reg then turns into SSA values.
+class ScalarReplacement : public FunctionPass {
+ public:
+  explicit ScalarReplacement() : FunctionPass("ScalarReplacement") {}
+  ~ScalarReplacement() override = default;
+
+  bool runOnFunction(Function *F) override;
+};
+
+} // namespace hermes
+
+#endif // HERMES_OPTIMIZER_SCALAR_SCALARREPLACEMENT_H
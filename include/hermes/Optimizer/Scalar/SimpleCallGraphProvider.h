@@ -12,17 +12,19 @@
 
 namespace hermes {
 
+class CJSExports;
 class Function;
 
 /// This class provides an (one) implementation of the CallGraphProvider
 /// interface.  This implementation uses only local information based
-/// on def-use. No closure analysis is used.
+/// on def-use. No closure analysis is used. When \p exports is given, the
+/// calls of functions exported by CommonJS modules are followed as well.
 class SimpleCallGraphProvider : public CallGraphProvider {
-  void initCallRelationships(Function *F);
+  void initCallRelationships(Function *F, const CJSExports *exports);
 
  public:
-  SimpleCallGraphProvider(Function *F) {
-    initCallRelationships(F);
+  SimpleCallGraphProvider(Function *F, const CJSExports *exports = nullptr) {
+    initCallRelationships(F, exports);
   }
 };
 } // namespace hermes
@@ -60,5 +60,13 @@ void splitCriticalEdge(IRBuilder *builder, BasicBlock *from, BasicBlock *to);
 /// with identical instructions or duplicated without changing semantics, and
 /// can be placed anywhere in the middle of a basic block.
 bool isSimpleSideEffectFreeInstruction(Instruction *I);
+
+/// \return the name of the property \p prop, if it is a literal string which
+/// can't change the prototype of the object, or nullptr.
+LiteralString *getLiteralPropertyName(Value *prop);
+
+/// \return true if the property \p prop of \p object is the length of an
+/// array literal, which is never an accessor.
+bool isArrayLiteralLength(Value *object, Value *prop);
 } // namespace hermes
 #endif // HERMES_OPTIMIZER_SCALAR_UTILS_H
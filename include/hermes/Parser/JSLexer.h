@@ -365,6 +365,17 @@ class JSLexer {
   /// Should be called in the middle of parsing a template literal.
   const Token *rescanRBraceInTemplateLiteral();
 
+  /// Scan from the current token, which must be the '{' that starts a
+  /// function body, to the matching '}', only tracking the nesting of braces
+  /// and template literals instead of parsing. Messages are suppressed, so
+  /// errors in the body are not reported.
+  /// \param[out] useStaticBuiltin set to true if the body may contain a
+  ///   'use static builtin' directive.
+  /// \return the end of the matching '}', or None if it can't be found
+  ///   without parsing, e.g. when a '/' could start a regexp or be a
+  ///   division. In that case the caller should seek back and parse.
+  llvm::Optional<SMLoc> scanFunctionBodyEnd(bool &useStaticBuiltin);
+
   /// Report an error for the range from startLoc to curCharPtr.
   bool errorRange(SMLoc startLoc, const llvm::Twine &msg) {
     return error({startLoc, SMLoc::getFromPointer(curCharPtr_)}, msg);
@@ -11,9 +11,13 @@
 #include "hermes/Parser/JSONParser.h"
 #include "hermes/Support/OptValue.h"
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace hermes {
@@ -92,15 +96,68 @@ class SourceMap {
   using MetadataEntry = parser::JSONSharedValue;
   using MetadataList = std::vector<llvm::Optional<MetadataEntry>>;
 
+  /// A segment as the map stores it: a fixed-size record, so that the
+  /// segments of a line are a flat array that can be binary searched and
+  /// written to a cache file as is. Absent fields are -1.
+  struct CompactSegment {
+    int32_t generatedColumn;
+    int32_t sourceIndex;
+    int32_t lineIndex;
+    int32_t columnIndex;
+    int32_t nameIndex;
+
+    /// \return the segment as a Segment.
+    Segment toSegment() const;
+  };
+
+  /// Where a generated line starts in the "mappings" string, and the delta
+  /// decoding state at that point, from which the line can be decoded alone.
+  /// The generated column always starts at 0.
+  struct LineState {
+    uint32_t offset = 0;
+    int32_t sourceIndex = 0;
+    int32_t lineIndex = 0;
+    int32_t columnIndex = 0;
+    int32_t nameIndex = 0;
+  };
+
+  /// Create a map from the decoded segments of every line in \p lines.
   SourceMap(
       const std::string &sourceRoot,
       std::vector<std::string> &&sources,
       std::vector<SegmentList> &&lines,
-      MetadataList &&sourcesMetadata)
-      : sourceRoot_(sourceRoot),
-        sources_(std::move(sources)),
-        lines_(std::move(lines)),
-        sourcesMetadata_(std::move(sourcesMetadata)) {}
+      MetadataList &&sourcesMetadata);
+
+  /// Create a map that decodes the lines of the "mappings" string
+  /// \p mappings when they are first looked up, from the state at the start
+  /// of every line in \p lineStates. The string must have been validated.
+  SourceMap(
+      const std::string &sourceRoot,
+      std::vector<std::string> &&sources,
+      std::string &&mappings,
+      std::vector<LineState> &&lineStates,
+      MetadataList &&sourcesMetadata);
+
+  SourceMap(const SourceMap &) = delete;
+  SourceMap &operator=(const SourceMap &) = delete;
+
+  /// Write the sources and the decoded segments of the map to \p OS, in a
+  /// form that loadCache() can use without decoding or copying it, so that
+  /// the map of a large bundle doesn't have to be parsed again to symbolicate
+  /// every crash report. The cache is in host byte order, and doesn't hold
+  /// the metadata of the sources.
+  void writeCache(llvm::raw_ostream &OS) const;
+
+  /// Create a map from the cache file \p buffer written by writeCache(),
+  /// whose segments are looked up in place, so \p buffer is best mmapped.
+  /// \return the map, or nullptr if \p buffer is not a valid cache file.
+  static std::unique_ptr<SourceMap> loadCache(
+      std::unique_ptr<llvm::MemoryBuffer> buffer);
+
+  /// \return the number of generated lines.
+  uint32_t getNumLines() const {
+    return numLines_;
+  }
 
   /// Query source map text location for \p line and \p column.
   /// In both the input and output of this function, line and column numbers
@@ -151,8 +208,34 @@ class SourceMap {
   /// appended.
   std::vector<std::string> sources_;
 
-  /// The list of segments in VLQ scheme.
-  std::vector<SegmentList> lines_;
+  /// \return the segments of the zero-based generated line \p lineIndex,
+  /// decoding them first if they haven't been.
+  llvm::ArrayRef<CompactSegment> getLine(uint32_t lineIndex) const;
+
+  /// The number of generated lines.
+  uint32_t numLines_;
+
+  /// The segments of every line, if they were decoded up front, and the
+  /// index in segments_ of the first segment of every line, followed by the
+  /// number of segments. They refer to ownedSegments_ and ownedLineStarts_,
+  /// or to cacheBuffer_. lineStarts_ is empty if the lines are decoded lazily.
+  llvm::ArrayRef<CompactSegment> segments_{};
+  llvm::ArrayRef<uint32_t> lineStarts_{};
+  std::vector<CompactSegment> ownedSegments_{};
+  std::vector<uint32_t> ownedLineStarts_{};
+  std::unique_ptr<llvm::MemoryBuffer> cacheBuffer_{};
+
+  /// The "mappings" string, and the state at the start of every line, if the
+  /// lines are decoded lazily.
+  std::string mappings_{};
+  std::vector<LineState> lineStates_{};
+
+  /// The lazily decoded lines, null until they are first looked up.
+  mutable std::vector<std::unique_ptr<std::vector<CompactSegment>>>
+      decodedLines_{};
+
+  /// Guards decodedLines_, as lookups are const.
+  mutable std::mutex decodeMutex_{};
 
   /// Metadata for each source keyed by source index. Represents the
   /// x_facebook_sources field in the JSON source map.
@@ -14,6 +14,8 @@
 #include "llvm/ADT/ArrayRef.h"
 
 #include <llvm/ADT/DenseMap.h>
+#include <map>
+#include <memory>
 #include <vector>
 
 namespace hermes {
@@ -26,28 +28,31 @@ namespace hermes {
 class SourceMapGenerator {
  public:
   /// Add a line \p line represented as a list of Segments to the 'mappings'
-  /// section.
+  /// section. Lines are encoded as soon as every line before them has been
+  /// added, so their segments aren't kept, and each line can only be added
+  /// once.
   /// \param cjsModuleOffset the offset of the module represented by the given
   /// line, used as the "line" when reporting stack traces from the VM,
   /// which doesn't have access to the segment IDs.
-  void addMappingsLine(SourceMap::SegmentList line, uint32_t cjsModuleOffset) {
-    if (lines_.size() <= cjsModuleOffset) {
-      lines_.resize(cjsModuleOffset + 1);
-    }
-    lines_[cjsModuleOffset] = std::move(line);
+  void addMappingsLine(SourceMap::SegmentList line, uint32_t cjsModuleOffset);
+
+  /// \return the number of mappings lines, counting the lines that are
+  /// missing before the last line added, which are left empty.
+  uint32_t getNumMappingsLines() const {
+    return lineSizes_.size();
   }
 
-  /// \return the list of mappings lines.
-  llvm::ArrayRef<SourceMap::SegmentList> getMappingsLines() const {
-    return lines_;
+  /// \return the number of segments in the mappings line \p index.
+  uint32_t getMappingsLineSize(uint32_t index) const {
+    assert(index < lineSizes_.size() && "index out of range");
+    return lineSizes_[index];
   }
 
   /// Set the list of input source maps to \p maps.
   /// The order should match the indexes used in the sourceIndex field of
-  /// Segment.
-  void setInputSourceMaps(std::vector<std::unique_ptr<SourceMap>> maps) {
-    inputSourceMaps_ = std::move(maps);
-  }
+  /// Segment. Lines added afterwards are translated through the input maps
+  /// as they are encoded, so this must be called before adding any lines.
+  void setInputSourceMaps(std::vector<std::unique_ptr<SourceMap>> maps);
 
   /// Adds the source filename to filenameTable_ if it doesn't already exist.
   /// If \p metadata is provided and is non-null, it becomes the metadata entry
@@ -57,8 +62,10 @@ class SourceMapGenerator {
       llvm::StringRef filename,
       llvm::Optional<SourceMap::MetadataEntry> metadata = llvm::None);
 
-  /// Output the given source map as JSON.
-  void outputAsJSON(llvm::raw_ostream &OS) const;
+  /// Output the given source map as JSON. Lines that were waiting for a line
+  /// before them that was never added are encoded first, with the missing
+  /// lines left empty.
+  void outputAsJSON(llvm::raw_ostream &OS);
 
   /// Adds a list of function offsets indexed by function ID for a given
   /// bytecode segment. This list will be printed under
@@ -85,12 +92,9 @@ class SourceMapGenerator {
     int32_t nameIndex = 0;
   };
 
-  /// Implementation of outputAsJSON for a merged source map generator.
+  /// Implementation of outputAsJSON once every line is encoded.
   void outputAsJSONImpl(llvm::raw_ostream &OS) const;
 
-  /// \return the mappings encoded in VLQ format.
-  std::string getVLQMappingsString() const;
-
   /// \return a list of sources, in order.
   /// This list refers to internals of the StringMap and is invalidated by
   /// addSource().
@@ -103,9 +107,19 @@ class SourceMapGenerator {
       llvm::ArrayRef<SourceMap::Segment> segments,
       llvm::raw_ostream &OS);
 
-  /// Merge the input source maps with the state in this generator,
-  /// and return a new generator which contains a merged representation.
-  SourceMapGenerator mergedWithInputSourceMaps() const;
+  /// Encode \p line as the next line of the mappings, or pass it on to
+  /// merged_ after translating it if there are input source maps.
+  void encodeLine(const SourceMap::SegmentList &line);
+
+  /// Encode the lines waiting for a line before them, leaving the missing
+  /// lines empty.
+  void flushPendingLines();
+
+  /// \return the location in merged_ of the location \p loc of the
+  /// generated code, through the input source map of its source if it has
+  /// one and maps it.
+  SourceMap::Segment::SourceLocation translateLocation(
+      const SourceMap::Segment::SourceLocation &loc);
 
   /// \return the input source map segment for \p seg if the input source map
   /// exists and has a valid location for \p seg, else return llvm::None.
@@ -126,14 +140,44 @@ class SourceMapGenerator {
   /// The list of symbol names, populating the names field.
   std::vector<std::string> symbolNames_;
 
-  /// The list of segments in our VLQ scheme.
-  std::vector<SourceMap::SegmentList> lines_;
+  /// The encoded mappings lines, each ended by a ';'.
+  std::string mappings_{};
+
+  /// The delta encoding state at the end of mappings_.
+  State state_{};
+
+  /// The number of segments in every line added so far, or 0 for the lines
+  /// that are missing.
+  std::vector<uint32_t> lineSizes_{};
+
+  /// The number of lines encoded in mappings_, or passed on to merged_.
+  uint32_t numEncodedLines_{0};
+
+  /// The lines added before a line that comes before them, by index.
+  std::map<uint32_t, SourceMap::SegmentList> pendingLines_{};
 
   /// The list of input source maps, such that the input file i has the
   /// SourceMap at index i. If no map was provided for a file, this list
   /// contains nullptr.
   std::vector<std::unique_ptr<SourceMap>> inputSourceMaps_;
 
+  /// The generator of the merged map, which the lines are passed on to once
+  /// translated, if there are input source maps.
+  std::unique_ptr<SourceMapGenerator> merged_{};
+
+  /// A location in merged_, and whether an input source map mapped it.
+  struct MergedLocation {
+    SourceMap::Segment::SourceLocation loc;
+    bool mapped;
+  };
+
+  /// The locations in merged_ of the locations of the generated code, keyed
+  /// by their source index, then their line and column. Many addresses map
+  /// to the same location, so this saves looking them up in the input maps
+  /// and their file names up in merged_ again.
+  llvm::DenseMap<std::pair<uint32_t, uint64_t>, MergedLocation>
+      mergedLocations_{};
+
   /// Map from {filename => source index}.
   StringSetVector filenameTable_{};
 
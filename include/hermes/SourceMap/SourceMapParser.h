@@ -46,15 +46,27 @@ class SourceMapParser {
     int32_t nameIndex = 0;
   };
 
-  /// Parse "mappings" section from \p sourceMappings. The parsed line mappings
-  /// are returned in \p lines.
+  /// Validate the "mappings" section \p sourceMappings without keeping its
+  /// segments. The state at the start of every line is returned in
+  /// \p lines, so that SourceMap can decode each line when it is needed.
   static bool parseMappings(
       llvm::StringRef sourceMappings,
-      std::vector<SourceMap::SegmentList> &lines);
+      std::vector<SourceMap::LineState> &lines);
+
+  /// Parse the segments of the single line \p line of "mappings", starting
+  /// from \p state, which is left at the end of the line. The segments are
+  /// appended to \p segments unless it is null.
+  static bool parseLine(
+      llvm::StringRef line,
+      State &state,
+      std::vector<SourceMap::CompactSegment> *segments);
 
   /// Parse single segment in mapping.
-  static llvm::Optional<SourceMap::Segment>
+  static llvm::Optional<SourceMap::CompactSegment>
   parseSegment(const State &state, const char *&pCur, const char *pSegEnd);
+
+  /// SourceMap decodes its lines lazily with parseLine().
+  friend class SourceMap;
 };
 
 } // namespace hermes
@@ -14,6 +14,7 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/MathExtras.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -49,24 +50,43 @@ class BacktrackingBumpPtrAllocator {
     uintptr_t offset;
     /// A place to store allocations that can't fit into the slabs, if any.
     llvm::SmallVector<std::unique_ptr<void, decltype(free) *>, 0> hugeAllocs{};
+    /// The total size of hugeAllocs.
+    size_t hugeBytes;
     /// The state of the previous scope.
     State *previous;
 
     /// Construct a new scope shadowing a previous one.
     State(State *previous)
-        : slab(previous->slab), offset(previous->offset), previous(previous) {}
+        : slab(previous->slab),
+          offset(previous->offset),
+          hugeBytes(0),
+          previous(previous) {}
     /// Construct the initial scope.
-    State() : slab(0), offset(0), previous(nullptr) {}
+    State() : slab(0), offset(0), hugeBytes(0), previous(nullptr) {}
   };
 
   /// The current state of the bump pointer.
   State *state_;
 
+  /// The total size of the huge allocations of all the scopes.
+  size_t hugeBytes_{0};
+
+  /// The most memory held at once, see getPeakBytes().
+  size_t peakBytes_{0};
+
+  /// Update peakBytes_ after memory was allocated.
+  void updatePeakBytes() {
+    peakBytes_ = std::max(peakBytes_, getBytes());
+  }
+
   /// Allocate memory that can't fit within a single slab.
   void *allocateHuge(int size) {
     auto *ptr = checkedMalloc(size);
     state_->hugeAllocs.push_back(
         std::unique_ptr<void, decltype(free) *>(ptr, free));
+    state_->hugeBytes += size;
+    hugeBytes_ += size;
+    updatePeakBytes();
     return ptr;
   }
 
@@ -83,6 +103,7 @@ class BacktrackingBumpPtrAllocator {
   explicit BacktrackingBumpPtrAllocator() {
     state_ = new State();
     slabs_.push_back(llvm::make_unique<Slab>());
+    updatePeakBytes();
   }
   ~BacktrackingBumpPtrAllocator() {
     while (state_)
@@ -100,11 +121,23 @@ class BacktrackingBumpPtrAllocator {
     assert(state_ && "No previous allocation scope pushed");
     auto *top = state_;
     state_ = state_->previous;
+    hugeBytes_ -= top->hugeBytes;
     delete top;
     // We could also clean up unnecessary slabs, but we're likely to need
     // then again so don't bother.
   }
 
+  /// \return the memory currently held by the allocator. Slabs are kept for
+  /// reuse after the scope using them is popped, so they are always counted.
+  size_t getBytes() const {
+    return slabs_.size() * SlabSize + hugeBytes_;
+  }
+
+  /// \return the most memory the allocator has held at once.
+  size_t getPeakBytes() const {
+    return peakBytes_;
+  }
+
   /// Allocate space for N elements of type T.
   template <typename T>
   inline T *Allocate(size_t num = 1, size_t alignment = sizeof(double)) {
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SUPPORT_BASICBLOCKPROFILE_H
+#define HERMES_SUPPORT_BASICBLOCKPROFILE_H
+
+#include <cstdint>
+
+namespace hermes {
+
+/// The basic block profile is written by a VM built with HERMESVM_PROFILER_BB
+/// when running bytecode compiled with -basic-block-profiling, and read by
+/// hbcdump and by the compiler's -profile-use. It is a JSON object with:
+///   "version": the version of the format,
+///   "page_size": the page size of the profiled device,
+///   "functions": an array with an object for each function that ran:
+///     "checksum": the MD5 of the bytecode of the function, in hex,
+///     "source_hash": the SHA1 of the source the bytecode was compiled from,
+///       in hex, as stored in the bytecode file (since version 3),
+///     "line", "column": where the function starts in that source, 1-based,
+///       only if the bytecode has debug info,
+///     "basic_blocks": an array with an object for each block id:
+///       "profile_index": the block id, which is the operand of the
+///         ProfilePoint at the start of the block,
+///       "execution_count": how many times the block ran,
+///       "order": when the block first ran in the whole run, from 1, or 0 if
+///         it never did.
+/// Block ids are numbered backwards from 1 in the order of the lowered blocks
+/// of the function, so the entry block has the highest, and are the same when
+/// the same source is compiled with the same options. Id 0 is shared by the
+/// blocks past the 65535th.
+/// A function is identified across compilations by the source hash and its
+/// start in the source, and within one bytecode file by its checksum.
+/// Fields are only ever added, so readers accept all the versions from
+/// kMinBasicBlockProfileVersion.
+constexpr int32_t kBasicBlockProfileVersion = 3;
+constexpr int32_t kMinBasicBlockProfileVersion = 2;
+
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_BASICBLOCKPROFILE_H
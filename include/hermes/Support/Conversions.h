@@ -12,6 +12,7 @@
 
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/MathExtras.h"
 
 #include <cstdint>
@@ -288,6 +289,161 @@ OptValue<double> parseIntWithRadix(Iterable str, int radix) {
   return result;
 }
 
+/// The most decimal digits parsed into a uint64_t by parseDecimalDigits().
+constexpr unsigned kMaxFastDecimalDigits = 19;
+
+/// Read the eight ASCII characters at \p str into \p value if they are all
+/// decimal digits, eight at a time.
+/// \return true if they were read.
+inline bool readEightDecimalDigits(const char *str, uint32_t &value) {
+  uint64_t val = llvm::support::endian::read64le(str);
+  // Every byte must be in [0x30, 0x39], so that adding 6 leaves it in
+  // [0x36, 0x3F]. No byte carries into the next when the first test passes.
+  if ((val & 0xF0F0F0F0F0F0F0F0u) != 0x3030303030303030u ||
+      ((val + 0x0606060606060606u) & 0xF0F0F0F0F0F0F0F0u) !=
+          0x3030303030303030u)
+    return false;
+  // Combine the digits into pairs, then the pairs into groups of four, and
+  // the two groups into one number. The first digit is in the lowest byte.
+  val -= 0x3030303030303030u;
+  val = (val * 10) + (val >> 8);
+  val = (((val & 0x000000FF000000FFu) * 0x000F424000000064u) +
+         (((val >> 16) & 0x000000FF000000FFu) * 0x0000271000000001u)) >>
+      32;
+  value = static_cast<uint32_t>(val);
+  return true;
+}
+
+/// UTF-16 characters are read one at a time.
+inline bool readEightDecimalDigits(const char16_t *, uint32_t &) {
+  return false;
+}
+
+/// Append the decimal digits at \p str to \p mantissa, and add their number
+/// to \p numDigits, advancing \p str past them.
+/// \return false if there are more than kMaxFastDecimalDigits digits.
+template <typename CharT>
+bool parseDecimalDigits(
+    const CharT *&str,
+    const CharT *end,
+    uint64_t &mantissa,
+    unsigned &numDigits) {
+  uint32_t eight;
+  while (end - str >= 8 && numDigits + 8 <= kMaxFastDecimalDigits &&
+         readEightDecimalDigits(str, eight)) {
+    mantissa = mantissa * 100000000 + eight;
+    numDigits += 8;
+    str += 8;
+  }
+  for (; str != end && '0' <= *str && *str <= '9'; ++str) {
+    if (++numDigits > kMaxFastDecimalDigits)
+      return false;
+    mantissa = mantissa * 10 + (*str - '0');
+  }
+  return true;
+}
+
+/// Parse the decimal digits at the start of [begin, end) into \p result, if
+/// their value is exactly representable.
+/// \return the end of the digits, or nullptr if there are none or their value
+/// is above 2**53, in which case it must be computed another way.
+template <typename CharT>
+const CharT *
+parseDecimalIntegerFast(const CharT *begin, const CharT *end, double &result) {
+  const CharT *str = begin;
+  while (str != end && *str == '0')
+    ++str;
+  uint64_t mantissa = 0;
+  unsigned numDigits = 0;
+  if (!parseDecimalDigits(str, end, mantissa, numDigits) || str == begin ||
+      mantissa > (uint64_t(1) << 53))
+    return nullptr;
+  result = mantissa;
+  return str;
+}
+
+/// Parse the unsigned decimal number at the start of [begin, end) into
+/// \p result: digits with an optional fraction and exponent, as in a
+/// StrUnsignedDecimalLiteral other than Infinity. This is the case of
+/// Clinger's fast path, where the digits and the power of ten are exact
+/// doubles, so that one multiplication or division rounds correctly.
+/// \return the end of the number, or nullptr if there is none or it must be
+/// converted by strtod().
+template <typename CharT>
+const CharT *
+parseDecimalFast(const CharT *begin, const CharT *end, double &result) {
+  static const double powersOfTen[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const int maxPower = 22;
+
+  const CharT *str = begin;
+  bool anyDigits = false;
+  uint64_t mantissa = 0;
+  unsigned numDigits = 0;
+  int exponent = 0;
+
+  // Leading zeros don't count towards the digits which fit in the mantissa.
+  for (; str != end && *str == '0'; ++str)
+    anyDigits = true;
+  const CharT *digits = str;
+  if (!parseDecimalDigits(str, end, mantissa, numDigits))
+    return nullptr;
+  anyDigits |= str != digits;
+
+  if (str != end && *str == '.') {
+    ++str;
+    if (!mantissa) {
+      for (; str != end && *str == '0'; ++str) {
+        anyDigits = true;
+        --exponent;
+      }
+    }
+    digits = str;
+    if (!parseDecimalDigits(str, end, mantissa, numDigits))
+      return nullptr;
+    anyDigits |= str != digits;
+    exponent -= static_cast<int>(str - digits);
+  }
+  if (!anyDigits)
+    return nullptr;
+
+  // The exponent is only part of the number if it has digits.
+  if (str != end && (*str == 'e' || *str == 'E')) {
+    const CharT *exp = str + 1;
+    bool negative = false;
+    if (exp != end && (*exp == '+' || *exp == '-')) {
+      negative = *exp == '-';
+      ++exp;
+    }
+    if (exp != end && '0' <= *exp && *exp <= '9') {
+      int value = 0;
+      for (; exp != end && '0' <= *exp && *exp <= '9'; ++exp) {
+        value = value * 10 + (*exp - '0');
+        if (value > 1000)
+          return nullptr;
+      }
+      exponent += negative ? -value : value;
+      str = exp;
+    }
+  }
+
+  if (mantissa > (uint64_t(1) << 53))
+    return nullptr;
+  if (!mantissa) {
+    result = 0;
+  } else if (exponent < 0) {
+    if (exponent < -maxPower)
+      return nullptr;
+    result = static_cast<double>(mantissa) / powersOfTen[-exponent];
+  } else {
+    if (exponent > maxPower)
+      return nullptr;
+    result = static_cast<double>(mantissa) * powersOfTen[exponent];
+  }
+  return str;
+}
+
 } // namespace hermes
 
 #endif // HERMES_SUPPORT_CONVERSIONS_H
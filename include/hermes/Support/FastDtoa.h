@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SUPPORT_FASTDTOA_H
+#define HERMES_SUPPORT_FASTDTOA_H
+
+namespace hermes {
+
+/// The maximum number of digits written by fastShortestDtoa().
+const unsigned FAST_DTOA_MAX_DIGITS = 17;
+
+/// Generate the shortest digits that round-trip to \p v, closest to it, with
+/// the Grisu3 algorithm by Florian Loitsch ("Printing Floating-Point Numbers
+/// Quickly and Accurately with Integers", PLDI 2010). It only uses 64-bit
+/// integer arithmetic, but gives up on about 0.5% of the numbers, where it
+/// can't prove that its result is the shortest or the closest one, and the
+/// caller must use dtoa instead.
+/// \param v a finite positive number.
+/// \param buf receives the digits without a terminating zero, at least
+///   FAST_DTOA_MAX_DIGITS chars.
+/// \param[out] decimalPoint the position of the decimal point relative to
+///   the first digit, which is n in ES5.1 9.8.1.
+/// \return the number of digits, or 0 if the algorithm gave up.
+unsigned fastShortestDtoa(double v, char *buf, int *decimalPoint);
+
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_FASTDTOA_H
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SUPPORT_LZ4_H
+#define HERMES_SUPPORT_LZ4_H
+
+#include "llvm/ADT/ArrayRef.h"
+
+#include <vector>
+
+namespace hermes {
+
+/// Compress \p input in the LZ4 block format and append the result to \p out.
+/// The block can be expanded by any LZ4 decoder given the size of \p input.
+void compressLZ4Block(
+    llvm::ArrayRef<uint8_t> input,
+    std::vector<uint8_t> &out);
+
+/// Expand the LZ4 block \p input into \p output, which must be exactly the
+/// size of the original data.
+/// \return false if \p input is malformed or doesn't expand to the size of
+///   \p output, in which case the contents of \p output are unspecified.
+bool decompressLZ4Block(
+    llvm::ArrayRef<uint8_t> input,
+    llvm::MutableArrayRef<uint8_t> output);
+
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_LZ4_H
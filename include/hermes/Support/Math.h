@@ -9,6 +9,7 @@
 #define HERMES_SUPPORT_MATH_H
 
 #include <cmath>
+#include <limits>
 
 namespace hermes {
 
@@ -30,6 +31,28 @@ inline double expOp(double x, double y) {
   return std::pow(x, y);
 }
 
+/// ES9.0 20.2.2.25
+/// \return Math.min(x, y) on doubles, which is NaN if either is NaN, and
+/// treats -0 as less than +0.
+inline double minOp(double x, double y) {
+  if (std::isnan(x) || std::isnan(y))
+    return std::numeric_limits<double>::quiet_NaN();
+  if (x == y)
+    return std::signbit(x) ? x : y;
+  return x < y ? x : y;
+}
+
+/// ES9.0 20.2.2.24
+/// \return Math.max(x, y) on doubles, which is NaN if either is NaN, and
+/// treats +0 as greater than -0.
+inline double maxOp(double x, double y) {
+  if (std::isnan(x) || std::isnan(y))
+    return std::numeric_limits<double>::quiet_NaN();
+  if (x == y)
+    return std::signbit(x) ? y : x;
+  return x > y ? x : y;
+}
+
 } // namespace hermes
 
 #endif
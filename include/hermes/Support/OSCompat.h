@@ -106,6 +106,23 @@ bool vm_protect(void *p, size_t sz, ProtectMode mode);
 enum class MAdvice { Random, Sequential };
 bool vm_madvise(void *p, size_t sz, MAdvice advice);
 
+/// \return the size of the huge pages used by vm_allocate_huge_aligned and
+/// vm_hugepage, where they are supported.
+size_t huge_page_size();
+
+/// Like \p vm_allocate_aligned, but backs the region with explicit huge pages
+/// (MAP_HUGETLB), which must have been reserved by the system administrator.
+/// \p sz and \p alignment must be multiples of huge_page_size().  Returns an
+/// error if the region cannot be allocated, or if the platform does not
+/// support explicit huge pages.  Free the region with \p vm_free_aligned.
+llvm::ErrorOr<void *> vm_allocate_huge_aligned(size_t sz, size_t alignment);
+
+/// Ask the OS to back the \p sz byte region of memory starting at \p p with
+/// transparent huge pages (MADV_HUGEPAGE), where it is aligned to them.
+/// \p p must be page-aligned.  \return true if successful, false on error or
+/// if the platform does not support it.
+bool vm_hugepage(void *p, size_t sz);
+
 /// Return the number of pages in the given region that are currently in RAM.
 /// If \p runs is provided, then populate it with the lengths of runs of
 /// consecutive pages with the same resident/non-resident status, alternating
@@ -150,6 +167,10 @@ bool thread_page_fault_count(int64_t *outMinorFaults, int64_t *outMajorFaults);
 /// \return name of current thread.
 std::string thread_name();
 
+/// Restrict the current thread to run on CPU \p cpu only.
+/// \return true if successful, false on error or if unsupported.
+bool set_thread_affinity(unsigned cpu);
+
 /// Converts a value to its string representation.  Only works for
 /// numeric values, e.g. 0 becomes "0", not '\0'.
 ///
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SUPPORT_TRACEEVENTS_H
+#define HERMES_SUPPORT_TRACEEVENTS_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hermes {
+namespace trace {
+
+/// The categories of trace events, which are enabled separately.
+enum class Category : uint32_t {
+  /// Entry points of JS execution: running bytecode and requiring modules.
+  Execution = 1 << 0,
+  /// Collections and their phases.
+  GC = 1 << 1,
+  /// Lazy compilation, RegExp compilation, and JIT compilation and install.
+  Compile = 1 << 2,
+};
+
+/// All the categories.
+constexpr uint32_t kAllCategories = 0x7;
+
+/// \return the name of \p category in traces.
+const char *categoryName(Category category);
+
+/// \return the categories named in the comma separated list \p names, or
+/// llvm::None if one of them is unknown.
+llvm::Optional<uint32_t> parseCategories(llvm::StringRef names);
+
+/// An argument recorded with an event.
+struct Arg {
+  enum class Kind { Int, Double, String };
+  const char *name;
+  Kind kind;
+  int64_t i{0};
+  double d{0};
+  std::string s;
+
+  Arg(const char *name, int64_t i) : name(name), kind(Kind::Int), i(i) {}
+  Arg(const char *name, double d) : name(name), kind(Kind::Double), d(d) {}
+  Arg(const char *name, std::string s)
+      : name(name), kind(Kind::String), s(std::move(s)) {}
+};
+
+/// Receives the events of the enabled categories, from every thread that
+/// runs them, so it must be thread-safe.
+class Sink {
+ public:
+  virtual ~Sink();
+
+  /// An event named \p name starts on the calling thread.
+  virtual void begin(Category category, const char *name) = 0;
+
+  /// The last event started on the calling thread ends, with \p args.
+  virtual void
+  end(Category category, const char *name, llvm::ArrayRef<Arg> args) = 0;
+};
+
+namespace detail {
+/// The categories enabled, checked by every event.
+extern std::atomic<uint32_t> enabledCategories;
+/// \return the sink, if it is installed.
+std::shared_ptr<Sink> getSink();
+} // namespace detail
+
+/// Send the events of \p categories to \p sink, replacing the previous sink.
+/// Events in flight end in the sink they began in. A null \p sink disables
+/// all categories.
+void setSink(std::shared_ptr<Sink> sink, uint32_t categories = kAllCategories);
+
+/// \return whether the events of \p category are being recorded.
+inline bool isEnabled(Category category) {
+  return detail::enabledCategories.load(std::memory_order_relaxed) &
+      static_cast<uint32_t>(category);
+}
+
+/// An RAII-style object delimiting an event on the calling thread. When its
+/// category is disabled it only costs a load and a branch on construction,
+/// and a branch on each argument and on destruction.
+class Scope {
+ public:
+  Scope(Category category, const char *name)
+      : category_(category), name_(name) {
+    if (LLVM_UNLIKELY(isEnabled(category)))
+      beginSlow();
+  }
+
+  ~Scope() {
+    if (LLVM_UNLIKELY(sink_ != nullptr))
+      sink_->end(category_, name_, args_);
+  }
+
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+  /// \return whether the event is being recorded, to skip computing
+  /// arguments that are expensive to get.
+  bool enabled() const {
+    return sink_ != nullptr;
+  }
+
+  /// Record the argument \p name with \p value.
+  void addArg(const char *name, int64_t value) {
+    if (LLVM_UNLIKELY(sink_ != nullptr))
+      args_.emplace_back(name, value);
+  }
+  void addArgD(const char *name, double value) {
+    if (LLVM_UNLIKELY(sink_ != nullptr))
+      args_.emplace_back(name, value);
+  }
+  void addArg(const char *name, llvm::StringRef value) {
+    if (LLVM_UNLIKELY(sink_ != nullptr))
+      args_.emplace_back(name, value.str());
+  }
+
+ private:
+  void beginSlow();
+
+  const Category category_;
+  const char *const name_;
+  /// The sink the event began in, or null if it is not recorded.
+  std::shared_ptr<Sink> sink_;
+  llvm::SmallVector<Arg, 2> args_;
+};
+
+/// Records the events in memory, and writes them in the Chrome trace event
+/// format, which Chrome's about:tracing and the Perfetto UI load.
+class ChromeTraceSink final : public Sink {
+ public:
+  void begin(Category category, const char *name) override;
+  void end(Category category, const char *name, llvm::ArrayRef<Arg> args)
+      override;
+
+  /// Write the events that have ended so far to \p OS as a JSON object.
+  void serialize(llvm::raw_ostream &OS);
+
+ private:
+  /// An event that has ended.
+  struct Event {
+    Category category;
+    const char *name;
+    uint64_t tid;
+    /// Start and duration, in microseconds.
+    int64_t ts;
+    int64_t dur;
+    std::vector<Arg> args;
+  };
+
+  std::mutex mtx_;
+  std::vector<Event> events_;
+  /// The start times of the events in flight, by thread.
+  std::vector<std::pair<uint64_t, int64_t>> open_;
+};
+
+/// Writes the events to the ftrace marker file, as ATrace does, so that
+/// systrace and Perfetto's ftrace data source record them along with the
+/// system's own events. Arguments are dropped, since the markers of
+/// ATrace have none.
+class ATraceSink final : public Sink {
+ public:
+  /// Open the marker file of the kernel.
+  ATraceSink();
+  ~ATraceSink() override;
+
+  /// \return whether the marker file could be opened.
+  bool isOpen() const {
+    return fd_ != -1;
+  }
+
+  void begin(Category category, const char *name) override;
+  void end(Category category, const char *name, llvm::ArrayRef<Arg> args)
+      override;
+
+ private:
+  int fd_{-1};
+};
+
+} // namespace trace
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_TRACEEVENTS_H
@@ -30,7 +30,8 @@ class UTF16Stream {
         utf8End_(nullptr) {}
 
   /// A stream that converts \p utf8 to UTF16. If the input is not valid UTF8,
-  /// then the stream will end at the first malformed character.
+  /// then the stream will end at the first malformed character, and
+  /// isMalformed() will return true once it has.
   explicit UTF16Stream(llvm::ArrayRef<uint8_t> utf8);
 
   /// Movable but not copyable.
@@ -59,6 +60,27 @@ class UTF16Stream {
     return *this;
   }
 
+  /// Returns the UTF16 units starting at the current stream position which
+  /// are available without converting more input.
+  /// \pre hasChar returns true.
+  llvm::ArrayRef<char16_t> available() const {
+    assert(cur_ != end_ && "must check hasChar");
+    return llvm::ArrayRef<char16_t>(cur_, end_);
+  }
+
+  /// Advances the stream by \p n UTF16 units, which must be available.
+  UTF16Stream &operator+=(size_t n) {
+    assert(n <= (size_t)(end_ - cur_) && "must be available");
+    cur_ += n;
+    return *this;
+  }
+
+  /// Returns whether the stream ended early because the UTF8 input was
+  /// malformed. Only meaningful once hasChar has returned false.
+  bool isMalformed() const {
+    return malformed_;
+  }
+
  private:
   /// Tries to convert more data. Returns true if more data was converted.
   bool refill();
@@ -74,6 +96,9 @@ class UTF16Stream {
 
   /// The conversion buffer (if UTF8 input).
   OwningArray<char16_t> storage_;
+
+  /// Whether the conversion stopped at a malformed character.
+  bool malformed_{false};
 };
 
 }; // namespace hermes
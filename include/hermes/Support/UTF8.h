@@ -58,6 +58,20 @@ inline bool isAllASCII(const char *start, const char *end) {
   return isAllASCII((const uint8_t *)start, (const uint8_t *)end);
 }
 
+/// \return the first character of the ASCII characters [start, end) which
+/// changes when converting them to upper case if \p upperCase, or else to
+/// lower case, or \p end if none does.
+const char *
+findASCIICaseChange(const char *start, const char *end, bool upperCase);
+
+/// Write the ASCII characters [start, end) to \p out, converted to upper case
+/// if \p upperCase, or else to lower case.
+void convertASCIICase(
+    const char *start,
+    const char *end,
+    char *out,
+    bool upperCase);
+
 /// Decode a sequence of UTF8 encoded bytes when it is known that the first byte
 /// is a start of an UTF8 sequence.
 /// \param allowSurrogates when false, values in the surrogate range are
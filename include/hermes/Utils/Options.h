@@ -8,6 +8,9 @@
 #ifndef HERMES_UTILS_OPTIONS_H
 #define HERMES_UTILS_OPTIONS_H
 
+#include <cstdint>
+#include <vector>
+
 namespace hermes {
 
 enum OutputFormatKind {
@@ -24,6 +27,16 @@ enum OutputFormatKind {
   EmitBundle
 };
 
+/// A part of a bytecode file read during a traced startup: the body of
+/// function \c functionID if \c length is 0, else the \c length bytes at
+/// \c offset. Such ranges lie before the function bodies, which is the part
+/// of the file that doesn't depend on the order of the bodies.
+struct StartupRead {
+  uint32_t functionID;
+  uint32_t offset;
+  uint32_t length;
+};
+
 /// Options controlling the type of output to generate.
 struct BytecodeGenerationOptions {
   /// The format of the output.
@@ -54,6 +67,34 @@ struct BytecodeGenerationOptions {
   /// Add this much garbage after each function body (relative to its size).
   unsigned padFunctionBodiesPercent = 0;
 
+  /// Renumber the registers of each optimized function once Movs have been
+  /// eliminated, to shrink its frame.
+  bool compactRegisters = false;
+
+  /// Thread jumps, fold branches on constants, drop redundant Movs and fuse
+  /// GetEnvironment with the following environment access during instruction
+  /// selection.
+  bool bytecodePeephole = false;
+
+  /// Read the properties of object literals from the slots they have in the
+  /// literal, guarded by a check of the hidden class.
+  bool literalSlots = false;
+
+  /// Emit the bytecode file in compressed form (see CompressedBytecodeHeader).
+  bool compressBytecode = false;
+
+  /// The number of threads allocating registers during code generation. The
+  /// output doesn't depend on it.
+  unsigned numCodegenThreads = 1;
+
+  /// IDs of functions whose bodies are placed first in the bytecode file, in
+  /// this order. The remaining bodies follow in the order of their IDs.
+  std::vector<uint32_t> functionLayoutOrder{};
+
+  /// The parts of the file read during startup, in the order they were first
+  /// touched. They are recorded in the prefetch table of the file.
+  std::vector<StartupRead> startupReads{};
+
   /* implicit */ BytecodeGenerationOptions(OutputFormatKind format)
       : format(format) {}
 
@@ -31,7 +31,9 @@ namespace hermes {
 namespace vm {
 
 class CompactionResult;
+class FreeList;
 class GCGeneration;
+struct RuntimeOffsets;
 
 // In this class:
 // TODO (T25527350): Debug Dump
@@ -58,6 +60,8 @@ class GCGeneration;
 class AlignedHeapSegment final {
   friend CompactionResult::Allocator;
   friend CompactionResult::Chunk;
+  // The JIT bumps level_ against effectiveEnd_ inline.
+  friend struct RuntimeOffsets;
 
  public:
   /// Construct a null AlignedHeapSegment (one that does not own memory).
@@ -262,6 +266,12 @@ class AlignedHeapSegment final {
   template <AdviseUnused MU = AdviseUnused::No>
   void resetLevel();
 
+  /// Return the pages above the level of this segment, up to the end of its
+  /// storage, to the OS.  Unlike setLevel, this covers pages that were dirtied
+  /// before the segment was last shrunk.  Debug builds keep the pages, as they
+  /// hold the pattern that marks unwritten memory.
+  void markUnusedAboveLevel();
+
   /// Increase the size of the allocation region in this segment by the minimum
   /// amount such that this.size() >= desired.
   ///
@@ -295,6 +305,11 @@ class AlignedHeapSegment final {
   /// max size of markStack sets a flag and returns.
   void completeMarking(GC *gc, CompleteMarkState *markState);
 
+  /// Call \p callback on every cell in this segment whose mark bit is
+  /// currently set, in increasing address order.  Used to seed parallel
+  /// marking with the cells marked from the roots.
+  void forMarkedObjs(const std::function<void(GCCell *)> &callback);
+
   /// Assumes marking is complete.  Scans the heap, determining, for each live
   /// object, the address to which it will later be compacted.  Objects are
   /// compacted into chunks, in the order they are provided by
@@ -309,6 +324,23 @@ class AlignedHeapSegment final {
   /// subsequent heap traversals.
   void sweepAndInstallForwardingPointers(GC *gc, SweepResult *sweepResult);
 
+  /// Assumes marking is complete.  \return true if at least \p minLiveFraction
+  /// of the allocated bytes in this segment are live, and every gap between
+  /// live objects is large enough to hold a FillerCell, so that the segment
+  /// can be swept with sweepInPlace.
+  bool canSweepInPlace(double minLiveFraction) const;
+
+  /// An alternative to sweepAndInstallForwardingPointers for segments that are
+  /// mostly live, which does not move their live objects: their forwarding
+  /// pointers point to themselves, they are not trimmed, and compact() turns
+  /// the dead regions between them into FillerCells.  Segments swept this way
+  /// have no memory copied during compaction.  Those regions are recorded in
+  /// \p freeList, to be allocated into after the collection.
+  ///
+  /// \pre The active chunk of sweepResult->compactionResult was created from
+  ///     this segment, and nothing has been compacted into it yet.
+  void sweepInPlace(GC *gc, SweepResult *sweepResult, FreeList *freeList);
+
   /// Assumes sweeping is complete.  Traverses the live objects, scanning their
   /// pointers.  For each pointer to another heap object, update the pointer by
   /// following the referent's forwarding pointer.  Marked cells are considered
@@ -326,8 +358,10 @@ class AlignedHeapSegment final {
   /// the VTable pointers of the N remaining live cells.  Moves each live cell
   /// to the post-compaction address indicated by its forwarding pointer and
   /// restores its displaced VTable pointer, consuming it in the process
-  /// (indicated by incrementing *vTableBegin).
-  void compact(SweepResult::VTablesRemaining &vTables);
+  /// (indicated by incrementing *vTableBegin).  If the segment was swept in
+  /// place, fills the dead regions between its live cells instead, using \p gc
+  /// to construct the FillerCells.
+  void compact(GC *gc, SweepResult::VTablesRemaining &vTables);
 
   /// TODO (T25573911): the next two methods are usually debug-only; exposed
   /// in opt for temporary old-to-young pointer traversal.
@@ -425,6 +459,10 @@ class AlignedHeapSegment final {
   /// Pointer to the generation that owns this segment.
   GCGeneration *generation_{nullptr};
 
+  /// Whether the current full collection swept this segment in place, see
+  /// sweepInPlace.  Reset by compact().
+  bool sweptInPlace_{false};
+
 #ifdef HERMES_EXTRA_DEBUG
   /// Support summarization of the vtables in the segment.
   /// TODO(T56364255): remove this when the problem is diagnosed.
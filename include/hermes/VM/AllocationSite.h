@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_ALLOCATIONSITE_H
+#define HERMES_VM_ALLOCATIONSITE_H
+
+#include <cstdint>
+
+namespace hermes {
+namespace vm {
+
+/// Survival feedback for one instruction allocating object or array literals,
+/// used to decide whether its objects should be allocated directly in the old
+/// generation ("pretenured").
+///
+/// The GC samples at most one object per site at a time: the sample is taken
+/// when the object is allocated, and resolved by the first collection that
+/// runs afterwards, by checking whether the object survived it.  Once enough
+/// samples are known and almost all of them survived, the site is pretenured
+/// for good.  Otherwise the counts decay, so that a site whose objects become
+/// long-lived later on (e.g. once module initialization is over) can still be
+/// pretenured.
+class AllocationSite {
+ public:
+  /// The number of samples needed before deciding whether to pretenure.
+  static constexpr uint32_t kMinSamples = 16;
+
+  /// The site is pretenured if at least kSurvivalNumerator /
+  /// kSurvivalDenominator of its samples survived.
+  static constexpr uint32_t kSurvivalNumerator = 7;
+  static constexpr uint32_t kSurvivalDenominator = 8;
+
+  /// \return whether objects allocated at this site should go directly to the
+  /// old generation.
+  bool shouldPretenure() const {
+    return pretenure_;
+  }
+
+  /// \return whether an object allocated at this site is currently being
+  /// sampled.
+  bool isSampling() const {
+    return sampling_;
+  }
+
+  /// Start sampling an object allocated at this site.
+  void startSample() {
+    sampling_ = true;
+  }
+
+  /// Record the outcome of the current sample: \p survived says whether the
+  /// object survived the collection that resolved it.
+  void recordSample(bool survived) {
+    sampling_ = false;
+    ++numSamples_;
+    if (survived) {
+      ++numSurvived_;
+    }
+    if (numSamples_ < kMinSamples) {
+      return;
+    }
+    if (numSurvived_ * kSurvivalDenominator >=
+        numSamples_ * kSurvivalNumerator) {
+      pretenure_ = true;
+      return;
+    }
+    numSamples_ /= 2;
+    numSurvived_ /= 2;
+  }
+
+  uint32_t numSamples() const {
+    return numSamples_;
+  }
+
+  uint32_t numSurvived() const {
+    return numSurvived_;
+  }
+
+ private:
+  /// The number of resolved samples, and how many of them survived.
+  uint32_t numSamples_{0};
+  uint32_t numSurvived_{0};
+
+  /// Whether an object from this site is waiting to be resolved by a GC.
+  bool sampling_{false};
+
+  /// Whether this site is pretenured.
+  bool pretenure_{false};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_ALLOCATIONSITE_H
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_BACKGROUNDFREER_H
+#define HERMES_VM_BACKGROUNDFREER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// Frees batches of malloc'd memory on a worker thread, so that releasing the
+/// native memory of cells finalized during a collection does not lengthen the
+/// pause.  The worker thread is created lazily, by the first batch.
+class BackgroundFreer {
+ public:
+  BackgroundFreer() = default;
+
+  /// Frees any memory still pending, and joins the worker thread.
+  ~BackgroundFreer();
+
+  BackgroundFreer(const BackgroundFreer &) = delete;
+  BackgroundFreer &operator=(const BackgroundFreer &) = delete;
+
+  /// Take ownership of the memory blocks in \p batch, which is left empty, and
+  /// free them on the worker thread.
+  void enqueue(std::vector<void *> &batch);
+
+  /// Block until every memory block enqueued so far has been freed.
+  void waitUntilIdle();
+
+ private:
+  /// The loop run by the worker thread.
+  void workerLoop();
+
+  /// Protects pending_, busy_ and shouldExit_.
+  std::mutex mtx_;
+
+  /// Signalled when work is enqueued, or the worker should exit.
+  std::condition_variable workAvailable_;
+
+  /// Signalled when the worker has run out of work.
+  std::condition_variable idle_;
+
+  /// Memory blocks waiting to be freed.
+  std::vector<void *> pending_;
+
+  /// Whether the worker is freeing a batch it has taken out of pending_.
+  bool busy_{false};
+
+  /// Whether the worker thread should exit once pending_ is empty.
+  bool shouldExit_{false};
+
+  std::thread worker_;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_BACKGROUNDFREER_H
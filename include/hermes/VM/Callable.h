@@ -342,6 +342,76 @@ class Callable : public JSObject {
       Handle<JSObject> parentHandle);
 };
 
+/// A call of a function with a fixed "this" and number of arguments, which a
+/// builtin makes many times, like the comparator of Array.prototype.sort. The
+/// native call frame is set up once, instead of for every call as
+/// Callable::executeCall*() do, and each call only stores its arguments.
+/// The frame stays on the register stack as long as this object lives, so it
+/// must be allocated on the C++ stack. Other calls made in the meantime, e.g.
+/// to getters, simply get frames above it.
+/// Usage example:
+///   PreparedCall callback{runtime, callbackFn, thisArg, 3};
+///   if (LLVM_UNLIKELY(callback.overflowed()))
+///     return runtime->raiseStackOverflow(...);
+///   for (...)
+///     auto callRes = callback.call(value, index, obj);
+class PreparedCall {
+  /// The runtime to call in.
+  Runtime *const runtime_;
+
+  /// The function to call.
+  const Handle<Callable> callee_;
+
+  /// The "this" argument of every call.
+  const Handle<> thisArg_;
+
+  /// The number of arguments of every call.
+  const uint32_t argCount_;
+
+  /// The frame reused by every call.
+  ScopedNativeCallFrame frame_;
+
+ public:
+  PreparedCall(
+      Runtime *runtime,
+      Handle<Callable> callee,
+      Handle<> thisArg,
+      uint32_t argCount)
+      : runtime_(runtime),
+        callee_(callee),
+        thisArg_(thisArg),
+        argCount_(argCount),
+        frame_{runtime, argCount, *callee, false, *thisArg} {
+    // The arguments must be valid before anything collects garbage.
+    if (LLVM_LIKELY(!frame_.overflowed()))
+      frame_.fillArguments(argCount, HermesValue::encodeUndefinedValue());
+  }
+
+  /// \return whether the frame couldn't be set up, in which case the call must
+  ///   not be made.
+  bool overflowed() const {
+    return frame_.overflowed();
+  }
+
+  /// Call the function with the arguments \p args, whose number must be the
+  /// one the call was prepared for.
+  CallResult<HermesValue> callWithArgs(llvm::ArrayRef<HermesValue> args) {
+    assert(args.size() == argCount_ && "wrong number of arguments");
+    frame_.reinitialize(argCount_, *callee_, *thisArg_);
+    for (uint32_t i = 0; i != argCount_; ++i)
+      frame_->getArgRef(i) = args[i];
+    return Callable::call(callee_, runtime_);
+  }
+
+  /// Call the function with the arguments \p args, of which there must be at
+  /// least one.
+  template <typename... Args>
+  CallResult<HermesValue> call(Args... args) {
+    const HermesValue argValues[] = {args...};
+    return callWithArgs(argValues);
+  }
+};
+
 /// A function produced by Function.prototype.bind(). It packages a function
 /// with values for some of its parameters.
 class BoundFunction final : public Callable {
@@ -402,6 +472,17 @@ class BoundFunction final : public Callable {
     return argStorage_.get(runtime)->size();
   }
 
+  /// \return the bound 'this' argument.
+  HermesValue getBoundThis(Runtime *runtime) const {
+    return argStorage_.get(runtime)->at(0);
+  }
+
+  /// \return true if only 'this' is bound, so a call can pass its arguments
+  /// straight to the target.
+  bool bindsOnlyThis(Runtime *runtime) const {
+    return getArgCountWithThis(runtime) == 1;
+  }
+
  private:
 #ifdef HERMESVM_SERIALIZE
   explicit BoundFunction(Deserializer &d);
@@ -805,6 +886,7 @@ class NativeConstructor final : public NativeFunction {
 class JSFunction : public Callable {
   using Super = Callable;
   friend void FunctionBuildMeta(const GCCell *cell, Metadata::Builder &mb);
+  friend struct JSFunctionOffsets;
 
   /// CodeBlock to execute when called.
   CodeBlock *codeBlock_;
@@ -917,6 +999,13 @@ class JSFunction : public Callable {
       Handle<Callable> selfHandle,
       Runtime *runtime);
 
+  /// Create the 'this' object of a constructor call, with storage for as
+  /// many properties as the previous objects the function constructed had.
+  static CallResult<HermesValue> _newObjectImpl(
+      Handle<Callable> selfHandle,
+      Runtime *runtime,
+      Handle<JSObject> parentHandle);
+
   static std::string _snapshotNameImpl(GCCell *cell, GC *gc);
 };
 
@@ -1099,12 +1188,15 @@ class GeneratorInnerFunction final : public JSFunction {
   }
 
   /// Restores the stack variables needed to resume execution from a
-  /// SuspendedYield state.
+  /// SuspendedYield state. Only the registers saved by the last saveStack
+  /// are copied back; the rest of the frame keeps its initial undefined.
   void restoreStack(Runtime *runtime);
 
   /// Saves the stack variables needed to resume execution from a SuspendedYield
   /// state, and places them in an internal property.
-  void saveStack(Runtime *runtime);
+  /// \param numRegs the number of registers, counted from the first, which
+  ///   hold every value live after the yield.
+  void saveStack(Runtime *runtime, uint32_t numRegs);
 
   void setNextIP(const Inst *ip) {
     nextIPOffset_ = getCodeBlock()->getOffsetOf(ip);
@@ -1169,6 +1261,11 @@ class GeneratorInnerFunction final : public JSFunction {
   /// Saved as uint32_t instead of Inst * in order to save memory.
   uint32_t nextIPOffset_{0};
 
+  /// The number of frame slots, including the extra registers at the start of
+  /// the frame, stored by the last saveStack. They are the slots at the end of
+  /// the saved frame in savedContext_.
+  uint32_t savedRegCount_{0};
+
   /// The action requested by the user by the way the generator is invoked.
   Action action_;
 
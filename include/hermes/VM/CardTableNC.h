@@ -34,6 +34,11 @@ namespace vm {
 /// object whose extent [obj-start, end) contains the start of the card.  This
 /// allows us to scan dirty cards: finding the crossing object allows us to then
 /// do object-to-object traversal to the end of the card.
+///
+/// Each run of kCardsPerSummary cards is also summarized by an entry in a
+/// smaller table, which is dirty whenever one of the cards it covers may be.
+/// Searches for dirty cards consult the summary first, so that the clean parts
+/// of a segment are skipped in bulk.
 class CardTable {
  public:
   /// Points at the start of a card.
@@ -72,6 +77,17 @@ class CardTable {
   static constexpr size_t kCardTableSize =
       llvm::alignTo<pagesize::kExpectedPageSize>(kValidIndices);
 
+  /// The number (and base-two log of the number) of cards covered by each
+  /// entry of the summary table.
+  static constexpr size_t kLogCardsPerSummary = 6; // ==> 32KB per entry.
+  static constexpr size_t kCardsPerSummary = 1 << kLogCardsPerSummary;
+
+  /// The size of the summary table: also rounded up to the maximum page size,
+  /// so that the structures following the card table stay page-aligned.
+  static constexpr size_t kSummaryTableSize =
+      llvm::alignTo<pagesize::kExpectedPageSize>(
+          kCardTableSize >> kLogCardsPerSummary);
+
   /// A prefix of every segment is occupied by auxilary data
   /// structures.  The card table is the first such data structure.
   /// The card table maps to the segment.  Only the suffix of the card
@@ -84,9 +100,9 @@ class CardTable {
   /// the card table, so it can be used for other purposes.
   /// Note that the total size of the card table is 2 times
   /// kCardTableSize, since the CardTable contains two byte arrays of
-  /// that size (cards_ and _boundaries_).
+  /// that size (cards_ and _boundaries_), plus the summary table.
   static constexpr size_t kUnusedPrefixSize =
-      (2 * kCardTableSize) >> kLogCardSize;
+      (2 * kCardTableSize + kSummaryTableSize) >> kLogCardSize;
 
   /// It is sometimes more clear to name the value above as the first valid
   /// index of the card table.  The translation from size to index assumes that
@@ -150,10 +166,14 @@ class CardTable {
   /// \pre \p index is required to be a valid card table index.
   inline bool isCardForIndexDirty(const size_t index) const;
 
+  /// Returns whether the summary entry covering the card at the given index
+  /// is dirty, i.e. whether searches for dirty cards look at that card.
+  /// \pre \p index is required to be a valid card table index.
+  inline bool isSummaryForIndexDirty(const size_t index) const;
+
   /// If there is a dirty card at or after \p fromIndex, at an index less than
   /// \p endIndex, returns the index of the dirty card, else returns none.
-  inline OptValue<size_t> findNextDirtyCard(size_t fromIndex, size_t endIndex)
-      const;
+  OptValue<size_t> findNextDirtyCard(size_t fromIndex, size_t endIndex) const;
 
   /// If there is a card card at or after \p fromIndex, at an index less than
   /// \p endIndex, returns the index of the clean card, else returns none.
@@ -247,12 +267,23 @@ class CardTable {
   /// Returns true iff ptr is card-aligned.
   static inline bool isCardAligned(const void *ptr);
 
+  /// \return the index of the first entry of \p table in the range
+  /// [fromIndex, endIndex) with value \p status, or none if one does not
+  /// exist.
+  static OptValue<size_t> findNextWithStatus(
+      const CardStatus *table,
+      CardStatus status,
+      size_t fromIndex,
+      size_t endIndex);
+
   /// \return the index of the first card in the range [fromIndex, endIndex)
   /// with value \p status, or none if one does not exist.
   OptValue<size_t> findNextCardWithStatus(
       CardStatus status,
       size_t fromIndex,
-      size_t endIndex) const;
+      size_t endIndex) const {
+    return findNextWithStatus(cards_, status, fromIndex, endIndex);
+  }
 
   /// Clean, or dirty, the indicated index ranges in the card table.
   /// Ranges are inclusive: [from, to].
@@ -274,6 +305,13 @@ class CardTable {
   /// crossed cards gets a non-negative value, and each subsequent one uses the
   /// maximum exponent that stays within the card range for the object.
   int8_t boundaries_[kCardTableSize];
+
+  /// Entry I is dirty if any of the cards
+  /// [I * kCardsPerSummary, (I + 1) * kCardsPerSummary) may be dirty.  Dirtying
+  /// a card always dirties its entry, but cleaning cards only cleans the
+  /// entries whose cards are all cleaned, so a dirty entry may cover only clean
+  /// cards.  This placement, after boundaries_, keeps that table page-aligned.
+  CardStatus summary_[kSummaryTableSize]{};
 };
 
 /// Implementations of inlines.
@@ -311,7 +349,9 @@ inline const char *CardTable::indexToAddress(size_t index) const {
 }
 
 inline void CardTable::dirtyCardForAddress(const void *addr) {
-  cards_[addressToIndex(addr)] = CardStatus::Dirty;
+  const size_t index = addressToIndex(addr);
+  cards_[index] = CardStatus::Dirty;
+  summary_[index >> kLogCardsPerSummary] = CardStatus::Dirty;
 }
 
 inline bool CardTable::isCardForAddressDirty(const void *addr) const {
@@ -323,10 +363,9 @@ inline bool CardTable::isCardForIndexDirty(size_t index) const {
   return cards_[index] == CardStatus::Dirty;
 }
 
-inline OptValue<size_t> CardTable::findNextDirtyCard(
-    size_t fromIndex,
-    size_t endIndex) const {
-  return findNextCardWithStatus(CardStatus::Dirty, fromIndex, endIndex);
+inline bool CardTable::isSummaryForIndexDirty(size_t index) const {
+  assert(index < kValidIndices && "index is required to be in range.");
+  return summary_[index >> kLogCardsPerSummary] == CardStatus::Dirty;
 }
 
 inline OptValue<size_t> CardTable::findNextCleanCard(
@@ -13,16 +13,18 @@
 #include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
 #include "hermes/Inst/Inst.h"
 #include "hermes/Support/SourceErrorManager.h"
+#include "hermes/VM/AllocationSite.h"
 #include "hermes/VM/HermesValue.h"
 #include "hermes/VM/IdentifierTable.h"
 #include "hermes/VM/Profiler.h"
 #include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/SerializedLiteralParser.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/Optional.h"
-#include "llvm/Support/TrailingObjects.h"
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace hermes {
@@ -30,14 +32,14 @@ namespace vm {
 
 class RuntimeModule;
 class CodeBlock;
+class JSObject;
 
 /// A pointer to JIT-compiled function.
 typedef CallResult<HermesValue> (*JITCompiledFunctionPtr)(Runtime *runtime);
 
 /// A sequence of instructions representing the body of a function.
-class CodeBlock final
-    : private llvm::TrailingObjects<CodeBlock, PropertyCacheEntry> {
-  friend TrailingObjects;
+class CodeBlock final {
+  friend struct CodeBlockOffsets;
   /// Points to the runtime module with the information required for this code
   /// block.
   RuntimeModule *const runtimeModule_;
@@ -56,21 +58,57 @@ class CodeBlock final
   /// example because it contains constructs that the JIT can't handle.
   bool dontJIT_ = false;
 
+  /// Set whenever the compiled body is entered, and cleared when the JIT
+  /// looks for cold code to evict.
+  bool JITUsed_ = false;
+
   /// If this CodeBlock was compiled, a pointer to the body.
   JITCompiledFunctionPtr JITCompiled_ = nullptr;
 
   /// Function execution count.
-  /// Ideally, a function's hotness should also include if it has a loop and how
-  /// hot that loop is.
   uint32_t executionCount_ = 0;
+
+  /// Number of backward branches taken by the interpreter in this function,
+  /// i.e. the number of loop iterations it has executed.
+  uint32_t backEdgeCount_ = 0;
+
+  /// If this CodeBlock was compiled, the native entry points into the middle
+  /// of the body, keyed by the bytecode offset of the loop header they start
+  /// at. They expect the frame to have been set up by the interpreter.
+  llvm::DenseMap<uint32_t, JITCompiledFunctionPtr> JITLoopEntries_{};
+
+  /// Type feedback for the JIT: the offsets of the arithmetic and comparison
+  /// instructions that the interpreter executed with an operand that isn't a
+  /// number.
+  llvm::DenseSet<uint32_t> nonNumberArithSites_{};
+
+  /// Set once the function is queued for compilation on a background thread,
+  /// after which the type feedback no longer changes.
+  bool typeFeedbackFrozen_ = false;
 #endif
 
+  /// The property cache, allocated from the RuntimeModule when it is first
+  /// used, since most functions run only a few times if at all. Null until
+  /// then.
+  PropertyCacheEntry *propertyCache_{nullptr};
+
   /// Total size of the property cache.
-  const uint32_t propertyCacheSize_;
+  uint32_t propertyCacheSize_{0};
 
   /// Offset of the write property cache, which occurs after the read property
   /// cache.
-  const uint32_t writePropCacheOffset_;
+  uint32_t writePropCacheOffset_{0};
+
+  /// Survival feedback for the literal allocations in this function, keyed by
+  /// the offset of the allocating instruction.  A node-based map, because the
+  /// GC holds on to the sites it is sampling.
+  std::unordered_map<uint32_t, AllocationSite> allocationSites_;
+
+  /// Slack tracking for the objects constructed by this function: the most
+  /// recent one, held weakly, and the largest number of properties any of the
+  /// previous ones had when the next one was constructed.
+  JSObject *lastConstructed_{nullptr};
+  uint32_t numConstructedProperties_{0};
 
 #ifndef HERMESVM_LEAN
   /// Compiles a lazy CodeBlock. Intended to be called from lazyCompile.
@@ -82,30 +120,26 @@ class CodeBlock final
   /// \param start if true, return the start coordinates, else end coordinates.
   SourceErrorManager::SourceCoords getLazyFunctionLoc(bool start) const;
 
-  /// \return the base pointer of the property cache.
-  PropertyCacheEntry *propertyCache() {
-    return getTrailingObjects<PropertyCacheEntry>();
-  }
+  /// Allocate the property cache, sized for the highest cache indices in the
+  /// function header.
+  void allocatePropertyCache();
 
-  PropertyCacheEntry *writePropertyCache() {
-    return getTrailingObjects<PropertyCacheEntry>() + writePropCacheOffset_;
+  /// \return the base pointer of the property cache, allocating it if needed.
+  PropertyCacheEntry *propertyCache() {
+    if (LLVM_UNLIKELY(!propertyCache_))
+      allocatePropertyCache();
+    return propertyCache_;
   }
 
   CodeBlock(
       RuntimeModule *runtimeModule,
       hbc::RuntimeFunctionHeader header,
       const uint8_t *bytecode,
-      uint32_t functionID,
-      uint32_t cacheSize,
-      uint32_t writePropCacheOffset)
+      uint32_t functionID)
       : runtimeModule_(runtimeModule),
         functionHeader_(header),
         bytecode_(bytecode),
-        functionID_(functionID),
-        propertyCacheSize_(cacheSize),
-        writePropCacheOffset_(writePropCacheOffset) {
-    std::uninitialized_fill_n(propertyCache(), cacheSize, PropertyCacheEntry{});
-  }
+        functionID_(functionID) {}
 
  public:
 #if defined(HERMESVM_PROFILER_JSFUNCTION) || defined(HERMESVM_PROFILER_EXTERN)
@@ -122,18 +156,9 @@ class CodeBlock final
       RuntimeModule *runtimeModule,
       hbc::RuntimeFunctionHeader header,
       const uint8_t *bytecode,
-      uint32_t functionID,
-      uint32_t cacheSize,
-      uint32_t writePropCacheOffset) {
-    auto allocSize = totalSizeToAlloc<PropertyCacheEntry>(cacheSize);
-    void *mem = checkedMalloc(allocSize);
-    return new (mem) CodeBlock(
-        runtimeModule,
-        header,
-        bytecode,
-        functionID,
-        cacheSize,
-        writePropCacheOffset);
+      uint32_t functionID) {
+    void *mem = checkedMalloc(sizeof(CodeBlock));
+    return new (mem) CodeBlock(runtimeModule, header, bytecode, functionID);
   }
 
   /// Override of delete that balances the memory allocated in our create()
@@ -228,6 +253,22 @@ class CodeBlock final
     return offset;
   }
 
+  /// \return the allocation site of the instruction \p ip in this code block,
+  /// creating it if necessary.
+  AllocationSite &getAllocationSite(const inst::Inst *ip) {
+    return allocationSites_[getOffsetOf(ip)];
+  }
+
+  /// \return the number of properties to allocate storage for in a new object
+  /// constructed by this function, accounting for the properties the previous
+  /// one ended up with.
+  uint32_t getNumConstructedProperties(Runtime *runtime);
+
+  /// Track \p obj as the most recent object constructed by this function.
+  void setLastConstructed(JSObject *obj) {
+    lastConstructed_ = obj;
+  }
+
 #ifndef HERMESVM_LEAN
   /// Checks whether this function is lazily compiled.
   bool isLazy() const {
@@ -281,6 +322,28 @@ class CodeBlock final
     JITCompiled_ = JITCompiled;
   }
 
+  /// Record that the compiled body is being entered.
+  void markJITUsed() {
+    JITUsed_ = true;
+  }
+
+  /// \return whether the compiled body was entered since the last call, and
+  ///   clear the flag.
+  bool testAndClearJITUsed() {
+    bool used = JITUsed_;
+    JITUsed_ = false;
+    return used;
+  }
+
+  /// Drop the compiled code and its loop entries, so the function runs in
+  /// the interpreter again, until it gets hot again.
+  void clearJITCompiled() {
+    JITCompiled_ = nullptr;
+    JITLoopEntries_.clear();
+    executionCount_ = 0;
+    backEdgeCount_ = 0;
+  }
+
   /// Increment the function execution count.
   void incrementExecutionCount() {
     executionCount_++;
@@ -295,6 +358,52 @@ class CodeBlock final
   void clearExecutionCount() {
     executionCount_ = 0;
   }
+
+  /// Increment the count of backward branches taken in this function.
+  void incrementBackEdgeCount() {
+    backEdgeCount_++;
+  }
+
+  /// \return the count of backward branches taken in this function.
+  uint32_t getBackEdgeCount() const {
+    return backEdgeCount_;
+  }
+
+  /// Reset the count of backward branches taken in this function to 0.
+  void clearBackEdgeCount() {
+    backEdgeCount_ = 0;
+  }
+
+  /// \return the native code entering this function at the loop header at
+  ///   bytecode offset \p offset, or null if there isn't one.
+  JITCompiledFunctionPtr getJITLoopEntry(uint32_t offset) const {
+    auto it = JITLoopEntries_.find(offset);
+    return it != JITLoopEntries_.end() ? it->second : nullptr;
+  }
+
+  /// Set the native code entering this function at the loop header at
+  /// bytecode offset \p offset.
+  void setJITLoopEntry(uint32_t offset, JITCompiledFunctionPtr entry) {
+    JITLoopEntries_[offset] = entry;
+  }
+
+  /// Record that the arithmetic instruction \p ip was executed with an
+  /// operand that isn't a number.
+  void recordNonNumberArith(const inst::Inst *ip) {
+    if (!typeFeedbackFrozen_)
+      nonNumberArithSites_.insert(getOffsetOf(ip));
+  }
+
+  /// Stop recording type feedback, so that it can be read by another thread.
+  void freezeTypeFeedback() {
+    typeFeedbackFrozen_ = true;
+  }
+
+  /// \return true if the arithmetic instruction at bytecode offset \p offset
+  ///   was ever executed with an operand that isn't a number.
+  bool sawNonNumberArith(uint32_t offset) const {
+    return nonNumberArithSites_.count(offset);
+  }
 #else
   /// \return true if JIT is disabled for this function.
   bool getDontJIT() const {
@@ -313,6 +422,17 @@ class CodeBlock final
   /// Set the native code for this function.
   void setJITCompiled(JITCompiledFunctionPtr JITCompiled) {}
 
+  /// Record that the compiled body is being entered.
+  void markJITUsed() {}
+
+  /// \return false, there is no compiled body if the JIT is not enabled.
+  bool testAndClearJITUsed() {
+    return false;
+  }
+
+  /// Drop the compiled code and its loop entries.
+  void clearJITCompiled() {}
+
   /// Increment the function executionCount_ count
   void incrementExecutionCount() {}
 
@@ -323,23 +443,76 @@ class CodeBlock final
 
   /// Reset the function executionCount_ count to 0
   void clearExecutionCount() {}
+
+  /// Increment the count of backward branches taken in this function.
+  void incrementBackEdgeCount() {}
+
+  /// \return the count of backward branches as 0 if the JIT is not enabled.
+  uint32_t getBackEdgeCount() const {
+    return 0;
+  }
+
+  /// Reset the count of backward branches taken in this function to 0.
+  void clearBackEdgeCount() {}
+
+  /// \return the native code entering this function at the loop header at
+  ///   bytecode offset \p offset, or null if there isn't one.
+  JITCompiledFunctionPtr getJITLoopEntry(uint32_t offset) const {
+    return nullptr;
+  }
+
+  /// Set the native code entering this function at the loop header at
+  /// bytecode offset \p offset.
+  void setJITLoopEntry(uint32_t offset, JITCompiledFunctionPtr entry) {}
+
+  /// Record that the arithmetic instruction \p ip was executed with an
+  /// operand that isn't a number.
+  void recordNonNumberArith(const inst::Inst *ip) {}
+
+  /// Stop recording type feedback, so that it can be read by another thread.
+  void freezeTypeFeedback() {}
+
+  /// \return false, there is no type feedback if the JIT is not enabled.
+  bool sawNonNumberArith(uint32_t offset) const {
+    return false;
+  }
 #endif
 
   inline PropertyCacheEntry *getReadCacheEntry(uint8_t idx) {
+    PropertyCacheEntry *cache = propertyCache();
     assert(idx < writePropCacheOffset_ && "idx out of ReadCache bound");
-    return &propertyCache()[idx];
+    return &cache[idx];
   }
 
   inline PropertyCacheEntry *getWriteCacheEntry(uint8_t idx) {
+    PropertyCacheEntry *cache = propertyCache();
     assert(
         writePropCacheOffset_ + idx < propertyCacheSize_ &&
         "idx out of WriteCache bound");
-    return &propertyCache()[writePropCacheOffset_ + idx];
+    return &cache[writePropCacheOffset_ + idx];
+  }
+
+  /// \return whether the property cache has been allocated, i.e. whether the
+  /// function ever accessed a cached property.
+  bool hasPropertyCache() const {
+    return propertyCache_ != nullptr;
+  }
+
+  /// Allocate the property cache now if it hasn't been, so that code which
+  /// embeds the addresses of its entries can be compiled on another thread.
+  void ensurePropertyCache() {
+    (void)propertyCache();
   }
 
   // Mark all hidden classes in the property cache as roots.
   void markCachedHiddenClasses(Runtime *runtime, WeakRootAcceptor &acceptor);
 
+  /// Mark the most recently constructed object as a weak root.
+  void markLastConstructed(WeakRootAcceptor &acceptor) {
+    if (lastConstructed_)
+      acceptor.acceptWeak(reinterpret_cast<void *&>(lastConstructed_));
+  }
+
   static CodeBlock *createCodeBlock(
       RuntimeModule *runtimeModule,
       hbc::RuntimeFunctionHeader header,
@@ -390,10 +563,10 @@ class CodeBlock final
 };
 
 #ifndef HERMESVM_LEAN
-/// Compiles a lazy Function into a separate BytecodeModule. The module will
-/// in turn generate other lazy functions.
+/// Compiles the lazy function with the data \p lazyData into a separate
+/// BytecodeModule. The module will in turn generate other lazy functions.
 std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
-    Function *lazyFunction);
+    hbc::LazyCompilationData *lazyData);
 #endif
 
 } // namespace vm
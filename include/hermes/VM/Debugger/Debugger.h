@@ -111,6 +111,25 @@ class Debugger {
   llvm::MapVector<BreakpointID, Breakpoint> userBreakpoints_{};
   BreakpointID nextBreakpointId_{1};
 
+  /// The condition of a user breakpoint compiled in the scope of its code
+  /// block, so that hitting the breakpoint only has to create a closure over
+  /// the environment of the frame and call it, rather than look up the scope
+  /// chain and load the compiled condition into a new RuntimeModule.
+  struct CompiledCondition {
+    /// The Domain owning the RuntimeModule of the condition, which keeps
+    /// \c codeBlock alive.
+    PinnedHermesValue domain{};
+
+    /// The global function of the condition, or null if the condition can't
+    /// be compiled, in which case the breakpoint never pauses.
+    CodeBlock *codeBlock{nullptr};
+  };
+
+  /// The compiled conditions of the user breakpoints that have been hit.
+  /// An entry is dropped when its breakpoint changes condition, is deleted or
+  /// is unresolved.
+  llvm::DenseMap<BreakpointID, CompiledCondition> compiledConditions_{};
+
   /// One-shot breakpoints that are used for stepping commands.
   /// These are typically cleared immediately after breaking.
   std::vector<Breakpoint> tempBreakpoints_{};
@@ -186,6 +205,10 @@ class Debugger {
   /// This is only valid if curStepMode_ is not None.
   InterpreterState preStepState_{};
 
+  /// Whether the debugger has ever paused, or been told how to, so code has to
+  /// run in the instrumented interpreter loop.
+  bool isActive_{false};
+
   // Whether an user has attached to any Inspector.
   // It is exposed to JS via a property %DebuggerInternal.isDebuggerAttached
   bool isDebuggerAttached_{false};
@@ -236,6 +259,18 @@ class Debugger {
     return isDebugging_;
   }
 
+  /// \return whether the debugger has ever paused or been told how to, after
+  /// which new calls into JS run in the instrumented interpreter loop.
+  bool isActive() const {
+    return isActive_;
+  }
+
+  /// Run new calls into JS in the instrumented interpreter loop, as a client
+  /// that will debug them has attached.
+  void activate() {
+    isActive_ = true;
+  }
+
   // \return the stack trace for the state given by \p state.
   StackTrace getStackTrace(InterpreterState state) const;
 
@@ -268,6 +303,8 @@ class Debugger {
   }
 
   void setPauseOnThrowMode(PauseOnThrowMode mode) {
+    if (mode != PauseOnThrowMode::None)
+      activate();
     pauseOnThrowMode_ = mode;
   }
 
@@ -277,6 +314,8 @@ class Debugger {
 
   /// Sets the property %isDebuggerAttached in the %DebuggerInternal object.
   void setIsDebuggerAttached(bool isAttached) {
+    if (isAttached)
+      activate();
     isDebuggerAttached_ = isAttached;
   }
 
@@ -302,7 +341,9 @@ class Debugger {
   /// created.
   BreakpointID createBreakpoint(const SourceLocation &loc);
 
-  /// Sets the condition on a breakpoint.
+  /// Sets the condition on a breakpoint. The condition is compiled the first
+  /// time the breakpoint is hit and evaluated without pausing, which also
+  /// makes a logpoint of a condition that prints something and is false.
   /// \param id the breakpoint to change the condition on.
   /// \param condition if None, unset the condition, else set the condition.
   void setBreakpointCondition(BreakpointID id, std::string condition);
@@ -390,6 +431,9 @@ class Debugger {
   /// \param codeBlock the code block that was compiled before this call.
   void resolveBreakpoints(CodeBlock *codeBlock);
 
+  /// Mark the GC roots held by the debugger with \p acceptor.
+  void markRoots(SlotAcceptor &acceptor);
+
   /// \return the source map URL for \p scriptId, empty string if non exists.
   String getSourceMappingUrl(ScriptID scriptId) const;
 
@@ -478,6 +522,12 @@ class Debugger {
   /// If the current instruction is a call or a return, don't use this function.
   ExecutionStatus stepInstruction(InterpreterState &state);
 
+  /// Evaluate the non-empty condition of the user breakpoint \p id in the
+  /// topmost stack frame, compiling it the first time. Exceptions thrown by
+  /// the condition are ignored.
+  /// \return whether the condition is true.
+  bool evalBreakpointCondition(BreakpointID id);
+
   /// Evaluate \p src rooted in the stack frame specified in \p args. 0 is the
   /// topmost frame, corresponding to \p state. Populate \p outMetadata
   /// with metadata for the result.
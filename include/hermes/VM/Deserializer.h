@@ -15,6 +15,8 @@
 
 #include "hermes/Support/MemoryBuffer.h"
 
+#include <vector>
+
 using llvm::ArrayRef;
 namespace hermes {
 
@@ -287,8 +289,10 @@ class Deserializer {
   /// PointerBase for GCPointer.
   Runtime *runtime_;
 
-  /// A queue to remember forward references we see during deserialization.
-  std::deque<RelocationEntry> relocationQueue_;
+  /// Forward references we see during deserialization.  They are only
+  /// resolved once everything has been read, in any order, so a vector is
+  /// enough.
+  std::vector<RelocationEntry> relocationQueue_;
 
   /// A MemoryBuffer that holds the serialized data and where we read from.
   std::shared_ptr<const llvm::MemoryBuffer> buffer_;
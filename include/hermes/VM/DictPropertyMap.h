@@ -14,6 +14,8 @@
 
 #include "llvm/Support/TrailingObjects.h"
 
+#include <algorithm>
+
 namespace hermes {
 namespace vm {
 
@@ -68,26 +70,44 @@ namespace detail {
 /// A valid entry in the hash table holds an index into the descriptor array
 /// and part of the SymbolID (for filtering). Entries transition as follows:
 /// empty -> valid -> deleted -> valid -> ...
+///
+/// The table is probed kGroupSize consecutive entries at a time, which are
+/// matched against the SymbolID at once with SIMD where available, like the
+/// control bytes of a Swiss table.
 class DPMHashPair {
  public:
-  DPMHashPair() : idpart_(0), desc_(0) {}
+  /// The number of entries probed at once. The hash table capacity is a
+  /// multiple of it.
+  static constexpr uint32_t kGroupSize = 4;
+
+  /// Bit masks of the entries of a group, bit i standing for entry i.
+  struct GroupMatch {
+    /// Valid entries which may be for the SymbolID.
+    unsigned candidates;
+    /// Deleted entries.
+    unsigned deleted;
+    /// Empty entries.
+    unsigned empty;
+  };
+
+  DPMHashPair() : raw_(0) {}
   bool isEmpty() const {
-    return desc_ == EMPTY;
+    return getDesc() == EMPTY;
   }
   bool isDeleted() const {
-    return desc_ == DELETED;
+    return getDesc() == DELETED;
   }
   bool isValid() const {
-    return desc_ >= FIRST_VALID;
+    return getDesc() >= FIRST_VALID;
   }
   uint32_t getDescIndex() const {
     assert(isValid() && "asked for descriptor of invalid pair");
-    return desc_ - FIRST_VALID;
+    return getDesc() - FIRST_VALID;
   }
   /// Returns false if this entry does not match \p id.
   bool mayBe(SymbolID id) const {
     assert(isValid() && "tried to match invalid pair");
-    return idpart_ == (id.unsafeGetRaw() & ID_MASK);
+    return (raw_ & ID_MASK) == (id.unsafeGetRaw() & ID_MASK);
   }
   /// (Re)initialize an empty or deleted hash table entry.
   /// Returns true iff the previous state was deleted.
@@ -95,8 +115,7 @@ class DPMHashPair {
     assert(!isValid() && "overwriting a valid entry");
     assert(canStore(idx) && "impossibly large descriptor index");
     bool ret = isDeleted();
-    desc_ = idx + FIRST_VALID;
-    idpart_ = (id.unsafeGetRaw() & ID_MASK);
+    raw_ = ((idx + FIRST_VALID) << ID_BITS) | (id.unsafeGetRaw() & ID_MASK);
     assert(isValid() && "failed to make a valid entry");
     return ret;
   }
@@ -105,7 +124,7 @@ class DPMHashPair {
   uint32_t setDeleted() {
     assert(isValid() && "tried to delete an empty/deleted entry");
     uint32_t ret = getDescIndex();
-    desc_ = DELETED;
+    raw_ = (DELETED << ID_BITS) | (raw_ & ID_MASK);
     return ret;
   }
   /// Returns true if idx is small enough to be stored as a descriptor index
@@ -114,9 +133,13 @@ class DPMHashPair {
     return idx < ((1 << DESC_BITS) - FIRST_VALID);
   }
 
+  /// Match the kGroupSize entries starting at \p group against \p id.
+  static GroupMatch matchGroup(const DPMHashPair *group, SymbolID id);
+
  private:
-  /// Encoding of desc_. Empty is 0 so that zeroed memory means all empty.
-  enum { EMPTY = 0, DELETED, FIRST_VALID };
+  /// Encoding of the descriptor part. Empty is 0 so that zeroed memory means
+  /// all empty.
+  enum : uint32_t { EMPTY = 0, DELETED, FIRST_VALID };
 
   /// Number of bits of SymbolID to store. A static_assert checks that
   /// the max possible descriptor index can be stored in the other bits.
@@ -133,14 +156,19 @@ class DPMHashPair {
   /// Bits that can hold (max possible descriptor index + FIRST_VALID).
   static constexpr size_t DESC_BITS = 32 - ID_BITS;
 
-  struct {
-    /// Part of a SymbolID.
-    uint32_t idpart_ : ID_BITS;
-    /// Encoded descriptor index (or EMPTY/DELETED).
-    uint32_t desc_ : DESC_BITS;
-  };
+  uint32_t getDesc() const {
+    return raw_ >> ID_BITS;
+  }
+
+  /// The encoded descriptor index (or EMPTY/DELETED) in the high DESC_BITS,
+  /// and part of a SymbolID in the low ID_BITS.
+  uint32_t raw_;
 };
 
+static_assert(
+    sizeof(DPMHashPair) == sizeof(uint32_t),
+    "DPMHashPair groups are loaded as vectors of uint32_t");
+
 } // namespace detail
 
 class DictPropertyMap final : public VariableSizeRuntimeCell,
@@ -311,19 +339,21 @@ class DictPropertyMap final : public VariableSizeRuntimeCell,
   size_type deletedListSize_{0};
 
   /// Derive the size of the hash table so it can hold \p cap elements without
-  /// many collisions. The result must also be a power of 2.
+  /// many collisions. The result must also be a power of 2, and hold at least
+  /// one group.
   static size_type calcHashCapacity(size_type cap) {
     assert(
         (cap <= std::numeric_limits<size_type>::max() / 4) &&
         "size will cause integer overflow in calcHashCapacity");
 
-    return llvm::PowerOf2Ceil(cap * 4 / 3 + 1);
+    return std::max<size_type>(
+        llvm::PowerOf2Ceil(cap * 4 / 3 + 1), HashPair::kGroupSize);
   }
 
   /// A const-expr version of \c calcHashCapacity() using 64-bit arithmetic.
   /// NOTE: it must not be used at runtime since it might be slow.
   static constexpr uint64_t constCalcHashCapacity64(uint64_t cap) {
-    return constPowerOf2Ceil(cap * 4 / 3 + 1);
+    return constPowerOf2Ceil(cap * 4 / 3 + 1, HashPair::kGroupSize);
   }
 
   /// A constexpr compatible version of llvm::PowerOf2Ceil().
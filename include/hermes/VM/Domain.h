@@ -88,6 +88,10 @@ class Domain final : public GCCell {
   /// The index is used to look up the actual CJSModule in cjsModules_.
   llvm::DenseMap<SymbolID, uint32_t> cjsModuleTable_{};
 
+  /// Element i is true if the dependencies of the CJS module with ID i have
+  /// been prefetched by prefetchCJSModuleDependencies().
+  std::vector<bool> prefetchedCJSModules_{};
+
   /// RuntimeModules owned by this Domain.
   /// These will be freed from the Domain destructor.
   CopyableVector<RuntimeModule *> runtimeModules_{};
@@ -164,6 +168,19 @@ class Domain final : public GCCell {
     return offset;
   }
 
+  /// \return the segment containing the CJS module with ID \p id according to
+  /// the segment tables of the loaded RuntimeModules, None if no table lists
+  /// it.
+  OptValue<uint32_t> findSegmentOfModule(uint32_t id) const;
+
+  /// Advise the bytecode providers that the CJS modules statically required,
+  /// directly or not, by the module at \p cjsModuleOffset are going to be
+  /// run soon, so that their bytecode is read in while it runs. Modules which
+  /// have been required or whose segment hasn't been loaded are skipped.
+  void prefetchCJSModuleDependencies(
+      Runtime *runtime,
+      uint32_t cjsModuleOffset);
+
   /// \return the cached exports object for the given cjsModuleOffset.
   PseudoHandle<> getCachedExports(Runtime *runtime, uint32_t cjsModuleOffset)
       const {
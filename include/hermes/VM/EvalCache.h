@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_EVALCACHE_H
+#define HERMES_VM_EVALCACHE_H
+
+#include "hermes/Support/ScopeChain.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace hermes {
+namespace hbc {
+class BCProviderFromSrc;
+struct CompileFlags;
+} // namespace hbc
+
+namespace vm {
+
+/// A cache of the bytecode compiled by a runtime for eval() and the Function
+/// constructor, keyed on the source, the compile flags and the names in scope
+/// of a direct eval, so that compiling the same source again, as templating
+/// libraries tend to, runs the bytecode compiled the first time instead. The
+/// least recently used entry is evicted when the cache is full.
+class EvalCache {
+ public:
+  /// Create a cache of the bytecode of up to \p capacity sources. A capacity
+  /// of 0 disables the cache.
+  explicit EvalCache(unsigned capacity) : capacity_(capacity) {}
+
+  /// \return the bytecode of \p source compiled with \p flags in the scope
+  ///   \p scopeChain, or null if it is not cached.
+  std::shared_ptr<hbc::BCProviderFromSrc> lookup(
+      llvm::StringRef source,
+      const hbc::CompileFlags &flags,
+      const ScopeChain &scopeChain);
+
+  /// Cache \p bytecode as the bytecode of \p source compiled with \p flags in
+  /// the scope \p scopeChain, evicting the least recently used entry if the
+  /// cache is full.
+  void insert(
+      llvm::StringRef source,
+      const hbc::CompileFlags &flags,
+      const ScopeChain &scopeChain,
+      std::shared_ptr<hbc::BCProviderFromSrc> bytecode);
+
+  /// Print the number of hits, misses and evictions to \p os, to tune the
+  /// capacity of the cache. Nothing is printed if it was never used.
+  void printStats(llvm::raw_ostream &os) const;
+
+ private:
+  /// The flags, then the names in scope, then the source.
+  using Key = std::string;
+
+  static Key makeKey(
+      llvm::StringRef source,
+      const hbc::CompileFlags &flags,
+      const ScopeChain &scopeChain);
+
+  struct Entry {
+    Key key;
+    std::shared_ptr<hbc::BCProviderFromSrc> bytecode;
+  };
+
+  /// The maximum number of entries.
+  const unsigned capacity_;
+
+  /// The entries, from the most recently used to the least.
+  std::list<Entry> entries_{};
+
+  /// The entries by their key.
+  std::unordered_map<Key, std::list<Entry>::iterator> index_{};
+
+  /// The total size of the keys of the entries, which hold the sources.
+  size_t keyBytes_{0};
+
+  uint64_t numHits_{0};
+  uint64_t numMisses_{0};
+  uint64_t numEvictions_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_EVALCACHE_H
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_FREELISTNC_H
+#define HERMES_VM_FREELISTNC_H
+
+#include "hermes/VM/HeapAlign.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// Size-segregated lists of the free regions between live cells of old-gen
+/// segments that were swept in place by a full collection.  The regions are
+/// filled with FillerCells so that the heap stays parseable, and can be handed
+/// out again to allocations made directly in the old generation.
+///
+/// Small regions are kept in one list per size, in HeapAlign steps, and
+/// larger ones in lists covering power-of-two ranges of sizes.
+class FreeList {
+ public:
+  /// A free region of the heap.  A null start means no region.
+  struct Region {
+    char *start;
+    gcheapsize_t size;
+
+    explicit operator bool() const {
+      return start != nullptr;
+    }
+  };
+
+  /// The smallest region that can be recorded, or left over after carving an
+  /// allocation out of a region: it must be able to hold a FillerCell.
+  static const gcheapsize_t kMinRegionSize;
+
+  /// Regions smaller than this have a list for every possible size.
+  static constexpr gcheapsize_t kMaxExactSize = 256;
+
+  /// The number of lists for regions of power-of-two size ranges.
+  static constexpr size_t kNumRangeClasses = 20;
+
+  /// Discard every region.
+  void clear();
+
+  /// Record the free region [start, start + size), which must be
+  /// heap-aligned.  Regions smaller than kMinRegionSize are not recorded.
+  void add(char *start, gcheapsize_t size);
+
+  /// Remove and \return a region that can hold \p size bytes, either exactly,
+  /// or with a remainder of at least kMinRegionSize.  \return a null region if
+  /// there is none.
+  Region take(gcheapsize_t size);
+
+  /// \return whether there are no free regions.
+  bool empty() const {
+    return bytes_ == 0;
+  }
+
+  /// \return the total size of the free regions, in bytes.
+  gcheapsize_t bytes() const {
+    return bytes_;
+  }
+
+ private:
+  /// The number of lists for regions smaller than kMaxExactSize.
+  static constexpr size_t kNumExactClasses = kMaxExactSize >> LogHeapAlign;
+
+  static constexpr size_t kNumClasses = kNumExactClasses + kNumRangeClasses;
+
+  /// How many regions of a list are examined before moving on to the next,
+  /// larger, size class.
+  static constexpr size_t kMaxProbes = 8;
+
+  /// \return the size class of regions of \p size bytes.
+  static size_t sizeClass(gcheapsize_t size);
+
+  /// \return whether \p regionSize bytes can hold an allocation of \p size.
+  static bool fits(gcheapsize_t regionSize, gcheapsize_t size) {
+    return regionSize == size || regionSize >= size + kMinRegionSize;
+  }
+
+  std::vector<Region> classes_[kNumClasses];
+
+  /// The sum of the sizes of all the regions.
+  gcheapsize_t bytes_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_FREELISTNC_H
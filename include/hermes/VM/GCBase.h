@@ -10,12 +10,16 @@
 
 #include "hermes/Platform/Logging.h"
 #include "hermes/Public/CrashManager.h"
+#include "hermes/Public/GCCollectionEvent.h"
 #include "hermes/Public/GCConfig.h"
 #include "hermes/Public/GCTripwireContext.h"
 #include "hermes/Public/MemoryEventTracker.h"
+#include "hermes/Public/MemoryPressure.h"
 #include "hermes/Support/CheckedMalloc.h"
 #include "hermes/Support/OSCompat.h"
 #include "hermes/Support/StatsAccumulator.h"
+#include "hermes/Support/TraceEvents.h"
+#include "hermes/VM/BackgroundFreer.h"
 #include "hermes/VM/BuildMetadata.h"
 #include "hermes/VM/CellKind.h"
 #include "hermes/VM/GCDecl.h"
@@ -30,15 +34,18 @@
 #include "hermes/VM/StorageProvider.h"
 #include "hermes/VM/StringRefUtils.h"
 #include "hermes/VM/VTable.h"
+#include "hermes/VM/instrumentation/PerfEvents.h"
 
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/Support/ErrorHandling.h"
 
+#include <array>
 #include <cassert>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <random>
 #include <system_error>
 #include <vector>
@@ -88,6 +95,10 @@ class Deserializer;
 /// Force a garbage collection cycle.
 ///   void collect();
 ///
+/// Collect, then give as much memory back to the system as \p level calls
+/// for.  Returns the number of bytes by which the heap's footprint shrank.
+///   size_t notifyMemoryPressure(MemoryPressureLevel level);
+///
 /// The maximum size of any one allocation allowable by the GC in any state.
 ///   static constexpr uint32_t maxAllocationSize();
 ///
@@ -245,6 +256,36 @@ class GCBase {
     GCRef(GC &gc) : gc(gc) {}
   };
 
+  /// The durations of a phase over many collections.  Time unit is seconds.
+  struct PhaseHistogram {
+    /// The number of buckets of the histogram.
+    static constexpr unsigned kNumBuckets = 12;
+
+    /// Wall times are counted in buckets of increasing powers of two: bucket 0
+    /// counts the times below kFirstBucketLimitSecs, bucket i those below twice
+    /// the limit of bucket i - 1, and the last bucket the times above that.
+    static constexpr double kFirstBucketLimitSecs = 0.000125;
+
+    /// Summary statistics for the wall and CPU times of the phase.
+    StatsAccumulator<double> wallTime;
+    StatsAccumulator<double> cpuTime;
+
+    /// The number of collections whose phase fell in each bucket.
+    std::array<unsigned, kNumBuckets> buckets{};
+
+    /// The hardware counters of the phase over all collections, if they are
+    /// sampled.
+    instrumentation::HardwareCounters counters{};
+
+    /// \return the exclusive upper limit of the wall times in \p bucket, which
+    /// is infinite for the last bucket.
+    static double bucketLimitSecs(unsigned bucket);
+
+    /// Record a phase that took \p wallSecs wall time and \p cpuSecs CPU
+    /// time.
+    void record(double wallSecs, double cpuSecs);
+  };
+
   /// Stats for collections. Time unit, where applicable, is seconds.
   struct CumulativeHeapStats {
     unsigned numCollections{0};
@@ -262,6 +303,22 @@ class GCBase {
 
     /// Bytes alive after a collection.
     StatsAccumulator<gcheapsize_t, uint64_t> usedAfter;
+
+    /// Number of collections after which the collected region was grown, or
+    /// shrunk, by adaptive sizing.
+    unsigned numGrowths{0};
+    unsigned numShrinks{0};
+
+    /// Bytes of young-gen cells promoted to the old generation by a young-gen
+    /// collection.
+    StatsAccumulator<gcheapsize_t, uint64_t> promotedBytes;
+
+    /// The times of each phase of the collections, indexed by GCPhase.
+    std::array<PhaseHistogram, kNumGCPhases> phaseTimes;
+
+    const PhaseHistogram &phaseTimesOf(GCPhase phase) const {
+      return phaseTimes[static_cast<unsigned>(phase)];
+    }
   };
 
   struct HeapInfo {
@@ -280,6 +337,8 @@ class GCBase {
     unsigned mallocSizeEstimate{0};
     /// The total amount of Virtual Address space (VA) that the GC is using.
     uint64_t va{0};
+    /// The times of each phase of all collections, indexed by GCPhase.
+    std::array<PhaseHistogram, kNumGCPhases> phaseTimes;
     /// Stats for full collections (zeroes if non-generational GC).
     CumulativeHeapStats fullStats;
     /// Stats for collections in the young generation (zeroes if
@@ -505,6 +564,12 @@ class GCBase {
 
   /// Populate \p info with information about the heap.
   virtual void getHeapInfo(HeapInfo &info);
+
+  /// Read the hardware counters of the thread around each phase of the
+  /// collections, if \p sample is true, and add them to the phase times.
+  void setSampleHardwareCounters(bool sample) {
+    sampleHardwareCounters_ = sample;
+  }
   /// Same as \c getHeapInfo, and it adds the amount of malloc memory in use.
   virtual void getHeapInfoWithMallocSize(HeapInfo &info) = 0;
 
@@ -573,6 +638,12 @@ class GCBase {
   }
 #endif
 
+  /// \return whether stores into the location \p loc may skip the write
+  /// barriers, which the default implementations above never need.
+  bool canSkipWriteBarriers(const void *loc) const {
+    return true;
+  }
+
   /// @name Marking APIs
   /// @{
 
@@ -622,6 +693,37 @@ class GCBase {
     return inGC_;
   }
 
+  /// Release \p mem, malloc'd native memory owned by a cell that is being
+  /// finalized.  When background finalization is enabled, memory released
+  /// during a collection is freed on a background thread once the collection
+  /// is over.  Any external memory charge for \p mem must be debited by the
+  /// caller, so that the accounting does not depend on when it is freed.
+  void freeNativeMemory(void *mem) {
+    if (backgroundFreer_ && inGC_) {
+      deferredFrees_.push_back(mem);
+    } else {
+      free(mem);
+    }
+  }
+
+  /// Block until the native memory released by finalizers so far is freed.
+  void waitForBackgroundFrees();
+
+  /// \return true if finalizing \p cell has effects outside the runtime, like
+  /// destroying a HostObject or handing a data block or the characters of a
+  /// string back to the embedder, rather than only releasing memory that the
+  /// runtime allocated.
+  static bool hasObservableFinalizer(GCCell *cell);
+
+  /// A fast teardown still frees the native memory of the cells which own at
+  /// least this many bytes: they are few, but hold most of the memory.
+  static constexpr size_t kFastTeardownMinFreedBytes = 64 * 1024;
+
+  /// Run the finalizer of \p cell as part of a fast teardown, if it is
+  /// observable or frees at least kFastTeardownMinFreedBytes.
+  /// \return the number of bytes of native memory leaked by skipping it.
+  static uint64_t finalizeForFastTeardown(GCCell *cell, GC *gc);
+
   IDTracker &getIDTracker() {
     return idTracker_;
   }
@@ -690,8 +792,40 @@ class GCBase {
     GCBase *const gc_;
     OptValue<GCCallbacks *> gcCallbacksOpt_;
     std::string extraInfo_;
+    trace::Scope traceScope_{trace::Category::GC, "collection"};
+  };
+
+  /// An RAII-style object that adds the wall and CPU time of its lifetime to
+  /// the given phase of the record of the current collection.
+  class GCPhaseTimer final {
+   public:
+    GCPhaseTimer(GCBase *gc, GCPhase phase);
+    ~GCPhaseTimer();
+
+   private:
+    GCBase *const gc_;
+    const GCPhase phase_;
+    const TimePoint wallStart_;
+    const std::chrono::microseconds cpuStart_;
+    instrumentation::HardwareCounters countersStart_{};
+    trace::Scope traceScope_;
   };
 
+  /// Start the record of a new collection, which is a young-gen collection if
+  /// \p youngGen is true.
+  void beginCollectionEvent(bool youngGen);
+
+  /// Finish the record of the current collection, which took \p wallTime
+  /// seconds wall time and \p cpuTime seconds CPU time: add its phase times to
+  /// the overall cumulative stats, and to \p regionStats if it is not null,
+  /// and pass it to the collection event callback, if there is one.
+  void recordCollectionEvent(
+      double wallTime,
+      double cpuTime,
+      gcheapsize_t usedBefore,
+      gcheapsize_t usedAfter,
+      CumulativeHeapStats *regionStats);
+
   /// Returns the number of bytes allocated allocated since the last GC.
   /// TODO: Implement this for heaps other than GenGC
   /// (at which point this can become an abstract function).
@@ -848,6 +982,16 @@ class GCBase {
   // The cumulative GC stats.
   CumulativeHeapStats cumStats_;
 
+  /// The record of the current, or last, collection.
+  GCCollectionEvent collectionEvent_;
+
+  /// Whether to read the hardware counters around each phase.
+  bool sampleHardwareCounters_{false};
+
+  /// The hardware counters of each phase of the current collection, indexed
+  /// by GCPhase.
+  std::array<instrumentation::HardwareCounters, kNumGCPhases> phaseCounters_;
+
   /// Name to indentify this heap in logs.
   std::string name_;
 
@@ -855,6 +999,14 @@ class GCBase {
   /// snapshots and the memory profiler.
   IDTracker idTracker_;
 
+  /// Frees the native memory released in collections, if background
+  /// finalization is enabled.
+  std::unique_ptr<BackgroundFreer> backgroundFreer_;
+
+  /// The native memory released during the current collection, handed to
+  /// backgroundFreer_ when it ends.
+  std::vector<void *> deferredFrees_;
+
 #ifndef NDEBUG
   /// The number of reasons why no allocation is allowed in this heap right now.
   uint32_t noAllocLevel_{0};
@@ -877,6 +1029,9 @@ class GCBase {
   /// True if the tripwire has already been called on this heap.
   bool tripwireCalled_{false};
 
+  /// Callback called, if it's not null, with the record of every collection.
+  std::function<void(const GCCollectionEvent &)> collectionEventCallback_;
+
 #ifdef HERMESVM_SANITIZE_HANDLES
   /// Whether to keep moving the heap around to detect unsanitary GC handles.
   double sanitizeRate_{1.0};
@@ -268,6 +268,11 @@ class GCGeneration {
   /// Call the finalizer methods on cells that are not marked.
   void finalizeUnreachableObjects();
 
+  /// Call the finalizer methods of a fast teardown (see
+  /// GCBase::finalizeForFastTeardown()), and forget about the other cells.
+  /// \return the number of bytes of native memory leaked by the others.
+  uint64_t finalizeObservableObjects();
+
   /// Update the pointers in the finalizer list according to the forwarding
   /// pointers in the cells pointed to (assuming such forwarding pointers have
   /// been installed).
@@ -16,6 +16,7 @@
 #include "hermes/VM/AlignedHeapSegment.h"
 #include "hermes/VM/AlignedStorage.h"
 #include "hermes/VM/AllocResult.h"
+#include "hermes/VM/AllocationSite.h"
 #include "hermes/VM/CellKind.h"
 #include "hermes/VM/CompleteMarkState.h"
 #include "hermes/VM/GCBase.h"
@@ -23,6 +24,7 @@
 #include "hermes/VM/GCPointer.h"
 #include "hermes/VM/GCSegmentAddressIndex.h"
 #include "hermes/VM/HermesValue.h"
+#include "hermes/VM/LargeObjectSpaceNC.h"
 #include "hermes/VM/LogFailStorageProvider.h"
 #include "hermes/VM/OldGenNC.h"
 #include "hermes/VM/SweepResultNC.h"
@@ -31,6 +33,7 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ErrorHandling.h"
 
+#include <chrono>
 #include <deque>
 #include <limits>
 #include <vector>
@@ -44,6 +47,7 @@ namespace vm {
 class WeakRefBase;
 template <class T>
 class WeakRef;
+struct RuntimeOffsets;
 
 /// A simple two-generation GC.
 ///
@@ -149,6 +153,34 @@ class GenGC final : public GCBase {
   template <HasFinalizer hasFinalizer = HasFinalizer::No>
   inline void *allocLongLived(uint32_t size);
 
+  /// Like allocLongLived, for objects that are expected to be long-lived
+  /// because of their allocation site.  Unlike allocLongLived, the object may
+  /// be initialized without write barriers, like an object allocated by alloc.
+  template <HasFinalizer hasFinalizer = HasFinalizer::No>
+  inline void *allocPretenured(uint32_t size);
+
+  /// \return whether allocation sites are sampled, and objects from sites
+  /// whose objects usually survive are pretenured.
+  bool isPretenuringEnabled() const {
+    return pretenuring_;
+  }
+
+  /// \return whether large variable-sized cells are allocated in segments of
+  /// their own.
+  bool isLargeObjectSpaceEnabled() const {
+    return largeObjectSpace_;
+  }
+
+  /// \return the number of cells in the large object space.
+  size_t numLargeObjects() const {
+    return largeObjects_.numCells();
+  }
+
+  /// Inform the GC that \p cell was just allocated at \p site.  If the site is
+  /// not already being sampled, the next collection records in \p site whether
+  /// \p cell survived it.
+  void sampleAllocationSite(GCCell *cell, AllocationSite *site);
+
   /// Returns whether an external allocation of the given \p size fits
   /// within the maximum heap size.  (Note that this does not guarantee that the
   /// allocation will "succeed" -- the size plus the used() of the heap may
@@ -244,6 +276,16 @@ class GenGC final : public GCBase {
   ///     result of this collection.
   void collect(bool canEffectiveOOM = false);
 
+  /// Do a full collection, then shrink the heap and release its unused memory
+  /// as \p level calls for: Moderate releases the cached segments and sizes
+  /// the heap for the occupancy target; Critical shrinks the heap to fit the
+  /// live data, and returns every page above the level of each segment to the
+  /// OS, regardless of ShouldReleaseUnused.
+  /// (Part of general GC API defined in GC.h).
+  /// \return the number of bytes by which the heap's size, plus its cached
+  ///     segments, shrank.
+  size_t notifyMemoryPressure(MemoryPressureLevel level);
+
   static constexpr uint32_t maxAllocationSize() {
     // The largest allocation allowable in NCGen is the max size a single
     // segment supports.
@@ -251,7 +293,8 @@ class GenGC final : public GCBase {
   }
 
   /// The occupancy target guides heap sizing -- the fraction of the heap
-  /// that is intended to be occupied by live data.
+  /// that is intended to be occupied by live data.  It is adapted by full
+  /// collections if the GC has a GC time target.
   double occupancyTarget() const {
     return occupancyTarget_;
   }
@@ -259,6 +302,13 @@ class GenGC final : public GCBase {
   /// Run the finalizers for all heap objects.
   void finalizeAll();
 
+  /// Like finalizeAll(), but only run the finalizers which are observable
+  /// outside the runtime, or which free a large block of native memory (see
+  /// GCBase::finalizeForFastTeardown()). The memory the others would free is
+  /// leaked.
+  /// \return the number of bytes of native memory leaked.
+  uint64_t finalizeObservable();
+
 #ifndef NDEBUG
   /// Return true if \p ptr is within one of the virtual address ranges
   /// allocated for the heap. Not intended for use in normal production GC
@@ -284,6 +334,15 @@ class GenGC final : public GCBase {
     return youngGen_.contains(ptr);
   }
 
+  /// \return whether stores into the location \p loc may skip the write
+  /// barriers. Stores into the young generation never need them: its cards are
+  /// not scanned, and incremental marking starts with an empty young
+  /// generation, so every cell in it is scanned again when the marking ends.
+  /// This lets cells that were just allocated be initialized without barriers.
+  bool canSkipWriteBarriers(const void *loc) const {
+    return youngGen_.contains(loc);
+  }
+
   /// Amount of space currently in use by allocated objects.
   /// The first version may be used always; the usedDirect version can only
   /// be used when the allocation context has been yielded, but is faster.
@@ -364,7 +423,8 @@ class GenGC final : public GCBase {
 
 #ifndef NDEBUG
   /// For testing purposes, we expose the ability to explicity request a
-  /// young-generation collection.
+  /// young-generation collection.  As with collections caused by allocation,
+  /// it is followed by an increment of incremental marking, if enabled.
   void youngGenCollect();
 
   /// The number of allocated objects in the heap (sum over the generations).
@@ -471,7 +531,8 @@ class GenGC final : public GCBase {
   static constexpr unsigned kYoungGenFractionDenom =
       Size::kYoungGenFractionDenom;
 
-  /// Young gen initial size, as a function of the overall heap's size.
+  /// Young gen size, as a function of the overall heap's size.  Once adaptive
+  /// sizing has resized the young gen, its target size is kept instead.
   size_t youngGenSize(size_t totalHeapSize) const;
 
  private:
@@ -480,12 +541,20 @@ class GenGC final : public GCBase {
   friend class GCGeneration;
   friend class YoungGen;
   friend class OldGen;
+  friend class LargeObjectSpace;
+  // The JIT allocates from allocContext_ inline, see RuntimeOffsets.
+  friend struct RuntimeOffsets;
 
   /// The slow path for allocation.  Same specification as alloc(),
   /// albeit with the template arguments passed as explicit dynamic
   /// arguments.
   void *allocSlow(uint32_t sz, bool fixedSize, HasFinalizer hasFinalizer);
 
+  /// Allocate a cell of \p sz bytes in the large object space, doing a full
+  /// collection if necessary to make room for its charge in the old
+  /// generation.
+  void *allocLarge(uint32_t sz);
+
   /// The given pointer value is being written at the given loc (required to
   /// be in the heap).  The value is may be null.  Execute a write
   /// barrier.  The \p hv argument indicates whether this is being
@@ -590,6 +659,11 @@ class GenGC final : public GCBase {
         size_t usedAfter,
         CumulativeHeapStats *regionStats);
 
+    /// \return when the collection started.
+    TimePoint wallStart() const {
+      return wallStart_;
+    }
+
    private:
     GenGC *gc_;
     GCCycle cycle_;
@@ -653,6 +727,12 @@ class GenGC final : public GCBase {
   /// them by following the forwarding pointers in their referents.
   void updateReferences(const SweepResult &sweepResult);
 
+  /// Same as the segment-scanning part of updateReferences, but distributes
+  /// the used segments of both generations over compactionThreads_ threads.
+  /// Requires that object IDs are not being tracked, as the ID tracker is not
+  /// thread-safe.
+  void updateReferencesParallel(const SweepResult &sweepResult);
+
   /// Iterate over the live objects, moving them to their post-compaction
   /// addresses and restoring their displaced VTable pointers (from
   /// sweepResult).  Also, sets the "levels" of the generations to the values in
@@ -666,6 +746,57 @@ class GenGC final : public GCBase {
   /// close the mark bits.
   void completeMarking();
 
+  /// Same as completeMarking, but spreads the work over markingThreads_
+  /// threads using a ParallelMarkState.
+  void completeMarkingParallel();
+
+  /// Incremental marking of the old generation:
+
+  struct IncrementalMarkAcceptor;
+
+  /// Called after every young-gen collection.  If incremental marking is
+  /// enabled, starts a marking cycle once the old generation is sufficiently
+  /// full, and otherwise continues the current one for at most
+  /// incrementalMarkBudgetMs_.  When the cycle runs out of work, does the full
+  /// collection that uses its mark bits.
+  void markIncrementally();
+
+  /// Clear the old-gen mark bits, and mark the cells directly reachable from
+  /// the roots.  Requires the young generation to be empty.
+  void startIncrementalMark();
+
+  /// Scan cells from incrementalMarkStack_ until it is empty or \p deadline
+  /// has passed.  \return true if the stack was emptied.
+  bool drainIncrementalMarkStack(
+      std::chrono::steady_clock::time_point deadline);
+
+  /// The final, stop-the-world part of an incremental marking cycle, run by
+  /// markPhase instead of marking from scratch: treats every old-gen cell
+  /// allocated during the cycle, and every cell reachable from the roots, as
+  /// marked, and transitively scans them.
+  void finishIncrementalMark();
+
+  /// If \p ptr is an unmarked old-gen cell, mark it and push it onto
+  /// incrementalMarkStack_.  Used both by the incremental marker and by the
+  /// write barrier while a cycle is in progress.
+  void incrementalMarkShade(void *ptr);
+
+  /// Record in each sampled allocation site whether its sample survived the
+  /// current collection, and forget the samples.  Must run after marking
+  /// (\p fullGC) or evacuation of the young generation, but before the
+  /// finalizers, which may free the code blocks owning the sites.
+  void resolveAllocationSiteSamples(bool fullGC);
+
+  /// Adaptive young-gen sizing, run at the end of each young-gen collection,
+  /// which took \p pauseSecs, found \p usedBefore bytes in the young gen and
+  /// promoted \p promotedBytes of them.  Shrinks the young gen if the pause
+  /// exceeded the target, and grows it if few bytes survived but young-gen
+  /// collections are taking a large share of the time.
+  void updateYoungGenSize(
+      double pauseSecs,
+      size_t usedBefore,
+      size_t promotedBytes);
+
   /// Does any work necessary for GC stats at the end of collection.
   /// Returns the number of allocated objects before collection starts.
   /// (In optimized builds, does nothing, and returns zero.)
@@ -726,7 +857,8 @@ class GenGC final : public GCBase {
 
   /// Update all weak reference slots: update the pointers of live objects and
   /// clear the pointers of freed objects. Additionally, free all weak slots
-  /// that are no longer in use (weren't marked).
+  /// that are no longer in use (weren't marked), and, in a full GC, unmark the
+  /// others.
   void updateWeakReferences(bool fullGC);
 
   /// Updates a single WeakRefSlot.  The \p fullGC argument indicates
@@ -734,8 +866,19 @@ class GenGC final : public GCBase {
   /// This version uses internal mark bits.
   void updateWeakReference(WeakRefSlot *slot, bool fullGC);
 
-  /// Set all the marked weak references to unmarked.
-  void unmarkWeakReferences();
+  /// The full-GC part of updateWeakReferences for the slots of weakSlots_ at
+  /// indices [begin, end): updates and unmarks the marked slots, and appends
+  /// the unmarked ones to \p deadSlots, in order, instead of freeing them.
+  /// Only touches the slots in the range, so disjoint ranges may be processed
+  /// concurrently.
+  void updateWeakSlotsForFullGC(
+      size_t begin,
+      size_t end,
+      std::vector<WeakRefSlot *> &deadSlots);
+
+  /// Full collections only process weak slots on several threads if each
+  /// thread gets at least this many.
+  static constexpr size_t kMinWeakSlotsPerThread = 4096;
 
   /// Allocate a new weak reference slot and return a pointer to it.
   WeakRefSlot *allocWeakSlot(HermesValue init);
@@ -750,9 +893,14 @@ class GenGC final : public GCBase {
   /// of the live data.
   void updateWeightedUsed();
 
-  /// At the end of a full collection, grow or shrink the heap, if heuristics
-  /// indicate.
-  void updateHeapSize();
+  /// At the end of a full collection, which started at \p collectionStart,
+  /// grow or shrink the heap, if heuristics indicate.
+  void updateHeapSize(TimePoint collectionStart);
+
+  /// If the GC has a GC time target, adapt the occupancy target to the
+  /// fraction of the time spent in the GC between the start of the previous
+  /// full collection and \p collectionStart, the start of this one.
+  void updateOccupancyTarget(TimePoint collectionStart);
 
   /// The generation from which the alloc context is claimed, as a
   /// GCGeneration*.
@@ -789,6 +937,10 @@ class GenGC final : public GCBase {
   YoungGen youngGen_;
   OldGen oldGen_;
 
+  /// Large variable-sized cells, allocated outside of the generations.  Their
+  /// size is charged to oldGen_.
+  LargeObjectSpace largeObjects_;
+
   /// The current allocation context: what segment we are allocating
   /// into, where to accumulate finalizable objects, the count of
   /// allocated objects.  Should be valid when allocating.  When doing
@@ -810,6 +962,24 @@ class GenGC final : public GCBase {
   /// Fraction of the heap that is intended to be occupied by live data.
   double occupancyTarget_;
 
+  /// The fraction of the time intended to be spent in the GC, or 0 if the
+  /// occupancy target is fixed.
+  const double gcTimeTarget_;
+
+  /// When the previous full collection started, and the total GC time
+  /// before it, which delimit the window whose GC time adapts the occupancy
+  /// target.
+  TimePoint lastFullCollectionStart_;
+  double gcTimeAtLastFullCollection_{0};
+
+  /// The occupancy target is adapted within these bounds...
+  static constexpr double kMinAdaptiveOccupancyTarget = 0.1;
+  static constexpr double kMaxAdaptiveOccupancyTarget = 0.9;
+
+  /// ...and by at most this factor on the free space per live byte at each
+  /// full collection.
+  static constexpr double kMaxOccupancyAdaptFactor = 2.0;
+
   /// The number of consecutive full collections we consider to be an "Effective
   /// OOM".
   unsigned oomThreshold_;
@@ -827,6 +997,77 @@ class GenGC final : public GCBase {
 
   /// Full heap marking infrastructure.
 
+  /// The number of threads used to complete marking in full collections.
+  const unsigned markingThreads_;
+
+  /// The number of threads used to update references in full collections.
+  const unsigned compactionThreads_;
+
+  /// The number of threads used to scan dirty cards in young-gen collections.
+  const unsigned cardScanThreads_;
+
+  /// If non-zero, the maximum time in milliseconds spent on each increment of
+  /// old-gen marking.
+  const unsigned incrementalMarkBudgetMs_;
+
+  /// True while an incremental marking cycle is in progress.  The write
+  /// barriers then shade the cells they store, so that cells already scanned
+  /// by the cycle cannot hide unmarked ones.
+  bool incrementalMarkActive_{false};
+
+  /// Old-gen cells that the incremental marker has marked, but not scanned.
+  std::vector<GCCell *> incrementalMarkStack_{};
+
+  /// The old-gen level at the start of the current incremental marking cycle.
+  /// Cells allocated above it, including promoted ones, are not tracked by the
+  /// cycle, and are treated as reachable when it finishes.
+  OldGen::Location incrementalMarkStart_{};
+
+  /// Once the old generation is this full after a young-gen collection, an
+  /// incremental marking cycle is started.
+  static constexpr double kIncrementalMarkStartOccupancy = 0.75;
+
+  /// The incremental marker checks the clock after scanning this many cells.
+  static constexpr unsigned kIncrementalMarkCellsPerClockCheck = 64;
+
+  /// Whether allocation sites are sampled and pretenured.
+  const bool pretenuring_;
+
+  /// Whether large variable-sized cells are allocated in largeObjects_.
+  const bool largeObjectSpace_;
+
+  /// A young-gen cell whose survival will be recorded in the allocation site
+  /// it was allocated at.
+  struct AllocationSiteSample {
+    GCCell *cell;
+    AllocationSite *site;
+  };
+
+  /// The samples to resolve at the next collection.  The cells are not roots:
+  /// a sample that did not survive is a result, not a leak.
+  std::vector<AllocationSiteSample> allocationSiteSamples_{};
+
+  /// The pause target of adaptive young-gen sizing, or 0 if the young gen is
+  /// sized as a fixed fraction of the heap.
+  const unsigned youngGenPauseTargetMs_;
+
+  /// The young-gen size chosen by adaptive sizing, which heap resizing keeps.
+  /// 0 until adaptive sizing first resizes the young gen.
+  size_t youngGenTargetSize_{0};
+
+  /// When the previous young-gen collection ended.
+  TimePoint lastYoungGenCollectionEnd_{};
+
+  /// The young gen is grown if less than this fraction of it survived...
+  static constexpr double kYoungGenLowSurvivalRate = 0.1;
+
+  /// ...and the collection took more than this fraction of the time since
+  /// the previous one ended.
+  static constexpr double kYoungGenHighGCTimeRatio = 0.05;
+
+  /// Adaptive sizing multiplies or divides the young-gen size by this.
+  static constexpr size_t kYoungGenResizeFactor = 2;
+
   /// Contains the markStack, overflow boolean, and pointer to the
   /// parent object of the object currently being marked.
   CompleteMarkState markState_;
@@ -914,6 +1155,16 @@ inline void *GenGC::alloc(uint32_t sz) {
     collect();
   }
 
+#ifndef HERMESVM_COMPRESSED_POINTERS
+  // Compressed pointers can only address a limited number of segments, which
+  // large objects would use up quickly.
+  if (!fixedSize && hasFinalizer == HasFinalizer::No &&
+      LLVM_UNLIKELY(sz >= LargeObjectSpace::kMinAllocSize) &&
+      largeObjectSpace_) {
+    return allocLarge(sz);
+  }
+#endif
+
 #ifdef HERMESVM_GC_GENERATIONAL_MARKSWEEPCOMPACT
   AllocResult res = oldGen_.alloc(sz, hasFinalizer);
   assert(res.success && "Should never fail to allocate at the top level");
@@ -942,6 +1193,19 @@ inline void *GenGC::alloc(uint32_t sz) {
 #endif // HERMESVM_GC_GENERATIONAL_MARKSWEEPCOMPACT
 }
 
+template <HasFinalizer hasFinalizer>
+inline void *GenGC::allocPretenured(uint32_t size) {
+  void *mem = allocLongLived<hasFinalizer>(size);
+  if (allocContextFromYG_) {
+    // The caller may store pointers to young-gen objects into the new object
+    // without barriers.  Dirty its cards, so that the next young-gen
+    // collection scans it.
+    AlignedHeapSegment::cardTableCovering(mem)->dirtyCardsForAddressRange(
+        mem, static_cast<char *>(mem) + heapAlignSize(size) - 1);
+  }
+  return mem;
+}
+
 template <HasFinalizer hasFinalizer>
 inline void *GenGC::allocLongLived(uint32_t size) {
 #ifndef NDEBUG
@@ -1043,6 +1307,9 @@ inline void GenGC::writeBarrierImpl(void *loc, void *value, bool hv) {
   // and we will not return early.  But youngGen_.contains(value) will
   // fail, so we will (correctly) not dirty the card for loc.
   HERMES_SLOW_ASSERT(value == nullptr || dbgContains(value));
+  if (LLVM_UNLIKELY(incrementalMarkActive_)) {
+    incrementalMarkShade(value);
+  }
   if (AlignedStorage::containedInSame(locPtr, value)) {
     return;
   }
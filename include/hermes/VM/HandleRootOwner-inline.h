@@ -54,6 +54,20 @@ inline Handle<HermesValue> HandleRootOwner::getBoolValue(bool b) {
   return Handle<HermesValue>(b ? &trueValue_ : &falseValue_);
 }
 
+template <unsigned N>
+template <typename T>
+inline Handle<T> HandleArray<N>::handle(unsigned index) {
+  return Handle<T>::vmcast(&(*this)[index]);
+}
+
+template <unsigned N>
+template <typename T>
+inline MutableHandle<T> HandleArray<N>::mutableHandle(unsigned index) {
+  PinnedHermesValue &value = (*this)[index];
+  value = HermesValueTraits<T>::encode(HermesValueTraits<T>::defaultValue());
+  return MutableHandle<T>::aliasForOutput(&value);
+}
+
 inline PinnedHermesValue *HandleRootOwner::newHandle(HermesValue value) {
   assert(topGCScope_ && "no active GCScope");
   return topGCScope_->newHandle(value);
@@ -20,6 +20,7 @@ namespace vm {
 
 // Forward declarations.
 class GCScope;
+class HandleArrayBase;
 class HandleBase;
 template <typename T>
 class Handle;
@@ -125,11 +126,15 @@ class HandleRootOwner {
 
  private:
   friend class GCScope;
+  friend class HandleArrayBase;
   friend class HandleBase;
 
   /// The top-most GC scope.
   GCScope *topGCScope_{};
 
+  /// The most recently created HandleArray.
+  HandleArrayBase *topHandleArray_{};
+
   /// The active WeakRefs that have been created using WeakRefHolders.
   /// These are marked during GC to prevent collection of their WeakRefSlots.
   std::vector<WeakRef<HermesValue>> weakRefs_{};
@@ -472,6 +477,78 @@ class GCScopeMarkerRAII {
   }
 };
 
+/// The part of HandleArray which doesn't depend on its size: registers the
+/// handles with the runtime, so that they are marked by the GC, for as long as
+/// the array is alive.
+class HandleArrayBase {
+  friend class HandleRootOwner;
+
+  HandleRootOwner *const runtime_;
+  /// The HandleArray created before this one.
+  HandleArrayBase *const prev_;
+  PinnedHermesValue *const values_;
+  const unsigned size_;
+
+  HandleArrayBase(const HandleArrayBase &) = delete;
+  void operator=(const HandleArrayBase &) = delete;
+
+ protected:
+  /// Register the \p size values at \p values. They are constructed right
+  /// after, before anything can allocate.
+  HandleArrayBase(
+      HandleRootOwner *runtime,
+      PinnedHermesValue *values,
+      unsigned size)
+      : runtime_(runtime),
+        prev_(runtime->topHandleArray_),
+        values_(values),
+        size_(size) {
+    runtime->topHandleArray_ = this;
+  }
+
+  ~HandleArrayBase() {
+    assert(
+        runtime_->topHandleArray_ == this &&
+        "HandleArrays must be destroyed in reverse order of creation");
+    runtime_->topHandleArray_ = prev_;
+  }
+
+  /// Mark the handles of this array.
+  void mark(SlotAcceptor &acceptor) {
+    for (unsigned i = 0; i < size_; ++i)
+      acceptor.accept(values_[i]);
+  }
+};
+
+/// \p N handles stored in the native stack frame, which are initially
+/// undefined. Unlike those of a GCScope, they are not allocated one at a time,
+/// so a loop can keep its values in them, instead of allocating handles in
+/// every iteration and flushing the scope to a marker.
+template <unsigned N>
+class HandleArray final : public HandleArrayBase {
+  PinnedHermesValue storage_[N];
+
+ public:
+  explicit HandleArray(HandleRootOwner *runtime)
+      : HandleArrayBase(runtime, storage_, N) {}
+
+  /// \return the value of the handle at \p index, which may be assigned.
+  PinnedHermesValue &operator[](unsigned index) {
+    assert(index < N && "HandleArray index out of range");
+    return storage_[index];
+  }
+
+  /// \return a Handle to the value at \p index, which must be a \p T.
+  template <typename T = HermesValue>
+  Handle<T> handle(unsigned index);
+
+  /// Reset the value at \p index to the default value of \p T, like a new
+  /// MutableHandle<T>.
+  /// \return a MutableHandle to the value at \p index.
+  template <typename T = HermesValue>
+  MutableHandle<T> mutableHandle(unsigned index);
+};
+
 } // namespace vm
 } // namespace hermes
 
@@ -21,7 +21,9 @@
 #include "llvm/Support/raw_ostream.h"
 
 #include <bitset>
+#include <deque>
 #include <string>
+#include <vector>
 
 namespace hermes {
 namespace vm {
@@ -51,6 +53,12 @@ std::string converter(UTF16Ref ref);
 ///   Something which enables these should be implemented in the future.
 void rawHeapSnapshot(llvm::raw_ostream &os, const char *start, const char *end);
 
+/// Writes a heap snapshot in the V8 format to a JSONEmitter as the heap is
+/// traversed. The heap is traversed twice: the first time emits the nodes, and
+/// the second the edges, which refer to their target nodes by index. The only
+/// state kept across the traversals is the string table and the IDs of the
+/// nodes in the order they were emitted, so the memory used is a small
+/// fraction of the size of the heap.
 class HeapSnapshot {
  public:
   enum class Section : unsigned {
@@ -137,6 +145,12 @@ class HeapSnapshot {
   void emitMeta();
   void emitStrings();
 
+  /// Sort the nodes by ID once they have all been emitted.
+  void indexNodes();
+
+  /// \return the index of the node with \p id in the nodes section.
+  NodeIndex getNodeIndex(NodeID id) const;
+
   /// The next section to be closed.  This class guarantees that all previous
   /// sections will have been written to the JSON emitter.
   Section nextSection_{Section::Nodes};
@@ -145,9 +159,13 @@ class HeapSnapshot {
   bool sectionOpened_{false};
 
   JSONEmitter &json_;
-  llvm::DenseMap<NodeID, NodeIndex> nodeToIndex_;
+  /// IDs of the nodes in the order they were emitted, so the position of an
+  /// ID is the index of its node. A deque grows without copying or leaving
+  /// unused capacity behind.
+  std::deque<NodeID> nodeIDs_;
+  /// Indices of the nodes sorted by ID, to find the target of an edge.
+  std::vector<NodeIndex> indicesByID_;
   StringSetVector stringTable_;
-  NodeIndex nodeCount_{0};
   HeapSizeType currEdgeCount_{0};
 #ifndef NDEBUG
   /// How many edges have currently been added.
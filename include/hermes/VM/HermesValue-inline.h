@@ -38,6 +38,13 @@ inline void GCHermesValue::set(HermesValue hv, GC *gc) {
     gc->writeBarrier(this, hv);
 }
 
+void GCHermesValue::initialize(HermesValue hv, GC *gc) {
+  if (LLVM_LIKELY(gc->canSkipWriteBarriers(this)))
+    set<std::false_type>(hv, gc);
+  else
+    set(hv, gc);
+}
+
 void GCHermesValue::setNonPtr(HermesValue hv) {
   assert(!hv.isPointer() || !hv.getPointer());
   setNoBarrier(hv);
@@ -89,6 +96,30 @@ inline GCHermesValue *GCHermesValue::copy(
   return result + (last - first);
 }
 
+inline GCHermesValue *GCHermesValue::uninitialized_copy(
+    GCHermesValue *first,
+    GCHermesValue *last,
+    GCHermesValue *result,
+    GC *gc) {
+  if (first == last)
+    return result;
+  if (!gc->canSkipWriteBarriers(result))
+    return copy(first, last, result, gc);
+#ifndef NDEBUG
+  for (GCHermesValue *it = first; it != last; ++it) {
+    assert(
+        (!it->isPointer() ||
+         !gc->needsWriteBarrier(result + (it - first), it->getPointer())) &&
+        "skipped a needed write barrier");
+  }
+#endif
+  std::memmove(
+      reinterpret_cast<void *>(result),
+      first,
+      (last - first) * sizeof(GCHermesValue));
+  return result + (last - first);
+}
+
 template <typename InputIt, typename OutputIt>
 inline OutputIt GCHermesValue::copy_backward(
     InputIt first,
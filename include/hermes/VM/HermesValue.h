@@ -474,6 +474,11 @@ class GCHermesValue : public HermesValue {
   template <typename NeedsBarriers = std::true_type>
   inline void set(HermesValue hv, GC *gc);
 
+  /// Like set(), for a store initializing a cell that was just allocated.
+  /// The write barrier is skipped when the GC allows it, which it does for
+  /// the common case of a cell in the young generation.
+  inline void initialize(HermesValue hv, GC *gc);
+
   /// The HermesValue \p hv must not be an object pointer.  Assign the
   /// value.
   inline void setNonPtr(HermesValue hv);
@@ -490,6 +495,17 @@ class GCHermesValue : public HermesValue {
   static inline OutputIt
   copy(InputIt first, InputIt last, OutputIt result, GC *gc);
 
+  /// Copies the range of values [\p first, \p last) into \p result, which is
+  /// in a cell that was just allocated. Like initialize(), this skips the
+  /// write barriers when the GC allows it.
+  /// \pre The destination range must be wholly contained within one segment
+  ///     of the heap.
+  static inline GCHermesValue *uninitialized_copy(
+      GCHermesValue *first,
+      GCHermesValue *last,
+      GCHermesValue *result,
+      GC *gc);
+
   /// Copies a range of values and performs a write barrier on each.
   template <typename InputIt, typename OutputIt>
   static inline OutputIt
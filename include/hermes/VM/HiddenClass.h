@@ -110,6 +110,11 @@ struct ClassFlags {
 /// is not shared - it belongs to exactly one object - and updates are done "in
 /// place" instead of creating new child classes.
 ///
+/// A dictionary whose object keeps being read without the dictionary changing
+/// (\c kDictionaryQuietReads reads which missed the inline caches) is replaced
+/// by a regular class, found by adding its properties to the root class in
+/// order, so that the object can share it and be cached again.
+///
 /// Property Maps
 /// =============
 /// Conceptually every hidden class has a property map - a table mapping from
@@ -125,6 +130,13 @@ struct ClassFlags {
 /// The desired effect is that only "leaf" classes have property maps and normal
 /// property assignment doesn't create a map at all in the intermediate states
 /// (except the first time).
+///
+/// A class with several children is the exception: it keeps its map, and the
+/// children share it. A child looks for a property in the classes between it
+/// and the nearest ancestor with a map (at most \c kMaxSharedMapDelta of
+/// them, each defining one property), then in the map of that ancestor. It
+/// only needs a map of its own when the position of a property it has is
+/// needed, to update or delete the property.
 class HiddenClass;
 namespace detail {
 /// Encode a transition from a hidden class to a child, keyed on the
@@ -213,6 +225,12 @@ class TransitionMap {
     return isClean() || (isLarge() && large()->isKnownEmpty());
   }
 
+  /// \return true if more than one transition was ever inserted, even if
+  /// some of them have been freed since.
+  bool hasSeveralEntries() const {
+    return isLarge();
+  }
+
   /// Invoke \p callback on each (const) key and value. Values may be invalid.
   template <typename CallbackFunction>
   void forEachEntry(const CallbackFunction &callback) const {
@@ -274,6 +292,15 @@ class HiddenClass final : public GCCell {
   /// mode".
   static constexpr unsigned kDictionaryThreshold = 64;
 
+  /// The number of reads of the object owning a dictionary which miss the
+  /// inline caches, with no change to the dictionary in between, after which
+  /// the object gets a regular class again.
+  static constexpr unsigned kDictionaryQuietReads = 64;
+
+  /// The number of classes without a property map which a lookup goes
+  /// through, looking for the map of an ancestor shared with their siblings.
+  static constexpr unsigned kMaxSharedMapDelta = 8;
+
   static VTable vt;
 
   static bool classof(const GCCell *cell) {
@@ -318,6 +345,25 @@ class HiddenClass final : public GCCell {
     return flags_.hasIndexLikeProperties;
   }
 
+  /// Record that the last property with an index-like name was deleted.
+  /// \pre this is a dictionary, which only describes a single object.
+  void clearHasIndexLikeProperties() {
+    assert(isDictionary() && "only dictionaries describe a single object");
+    flags_.hasIndexLikeProperties = false;
+  }
+
+  /// Record a read of the object owning this dictionary which missed the
+  /// inline caches.
+  /// \return true if the dictionary has not changed for the last
+  ///   \c kDictionaryQuietReads of them, in which case the count starts over.
+  bool noteDictionaryRead() {
+    assert(isDictionary() && "only dictionaries count their reads");
+    if (++dictionaryReads_ < kDictionaryQuietReads)
+      return false;
+    dictionaryReads_ = 0;
+    return true;
+  }
+
   /// \return The for-in cache if one has been set, otherwise nullptr.
   BigStorage *getForInCache(Runtime *runtime) const {
     return forInCache_.get(runtime);
@@ -331,6 +377,18 @@ class HiddenClass final : public GCCell {
     forInCache_ = nullptr;
   }
 
+  /// \return the names of the enumerable string-keyed properties of plain
+  /// objects of this class, as Object.keys() returns them, if they have been
+  /// cached, otherwise nullptr.
+  ArrayStorage *getKeysCache(Runtime *runtime) const {
+    return keysCache_.get(runtime);
+  }
+
+  void setKeysCache(ArrayStorage *arr, Runtime *runtime) {
+    assert(!isDictionary() && "dictionaries change in place");
+    keysCache_.set(runtime, arr, &runtime->getHeap());
+  }
+
   /// Reset the property map, unless this class is in dictionary mode.
   /// May be called by the GC for any HiddenClass not in a Handle.
   void clearPropertyMap() {
@@ -387,6 +445,17 @@ class HiddenClass final : public GCCell {
       PropertyFlags expectedFlags,
       NamedPropertyDescriptor &desc);
 
+  /// Look for a property like \c findProperty(), when its position isn't
+  /// needed. The property may be found in a map shared with the siblings of
+  /// the class, instead of creating a map for the class.
+  /// \return true if the property was found.
+  static bool findPropertyDescriptor(
+      PseudoHandle<HiddenClass> self,
+      Runtime *runtime,
+      SymbolID name,
+      PropertyFlags expectedFlags,
+      NamedPropertyDescriptor &desc);
+
   /// Same operation as \p findProperty, but does not do any allocations.
   /// This is slower than \p findProperty because it needs to traverse the full
   /// hidden class chain in the worst case.
@@ -394,10 +463,10 @@ class HiddenClass final : public GCCell {
   findPropertyNoAlloc(HiddenClass *self, PointerBase *base, SymbolID name);
 
   /// An optimistic fast path for \c findProperty(). If there is an allocated
-  /// property map, this will return an OptValue containing either true or
-  /// false. If there was no allocated property map, this returns llvm::None. If
-  /// this fails by returning None, the "slow path", \c findProperty() itself,
-  /// must be used.
+  /// property map, of this class or of a close ancestor, this will return an
+  /// OptValue containing either true or false. If there was no allocated
+  /// property map, this returns llvm::None. If this fails by returning None,
+  /// the "slow path", \c findProperty() itself, must be used.
   static OptValue<bool> tryFindPropertyFast(
       const HiddenClass *self,
       PointerBase *base,
@@ -499,6 +568,14 @@ class HiddenClass final : public GCCell {
       PropertyFlags propertyFlags,
       unsigned numProperties);
 
+  /// Look up the child of \p selfHandle by \p transition, in the transition
+  /// cache of the runtime and then in the transition map, caching it in the
+  /// former if it is only found in the latter.
+  static llvm::Optional<Handle<HiddenClass>> lookupTransition(
+      Handle<HiddenClass> selfHandle,
+      Runtime *runtime,
+      const Transition &transition);
+
   /// Create a copy of this \c HiddenClass and ensure that the copy is
   /// in dictionary mode.  Requires that the current \C HiddenClass
   /// does not have the dictionaryNoCacheMode flag set; such
@@ -522,6 +599,30 @@ class HiddenClass final : public GCCell {
       SymbolID name,
       NamedPropertyDescriptor desc);
 
+  /// \return true if the property map of this class is kept for the lookups
+  /// of its several children, instead of moving to one of them.
+  bool sharesPropertyMap() const {
+    return transitionMap_.hasSeveralEntries();
+  }
+
+  /// Look for a property in the classes between \p self and its nearest
+  /// ancestor with a property map, then in that map, without allocating.
+  /// \return whether the property was found, or None if \p self has no
+  ///   ancestor with a map within \c kMaxSharedMapDelta classes.
+  static OptValue<bool> findPropertyInAncestorMap(
+      const HiddenClass *self,
+      PointerBase *base,
+      SymbolID name,
+      NamedPropertyDescriptor &desc);
+
+  /// Same as \c findPropertyInAncestorMap(), but if the parent of
+  /// \p selfHandle shares its map and doesn't have one, create it first.
+  static OptValue<bool> findPropertyInSharedMap(
+      Handle<HiddenClass> selfHandle,
+      Runtime *runtime,
+      SymbolID name,
+      NamedPropertyDescriptor &desc);
+
   /// Construct a property map by walking back the chain of hidden classes and
   /// store it in \c propertyMap_.
   static void initializeMissingPropertyMap(
@@ -530,7 +631,8 @@ class HiddenClass final : public GCCell {
 
   /// Initialize the property map by transferring the parent's map to ourselves
   /// and adding a our property to it. It must only be called if we don't have a
-  /// property map of our own but have a valid parent with a property map.
+  /// property map of our own but have a valid parent with a property map,
+  /// which it doesn't share.
   static void stealPropertyMapFromParent(
       Handle<HiddenClass> selfHandle,
       Runtime *runtime);
@@ -562,6 +664,10 @@ class HiddenClass final : public GCCell {
   /// Flags associated with this hidden class.
   ClassFlags flags_{};
 
+  /// In dictionary mode, the number of reads counted by noteDictionaryRead()
+  /// since the dictionary last changed.
+  uint16_t dictionaryReads_{0};
+
   /// Total number of properties encoded in the entire chain from this class
   /// to the root. Note that some transitions do not introduce a new property,
   /// so this is not the same as the length of the transition chain.
@@ -590,6 +696,10 @@ class HiddenClass final : public GCCell {
   /// Cache that contains for-in property names for objects of this class.
   /// Never used in dictionary mode.
   GCPointer<BigStorage> forInCache_{};
+
+  /// Cache that contains the Object.keys() names of plain objects of this
+  /// class. Never used in dictionary mode.
+  GCPointer<ArrayStorage> keysCache_{};
 };
 
 //===----------------------------------------------------------------------===//
@@ -636,7 +746,7 @@ inline OptValue<bool> HiddenClass::tryFindPropertyFast(
   } else if (self->numProperties_ == 0) {
     return false;
   }
-  return llvm::None;
+  return findPropertyInAncestorMap(self, base, name, desc);
 }
 
 } // namespace vm
@@ -79,6 +79,11 @@ class Interpreter {
       PinnedHermesValue *frameRegs,
       const Inst *ip);
 
+  /// Notify the runtime of a timeout or an interrupt if one was requested
+  /// through an async break. Async debugger requests are left pending, since
+  /// only the interpreter loop can service them.
+  static ExecutionStatus handleAsyncBreak(Runtime *runtime);
+
   /// Implement the slow path of OpCode::Call/CallLong/Construct/ConstructLong.
   /// The callee frame must have been initialized already and the fast path
   /// (calling a \c JSFunction) must have been handled.
@@ -109,6 +114,50 @@ class Interpreter {
   static OptValue<HermesValue>
   getByValTransientFast(Runtime *runtime, Handle<> base, Handle<> nameHandle);
 
+  /// Fast path for OpCode::GetByVal on an object -- read an element of an
+  /// array, arguments object or typed array directly from its storage,
+  /// specialized on the kind of \p obj, when \p name is an array index.
+  /// \return the element, or llvm::None if the generic path must be taken.
+  static OptValue<HermesValue>
+  getByValObjectFast(Runtime *runtime, JSObject *obj, HermesValue name);
+
+  /// Fast path for OpCode::PutByVal on an object -- overwrite an existing
+  /// element of an array, arguments object or typed array in its storage when
+  /// \p name is an array index, without calling into user code.
+  /// \return true if the value was stored, false if the generic path must be
+  /// taken.
+  static bool putByValObjectFast(
+      Runtime *runtime,
+      JSObject *obj,
+      HermesValue name,
+      HermesValue value);
+
+  /// Fast path for OpCode::DataViewGet -- read the element directly from the
+  /// storage of \p view when \p callee is the original DataView.prototype
+  /// method for the element type in \p type, the type operand of the
+  /// instruction, and \p offset is an index in range.
+  /// \return the element, or llvm::None if the method must be called.
+  static OptValue<HermesValue> dataViewGetFast(
+      Runtime *runtime,
+      HermesValue callee,
+      HermesValue view,
+      HermesValue offset,
+      HermesValue littleEndian,
+      uint8_t type);
+
+  /// Fast path for OpCode::DataViewSet -- like dataViewGetFast(), but write
+  /// \p value, which must be a number.
+  /// \return true if the value was written, false if the method must be
+  /// called.
+  static bool dataViewSetFast(
+      Runtime *runtime,
+      HermesValue callee,
+      HermesValue view,
+      HermesValue offset,
+      HermesValue value,
+      HermesValue littleEndian,
+      uint8_t type);
+
   /// Implement OpCode::GetByVal when the base is not an object.
   static CallResult<HermesValue>
   getByValTransient_RJS(Runtime *runtime, Handle<> base, Handle<> name);
@@ -129,33 +178,50 @@ class Interpreter {
       Handle<> value,
       bool strictMode);
 
-  template <bool SingleStep>
+  /// Run the function in \p state, in a new frame, or from the instruction
+  /// in \p state in the current frame if \p resume is true or SingleStep.
+  /// With the JIT, return before popping the frame \p resumeFrame when it
+  /// returns or throws, if it isn't null.
+  /// Only the Instrumented loop reports function entries and exits to the
+  /// function profiler, and in debugger builds checks for async debugger
+  /// requests at calls and returns, and for stepping into functions. Code runs
+  /// in the other loop until the profiler is enabled or the debugger becomes
+  /// active, so that it pays nothing for them; that loop hands its frames over
+  /// to the instrumented one when it has to run the debugger.
+  template <bool SingleStep, bool Instrumented>
   static CallResult<HermesValue> interpretFunction(
       Runtime *runtime,
-      InterpreterState &state);
+      InterpreterState &state,
+      bool resume = false,
+      const PinnedHermesValue *resumeFrame = nullptr);
 
   /// Populates an object with literal values from the object buffer.
   /// \param numLiterals the amount of literals to read from the buffer.
   /// \param keyBufferIndex the first element of the key buffer to read.
   /// \param valBufferIndex the first element of the val buffer to read.
+  /// \param site if not null, the allocation site of the object, which decides
+  ///   whether it is pretenured, and may be sampled by the GC.
   /// \return ExecutionStatus::EXCEPTION if the property definitions throw.
   static CallResult<HermesValue> createObjectFromBuffer(
       Runtime *runtime,
       CodeBlock *curCodeBlock,
       unsigned numLiterals,
       unsigned keyBufferIndex,
-      unsigned valBufferIndex);
+      unsigned valBufferIndex,
+      AllocationSite *site = nullptr);
 
   /// Populates an array with literal values from the array buffer.
   /// \param numLiterals the amount of literals to read from the buffer.
   /// \param bufferIndex the first element of the buffer to read.
+  /// \param site as in createObjectFromBuffer.
   /// \return ExecutionStatus::EXCEPTION if the property definitions throw.
   static CallResult<HermesValue> createArrayFromBuffer(
       Runtime *runtime,
       CodeBlock *curCodeBlock,
       unsigned numElements,
       unsigned numLiterals,
-      unsigned bufferIndex);
+      unsigned bufferIndex,
+      AllocationSite *site = nullptr);
 
 #ifdef HERMES_ENABLE_DEBUGGER
   /// Wrapper around runDebugger() that reapplies the interpreter state.
@@ -206,6 +272,48 @@ class Interpreter {
       Runtime *runtime,
       PinnedHermesValue *frameRegs,
       const inst::Inst *ip);
+
+  /// Implementation of GetByIdSlot, including the cache check that the
+  /// interpreter also performs inline. The read cache entry of the instruction
+  /// is only updated with classes which have the property at its slot.
+  static ExecutionStatus caseGetByIdSlot(
+      Runtime *runtime,
+      PinnedHermesValue *frameRegs,
+      const inst::Inst *ip);
+
+  /// Implementation of DataViewGet and DataViewSet, including the fast paths
+  /// that the interpreter also performs inline. The method is called when
+  /// they don't apply.
+  static ExecutionStatus caseDataViewGet(
+      Runtime *runtime,
+      PinnedHermesValue *frameRegs,
+      const inst::Inst *ip);
+
+  static ExecutionStatus caseDataViewSet(
+      Runtime *runtime,
+      PinnedHermesValue *frameRegs,
+      const inst::Inst *ip);
+
+#ifdef HERMESVM_TAIL_CALL_DISPATCH
+  /// Run the instructions from \p ip on with the tail-call handlers of
+  /// Interpreter-tailcall.cpp, as long as they are simple instructions which
+  /// take their fast path.
+  /// \return the first instruction that was not run.
+  static const inst::Inst *runTailCallHandlers(
+      Runtime *runtime,
+      PinnedHermesValue *frameRegs,
+      const inst::Inst *ip);
+#endif
+
+  /// Look up \p val, the input of the SwitchStr or SwitchSparse instruction
+  /// \p ip of a function of \p runtimeModule, in its hashed jump table.
+  /// \return the slot of the case it is strictly equal to, or the number of
+  /// slots of the table if there is none.
+  static uint32_t switchHashSlot(
+      Runtime *runtime,
+      RuntimeModule *runtimeModule,
+      PinnedHermesValue *val,
+      const inst::Inst *ip);
 };
 
 } // namespace vm
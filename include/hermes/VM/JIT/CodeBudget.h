@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_CODEBUDGET_H
+#define HERMES_VM_JIT_CODEBUDGET_H
+
+#include "hermes/VM/JIT/CompileQueue.h"
+
+#include "llvm/ADT/STLExtras.h"
+
+#include <list>
+
+namespace hermes {
+namespace vm {
+
+class Runtime;
+
+/// Keeps track of the executable memory used by the installed code of every
+/// CodeBlock, and evicts the code of cold functions to keep it within a
+/// budget. Evicted functions go back to the interpreter and may be compiled
+/// again once they get hot again.
+///
+/// Functions are picked with the CLOCK approximation of LRU: every entry into
+/// a compiled body marks its CodeBlock as used, and the eviction sweeps the
+/// compiled functions in order, clearing the mark of the used ones and
+/// evicting the first ones that weren't. The code of a function with a frame
+/// on the stack is never evicted, since it may be running or be returned to.
+class CodeBudget {
+ public:
+  using FreeFunction = llvm::function_ref<void(ExecHeap::BlockPair)>;
+
+  /// Limit the executable memory used by the compiled code to \p limit
+  /// bytes, or don't limit it if \p limit is 0.
+  void setLimit(size_t limit) {
+    limit_ = limit;
+  }
+
+  /// \return the budget in bytes, or 0 if there is none.
+  size_t getLimit() const {
+    return limit_;
+  }
+
+  /// \return true if the compiled code uses more memory than its budget.
+  bool isOverBudget() const {
+    return limit_ && bytesUsed_ > limit_;
+  }
+
+  /// Record that \p code was installed into \p codeBlock.
+  void add(CodeBlock *codeBlock, const JITCompiledCode &code);
+
+  /// Evict cold code until its memory is within the budget again, or every
+  /// compiled function is either hot or on the stack of \p runtime.
+  /// \param free called with the memory of every evicted function.
+  void evict(Runtime *runtime, FreeFunction free);
+
+  /// Forget the code of the CodeBlocks owned by \p runtimeModule, which is
+  /// being destroyed, and pass its memory to \p free.
+  void remove(RuntimeModule *runtimeModule, FreeFunction free);
+
+  /// \return the number of bytes of executable memory used by the code of
+  ///   the compiled functions.
+  size_t getBytesUsed() const {
+    return bytesUsed_;
+  }
+
+  /// \return the total number of bytes of executable memory freed so far.
+  size_t getBytesFreed() const {
+    return bytesFreed_;
+  }
+
+  /// \return the number of functions whose code has been evicted so far.
+  uint32_t getNumEvicted() const {
+    return numEvicted_;
+  }
+
+ private:
+  /// The code of a compiled function.
+  struct Entry {
+    CodeBlock *codeBlock;
+    ExecHeap::BlockPair blocks;
+    size_t size;
+  };
+  using EntryList = std::list<Entry>;
+
+  /// Forget the entry \p it and free its memory.
+  /// \return the next entry.
+  EntryList::iterator release(EntryList::iterator it, FreeFunction free);
+
+  /// The compiled functions, in the order they are swept.
+  EntryList entries_{};
+
+  /// The next entry considered for eviction; the "clock hand".
+  EntryList::iterator hand_ = entries_.end();
+
+  /// The budget in bytes, or 0 if there is none.
+  size_t limit_ = 0;
+
+  /// The memory used by the entries.
+  size_t bytesUsed_ = 0;
+
+  /// The total memory freed by evictions and destroyed RuntimeModules.
+  size_t bytesFreed_ = 0;
+
+  /// The number of functions evicted.
+  uint32_t numEvicted_ = 0;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_CODEBUDGET_H
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_COMPILEQUEUE_H
+#define HERMES_VM_JIT_COMPILEQUEUE_H
+
+#include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/JIT/ExecHeap.h"
+
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/STLExtras.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// The native code produced for a CodeBlock. It isn't used by the interpreter
+/// until it is installed into the CodeBlock.
+struct JITCompiledCode {
+  /// The native body of the function, or null if the compilation failed.
+  JITCompiledFunctionPtr body = nullptr;
+
+  /// The native entry points at the loop headers of the function, with the
+  /// bytecode offset of the header they start at.
+  std::vector<std::pair<uint32_t, JITCompiledFunctionPtr>> loopEntries{};
+
+  /// The executable memory holding the code.
+  ExecHeap::BlockPair blocks{nullptr, nullptr};
+
+  /// The number of bytes of executable memory kept for the code.
+  size_t size = 0;
+
+  /// The number of bytes of code emitted in each of the blocks.
+  ExecHeap::SizePair codeSizes{0, 0};
+
+  /// The offset of the code of every instruction in the first block, with the
+  /// bytecode offset of the instruction, in order. Only filled in if a
+  /// JITPerfMap wants the source lines of the code.
+  std::vector<std::pair<uint32_t, uint32_t>> lineTable{};
+
+  /// Make the code the implementation of \p codeBlock, or mark \p codeBlock as
+  /// not compilable if the compilation failed. Must be called on the thread
+  /// running the interpreter.
+  void install(CodeBlock *codeBlock) const;
+};
+
+/// Compiles CodeBlocks on a worker thread, so that the interpreter can keep
+/// running the function while it is being compiled. The worker thread is
+/// created lazily, by the first compilation.
+///
+/// The finished code is kept in the queue until the interpreter calls
+/// \c installFinished() at a call boundary, so a CodeBlock never changes while
+/// the interpreter is using it. The compile function is the only code run on
+/// the worker thread; it must not touch any state of the runtime that the
+/// interpreter may be modifying. Since the worker owns the executable heap,
+/// evicted code is also freed by it, with the release function.
+class CompileQueue {
+ public:
+  using CompileFunction = std::function<JITCompiledCode(CodeBlock *)>;
+  using ReleaseFunction = std::function<void(ExecHeap::BlockPair)>;
+  using InstallFunction =
+      llvm::function_ref<void(CodeBlock *, const JITCompiledCode &)>;
+
+  CompileQueue(CompileFunction compile, ReleaseFunction release);
+
+  /// Discards the pending compilations, waits for the one in progress, joins
+  /// the worker thread and frees the code that is still waiting to be.
+  ~CompileQueue();
+
+  CompileQueue(const CompileQueue &) = delete;
+  CompileQueue &operator=(const CompileQueue &) = delete;
+
+  /// Compile \p codeBlock on the worker thread, unless it is already queued or
+  /// compiled and waiting to be installed. Any CodeBlocks it calls or creates
+  /// closures for are materialized first, so the worker doesn't have to, and
+  /// its type feedback is frozen.
+  void enqueue(CodeBlock *codeBlock);
+
+  /// Install the code of every finished compilation into its CodeBlock, by
+  /// passing both to \p install.
+  void installFinished(InstallFunction install) {
+    if (LLVM_UNLIKELY(hasFinished_.load(std::memory_order_acquire)))
+      installFinishedSlowPath(install);
+  }
+
+  /// Forget the compilations of the CodeBlocks owned by \p runtimeModule,
+  /// which is being destroyed, waiting for the worker if it is compiling one.
+  /// The code of the finished ones is freed.
+  void cancel(RuntimeModule *runtimeModule);
+
+  /// Free the executable memory \p blocks on the worker thread, once it is
+  /// done with the compilation in progress.
+  void releaseLater(ExecHeap::BlockPair blocks);
+
+  /// Block until every CodeBlock enqueued so far has been compiled.
+  void waitUntilIdle();
+
+ private:
+  /// The loop run by the worker thread.
+  void workerLoop();
+
+  /// Install the finished compilations, once there are some.
+  void installFinishedSlowPath(InstallFunction install);
+
+  /// Produces the native code of a CodeBlock. Only called by the worker.
+  CompileFunction compile_;
+
+  /// Frees the executable memory of evicted code. Only called by the worker,
+  /// or once it has exited.
+  ReleaseFunction release_;
+
+  /// Protects pending_, finished_, released_, running_ and shouldExit_.
+  std::mutex mtx_;
+
+  /// Signalled when work is enqueued or released, or the worker should exit.
+  std::condition_variable workAvailable_;
+
+  /// Signalled when the worker has finished a compilation.
+  std::condition_variable compiled_;
+
+  /// CodeBlocks waiting to be compiled, in order.
+  std::deque<CodeBlock *> pending_{};
+
+  /// Compilations waiting to be installed.
+  std::vector<std::pair<CodeBlock *, JITCompiledCode>> finished_{};
+
+  /// Executable memory waiting to be freed.
+  std::vector<ExecHeap::BlockPair> released_{};
+
+  /// Whether finished_ is not empty, so that checking it at every call
+  /// boundary doesn't require the lock.
+  std::atomic<bool> hasFinished_{false};
+
+  /// The CodeBlock the worker is compiling, if any.
+  CodeBlock *running_{nullptr};
+
+  /// Whether the worker thread should exit.
+  bool shouldExit_{false};
+
+  /// Every CodeBlock that was enqueued and hasn't been installed yet. Only
+  /// accessed by the interpreter thread.
+  llvm::DenseSet<CodeBlock *> queued_{};
+
+  std::thread worker_;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_COMPILEQUEUE_H
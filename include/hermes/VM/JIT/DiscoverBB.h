@@ -23,10 +23,13 @@ class CodeBlock;
 ///     every basic block in order. The last entry is the end of the bytecode.
 /// \param[out] labels Map from a bytecode target label offset to a basic block
 ///     index.
+/// \param[out] loopHeaders on output it will contain the index of every basic
+///     block that is the target of a backward branch, in order.
 void discoverBasicBlocks(
     CodeBlock *codeBlock,
     std::vector<uint32_t> &basicBlocks,
-    llvm::DenseMap<uint32_t, unsigned> &labels);
+    llvm::DenseMap<uint32_t, unsigned> &labels,
+    std::vector<unsigned> &loopHeaders);
 
 } // namespace vm
 } // namespace hermes
@@ -18,6 +18,12 @@
 #include <memory>
 #include <utility>
 
+#if defined(__APPLE__) && defined(__aarch64__)
+/// Executable memory must be mapped with MAP_JIT and made writable per thread.
+#define HERMESVM_JIT_MAP_JIT
+#include <libkern/OSCacheControl.h>
+#endif
+
 namespace llvm {
 class raw_ostream;
 } // namespace llvm
@@ -34,6 +40,13 @@ namespace vm {
 ///   within it.
 /// Each block (\c DualPool) is split into two heaps of specified size.
 /// Allocation and deallocation functions work in both heaps at the same time.
+///
+/// Memory is never writable and executable at the same time, as required by
+/// iOS and by recent Android versions: pools start out writable, and the pages
+/// of a pair of blocks are made writable with \c unprotect() before code is
+/// emitted into them, and executable with \c publish() once it is complete.
+/// On Apple arm64 pools are mapped with MAP_JIT and the toggling is done per
+/// thread instead, which is the only mechanism the OS allows there.
 class ExecHeap {
  public:
   using BlockPair = std::pair<uint8_t *, uint8_t *>;
@@ -75,11 +88,32 @@ class ExecHeap {
   /// \c freeRemaining(blocks, {0, 0}).
   void free(BlockPair blocks);
 
+  /// Make the pages containing the first \p sizes bytes of the previously
+  /// allocated \p blocks writable, so code can be emitted into them. Until the
+  /// matching \c publish(), code in the same pages must not be executed.
+  /// \return false if the protection could not be changed.
+  bool unprotect(BlockPair blocks, SizePair sizes);
+
+  /// Make the pages containing the first \p sizes bytes of \p blocks
+  /// executable again and invalidate the instruction cache for them. Must be
+  /// called after \c unprotect() before the code is executed or the blocks are
+  /// freed.
+  /// \return false if the protection could not be changed.
+  bool publish(BlockPair blocks, SizePair sizes);
+
   /// Invalidate the instruction cache for a JIT-ted block of code before
   /// executing it.
   inline void invalidateInstructionCache(void *addr, size_t len) {
+#ifdef HERMESVM_JIT_MAP_JIT
+    sys_icache_invalidate(addr, len);
+#else
     llvm::sys::Memory::InvalidateInstructionCache(addr, len);
-    // Possibly use  __builtin___clear_cache() for better performance?
+#endif
+  }
+
+  /// \return the executable memory mapped by the pools allocated so far.
+  size_t getReservedSize() const {
+    return pools_.size() * (firstHeapSize_ + secondHeapSize_);
   }
 
   /// Dump the heap metadata to the specified output stream.
@@ -10,19 +10,34 @@
 
 #ifdef HERMESVM_JIT
 
+#if defined(__aarch64__)
+#include "hermes/VM/JIT/arm64/JIT.h"
+#else
 #include "hermes/VM/JIT/x86-64/JIT.h"
+#endif
 
 namespace hermes {
 namespace vm {
 
+#if defined(__aarch64__)
+using arm64::JITContext;
+#else
 using x86_64::JITContext;
+#endif
 
 } // namespace vm
 } // namespace hermes
 
 #else
 
+#include "hermes/Regex/Executor.h"
 #include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/JIT/JITRegExp.h"
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <vector>
 
 namespace hermes {
 namespace vm {
@@ -52,6 +67,35 @@ class JITContext {
     return codeBlock->getJITCompiled();
   }
 
+  /// Count a backward branch to the loop header \p ip in the interpreted
+  /// function \p codeBlock and, if the function is hot enough, compile it and
+  /// return the native code continuing it from that loop header. Otherwise,
+  /// return nullptr.
+  inline JITCompiledFunctionPtr
+  compileLoop(Runtime *runtime, CodeBlock *codeBlock, const inst::Inst *ip) {
+    return nullptr;
+  }
+
+  /// \return the JIT state shared by the regexps with \p bytecode. There is
+  /// none without the JIT.
+  JITRegExp *getRegExp(llvm::ArrayRef<uint8_t> bytecode) {
+    return nullptr;
+  }
+
+  /// Search with the native code of \p regExp, which is never compiled here.
+  /// \return llvm::None, to search with the interpreter.
+  template <typename CharT>
+  llvm::Optional<regex::MatchRuntimeResult> searchRegExp(
+      JITRegExp *regExp,
+      llvm::ArrayRef<uint8_t> bytecode,
+      const CharT *first,
+      uint32_t start,
+      uint32_t length,
+      std::vector<regex::CapturedRange> *m,
+      regex::constants::MatchFlagType matchFlags) {
+    return llvm::None;
+  }
+
   /// \return true if JIT compilation is enabled.
   bool isEnabled() const {
     return false;
@@ -60,6 +104,47 @@ class JITContext {
   /// Enable or disable JIT compilation.
   void setEnabled(bool enabled) {}
 
+  /// \return true if functions are compiled on a background thread.
+  bool getBackgroundCompilation() const {
+    return false;
+  }
+
+  /// Compile functions on a background thread while the interpreter keeps
+  /// running them, or synchronously, when they get hot.
+  void setBackgroundCompilation(bool background) {}
+
+  /// Forget the pending compilations and free the compiled code of the
+  /// CodeBlocks owned by \p runtimeModule, which is being destroyed.
+  void cancelCompilations(RuntimeModule *runtimeModule) {}
+
+  /// Limit the executable memory used by the compiled code to \p bytes.
+  void setCodeBudget(size_t bytes) {}
+
+  /// Print the statistics of the executable memory used by the compiled code
+  /// to \p os.
+  void printStats(llvm::raw_ostream &os) const {}
+
+  /// \return the executable memory mapped for the compiled code, of which
+  /// there is none.
+  size_t getExecMemorySize() const {
+    return 0;
+  }
+
+  /// Remember the compiled functions of every bytecode file in \p dir, and
+  /// compile them as soon as the bytecode file is loaded again.
+  void setProfileCacheDir(const std::string &dir) {}
+
+  /// Compile the functions of \p runtimeModule that were compiled the last
+  /// time its bytecode was run.
+  void loadProfile(Runtime *runtime, RuntimeModule *runtimeModule) {}
+
+  /// Remember the compiled functions of \p runtimeModule, which is being
+  /// destroyed, for the next launch.
+  void saveProfile(RuntimeModule *runtimeModule) {}
+
+  /// Describe the compiled code to the Linux perf tool.
+  void setPerfMap(bool enable) {}
+
   /// Enable or disable dumping JIT'ed Code.
   void setDumpJITCode(bool dump) {}
 
@@ -68,6 +153,13 @@ class JITContext {
     return false;
   }
 
+  /// Set the number of interpreted calls after which a function is compiled.
+  void setCallThreshold(uint32_t threshold) {}
+
+  /// Set the number of interpreted loop iterations after which a function is
+  /// compiled and entered at the loop header.
+  void setLoopThreshold(uint32_t threshold) {}
+
   /// Set the flag to fatally crash on JIT compilation errors.
   void setCrashOnError(bool crash) {}
 
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_JITPERFMAP_H
+#define HERMES_VM_JIT_JITPERFMAP_H
+
+#include "hermes/VM/JIT/CompileQueue.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <memory>
+#include <string>
+
+namespace hermes {
+namespace vm {
+
+/// Describes the installed JIT'ed code to the Linux perf tool, so that its
+/// samples are attributed to JS functions instead of anonymous memory.
+///
+/// Two files are written, named after the process ID:
+/// - perf-<pid>.map, a text file with the address, size and name of every
+///   piece of code, which `perf report` reads directly.
+/// - jit-<pid>.dump, in the jitdump format, which also holds a copy of the
+///   code and its source lines. `perf record -k mono` notices it because the
+///   file is mapped into the process, and `perf inject --jit` turns it into
+///   ELF images that `perf report` and `perf annotate` can use.
+///
+/// Code that is later evicted stays in the files; perf attributes the samples
+/// at an address to the code loaded there most recently.
+class JITPerfMap {
+ public:
+  /// Create the files in \p dir. perf only looks for the map in /tmp.
+  explicit JITPerfMap(llvm::StringRef dir = "/tmp");
+  ~JITPerfMap();
+
+  JITPerfMap(const JITPerfMap &) = delete;
+  void operator=(const JITPerfMap &) = delete;
+
+  /// Record that \p code was installed into \p codeBlock. Must be called on
+  /// the thread running the interpreter.
+  void add(const CodeBlock *codeBlock, const JITCompiledCode &code);
+
+  /// \return the path of the perf map.
+  const std::string &getMapPath() const {
+    return mapPath_;
+  }
+
+  /// \return the path of the jitdump file.
+  const std::string &getDumpPath() const {
+    return dumpPath_;
+  }
+
+ private:
+  /// Write a JIT_CODE_DEBUG_INFO record with the source lines of the code
+  /// of \p codeBlock at \p addr, if it has any.
+  void writeDebugInfo(
+      const CodeBlock *codeBlock,
+      const uint8_t *addr,
+      const JITCompiledCode &code);
+
+  /// Write a JIT_CODE_LOAD record for the \p size bytes of code at \p addr,
+  /// named \p name.
+  void writeCodeLoad(const std::string &name, const uint8_t *addr, size_t size);
+
+  /// Describe the \p size bytes of code at \p addr, named \p name, in both
+  /// files.
+  void addRange(const std::string &name, const uint8_t *addr, size_t size);
+
+  /// The path of the perf map.
+  std::string mapPath_;
+  /// The perf map, or null if it couldn't be created.
+  std::unique_ptr<llvm::raw_fd_ostream> map_{};
+
+  /// The path of the jitdump file.
+  std::string dumpPath_;
+  /// The jitdump file, or null if it couldn't be created.
+  std::unique_ptr<llvm::raw_fd_ostream> dump_{};
+  /// The mapping of the first page of the jitdump file, which tells perf
+  /// where to find it.
+  void *dumpMarker_{nullptr};
+
+  /// The index of the next JIT_CODE_LOAD record.
+  uint64_t codeIndex_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_JITPERFMAP_H
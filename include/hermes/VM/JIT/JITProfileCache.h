@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_JITPROFILECACHE_H
+#define HERMES_VM_JIT_JITPROFILECACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+class RuntimeModule;
+
+/// Remembers across launches which functions of a bytecode file were hot
+/// enough to be JIT compiled, so that the next launch can compile them as soon
+/// as the bytecode is loaded instead of interpreting them until they get hot
+/// again.
+///
+/// Every bytecode file has its own profile in the cache directory, named after
+/// the source hash in its header. It is a text file with a header line
+/// followed by the ID of a compiled function per line. Bytecode without a
+/// source hash, e.g. compiled from source by the runtime, is not cached.
+class JITProfileCache {
+ public:
+  /// \param dir the directory holding the profiles. It must already exist.
+  explicit JITProfileCache(std::string dir) : dir_(std::move(dir)) {}
+
+  /// \return the IDs of the functions of \p runtimeModule that were compiled
+  ///   when its bytecode was last run, or an empty vector if there is no
+  ///   usable profile.
+  std::vector<uint32_t> load(const RuntimeModule *runtimeModule) const;
+
+  /// Replace the profile of \p runtimeModule with the functions it owns that
+  /// have been compiled. Failing to write the profile is not an error.
+  void save(const RuntimeModule *runtimeModule) const;
+
+ private:
+  /// \return the path of the profile of \p runtimeModule, or an empty string
+  ///   if its bytecode has no source hash.
+  std::string getPath(const RuntimeModule *runtimeModule) const;
+
+  /// The directory holding the profiles.
+  const std::string dir_;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_JITPROFILECACHE_H
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_JITREGEXP_H
+#define HERMES_VM_JIT_JITREGEXP_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hermes {
+namespace vm {
+
+/// The outcome of running the native code of a regexp.
+enum class JITRegExpResult : uint32_t {
+  /// A match was found; the captures hold its bounds.
+  Match,
+  /// There is no match at any of the start positions.
+  NoMatch,
+  /// The backtracking budget or stack ran out before a result was found. The
+  /// search must be repeated by the interpreter.
+  Fallback,
+};
+
+/// The arguments of the native code of a regexp, searching the input of
+/// code units \p CharT. The layout is known to the generated code.
+template <typename CharT>
+struct JITRegExpArgs {
+  /// The first code unit of the input.
+  const CharT *first;
+  /// One past the last code unit of the input.
+  const CharT *last;
+  /// The first position a match may start at.
+  const CharT *start;
+  /// The last position a match may start at.
+  const CharT *lastStart;
+  /// The start and end pointers of the whole match, followed by those of
+  /// every capture group, all initialized to null, which marks an unmatched
+  /// group.
+  const CharT **captures;
+  /// The backtracking stack, of 3 words per entry, and its end.
+  uint64_t *stack;
+  uint64_t *stackEnd;
+  /// The number of times the code may backtrack before it gives up.
+  uint32_t backtrackLimit;
+};
+
+/// A regexp compiled to native code, returning the JITRegExpResult of a
+/// search.
+template <typename CharT>
+using JITCompiledRegExpPtr = JITRegExpResult (*)(const JITRegExpArgs<CharT> *);
+
+/// The JIT state of a regexp bytecode, shared by every JSRegExp with the same
+/// bytecode, so that literals evaluated again on every call still get hot.
+struct JITRegExp {
+  /// The number of interpreted searches, until the regexp is compiled.
+  uint32_t searchCount{0};
+  /// Set if the regexp can't be compiled.
+  bool dontJIT{false};
+  /// The native code searching ASCII and UTF-16 input respectively, if
+  /// compiled.
+  JITCompiledRegExpPtr<char> code8{nullptr};
+  JITCompiledRegExpPtr<char16_t> code16{nullptr};
+};
+
+/// The number of entries of the backtracking stack of the native code. The
+/// search falls back to the interpreter when they run out.
+constexpr size_t kJITRegExpStackEntries = 1 << 14;
+
+/// \return the number of times the native code may backtrack when searching
+/// \p length code units, past which the interpreter, with its own budget and
+/// linear fallback, takes over.
+constexpr uint32_t jitRegExpBacktrackLimit(uint32_t length) {
+  return length < (1u << 26) ? (1u << 14) + 16 * length : (1u << 30);
+}
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_JITREGEXP_H
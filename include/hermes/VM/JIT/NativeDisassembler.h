@@ -24,6 +24,7 @@ class NativeDisassembler {
 
  public:
   static const char x86_64_unknown_linux_gnu[];
+  static const char aarch64_unknown_linux_gnu[];
 
   virtual ~NativeDisassembler() = 0;
 
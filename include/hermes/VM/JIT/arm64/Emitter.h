@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// The AArch64 (A64) binary instruction emitter.
+/// Every A64 instruction is a single little-endian 32-bit word, so unlike the
+/// x86-64 emitter no templates are needed to select encodings. Only the 64-bit
+/// forms of integer instructions are provided, except where a 32-bit form is
+/// needed to test the tag or the low half of a HermesValue.
+//===----------------------------------------------------------------------===//
+
+#ifndef HERMES_VM_JIT_ARM64_EMITTER_H
+#define HERMES_VM_JIT_ARM64_EMITTER_H
+
+#include "hermes/Support/Compiler.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace hermes {
+namespace vm {
+namespace arm64 {
+
+/// A general purpose register. Register 31 is the stack pointer or the zero
+/// register depending on the instruction.
+enum class Reg : uint8_t {
+  x0 = 0,
+  x1,
+  x2,
+  x3,
+  x4,
+  x5,
+  x6,
+  x7,
+  x8,
+  x9,
+  x10,
+  x11,
+  x12,
+  x13,
+  x14,
+  x15,
+  /// The intra-procedure-call scratch registers. x17 is clobbered by the
+  /// emitter itself to materialize offsets that don't fit in an instruction.
+  x16,
+  x17,
+  x18,
+  x19,
+  x20,
+  x21,
+  x22,
+  x23,
+  x24,
+  x25,
+  x26,
+  x27,
+  x28,
+  x29,
+  x30,
+  sp = 31,
+  xzr = 31,
+
+  fp = x29,
+  lr = x30,
+};
+
+/// A floating point register, used as a double.
+enum class FReg : uint8_t {
+  d0 = 0,
+  d1,
+  d2,
+  d3,
+};
+
+/// Condition codes.
+enum class Cond : uint8_t {
+  EQ = 0,
+  NE = 1,
+  HS = 2,
+  LO = 3,
+  MI = 4,
+  PL = 5,
+  VS = 6,
+  VC = 7,
+  HI = 8,
+  LS = 9,
+  GE = 10,
+  LT = 11,
+  GT = 12,
+  LE = 13,
+};
+
+/// \return the condition which holds exactly when \p cc doesn't.
+constexpr Cond invert(Cond cc) {
+  return static_cast<Cond>(static_cast<uint8_t>(cc) ^ 1);
+}
+
+/// A light-weight AArch64 binary instruction emitter. It is initialized with
+/// an output pointer and emits by incrementing it. It is the caller's
+/// responsibility to check whether the output buffer has enough space. The
+/// longest sequence emitted by a single call is MAX_INSTRUCTION_LENGTH bytes.
+///
+/// Like the x86-64 emitter, this class is trivially copyable and only holds
+/// the output pointer, so it can be passed and returned in a register.
+class Emitter {
+ public:
+  /// A 64-bit immediate takes four instructions, and a memory access with an
+  /// out of range offset one more.
+  static constexpr unsigned MAX_INSTRUCTION_LENGTH = 5 * 4;
+
+  explicit Emitter(uint8_t *buf) : out(buf) {}
+
+  Emitter(const Emitter &) = default;
+  Emitter &operator=(const Emitter &) = default;
+  ~Emitter() = default;
+
+  /// \return the current output pointer.
+  uint8_t *current() const {
+    return out;
+  }
+
+  /// Set the current output pointer.
+  void setCurrent(uint8_t *buf) {
+    out = buf;
+  }
+
+  template <uintptr_t x>
+  void align() {
+    out = reinterpret_cast<uint8_t *>(
+        (reinterpret_cast<uintptr_t>(out) + (x - 1)) & ~(x - 1));
+  }
+
+  template <typename T>
+  void numericConst(T x) {
+    std::memcpy(out, &x, sizeof(x));
+    out += sizeof(x);
+  }
+
+  /// Load the 64-bit immediate \p imm into \p dst with the shortest MOVZ/MOVN
+  /// and MOVK sequence.
+  void movImm(uint64_t imm, Reg dst) {
+    unsigned zeros = 0, ones = 0;
+    for (unsigned hw = 0; hw != 4; ++hw) {
+      uint16_t chunk = imm >> (hw * 16);
+      zeros += chunk == 0;
+      ones += chunk == 0xFFFF;
+    }
+    // With MOVN the chunks that are all ones come for free instead.
+    const bool useMovn = ones > zeros;
+    const uint16_t skip = useMovn ? 0xFFFF : 0;
+    bool first = true;
+    for (unsigned hw = 0; hw != 4; ++hw) {
+      uint16_t chunk = imm >> (hw * 16);
+      if (chunk == skip)
+        continue;
+      if (first) {
+        emit32(
+            (useMovn ? 0x92800000u : 0xD2800000u) | hw << 21 |
+            (uint32_t)(uint16_t)(useMovn ? ~chunk : chunk) << 5 | ord(dst));
+        first = false;
+      } else {
+        emit32(0xF2800000u | hw << 21 | (uint32_t)chunk << 5 | ord(dst));
+      }
+    }
+    // All chunks were skipped: the value is 0 or ~0.
+    if (first)
+      emit32((useMovn ? 0x92800000u : 0xD2800000u) | ord(dst));
+  }
+
+  /// mov dst, src. Neither register may be sp.
+  void movRegToReg(Reg src, Reg dst) {
+    emit32(0xAA0003E0u | ord(src) << 16 | ord(dst));
+  }
+
+  /// add dst, src, #imm. Either register may be sp.
+  void addImm(Reg src, uint32_t imm, Reg dst) {
+    assert(imm < 4096 && "add immediate out of range");
+    emit32(0x91000000u | imm << 10 | ord(src) << 5 | ord(dst));
+  }
+  /// sub dst, src, #imm. Either register may be sp.
+  void subImm(Reg src, uint32_t imm, Reg dst) {
+    assert(imm < 4096 && "sub immediate out of range");
+    emit32(0xD1000000u | imm << 10 | ord(src) << 5 | ord(dst));
+  }
+  /// add dst, src1, src2.
+  void addReg(Reg src1, Reg src2, Reg dst) {
+    emit32(0x8B000000u | ord(src2) << 16 | ord(src1) << 5 | ord(dst));
+  }
+  /// dst = src + offset, for any offset. Clobbers x17 if the offset doesn't
+  /// fit in an immediate.
+  void addOffset(Reg src, int64_t offset, Reg dst) {
+    if (offset >= 0 && offset < 4096) {
+      addImm(src, offset, dst);
+    } else if (offset < 0 && offset > -4096) {
+      subImm(src, -offset, dst);
+    } else {
+      movImm(offset, Reg::x17);
+      addReg(src, Reg::x17, dst);
+    }
+  }
+
+  /// orr dst, src1, src2.
+  void orrReg(Reg src1, Reg src2, Reg dst) {
+    emit32(0xAA000000u | ord(src2) << 16 | ord(src1) << 5 | ord(dst));
+  }
+  /// eor dst, src, #1.
+  void eorOne(Reg src, Reg dst) {
+    emit32(0xD2400000u | ord(src) << 5 | ord(dst));
+  }
+  /// lsr dst, src, #shift.
+  void lsrImm(Reg src, unsigned shift, Reg dst) {
+    assert(shift < 64 && "shift out of range");
+    emit32(0xD340FC00u | shift << 16 | ord(src) << 5 | ord(dst));
+  }
+
+  /// cmp src1, src2 (64-bit).
+  void cmpReg(Reg src1, Reg src2) {
+    emit32(0xEB00001Fu | ord(src2) << 16 | ord(src1) << 5);
+  }
+  /// cmp wsrc1, wsrc2 (32-bit).
+  void cmpRegW(Reg src1, Reg src2) {
+    emit32(0x6B00001Fu | ord(src2) << 16 | ord(src1) << 5);
+  }
+  /// cmp src, #imm (64-bit).
+  void cmpImm(Reg src, uint32_t imm) {
+    assert(imm < 4096 && "cmp immediate out of range");
+    emit32(0xF100001Fu | imm << 10 | ord(src) << 5);
+  }
+  /// cmp wsrc, #imm (32-bit).
+  void cmpImmW(Reg src, uint32_t imm) {
+    assert(imm < 4096 && "cmp immediate out of range");
+    emit32(0x7100001Fu | imm << 10 | ord(src) << 5);
+  }
+  /// tst wsrc, #0xff. Tests a bool returned by a C++ function, whose upper
+  /// bits are unspecified.
+  void tstByte(Reg src) {
+    emit32(0x72001C1Fu | ord(src) << 5);
+  }
+  /// cset wdst, cc. The upper half of dst is cleared.
+  void cset(Cond cc, Reg dst) {
+    emit32(0x1A9F07E0u | (uint32_t)invert(cc) << 12 | ord(dst));
+  }
+
+  /// @name Memory accesses
+  /// Each access picks the scaled unsigned offset form, the unscaled signed
+  /// offset form or, if neither fits, materializes the offset in x17.
+  /// @{
+
+  /// ldr dst, [base, #offset].
+  void ldr(Reg base, int32_t offset, Reg dst) {
+    memAccess(0xF9400000u, 0xF8400000u, 0xF8606800u, 3, base, offset, ord(dst));
+  }
+  /// str src, [base, #offset].
+  void str(Reg src, Reg base, int32_t offset) {
+    memAccess(0xF9000000u, 0xF8000000u, 0xF8206800u, 3, base, offset, ord(src));
+  }
+  /// ldr wdst, [base, #offset].
+  void ldrW(Reg base, int32_t offset, Reg dst) {
+    memAccess(0xB9400000u, 0xB8400000u, 0xB8606800u, 2, base, offset, ord(dst));
+  }
+  /// ldrb wdst, [base, #offset].
+  void ldrb(Reg base, int32_t offset, Reg dst) {
+    memAccess(0x39400000u, 0x38400000u, 0x38606800u, 0, base, offset, ord(dst));
+  }
+  /// ldr ddst, [base, #offset].
+  void ldrD(Reg base, int32_t offset, FReg dst) {
+    memAccess(0xFD400000u, 0xFC400000u, 0xFC606800u, 3, base, offset, ord(dst));
+  }
+  /// str dsrc, [base, #offset].
+  void strD(FReg src, Reg base, int32_t offset) {
+    memAccess(0xFD000000u, 0xFC000000u, 0xFC206800u, 3, base, offset, ord(src));
+  }
+
+  /// str src, [base, #offset]! (pre-indexed).
+  void strPre(Reg src, Reg base, int32_t offset) {
+    assert(offset >= -256 && offset < 256 && "pre-index offset out of range");
+    emit32(0xF8000C00u | ((uint32_t)offset & 0x1FF) << 12 | ord(base) << 5 |
+           ord(src));
+  }
+
+  /// stp src1, src2, [base, #offset]! (pre-indexed).
+  void stpPre(Reg src1, Reg src2, Reg base, int32_t offset) {
+    emit32(0xA9800000u | pairOffset(offset) | ord(src2) << 10 | ord(base) << 5 |
+           ord(src1));
+  }
+  /// stp src1, src2, [base, #offset].
+  void stp(Reg src1, Reg src2, Reg base, int32_t offset) {
+    emit32(0xA9000000u | pairOffset(offset) | ord(src2) << 10 | ord(base) << 5 |
+           ord(src1));
+  }
+  /// ldp dst1, dst2, [base], #offset (post-indexed).
+  void ldpPost(Reg base, int32_t offset, Reg dst1, Reg dst2) {
+    emit32(0xA8C00000u | pairOffset(offset) | ord(dst2) << 10 | ord(base) << 5 |
+           ord(dst1));
+  }
+  /// ldp dst1, dst2, [base, #offset].
+  void ldp(Reg base, int32_t offset, Reg dst1, Reg dst2) {
+    emit32(0xA9400000u | pairOffset(offset) | ord(dst2) << 10 | ord(base) << 5 |
+           ord(dst1));
+  }
+
+  /// @}
+
+  /// fmov ddst, xsrc.
+  void fmovToFP(Reg src, FReg dst) {
+    emit32(0x9E670000u | ord(src) << 5 | ord(dst));
+  }
+  /// fadd dst, src1, src2.
+  void fadd(FReg src1, FReg src2, FReg dst) {
+    fpBinOp(0x1E602800u, src1, src2, dst);
+  }
+  /// fsub dst, src1, src2.
+  void fsub(FReg src1, FReg src2, FReg dst) {
+    fpBinOp(0x1E603800u, src1, src2, dst);
+  }
+  /// fmul dst, src1, src2.
+  void fmul(FReg src1, FReg src2, FReg dst) {
+    fpBinOp(0x1E600800u, src1, src2, dst);
+  }
+  /// fdiv dst, src1, src2.
+  void fdiv(FReg src1, FReg src2, FReg dst) {
+    fpBinOp(0x1E601800u, src1, src2, dst);
+  }
+  /// fmax dst, src1, src2, which is NaN if either operand is, and orders -0
+  /// below +0.
+  void fmax(FReg src1, FReg src2, FReg dst) {
+    fpBinOp(0x1E604800u, src1, src2, dst);
+  }
+  /// fmin dst, src1, src2, which is NaN if either operand is, and orders -0
+  /// below +0.
+  void fmin(FReg src1, FReg src2, FReg dst) {
+    fpBinOp(0x1E605800u, src1, src2, dst);
+  }
+  /// fabs dst, src.
+  void fabs(FReg src, FReg dst) {
+    fpUnOp(0x1E60C000u, src, dst);
+  }
+  /// fsqrt dst, src.
+  void fsqrt(FReg src, FReg dst) {
+    fpUnOp(0x1E61C000u, src, dst);
+  }
+  /// frintm dst, src, which rounds towards minus infinity.
+  void frintm(FReg src, FReg dst) {
+    fpUnOp(0x1E654000u, src, dst);
+  }
+  /// frintp dst, src, which rounds towards plus infinity.
+  void frintp(FReg src, FReg dst) {
+    fpUnOp(0x1E64C000u, src, dst);
+  }
+  /// fcmp src1, src2. An unordered result sets C and V.
+  void fcmp(FReg src1, FReg src2) {
+    emit32(0x1E602000u | ord(src2) << 16 | ord(src1) << 5);
+  }
+
+  /// @name Control flow
+  /// Branch targets must be within the +/-128MB range of B. The conditional
+  /// branches only reach +/-1MB, so they are only used for short local skips.
+  /// @{
+
+  /// b target.
+  void b(const uint8_t *target) {
+    emit32(0x14000000u | branchOffset<26>(target));
+  }
+  /// b.cc target.
+  void bcond(Cond cc, const uint8_t *target) {
+    emit32(0x54000000u | branchOffset<19>(target) << 5 | (uint32_t)cc);
+  }
+  /// cbz wsrc, target.
+  void cbzW(Reg src, const uint8_t *target) {
+    emit32(0x34000000u | branchOffset<19>(target) << 5 | ord(src));
+  }
+  /// cbnz wsrc, target.
+  void cbnzW(Reg src, const uint8_t *target) {
+    emit32(0x35000000u | branchOffset<19>(target) << 5 | ord(src));
+  }
+  /// blr target.
+  void blr(Reg target) {
+    emit32(0xD63F0000u | ord(target) << 5);
+  }
+  /// ret.
+  void ret() {
+    emit32(0xD65F03C0u);
+  }
+  /// udf #0, which always raises an undefined instruction exception.
+  void udf() {
+    emit32(0x00000000u);
+  }
+
+  /// Point the B instruction at \p insn to \p target.
+  static void patchB(uint8_t *insn, const uint8_t *target) {
+    Emitter e{insn};
+    e.b(target);
+  }
+
+  /// @}
+
+ private:
+  uint8_t *out;
+
+  void emit32(uint32_t insn) {
+    numericConst(insn);
+  }
+
+  static uint32_t ord(Reg reg) {
+    return static_cast<uint32_t>(reg);
+  }
+  static uint32_t ord(FReg reg) {
+    return static_cast<uint32_t>(reg);
+  }
+
+  /// \return the imm7 field of a 64-bit load/store pair.
+  static uint32_t pairOffset(int32_t offset) {
+    assert(
+        offset % 8 == 0 && offset >= -512 && offset < 512 &&
+        "pair offset out of range");
+    return ((uint32_t)(offset / 8) & 0x7F) << 15;
+  }
+
+  /// \return the word offset to \p target as a \p bits wide field.
+  template <unsigned bits>
+  uint32_t branchOffset(const uint8_t *target) const {
+    int64_t offset = target - out;
+    assert((offset & 3) == 0 && "misaligned branch target");
+    assert(
+        offset >= -(int64_t(1) << (bits + 1)) &&
+        offset < (int64_t(1) << (bits + 1)) && "branch target out of range");
+    return (uint32_t)(offset >> 2) & ((1u << bits) - 1);
+  }
+
+  /// Emit a load or store of a (1 << sizeLog2)-byte value to or from register
+  /// \p rt.
+  /// \param scaledOp the opcode of the scaled unsigned 12-bit offset form.
+  /// \param unscaledOp the opcode of the unscaled signed 9-bit offset form.
+  /// \param regOp the opcode of the register offset form.
+  void memAccess(
+      uint32_t scaledOp,
+      uint32_t unscaledOp,
+      uint32_t regOp,
+      unsigned sizeLog2,
+      Reg base,
+      int32_t offset,
+      uint32_t rt) {
+    if (offset >= 0 && (offset & ((1 << sizeLog2) - 1)) == 0 &&
+        (offset >> sizeLog2) < 4096) {
+      emit32(
+          scaledOp | (uint32_t)(offset >> sizeLog2) << 10 | ord(base) << 5 |
+          rt);
+    } else if (offset >= -256 && offset < 256) {
+      emit32(
+          unscaledOp | ((uint32_t)offset & 0x1FF) << 12 | ord(base) << 5 |
+          rt);
+    } else {
+      movImm((int64_t)offset, Reg::x17);
+      emit32(regOp | ord(Reg::x17) << 16 | ord(base) << 5 | rt);
+    }
+  }
+
+  void fpBinOp(uint32_t op, FReg src1, FReg src2, FReg dst) {
+    emit32(op | ord(src2) << 16 | ord(src1) << 5 | ord(dst));
+  }
+  void fpUnOp(uint32_t op, FReg src, FReg dst) {
+    emit32(op | ord(src) << 5 | ord(dst));
+  }
+} HERMES_ATTRIBUTE_WARN_UNUSED_RESULT_TYPE;
+
+static_assert(
+    IsTriviallyCopyable<Emitter, true>::value,
+    "Emitter must be trivially copyable");
+
+} // namespace arm64
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_ARM64_EMITTER_H
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_ARM64_JIT_H
+#define HERMES_VM_JIT_ARM64_JIT_H
+
+#include "hermes/Regex/Executor.h"
+#include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/JIT/CodeBudget.h"
+#include "hermes/VM/JIT/ExecHeap.h"
+#include "hermes/VM/JIT/JITRegExp.h"
+#include "hermes/VM/JIT/NativeDisassembler.h"
+
+#include "llvm/ADT/Optional.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+class JITPerfMap;
+class JITProfileCache;
+namespace arm64 {
+
+/// All state related to JIT compilation.
+class JITContext {
+ public:
+  /// Construct a JIT context. No executable memory is allocated before it is
+  /// needed.
+  /// \param enable whether JIT is enabled.
+  /// \param blockSize the size of individual blocks of executable memory to be
+  ///     allocated.
+  /// \param maximum amount of executable memory that can be allocated by the
+  ///     JIT.
+  JITContext(bool enable, size_t blockSize, size_t maxMemory);
+  ~JITContext();
+
+  JITContext(const JITContext &) = delete;
+  void operator=(const JITContext &) = delete;
+
+  /// Compile a function to native code and return the native pointer. If the
+  /// function was previously compiled, return the existing body. If it cannot
+  /// be compiled, return nullptr.
+  inline JITCompiledFunctionPtr compile(Runtime *runtime, CodeBlock *codeBlock);
+
+  /// Count a backward branch to the loop header \p ip in the interpreted
+  /// function \p codeBlock and, if the function is hot enough, compile it and
+  /// return the native code continuing it from that loop header. The native
+  /// code runs the function to completion in the frame the interpreter has
+  /// set up. Otherwise, return nullptr.
+  inline JITCompiledFunctionPtr
+  compileLoop(Runtime *runtime, CodeBlock *codeBlock, const inst::Inst *ip);
+
+  /// \return the JIT state shared by the regexps with \p bytecode. Regexps
+  /// are only compiled on x86-64, so there is none.
+  JITRegExp *getRegExp(llvm::ArrayRef<uint8_t> bytecode) {
+    return nullptr;
+  }
+
+  /// Search with the native code of \p regExp, which is never compiled here.
+  /// \return llvm::None, to search with the interpreter.
+  template <typename CharT>
+  llvm::Optional<regex::MatchRuntimeResult> searchRegExp(
+      JITRegExp *regExp,
+      llvm::ArrayRef<uint8_t> bytecode,
+      const CharT *first,
+      uint32_t start,
+      uint32_t length,
+      std::vector<regex::CapturedRange> *m,
+      regex::constants::MatchFlagType matchFlags) {
+    return llvm::None;
+  }
+
+  /// \return true if JIT compilation is enabled.
+  bool isEnabled() const {
+    return enabled_;
+  }
+
+  /// Enable or disable JIT compilation.
+  void setEnabled(bool enabled) {
+    enabled_ = enabled;
+  }
+
+  /// \return true if functions are compiled on a background thread.
+  bool getBackgroundCompilation() const {
+    return queue_ != nullptr;
+  }
+
+  /// Compile functions on a background thread while the interpreter keeps
+  /// running them, or synchronously, when they get hot.
+  void setBackgroundCompilation(bool background);
+
+  /// Forget the pending compilations and free the compiled code of the
+  /// CodeBlocks owned by \p runtimeModule, which is being destroyed.
+  void cancelCompilations(RuntimeModule *runtimeModule);
+
+  /// Limit the executable memory used by the compiled code to \p bytes. Past
+  /// it, the code of the least recently used functions is freed and they go
+  /// back to the interpreter. 0 means no limit.
+  void setCodeBudget(size_t bytes) {
+    budget_.setLimit(bytes);
+  }
+
+  /// Print the statistics of the executable memory used by the compiled code
+  /// to \p os.
+  void printStats(llvm::raw_ostream &os) const;
+
+  /// \return the executable memory mapped for the compiled code.
+  size_t getExecMemorySize() const {
+    return heap_.getReservedSize();
+  }
+
+  /// Remember the compiled functions of every bytecode file in \p dir, and
+  /// compile them as soon as the bytecode file is loaded again. An empty \p
+  /// dir disables it.
+  void setProfileCacheDir(const std::string &dir);
+
+  /// Compile the functions of \p runtimeModule that were compiled the last
+  /// time its bytecode was run.
+  void loadProfile(Runtime *runtime, RuntimeModule *runtimeModule);
+
+  /// Remember the compiled functions of \p runtimeModule, which is being
+  /// destroyed, for the next launch.
+  void saveProfile(RuntimeModule *runtimeModule);
+
+  /// Describe the compiled code to the Linux perf tool, in
+  /// /tmp/perf-<pid>.map and a jitdump file, or stop describing it.
+  void setPerfMap(bool enable);
+
+  /// \return true if the compiled code is described to the Linux perf tool.
+  bool hasPerfMap() const {
+    return perfMap_ != nullptr;
+  }
+
+  /// Enable or disable dumping JIT'ed Code.
+  void setDumpJITCode(bool dump) {
+    dumpJITCode_ = dump;
+  }
+
+  /// \return true if dumping JIT'ed Code is enabled.
+  bool getDumpJITCode() {
+    return dumpJITCode_;
+  }
+
+  /// Set the number of interpreted calls after which a function is compiled.
+  void setCallThreshold(uint32_t threshold) {
+    callThreshold_ = threshold;
+  }
+
+  /// Set the number of interpreted loop iterations after which a function is
+  /// compiled and entered at the loop header.
+  void setLoopThreshold(uint32_t threshold) {
+    loopThreshold_ = threshold;
+  }
+
+  /// Set the flag to fatally crash on JIT compilation errors.
+  void setCrashOnError(bool crash) {
+    crashOnError_ = crash;
+  }
+
+  /// \return true if we should fatally crash on JIT compilation errors.
+  bool getCrashOnError() {
+    return crashOnError_;
+  }
+
+  /// \return the executable memory heap.
+  ExecHeap &getHeap() {
+    return heap_;
+  }
+
+  /// \return the native disassembler for our target.
+  NativeDisassembler &getDisassembler() {
+    return *dis_;
+  }
+
+ private:
+  /// Slow path that actually performs the compilation of the specified
+  /// CodeBlock.
+  JITCompiledFunctionPtr compileImpl(Runtime *runtime, CodeBlock *codeBlock);
+
+  /// Slow path of compileLoop(), called once the loop is hot enough.
+  JITCompiledFunctionPtr
+  compileLoopImpl(Runtime *runtime, CodeBlock *codeBlock, const inst::Inst *ip);
+
+  /// Install \p code into \p codeBlock and account for its memory.
+  void install(CodeBlock *codeBlock, const JITCompiledCode &code);
+
+  /// Evict the code of cold functions if the compiled code is over budget.
+  void enforceBudget(Runtime *runtime);
+
+  /// Free the executable memory \p blocks of code that is no longer used.
+  void releaseCode(ExecHeap::BlockPair blocks);
+
+ private:
+  /// Whether JIT compilation is enabled.
+  bool enabled_{false};
+  /// Executable heap where all executable code is allocated.
+  ExecHeap heap_;
+  /// whether to dump JIT'ed code
+  bool dumpJITCode_{false};
+  /// whether to fatally crash on JIT compilation errors
+  bool crashOnError_{false};
+
+  /// Compiles functions in the background, if enabled.
+  std::unique_ptr<CompileQueue> queue_{};
+
+  /// The executable memory used by the installed code.
+  CodeBudget budget_{};
+
+  /// Remembers the compiled functions across launches, if enabled.
+  std::unique_ptr<JITProfileCache> profileCache_{};
+
+  /// Describes the installed code to perf, if enabled.
+  std::unique_ptr<JITPerfMap> perfMap_{};
+
+  /// The disassembler for our target.
+  std::unique_ptr<NativeDisassembler> dis_ =
+      NativeDisassembler::create(NativeDisassembler::aarch64_unknown_linux_gnu);
+
+  /// The JIT compile threshold for function execution count
+  uint32_t callThreshold_{0};
+  /// The JIT compile threshold for the loop iterations of a function.
+  uint32_t loopThreshold_{0};
+};
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+inline JITCompiledFunctionPtr JITContext::compile(
+    Runtime *runtime,
+    CodeBlock *codeBlock) {
+  auto ptr = codeBlock->getJITCompiled();
+  if (LLVM_LIKELY(ptr)) {
+    codeBlock->markJITUsed();
+    return ptr;
+  }
+  if (LLVM_LIKELY(!enabled_))
+    return nullptr;
+  if (LLVM_LIKELY(codeBlock->getDontJIT()))
+    return nullptr;
+  if (LLVM_LIKELY(codeBlock->getExecutionCount() < callThreshold_))
+    return nullptr;
+  return compileImpl(runtime, codeBlock);
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+inline JITCompiledFunctionPtr JITContext::compileLoop(
+    Runtime *runtime,
+    CodeBlock *codeBlock,
+    const inst::Inst *ip) {
+  if (LLVM_LIKELY(!enabled_))
+    return nullptr;
+  if (LLVM_UNLIKELY(codeBlock->getDontJIT()))
+    return nullptr;
+  codeBlock->incrementBackEdgeCount();
+  if (LLVM_LIKELY(codeBlock->getBackEdgeCount() < loopThreshold_))
+    return nullptr;
+  return compileLoopImpl(runtime, codeBlock, ip);
+}
+
+} // namespace arm64
+} // namespace vm
+} // namespace hermes
+#endif // HERMES_VM_JIT_ARM64_JIT_H
@@ -578,6 +578,18 @@ class Emitter {
     _opRMToReg<s, scale, 0x8A>(srcBase, srcIndex, srcOffset, dst);
   }
 
+  /// Move the byte or word operand at the given address to the 32-bit \p dst,
+  /// zero extended.
+  template <S s, unsigned scale = 0>
+  void movzxRMToReg(Reg srcBase, Reg srcIndex, int32_t srcOffset, Reg dst) {
+    static_assert(s == S::B || s == S::W, "only B and W are extended");
+    emitREX<S::L>(out, srcBase, srcIndex, ord(dst));
+    *out++ = 0x0F;
+    *out++ = s == S::B ? 0xB6 : 0xB7;
+    EmitModRM<S::L, 0, scale>::emitModRM(
+        out, srcBase, srcIndex, srcOffset, ord(dst));
+  }
+
   template <S s>
   void movImmToReg(typename OperandType<s>::type imm, Reg reg) {
     static_assert(s != S::SLQ, "SLQ not supported");
@@ -661,6 +673,13 @@ class Emitter {
     _opImmToRm<s, scale, 0x80, 7>(imm, dstBase, dstIndex, dstOffset);
   }
 
+  /// Compare \p dst against the operand at the given address, setting the
+  /// flags as for dst - operand.
+  template <S s, unsigned scale = 0>
+  void cmpRmToReg(Reg srcBase, Reg srcIndex, int32_t srcOffset, Reg dst) {
+    _opRMToReg<s, scale, 0x3A>(srcBase, srcIndex, srcOffset, dst);
+  }
+
   template <S s, unsigned scale = 0>
   void testImmToRM(
       typename OperandType<s>::type imm,
@@ -742,6 +761,14 @@ class Emitter {
     _opImmToRm<s, ScaleRegAccess, 0x83, 6>(imm, reg, Reg::none, 0);
   }
   template <S s, unsigned scale = 0>
+  void addImmToRM(
+      typename OperandType<s>::type imm,
+      Reg dstBase,
+      Reg dstIndex,
+      int32_t dstOffset) {
+    _opImmToRm<s, scale, 0x80, 0>(imm, dstBase, dstIndex, dstOffset);
+  }
+  template <S s, unsigned scale = 0>
   void xorImmToRM(
       typename OperandType<s>::type imm,
       Reg dstBase,
@@ -795,10 +822,24 @@ class Emitter {
     emitConst(out, imm);
   }
 
+  /// shift \p reg to the left by \p imm bits
+  void shlImm8ToReg(typename OperandType<S::B>::type imm, Reg reg) {
+    emitREX<S::Q>(out, reg, Reg::none, 4);
+    *out++ = 0xc1;
+    *out++ = ModeSel<AddrMode::Reg>::modRM(reg, 4);
+    emitConst(out, imm);
+  }
+
   void retq() {
     *out++ = 0xc3;
   }
 
+  /// Emit an instruction that raises an invalid opcode exception.
+  void ud2() {
+    *out++ = 0x0F;
+    *out++ = 0x0B;
+  }
+
   void call(const uint8_t *target) {
     auto offset = target - out - 5;
     assert(isInt32(offset) && "operand must be 32-bit");
@@ -987,6 +1028,11 @@ class Emitter {
     _fpRMToReg<scale, fp, 0x59>(srcBase, srcIndex, srcOffset, dst);
   }
 
+  template <unsigned scale = 0, FP fp = FP::Double>
+  void sqrtfpRMToReg(Reg srcBase, Reg srcIndex, int32_t srcOffset, Reg dst) {
+    _fpRMToReg<scale, fp, 0x51>(srcBase, srcIndex, srcOffset, dst);
+  }
+
   template <unsigned scale = 0, FP fp = FP::Double>
   void ucomisRMToReg(Reg srcBase, Reg srcIndex, int32_t srcOffset, Reg dst) {
     _dpfpRMToReg<scale, fp, 0x2E>(srcBase, srcIndex, srcOffset, dst);
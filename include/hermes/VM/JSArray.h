@@ -41,6 +41,19 @@ class ArrayImpl : public JSObject {
   /// into.
   using StorageType = BigStorage;
 
+  /// What is known about the elements in storage, from the most to the least
+  /// specific. The elements are always stored as HermesValues, which already
+  /// hold doubles unboxed, so the kind only tells the fast paths which checks
+  /// they can skip.
+  enum class ElementKind : uint8_t {
+    /// No element is empty, and every element is a number.
+    PackedNumber,
+    /// No element is empty.
+    Packed,
+    /// Some elements are empty.
+    Holey,
+  };
+
   /// Resize the internal storage. The ".length" property is not affected. It
   /// does \b NOT check for read-only properties.
   static ExecutionStatus setStorageEndIndex(
@@ -69,6 +82,8 @@ class ArrayImpl : public JSObject {
   /// "empty" are assumed to exist for the purpose of this definition. This is
   /// only safe to do for arrays that were created by the caller, can be
   /// extended, are not sealed or frozen, and were never passed to user JS code.
+  /// Since the array is being initialized, the write barrier is skipped when
+  /// the GC allows it.
   static void unsafeSetExistingElementAt(
       ArrayImpl *self,
       Runtime *runtime,
@@ -81,9 +96,51 @@ class ArrayImpl : public JSObject {
     assert(
         index >= self->beginIndex_ && index < self->endIndex_ &&
         "array index out of range");
-    self->indexedStorage_.getNonNull(runtime)
-        ->at(index - self->beginIndex_)
-        .set(value, &runtime->getHeap());
+    auto &elem = self->indexedStorage_.getNonNull(runtime)->at(
+        self->toStorageIndex(index));
+    self->noteElementWrite(elem, value);
+    elem.initialize(value, &runtime->getHeap());
+  }
+
+  /// Overwrite the elements starting at index \p index, which must exist and
+  /// be empty, with the non-empty values [\p first, \p last) in bulk.
+  static void unsafeSetExistingElements(
+      ArrayImpl *self,
+      Runtime *runtime,
+      size_type index,
+      GCHermesValue *first,
+      GCHermesValue *last) {
+    assert(!self->flags_.noExtend && "this array cannot be extended");
+    assert(
+        index >= self->beginIndex_ &&
+        (size_type)(last - first) <= self->endIndex_ - index &&
+        "array index out of range");
+    self->indexedStorage_.getNonNull(runtime)->setRange(
+        runtime, self->toStorageIndex(index), first, last);
+    self->numEmpty_ -= last - first;
+    for (auto *it = first; it != last && self->onlyNumbers_; ++it)
+      self->noteNewElement(*it);
+  }
+
+  /// Overwrite the element at index \p index with \p value, if the element
+  /// exists in storage and the array is not frozen. This neither resizes the
+  /// storage nor looks at the prototype chain, so holes are not filled in.
+  /// \return true if the element was set.
+  bool trySetExistingElement(
+      Runtime *runtime,
+      size_type index,
+      HermesValue value) {
+    if (LLVM_UNLIKELY(flags_.frozen) || index < beginIndex_ ||
+        index >= endIndex_) {
+      return false;
+    }
+    auto &elem = indexedStorage_.getNonNull(runtime)->at(toStorageIndex(index));
+    if (elem.isEmpty()) {
+      return false;
+    }
+    noteElementWrite(elem, value);
+    elem.set(value, &runtime->getHeap());
+    return true;
   }
 
   /// Set the element at index \p index to empty. This does not affect the
@@ -96,6 +153,27 @@ class ArrayImpl : public JSObject {
     return _deleteOwnIndexedImpl(selfHandle, runtime, index);
   }
 
+  /// Remove the first \p count elements, moving every other element down by
+  /// \p count indices. Only the start of the storage moves, so this takes
+  /// amortized time proportional to \p count. The ".length" property of a
+  /// \c JSArray is not affected.
+  /// \pre the array can be extended, its begin index is 0 and \p count is at
+  ///   most its end index.
+  static void shiftElements(
+      Handle<ArrayImpl> selfHandle,
+      Runtime *runtime,
+      size_type count);
+
+  /// Move every element up by \p count indices, leaving the first \p count
+  /// elements empty. Room is reserved at the start of the storage in
+  /// proportion to its size, so this also takes amortized time proportional to
+  /// \p count. The ".length" property of a \c JSArray is not affected.
+  /// \pre the array can be extended and its begin index is 0.
+  static ExecutionStatus unshiftElements(
+      Handle<ArrayImpl> selfHandle,
+      Runtime *runtime,
+      size_type count);
+
   /// \return the first index of the array.
   size_type getBeginIndex() const {
     return beginIndex_;
@@ -106,11 +184,26 @@ class ArrayImpl : public JSObject {
     return endIndex_;
   }
 
+  /// \return what is known about the elements in storage.
+  ElementKind getElementKind() const {
+    if (numEmpty_)
+      return ElementKind::Holey;
+    return onlyNumbers_ ? ElementKind::PackedNumber : ElementKind::Packed;
+  }
+
+  /// \return true if every index below \p length holds a plain data element
+  /// in storage, so that they can be read without checking for holes or
+  /// looking at the prototype chain.
+  bool isPackedUpTo(uint64_t length) const {
+    return hasFastIndexProperties() && numEmpty_ == 0 && beginIndex_ == 0 &&
+        endIndex_ >= length;
+  }
+
   /// Return the value at index \p index, or \c empty if the index is not
   /// contained in the storage.
   const HermesValue at(Runtime *runtime, size_type index) const {
     return index >= beginIndex_ && index < endIndex_
-        ? indexedStorage_.getNonNull(runtime)->at(index - beginIndex_)
+        ? indexedStorage_.getNonNull(runtime)->at(toStorageIndex(index))
         : HermesValue::encodeEmptyValue();
   }
 
@@ -227,10 +320,59 @@ class ArrayImpl : public JSObject {
 
   /// Return the value at index \p index, which must be valid.
   const HermesValue unsafeAt(Runtime *runtime, size_type index) const {
-    return indexedStorage_.getNonNull(runtime)->at(index - beginIndex_);
+    return indexedStorage_.getNonNull(runtime)->at(toStorageIndex(index));
   }
 
  private:
+  /// A new element this close to the storage is always stored in it, with the
+  /// elements in between empty.
+  static constexpr uint32_t kMaxDenseGap = 1024;
+  /// A new element further away is only stored in the storage if the empty
+  /// elements in between are at most this many times the number of elements.
+  static constexpr uint32_t kMaxSparseness = 4;
+
+  /// \return the position in storage of the element at index \p index.
+  size_type toStorageIndex(size_type index) const {
+    return index - beginIndex_ + storageOffset_;
+  }
+
+  /// \return true if a new element at \p index, which is outside of the
+  /// storage, is too far away from the other elements to be stored in it.
+  bool isSparseIndex(Runtime *runtime, uint32_t index) const;
+
+  /// Move the elements which were stored as named properties, because they
+  /// were too far away from the others, into the storage now that it spans
+  /// them. Once no property with an index-like name is left, the fast paths
+  /// for indexed properties apply again.
+  static void absorbIndexLikeProperties(
+      Handle<ArrayImpl> selfHandle,
+      Runtime *runtime);
+
+  /// Update the element kind for the element \p oldValue in storage being
+  /// replaced with \p newValue.
+  void noteElementWrite(HermesValue oldValue, HermesValue newValue) {
+    if (oldValue.isEmpty() != newValue.isEmpty()) {
+      if (newValue.isEmpty())
+        ++numEmpty_;
+      else
+        --numEmpty_;
+    }
+    if (!newValue.isEmpty() && !newValue.isNumber())
+      onlyNumbers_ = false;
+  }
+
+  /// Update the element kind for \p value being stored in a new element.
+  void noteNewElement(HermesValue value) {
+    if (!value.isNumber())
+      onlyNumbers_ = false;
+  }
+
+  /// Update the element kind for the storage becoming empty.
+  void resetElementKind() {
+    numEmpty_ = 0;
+    onlyNumbers_ = true;
+  }
+
   /// The first index contained in the storage.
   uint32_t beginIndex_{0};
   /// One past the last index contained in the storage.
@@ -238,6 +380,16 @@ class ArrayImpl : public JSObject {
   /// The indexed property storage. It can be nullptr, if both its capacity and
   /// size are 0.
   GCPointer<StorageType> indexedStorage_;
+  /// The number of empty slots at the start of the storage which hold no
+  /// element, left by shiftElements() or reserved by unshiftElements(), so
+  /// that elements can be removed and added at the front like in a deque. The
+  /// storage size is always storageOffset_ + endIndex_ - beginIndex_.
+  uint32_t storageOffset_{0};
+  /// The number of empty elements in the storage.
+  uint32_t numEmpty_{0};
+  /// Whether every element in the storage which isn't empty is a number. It is
+  /// only set again when the storage is emptied.
+  bool onlyNumbers_{true};
 };
 
 class Arguments final : public ArrayImpl {
@@ -309,13 +461,15 @@ class JSArray final : public ArrayImpl {
 
   /// Create an instance of Array, with [[Prototype]] initialized with
   /// \p prototypeHandle, with capacity for \p capacity elements and actual size
-  /// \p length.
+  /// \p length.  If \p pretenure is true, the array and its storage are
+  /// allocated directly in the long-lived part of the heap.
   static CallResult<HermesValue> create(
       Runtime *runtime,
       Handle<JSObject> prototypeHandle,
       Handle<HiddenClass> classHandle,
       size_type capacity = 0,
-      size_type length = 0);
+      size_type length = 0,
+      bool pretenure = false);
 
   static CallResult<HermesValue> create(
       Runtime *runtime,
@@ -339,8 +493,11 @@ class JSArray final : public ArrayImpl {
 
   /// Create an instance of Array, using the standard array prototype, with
   /// capacity for \p capacity elements and actual size \p length.
-  static CallResult<PseudoHandle<JSArray>>
-  create(Runtime *runtime, size_type capacity, size_type length);
+  static CallResult<PseudoHandle<JSArray>> create(
+      Runtime *runtime,
+      size_type capacity,
+      size_type length,
+      bool pretenure = false);
 
   /// A convenience method for setting the \c .length property of the array.
   /// It performs the necessary checks and updates the property. It could fail
@@ -435,6 +592,14 @@ class JSArrayIterator : public JSObject {
       Handle<JSArrayIterator> self,
       Runtime *runtime);
 
+  /// Iterate to the next element and store it in \p value, without creating
+  /// an iterator result object.
+  /// \return false if the iteration has ended.
+  static CallResult<bool> nextValue(
+      Handle<JSArrayIterator> self,
+      Runtime *runtime,
+      MutableHandle<> &value);
+
  private:
 #ifdef HERMESVM_SERIALIZE
   explicit JSArrayIterator(Deserializer &d);
@@ -11,6 +11,8 @@
 #include "hermes/VM/JSObject.h"
 #include "hermes/VM/Runtime.h"
 
+#include <functional>
+
 namespace hermes {
 namespace vm {
 
@@ -54,13 +56,28 @@ class JSArrayBuffer final : public JSObject {
       size_type count);
 
   /// Creates a data block of size \p size for this JSArrayBuffer to hold.
-  /// Replaces the currently used data block.
+  /// Replaces the currently used data block. Zeroed blocks of at least
+  /// \c kMinMappedSize bytes are mapped from the OS, which zeroes their pages
+  /// when they are first touched instead of all of them up front.
   /// \p zero if true, zero out the data in the block, else leave it
   ///   uninitialized.
   /// \return ExecutionStatus::RETURNED iff the allocation was successful.
   ExecutionStatus
   createDataBlock(Runtime *runtime, size_type size, bool zero = true);
 
+  /// Make the \p size bytes at \p data, which belong to the embedder, the
+  /// data block of this buffer, replacing the currently used one. They are
+  /// used in place rather than copied, and are credited to the GC as external
+  /// memory. \p release is called when the buffer is detached or finalized,
+  /// after which the bytes are no longer accessed, or before returning if
+  /// they could not be used.
+  /// \return ExecutionStatus::RETURNED iff the bytes were used.
+  ExecutionStatus setExternalDataBlock(
+      Runtime *runtime,
+      uint8_t *data,
+      size_type size,
+      std::function<void()> release);
+
   /// Retrieves a pointer to the held buffer.
   /// \return A pointer to the buffer owned by this object. This can be null
   ///   if the ArrayBuffer is empty.
@@ -82,9 +99,16 @@ class JSArrayBuffer final : public JSObject {
     return attached_;
   }
 
+  /// Whether the data block belongs to the embedder, which is told when it
+  /// is released.
+  bool hasExternalDataBlock() const {
+    return externalRelease_;
+  }
+
   /// Detaches this buffer from its data block, effectively freeing the storage
   /// and setting this ArrayBuffer to have zero size.  The \p gc argument allows
-  /// the GC to be informed of this external memory deletion.
+  /// the GC to be informed of this external memory deletion. A data block that
+  /// belongs to the embedder is released instead.
   void detach(GC *gc);
 
  protected:
@@ -95,9 +119,18 @@ class JSArrayBuffer final : public JSObject {
   static void _snapshotAddNodesImpl(GCCell *cell, GC *gc, HeapSnapshot &snap);
 
  private:
+  /// The smallest zeroed data block which is mapped from the OS rather than
+  /// allocated with calloc.
+  static constexpr size_type kMinMappedSize = 1 << 20;
+
   uint8_t *data_;
   size_type size_;
   bool attached_;
+  /// Whether the data block was mapped from the OS, and must be unmapped.
+  bool mapped_;
+  /// Releases the data block if it belongs to the embedder, null otherwise.
+  /// It lives outside the cell, which the GC may move.
+  std::function<void()> *externalRelease_;
 
 #ifdef HERMESVM_SERIALIZE
   explicit JSArrayBuffer(Deserializer &d);
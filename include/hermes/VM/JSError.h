@@ -71,6 +71,9 @@ class JSError final : public JSObject {
   /// stack. If the top call frame indicates a JS callee, but the codeBlock and
   /// ip are not supplied, return without doing anything. This handles the case
   /// when an exception is thrown from within the current code block.
+  /// Only the location and callee of each frame are recorded, up to the
+  /// runtime's maximum stack trace depth. The function names, source locations
+  /// and the string are computed when the stack property is first read.
   ///
   /// \param skipTopFrame don't record the topmost frame. This is used when
   ///   we want to skip the Error() constructor itself.
@@ -140,9 +143,10 @@ class JSError final : public JSObject {
   /// A list of Domains which are referenced by the stacktrace_.
   GCPointer<ArrayStorage> domains_;
 
-  /// If not null, an array of function names as the 'name' property of the
-  /// Callables. This is parallel to the stack trace array.
-  GCPointer<PropStorage> funcNames_;
+  /// If not null, an array of the Callables on the stack, or undefined for
+  /// frames without one, whose 'name' property is used as the function name.
+  /// This is parallel to the stack trace array.
+  GCPointer<PropStorage> callees_;
 
   /// If true, JS catch and finally blocks will be run after this error is
   /// thrown. Else, there will be no more JS executed after this error is
@@ -21,6 +21,10 @@
 #include <memory>
 
 namespace hermes {
+namespace hbc {
+class BCProvider;
+} // namespace hbc
+
 namespace vm {
 
 // External forward declarations.
@@ -47,6 +51,17 @@ void createHermesBuiltins(
 std::shared_ptr<RuntimeCommonStorage> createRuntimeCommonStorage(
     bool shouldTrace);
 
+/// Compile the given source \p utf8code as eval code, using the given
+/// \p scopeChain to resolve identifiers, without running it. If
+/// \p singleFunction is set, require that the output be only a single
+/// function. \return the bytecode, whose global function takes the
+/// environment the code is evaluated in.
+CallResult<std::shared_ptr<hbc::BCProvider>> compileEvalCode(
+    Runtime *runtime,
+    llvm::StringRef utf8code,
+    const ScopeChain &scopeChain,
+    bool singleFunction);
+
 /// eval() entry point. Evaluate the given source \p utf8code within the given
 /// \p environment, using the given \p scopeChain to resolve identifiers.
 /// \p thisArg is the initial "this" value of the function being evaluated.
@@ -100,7 +100,7 @@ int32_t weekDay(double t);
 // ES5.1 15.9.1.7
 
 /// Local time zone offset, explicitly not including DST offset.
-/// TODO: Cache this value to avoid recomputing every time.
+/// LocalTimeOffsetCache caches this value for a Runtime.
 double localTZA();
 
 //===----------------------------------------------------------------------===//
@@ -124,6 +124,44 @@ double localTime(double t);
 /// Spec refers to this as the UTC() function.
 double utcTime(double t);
 
+/// Caches the local time zone adjustment and the daylight saving adjustment of
+/// the last range of times looked up, so that converting many nearby times
+/// between UTC and local time doesn't query libc for each of them.
+class LocalTimeOffsetCache {
+ public:
+  /// \return localTZA(), computed on the first call after a reset().
+  double localTZA();
+
+  /// \return daylightSavingTA(t), reusing the cached range when \p t falls in
+  /// it or close enough to extend it.
+  double daylightSavingTA(double t);
+
+  /// Forget all cached values, e.g. after the time zone has changed.
+  void reset();
+
+ private:
+  /// The largest distance, in milliseconds, by which the cached range is
+  /// extended without checking for a DST transition in between. No time zone
+  /// changes its DST adjustment twice in this interval.
+  static constexpr double kMaxRangeExtension = 19 * 24 * 3600 * 1000.0;
+
+  /// Whether ltza_ holds the value of localTZA().
+  bool hasLocalTZA_{false};
+  double ltza_{0};
+
+  /// All the times in [dstStart_, dstEnd_] have the DST adjustment dstOffset_.
+  /// The range is empty when dstStart_ > dstEnd_.
+  double dstStart_{1};
+  double dstEnd_{0};
+  double dstOffset_{0};
+};
+
+/// Conversion from UTC to local time, using the offsets in \p cache.
+double localTime(double t, LocalTimeOffsetCache &cache);
+
+/// Conversion from local time to UTC, using the offsets in \p cache.
+double utcTime(double t, LocalTimeOffsetCache &cache);
+
 //===----------------------------------------------------------------------===//
 // ES5.1 15.9.1.10
 
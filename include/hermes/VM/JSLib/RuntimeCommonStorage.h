@@ -12,6 +12,7 @@
 #if __APPLE__
 #include <CoreFoundation/CoreFoundation.h>
 #endif
+#include "hermes/VM/JSLib/DateUtil.h"
 #include "hermes/VM/MockedEnvironment.h"
 
 #include "llvm/ADT/Optional.h"
@@ -44,6 +45,9 @@ struct RuntimeCommonStorage {
   std::minstd_rand randomEngine_;
   bool randomEngineSeeded_ = false;
 
+  /// Time zone offsets used by Date to convert between UTC and local time.
+  LocalTimeOffsetCache localTimeOffsetCache;
+
 #if __APPLE__
   /// \return a reference to the locale to use for collation, date formatting,
   /// etc. The caller must CFRelease this.
@@ -20,7 +20,9 @@ CallResult<HermesValue> runtimeJSONParse(
     Handle<StringPrimitive> jsonString,
     Handle<Callable> reviver);
 
-/// Alternative interface to runtimeJSONParse for strings outside the JS heap.
+/// Alternative interface to runtimeJSONParse for strings outside the JS heap,
+/// such as UTF8 input converted by \p s as it is parsed, where malformed UTF8
+/// is a SyntaxError.
 CallResult<HermesValue> runtimeJSONParseRef(Runtime *runtime, UTF16Stream &&s);
 
 /// Returns a String in JSON format representing an ECMAScript value,
@@ -61,9 +61,28 @@ class JSMapImpl final : public JSObject {
     return static_cast<bool>(storage_);
   }
 
-  /// Advance iterator and return the next.
-  HashMapEntry *iteratorNext(Runtime *runtime, HashMapEntry *entry) {
-    return storage_.get(runtime)->iteratorNext(runtime, entry);
+  /// Advance the iteration position (\p epoch, \p index) to the next entry,
+  /// as OrderedHashMap::iteratorNext(). \return true if there is one.
+  static CallResult<bool> iteratorNext(
+      Handle<JSMapImpl> self,
+      Runtime *runtime,
+      MutableHandle<ArrayStorage> &epoch,
+      uint32_t &index) {
+    return OrderedHashMap::iteratorNext(
+        runtime->makeHandle<OrderedHashMap>(self->storage_),
+        runtime,
+        epoch,
+        index);
+  }
+
+  /// \return the key of the entry at \p index.
+  HermesValue getKey(Runtime *runtime, uint32_t index) {
+    return storage_.get(runtime)->getKey(runtime, index);
+  }
+
+  /// \return the value of the entry at \p index.
+  HermesValue getValue(Runtime *runtime, uint32_t index) {
+    return storage_.get(runtime)->getValue(runtime, index);
   }
 
   /// Add a value.
@@ -109,9 +128,10 @@ class JSMapImpl final : public JSObject {
   }
 
   /// Clear all elements from the storage.
-  static void clear(Handle<JSMapImpl> self, Runtime *runtime) {
+  static ExecutionStatus clear(Handle<JSMapImpl> self, Runtime *runtime) {
     self->assertInitialized();
-    self->storage_.get(runtime)->clear(runtime);
+    return OrderedHashMap::clear(
+        runtime->makeHandle<OrderedHashMap>(self->storage_), runtime);
   }
 
   /// Call \p callbackfn for each entry, with \p thisArg as this.
@@ -121,22 +141,28 @@ class JSMapImpl final : public JSObject {
       Handle<Callable> callbackfn,
       Handle<> thisArg) {
     self->assertInitialized();
-    MutableHandle<HashMapEntry> entry{runtime};
-    for (entry = self->storage_.get(runtime)->iteratorNext(runtime); entry;
-         entry =
-             self->storage_.get(runtime)->iteratorNext(runtime, entry.get())) {
-      HermesValue key = entry->key;
-      HermesValue value = entry->value;
+    PreparedCall callback{runtime, callbackfn, thisArg, 3};
+    if (LLVM_UNLIKELY(callback.overflowed())) {
+      return runtime->raiseStackOverflow(
+          Runtime::StackOverflowKind::NativeStack);
+    }
+    MutableHandle<ArrayStorage> epoch{runtime};
+    GCScopeMarkerRAII marker{runtime};
+    for (uint32_t index = 0;; ++index) {
+      marker.flush();
+      auto nextRes = iteratorNext(self, runtime, epoch, index);
+      if (LLVM_UNLIKELY(nextRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (!*nextRes)
+        break;
+      HermesValue key = self->getKey(runtime, index);
+      HermesValue value = self->getValue(runtime, index);
       assert(!key.isEmpty() && "Invalid key encountered");
       assert(!value.isEmpty() && "Invalid value encountered");
       if (LLVM_UNLIKELY(
-              Callable::executeCall3(
-                  callbackfn,
-                  runtime,
-                  thisArg,
-                  value,
-                  key,
-                  self.getHermesValue()) == ExecutionStatus::EXCEPTION)) {
+              callback.call(value, key, self.getHermesValue()) ==
+              ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
     }
@@ -211,51 +237,72 @@ class JSMapIteratorImpl final : public JSObject {
       Handle<JSMapIteratorImpl> self,
       Runtime *runtime) {
     MutableHandle<> value{runtime};
-    if (!self->iterationFinished_) {
-      // Iteration has not yet reached the end previously.
-      assert(self->data_ && "Storage uninitialized");
-      // Advance the iterator.
-      self->itr_.set(
-          runtime,
-          self->data_.get(runtime)->iteratorNext(
-              runtime, self->itr_.get(runtime)),
-          &runtime->getHeap());
-      if (self->itr_) {
-        switch (self->iterationKind_) {
-          case IterationKind::Key:
-            value = self->itr_.get(runtime)->key;
-            break;
-          case IterationKind::Value:
-            value = self->itr_.get(runtime)->value;
-            break;
-          case IterationKind::Entry: {
-            // If we are iterating both key and value, we need to create an
-            // array.
-            auto arrRes = JSArray::create(runtime, 2, 2);
-            if (arrRes == ExecutionStatus::EXCEPTION) {
-              return ExecutionStatus::EXCEPTION;
-            }
-            auto arrHandle = toHandle(runtime, std::move(*arrRes));
-            value = self->itr_.get(runtime)->key;
-            JSArray::setElementAt(arrHandle, runtime, 0, value);
-            value = self->itr_.get(runtime)->value;
-            JSArray::setElementAt(arrHandle, runtime, 1, value);
-            value = arrHandle.getHermesValue();
-            break;
-          };
-          case IterationKind::NumKinds:
-            llvm_unreachable("Invalid iteration kind");
-            return HermesValue::encodeEmptyValue();
+    auto nextRes = nextValue(self, runtime, value);
+    if (LLVM_UNLIKELY(nextRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    return createIterResultObject(runtime, value, !*nextRes).getHermesValue();
+  }
+
+  /// Iterate to the next element and store it in \p value, without creating
+  /// an iterator result object.
+  /// \return false if the iteration has ended.
+  static CallResult<bool> nextValue(
+      Handle<JSMapIteratorImpl> self,
+      Runtime *runtime,
+      MutableHandle<> &value) {
+    value = HermesValue::encodeUndefinedValue();
+    if (self->iterationFinished_) {
+      // Iteration has already reached the end previously.
+      return false;
+    }
+    assert(self->data_ && "Storage uninitialized");
+    // Advance the iterator.
+    MutableHandle<ArrayStorage> epoch{runtime, self->epoch_.get(runtime)};
+    uint32_t index = self->index_;
+    auto nextRes = JSMapImpl<JSMapTypeTraits<C>::ContainerKind>::iteratorNext(
+        runtime->makeHandle(self->data_), runtime, epoch, index);
+    if (LLVM_UNLIKELY(nextRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    self->epoch_.set(runtime, epoch.get(), &runtime->getHeap());
+    self->index_ = index + 1;
+    if (!*nextRes) {
+      // If the next element in the iterator is invalid, we have
+      // reached the end.
+      self->iterationFinished_ = true;
+      self->data_ = nullptr;
+      self->epoch_ = nullptr;
+      return false;
+    }
+    switch (self->iterationKind_) {
+      case IterationKind::Key:
+        value = self->data_.get(runtime)->getKey(runtime, index);
+        return true;
+      case IterationKind::Value:
+        value = self->data_.get(runtime)->getValue(runtime, index);
+        return true;
+      case IterationKind::Entry: {
+        // If we are iterating both key and value, we need to create an
+        // array.
+        auto arrRes = JSArray::create(runtime, 2, 2);
+        if (arrRes == ExecutionStatus::EXCEPTION) {
+          return ExecutionStatus::EXCEPTION;
         }
-      } else {
-        // If the next element in the iterator is invalid, we have
-        // reached the end.
-        self->iterationFinished_ = true;
-        self->data_ = nullptr;
-      }
+        auto arrHandle = toHandle(runtime, std::move(*arrRes));
+        value = self->data_.get(runtime)->getKey(runtime, index);
+        JSArray::setElementAt(arrHandle, runtime, 0, value);
+        value = self->data_.get(runtime)->getValue(runtime, index);
+        JSArray::setElementAt(arrHandle, runtime, 1, value);
+        value = arrHandle.getHermesValue();
+        return true;
+      };
+      case IterationKind::NumKinds:
+        llvm_unreachable("Invalid iteration kind");
+        return false;
     }
-    return createIterResultObject(runtime, value, self->iterationFinished_)
-        .getHermesValue();
+    llvm_unreachable("Invalid iteration kind");
+    return false;
   }
 
   /// Build the metadata for this map implementation, and store it into \p mb.
@@ -281,8 +328,12 @@ class JSMapIteratorImpl final : public JSObject {
   /// initialized or the iteration has ended.
   GCPointer<JSMapImpl<JSMapTypeTraits<C>::ContainerKind>> data_{nullptr};
 
-  /// Iteration pointer to the element storage in the Map.
-  GCPointer<HashMapEntry> itr_{nullptr};
+  /// The compaction epoch of the Map storage that index_ refers to, or
+  /// nullptr before the first element.
+  GCPointer<ArrayStorage> epoch_{nullptr};
+
+  /// The index of the next entry to visit in the Map storage.
+  uint32_t index_{0};
 
   IterationKind iterationKind_;
 
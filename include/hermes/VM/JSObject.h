@@ -13,6 +13,7 @@
 #include "hermes/VM/HermesValue-inline.h"
 #include "hermes/VM/HiddenClass.h"
 #include "hermes/VM/Operations.h"
+#include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/PropertyDescriptor.h"
 #include "hermes/VM/TypesafeFlags.h"
 #include "hermes/VM/VTable.h"
@@ -308,6 +309,7 @@ struct ObjectVTable {
 /// available.
 class JSObject : public GCCell {
   friend void ObjectBuildMeta(const GCCell *cell, Metadata::Builder &mb);
+  friend struct JSObjectOffsets;
 
  protected:
   /// A light-weight constructor which performs no GC allocations. Its purpose
@@ -371,21 +373,31 @@ class JSObject : public GCCell {
   /// If allocation fails, the GC declares an OOM.
   static PseudoHandle<JSObject> create(Runtime *runtime);
 
+  /// Constructs a JSObject with the standard Object prototype in \p mem, which
+  /// must be freshly allocated heap memory of cellSize<JSObject>() bytes (for
+  /// example bump-allocated inline by the JIT).  Does not allocate.
+  static PseudoHandle<JSObject> createInPlace(Runtime *runtime, void *mem);
+
   /// Attempts to allocate a JSObject with the standard Object prototype and
   /// property storage preallocated. If allocation fails, the GC declares an
   /// OOM.
   /// \param propertyCount number of property storage slots preallocated.
+  /// \param pretenure whether to allocate the object directly in the long-lived
+  ///   part of the heap, see AllocationSite.
   static PseudoHandle<JSObject> create(
       Runtime *runtime,
-      unsigned propertyCount);
+      unsigned propertyCount,
+      bool pretenure = false);
 
   /// Allocates a JSObject with the given hidden class and property storage
   /// preallocated. If allocation fails, the GC declares an
   /// OOM.
   /// \param clazz the hidden class for the new object.
+  /// \param pretenure as above.
   static PseudoHandle<JSObject> create(
       Runtime *runtime,
-      Handle<HiddenClass> clazz);
+      Handle<HiddenClass> clazz,
+      bool pretenure = false);
 
   /// Attempts to allocate a JSObject and returns whether it succeeded or not.
   /// NOTE: This function always returns \c ExecutionStatus::RETURNED, it is
@@ -432,6 +444,18 @@ class JSObject : public GCCell {
     return flags_.hostObject;
   }
 
+  /// \return true if this object has indexed storage, where the properties
+  /// with index-like names may be.
+  bool hasIndexedStorage() const {
+    return flags_.indexedStorage;
+  }
+
+  /// \return true if this object has indexed storage and no index-like named
+  /// properties, so that indexed accesses only need to look at the storage.
+  bool hasFastIndexProperties() const {
+    return flags_.fastIndexProperties;
+  }
+
   /// \return the `__proto__` internal property, which may be nullptr.
   JSObject *getParent(Runtime *runtime) const {
     return parent_.get(runtime);
@@ -458,6 +482,15 @@ class JSObject : public GCCell {
       Runtime *runtime,
       Handle<JSObject> lazyObject);
 
+  /// Make the builtin constructor \p cons and its prototype \p proto lazy, so
+  /// that their properties are only defined by \p init when either of them is
+  /// first used. Neither object may have properties yet.
+  static void makeLazyBuiltin(
+      Runtime *runtime,
+      Handle<JSObject> cons,
+      Handle<JSObject> proto,
+      void (*init)(Runtime *runtime, Handle<JSObject> cons));
+
   /// Get the objectID, which must already have been assigned using \c
   /// getObjectID().
   ObjectID getAlreadyAssignedObjectID() const {
@@ -524,6 +557,27 @@ class JSObject : public GCCell {
         self, runtime, index, value);
   }
 
+  /// Give the plain object \p selfHandle, whose class is a dictionary, the
+  /// regular class with the same properties in the same order, moving the
+  /// property values to the slots of that class. This lets objects which
+  /// became dictionaries, e.g. by deleting a property, share a class and be
+  /// cached again once they are only read.
+  /// \return true if the class of the object was replaced.
+  static bool tryLeaveDictionaryMode(
+      Handle<JSObject> selfHandle,
+      Runtime *runtime);
+
+  /// Copy all the properties of the plain object \p source to \p selfHandle
+  /// at once, by giving it the class of \p source and a copy of its slots.
+  /// The class of \p source must not be a dictionary, and its properties must
+  /// all be enumerable, writable and configurable data properties.
+  /// \return false, without copying anything, if \p selfHandle isn't a new
+  ///   extensible plain object without properties.
+  static CallResult<bool> tryAdoptClassAndSlots(
+      Handle<JSObject> selfHandle,
+      Runtime *runtime,
+      Handle<JSObject> source);
+
   /// By default, returns a list of enumerable property names and symbols
   /// belonging to this object. Indexed property names will be represented as
   /// numbers for efficiency. The order of properties follows ES2015 - first
@@ -603,6 +657,25 @@ class JSObject : public GCCell {
       SlotIndex index,
       HermesValue value);
 
+  /// Store a value to the "named value" storage space by \p index, while
+  /// initializing the object \p self, which was just created. The write
+  /// barrier is skipped when the GC allows it.
+  static void initNamedSlotValue(
+      JSObject *self,
+      Runtime *runtime,
+      SlotIndex index,
+      HermesValue value);
+
+  /// Store the values [\p first, \p last) to the "named value" storage space
+  /// of the object \p self, which was just created, starting from the first
+  /// slot, with at most two copies and without write barriers when the GC
+  /// allows it.
+  static void initNamedSlotValues(
+      JSObject *self,
+      Runtime *runtime,
+      GCHermesValue *first,
+      GCHermesValue *last);
+
   /// Store a value to the "named value" storage space by the slot described by
   /// \p desc.
   static void setNamedSlotValue(
@@ -700,6 +773,28 @@ class JSObject : public GCCell {
   static OptValue<HermesValue>
   tryGetNamedNoAlloc(JSObject *self, PointerBase *base, SymbolID name);
 
+  /// Look up a property load that \p cacheEntry cached as found on a
+  /// prototype, by checking the classes of the objects on the prototype chain
+  /// of \p self. If \p selfLacksProperty, the caller has already established
+  /// that \p self does not have the property, and its class is not checked.
+  /// \return the object holding the property at cacheEntry.protoSlot, or
+  /// nullptr if the entry does not apply to \p self.
+  static JSObject *getCachedPrototypeHolder(
+      JSObject *self,
+      PointerBase *base,
+      const PropertyCacheEntry &cacheEntry,
+      bool selfLacksProperty = false);
+
+  /// Cache in \p cacheEntry that a load of a property from \p self found it
+  /// at \p slot in \p holder, if the prototype chain between them allows it.
+  /// \pre holder is on the prototype chain of self, and is not self.
+  static void cachePrototypeLoad(
+      JSObject *self,
+      PointerBase *base,
+      JSObject *holder,
+      SlotIndex slot,
+      PropertyCacheEntry *cacheEntry);
+
   /// ES5.1 8.12.1.
   /// \param nameValHandle the name of the property. It must be a primitive.
   static CallResult<bool> getOwnComputedPrimitiveDescriptor(
@@ -1200,6 +1295,16 @@ class JSObject : public GCCell {
       SymbolID name,
       NamedPropertyDescriptor &desc);
 
+  /// Look for a property like \c findProperty(), when its position isn't
+  /// needed, and store its descriptor in \p desc.
+  /// \return true if the property was found.
+  static bool findPropertyDescriptor(
+      Handle<JSObject> selfHandle,
+      Runtime *runtime,
+      SymbolID name,
+      PropertyFlags expectedFlags,
+      NamedPropertyDescriptor &desc);
+
   /// ES5.1 8.12.9.
   static CallResult<bool> addOwnProperty(
       Handle<JSObject> selfHandle,
@@ -1439,6 +1544,36 @@ inline void JSObject::setNamedSlotValue(
       .set(value, &runtime->getHeap());
 }
 
+inline void JSObject::initNamedSlotValue(
+    JSObject *self,
+    Runtime *runtime,
+    SlotIndex index,
+    HermesValue value) {
+  if (LLVM_LIKELY(index < DIRECT_PROPERTY_SLOTS))
+    return self->directProps_[index].initialize(value, &runtime->getHeap());
+
+  self->propStorage_.get(runtime)
+      ->at(index - DIRECT_PROPERTY_SLOTS)
+      .initialize(value, &runtime->getHeap());
+}
+
+inline void JSObject::initNamedSlotValues(
+    JSObject *self,
+    Runtime *runtime,
+    GCHermesValue *first,
+    GCHermesValue *last) {
+  auto *mid = first + std::min<ptrdiff_t>(last - first, DIRECT_PROPERTY_SLOTS);
+  GCHermesValue::uninitialized_copy(
+      first, mid, self->directProps_, &runtime->getHeap());
+  if (mid != last) {
+    GCHermesValue::uninitialized_copy(
+        mid,
+        last,
+        self->propStorage_.get(runtime)->data(),
+        &runtime->getHeap());
+  }
+}
+
 inline HermesValue JSObject::getComputedSlotValue(
     JSObject *self,
     Runtime *runtime,
@@ -1477,7 +1612,8 @@ inline bool JSObject::getOwnNamedDescriptor(
     Runtime *runtime,
     SymbolID name,
     NamedPropertyDescriptor &desc) {
-  return findProperty(selfHandle, runtime, name, desc).hasValue();
+  return findPropertyDescriptor(
+      selfHandle, runtime, name, PropertyFlags::invalid(), desc);
 }
 
 inline OptValue<bool> JSObject::tryGetOwnNamedDescriptorFast(
@@ -1489,6 +1625,33 @@ inline OptValue<bool> JSObject::tryGetOwnNamedDescriptorFast(
       self->clazz_.getNonNull(runtime), runtime, name, desc);
 }
 
+inline JSObject *JSObject::getCachedPrototypeHolder(
+    JSObject *self,
+    PointerBase *base,
+    const PropertyCacheEntry &cacheEntry,
+    bool selfLacksProperty) {
+  unsigned depth = cacheEntry.protoDepth;
+  if (!depth ||
+      (!selfLacksProperty &&
+       self->clazz_.getStorageType() != cacheEntry.protoClazz[0])) {
+    return nullptr;
+  }
+  JSObject *obj = self;
+  for (unsigned level = 1; level <= depth; ++level) {
+    // A lazy object has no properties until it is initialized, and a host
+    // object may have any, so neither can be assumed to lack the property.
+    if (LLVM_UNLIKELY(obj->flags_.lazyObject || obj->flags_.hostObject)) {
+      return nullptr;
+    }
+    obj = obj->parent_.get(base);
+    if (!obj ||
+        obj->clazz_.getStorageType() != cacheEntry.protoClazz[level]) {
+      return nullptr;
+    }
+  }
+  return obj;
+}
+
 inline OptValue<HermesValue>
 JSObject::tryGetNamedNoAlloc(JSObject *self, PointerBase *base, SymbolID name) {
   for (JSObject *curr = self; curr; curr = curr->parent_.get(base)) {
@@ -1591,6 +1754,20 @@ inline OptValue<HiddenClass::PropertyPos> JSObject::findProperty(
       desc);
 }
 
+inline bool JSObject::findPropertyDescriptor(
+    Handle<JSObject> selfHandle,
+    Runtime *runtime,
+    SymbolID name,
+    PropertyFlags expectedFlags,
+    NamedPropertyDescriptor &desc) {
+  return HiddenClass::findPropertyDescriptor(
+      createPseudoHandle(selfHandle->clazz_.getNonNull(runtime)),
+      runtime,
+      name,
+      expectedFlags,
+      desc);
+}
+
 inline bool JSObject::shouldCacheForIn(Runtime *runtime) const {
   return !clazz_.get(runtime)->isDictionary() && !flags_.indexedStorage &&
       !flags_.hostObject;
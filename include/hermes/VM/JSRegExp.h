@@ -18,6 +18,8 @@
 namespace hermes {
 namespace vm {
 
+struct JITRegExp;
+
 class JSRegExp final : public JSObject {
  public:
   using Super = JSObject;
@@ -132,6 +134,10 @@ class JSRegExp final : public JSObject {
   uint8_t *bytecode_{};
   uint32_t bytecodeSize_{0};
 
+  /// The JIT state shared by the regexps with the same bytecode, looked up on
+  /// the first search when the JIT is enabled.
+  JITRegExp *jitRegExp_{nullptr};
+
   FlagBits flagBits_ = {};
 
   // Finalizer to clean up stored native regex
@@ -14,6 +14,8 @@
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/WeakRef.h"
 
+#include <vector>
+
 namespace hermes {
 namespace vm {
 
@@ -166,8 +168,8 @@ class JSWeakMapImplBase : public JSObject {
     self->~JSWeakMapImplBase();
   }
 
-  /// Mark weak references and set hasFreeableSlots_ if invalidated slots
-  /// were found.
+  /// Mark weak references, and record the keys of the entries whose
+  /// references were invalidated in freeableKeys_.
   static void _markWeakImpl(GCCell *cell, WeakRefAcceptor &acceptor);
 
   static size_t _mallocSizeImpl(GCCell *cell) {
@@ -177,11 +179,14 @@ class JSWeakMapImplBase : public JSObject {
 
   /// \return the number of bytes allocated by this object on the heap.
   size_t getMallocSize() const {
-    return map_.getMemorySize();
+    return map_.getMemorySize() +
+        freeableKeys_.capacity() * sizeof(decltype(freeableKeys_)::value_type);
   }
 
-  /// Iterate the slots in map_ and call deleteInternal on any invalid
-  /// references, adding all available slots to the free list.
+  /// Call deleteInternal on the entries with invalid references, adding all
+  /// available slots to the free list.  Only the entries recorded in
+  /// freeableKeys_ are examined, unless none were recorded since the map was
+  /// deserialized.
   void findAndDeleteFreeSlots(PointerBase *base);
 
   /// Erase the map entry and corresponding valueStorage entry
@@ -219,6 +224,14 @@ class JSWeakMapImplBase : public JSObject {
   /// Next index to use when the free list runs out of elements.
   uint32_t nextIndex_{0};
 
+  /// The keys of the entries whose references markWeakRefs found invalid, so
+  /// that deleting them costs time proportional to their number rather than
+  /// to the size of the map.  Rebuilt every time the weak refs are marked,
+  /// which happens before any slot can be freed, so the slots of keys that
+  /// were deleted from map_ meanwhile are still valid to compare against.
+  /// Not serialized.
+  std::vector<WeakRefKey> freeableKeys_;
+
   /// This is set to true when markWeakRefs sees an invalid slot which can be
   /// freed later.
   /// When set to true, the WeakMap should look for free slots the next time
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_LARGEOBJECTSPACENC_H
+#define HERMES_VM_LARGEOBJECTSPACENC_H
+
+#include "hermes/VM/AlignedHeapSegment.h"
+#include "hermes/VM/AllocResult.h"
+#include "hermes/VM/GCCell.h"
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+class GenGC;
+struct FullMSCUpdateAcceptor;
+
+/// A space for variable-sized cells that are too large to be worth copying,
+/// such as the backing stores of large arrays.  Every cell is allocated at the
+/// start of a segment of its own, obtained from the storage provider, and
+/// never moves: young-gen collections do not evacuate it, and full collections
+/// do not compact it.  Once the cell dies, its segment is handed back to the
+/// storage provider as a whole.
+///
+/// The segments are registered in the GC's segment index, so marking and the
+/// write barriers treat them like old-gen segments.  Pointers into the young
+/// generation are found by scanning their dirty cards in young-gen
+/// collections; since a segment holds a single cell, the card object
+/// boundaries are not needed.
+///
+/// The cells are charged to the old generation as external memory, rounded up
+/// to whole pages, so that they count towards its occupancy and the heap size
+/// limit as if they were allocated in it.
+class LargeObjectSpace {
+ public:
+  explicit LargeObjectSpace(GenGC *gc) : gc_(gc) {}
+
+  /// Variable-sized cells at least this large are allocated in this space when
+  /// it is enabled.  Smaller ones would waste most of their segment.
+  static constexpr uint32_t kMinAllocSize = AlignedHeapSegment::maxSize() / 16;
+
+  /// \return the external memory charged to the old generation for a cell of
+  /// \p size bytes.
+  static size_t chargeForSize(uint32_t size);
+
+  /// Allocate an uninitialized cell of \p size bytes in a fresh segment, and
+  /// charge it to the old generation.  The cards of the cell are dirtied, as
+  /// it may be initialized without write barriers.  \return a failure if no
+  /// storage could be obtained.
+  AllocResult alloc(uint32_t size);
+
+  /// The external memory currently charged for the cells of this space.
+  size_t externalCharge() const {
+    return externalCharge_;
+  }
+
+  /// The number of cells (and segments) in this space.
+  size_t numCells() const {
+    return segments_.size();
+  }
+
+  /// Call \p callback on every cell in this space.
+  void forAllObjs(const std::function<void(GCCell *)> &callback);
+
+  /// Clear the mark bits of the segments.
+  void clearMarkBits();
+
+  /// Find the pointers into the young generation in the dirty cards of the
+  /// cells, and evacuate their referents.  Cleans the cards.
+  void markYoungGenPointers();
+
+  /// In a full collection, after marking and finalization: remove the external
+  /// memory charge of the unmarked cells, and install a forwarding pointer to
+  /// itself in every marked cell, recording its displaced VTable.
+  void sweep();
+
+  /// In a full collection, update the pointers in the marked cells using \p
+  /// acceptor.
+  void updateReferences(FullMSCUpdateAcceptor *acceptor);
+
+  /// In a full collection, once references are updated: put back the VTables
+  /// of the marked cells, and release the segments of the unmarked ones.
+  void compact();
+
+  /// See OldGen::updateCardTablesAfterCompaction.
+  void updateCardTablesAfterCompaction(bool youngIsEmpty);
+
+#ifndef NDEBUG
+  unsigned numAllocatedObjects() const {
+    return numAllocatedObjects_;
+  }
+
+  unsigned numReachableObjects() const {
+    return numReachableObjects_;
+  }
+
+  void resetNumReachableObjects() {
+    numReachableObjects_ = 0;
+  }
+
+  /// After a full collection, only the surviving cells remain allocated.
+  void resetNumAllocatedObjects() {
+    numAllocatedObjects_ = segments_.size();
+  }
+#endif
+
+#ifdef HERMES_SLOW_DEBUG
+  void checkWellFormed(const GenGC *gc) const;
+#endif
+
+ private:
+  /// \return the cell occupying \p segment.
+  static GCCell *cellIn(const AlignedHeapSegment &segment) {
+    return reinterpret_cast<GCCell *>(segment.start());
+  }
+
+  /// Update the GC's segment index after segments_ has been modified.
+  void segmentsMoved();
+
+  /// The name given to the memory mapping for segments of this space.
+  static const char *kSegmentName;
+
+  GenGC *gc_;
+
+  /// The segments, one per cell, in allocation order.
+  std::vector<AlignedHeapSegment> segments_;
+
+  /// The VTables of the marked cells, displaced by forwarding pointers during
+  /// a full collection, in the order of segments_.
+  std::vector<const VTable *> displacedVTables_;
+
+  /// The sum of chargeForSize over the cells in this space.
+  size_t externalCharge_{0};
+
+#ifndef NDEBUG
+  unsigned numAllocatedObjects_{0};
+  unsigned numReachableObjects_{0};
+#endif
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_LARGEOBJECTSPACENC_H
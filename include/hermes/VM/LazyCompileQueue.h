@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_LAZYCOMPILEQUEUE_H
+#define HERMES_VM_LAZYCOMPILEQUEUE_H
+
+#ifndef HERMESVM_LEAN
+#include "hermes/BCGen/HBC/Bytecode.h"
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+#include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace hermes {
+namespace vm {
+
+/// Compiles lazy functions on a worker thread before they are first called,
+/// so that the call finds their bytecode ready instead of compiling it on the
+/// thread running the interpreter. The worker thread is created lazily, by the
+/// first enqueued function.
+///
+/// All the lazy functions of a source share the compiler state of its
+/// Context, even across runtimes, so every compilation holds the compiler
+/// lock of the source's \c hbc::LazyFunctionCache: \c take() compiles on the
+/// calling thread when the function isn't ready, after the worker is done
+/// with the one it may be compiling.
+class LazyCompileQueue {
+ public:
+  LazyCompileQueue() = default;
+
+  /// Discards the pending compilations, waits for the one in progress and
+  /// joins the worker thread.
+  ~LazyCompileQueue();
+
+  LazyCompileQueue(const LazyCompileQueue &) = delete;
+  LazyCompileQueue &operator=(const LazyCompileQueue &) = delete;
+
+  /// Compile the lazy function \p lazyFunction on the worker thread, unless
+  /// it is already queued or compiled. \p provider owns \p lazyFunction, and
+  /// \p root is the module of its source, whose compiler lock is held during
+  /// the compilation. Both are kept alive until the result is taken or
+  /// cancelled.
+  void enqueue(
+      std::shared_ptr<hbc::BCProvider> root,
+      std::shared_ptr<hbc::BCProvider> provider,
+      hbc::BytecodeFunction *lazyFunction);
+
+  /// \return the bytecode of the lazy function with the data \p lazyData,
+  /// compiled by the worker if it got to it, or on the calling thread, holding
+  /// the compiler lock of \p cache, otherwise.
+  std::unique_ptr<hbc::BytecodeModule> take(
+      hbc::LazyFunctionCache &cache,
+      hbc::LazyCompilationData *lazyData);
+
+  /// Forget the compilation of the lazy function with the data \p lazyData,
+  /// whose CodeBlock is being destroyed, waiting for the worker if it is
+  /// compiling it.
+  void cancel(hbc::LazyCompilationData *lazyData);
+
+  /// Block until every function enqueued so far has been compiled.
+  void waitUntilIdle();
+
+ private:
+  /// A function which was enqueued and hasn't been taken yet.
+  struct Entry {
+    /// Keeps the module of the source, and so its compiler lock, alive.
+    std::shared_ptr<hbc::BCProvider> root;
+    /// Keeps the lazy function, and so the key of the entry, alive.
+    std::shared_ptr<hbc::BCProvider> provider;
+    /// The compiled bytecode, once the worker is done.
+    std::unique_ptr<hbc::BytecodeModule> result{};
+  };
+
+  /// The loop run by the worker thread.
+  void workerLoop();
+
+  /// Protects entries_, pending_, running_ and shouldExit_.
+  std::mutex mtx_;
+
+  /// Signalled when work is enqueued or the worker should exit.
+  std::condition_variable workAvailable_;
+
+  /// Signalled when the worker has finished a compilation.
+  std::condition_variable compiled_;
+
+  /// Every function which was enqueued and hasn't been taken or cancelled.
+  llvm::DenseMap<hbc::LazyCompilationData *, Entry> entries_{};
+
+  /// Functions waiting to be compiled, in order.
+  std::deque<hbc::LazyCompilationData *> pending_{};
+
+  /// The function the worker is compiling, if any.
+  hbc::LazyCompilationData *running_{nullptr};
+
+  /// Whether the worker thread should exit.
+  bool shouldExit_{false};
+
+  std::thread worker_;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMESVM_LEAN
+#endif // HERMES_VM_LAZYCOMPILEQUEUE_H
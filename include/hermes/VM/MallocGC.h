@@ -9,6 +9,7 @@
 #define HERMES_VM_MALLOCGC_H
 
 #include "hermes/Public/GCConfig.h"
+#include "hermes/VM/AllocationSite.h"
 #include "hermes/VM/GCBase.h"
 #include "hermes/VM/GCCell.h"
 
@@ -177,6 +178,21 @@ class MallocGC final : public GCBase {
   template <HasFinalizer hasFinalizer = HasFinalizer::No>
   inline void *allocLongLived(uint32_t size);
 
+  /// Same as above, for objects pretenured because of their allocation site.
+  /// NOTE: this does nothing different for MallocGC, but does for GenGC.
+  template <HasFinalizer hasFinalizer = HasFinalizer::No>
+  inline void *allocPretenured(uint32_t size) {
+    return alloc<true, hasFinalizer>(size);
+  }
+
+  /// Allocation sites are never pretenured in this collector, since it has
+  /// no generations.
+  bool isPretenuringEnabled() const {
+    return false;
+  }
+
+  void sampleAllocationSite(GCCell *, AllocationSite *) {}
+
   /// Returns whether an external allocation of the given \p size fits
   /// within the maximum heap size.  (Note that this does not guarantee that the
   /// allocation will "succeed" -- the size plus the used() of the heap may
@@ -188,6 +204,11 @@ class MallocGC final : public GCBase {
   /// weak pointers that point to dead objects.
   void collect();
 
+  /// Collect, which frees the dead objects.  Every cell is malloc'd, so there
+  /// is no further memory to release at any \p level.
+  /// \return the number of bytes of dead objects that were freed.
+  size_t notifyMemoryPressure(MemoryPressureLevel level);
+
   static constexpr uint32_t maxAllocationSize() {
     // MallocGC imposes no limit on individual allocations.
     return std::numeric_limits<uint32_t>::max();
@@ -196,6 +217,13 @@ class MallocGC final : public GCBase {
   /// Run the finalizers for all objects.
   void finalizeAll();
 
+  /// Like finalizeAll(), but only run the finalizers which are observable
+  /// outside the runtime, or which free a large block of native memory (see
+  /// GCBase::finalizeForFastTeardown()). The memory the others would free is
+  /// leaked.
+  /// \return the number of bytes of native memory leaked.
+  uint64_t finalizeObservable();
+
   /// \return true iff this is collecting the entire heap, or false if it is
   /// only a portion of the heap.
   /// \pre Assumes inGC() is true, or else this has no meaning.
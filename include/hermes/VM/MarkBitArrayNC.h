@@ -15,6 +15,8 @@
 
 #include "llvm/Support/MathExtras.h"
 
+#include <atomic>
+
 namespace hermes {
 namespace vm {
 
@@ -56,6 +58,11 @@ class MarkBitArrayNC {
   /// range of the array.
   inline void mark(size_t ind);
 
+  /// Like mark, but safe to call concurrently with other calls to markAtomic
+  /// on the same array.  Returns true iff this call changed the bit from 0 to
+  /// 1, i.e. exactly one of several racing callers observes true.
+  inline bool markAtomic(size_t ind);
+
   /// Clears the bit array.
   inline void clear();
 
@@ -147,6 +154,20 @@ void MarkBitArrayNC::mark(size_t ind) {
   bitArray_[ind / kBitsPerVal] |= (size_t)1 << (ind % kBitsPerVal);
 }
 
+bool MarkBitArrayNC::markAtomic(size_t ind) {
+  assert(
+      ind < kValidIndices &&
+      "precondition: ind must be within the index range");
+  static_assert(
+      sizeof(std::atomic<size_t>) == sizeof(size_t),
+      "Mark bit words must be usable as atomics in place");
+
+  const size_t bit = (size_t)1 << (ind % kBitsPerVal);
+  auto *word =
+      reinterpret_cast<std::atomic<size_t> *>(&bitArray_[ind / kBitsPerVal]);
+  return !(word->fetch_or(bit, std::memory_order_relaxed) & bit);
+}
+
 void MarkBitArrayNC::clear() {
   ::memset(bitArray_, 0, sizeof(bitArray_));
 }
@@ -14,6 +14,7 @@
 #include "hermes/VM/CardTableNC.h"
 #include "hermes/VM/CompactionResult.h"
 #include "hermes/VM/CompleteMarkState.h"
+#include "hermes/VM/FreeListNC.h"
 #include "hermes/VM/GCGeneration.h"
 #include "hermes/VM/GCSegmentRange-inline.h"
 #include "hermes/VM/GCSegmentRange.h"
@@ -192,7 +193,12 @@ class OldGen : public GCGeneration {
   /// @}
 
   /// Assumes the generation owns its allocation context.  Attempts to allocate
-  /// in that; if that fails, calls allocSlow.
+  /// in a free region left by the last full collection, then in the context;
+  /// if that fails, calls allocSlow.
+  ///
+  /// Only allocations made directly in the generation may use the free
+  /// regions: promotion must allocate contiguously, as the young-gen
+  /// transitive closure scans the promoted objects in allocation order.
   inline AllocResult alloc(uint32_t size, HasFinalizer hasFinalizer);
 
   /// A location in the old gen: a pair of a segment index, and a
@@ -248,10 +254,22 @@ class OldGen : public GCGeneration {
   ///     quota could be met, immediately following this call.
   bool ensureFits(size_t amount);
 
+  /// Give the segments retained to serve future materializations back to the
+  /// storage provider.  \return the number of bytes of storage released.
+  size_t releaseSegmentCache();
+
   /// Find all pointers in the current generation that point into
   /// youngGen, and apply the current mark function to them.
   void markYoungGenPointers(Location originalLevel);
 
+  /// Same as markYoungGenPointers, but the dirty cards of the segments are
+  /// scanned by \p numThreads threads, which collect the slots holding
+  /// young-gen pointers.  The referents are then evacuated on the calling
+  /// thread, as promotion allocates in this generation.
+  void markYoungGenPointersParallel(
+      Location originalLevel,
+      unsigned numThreads);
+
   /// Complete an in-progress young-gen collection.  Some number of
   /// young-gen objects have been found reachable and promoted into
   /// the current generation (e.g., by root or card scanning).  The
@@ -290,9 +308,23 @@ class OldGen : public GCGeneration {
   void verifyCardTableBoundaries() const;
 #endif
 
-  /// See GCGeneration.h for more information.
+  /// See GCGeneration.h for more information.  The leading segments that are
+  /// at least kSweepInPlaceMinLiveFraction live are swept in place (see
+  /// AlignedHeapSegment::sweepInPlace), so that compaction does not copy their
+  /// contents only to close a few gaps; the gaps are added to the free list
+  /// instead.  Segments from the first fragmented one onward are compacted as
+  /// usual.
   void sweepAndInstallForwardingPointers(GC *gc, SweepResult *sweepResult);
 
+  /// The fraction of a segment's allocated bytes that must be live for it to
+  /// be swept in place, rather than compacted.
+  static constexpr double kSweepInPlaceMinLiveFraction = 0.75;
+
+  /// The free regions left between live objects by the last full collection.
+  const FreeList &freeList() const {
+    return freeList_;
+  }
+
   /// See GCGeneration.h for more information.
   void updateReferences(GC *gc, SweepResult::VTablesRemaining &vTables);
 
@@ -391,6 +423,11 @@ class OldGen : public GCGeneration {
   /// segment, collection, etc).
   void updateCardTableBoundary();
 
+  /// Allocate \p size bytes in a region of the free list, putting a
+  /// FillerCell in whatever is left of the region.  \return a failure if no
+  /// region fits.
+  AllocResult allocFromFreeList(uint32_t size, HasFinalizer hasFinalizer);
+
   /// Slow path for allocation: allocation in the current allocation
   /// segment failed.  Attempt in the next segment, if one exists,
   /// returning a failure if no it does not.
@@ -426,6 +463,10 @@ class OldGen : public GCGeneration {
   /// The minimum and maximum sizes of the current generation.
   const Size sz_;
 
+  /// The free regions between the live objects of segments swept in place by
+  /// the last full collection.
+  FreeList freeList_;
+
   /// The segments in the old generation that are filled with allocations, but
   /// are not currently being allocated into.
   std::deque<AlignedHeapSegment> filledSegments_;
@@ -481,6 +522,12 @@ size_t OldGen::Size::minSegments() const {
 
 AllocResult OldGen::alloc(uint32_t size, HasFinalizer hasFinalizer) {
   assert(ownsAllocContext());
+  if (LLVM_UNLIKELY(!freeList_.empty())) {
+    AllocResult result = allocFromFreeList(size, hasFinalizer);
+    if (result.success) {
+      return result;
+    }
+  }
   AllocResult result = allocRaw(size, hasFinalizer);
   if (LLVM_LIKELY(result.success)) {
     return result;
@@ -229,6 +229,14 @@ bool isPrimitive(HermesValue val);
 CallResult<HermesValue>
 addOp_RJS(Runtime *runtime, Handle<> xHandle, Handle<> yHandle);
 
+/// Convert the \p count values starting at \p args to strings, in order, and
+/// \return their concatenation. The length and the representation (ASCII or
+/// UTF-16) of the result are known before it is allocated, so it is built
+/// without intermediate strings. The converted strings replace the values in
+/// \p args, which must be rooted.
+CallResult<HermesValue>
+stringConcat_RJS(Runtime *runtime, PinnedHermesValue *args, uint32_t count);
+
 /// ES9.0 12.6.4
 inline double expOp(double x, double y) {
   constexpr double nan = std::numeric_limits<double>::quiet_NaN();
@@ -269,6 +277,17 @@ inline char16_t letterToLower(char16_t c) {
 /// \returns the double that results, and NaN on failure.
 double parseIntWithRadix(const StringView str, int radix);
 
+/// Parse the unsigned decimal number at the start of \p str into \p result,
+/// when it has few enough digits to be converted exactly without strtod().
+/// See hermes::parseDecimalFast().
+/// \return the number of characters parsed, or 0 if there is no such number.
+uint32_t parseDecimalFast(const StringView str, double &result);
+
+/// Parse the decimal digits at the start of \p str into \p result, when
+/// their value is at most 2**53. See hermes::parseDecimalIntegerFast().
+/// \return the number of digits parsed, or 0 if there are none.
+uint32_t parseDecimalIntegerFast(const StringView str, double &result);
+
 /// Takes a finite double \p number and a base \p radix (between 2 and 36
 /// inclusive), and returns the string that results from converting \p number
 /// into a string in base \p radix.
@@ -11,78 +11,32 @@
 #include "hermes/Support/ErrorHandling.h"
 #include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/Runtime.h"
+#include "hermes/VM/SegmentedArray.h"
+
+#include "llvm/ADT/ArrayRef.h"
 
 #include <vector>
 
 namespace hermes {
 namespace vm {
 
-/// HashMapEntry is a gc-managed entry in the OrderedHashMap.
-/// We use HashMapEntry to form two separate linked lists,
-/// one that tracks the insertion order for iteration purpose, one
-/// tracks the list of entries in a hash table bucket for hash operations.
-class HashMapEntry final : public GCCell {
- public:
-  static VTable vt;
-
-  /// The key.
-  GCHermesValue key;
-
-  /// The value.
-  GCHermesValue value;
-
-  /// Previous entry in insertion order.
-  GCPointer<HashMapEntry> prevIterationEntry{nullptr};
-
-  /// Next entry in insertion order.
-  GCPointer<HashMapEntry> nextIterationEntry{nullptr};
-
-  /// Next entry in the hash table bucket.
-  GCPointer<HashMapEntry> nextEntryInBucket{nullptr};
-
-  static bool classof(const GCCell *cell) {
-    return cell->getKind() == CellKind::HashMapEntryKind;
-  }
-
-  static CallResult<HermesValue> create(Runtime *runtime);
-
-  /// Indicates whether this entry has been deleted.
-  bool isDeleted() const {
-    assert(key.isEmpty() == value.isEmpty() && "Inconsistent deleted status");
-    return value.isEmpty();
-  }
-
-  /// Mark this entry as deleted.
-  void markDeleted() {
-    key.setNonPtr(HermesValue::encodeEmptyValue());
-    value.setNonPtr(HermesValue::encodeEmptyValue());
-  }
-
- protected:
-#ifdef HERMESVM_SERIALIZE
-  explicit HashMapEntry(Deserializer &d);
-
-  friend void HashMapEntryDeserialize(Deserializer &d, CellKind kind);
-#endif
-
-  HashMapEntry(Runtime *runtime) : GCCell(&runtime->getHeap(), &vt) {}
-}; // HashMapEntry
-
 /// OrderedHashMap is a gc-managed hash map that maintains insertion order.
-/// The map contains two conceptual parts: a standard chained hash table,
-/// to store and lookup HermesValue; a linked list to maintain the insertion
-/// order.
-/// When an element is added, it's always appended to the end of the linked
-/// list. When an element is deleted, we mark it as deleted and remove it
-/// from the linked list, unless it's the last element.
-/// Iterators are pointers to the entries, which are always linked according
-/// to insertion order.
-/// When the size of the hash table becomes unreasonably large or small
-/// comparing to the number of alive elements, we will rehash the table.
-/// We always make sure that any entry at any moment can successfully find
-/// the next entry according to insertion order, and rely on GC to manage
-/// the "deleted" entries", free them when no more iterators are before
-/// that entry.
+/// The entries are stored in insertion order as consecutive key/value pairs
+/// of a SegmentedArray, so that a large map is a few fixed size segments for
+/// the GC to scan rather than an object per entry. A native open addressing
+/// table, of twice the number of stored entries at least, maps the hashes of
+/// the keys to the indices of their entries.
+/// Deleting an entry leaves a tombstone, whose key and value are empty, in
+/// its place. When tombstones make up half of the stored entries as the index
+/// table fills up, or three quarters after a deletion, the map is compacted:
+/// the entries that are left move down over the tombstones and the index
+/// table is rebuilt.
+/// Iteration positions are entry indices, which compaction would invalidate.
+/// Once iterated, the map tracks compaction epochs: each compaction records,
+/// in the epoch it ends, the former indices of the entries that survived it,
+/// so that the position of an iterator in any earlier epoch can be brought to
+/// the current one. The records are only reachable from the iterators that
+/// need them.
 class OrderedHashMap final : public GCCell {
   friend void OrderedHashMapBuildMeta(
       const GCCell *cell,
@@ -111,11 +65,6 @@ class OrderedHashMap final : public GCCell {
   static HermesValue
   get(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
 
-  /// Lookup \p key in the table and \return the value if exists.
-  /// Otherwise \return nullptr.
-  static HashMapEntry *
-  find(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
-
   /// Insert a key/value pair into the map, if not already existing.
   static ExecutionStatus insert(
       Handle<OrderedHashMap> self,
@@ -127,77 +76,109 @@ class OrderedHashMap final : public GCCell {
   static bool
   erase(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
 
-  /// Clear the map.  The \p gc parameter is necessary for write barriers.
-  void clear(Runtime *runtime);
+  /// Clear the map.
+  static ExecutionStatus clear(Handle<OrderedHashMap> self, Runtime *runtime);
 
   /// \return the size of the map.
   uint32_t size() const {
     return size_;
   }
 
-  /// \return the next element in insertion order.
-  /// If \p entry is nullptr, we are starting the iteration from the first
-  /// entry that is not deleted.
-  /// Otherwise, we look for the next element after \p entry that is not
-  /// deleted.
-  HashMapEntry *iteratorNext(Runtime *runtime, HashMapEntry *entry = nullptr)
-      const;
-
- protected:
-  OrderedHashMap(Runtime *runtime, Handle<ArrayStorage> hashTableStorage);
+  /// Find the first entry that is not deleted at or after the entry \p index
+  /// of the compaction epoch \p epoch, or of the first entry if \p epoch is
+  /// null. Update \p epoch to the current epoch and \p index to the found
+  /// entry, or to the end of the entries if there is none.
+  /// \return true if an entry was found.
+  static CallResult<bool> iteratorNext(
+      Handle<OrderedHashMap> self,
+      Runtime *runtime,
+      MutableHandle<ArrayStorage> &epoch,
+      uint32_t &index);
 
- private:
-  /// The hashtable, with size always equal to capacity_. The number of
-  /// reachable entries from hashTable_ should be equal to size_.
-  GCPointer<ArrayStorage> hashTable_{nullptr};
+  /// \return the key of the entry at \p index.
+  HermesValue getKey(PointerBase *base, uint32_t index) const {
+    return entries_.getNonNull(base)->at(index * 2);
+  }
 
-  /// The first entry ever inserted. We need this entry to begin an iteration.
-  GCPointer<HashMapEntry> firstIterationEntry_{nullptr};
+  /// \return the value of the entry at \p index.
+  HermesValue getValue(PointerBase *base, uint32_t index) const {
+    return entries_.getNonNull(base)->at(index * 2 + 1);
+  }
 
-  /// The last entry inserted. We need it to add new elements afterwards.
-  GCPointer<HashMapEntry> lastIterationEntry_{nullptr};
+ protected:
+  OrderedHashMap(Runtime *runtime, Handle<SegmentedArray> entries);
 
-  /// Initial capacity of the hash table.
-  static constexpr uint32_t INITIAL_CAPACITY = 16;
+  static void _finalizeImpl(GCCell *cell, GC *gc) {
+    auto *self = vmcast<OrderedHashMap>(cell);
+    self->~OrderedHashMap();
+  }
 
-  /// Maximum capacity cannot exceed the maximum capacity of the underlying
-  /// ArrayStorage.
-  // It needs to be less than 1/4th the max 32-bit integer in order to use an
-  // integer-based load factor check of 0.75.
-  /// TODO(T31421960): Use constexpr std::min.
-  static constexpr uint32_t MAX_CAPACITY =
-      ArrayStorage::maxElements() < UINT32_MAX / 4 ? ArrayStorage::maxElements()
-                                                   : UINT32_MAX / 4;
+  static size_t _mallocSizeImpl(GCCell *cell) {
+    auto *self = vmcast<OrderedHashMap>(cell);
+    return self->index_.capacity() * sizeof(IndexSlot);
+  }
 
-  /// Capacity of the hash table.
-  uint32_t capacity_{INITIAL_CAPACITY};
+ private:
+  /// A slot of the index table.
+  struct IndexSlot {
+    /// The index of the entry, or kEmptySlot.
+    uint32_t entry;
+    /// The hash of the key of the entry.
+    uint32_t hash;
+  };
+
+  /// The entry of the unused index slots.
+  static constexpr uint32_t kEmptySlot = UINT32_MAX;
+
+  /// The keys and values of the entries in insertion order, including the
+  /// tombstones.
+  GCPointer<SegmentedArray> entries_{nullptr};
+
+  /// The current compaction epoch, allocated by the first iteration. Its only
+  /// element is empty until the epoch ends, and then holds a SegmentedArray
+  /// whose first element is the next epoch, followed by the former indices of
+  /// the entries that survived the compaction.
+  GCPointer<ArrayStorage> epoch_{nullptr};
+
+  /// The index table, whose size is a power of 2.
+  std::vector<IndexSlot> index_;
+
+  /// Initial size of the index table.
+  static constexpr uint32_t INITIAL_CAPACITY = 16;
 
   /// Number of alive entries in the storage.
   uint32_t size_{0};
 
-  /// Hash a HermesValue to an index to our hash table.
-  static uint32_t
-  hashToBucket(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key) {
-    auto hash = runtime->gcStableHashHermesValue(key);
-    assert(
-        (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-        "capacity_ must be power of 2");
-    return hash & (self->capacity_ - 1);
+  /// \return the number of entries in the storage, including the tombstones.
+  uint32_t numEntries(PointerBase *base) const {
+    return entries_.getNonNull(base)->size() / 2;
   }
 
-  /// Remove a node from the linked list.
-  void removeLinkedListNode(Runtime *runtime, HashMapEntry *entry, GC *gc);
-
-  /// Lookup an entry with key as \p key in a given \p bucket.
-  HashMapEntry *
-  lookupInBucket(Runtime *runtime, uint32_t bucket, HermesValue key);
+  /// \return the hash of \p key.
+  static uint32_t hashKey(Runtime *runtime, Handle<> key) {
+    return static_cast<uint32_t>(runtime->gcStableHashHermesValue(key));
+  }
 
-  /// Adjust the capacity of the hashtable and rehash if necessary.
-  /// We make decisions based on the Load Factor (size / capacity).
-  /// Rehash if load factor is outside of the range of [0.25, 0.75].
-  static ExecutionStatus rehashIfNecessary(
-      Handle<OrderedHashMap> self,
-      Runtime *runtime);
+  /// \return the size of the index table for \p numEntries entries, which
+  ///   leaves room for one more.
+  static uint32_t indexCapacityFor(uint32_t numEntries);
+
+  /// \return the index slot of the entry with \p key, whose hash is \p hash,
+  ///   or llvm::None if there is none.
+  OptValue<uint32_t>
+  lookup(PointerBase *base, uint32_t hash, HermesValue key) const;
+
+  /// Replace the index table with one of \p capacity slots, holding the
+  /// entries that are not deleted, whose indices are first mapped through
+  /// \p newIndexOf if it is not empty.
+  void rebuildIndex(
+      PointerBase *base,
+      uint32_t capacity,
+      llvm::ArrayRef<uint32_t> newIndexOf);
+
+  /// Remove the tombstones from the entries, and end the current epoch if
+  /// there is one.
+  static ExecutionStatus compact(Handle<OrderedHashMap> self, Runtime *runtime);
 }; // OrderedHashMap
 } // namespace vm
 } // namespace hermes
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_PARALLELMARKSTATE_H
+#define HERMES_VM_PARALLELMARKSTATE_H
+
+#include "hermes/VM/GCBase.h"
+#include "hermes/VM/GCCell.h"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// Intermediate state for completing the marking phase of a full collection
+/// on several threads.
+///
+/// Unlike CompleteMarkState, which relies on a single increasing-address
+/// traversal of the mark bit arrays and bounded mark stacks, every worker here
+/// pushes each cell it is the first to mark onto its own unbounded mark stack.
+/// Mark bits are set atomically, so exactly one worker becomes responsible for
+/// scanning any given cell.
+///
+/// Load balancing uses work stealing: when a worker's private stack grows past
+/// kPublishThreshold, it moves its oldest kStealChunk cells into a
+/// lock-protected deque that other workers may steal from once their own
+/// stacks run dry.  Marking terminates when every worker is idle and no
+/// published work remains.
+class ParallelMarkState {
+ public:
+  /// Create the state for marking with \p numWorkers threads (including the
+  /// calling thread) in \p gc, whose symbol table currently has \p numSymbols
+  /// entries.
+  ParallelMarkState(GC *gc, unsigned numWorkers, size_t numSymbols);
+  ~ParallelMarkState();
+
+  /// Add a cell that was marked from the roots, and whose fields must be
+  /// scanned.  Must be called before run(), from a single thread.
+  void addGray(GCCell *cell);
+
+  /// Transitively mark from the cells added via addGray, using numWorkers()
+  /// threads.  Returns once every reachable cell is marked.
+  void run();
+
+  /// Report every symbol found during marking to \p gc via GC::markSymbol.
+  /// Must be called after run().
+  void flushMarkedSymbols();
+
+  unsigned numWorkers() const {
+    return workers_.size();
+  }
+
+  /// Once a worker's private stack holds this many cells, it publishes some of
+  /// them for stealing.
+  static constexpr size_t kPublishThreshold = 256;
+
+  /// The number of cells published or stolen at once.
+  static constexpr size_t kStealChunk = kPublishThreshold / 2;
+
+ private:
+  struct Worker;
+  struct MarkAcceptor;
+
+  /// The marking loop executed by each worker.
+  void workerLoop(Worker &worker);
+
+  /// If \p worker has a large private stack, make part of it stealable.
+  void maybePublish(Worker &worker);
+
+  /// Try to move published cells (its own first, then those of other workers)
+  /// into the private stack of \p worker.  \return true if any were found.
+  bool steal(Worker &worker);
+
+  /// The heap being marked.
+  GC *gc_;
+
+  /// Per-worker state; workers_[0] is driven by the thread calling run().
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  /// The worker that the next addGray call seeds.
+  unsigned nextSeedWorker_{0};
+
+  /// The number of workers that found no work and are waiting to terminate.
+  std::atomic<unsigned> numIdle_{0};
+
+  /// The total number of cells in all workers' published deques.
+  std::atomic<size_t> numPublished_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_PARALLELMARKSTATE_H
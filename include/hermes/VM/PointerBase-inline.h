@@ -63,6 +63,13 @@ inline uint32_t BasedPointer::getRawValue() const {
   return segAndOffset_;
 }
 
+/*static*/
+inline BasedPointer BasedPointer::fromRawValue(uint32_t raw) {
+  BasedPointer result;
+  result.segAndOffset_ = raw;
+  return result;
+}
+
 inline void *PointerBase::basedToPointer(BasedPointer ptr) const {
   // The value
   char *segBase = reinterpret_cast<char *>(segmentMap_[ptr.getSegmentIndex()]);
@@ -45,6 +45,9 @@ class BasedPointer final {
 
   inline uint32_t getRawValue() const;
 
+  /// Rebuild a BasedPointer from the value returned by getRawValue().
+  static inline BasedPointer fromRawValue(uint32_t raw);
+
  private:
   static inline uint32_t computeSegmentAndOffset(const void *heapAddr);
 
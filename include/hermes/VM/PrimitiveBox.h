@@ -183,6 +183,14 @@ class JSStringIterator : public JSObject {
       Handle<JSStringIterator> self,
       Runtime *runtime);
 
+  /// Iterate to the next code point and store it in \p value, without
+  /// creating an iterator result object.
+  /// \return false if the iteration has ended.
+  static CallResult<bool> nextValue(
+      Handle<JSStringIterator> self,
+      Runtime *runtime,
+      MutableHandle<> &value);
+
  private:
 #ifdef HERMESVM_SERIALIZE
   explicit JSStringIterator(Deserializer &d);
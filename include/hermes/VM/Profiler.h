@@ -15,9 +15,10 @@
   uint64_t startTime = __rdtsc(); \
   unsigned curOpcode = (unsigned)OpCode::Call;
 
-#define RECORD_OPCODE_START_TIME                \
-  curOpcode = (unsigned)ip->opCode;             \
-  runtime->opcodeExecuteFrequency[curOpcode]++; \
+#define RECORD_OPCODE_START_TIME                                     \
+  runtime->opcodePairFrequency[curOpcode][(unsigned)ip->opCode]++; \
+  curOpcode = (unsigned)ip->opCode;                                \
+  runtime->opcodeExecuteFrequency[curOpcode]++;                    \
   startTime = __rdtsc();
 
 #define UPDATE_OPCODE_TIME_SPENT \
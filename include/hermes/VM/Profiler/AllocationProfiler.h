@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_PROFILER_ALLOCATIONPROFILER_H
+#define HERMES_VM_PROFILER_ALLOCATIONPROFILER_H
+
+// Allocation sampling captures stacks with the sampling profiler's stack walk,
+// which is only implemented on POSIX.
+#ifndef _WINDOWS
+
+#include "hermes/VM/Profiler/SamplingProfiler.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+#include <random>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// Samples the allocations of one runtime, on average one every sampling
+/// interval bytes, and attributes each sample to the JS stack that made it.
+/// The distance between samples is drawn from an exponential distribution,
+/// so allocations of every size are sampled in proportion to their bytes and
+/// periodic allocation patterns cannot line up with the samples.
+/// Sampled objects are followed through collections by the heap's IDTracker,
+/// which tells which of them are still alive when the profile is written.
+class AllocationProfiler {
+ public:
+  /// Start sampling the allocations of \p runtime, on average one every
+  /// \p samplingInterval bytes.
+  AllocationProfiler(Runtime *runtime, uint64_t samplingInterval);
+
+  /// \return the number of bytes to allocate before taking the next sample.
+  int64_t nextSampleDistance();
+
+  /// Record the allocation of \p size bytes at \p mem by the code running on
+  /// the runtime.
+  void recordSample(const void *mem, uint32_t size);
+
+  /// Write the samples to \p OS in the Chrome sampling heap profile format:
+  /// a call tree rooted at "head", in which each node has the estimated
+  /// bytes still alive ("selfSize") and allocated in total ("allocatedSize")
+  /// by its stack, followed by the samples of the objects still alive.
+  /// Samples of dead objects are discarded.
+  void serialize(llvm::raw_ostream &OS);
+
+ private:
+  /// Index of the root of the call tree, standing for allocations made with
+  /// no JS on the stack.
+  static constexpr uint32_t kRoot = UINT32_MAX;
+  /// Max depth of the captured stacks.
+  static constexpr uint32_t kMaxStackDepth = 500;
+
+  /// A frame in the call tree of the allocating stacks.
+  struct Node {
+    /// Frame information.
+    SamplingProfiler::StackFrame frame;
+    /// Index of the caller's node, or kRoot.
+    uint32_t parent;
+    /// Estimated bytes allocated by this stack, live or dead.
+    uint64_t allocatedBytes;
+  };
+
+  /// A sampled allocation.
+  struct Sample {
+    /// Id of the sampled object in the heap's IDTracker.
+    HeapSnapshot::NodeID objectID;
+    /// Node of the allocating stack, or kRoot.
+    uint32_t node;
+    /// Estimated bytes allocated that the sample stands for.
+    uint64_t size;
+    /// Order in which the samples were taken.
+    uint64_t ordinal;
+  };
+
+  Runtime *const runtime_;
+  /// Mean number of bytes between samples.
+  const double samplingInterval_;
+  /// Source of the distances between samples.
+  std::minstd_rand randomEngine_;
+  std::exponential_distribution<double> distanceDistribution_;
+  /// Storage the allocating stack is captured into.
+  SamplingProfiler::StackTrace stackStorage_{kMaxStackDepth};
+  /// Call tree of the allocating stacks. Callers precede their callees.
+  std::vector<Node> nodes_;
+  /// Maps a (parent, frame) key to the index of its node in nodes_.
+  llvm::DenseMap<std::pair<uint64_t, uint64_t>, uint32_t> nodeIndex_;
+  /// Samples of the objects that were alive when last checked.
+  std::vector<Sample> samples_;
+  /// Allocated bytes estimated for the samples with no JS on the stack.
+  uint64_t rootAllocatedBytes_{0};
+  /// Ordinal of the next sample.
+  uint64_t nextOrdinal_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // not _WINDOWS
+
+#endif // HERMES_VM_PROFILER_ALLOCATIONPROFILER_H
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_PROFILER_FUNCTIONPROFILER_H
+#define HERMES_VM_PROFILER_FUNCTIONPROFILER_H
+
+#include "hermes/VM/HermesValue.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+class CodeBlock;
+class Runtime;
+
+/// Measures the wall and CPU time of every call to a JS function of one
+/// runtime, as reported by the interpreter and the JIT compiled code at the
+/// entry and exit of each function. Times are aggregated per function and
+/// per call stack, so memory use does not grow with the number of calls.
+/// Activations are identified by their frame: an exit ends the activation of
+/// its frame and those of every deeper frame, whose exits were not reported,
+/// e.g. because an exception unwound them. Entering a frame that is already
+/// active, as when the interpreter resumes a frame of JIT compiled code, is
+/// ignored.
+class FunctionProfiler {
+ public:
+  explicit FunctionProfiler(Runtime *runtime);
+
+  /// \p codeBlock starts running in the frame at \p frame.
+  void enter(CodeBlock *codeBlock, const PinnedHermesValue *frame);
+
+  /// The function running in the frame at \p frame returns or unwinds.
+  void exit(const PinnedHermesValue *frame);
+
+  /// Write the self wall time of each call stack to \p OS as flame graph
+  /// folded stacks: the functions of the stack from the root, separated by
+  /// ';', and the time in microseconds. Calls that have not returned yet
+  /// are counted, but not their time.
+  void dumpFoldedStacks(llvm::raw_ostream &OS) const;
+
+  /// Write the calls, and the self and total wall and CPU times in
+  /// microseconds of each function to \p OS as a JSON array, most self wall
+  /// time first. The total time of a recursive function counts its
+  /// outermost activations only.
+  void dumpSummary(llvm::raw_ostream &OS) const;
+
+ private:
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  /// Index of the root of the call tree.
+  static constexpr uint32_t kRoot = UINT32_MAX;
+
+  /// The times of a function, over all its calls.
+  struct Function {
+    /// Name and source location, in folded stack form.
+    std::string name;
+    uint64_t calls;
+    /// Wall times in nanoseconds, CPU times in microseconds.
+    uint64_t selfWall;
+    uint64_t totalWall;
+    uint64_t selfCPU;
+    uint64_t totalCPU;
+    /// Number of activations of the function on the stack.
+    uint32_t active;
+
+    explicit Function(std::string name)
+        : name(std::move(name)),
+          calls(0),
+          selfWall(0),
+          totalWall(0),
+          selfCPU(0),
+          totalCPU(0),
+          active(0) {}
+  };
+
+  /// A call stack, in the tree of the call stacks seen.
+  struct Node {
+    /// Index of the function in functions_.
+    uint32_t function;
+    /// Index of the caller's node, or kRoot.
+    uint32_t parent;
+    uint64_t calls;
+    /// Self wall time in nanoseconds.
+    uint64_t selfWall;
+  };
+
+  /// A call that has not returned yet.
+  struct Activation {
+    const PinnedHermesValue *frame;
+    uint32_t node;
+    TimePoint wallStart;
+    std::chrono::microseconds cpuStart;
+    /// Total times of the calls it made, which are not its self time.
+    uint64_t childWall;
+    uint64_t childCPU;
+  };
+
+  /// \return the index of \p codeBlock in functions_, adding it if needed.
+  uint32_t getFunction(CodeBlock *codeBlock);
+
+  /// End the innermost activation at \p wallEnd and \p cpuEnd.
+  void pop(TimePoint wallEnd, std::chrono::microseconds cpuEnd);
+
+  Runtime *const runtime_;
+  std::vector<Function> functions_;
+  llvm::DenseMap<CodeBlock *, uint32_t> functionIndex_;
+  /// Callers precede their callees.
+  std::vector<Node> nodes_;
+  /// Maps a (parent node, function) key to the index of its node.
+  llvm::DenseMap<std::pair<uint32_t, uint32_t>, uint32_t> nodeIndex_;
+  /// The calls in progress, innermost last. Deeper frames are at lower
+  /// addresses.
+  std::vector<Activation> stack_;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_PROFILER_FUNCTIONPROFILER_H
@@ -8,6 +8,7 @@
 #ifndef INLINECACHE_PROFILER_H
 #define INLINECACHE_PROFILER_H
 
+#include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/SymbolID.h"
 #include "llvm/ADT/DenseMap.h"
 
@@ -61,6 +62,11 @@ class InlineCacheProfiler {
     /// Total number of inline caching hits at the source location.
     uint64_t hitCount{0};
 
+    /// The state of the inline cache at the source location, the last time
+    /// it was used.
+    PropertyCacheEntry::State cacheState{
+        PropertyCacheEntry::State::Uninitialized};
+
     /// Internal map that keeps track of the mapping between
     /// <property, object hidden class, cached hidden class> and its frequency.
     llvm::DenseMap<ICMissKey, uint64_t> hiddenClasses;
@@ -72,16 +78,20 @@ class InlineCacheProfiler {
   /// inline caching at a specific source location.
   ICMiss &getICMissBySourceLocation(CodeBlock *codeblock, uint32_t instOffset);
 
-  /// Record an inline caching miss.
+  /// Record an inline caching miss on a cache in state \p cacheState.
   bool insertICMiss(
       CodeBlock *codeblock,
       uint32_t instOffset,
       SymbolID &propertyID,
       ClassId objectHiddenClassId,
-      ClassId cachedHiddenClassId);
+      ClassId cachedHiddenClassId,
+      PropertyCacheEntry::State cacheState);
 
-  /// Record an inline caching hit.
-  bool insertICHit(CodeBlock *codeblock, uint32_t instOffset);
+  /// Record an inline caching hit on a cache in state \p cacheState.
+  bool insertICHit(
+      CodeBlock *codeblock,
+      uint32_t instOffset,
+      PropertyCacheEntry::State cacheState);
 
   /// Get the total number of inline caching misses.
   uint32_t getTotalMisses() {
@@ -22,6 +22,7 @@
 #endif
 
 #include <chrono>
+#include <functional>
 #include <mutex>
 #include <thread>
 #include <unordered_set>
@@ -34,15 +35,18 @@
 namespace hermes {
 namespace vm {
 
-/// Singleton wall-time based JS sampling profiler that walks VM stack frames
-/// in a configurable interval. The profiler can be enabled and disabled
-/// on demand.
+/// Wall-time based JS sampling profiler that walks VM stack frames in a
+/// configurable interval. The profiler can be enabled and disabled on demand.
+/// Runtimes are sampled by the process-wide instance unless they are given
+/// one of their own, which has its own interval, samples and sampling thread.
 class SamplingProfiler {
  public:
   using ThreadId = uint64_t;
   using TimeStampType = std::chrono::steady_clock::time_point;
   using ThreadNamesMap =
       llvm::DenseMap<SamplingProfiler::ThreadId, std::string>;
+  /// Receives each chunk of aggregated samples in streaming mode.
+  using StreamSink = std::function<void(const std::string &chunk)>;
 
   /// Captured JSFunction stack frame information for symbolication.
   /// TODO: consolidate the stack frame struct with other function/extern
@@ -113,14 +117,39 @@ class SamplingProfiler {
   };
 
  private:
+  /// A frame in the call tree that samples are aggregated into in streaming
+  /// mode. Identical frames under the same caller share a node.
+  struct CallTreeNode {
+    /// Frame information.
+    StackFrame frame;
+    /// Index of the caller's node in callTree_, or kNoParent for a root.
+    uint32_t parent;
+    /// Number of samples whose leaf frame is this node.
+    uint32_t selfCount;
+  };
+
   /// Max size of sampleStorage_.
   static const int kMaxStackDepth = 500;
 
+  /// Parent index of the root frames in callTree_.
+  static constexpr uint32_t kNoParent = UINT32_MAX;
+
+  /// Number of opcodes, and the value of sampledOpCode_ for a sample whose
+  /// leaf frame is not executing a known instruction.
+  static constexpr uint32_t kNumOpCodes =
+      static_cast<uint32_t>(inst::OpCode::_last);
+
   /// Pointing to the singleton SamplingProfiler instance.
   /// We need this field because accessing local static variable from
   /// signal handler is unsafe.
   static volatile std::atomic<SamplingProfiler *> sProfilerInstance_;
 
+  /// Pointing to the profiler whose sample the signal handler is taking.
+  /// Stored, along with sending the signal and waiting for the handler, while
+  /// holding the process-wide signal lock, so that profilers sampling the
+  /// same thread never mix up their samples.
+  static volatile std::atomic<SamplingProfiler *> sSamplingProfiler_;
+
   /// Lock for profiler operations and access to member fields.
   std::mutex profilerLock_;
 
@@ -134,8 +163,13 @@ class SamplingProfiler {
 
   /// Whether profiler is enabled or not. Protected by profilerLock_.
   bool enabled_{false};
-  /// Whether signal handler is registered or not. Protected by profilerLock_.
-  bool isSigHandlerRegistered_{false};
+
+  /// Time to wait between samples. Protected by profilerLock_.
+  std::chrono::microseconds samplingInterval_{std::chrono::milliseconds(1)};
+
+  /// Thread taking samples while the profiler is enabled. It is joined by
+  /// disable(), so it never outlives the profiler.
+  std::thread timerThread_;
 
   /// Semaphore to indicate all signal handlers have finished the sampling.
   Semaphore samplingDoneSem_;
@@ -143,10 +177,31 @@ class SamplingProfiler {
   /// Sampled stack traces overtime. Protected by profilerLock_.
   std::vector<StackTrace> sampledStacks_;
 
+  /// Whether samples are aggregated into callTree_ and handed to
+  /// streamSink_ instead of being kept in sampledStacks_.
+  /// The streaming fields below are all protected by profilerLock_.
+  bool streaming_{false};
+  /// Capacity of callTree_; reaching it forces a flush.
+  uint32_t maxCallTreeNodes_{0};
+  /// Longest time samples are held in callTree_ before being flushed.
+  std::chrono::steady_clock::duration flushInterval_{};
+  /// When callTree_ was last flushed.
+  TimeStampType lastFlushTime_;
+  /// Receives the flushed call trees.
+  StreamSink streamSink_;
+  /// Call tree of the samples taken since the last flush. Callers always
+  /// precede their callees.
+  std::vector<CallTreeNode> callTree_;
+  /// Maps a (parent, frame) key to the index of its node in callTree_.
+  llvm::DenseMap<std::pair<uint64_t, uint64_t>, uint32_t> callTreeIndex_;
+
   /// Threading: load/store of sampledStackDepth_ and sampleStorage_
   /// are protected by samplingDoneSem_.
   /// Actual sampled stack depth in sampleStorage_.
   uint32_t sampledStackDepth_{0};
+  /// Opcode of the instruction the leaf JS frame of the sample was executing,
+  /// or kNumOpCodes if the leaf frame is not JS or its IP is unknown.
+  uint32_t sampledOpCode_{kNumOpCodes};
   /// Preallocated stack frames storage for signal handler(because
   /// allocating memory in signal handler is not allowed)
   /// This storage does not need to be protected by lock because accessing to
@@ -170,6 +225,17 @@ class SamplingProfiler {
   /// because this container never rehashes.
   std::unordered_set<std::string> gcEventExtraInfoSet_;
 
+  /// Approximate histograms of what the leaf frames were executing, counted
+  /// from every sample in both modes. Protected by profilerLock_.
+  /// Samples per opcode of the leaf JS frame's instruction; the last entry
+  /// counts the leaf JS frames whose instruction is unknown, such as compiled
+  /// code.
+  uint64_t opCodeSamples_[kNumOpCodes + 1]{};
+  /// Samples per builtin that was the leaf frame. The key is the builtin's
+  /// NativeFunctionPtr, as "void *" since DenseMapInfo cannot align function
+  /// pointers.
+  llvm::DenseMap<void *, uint64_t> builtinSamples_;
+
   /// Domains to be kept alive for sampled RuntimeModules.
   /// Its storage size is increased/decreased by
   /// increaseDomainCount/decreaseDomainCount outside signal handler.
@@ -186,14 +252,14 @@ class SamplingProfiler {
 
   /// invoke sigaction() posix API to register \p handler.
   /// \return what sigaction() returns: 0 to indicate success.
-  int invokeSignalAction(void (*handler)(int));
+  static int invokeSignalAction(void (*handler)(int));
 
-  /// Register sampling signal handler if not done yet.
+  /// Register sampling signal handler if no other profiler is enabled.
   /// \return true to indicate success.
-  bool registerSignalHandlers();
+  static bool registerSignalHandlers();
 
-  /// Unregister sampling signal handler.
-  bool unregisterSignalHandler();
+  /// Unregister sampling signal handler once no profiler is enabled.
+  static bool unregisterSignalHandler();
 
   /// Hold \p domain so that the RuntimeModule(s) used by profiler are not
   /// released during symbolication.
@@ -214,16 +280,34 @@ class SamplingProfiler {
   /// This function is called from signal handler so should obey all
   /// rules of signal handler(no lock, no memory allocation etc...)
   /// \param startIndex specifies the start index in \p sampleStorage to fill.
+  /// \param[out] leafIP if not null, set to the instruction the leaf frame is
+  /// executing if it is a JS frame whose instruction is known, else null.
   /// \return total number of stack frames captured in \p sampleStorage
   /// including existing frames before \p startIndex.
   uint32_t walkRuntimeStack(
       const Runtime *runtime,
       StackTrace &sampleStorage,
-      uint32_t startIndex = 0);
+      uint32_t startIndex = 0,
+      const inst::Inst **leafIP = nullptr);
+
+  /// Add the leaf frame of the sample in sampleStorage_ to the opcode and
+  /// builtin histograms.
+  /// Note: caller should take the lock before calling.
+  void countLeafFrame();
 
   /// Record JS stack at time of the GC.
   void recordPreGCStack(Runtime *runtime, const std::string &extraInfo);
 
+  /// Add the first \p depth frames of \p sample to callTree_, flushing it
+  /// first if it may not have room for them.
+  /// Note: caller should take the lock before calling.
+  void aggregateSample(const StackTrace &sample, uint32_t depth);
+
+  /// Hand callTree_ to streamSink_ in folded stack format, one
+  /// "root;...;leaf count" line per leaf, then empty it.
+  /// Note: caller should take the lock before calling.
+  void flushCallTree();
+
 #if defined(__ANDROID__) && defined(HERMES_FACEBOOK_BUILD)
   /// Registered loom callback for collecting stack frames.
   static StackCollectionRetcode collectStackForLoom(
@@ -241,6 +325,19 @@ class SamplingProfiler {
   /// Return the singleton profiler instance.
   static const std::shared_ptr<SamplingProfiler> &getInstance();
 
+  /// Return a new profiler independent of the singleton instance, for a
+  /// runtime to be sampled on its own.
+  static std::shared_ptr<SamplingProfiler> create();
+
+  /// \return the key identifying \p frame among the callees of the call tree
+  /// node \p parent. Frames that compare equal get the same key, which is
+  /// never the empty or tombstone key of a DenseMap.
+  static std::pair<uint64_t, uint64_t> getCallTreeKey(
+      uint32_t parent,
+      const StackFrame &frame);
+
+  ~SamplingProfiler();
+
   /// Register an active \p runtime and current thread with profiler.
   /// Should only be called from the thread running hermes runtime.
   void registerRuntime(Runtime *runtime);
@@ -248,10 +345,11 @@ class SamplingProfiler {
   /// Unregister an active \p runtime and current thread with profiler.
   void unregisterRuntime(Runtime *runtime);
 
-  /// Reserve domain slots to avoid memory allocation in signal handler.
-  void increaseDomainCount();
-  /// Shrink domain storage to fit domains alive.
-  void decreaseDomainCount();
+  /// Reserve a domain slot in every profiler to avoid memory allocation in
+  /// signal handler.
+  static void increaseDomainCount();
+  /// Shrink the domain storage of every profiler to fit domains alive.
+  static void decreaseDomainCount();
 
   /// Mark roots that are kept alive by the SamplingProfiler.
   void markRoots(SlotAcceptorWithNames &acceptor) {
@@ -260,6 +358,12 @@ class SamplingProfiler {
     }
   }
 
+  /// Walk the stack of \p runtime, which must be running on the calling
+  /// thread, into \p storage the way a sample does. The domains of the
+  /// captured frames are kept alive until the samples are next cleared.
+  /// \return the number of frames captured, leaf first.
+  uint32_t captureStack(const Runtime *runtime, StackTrace &storage);
+
   /// Dump sampled stack to \p OS.
   /// NOTE: this is for manual testing purpose.
   void dumpSampledStack(llvm::raw_ostream &OS);
@@ -267,9 +371,33 @@ class SamplingProfiler {
   /// Dump sampled stack to \p OS in chrome trace format.
   void dumpChromeTrace(llvm::raw_ostream &OS);
 
+  /// Dump to \p OS how many samples caught each opcode and each builtin
+  /// executing in the leaf frame, most frequent first. This approximates
+  /// where time goes at the instruction level without the cost of the
+  /// compile-time opcode and native call profilers.
+  void dumpOpCodeAndBuiltinHistograms(llvm::raw_ostream &OS);
+
+  /// Set the time to wait between samples to \p interval.
+  void setSamplingInterval(std::chrono::microseconds interval);
+
   /// Enable and start profiling.
   bool enable();
 
+  /// Enable and start profiling in streaming mode: rather than keeping every
+  /// sample, merge them into a call tree of at most \p maxNodes frames and
+  /// hand it to \p sink whenever it fills up, \p flushInterval passes, or
+  /// profiling is disabled. Memory use stays bounded however long profiling
+  /// runs. \p sink is called on the sampling thread with the profiler lock
+  /// held, so it must not call back into the profiler.
+  /// \return false if the profiler is already enabled or fails to start.
+  bool enableStreaming(
+      uint32_t maxNodes,
+      std::chrono::milliseconds flushInterval,
+      StreamSink sink);
+
+  /// Hand the samples aggregated so far in streaming mode to the sink.
+  void flushStream();
+
   /// Disable and stop profiling.
   bool disable();
 
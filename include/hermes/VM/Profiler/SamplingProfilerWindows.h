@@ -10,11 +10,18 @@
 
 #include "hermes/VM/Runtime.h"
 
+#include <chrono>
+#include <functional>
+
 namespace hermes {
 namespace vm {
 
 /// No-op implementation of wall-time based JS sampling profiler.
 class SamplingProfiler {
+ public:
+  /// Receives each chunk of aggregated samples in streaming mode.
+  using StreamSink = std::function<void(const std::string &chunk)>;
+
  private:
   SamplingProfiler() = default;
 
@@ -22,6 +29,9 @@ class SamplingProfiler {
   /// Return the singleton profiler instance.
   static const std::shared_ptr<SamplingProfiler> &getInstance();
 
+  /// Return a new profiler independent of the singleton instance.
+  static std::shared_ptr<SamplingProfiler> create();
+
   /// Register an active \p runtime and current thread with profiler.
   /// Should only be called from the thread running hermes runtime.
   void registerRuntime(Runtime *runtime) {}
@@ -30,10 +40,10 @@ class SamplingProfiler {
   void unregisterRuntime(Runtime *runtime) {}
 
   /// Reserve domain slots to avoid memory allocation in signal handler.
-  void increaseDomainCount() {}
+  static void increaseDomainCount() {}
 
   /// Shrink domain storage to fit domains alive.
-  void decreaseDomainCount() {}
+  static void decreaseDomainCount() {}
 
   /// Mark roots that are kept alive by the SamplingProfiler.
   void markRoots(SlotAcceptorWithNames &acceptor) {}
@@ -45,11 +55,28 @@ class SamplingProfiler {
   /// Dump sampled stack to \p OS in chrome trace format.
   void dumpChromeTrace(llvm::raw_ostream &OS) {}
 
+  /// Dump the sampled opcode and builtin histograms to \p OS.
+  void dumpOpCodeAndBuiltinHistograms(llvm::raw_ostream &OS) {}
+
+  /// Set the time to wait between samples to \p interval.
+  void setSamplingInterval(std::chrono::microseconds interval) {}
+
   /// Enable and start profiling.
   bool enable() {
     return false;
   }
 
+  /// Enable and start profiling in streaming mode.
+  bool enableStreaming(
+      uint32_t maxNodes,
+      std::chrono::milliseconds flushInterval,
+      StreamSink sink) {
+    return false;
+  }
+
+  /// Hand the samples aggregated so far in streaming mode to the sink.
+  void flushStream() {}
+
   /// Disable and stop profiling.
   bool disable() {
     return true;
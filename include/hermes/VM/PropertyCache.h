@@ -11,6 +11,8 @@
 #include "hermes/VM/GCPointer.h"
 #include "hermes/VM/SymbolID.h"
 
+#include <cassert>
+
 namespace hermes {
 namespace vm {
 using SlotIndex = uint32_t;
@@ -19,16 +21,170 @@ class HiddenClass;
 
 /// A cache entry for a property lookup.
 /// If the class operation that we are performing
-/// matches the values in the cache entry, \c slot is the index of a
-/// non-accessor property.
+/// matches one of the classes in the cache entry, the slot cached with it is
+/// the index of a non-accessor property.
+///
+/// The fast paths compare against \c clazz first, so a monomorphic site costs a
+/// single comparison, as it always has. Sites that see a few different classes
+/// keep up to kNumWays - 1 more in \c polyClazz. A site that sees more classes
+/// than that becomes megamorphic: the extra classes are dropped, and the entry
+/// goes back to caching only the most recently seen class.
+///
+/// A read entry may also cache a property found on a prototype of the object,
+/// in \c protoClazz. It records the class of every object on the way from the
+/// receiver to the holder of the property, so a change to any of them, either
+/// a class transition or a different prototype, makes the entry miss.
+///
+/// A read entry of a global variable also holds a global cell: the slot of
+/// the property in the global object, valid as long as the global property
+/// epoch of the runtime is the one recorded with it. The global object is
+/// usually a dictionary, which can't be cached by class once any of its
+/// properties has been deleted or reconfigured. Such a change bumps the epoch
+/// instead, and adding properties keeps the slots of the others, so the cells
+/// of a global object which is only added to stay valid.
 struct PropertyCacheEntry {
+  using ClassStorageType = GCPointer<HiddenClass>::StorageType;
+
+  /// The number of classes a polymorphic entry holds.
+  static constexpr unsigned kNumWays = 4;
+
+  /// The number of prototypes a cached prototype load may look through.
+  static constexpr unsigned kMaxProtoDepth = 3;
+
+  /// The state of a cache entry, for profiling.
+  enum class State : uint8_t {
+    Uninitialized,
+    Monomorphic,
+    Polymorphic,
+    Megamorphic,
+  };
+
   /// Cached class.
-  GCPointer<HiddenClass>::StorageType clazz{nullptr};
+  ClassStorageType clazz{nullptr};
 
   /// Cached property index.
   SlotIndex slot{0};
+
+  /// Whether the site has seen more than kNumWays classes.
+  bool megamorphic{false};
+
+  /// The other cached classes and property indices of a polymorphic site.
+  /// Unused ways hold null.
+  ClassStorageType polyClazz[kNumWays - 1]{};
+  SlotIndex polySlot[kNumWays - 1]{};
+
+  /// The classes of the objects on the prototype chain of a load that found
+  /// the property on a prototype: protoClazz[0] is the class of the receiver
+  /// and protoClazz[protoDepth] is the class of the holder. The receiver class
+  /// is null if the receiver itself must be looked up, because it is a
+  /// dictionary that could gain the property without changing class.
+  ClassStorageType protoClazz[kMaxProtoDepth + 1]{};
+
+  /// The property index in the holder of a cached prototype load.
+  SlotIndex protoSlot{0};
+
+  /// How far up the prototype chain of the receiver the holder of a cached
+  /// prototype load is (1 for its direct prototype), or 0 if none is cached.
+  uint8_t protoDepth{0};
+
+  /// The global property epoch at which the global cell was filled, or 0 if
+  /// there is none.
+  uint32_t globalEpoch{0};
+
+  /// The slot of the property in the global object, if the global cell is
+  /// valid.
+  SlotIndex globalSlot{0};
+
+  /// Telemetry of the sites using the entry, kept in every build to find
+  /// shape-unstable property accesses. The fast paths add one to hits; the
+  /// slow paths, which are already expensive, count the rest.
+  /// Accesses answered by the cache.
+  uint64_t hits{0};
+  /// Accesses the cache could not answer.
+  uint32_t misses{0};
+  /// Cached classes dropped to make room for another, which only happens
+  /// once the entry is megamorphic.
+  uint32_t evictions{0};
+
+  /// Look for \p cls among the other classes of a polymorphic entry.
+  /// \return true and set \p slotOut to its property index if it was found.
+  bool findPolymorphic(ClassStorageType cls, SlotIndex &slotOut) const {
+    for (unsigned i = 0; i < kNumWays - 1; ++i) {
+      if (polyClazz[i] == cls) {
+        slotOut = polySlot[i];
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Look for \p cls among all the cached classes.
+  /// \return true and set \p slotOut to its property index if it was found.
+  bool find(ClassStorageType cls, SlotIndex &slotOut) const {
+    if (clazz == cls) {
+      slotOut = slot;
+      return true;
+    }
+    return findPolymorphic(cls, slotOut);
+  }
+
+  /// Cache \p newSlot as the property index for \p cls.
+  /// \pre cls is not null.
+  void update(ClassStorageType cls, SlotIndex newSlot) {
+    assert(cls && "Cannot cache a null class");
+    if (!clazz || clazz == cls || megamorphic) {
+      if (megamorphic && clazz != cls) {
+        ++evictions;
+      }
+      clazz = cls;
+      slot = newSlot;
+      return;
+    }
+    for (unsigned i = 0; i < kNumWays - 1; ++i) {
+      if (!polyClazz[i] || polyClazz[i] == cls) {
+        polyClazz[i] = cls;
+        polySlot[i] = newSlot;
+        return;
+      }
+    }
+    // Out of ways: stop tracking the site's classes.
+    megamorphic = true;
+    evictions += kNumWays;
+    for (auto &way : polyClazz) {
+      way = ClassStorageType{};
+    }
+    clazz = cls;
+    slot = newSlot;
+  }
+
+  State getState() const {
+    if (megamorphic) {
+      return State::Megamorphic;
+    }
+    for (const auto &way : polyClazz) {
+      if (way) {
+        return State::Polymorphic;
+      }
+    }
+    return clazz || globalEpoch ? State::Monomorphic : State::Uninitialized;
+  }
 };
 
+/// \return a short name for \p state.
+inline const char *propertyCacheStateName(PropertyCacheEntry::State state) {
+  switch (state) {
+    case PropertyCacheEntry::State::Uninitialized:
+      return "uninitialized";
+    case PropertyCacheEntry::State::Monomorphic:
+      return "monomorphic";
+    case PropertyCacheEntry::State::Polymorphic:
+      return "polymorphic";
+    case PropertyCacheEntry::State::Megamorphic:
+      return "megamorphic";
+  }
+  return "unknown";
+}
+
 } // namespace vm
 } // namespace hermes
 #endif // PROJECT_PROPERTYCACHE_H
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_REGEXPCACHE_H
+#define HERMES_VM_REGEXPCACHE_H
+
+#include "hermes/VM/StringRefUtils.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// A cache of the bytecode of the regexps compiled by a runtime, keyed on
+/// their pattern and syntax flags, so that a RegExp constructed again from the
+/// same strings, like `new RegExp(str)` in a loop, copies the bytecode instead
+/// of parsing and compiling the pattern again. The least recently used entry
+/// is evicted when the cache is full.
+class RegExpCache {
+ public:
+  /// Create a cache of the bytecode of up to \p capacity regexps. A capacity
+  /// of 0 disables the cache.
+  explicit RegExpCache(unsigned capacity) : capacity_(capacity) {}
+
+  /// \return the bytecode of the regexp \p pattern compiled with the syntax
+  ///   flags \p flags, or null if it is not cached. The bytecode stays valid
+  ///   until the next insertion.
+  const std::vector<uint8_t> *lookup(UTF16Ref pattern, uint8_t flags);
+
+  /// Cache \p bytecode as the bytecode of the regexp \p pattern compiled with
+  /// the syntax flags \p flags, evicting the least recently used entry if the
+  /// cache is full.
+  void insert(UTF16Ref pattern, uint8_t flags, std::vector<uint8_t> bytecode);
+
+  /// Print the number of hits, misses and evictions to \p os, to tune the
+  /// capacity of the cache. Nothing is printed if it was never used.
+  void printStats(llvm::raw_ostream &os) const;
+
+ private:
+  /// The flags of a regexp followed by its pattern.
+  using Key = std::u16string;
+
+  static Key makeKey(UTF16Ref pattern, uint8_t flags);
+
+  struct Entry {
+    Key key;
+    std::vector<uint8_t> bytecode;
+  };
+
+  /// The maximum number of entries.
+  const unsigned capacity_;
+
+  /// The entries, from the most recently used to the least.
+  std::list<Entry> entries_{};
+
+  /// The entries by their key.
+  std::unordered_map<Key, std::list<Entry>::iterator> index_{};
+
+  /// The total size of the bytecode of the entries.
+  size_t bytecodeBytes_{0};
+
+  uint64_t numHits_{0};
+  uint64_t numMisses_{0};
+  uint64_t numEvictions_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_REGEXPCACHE_H
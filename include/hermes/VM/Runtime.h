@@ -23,21 +23,25 @@
 #include "hermes/VM/Handle-inline.h"
 #include "hermes/VM/HandleRootOwner-inline.h"
 #include "hermes/VM/HasFinalizer.h"
+#include "hermes/VM/EvalCache.h"
 #include "hermes/VM/IdentifierTable.h"
 #include "hermes/VM/InterpreterState.h"
 #include "hermes/VM/JIT/JIT.h"
+#include "hermes/VM/LazyCompileQueue.h"
 #include "hermes/VM/MockedEnvironment.h"
 #include "hermes/VM/PointerBase.h"
 #include "hermes/VM/Predefined.h"
 #include "hermes/VM/Profiler.h"
 #include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/PropertyDescriptor.h"
+#include "hermes/VM/RegExpCache.h"
 #include "hermes/VM/RegExpMatch.h"
 #include "hermes/VM/RuntimeModule.h"
 #include "hermes/VM/RuntimeStats.h"
 #include "hermes/VM/Serializer.h"
 #include "hermes/VM/StackFrame.h"
 #include "hermes/VM/SymbolRegistry.h"
+#include "hermes/VM/TransitionCache.h"
 #include "hermes/VM/TwineChar16.h"
 
 #ifdef HERMESVM_PROFILER_BB
@@ -79,6 +83,8 @@ struct RuntimeOffsets;
 class ScopedNativeDepthTracker;
 class ScopedNativeCallFrame;
 class SamplingProfiler;
+class AllocationProfiler;
+class FunctionProfiler;
 
 #ifdef HERMESVM_PROFILER_BB
 class JSArray;
@@ -98,6 +104,9 @@ enum {
   MAdviseStringsSequential = 1 << 4,
   MAdviseStringsRandom = 1 << 5,
   MAdviseStringsWillNeed = 1 << 6,
+  /// Map every identifier of a persistent module when it is loaded, instead
+  /// of on first use.
+  EagerIdentifiers = 1 << 7,
 };
 /// Set of flags for active VM experiments.
 using VMExperimentFlags = uint32_t;
@@ -108,6 +117,11 @@ using ObjectID = uint32_t;
 
 using DestructionCallback = std::function<void(Runtime *)>;
 
+/// Returns the bytecode of the given segment of the running bundle, or nullptr
+/// if it can't be loaded.
+using SegmentLoader =
+    std::function<std::shared_ptr<hbc::BCProvider>(uint32_t segment)>;
+
 #define PROP_CACHE_IDS(V) V(RegExpLastIndex, Predefined::lastIndex)
 
 /// Fixed set of ids used by the property cache in Runtime.
@@ -128,6 +142,12 @@ class Runtime : public HandleRootOwner,
 
   ~Runtime();
 
+  /// \return the number of bytes of native memory leaked by the fast
+  /// teardowns (see RuntimeConfig::FastTeardown) of all runtimes so far.
+  static uint64_t getFastTeardownLeakedBytes() {
+    return fastTeardownLeakedBytes_.load(std::memory_order_relaxed);
+  }
+
   /// Add a custom function that will be executed at the start of every garbage
   /// collection to mark additional GC roots that may not be known to the
   /// Runtime.
@@ -201,6 +221,17 @@ class Runtime : public HandleRootOwner,
       Handle<RequireContext> requireContext,
       RuntimeModuleFlags flags = {});
 
+  /// Set the function used to load the segment of a module that is required
+  /// before its segment was loaded with loadSegment().
+  void setSegmentLoader(SegmentLoader loader) {
+    segmentLoader_ = std::move(loader);
+  }
+
+  /// \return the segment loader, which may be empty.
+  const SegmentLoader &getSegmentLoader() const {
+    return segmentLoader_;
+  }
+
   /// Runs the internal bytecode. This is called once during initialization.
   void runInternalBytecode();
 
@@ -225,6 +256,17 @@ class Runtime : public HandleRootOwner,
   template <HasFinalizer hasFinalizer = HasFinalizer::No>
   void *allocLongLived(uint32_t size);
 
+  /// Like the above, for an object that is expected to be long-lived because
+  /// of its allocation site.  The object may be initialized without barriers.
+  template <HasFinalizer hasFinalizer = HasFinalizer::No>
+  void *allocPretenured(uint32_t size);
+
+  /// Account for the allocation of \p size bytes at \p mem, taking an
+  /// allocation sample once enough bytes have been allocated since the last
+  /// one. All of the allocation functions above call it; allocations made
+  /// without them, like the JIT's inline ones, must call it too.
+  inline void countAllocation(const void *mem, uint32_t size);
+
   /// Used as a placeholder for places where we should be checking for OOM
   /// but aren't yet.
   /// TODO: do something when there is an uncaught exception, e.g. print
@@ -298,6 +340,32 @@ class Runtime : public HandleRootOwner,
   /// the builtins header header.
   inline NativeFunction *getBuiltinNativeFunction(unsigned builtinMethodID);
 
+  /// Define the properties of a lazy builtin: its constructor \p cons and the
+  /// prototype of its instances.
+  using LazyBuiltinInit = void(Runtime *runtime, Handle<JSObject> cons);
+
+  /// A builtin constructor and prototype whose properties are only defined
+  /// the first time either of them is used.
+  struct LazyBuiltin {
+    JSObject *constructor;
+    JSObject *prototype;
+    /// Defines the properties, or nullptr once they have been defined.
+    LazyBuiltinInit *init;
+  };
+
+  /// Register the lazy builtin with constructor \p cons and prototype \p
+  /// proto, whose properties are defined by \p init.
+  /// \return the index of the builtin, which is never 0.
+  uint32_t
+  addLazyBuiltin(JSObject *cons, JSObject *proto, LazyBuiltinInit *init);
+
+  /// \return the uninitialized lazy builtin with index \p index, if \p obj is
+  /// its constructor or prototype, or nullptr otherwise.
+  LazyBuiltin *findLazyBuiltin(uint32_t index, JSObject *obj);
+
+  /// Define the properties of all the lazy builtins which haven't been used.
+  void initializeLazyBuiltins();
+
   IdentifierTable &getIdentifierTable() {
     return identifierTable_;
   }
@@ -306,10 +374,39 @@ class Runtime : public HandleRootOwner,
     return symbolRegistry_;
   }
 
+  TransitionCache &getTransitionCache() {
+    return transitionCache_;
+  }
+
+  RegExpCache &getRegExpCache() {
+    return regExpCache_;
+  }
+
+  EvalCache &getEvalCache() {
+    return evalCache_;
+  }
+
   /// Return a StringPrimitive representation of a single character. The first
   /// 256 characters are pre-allocated. The rest are allocated every time.
   Handle<StringPrimitive> getCharacterString(char16_t ch);
 
+  /// \return the string of the number \p m in the number to string cache, or
+  /// nullptr if it isn't there. \p m must not be NaN or zero.
+  StringPrimitive *getCachedNumberString(double m) {
+    uint64_t bits = safeTypeCast<double, uint64_t>(m);
+    NumberStringCacheEntry &entry = numberStringCache_[numberStringHash(bits)];
+    return entry.bits == bits ? entry.str.getString() : nullptr;
+  }
+
+  /// Record \p str as the string of the number \p m in the number to string
+  /// cache, replacing the number sharing its entry.
+  void cacheNumberString(double m, StringPrimitive *str) {
+    uint64_t bits = safeTypeCast<double, uint64_t>(m);
+    NumberStringCacheEntry &entry = numberStringCache_[numberStringHash(bits)];
+    entry.bits = bits;
+    entry.str = HermesValue::encodeStringValue(str);
+  }
+
   CodeBlock *getEmptyCodeBlock() const {
     assert(emptyCodeBlock_ && "Invalid empty code block");
     return emptyCodeBlock_;
@@ -443,10 +540,37 @@ class Runtime : public HandleRootOwner,
   /// Return the global object.
   Handle<JSObject> getGlobal();
 
+  /// \return true if \p cell is the global object.
+  bool isGlobal(const GCCell *cell) const {
+    return global_.getPointer() == cell;
+  }
+
+  /// \return the global property epoch, which property caches record along
+  /// with the slot of an own property of the global object they read. It
+  /// never is 0, so 0 marks a cache entry without a global cell.
+  uint32_t getGlobalPropertyEpoch() const {
+    return globalPropertyEpoch_;
+  }
+
+  /// Invalidate the global cells of every property cache, because a property
+  /// of the global object was deleted or reconfigured, or its slots moved.
+  void invalidateGlobalPropertyCells() {
+    if (LLVM_UNLIKELY(++globalPropertyEpoch_ == 0))
+      globalPropertyEpoch_ = 1;
+  }
+
   /// Return the JIT context.
   JITContext &getJITContext() {
     return jitContext_;
   }
+
+#ifndef HERMESVM_LEAN
+  /// \return the queue compiling lazy functions ahead of their first call, or
+  /// null if lazy precompilation is disabled.
+  LazyCompileQueue *getLazyCompileQueue() {
+    return lazyCompileQueue_.get();
+  }
+#endif
   /// Returns trailing data for all runtime modules.
   std::vector<llvm::ArrayRef<uint8_t>> getEpilogues();
 
@@ -458,6 +582,36 @@ class Runtime : public HandleRootOwner,
   /// Print the heap and other misc. stats to the given stream.
   void printHeapStats(llvm::raw_ostream &os);
 
+  /// The memory held by the runtime outside of the objects it allocates in the
+  /// JS heap, by category, in bytes.
+  struct NativeMemoryInfo {
+    /// The IdentifierTable and the strings it owns.
+    size_t identifierTable{0};
+    /// The RuntimeModules and their string, function, object literal hidden
+    /// class and template object tables.
+    size_t runtimeModules{0};
+    /// The CodeBlocks owned by the RuntimeModules.
+    size_t codeBlocks{0};
+    /// The arenas holding the property caches of the CodeBlocks.
+    size_t propertyCaches{0};
+    /// The transition tables of the hidden classes.
+    size_t hiddenClassTransitions{0};
+    /// The property maps of the hidden classes. They are allocated in the JS
+    /// heap, so they are also part of \c GCBase::HeapInfo::allocatedBytes.
+    size_t hiddenClassPropertyMaps{0};
+    /// The executable memory mapped by the JIT.
+    size_t jitCode{0};
+    /// The bytecode buffers of the RuntimeModules.
+    size_t bytecode{0};
+    /// The part of the bytecode buffers currently resident in RAM, or 0 if it
+    /// can't be determined.
+    size_t bytecodeResident{0};
+  };
+
+  /// Fill \p info with the memory held by the runtime outside of the JS heap.
+  /// This walks the whole heap, so it is meant for diagnostics.
+  void getNativeMemoryInfo(NativeMemoryInfo &info);
+
 #ifndef NDEBUG
   /// Iterate over all arrays in the heap and print their sizes and capacities.
   void printArrayCensus(llvm::raw_ostream &os);
@@ -488,6 +642,23 @@ class Runtime : public HandleRootOwner,
     triggerAsyncBreak(AsyncBreakReasonBits::Timeout);
   }
 
+  /// Request the interpreter loop to call the interrupt handler at the next
+  /// async break check. This may be called from any thread, or a signal
+  /// handler.
+  void triggerInterruptAsyncBreak() {
+    triggerAsyncBreak(AsyncBreakReasonBits::Interrupt);
+  }
+
+  /// Called on the thread running the runtime to take an interrupt. It may
+  /// run JS; an exception it raises is thrown where the interrupt was taken.
+  using InterruptHandler = std::function<ExecutionStatus()>;
+
+  /// Set the function that takes the interrupts requested by
+  /// triggerInterruptAsyncBreak(). Without one, they are ignored.
+  void setInterruptHandler(InterruptHandler handler) {
+    interruptHandler_ = std::move(handler);
+  }
+
   /// Register \p callback which will be called
   /// during runtime destruction.
   void registerDestructionCallback(DestructionCallback callback) {
@@ -600,6 +771,15 @@ class Runtime : public HandleRootOwner,
   ExecutionStatus stepFunction(InterpreterState &state);
 #endif
 
+#ifdef HERMESVM_JIT
+  /// Continue running \p codeBlock in the interpreter from the instruction at
+  /// \p offset, in the current frame, which JIT'ed code has set up and left
+  /// every register of in its frame slot. Like the JIT'ed code would, return
+  /// when the function returns or throws an exception that it doesn't catch,
+  /// and leave the frame to be popped by the caller.
+  CallResult<HermesValue> resumeFunction(CodeBlock *codeBlock, uint32_t offset);
+#endif
+
   /// Inserts an object into the string cycle checking stack.
   /// \return true if a cycle was found
   CallResult<bool> insertVisitedObject(Handle<JSObject> obj);
@@ -645,6 +825,13 @@ class Runtime : public HandleRootOwner,
   /// Track time spent of each opcode in the interpreter, in CPU cycles.
   uint64_t timeSpent[256] = {0};
 
+  /// Track how often each opcode is executed right after each other opcode,
+  /// indexed by [previous][current], to find candidates for fusing.
+  uint32_t opcodePairFrequency[256][256] = {{0}};
+
+  /// The number of opcode pairs listed by dumpOpcodeStats().
+  static constexpr unsigned kNumDumpedOpcodePairs = 100;
+
   /// Dump opcode stats to a stream.
   void dumpOpcodeStats(llvm::raw_ostream &os) const;
 #endif
@@ -712,9 +899,100 @@ class Runtime : public HandleRootOwner,
     return vmExperimentFlags_;
   }
 
+  /// \return the largest number of frames recorded in the stack trace of an
+  /// Error, or 0 if there is no limit.
+  unsigned getMaxStackTraceDepth() const {
+    return maxStackTraceDepth_;
+  }
+
   // Return a reference to the runtime's CrashManager.
   inline CrashManager &getCrashManager();
 
+  /// \return the sampling profiler this runtime is registered with.
+  const std::shared_ptr<SamplingProfiler> &getSamplingProfiler() const {
+    return samplingProfiler_;
+  }
+
+  /// Register this runtime with \p profiler instead of its current sampling
+  /// profiler, e.g. to sample it independently of the process-wide one.
+  /// Must be called on the thread running the runtime.
+  void setSamplingProfiler(std::shared_ptr<SamplingProfiler> profiler);
+
+  /// Publish \p ip as the instruction the interpreter is about to execute,
+  /// for the sampling profiler to tell what the leaf frame is doing.
+  void setCurrentIP(const inst::Inst *ip) {
+    currentIP_.store(ip, std::memory_order_relaxed);
+  }
+
+  /// \return the instruction the interpreter last published. It is stale
+  /// whenever the leaf frame is not interpreted, so it has to be checked
+  /// against the leaf frame's code block.
+  const inst::Inst *getCurrentIP() const {
+    return currentIP_.load(std::memory_order_relaxed);
+  }
+
+  /// Start sampling allocations, on average one every \p samplingInterval
+  /// bytes, and attributing each to the JS stack that made it. Samples taken
+  /// before are discarded.
+  /// \return false if allocation sampling is not supported on this platform.
+  bool enableAllocationSampling(uint64_t samplingInterval);
+
+  /// Stop sampling allocations and discard the samples.
+  void disableAllocationSampling();
+
+  /// Write the allocations sampled so far to \p OS in the Chrome sampling
+  /// heap profile format, with the bytes still alive and allocated in total
+  /// by each stack.
+  void dumpSampledAllocations(llvm::raw_ostream &OS);
+
+  /// Start measuring the wall and CPU time and counting the calls of every JS
+  /// function, in the interpreter and in JIT compiled code. Measurements
+  /// taken before are discarded.
+  void enableFunctionProfiling();
+
+  /// Stop measuring the JS functions and discard the measurements.
+  void disableFunctionProfiling();
+
+  /// Write the self wall time of every call stack measured so far to \p OS
+  /// as flame graph folded stacks, in microseconds.
+  void dumpFunctionProfile(llvm::raw_ostream &OS);
+
+  /// Write the calls, and the self and total wall and CPU times of every
+  /// function measured so far to \p OS as a JSON array.
+  void dumpFunctionProfileSummary(llvm::raw_ostream &OS);
+
+  /// Tell the function profiler, if it is enabled, that \p codeBlock starts
+  /// running in the frame at \p frame.
+  void functionProfilerEnter(
+      CodeBlock *codeBlock,
+      const PinnedHermesValue *frame) {
+    if (LLVM_UNLIKELY(functionProfilerActive_))
+      functionProfilerEnterSlow(codeBlock, frame);
+  }
+
+  /// Tell the function profiler, if it is enabled, that the function running
+  /// in the frame at \p frame returns or unwinds.
+  void functionProfilerExit(const PinnedHermesValue *frame) {
+    if (LLVM_UNLIKELY(functionProfilerActive_))
+      functionProfilerExitSlow(frame);
+  }
+
+  /// \return whether new calls into JS have to run in the instrumented
+  /// interpreter loop, because functions are being profiled or, in debugger
+  /// builds, the debugger is active.
+  bool needsInstrumentedInterpreter() const {
+#ifdef HERMES_ENABLE_DEBUGGER
+    if (debugger_.isActive())
+      return true;
+#endif
+    return functionProfilerActive_;
+  }
+
+  /// Write the hit, miss and eviction counts of every property cache entry
+  /// that has been used to \p OS as a JSON array, with the property and the
+  /// source location of the accesses sharing the entry, most misses first.
+  void dumpPropertyCacheStats(llvm::raw_ostream &OS);
+
   /// Returns a string representation of the JS stack.  Does no operations
   /// that allocate on the JS heap, so safe to use for an out-of-memory
   /// exception.
@@ -766,13 +1044,14 @@ class Runtime : public HandleRootOwner,
   /// collected.
   void preventHCGC(HiddenClass *hc);
 
-  /// Inserts Hidden Classes into InlineCacheProfiler
+  /// Inserts Hidden Classes into InlineCacheProfiler. The access is a hit if
+  /// \p objectHiddenClass is any of the classes in \p cacheEntry.
   void recordHiddenClass(
       CodeBlock *codeBlock,
       const Inst *cacheMissInst,
       SymbolID symbolID,
       HiddenClass *objectHiddenClass,
-      HiddenClass *cachedHiddenClass);
+      const PropertyCacheEntry &cacheEntry);
 
   /// Resolve HiddenClass pointers from its hidden class Id.
   HiddenClass *resolveHiddenClassId(ClassId classId);
@@ -846,6 +1125,11 @@ class Runtime : public HandleRootOwner,
   /// 1) a function that returns the global object.
   static std::unique_ptr<Buffer> generateSpecialRuntimeBytecode();
 
+  /// \return a non-owning view of the special runtime bytecode, which is
+  /// generated once per process and shared by all runtimes, since it is
+  /// immutable and does not depend on the runtime.
+  static std::unique_ptr<Buffer> getSharedSpecialRuntimeBytecode();
+
   /// Insert the predefined strings into the IdentifierTable.
   /// NOTE: this function does not do any allocations in the GC heap, it is safe
   /// to use at any time in initialization.
@@ -930,6 +1214,14 @@ class Runtime : public HandleRootOwner,
   /// All state related to JIT compilation.
   JITContext jitContext_;
 
+  /// Loads segments of the running bundle on demand, if set.
+  SegmentLoader segmentLoader_;
+
+#ifndef HERMESVM_LEAN
+  /// Compiles lazy functions in the background, if enabled.
+  std::unique_ptr<LazyCompileQueue> lazyCompileQueue_;
+#endif
+
   /// Set to true if we should enable ES6 Symbol.
   const bool hasES6Symbol_;
 
@@ -950,6 +1242,17 @@ class Runtime : public HandleRootOwner,
   /// bit values, typically 1 as test and 0 as control.
   experiments::VMExperimentFlags vmExperimentFlags_{experiments::Default};
 
+  /// The largest number of frames recorded in the stack trace of an Error, or
+  /// 0 if there is no limit.
+  const unsigned maxStackTraceDepth_;
+
+  /// Whether the destructor only runs the finalizers which are observable
+  /// outside the runtime.
+  const bool fastTeardown_;
+
+  /// The number of bytes leaked by the fast teardowns of all runtimes.
+  static std::atomic<uint64_t> fastTeardownLeakedBytes_;
+
   friend class GCScope;
   friend class HandleBase;
   friend class Interpreter;
@@ -980,6 +1283,19 @@ class Runtime : public HandleRootOwner,
   /// The global symbol registry.
   SymbolRegistry symbolRegistry_{};
 
+  /// The hidden class transitions looked up most recently.
+  TransitionCache transitionCache_{};
+
+  /// The bytecode of the regexps compiled most recently.
+  RegExpCache regExpCache_;
+
+  /// The bytecode of the sources compiled most recently by eval.
+  EvalCache evalCache_;
+
+  /// The builtins keeping their native implementation rather than the one
+  /// of the JS library, by their path from the global object.
+  std::vector<std::string> nativeLibraryFunctions_;
+
   /// Set of runtime statistics.
   instrumentation::RuntimeStats runtimeStats_;
 
@@ -1008,9 +1324,12 @@ class Runtime : public HandleRootOwner,
 
   PinnedHermesValue *registerStack_;
   PinnedHermesValue *registerStackEnd_;
+  /// registerStack_ + STACK_RESERVE, the lowest stack pointer that a checked
+  /// allocation may leave.
+  PinnedHermesValue *registerStackLimit_;
   PinnedHermesValue *stackPointer_;
-  /// Bytes of register stack to unmap on destruction.
-  /// When set to zero, the register stack is not allocated
+  /// Bytes of register stack to unmap on destruction, including the guard
+  /// page below it. When set to zero, the register stack is not allocated
   /// by the runtime itself.
   uint32_t registerStackBytesToUnmap_{0};
   /// Manages data to be used in the case of a crash.
@@ -1034,6 +1353,10 @@ class Runtime : public HandleRootOwner,
   /// Raw pointer to the root of all hidden classes.
   HiddenClass *rootClazzRawPtr_{};
 
+  /// The epoch of the global cells of the property caches; see
+  /// getGlobalPropertyEpoch().
+  uint32_t globalPropertyEpoch_{1};
+
   /// Cache for property lookups in non-JS code.
   PropertyCacheEntry fixedPropCache_[(size_t)PropCacheID::_COUNT];
 
@@ -1042,9 +1365,40 @@ class Runtime : public HandleRootOwner,
   /// to be scanned as roots in young-gen collections.
   std::vector<PinnedHermesValue> charStrings_{};
 
+  /// An entry of the number to string cache.
+  struct NumberStringCacheEntry {
+    /// The bits of the number. Zero, the bits of +0, is never looked up, so
+    /// it marks the unused entries.
+    uint64_t bits{0};
+    /// The string of the number.
+    PinnedHermesValue str{};
+  };
+
+  /// Number of entries of the number to string cache, a power of 2.
+  static constexpr unsigned kNumberStringCacheSizeLog2 = 6;
+
+  /// \return the index of the entry of the number to string cache for the
+  /// number with the bits \p bits.
+  static unsigned numberStringHash(uint64_t bits) {
+    // The low bits of integers and short fractions are zero, so fold the
+    // upper half in before hashing.
+    uint32_t folded = static_cast<uint32_t>(bits ^ (bits >> 32));
+    return (folded * 0x9E3779B9u) >> (32 - kNumberStringCacheSizeLog2);
+  }
+
+  /// A direct-mapped cache of the strings of recently converted numbers, so
+  /// that repeatedly stringified numbers, like array indices used as property
+  /// keys, share one string. The strings are marked as roots in every
+  /// collection.
+  NumberStringCacheEntry numberStringCache_[1u << kNumberStringCacheSizeLog2];
+
   /// Pointers to native implementations of builtins.
   std::vector<NativeFunction *> builtins_{};
 
+  /// The builtins whose properties are defined when first used, indexed by
+  /// their index minus one. Their objects are marked as roots.
+  std::vector<LazyBuiltin> lazyBuiltins_{};
+
   /// True if the builtins are all frozen (non-writable, non-configurable).
   bool builtinsFrozen_{false};
 
@@ -1063,6 +1417,35 @@ class Runtime : public HandleRootOwner,
   /// we are sure it's safe to unregisterRuntime in destructor.
   std::shared_ptr<SamplingProfiler> samplingProfiler_;
 
+  /// The instruction the interpreter last dispatched. It is read from the
+  /// sampling profiler's signal handler, hence atomic; a relaxed store is a
+  /// plain store on every supported target.
+  std::atomic<const inst::Inst *> currentIP_{nullptr};
+
+  /// Bytes left to allocate before the next allocation sample. It is never
+  /// exhausted while allocation sampling is disabled.
+  int64_t allocationBytesUntilSample_{INT64_MAX};
+
+#ifndef _WINDOWS
+  /// Samples the allocations while allocation sampling is enabled.
+  std::unique_ptr<AllocationProfiler> allocationProfiler_;
+#endif
+
+  /// Take an allocation sample of the \p size bytes at \p mem.
+  void sampleAllocation(const void *mem, uint32_t size);
+
+  /// Whether the function profiler is enabled. It is read by JIT compiled
+  /// code at the entry and exit of every function.
+  bool functionProfilerActive_{false};
+
+  /// Measures the JS functions while function profiling is enabled.
+  std::unique_ptr<FunctionProfiler> functionProfiler_;
+
+  void functionProfilerEnterSlow(
+      CodeBlock *codeBlock,
+      const PinnedHermesValue *frame);
+  void functionProfilerExitSlow(const PinnedHermesValue *frame);
+
   /// A list of callbacks to call before runtime destruction.
   std::vector<DestructionCallback> destructionCallbacks_;
 
@@ -1071,6 +1454,7 @@ class Runtime : public HandleRootOwner,
     DebuggerExplicit = 0x1,
     DebuggerImplicit = 0x2,
     Timeout = 0x4,
+    Interrupt = 0x8,
   };
 
   /// An atomic flag set when an async pause is requested.
@@ -1089,6 +1473,14 @@ class Runtime : public HandleRootOwner,
         (uint8_t)AsyncBreakReasonBits::DebuggerImplicit);
   }
 
+  /// \return whether a debugger async pause was requested, leaving the
+  /// request to be taken.
+  bool hasDebuggerAsyncBreakRequest() const {
+    return asyncBreakRequestFlag_.load(std::memory_order_relaxed) &
+        ((uint8_t)AsyncBreakReasonBits::DebuggerExplicit |
+         (uint8_t)AsyncBreakReasonBits::DebuggerImplicit);
+  }
+
   Debugger debugger_{this};
 #endif
 
@@ -1128,9 +1520,26 @@ class Runtime : public HandleRootOwner,
     asyncBreakRequestFlag_.fetch_or((uint8_t)reason, std::memory_order_relaxed);
   }
 
+  /// \return whether an interrupt was requested or not. Clear the interrupt
+  /// request bit afterward.
+  bool testAndClearInterruptAsyncBreakRequest() {
+    return testAndClearAsyncBreakRequest(
+        (uint8_t)AsyncBreakReasonBits::Interrupt);
+  }
+
   /// Notify runtime execution has timeout.
   ExecutionStatus notifyTimeout();
 
+  /// Call the interrupt handler, unless it is already running, in which case
+  /// the interrupt is taken once it returns.
+  ExecutionStatus notifyInterrupt();
+
+  /// Takes the interrupts, if set.
+  InterruptHandler interruptHandler_{};
+
+  /// Whether interruptHandler_ is running.
+  bool inInterruptHandler_{false};
+
   /// Holds references to persistent BC providers for the lifetime of the
   /// Runtime. This is needed because the identifier table may contain pointers
   /// into bytecode, and so memory backing these must be preserved.
@@ -1331,6 +1740,24 @@ class ScopedNativeCallFrame {
     std::uninitialized_fill_n(&frame_.getArgRefUnsafe(0), argCount, fillValue);
   }
 
+  /// Prepare the frame for another call of \p callee with the same number
+  /// \p argCount of arguments and \p thisArg. A call may clobber the frame
+  /// metadata and "this", so they are initialized again, and the caller must
+  /// store the arguments again. This lets a loop call a function many times
+  /// without setting up a new frame for every call.
+  void reinitialize(uint32_t argCount, Callable *callee, HermesValue thisArg) {
+    assert(!overflowed() && "ScopedNativeCallFrame overflowed");
+    frame_ = StackFramePtr::initFrame(
+        frame_.ptr(),
+        runtime_->currentFrame_,
+        nullptr,
+        nullptr,
+        argCount,
+        HermesValue::encodeObjectValue(callee),
+        HermesValue::encodeUndefinedValue());
+    frame_.getThisArgRef() = thisArg;
+  }
+
   /// \return whether the stack frame overflowed.
   bool overflowed() const {
     return overflowed_;
@@ -1389,12 +1816,29 @@ inline void Runtime::addCustomWeakRootsFunction(
 
 template <bool fixedSize, HasFinalizer hasFinalizer>
 inline void *Runtime::alloc(uint32_t sz) {
-  return heap_.alloc<fixedSize, hasFinalizer>(sz);
+  void *mem = heap_.alloc<fixedSize, hasFinalizer>(sz);
+  countAllocation(mem, sz);
+  return mem;
 }
 
 template <HasFinalizer hasFinalizer>
 inline void *Runtime::allocLongLived(uint32_t size) {
-  return heap_.allocLongLived<hasFinalizer>(size);
+  void *mem = heap_.allocLongLived<hasFinalizer>(size);
+  countAllocation(mem, size);
+  return mem;
+}
+
+template <HasFinalizer hasFinalizer>
+inline void *Runtime::allocPretenured(uint32_t size) {
+  void *mem = heap_.allocPretenured<hasFinalizer>(size);
+  countAllocation(mem, size);
+  return mem;
+}
+
+inline void Runtime::countAllocation(const void *mem, uint32_t size) {
+  if (LLVM_UNLIKELY((allocationBytesUntilSample_ -= size) < 0)) {
+    sampleAllocation(mem, size);
+  }
 }
 
 template <typename T>
@@ -1481,9 +1925,9 @@ inline uint32_t Runtime::availableStackSize() const {
 }
 
 inline bool Runtime::checkAvailableStack(uint32_t count) {
-  // Note: use 64-bit arithmetic to avoid overflow. We could also do it with
-  // a couple of comparisons, but that is likely to be slower.
-  return availableStackSize() >= (uint64_t)count + STACK_RESERVE;
+  // The reserve is folded into the limit, and the difference is signed since
+  // unchecked allocations may already have dipped into it.
+  return stackPointer_ - registerStackLimit_ >= (ptrdiff_t)count;
 }
 
 inline PinnedHermesValue *Runtime::allocUninitializedStack(uint32_t count) {
@@ -16,10 +16,12 @@
 #include "hermes/VM/WeakRef.h"
 
 #include "llvm/ADT/simple_ilist.h"
+#include "llvm/Support/Allocator.h"
 
 namespace hermes {
 namespace vm {
 
+class ArrayStorage;
 class CodeBlock;
 class Runtime;
 
@@ -45,6 +47,10 @@ union RuntimeModuleFlags {
     /// Whether this runtime module's epilogue should be hidden in
     /// runtime.getEpilogues().
     bool hidesEpilogue : 1;
+
+    /// Whether the bytecode buffer is immutable and may be mapped by other
+    /// processes, so that nothing may ever be written into it.
+    bool sharedBytecode : 1;
   };
   uint8_t flags;
   RuntimeModuleFlags() : flags(0) {}
@@ -114,6 +120,22 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// A map from template object ids to template objects.
   llvm::DenseMap<uint32_t, JSObject *> templateMap_;
 
+  /// A map from the key returned by getLiteralValuesKey() to the decoded
+  /// values of a literal, which new literals are filled from in bulk. A null
+  /// entry records that the literal has been created once; its values are only
+  /// kept when it is created again.
+  llvm::DenseMap<uint64_t, ArrayStorage *> literalValues_;
+
+  /// Holds the property caches of the CodeBlocks owned by this module, which
+  /// are freed along with it.
+  llvm::BumpPtrAllocator propertyCacheAllocator_;
+
+#ifdef HERMES_ENABLE_DEBUGGER
+  /// Holds the private copies of the bytecode of the functions of a module
+  /// with shared bytecode, which the debugger patches breakpoints into.
+  llvm::BumpPtrAllocator privateBytecodeAllocator_;
+#endif
+
   /// Registers the created RuntimeModule with \param domain, resulting in
   /// \param domain owning it. The RuntimeModule will be freed when the
   /// domain is collected..
@@ -125,6 +147,9 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
 
   CodeBlock *getCodeBlockSlowPath(unsigned index);
 
+  /// \return the bytecode that the CodeBlock of function \p index executes.
+  const uint8_t *getFunctionBytecode(unsigned index);
+
 #ifdef HERMESVM_SERIALIZE
   /// Constructor used when deserializing.
   /// Note that this function does NOT add the new RumtimeModule to Domain's
@@ -191,8 +216,9 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
 
   /// Initialize lazy modules created with \p createUninitialized.
   /// Calls `initialize` and does a bit of extra work.
-  /// \param bytecode the bytecode data to initialize it with.
-  void initializeLazyMayAllocate(std::unique_ptr<hbc::BCProvider> bytecode);
+  /// \param bytecode the bytecode data to initialize it with, which may be
+  ///   shared with the runtimes that compiled the same function.
+  void initializeLazyMayAllocate(std::shared_ptr<hbc::BCProvider> bytecode);
 #endif
 
   /// If this function was lazily compiled, return the RuntimeModule with the
@@ -207,6 +233,11 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
 #endif
   }
 
+  /// \return the runtime this module belongs to.
+  Runtime *getRuntime() const {
+    return runtime_;
+  }
+
   /// Initialize modules created with \p createUninitialized,
   /// but do not import the CJS module table, allowing us to always succeed.
   /// \param bytecode the bytecode data to initialize it with.
@@ -227,12 +258,14 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// For opcodes that use a stringID as identifier explicitly, we know that
   /// the compiler would have marked the stringID as identifier, and hence
   /// we should have created the symbol during identifier table initialization.
-  /// The symbol must already exist in the map. This is a fast path.
+  /// The identifiers of a persistent module are instead mapped on first use,
+  /// which only registers a lazy identifier and doesn't allocate in the JS
+  /// heap. This is a fast path.
   SymbolID getSymbolIDMustExist(StringID stringID) {
-    assert(
-        stringIDMap_[stringID].isValid() &&
-        "Symbol must exist for this string ID");
-    return stringIDMap_[stringID];
+    SymbolID id = stringIDMap_[stringID];
+    if (LLVM_UNLIKELY(!id.isValid()))
+      return importIdentifier(stringID);
+    return id;
   }
 
   /// \return the \c SymbolID for a string by string index. The symbol may not
@@ -274,6 +307,20 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
     return getCodeBlockSlowPath(index);
   }
 
+  /// \return \p size new property cache entries, which live as long as this
+  /// module.
+  PropertyCacheEntry *allocatePropertyCache(uint32_t size) {
+    auto *cache = propertyCacheAllocator_.Allocate<PropertyCacheEntry>(size);
+    std::uninitialized_fill_n(cache, size, PropertyCacheEntry{});
+    return cache;
+  }
+
+  /// \return the CodeBlock for a function by function index, or nullptr if it
+  /// hasn't been created yet.
+  CodeBlock *getCodeBlockIfCreated(unsigned index) const {
+    return functionMap_[index];
+  }
+
   /// \return whether this RuntimeModule has been initialized.
   bool isInitialized() const {
     return !bcProvider_->isLazy();
@@ -343,6 +390,20 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// RuntimeModule.
   size_t additionalMemorySize() const;
 
+  /// \return the memory used by the tables mapping the strings, functions,
+  /// object literal hidden classes and template objects of this module.
+  size_t tableMemorySize() const;
+
+  /// \return the memory used by the CodeBlocks owned by this module and any
+  /// private copies of their bytecode, not counting their property caches.
+  size_t codeBlockMemorySize() const;
+
+  /// \return the memory of the arena holding the property caches of the
+  /// CodeBlocks owned by this module.
+  size_t propertyCacheMemorySize() const {
+    return propertyCacheAllocator_.getTotalMemory();
+  }
+
   /// Find the cached hidden class for an object literal, if one exists.
   /// \param keyBufferIndex value of NewObjectWithBuffer instruction.
   /// \param numLiterals number of literals used from key buffer of
@@ -358,6 +419,19 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// \param clazz the hidden class to cache.
   void tryCacheLiteralHiddenClass(unsigned keyBufferIndex, HiddenClass *clazz);
 
+  /// The buffers that the values of array and object literals come from.
+  enum class LiteralValueBuffer : uint8_t { Array, Object };
+
+  /// Get the values of the literal made of the \p numLiterals values at
+  /// \p bufferIndex of \p buffer, so that a new literal can be filled with
+  /// them in a single copy. They are decoded the second time the literal is
+  /// created, so literals which are only created once cost no extra memory.
+  /// \return the values, or nullptr if this is the first time.
+  ArrayStorage *getLiteralValuesMayAllocate(
+      LiteralValueBuffer buffer,
+      uint32_t bufferIndex,
+      unsigned numLiterals);
+
   /// Given \p templateObjectID, retrieve the cached template object.
   /// if it doesn't exist, return a nullptr.
   JSObject *findCachedTemplateObject(uint32_t templateObjID) {
@@ -392,6 +466,11 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// Import the string table from the supplied module.
   void importStringIDMapMayAllocate();
 
+  /// Map the identifier \p stringID of a persistent module on its first use,
+  /// registering it as a lazy identifier.
+  /// \return its symbol ID.
+  SymbolID importIdentifier(StringID stringID);
+
   /// Initialize functionMap_, without actually creating the code blocks.
   /// They will be created lazily when needed.
   void initializeFunctionMap();
@@ -437,6 +516,16 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
     return ((uint32_t)keyBufferIndex << 8) | numLiterals;
   }
 
+  /// \return the key of the values of a literal in literalValues_.
+  static uint64_t getLiteralValuesKey(
+      LiteralValueBuffer buffer,
+      uint32_t bufferIndex,
+      unsigned numLiterals) {
+    assert(numLiterals <= UINT16_MAX && "too many literals");
+    return ((uint64_t)bufferIndex << 32) | (numLiterals << 1) |
+        (buffer == LiteralValueBuffer::Object);
+  }
+
   /// \return whether tuple <keyBufferIndex, numLiterals> can generate a
   /// hidden class literal cache hash key or not.
   /// \param keyBufferIndex value of NewObjectWithBuffer instruction; it must
@@ -9,6 +9,7 @@
 #define HERMES_VM_RUNTIMESTATS_H
 
 #include "hermes/Support/PerfSection.h"
+#include "hermes/VM/instrumentation/PerfEvents.h"
 
 #include <stdint.h>
 #include <chrono>
@@ -29,10 +30,14 @@ struct RuntimeStats {
     int64_t threadMajorFaults{0};
     long volCtxSwitches{0};
     long involCtxSwitches{0};
+    /// The hardware counters of the thread, which stay zero where they are
+    /// not available.
+    HardwareCounters hardware{};
   };
 
   /// A Statistic tracks duration in wall and CPU time, (optionally) the number
-  /// of minor and major faults, and a count.  All times are in seconds.
+  /// of minor and major faults and the hardware counters, and a count.  All
+  /// times are in seconds.
   struct Statistic {
     double wallDuration{0};
     double cpuDuration{0};
@@ -51,6 +56,12 @@ struct RuntimeStats {
   /// Measure of of jsi Function calls (incoming to VM).
   Statistic incomingFunction;
 
+  /// Measure of the JIT compilations done on the runtime's thread.
+  Statistic jitCompile;
+
+  /// Measure of the creation of the runtime modules of loaded bytecode.
+  Statistic moduleInit;
+
   /// The topmost RAIITimer in the stack.
   RAIITimer *timerStack{nullptr};
 
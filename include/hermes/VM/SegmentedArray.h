@@ -264,6 +264,16 @@ class SegmentedArray final
     }
   }
 
+  /// Overwrite the elements starting at \p index with [\p first, \p last),
+  /// which must all be within the size. Each contiguous run of the storage is
+  /// written with a single copy. The elements are being initialized, so the
+  /// write barriers are skipped when the GC allows it.
+  void setRange(
+      Runtime *runtime,
+      size_type index,
+      GCHermesValue *first,
+      GCHermesValue *last);
+
   /// Get the element located at \p index. \p const function for read.
   const GCHermesValue &at(size_type index) const {
     assert(index < size() && "Invalid index.");
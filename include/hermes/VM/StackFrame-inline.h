@@ -46,6 +46,7 @@ inline Callable *StackFramePtrT<isConst>::getCalleeClosure() const {
   return dyn_vmcast<Callable>(getCalleeClosureOrCBRef());
 }
 
+#ifdef HERMES_ENABLE_DEBUGGER
 template <bool isConst>
 inline Handle<Environment> StackFramePtrT<isConst>::getDebugEnvironmentHandle()
     const {
@@ -60,6 +61,7 @@ inline Environment *StackFramePtrT<isConst>::getDebugEnvironment() const {
       ? nullptr
       : vmcast_or_null<Environment>(getDebugEnvironmentRef());
 }
+#endif
 
 } // namespace vm
 } // namespace hermes
@@ -101,7 +101,9 @@ class StackFramePtrT {
   // Declare convenience accessors to the underlying HermesValue slots.
   _HERMESVM_DEFINE_STACKFRAME_REF(FirstLocal)
   _HERMESVM_DEFINE_STACKFRAME_REF(Scratch)
+#ifdef HERMES_ENABLE_DEBUGGER
   _HERMESVM_DEFINE_STACKFRAME_REF(DebugEnvironment)
+#endif
   _HERMESVM_DEFINE_STACKFRAME_REF(PreviousFrame)
   _HERMESVM_DEFINE_STACKFRAME_REF(SavedIP)
   _HERMESVM_DEFINE_STACKFRAME_REF(SavedCodeBlock)
@@ -142,6 +144,7 @@ class StackFramePtrT {
     return getSavedCodeBlockRef().template getNativePointer<CodeBlock>();
   }
 
+#ifdef HERMES_ENABLE_DEBUGGER
   /// \return a handle holding the callee debug environment.
   /// The environment associated with the callee's stack frame, that is, the
   /// Environment created by the last CreateEnvironment instruction to execute
@@ -161,6 +164,7 @@ class StackFramePtrT {
   /// is stored in the call frame so that the debugger can gain access to the
   /// Environment at arbitrary frames. Note this is managed by the GC.
   inline Environment *getDebugEnvironment() const;
+#endif
 
   /// \return the number of JavaScript arguments passed to the callee excluding
   /// \c "this".
@@ -8,6 +8,9 @@
 #ifndef HERMES_VM_STORAGEPROVIDER_H
 #define HERMES_VM_STORAGEPROVIDER_H
 
+#include "hermes/Public/GCConfig.h"
+#include "hermes/Public/StoragePool.h"
+
 #include "llvm/Support/ErrorOr.h"
 
 #include <limits>
@@ -37,14 +40,46 @@ class StorageProvider {
   static llvm::ErrorOr<std::unique_ptr<StorageProvider>>
   preAllocatedProvider(size_t amount, size_t minAmount, size_t excess);
 
-  /// Provide storage from mmap'ed separate regions.
-  static std::unique_ptr<StorageProvider> mmapProvider();
+  /// Provide storage from mmap'ed separate regions, backed by huge pages as
+  /// requested by \p hugePages.  Where huge pages are not available, the
+  /// storage is backed by normal pages.
+  static std::unique_ptr<StorageProvider> mmapProvider(
+      HugePagesMode hugePages = kHugePagesNone);
+
+  /// Provide storage from mmap'ed separate regions, like mmapProvider, but
+  /// recycle deleted storages through a pool shared by every pooled provider
+  /// in the process, so that runtimes created after others are destroyed
+  /// reuse their storages rather than mapping new ones.
+  static std::unique_ptr<StorageProvider> pooledProvider(
+      HugePagesMode hugePages = kHugePagesNone);
 
   /// Provide storage via malloc.
   static std::unique_ptr<StorageProvider> mallocProvider();
 
   /// @}
 
+  /// @name Process-wide storage pool
+  /// @{
+
+  /// By default, the pool retains up to this many bytes of storages.
+  static constexpr size_t kDefaultStoragePoolMaxBytes = 64 << 20;
+
+  /// Retain at most \p maxBytes of deleted storages in the pool, unmapping
+  /// those beyond it (including any already retained), and apply \p zeroing
+  /// to storages as they are deleted.
+  static void configureStoragePool(
+      size_t maxBytes,
+      StoragePoolZeroing zeroing = StoragePoolZeroing::None);
+
+  /// \return the number of bytes of storages retained by the pool.
+  static size_t storagePoolBytes();
+
+  /// Unmap every storage retained by the pool.  \return the number of bytes
+  /// released.
+  static size_t drainStoragePool();
+
+  /// @}
+
   /// Create a new segment memory space.
   llvm::ErrorOr<void *> newStorage() {
     return newStorage(nullptr);
@@ -115,15 +115,22 @@ class StringBuilder {
     }
   }
 
-  /// Append the first \p length characters from StringPrimitive \p other.
-  void appendStringPrim(Handle<StringPrimitive> other, uint32_t length) {
+  /// Append the \p length characters from StringPrimitive \p other starting
+  /// at \p start.
+  void appendStringPrim(
+      Handle<StringPrimitive> other,
+      uint32_t start,
+      uint32_t length) {
+    assert(
+        start + length <= other->getStringLength() &&
+        "StringBuilder append source out of bound");
     assert(
         index_ + length <= strPrim_->getStringLength() &&
         "StringBuilder append out of bound");
     if (other->isASCII()) {
-      appendASCIIRef({other->castToASCIIPointer(), length});
+      appendASCIIRef({other->castToASCIIPointer() + start, length});
     } else if (!strPrim_->isASCII()) {
-      appendUTF16Ref({other->castToUTF16Pointer(), length});
+      appendUTF16Ref({other->castToUTF16Pointer() + start, length});
     } else {
       // strPrim_ is ASCII, while other is UTF16. We have to recreate string.
       auto strRes = runtime_->ignoreAllocationFailure(StringPrimitive::create(
@@ -135,10 +142,15 @@ class StringBuilder {
       index_ = 0;
       // Append original string and other.
       appendASCIIRef(currentPartialString);
-      appendUTF16Ref({other->castToUTF16Pointer(), length});
+      appendUTF16Ref({other->castToUTF16Pointer() + start, length});
     }
   }
 
+  /// Append the first \p length characters from StringPrimitive \p other.
+  void appendStringPrim(Handle<StringPrimitive> other, uint32_t length) {
+    appendStringPrim(other, 0, length);
+  }
+
   /// Append all characters from StringPrimitive \p other.
   void appendStringPrim(Handle<StringPrimitive> other) {
     return appendStringPrim(other, other->getStringLength());
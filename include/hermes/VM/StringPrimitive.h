@@ -18,6 +18,8 @@
 
 #include "llvm/Support/TrailingObjects.h"
 
+#include <functional>
+#include <memory>
 #include <type_traits>
 
 namespace hermes {
@@ -138,6 +140,10 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   static constexpr uint32_t CONCAT_STRING_MIN_SIZE =
       256 > EXTERNAL_STRING_MIN_SIZE ? 256 : EXTERNAL_STRING_MIN_SIZE;
 
+  /// Slices of this size or larger of a string whose characters live in an
+  /// ExternalStringPrimitive may share them, as a BufferedStringPrimitive.
+  static constexpr uint32_t SLICE_STRING_MIN_SIZE = CONCAT_STRING_MIN_SIZE;
+
   static bool classof(const GCCell *cell) {
     return kindInRange(
         cell->getKind(),
@@ -549,11 +555,53 @@ class ExternalStringPrimitive final : public SymbolStringPrimitive {
     return cell->getKind() == ExternalStringPrimitive::getCellKind();
   }
 
+  /// Create a string of the \p length characters at \p chars, which are used
+  /// in place rather than copied, and are credited to the GC as external
+  /// memory. \p release is called once the characters are no longer needed,
+  /// when the string is finalized, or before returning if it could not be
+  /// created. The characters must not change until then. Throw \c RangeError
+  /// if the string is longer than \c MAX_STRING_LENGTH characters.
+  /// \pre length >= EXTERNAL_STRING_MIN_SIZE.
+  static CallResult<HermesValue> createForeign(
+      Runtime *runtime,
+      const T *chars,
+      uint32_t length,
+      std::function<void()> release);
+
+  /// \return true if the characters belong to the embedder, which is told
+  /// when they are released.
+  bool isForeign() const {
+    return foreign_ != nullptr;
+  }
+
  private:
   static const VTable vt;
 
+  /// The characters of a string created by createForeign(), which belong to
+  /// the embedder. They are released when this is destroyed.
+  struct Foreign {
+    const T *const chars;
+    const std::function<void()> release;
+
+    Foreign(const T *chars, std::function<void()> release)
+        : chars(chars), release(std::move(release)) {}
+    Foreign(const Foreign &) = delete;
+    Foreign &operator=(const Foreign &) = delete;
+    ~Foreign() {
+      if (release)
+        release();
+    }
+  };
+
   size_t calcExternalMemorySize() const {
-    return contents_.capacity() * sizeof(T);
+    return foreign_ ? getStringLength() * sizeof(T)
+                    : contents_.capacity() * sizeof(T);
+  }
+
+  /// \return the number of characters in the buffer, which a concatenation
+  /// may have made longer than the string.
+  size_t bufferSize() const {
+    return foreign_ ? getStringLength() : contents_.size();
   }
 
   /// Construct an ExternalStringPrimitive from the given string \p contents,
@@ -561,7 +609,15 @@ class ExternalStringPrimitive final : public SymbolStringPrimitive {
   template <class BasicString>
   ExternalStringPrimitive(Runtime *runtime, BasicString &&contents);
 
-  /// Destructor deallocates the contents_ string.
+  /// Construct an ExternalStringPrimitive using the foreign characters
+  /// \p foreign in place.
+  ExternalStringPrimitive(
+      Runtime *runtime,
+      uint32_t length,
+      std::unique_ptr<Foreign> foreign);
+
+  /// Destructor deallocates the contents_ string, or releases the foreign
+  /// characters.
   ~ExternalStringPrimitive() = default;
 
   /// Transfer ownership of an std::string into a new StringPrim. Throw \c
@@ -584,6 +640,8 @@ class ExternalStringPrimitive final : public SymbolStringPrimitive {
   static CallResult<HermesValue> create(Runtime *runtime, uint32_t length);
 
   const T *getRawPointer() const {
+    if (LLVM_UNLIKELY(foreign_ != nullptr))
+      return foreign_->chars;
     // C++11 defines this to be valid even if the string is empty.
     return &contents_[0];
   }
@@ -593,6 +651,7 @@ class ExternalStringPrimitive final : public SymbolStringPrimitive {
   /// normally be done, but for those rare cases, this method gives access to
   /// the writable buffer.
   T *getRawPointerForWrite() {
+    assert(!foreign_ && "foreign characters are immutable");
     // C++11 defines this to be valid even if the string is empty.
     return &contents_[0];
   }
@@ -611,8 +670,12 @@ class ExternalStringPrimitive final : public SymbolStringPrimitive {
   static void _snapshotAddNodesImpl(GCCell *cell, GC *gc, HeapSnapshot &snap);
 
   /// The backing storage of this string. Note that the string's length is fixed
-  /// and must always be equal to StringPrimitive::getStringLength().
+  /// and must always be equal to StringPrimitive::getStringLength(). Empty if
+  /// the characters are foreign.
   CopyableStdString contents_{};
+
+  /// The characters used in place of contents_, if they are foreign.
+  std::unique_ptr<Foreign> foreign_{};
 };
 
 /// An immutable JavaScript primitive consisting of a pointer to an
@@ -631,10 +694,16 @@ class ExternalStringPrimitive final : public SymbolStringPrimitive {
 /// \c globalThis.prop will keep the whole string alive, even though we no
 /// longer need the \c largeString suffix.
 ///
-/// The probability of this happening is not high, but it is possible. One way
-/// to adress this in the future is to create new ExternalStringPrimitive after
-/// a  certain amount of resizing. In this way each stage of the concatenation
-/// has an upper bound of the amount of extra memory it can keep alive.
+/// A BufferedStringPrimitive may also be a slice of a large string whose
+/// characters live in an ExternalStringPrimitive, in which case it starts at
+/// an offset in that buffer, and the buffer may be that very string. Slices
+/// much shorter than the buffer are copied instead, for the reason above.
+///
+/// To bound this, a buffer of at least \c NEW_BUFFER_MIN_SIZE characters is
+/// never grown in place: an append which doesn't fit in its capacity starts a
+/// new buffer with twice the room instead, which costs the same copy as growing
+/// a std::string. Each large stage of the concatenation thus keeps alive at
+/// most about twice its own length, and appends stay amortized linear.
 template <typename T>
 class BufferedStringPrimitive final : public StringPrimitive {
   friend class IdentifierTable;
@@ -674,6 +743,14 @@ class BufferedStringPrimitive final : public StringPrimitive {
     return cell->getKind() == BufferedStringPrimitive::getCellKind();
   }
 
+  /// Appending to a concatenation buffer at least this long, beyond its
+  /// capacity, starts a new buffer instead of growing it in place.
+  static constexpr uint32_t NEW_BUFFER_MIN_SIZE = 1 << 16;
+
+  /// A slice shares the buffer of its string only if the buffer is at most
+  /// this many times longer than the slice.
+  static constexpr uint32_t SLICE_MAX_BUFFER_RATIO = 4;
+
 #ifdef UNIT_TEST
   /// Expose the concatenation buffer for unit tests.
   ExternalStringPrimitive<T> *testGetConcatBuffer() const {
@@ -685,31 +762,59 @@ class BufferedStringPrimitive final : public StringPrimitive {
   static const VTable vt;
 
   /// Construct a BufferedStringPrimitive with the specified length \p length
-  /// and the associated concatenation buffer \p storage. Note that the length
-  /// of the primitive may be smaller than the length of the buffer.
+  /// at \p offset in the associated concatenation buffer \p storage. Note that
+  /// the length of the primitive may be smaller than the length of the buffer.
   BufferedStringPrimitive(
       Runtime *runtime,
       uint32_t length,
-      ExternalStringPrimitive<T> *concatBuffer)
+      ExternalStringPrimitive<T> *concatBuffer,
+      uint32_t offset)
       : StringPrimitive(
             runtime,
             &vt,
             sizeof(BufferedStringPrimitive<T>),
-            length) {
+            length),
+        offset_(offset) {
     concatBufferHV_.set(
         HermesValue::encodeObjectValue(concatBuffer), &runtime->getHeap());
     assert(
-        concatBuffer->contents_.size() >= length &&
+        concatBuffer->bufferSize() >= offset + length &&
         "length exceeds size of concatenation buffer");
   }
 
   /// Allocate a BufferedStringPrimitive with the specified length \p length
-  /// and the associated concatenation buffer \p storage. Note that the length
-  /// of the primitive may be smaller than the length of the buffer.
+  /// at \p offset in the associated concatenation buffer \p storage. Note that
+  /// the length of the primitive may be smaller than the length of the buffer.
   static PseudoHandle<StringPrimitive> create(
       Runtime *runtime,
       uint32_t length,
-      Handle<ExternalStringPrimitive<T>> storage);
+      Handle<ExternalStringPrimitive<T>> storage,
+      uint32_t offset = 0);
+
+  /// \return the ExternalStringPrimitive holding the characters of \p str,
+  /// which is of type T, or null if they are in the GC heap.
+  static ExternalStringPrimitive<T> *getSliceBuffer(const StringPrimitive *str);
+
+  /// \return whether a slice of \p length characters of \p str, which is of
+  /// type T, should share its buffer rather than be copied.
+  static bool canSlice(const StringPrimitive *str, uint32_t length);
+
+  /// Allocate a BufferedStringPrimitive for the \p length characters at
+  /// \p start in \p strHnd, sharing its buffer.
+  /// \pre canSlice() returned true for \p strHnd and \p length.
+  static PseudoHandle<StringPrimitive> slice(
+      Runtime *runtime,
+      Handle<StringPrimitive> strHnd,
+      uint32_t start,
+      uint32_t length);
+
+  /// \return whether this string ends where its concatenation buffer does, so
+  /// that it can be appended to in place. Foreign characters never are.
+  bool endsConcatBuffer() const {
+    const ExternalStringPrimitive<T> *buffer = getConcatBuffer();
+    return !buffer->foreign_ &&
+        offset_ + getStringLength() == buffer->contents_.size();
+  }
 
   /// Append a new string to the concatenation buffer and allocate a new
   /// BufferedStringPrimitive representing the result.
@@ -725,13 +830,15 @@ class BufferedStringPrimitive final : public StringPrimitive {
   /// template clases), initialize it with the concatenation of \p leftHnd and
   /// \p rightHnd and allocate a new BufferedStringPrimitive to represent the
   /// result.
+  /// The buffer has room for at least \p capacity characters.
   /// \pre The types must be compatible with respect to T (cannot append UTF16
   /// to ASCII) and the combined length must have been validated.
   /// \return a new BufferedStringPrimitive representing the result.
   static PseudoHandle<StringPrimitive> create(
       Runtime *runtime,
       Handle<StringPrimitive> leftHnd,
-      Handle<StringPrimitive> rightHnd);
+      Handle<StringPrimitive> rightHnd,
+      size_t capacity = 0);
 
   /// Append a string primitive to the StdString \p res, performing an ASCII to
   /// UTF16 conversion if necessary.
@@ -742,7 +849,7 @@ class BufferedStringPrimitive final : public StringPrimitive {
 
   /// \return a const pointer to the first character of the string.
   const T *getRawPointer() const {
-    return getConcatBuffer()->getRawPointer();
+    return getConcatBuffer()->getRawPointer() + offset_;
   }
 
   /// A helper to cast \c concatBufferHV_ to a typed pointer to
@@ -762,6 +869,9 @@ class BufferedStringPrimitive final : public StringPrimitive {
   /// refactoring around compressed pointers, which require PointerBase to be
   /// passed to functions which didn't previously need it.
   GCHermesValue concatBufferHV_;
+
+  /// The index of the first character of this string in the buffer.
+  const uint32_t offset_;
 };
 
 /// \return true if this is one of the BufferedStringPrimitive classes.
@@ -9,6 +9,7 @@
 #define HERMES_VM_UTF16REF_H
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
 
 namespace llvm {
 class raw_ostream;
@@ -43,6 +44,33 @@ bool stringRefEquals(llvm::ArrayRef<T1> str1, llvm::ArrayRef<T2> str2) {
   return std::equal(str1.begin(), str1.end(), str2.begin());
 };
 
+/// Check whether an ASCII and a UTF-16 ArrayRef are equal in content, a vector
+/// of characters at a time. Strings of the same type are compared by the
+/// template above, which std::equal turns into a memcmp().
+bool stringRefEquals(ASCIIRef str1, UTF16Ref str2);
+
+inline bool stringRefEquals(UTF16Ref str1, ASCIIRef str2) {
+  return stringRefEquals(str2, str1);
+}
+
+/// \return the index of the first occurrence of \p needle in \p haystack at
+/// or after \p start, if any. Candidates are found a vector of characters at a
+/// time, by matching the first and last characters of \p needle.
+/// Instantiated for every combination of char and char16_t.
+template <typename T1, typename T2>
+llvm::Optional<uint32_t> stringRefFind(
+    llvm::ArrayRef<T1> haystack,
+    llvm::ArrayRef<T2> needle,
+    uint32_t start);
+
+/// \return the index of the last occurrence of \p needle in \p haystack which
+/// ends at or before \p end, if any, scanning backwards like stringRefFind().
+template <typename T1, typename T2>
+llvm::Optional<uint32_t> stringRefFindLast(
+    llvm::ArrayRef<T1> haystack,
+    llvm::ArrayRef<T2> needle,
+    uint32_t end);
+
 /// Compare two ArrayRef, \return +1 if str1 > str2, -1 if str1 < str2, 0
 /// otherwise.
 template <typename T1, typename T2>
@@ -297,6 +297,16 @@ class StringView {
     return slice(start, length_ - start);
   }
 
+  /// \return the index of the first occurrence of \p needle in this string at
+  /// or after \p start, if any.
+  llvm::Optional<uint32_t> find(const StringView &needle, uint32_t start = 0)
+      const;
+
+  /// \return the index of the last occurrence of \p needle in this string
+  /// which ends at or before \p end, if any.
+  llvm::Optional<uint32_t> findLast(const StringView &needle, uint32_t end)
+      const;
+
   /// \return a new StringView with the string sliced between [first, last).
   StringView slice(const_iterator first, const_iterator last) const {
     return slice(first - begin(), last - first);
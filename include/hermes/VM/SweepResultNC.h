@@ -28,6 +28,12 @@ struct SweepResult {
   /// pointers, in the order they were displaced.
   std::vector<const VTable *> displacedVtablePtrs;
 
+  /// For each swept segment, in sweep order, the size of displacedVtablePtrs
+  /// after that segment was swept.  The VTable pointers displaced from the i'th
+  /// segment's live cells are thus those in [segmentVTablesEnd[i - 1],
+  /// segmentVTablesEnd[i]), which lets segments be processed independently.
+  std::vector<size_t> segmentVTablesEnd;
+
   /// An abstraction over the space available to compact into, as well as how
   /// much to use, and the next address to compact into.
   CompactionResult compactionResult;
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_TRANSITIONCACHE_H
+#define HERMES_VM_TRANSITIONCACHE_H
+
+#include "hermes/VM/PropertyDescriptor.h"
+#include "hermes/VM/SlotAcceptor.h"
+#include "hermes/VM/SymbolID.h"
+
+#include "llvm/Support/Compiler.h"
+
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+class HiddenClass;
+
+/// A cache of the hidden class transitions of a runtime, keyed on the parent
+/// class, the property name and the property flags, in a flat open-addressing
+/// table. Looking a transition up probes a few adjacent entries, instead of
+/// the WeakValueMap of classes with many children, like the root class which
+/// every object literal starts from.
+///
+/// The TransitionMap of each class remains the source of truth, and is what
+/// serialization and heap snapshots see: the cache only holds copies of its
+/// entries, which may be evicted at any time. Both classes of an entry are
+/// weak roots; the entry is dropped when either of them dies. A GC may move
+/// the classes, so the table is rehashed before it is used again.
+class TransitionCache {
+ public:
+  TransitionCache();
+
+  /// \return the child of \p parent by the transition adding or updating the
+  ///   property \p name with \p flags, or null if it is not cached.
+  HiddenClass *lookup(HiddenClass *parent, SymbolID name, PropertyFlags flags);
+
+  /// Cache \p child as the child of \p parent by the transition adding or
+  /// updating the property \p name with \p flags, evicting an entry if all
+  /// the entries it may be stored in are taken.
+  void insert(
+      HiddenClass *parent,
+      SymbolID name,
+      PropertyFlags flags,
+      HiddenClass *child);
+
+  /// Update the classes of every entry after a GC, dropping the entries where
+  /// either of them died.
+  void markWeakRoots(WeakRootAcceptor &acceptor);
+
+ private:
+  /// The number of entries, a power of 2.
+  static constexpr unsigned kNumEntries = 1024;
+  /// The number of consecutive entries a transition may be stored in.
+  static constexpr unsigned kNumProbes = 4;
+
+  struct Entry {
+    /// The parent class, or null if the entry is free.
+    HiddenClass *parent{nullptr};
+    SymbolID name{};
+    PropertyFlags flags{};
+    HiddenClass *child{nullptr};
+  };
+
+  /// \return the index of the first entry a transition may be stored in.
+  static unsigned hash(HiddenClass *parent, SymbolID name, PropertyFlags flags);
+
+  /// Rehash the table if a GC may have moved its classes.
+  void rehashIfNeeded() {
+    if (LLVM_UNLIKELY(needsRehash_))
+      rehash();
+  }
+
+  /// Reinsert every entry at the position of its current classes.
+  void rehash();
+
+  std::vector<Entry> entries_;
+
+  /// Set by markWeakRoots(), since the classes may have moved.
+  bool needsRehash_{false};
+
+  /// The entry evicted next when all the probed entries are taken, rotating
+  /// through the probes.
+  unsigned nextEvict_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_TRANSITIONCACHE_H
@@ -15,6 +15,33 @@ namespace hermes {
 namespace vm {
 namespace instrumentation {
 
+/// Hardware counters of a thread, counted in user mode.
+struct HardwareCounters {
+  uint64_t instructions{0};
+  uint64_t cycles{0};
+  /// Misses of the last level cache.
+  uint64_t cacheMisses{0};
+  /// Misses of the data TLB on loads.
+  uint64_t tlbMisses{0};
+
+  HardwareCounters &operator+=(const HardwareCounters &other) {
+    instructions += other.instructions;
+    cycles += other.cycles;
+    cacheMisses += other.cacheMisses;
+    tlbMisses += other.tlbMisses;
+    return *this;
+  }
+
+  HardwareCounters operator-(const HardwareCounters &other) const {
+    HardwareCounters result;
+    result.instructions = instructions - other.instructions;
+    result.cycles = cycles - other.cycles;
+    result.cacheMisses = cacheMisses - other.cacheMisses;
+    result.tlbMisses = tlbMisses - other.tlbMisses;
+    return result;
+  }
+};
+
 /// Activates and logs various Linux performance counters.
 /// Methods are NOT thread-safe. Counters are process-wide.
 struct PerfEvents {
@@ -24,6 +51,14 @@ struct PerfEvents {
   /// has a field named "totalTime". The counters are added before that field.
   /// If the counters can't be read, leave jsonStats unchanged and return false.
   static bool endAndInsertStats(std::string &jsonStats);
+
+  /// Read into \p counters the hardware counters of the calling thread,
+  /// which count from the thread's first call. Unlike the process-wide
+  /// counters above, they are never reset, so callers measure a region of
+  /// code by the difference of two readings. Counters the CPU doesn't have
+  /// stay zero. This is thread-safe.
+  /// \return false if the counters are not available.
+  static bool readThreadCounters(HardwareCounters &counters);
 };
 
 } // namespace instrumentation
@@ -48,5 +48,142 @@ BlockStatementNode *getBlockStatement(FunctionLikeNode *node) {
   }
 }
 
+namespace {
+
+/// Visits a tree and replaces each of its labels by the label with the same
+/// name in another string table.
+class LabelReinterner {
+  StringTable &table_;
+
+  void reintern(NodeLabel &label) {
+    if (label)
+      label = table_.getString(label->str());
+  }
+  /// Other fields are not labels.
+  template <typename T>
+  void reintern(T &) {}
+
+#define ESTREE_NODE_0_ARGS(NAME, BASE) \
+  void reinternFields(NAME##Node *) {}
+
+#define ESTREE_NODE_1_ARGS(NAME, BASE, ARG0TY, ARG0NM, ARG0OPT) \
+  void reinternFields(NAME##Node *node) {                       \
+    reintern(node->_##ARG0NM);                                  \
+  }
+
+#define ESTREE_NODE_2_ARGS(                                       \
+    NAME, BASE, ARG0TY, ARG0NM, ARG0OPT, ARG1TY, ARG1NM, ARG1OPT) \
+  void reinternFields(NAME##Node *node) {                         \
+    reintern(node->_##ARG0NM);                                    \
+    reintern(node->_##ARG1NM);                                    \
+  }
+
+#define ESTREE_NODE_3_ARGS(                   \
+    NAME,                                     \
+    BASE,                                     \
+    ARG0TY,                                   \
+    ARG0NM,                                   \
+    ARG0OPT,                                  \
+    ARG1TY,                                   \
+    ARG1NM,                                   \
+    ARG1OPT,                                  \
+    ARG2TY,                                   \
+    ARG2NM,                                   \
+    ARG2OPT)                                  \
+  void reinternFields(NAME##Node *node) {     \
+    reintern(node->_##ARG0NM);                \
+    reintern(node->_##ARG1NM);                \
+    reintern(node->_##ARG2NM);                \
+  }
+
+#define ESTREE_NODE_4_ARGS(                   \
+    NAME,                                     \
+    BASE,                                     \
+    ARG0TY,                                   \
+    ARG0NM,                                   \
+    ARG0OPT,                                  \
+    ARG1TY,                                   \
+    ARG1NM,                                   \
+    ARG1OPT,                                  \
+    ARG2TY,                                   \
+    ARG2NM,                                   \
+    ARG2OPT,                                  \
+    ARG3TY,                                   \
+    ARG3NM,                                   \
+    ARG3OPT)                                  \
+  void reinternFields(NAME##Node *node) {     \
+    reintern(node->_##ARG0NM);                \
+    reintern(node->_##ARG1NM);                \
+    reintern(node->_##ARG2NM);                \
+    reintern(node->_##ARG3NM);                \
+  }
+
+#define ESTREE_NODE_5_ARGS(                   \
+    NAME,                                     \
+    BASE,                                     \
+    ARG0TY,                                   \
+    ARG0NM,                                   \
+    ARG0OPT,                                  \
+    ARG1TY,                                   \
+    ARG1NM,                                   \
+    ARG1OPT,                                  \
+    ARG2TY,                                   \
+    ARG2NM,                                   \
+    ARG2OPT,                                  \
+    ARG3TY,                                   \
+    ARG3NM,                                   \
+    ARG3OPT,                                  \
+    ARG4TY,                                   \
+    ARG4NM,                                   \
+    ARG4OPT)                                  \
+  void reinternFields(NAME##Node *node) {     \
+    reintern(node->_##ARG0NM);                \
+    reintern(node->_##ARG1NM);                \
+    reintern(node->_##ARG2NM);                \
+    reintern(node->_##ARG3NM);                \
+    reintern(node->_##ARG4NM);                \
+  }
+
+#include "hermes/AST/ESTree.def"
+
+ public:
+  explicit LabelReinterner(StringTable &table) : table_(table) {}
+
+  bool shouldVisit(Node *) {
+    return true;
+  }
+
+  void enter(Node *node) {
+    switch (node->getKind()) {
+      default:
+        llvm_unreachable("invalid node kind");
+
+#define VISIT(NAME)    \
+  case NodeKind::NAME: \
+    return reinternFields(cast<NAME##Node>(node));
+
+#define ESTREE_NODE_0_ARGS(NAME, ...) VISIT(NAME)
+#define ESTREE_NODE_1_ARGS(NAME, ...) VISIT(NAME)
+#define ESTREE_NODE_2_ARGS(NAME, ...) VISIT(NAME)
+#define ESTREE_NODE_3_ARGS(NAME, ...) VISIT(NAME)
+#define ESTREE_NODE_4_ARGS(NAME, ...) VISIT(NAME)
+#define ESTREE_NODE_5_ARGS(NAME, ...) VISIT(NAME)
+
+#include "hermes/AST/ESTree.def"
+
+#undef VISIT
+    }
+  }
+
+  void leave(Node *) {}
+};
+
+} // namespace
+
+void reinternLabels(NodePtr root, StringTable &table) {
+  LabelReinterner reinterner(table);
+  ESTreeVisit(reinterner, root);
+}
+
 } // namespace ESTree
 } // namespace hermes
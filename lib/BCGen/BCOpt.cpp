@@ -12,6 +12,7 @@
 #include "hermes/IR/IR.h"
 #include "hermes/IR/IRBuilder.h"
 #include "hermes/IR/Instrs.h"
+#include "hermes/Support/Statistic.h"
 #include "hermes/Utils/Dumper.h"
 
 #include "llvm/ADT/PostOrderIterator.h"
@@ -29,6 +30,9 @@ using llvm::dyn_cast;
 using llvm::dyn_cast_or_null;
 using llvm::isa;
 
+STATISTIC(NumMovsEliminated, "Number of Movs eliminated");
+STATISTIC(NumRegistersCompacted, "Number of registers dropped by compaction");
+
 bool MovElimination::runOnFunction(Function *F) {
   bool changed = false;
 
@@ -86,6 +90,7 @@ bool MovElimination::runOnFunction(Function *F) {
             RA_.updateRegister(op, dest);
             destroyer.add(mov);
             mov->replaceAllUsesWith(op);
+            ++NumMovsEliminated;
             changed = true;
             movRemoved = true;
           }
@@ -110,3 +115,9 @@ bool MovElimination::runOnFunction(Function *F) {
 
   return changed;
 }
+
+bool CompactRegisters::runOnFunction(Function *F) {
+  unsigned numDropped = RA_.compactRegisters();
+  NumRegistersCompacted += numDropped;
+  return numDropped != 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/BCGen/HBC/BytecodeCompression.h"
+
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+#include "hermes/Support/LZ4.h"
+
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace hermes {
+namespace hbc {
+
+bool compressBytecode(
+    llvm::ArrayRef<uint8_t> bytecode,
+    llvm::raw_ostream &OS,
+    std::string *outError) {
+  ConstBytecodeFileFields fields;
+  if (!fields.populateFromBuffer(bytecode, outError))
+    return false;
+  const BytecodeFileHeader *fileHeader = fields.header;
+
+  // Find the range holding the function bodies, so that the blocks made only
+  // of bodies can be left compressed until one of their functions is used.
+  uint32_t lazyStart = fileHeader->fileLength;
+  uint32_t lazyEnd = 0;
+  for (const SmallFuncHeader &small : fields.functionHeaders) {
+    RuntimeFunctionHeader header = small.flags.overflowed
+        ? RuntimeFunctionHeader(reinterpret_cast<const FunctionHeader *>(
+              bytecode.data() + small.getLargeHeaderOffset()))
+        : RuntimeFunctionHeader(&small);
+    lazyStart = std::min(lazyStart, header.offset());
+    lazyEnd =
+        std::max(lazyEnd, header.offset() + header.bytecodeSizeInBytes());
+  }
+  if (lazyStart > lazyEnd)
+    lazyStart = lazyEnd = 0;
+
+  CompressedBytecodeHeader header;
+  header.magic = COMPRESSED_MAGIC;
+  header.version = BYTECODE_VERSION;
+  std::copy(
+      fileHeader->sourceHash,
+      fileHeader->sourceHash + SHA1_NUM_BYTES,
+      header.sourceHash);
+  header.fileLength = fileHeader->fileLength;
+  header.blockSize = COMPRESSED_BLOCK_SIZE;
+  header.blockCount =
+      llvm::alignTo(header.fileLength, header.blockSize) / header.blockSize;
+  header.lazyStart = lazyStart;
+  header.lazyEnd = lazyEnd;
+
+  std::vector<CompressedBlockEntry> index(header.blockCount);
+  std::vector<uint8_t> blocks;
+  uint32_t blocksStart =
+      sizeof(header) + header.blockCount * sizeof(CompressedBlockEntry);
+  for (uint32_t i = 0; i < header.blockCount; ++i) {
+    uint32_t start = i * header.blockSize;
+    uint32_t size = std::min(header.blockSize, header.fileLength - start);
+    index[i].offset = blocksStart + blocks.size();
+    compressLZ4Block(bytecode.slice(start, size), blocks);
+    index[i].size = blocksStart + blocks.size() - index[i].offset;
+  }
+  header.compressedLength = blocksStart + blocks.size();
+
+  OS.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  OS.write(
+      reinterpret_cast<const char *>(index.data()),
+      index.size() * sizeof(CompressedBlockEntry));
+  OS.write(reinterpret_cast<const char *>(blocks.data()), blocks.size());
+  return true;
+}
+
+} // namespace hbc
+} // namespace hermes
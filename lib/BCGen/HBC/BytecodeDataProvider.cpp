@@ -7,13 +7,17 @@
 
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
 #include "hermes/BCGen/HBC/BytecodeFileFormat.h"
+#include "hermes/Inst/InstDecode.h"
 #include "hermes/Support/ErrorHandling.h"
+#include "hermes/Support/LZ4.h"
 #include "hermes/Support/OSCompat.h"
 #include "hermes/VM/Deserializer.h"
 #include "hermes/VM/Serializer.h"
 
 #include "llvm/Support/MathExtras.h"
 
+#include <algorithm>
+
 #ifdef HERMESVM_SERIALIZE
 using hermes::vm::Deserializer;
 using hermes::vm::Serializer;
@@ -69,9 +73,101 @@ static bool sanityCheck(
     }
     return false;
   }
+  if (header->layoutChecksum != header->computeLayoutChecksum()) {
+    if (errorMessage) {
+      *errorMessage = "Bytecode file header is corrupt";
+    }
+    return false;
+  }
+  if (header->fileLength > aref.size() ||
+      header->debugInfoOffset > header->fileLength ||
+      header->globalCodeIndex >= header->functionCount) {
+    if (errorMessage) {
+      *errorMessage = "Bytecode file header is out of bounds";
+    }
+    return false;
+  }
+  return true;
+}
+
+/// Returns if aref points to a valid compressed bytecode file and specifies
+/// why it may not in errorMessage (if supplied). The contents of the blocks
+/// are only checked as they are expanded.
+static bool compressedSanityCheck(
+    llvm::ArrayRef<uint8_t> aref,
+    std::string *errorMessage) {
+  auto fail = [errorMessage](const char *message) {
+    if (errorMessage) {
+      *errorMessage = message;
+    }
+    return false;
+  };
+  if (aref.size() < sizeof(hbc::CompressedBytecodeHeader)) {
+    return fail("Buffer too small");
+  }
+  if (llvm::alignAddr(aref.data(), BYTECODE_ALIGNMENT) !=
+      (uintptr_t)aref.data()) {
+    return fail("Buffer misaligned.");
+  }
+
+  const auto *header =
+      reinterpret_cast<const hbc::CompressedBytecodeHeader *>(aref.data());
+  if (header->magic != COMPRESSED_MAGIC) {
+    return fail("Incorrect magic number");
+  }
+  if (header->version != hbc::BYTECODE_VERSION) {
+    if (errorMessage) {
+      llvm::raw_string_ostream errs(*errorMessage);
+      errs << "Wrong bytecode version. Expected " << hbc::BYTECODE_VERSION
+           << " but got " << header->version;
+    }
+    return false;
+  }
+  if (header->fileLength < sizeof(hbc::BytecodeFileHeader) ||
+      header->blockSize == 0 ||
+      header->blockCount !=
+          llvm::alignTo(header->fileLength, header->blockSize) /
+              header->blockSize ||
+      header->lazyStart > header->lazyEnd ||
+      header->lazyEnd > header->fileLength) {
+    return fail("Malformed compressed bytecode header");
+  }
+
+  uint64_t indexEnd = sizeof(hbc::CompressedBytecodeHeader) +
+      (uint64_t)header->blockCount * sizeof(hbc::CompressedBlockEntry);
+  if (header->compressedLength > aref.size() ||
+      indexEnd > header->compressedLength) {
+    return fail("Compressed bytecode is truncated");
+  }
+  const auto *index = reinterpret_cast<const hbc::CompressedBlockEntry *>(
+      aref.data() + sizeof(hbc::CompressedBytecodeHeader));
+  for (uint32_t i = 0; i < header->blockCount; ++i) {
+    if (index[i].offset < indexEnd ||
+        (uint64_t)index[i].offset + index[i].size >
+            header->compressedLength) {
+      return fail("Compressed bytecode block out of bounds");
+    }
+  }
   return true;
 }
 
+/// The execution form of a compressed bytecode file. Its memory comes from
+/// vm_allocate, so the pages of blocks which are never expanded are never
+/// committed.
+class ExpandedBytecodeBuffer final : public Buffer {
+  /// The size of the allocation, a multiple of the page size.
+  size_t allocSize_;
+
+ public:
+  ExpandedBytecodeBuffer(void *data, size_t size, size_t allocSize)
+      : Buffer(static_cast<const uint8_t *>(data), size),
+        allocSize_(allocSize) {}
+
+  ~ExpandedBytecodeBuffer() override {
+    oscompat::vm_free(const_cast<uint8_t *>(data_), allocSize_);
+  }
+};
+
 /// Assert that \p buf has the proper alignment for T, and then cast it to a
 /// pointer to T. \return the pointer to T.
 template <typename T>
@@ -238,10 +334,44 @@ bool BytecodeFileFields<Mutable>::populateFromBuffer(
             castArrayRef<std::pair<uint32_t, uint32_t>>(buf, h->cjsModuleCount);
       }
     }
+    void visitSegmentTable() {
+      align(buf);
+      f.segmentTable = castArrayRef<SegmentTableEntry>(buf, h->segmentCount);
+    }
+    void visitCJSModuleDependencyTable() {
+      align(buf);
+      // The offsets are left out when no module has dependencies.
+      uint32_t offsetCount =
+          h->cjsModuleDependencyCount ? h->cjsModuleCount : 0;
+      f.cjsModuleDependencyOffsets = castArrayRef<uint32_t>(buf, offsetCount);
+      f.cjsModuleDependencies =
+          castArrayRef<uint32_t>(buf, h->cjsModuleDependencyCount);
+    }
   };
 
   BytecodeFileFieldsPopulator populator{*this, buffer.data()};
   visitBytecodeSegmentsInOrder(populator);
+  if ((size_t)(populator.buf - buffer.data()) > header->fileLength) {
+    if (outError) {
+      *outError = "Bytecode sections out of bounds";
+    }
+    return false;
+  }
+
+  // The prefetch table follows the debug info at the end of the file.
+  if (uint32_t count = header->prefetchRangeCount) {
+    uint32_t offset = header->prefetchTableOffset;
+    if (offset % BYTECODE_ALIGNMENT != 0 ||
+        offset > buffer.size() ||
+        (buffer.size() - offset) / sizeof(PrefetchRange) < count) {
+      if (outError) {
+        *outError = "Prefetch table out of bounds";
+      }
+      return false;
+    }
+    auto buf = buffer.data() + offset;
+    prefetchTable = castArrayRef<PrefetchRange>(buf, count);
+  }
   return true;
 }
 
@@ -253,12 +383,17 @@ int32_t BCProviderBase::findCatchTargetOffset(
     uint32_t functionID,
     uint32_t exceptionOffset) const {
   auto exceptions = getExceptionTable(functionID);
-  for (unsigned i = 0, e = exceptions.size(); i < e; ++i) {
-    if (exceptions[i].start <= exceptionOffset &&
-        exceptionOffset < exceptions[i].end) {
-      return exceptions[i].target;
-    }
-  }
+  // The handlers don't overlap and are sorted by their start, so only the last
+  // one starting at or before the offset may cover it.
+  auto it = std::upper_bound(
+      exceptions.begin(),
+      exceptions.end(),
+      exceptionOffset,
+      [](uint32_t offset, const hbc::HBCExceptionHandlerInfo &handler) {
+        return offset < handler.start;
+      });
+  if (it != exceptions.begin() && exceptionOffset < (it - 1)->end)
+    return (it - 1)->target;
   // No handler is found.
   return -1;
 }
@@ -292,6 +427,17 @@ llvm::Optional<SourceMapTextLocation> BCProviderBase::getLocationForAddress(
   return llvm::None;
 }
 
+namespace {
+void prefetchRegion(const uint8_t *p, size_t sz) {
+  // Extend start of region down to a page boundary. The region is still inside
+  // the file since the file starts on a page boundary.
+  auto PS = oscompat::page_size();
+  auto roundDownDelta = reinterpret_cast<uintptr_t>(p) & (PS - 1);
+  oscompat::vm_prefetch(
+      const_cast<uint8_t *>(p - roundDownDelta), sz + roundDownDelta);
+}
+} // namespace
+
 /// Read [data, data + size) sequentially into the OS page cache, but
 /// abort ASAP if another thread sets \p abortFlag.
 static void
@@ -314,6 +460,36 @@ warmup(const uint8_t *data, uint32_t size, std::atomic<bool> *abortFlag) {
   }
 }
 
+/// Read the \p ranges of the file at \p data, which is \p size bytes long,
+/// into the OS page cache in order, but abort ASAP if another thread sets
+/// \p abortFlag.
+static void warmupRanges(
+    const uint8_t *data,
+    uint32_t size,
+    llvm::ArrayRef<hbc::PrefetchRange> ranges,
+    std::atomic<bool> *abortFlag) {
+  // Ask for all of the ranges up front so that the reads overlap, then touch
+  // them in the order they will be needed.
+  for (const auto &range : ranges) {
+    if (range.offset < size)
+      prefetchRegion(
+          data + range.offset, std::min(range.length, size - range.offset));
+  }
+  const uint32_t PS = oscompat::page_size();
+  for (const auto &range : ranges) {
+    if (abortFlag->load(std::memory_order_acquire)) {
+      return;
+    }
+    if (range.offset >= size)
+      continue;
+    uint32_t end = range.offset + std::min(range.length, size - range.offset);
+    // Touch the first byte of each page in the range.
+    for (uint32_t i = range.offset; i < end; i = (i / PS + 1) * PS) {
+      (void)(((volatile const uint8_t *)data)[i]);
+    }
+  }
+}
+
 void BCProviderFromBuffer::stopWarmup() {
   if (warmupThread_) {
     warmupAbortFlag_.store(true, std::memory_order_release);
@@ -323,7 +499,18 @@ void BCProviderFromBuffer::stopWarmup() {
 }
 
 void BCProviderFromBuffer::startWarmup(uint8_t percent) {
-  if (!warmupThread_) {
+  // Blocks of a compressed file are expanded as they are used; there is no
+  // file to read ahead.
+  if (!warmupThread_ && !compressed_) {
+    if (!prefetchTable_.empty()) {
+      warmupThread_ = std::thread(
+          warmupRanges,
+          buffer_->data(),
+          buffer_->size(),
+          prefetchTable_,
+          &warmupAbortFlag_);
+      return;
+    }
     uint32_t warmupSize = buffer_->size();
     assert(percent <= 100);
     if (percent < 100) {
@@ -336,6 +523,29 @@ void BCProviderFromBuffer::startWarmup(uint8_t percent) {
   }
 }
 
+void BCProviderFromBuffer::readInForLoad() {
+  // A compressed file was expanded into memory when it was opened.
+  if (compressed_) {
+    return;
+  }
+  std::atomic<bool> abortFlag{false};
+  if (!prefetchTable_.empty()) {
+    warmupRanges(bufferPtr_, buffer_->size(), prefetchTable_, &abortFlag);
+    return;
+  }
+  // The function headers are followed by the string table, which is read
+  // when the module is loaded. Then the global function runs.
+  auto *tablesEnd =
+      reinterpret_cast<const uint8_t *>(overflowStringTableEntries_.end());
+  uint32_t tablesStart =
+      reinterpret_cast<const uint8_t *>(functionHeaders_) - bufferPtr_;
+  RuntimeFunctionHeader global = getFunctionHeader(globalFunctionIndex_);
+  hbc::PrefetchRange ranges[] = {
+      {tablesStart, (uint32_t)(tablesEnd - bufferPtr_) - tablesStart},
+      {global.offset(), global.bytecodeSizeInBytes()}};
+  warmupRanges(bufferPtr_, buffer_->size(), ranges, &abortFlag);
+}
+
 namespace {
 
 /// Cast a pointer of any type to a uint8_t pointer.
@@ -462,7 +672,21 @@ void BCProviderFromBuffer::willNeedStringTable() {
   oscompat::vm_prefetch(start, prefetchLength);
 }
 
+void BCProviderFromBuffer::willNeedFunction(uint32_t functionID) {
+  // The blocks of a compressed file are expanded on the thread running them;
+  // there is no file to read ahead.
+  if (compressed_) {
+    return;
+  }
+  RuntimeFunctionHeader header = getFunctionHeader(functionID);
+  prefetchRegion(bufferPtr_ + header.offset(), header.bytecodeSizeInBytes());
+}
+
 void BCProviderFromBuffer::dontNeedIdentifierTranslations() {
+  // The expanded form of a compressed file can't be paged back in.
+  if (compressed_) {
+    return;
+  }
   auto start = reinterpret_cast<uintptr_t>(identifierTranslations_.begin());
   auto end = reinterpret_cast<uintptr_t>(identifierTranslations_.end());
   const size_t PS = oscompat::page_size();
@@ -478,7 +702,9 @@ void BCProviderFromBuffer::dontNeedIdentifierTranslations() {
 
 void BCProviderFromBuffer::startPageAccessTracker() {
   auto size = buffer_->size();
-  if (!tracker_) {
+  // Protecting the pages of a compressed file would fault as blocks are
+  // expanded into them.
+  if (!tracker_ && !compressed_) {
     tracker_ =
         PageAccessTracker::create(const_cast<uint8_t *>(bufferPtr_), size);
   }
@@ -486,6 +712,9 @@ void BCProviderFromBuffer::startPageAccessTracker() {
 
 BCProviderFromBuffer::BCProviderFromBuffer(std::unique_ptr<const Buffer> buffer)
     : buffer_(std::move(buffer)), bufferPtr_(buffer_->data()) {
+  if (isCompressedBytecodeStream(*buffer_) && !openCompressed()) {
+    return;
+  }
   ConstBytecodeFileFields fields;
   if (!fields.populateFromBuffer({bufferPtr_, buffer_->size()}, &errstr_)) {
     return;
@@ -510,11 +739,86 @@ BCProviderFromBuffer::BCProviderFromBuffer(std::unique_ptr<const Buffer> buffer)
   cjsModuleOffset_ = fileHeader->cjsModuleOffset;
   cjsModuleTable_ = fields.cjsModuleTable;
   cjsModuleTableStatic_ = fields.cjsModuleTableStatic;
+  segmentTable_ = fields.segmentTable;
+  cjsModuleDependencyOffsets_ = fields.cjsModuleDependencyOffsets;
+  cjsModuleDependencies_ = fields.cjsModuleDependencies;
+  prefetchTable_ = fields.prefetchTable;
+}
+
+bool BCProviderFromBuffer::openCompressed() {
+  if (!compressedSanityCheck({bufferPtr_, buffer_->size()}, &errstr_)) {
+    return false;
+  }
+  const auto *header =
+      reinterpret_cast<const hbc::CompressedBytecodeHeader *>(bufferPtr_);
+  size_t allocSize = llvm::alignTo(header->fileLength, oscompat::page_size());
+  auto result = oscompat::vm_allocate(allocSize);
+  if (!result) {
+    errstr_ = "Failed to allocate memory for compressed bytecode";
+    return false;
+  }
+
+  compressed_ = std::move(buffer_);
+  buffer_ = llvm::make_unique<ExpandedBytecodeBuffer>(
+      result.get(), header->fileLength, allocSize);
+  bufferPtr_ = buffer_->data();
+  expandedBlocks_.reset(new std::atomic<bool>[header->blockCount]);
+  for (uint32_t i = 0; i < header->blockCount; ++i) {
+    expandedBlocks_[i].store(false, std::memory_order_relaxed);
+    uint32_t start = i * header->blockSize;
+    uint32_t end = std::min(start + header->blockSize, header->fileLength);
+    if (start >= header->lazyStart && end <= header->lazyEnd) {
+      continue;
+    }
+    if (!expandBlock(i)) {
+      errstr_ = "Malformed compressed bytecode block";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool BCProviderFromBuffer::expandBlock(uint32_t index) const {
+  const uint8_t *file = compressed_->data();
+  const auto *header =
+      reinterpret_cast<const hbc::CompressedBytecodeHeader *>(file);
+  const auto &entry = reinterpret_cast<const hbc::CompressedBlockEntry *>(
+      file + sizeof(hbc::CompressedBytecodeHeader))[index];
+  uint32_t start = index * header->blockSize;
+  uint32_t size = std::min(header->blockSize, header->fileLength - start);
+  if (!decompressLZ4Block(
+          {file + entry.offset, entry.size},
+          {const_cast<uint8_t *>(bufferPtr_) + start, size})) {
+    return false;
+  }
+  expandedBlocks_[index].store(true, std::memory_order_release);
+  return true;
+}
+
+void BCProviderFromBuffer::expandBlocks(uint32_t offset, uint32_t size) const {
+  const auto *header =
+      reinterpret_cast<const hbc::CompressedBytecodeHeader *>(
+          compressed_->data());
+  uint32_t first = offset / header->blockSize;
+  uint32_t last = std::min(
+      (offset + std::max(size, 1u) - 1) / header->blockSize,
+      header->blockCount - 1);
+  for (uint32_t i = first; i <= last; ++i) {
+    if (expandedBlocks_[i].load(std::memory_order_acquire)) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock{expandMutex_};
+    if (!expandedBlocks_[i].load(std::memory_order_relaxed) &&
+        !expandBlock(i)) {
+      hermes_fatal("Malformed compressed bytecode block");
+    }
+  }
 }
 
 llvm::ArrayRef<uint8_t> BCProviderFromBuffer::getEpilogue() const {
+  const Buffer &file = compressed_ ? *compressed_ : *buffer_;
   return BCProviderFromBuffer::getEpilogueFromBytecode(
-      llvm::ArrayRef<uint8_t>(bufferPtr_, buffer_->size()));
+      llvm::ArrayRef<uint8_t>(file.data(), file.size()));
 }
 
 SHA1 BCProviderFromBuffer::getSourceHash() const {
@@ -525,6 +829,10 @@ SHA1 BCProviderFromBuffer::getSourceHash() const {
 llvm::ArrayRef<uint8_t> BCProviderFromBuffer::getEpilogueFromBytecode(
     llvm::ArrayRef<uint8_t> buffer) {
   const uint8_t *p = buffer.data();
+  if (isCompressedBytecodeStream(buffer)) {
+    const auto *header = castData<hbc::CompressedBytecodeHeader>(p);
+    return buffer.slice(header->compressedLength);
+  }
   const auto *fileHeader = castData<hbc::BytecodeFileHeader>(p);
   const auto *begin = buffer.data() + fileHeader->fileLength;
   const auto *end = buffer.data() + buffer.size();
@@ -535,6 +843,12 @@ SHA1 BCProviderFromBuffer::getSourceHashFromBytecode(
     llvm::ArrayRef<uint8_t> buffer) {
   SHA1 hash;
   const uint8_t *p = buffer.data();
+  if (isCompressedBytecodeStream(buffer)) {
+    const auto *header = castData<hbc::CompressedBytecodeHeader>(p);
+    std::copy(
+        header->sourceHash, header->sourceHash + SHA1_NUM_BYTES, hash.begin());
+    return hash;
+  }
   const auto *fileHeader = castData<hbc::BytecodeFileHeader>(p);
   std::copy(
       fileHeader->sourceHash,
@@ -601,23 +915,16 @@ BCProviderFromBuffer::getExceptionTableAndDebugOffsets(
   return {exceptionTable, debugOffsets};
 }
 
-namespace {
-void prefetchRegion(const uint8_t *p, size_t sz) {
-  // Extend start of region down to a page boundary. The region is still inside
-  // the file since we assert below that the file starts on a page boundary.
-  auto PS = oscompat::page_size();
-  auto roundDownDelta = reinterpret_cast<uintptr_t>(p) & (PS - 1);
-  oscompat::vm_prefetch(
-      const_cast<uint8_t *>(p - roundDownDelta), sz + roundDownDelta);
-}
-} // namespace
-
 void BCProviderFromBuffer::prefetch(llvm::ArrayRef<uint8_t> aref) {
   // We require file start be page-aligned so we can safely round down to page
   // size in prefetchRegion.
   assert(
       reinterpret_cast<uintptr_t>(aref.data()) % oscompat::page_size() == 0 &&
       "Precondition: pointer is page-aligned.");
+  // Nothing of a compressed file is used in place.
+  if (isCompressedBytecodeStream(aref)) {
+    return;
+  }
   ConstBytecodeFileFields fields;
   std::string errstr;
   if (!fields.populateFromBuffer(aref, &errstr)) {
@@ -629,6 +936,17 @@ void BCProviderFromBuffer::prefetch(llvm::ArrayRef<uint8_t> aref) {
   }
   const hbc::BytecodeFileHeader *fileHeader = fields.header;
 
+  // If the file records what its startup reads, prefetch exactly that.
+  if (!fields.prefetchTable.empty()) {
+    for (const auto &range : fields.prefetchTable) {
+      if (range.offset < aref.size())
+        prefetchRegion(
+            aref.data() + range.offset,
+            std::min<size_t>(range.length, aref.size() - range.offset));
+    }
+    return;
+  }
+
   // String table.
   auto stringCount = fileHeader->stringCount;
   const hbc::SmallStringTableEntry *stringTableEntries =
@@ -651,9 +969,199 @@ void BCProviderFromBuffer::prefetch(llvm::ArrayRef<uint8_t> aref) {
 bool BCProviderFromBuffer::bytecodeStreamSanityCheck(
     llvm::ArrayRef<uint8_t> aref,
     std::string *errorMessage) {
+  if (isCompressedBytecodeStream(aref)) {
+    return compressedSanityCheck(aref, errorMessage);
+  }
   return sanityCheck(aref, BytecodeForm::Execution, errorMessage);
 }
 
+bool BCProviderFromBuffer::bytecodeStreamStrictCheck(
+    llvm::ArrayRef<uint8_t> aref,
+    std::string *errorMessage) {
+  auto fail = [errorMessage](const llvm::Twine &message) {
+    if (errorMessage) {
+      *errorMessage = message.str();
+    }
+    return false;
+  };
+
+  if (isCompressedBytecodeStream(aref)) {
+    // Expand every block and check the execution form they make up.
+    if (!compressedSanityCheck(aref, errorMessage)) {
+      return false;
+    }
+    const auto *header =
+        reinterpret_cast<const hbc::CompressedBytecodeHeader *>(aref.data());
+    const auto *index = reinterpret_cast<const hbc::CompressedBlockEntry *>(
+        aref.data() + sizeof(hbc::CompressedBytecodeHeader));
+    // Use a vector of words so the expanded file is suitably aligned.
+    std::vector<uint32_t> words(
+        llvm::alignTo(header->fileLength, sizeof(uint32_t)) /
+        sizeof(uint32_t));
+    auto *expanded = reinterpret_cast<uint8_t *>(words.data());
+    for (uint32_t i = 0; i < header->blockCount; ++i) {
+      uint32_t start = i * header->blockSize;
+      uint32_t size = std::min(header->blockSize, header->fileLength - start);
+      if (!decompressLZ4Block(
+              {aref.data() + index[i].offset, index[i].size},
+              {expanded + start, size})) {
+        return fail("Compressed bytecode block " + llvm::Twine(i) +
+                    " is corrupt");
+      }
+    }
+    return bytecodeStreamStrictCheck(
+        {expanded, header->fileLength}, errorMessage);
+  }
+
+  ConstBytecodeFileFields fields;
+  if (!fields.populateFromBuffer(aref, errorMessage)) {
+    return false;
+  }
+  const auto *fileHeader = fields.header;
+  uint32_t fileLength = fileHeader->fileLength;
+  uint32_t functionCount = fileHeader->functionCount;
+  auto inFile = [fileLength](uint64_t offset, uint64_t length) {
+    return offset <= fileLength && length <= fileLength - offset;
+  };
+
+  // Every string must lie within the string storage.
+  for (uint32_t i = 0; i < fileHeader->stringCount; ++i) {
+    const auto &small = fields.stringTableEntries[i];
+    uint64_t offset = small.offset;
+    uint64_t length = small.length;
+    if (small.isOverflowed()) {
+      if (offset >= fields.stringTableOverflowEntries.size()) {
+        return fail("String " + llvm::Twine(i) + " has no overflow entry");
+      }
+      const auto &overflow = fields.stringTableOverflowEntries[offset];
+      offset = overflow.offset;
+      length = overflow.length;
+    }
+    if (small.isUTF16) {
+      length *= 2;
+    }
+    if (offset + length > fields.stringStorage.size()) {
+      return fail("String " + llvm::Twine(i) + " is out of bounds");
+    }
+  }
+
+  for (uint32_t functionID : fields.cjsModuleTableStatic) {
+    if (functionID >= functionCount) {
+      return fail("CommonJS module refers to a missing function");
+    }
+  }
+  for (const auto &entry : fields.cjsModuleTable) {
+    if (entry.second >= functionCount) {
+      return fail("CommonJS module refers to a missing function");
+    }
+  }
+  uint32_t prevDependencyOffset = 0;
+  for (uint32_t offset : fields.cjsModuleDependencyOffsets) {
+    if (offset < prevDependencyOffset ||
+        offset > fields.cjsModuleDependencies.size()) {
+      return fail("CommonJS module dependencies are out of bounds");
+    }
+    prevDependencyOffset = offset;
+  }
+
+  for (uint32_t id = 0; id < functionCount; ++id) {
+    auto failFunction = [&](const char *message) {
+      return failFunction("Function " + llvm::Twine(id) + ": " + message);
+    };
+    const hbc::SmallFuncHeader &small = fields.functionHeaders[id];
+    // The exception table and debug offsets follow the large header of an
+    // overflowed function, and are at infoOffset otherwise.
+    uint64_t infoOffset = small.infoOffset;
+    RuntimeFunctionHeader header(&small);
+    if (small.flags.overflowed) {
+      uint32_t largeOffset = small.getLargeHeaderOffset();
+      if (largeOffset % BYTECODE_ALIGNMENT != 0 ||
+          !inFile(largeOffset, sizeof(hbc::FunctionHeader))) {
+        return failFunction("large header out of bounds");
+      }
+      header = RuntimeFunctionHeader(
+          reinterpret_cast<const hbc::FunctionHeader *>(
+              aref.data() + largeOffset));
+      infoOffset = largeOffset + sizeof(hbc::FunctionHeader);
+    }
+
+    uint32_t size = header.bytecodeSizeInBytes();
+    if (!inFile(header.offset(), size)) {
+      return failFunction("bytecode out of bounds");
+    }
+
+    if (header.flags().hasExceptionHandler || header.flags().hasDebugInfo) {
+      infoOffset = llvm::alignTo(infoOffset, BYTECODE_ALIGNMENT);
+      if (!inFile(infoOffset, 0)) {
+        return failFunction("info out of bounds");
+      }
+    }
+    if (header.flags().hasExceptionHandler) {
+      if (!inFile(infoOffset, sizeof(hbc::ExceptionHandlerTableHeader))) {
+        return failFunction("exception table out of bounds");
+      }
+      const auto *buf = aref.data() + infoOffset;
+      const auto *tableHeader =
+          castData<hbc::ExceptionHandlerTableHeader>(buf);
+      if (!inFile(
+              buf - aref.data(),
+              (uint64_t)tableHeader->count *
+                  sizeof(hbc::HBCExceptionHandlerInfo))) {
+        return failFunction("exception table out of bounds");
+      }
+      uint32_t prevEnd = 0;
+      for (const auto &handler : castArrayRef<hbc::HBCExceptionHandlerInfo>(
+               buf, tableHeader->count)) {
+        if (handler.start > handler.end || handler.end > size ||
+            handler.target >= size) {
+          return failFunction("exception handler out of bounds");
+        }
+        if (handler.start < prevEnd) {
+          return failFunction("exception handlers not sorted");
+        }
+        prevEnd = handler.end;
+      }
+    }
+
+    // Decode every instruction, checking that it fits in the function, that
+    // its registers fit in the frame and that its jumps stay in the function.
+    const uint8_t *bytecode = aref.data() + header.offset();
+    uint32_t frameSize = header.frameSize();
+    for (uint32_t ip = 0; ip < size;) {
+      auto opCode = static_cast<inst::OpCode>(bytecode[ip]);
+      if (opCode >= inst::OpCode::_last) {
+        return failFunction("invalid opcode");
+      }
+      if (inst::getInstSize(opCode) > size - ip) {
+        return failFunction("truncated instruction");
+      }
+      auto decoded = inst::decodeInstruction(
+          reinterpret_cast<const inst::Inst *>(bytecode + ip));
+      for (unsigned i = 0; i < decoded.meta.numOperands; ++i) {
+        int64_t value = decoded.operandValue[i].integer;
+        switch (decoded.meta.operandType[i]) {
+          case inst::OperandType::Reg8:
+          case inst::OperandType::Reg32:
+            if ((uint64_t)value >= frameSize) {
+              return failFunction("invalid register");
+            }
+            break;
+          case inst::OperandType::Addr8:
+          case inst::OperandType::Addr32:
+            if (ip + value < 0 || ip + value >= size) {
+              return failFunction("invalid jump target");
+            }
+            break;
+          default:
+            break;
+        }
+      }
+      ip += decoded.meta.size;
+    }
+  }
+  return true;
+}
+
 #ifdef HERMESVM_SERIALIZE
 void BCProviderFromBuffer::serialize(Serializer &s) const {
   // For BCProviderFromBuffer, serialize the buffer directly.
@@ -661,9 +1169,11 @@ void BCProviderFromBuffer::serialize(Serializer &s) const {
   // hash and later use the filename directly for deserialization and use hash
   // as a sanity check.
 
-  s.writeInt<size_t>(buffer_->size());
+  // A compressed file is serialized as it was loaded.
+  const Buffer &file = compressed_ ? *compressed_ : *buffer_;
+  s.writeInt<size_t>(file.size());
   s.pad();
-  s.writeData(buffer_->data(), buffer_->size());
+  s.writeData(file.data(), file.size());
   s.endObject(this);
 }
 
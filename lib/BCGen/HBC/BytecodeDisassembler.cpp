@@ -130,6 +130,9 @@ void BytecodeDisassembler::disassembleBytecodeFileHeader(raw_ostream &OS) {
      << "\n";
   OS << "  CommonJS module count (static): "
      << bcProvider_->getCJSModuleTableStatic().size() << "\n";
+  OS << "  Segment count: " << bcProvider_->getSegmentTable().size() << "\n";
+  OS << "  Prefetch range count: " << bcProvider_->getPrefetchTable().size()
+     << "\n";
   OS << "  Bytecode options:\n";
   OS << "    staticBuiltins: " << bcopts.staticBuiltins << "\n";
   OS << "    cjsModulesStaticallyResolved: "
@@ -271,7 +274,46 @@ void BytecodeDisassembler::disassembleCJSModuleTable(raw_ostream &OS) {
       OS << "Module index " << i << " -> function ID " << functionID << '\n';
     }
     OS << '\n';
+
+    bool printedDependencies = false;
+    for (uint32_t i = 0; i < cjsModulesStatic.size(); ++i) {
+      auto dependencies = bcProvider_->getCJSModuleDependencies(i);
+      if (dependencies.empty())
+        continue;
+      if (!printedDependencies) {
+        OS << "CommonJS Module Dependencies:\n";
+        printedDependencies = true;
+      }
+      OS << "Module index " << i << " -> modules";
+      for (uint32_t id : dependencies)
+        OS << ' ' << id;
+      OS << '\n';
+    }
+    if (printedDependencies)
+      OS << '\n';
+  }
+
+  auto segmentTable = bcProvider_->getSegmentTable();
+  if (!segmentTable.empty()) {
+    OS << "Segments:\n";
+    for (const auto &entry : segmentTable) {
+      OS << "Segment " << entry.segment << " -> " << entry.moduleCount
+         << " modules from index " << entry.firstModule << '\n';
+    }
+    OS << '\n';
+  }
+}
+
+void BytecodeDisassembler::disassemblePrefetchTable(raw_ostream &OS) {
+  auto prefetchTable = bcProvider_->getPrefetchTable();
+  if (prefetchTable.empty())
+    return;
+  OS << "Prefetch Table:\n";
+  for (const auto &range : prefetchTable) {
+    OS << "  [" << range.offset << ", " << range.offset + range.length
+       << ")\n";
   }
+  OS << '\n';
 }
 
 void BytecodeDisassembler::disassembleExceptionHandlers(
@@ -312,27 +354,58 @@ void BytecodeDisassembler::disassembleExceptionHandlersPretty(
 
 namespace {
 
-/// Given a SwitchImm instruction, loop through each entry of the associated
-/// jump table.
+/// \return whether \p opCode is one of the switch instructions with a jump
+/// table.
+bool isSwitchWithJumpTable(OpCode opCode) {
+  return opCode == OpCode::SwitchImm || opCode == OpCode::SwitchStr ||
+      opCode == OpCode::SwitchSparse;
+}
+
+/// \return the unaligned offset of the jump table of the switch instruction
+/// \p inst. It is the second operand of all of them.
+uint32_t switchJumpTableOffset(const inst::Inst *inst) {
+  if (inst->opCode == OpCode::SwitchImm)
+    return inst->iSwitchImm.op2;
+  if (inst->opCode == OpCode::SwitchStr)
+    return inst->iSwitchStr.op2;
+  return inst->iSwitchSparse.op2;
+}
+
+/// Given a SwitchImm, SwitchStr or SwitchSparse instruction, loop through each
+/// entry of the associated jump table. The keys of the hashed jump tables of
+/// SwitchStr and SwitchSparse are skipped, and their slots are the indices.
 /// F: (current index into master jump table, jump target offset, destination
 /// instruction) -> void.
 template <typename F>
 void switchJumpTableForEach(const inst::Inst *inst, F f) {
-  assert(inst->opCode == inst::OpCode::SwitchImm && "expected SwitchImm");
-  unsigned start = inst->iSwitchImm.op4;
-  unsigned end = inst->iSwitchImm.op5;
-  assert(start < end);
-  unsigned numberOfEntries = end - start;
-
-  /// Get the current SwitchImm instruction's subview [start, end] start pointer
-  /// from master jump table. This is the same computation done by the
-  /// interpreter to figure out the start of the jump table view.
+  assert(isSwitchWithJumpTable(inst->opCode) && "expected a switch");
+
+  /// Get the current switch instruction's subview from master jump table. This
+  /// is the same computation done by the interpreter to figure out the start
+  /// of the jump table view.
   const auto *curJmpTableView =
       reinterpret_cast<const uint32_t *>(llvm::alignAddr(
-          (const uint8_t *)inst + inst->iSwitchImm.op2, sizeof(uint32_t)));
+          (const uint8_t *)inst + switchJumpTableOffset(inst),
+          sizeof(uint32_t)));
+
+  unsigned start;
+  unsigned numberOfEntries;
+  if (inst->opCode == OpCode::SwitchImm) {
+    start = inst->iSwitchImm.op4;
+    unsigned end = inst->iSwitchImm.op5;
+    assert(start < end);
+    numberOfEntries = end - start + 1;
+  } else {
+    start = 0;
+    numberOfEntries = inst->opCode == OpCode::SwitchStr
+        ? inst->iSwitchStr.op4
+        : inst->iSwitchSparse.op4;
+    // Skip the keys.
+    curJmpTableView += numberOfEntries;
+  }
 
   for (unsigned curJmpTableViewOffset = 0;
-       curJmpTableViewOffset <= numberOfEntries;
+       curJmpTableViewOffset < numberOfEntries;
        curJmpTableViewOffset++) {
     auto jumpTargetOffset = curJmpTableView[curJmpTableViewOffset];
     f(curJmpTableViewOffset + start,
@@ -359,8 +432,8 @@ void BytecodeVisitor::visitInstructionsInFunction(unsigned funcId) {
     auto instLength = md.size;
     preVisitInstruction(md.opCode, ip, instLength);
 
-    // Visit branch targets of the SwitchImm instruction.
-    if (op == OpCode::SwitchImm) {
+    // Visit branch targets of the switch instruction.
+    if (isSwitchWithJumpTable(op)) {
       switchJumpTableForEach(
           (inst::Inst const *)ip,
           [this](uint32_t jmpIdx, int32_t offset, const uint8_t *dest) {
@@ -485,7 +558,9 @@ void JumpTargetsVisitor::preVisitInstruction(
     int length) {
   switch (opcode) {
     case OpCode::SwitchImm:
-      // Decode jump table of SwitchImm instruction.
+    case OpCode::SwitchStr:
+    case OpCode::SwitchSparse:
+      // Decode jump table of the switch instruction.
       switchInsts_.push_back((inst::Inst const *)ip);
       break;
 
@@ -694,7 +769,7 @@ class DisassembleVisitor : public BytecodeVisitor {
     int offset = ip - bcProvider_->getBytecode(funcId_);
     assert(offset >= 0);
     os_ << "[@ " << offset << "] " << getOpCodeString(opcode);
-    if (opcode == OpCode::SwitchImm) {
+    if (isSwitchWithJumpTable(opcode)) {
       const inst::Inst *inst = (inst::Inst const *)ip;
       switchInsts_.push_back(inst);
     }
@@ -797,7 +872,10 @@ BytecodeSectionWalker::BytecodeSectionWalker(
       bcProvider->getCJSModuleTable().begin(),
       bcProvider->getCJSModuleTable().end());
 
+  // Function bodies may be laid out in any order.
   auto firstFuncStart = bcProvider->getBytecode(0);
+  for (uint32_t id = 1, e = bcProvider->getFunctionCount(); id < e; ++id)
+    firstFuncStart = std::min(firstFuncStart, bcProvider->getBytecode(id));
   auto firstFuncHeader = bcProvider->getFunctionHeader(0);
   auto firstFuncInfoStart = bytecodeStart + firstFuncHeader.infoOffset();
   auto debugInfoStart = bytecodeStart + fileHeader->debugInfoOffset;
@@ -886,7 +964,7 @@ void BytecodeDisassembler::disassembleFunctionPretty(
        << "Jump Tables: \n";
     for (auto *inst : switchInsts) {
       OS << "  "
-         << "offset " << inst->iSwitchImm.op2 << "\n";
+         << "offset " << switchJumpTableOffset(inst) << "\n";
       switchJumpTableForEach(
           inst, [&](uint32_t jmpIdx, int32_t offset, const uint8_t *dest) {
             OS << "   " << jmpIdx << " : "
@@ -912,7 +990,7 @@ void BytecodeDisassembler::disassembleFunctionRaw(
        << "Jump Tables: \n";
     for (auto *inst : switchInsts) {
       OS << "  "
-         << "offset " << inst->iSwitchImm.op2 << "\n";
+         << "offset " << switchJumpTableOffset(inst) << "\n";
       switchJumpTableForEach(
           inst, [&](uint32_t jmpIdx, int32_t offset, const uint8_t *dest) {
             OS << "   " << jmpIdx << " : " << offset << "\n";
@@ -963,6 +1041,7 @@ void BytecodeDisassembler::disassemble(raw_ostream &OS) {
   disassembleArrayBuffer(OS);
   disassembleObjectBuffer(OS);
   disassembleCJSModuleTable(OS);
+  disassemblePrefetchTable(OS);
 
   for (unsigned funcId = 0; funcId < bcProvider_->getFunctionCount();
        ++funcId) {
@@ -16,6 +16,7 @@
 #include "llvm/Support/Format.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <locale>
 #include <unordered_map>
 
@@ -77,6 +78,44 @@ std::pair<uint32_t, uint32_t> BytecodeModuleGenerator::addObjectBuffer(
       literalGenerator_.serializeBuffer(vals, objValBuffer_, false)};
 }
 
+/// \return the exception handlers \p handlers, of which the first one covering
+/// an offset handles it, as handlers which don't overlap, sorted by their
+/// start. This lets the VM find the handler of an offset with a binary search.
+static std::vector<HBCExceptionHandlerInfo> sortExceptionHandlers(
+    const std::vector<HBCExceptionHandlerInfo> &handlers) {
+  // Every offset between two consecutive boundaries is covered by the same
+  // handlers.
+  std::vector<uint32_t> bounds;
+  for (const auto &handler : handlers) {
+    bounds.push_back(handler.start);
+    bounds.push_back(handler.end);
+  }
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+  std::vector<HBCExceptionHandlerInfo> sorted;
+  for (size_t i = 1, e = bounds.size(); i < e; ++i) {
+    uint32_t start = bounds[i - 1];
+    uint32_t end = bounds[i];
+    auto it = std::find_if(
+        handlers.begin(),
+        handlers.end(),
+        [start](const HBCExceptionHandlerInfo &handler) {
+          return handler.start <= start && start < handler.end;
+        });
+    if (it == handlers.end())
+      continue;
+    // Merge with the previous range if it jumps to the same target.
+    if (!sorted.empty() && sorted.back().end == start &&
+        sorted.back().target == it->target) {
+      sorted.back().end = end;
+      continue;
+    }
+    sorted.push_back(HBCExceptionHandlerInfo{start, end, it->target});
+  }
+  return sorted;
+}
+
 std::unique_ptr<BytecodeFunction>
 BytecodeFunctionGenerator::generateBytecodeFunction(
     Function::DefinitionKind definitionKind,
@@ -98,7 +137,7 @@ BytecodeFunctionGenerator::generateBytecodeFunction(
           nameID,
           highestReadCacheIndex_,
           highestWriteCacheIndex_),
-      std::move(exceptionHandlers_),
+      sortExceptionHandlers(exceptionHandlers_),
       std::move(jumpTable_)));
 }
 
@@ -193,13 +232,17 @@ void BytecodeModuleGenerator::addCJSModule(
 
 void BytecodeModuleGenerator::addCJSModuleStatic(
     uint32_t moduleID,
-    uint32_t functionID) {
+    uint32_t functionID,
+    llvm::ArrayRef<uint32_t> dependencies) {
   assert(cjsModules_.empty() && "Unresolved modules must be in cjsModules_");
   assert(
       moduleID - cjsModuleOffset_ == cjsModulesStatic_.size() &&
       "Module ID out of order in cjsModulesStatic_");
   (void)moduleID;
   cjsModulesStatic_.push_back(functionID);
+  cjsModuleDependencyOffsets_.push_back(cjsModuleDependencies_.size());
+  cjsModuleDependencies_.insert(
+      cjsModuleDependencies_.end(), dependencies.begin(), dependencies.end());
 }
 
 std::unique_ptr<BytecodeModule> BytecodeModuleGenerator::generate() {
@@ -218,6 +261,10 @@ std::unique_ptr<BytecodeModule> BytecodeModuleGenerator::generate() {
   BytecodeOptions bytecodeOptions;
   bytecodeOptions.staticBuiltins = options_.staticBuiltinsEnabled;
   bytecodeOptions.cjsModulesStaticallyResolved = !cjsModulesStatic_.empty();
+  // Leave out the offsets when there is nothing to prefetch.
+  if (cjsModuleDependencies_.empty()) {
+    cjsModuleDependencyOffsets_.clear();
+  }
   std::unique_ptr<BytecodeModule> BM{new BytecodeModule(
       functionGenerators_.size(),
       std::move(kinds),
@@ -233,6 +280,9 @@ std::unique_ptr<BytecodeModule> BytecodeModuleGenerator::generate() {
       cjsModuleOffset_,
       std::move(cjsModules_),
       std::move(cjsModulesStatic_),
+      std::move(segmentTable_),
+      std::move(cjsModuleDependencyOffsets_),
+      std::move(cjsModuleDependencies_),
       bytecodeOptions)};
 
   DebugInfoGenerator debugInfoGen{std::move(filenameTable_)};
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/BCGen/HBC/BytecodePatch.h"
+
+#include "hermes/BCGen/HBC/BytecodeFormConverter.h"
+
+#include "llvm/Support/FileOutputBuffer.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace hermes {
+namespace hbc {
+
+namespace {
+
+/// A chunk of a patch being created, with the bytes it adds.
+struct PatchChunk {
+  BytecodePatchChunk chunk;
+  llvm::ArrayRef<uint8_t> added;
+};
+
+/// Copy the bytecode file \p bytes in execution form to \p out, converted to
+/// delta form.
+/// \return true if successful, false if \p bytes could not be interpreted.
+bool copyToDeltaForm(
+    llvm::ArrayRef<uint8_t> bytes,
+    std::vector<uint8_t> &out,
+    std::string *outError) {
+  out.assign(bytes.begin(), bytes.end());
+  return convertBytecodeToForm(out, BytecodeForm::Delta, outError);
+}
+
+/// Store in \p starts the offsets where the sections of the bytecode file
+/// \p bytes in delta form start, in order, followed by the length of the
+/// file. The last section is whatever follows the file, such as an epilogue.
+/// \return true if successful, false if \p bytes could not be interpreted.
+bool getSectionStarts(
+    llvm::ArrayRef<uint8_t> bytes,
+    std::vector<uint32_t> &starts,
+    std::string *outError) {
+  ConstBytecodeFileFields fields;
+  if (!fields.populateFromBuffer(bytes, outError, BytecodeForm::Delta))
+    return false;
+  const BytecodeFileHeader *header = fields.header;
+  auto offset = [&bytes](const void *ptr) {
+    return (uint32_t)(static_cast<const uint8_t *>(ptr) - bytes.data());
+  };
+  const void *cjsModuleTable = header->options.cjsModulesStaticallyResolved
+      ? static_cast<const void *>(fields.cjsModuleTableStatic.data())
+      : static_cast<const void *>(fields.cjsModuleTable.data());
+
+  // The function bodies and their info follow the CJS module dependency
+  // table, and precede the debug info and the prefetch table.
+  starts = {0,
+            offset(fields.functionHeaders.data()),
+            offset(fields.stringKinds.data()),
+            offset(fields.identifierTranslations.data()),
+            offset(fields.stringTableEntries.data()),
+            offset(fields.stringTableOverflowEntries.data()),
+            offset(fields.stringStorage.data()),
+            offset(fields.arrayBuffer.data()),
+            offset(fields.objKeyBuffer.data()),
+            offset(fields.objValueBuffer.data()),
+            offset(fields.regExpTable.data()),
+            offset(fields.regExpStorage.data()),
+            offset(cjsModuleTable),
+            offset(fields.segmentTable.data()),
+            offset(fields.cjsModuleDependencyOffsets.data()),
+            offset(fields.cjsModuleDependencies.end()),
+            header->debugInfoOffset,
+            header->fileLength,
+            (uint32_t)bytes.size()};
+  // Keep the offsets ascending, so that missing sections are empty.
+  for (size_t i = 1, e = starts.size(); i != e; ++i) {
+    starts[i] = std::min(
+        std::max(starts[i], starts[i - 1]), (uint32_t)bytes.size());
+  }
+  return true;
+}
+
+} // namespace
+
+bool createBytecodePatch(
+    llvm::ArrayRef<uint8_t> base,
+    llvm::ArrayRef<uint8_t> updated,
+    llvm::raw_ostream &OS,
+    std::string *outError) {
+  std::vector<uint8_t> baseDelta;
+  std::vector<uint8_t> updatedDelta;
+  if (!copyToDeltaForm(base, baseDelta, outError) ||
+      !copyToDeltaForm(updated, updatedDelta, outError))
+    return false;
+  std::vector<uint32_t> baseStarts;
+  std::vector<uint32_t> updatedStarts;
+  if (!getSectionStarts(baseDelta, baseStarts, outError) ||
+      !getSectionStarts(updatedDelta, updatedStarts, outError))
+    return false;
+
+  std::vector<PatchChunk> chunks;
+  // Append chunks, merged with the last one when the bytes follow it.
+  auto copy = [&chunks](uint32_t offset, uint32_t length) {
+    if (!length)
+      return;
+    if (!chunks.empty()) {
+      BytecodePatchChunk &last = chunks.back().chunk;
+      if (last.baseOffset != BytecodePatchChunk::ADDED_BYTES &&
+          last.baseOffset + last.length == offset) {
+        last.length += length;
+        return;
+      }
+    }
+    chunks.push_back({{offset, length}, {}});
+  };
+  auto add = [&chunks](llvm::ArrayRef<uint8_t> bytes) {
+    if (bytes.empty())
+      return;
+    if (!chunks.empty() && chunks.back().added.end() == bytes.begin()) {
+      PatchChunk &last = chunks.back();
+      last.chunk.length += bytes.size();
+      last.added = {last.added.data(), last.chunk.length};
+      return;
+    }
+    chunks.push_back(
+        {{BytecodePatchChunk::ADDED_BYTES, (uint32_t)bytes.size()}, bytes});
+  };
+
+  // An update usually changes a few places of each section, which leaves the
+  // rest of the section in delta form as it was. Keep the bytes which are the
+  // same at the start and at the end of each section.
+  llvm::ArrayRef<uint8_t> baseBytes(baseDelta);
+  llvm::ArrayRef<uint8_t> updatedBytes(updatedDelta);
+  for (size_t i = 0, e = baseStarts.size() - 1; i != e; ++i) {
+    auto from =
+        baseBytes.slice(baseStarts[i], baseStarts[i + 1] - baseStarts[i]);
+    auto to = updatedBytes.slice(
+        updatedStarts[i], updatedStarts[i + 1] - updatedStarts[i]);
+    size_t common = std::min(from.size(), to.size());
+    size_t prefix = 0;
+    while (prefix < common && from[prefix] == to[prefix])
+      ++prefix;
+    size_t suffix = 0;
+    while (suffix < common - prefix &&
+           from[from.size() - 1 - suffix] == to[to.size() - 1 - suffix])
+      ++suffix;
+    copy(baseStarts[i], prefix);
+    add(to.slice(prefix, to.size() - prefix - suffix));
+    copy(baseStarts[i + 1] - suffix, suffix);
+  }
+
+  const auto *baseHeader =
+      reinterpret_cast<const BytecodeFileHeader *>(base.data());
+  BytecodePatchHeader header;
+  header.magic = PATCH_MAGIC;
+  header.version = BYTECODE_VERSION;
+  std::copy(
+      baseHeader->sourceHash,
+      baseHeader->sourceHash + SHA1_NUM_BYTES,
+      header.baseSourceHash);
+  header.baseFileLength = base.size();
+  header.fileLength = updated.size();
+  header.chunkCount = chunks.size();
+
+  OS.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (const PatchChunk &chunk : chunks) {
+    OS.write(
+        reinterpret_cast<const char *>(&chunk.chunk), sizeof(chunk.chunk));
+    OS.write(
+        reinterpret_cast<const char *>(chunk.added.data()),
+        chunk.added.size());
+  }
+  return true;
+}
+
+bool applyBytecodePatch(
+    llvm::StringRef basePath,
+    llvm::ArrayRef<uint8_t> patch,
+    llvm::StringRef outPath,
+    std::string *outError) {
+  auto fail = [outError](const llvm::Twine &message) {
+    if (outError) {
+      *outError = message.str();
+    }
+    return false;
+  };
+
+  if (patch.size() < sizeof(BytecodePatchHeader))
+    return fail("Patch is truncated");
+  const auto *header =
+      reinterpret_cast<const BytecodePatchHeader *>(patch.data());
+  if (header->magic != PATCH_MAGIC)
+    return fail("Not a bytecode patch");
+  uint32_t version = header->version;
+  if (version != BYTECODE_VERSION)
+    return fail(
+        "Wrong bytecode version. Expected " + llvm::Twine(BYTECODE_VERSION) +
+        " but got " + llvm::Twine(version));
+  if (header->fileLength < sizeof(BytecodeFileHeader))
+    return fail("Updated file is too short");
+
+  auto baseOrErr = llvm::MemoryBuffer::getFile(
+      basePath, -1, false /* RequiresNullTerminator */);
+  if (!baseOrErr)
+    return fail(
+        "Failed to open " + basePath + ": " + baseOrErr.getError().message());
+  std::unique_ptr<llvm::MemoryBuffer> baseFile = std::move(*baseOrErr);
+  llvm::ArrayRef<uint8_t> base(
+      reinterpret_cast<const uint8_t *>(baseFile->getBufferStart()),
+      baseFile->getBufferSize());
+  if (base.size() != header->baseFileLength ||
+      base.size() < sizeof(BytecodeFileHeader) ||
+      !std::equal(
+          header->baseSourceHash,
+          header->baseSourceHash + SHA1_NUM_BYTES,
+          reinterpret_cast<const BytecodeFileHeader *>(base.data())
+              ->sourceHash))
+    return fail("Patch does not apply to " + basePath);
+
+  // The chunks copy the base file in delta form, which is written to a
+  // scratch file that is never committed.
+  auto scratchOrErr = llvm::FileOutputBuffer::create(outPath, base.size());
+  if (!scratchOrErr)
+    return fail(llvm::toString(scratchOrErr.takeError()));
+  std::unique_ptr<llvm::FileOutputBuffer> scratch = std::move(*scratchOrErr);
+  std::copy(base.begin(), base.end(), scratch->getBufferStart());
+  baseFile.reset();
+  llvm::MutableArrayRef<uint8_t> baseDelta(
+      scratch->getBufferStart(), scratch->getBufferSize());
+  if (!convertBytecodeToForm(baseDelta, BytecodeForm::Delta, outError))
+    return false;
+
+  auto outputOrErr =
+      llvm::FileOutputBuffer::create(outPath, header->fileLength);
+  if (!outputOrErr)
+    return fail(llvm::toString(outputOrErr.takeError()));
+  std::unique_ptr<llvm::FileOutputBuffer> output = std::move(*outputOrErr);
+  llvm::MutableArrayRef<uint8_t> updated(
+      output->getBufferStart(), output->getBufferSize());
+
+  // Fill the updated file one chunk at a time.
+  const uint8_t *cursor = patch.data() + sizeof(BytecodePatchHeader);
+  uint32_t written = 0;
+  for (uint32_t i = 0; i < header->chunkCount; ++i) {
+    if ((size_t)(patch.end() - cursor) < sizeof(BytecodePatchChunk))
+      return fail("Patch is truncated");
+    const auto *chunk = reinterpret_cast<const BytecodePatchChunk *>(cursor);
+    cursor += sizeof(BytecodePatchChunk);
+    if (chunk->length > updated.size() - written)
+      return fail("Patch chunk is out of bounds");
+
+    const uint8_t *bytes;
+    if (chunk->baseOffset == BytecodePatchChunk::ADDED_BYTES) {
+      if ((size_t)(patch.end() - cursor) < chunk->length)
+        return fail("Patch is truncated");
+      bytes = cursor;
+      cursor += chunk->length;
+    } else {
+      if (chunk->baseOffset > baseDelta.size() ||
+          chunk->length > baseDelta.size() - chunk->baseOffset)
+        return fail("Patch chunk is out of bounds");
+      bytes = baseDelta.data() + chunk->baseOffset;
+    }
+    std::copy(bytes, bytes + chunk->length, updated.data() + written);
+    written += chunk->length;
+  }
+  if (written != updated.size() || cursor != patch.end())
+    return fail("Patch chunks do not match the updated file");
+  scratch.reset();
+
+  if (!convertBytecodeToForm(updated, BytecodeForm::Execution, outError))
+    return false;
+  if (auto err = output->commit())
+    return fail(llvm::toString(std::move(err)));
+  return true;
+}
+
+} // namespace hbc
+} // namespace hermes
@@ -8,6 +8,7 @@
 #include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
 
 #include "hermes/AST/SemValidate.h"
+#include "hermes/BCGen/HBC/BytecodeStream.h"
 #include "hermes/BCGen/HBC/HBC.h"
 #ifdef HERMESVM_ENABLE_OPTIMIZATION_AT_RUNTIME
 #include "hermes/Optimizer/PassManager/Pipeline.h"
@@ -20,6 +21,12 @@
 #include "hermes/VM/Deserializer.h"
 #include "hermes/VM/Serializer.h"
 
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
 #ifdef HERMESVM_SERIALIZE
 using hermes::vm::Deserializer;
 using hermes::vm::Serializer;
@@ -49,6 +56,126 @@ bool isSingleFunctionExpression(ESTree::NodePtr ast) {
 }
 } // namespace
 
+std::shared_ptr<BCProviderBase> LazyFunctionCache::find(
+    LazyCompilationData *lazyData) {
+  std::lock_guard<std::mutex> lk(mtx_);
+  auto it = compiled_.find(lazyData);
+  return it != compiled_.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<BCProviderBase> LazyFunctionCache::insert(
+    LazyCompilationData *lazyData,
+    std::unique_ptr<BCProviderBase> compiled) {
+  std::lock_guard<std::mutex> lk(mtx_);
+  return compiled_.try_emplace(lazyData, std::move(compiled)).first->second;
+}
+
+SHA1 LazyFunctionCache::getDiskCacheKey(LazyCompilationData *lazyData) {
+  const llvm::MemoryBuffer *source =
+      lazyData->context->getSourceErrorManager().getSourceBuffer(
+          lazyData->bufferId);
+  auto it = sourceHashes_.find(lazyData->bufferId);
+  if (it == sourceHashes_.end()) {
+    llvm::SHA1 hasher;
+    hasher.update(source->getBuffer());
+    auto rawHash = hasher.final();
+    SHA1 hash{};
+    std::copy(rawHash.begin(), rawHash.end(), hash.begin());
+    it = sourceHashes_.try_emplace(lazyData->bufferId, hash).first;
+  }
+
+  // The settings of the compiler which change the generated bytecode.
+  Context &context = *lazyData->context;
+  uint32_t key[] = {
+      context.isStrictMode(),
+      context.getOptimizationSettings().staticBuiltins,
+      context.getEmitAsyncBreakCheck(),
+      (uint32_t)context.getDebugInfoSetting(),
+      (uint32_t)(lazyData->span.Start.getPointer() - source->getBufferStart()),
+      (uint32_t)(lazyData->span.End.getPointer() - source->getBufferStart())};
+  llvm::SHA1 hasher;
+  hasher.update(it->second);
+  hasher.update(llvm::ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(key), sizeof(key)));
+  auto rawHash = hasher.final();
+  SHA1 hash{};
+  std::copy(rawHash.begin(), rawHash.end(), hash.begin());
+  return hash;
+}
+
+std::string LazyFunctionCache::getDiskCachePath(const SHA1 &key) const {
+  llvm::SmallString<128> path{diskCacheDir_};
+  llvm::sys::path::append(path, hashAsString(key) + ".hbc");
+  return path.str().str();
+}
+
+std::unique_ptr<BCProviderBase> LazyFunctionCache::load(
+    LazyCompilationData *lazyData) {
+  if (diskCacheDir_.empty())
+    return nullptr;
+  SHA1 key;
+  {
+    auto compilerLock = lockCompiler();
+    key = getDiskCacheKey(lazyData);
+  }
+
+  auto file = llvm::MemoryBuffer::getFile(
+      getDiskCachePath(key),
+      /*FileSize*/ -1,
+      /*RequiresNullTerminator*/ false);
+  if (!file)
+    return nullptr;
+  // A file which is corrupt, or was written by another version of the
+  // compiler, is ignored.
+  llvm::ArrayRef<uint8_t> data{
+      reinterpret_cast<const uint8_t *>((*file)->getBufferStart()),
+      (*file)->getBufferSize()};
+  if (!BCProviderFromBuffer::bytecodeStreamStrictCheck(data) ||
+      BCProviderFromBuffer::getSourceHashFromBytecode(data) != key)
+    return nullptr;
+  return BCProviderFromBuffer::createBCProviderFromBuffer(
+             llvm::make_unique<OwnedMemoryBuffer>(std::move(*file)))
+      .first;
+}
+
+void LazyFunctionCache::store(
+    LazyCompilationData *lazyData,
+    BytecodeModule &bcMod) {
+  if (diskCacheDir_.empty())
+    return;
+  for (uint32_t i = 0, e = bcMod.getNumFunctions(); i < e; ++i) {
+    if (bcMod.getFunction(i).isLazy())
+      return;
+  }
+  SHA1 key;
+  {
+    auto compilerLock = lockCompiler();
+    key = getDiskCacheKey(lazyData);
+  }
+
+  // Write a temporary file and rename it, so that another process running the
+  // same source never loads a partial file. The key takes the place of the
+  // source hash, which identifies the file when it is loaded.
+  std::string path = getDiskCachePath(key);
+  std::string tmpPath = path + ".tmp";
+  {
+    std::error_code code;
+    llvm::raw_fd_ostream OS(tmpPath, code, llvm::sys::fs::F_None);
+    if (code)
+      return;
+    BytecodeSerializer BS{OS, BytecodeGenerationOptions::defaults()};
+    BS.serialize(bcMod, key);
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      llvm::sys::fs::remove(tmpPath);
+      return;
+    }
+  }
+  if (llvm::sys::fs::rename(tmpPath, path))
+    llvm::sys::fs::remove(tmpPath);
+}
+
 BCProviderFromSrc::BCProviderFromSrc(
     std::unique_ptr<hbc::BytecodeModule> module)
     : module_(std::move(module)) {
@@ -73,6 +200,9 @@ BCProviderFromSrc::BCProviderFromSrc(
   cjsModuleOffset_ = module_->getCJSModuleOffset();
   cjsModuleTable_ = module_->getCJSModuleTable();
   cjsModuleTableStatic_ = module_->getCJSModuleTableStatic();
+  segmentTable_ = module_->getSegmentTable();
+  cjsModuleDependencyOffsets_ = module_->getCJSModuleDependencyOffsets();
+  cjsModuleDependencies_ = module_->getCJSModuleDependencies();
 
   debugInfo_ = &module_->getDebugInfo();
 
@@ -215,6 +345,8 @@ BCProviderFromSrc::createBCProviderFromSrc(
   auto bytecode = createBCProviderFromSrc(
       hbc::generateBytecodeModule(&M, M.getTopLevelFunction(), opts));
   bytecode->singleFunction_ = isSingleFunctionExpression(parsed.getValue());
+  if (compileFlags.lazy && !compileFlags.lazyCacheDir.empty())
+    bytecode->lazyFunctions_.setDiskCacheDir(compileFlags.lazyCacheDir);
   return {std::move(bytecode), std::string{}};
 }
 
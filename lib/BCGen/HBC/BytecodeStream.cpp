@@ -7,12 +7,15 @@
 
 #include "hermes/BCGen/HBC/BytecodeStream.h"
 
+#include "llvm/ADT/BitVector.h"
+
 using namespace hermes;
 using namespace hbc;
 
 // ============================ File ============================
 void BytecodeSerializer::serialize(BytecodeModule &BM, const SHA1 &sourceHash) {
   bytecodeModule_ = &BM;
+  prefetchRanges_ = getPrefetchRanges(BM);
   uint32_t cjsModuleCount = BM.getBytecodeOptions().cjsModulesStaticallyResolved
       ? BM.getCJSModuleTableStatic().size()
       : BM.getCJSModuleTable().size();
@@ -34,7 +37,12 @@ void BytecodeSerializer::serialize(BytecodeModule &BM, const SHA1 &sourceHash) {
                             BM.getObjectValueBufferSize(),
                             BM.getCJSModuleOffset(),
                             cjsModuleCount,
+                            static_cast<uint32_t>(BM.getSegmentTable().size()),
+                            static_cast<uint32_t>(
+                                BM.getCJSModuleDependencies().size()),
+                            static_cast<uint32_t>(prefetchRanges_.size()),
                             debugInfoOffset_,
+                            prefetchTableOffset_,
                             BM.getBytecodeOptions()};
   writeBinary(header);
   // Sizes of file and function headers are tuned for good cache line packing.
@@ -47,6 +55,7 @@ void BytecodeSerializer::serialize(BytecodeModule &BM, const SHA1 &sourceHash) {
   }
 
   serializeDebugInfo(BM);
+  serializePrefetchTable();
 
   if (isLayout_) {
     finishLayout(BM);
@@ -106,6 +115,36 @@ void BytecodeSerializer::serializeDebugInfo(BytecodeModule &BM) {
   writeBinaryArray(data.getData());
 }
 
+// ========================= Prefetch Table =========================
+std::vector<PrefetchRange> BytecodeSerializer::getPrefetchRanges(
+    BytecodeModule &BM) const {
+  std::vector<PrefetchRange> ranges;
+  for (const StartupRead &read : options_.startupReads) {
+    if (read.length) {
+      ranges.push_back({read.offset, read.length});
+      continue;
+    }
+    if (read.functionID >= BM.getNumFunctions())
+      continue;
+    const BytecodeFunction &BF = *BM.getFunctionTable()[read.functionID];
+    // The jump tables follow the opcodes, aligned as in
+    // serializeFunctionsBytecode().
+    uint32_t length = BF.getOpcodeArray().size();
+    if (!BF.getJumpTables().empty()) {
+      length = llvm::alignTo(length, sizeof(uint32_t)) +
+          BF.getJumpTables().size() * sizeof(uint32_t);
+    }
+    ranges.push_back({BF.getOffset(), length});
+  }
+  return ranges;
+}
+
+void BytecodeSerializer::serializePrefetchTable() {
+  pad(BYTECODE_ALIGNMENT);
+  prefetchTableOffset_ = prefetchRanges_.empty() ? 0 : loc_;
+  writeBinaryArray(llvm::makeArrayRef(prefetchRanges_));
+}
+
 // ===================== CommonJS Module Table ======================
 void BytecodeSerializer::serializeCJSModuleTable(BytecodeModule &BM) {
   pad(BYTECODE_ALIGNMENT);
@@ -153,12 +192,34 @@ void BytecodeSerializer::serializeDebugOffsets(BytecodeFunction &BF) {
 }
 
 // ============================ Function ============================
+std::vector<uint32_t> BytecodeSerializer::getFunctionLayoutOrder(
+    BytecodeModule &BM) const {
+  const uint32_t numFunctions = BM.getNumFunctions();
+  std::vector<uint32_t> order;
+  order.reserve(numFunctions);
+  llvm::BitVector placed(numFunctions);
+  for (uint32_t id : options_.functionLayoutOrder) {
+    if (id < numFunctions && !placed.test(id)) {
+      placed.set(id);
+      order.push_back(id);
+    }
+  }
+  for (uint32_t id = 0; id < numFunctions; ++id) {
+    if (!placed.test(id))
+      order.push_back(id);
+  }
+  return order;
+}
+
 void BytecodeSerializer::serializeFunctionsBytecode(BytecodeModule &BM) {
   // Map from opcodes and jumptables to offsets, used to deduplicate bytecode.
   using DedupKey =
       std::pair<llvm::ArrayRef<opcode_atom_t>, llvm::ArrayRef<uint32_t>>;
   llvm::DenseMap<DedupKey, uint32_t> bcMap;
-  for (auto &entry : BM.getFunctionTable()) {
+  // Both the layout and the writing pass must visit the bodies in the same
+  // order, since the writing pass relies on the offsets growing.
+  for (uint32_t id : getFunctionLayoutOrder(BM)) {
+    auto &entry = BM.getFunctionTable()[id];
     if (options_.optimizationEnabled) {
       // If identical bytecode exists, we'll reuse it.
       bool reuse = false;
@@ -300,3 +361,14 @@ void BytecodeSerializer::visitCJSModuleTable() {
   pad(BYTECODE_ALIGNMENT);
   serializeCJSModuleTable(*bytecodeModule_);
 }
+
+void BytecodeSerializer::visitSegmentTable() {
+  pad(BYTECODE_ALIGNMENT);
+  writeBinaryArray(bytecodeModule_->getSegmentTable());
+}
+
+void BytecodeSerializer::visitCJSModuleDependencyTable() {
+  pad(BYTECODE_ALIGNMENT);
+  writeBinaryArray(bytecodeModule_->getCJSModuleDependencyOffsets());
+  writeBinaryArray(bytecodeModule_->getCJSModuleDependencies());
+}
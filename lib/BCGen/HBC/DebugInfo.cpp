@@ -10,6 +10,8 @@
 #include "hermes/BCGen/HBC/ConsecutiveStringStorage.h"
 #include "hermes/SourceMap/SourceMapGenerator.h"
 
+#include <algorithm>
+
 using namespace hermes;
 using namespace hbc;
 
@@ -117,27 +119,64 @@ OptValue<uint32_t> DebugInfo::getFilenameForAddress(
   return value;
 }
 
-OptValue<DebugSourceLocation> DebugInfo::getLocationForAddress(
-    uint32_t debugOffset,
-    uint32_t offsetInFunction) const {
+std::vector<DebugSourceLocation> DebugInfo::decodeLocations(
+    uint32_t debugOffset) const {
   assert(debugOffset < data_.size() && "Debug offset out of range");
+  std::vector<DebugSourceLocation> locations;
   FunctionDebugInfoDeserializer fdid(data_.getData(), debugOffset);
-  DebugSourceLocation lastLocation = fdid.getCurrent();
-  uint32_t lastLocationOffset = debugOffset;
-  uint32_t nextLocationOffset = fdid.getOffset();
-  while (auto loc = fdid.next()) {
-    if (loc->address > offsetInFunction)
+  DebugSourceLocation location = fdid.getCurrent();
+  uint32_t locationOffset = debugOffset;
+  for (;;) {
+    auto file = getFilenameForAddress(locationOffset);
+    location.filenameId = file ? *file : kNoFilename;
+    locations.push_back(location);
+    locationOffset = fdid.getOffset();
+    auto next = fdid.next();
+    if (!next)
       break;
-    lastLocation = *loc;
-    lastLocationOffset = nextLocationOffset;
-    nextLocationOffset = fdid.getOffset();
+    location = *next;
+  }
+  return locations;
+}
+
+OptValue<DebugSourceLocation> DebugInfo::getLocationForAddress(
+    uint32_t debugOffset,
+    uint32_t offsetInFunction) const {
+  std::lock_guard<std::mutex> lock(locationCache_->mutex);
+  auto &locations = locationCache_->functions[debugOffset];
+  if (locations.empty()) {
+    locations = decodeLocations(debugOffset);
   }
-  if (auto file = getFilenameForAddress(lastLocationOffset)) {
-    lastLocation.address = offsetInFunction;
-    lastLocation.filenameId = *file;
-    return lastLocation;
+  // The location of an address is the last one at or before it. The first
+  // location is the start of the function, at address 0.
+  auto it = std::upper_bound(
+      locations.begin(),
+      locations.end(),
+      offsetInFunction,
+      [](uint32_t address, const DebugSourceLocation &location) {
+        return address < location.address;
+      });
+  assert(it != locations.begin() && "No location at the function start");
+  DebugSourceLocation location = *std::prev(it);
+  if (location.filenameId == kNoFilename) {
+    return llvm::None;
   }
-  return llvm::None;
+  location.address = offsetInFunction;
+  return location;
+}
+
+std::vector<DebugSourceLocation> DebugInfo::getLocationsForFunction(
+    uint32_t debugOffset) const {
+  std::vector<DebugSourceLocation> locations = decodeLocations(debugOffset);
+  locations.erase(
+      std::remove_if(
+          locations.begin(),
+          locations.end(),
+          [](const DebugSourceLocation &location) {
+            return location.filenameId == kNoFilename;
+          }),
+      locations.end());
+  return locations;
 }
 
 OptValue<DebugSearchResult> DebugInfo::getAddressForLocation(
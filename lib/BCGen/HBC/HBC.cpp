@@ -8,10 +8,12 @@
 #include "hermes/BCGen/HBC/HBC.h"
 
 #include "hermes/BCGen/BCOpt.h"
+#include "hermes/BCGen/HBC/BytecodeCompression.h"
 #include "hermes/BCGen/HBC/BytecodeGenerator.h"
 #include "hermes/BCGen/HBC/BytecodeStream.h"
 #include "hermes/BCGen/HBC/ISel.h"
 #include "hermes/BCGen/HBC/Passes.h"
+#include "hermes/BCGen/HBC/Passes/CombineStringConcat.h"
 #include "hermes/BCGen/HBC/Passes/FuncCallNOpts.h"
 #include "hermes/BCGen/HBC/Passes/InsertProfilePoint.h"
 #include "hermes/BCGen/HBC/Passes/LowerBuiltinCalls.h"
@@ -26,9 +28,13 @@
 #include "hermes/IR/Instrs.h"
 #include "hermes/Optimizer/PassManager/Pass.h"
 #include "hermes/Optimizer/PassManager/PassManager.h"
+#include "hermes/Support/ErrorHandling.h"
 #include "hermes/Support/PerfSection.h"
 #include "hermes/Support/UTF8.h"
 
+#include <atomic>
+#include <thread>
+
 #define DEBUG_TYPE "hbc-backend"
 
 using namespace hermes;
@@ -47,6 +53,77 @@ const unsigned kFastRegisterAllocationThreshold = 250;
 // time memory usage.
 const uint64_t kRegisterAllocationMemoryLimit = 10L * 1024 * 1024;
 
+/// The number of functions whose registers each codegen thread allocates
+/// before the results are consumed.
+const size_t kFunctionsPerCodegenThread = 32;
+
+/// Allocate the registers of the function \p F, lowering its PHIs.
+std::unique_ptr<HVMRegisterAllocator> allocateRegisters(
+    Function *F,
+    const BytecodeGenerationOptions &options) {
+  auto RA = llvm::make_unique<HVMRegisterAllocator>(F);
+  if (!options.optimizationEnabled) {
+    RA->setFastPassThreshold(kFastRegisterAllocationThreshold);
+    RA->setMemoryLimit(kRegisterAllocationMemoryLimit);
+  }
+  PostOrderAnalysis PO(F);
+  /// The order of the blocks is reverse-post-order, which is a simply
+  /// topological sort.
+  llvm::SmallVector<BasicBlock *, 16> order(PO.rbegin(), PO.rend());
+  RA->allocate(order);
+  return RA;
+}
+
+/// \return true if the registers of \p F can be allocated concurrently with
+/// those of other functions. Register allocation only modifies the IR of the
+/// function itself, except for the use lists of the literals it copies into
+/// PHI registers, which are shared by the whole module.
+bool canAllocateRegistersConcurrently(Function *F) {
+  if (F->isLazy())
+    return false;
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      auto *phi = dyn_cast<PhiInst>(&I);
+      if (!phi)
+        continue;
+      for (unsigned i = 0, e = phi->getNumEntries(); i < e; ++i) {
+        if (!isa<Instruction>(phi->getEntry(i).first))
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+/// Allocate the registers of the \p functions which allow it, using up to
+/// options.numCodegenThreads threads.
+/// \return the allocator of each function, or null for the functions that
+///   must be allocated on the calling thread.
+std::vector<std::unique_ptr<HVMRegisterAllocator>>
+allocateRegistersConcurrently(
+    llvm::ArrayRef<Function *> functions,
+    const BytecodeGenerationOptions &options) {
+  std::vector<std::unique_ptr<HVMRegisterAllocator>> allocators(
+      functions.size());
+  if (options.numCodegenThreads <= 1)
+    return allocators;
+
+  std::atomic<size_t> next{0};
+  auto work = [&]() {
+    for (size_t i; (i = next++) < functions.size();) {
+      if (canAllocateRegistersConcurrently(functions[i]))
+        allocators[i] = allocateRegisters(functions[i], options);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < options.numCodegenThreads; ++i)
+    threads.emplace_back(work);
+  work();
+  for (auto &thread : threads)
+    thread.join();
+  return allocators;
+}
+
 void lowerIR(Module *M, const BytecodeGenerationOptions &options) {
   if (M->isLowered())
     return;
@@ -62,6 +139,11 @@ void lowerIR(Module *M, const BytecodeGenerationOptions &options) {
   PM.addPass(new LowerExponentiationOperator());
   // LowerBuiltinCalls needs to run before the rest of the lowering.
   PM.addPass(new LowerBuiltinCalls());
+  if (options.optimizationEnabled) {
+    // Turn chains of string additions, whose types are now inferred, into
+    // single concatenations.
+    PM.addPass(new CombineStringConcat());
+  }
   // It is important to run LowerNumericProperties before LoadConstants
   // as LowerNumericProperties could generate new constants.
   PM.addPass(new LowerNumericProperties());
@@ -154,6 +236,17 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
 
   if (range) {
     BMGen.setCJSModuleOffset(range->first);
+    // Record where every module of a split bundle is, so that requiring a
+    // module can load its segment on demand.
+    const auto &segmentRanges = M->getContext().getSegmentRanges();
+    if (M->getCJSModulesResolved() && segmentRanges.size() > 1) {
+      for (const auto &segmentRange : segmentRanges) {
+        BMGen.addSegment(
+            segmentRange.segment,
+            segmentRange.first,
+            segmentRange.last + 1 - segmentRange.first);
+      }
+    }
   }
 
   // Empty if all functions should be generated (i.e. bundle splitting was not
@@ -216,7 +309,8 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
     auto *cjsModule = M->findCJSModule(&F);
     if (cjsModule) {
       if (M->getCJSModulesResolved()) {
-        BMGen.addCJSModuleStatic(cjsModule->id, index);
+        BMGen.addCJSModuleStatic(
+            cjsModule->id, index, cjsModule->dependencies);
       } else {
         BMGen.addCJSModule(index, BMGen.getStringID(cjsModule->filename.str()));
       }
@@ -226,61 +320,81 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
 
   // Construct the relative function scope depth map.
   FunctionScopeAnalysis scopeAnalysis{entryPoint};
-  // Bytecode generation for each function.
+
+  llvm::SmallVector<Function *, 16> functions;
   for (auto &F : *M) {
-    if (!shouldGenerate(&F)) {
-      continue;
+    if (shouldGenerate(&F)) {
+      functions.push_back(&F);
     }
+  }
 
-    std::unique_ptr<BytecodeFunctionGenerator> funcGen;
-
-    if (F.isLazy()) {
-      funcGen = BytecodeFunctionGenerator::create(BMGen, 0);
-    } else {
-      HVMRegisterAllocator RA(&F);
-      if (!options.optimizationEnabled) {
-        RA.setFastPassThreshold(kFastRegisterAllocationThreshold);
-        RA.setMemoryLimit(kRegisterAllocationMemoryLimit);
-      }
-      PostOrderAnalysis PO(&F);
-      /// The order of the blocks is reverse-post-order, which is a simply
-      /// topological sort.
-      llvm::SmallVector<BasicBlock *, 16> order(PO.rbegin(), PO.rend());
-      RA.allocate(order);
-
-      if (options.format == DumpRA) {
-        RA.dump();
-      }
-
-      PassManager PM;
-      PM.addPass(new LowerStoreInstrs(RA));
-      PM.addPass(new LowerCalls(RA));
-      if (options.optimizationEnabled) {
-        PM.addPass(new MovElimination(RA));
-        PM.addPass(new RecreateCheapValues(RA));
-        PM.addPass(new LoadConstantValueNumbering(RA));
-      }
-      PM.addPass(new SpillRegisters(RA));
-      if (options.basicBlockProfiling) {
-        // Insert after all other passes so that it sees final basic block
-        // list.
-        PM.addPass(new InsertProfilePoint());
+  // Functions are generated in batches: the registers of a batch are allocated
+  // on several threads, then the rest of the generation runs in module order
+  // on this thread. Batching bounds the number of live allocators.
+  const size_t batchSize = options.numCodegenThreads > 1
+      ? options.numCodegenThreads * kFunctionsPerCodegenThread
+      : 1;
+  for (size_t begin = 0, e = functions.size(); begin < e; begin += batchSize) {
+    llvm::ArrayRef<Function *> batch = llvm::makeArrayRef(functions).slice(
+        begin, std::min(batchSize, e - begin));
+    auto allocators = allocateRegistersConcurrently(batch, options);
+
+    // Bytecode generation for each function.
+    for (size_t i = 0; i < batch.size(); ++i) {
+      Function &F = *batch[i];
+      std::unique_ptr<BytecodeFunctionGenerator> funcGen;
+
+      if (F.isLazy()) {
+        funcGen = BytecodeFunctionGenerator::create(BMGen, 0);
+      } else {
+        if (!allocators[i]) {
+          allocators[i] = allocateRegisters(&F, options);
+        }
+        HVMRegisterAllocator &RA = *allocators[i];
+
+        if (options.format == DumpRA) {
+          RA.dump();
+        }
+
+        PassManager PM;
+        PM.addPass(new LowerStoreInstrs(RA));
+        PM.addPass(new LowerCalls(RA));
+        if (options.optimizationEnabled) {
+          PM.addPass(new MovElimination(RA));
+          PM.addPass(new RecreateCheapValues(RA));
+          PM.addPass(new LoadConstantValueNumbering(RA));
+          if (options.compactRegisters)
+            PM.addPass(new CompactRegisters(RA));
+        }
+        PM.addPass(new SpillRegisters(RA));
+        if (options.basicBlockProfiling) {
+          // Insert after all other passes so that it sees final basic block
+          // list.
+          PM.addPass(new InsertProfilePoint());
+        }
+        PM.run(&F);
+
+        if (options.format == DumpLRA)
+          RA.dump();
+
+        if (options.format == DumpPostRA)
+          F.dump();
+
+        funcGen =
+            BytecodeFunctionGenerator::create(BMGen, RA.getMaxRegisterUsage());
+        HBCISel hbciSel(
+            &F,
+            funcGen.get(),
+            RA,
+            scopeAnalysis,
+            options.bytecodePeephole,
+            options.literalSlots);
+        hbciSel.generate(sourceMapGen);
       }
-      PM.run(&F);
-
-      if (options.format == DumpLRA)
-        RA.dump();
-
-      if (options.format == DumpPostRA)
-        F.dump();
 
-      funcGen =
-          BytecodeFunctionGenerator::create(BMGen, RA.getMaxRegisterUsage());
-      HBCISel hbciSel(&F, funcGen.get(), RA, scopeAnalysis);
-      hbciSel.generate(sourceMapGen);
+      BMGen.setFunctionGenerator(&F, std::move(funcGen));
+      allocators[i].reset();
     }
-
-    BMGen.setFunctionGenerator(&F, std::move(funcGen));
   }
 
   return BMGen.generate();
@@ -303,8 +417,23 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecode(
       std::move(baseBCProvider));
   if (options.format == OutputFormatKind::EmitBundle) {
     assert(BM != nullptr);
-    BytecodeSerializer BS{OS, options};
-    BS.serialize(*BM, sourceHash);
+    if (options.compressBytecode) {
+      llvm::SmallVector<char, 0> bytecode;
+      llvm::raw_svector_ostream bytecodeOS{bytecode};
+      BytecodeSerializer BS{bytecodeOS, options};
+      BS.serialize(*BM, sourceHash);
+      std::string error;
+      if (!compressBytecode(
+              {reinterpret_cast<const uint8_t *>(bytecode.data()),
+               bytecode.size()},
+              OS,
+              &error)) {
+        hermes_fatal(error);
+      }
+    } else {
+      BytecodeSerializer BS{OS, options};
+      BS.serialize(*BM, sourceHash);
+    }
   }
   // Now that the BytecodeFunctions know their offsets into the stream, we can
   // populate the source map.
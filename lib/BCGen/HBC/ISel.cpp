@@ -10,11 +10,15 @@
 #include "hermes/BCGen/BCOpt.h"
 #include "hermes/BCGen/HBC/BytecodeGenerator.h"
 #include "hermes/BCGen/HBC/HBC.h"
+#include "hermes/BCGen/HBC/SwitchHash.h"
 #include "hermes/IR/Analysis.h"
+#include "hermes/IR/IREval.h"
 #include "hermes/SourceMap/SourceMapGenerator.h"
 #include "hermes/Support/Statistic.h"
 
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringSwitch.h"
 
 #define DEBUG_TYPE "hbc-backend-isel"
 
@@ -36,6 +40,13 @@ STATISTIC(
 STATISTIC(
     NumCacheSlots,
     "Number of cache slots allocated for all put/get property instructions");
+STATISTIC(NumJumpsThreaded, "Number of jumps threaded to their final target");
+STATISTIC(NumBranchesFolded, "Number of branches on constants folded");
+STATISTIC(NumMovsDropped, "Number of Movs of values already copied dropped");
+STATISTIC(NumLiteralSlotLoads, "Number of loads from literal slots");
+STATISTIC(
+    NumEnvironmentAccessesFused,
+    "Number of environment loads and stores fused with GetEnvironment");
 
 /// Given a list of basic blocks \p blocks linearized into the order they will
 /// be generated, \return the set of those basic blocks containing backwards
@@ -80,11 +91,28 @@ unsigned HBCISel::encodeValue(Value *value) {
 }
 
 void HBCISel::registerLongJump(offset_t loc, BasicBlock *target) {
-  relocations_.push_back(
-      {loc, Relocation::RelocationType::LongJumpType, target});
+  BasicBlock *dst = getJumpTarget(target);
+  if (dst != target)
+    ++NumJumpsThreaded;
+  relocations_.push_back({loc, Relocation::RelocationType::LongJumpType, dst});
+}
+
+BasicBlock *HBCISel::getJumpTarget(BasicBlock *BB) {
+  if (!peephole_)
+    return BB;
+  // A cycle of such blocks is an infinite loop, which must be kept.
+  llvm::SmallPtrSet<BasicBlock *, 4> visited;
+  while (true) {
+    auto *branch = llvm::dyn_cast_or_null<BranchInst>(BB->getTerminator());
+    if (!branch || &*BB->begin() != branch || asyncBreakChecks_.count(BB) ||
+        !visited.insert(BB).second)
+      break;
+    BB = branch->getBranchDest();
+  }
+  return BB;
 }
 
-void HBCISel::registerSwitchImm(offset_t loc, SwitchImmInst *inst) {
+void HBCISel::registerSwitchImm(offset_t loc, TerminatorInst *inst) {
   relocations_.push_back(
       {loc, Relocation::RelocationType::JumpTableDispatch, inst});
 }
@@ -132,12 +160,12 @@ void HBCISel::resolveRelocations() {
           // Nothing, just keep track of the location.
           break;
         case Relocation::JumpTableDispatch:
-          auto &switchImmInfo = switchImmInfo_[cast<SwitchImmInst>(pointer)];
+          auto &switchImmInfo = switchImmInfo_[cast<TerminatorInst>(pointer)];
           // update default target jmp
           BasicBlock *defaultBlock = switchImmInfo.defaultTarget;
           int defaultOffset = basicBlockMap_[defaultBlock].first - loc;
           BCFGen_->updateJumpTarget(loc + 1 + 1 + 4, defaultOffset, 4);
-          switchImmInfo_[cast<SwitchImmInst>(pointer)].offset = loc;
+          switchImmInfo.offset = loc;
           break;
       }
 
@@ -166,7 +194,7 @@ void HBCISel::resolveExceptionHandlers() {
 
 void HBCISel::generateJumpTable() {
   using SwitchInfoEntry =
-      llvm::DenseMap<SwitchImmInst *, SwitchImmInfo>::iterator::value_type;
+      llvm::DenseMap<TerminatorInst *, SwitchImmInfo>::iterator::value_type;
 
   if (switchImmInfo_.empty())
     return;
@@ -187,6 +215,7 @@ void HBCISel::generateJumpTable() {
   for (auto &tuple : infoVector) {
     auto entry = tuple.second;
     uint32_t startOfTable = res.size();
+    res.insert(res.end(), entry.keys.begin(), entry.keys.end());
     for (uint32_t jmpIdx = 0; jmpIdx < entry.table.size(); jmpIdx++) {
       res.push_back(basicBlockMap_[entry.table[jmpIdx]].first - entry.offset);
     }
@@ -338,11 +367,21 @@ void HBCISel::generateAsInt32Inst(AsInt32Inst *Inst, BasicBlock *next) {
 void HBCISel::emitMovIfNeeded(param_t dest, param_t src) {
   if (dest == src)
     return;
+  // Right after a Mov between the same registers, both hold the same value.
+  if (peephole_ && BCFGen_->getCurrentLocation() == lastMovEnd_ &&
+      ((dest == lastMovDest_ && src == lastMovSrc_) ||
+       (dest == lastMovSrc_ && src == lastMovDest_))) {
+    ++NumMovsDropped;
+    return;
+  }
   if (dest <= UINT8_MAX && src <= UINT8_MAX) {
     BCFGen_->emitMov(dest, src);
   } else {
     BCFGen_->emitMovLong(dest, src);
   }
+  lastMovEnd_ = BCFGen_->getCurrentLocation();
+  lastMovDest_ = dest;
+  lastMovSrc_ = src;
 }
 
 void HBCISel::emitUnreachableIfDebug() {
@@ -688,6 +727,8 @@ void HBCISel::generateLoadPropertyInst(
 
   if (auto *Lit = dyn_cast<LiteralString>(prop)) {
     auto id = BCFGen_->getIdentifierID(Lit);
+    if (literalSlots_ && tryEmitGetByIdSlot(Inst, Lit, id))
+      return;
     if (id > UINT16_MAX) {
       BCFGen_->emitGetByIdLong(
           resultReg, objReg, acquirePropertyReadCacheIndex(id), id);
@@ -868,7 +909,7 @@ void HBCISel::generateTerminatorInst(TerminatorInst *Inst, BasicBlock *next) {
 }
 void HBCISel::generateBranchInst(BranchInst *Inst, BasicBlock *next) {
   auto *dst = Inst->getBranchDest();
-  if (dst == next)
+  if (dst == next || getJumpTarget(dst) == next)
     return;
 
   auto loc = BCFGen_->emitJmpLong(0);
@@ -899,10 +940,101 @@ void HBCISel::generateSaveAndYieldInst(
     SaveAndYieldInst *Inst,
     BasicBlock *next) {
   auto result = encodeValue(Inst->getResult());
-  auto loc = BCFGen_->emitSaveGeneratorLong(0);
+  // Only the registers that execution may read after resuming at the next
+  // block need to be saved in the generator.
+  auto loc = BCFGen_->emitSaveGeneratorLong(
+      0, getLiveRegisterCount(Inst->getNextBlock()));
   registerLongJump(loc, Inst->getNextBlock());
   BCFGen_->emitRet(result);
 }
+
+void HBCISel::computeLiveRegisters() {
+  // Size the sets to hold every register used in the function.
+  unsigned numRegs = 0;
+  for (auto &BB : *F_) {
+    for (auto &I : BB) {
+      if (RA_.isAllocated(&I))
+        numRegs = std::max(numRegs, RA_.getRegister(&I).getIndex() + 1);
+    }
+  }
+
+  // Blocks covered by a catch may continue at the catch block.
+  CatchInfoMap catchInfo{};
+  llvm::SmallVector<CatchInst *, 4> aliveCatches{};
+  llvm::SmallPtrSet<BasicBlock *, 32> visited{};
+  constructCatchMap(catchInfo, aliveCatches, visited, &F_->front());
+  DenseMap<BasicBlock *, llvm::SmallVector<BasicBlock *, 2>> catchBlocks{};
+  for (auto &entry : catchInfo) {
+    for (auto *BB : entry.second.coveredBlockList)
+      catchBlocks[BB].push_back(entry.first->getParent());
+  }
+
+  PostOrderAnalysis PO(F_);
+  for (auto *BB : PO)
+    liveRegistersIn_[BB].resize(numRegs);
+
+  // Iterate backwards until the sets don't change. Stack locations are
+  // written by StoreStackInst and by the isReturn operand of
+  // ResumeGeneratorInst; any other output operand counts as a read, which only
+  // makes the result conservative.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto *BB : PO) {
+      llvm::BitVector live(numRegs);
+      for (auto *succ : successors(BB))
+        live |= liveRegistersIn_[succ];
+      auto catchIt = catchBlocks.find(BB);
+      if (catchIt != catchBlocks.end()) {
+        for (auto *catchBB : catchIt->second)
+          live |= liveRegistersIn_[catchBB];
+      }
+      for (auto it = BB->rbegin(), e = BB->rend(); it != e; ++it) {
+        Instruction *I = &*it;
+        if (RA_.isAllocated(I))
+          live.reset(RA_.getRegister(I).getIndex());
+        // PhiInsts have been lowered to Movs in the predecessors.
+        if (isa<PhiInst>(I))
+          continue;
+        Value *written = nullptr;
+        if (auto *SSI = dyn_cast<StoreStackInst>(I))
+          written = SSI->getPtr();
+        else if (auto *RGI = dyn_cast<ResumeGeneratorInst>(I))
+          written = RGI->getIsReturn();
+        if (written) {
+          auto *writtenInst = cast<Instruction>(written);
+          if (RA_.isAllocated(writtenInst))
+            live.reset(RA_.getRegister(writtenInst).getIndex());
+        }
+        for (unsigned i = 0, e = I->getNumOperands(); i != e; ++i) {
+          auto *op = dyn_cast<Instruction>(I->getOperand(i));
+          if (op && op != written && RA_.isAllocated(op))
+            live.set(RA_.getRegister(op).getIndex());
+        }
+      }
+      if (catchIt != catchBlocks.end()) {
+        for (auto *catchBB : catchIt->second)
+          live |= liveRegistersIn_[catchBB];
+      }
+      auto &liveIn = liveRegistersIn_[BB];
+      if (live != liveIn) {
+        liveIn = std::move(live);
+        changed = true;
+      }
+    }
+  }
+}
+
+unsigned HBCISel::getLiveRegisterCount(BasicBlock *BB) {
+  if (liveRegistersIn_.empty())
+    computeLiveRegisters();
+  auto it = liveRegistersIn_.find(BB);
+  if (it == liveRegistersIn_.end())
+    return 0;
+  int last = it->second.find_last();
+  return last < 0 ? 0 : last + 1;
+}
+
 void HBCISel::generateCreateGeneratorInst(
     CreateGeneratorInst *Inst,
     BasicBlock *next) {
@@ -940,6 +1072,23 @@ void HBCISel::generateCondBranchInst(CondBranchInst *Inst, BasicBlock *next) {
   BasicBlock *trueBlock = Inst->getTrueDest();
   BasicBlock *falseBlock = Inst->getFalseDest();
 
+  // A branch on a constant only needs a jump to the side it always takes.
+  auto *loadConst = llvm::dyn_cast<HBCLoadConstInst>(Inst->getCondition());
+  if (peephole_ && loadConst) {
+    IRBuilder builder(F_);
+    BasicBlock *dst = nullptr;
+    if (evalIsTrue(builder, loadConst->getConst()))
+      dst = trueBlock;
+    else if (evalIsFalse(builder, loadConst->getConst()))
+      dst = falseBlock;
+    if (dst) {
+      ++NumBranchesFolded;
+      if (dst != next && getJumpTarget(dst) != next)
+        registerLongJump(BCFGen_->emitJmpLong(0), dst);
+      return;
+    }
+  }
+
   // Emit a conditional jump to the 'False' destination and a fall-through to
   // the 'True' side.
   if (next == trueBlock) {
@@ -1132,11 +1281,75 @@ void HBCISel::generateCallInst(CallInst *Inst, BasicBlock *next) {
   }
 }
 
+/// \return the element type of the DataView.prototype method called by
+/// \p Inst, with whether it is a set method in \p isSet, if the call is
+/// emitted as DataViewGet or DataViewSet, or DataViewType::_count otherwise.
+static DataViewType::Enum getDataViewMethod(HBCCallNInst *Inst, bool &isSet) {
+  // The method is loaded from the object it is called on.
+  auto *LPI = dyn_cast<LoadPropertyInst>(Inst->getCallee());
+  if (!LPI || LPI->getKind() != ValueKind::LoadPropertyInstKind ||
+      LPI->getObject() != Inst->getThis())
+    return DataViewType::_count;
+  auto *name = dyn_cast<LiteralString>(LPI->getProperty());
+  if (!name)
+    return DataViewType::_count;
+
+  StringRef str = name->getValue().str();
+  isSet = str.startswith("set");
+  if (!isSet && !str.startswith("get"))
+    return DataViewType::_count;
+  // The offset, the value of a set, and optionally littleEndian. The result
+  // of a set isn't stored.
+  unsigned numArgs = Inst->getNumArguments() - 1;
+  unsigned minArgs = isSet ? 2 : 1;
+  if (numArgs < minArgs || numArgs > minArgs + 1 ||
+      (isSet && Inst->hasUsers()))
+    return DataViewType::_count;
+  return llvm::StringSwitch<DataViewType::Enum>(str.substr(3))
+      .Case("Int8", DataViewType::Int8)
+      .Case("Int16", DataViewType::Int16)
+      .Case("Int32", DataViewType::Int32)
+      .Case("Uint8", DataViewType::Uint8)
+      .Case("Uint16", DataViewType::Uint16)
+      .Case("Uint32", DataViewType::Uint32)
+      .Case("Float32", DataViewType::Float32)
+      .Case("Float64", DataViewType::Float64)
+      .Default(DataViewType::_count);
+}
+
 void HBCISel::generateHBCCallNInst(HBCCallNInst *Inst, BasicBlock *next) {
   auto output = encodeValue(Inst);
   auto function = encodeValue(Inst->getCallee());
   verifyCall(Inst);
 
+  bool isSet;
+  DataViewType::Enum type = getDataViewMethod(Inst, isSet);
+  if (type != DataViewType::_count) {
+    auto view = encodeValue(Inst->getArgument(0));
+    auto offset = encodeValue(Inst->getArgument(1));
+    // Without littleEndian, the type says so, and any register will do.
+    unsigned littleEndianIdx = isSet ? 3 : 2;
+    auto littleEndian = offset;
+    uint8_t typeOperand = type;
+    if (Inst->getNumArguments() > littleEndianIdx) {
+      littleEndian = encodeValue(Inst->getArgument(littleEndianIdx));
+      typeOperand |= DataViewType::LittleEndianArg;
+    }
+    if (isSet) {
+      BCFGen_->emitDataViewSet(
+          function,
+          view,
+          offset,
+          encodeValue(Inst->getArgument(2)),
+          littleEndian,
+          typeOperand);
+    } else {
+      BCFGen_->emitDataViewGet(
+          output, function, view, offset, littleEndian, typeOperand);
+    }
+    return;
+  }
+
   static_assert(
       HBCCallNInst::kMinArgs == 1 && HBCCallNInst::kMaxArgs == 4,
       "Update generateHBCCallNInst to reflect min/max arg range");
@@ -1178,8 +1391,57 @@ void HBCISel::generateConstructInst(ConstructInst *Inst, BasicBlock *next) {
   llvm_unreachable("ConstructInst should have been lowered");
 }
 
+/// \return the number of arguments read by the Math method \p builtin if it
+/// has an instruction computing it inline, or 0 otherwise.
+static unsigned getInlineBuiltinArity(BuiltinMethod::Enum builtin) {
+  switch (builtin) {
+    case BuiltinMethod::Math_abs:
+    case BuiltinMethod::Math_ceil:
+    case BuiltinMethod::Math_floor:
+    case BuiltinMethod::Math_sqrt:
+      return 1;
+    case BuiltinMethod::Math_min:
+    case BuiltinMethod::Math_max:
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+bool HBCISel::isInlineBuiltinCall(CallBuiltinInst *Inst) {
+  // Only calls passing exactly the arguments the method reads, after the
+  // undefined "this", have an inline form.
+  unsigned arity = getInlineBuiltinArity(Inst->getBuiltinIndex());
+  return arity && Inst->getNumArguments() == arity + 1;
+}
+
 void HBCISel::generateCallBuiltinInst(CallBuiltinInst *Inst, BasicBlock *next) {
   auto output = encodeValue(Inst);
+  if (isInlineBuiltinCall(Inst)) {
+    auto arg1 = encodeValue(Inst->getArgument(1));
+    switch (Inst->getBuiltinIndex()) {
+      case BuiltinMethod::Math_abs:
+        BCFGen_->emitMathAbs(output, arg1);
+        return;
+      case BuiltinMethod::Math_ceil:
+        BCFGen_->emitMathCeil(output, arg1);
+        return;
+      case BuiltinMethod::Math_floor:
+        BCFGen_->emitMathFloor(output, arg1);
+        return;
+      case BuiltinMethod::Math_sqrt:
+        BCFGen_->emitMathSqrt(output, arg1);
+        return;
+      case BuiltinMethod::Math_min:
+        BCFGen_->emitMathMin(output, arg1, encodeValue(Inst->getArgument(2)));
+        return;
+      case BuiltinMethod::Math_max:
+        BCFGen_->emitMathMax(output, arg1, encodeValue(Inst->getArgument(2)));
+        return;
+      default:
+        llvm_unreachable("builtin has no inline form");
+    }
+  }
   verifyCall(Inst);
 
   assert(
@@ -1188,6 +1450,18 @@ void HBCISel::generateCallBuiltinInst(CallBuiltinInst *Inst, BasicBlock *next) {
   BCFGen_->emitCallBuiltin(
       output, Inst->getBuiltinIndex(), Inst->getNumArguments());
 }
+void HBCISel::generateStringConcatInst(
+    StringConcatInst *Inst,
+    BasicBlock *next) {
+  auto output = encodeValue(Inst);
+  verifyCall(Inst);
+
+  assert(
+      Inst->getNumArguments() <= UINT8_MAX &&
+      "too many operands to StringConcat");
+  BCFGen_->emitStringConcat(output, Inst->getNumArguments());
+}
+
 void HBCISel::generateHBCCallDirectInst(
     HBCCallDirectInst *Inst,
     BasicBlock *next) {
@@ -1226,8 +1500,44 @@ void HBCISel::generateHBCResolveEnvironment(
       curScopeDepth && curScopeDepth.getValue() >= instScopeDepth.getValue() &&
       "Cannot access variables in inner scopes");
   int32_t delta = curScopeDepth.getValue() - instScopeDepth.getValue();
-  assert(delta > 0 && "HBCResolveEnvironment for current scope");
-  BCFGen_->emitGetEnvironment(encodeValue(Inst), delta - 1);
+  // GetEnvironment counts from the environment the function was created in,
+  // which is the function's own environment if it is flattened.
+  if (!F_->isEnvironmentFlattened()) {
+    assert(delta > 0 && "HBCResolveEnvironment for current scope");
+    --delta;
+  }
+  auto envReg = encodeValue(Inst);
+  if (peephole_ && fuseEnvironmentAccess(Inst, envReg, delta))
+    return;
+  BCFGen_->emitGetEnvironment(envReg, delta);
+}
+bool HBCISel::fuseEnvironmentAccess(
+    HBCResolveEnvironment *Inst,
+    param_t envReg,
+    uint8_t level) {
+  Instruction *access = Inst->getNextNode();
+  if (auto *load = dyn_cast<HBCLoadFromEnvironmentInst>(access)) {
+    auto varIdx = encodeValue(load->getResolvedName());
+    if (load->getEnvironment() != Inst || varIdx > UINT8_MAX)
+      return false;
+    BCFGen_->emitGetEnvironmentAndLoad(
+        envReg, encodeValue(load), level, varIdx);
+  } else if (auto *store = dyn_cast<HBCStoreToEnvironmentInst>(access)) {
+    auto varIdx = encodeValue(store->getResolvedName());
+    if (store->getEnvironment() != Inst || varIdx > UINT8_MAX)
+      return false;
+    auto valueReg = encodeValue(store->getStoredValue());
+    if (store->getStoredValue()->getType().isNonPtr()) {
+      BCFGen_->emitGetEnvironmentAndStoreNP(envReg, level, varIdx, valueReg);
+    } else {
+      BCFGen_->emitGetEnvironmentAndStore(envReg, level, varIdx, valueReg);
+    }
+  } else {
+    return false;
+  }
+  ++NumEnvironmentAccessesFused;
+  fusedNext_ = access;
+  return true;
 }
 void HBCISel::generateHBCStoreToEnvironmentInst(
     HBCStoreToEnvironmentInst *Inst,
@@ -1460,6 +1770,45 @@ void HBCISel::generateSwitchImmInst(
   switchImmInfo_[Inst] = {0, Inst->getDefaultDestination(), jmpTable};
 }
 
+void HBCISel::generateSwitchHashInst(
+    hermes::SwitchHashInst *Inst,
+    hermes::BasicBlock *next) {
+  uint32_t numSlots = Inst->getNumSlots();
+  bool strings = Inst->hasStringCases();
+
+  // Empty slots jump to the default block, and their key is never compared.
+  std::vector<uint32_t> keys(numSlots, 0);
+  std::vector<BasicBlock *> jmpTable(numSlots, Inst->getDefaultDestination());
+
+  for (uint32_t caseIdx = 0; caseIdx < Inst->getNumCasePair(); caseIdx++) {
+    auto casePair = Inst->getCasePair(caseIdx);
+    uint32_t hash, key;
+    if (strings) {
+      auto *str = cast<LiteralString>(casePair.first);
+      hash = hashSwitchString(str->getValue().str());
+      key = BCFGen_->getIdentifierID(str);
+    } else {
+      int32_t num = cast<LiteralNumber>(casePair.first)->asInt32();
+      hash = hashSwitchInt32(num);
+      key = (uint32_t)num;
+    }
+    uint32_t slot = hash & (numSlots - 1);
+    assert(
+        jmpTable[slot] == Inst->getDefaultDestination() &&
+        "cases must have distinct slots");
+    keys[slot] = key;
+    jmpTable[slot] = casePair.second;
+  }
+
+  auto input = encodeValue(Inst->getInputValue());
+  registerSwitchImm(
+      strings ? BCFGen_->emitSwitchStr(input, 0, 0, numSlots)
+              : BCFGen_->emitSwitchSparse(input, 0, 0, numSlots),
+      Inst);
+  switchImmInfo_[Inst] = {
+      0, Inst->getDefaultDestination(), jmpTable, std::move(keys)};
+}
+
 void HBCISel::initialize() {
   IRBuilder builder(F_->getParent());
   if (F_->isGlobalScope()) {
@@ -1483,6 +1832,8 @@ void HBCISel::generate(BasicBlock *BB, BasicBlock *next) {
   relocations_.push_back(
       {begin_loc, Relocation::RelocationType::BasicBlockType, BB});
   basicBlockMap_[BB] = std::make_pair(begin_loc, next);
+  // The block may be reached by a jump, after any Mov.
+  lastMovEnd_ = ~offset_t(0);
 
   if (BB == &F_->front()) {
     initialize();
@@ -1494,6 +1845,11 @@ void HBCISel::generate(BasicBlock *BB, BasicBlock *next) {
   const Instruction *asyncBreakCheckLoc =
       asyncBreakChecks_.count(BB) ? BB->getTerminator() : nullptr;
   for (auto &I : *BB) {
+    if (&I == fusedNext_) {
+      // Already emitted together with the instruction before it.
+      fusedNext_ = nullptr;
+      continue;
+    }
     if (&I == asyncBreakCheckLoc) {
       BCFGen_->emitAsyncBreakCheck();
     }
@@ -1600,6 +1956,38 @@ uint8_t HBCISel::acquirePropertyReadCacheIndex(unsigned id) {
   return idx;
 }
 
+bool HBCISel::tryEmitGetByIdSlot(
+    LoadPropertyInst *Inst,
+    LiteralString *prop,
+    unsigned id) {
+  auto *alloc = dyn_cast<HBCAllocObjectFromBufferInst>(Inst->getObject());
+  if (!alloc || id > UINT16_MAX ||
+      lastPropertyReadCacheIndex_ == std::numeric_limits<uint8_t>::max())
+    return false;
+
+  // The object gets its properties in the order of the keys, but numeric keys
+  // may not take a slot. The VM checks the slot before it relies on it, so
+  // this only needs to be a good guess.
+  unsigned e = alloc->getKeyValuePairCount();
+  for (unsigned slot = 0; slot < e && slot <= UINT8_MAX; ++slot) {
+    auto *key = dyn_cast<LiteralString>(alloc->getKeyValuePair(slot).first);
+    if (!key)
+      return false;
+    if (key != prop)
+      continue;
+    ++NumLiteralSlotLoads;
+    ++NumCacheSlots;
+    BCFGen_->emitGetByIdSlot(
+        encodeValue(Inst),
+        encodeValue(alloc),
+        ++lastPropertyReadCacheIndex_,
+        slot,
+        id);
+    return true;
+  }
+  return false;
+}
+
 uint8_t HBCISel::acquirePropertyWriteCacheIndex(unsigned id) {
   const bool reuse = F_->getContext().getOptimizationSettings().reusePropCache;
   // Zero is reserved for indicating no-cache, so cannot be a value in the map.
@@ -13,9 +13,12 @@
 #include "hermes/BCGen/HBC/BytecodeStream.h"
 #include "hermes/BCGen/HBC/HBC.h"
 #include "hermes/BCGen/HBC/ISel.h"
+#include "hermes/BCGen/HBC/SwitchHash.h"
 #include "hermes/BCGen/Lowering.h"
 
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/Support/MathExtras.h"
 
 #define DEBUG_TYPE "hbc-backend"
 
@@ -182,12 +185,19 @@ bool LoadConstants::operandMustBeLiteral(Instruction *Inst, unsigned opIndex) {
        opIndex >= SwitchImmInst::FirstCaseIdx))
     return true;
 
+  if (isa<SwitchHashInst>(Inst) && opIndex >= SwitchHashInst::NumSlotsIdx)
+    return true;
+
   /// CallBuiltin's callee and "this" should always be literals.
   if (isa<CallBuiltinInst>(Inst) &&
       (opIndex == CallBuiltinInst::CalleeIdx ||
        opIndex == CallBuiltinInst::ThisIdx))
     return true;
 
+  /// StringConcat's callee is always undefined.
+  if (isa<StringConcatInst>(Inst) && opIndex == StringConcatInst::CalleeIdx)
+    return true;
+
   return false;
 }
 
@@ -252,6 +262,8 @@ bool LoadParameters::runOnFunction(Function *F) {
   for (Parameter *p : F->getParameters()) {
     auto *load =
         builder.createHBCLoadParamInst(builder.getLiteralNumber(index));
+    // Keep the type inferred for the parameter, so that ISel can use it.
+    load->setType(p->getType());
     p->replaceAllUsesWith(load);
     index++;
     changed = true;
@@ -272,13 +284,75 @@ bool LoadParameters::runOnFunction(Function *F) {
   return changed;
 }
 
+/// \return true if \p F may use the environment it was created in as its own
+/// instead of creating one, which is only the case if nothing stores into its
+/// scope and nothing at runtime relies on each function having its own
+/// environment.
+static bool canFlattenEnvironment(Function *F) {
+  Context &context = F->getContext();
+  // The debugger and lazy compilation describe the environment chain as one
+  // environment per enclosing function.
+  if (!context.getOptimizationSettings().flattenEnvironments ||
+      context.isLazyCompilation() ||
+      context.getDebugInfoSetting() == DebugInfoSetting::ALL)
+    return false;
+  // The depths of the global scope and of CommonJS modules are fixed, and
+  // generators keep their environments across resumptions.
+  if (F->isGlobalScope() || F->getParent()->findCJSModule(F) ||
+      isa<GeneratorFunction>(F) || isa<GeneratorInnerFunction>(F))
+    return false;
+  for (Variable *var : F->getFunctionScope()->getVariables()) {
+    if (var->hasUsers())
+      return false;
+  }
+  return true;
+}
+
+/// \return the variable of an outer scope of \p F accessed by \p inst, or
+/// null if it doesn't access one.
+static Variable *getOuterVariable(Function *F, Instruction *inst) {
+  Variable *var = nullptr;
+  if (auto *LFI = dyn_cast<LoadFrameInst>(inst))
+    var = LFI->getLoadVariable();
+  else if (auto *SFI = dyn_cast<StoreFrameInst>(inst))
+    var = SFI->getVariable();
+  return var && var->getParent()->getFunction() != F ? var : nullptr;
+}
+
+void LowerLoadStoreFrameInst::resolveEntryEnvironments(
+    IRBuilder &builder,
+    Function *F) {
+  llvm::DenseMap<VariableScope *, unsigned> numAccesses;
+  for (BasicBlock &BB : F->getBasicBlockList()) {
+    for (Instruction &inst : BB) {
+      if (Variable *var = getOuterVariable(F, &inst))
+        ++numAccesses[var->getParent()];
+    }
+  }
+  // Resolve them in the order of their first access, so that the output
+  // doesn't depend on the order of the map.
+  for (BasicBlock &BB : F->getBasicBlockList()) {
+    for (Instruction &inst : BB) {
+      Variable *var = getOuterVariable(F, &inst);
+      if (!var || numAccesses.lookup(var->getParent()) < 2)
+        continue;
+      Instruction *&env = entryEnvironments_[var->getParent()];
+      if (!env)
+        env = builder.createHBCResolveEnvironment(var->getParent());
+    }
+  }
+}
+
 Instruction *LowerLoadStoreFrameInst::getScope(
     IRBuilder &builder,
     Variable *var,
-    HBCCreateEnvironmentInst *captureScope) {
+    Instruction *captureScope) {
   if (var->getParent()->getFunction() != builder.getFunction()) {
     // If the variable is neither from the current scope,
     // we should get the proper scope for it.
+    auto it = entryEnvironments_.find(var->getParent());
+    if (it != entryEnvironments_.end())
+      return it->second;
     return builder.createHBCResolveEnvironment(var->getParent());
   } else {
     // Now we know that the variable belongs to the current scope.
@@ -303,10 +377,20 @@ bool LowerLoadStoreFrameInst::runOnFunction(Function *F) {
   // there are no captured variables in this function.
   // Closures need a new environment even without captured variables because
   // we currently use only the lexical nesting level to determine which parent
-  // environment to use - we don't account for the case when an environment may
-  // not be needed somewhere along the chain.
-  HBCCreateEnvironmentInst *captureScope =
-      builder.createHBCCreateEnvironmentInst();
+  // environment to use, unless the function is marked as flattened: then its
+  // scope has the depth of its parent's and resolving it gives the environment
+  // the function was created in.
+  Instruction *captureScope;
+  if (canFlattenEnvironment(F)) {
+    F->setEnvironmentFlattened();
+    captureScope = builder.createHBCResolveEnvironment(F->getFunctionScope());
+  } else {
+    captureScope = builder.createHBCCreateEnvironmentInst();
+  }
+
+  entryEnvironments_.clear();
+  if (F->getContext().getOptimizationSettings().flattenEnvironments)
+    resolveEntryEnvironments(builder, F);
 
   for (BasicBlock &BB : F->getBasicBlockList()) {
     for (auto I = BB.begin(), E = BB.end(); I != E; /* nothing */) {
@@ -397,6 +481,188 @@ CreateArgumentsInst *LowerArgumentsArray::getCreateArgumentsInst(Function *F) {
   return nullptr;
 }
 
+namespace {
+/// A call that only passes the arguments object along to another function,
+/// and the builtin call replacing it.
+struct ForwardingCall {
+  /// The call to replace.
+  CallInst *call;
+  /// The builtin to call instead.
+  BuiltinMethod::Enum builtin;
+  /// The arguments of the builtin.
+  llvm::SmallVector<Value *, 3> args;
+  /// Instructions that only fed the call, to be erased with it.
+  llvm::SmallVector<Instruction *, 2> dead;
+};
+} // namespace
+
+/// \return true if \p value is the literal string \p str.
+static bool isLiteralString(Value *value, StringRef str) {
+  auto *lit = dyn_cast<LiteralString>(value);
+  return lit && lit->getValue().str() == str;
+}
+
+/// \return true if \p value loads `Array.prototype.slice` or `[].slice`.
+static bool isArraySlice(Value *value) {
+  auto *slice = dyn_cast<LoadPropertyInst>(value);
+  if (!slice || !isLiteralString(slice->getProperty(), "slice"))
+    return false;
+  if (auto *array = dyn_cast<AllocArrayInst>(slice->getObject()))
+    return array->getElementCount() == 0 && array->hasOneUser();
+  auto *proto = dyn_cast<LoadPropertyInst>(slice->getObject());
+  if (!proto || !isLiteralString(proto->getProperty(), "prototype"))
+    return false;
+  auto *ctor = dyn_cast<LoadPropertyInst>(proto->getObject());
+  return ctor && isa<GlobalObject>(ctor->getObject()) &&
+      isLiteralString(ctor->getProperty(), "Array");
+}
+
+/// Match the calls that only pass \p createArguments along:
+/// - `fn.apply(thisVal, arguments)`, which becomes
+///   HermesBuiltin.applyArguments(fn, thisVal, fn.apply). The builtin checks
+///   that fn.apply is Function.prototype.apply.
+/// - `Array.prototype.slice.call(arguments, from)`, which becomes
+///   HermesBuiltin.copyRestArgs(from).
+/// - `fn(...arguments)`, which becomes
+///   HermesBuiltin.applyArguments(fn, thisVal).
+/// The last two assume that the builtins haven't been modified, so they
+/// require \p staticBuiltins.
+/// \return the call that \p user is part of, if it is one of these.
+static llvm::Optional<ForwardingCall> matchForwardingCall(
+    IRBuilder &builder,
+    Instruction *user,
+    CreateArgumentsInst *createArguments,
+    bool staticBuiltins) {
+  if (user->getKind() == ValueKind::CallInstKind) {
+    auto *call = cast<CallInst>(user);
+    auto *callee = dyn_cast<LoadPropertyInst>(call->getCallee());
+    if (!callee || callee->getObject() != call->getArgument(0) ||
+        call->getArgument(0) == createArguments)
+      return llvm::None;
+    unsigned numArgs = call->getNumArguments();
+
+    if (isLiteralString(callee->getProperty(), "apply") && numArgs == 3 &&
+        call->getArgument(1) != createArguments &&
+        call->getArgument(2) == createArguments) {
+      Value *fn = call->getArgument(0);
+      Value *thisVal = call->getArgument(1);
+      return ForwardingCall{call,
+                            BuiltinMethod::HermesBuiltin_applyArguments,
+                            {fn, thisVal, callee}};
+    }
+
+    if (staticBuiltins && isLiteralString(callee->getProperty(), "call") &&
+        isArraySlice(callee->getObject()) && (numArgs == 2 || numArgs == 3) &&
+        call->getArgument(1) == createArguments) {
+      // A negative start counts from the end, which copyRestArgs can't do.
+      Value *from = builder.getLiteralPositiveZero();
+      if (numArgs == 3) {
+        auto *lit = dyn_cast<LiteralNumber>(call->getArgument(2));
+        if (!lit || !lit->isIntTypeRepresentible<uint32_t>())
+          return llvm::None;
+        from = lit;
+      }
+      return ForwardingCall{
+          call, BuiltinMethod::HermesBuiltin_copyRestArgs, {from}};
+    }
+    return llvm::None;
+  }
+
+  // The spread is IRGen'd as an array filled by arraySpread and passed to
+  // HermesBuiltin.apply.
+  auto *spread = dyn_cast<CallBuiltinInst>(user);
+  if (!staticBuiltins || !spread ||
+      spread->getBuiltinIndex() != BuiltinMethod::HermesBuiltin_arraySpread ||
+      spread->getNumArguments() != 4 || spread->hasUsers() ||
+      spread->getArgument(2) != createArguments)
+    return llvm::None;
+  auto *array = dyn_cast<AllocArrayInst>(spread->getArgument(1));
+  auto *nextIndex = dyn_cast<LiteralNumber>(spread->getArgument(3));
+  if (!array || array->getElementCount() != 0 ||
+      array->getNumUsers() != 2 || !nextIndex || !nextIndex->isPositiveZero())
+    return llvm::None;
+  for (auto *arrayUser : array->getUsers()) {
+    auto *apply = dyn_cast<CallBuiltinInst>(arrayUser);
+    // HermesBuiltin.apply without a this argument is a construction.
+    if (!apply ||
+        apply->getBuiltinIndex() != BuiltinMethod::HermesBuiltin_apply ||
+        apply->getNumArguments() != 4 || apply->getArgument(2) != array ||
+        apply->getParent() != spread->getParent())
+      continue;
+    Value *fn = apply->getArgument(1);
+    Value *thisVal = apply->getArgument(3);
+    if (fn == array || thisVal == array || fn == createArguments ||
+        thisVal == createArguments)
+      return llvm::None;
+    return ForwardingCall{apply,
+                          BuiltinMethod::HermesBuiltin_applyArguments,
+                          {fn, thisVal},
+                          {spread, array}};
+  }
+  return llvm::None;
+}
+
+/// Erase \p value if it is an unused property load or array allocation, and
+/// then the object it loaded from. Like LowerBuiltinCalls, this assumes that
+/// the loads of builtins have no side effects.
+static void eraseUnusedLoads(Value *value) {
+  auto *inst = dyn_cast<Instruction>(value);
+  if (!inst || inst->hasUsers())
+    return;
+  if (auto *load = dyn_cast<LoadPropertyInst>(inst)) {
+    Value *object = load->getObject();
+    load->eraseFromParent();
+    eraseUnusedLoads(object);
+  } else if (isa<AllocArrayInst>(inst)) {
+    inst->eraseFromParent();
+  }
+}
+
+bool LowerArgumentsArray::forwardArguments(
+    Function *F,
+    CreateArgumentsInst *createArguments) {
+  // Generators don't run in the frame they were called with.
+  if (isa<GeneratorInnerFunction>(F))
+    return false;
+
+  // The builtins read the parameters from the frame, so they are only
+  // equivalent if the arguments object can't be modified, and
+  // applyArguments creates a new one when it can't forward, so its identity
+  // must not be observable. Only do it when every other use of the arguments
+  // object is a property load.
+  IRBuilder builder(F);
+  bool staticBuiltins =
+      F->getContext().getOptimizationSettings().staticBuiltins;
+  llvm::SmallVector<ForwardingCall, 2> calls;
+  llvm::SmallPtrSet<Instruction *, 4> seen;
+  for (auto *user : createArguments->getUsers()) {
+    if (!seen.insert(user).second)
+      continue;
+    auto *load = dyn_cast<LoadPropertyInst>(user);
+    if (load && load->getObject() == createArguments &&
+        load->getProperty() != createArguments)
+      continue;
+    auto call =
+        matchForwardingCall(builder, user, createArguments, staticBuiltins);
+    if (!call)
+      return false;
+    calls.push_back(std::move(*call));
+  }
+
+  for (auto &fwd : calls) {
+    builder.setInsertionPoint(fwd.call);
+    builder.setLocation(fwd.call->getLocation());
+    auto *builtin = builder.createCallBuiltinInst(fwd.builtin, fwd.args);
+    fwd.call->replaceAllUsesWith(builtin);
+    Value *callee = fwd.call->getCallee();
+    fwd.call->eraseFromParent();
+    for (auto *inst : fwd.dead)
+      inst->eraseFromParent();
+    eraseUnusedLoads(callee);
+  }
+  return !calls.empty();
+}
+
 bool LowerArgumentsArray::runOnFunction(Function *F) {
   IRBuilder builder(F);
   updateToEntryInsertionPoint(builder, F);
@@ -406,6 +672,8 @@ bool LowerArgumentsArray::runOnFunction(Function *F) {
     return false;
   }
 
+  forwardArguments(F, createArguments);
+
   builder.setInsertionPoint(createArguments);
   AllocStackInst *lazyReg = builder.createAllocStackInst("arguments");
   builder.createStoreStackInst(builder.getLiteralUndefined(), lazyReg);
@@ -578,6 +846,10 @@ bool LowerCalls::runOnFunction(Function *F) {
       // This also matches constructors.
       if (!call)
         continue;
+      // Builtins computed inline read their arguments where they are.
+      auto *builtin = dyn_cast<CallBuiltinInst>(call);
+      if (builtin && HBCISel::isInlineBuiltinCall(builtin))
+        continue;
       builder.setInsertionPoint(call);
       changed = true;
 
@@ -749,6 +1021,8 @@ bool SpillRegisters::requiresShortOperand(Instruction *I, int op) {
     case ValueKind::HBCSpillMovInstKind:
     case ValueKind::LoadStackInstKind:
     case ValueKind::StoreStackInstKind:
+    // StringConcat encodes none of its operands.
+    case ValueKind::StringConcatInstKind:
       return false;
     case ValueKind::CallInstKind:
     case ValueKind::ConstructInstKind:
@@ -850,6 +1124,9 @@ bool SpillRegisters::runOnFunction(Function *F) {
   return true;
 }
 
+/// Switches with fewer cases are left to be lowered into a chain of compares.
+static constexpr unsigned MIN_JUMP_TABLE_CASES = 10;
+
 bool LowerSwitchIntoJumpTables::runOnFunction(Function *F) {
   bool changed = false;
   llvm::SmallVector<SwitchInst *, 4> switches;
@@ -861,7 +1138,7 @@ bool LowerSwitchIntoJumpTables::runOnFunction(Function *F) {
     }
 
   for (auto *S : switches) {
-    if (lowerIntoJumpTable(S))
+    if (lowerIntoJumpTable(S) || lowerIntoHashTable(S))
       changed = true;
   }
 
@@ -916,7 +1193,7 @@ bool LowerSwitchIntoJumpTables::lowerIntoJumpTable(SwitchInst *switchInst) {
 
   // Check the "denseness" of the cases.
   // Don't convert small switches.
-  if (range / numCases > 5 || numCases < 10)
+  if (range / numCases > 5 || numCases < MIN_JUMP_TABLE_CASES)
     return false;
 
   builder.setInsertionPoint(switchInst);
@@ -933,5 +1210,73 @@ bool LowerSwitchIntoJumpTables::lowerIntoJumpTable(SwitchInst *switchInst) {
   return true;
 }
 
+bool LowerSwitchIntoJumpTables::lowerIntoHashTable(SwitchInst *switchInst) {
+  if (isa<Literal>(switchInst->getInputValue()))
+    return false;
+  unsigned numCases = switchInst->getNumCasePair();
+  if (numCases < MIN_JUMP_TABLE_CASES)
+    return false;
+
+  // The cases must be all strings or all int32 numbers, so that a single
+  // lookup of the input finds the only one it can be strictly equal to.
+  bool strings = isa<LiteralString>(switchInst->getCasePair(0).first);
+  SwitchHashInst::ValueListType values;
+  SwitchHashInst::BasicBlockListType blocks;
+  llvm::SmallVector<uint32_t, 8> hashes;
+  for (unsigned i = 0; i != numCases; ++i) {
+    auto casePair = switchInst->getCasePair(i);
+    if (strings) {
+      auto *str = dyn_cast<LiteralString>(casePair.first);
+      if (!str)
+        return false;
+      hashes.push_back(hashSwitchString(str->getValue().str()));
+    } else {
+      auto *num = dyn_cast<LiteralNumber>(casePair.first);
+      if (!num || !num->isInt32Representible())
+        return false;
+      hashes.push_back(hashSwitchInt32(num->asInt32()));
+    }
+    values.push_back(casePair.first);
+    blocks.push_back(casePair.second);
+  }
+
+  // Find the smallest table in which every case has a slot of its own, so
+  // that the lookup never probes more than one slot.
+  uint32_t maxSlots =
+      llvm::PowerOf2Ceil(numCases) * SWITCH_HASH_MAX_SLOTS_PER_CASE;
+  uint32_t numSlots = llvm::PowerOf2Ceil(numCases);
+  llvm::BitVector used;
+  for (; numSlots <= maxSlots; numSlots *= 2) {
+    used.clear();
+    used.resize(numSlots);
+    bool collision = false;
+    for (uint32_t hash : hashes) {
+      uint32_t slot = hash & (numSlots - 1);
+      if (used.test(slot)) {
+        collision = true;
+        break;
+      }
+      used.set(slot);
+    }
+    if (!collision)
+      break;
+  }
+  if (numSlots > maxSlots)
+    return false;
+
+  IRBuilder builder(switchInst->getParent()->getParent());
+  builder.setInsertionPoint(switchInst);
+  auto *switchHashInst = builder.createSwitchHashInst(
+      switchInst->getInputValue(),
+      switchInst->getDefaultDestination(),
+      builder.getLiteralNumber(numSlots),
+      values,
+      blocks);
+
+  switchInst->replaceAllUsesWith(switchHashInst);
+  switchInst->eraseFromParent();
+  return true;
+}
+
 } // namespace hbc
 } // namespace hermes
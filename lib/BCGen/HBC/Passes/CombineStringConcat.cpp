@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#define DEBUG_TYPE "CombineStringConcat"
+#include "hermes/BCGen/HBC/Passes/CombineStringConcat.h"
+
+#include "hermes/IR/IRBuilder.h"
+#include "hermes/Support/Statistic.h"
+
+#include "llvm/ADT/SmallVector.h"
+
+STATISTIC(NumConcats, "Number of StringConcat instructions created");
+STATISTIC(NumAddsCombined, "Number of string additions combined");
+
+using llvm::dyn_cast;
+
+namespace hermes {
+namespace hbc {
+
+namespace {
+
+/// \return \p V as an addition producing a string, because one of its operands
+/// is a string, or nullptr if it is not one.
+BinaryOperatorInst *asStringAdd(Value *V) {
+  auto *add = dyn_cast<BinaryOperatorInst>(V);
+  if (!add || add->getOperatorKind() != BinaryOperatorInst::OpKind::AddKind)
+    return nullptr;
+  if (!add->getLeftHandSide()->getType().isStringType() &&
+      !add->getRightHandSide()->getType().isStringType())
+    return nullptr;
+  return add;
+}
+
+/// \return whether the string addition \p add is only an operand of another
+/// string addition in the same block, so that it can be combined with it.
+/// Staying in the block keeps both in the same try region.
+bool feedsStringAdd(BinaryOperatorInst *add) {
+  if (!add->hasOneUser())
+    return false;
+  Instruction *user = add->getUsers()[0];
+  return user->getParent() == add->getParent() && asStringAdd(user);
+}
+
+/// An operand of a string addition, which is not itself combined.
+struct Part {
+  Value *value;
+  /// The addition \c value is an operand of. If \c value is not a string, it
+  /// is converted there, so that its conversion still runs in the same order
+  /// relative to the other side effects.
+  BinaryOperatorInst *add;
+};
+
+/// Replace \p root and the string additions feeding it with a StringConcatInst.
+/// \return whether anything changed.
+bool combine(IRBuilder &builder, BinaryOperatorInst *root) {
+  // Walk the tree of additions left to right, collecting its parts in order
+  // and its additions with the root first.
+  llvm::SmallVector<Part, 8> parts;
+  llvm::SmallVector<BinaryOperatorInst *, 8> adds;
+  llvm::SmallVector<Part, 8> stack;
+  auto pushOperands = [&stack, &adds](BinaryOperatorInst *add) {
+    adds.push_back(add);
+    stack.push_back({add->getRightHandSide(), add});
+    stack.push_back({add->getLeftHandSide(), add});
+  };
+  pushOperands(root);
+  while (!stack.empty()) {
+    Part part = stack.pop_back_val();
+    auto *add = asStringAdd(part.value);
+    if (add && feedsStringAdd(add))
+      pushOperands(add);
+    else
+      parts.push_back(part);
+  }
+
+  // A single addition is already a single concatenation.
+  if (adds.size() < 2 || parts.size() > StringConcatInst::MAX_OPERANDS)
+    return false;
+
+  llvm::SmallVector<Value *, 8> operands;
+  for (const Part &part : parts) {
+    if (part.value->getType().isStringType()) {
+      operands.push_back(part.value);
+      continue;
+    }
+    builder.setInsertionPoint(part.add);
+    builder.setLocation(part.add->getLocation());
+    operands.push_back(builder.createAddEmptyStringInst(part.value));
+  }
+
+  builder.setInsertionPoint(root);
+  builder.setLocation(root->getLocation());
+  auto *concat = builder.createStringConcatInst(operands);
+  root->replaceAllUsesWith(concat);
+  // Each addition is only used by the one before it in the list.
+  for (auto *add : adds)
+    add->eraseFromParent();
+
+  ++NumConcats;
+  NumAddsCombined += adds.size();
+  return true;
+}
+
+} // namespace
+
+bool CombineStringConcat::runOnFunction(Function *F) {
+  IRBuilder builder{F};
+
+  // Find the last addition of every chain first, since combining a chain
+  // erases its additions.
+  llvm::SmallVector<BinaryOperatorInst *, 8> roots;
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      auto *add = asStringAdd(&I);
+      if (add && !feedsStringAdd(add))
+        roots.push_back(add);
+    }
+  }
+
+  bool changed = false;
+  for (auto *root : roots)
+    changed |= combine(builder, root);
+  return changed;
+}
+
+} // namespace hbc
+} // namespace hermes
@@ -70,7 +70,11 @@ std::unique_ptr<Buffer> SimpleBytecodeBuilder::generateBytecodeBuffer() {
                             0,
                             0,
                             0,
+                            0,
+                            0,
+                            0,
                             debugOffset,
+                            0,
                             options};
   // Write BytecodeFileHeader to the buffer.
   appendStructToBytecode(bytecode, header);
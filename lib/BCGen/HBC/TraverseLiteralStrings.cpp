@@ -35,6 +35,11 @@ bool isIdOperand(Instruction *I, unsigned idx) {
       // operands starting from FirstKeyIdx.
       return (idx - HBCAllocObjectFromBufferInst::FirstKeyIdx) % 2 == 0;
 
+    case ValueKind::SwitchHashInstKind:
+      // The string cases of SwitchHash are compared as identifiers.
+      return idx >= SwitchHashInst::FirstCaseIdx &&
+          (idx - SwitchHashInst::FirstCaseIdx) % 2 == 0;
+
     default:
       return false;
   }
@@ -75,6 +75,12 @@ void RegisterFile::killRegister(Register reg) {
   assert(isFree(reg) && "Error freeing register!");
 }
 
+void RegisterFile::shrink(unsigned n) {
+  assert(n <= registers.size() && "Can't grow the register file");
+  assert(getNumLiveRegisters() == 0 && "Shrinking a register file in use");
+  registers.resize(n);
+}
+
 void RegisterFile::verify() {}
 
 void RegisterFile::dump() {
@@ -886,6 +892,48 @@ bool RegisterAllocator::isAllocated(Value *I) {
   return allocated.count(I);
 }
 
+unsigned RegisterAllocator::compactRegisters() {
+  unsigned numRegisters = file.getMaxRegisterUsage();
+  BitVector used(numRegisters);
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      if (!isAllocated(&I))
+        continue;
+      unsigned idx = getRegister(&I).getIndex();
+      if (idx < numRegisters)
+        used.set(idx);
+    }
+  }
+
+  unsigned numDropped = numRegisters - used.count();
+  if (!numDropped)
+    return 0;
+
+  // Keep the order of the registers, so that consecutive registers stay
+  // consecutive.
+  llvm::SmallVector<unsigned, 32> newIndex(numRegisters);
+  for (unsigned i = 0, next = 0; i < numRegisters; ++i) {
+    if (used.test(i))
+      newIndex[i] = next++;
+  }
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      if (!isAllocated(&I))
+        continue;
+      unsigned idx = getRegister(&I).getIndex();
+      updateRegister(
+          &I,
+          Register(idx < numRegisters ? newIndex[idx] : idx - numDropped));
+    }
+  }
+  file.shrink(numRegisters - numDropped);
+
+  LLVM_DEBUG(
+      dbgs() << "Dropped " << numDropped << " of " << numRegisters
+             << " registers in " << F->getInternalNameStr() << "\n");
+  return numDropped;
+}
+
 Register RegisterAllocator::reserve(unsigned count) {
   return file.tailAllocateConsecutive(count);
 }
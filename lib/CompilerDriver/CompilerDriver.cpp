@@ -31,12 +31,17 @@
 #include "hermes/SourceMap/SourceMapParser.h"
 #include "hermes/SourceMap/SourceMapTranslator.h"
 #include "hermes/Support/Algorithms.h"
+#include "hermes/Support/BasicBlockProfile.h"
 #include "hermes/Support/MemoryBuffer.h"
 #include "hermes/Support/OSCompat.h"
+#include "hermes/Support/SHA1.h"
+#include "hermes/Support/Statistic.h"
 #include "hermes/Support/Warning.h"
 #include "hermes/Utils/Dumper.h"
 #include "hermes/Utils/Options.h"
 
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FileSystem.h"
@@ -48,10 +53,17 @@
 
 #include "zip/src/zip.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 #define DEBUG_TYPE "hermes"
 
+STATISTIC(ASTPeakBytes, "Peak bytes allocated for ASTs");
+
 using llvm::ArrayRef;
 using llvm::cast;
 using llvm::dyn_cast;
@@ -260,6 +272,12 @@ static opt<bool> LazyCompilation(
     desc("Compile source lazily when executing (HBC only)"),
     cat(CompilerCategory));
 
+static opt<std::string> LazyCacheDir(
+    "lazy-cache",
+    desc("Directory where lazily compiled functions are kept across runs"),
+    value_desc("dir"),
+    cat(CompilerCategory));
+
 /// The following flags are exported so it may be used by the VM driver as well.
 opt<bool> BasicBlockProfiling(
     "basic-block-profiling",
@@ -288,6 +306,15 @@ opt<bool> EmitAsyncBreakCheck(
     init(false),
     cat(CompilerCategory));
 
+static list<std::string> Defines(
+    "D",
+    desc("Replace reads of a global, or of a property of it like "
+         "process.env.NODE_ENV, with a constant (can be specified more "
+         "than once)"),
+    value_desc("name=value"),
+    Prefix,
+    cat(CompilerCategory));
+
 static list<std::string> IncludeGlobals(
     "include-globals",
     desc("Include the definitions of global properties (can be "
@@ -402,6 +429,12 @@ static opt<bool> CommonJS(
     init(false),
     cat(CompilerCategory));
 
+static opt<unsigned> ParseThreads(
+    "parse-threads",
+    desc("Number of threads parsing CommonJS modules (0 means one per core)"),
+    init(0),
+    cat(CompilerCategory));
+
 static CLFlag StaticRequire(
     'f',
     "static-require",
@@ -443,6 +476,13 @@ static opt<bool> ReusePropCache(
 static CLFlag
     Inline('f', "inline", true, "inlining of functions", CompilerCategory);
 
+static CLFlag FlattenEnvironments(
+    'f',
+    "flatten-environments",
+    false,
+    "flattening of environments without captured variables",
+    CompilerCategory);
+
 static CLFlag Outline(
     'f',
     "outline",
@@ -520,6 +560,85 @@ static opt<unsigned> PadFunctionBodiesPercent(
     Hidden,
     cat(CompilerCategory));
 
+static opt<std::string> ProfileUse(
+    "profile-use",
+    desc("Guide optimizations with the basic block profile in this file, "
+         "which was written by a run with -basic-block-profiling"),
+    value_desc("filename"),
+    init(""),
+    cat(CompilerCategory));
+
+static opt<std::string> LayoutTrace(
+    "layout-trace",
+    desc("Place the bodies of the functions touched in this page access trace "
+         "first, in the order they were touched. The trace is the JSON "
+         "output of PageAccessTracker"),
+    value_desc("filename"),
+    init(""),
+    cat(CompilerCategory));
+
+static opt<std::string> PrefetchTrace(
+    "prefetch-trace",
+    desc("Record the parts of the file touched in this page access trace, so "
+         "that warmup reads exactly them. The trace is the JSON output of "
+         "PageAccessTracker"),
+    value_desc("filename"),
+    init(""),
+    cat(CompilerCategory));
+
+static opt<std::string> LayoutTraceBytecode(
+    "layout-trace-bytecode",
+    desc("The bytecode file traced for -layout-trace and -prefetch-trace. It "
+         "must have been compiled from the same source with the same flags"),
+    value_desc("filename"),
+    init(""),
+    cat(CompilerCategory));
+
+static opt<unsigned> CodegenThreads(
+    "j",
+    desc("Number of threads to use for code generation"),
+    value_desc("N"),
+    init(1),
+    cat(CompilerCategory));
+
+static opt<bool> CompactRegisters(
+    "compact-registers",
+    desc("Renumber the registers of each function after Mov elimination, so "
+         "that the registers it leaves unused don't take space in the frame"),
+    init(false),
+    cat(CompilerCategory));
+
+static opt<bool> BytecodePeephole(
+    "bytecode-peephole",
+    desc("Thread jumps to jumps, fold branches on constants, drop "
+         "redundant Movs and fuse environment accesses while emitting the "
+         "bytecode"),
+    init(false),
+    cat(CompilerCategory));
+
+static opt<bool> LiteralSlots(
+    "literal-slots",
+    desc("Read the properties of object literals from their slot in the "
+         "literal when the hidden class matches"),
+    init(false),
+    cat(CompilerCategory));
+
+static opt<bool> CompressBytecode(
+    "compress-bytecode",
+    desc("Emit the bytecode file in compressed form, whose function bodies "
+         "are expanded as they are first needed when it is run"),
+    init(false),
+    cat(CompilerCategory));
+
+static opt<std::string> CompileCache(
+    "compile-cache",
+    desc("Reuse the bytecode of an earlier compilation of the same files "
+         "with the same flags by the same compiler, found in this directory, "
+         "and store new ones there"),
+    value_desc("dir"),
+    init(""),
+    cat(CompilerCategory));
+
 } // namespace cl
 
 namespace {
@@ -718,30 +837,19 @@ SourceErrorOutputOptions guessErrorOutputOptions() {
   return result;
 }
 
-/// Parse the given files and return a single AST pointer.
-/// \p sourceMap any parsed source map associated with \p fileBuf.
-/// \p sourceMapTranslator input source map coordinate translator.
+/// Parse the buffer \p fileBufId of the SourceErrorManager of \p context.
 /// \return A pointer to the new validated AST, nullptr if parsing failed.
-/// If using CJS modules, return a FunctionExpressionNode, else a ProgramNode.
-ESTree::NodePtr parseJS(
+/// If \p wrapCJSModule, return a FunctionExpressionNode, else a ProgramNode.
+ESTree::NodePtr parseJSBuffer(
     std::shared_ptr<Context> &context,
     sem::SemContext &semCtx,
-    std::unique_ptr<llvm::MemoryBuffer> fileBuf,
-    std::unique_ptr<SourceMap> sourceMap = nullptr,
-    std::shared_ptr<SourceMapTranslator> sourceMapTranslator = nullptr,
-    bool wrapCJSModule = false) {
-  assert(fileBuf && "Need a file to compile");
+    uint32_t fileBufId,
+    bool wrapCJSModule) {
   assert(context && "Need a context to compile using");
   // This value will be set to true if the parser detected the 'use static
   // builtin' directive in the source.
   bool useStaticBuiltinDetected = false;
 
-  int fileBufId =
-      context->getSourceErrorManager().addNewSourceBuffer(std::move(fileBuf));
-  if (sourceMap != nullptr && sourceMapTranslator != nullptr) {
-    sourceMapTranslator->addSourceMap(fileBufId, std::move(sourceMap));
-  }
-
   auto mode = parser::FullParse;
 
   if (context->isLazyCompilation()) {
@@ -807,6 +915,29 @@ ESTree::NodePtr parseJS(
   return parsedAST;
 }
 
+/// Parse the given files and return a single AST pointer.
+/// \p sourceMap any parsed source map associated with \p fileBuf.
+/// \p sourceMapTranslator input source map coordinate translator.
+/// \return A pointer to the new validated AST, nullptr if parsing failed.
+/// If using CJS modules, return a FunctionExpressionNode, else a ProgramNode.
+ESTree::NodePtr parseJS(
+    std::shared_ptr<Context> &context,
+    sem::SemContext &semCtx,
+    std::unique_ptr<llvm::MemoryBuffer> fileBuf,
+    std::unique_ptr<SourceMap> sourceMap = nullptr,
+    std::shared_ptr<SourceMapTranslator> sourceMapTranslator = nullptr,
+    bool wrapCJSModule = false) {
+  assert(fileBuf && "Need a file to compile");
+  assert(context && "Need a context to compile using");
+
+  int fileBufId =
+      context->getSourceErrorManager().addNewSourceBuffer(std::move(fileBuf));
+  if (sourceMap != nullptr && sourceMapTranslator != nullptr) {
+    sourceMapTranslator->addSourceMap(fileBufId, std::move(sourceMap));
+  }
+  return parseJSBuffer(context, semCtx, fileBufId, wrapCJSModule);
+}
+
 /// Apply custom logic for flag initialization.
 void setFlagDefaults() {
   // We haven't been given any file names; just use "-", which acts as stdin.
@@ -852,6 +983,21 @@ bool validateFlags() {
         "Specify output file with -out filename.");
   }
 
+  // Validate global constants.
+  for (llvm::StringRef define : cl::Defines) {
+    if (define.find('=') == llvm::StringRef::npos ||
+        define.split('=').first.empty()) {
+      err("Error! -D expects name=value");
+    }
+  }
+
+  // Validate function layout flags.
+  bool hasTrace = !cl::LayoutTrace.empty() || !cl::PrefetchTrace.empty();
+  if (hasTrace == cl::LayoutTraceBytecode.empty()) {
+    err("Error! -layout-trace-bytecode must be used with -layout-trace or "
+        "-prefetch-trace");
+  }
+
   // Validate lazy compilation flags.
   if (cl::LazyCompilation) {
     if (cl::BytecodeFormat != cl::BytecodeFormatKind::HBC)
@@ -890,6 +1036,16 @@ bool validateFlags() {
       err("-output-source-map only works with -emit-binary");
   }
 
+  // Validate compile cache flags.
+  if (!cl::CompileCache.empty()) {
+    if (cl::DumpTarget != EmitBundle || cl::BytecodeOutputFilename.empty())
+      err("-compile-cache requires -emit-binary and -out");
+    if (cl::BytecodeMode)
+      err("-compile-cache doesn't make sense with bytecode");
+    if (cl::OutputSourceMap)
+      err("-compile-cache doesn't support -output-source-map");
+  }
+
   // Validate bytecode dumping flags.
   if (cl::BytecodeMode && cl::DumpTarget != None) {
     if (cl::BytecodeFormat != cl::BytecodeFormatKind::HBC)
@@ -901,16 +1057,22 @@ bool validateFlags() {
 }
 
 /// Create a Context, respecting the command line flags.
+/// \param entryCounts the function entry counts read from a profile.
 /// \return the Context.
 std::shared_ptr<Context> createContext(
     std::unique_ptr<Context::ResolutionTable> resolutionTable,
-    std::vector<Context::SegmentRange> segmentRanges) {
+    std::vector<Context::SegmentRange> segmentRanges,
+    FunctionEntryCounts entryCounts) {
   CodeGenerationSettings codeGenOpts;
   codeGenOpts.enableTDZ = cl::EnableTDZ;
   codeGenOpts.dumpOperandRegisters = cl::DumpOperandRegisters;
   codeGenOpts.dumpUseList = cl::DumpUseList;
   codeGenOpts.dumpSourceLocation = cl::DumpSourceLocation;
   codeGenOpts.dumpIRBetweenPasses = cl::DumpBetweenPasses;
+  for (llvm::StringRef define : cl::Defines) {
+    auto nameAndValue = define.split('=');
+    codeGenOpts.globalDefines[nameAndValue.first] = nameAndValue.second;
+  }
   if (cl::BytecodeFormat == cl::BytecodeFormatKind::HBC) {
     codeGenOpts.unlimitedRegisters = false;
   }
@@ -938,12 +1100,15 @@ std::shared_ptr<Context> createContext(
   optimizationOpts.outliningSettings.maxParameters = cl::OutliningMaxParameters;
 
   optimizationOpts.reusePropCache = cl::ReusePropCache;
+  optimizationOpts.flattenEnvironments =
+      cl::OptimizationLevel != cl::OptLevel::O0 && cl::FlattenEnvironments;
 
   // When the setting is auto-detect, we will set the correct value after
   // parsing.
   optimizationOpts.staticBuiltins =
       cl::StaticBuiltins == cl::StaticBuiltinSetting::ForceOn;
   optimizationOpts.staticRequire = cl::StaticRequire;
+  optimizationOpts.functionEntryCounts = std::move(entryCounts);
 
   auto context = std::make_shared<Context>(
       codeGenOpts,
@@ -999,6 +1164,72 @@ std::shared_ptr<Context> createContext(
   return root.getValue();
 }
 
+/// Read the number of calls to each function from the basic block profile
+/// in \p path into \p entryCounts. Functions are identified by their location
+/// in the source, which is only recorded if the profiled bytecode had debug
+/// info. Functions profiled in a different source than the one hashing to
+/// \p sourceHash are skipped, as their locations may not match anymore;
+/// profiles older than version 3 don't record the source hash, and are
+/// trusted to match. All error messages are printed to stderr.
+/// \return true on success.
+bool readFunctionEntryCounts(
+    llvm::StringRef path,
+    const SHA1 &sourceHash,
+    FunctionEntryCounts &entryCounts) {
+  using namespace ::hermes::parser;
+  auto file = memoryBufferFromFile(path);
+  if (!file)
+    return false;
+  JSLexer::Allocator alloc;
+  auto *root = llvm::dyn_cast_or_null<JSONObject>(parseJSONFile(file, alloc));
+  auto *functions = root
+      ? llvm::dyn_cast_or_null<JSONArray>(root->get("functions"))
+      : nullptr;
+  auto *version = root
+      ? llvm::dyn_cast_or_null<JSONNumber>(root->get("version"))
+      : nullptr;
+  if (!functions || !version ||
+      version->getValue() < kMinBasicBlockProfileVersion ||
+      version->getValue() > kBasicBlockProfileVersion) {
+    llvm::errs() << "Error! Invalid profile: " << path << '\n';
+    return false;
+  }
+  std::string expectedHash = hashAsString(sourceHash);
+  unsigned numStale = 0;
+  for (auto *val : *functions) {
+    auto *function = llvm::dyn_cast<JSONObject>(val);
+    if (!function)
+      continue;
+    auto *hash =
+        llvm::dyn_cast_or_null<JSONString>(function->get("source_hash"));
+    if (hash && hash->str() != expectedHash) {
+      ++numStale;
+      continue;
+    }
+    auto *line = llvm::dyn_cast_or_null<JSONNumber>(function->get("line"));
+    auto *column = llvm::dyn_cast_or_null<JSONNumber>(function->get("column"));
+    auto *blocks =
+        llvm::dyn_cast_or_null<JSONArray>(function->get("basic_blocks"));
+    if (!line || !column || !blocks || blocks->size() == 0)
+      continue;
+    // The entry block has the highest profile index.
+    auto *entry = llvm::dyn_cast<JSONObject>(blocks->at(blocks->size() - 1));
+    auto *count = entry ? llvm::dyn_cast_or_null<JSONNumber>(
+                              entry->get("execution_count"))
+                        : nullptr;
+    if (!count)
+      continue;
+    entryCounts[{(unsigned)line->getValue(), (unsigned)column->getValue()}] +=
+        (uint64_t)count->getValue();
+  }
+  if (numStale) {
+    llvm::errs() << "Warning: ignoring " << numStale
+                 << " functions of the profile " << path
+                 << " which were profiled with a different source\n";
+  }
+  return true;
+}
+
 /// Given the root path to the directory or zip file, the file name, and
 /// a zip struct that represents the zip file if it's a zip, return
 /// the memory buffer of the file content.
@@ -1136,6 +1367,258 @@ std::unique_ptr<hbc::BCProviderFromBuffer> loadBaseBytecodeProvider(
   return std::move(ret.first);
 }
 
+/// A page access trace, together with the bytecode file that was traced.
+struct PageAccessTrace {
+  /// The range of a function body in the traced file.
+  struct Body {
+    uint64_t start;
+    uint64_t end;
+    uint32_t functionID;
+  };
+
+  /// The IDs of the touched pages, in the order they were first touched.
+  std::vector<uint64_t> pageIds;
+  uint64_t pageSize;
+  /// The number of functions in the traced file.
+  uint32_t functionCount;
+  /// The non-empty function bodies of the traced file, sorted by start.
+  std::vector<Body> bodies;
+
+  /// Call \p callback with the ID of each function whose body overlaps
+  /// [start, end), in the order of the bodies.
+  template <typename F>
+  void forEachBodyIn(uint64_t start, uint64_t end, F callback) const {
+    auto it = std::partition_point(
+        bodies.begin(), bodies.end(), [start](const Body &body) {
+          return body.end <= start;
+        });
+    for (; it != bodies.end() && it->start < end; ++it)
+      callback(it->functionID);
+  }
+};
+
+/// Read a page access trace.
+/// \param tracePath the page access trace, as printed in JSON by
+///   PageAccessTracker.
+/// \param bytecodePath the bytecode file that was traced.
+/// \param sourceHash the hash of the source being compiled, which must be the
+///   source of the traced bytecode.
+/// \param[out] trace the trace.
+/// \return true on success. All error messages are printed to stderr.
+bool readPageAccessTrace(
+    llvm::StringRef tracePath,
+    llvm::StringRef bytecodePath,
+    const SHA1 &sourceHash,
+    PageAccessTrace &trace) {
+  using namespace ::hermes::parser;
+  auto file = memoryBufferFromFile(tracePath);
+  if (!file)
+    return false;
+  JSLexer::Allocator alloc;
+  auto *root = llvm::dyn_cast_or_null<JSONObject>(parseJSONFile(file, alloc));
+  auto *pageIds = root
+      ? llvm::dyn_cast_or_null<JSONArray>(root->get("page_ids"))
+      : nullptr;
+  if (!pageIds) {
+    llvm::errs() << "Error! Invalid page access trace: " << tracePath << '\n';
+    return false;
+  }
+  trace.pageSize = oscompat::page_size();
+  if (auto *size = llvm::dyn_cast_or_null<JSONNumber>(root->get("page_size")))
+    trace.pageSize = (uint64_t)size->getValue();
+  for (auto *val : *pageIds) {
+    if (auto *pageId = llvm::dyn_cast<JSONNumber>(val))
+      trace.pageIds.push_back((uint64_t)pageId->getValue());
+  }
+
+  auto bcProvider =
+      loadBaseBytecodeProvider(memoryBufferFromFile(bytecodePath));
+  if (!bcProvider)
+    return false;
+  if (bcProvider->getSourceHash() != sourceHash) {
+    llvm::errs() << "Error! " << bytecodePath
+                 << " was not compiled from the same source\n";
+    return false;
+  }
+
+  trace.functionCount = bcProvider->getFunctionCount();
+  for (uint32_t id = 0; id < trace.functionCount; ++id) {
+    auto header = bcProvider->getFunctionHeader(id);
+    if (header.bytecodeSizeInBytes() == 0)
+      continue;
+    trace.bodies.push_back(
+        {header.offset(), header.offset() + header.bytecodeSizeInBytes(), id});
+  }
+  // Bodies don't overlap, except for deduplicated ones which are identical, so
+  // this also sorts them by end.
+  std::sort(
+      trace.bodies.begin(),
+      trace.bodies.end(),
+      [](const PageAccessTrace::Body &a, const PageAccessTrace::Body &b) {
+        return a.start < b.start;
+      });
+  return true;
+}
+
+/// Compute the order of function bodies which makes the functions touched
+/// during a traced run contiguous, in the order they were first touched.
+/// \param tracePath the page access trace, as printed in JSON by
+///   PageAccessTracker.
+/// \param bytecodePath the bytecode file that was traced.
+/// \param sourceHash the hash of the source being compiled, which must be the
+///   source of the traced bytecode.
+/// \param[out] order the IDs of the touched functions.
+/// \return true on success. All error messages are printed to stderr.
+bool readFunctionLayoutOrder(
+    llvm::StringRef tracePath,
+    llvm::StringRef bytecodePath,
+    const SHA1 &sourceHash,
+    std::vector<uint32_t> &order) {
+  PageAccessTrace trace;
+  if (!readPageAccessTrace(tracePath, bytecodePath, sourceHash, trace))
+    return false;
+
+  llvm::BitVector placed(trace.functionCount);
+  for (uint64_t pageId : trace.pageIds) {
+    uint64_t pageStart = pageId * trace.pageSize;
+    trace.forEachBodyIn(
+        pageStart, pageStart + trace.pageSize, [&](uint32_t functionID) {
+          if (!placed.test(functionID)) {
+            placed.set(functionID);
+            order.push_back(functionID);
+          }
+        });
+  }
+  return true;
+}
+
+/// Compute the parts of the file read during a traced run, in the order they
+/// were first touched. Function bodies are named by function, since they may
+/// be laid out differently in the file being compiled; everything before them
+/// keeps its offset.
+/// \param tracePath the page access trace, as printed in JSON by
+///   PageAccessTracker.
+/// \param bytecodePath the bytecode file that was traced.
+/// \param sourceHash the hash of the source being compiled, which must be the
+///   source of the traced bytecode.
+/// \param[out] reads the parts of the file that were read.
+/// \return true on success. All error messages are printed to stderr.
+bool readStartupReads(
+    llvm::StringRef tracePath,
+    llvm::StringRef bytecodePath,
+    const SHA1 &sourceHash,
+    std::vector<StartupRead> &reads) {
+  PageAccessTrace trace;
+  if (!readPageAccessTrace(tracePath, bytecodePath, sourceHash, trace))
+    return false;
+
+  uint64_t bodiesStart = trace.bodies.empty() ? 0 : trace.bodies.front().start;
+  llvm::BitVector placed(trace.functionCount);
+  for (uint64_t pageId : trace.pageIds) {
+    uint64_t pageStart = pageId * trace.pageSize;
+    uint64_t pageEnd = pageStart + trace.pageSize;
+    if (pageStart < bodiesStart) {
+      uint32_t length = std::min(pageEnd, bodiesStart) - pageStart;
+      // Extend the previous range if the run went on reading sequentially.
+      if (!reads.empty() && reads.back().length &&
+          reads.back().offset + reads.back().length == pageStart) {
+        reads.back().length += length;
+      } else {
+        reads.push_back({0, (uint32_t)pageStart, length});
+      }
+    }
+    trace.forEachBodyIn(pageStart, pageEnd, [&](uint32_t functionID) {
+      if (!placed.test(functionID)) {
+        placed.set(functionID);
+        reads.push_back({functionID, 0, 0});
+      }
+    });
+  }
+  return true;
+}
+
+/// Find the entry of the compile cache for the compilation requested by
+/// \p commandLine. It is named after a hash of the compiler executable, the
+/// flags, and the contents of every file they name which can affect the
+/// output. The output file name is left out, so that the same sources can be
+/// compiled to several places.
+/// \param commandLine the arguments of the compiler, starting with its name.
+/// \return the path of the entry, or an empty string if the compilation
+/// can't be cached, e.g. because it reads stdin or a directory.
+std::string getCompileCacheEntry(llvm::ArrayRef<const char *> commandLine) {
+  llvm::SHA1 hasher;
+  auto addString = [&hasher](llvm::StringRef str) {
+    hasher.update(str);
+    hasher.update(llvm::StringRef("", 1));
+  };
+  auto addFile = [&addString](llvm::StringRef path) {
+    if (!llvm::sys::fs::is_regular_file(path))
+      return false;
+    auto buf = memoryBufferFromFile(path, false, /* silent */ true);
+    if (!buf)
+      return false;
+    addString(buf->getBuffer());
+    return true;
+  };
+
+  // A rebuilt compiler may generate different bytecode for the same flags.
+  std::string exe = llvm::sys::fs::getMainExecutable(
+      commandLine[0], reinterpret_cast<void *>(&getCompileCacheEntry));
+  if (exe.empty() || !addFile(exe))
+    return "";
+
+  llvm::StringRef out = cl::BytecodeOutputFilename;
+  for (llvm::StringRef arg : commandLine.drop_front()) {
+    if (arg == out || arg.endswith(("=" + out).str()))
+      continue;
+    addString(arg);
+  }
+
+  for (const std::string &filename : cl::InputFilenames) {
+    if (!addFile(filename))
+      return "";
+  }
+  for (const std::string &filename : cl::IncludeGlobals) {
+    if (!addFile(filename))
+      return "";
+  }
+  for (llvm::StringRef filename :
+       {cl::InputSourceMap.getValue(),
+        cl::BaseBytecodeFile.getValue(),
+        cl::ProfileUse.getValue(),
+        cl::LayoutTrace.getValue(),
+        cl::PrefetchTrace.getValue(),
+        cl::LayoutTraceBytecode.getValue()}) {
+    if (!filename.empty() && !addFile(filename))
+      return "";
+  }
+
+  llvm::SmallString<128> path{cl::CompileCache.getValue()};
+  llvm::sys::path::append(path, llvm::toHex(hasher.final()) + ".hbc");
+  return path.str();
+}
+
+/// Copy the bytecode in \p outputPath to the compile cache entry \p entry.
+/// The copy is renamed into place once complete, so that concurrent
+/// compilations never see a partial entry. Failures only print a warning.
+void addToCompileCache(llvm::StringRef outputPath, llvm::StringRef entry) {
+  llvm::SmallString<128> tempPath;
+  std::error_code EC =
+      llvm::sys::fs::create_directories(llvm::sys::path::parent_path(entry));
+  if (!EC)
+    EC = llvm::sys::fs::createUniqueFile(entry + "-%%%%%%%%", tempPath);
+  if (!EC)
+    EC = llvm::sys::fs::copy_file(outputPath, tempPath);
+  if (!EC)
+    EC = llvm::sys::fs::rename(tempPath, entry);
+  if (EC) {
+    llvm::errs() << "Warning: failed to add " << entry
+                 << " to the compile cache: " << EC.message() << '\n';
+    if (!tempPath.empty())
+      llvm::sys::fs::remove(tempPath);
+  }
+}
+
 /// Read the base bytecode provider map from either a directory or a zip file.
 /// This is used when commonjs is used and we need to optimize for delta
 /// bytecode updates. A metadata.hbc.json file is expected to exist in the
@@ -1297,6 +1780,154 @@ std::unique_ptr<Context::ResolutionTable> readResolutionTable(
   return result;
 }
 
+/// The result of parsing a CJS module on a thread of its own.
+struct ParsedModule {
+  /// The validated AST, with labels from the string table of the Context of
+  /// the thread. Null if parsing failed or reported any message, in which
+  /// case the module is parsed again to report the messages in order.
+  ESTree::FunctionExpressionNode *ast{nullptr};
+
+  /// Whether the 'use static builtin' directive was detected.
+  bool useStaticBuiltin{false};
+
+  /// The URLs set by magic comments, if any.
+  llvm::StringRef sourceMappingUrl{};
+  llvm::StringRef sourceUrl{};
+};
+
+/// Parses and validates CJS modules on a number of threads, each with its own
+/// Context, so that they don't contend on allocators and string tables.
+/// Every thread holds on to the AST of one module until it is released, and
+/// parses the next module in a scope of its allocator, so at most one AST
+/// per thread is in memory at once.
+class ParallelModuleParser {
+ public:
+  /// Start parsing the modules in the buffers \p bufIds of \p mainContext
+  /// on \p numThreads threads.
+  ParallelModuleParser(
+      const std::vector<uint32_t> &bufIds,
+      Context &mainContext,
+      unsigned numThreads)
+      : results_(bufIds.size()),
+        parsed_(bufIds.size(), false),
+        released_(bufIds.size(), false) {
+    for (unsigned i = 0; i < numThreads; ++i) {
+      workers_.emplace_back(new Worker());
+      Worker &worker = *workers_.back();
+      worker.context = createContext(nullptr, {}, {});
+      auto &sm = worker.context->getSourceErrorManager();
+      // Messages are reported by parsing the module again on the main thread,
+      // so they are only counted here.
+      sm.setDiagHandler([](const llvm::SMDiagnostic &, void *) {});
+      sm.setErrorLimit(0);
+      threads_.emplace_back([this, &worker, bufIds, &mainContext] {
+        for (size_t i; (i = next_++) < results_.size();) {
+          AllocationScope scope(worker.context->getAllocator());
+          parseModule(
+              worker,
+              *mainContext.getSourceErrorManager().getSourceBuffer(bufIds[i]),
+              results_[i]);
+          std::unique_lock<std::mutex> lk(mtx_);
+          parsed_[i] = true;
+          cv_.notify_all();
+          cv_.wait(lk, [this, i] { return released_[i] || stopping_; });
+          if (stopping_)
+            return;
+        }
+      });
+    }
+  }
+
+  /// Stop parsing and free all the ASTs.
+  ~ParallelModuleParser() {
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto &thread : threads_)
+      thread.join();
+    for (auto &worker : workers_)
+      ASTPeakBytes += worker->context->getAllocator().getPeakBytes();
+  }
+
+  /// Wait for module \p i to be parsed. Modules must be waited for in order.
+  /// \return the result, which is valid until release(i) is called.
+  const ParsedModule &get(size_t i) {
+    std::unique_lock<std::mutex> lk(mtx_);
+    cv_.wait(lk, [this, i] { return parsed_[i]; });
+    return results_[i];
+  }
+
+  /// Free the AST of module \p i, and let its thread parse another module.
+  void release(size_t i) {
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      released_[i] = true;
+      results_[i].ast = nullptr;
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  struct Worker {
+    std::shared_ptr<Context> context;
+    sem::SemContext semCtx;
+  };
+
+  /// Parse \p buf, which is owned by the main Context, into \p result.
+  static void parseModule(
+      Worker &worker,
+      const llvm::MemoryBuffer &buf,
+      ParsedModule &result) {
+    auto &sm = worker.context->getSourceErrorManager();
+    unsigned messages = sm.getErrorCount() + sm.getWarningCount();
+    // Locations point into buf, so they are valid in the main Context.
+    uint32_t bufId = sm.addNewSourceBuffer(llvm::MemoryBuffer::getMemBuffer(
+        buf.getBuffer(), buf.getBufferIdentifier(), false));
+    auto *ast = parseJSBuffer(
+        worker.context, worker.semCtx, bufId, /* wrapCJSModule */ true);
+    if (!ast || sm.getErrorCount() + sm.getWarningCount() != messages)
+      return;
+    result.ast = cast<ESTree::FunctionExpressionNode>(ast);
+    result.useStaticBuiltin =
+        worker.context->getOptimizationSettings().staticBuiltins;
+    result.sourceMappingUrl = sm.getSourceMappingUrl(bufId);
+    if (sm.getSourceUrl(bufId) != sm.getOriginalBufferIdentifier(bufId))
+      result.sourceUrl = sm.getSourceUrl(bufId);
+  }
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  /// The index of the next module to parse.
+  std::atomic<size_t> next_{0};
+  std::vector<ParsedModule> results_;
+
+  /// Guards parsed_, released_ and stopping_.
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::vector<bool> parsed_;
+  std::vector<bool> released_;
+  bool stopping_{false};
+};
+
+/// \return the number of threads to parse \p numModules CJS modules on, or
+/// 0 to parse them on the main thread.
+unsigned parseThreadsForModules(size_t numModules) {
+  // The ASTs are dumped as they are parsed, so they must be parsed in order.
+  if (cl::DumpTarget == DumpAST || cl::DumpTarget == DumpTransformedAST)
+    return 0;
+#ifdef HERMES_USE_FLOWPARSER
+  if (cl::FlowParser)
+    return 0;
+#endif
+  unsigned numThreads = cl::ParseThreads;
+  if (numThreads == 0)
+    numThreads = std::thread::hardware_concurrency();
+  numThreads = std::min<size_t>(numThreads, numModules);
+  return numThreads > 1 ? numThreads : 0;
+}
+
 /// Generate IR for CJS modules into the Module \p M for the source files in
 /// \p fileBufs. Treat the first element in fileBufs as the entry point.
 /// \param inputSourceMaps the parsed versions of the input source maps,
@@ -1331,44 +1962,76 @@ bool generateIRForSourcesAsCJSModules(
   inputSourceMaps.push_back(nullptr);
   std::vector<std::string> sources{"<global>"};
 
-  Function *topLevelFunction = M.getTopLevelFunction();
+  // Parsing the modules is independent, so it is done ahead of IR generation,
+  // on as many threads as there are cores. IR is generated from them in
+  // order, and each AST is freed as soon as its IR is generated.
+  std::vector<ModuleInSegment *> modules;
+  std::vector<uint32_t> bufIds;
   for (auto &entry : fileBufs) {
     for (ModuleInSegment &moduleInSegment : entry.second) {
-      auto &fileBuf = moduleInSegment.file;
-      llvm::SmallString<64> filename{fileBuf->getBufferIdentifier()};
-      if (sourceMapGen) {
-        sources.push_back(fileBuf->getBufferIdentifier());
-      }
-      llvm::sys::path::replace_path_prefix(
-          filename, rootPath, "./", llvm::sys::path::Style::posix);
+      modules.push_back(&moduleInSegment);
+      bufIds.push_back(context->getSourceErrorManager().addNewSourceBuffer(
+          std::move(moduleInSegment.file)));
+    }
+  }
+  std::unique_ptr<ParallelModuleParser> parsed;
+  if (unsigned numThreads = parseThreadsForModules(modules.size())) {
+    parsed =
+        llvm::make_unique<ParallelModuleParser>(bufIds, *context, numThreads);
+  }
+
+  Function *topLevelFunction = M.getTopLevelFunction();
+  auto &sm = context->getSourceErrorManager();
+  for (size_t i = 0, e = modules.size(); i < e; ++i) {
+    ModuleInSegment &moduleInSegment = *modules[i];
+    const llvm::MemoryBuffer *fileBuf = sm.getSourceBuffer(bufIds[i]);
+    llvm::SmallString<64> filename{fileBuf->getBufferIdentifier()};
+    if (sourceMapGen) {
+      sources.push_back(fileBuf->getBufferIdentifier());
+    }
+    llvm::sys::path::replace_path_prefix(
+        filename, rootPath, "./", llvm::sys::path::Style::posix);
+    // The AST of the module is not needed after its IR is generated. Lazily
+    // compiled functions are parsed again from the source.
+    AllocationScope moduleScope(context->getAllocator());
+    ESTree::FunctionExpressionNode *ast = nullptr;
+    const ParsedModule *module = parsed ? &parsed->get(i) : nullptr;
+    if (module && module->ast) {
+      ast = module->ast;
+      ESTree::reinternLabels(ast, context->getStringTable());
+      if (cl::StaticBuiltins == cl::StaticBuiltinSetting::AutoDetect)
+        context->setStaticBuiltinOptimization(module->useStaticBuiltin);
+      if (!module->sourceMappingUrl.empty())
+        sm.setSourceMappingUrl(bufIds[i], module->sourceMappingUrl);
+      if (!module->sourceUrl.empty())
+        sm.setSourceUrl(bufIds[i], module->sourceUrl);
+    } else {
       // TODO: use sourceMapTranslator for CJS module.
-      auto *ast = parseJS(
-          context,
-          semCtx,
-          std::move(fileBuf),
-          /*sourceMap*/ nullptr,
-          /*sourceMapTranslator*/ nullptr,
-          /*wrapCJSModule*/ true);
-      if (!ast) {
+      auto *node = parseJSBuffer(
+          context, semCtx, bufIds[i], /*wrapCJSModule*/ true);
+      if (!node) {
         return false;
       }
-      generateIRForCJSModule(
-          cast<ESTree::FunctionExpressionNode>(ast),
-          moduleInSegment.id,
-          llvm::sys::path::remove_leading_dotslash(filename),
-          &M,
-          topLevelFunction,
-          declFileList);
-      if (moduleInSegment.sourceMap) {
-        auto inputMap = SourceMapParser::parse(*moduleInSegment.sourceMap);
-        if (!inputMap) {
-          // parse() returns nullptr on failure and reports its own errors.
-          return false;
-        }
-        inputSourceMaps.push_back(std::move(inputMap));
-      } else {
-        inputSourceMaps.push_back(nullptr);
+      ast = cast<ESTree::FunctionExpressionNode>(node);
+    }
+    generateIRForCJSModule(
+        ast,
+        moduleInSegment.id,
+        llvm::sys::path::remove_leading_dotslash(filename),
+        &M,
+        topLevelFunction,
+        declFileList);
+    if (parsed)
+      parsed->release(i);
+    if (moduleInSegment.sourceMap) {
+      auto inputMap = SourceMapParser::parse(*moduleInSegment.sourceMap);
+      if (!inputMap) {
+        // parse() returns nullptr on failure and reports its own errors.
+        return false;
       }
+      inputSourceMaps.push_back(std::move(inputMap));
+    } else {
+      inputSourceMaps.push_back(nullptr);
     }
   }
 
@@ -1456,8 +2119,11 @@ CompileResult generateBytecodeForExecution(
     // Lazy compilation requires that the context stay alive.
     if (context->isLazyCompilation())
       result.context = context;
-    result.bytecodeProvider = hbc::BCProviderFromSrc::createBCProviderFromSrc(
+    auto provider = hbc::BCProviderFromSrc::createBCProviderFromSrc(
         hbc::generateBytecodeModule(&M, M.getTopLevelFunction(), genOptions));
+    if (context->isLazyCompilation() && !cl::LazyCacheDir.empty())
+      provider->getLazyFunctionCache().setDiskCacheDir(cl::LazyCacheDir);
+    result.bytecodeProvider = std::move(provider);
 
   } else {
     llvm_unreachable("Invalid bytecode kind for execution");
@@ -1507,16 +2173,9 @@ CompileResult generateBytecodeForSerialization(
   return Success;
 }
 
-/// Compiles the given files \p fileBufs with the context \p context,
-/// respecting the command line flags.
-/// \return a CompileResult containing the compilation status and artifacts.
-CompileResult processSourceFiles(
-    std::shared_ptr<Context> context,
-    SegmentTable fileBufs) {
-  assert(!fileBufs.empty() && "Need at least one file to compile");
-  assert(context && "Need a context to compile using");
-  assert(!cl::BytecodeMode && "Input files must not be bytecode");
-
+/// \return the hash of the sources in \p fileBufs, which is stored in the
+/// bytecode compiled from them.
+SHA1 hashSourceFiles(const SegmentTable &fileBufs) {
   llvm::SHA1 hasher;
   for (const auto &entry : fileBufs) {
     for (const auto &fileAndMap : entry.second) {
@@ -1530,6 +2189,20 @@ CompileResult processSourceFiles(
   assert(
       rawFinalHash.size() == SHA1_NUM_BYTES && "Incorrect length of SHA1 hash");
   std::copy(rawFinalHash.begin(), rawFinalHash.end(), sourceHash.begin());
+  return sourceHash;
+}
+
+/// Compiles the given files \p fileBufs with the context \p context,
+/// respecting the command line flags.
+/// \return a CompileResult containing the compilation status and artifacts.
+CompileResult processSourceFiles(
+    std::shared_ptr<Context> context,
+    SegmentTable fileBufs) {
+  assert(!fileBufs.empty() && "Need at least one file to compile");
+  assert(context && "Need a context to compile using");
+  assert(!cl::BytecodeMode && "Input files must not be bytecode");
+
+  SHA1 sourceHash = hashSourceFiles(fileBufs);
 #ifndef NDEBUG
   if (cl::LexerOnly) {
     unsigned count = 0;
@@ -1617,6 +2290,8 @@ CompileResult processSourceFiles(
     auto sourceMapTranslator =
         std::make_shared<SourceMapTranslator>(context->getSourceErrorManager());
     context->getSourceErrorManager().setTranslator(sourceMapTranslator);
+    // Free the AST before the IR is optimized.
+    AllocationScope astScope(context->getAllocator());
     ESTree::NodePtr ast = parseJS(
         context,
         semCtx,
@@ -1628,6 +2303,7 @@ CompileResult processSourceFiles(
     }
     generateIRFromESTree(ast, &M, declFileList, {});
   }
+  ASTPeakBytes += context->getAllocator().getPeakBytes();
 
   // Bail out if there were any errors. We can't ensure that the module is in
   // a valid state.
@@ -1689,6 +2365,11 @@ CompileResult processSourceFiles(
   // options parsing and js parsing. Set the bytecode header flag here.
   genOptions.staticBuiltinsEnabled = context->getStaticBuiltinOptimization();
   genOptions.padFunctionBodiesPercent = cl::PadFunctionBodiesPercent;
+  genOptions.numCodegenThreads = cl::CodegenThreads;
+  genOptions.compactRegisters = cl::CompactRegisters;
+  genOptions.bytecodePeephole = cl::BytecodePeephole;
+  genOptions.literalSlots = cl::LiteralSlots;
+  genOptions.compressBytecode = cl::CompressBytecode;
 
   // If the user requests to output a source map, then do not also emit debug
   // info into the bytecode.
@@ -1713,6 +2394,34 @@ CompileResult processSourceFiles(
     }
   }
 
+  if (!cl::LayoutTrace.empty()) {
+    if (context->getSegmentRanges().size() >= 2) {
+      llvm::errs() << "Error! -layout-trace doesn't support segments\n";
+      return InvalidFlags;
+    }
+    if (!readFunctionLayoutOrder(
+            cl::LayoutTrace,
+            cl::LayoutTraceBytecode,
+            sourceHash,
+            genOptions.functionLayoutOrder)) {
+      return InputFileError;
+    }
+  }
+
+  if (!cl::PrefetchTrace.empty()) {
+    if (context->getSegmentRanges().size() >= 2) {
+      llvm::errs() << "Error! -prefetch-trace doesn't support segments\n";
+      return InvalidFlags;
+    }
+    if (!readStartupReads(
+            cl::PrefetchTrace,
+            cl::LayoutTraceBytecode,
+            sourceHash,
+            genOptions.startupReads)) {
+      return InputFileError;
+    }
+  }
+
   CompileResult result{Success};
   StringRef base = cl::BytecodeOutputFilename;
   if (context->getSegmentRanges().size() < 2) {
@@ -1836,7 +2545,8 @@ void printHermesREPLVersion(llvm::raw_ostream &s) {
   printHermesVersion(s, " REPL", false);
 }
 
-CompileResult compileFromCommandLineOptions() {
+CompileResult compileFromCommandLineOptions(
+    llvm::ArrayRef<const char *> commandLine) {
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_STATS)
   if (cl::PrintStats)
     hermes::EnableStatistics();
@@ -1847,6 +2557,20 @@ CompileResult compileFromCommandLineOptions() {
   if (!validateFlags())
     return InvalidFlags;
 
+  // Reuse the output of an identical earlier compilation if there is one.
+  std::string cacheEntry;
+  if (!cl::CompileCache.empty()) {
+    if (commandLine.empty()) {
+      llvm::errs() << "Error! -compile-cache is not supported by this tool\n";
+      return InvalidFlags;
+    }
+    cacheEntry = getCompileCacheEntry(commandLine);
+    if (!cacheEntry.empty() &&
+        !llvm::sys::fs::copy_file(cacheEntry, cl::BytecodeOutputFilename)) {
+      return Success;
+    }
+  }
+
   // Load input files.
   SegmentTable fileBufs{};
 
@@ -1915,9 +2639,22 @@ CompileResult compileFromCommandLineOptions() {
         "validateFlags() should enforce exactly one bytecode input file");
     return processBytecodeFile(std::move(fileBufs[0][0].file));
   } else {
-    std::shared_ptr<Context> context =
-        createContext(std::move(resolutionTable), std::move(segmentRanges));
-    return processSourceFiles(context, std::move(fileBufs));
+    FunctionEntryCounts entryCounts;
+    if (!cl::ProfileUse.empty() &&
+        !readFunctionEntryCounts(
+            cl::ProfileUse, hashSourceFiles(fileBufs), entryCounts)) {
+      return InputFileError;
+    }
+    std::shared_ptr<Context> context = createContext(
+        std::move(resolutionTable),
+        std::move(segmentRanges),
+        std::move(entryCounts));
+    bool singleSegment = context->getSegmentRanges().size() < 2;
+    CompileResult result = processSourceFiles(context, std::move(fileBufs));
+    // Only a single output file can be cached.
+    if (result.status == Success && singleSegment && !cacheEntry.empty())
+      addToCompileCache(cl::BytecodeOutputFilename, cacheEntry);
+    return result;
   }
 }
 } // namespace driver
@@ -9,6 +9,7 @@
 
 #include "hermes/CompilerDriver/CompilerDriver.h"
 #include "hermes/Support/MemoryBuffer.h"
+#include "hermes/Support/TraceEvents.h"
 #include "hermes/Support/UTF8.h"
 #include "hermes/VM/Callable.h"
 #include "hermes/VM/Domain.h"
@@ -250,6 +251,23 @@ void installConsoleBindings(
       loadSegment,
       reinterpret_cast<void *>(const_cast<std::string *>(filename)),
       2);
+
+  // Segments of modules required before loadSegment() was called are read
+  // from the same place.
+  if (filename) {
+    runtime->setSegmentLoader(
+        [baseFilename = *filename](
+            uint32_t segment) -> std::shared_ptr<hbc::BCProvider> {
+          auto fileBufRes = llvm::MemoryBuffer::getFile(
+              Twine(baseFilename) + "." + Twine(segment));
+          if (!fileBufRes)
+            return nullptr;
+          return hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+                     llvm::make_unique<OwnedMemoryBuffer>(
+                         std::move(*fileBufRes)))
+              .first;
+        });
+  }
 }
 
 // If a function body might throw C++ exceptions other than
@@ -308,7 +326,14 @@ bool executeHBCBytecodeImpl(
   }
 
   if (options.DeserializeFile != "") {
-    auto inputFileOrErr = llvm::MemoryBuffer::getFile(options.DeserializeFile);
+    // The Deserializer reads the file in place, and keeps referring to the
+    // bytecode and string literals in it, but never needs a null terminator.
+    // Not requiring one lets the file be mapped rather than copied even when
+    // its size happens to be a multiple of the page size.
+    auto inputFileOrErr = llvm::MemoryBuffer::getFile(
+        options.DeserializeFile,
+        /* FileSize */ -1,
+        /* RequiresNullTerminator */ false);
     if (!inputFileOrErr) {
       llvm::errs() << "Failed to read Deserialize file: "
                    << options.DeserializeFile << '\n';
@@ -345,6 +370,10 @@ bool executeHBCBytecodeImpl(
         runtime.get(), options.timeLimit);
   }
 
+  if (options.allocationSamplingInterval > 0) {
+    runtime->enableAllocationSampling(options.allocationSamplingInterval);
+  }
+
   if (shouldRecordGCStats) {
     statSampler = llvm::make_unique<vm::StatSamplingThread>(
         std::chrono::milliseconds(100));
@@ -377,7 +406,24 @@ bool executeHBCBytecodeImpl(
   }
 
   if (options.runtimeConfig.getEnableSampleProfiling()) {
-    vm::SamplingProfiler::getInstance()->enable();
+    if (options.sampleProfilingStreamNodes) {
+      vm::SamplingProfiler::getInstance()->enableStreaming(
+          options.sampleProfilingStreamNodes,
+          std::chrono::seconds(1),
+          [](const std::string &chunk) { llvm::errs() << chunk; });
+    } else {
+      vm::SamplingProfiler::getInstance()->enable();
+    }
+  }
+
+  if (options.functionProfiling || options.functionProfilingSummary) {
+    runtime->enableFunctionProfiling();
+  }
+
+  std::shared_ptr<trace::ChromeTraceSink> traceSink;
+  if (!options.traceEventsFile.empty()) {
+    traceSink = std::make_shared<trace::ChromeTraceSink>();
+    trace::setSink(traceSink, options.traceEventCategories);
   }
 
   llvm::StringRef sourceURL{};
@@ -389,10 +435,49 @@ bool executeHBCBytecodeImpl(
 
   if (options.runtimeConfig.getEnableSampleProfiling()) {
     auto profiler = vm::SamplingProfiler::getInstance();
-    profiler->dumpChromeTrace(llvm::errs());
+    if (options.sampleProfilingHistograms) {
+      profiler->dumpOpCodeAndBuiltinHistograms(llvm::errs());
+    }
+    if (!options.sampleProfilingStreamNodes) {
+      profiler->dumpChromeTrace(llvm::errs());
+    }
+    // Disabling flushes whatever has been streamed since the last chunk.
     profiler->disable();
   }
 
+  if (options.allocationSamplingInterval > 0) {
+    runtime->dumpSampledAllocations(llvm::errs());
+    llvm::errs() << "\n";
+    runtime->disableAllocationSampling();
+  }
+
+  if (options.dumpPropertyCacheStats) {
+    runtime->dumpPropertyCacheStats(llvm::errs());
+  }
+
+  if (options.functionProfiling || options.functionProfilingSummary) {
+    if (options.functionProfilingSummary) {
+      runtime->dumpFunctionProfileSummary(llvm::errs());
+    }
+    if (options.functionProfiling) {
+      runtime->dumpFunctionProfile(llvm::errs());
+    }
+    runtime->disableFunctionProfiling();
+  }
+
+  if (traceSink) {
+    trace::setSink(nullptr);
+    std::error_code EC;
+    llvm::raw_fd_ostream traceFile(
+        llvm::StringRef(options.traceEventsFile), EC);
+    if (EC) {
+      llvm::errs() << "Failed to open trace events file: "
+                   << options.traceEventsFile << "\n";
+    } else {
+      traceSink->serialize(traceFile);
+    }
+  }
+
   bool threwException = status == vm::ExecutionStatus::EXCEPTION;
 
   if (threwException) {
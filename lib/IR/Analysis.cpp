@@ -231,7 +231,9 @@ FunctionScopeAnalysis::calculateFunctionScopeData(Function *F) {
     Function *Parent = Inst->getParent()->getParent();
     ScopeData parentData = calculateFunctionScopeData(Parent);
     if (!parentData.orphaned) {
-      lexicalScopeMap_[F] = ScopeData(Parent, parentData.depth + 1);
+      // A function with a flattened environment shares its parent's.
+      lexicalScopeMap_[F] = ScopeData(
+          Parent, parentData.depth + (F->isEnvironmentFlattened() ? 0 : 1));
     } else {
       lexicalScopeMap_[F] = ScopeData::orphan();
     }
@@ -740,6 +740,17 @@ SwitchImmInst *IRBuilder::createSwitchImmInst(
   return inst;
 }
 
+SwitchHashInst *IRBuilder::createSwitchHashInst(
+    Value *input,
+    BasicBlock *defaultBlock,
+    LiteralNumber *numSlots,
+    const SwitchHashInst::ValueListType &values,
+    const SwitchHashInst::BasicBlockListType &blocks) {
+  auto inst = new SwitchHashInst(input, defaultBlock, numSlots, values, blocks);
+  insert(inst);
+  return inst;
+}
+
 DirectEvalInst *IRBuilder::createDirectEvalInst(Value *operand) {
   auto *inst = new DirectEvalInst(operand);
   insert(inst);
@@ -827,6 +838,15 @@ CallBuiltinInst *IRBuilder::createCallBuiltinInst(
   return inst;
 }
 
+StringConcatInst *IRBuilder::createStringConcatInst(
+    ArrayRef<Value *> operands) {
+  assert(!operands.empty() && "StringConcat needs at least one operand");
+  auto *inst = new StringConcatInst(
+      getLiteralUndefined(), operands.front(), operands.drop_front());
+  insert(inst);
+  return inst;
+}
+
 HBCCallDirectInst *IRBuilder::createHBCCallDirectInst(
     Function *callee,
     Value *thisValue,
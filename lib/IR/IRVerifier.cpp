@@ -13,6 +13,7 @@
 
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/MathExtras.h"
 
 using llvm::dyn_cast;
 using llvm::isa;
@@ -446,6 +447,15 @@ void Verifier::visitCallBuiltinInst(CallBuiltinInst const &Inst) {
       "CallBuiltin too many arguments");
   visitCallInst(Inst);
 }
+void Verifier::visitStringConcatInst(StringConcatInst const &Inst) {
+  Assert(
+      isa<LiteralUndefined>(Inst.getCallee()),
+      "StringConcat callee must be undefined");
+  Assert(
+      Inst.getNumArguments() <= StringConcatInst::MAX_OPERANDS,
+      "StringConcat too many operands");
+  visitCallInst(Inst);
+}
 void Verifier::visitHBCCallDirectInst(HBCCallDirectInst const &Inst) {
   Assert(
       isa<Function>(Inst.getCallee()),
@@ -702,6 +712,24 @@ void Verifier::visitSwitchImmInst(const hermes::SwitchImmInst &Inst) {
   }
 }
 
+void Verifier::visitSwitchHashInst(const hermes::SwitchHashInst &Inst) {
+  visitSwitchLikeInst(Inst);
+  Assert(
+      llvm::isPowerOf2_32(Inst.getNumSlots()),
+      "number of slots must be a power of 2");
+  bool strings = Inst.hasStringCases();
+  for (unsigned idx = 0, e = Inst.getNumCasePair(); idx < e; ++idx) {
+    auto *value = Inst.getCasePair(idx).first;
+    if (strings) {
+      Assert(isa<LiteralString>(value), "case values must all be strings");
+    } else {
+      auto *num = dyn_cast<LiteralNumber>(value);
+      Assert(
+          num && num->isInt32Representible(), "case value must be a int32");
+    }
+  }
+}
+
 void Verifier::visitCheckHasInstanceInst(const CheckHasInstanceInst &Inst) {
   Assert(isTerminator(&Inst), "CheckHasInstanceInst must be a terminator");
   Assert(
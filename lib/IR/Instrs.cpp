@@ -9,6 +9,7 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
 
 #include "hermes/IR/CFG.h"
 #include "hermes/IR/IR.h"
@@ -368,6 +369,48 @@ void SwitchImmInst::setSuccessor(unsigned idx, BasicBlock *B) {
   setOperand(B, FirstCaseIdx + (idx - 1) * 2 + 1);
 }
 
+SwitchHashInst::SwitchHashInst(
+    Value *input,
+    BasicBlock *defaultBlock,
+    LiteralNumber *numSlots,
+    const ValueListType &values,
+    const BasicBlockListType &blocks)
+    : TerminatorInst(ValueKind::SwitchHashInstKind) {
+  pushOperand(input);
+  pushOperand(defaultBlock);
+
+  assert(
+      numSlots->isUInt32Representible() &&
+      llvm::isPowerOf2_32(numSlots->asUInt32()) &&
+      "numSlots must be a power of 2");
+  pushOperand(numSlots);
+
+  assert(blocks.size() && "Empty switch statement (no cases?)");
+  assert(values.size() == blocks.size() && "Block-value pairs mismatch");
+
+  // Push the switch targets.
+  for (size_t i = 0, e = values.size(); i < e; ++i) {
+    pushOperand(values[i]);
+    pushOperand(blocks[i]);
+  }
+}
+
+BasicBlock *SwitchHashInst::getSuccessor(unsigned idx) const {
+  assert(idx < getNumSuccessors() && "getSuccessor out of bound!");
+  if (idx == 0)
+    return getDefaultDestination();
+  return getCasePair(idx - 1).second;
+}
+
+void SwitchHashInst::setSuccessor(unsigned idx, BasicBlock *B) {
+  assert(idx < getNumSuccessors() && "setSuccessor out of bound!");
+  if (idx == 0) {
+    setOperand(B, DefaultBlockIdx);
+    return;
+  }
+  setOperand(B, FirstCaseIdx + (idx - 1) * 2 + 1);
+}
+
 Instruction::Variety Instruction::getVariety() const {
   const ValueKind kind = getKind();
 
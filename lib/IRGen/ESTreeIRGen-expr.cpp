@@ -76,6 +76,8 @@ Value *ESTreeIRGen::genExpression(ESTree::Node *expr, Identifier nameHint) {
 
   // Handle MemberExpression expressions for access property.
   if (auto *Mem = dyn_cast<ESTree::MemberExpressionNode>(expr)) {
+    if (auto *define = genGlobalDefine(Mem))
+      return define;
     LReference lref = createLRef(Mem, false);
     return lref.emitLoad();
   }
@@ -1212,6 +1214,9 @@ Value *ESTreeIRGen::genIdentifierExpression(
   // Lookup variable name.
   auto StrName = getNameFieldFromID(Iden);
 
+  if (auto *define = genGlobalDefine(Iden))
+    return define;
+
   auto *Var = ensureVariableExists(Iden);
 
   // For uses of undefined as the global property, we make an optimization
@@ -1233,6 +1238,53 @@ Value *ESTreeIRGen::genIdentifierExpression(
   return emitLoad(Builder, Var, afterTypeOf);
 }
 
+Value *ESTreeIRGen::genGlobalDefine(ESTree::Node *expr) {
+  const auto &defines =
+      Mod->getContext().getCodeGenerationSettings().globalDefines;
+  if (defines.empty())
+    return nullptr;
+
+  // Collect the property names from the outermost member expression in.
+  llvm::SmallVector<StringRef, 4> props;
+  while (auto *Mem = dyn_cast<ESTree::MemberExpressionNode>(expr)) {
+    auto *prop = dyn_cast<ESTree::IdentifierNode>(Mem->_property);
+    if (Mem->_computed || !prop)
+      return nullptr;
+    props.push_back(prop->_name->str());
+    expr = Mem->_object;
+  }
+  auto *Iden = dyn_cast<ESTree::IdentifierNode>(expr);
+  if (!Iden)
+    return nullptr;
+
+  // A local variable shadows the global.
+  auto *Var = nameTable_.lookup(getNameFieldFromID(Iden));
+  if (Var && !isa<GlobalObjectProperty>(Var))
+    return nullptr;
+
+  std::string name = Iden->_name->str();
+  for (StringRef prop : llvm::reverse(props))
+    (name += '.') += prop;
+  auto it = defines.find(name);
+  if (it == defines.end())
+    return nullptr;
+
+  StringRef value = it->getValue();
+  double number;
+  if (value == "true" || value == "false")
+    return Builder.getLiteralBool(value == "true");
+  if (value == "null")
+    return Builder.getLiteralNull();
+  if (value == "undefined")
+    return Builder.getLiteralUndefined();
+  if (!value.getAsDouble(number))
+    return Builder.getLiteralNumber(number);
+  if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') &&
+      value.back() == value.front())
+    value = value.drop_front().drop_back();
+  return Builder.getLiteralString(value);
+}
+
 Value *ESTreeIRGen::genMetaProperty(ESTree::MetaPropertyNode *MP) {
   // Recognize "new.target"
   if (cast<ESTree::IdentifierNode>(MP->_meta)->_name->str() == "new") {
@@ -1373,10 +1425,11 @@ Value *ESTreeIRGen::genTemplateLiteralExpr(ESTree::TemplateLiteralNode *Expr) {
       Expr->_quasis.size() == Expr->_expressions.size() + 1 &&
       "The string count should always be one more than substitution count.");
 
-  // Construct an argument list for calling HermesInternal.concat():
-  // cookedStr0, substitution0, cookedStr1, ..., substitutionN, cookedStrN + 1,
-  // skipping any empty string, except for the first cooked string, which is
-  // going to be the `this` to the concat call.
+  // Construct the list of strings to concatenate after the first one:
+  // substitution0, cookedStr1, ..., substitutionN, cookedStrN + 1, skipping any
+  // empty string. The first cooked string is either the first operand of
+  // StringConcat or, with too many operands, the `this` of a call to
+  // HermesInternal.concat().
 
   // Get the first cooked string.
   auto strItr = Expr->_quasis.begin();
@@ -1411,6 +1464,15 @@ Value *ESTreeIRGen::genTemplateLiteralExpr(ESTree::TemplateLiteralNode *Expr) {
     return Builder.createAddEmptyStringInst(argList[0]);
   }
 
+  // Concatenate the opening string, unless it is empty, and the arguments,
+  // which StringConcat converts to strings like HermesInternal.concat() would.
+  bool hasOpening = !firstCookedStr->getValue().str().empty();
+  if (argList.size() + hasOpening <= StringConcatInst::MAX_OPERANDS) {
+    if (hasOpening)
+      argList.insert(argList.begin(), firstCookedStr);
+    return Builder.createStringConcatInst(argList);
+  }
+
   // Generate a function call to HermesInternal.concat() with these arguments.
   return genHermesInternalCall("concat", firstCookedStr, argList);
 }
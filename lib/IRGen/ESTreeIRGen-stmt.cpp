@@ -468,18 +468,27 @@ void ESTreeIRGen::genForOfStatement(ESTree::ForOfStatementNode *forOfStmt) {
 
   auto *exprValue = genExpression(forOfStmt->_right);
   auto iteratorRecord = emitGetIterator(exprValue);
+  // The iteratorStep() builtin returns this object once the iterator is done.
+  // It never escapes the loop, so no value of the iterator can be equal to it.
+  auto *doneMarker = Builder.createAllocObjectInst(0);
 
   Builder.createBranchInst(getNextBlock);
 
+  // Step the iterator and get the value in one builtin call, which doesn't
+  // need the iterator result objects of the builtin iterators.
   Builder.setInsertionBlock(getNextBlock);
-  auto *nextResult = emitIteratorNext(iteratorRecord);
-  auto *done = emitIteratorComplete(nextResult);
-  Builder.createCondBranchInst(done, exitBlock, bodyBlock);
+  auto *nextValue = genBuiltinCall(
+      BuiltinMethod::HermesBuiltin_iteratorStep,
+      {iteratorRecord.iterator, iteratorRecord.nextMethod, doneMarker});
+  Builder.createCompareBranchInst(
+      nextValue,
+      doneMarker,
+      BinaryOperatorInst::OpKind::StrictlyEqualKind,
+      exitBlock,
+      bodyBlock);
 
   Builder.setInsertionBlock(bodyBlock);
 
-  auto *nextValue = emitIteratorValue(nextResult);
-
   emitTryCatchScaffolding(
       getNextBlock,
       // emitBody.
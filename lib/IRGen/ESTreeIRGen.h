@@ -525,10 +525,15 @@ class ESTreeIRGen {
       ESTree::IdentifierNode *Iden,
       bool afterTypeOf);
 
+  /// \return the constant declared on the command line for the global read
+  /// by \p expr, which is an identifier or a chain of non-computed member
+  /// expressions on one, or nullptr if there is none.
+  Value *genGlobalDefine(ESTree::Node *expr);
+
   Value *genMetaProperty(ESTree::MetaPropertyNode *MP);
 
   /// Generate IR for a template literal expression, which in most cases is
-  /// translated to a call to HermesInternal.concat().
+  /// translated to a StringConcat instruction.
   Value *genTemplateLiteralExpr(ESTree::TemplateLiteralNode *Expr);
 
   /// Generate IR for a tagged template expression, which involves converting
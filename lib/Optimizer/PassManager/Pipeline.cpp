@@ -59,14 +59,27 @@ void hermes::runFullOptimizationPasses(Module &M) {
   PM.addMem2Reg();
   PM.addStackPromotion();
   PM.addInlining();
+  // Loop over arrays in place of calling forEach, map, filter and reduce with
+  // a function expression, which is inlined into the loop.
+  PM.addInlineArrayCallbacks();
   PM.addStackPromotion();
+  // Inlining exposes objects that are created and destructured in the same
+  // function. Their properties become stack allocations, which are promoted
+  // to registers before CSE, LoadElim and LICM look at them.
+  PM.addScalarReplacement();
+  PM.addMem2Reg();
   PM.addInstSimplify();
   PM.addDCE();
 
   // Run type inference before CSE so that we can better reason about binopt.
   PM.addTypeInference();
   PM.addCSE();
+  // Reuse the values of variables and literal properties loaded or stored
+  // earlier, which CSE can't do since memory may change in between.
+  PM.addLoadElim();
   PM.addTDZDedup();
+  // Move the loads and computations that CSE couldn't eliminate out of loops.
+  PM.addLICM();
   PM.addSimplifyCFG();
 
   PM.addInstSimplify();
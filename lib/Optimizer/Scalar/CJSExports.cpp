@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#define DEBUG_TYPE "cjsexports"
+
+#include "hermes/Optimizer/Scalar/CJSExports.h"
+#include "hermes/IR/CFG.h"
+#include "hermes/Optimizer/Scalar/Utils.h"
+
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/Debug.h"
+
+using namespace hermes;
+using llvm::dbgs;
+using llvm::isa;
+
+namespace {
+
+/// What is known about a CommonJS module.
+struct ModuleInfo {
+  /// The function of the module.
+  Function *function;
+  /// Whether the exports of the module are tracked. Cleared as soon as the
+  /// exports object may be reached by unknown code.
+  bool tracked;
+  /// The stores into the exports object, by property name.
+  llvm::MapVector<Identifier, llvm::SmallVector<StorePropertyInst *, 2>>
+      stores{};
+  /// The resolved require() calls of the module.
+  llvm::SmallVector<CallBuiltinInst *, 4> requireCalls{};
+  /// The indices of the modules required by the functions of this module.
+  llvm::SmallVector<unsigned, 4> deps{};
+
+  ModuleInfo(Function *function, bool tracked)
+      : function(function), tracked(tracked) {}
+};
+
+/// A use of a value: the user, and the value it uses, which is either the
+/// original value or a load of a variable only that value is stored into.
+using Use = std::pair<Value *, Instruction *>;
+
+/// Collect the uses of \p value into \p uses, looking through the variables
+/// that only \p value is ever stored into.
+void collectUses(Value *value, llvm::SmallVectorImpl<Use> &uses) {
+  llvm::SmallPtrSet<Variable *, 4> visited;
+  llvm::SmallVector<Value *, 4> copies{value};
+  while (!copies.empty()) {
+    Value *copy = copies.pop_back_val();
+    for (auto *U : copy->getUsers()) {
+      auto *SF = dyn_cast<StoreFrameInst>(U);
+      if (SF && SF->getValue() == copy &&
+          !SF->getVariable()->getParent()->isGlobalScope() &&
+          isStoreOnceVariable(SF->getVariable()) == copy) {
+        if (visited.insert(SF->getVariable()).second) {
+          for (auto *VU : SF->getVariable()->getUsers()) {
+            if (auto *LF = dyn_cast<LoadFrameInst>(VU))
+              copies.push_back(LF);
+          }
+        }
+        continue;
+      }
+      uses.emplace_back(copy, U);
+    }
+  }
+}
+
+/// \return the required module ID if \p I is a resolved require() call.
+llvm::Optional<uint32_t> getRequiredModule(Instruction *I) {
+  auto *call = dyn_cast<CallBuiltinInst>(I);
+  if (!call ||
+      call->getBuiltinIndex() != BuiltinMethod::HermesBuiltin_requireFast ||
+      call->getNumArguments() != 2)
+    return llvm::None;
+  auto *id = dyn_cast<LiteralNumber>(call->getArgument(1));
+  if (!id || !id->isUInt32Representible())
+    return llvm::None;
+  return id->asUInt32();
+}
+
+/// Stop tracking the modules which may be required while they are still
+/// being initialized, because they are part of a cycle of requires. Their
+/// exports object may be missing properties then.
+void untrackCycles(std::vector<ModuleInfo> &modules) {
+  // Remove the modules which don't require any remaining module until there
+  // are none, then the modules which no remaining module requires. The
+  // modules which remain are the ones in cycles and, conservatively, some of
+  // the ones between cycles.
+  unsigned numModules = modules.size();
+  std::vector<unsigned> numDeps(numModules), numRequirers(numModules);
+  std::vector<llvm::SmallVector<unsigned, 4>> requirers(numModules);
+  for (unsigned i = 0; i < numModules; ++i) {
+    numDeps[i] = modules[i].deps.size();
+    for (unsigned dep : modules[i].deps)
+      requirers[dep].push_back(i);
+  }
+
+  llvm::BitVector removed(numModules);
+  llvm::SmallVector<unsigned, 16> worklist;
+  for (unsigned i = 0; i < numModules; ++i) {
+    if (!numDeps[i])
+      worklist.push_back(i);
+  }
+  while (!worklist.empty()) {
+    unsigned i = worklist.pop_back_val();
+    removed.set(i);
+    for (unsigned requirer : requirers[i]) {
+      if (--numDeps[requirer] == 0)
+        worklist.push_back(requirer);
+    }
+  }
+
+  for (unsigned i = 0; i < numModules; ++i) {
+    if (removed.test(i))
+      continue;
+    for (unsigned dep : modules[i].deps) {
+      if (!removed.test(dep))
+        ++numRequirers[dep];
+    }
+  }
+  for (unsigned i = 0; i < numModules; ++i) {
+    if (!removed.test(i) && !numRequirers[i])
+      worklist.push_back(i);
+  }
+  while (!worklist.empty()) {
+    unsigned i = worklist.pop_back_val();
+    removed.set(i);
+    for (unsigned dep : modules[i].deps) {
+      if (!removed.test(dep) && --numRequirers[dep] == 0)
+        worklist.push_back(dep);
+    }
+  }
+
+  for (unsigned i = 0; i < numModules; ++i) {
+    if (!removed.test(i))
+      modules[i].tracked = false;
+  }
+}
+
+/// Collect the stores into the exports object of the module \p info.
+/// \return false if the exports object is used in any other way, or may be
+///   replaced through the module object.
+bool collectExportStores(ModuleInfo &info) {
+  Function *F = info.function;
+  auto &params = F->getParameters();
+  if (params.size() != 3 || params[2]->hasUsers())
+    return false;
+
+  // The exports object is also passed as "this".
+  Value *exports = params[0];
+  Value *thisParam = F->getThisParameter();
+  for (Value *param : {exports, thisParam}) {
+    if (!param)
+      continue;
+    for (auto *U : param->getUsers()) {
+      if (U->getKind() != ValueKind::StorePropertyInstKind)
+        return false;
+      auto *store = cast<StorePropertyInst>(U);
+      LiteralString *name = getLiteralPropertyName(store->getProperty());
+      if (store->getObject() != param || !name ||
+          store->getStoredValue() == exports ||
+          store->getStoredValue() == thisParam)
+        return false;
+      info.stores[name->getValue()].push_back(store);
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+CJSExports::CJSExports(Module *M) {
+  if (!M->getCJSModulesResolved())
+    return;
+
+  std::vector<ModuleInfo> modules;
+  llvm::DenseMap<uint32_t, unsigned> moduleIndices;
+  for (const auto &cjsModule : M->getCJSModules()) {
+    if (!cjsModule.function)
+      continue;
+    moduleIndices[cjsModule.id] = modules.size();
+    // The entry point returns its exports to the caller of the bundle.
+    modules.emplace_back(cjsModule.function, cjsModule.id != 0);
+  }
+
+  // The function creating each function, to find the module it belongs to.
+  llvm::DenseMap<Function *, Function *> creators;
+  for (auto &F : *M) {
+    for (auto &BB : F) {
+      for (auto &I : BB) {
+        if (auto *CFI = dyn_cast<CreateFunctionInst>(&I))
+          creators[CFI->getFunctionCode()] = &F;
+      }
+    }
+  }
+  auto getModuleIndex = [&](Function *F) -> llvm::Optional<unsigned> {
+    for (; F; F = creators.lookup(F)) {
+      if (auto *cjsModule = M->findCJSModule(F))
+        return moduleIndices[cjsModule->id];
+    }
+    return llvm::None;
+  };
+
+  for (auto &F : *M) {
+    for (auto &BB : F) {
+      for (auto &I : BB) {
+        auto id = getRequiredModule(&I);
+        if (!id)
+          continue;
+        auto it = moduleIndices.find(*id);
+        if (it == moduleIndices.end())
+          continue;
+        ModuleInfo &required = modules[it->second];
+        required.requireCalls.push_back(cast<CallBuiltinInst>(&I));
+        if (auto requirer = getModuleIndex(&F))
+          modules[*requirer].deps.push_back(it->second);
+        else
+          required.tracked = false;
+      }
+    }
+  }
+  untrackCycles(modules);
+
+  for (ModuleInfo &info : modules) {
+    if (!info.tracked || !collectExportStores(info))
+      continue;
+
+    // The names which only functions are stored into, and which function
+    // each store stores.
+    llvm::DenseMap<Identifier, llvm::SmallVector<Function *, 2>> functions;
+    for (auto &entry : info.stores) {
+      llvm::SmallVector<Function *, 2> stored;
+      for (auto *store : entry.second) {
+        if (store->getStoredValue()->getKind() !=
+            ValueKind::CreateFunctionInstKind)
+          break;
+        stored.push_back(
+            cast<CreateFunctionInst>(store->getStoredValue())
+                ->getFunctionCode());
+      }
+      if (stored.size() == entry.second.size())
+        functions[entry.first] = std::move(stored);
+    }
+
+    // Check that the exports object only flows into property loads, and into
+    // the "this" of calls of the exported functions which don't use it. Note
+    // the calls of the loaded functions.
+    bool escapes = false;
+    llvm::DenseSet<Identifier> escapedNames;
+    llvm::DenseMap<CallInst *, Identifier> calleeNames;
+    llvm::SmallVector<CallInst *, 4> thisCalls;
+    for (auto *require : info.requireCalls) {
+      llvm::SmallVector<Use, 4> uses;
+      collectUses(require, uses);
+      for (const Use &use : uses) {
+        Value *copy = use.first;
+        if (use.second->getKind() == ValueKind::LoadPropertyInstKind) {
+          auto *load = cast<LoadPropertyInst>(use.second);
+          LiteralString *lit = getLiteralPropertyName(load->getProperty());
+          if (load->getObject() != copy || !lit) {
+            escapes = true;
+            break;
+          }
+          Identifier name = lit->getValue();
+          if (!functions.count(name))
+            continue;
+          llvm::SmallVector<Use, 4> loadUses;
+          collectUses(load, loadUses);
+          for (const Use &loadUse : loadUses) {
+            auto *call = dyn_cast<CallInst>(loadUse.second);
+            if (call && isDirectCallee(loadUse.first, call))
+              calleeNames[call] = name;
+            else
+              escapedNames.insert(name);
+          }
+        } else if (auto *call = dyn_cast<CallInst>(use.second)) {
+          if (call->getCallee() == copy) {
+            escapes = true;
+            break;
+          }
+          for (unsigned i = 1, e = call->getNumArguments(); i < e; ++i) {
+            if (call->getArgument(i) == copy)
+              escapes = true;
+          }
+          thisCalls.push_back(call);
+        } else {
+          escapes = true;
+          break;
+        }
+      }
+      if (escapes)
+        break;
+    }
+    for (auto *call : thisCalls) {
+      auto it = calleeNames.find(call);
+      if (it == calleeNames.end()) {
+        escapes = true;
+        break;
+      }
+      for (auto *F : functions[it->second]) {
+        if (F->getThisParameter() && F->getThisParameter()->hasUsers())
+          escapes = true;
+      }
+    }
+    if (escapes) {
+      LLVM_DEBUG(
+          dbgs() << "Exports of " << info.function->getInternalNameStr()
+                 << " escape\n");
+      continue;
+    }
+
+    // The requiring modules only run once the module has been initialized,
+    // so a property always holds one of the functions stored into it if one
+    // of the stores is always executed.
+    DominanceInfo DT(info.function);
+    llvm::SmallVector<ReturnInst *, 2> returns;
+    for (auto &BB : *info.function) {
+      if (auto *ret = dyn_cast<ReturnInst>(BB.getTerminator()))
+        returns.push_back(ret);
+    }
+    auto isAlwaysStored = [&](Identifier name) {
+      for (auto *store : info.stores[name]) {
+        bool dominatesReturns = true;
+        for (auto *ret : returns)
+          dominatesReturns &= DT.properlyDominates(store, ret);
+        if (dominatesReturns)
+          return true;
+      }
+      return false;
+    };
+
+    // Group the calls by the name they load.
+    llvm::DenseMap<Identifier, unsigned> nameExports;
+    for (auto &entry : functions) {
+      nameExports[entry.first] = exports_.size();
+      exports_.emplace_back();
+      exports_.back().functions.insert(
+          entry.second.begin(), entry.second.end());
+      if (!escapedNames.count(entry.first)) {
+        for (auto *store : info.stores[entry.first])
+          storeExports_[store] = exports_.size() - 1;
+      }
+    }
+    for (auto &entry : calleeNames) {
+      unsigned idx = nameExports[entry.second];
+      exports_[idx].calls.insert(entry.first);
+      if (isAlwaysStored(entry.second))
+        callExports_[entry.first] = idx;
+    }
+    LLVM_DEBUG(
+        dbgs() << "Tracking " << functions.size() << " exports of "
+               << info.function->getInternalNameStr() << "\n");
+  }
+}
+
+const llvm::DenseSet<CallInst *> *CJSExports::getImportingCalls(
+    StorePropertyInst *store) const {
+  auto it = storeExports_.find(store);
+  return it == storeExports_.end() ? nullptr : &exports_[it->second].calls;
+}
+
+const llvm::DenseSet<Function *> *CJSExports::getCallees(
+    CallInst *call) const {
+  auto it = callExports_.find(call);
+  return it == callExports_.end() ? nullptr : &exports_[it->second].functions;
+}
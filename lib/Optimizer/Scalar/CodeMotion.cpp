@@ -26,6 +26,7 @@ STATISTIC(NumCM, "Number of instructions moved");
 STATISTIC(NumHoistedCond, "Number of instructions hoisted from conditionals");
 STATISTIC(NumHoistedLoop, "Number of instructions hoisted from loops");
 STATISTIC(NumSunk, "Number of instructions sunk");
+STATISTIC(NumClosuresSunk, "Number of closures sunk to the block using them");
 
 /// Search the \p searchBudget instructions following \p copy in search of
 /// instructions that are identical to \p I and can be hoisted. Stop the search
@@ -200,6 +201,36 @@ static bool sinkInstructionsInBlock(
   return changed;
 }
 
+/// Sink \p CFI, if all its users are in a single other block, to just before
+/// the first of them, so that the closure is only created on the path which
+/// uses it. Closures with a single user are sunk with the other operands.
+/// \returns true if the closure was sunk.
+static bool sinkClosure(HBCCreateFunctionInst *CFI, const LoopAnalysis &loops) {
+  BasicBlock *parent = CFI->getParent();
+  BasicBlock *userBB = nullptr;
+  for (auto *U : CFI->getUsers()) {
+    if (isa<PhiInst>(U) || (userBB && U->getParent() != userBB))
+      return false;
+    userBB = U->getParent();
+  }
+  if (!userBB || userBB == parent)
+    return false;
+  // Don't create the closure in every iteration of a loop.
+  if (loops.isBlockInLoop(userBB) &&
+      loops.getLoopHeader(userBB) != loops.getLoopHeader(parent))
+    return false;
+
+  for (auto &I : *userBB) {
+    if (llvm::is_contained(CFI->getUsers(), &I)) {
+      CFI->moveBefore(&I);
+      break;
+    }
+  }
+  ++NumCM;
+  ++NumClosuresSunk;
+  return true;
+}
+
 bool CodeMotion::runOnFunction(Function *F) {
   bool changed = false;
   PostOrderAnalysis PO(F);
@@ -233,6 +264,16 @@ bool CodeMotion::runOnFunction(Function *F) {
     changed |= hoistInstructionsFromLoop(BB, dominance, loops);
   }
 
+  llvm::SmallVector<HBCCreateFunctionInst *, 4> closures;
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      if (auto *CFI = dyn_cast<HBCCreateFunctionInst>(&I))
+        closures.push_back(CFI);
+    }
+  }
+  for (auto *CFI : closures)
+    changed |= sinkClosure(CFI, loops);
+
   return changed;
 }
 
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#define DEBUG_TYPE "inlinearraycallbacks"
+
+#include "hermes/Optimizer/Scalar/InlineArrayCallbacks.h"
+#include "hermes/IR/IRBuilder.h"
+#include "hermes/IR/Instrs.h"
+#include "hermes/Optimizer/Scalar/Inlining.h"
+#include "hermes/Support/Statistic.h"
+
+#include "llvm/Support/Debug.h"
+
+using namespace hermes;
+using llvm::dbgs;
+
+STATISTIC(NumLowered, "Number of array method calls lowered to loops");
+
+namespace {
+
+using Method = ArrayCallbackMethod::Enum;
+using OpKind = BinaryOperatorInst::OpKind;
+
+/// A call of an array method which can be lowered to a loop.
+struct ArrayMethodCall {
+  /// The call of the method.
+  CallInst *call;
+  /// The method which is called.
+  Method method;
+  /// The function expression passed as the callback.
+  CreateFunctionInst *callback;
+};
+
+/// \return the array method called by \p CI, if the loop handles the
+/// arguments passed to it, or ArrayCallbackMethod::_count.
+Method getMethod(CallInst *CI) {
+  // The method is loaded from the object it is called on.
+  auto *LPI = dyn_cast<LoadPropertyInst>(CI->getCallee());
+  if (!LPI || LPI->getKind() != ValueKind::LoadPropertyInstKind ||
+      LPI->getObject() != CI->getThis())
+    return ArrayCallbackMethod::_count;
+  auto *name = dyn_cast<LiteralString>(LPI->getProperty());
+  if (!name)
+    return ArrayCallbackMethod::_count;
+
+  // The number of arguments, not counting "this".
+  unsigned numArgs = CI->getNumArguments() - 1;
+  StringRef str = name->getValue().str();
+  if (str == "reduce") {
+    // Without an initial value, the accumulator starts as the first element
+    // which is present, and the call throws if there is none.
+    return numArgs == 2 ? ArrayCallbackMethod::reduce
+                        : ArrayCallbackMethod::_count;
+  }
+  // The callback and the optional thisArg.
+  if (numArgs != 1 && numArgs != 2)
+    return ArrayCallbackMethod::_count;
+  if (str == "forEach")
+    return ArrayCallbackMethod::forEach;
+  if (str == "map")
+    return ArrayCallbackMethod::map;
+  if (str == "filter")
+    return ArrayCallbackMethod::filter;
+  return ArrayCallbackMethod::_count;
+}
+
+/// Collect the calls of \p F which can be lowered into \p calls.
+void collectCalls(Function *F, llvm::SmallVectorImpl<ArrayMethodCall> &calls) {
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      if (I.getKind() != ValueKind::CallInstKind)
+        continue;
+      auto *CI = cast<CallInst>(&I);
+      Method method = getMethod(CI);
+      if (method == ArrayCallbackMethod::_count)
+        continue;
+
+      // The callback must be created for this call only, so that the loop
+      // doesn't need to create it.
+      auto *CFI = dyn_cast<CreateFunctionInst>(CI->getArgument(1));
+      if (!CFI || CFI->getKind() != ValueKind::CreateFunctionInstKind ||
+          !CFI->hasOneUser())
+        continue;
+      for (unsigned i = 2, e = CI->getNumArguments(); i != e; ++i) {
+        if (CI->getArgument(i) == CFI)
+          CFI = nullptr;
+      }
+      if (!CFI || !canBeInlined(CFI->getFunctionCode(), F))
+        continue;
+
+      calls.push_back({CI, method, CFI});
+    }
+  }
+}
+
+/// Replace the call \p AMC with a loop calling the callback on every element
+/// present in the array, which is entered when the method is the original
+/// one, and the call itself otherwise. The callback is inlined into the loop.
+void lowerCall(IRBuilder &builder, const ArrayMethodCall &AMC) {
+  CallInst *CI = AMC.call;
+  CreateFunctionInst *CFI = AMC.callback;
+  BasicBlock *BB = CI->getParent();
+  Function *F = BB->getParent();
+  Value *array = CI->getThis();
+  Value *undefined = builder.getLiteralUndefined();
+  bool isReduce = AMC.method == ArrayCallbackMethod::reduce;
+  Value *thisArg = !isReduce && CI->getNumArguments() > 2 ? CI->getArgument(2)
+                                                          : undefined;
+
+  LLVM_DEBUG(
+      dbgs() << "Lowering an array method call in "
+             << F->getInternalNameStr() << "\n");
+  builder.setLocation(CI->getLocation());
+
+  // Move the instructions following the call to the block where both paths
+  // join.
+  BasicBlock *joinBB = builder.createBasicBlock(F);
+  builder.setInsertionBlock(joinBB);
+  for (auto it = std::next(CI->getIterator()), e = BB->end(); it != e;)
+    builder.transferInstructionToCurrentBlock(&*it++);
+
+  // The slow path creates the callback and calls the method.
+  BasicBlock *slowBB = builder.createBasicBlock(F);
+  builder.setInsertionBlock(slowBB);
+  builder.transferInstructionToCurrentBlock(CI);
+  CFI->moveBefore(CI);
+  builder.createBranchInst(joinBB);
+
+  BasicBlock *fastBB = builder.createBasicBlock(F);
+  BasicBlock *headBB = builder.createBasicBlock(F);
+  BasicBlock *bodyBB = builder.createBasicBlock(F);
+  BasicBlock *holeBB = builder.createBasicBlock(F);
+  BasicBlock *callBB = builder.createBasicBlock(F);
+  BasicBlock *contBB = builder.createBasicBlock(F);
+  BasicBlock *latchBB = builder.createBasicBlock(F);
+  BasicBlock *exitBB = builder.createBasicBlock(F);
+
+  builder.setInsertionBlock(BB);
+  auto *isOriginal = builder.createCallBuiltinInst(
+      BuiltinMethod::HermesBuiltin_isArrayCallbackMethod,
+      {array, CI->getCallee(), builder.getLiteralNumber(AMC.method)});
+  builder.createCondBranchInst(isOriginal, fastBB, slowBB);
+
+  // The length of an array is a number, which is only read once.
+  builder.setInsertionBlock(fastBB);
+  Value *zero = builder.getLiteralNumber(0);
+  Value *len = builder.createLoadPropertyInst(array, "length");
+  Value *result = undefined;
+  if (AMC.method == ArrayCallbackMethod::map ||
+      AMC.method == ArrayCallbackMethod::filter)
+    result =
+        builder.createAllocArrayInst(AllocArrayInst::ArrayValueList{}, 0);
+  builder.createBranchInst(headBB);
+
+  // The index, the accumulator of reduce and the length of the result of
+  // filter.
+  builder.setInsertionBlock(headBB);
+  PhiInst *k = builder.createPhiInst();
+  k->addEntry(zero, fastBB);
+  PhiInst *acc = nullptr;
+  if (isReduce) {
+    acc = builder.createPhiInst();
+    acc->addEntry(CI->getArgument(2), fastBB);
+  }
+  PhiInst *to = nullptr;
+  if (AMC.method == ArrayCallbackMethod::filter) {
+    to = builder.createPhiInst();
+    to->addEntry(zero, fastBB);
+  }
+  builder.createCompareBranchInst(
+      k, len, OpKind::LessThanKind, bodyBB, exitBB);
+
+  // Only an undefined element may be a hole, which is skipped.
+  builder.setInsertionBlock(bodyBB);
+  Value *element = builder.createLoadPropertyInst(array, k);
+  builder.createCompareBranchInst(
+      element, undefined, OpKind::StrictlyNotEqualKind, callBB, holeBB);
+  builder.setInsertionBlock(holeBB);
+  builder.createCondBranchInst(
+      builder.createBinaryOperatorInst(k, array, OpKind::InKind),
+      callBB,
+      latchBB);
+
+  builder.setInsertionBlock(callBB);
+  CallInst *call = isReduce
+      ? builder.createCallInst(CFI, undefined, {acc, element, k, array})
+      : builder.createCallInst(CFI, thisArg, {element, k, array});
+  Value *callResult =
+      inlineFunction(builder, CFI->getFunctionCode(), call, contBB);
+  call->eraseFromParent();
+
+  builder.setInsertionBlock(contBB);
+  Value *nextTo = nullptr;
+  BasicBlock *storeBB = nullptr;
+  switch (AMC.method) {
+    case ArrayCallbackMethod::map:
+      builder.createStoreOwnPropertyInst(
+          callResult, result, k, IRBuilder::PropEnumerable::Yes);
+      builder.createBranchInst(latchBB);
+      break;
+    case ArrayCallbackMethod::filter:
+      storeBB = builder.createBasicBlock(F);
+      builder.createCondBranchInst(callResult, storeBB, latchBB);
+      builder.setInsertionBlock(storeBB);
+      builder.createStoreOwnPropertyInst(
+          element, result, to, IRBuilder::PropEnumerable::Yes);
+      nextTo = builder.createBinaryOperatorInst(
+          to, builder.getLiteralNumber(1), OpKind::AddKind);
+      builder.createBranchInst(latchBB);
+      break;
+    default:
+      builder.createBranchInst(latchBB);
+      break;
+  }
+
+  builder.setInsertionBlock(latchBB);
+  if (acc) {
+    PhiInst *nextAcc = builder.createPhiInst();
+    nextAcc->addEntry(acc, holeBB);
+    nextAcc->addEntry(callResult, contBB);
+    acc->addEntry(nextAcc, latchBB);
+  }
+  if (to) {
+    PhiInst *latchTo = builder.createPhiInst();
+    latchTo->addEntry(to, holeBB);
+    latchTo->addEntry(to, contBB);
+    latchTo->addEntry(nextTo, storeBB);
+    to->addEntry(latchTo, latchBB);
+  }
+  k->addEntry(
+      builder.createBinaryOperatorInst(
+          k, builder.getLiteralNumber(1), OpKind::AddKind),
+      latchBB);
+  builder.createBranchInst(headBB);
+
+  // The result of map has holes where the array had them.
+  builder.setInsertionBlock(exitBB);
+  if (AMC.method == ArrayCallbackMethod::map)
+    builder.createStorePropertyInst(len, result, "length");
+  else if (isReduce)
+    result = acc;
+  builder.createBranchInst(joinBB);
+
+  builder.setInsertionPoint(&joinBB->front());
+  PhiInst *joined = builder.createPhiInst();
+  CI->replaceAllUsesWith(joined);
+  joined->addEntry(CI, slowBB);
+  joined->addEntry(result, exitBB);
+}
+
+} // namespace
+
+bool InlineArrayCallbacks::runOnFunction(Function *F) {
+  if (!F->getContext().getOptimizationSettings().inlining)
+    return false;
+
+  llvm::SmallVector<ArrayMethodCall, 4> calls;
+  collectCalls(F, calls);
+
+  IRBuilder builder(F);
+  for (const ArrayMethodCall &AMC : calls) {
+    lowerCall(builder, AMC);
+    ++NumLowered;
+  }
+  return !calls.empty();
+}
+
+Pass *hermes::createInlineArrayCallbacks() {
+  return new InlineArrayCallbacks();
+}
@@ -46,9 +46,7 @@ static llvm::SmallVector<BasicBlock *, 4> orderDFS(Function *F) {
   return order;
 }
 
-/// \return true if the function \p F satisfies the conditions for being
-///   inlined.
-static bool canBeInlined(Function *F, Function *intoFunction) {
+bool canBeInlined(Function *F, Function *intoFunction) {
   // If it has captured variables, it can't be inlined.
   if (!F->getFunctionScope()->getVariables().empty()) {
     return false;
@@ -83,14 +81,36 @@ static bool canBeInlined(Function *F, Function *intoFunction) {
   return true;
 }
 
-/// Inline a function into the current insertion point, which must be at the
-/// end of a basic block because a branch will be inserted.
-/// \param F the function to inline
-/// \param CI the call instruction being replaced. Note that this call
-///   will not actually replace it.
-/// \param nextBlock the block to branch after the inlining
-/// \return the return value of the inlined function
-static Value *inlineFunction(
+/// The number of calls in a profiling run from which a function is hot.
+static constexpr uint64_t kHotEntryCount = 1000;
+
+/// The maximum number of instructions of a hot function which is copied into
+/// several call sites.
+static constexpr unsigned kMaxHotFunctionSize = 32;
+
+/// \return true if the profile recorded at least kHotEntryCount calls to \p F,
+///   and \p F is small enough to be copied into each of its call sites.
+static bool isHotAndSmall(Function *F) {
+  const auto &entryCounts =
+      F->getContext().getOptimizationSettings().functionEntryCounts;
+  if (entryCounts.empty())
+    return false;
+
+  SourceErrorManager::SourceCoords coords;
+  if (!F->getContext().getSourceErrorManager().findBufferLineAndLoc(
+          F->getSourceRange().Start, coords))
+    return false;
+  auto it = entryCounts.find({coords.line, coords.col});
+  if (it == entryCounts.end() || it->second < kHotEntryCount)
+    return false;
+
+  unsigned size = 0;
+  for (auto &BB : *F)
+    size += BB.getInstList().size();
+  return size <= kMaxHotFunctionSize;
+}
+
+Value *inlineFunction(
     IRBuilder &builder,
     Function *F,
     CallInst *CI,
@@ -273,57 +293,69 @@ bool Inlining::runOnModule(Module *M) {
       if (!CFI)
         continue;
 
+      auto *FC = CFI->getFunctionCode();
+      llvm::SmallVector<CallInst *, 2> callSites{};
+
       // Check if the function is used only once directly by a CallInst.
       // We can't use getCallSites() (yet) because it also considers constructor
       // calls as well usages through environment variables.
-
-      if (!CFI->hasOneUser() ||
-          CFI->getUsers()[0]->getKind() != ValueKind::CallInstKind) {
-        continue;
+      if (CFI->hasOneUser()) {
+        if (CFI->getUsers()[0]->getKind() == ValueKind::CallInstKind) {
+          auto *CI = cast<CallInst>(CFI->getUsers()[0]);
+          if (isDirectCallee(CFI, CI))
+            callSites.push_back(CI);
+        }
+      } else if (isHotAndSmall(FC)) {
+        // Copy functions which the profile found to be hot into each of their
+        // direct call sites.
+        for (auto *U : CFI->getUsers()) {
+          if (U->getKind() != ValueKind::CallInstKind)
+            continue;
+          auto *CI = cast<CallInst>(U);
+          if (isDirectCallee(CFI, CI))
+            callSites.push_back(CI);
+        }
       }
-      auto *CI = cast<CallInst>(CFI->getUsers()[0]);
-      if (!isDirectCallee(CFI, CI))
-        continue;
 
-      Function *intoFunction = CI->getParent()->getParent();
-
-      auto *FC = CFI->getFunctionCode();
-      if (!canBeInlined(FC, intoFunction))
-        continue;
-
-      LLVM_DEBUG(llvm::dbgs() << "Inlining function '"
-                              << FC->getInternalNameStr() << "' ";
-                 FC->getContext().getSourceErrorManager().dumpCoords(
-                     llvm::dbgs(), FC->getSourceRange().Start);
-                 llvm::dbgs() << " into function '"
-                              << intoFunction->getInternalNameStr() << "' ";
-                 FC->getContext().getSourceErrorManager().dumpCoords(
-                     llvm::dbgs(), intoFunction->getSourceRange().Start);
-                 llvm::dbgs() << "\n";);
-
-      IRBuilder builder(M);
-
-      // Split the block in two and move all instructions following the call
-      // to the new block.
-      BasicBlock *nextBlock = builder.createBasicBlock(intoFunction);
-      builder.setInsertionBlock(nextBlock);
-
-      // Move the rest of the instructions.
-      auto it = CI->getIterator();
-      ++it; // Skip over the call.
-      auto e = CI->getParent()->end();
-      while (it != e)
-        builder.transferInstructionToCurrentBlock(&*it++);
-
-      // Perform the inlining.
-      builder.setInsertionPointAfter(CI);
-
-      auto *returnValue = inlineFunction(builder, FC, CI, nextBlock);
-      CI->replaceAllUsesWith(returnValue);
-      CI->eraseFromParent();
-
-      ++NumInlinedCalls;
-      changed = true;
+      for (CallInst *CI : callSites) {
+        Function *intoFunction = CI->getParent()->getParent();
+        if (!canBeInlined(FC, intoFunction))
+          continue;
+
+        LLVM_DEBUG(llvm::dbgs() << "Inlining function '"
+                                << FC->getInternalNameStr() << "' ";
+                   FC->getContext().getSourceErrorManager().dumpCoords(
+                       llvm::dbgs(), FC->getSourceRange().Start);
+                   llvm::dbgs() << " into function '"
+                                << intoFunction->getInternalNameStr() << "' ";
+                   FC->getContext().getSourceErrorManager().dumpCoords(
+                       llvm::dbgs(), intoFunction->getSourceRange().Start);
+                   llvm::dbgs() << "\n";);
+
+        IRBuilder builder(M);
+
+        // Split the block in two and move all instructions following the call
+        // to the new block.
+        BasicBlock *nextBlock = builder.createBasicBlock(intoFunction);
+        builder.setInsertionBlock(nextBlock);
+
+        // Move the rest of the instructions.
+        auto it = CI->getIterator();
+        ++it; // Skip over the call.
+        auto e = CI->getParent()->end();
+        while (it != e)
+          builder.transferInstructionToCurrentBlock(&*it++);
+
+        // Perform the inlining.
+        builder.setInsertionPointAfter(CI);
+
+        auto *returnValue = inlineFunction(builder, FC, CI, nextBlock);
+        CI->replaceAllUsesWith(returnValue);
+        CI->eraseFromParent();
+
+        ++NumInlinedCalls;
+        changed = true;
+      }
     }
   }
 
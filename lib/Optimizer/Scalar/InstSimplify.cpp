@@ -17,6 +17,7 @@
 #include "hermes/Support/Statistic.h"
 
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Support/Debug.h"
 
 using namespace hermes;
@@ -490,6 +491,23 @@ Value *simplifyAddEmptyString(AddEmptyStringInst *AES) {
   return nullptr;
 }
 
+Value *simplifyStringConcat(StringConcatInst *SC) {
+  IRBuilder builder(SC->getParent()->getParent());
+
+  // If every operand is a literal, try to evaluate the concatenation.
+  llvm::SmallString<256> result;
+  for (unsigned i = 0, e = SC->getNumArguments(); i < e; ++i) {
+    auto *lit = dyn_cast<Literal>(SC->getArgument(i));
+    if (!lit)
+      return nullptr;
+    auto *str = evalToString(builder, lit);
+    if (!str)
+      return nullptr;
+    result.append(str->getValue().str());
+  }
+  return builder.getLiteralString(result.str());
+}
+
 Value *simplifyCoerceThisNS(CoerceThisNSInst *coerce) {
   auto *operand = coerce->getSingleOperand();
 
@@ -540,6 +558,8 @@ OptValue<Value *> simplifyInstruction(Instruction *I) {
       return simplifyAsInt32(cast<AsInt32Inst>(I));
     case ValueKind::AddEmptyStringInstKind:
       return simplifyAddEmptyString(cast<AddEmptyStringInst>(I));
+    case ValueKind::StringConcatInstKind:
+      return simplifyStringConcat(cast<StringConcatInst>(I));
     case ValueKind::PhiInstKind:
       return simplifyPhiInst(cast<PhiInst>(I));
     case ValueKind::CondBranchInstKind:
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#define DEBUG_TYPE "licm"
+
+#include "hermes/Optimizer/Scalar/LICM.h"
+#include "hermes/IR/Analysis.h"
+#include "hermes/IR/CFG.h"
+#include "hermes/IR/Instrs.h"
+#include "hermes/Optimizer/Scalar/Utils.h"
+#include "hermes/Support/Statistic.h"
+
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/Debug.h"
+
+using namespace hermes;
+using llvm::dbgs;
+using llvm::isa;
+
+STATISTIC(NumHoisted, "Number of instructions hoisted from loops");
+STATISTIC(NumLoadsHoisted, "Number of loads hoisted from loops");
+STATISTIC(NumClosuresHoisted, "Number of closures hoisted from loops");
+
+namespace {
+
+using BlockSet = llvm::SmallPtrSet<BasicBlock *, 16>;
+
+/// \return true if \p I loads the length of an array literal, which can't
+/// execute any code.
+bool loadsArrayLiteralLength(Instruction *I) {
+  if (I->getKind() != ValueKind::LoadPropertyInstKind)
+    return false;
+  auto *LPI = cast<LoadPropertyInst>(I);
+  return isArrayLiteralLength(LPI->getObject(), LPI->getProperty());
+}
+
+/// \return true if \p F, or a function nested in it, may get hold of the
+/// closure which is called, through "arguments" or a direct eval. The
+/// "arguments" of arrow functions are created by the enclosing function.
+bool mayObserveCallee(Function *F, bool nested = false) {
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      if (isa<DirectEvalInst>(&I) ||
+          (!nested && isa<CreateArgumentsInst>(&I)))
+        return true;
+      if (auto *CFI = dyn_cast<CreateFunctionInst>(&I)) {
+        if (mayObserveCallee(CFI->getFunctionCode(), true))
+          return true;
+      }
+    }
+  }
+  return false;
+}
+
+/// \return true if \p I creates a closure which is only called, and can't
+/// observe itself. A function has a single environment, so the closures
+/// created in each iteration of a loop can't be told apart, and the one
+/// created before the loop can be reused by every iteration.
+bool isNonEscapingClosure(Instruction *I) {
+  if (I->getKind() != ValueKind::CreateFunctionInstKind)
+    return false;
+  for (auto *U : I->getUsers()) {
+    // Constructing would expose the closure as new.target, and its
+    // "prototype" property as the parent of the new object.
+    if (U->getKind() != ValueKind::CallInstKind ||
+        !isDirectCallee(I, cast<CallInst>(U)))
+      return false;
+  }
+  return !mayObserveCallee(cast<CreateFunctionInst>(I)->getFunctionCode());
+}
+
+/// Collect the blocks of the loop with header \p header into \p body.
+/// \return false if the loop can be entered other than through its preheader
+/// \p preheader.
+bool collectLoopBody(
+    BasicBlock *header,
+    BasicBlock *preheader,
+    const DominanceInfo &dominance,
+    BlockSet &body) {
+  llvm::SmallVector<BasicBlock *, 8> worklist;
+  body.insert(header);
+  for (auto *pred : predecessors(header)) {
+    if (pred == preheader)
+      continue;
+    if (!dominance.dominates(header, pred))
+      return false;
+    if (body.insert(pred).second)
+      worklist.push_back(pred);
+  }
+  // Everything which reaches a back edge without going through the header is
+  // in the loop.
+  while (!worklist.empty()) {
+    BasicBlock *BB = worklist.pop_back_val();
+    for (auto *pred : predecessors(BB)) {
+      if (!dominance.dominates(header, pred))
+        return false;
+      if (body.insert(pred).second)
+        worklist.push_back(pred);
+    }
+  }
+  return true;
+}
+
+/// The memory written by the instructions of a loop.
+struct LoopWrites {
+  /// The variables stored to in the loop.
+  llvm::SmallPtrSet<Variable *, 8> vars{};
+  /// Whether the loop may write anything else, including variables captured
+  /// by closures it calls.
+  bool unknown = false;
+};
+
+/// \return the memory which may be written by the loop with blocks \p body.
+LoopWrites collectWrites(const BlockSet &body) {
+  LoopWrites writes;
+  for (auto *BB : body) {
+    for (auto &I : *BB) {
+      if (auto *SFI = dyn_cast<StoreFrameInst>(&I)) {
+        writes.vars.insert(SFI->getVariable());
+        continue;
+      }
+      // Stack locations never alias variables or properties.
+      if (isa<StoreStackInst>(&I) || loadsArrayLiteralLength(&I))
+        continue;
+      if (I.getSideEffect() >= SideEffectKind::MayWrite)
+        writes.unknown = true;
+    }
+  }
+  return writes;
+}
+
+/// \return true if \p I produces the same value in every iteration of a loop
+/// which writes \p writes.
+bool isInvariantInLoop(Instruction *I, const LoopWrites &writes) {
+  if (isSimpleSideEffectFreeInstruction(I) || isNonEscapingClosure(I))
+    return true;
+  if (writes.unknown)
+    return false;
+  if (auto *LFI = dyn_cast<LoadFrameInst>(I))
+    return !writes.vars.count(LFI->getLoadVariable());
+  return loadsArrayLiteralLength(I);
+}
+
+/// Hoist the invariant instructions of the loop with header \p header into
+/// the preheader \p preheader.
+/// \returns true if some instructions were hoisted.
+bool hoistFromLoop(
+    BasicBlock *header,
+    BasicBlock *preheader,
+    const DominanceInfo &dominance) {
+  BlockSet body;
+  if (!collectLoopBody(header, preheader, dominance, body))
+    return false;
+  LoopWrites writes = collectWrites(body);
+  Instruction *branchInst = preheader->getTerminator();
+
+  auto operandsAvailable = [&](Instruction *I) {
+    for (unsigned i = 0, e = I->getNumOperands(); i < e; ++i) {
+      auto *operand = dyn_cast<Instruction>(I->getOperand(i));
+      if (operand && !dominance.properlyDominates(operand, branchInst))
+        return false;
+    }
+    return true;
+  };
+
+  // Hoisting an instruction may make the instructions using it invariant, so
+  // iterate until nothing else can move.
+  bool changed = false;
+  bool localChange;
+  do {
+    localChange = false;
+    // Visit the blocks in program order to keep the output deterministic.
+    for (auto &BB : *header->getParent()) {
+      if (!body.count(&BB))
+        continue;
+      for (auto it = BB.begin(), e = BB.end(); it != e;) {
+        Instruction *I = &*it++;
+        if (!isInvariantInLoop(I, writes) || !operandsAvailable(I))
+          continue;
+        LLVM_DEBUG(
+            dbgs() << "Hoisting " << I->getKindStr() << " into "
+                   << preheader->getParent()->getInternalNameStr() << "\n");
+        I->moveBefore(branchInst);
+        if (isa<CreateFunctionInst>(I))
+          ++NumClosuresHoisted;
+        else if (!isSimpleSideEffectFreeInstruction(I))
+          ++NumLoadsHoisted;
+        ++NumHoisted;
+        localChange = true;
+      }
+    }
+    changed |= localChange;
+  } while (localChange);
+  return changed;
+}
+
+} // namespace
+
+bool LICM::runOnFunction(Function *F) {
+  DominanceInfo dominance(F);
+  LoopAnalysis loops(F, dominance);
+  bool changed = false;
+  // Visit inner loops before the loops enclosing them, so that instructions
+  // can be hoisted through several levels.
+  PostOrderAnalysis PO(F);
+  for (auto *BB : PO) {
+    if (!loops.isBlockHeader(BB))
+      continue;
+    if (BasicBlock *preheader = loops.getLoopPreheader(BB))
+      changed |= hoistFromLoop(BB, preheader, dominance);
+  }
+  return changed;
+}
+
+Pass *hermes::createLICM() {
+  return new LICM();
+}
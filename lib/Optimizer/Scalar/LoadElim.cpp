@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#define DEBUG_TYPE "loadelim"
+
+#include "hermes/Optimizer/Scalar/LoadElim.h"
+#include "hermes/IR/Analysis.h"
+#include "hermes/IR/CFG.h"
+#include "hermes/IR/IRBuilder.h"
+#include "hermes/IR/Instrs.h"
+#include "hermes/Optimizer/Scalar/Utils.h"
+#include "hermes/Support/Statistic.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/Debug.h"
+
+using namespace hermes;
+using llvm::dbgs;
+using llvm::isa;
+
+STATISTIC(NumFrameLoadsElim, "Number of variable loads eliminated");
+STATISTIC(NumPropLoadsElim, "Number of property loads eliminated");
+
+namespace {
+
+/// The values known to be in memory at some point of a function.
+struct AvailableLoads {
+  /// The value of every variable that is known.
+  llvm::DenseMap<Variable *, Value *> vars{};
+  /// The value of every property known to be an own data property, by object
+  /// and name.
+  llvm::DenseMap<std::pair<Value *, LiteralString *>, Value *> props{};
+
+  /// Forget everything, as memory may have been written anywhere.
+  void clear() {
+    vars.clear();
+    props.clear();
+  }
+
+  /// Forget the properties of \p object.
+  void forgetObject(Value *object) {
+    for (auto it = props.begin(), e = props.end(); it != e; ++it) {
+      if (it->first.first == object)
+        props.erase(it);
+    }
+  }
+};
+
+/// \return the block whose values are still known at the start of \p BB,
+/// because it is the only way into \p BB, or nullptr.
+BasicBlock *getKnownPredecessor(BasicBlock *BB) {
+  // A handler is entered from anywhere in its try region, not only from the
+  // block starting it.
+  if (isa<CatchInst>(&BB->front()) || pred_count_unique(BB) != 1)
+    return nullptr;
+  BasicBlock *pred = *pred_begin(BB);
+  return pred != BB ? pred : nullptr;
+}
+
+/// Eliminate the loads of \p BB whose value is in \p avail, which is updated
+/// with the instructions of the block. The eliminated loads are added to
+/// \p destroyer.
+/// \return true if some loads were eliminated.
+bool processBlock(
+    BasicBlock *BB,
+    AvailableLoads &avail,
+    IRBuilder::InstructionDestroyer &destroyer) {
+  bool changed = false;
+  auto replace = [&](Instruction *load, Value *value) {
+    LLVM_DEBUG(
+        dbgs() << "Eliminating " << load->getKindStr() << " in "
+               << BB->getParent()->getInternalNameStr() << "\n");
+    load->replaceAllUsesWith(value);
+    destroyer.add(load);
+    changed = true;
+  };
+
+  for (auto &I : *BB) {
+    if (auto *LFI = dyn_cast<LoadFrameInst>(&I)) {
+      Value *&known = avail.vars[LFI->getLoadVariable()];
+      if (known) {
+        replace(LFI, known);
+        ++NumFrameLoadsElim;
+      } else {
+        known = LFI;
+      }
+      continue;
+    }
+    if (auto *SFI = dyn_cast<StoreFrameInst>(&I)) {
+      avail.vars[SFI->getVariable()] = SFI->getValue();
+      continue;
+    }
+    // Stack locations never alias variables or properties.
+    if (isa<StoreStackInst>(&I))
+      continue;
+
+    // The global property accesses are subclasses, which may throw instead.
+    if (I.getKind() == ValueKind::LoadPropertyInstKind) {
+      auto *LPI = cast<LoadPropertyInst>(&I);
+      Value *object = LPI->getObject();
+      if (LiteralString *name = getLiteralPropertyName(LPI->getProperty())) {
+        auto key = std::make_pair(object, name);
+        auto found = avail.props.find(key);
+        if (found != avail.props.end()) {
+          replace(LPI, found->second);
+          ++NumPropLoadsElim;
+          continue;
+        }
+        if (isArrayLiteralLength(object, name)) {
+          avail.props[key] = LPI;
+          continue;
+        }
+      }
+      // The load may call a getter.
+      avail.clear();
+      continue;
+    }
+    if (auto *SOI = dyn_cast<StoreNewOwnPropertyInst>(&I)) {
+      // Defining a property runs no code, but it changes the length of an
+      // array.
+      Value *object = SOI->getObject();
+      if (!isa<AllocObjectInst>(object))
+        avail.forgetObject(object);
+      else if (auto *name = getLiteralPropertyName(SOI->getPropertyName()))
+        avail.props[{object, name}] = SOI->getStoredValue();
+      continue;
+    }
+    if (I.getKind() == ValueKind::StorePropertyInstKind) {
+      // Assigning an own data property of an object literal runs no code.
+      auto *SPI = cast<StorePropertyInst>(&I);
+      Value *object = SPI->getObject();
+      LiteralString *name = getLiteralPropertyName(SPI->getProperty());
+      if (name && isa<AllocObjectInst>(object)) {
+        auto found = avail.props.find({object, name});
+        if (found != avail.props.end()) {
+          found->second = SPI->getStoredValue();
+          continue;
+        }
+      }
+      avail.clear();
+      continue;
+    }
+
+    if (I.getSideEffect() >= SideEffectKind::MayWrite)
+      avail.clear();
+  }
+  return changed;
+}
+
+} // namespace
+
+bool LoadElim::runOnFunction(Function *F) {
+  IRBuilder::InstructionDestroyer destroyer;
+  // The values known at the end of every block visited so far. A block is
+  // visited after its only predecessor, if it has one, in reverse post order.
+  llvm::DenseMap<BasicBlock *, AvailableLoads> exits;
+  PostOrderAnalysis PO(F);
+  bool changed = false;
+  for (auto it = PO.rbegin(), e = PO.rend(); it != e; ++it) {
+    BasicBlock *BB = *it;
+    AvailableLoads avail;
+    if (BasicBlock *pred = getKnownPredecessor(BB)) {
+      auto found = exits.find(pred);
+      if (found != exits.end())
+        avail = found->second;
+    }
+    changed |= processBlock(BB, avail, destroyer);
+    exits[BB] = std::move(avail);
+  }
+  return changed;
+}
+
+Pass *hermes::createLoadElim() {
+  return new LoadElim();
+}
@@ -64,9 +64,11 @@ class ResolveStaticRequireImpl {
     CallInst *call;
     /// The resolved target.
     Literal *resolvedTarget;
+    /// The ID of the module making the call.
+    uint32_t moduleID;
 
-    ResolvedRequire(CallInst *call, Literal *resolvedTarget)
-        : call(call), resolvedTarget(resolvedTarget) {}
+    ResolvedRequire(CallInst *call, Literal *resolvedTarget, uint32_t moduleID)
+        : call(call), resolvedTarget(resolvedTarget), moduleID(moduleID) {}
   };
 
   /// All resolved require calls. If canResolve_ is true, we can replace them
@@ -117,6 +119,11 @@ bool ResolveStaticRequireImpl::run() {
 
     RR.call->replaceAllUsesWith(callHI);
     RR.call->eraseFromParent();
+
+    // Record the dependency so that the runtime can load it ahead of time.
+    M_->addCJSModuleDependency(
+        RR.moduleID,
+        (uint32_t)cast<LiteralNumber>(RR.resolvedTarget)->getValue());
   }
 
   M_->setCJSModulesResolved(true);
@@ -271,7 +278,8 @@ void ResolveStaticRequireImpl::resolveRequireCall(
     return;
   }
 
-  resolvedRequireCalls_.emplace_back(call, resolved);
+  resolvedRequireCalls_.emplace_back(
+      call, resolved, M_->findCJSModule(moduleFunction)->id);
   ++NumRequireCallsResolved;
 }
 
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#define DEBUG_TYPE "scalarreplacement"
+
+#include "hermes/Optimizer/Scalar/ScalarReplacement.h"
+#include "hermes/IR/CFG.h"
+#include "hermes/IR/IRBuilder.h"
+#include "hermes/IR/Instrs.h"
+#include "hermes/Optimizer/Scalar/Utils.h"
+#include "hermes/Support/Statistic.h"
+
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/Debug.h"
+
+using namespace hermes;
+using llvm::dbgs;
+using llvm::isa;
+
+STATISTIC(NumObjectsReplaced, "Number of object allocations replaced");
+STATISTIC(NumPropsReplaced, "Number of object properties replaced");
+
+namespace {
+
+/// The accesses of an object that never escapes, grouped by property name.
+struct PropertyAccesses {
+  /// Stores defining the property as an own property of the object.
+  llvm::SmallVector<StoreOwnPropertyInst *, 2> defs{};
+  /// Assignments to the property.
+  llvm::SmallVector<StorePropertyInst *, 2> stores{};
+  /// Loads of the property.
+  llvm::SmallVector<LoadPropertyInst *, 2> loads{};
+};
+
+using PropertyMap = llvm::MapVector<Identifier, PropertyAccesses>;
+
+/// Collect the accesses of the object allocated by \p alloc into \p props.
+/// \return false if the object may escape, or if any of its properties may be
+/// found anywhere but in the object itself.
+bool collectAccesses(
+    DominanceInfo &DT,
+    AllocObjectInst *alloc,
+    PropertyMap &props) {
+  for (auto *user : alloc->getUsers()) {
+    if (auto *def = dyn_cast<StoreOwnPropertyInst>(user)) {
+      LiteralString *name = getLiteralPropertyName(def->getProperty());
+      if (def->getObject() != alloc || def->getStoredValue() == alloc ||
+          !name)
+        return false;
+      props[name->getValue()].defs.push_back(def);
+    } else if (user->getKind() == ValueKind::StorePropertyInstKind) {
+      auto *store = cast<StorePropertyInst>(user);
+      LiteralString *name = getLiteralPropertyName(store->getProperty());
+      if (store->getObject() != alloc || store->getStoredValue() == alloc ||
+          !name)
+        return false;
+      props[name->getValue()].stores.push_back(store);
+    } else if (user->getKind() == ValueKind::LoadPropertyInstKind) {
+      auto *load = cast<LoadPropertyInst>(user);
+      LiteralString *name = getLiteralPropertyName(load->getProperty());
+      if (load->getObject() != alloc || !name)
+        return false;
+      props[name->getValue()].loads.push_back(load);
+    } else {
+      return false;
+    }
+  }
+
+  // Loads of a property that isn't an own property yet would look it up in
+  // the prototype chain, and assignments could call a setter found there.
+  auto isDefinedAt = [&DT](PropertyAccesses &accesses, Instruction *inst) {
+    for (auto *def : accesses.defs) {
+      if (DT.properlyDominates(def, inst))
+        return true;
+    }
+    return false;
+  };
+  for (auto &entry : props) {
+    for (auto *store : entry.second.stores) {
+      if (!isDefinedAt(entry.second, store))
+        return false;
+    }
+    for (auto *load : entry.second.loads) {
+      if (!isDefinedAt(entry.second, load))
+        return false;
+    }
+  }
+  return true;
+}
+
+/// Replace the object allocated by \p alloc with a stack allocation for each
+/// of the properties in \p props.
+void replaceObject(
+    Function *F,
+    AllocObjectInst *alloc,
+    PropertyMap &props) {
+  IRBuilder builder(F);
+  IRBuilder::InstructionDestroyer destroyer;
+
+  for (auto &entry : props) {
+    builder.setInsertionPoint(&*F->begin()->begin());
+    auto *stackVar = builder.createAllocStackInst(entry.first);
+    builder.createStoreStackInst(builder.getLiteralUndefined(), stackVar);
+
+    for (auto *def : entry.second.defs) {
+      builder.setInsertionPoint(def);
+      builder.createStoreStackInst(def->getStoredValue(), stackVar);
+      destroyer.add(def);
+    }
+    for (auto *store : entry.second.stores) {
+      builder.setInsertionPoint(store);
+      builder.createStoreStackInst(store->getStoredValue(), stackVar);
+      destroyer.add(store);
+    }
+    for (auto *load : entry.second.loads) {
+      builder.setInsertionPoint(load);
+      auto *LS = builder.createLoadStackInst(stackVar);
+      load->replaceAllUsesWith(LS);
+      destroyer.add(load);
+    }
+    ++NumPropsReplaced;
+  }
+  destroyer.add(alloc);
+  ++NumObjectsReplaced;
+}
+
+} // namespace
+
+bool ScalarReplacement::runOnFunction(Function *F) {
+  llvm::SmallVector<AllocObjectInst *, 4> allocs;
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      if (auto *alloc = dyn_cast<AllocObjectInst>(&I))
+        allocs.push_back(alloc);
+    }
+  }
+  if (allocs.empty())
+    return false;
+
+  DominanceInfo DT(F);
+  bool changed = false;
+  for (auto *alloc : allocs) {
+    PropertyMap props;
+    if (!collectAccesses(DT, alloc, props))
+      continue;
+    LLVM_DEBUG(
+        dbgs() << "Replacing " << props.size() << " properties of an object in "
+               << F->getInternalNameStr() << "\n");
+    replaceObject(F, alloc, props);
+    changed = true;
+  }
+  return changed;
+}
+
+Pass *hermes::createScalarReplacement() {
+  return new ScalarReplacement();
+}
@@ -9,6 +9,7 @@
 
 #include "hermes/IR/IR.h"
 #include "hermes/IR/Instrs.h"
+#include "hermes/Optimizer/Scalar/CJSExports.h"
 #include "hermes/Optimizer/Scalar/Utils.h"
 
 using namespace hermes;
@@ -18,7 +19,15 @@ using llvm::isa;
 /// Auxiliary method to figure out the Functions that a given CallInst may
 /// be calling. Returns true if we have a complete set, false if there are
 /// unknown callees.
-static bool identifyCallees(CallInst *CI, llvm::DenseSet<Function *> &callees) {
+static bool identifyCallees(
+    CallInst *CI,
+    const CJSExports *exports,
+    llvm::DenseSet<Function *> &callees) {
+  if (auto *exported = exports ? exports->getCallees(CI) : nullptr) {
+    callees.insert(exported->begin(), exported->end());
+    return true;
+  }
+
   Value *callee = CI->getCallee();
   switch (callee->getKind()) {
     case ValueKind::FunctionKind: {
@@ -67,6 +76,7 @@ static bool identifyCallees(CallInst *CI, llvm::DenseSet<Function *> &callees) {
 /// invoked.  Returns true if the complete set of call sites is known.
 static bool identifyCallsites(
     Function *F,
+    const CJSExports *exports,
     llvm::DenseSet<CallInst *> &callSites) {
   for (auto *CU : F->getUsers()) {
     if (auto *CI = dyn_cast<CallInst>(CU)) {
@@ -75,6 +85,16 @@ static bool identifyCallsites(
       callSites.insert(CI);
     } else if (auto *CFI = dyn_cast<CreateFunctionInst>(CU)) {
       for (auto *CL : CFI->getUsers()) {
+        // A function exported by a CommonJS module is called by the modules
+        // requiring it.
+        if (auto *SPI = dyn_cast<StorePropertyInst>(CL)) {
+          auto *calls = exports ? exports->getImportingCalls(SPI) : nullptr;
+          if (!calls)
+            return false;
+          callSites.insert(calls->begin(), calls->end());
+          continue;
+        }
+
         auto *CI = dyn_cast<CallInst>(CL);
         if (!CI)
           return false;
@@ -91,10 +111,12 @@ static bool identifyCallsites(
 }
 
 /// The main function that computes caller-callee relationships.
-void SimpleCallGraphProvider::initCallRelationships(Function *F) {
+void SimpleCallGraphProvider::initCallRelationships(
+    Function *F,
+    const CJSExports *exports) {
   // (a) Initialize the callsites map.
   llvm::DenseSet<CallInst *> callSites;
-  if (identifyCallsites(F, callSites)) {
+  if (identifyCallsites(F, exports, callSites)) {
     callsites_.insert(std::make_pair(F, callSites));
   }
 
@@ -108,7 +130,7 @@ void SimpleCallGraphProvider::initCallRelationships(Function *F) {
         continue;
 
       llvm::DenseSet<Function *> funcs;
-      if (identifyCallees(CI, funcs)) {
+      if (identifyCallees(CI, exports, funcs)) {
         callees_.insert(std::make_pair(CI, funcs));
       }
     }
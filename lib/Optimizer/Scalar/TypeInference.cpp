@@ -12,6 +12,7 @@
 #include "hermes/IR/CFG.h"
 #include "hermes/IR/IRBuilder.h"
 #include "hermes/IR/Instrs.h"
+#include "hermes/Optimizer/Scalar/CJSExports.h"
 #include "hermes/Optimizer/Scalar/SimpleCallGraphProvider.h"
 #include "hermes/Support/Statistic.h"
 
@@ -685,8 +686,9 @@ bool TypeInferenceImpl::runOnModule(Module *M) {
 
   LLVM_DEBUG(dbgs() << "\nStart Type Inference on Module\n");
 
+  CJSExports exports{M};
   for (auto &F : *M) {
-    SimpleCallGraphProvider scgp(&F);
+    SimpleCallGraphProvider scgp(&F, &exports);
     cgp_ = &scgp;
     changed |= runOnFunction(&F);
   }
@@ -239,3 +239,16 @@ bool hermes::isSimpleSideEffectFreeInstruction(Instruction *I) {
   }
   llvm_unreachable("unreachable");
 }
+
+LiteralString *hermes::getLiteralPropertyName(Value *prop) {
+  auto *lit = dyn_cast<LiteralString>(prop);
+  if (!lit || lit->getValue().str() == "__proto__")
+    return nullptr;
+  return lit;
+}
+
+bool hermes::isArrayLiteralLength(Value *object, Value *prop) {
+  auto *lit = dyn_cast<LiteralString>(prop);
+  return lit && lit->getValue().str() == "length" &&
+      isa<AllocArrayInst>(object);
+}
@@ -11,6 +11,13 @@
 #include "hermes/Support/Conversions.h"
 
 #include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/MathExtras.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 using llvm::Twine;
 
@@ -42,6 +49,183 @@ inline bool matchUnicodeLineTerminatorOffset1(const char *curCharPtr_) {
       ((unsigned char)curCharPtr_[2] == 0xa8 ||
        (unsigned char)curCharPtr_[2] == 0xa9);
 }
+
+// Runs of characters which need no work besides being copied or skipped,
+// such as indentation, the text of comments and strings, and identifiers,
+// are skipped a vector of characters at a time. The skip functions return
+// the first character of the run which needs to be looked at, or the
+// remaining characters when there are fewer than a whole vector before
+// \p end, and the scalar loops of the callers continue from there.
+#if defined(__SSE2__) || defined(__aarch64__)
+
+#if defined(__SSE2__)
+using CharVec = __m128i;
+#else
+using CharVec = uint8x16_t;
+#endif
+constexpr ptrdiff_t kCharVecSize = 16;
+
+inline CharVec loadChars(const char *p) {
+#if defined(__SSE2__)
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+#else
+  return vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+#endif
+}
+
+/// \return the lanes of \p v which are \p c.
+inline CharVec matchChar(CharVec v, char c) {
+#if defined(__SSE2__)
+  return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+#else
+  return vceqq_u8(v, vdupq_n_u8(static_cast<uint8_t>(c)));
+#endif
+}
+
+/// \return the lanes of \p v in the ASCII range [\p lo, \p hi].
+inline CharVec matchRange(CharVec v, char lo, char hi) {
+#if defined(__SSE2__)
+  // The comparisons are signed, so non-ASCII lanes are below lo.
+  return _mm_and_si128(
+      _mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+      _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+#else
+  return vandq_u8(
+      vcgeq_u8(v, vdupq_n_u8(static_cast<uint8_t>(lo))),
+      vcleq_u8(v, vdupq_n_u8(static_cast<uint8_t>(hi))));
+#endif
+}
+
+/// \return the lanes of \p v which start or continue a UTF-8 sequence.
+inline CharVec matchNonASCII(CharVec v) {
+#if defined(__SSE2__)
+  return _mm_cmplt_epi8(v, _mm_setzero_si128());
+#else
+  return vcgeq_u8(v, vdupq_n_u8(0x80));
+#endif
+}
+
+/// \return the lanes set in either \p a or \p b.
+inline CharVec either(CharVec a, CharVec b) {
+#if defined(__SSE2__)
+  return _mm_or_si128(a, b);
+#else
+  return vorrq_u8(a, b);
+#endif
+}
+
+/// \return \p v with ASCII letters in lower case.
+inline CharVec toLower(CharVec v) {
+#if defined(__SSE2__)
+  return _mm_or_si128(v, _mm_set1_epi8(32));
+#else
+  return vorrq_u8(v, vdupq_n_u8(32));
+#endif
+}
+
+/// \return the index of the first lane set in \p match, or kCharVecSize.
+/// If \p invert, look for the first lane which is clear instead.
+inline ptrdiff_t firstMatch(CharVec match, bool invert = false) {
+#if defined(__SSE2__)
+  unsigned bits = _mm_movemask_epi8(match);
+  if (invert)
+    bits ^= 0xffff;
+  return bits ? static_cast<ptrdiff_t>(llvm::countTrailingZeros(bits))
+              : kCharVecSize;
+#else
+  // Narrow every byte to a nibble, since NEON has no movemask.
+  uint64_t bits = vget_lane_u64(
+      vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(match), 4)), 0);
+  if (invert)
+    bits = ~bits;
+  return bits ? static_cast<ptrdiff_t>(llvm::countTrailingZeros(bits) / 4)
+              : kCharVecSize;
+#endif
+}
+
+inline const char *skipSpaces(const char *p, const char *end) {
+  for (; end - p >= kCharVecSize; p += kCharVecSize) {
+    CharVec v = loadChars(p);
+    ptrdiff_t i =
+        firstMatch(either(matchChar(v, ' '), matchChar(v, '\t')), true);
+    if (i != kCharVecSize)
+      return p + i;
+  }
+  return p;
+}
+
+inline const char *skipLineCommentChars(const char *p, const char *end) {
+  for (; end - p >= kCharVecSize; p += kCharVecSize) {
+    CharVec v = loadChars(p);
+    CharVec newLine = either(matchChar(v, '\n'), matchChar(v, '\r'));
+    ptrdiff_t i = firstMatch(
+        either(newLine, either(matchChar(v, 0), matchNonASCII(v))));
+    if (i != kCharVecSize)
+      return p + i;
+  }
+  return p;
+}
+
+inline const char *skipBlockCommentChars(const char *p, const char *end) {
+  for (; end - p >= kCharVecSize; p += kCharVecSize) {
+    CharVec v = loadChars(p);
+    CharVec newLine = either(matchChar(v, '\n'), matchChar(v, '\r'));
+    ptrdiff_t i = firstMatch(either(
+        either(newLine, matchChar(v, '*')),
+        either(matchChar(v, 0), matchNonASCII(v))));
+    if (i != kCharVecSize)
+      return p + i;
+  }
+  return p;
+}
+
+inline const char *
+skipStringChars(const char *p, const char *end, char quoteCh) {
+  for (; end - p >= kCharVecSize; p += kCharVecSize) {
+    CharVec v = loadChars(p);
+    CharVec newLine = either(matchChar(v, '\n'), matchChar(v, '\r'));
+    CharVec special = either(matchChar(v, quoteCh), matchChar(v, '\\'));
+    ptrdiff_t i = firstMatch(either(
+        either(newLine, special), either(matchChar(v, 0), matchNonASCII(v))));
+    if (i != kCharVecSize)
+      return p + i;
+  }
+  return p;
+}
+
+inline const char *skipASCIIIdentifierParts(const char *p, const char *end) {
+  for (; end - p >= kCharVecSize; p += kCharVecSize) {
+    CharVec v = loadChars(p);
+    CharVec alnum =
+        either(matchRange(toLower(v), 'a', 'z'), matchRange(v, '0', '9'));
+    ptrdiff_t i = firstMatch(
+        either(alnum, either(matchChar(v, '_'), matchChar(v, '$'))), true);
+    if (i != kCharVecSize)
+      return p + i;
+  }
+  return p;
+}
+
+#else
+
+inline const char *skipSpaces(const char *p, const char *) {
+  return p;
+}
+inline const char *skipLineCommentChars(const char *p, const char *) {
+  return p;
+}
+inline const char *skipBlockCommentChars(const char *p, const char *) {
+  return p;
+}
+inline const char *skipStringChars(const char *p, const char *, char) {
+  return p;
+}
+inline const char *skipASCIIIdentifierParts(const char *p, const char *) {
+  return p;
+}
+
+#endif // __SSE2__ || __aarch64__
+
 } // namespace
 
 const char *tokenKindStr(TokenKind kind) {
@@ -260,9 +444,9 @@ const Token *JSLexer::advance(GrammarContext grammarContext) {
       case '\t':
       case ' ':
         // Spaces frequently come in groups, so use a tight inner loop to skip.
-        do
+        curCharPtr_ = skipSpaces(curCharPtr_ + 1, bufferEnd_);
+        while (*curCharPtr_ == '\t' || *curCharPtr_ == ' ')
           ++curCharPtr_;
-        while (*curCharPtr_ == '\t' || *curCharPtr_ == ' ');
         continue;
 
       // No-break space \u00A0 is UTF8 encoded as: c2 a0
@@ -585,6 +769,101 @@ const Token *JSLexer::rescanRBraceInTemplateLiteral() {
   return &token_;
 }
 
+llvm::Optional<SMLoc> JSLexer::scanFunctionBodyEnd(bool &useStaticBuiltin) {
+  assert(token_.getKind() == TokenKind::l_brace && "need { to scan a body");
+  SourceErrorManager::SaveAndSuppressMessages suppress(&sm_);
+  UniqueString *useStaticBuiltinStr = getStringLiteral("use static builtin");
+
+  // The open braces, and whether each one is a template substitution.
+  llvm::SmallVector<bool, 16> substitution{false};
+  // Whether the current token may be in a directive prologue.
+  bool inPrologue = true;
+  GrammarContext grammarContext = AllowRegExp;
+  for (;;) {
+    TokenKind prevKind = token_.getKind();
+    UniqueString *prevIdent =
+        prevKind == TokenKind::identifier ? token_.getIdentifier() : nullptr;
+    advance(grammarContext);
+
+    switch (token_.getKind()) {
+      case TokenKind::eof:
+        return llvm::None;
+
+      case TokenKind::l_brace:
+        substitution.push_back(false);
+        break;
+      case TokenKind::template_head:
+        substitution.push_back(true);
+        break;
+      case TokenKind::r_brace:
+        if (substitution.back()) {
+          if (rescanRBraceInTemplateLiteral()->getKind() ==
+              TokenKind::template_tail)
+            substitution.pop_back();
+          break;
+        }
+        substitution.pop_back();
+        if (substitution.empty())
+          return token_.getEndLoc();
+        break;
+
+      case TokenKind::slash:
+      case TokenKind::slashequal:
+        // These were scanned as a division, but could have been a regexp.
+        if (prevKind == TokenKind::r_paren || prevKind == TokenKind::r_brace ||
+            prevKind == TokenKind::plusplus ||
+            prevKind == TokenKind::minusminus ||
+            prevKind == TokenKind::rw_yield ||
+            (prevIdent &&
+             (prevIdent->str() == "await" || prevIdent->str() == "of" ||
+              prevIdent->str() == "let" || prevIdent->str() == "async")))
+          return llvm::None;
+        break;
+
+      case TokenKind::string_literal:
+        if (inPrologue && token_.getStringLiteral() == useStaticBuiltinStr)
+          useStaticBuiltin = true;
+        break;
+
+      default:
+        break;
+    }
+
+    // Directives follow the '{' of a function, or a previous directive.
+    inPrologue = token_.getKind() == TokenKind::l_brace ||
+        (inPrologue &&
+         (token_.getKind() == TokenKind::string_literal ||
+          token_.getKind() == TokenKind::semi));
+
+    // Whether a '/' after the token is a division. After some of these it
+    // could also start a regexp, which is checked above.
+    switch (token_.getKind()) {
+      case TokenKind::identifier:
+      case TokenKind::numeric_literal:
+      case TokenKind::string_literal:
+      case TokenKind::regexp_literal:
+      case TokenKind::no_substitution_template:
+      case TokenKind::template_tail:
+      case TokenKind::r_paren:
+      case TokenKind::r_square:
+      case TokenKind::r_brace:
+      case TokenKind::plusplus:
+      case TokenKind::minusminus:
+      case TokenKind::rw_this:
+      case TokenKind::rw_super:
+      case TokenKind::rw_null:
+      case TokenKind::rw_true:
+      case TokenKind::rw_false:
+      case TokenKind::rw_yield:
+        grammarContext = AllowDiv;
+        break;
+      default:
+        grammarContext = AllowRegExp;
+        break;
+    }
+  }
+}
+
 uint32_t JSLexer::consumeUnicodeEscape() {
   assert(*curCharPtr_ == '\\');
   ++curCharPtr_;
@@ -851,6 +1130,7 @@ const char *JSLexer::skipLineComment(const char *start) {
   start += 2;
 
   for (;;) {
+    start = skipLineCommentChars(start, bufferEnd_);
     switch ((unsigned char)*start) {
       case 0:
         if (start == bufferEnd_)
@@ -895,6 +1175,7 @@ const char *JSLexer::skipBlockComment(const char *start) {
   start += 2;
 
   for (;;) {
+    start = skipBlockCommentChars(start, bufferEnd_);
     switch ((unsigned char)*start) {
       case 0:
         if (start == bufferEnd_) {
@@ -1153,14 +1434,12 @@ TokenKind JSLexer::scanReservedWord(const char *start, unsigned length) {
 }
 
 void JSLexer::scanIdentifierFastPath(const char *start) {
-  const char *end = start;
-
   // Quickly consume the ASCII identifier part.
-  char ch;
-  do
-    ch = (unsigned char)*++end;
+  const char *end = skipASCIIIdentifierParts(start + 1, bufferEnd_);
+  char ch = *end;
   while (ch == '_' || ch == '$' || ((ch | 32) >= 'a' && (ch | 32) <= 'z') ||
-         (ch >= '0' && ch <= '9'));
+         (ch >= '0' && ch <= '9'))
+    ch = *++end;
 
   // Check whether a slow part of the identifier follows.
   if (LLVM_UNLIKELY(ch == '\\')) {
@@ -1213,6 +1492,10 @@ void JSLexer::scanString() {
   tmpStorage_.clear();
 
   for (;;) {
+    const char *plainEnd = skipStringChars(curCharPtr_, bufferEnd_, quoteCh);
+    tmpStorage_.append(curCharPtr_, plainEnd);
+    curCharPtr_ = plainEnd;
+
     if (*curCharPtr_ == quoteCh) {
       ++curCharPtr_;
       break;
@@ -503,12 +503,30 @@ Optional<ESTree::BlockStatementNode *> JSParserImpl::parseFunctionBody(
     bool eagerly,
     JSLexer::GrammarContext grammarContext,
     bool parseDirectives) {
-  if (pass_ == LazyParse && !eagerly) {
+  if ((pass_ == PreParse || pass_ == LazyParse) && !eagerly) {
     auto startLoc = tok_->getStartLoc();
-    assert(preParsed_->bodyStartToEnd.count(startLoc) == 1);
-    auto endLoc = preParsed_->bodyStartToEnd[startLoc];
-    if (endLoc.getPointer() - startLoc.getPointer() >
-        PreemptiveCompilationThresholdBytes) {
+    SMLoc endLoc;
+    bool useStaticBuiltin = false;
+    auto it = preParsed_->bodyStartToEnd.find(startLoc);
+    if (it != preParsed_->bodyStartToEnd.end()) {
+      endLoc = it->second;
+    } else {
+      // The body hasn't been seen: either this is the pre-parser, or it is
+      // nested in a body the pre-parser skipped. Find its end by scanning
+      // tokens, which is much cheaper than parsing it.
+      if (auto scanned = lexer_.scanFunctionBodyEnd(useStaticBuiltin)) {
+        endLoc = *scanned;
+        preParsed_->bodyStartToEnd[startLoc] = endLoc;
+      }
+      // Return to the '{', in case the body has to be parsed after all.
+      seek(startLoc);
+    }
+    if (endLoc.isValid() &&
+        endLoc.getPointer() - startLoc.getPointer() >
+            PreemptiveCompilationThresholdBytes) {
+      // The directive can't be seen in the skipped body.
+      if (useStaticBuiltin)
+        setUseStaticBuiltin();
       lexer_.seek(endLoc);
       advance();
 
@@ -10,38 +10,244 @@
 #if HERMES_PLATFORM_UNICODE == HERMES_PLATFORM_UNICODE_ICU
 
 #include "hermes/Platform/Unicode/icu.h"
+#include "hermes/Support/UTF8.h"
+
+#include "llvm/ADT/StringMap.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
 
 #include <time.h>
 
 namespace hermes {
 namespace platform_unicode {
 
-int localeCompare(
-    llvm::ArrayRef<char16_t> left,
-    llvm::ArrayRef<char16_t> right) {
+namespace {
+
+/// The number of ASCII characters.
+constexpr unsigned kNumASCII = 128;
+
+/// A collator opened for a locale, with the order of the ASCII characters
+/// when strings made of them can be compared without calling ICU.
+struct Collator {
+  UCollator *coll{nullptr};
+
+  /// Whether strings of ASCII characters are compared with the ranks below.
+  bool asciiFastPath{false};
+  /// Whether the tertiary ranks are compared after the primary ranks.
+  bool compareTertiary{false};
+  /// The rank of the primary weight of each ASCII character, or 0 for the
+  /// characters which are ignored.
+  uint8_t primary[kNumASCII];
+  /// The rank of the tertiary weight of each ASCII character, among the
+  /// characters with the same primary weight.
+  uint8_t tertiary[kNumASCII];
+};
+
+/// \return true if the set \p set holds a string made only of ASCII
+/// characters, or an ASCII character.
+bool hasASCIIString(const USet *set) {
+  for (int32_t i = 0, e = uset_getItemCount(set); i < e; ++i) {
+    UChar32 start, end;
+    UChar str[16];
+    UErrorCode err = U_ZERO_ERROR;
+    int32_t len = uset_getItem(set, i, &start, &end, str, 16, &err);
+    if (U_FAILURE(err))
+      return true;
+    if (len == 0 ? start < (UChar32)kNumASCII
+                 : std::all_of(str, str + len, [](UChar c) {
+                     return c < kNumASCII;
+                   }))
+      return true;
+  }
+  return false;
+}
+
+/// Rank the ASCII characters of \p collator, and enable its fast path if
+/// the strings made of them compare by the collation element of each
+/// character on its own. Then the primary weights of the characters which
+/// are not ignored are compared, followed by the tertiary weights of the
+/// characters in the same position, which have the same primary weights.
+void initASCIIFastPath(Collator &collator) {
+  UCollator *coll = collator.coll;
+  UErrorCode err = U_ZERO_ERROR;
+  // Numeric collation compares sequences of digits, and the case level and
+  // shifted punctuation add levels.
+  UColAttributeValue strength = ucol_getAttribute(coll, UCOL_STRENGTH, &err);
+  if (ucol_getAttribute(coll, UCOL_NUMERIC_COLLATION, &err) != UCOL_OFF ||
+      ucol_getAttribute(coll, UCOL_CASE_LEVEL, &err) != UCOL_OFF ||
+      ucol_getAttribute(coll, UCOL_ALTERNATE_HANDLING, &err) !=
+          UCOL_NON_IGNORABLE ||
+      strength == UCOL_IDENTICAL || U_FAILURE(err))
+    return;
+
+  // Contractions and expansions map a character to several collation
+  // elements, or several characters to one.
+  USet *contractions = uset_openEmpty();
+  USet *expansions = uset_openEmpty();
+  ucol_getContractionsAndExpansions(coll, contractions, expansions, true, &err);
+  bool contextFree = U_SUCCESS(err) && !hasASCIIString(contractions) &&
+      !hasASCIIString(expansions);
+  uset_close(contractions);
+  uset_close(expansions);
+  if (!contextFree)
+    return;
+
+  auto compare = [coll](UChar a, UChar b) {
+    return ucol_strcoll(coll, &a, 1, &b, 1);
+  };
+  auto isIgnored = [coll](UChar c) {
+    return ucol_strcoll(coll, &c, 1, &c, 0) == UCOL_EQUAL;
+  };
+  UChar order[kNumASCII];
+  for (unsigned c = 0; c < kNumASCII; ++c)
+    order[c] = c;
+
+  // Rank the primary weights.
+  ucol_setStrength(coll, UCOL_PRIMARY);
+  std::stable_sort(order, order + kNumASCII, [&compare](UChar a, UChar b) {
+    return compare(a, b) == UCOL_LESS;
+  });
+  uint8_t rank = 0;
+  for (unsigned i = 0; i < kNumASCII; ++i) {
+    UChar c = order[i];
+    if (isIgnored(c)) {
+      collator.primary[c] = 0;
+      continue;
+    }
+    if (!rank || compare(order[i - 1], c) != UCOL_EQUAL)
+      ++rank;
+    collator.primary[c] = rank;
+  }
+
+  // The characters with the same primary weight must have the same secondary
+  // weight.
+  bool sameSecondary = true;
+  ucol_setStrength(coll, UCOL_SECONDARY);
+  for (unsigned i = 1; i < kNumASCII; ++i) {
+    UChar c = order[i];
+    if (collator.primary[c] &&
+        collator.primary[c] == collator.primary[order[i - 1]])
+      sameSecondary &= compare(order[i - 1], c) == UCOL_EQUAL;
+  }
+
+  // Rank the tertiary weights of the characters with the same primary weight.
+  ucol_setAttribute(coll, UCOL_STRENGTH, strength, &err);
+  for (unsigned i = 0; i < kNumASCII;) {
+    unsigned end = i + 1;
+    while (end < kNumASCII &&
+           collator.primary[order[end]] == collator.primary[order[i]])
+      ++end;
+    std::stable_sort(order + i, order + end, [&compare](UChar a, UChar b) {
+      return compare(a, b) == UCOL_LESS;
+    });
+    rank = 0;
+    for (unsigned j = i; j < end; ++j) {
+      if (!rank || compare(order[j - 1], order[j]) != UCOL_EQUAL)
+        ++rank;
+      collator.tertiary[order[j]] = rank;
+    }
+    i = end;
+  }
+
+  // The ignored characters must be ignored at every level.
+  bool ignoredEverywhere = true;
+  for (unsigned c = 0; c < kNumASCII; ++c)
+    ignoredEverywhere &= collator.primary[c] || isIgnored(c);
+
+  collator.asciiFastPath =
+      U_SUCCESS(err) && sameSecondary && ignoredEverywhere;
+  collator.compareTertiary = strength >= UCOL_TERTIARY;
+}
+
+/// Open a collator for \p locale.
+std::unique_ptr<Collator> openCollator(const char *locale) {
+  auto collator = llvm::make_unique<Collator>();
   UErrorCode err{U_ZERO_ERROR};
-  UCollator *coll = ucol_open(uloc_getDefault(), &err);
+  collator->coll = ucol_open(locale, &err);
   if (U_FAILURE(err)) {
     // Failover to root locale if we're unable to open in default locale.
     err = U_ZERO_ERROR;
-    coll = ucol_open("", &err);
+    collator->coll = ucol_open("", &err);
   }
   assert(U_SUCCESS(err) && "failed to open collator");
 
   // Normalization mode allows for strings that can be represented
   // in two different ways to compare as equal.
-  ucol_setAttribute(coll, UCOL_NORMALIZATION_MODE, UCOL_ON, &err);
+  ucol_setAttribute(collator->coll, UCOL_NORMALIZATION_MODE, UCOL_ON, &err);
   assert(U_SUCCESS(err) && "failed to set collator attribute");
 
+  initASCIIFastPath(*collator);
+  return collator;
+}
+
+/// \return the collator for the default locale. The collators are opened
+/// once for each locale and never closed, since a collator may be used by
+/// several threads to compare strings.
+const Collator &getCollator() {
+  static std::mutex *mutex = new std::mutex();
+  static auto *collators = new llvm::StringMap<std::unique_ptr<Collator>>();
+  const char *locale = uloc_getDefault();
+  std::lock_guard<std::mutex> lock(*mutex);
+  std::unique_ptr<Collator> &collator = (*collators)[locale];
+  if (!collator)
+    collator = openCollator(locale);
+  return *collator;
+}
+
+/// Compare \p left and \p right, which are made of ASCII characters, with
+/// the ranks of \p collator. See initASCIIFastPath().
+/// \return -1, 0, or 1 like localeCompare().
+int compareASCII(
+    const Collator &collator,
+    llvm::ArrayRef<char16_t> left,
+    llvm::ArrayRef<char16_t> right) {
+  const uint8_t *levels[] = {collator.primary, collator.tertiary};
+  for (unsigned level = 0; level < 2; ++level) {
+    if (level == 1 && !collator.compareTertiary)
+      break;
+    const uint8_t *ranks = levels[level];
+    size_t i = 0;
+    size_t j = 0;
+    for (;;) {
+      while (i < left.size() && !collator.primary[left[i]])
+        ++i;
+      while (j < right.size() && !collator.primary[right[j]])
+        ++j;
+      if (i == left.size() || j == right.size())
+        break;
+      uint8_t l = ranks[left[i++]];
+      uint8_t r = ranks[right[j++]];
+      if (l != r)
+        return l < r ? -1 : 1;
+    }
+    // The string with more characters which aren't ignored is greater.
+    if (i != left.size())
+      return 1;
+    if (j != right.size())
+      return -1;
+  }
+  return 0;
+}
+
+} // namespace
+
+int localeCompare(
+    llvm::ArrayRef<char16_t> left,
+    llvm::ArrayRef<char16_t> right) {
+  const Collator &collator = getCollator();
+  if (collator.asciiFastPath && isAllASCII(left.begin(), left.end()) &&
+      isAllASCII(right.begin(), right.end()))
+    return compareASCII(collator, left, right);
+
   auto result = ucol_strcoll(
-      coll,
+      collator.coll,
       (const UChar *)left.data(),
       left.size(),
       (const UChar *)right.data(),
       right.size());
 
-  ucol_close(coll);
-
   switch (result) {
     case UCOL_LESS:
       return -1;
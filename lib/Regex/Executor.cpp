@@ -8,9 +8,14 @@
 #include "hermes/Regex/Executor.h"
 #include "hermes/Regex/RegexTraits.h"
 
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/TrailingObjects.h"
 
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+
 // This file contains the machinery for executing a regexp compiled to bytecode.
 
 namespace hermes {
@@ -19,6 +24,9 @@ namespace regex {
 template <class Traits>
 struct State;
 
+template <class Traits>
+class LinearMatcher;
+
 /// The kind of error that occurred when trying to find a match.
 enum class MatchRuntimeErrorType {
   /// No error occurred.
@@ -27,6 +35,9 @@ enum class MatchRuntimeErrorType {
   /// Reached maximum stack depth while searching for match.
   MaxStackDepth,
 
+  /// Backtracking took too long, on a regex which the linear engine can run
+  /// instead.
+  LinearFallback,
 };
 
 /// An enum describing Width1 opcodes. This is the set of regex opcodes which
@@ -201,6 +212,54 @@ class Cursor {
   bool forwards_;
 };
 
+/// The states of a regex for the linear engine, which runs every way a regex
+/// may match in lockstep over the input, in the order backtracking would try
+/// them, and keeps only the first of the ways which reach the same state at
+/// the same position. Since the rest of such a way can only do what the first
+/// one does, this finds the same match as backtracking in time linear in the
+/// length of the input.
+///
+/// A state is an instruction, plus the progress through it of instructions
+/// which take several steps: the iteration of a Width1Loop, the character of
+/// a MatchNChar8, or the second half of a surrogate pair. Regexes whose
+/// matches depend on more than their state can't be run this way: those with
+/// backreferences, lookarounds, loops counting iterations of a body which
+/// isn't one character, or loops whose body may match the empty string.
+class LinearProgram {
+ public:
+  /// Number the states of the regex compiled to \p bytecode, including its
+  /// header.
+  /// \return false if the regex can't be run by the linear engine.
+  bool init(llvm::ArrayRef<uint8_t> bytecode);
+
+  /// \return the number of the first state of the instruction at \p ip.
+  uint32_t state(uint32_t ip) const {
+    assert(ip < states_.size() && "Invalid instruction");
+    return states_[ip];
+  }
+
+  /// \return the number of states.
+  uint32_t stateCount() const {
+    return stateCount_;
+  }
+
+  /// \return the state of the Width1Loop \p loop after \p iterations, where
+  /// the iterations above its minimum are all the same if it is unbounded.
+  static uint32_t loopState(const Width1LoopInsn *loop, uint32_t iterations) {
+    uint32_t min = loop->min;
+    return loop->max == UINT32_MAX && iterations > min ? min : iterations;
+  }
+
+ private:
+  /// The most states a regex may have, times its capture groups, since each
+  /// thread at a position carries its captures.
+  static constexpr uint32_t kMaxStates = 1u << 16;
+
+  /// The first state of each instruction, indexed by its offset.
+  std::vector<uint32_t> states_{};
+  uint32_t stateCount_{0};
+};
+
 /// A Context records global information about a match attempt.
 template <class Traits>
 struct Context {
@@ -327,6 +386,12 @@ struct Context {
   /// overflow error.
   static constexpr size_t kMaxBacktrackDepth = 1u << 24;
 
+  /// The number of times we will backtrack before switching to the linear
+  /// engine, if it can run the regex, is this plus the next constant times
+  /// the length of the input.
+  static constexpr uint64_t kLinearFallbackBase = 1u << 14;
+  static constexpr uint64_t kLinearFallbackPerCodeUnit = 16;
+
   /// The stream of bytecode instructions, including the header.
   llvm::ArrayRef<uint8_t> bytecodeStream_;
 
@@ -351,9 +416,22 @@ struct Context {
   /// Traits used for canonicalization.
   Traits traits_;
 
-  /// The remaining number of times we will attempt to backtrack.
-  /// This is effectively a timeout on the regexp execution.
-  uint32_t backtracksRemaining_ = kBacktrackLimit;
+  /// The linear engine runs the instructions of this context.
+  friend class LinearMatcher<Traits>;
+
+  /// The remaining number of times we will attempt to backtrack before we
+  /// try the linear engine.
+  uint32_t backtracksRemaining_;
+
+  /// The number of times we attempt to backtrack after that, if the linear
+  /// engine can't run the regex. Together with the above, this is effectively
+  /// a timeout on the regexp execution.
+  uint32_t backtracksAfterFallback_;
+
+  /// Whether we checked if the linear engine can run the regex, and the
+  /// states of the regex for it if it can.
+  bool checkedLinear_ = false;
+  LinearProgram linearProgram_;
 
   /// Whether an error occurred during the regex matching.
   MatchRuntimeErrorType error_ = MatchRuntimeErrorType::None;
@@ -372,7 +450,12 @@ struct Context {
         first_(first),
         last_(last),
         markedCount_(markedCount),
-        loopCount_(loopCount) {}
+        loopCount_(loopCount) {
+    backtracksRemaining_ = std::min<uint64_t>(
+        kBacktrackLimit,
+        kLinearFallbackBase + kLinearFallbackPerCodeUnit * (last - first));
+    backtracksAfterFallback_ = kBacktrackLimit - backtracksRemaining_;
+  }
 
   /// Run the given State \p state, by starting at its cursor and acting on its
   /// ip_ until the match succeeds or fails. If \p onlyAtStart is set, only
@@ -398,19 +481,27 @@ struct Context {
       BacktrackStack &backtrackStack);
 
   /// Add a backtrack instruction to the backtrack stack \p bts.
-  /// On overflow, set error_ to Overflow.
+  /// On overflow, set error_ to Overflow, or to LinearFallback if the linear
+  /// engine should take over.
   /// \return true on success, false if we overflow.
   bool pushBacktrack(BacktrackStack &bts, BacktrackInsn insn) {
     bts.push_back(insn);
     if (LLVM_UNLIKELY(bts.size() > kMaxBacktrackDepth) ||
         LLVM_UNLIKELY(backtracksRemaining_ == 0)) {
-      error_ = MatchRuntimeErrorType::MaxStackDepth;
-      return false;
+      if (!continueAfterOverflow(bts.size()))
+        return false;
     }
     backtracksRemaining_--;
     return true;
   }
 
+  /// Called when the backtrack stack reached the depth \p depth, over its
+  /// maximum, or we ran out of backtracks. The first time, check whether the
+  /// linear engine can run the regex, and if not grant the remaining
+  /// backtracks.
+  /// \return true if backtracking can go on, or false after setting error_.
+  bool continueAfterOverflow(size_t depth);
+
   /// Run the given Width1Loop \p insn on the given state \p s with the
   /// backtrack stack \p bts.
   /// \return true on success, false if we should backtrack.
@@ -548,6 +639,24 @@ bool matchesRightAnchor(Context<Traits> &ctx, State<Traits> &s) {
   return matchesAnchor;
 }
 
+template <class Traits>
+bool matchesWordBoundary(Context<Traits> &ctx, State<Traits> &s) {
+  const Cursor<Traits> &c = s.cursor_;
+  const auto *charPointer = c.currentPointer();
+
+  bool prevIsWordchar = false;
+  if (!c.atLeft())
+    prevIsWordchar =
+        ctx.traits_.characterHasType(charPointer[-1], CharacterClass::Words);
+
+  bool currentIsWordchar = false;
+  if (!c.atRight())
+    currentIsWordchar =
+        ctx.traits_.characterHasType(charPointer[0], CharacterClass::Words);
+
+  return prevIsWordchar != currentIsWordchar;
+}
+
 /// \return true if all chars, stored in contiguous memory after \p insn,
 /// match the chars in state \p s in the same order. Note the count of chars
 /// is given in \p insn.
@@ -667,6 +776,9 @@ bool Context<Traits>::performEnterNonGreedyLoop(
 
 template <class Traits>
 bool Context<Traits>::backtrack(BacktrackStack &bts, State<Traits> *s) {
+  // Give up once an error occurred.
+  if (LLVM_UNLIKELY(error_ != MatchRuntimeErrorType::None))
+    return false;
   while (!bts.empty()) {
     BacktrackInsn &binsn = bts.back();
     switch (binsn.op) {
@@ -731,6 +843,24 @@ bool Context<Traits>::backtrack(BacktrackStack &bts, State<Traits> *s) {
   return false;
 }
 
+template <class Traits>
+bool Context<Traits>::continueAfterOverflow(size_t depth) {
+  if (error_ != MatchRuntimeErrorType::None)
+    return false;
+  if (!checkedLinear_) {
+    checkedLinear_ = true;
+    if (linearProgram_.init(bytecodeStream_)) {
+      error_ = MatchRuntimeErrorType::LinearFallback;
+      return false;
+    }
+    backtracksRemaining_ += backtracksAfterFallback_;
+    if (depth <= kMaxBacktrackDepth && backtracksRemaining_ != 0)
+      return true;
+  }
+  error_ = MatchRuntimeErrorType::MaxStackDepth;
+  return false;
+}
+
 template <class Traits>
 template <Width1Opcode w1opcode>
 bool Context<Traits>::matchWidth1(const Insn *base, CodeUnit c) const {
@@ -901,6 +1031,822 @@ inline size_t Context<Traits>::advanceStringIndex(
   return index + 2;
 }
 
+/// What every match of a regex starts with, found by looking at its first
+/// instructions, so that a search can skip the locations where no match can
+/// start without running the regex there. It is either a literal prefix, or
+/// the set of ASCII characters the first character of a match is in.
+class StartFilter {
+ public:
+  /// Look at the instructions starting at \p insns, of a regex with the
+  /// syntax flags \p syntaxFlags.
+  StartFilter(const uint8_t *insns, constants::SyntaxFlags syntaxFlags);
+
+  /// \return whether anything is known about the start of a match.
+  bool empty() const {
+    return prefix_.empty() && !hasFirstChars_;
+  }
+
+  /// \return the first location in [\p first, \p last) where a match may
+  /// start, or \p last if there is none. The empty range at \p last can never
+  /// match, since a match consumes at least one character.
+  template <typename CodeUnit>
+  const CodeUnit *next(const CodeUnit *first, const CodeUnit *last) const;
+
+ private:
+  /// The longest literal prefix to look for.
+  static constexpr size_t kMaxPrefix = 32;
+
+  /// Add the ASCII characters matched by the bracket \p insn.
+  /// \return false if it may match a character which isn't ASCII, or the
+  /// case is ignored.
+  bool addBracket(const BracketInsn *insn);
+
+  /// \return whether \p ch is one of the ASCII first characters.
+  bool isFirstChar(char16_t ch) const {
+    return ch < 128 && firstChars_[ch];
+  }
+
+  /// The code units every match starts with.
+  llvm::SmallVector<char16_t, 8> prefix_{};
+
+  /// Otherwise, the ASCII characters every match starts with one of.
+  std::bitset<128> firstChars_{};
+  bool hasFirstChars_{false};
+
+  constants::SyntaxFlags syntaxFlags_;
+};
+
+StartFilter::StartFilter(
+    const uint8_t *insns,
+    constants::SyntaxFlags syntaxFlags)
+    : syntaxFlags_(syntaxFlags) {
+  auto addChar = [this](uint32_t ch) {
+    // Surrogates may be half of a pair which is matched as a code point.
+    if (ch >= 0x10000 || (ch >= 0xD800 && ch <= 0xDFFF) ||
+        prefix_.size() == kMaxPrefix)
+      return false;
+    prefix_.push_back(ch);
+    return true;
+  };
+  uint32_t ip = 0;
+  for (;;) {
+    const Insn *base = reinterpret_cast<const Insn *>(&insns[ip]);
+    switch (base->opcode) {
+      // Capture groups don't consume any character.
+      case Opcode::BeginMarkedSubexpression:
+        ip += sizeof(BeginMarkedSubexpressionInsn);
+        continue;
+      case Opcode::EndMarkedSubexpression:
+        ip += sizeof(EndMarkedSubexpressionInsn);
+        continue;
+
+      case Opcode::MatchChar8:
+        if (!addChar((uint8_t)llvm::cast<MatchChar8Insn>(base)->c))
+          return;
+        ip += sizeof(MatchChar8Insn);
+        continue;
+      case Opcode::MatchChar16:
+        if (!addChar(llvm::cast<MatchChar16Insn>(base)->c))
+          return;
+        ip += sizeof(MatchChar16Insn);
+        continue;
+      case Opcode::MatchNChar8: {
+        const auto *insn = llvm::cast<MatchNChar8Insn>(base);
+        auto chars = reinterpret_cast<const uint8_t *>(insn + 1);
+        for (uint8_t i = 0; i < insn->charCount; ++i) {
+          if (!addChar(chars[i]))
+            return;
+        }
+        ip += insn->totalWidth();
+        continue;
+      }
+
+      // The first character of a match may also be known from a bracket or
+      // a loop which must match at least once, but only if there is no
+      // prefix.
+      case Opcode::Bracket:
+        if (prefix_.empty())
+          hasFirstChars_ = addBracket(llvm::cast<BracketInsn>(base));
+        return;
+      case Opcode::Width1Loop: {
+        const auto *loop = llvm::cast<Width1LoopInsn>(base);
+        if (!prefix_.empty() || loop->min == 0)
+          return;
+        const Insn *body = static_cast<const Insn *>(&loop[1]);
+        if (body->opcode == Opcode::MatchChar8) {
+          addChar((uint8_t)llvm::cast<MatchChar8Insn>(body)->c);
+        } else if (body->opcode == Opcode::MatchChar16) {
+          addChar(llvm::cast<MatchChar16Insn>(body)->c);
+        } else if (body->opcode == Opcode::Bracket) {
+          hasFirstChars_ = addBracket(llvm::cast<BracketInsn>(body));
+        }
+        return;
+      }
+
+      default:
+        return;
+    }
+  }
+}
+
+bool StartFilter::addBracket(const BracketInsn *insn) {
+  // Case-insensitive brackets match characters outside of their ranges, and
+  // \s matches whitespace which isn't ASCII.
+  if (insn->negate || insn->negativeCharClasses ||
+      (insn->positiveCharClasses & CharacterClass::Spaces) ||
+      (syntaxFlags_ & constants::icase))
+    return false;
+  auto ranges = reinterpret_cast<const BracketRange32 *>(insn + 1);
+  for (uint32_t i = 0; i < insn->rangeCount; ++i) {
+    if (ranges[i].end >= 128)
+      return false;
+    for (uint32_t ch = ranges[i].start; ch <= ranges[i].end; ++ch)
+      firstChars_.set(ch);
+  }
+  for (unsigned ch = 0; ch < 128; ++ch) {
+    bool digit = ch >= '0' && ch <= '9';
+    bool word = digit || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+        ch == '_';
+    if (((insn->positiveCharClasses & CharacterClass::Digits) && digit) ||
+        ((insn->positiveCharClasses & CharacterClass::Words) && word))
+      firstChars_.set(ch);
+  }
+  return true;
+}
+
+template <typename CodeUnit>
+const CodeUnit *StartFilter::next(const CodeUnit *first, const CodeUnit *last)
+    const {
+  if (prefix_.empty()) {
+    while (first != last && !isFirstChar(*first))
+      ++first;
+    return first;
+  }
+
+  const char16_t head = prefix_[0];
+  const size_t size = prefix_.size();
+  // ASCII input can't contain the rest of the code units.
+  if (sizeof(CodeUnit) == 1 && head >= 128)
+    return last;
+  for (;;) {
+    if ((size_t)(last - first) < size)
+      return last;
+    if (sizeof(CodeUnit) == 1) {
+      first = static_cast<const CodeUnit *>(
+          std::memchr(first, head, last - first - (size - 1)));
+      if (!first)
+        return last;
+    } else {
+      first = std::find(first, last - (size - 1), head);
+      if (first == last - (size - 1))
+        return last;
+    }
+    if (std::equal(prefix_.begin() + 1, prefix_.end(), first + 1))
+      return first;
+    ++first;
+  }
+}
+
+/// \return the width of the instruction \p base, including the data which
+/// follows it.
+static uint32_t instructionWidth(const Insn *base) {
+  switch (base->opcode) {
+    case Opcode::MatchNChar8:
+      return llvm::cast<MatchNChar8Insn>(base)->totalWidth();
+    case Opcode::MatchNCharICase8:
+      return llvm::cast<MatchNCharICase8Insn>(base)->totalWidth();
+    case Opcode::Bracket:
+      return llvm::cast<BracketInsn>(base)->totalWidth();
+    case Opcode::U16Bracket:
+      return llvm::cast<U16BracketInsn>(base)->totalWidth();
+    case Opcode::Goal:
+      return sizeof(GoalInsn);
+    case Opcode::LeftAnchor:
+      return sizeof(LeftAnchorInsn);
+    case Opcode::RightAnchor:
+      return sizeof(RightAnchorInsn);
+    case Opcode::MatchAnyButNewline:
+      return sizeof(MatchAnyButNewlineInsn);
+    case Opcode::U16MatchAnyButNewline:
+      return sizeof(U16MatchAnyButNewlineInsn);
+    case Opcode::MatchChar8:
+      return sizeof(MatchChar8Insn);
+    case Opcode::MatchChar16:
+      return sizeof(MatchChar16Insn);
+    case Opcode::U16MatchChar32:
+      return sizeof(U16MatchChar32Insn);
+    case Opcode::MatchCharICase8:
+      return sizeof(MatchCharICase8Insn);
+    case Opcode::MatchCharICase16:
+      return sizeof(MatchCharICase16Insn);
+    case Opcode::U16MatchCharICase32:
+      return sizeof(U16MatchCharICase32Insn);
+    case Opcode::Alternation:
+      return sizeof(AlternationInsn);
+    case Opcode::Jump32:
+      return sizeof(Jump32Insn);
+    case Opcode::BeginMarkedSubexpression:
+      return sizeof(BeginMarkedSubexpressionInsn);
+    case Opcode::EndMarkedSubexpression:
+      return sizeof(EndMarkedSubexpressionInsn);
+    case Opcode::BackRef:
+      return sizeof(BackRefInsn);
+    case Opcode::WordBoundary:
+      return sizeof(WordBoundaryInsn);
+    case Opcode::Lookaround:
+      return sizeof(LookaroundInsn);
+    case Opcode::BeginLoop:
+      return sizeof(BeginLoopInsn);
+    case Opcode::EndLoop:
+      return sizeof(EndLoopInsn);
+    case Opcode::BeginSimpleLoop:
+      return sizeof(BeginSimpleLoopInsn);
+    case Opcode::EndSimpleLoop:
+      return sizeof(EndSimpleLoopInsn);
+    case Opcode::Width1Loop:
+      return sizeof(Width1LoopInsn);
+  }
+  llvm_unreachable("Invalid opcode");
+}
+
+bool LinearProgram::init(llvm::ArrayRef<uint8_t> bytecode) {
+  const auto *header =
+      reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data());
+  llvm::ArrayRef<uint8_t> insns = bytecode.slice(sizeof(RegexBytecodeHeader));
+  const uint64_t maxStates = kMaxStates / (header->markedCount + 1);
+  states_.assign(insns.size(), 0);
+  uint64_t count = 0;
+  for (uint32_t ip = 0; ip < insns.size();) {
+    const Insn *base = reinterpret_cast<const Insn *>(&insns[ip]);
+    uint64_t states = 1;
+    switch (base->opcode) {
+      case Opcode::BackRef:
+      case Opcode::Lookaround:
+        return false;
+
+      case Opcode::BeginLoop: {
+        // Past the first iteration, the loop must always be able to exit, and
+        // either always or never be able to iterate again, so that its state
+        // doesn't depend on the count.
+        const auto *loop = llvm::cast<BeginLoopInsn>(base);
+        if (loop->min > 1 || (loop->max > 1 && loop->max != UINT32_MAX) ||
+            !(loop->loopeeConstraints & MatchConstraintNonEmpty))
+          return false;
+        break;
+      }
+
+      case Opcode::Width1Loop: {
+        // A thread in the loop is about to run the body once more, which it
+        // may only do below the maximum.
+        const auto *loop = llvm::cast<Width1LoopInsn>(base);
+        states = loop->max == UINT32_MAX ? (uint64_t)loop->min + 1 : loop->max;
+        break;
+      }
+
+      case Opcode::MatchNChar8:
+      case Opcode::MatchNCharICase8:
+        // The layout of both instructions is the same.
+        states = std::max<uint64_t>(
+            static_cast<const MatchNChar8Insn *>(base)->charCount, 1);
+        break;
+
+      // A surrogate pair is consumed in two steps.
+      case Opcode::U16MatchAnyButNewline:
+      case Opcode::U16MatchChar32:
+      case Opcode::U16MatchCharICase32:
+      case Opcode::U16Bracket:
+        states = 2;
+        break;
+
+      default:
+        break;
+    }
+    states_[ip] = count;
+    count += states;
+    if (count > maxStates)
+      return false;
+    ip += instructionWidth(base);
+  }
+  stateCount_ = count;
+  return true;
+}
+
+/// Runs a regex with the linear engine, see LinearProgram.
+template <class Traits>
+class LinearMatcher {
+  using CodeUnit = typename Traits::CodeUnit;
+  using CodePoint = typename Traits::CodePoint;
+
+ public:
+  /// Prepare to run the regex of \p ctx, whose linear program was set up.
+  explicit LinearMatcher(Context<Traits> &ctx);
+
+  /// Search from the cursor and IP of \p s, like Context::match(), populating
+  /// \p s with the state of the match if there is one.
+  /// \return the start of the match, or nullptr if there is none.
+  const CodeUnit *match(State<Traits> *s, bool onlyAtStart);
+
+ private:
+  /// A way the regex may match, which consumes the next code unit.
+  struct Thread {
+    /// The instruction consuming the code unit.
+    uint32_t ip;
+    /// The progress through the instruction, see LinearProgram.
+    uint32_t progress;
+    /// Where the match started.
+    const CodeUnit *start;
+  };
+
+  /// The threads at a position in the order backtracking would try them, and
+  /// their captured ranges, markedCount_ per thread.
+  struct ThreadList {
+    std::vector<Thread> threads;
+    std::vector<CapturedRange> captures;
+  };
+
+  /// Work left while following the instructions from a thread, in a stack
+  /// so that the ways to go on are followed in order.
+  struct Task {
+    enum Kind : uint8_t {
+      /// Follow the instruction at ip, after arg iterations if it is a
+      /// Width1Loop.
+      Follow,
+      /// Reset the capture groups of the BeginLoop at ip, and follow its body.
+      EnterLoop,
+      /// Add a thread in the Width1Loop at ip, in its state arg.
+      AddLoopThread,
+      /// Set the captured range of group arg back to range.
+      Restore,
+    };
+    Kind kind;
+    uint32_t ip;
+    uint32_t arg;
+    CapturedRange range;
+  };
+
+  /// \return the instruction at \p ip.
+  const Insn *insn(uint32_t ip) const {
+    return reinterpret_cast<const Insn *>(&bytecode_[ip]);
+  }
+
+  /// Push a task to follow the instruction at \p ip.
+  void pushFollow(uint32_t ip) {
+    tasks_.push_back({Task::Follow, ip, 0, {}});
+  }
+
+  /// Mark the state \p state as reached at the current position.
+  /// \return false if it already was.
+  bool visit(uint32_t state) {
+    if (visited_[state] == generation_)
+      return false;
+    visited_[state] = generation_;
+    return true;
+  }
+
+  /// Add a thread at \p ip with \p progress to next_, with the match start
+  /// \p start and the current captures.
+  void pushThread(uint32_t ip, uint32_t progress, const CodeUnit *start) {
+    next_.threads.push_back({ip, progress, start});
+    next_.captures.insert(
+        next_.captures.end(), captures_.begin(), captures_.end());
+  }
+
+  /// Add a thread like pushThread(), unless its state was reached.
+  void addThread(uint32_t ip, uint32_t progress, const CodeUnit *start);
+
+  /// Follow the instructions from \p ip which don't consume input at \p pos,
+  /// with \p iterations of \p ip if it is a Width1Loop, adding a thread to
+  /// next_ for each one which does, for a match started at \p start.
+  /// \return true if the regex matched, which makes the threads after this one
+  /// irrelevant.
+  bool follow(
+      uint32_t ip,
+      uint32_t iterations,
+      const CodeUnit *pos,
+      const CodeUnit *start);
+
+  /// Add the ways to go on through the BeginLoop \p loop at \p ip, entering
+  /// its body if \p body is set and exiting it if \p exit is set.
+  void pushLoop(const BeginLoopInsn *loop, uint32_t ip, bool body, bool exit);
+
+  /// Run the thread \p t with \p captures on the code unit at \p pos.
+  /// \return true if the regex matched.
+  bool
+  step(const Thread &t, const CapturedRange *captures, const CodeUnit *pos);
+
+  /// \return whether the Width1 instruction \p insn matches \p c.
+  bool matchesWidth1(const Insn *insn, CodeUnit c) const;
+
+  Context<Traits> &ctx_;
+  const LinearProgram &program_;
+
+  /// The instructions, following the header.
+  const uint8_t *bytecode_;
+
+  /// Its cursor is used to check assertions.
+  State<Traits> state_;
+
+  /// The threads at the current position and the next one.
+  ThreadList current_{};
+  ThreadList next_{};
+
+  /// The generation in which each state was last reached. The generation
+  /// changes with the position.
+  std::vector<uint32_t> visited_;
+  uint32_t generation_{0};
+
+  /// The captured ranges of the thread being followed.
+  llvm::SmallVector<CapturedRange, 16> captures_{};
+
+  llvm::SmallVector<Task, 16> tasks_{};
+
+  /// The best match found so far, if any.
+  const CodeUnit *matchStart_{nullptr};
+  const CodeUnit *matchEnd_{nullptr};
+  llvm::SmallVector<CapturedRange, 16> matchCaptures_{};
+};
+
+template <class Traits>
+LinearMatcher<Traits>::LinearMatcher(Context<Traits> &ctx)
+    : ctx_(ctx),
+      program_(ctx.linearProgram_),
+      bytecode_(&ctx.bytecodeStream_[sizeof(RegexBytecodeHeader)]),
+      state_(
+          Cursor<Traits>(ctx.first_, ctx.first_, ctx.last_, true),
+          0 /* markedCount */,
+          0 /* loopCount */),
+      visited_(program_.stateCount(), 0) {}
+
+template <class Traits>
+void LinearMatcher<Traits>::addThread(
+    uint32_t ip,
+    uint32_t progress,
+    const CodeUnit *start) {
+  if (visit(program_.state(ip) + progress))
+    pushThread(ip, progress, start);
+}
+
+template <class Traits>
+void LinearMatcher<Traits>::pushLoop(
+    const BeginLoopInsn *loop,
+    uint32_t ip,
+    bool body,
+    bool exit) {
+  // The task pushed last is followed first.
+  if (exit && loop->greedy)
+    pushFollow(loop->notTakenTarget);
+  if (body)
+    tasks_.push_back({Task::EnterLoop, ip, 0, {}});
+  if (exit && !loop->greedy)
+    pushFollow(loop->notTakenTarget);
+}
+
+template <class Traits>
+bool LinearMatcher<Traits>::follow(
+    uint32_t ip,
+    uint32_t iterations,
+    const CodeUnit *pos,
+    const CodeUnit *start) {
+  Cursor<Traits> &c = state_.cursor_;
+  c.setCurrentPointer(pos);
+  assert(tasks_.empty() && "Tasks left from another thread");
+  tasks_.push_back({Task::Follow, ip, iterations, {}});
+  while (!tasks_.empty()) {
+    Task task = tasks_.pop_back_val();
+    switch (task.kind) {
+      case Task::Follow:
+        break;
+      case Task::EnterLoop: {
+        // Restore the capture groups after following the body.
+        const auto *loop = llvm::cast<BeginLoopInsn>(insn(task.ip));
+        for (uint32_t mexp = loop->mexpBegin; mexp != loop->mexpEnd; ++mexp) {
+          tasks_.push_back({Task::Restore, 0, mexp, captures_[mexp]});
+          captures_[mexp] = {kNotMatched, kNotMatched};
+        }
+        pushFollow(task.ip + sizeof(BeginLoopInsn));
+        continue;
+      }
+      case Task::AddLoopThread:
+        addThread(task.ip, task.arg, start);
+        continue;
+      case Task::Restore:
+        captures_[task.arg] = task.range;
+        continue;
+    }
+
+    const Insn *base = insn(task.ip);
+    if (base->opcode == Opcode::Width1Loop) {
+      const auto *loop = llvm::cast<Width1LoopInsn>(base);
+      bool exit = task.arg >= loop->min;
+      if (exit && loop->greedy)
+        pushFollow(loop->notTakenTarget);
+      if (task.arg < loop->max) {
+        tasks_.push_back(
+            {Task::AddLoopThread,
+             task.ip,
+             LinearProgram::loopState(loop, task.arg),
+             {}});
+      }
+      if (exit && !loop->greedy)
+        pushFollow(loop->notTakenTarget);
+      continue;
+    }
+    if (!visit(program_.state(task.ip)))
+      continue;
+
+    switch (base->opcode) {
+      case Opcode::Goal:
+        matchStart_ = start;
+        matchEnd_ = pos;
+        matchCaptures_ = captures_;
+        tasks_.clear();
+        return true;
+
+      // Instructions which consume input are where the threads wait for it.
+      case Opcode::MatchAnyButNewline:
+      case Opcode::U16MatchAnyButNewline:
+      case Opcode::MatchChar8:
+      case Opcode::MatchChar16:
+      case Opcode::U16MatchChar32:
+      case Opcode::MatchNChar8:
+      case Opcode::MatchNCharICase8:
+      case Opcode::MatchCharICase8:
+      case Opcode::MatchCharICase16:
+      case Opcode::U16MatchCharICase32:
+      case Opcode::Bracket:
+      case Opcode::U16Bracket:
+        pushThread(task.ip, 0, start);
+        break;
+
+      case Opcode::LeftAnchor:
+        if (matchesLeftAnchor(ctx_, state_))
+          pushFollow(task.ip + sizeof(LeftAnchorInsn));
+        break;
+
+      case Opcode::RightAnchor:
+        if (matchesRightAnchor(ctx_, state_))
+          pushFollow(task.ip + sizeof(RightAnchorInsn));
+        break;
+
+      case Opcode::WordBoundary:
+        if (matchesWordBoundary(ctx_, state_) ^
+            llvm::cast<WordBoundaryInsn>(base)->invert)
+          pushFollow(task.ip + sizeof(WordBoundaryInsn));
+        break;
+
+      case Opcode::Alternation: {
+        const auto *alt = llvm::cast<AlternationInsn>(base);
+        if (c.satisfiesConstraints(ctx_.flags_, alt->secondaryConstraints))
+          pushFollow(alt->secondaryBranch);
+        if (c.satisfiesConstraints(ctx_.flags_, alt->primaryConstraints))
+          pushFollow(task.ip + sizeof(AlternationInsn));
+        break;
+      }
+
+      case Opcode::Jump32:
+        pushFollow(llvm::cast<Jump32Insn>(base)->target);
+        break;
+
+      case Opcode::BeginMarkedSubexpression: {
+        uint16_t mexp = llvm::cast<BeginMarkedSubexpressionInsn>(base)->mexp;
+        tasks_.push_back({Task::Restore, 0, mexp - 1u, captures_[mexp - 1]});
+        captures_[mexp - 1].start = c.offsetFromLeft();
+        pushFollow(task.ip + sizeof(BeginMarkedSubexpressionInsn));
+        break;
+      }
+
+      case Opcode::EndMarkedSubexpression: {
+        uint16_t mexp = llvm::cast<EndMarkedSubexpressionInsn>(base)->mexp;
+        tasks_.push_back({Task::Restore, 0, mexp - 1u, captures_[mexp - 1]});
+        captures_[mexp - 1].end = c.offsetFromLeft();
+        pushFollow(task.ip + sizeof(EndMarkedSubexpressionInsn));
+        break;
+      }
+
+      case Opcode::BeginLoop: {
+        const auto *loop = llvm::cast<BeginLoopInsn>(base);
+        if (!c.satisfiesConstraints(ctx_.flags_, loop->loopeeConstraints)) {
+          if (loop->min == 0)
+            pushFollow(loop->notTakenTarget);
+          break;
+        }
+        pushLoop(loop, task.ip, loop->max > 0, loop->min == 0);
+        break;
+      }
+
+      case Opcode::EndLoop: {
+        // The loop body ran at least once, which is its minimum.
+        uint32_t loopIp = llvm::cast<EndLoopInsn>(base)->target;
+        const auto *loop = llvm::cast<BeginLoopInsn>(insn(loopIp));
+        pushLoop(loop, loopIp, loop->max == UINT32_MAX, true);
+        break;
+      }
+
+      case Opcode::BeginSimpleLoop: {
+        const auto *loop = llvm::cast<BeginSimpleLoopInsn>(base);
+        pushFollow(loop->notTakenTarget);
+        if (c.satisfiesConstraints(ctx_.flags_, loop->loopeeConstraints))
+          pushFollow(task.ip + sizeof(BeginSimpleLoopInsn));
+        break;
+      }
+
+      case Opcode::EndSimpleLoop: {
+        uint32_t loopIp = llvm::cast<EndSimpleLoopInsn>(base)->target;
+        const auto *loop = llvm::cast<BeginSimpleLoopInsn>(insn(loopIp));
+        pushFollow(loop->notTakenTarget);
+        pushFollow(loopIp + sizeof(BeginSimpleLoopInsn));
+        break;
+      }
+
+      case Opcode::BackRef:
+      case Opcode::Lookaround:
+      case Opcode::Width1Loop:
+        llvm_unreachable("Not run by the linear engine");
+    }
+  }
+  return false;
+}
+
+template <class Traits>
+bool LinearMatcher<Traits>::matchesWidth1(const Insn *insn, CodeUnit c)
+    const {
+  using W1 = Width1Opcode;
+  switch (static_cast<Width1Opcode>(insn->opcode)) {
+    case W1::MatchChar8:
+      return ctx_.template matchWidth1<W1::MatchChar8>(insn, c);
+    case W1::MatchChar16:
+      return ctx_.template matchWidth1<W1::MatchChar16>(insn, c);
+    case W1::MatchCharICase8:
+      return ctx_.template matchWidth1<W1::MatchCharICase8>(insn, c);
+    case W1::MatchCharICase16:
+      return ctx_.template matchWidth1<W1::MatchCharICase16>(insn, c);
+    case W1::MatchAnyButNewline:
+      return ctx_.template matchWidth1<W1::MatchAnyButNewline>(insn, c);
+    case W1::Bracket:
+      return ctx_.template matchWidth1<W1::Bracket>(insn, c);
+  }
+  llvm_unreachable("Invalid width 1 opcode");
+}
+
+template <class Traits>
+bool LinearMatcher<Traits>::step(
+    const Thread &t,
+    const CapturedRange *captures,
+    const CodeUnit *pos) {
+  captures_.assign(captures, captures + ctx_.markedCount_);
+  const Insn *base = insn(t.ip);
+  const CodeUnit ch = *pos;
+  // The instruction following the one of the thread, if it matches.
+  uint32_t nextIp;
+  switch (base->opcode) {
+    case Opcode::MatchAnyButNewline:
+    case Opcode::MatchChar8:
+    case Opcode::MatchChar16:
+    case Opcode::MatchCharICase8:
+    case Opcode::MatchCharICase16:
+    case Opcode::Bracket:
+      if (!matchesWidth1(base, ch))
+        return false;
+      nextIp = t.ip + instructionWidth(base);
+      break;
+
+    case Opcode::Width1Loop: {
+      // Run the body, and go back to the loop.
+      const auto *loop = llvm::cast<Width1LoopInsn>(base);
+      if (!matchesWidth1(static_cast<const Insn *>(&loop[1]), ch))
+        return false;
+      return follow(t.ip, t.progress + 1, pos + 1, t.start);
+    }
+
+    case Opcode::MatchNChar8:
+    case Opcode::MatchNCharICase8: {
+      // The characters follow the instruction, whose layout is the same in
+      // both cases.
+      const auto *insn = static_cast<const MatchNChar8Insn *>(base);
+      char instC = reinterpret_cast<const char *>(insn + 1)[t.progress];
+      if (ch != instC &&
+          (base->opcode == Opcode::MatchNChar8 ||
+           (char32_t)ctx_.traits_.canonicalize(
+               ch, ctx_.syntaxFlags_ & constants::unicode) !=
+               (char32_t)instC))
+        return false;
+      if (t.progress + 1u < insn->charCount) {
+        addThread(t.ip, t.progress + 1, t.start);
+        return false;
+      }
+      nextIp = t.ip + instructionWidth(base);
+      break;
+    }
+
+    case Opcode::U16MatchAnyButNewline:
+    case Opcode::U16MatchChar32:
+    case Opcode::U16MatchCharICase32:
+    case Opcode::U16Bracket: {
+      nextIp = t.ip + instructionWidth(base);
+      // The second half of a surrogate pair which matched.
+      if (t.progress == 1)
+        break;
+      Cursor<Traits> c(ctx_.first_, pos, ctx_.last_, true);
+      CodePoint cp = c.consumeUTF16();
+      bool matched = true;
+      if (const auto *insn = llvm::dyn_cast<U16MatchChar32Insn>(base)) {
+        matched = cp == (CodePoint)insn->c;
+      } else if (
+          const auto *insn = llvm::dyn_cast<U16MatchCharICase32Insn>(base)) {
+        matched = cp == (CodePoint)insn->c ||
+            ctx_.traits_.canonicalize(cp, true) == (CodePoint)insn->c;
+      } else if (const auto *insn = llvm::dyn_cast<U16BracketInsn>(base)) {
+        matched = bracketMatchesChar<Traits>(
+            ctx_,
+            insn,
+            reinterpret_cast<const BracketRange32 *>(insn + 1),
+            cp);
+      }
+      if (!matched)
+        return false;
+      if (c.currentPointer() != pos + 1) {
+        addThread(t.ip, 1, t.start);
+        return false;
+      }
+      break;
+    }
+
+    default:
+      llvm_unreachable("Thread at an instruction which consumes no input");
+  }
+  return follow(nextIp, 0, pos + 1, t.start);
+}
+
+template <class Traits>
+auto LinearMatcher<Traits>::match(State<Traits> *s, bool onlyAtStart)
+    -> const CodeUnit * {
+  const uint32_t startIp = s->ip_;
+  const CodeUnit *const startLoc = s->cursor_.currentPointer();
+  const CodeUnit *const last = ctx_.last_;
+  const uint32_t markedCount = ctx_.markedCount_;
+  // As in Context::match(), including the empty range at the end.
+  const size_t locsToCheckCount = onlyAtStart ? 1 : 1 + (last - startLoc);
+
+  llvm::Optional<StartFilter> filter;
+  if (locsToCheckCount > 1) {
+    filter.emplace(&bytecode_[startIp], ctx_.syntaxFlags_);
+    if (filter->empty())
+      filter.reset();
+  }
+
+  const CodeUnit *pos = startLoc;
+  const CodeUnit *nextStart = startLoc;
+  ++generation_;
+  for (;;) {
+    // next_ holds the threads at pos from the previous position, which all
+    // come before a match starting at pos.
+    if (!matchStart_ && pos == nextStart) {
+      captures_.assign(markedCount, {kNotMatched, kNotMatched});
+      follow(startIp, 0, pos, pos);
+      size_t nextIndex =
+          ctx_.advanceStringIndex(startLoc, pos - startLoc, locsToCheckCount);
+      nextStart = nextIndex < locsToCheckCount ? startLoc + nextIndex : nullptr;
+    }
+    std::swap(current_, next_);
+    next_.threads.clear();
+    next_.captures.clear();
+    ++generation_;
+
+    if (current_.threads.empty()) {
+      // Skip to the next location where a match may start.
+      if (matchStart_ || !nextStart)
+        break;
+      pos = nextStart;
+      if (filter) {
+        pos = filter->next(pos, last);
+        if (pos == last)
+          break;
+        nextStart = pos;
+      }
+      continue;
+    }
+    if (pos == last)
+      break;
+    for (size_t i = 0, e = current_.threads.size(); i < e; ++i) {
+      if (step(
+              current_.threads[i],
+              current_.captures.data() + i * markedCount,
+              pos))
+        break;
+    }
+    ++pos;
+  }
+
+  if (!matchStart_)
+    return nullptr;
+  std::copy(
+      matchCaptures_.begin(),
+      matchCaptures_.end(),
+      s->capturedRanges_.begin());
+  s->cursor_.setCurrentPointer(matchEnd_);
+  return matchStart_;
+}
+
 template <class Traits>
 auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
     -> const CodeUnit * {
@@ -937,8 +1883,22 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
     goto backtrackingExhausted;       \
   } while (0)
 
+  // Skip the locations where no match can start, when there are several.
+  llvm::Optional<StartFilter> filter;
+  if (locsToCheckCount > 1) {
+    filter.emplace(&bytecode[startIp], syntaxFlags_);
+    if (filter->empty())
+      filter.reset();
+  }
+
   for (size_t locIndex = 0; locIndex < locsToCheckCount;
        locIndex = advanceStringIndex(startLoc, locIndex, locsToCheckCount)) {
+    if (filter) {
+      const CodeUnit *lastLoc = startLoc + locsToCheckCount - 1;
+      locIndex = filter->next(startLoc + locIndex, lastLoc) - startLoc;
+      if (startLoc + locIndex == lastLoc)
+        break;
+    }
     const CodeUnit *potentialMatchLocation = startLoc + locIndex;
     c.setCurrentPointer(potentialMatchLocation);
     s->ip_ = startIp;
@@ -1102,20 +2062,7 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
 
         case Opcode::WordBoundary: {
           const WordBoundaryInsn *insn = llvm::cast<WordBoundaryInsn>(base);
-          const auto *charPointer = c.currentPointer();
-
-          bool prevIsWordchar = false;
-          if (!c.atLeft())
-            prevIsWordchar = traits_.characterHasType(
-                charPointer[-1], CharacterClass::Words);
-
-          bool currentIsWordchar = false;
-          if (!c.atRight())
-            currentIsWordchar =
-                traits_.characterHasType(charPointer[0], CharacterClass::Words);
-
-          bool isWordBoundary = (prevIsWordchar != currentIsWordchar);
-          if (isWordBoundary ^ insn->invert)
+          if (matchesWordBoundary(*this, *s) ^ insn->invert)
             s->ip_ += sizeof(WordBoundaryInsn);
           else
             BACKTRACK();
@@ -1254,7 +2201,6 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
                 if (!pushBacktrack(
                         backtrackStack,
                         BacktrackInsn::makeSetCaptureGroup(i, cr))) {
-                  error_ = MatchRuntimeErrorType::MaxStackDepth;
                   return nullptr;
                 }
               }
@@ -1345,7 +2291,6 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
                       backtrackStack,
                       BacktrackInsn::makeEnterNonGreedyLoop(
                           loop, loopTakenIp, loopData))) {
-                error_ = MatchRuntimeErrorType::MaxStackDepth;
                 return nullptr;
               }
               s->ip_ = loop->notTakenTarget;
@@ -1355,7 +2300,6 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
                       backtrackStack,
                       BacktrackInsn::makeSetPosition(
                           loopNotTakenIp, c.currentPointer()))) {
-                error_ = MatchRuntimeErrorType::MaxStackDepth;
                 return nullptr;
               }
               prepareToEnterLoopBody(s, loop, backtrackStack);
@@ -1408,9 +2352,10 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
         }
       }
     }
-  // The search failed at this location.
+  // The search failed at this location, or we have to give up.
   backtrackingExhausted:
-    continue;
+    if (LLVM_UNLIKELY(error_ != MatchRuntimeErrorType::None))
+      return nullptr;
   }
   // The match failed.
   return nullptr;
@@ -1458,8 +2403,16 @@ MatchRuntimeResult searchWithBytecodeImpl(
   bool onlyAtStart = (header->constraints & MatchConstraintAnchoredAtStart) ||
       (matchFlags & constants::matchOnlyAtStart);
 
+  const CharT *matchStartLoc = ctx.match(&state, onlyAtStart);
+  if (ctx.error_ == MatchRuntimeErrorType::LinearFallback) {
+    // Backtracking took too long, search again with the linear engine.
+    ctx.error_ = MatchRuntimeErrorType::None;
+    state = State<Traits>{cursor, markedCount, loopCount};
+    matchStartLoc = LinearMatcher<Traits>(ctx).match(&state, onlyAtStart);
+  }
+
   auto result = MatchRuntimeResult::NoMatch;
-  if (const CharT *matchStartLoc = ctx.match(&state, onlyAtStart)) {
+  if (matchStartLoc) {
     // Match succeeded. Return captured ranges. The first range is the total
     // match, followed by any capture groups.
     if (m != nullptr) {
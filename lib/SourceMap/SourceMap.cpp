@@ -7,10 +7,134 @@
 
 #include "hermes/SourceMap/SourceMap.h"
 
+#include "hermes/SourceMap/SourceMapParser.h"
+
+#include <cstring>
+
 using namespace hermes;
 
 namespace hermes {
 
+namespace {
+
+static_assert(
+    sizeof(SourceMap::CompactSegment) == 5 * sizeof(int32_t),
+    "CompactSegment is written to the cache as is, so it can't have padding");
+
+/// The header of a cache file, which is followed by:
+///  - the lengths of the source root and the sources, as uint32_t;
+///  - the index of the first segment of every line, and the number of
+///    segments, as uint32_t;
+///  - the segments;
+///  - the characters of the source root and the sources.
+/// Everything but the characters is 4 byte aligned without padding.
+struct CacheHeader {
+  /// 'HSMC' in host byte order, so a cache from a host of the other byte
+  /// order is rejected.
+  uint32_t magic;
+  uint32_t version;
+  uint32_t numSources;
+  uint32_t numLines;
+  uint32_t numSegments;
+};
+
+constexpr uint32_t kCacheMagic = 'H' | 'S' << 8 | 'M' << 16 | 'C' << 24;
+constexpr uint32_t kCacheVersion = 1;
+
+template <typename T>
+void writeArray(llvm::raw_ostream &OS, llvm::ArrayRef<T> array) {
+  OS.write(
+      reinterpret_cast<const char *>(array.data()), array.size() * sizeof(T));
+}
+
+} // namespace
+
+SourceMap::Segment SourceMap::CompactSegment::toSegment() const {
+  Segment segment;
+  segment.generatedColumn = generatedColumn;
+  if (sourceIndex >= 0) {
+    segment.representedLocation =
+        Segment::SourceLocation(sourceIndex, lineIndex, columnIndex);
+    if (nameIndex >= 0) {
+      segment.representedLocation->nameIndex = nameIndex;
+    }
+  }
+  return segment;
+}
+
+SourceMap::SourceMap(
+    const std::string &sourceRoot,
+    std::vector<std::string> &&sources,
+    std::vector<SegmentList> &&lines,
+    MetadataList &&sourcesMetadata)
+    : sourceRoot_(sourceRoot),
+      sources_(std::move(sources)),
+      numLines_(lines.size()),
+      sourcesMetadata_(std::move(sourcesMetadata)) {
+  ownedLineStarts_.reserve(lines.size() + 1);
+  for (const SegmentList &line : lines) {
+    ownedLineStarts_.push_back(ownedSegments_.size());
+    for (const Segment &seg : line) {
+      CompactSegment compact{seg.generatedColumn, -1, -1, -1, -1};
+      if (seg.representedLocation.hasValue()) {
+        compact.sourceIndex = seg.representedLocation->sourceIndex;
+        compact.lineIndex = seg.representedLocation->lineIndex;
+        compact.columnIndex = seg.representedLocation->columnIndex;
+        compact.nameIndex = seg.representedLocation->nameIndex.getValueOr(-1);
+      }
+      ownedSegments_.push_back(compact);
+    }
+  }
+  ownedLineStarts_.push_back(ownedSegments_.size());
+  segments_ = ownedSegments_;
+  lineStarts_ = ownedLineStarts_;
+}
+
+SourceMap::SourceMap(
+    const std::string &sourceRoot,
+    std::vector<std::string> &&sources,
+    std::string &&mappings,
+    std::vector<LineState> &&lineStates,
+    MetadataList &&sourcesMetadata)
+    : sourceRoot_(sourceRoot),
+      sources_(std::move(sources)),
+      numLines_(lineStates.size()),
+      mappings_(std::move(mappings)),
+      lineStates_(std::move(lineStates)),
+      sourcesMetadata_(std::move(sourcesMetadata)) {
+  decodedLines_.resize(numLines_);
+}
+
+llvm::ArrayRef<SourceMap::CompactSegment> SourceMap::getLine(
+    uint32_t lineIndex) const {
+  assert(lineIndex < numLines_ && "lineIndex out of range");
+  if (!lineStarts_.empty()) {
+    return segments_.slice(
+        lineStarts_[lineIndex],
+        lineStarts_[lineIndex + 1] - lineStarts_[lineIndex]);
+  }
+
+  std::lock_guard<std::mutex> lock(decodeMutex_);
+  std::unique_ptr<std::vector<CompactSegment>> &decoded =
+      decodedLines_[lineIndex];
+  if (!decoded) {
+    const LineState &lineState = lineStates_[lineIndex];
+    SourceMapParser::State state;
+    state.sourceIndex = lineState.sourceIndex;
+    state.representedLine = lineState.lineIndex;
+    state.representedColumn = lineState.columnIndex;
+    state.nameIndex = lineState.nameIndex;
+    llvm::StringRef line =
+        llvm::StringRef(mappings_).substr(lineState.offset).split(';').first;
+    decoded = llvm::make_unique<std::vector<CompactSegment>>();
+    bool succeed = SourceMapParser::parseLine(line, state, decoded.get());
+    (void)succeed;
+    assert(succeed && "the parser should have validated the mappings");
+  }
+  // The decoded line is never changed again, so it can be read unlocked.
+  return *decoded;
+}
+
 llvm::Optional<SourceMapTextLocation> SourceMap::getLocationForAddress(
     uint32_t line,
     uint32_t column) const {
@@ -19,10 +143,11 @@ llvm::Optional<SourceMapTextLocation> SourceMap::getLocationForAddress(
   if (!seg.hasValue() || !seg->representedLocation.hasValue()) {
     return llvm::None;
   }
-  // parseSegment() should have validated this.
-  assert(
-      (size_t)seg->representedLocation->sourceIndex < sources_.size() &&
-      "SourceIndex is out-of-range.");
+  // The parser doesn't check the index against the sources, and a cache file
+  // may have been corrupted, so check it here.
+  if ((size_t)seg->representedLocation->sourceIndex >= sources_.size()) {
+    return llvm::None;
+  }
   std::string fileName =
       getSourceFullPath(seg->representedLocation->sourceIndex);
   return SourceMapTextLocation{
@@ -34,13 +159,13 @@ llvm::Optional<SourceMapTextLocation> SourceMap::getLocationForAddress(
 llvm::Optional<SourceMap::Segment> SourceMap::getSegmentForAddress(
     uint32_t line,
     uint32_t column) const {
-  if (line == 0 || line > lines_.size()) {
+  if (line == 0 || line > numLines_) {
     return llvm::None;
   }
 
   // line is 1-based.
   uint32_t lineIndex = line - 1;
-  auto &segments = lines_[lineIndex];
+  llvm::ArrayRef<CompactSegment> segments = getLine(lineIndex);
   if (segments.empty()) {
     return llvm::None;
   }
@@ -55,7 +180,7 @@ llvm::Optional<SourceMap::Segment> SourceMap::getSegmentForAddress(
       segments.begin(),
       segments.end(),
       columnIndex,
-      [](uint32_t column, const Segment &seg) {
+      [](uint32_t column, const CompactSegment &seg) {
         return column < (uint32_t)seg.generatedColumn;
       });
   // The found sentinel segment is the first one. No covering segment.
@@ -63,9 +188,107 @@ llvm::Optional<SourceMap::Segment> SourceMap::getSegmentForAddress(
     return llvm::None;
   }
   // Move back one slot.
-  const Segment &target =
+  const CompactSegment &target =
       segIter == segments.end() ? segments.back() : *(--segIter);
-  return target;
+  return target.toSegment();
+}
+
+void SourceMap::writeCache(llvm::raw_ostream &OS) const {
+  std::vector<uint32_t> stringLengths;
+  stringLengths.push_back(sourceRoot_.size());
+  for (const std::string &source : sources_) {
+    stringLengths.push_back(source.size());
+  }
+
+  std::vector<uint32_t> lineStarts;
+  std::vector<CompactSegment> segments;
+  for (uint32_t i = 0; i < numLines_; ++i) {
+    lineStarts.push_back(segments.size());
+    llvm::ArrayRef<CompactSegment> line = getLine(i);
+    segments.insert(segments.end(), line.begin(), line.end());
+  }
+  lineStarts.push_back(segments.size());
+
+  CacheHeader header{kCacheMagic,
+                     kCacheVersion,
+                     (uint32_t)sources_.size(),
+                     numLines_,
+                     (uint32_t)segments.size()};
+  OS.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  writeArray<uint32_t>(OS, stringLengths);
+  writeArray<uint32_t>(OS, lineStarts);
+  writeArray<CompactSegment>(OS, segments);
+  OS << sourceRoot_;
+  for (const std::string &source : sources_) {
+    OS << source;
+  }
+}
+
+std::unique_ptr<SourceMap> SourceMap::loadCache(
+    std::unique_ptr<llvm::MemoryBuffer> buffer) {
+  const char *data = buffer->getBufferStart();
+  size_t size = buffer->getBufferSize();
+  // The arrays are used in place, so they have to be aligned.
+  if (reinterpret_cast<uintptr_t>(data) % alignof(uint32_t) != 0 ||
+      size < sizeof(CacheHeader)) {
+    return nullptr;
+  }
+  CacheHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != kCacheMagic || header.version != kCacheVersion) {
+    return nullptr;
+  }
+
+  // Compute the sizes in 64 bits so a corrupt header can't overflow them.
+  uint64_t arraysSize = sizeof(CacheHeader) +
+      ((uint64_t)header.numSources + 1 + header.numLines + 1) *
+          sizeof(uint32_t) +
+      (uint64_t)header.numSegments * sizeof(CompactSegment);
+  if (arraysSize > size) {
+    return nullptr;
+  }
+  llvm::ArrayRef<uint32_t> stringLengths(
+      reinterpret_cast<const uint32_t *>(data + sizeof(CacheHeader)),
+      header.numSources + 1);
+  llvm::ArrayRef<uint32_t> lineStarts(
+      stringLengths.end(), header.numLines + 1);
+  llvm::ArrayRef<CompactSegment> segments(
+      reinterpret_cast<const CompactSegment *>(lineStarts.end()),
+      header.numSegments);
+
+  // Check the line starts, so that lookups can't go out of the segments.
+  if (lineStarts.front() != 0 || lineStarts.back() != header.numSegments) {
+    return nullptr;
+  }
+  for (uint32_t i = 0; i < header.numLines; ++i) {
+    if (lineStarts[i] > lineStarts[i + 1]) {
+      return nullptr;
+    }
+  }
+
+  uint64_t stringsSize = 0;
+  for (uint32_t length : stringLengths) {
+    stringsSize += length;
+  }
+  if (arraysSize + stringsSize != size) {
+    return nullptr;
+  }
+  const char *str = data + arraysSize;
+  std::string sourceRoot(str, stringLengths[0]);
+  str += stringLengths[0];
+  std::vector<std::string> sources;
+  for (uint32_t length : stringLengths.drop_front()) {
+    sources.emplace_back(str, length);
+    str += length;
+  }
+
+  std::unique_ptr<SourceMap> sourceMap{new SourceMap(
+      sourceRoot, std::move(sources), std::vector<SegmentList>{}, {})};
+  sourceMap->numLines_ = header.numLines;
+  sourceMap->segments_ = segments;
+  sourceMap->lineStarts_ = lineStarts;
+  sourceMap->cacheBuffer_ = std::move(buffer);
+  return sourceMap;
 }
 
 } // namespace hermes
@@ -42,6 +42,122 @@ uint32_t SourceMapGenerator::addSource(
   return index;
 }
 
+void SourceMapGenerator::addMappingsLine(
+    SourceMap::SegmentList line,
+    uint32_t cjsModuleOffset) {
+  assert(
+      cjsModuleOffset >= numEncodedLines_ &&
+      !pendingLines_.count(cjsModuleOffset) && "line was already added");
+  if (lineSizes_.size() <= cjsModuleOffset) {
+    lineSizes_.resize(cjsModuleOffset + 1);
+  }
+  lineSizes_[cjsModuleOffset] = line.size();
+  if (cjsModuleOffset != numEncodedLines_) {
+    pendingLines_.emplace(cjsModuleOffset, std::move(line));
+    return;
+  }
+  encodeLine(line);
+  // The line may have been the one the next pending lines were waiting for.
+  while (!pendingLines_.empty() &&
+         pendingLines_.begin()->first == numEncodedLines_) {
+    encodeLine(pendingLines_.begin()->second);
+    pendingLines_.erase(pendingLines_.begin());
+  }
+}
+
+void SourceMapGenerator::setInputSourceMaps(
+    std::vector<std::unique_ptr<SourceMap>> maps) {
+  assert(
+      lineSizes_.empty() &&
+      "input source maps must be set before adding mappings lines");
+  inputSourceMaps_ = std::move(maps);
+  if (!inputSourceMaps_.empty()) {
+    merged_ = llvm::make_unique<SourceMapGenerator>();
+  }
+}
+
+void SourceMapGenerator::encodeLine(const SourceMap::SegmentList &line) {
+  if (merged_) {
+    SourceMap::SegmentList newLine;
+    newLine.reserve(line.size());
+    for (const SourceMap::Segment &seg : line) {
+      SourceMap::Segment newSeg = seg;
+      if (seg.representedLocation.hasValue()) {
+        newSeg.representedLocation =
+            translateLocation(*seg.representedLocation);
+      }
+      newLine.push_back(newSeg);
+    }
+    merged_->addMappingsLine(std::move(newLine), numEncodedLines_++);
+    return;
+  }
+
+  llvm::raw_string_ostream OS(mappings_);
+  // The generated column (unlike other fields) resets with each new line.
+  state_.generatedColumn = 0;
+  state_ = encodeSourceLocations(state_, line, OS);
+  OS << ';';
+  ++numEncodedLines_;
+}
+
+void SourceMapGenerator::flushPendingLines() {
+  for (auto &entry : pendingLines_) {
+    while (numEncodedLines_ < entry.first) {
+      encodeLine({});
+    }
+    encodeLine(entry.second);
+  }
+  pendingLines_.clear();
+}
+
+SourceMap::Segment::SourceLocation SourceMapGenerator::translateLocation(
+    const SourceMap::Segment::SourceLocation &loc) {
+  assert(loc.sourceIndex >= 0 && "Negative source index");
+  auto key = std::make_pair(
+      (uint32_t)loc.sourceIndex,
+      (uint64_t)(uint32_t)loc.lineIndex << 32 | (uint32_t)loc.columnIndex);
+  auto it = mergedLocations_.find(key);
+  if (it == mergedLocations_.end()) {
+    MergedLocation merged{loc, false};
+    SourceMap::Segment seg;
+    seg.representedLocation = loc;
+    if (auto pair = getInputSegmentForSegment(seg)) {
+      // We have an input source map and were able to find a merged source
+      // location.
+      auto inputSeg = pair->first;
+      auto inputMap = pair->second;
+      if (inputSeg.representedLocation.hasValue()) {
+        auto inputLoc = inputSeg.representedLocation.getValue();
+        // Our _output_ sourceRoot is empty, so make sure to canonicalize
+        // the path based on the input map's sourceRoot.
+        std::string filename =
+            inputMap->getSourceFullPath(inputLoc.sourceIndex);
+        merged.loc = SourceMap::Segment::SourceLocation(
+            merged_->addSource(
+                filename, inputMap->getSourceMetadata(inputLoc.sourceIndex)),
+            inputLoc.lineIndex,
+            inputLoc.columnIndex
+            // TODO: Handle name index
+        );
+        merged.mapped = true;
+      }
+    }
+    if (!merged.mapped) {
+      // Failed to find a merge location. Use the existing location,
+      // but copy over the source file name.
+      merged.loc.sourceIndex = merged_->addSource(
+          filenameTable_[loc.sourceIndex], getSourceMetadata(loc.sourceIndex));
+    }
+    it = mergedLocations_.insert({key, merged}).first;
+  }
+
+  SourceMap::Segment::SourceLocation result = it->second.loc;
+  // The key doesn't include the name, which is only kept if the location
+  // wasn't mapped.
+  result.nameIndex = it->second.mapped ? llvm::None : loc.nameIndex;
+  return result;
+}
+
 llvm::Optional<std::pair<SourceMap::Segment, const SourceMap *>>
 SourceMapGenerator::getInputSegmentForSegment(
     const SourceMap::Segment &seg) const {
@@ -114,88 +230,20 @@ SourceMapGenerator::State SourceMapGenerator::encodeSourceLocations(
   return prevState;
 }
 
-std::string SourceMapGenerator::getVLQMappingsString() const {
-  std::string result;
-  llvm::raw_string_ostream OS(result);
-  State state;
-  for (const SourceMap::SegmentList &segments : lines_) {
-    // The generated column (unlike other fields) resets with each new line.
-    state.generatedColumn = 0;
-    state = encodeSourceLocations(state, segments, OS);
-    OS << ';';
-  }
-  OS.flush();
-  return result;
-}
-
 std::vector<llvm::StringRef> SourceMapGenerator::getSources() const {
   return std::vector<llvm::StringRef>(
       filenameTable_.begin(), filenameTable_.end());
 }
 
-SourceMapGenerator SourceMapGenerator::mergedWithInputSourceMaps() const {
-  assert(
-      !inputSourceMaps_.empty() &&
-      "Cannot merge source maps without input source maps");
-
-  auto sources = getSources();
-
-  // Create a new SourceMapGenerator with the merged data.
-  SourceMapGenerator merged;
-
-  for (uint32_t i = 0, e = lines_.size(); i < e; ++i) {
-    SourceMap::SegmentList newLine{};
-
-    for (const auto &seg : lines_[i]) {
-      SourceMap::Segment newSeg = seg;
-      newSeg.representedLocation = llvm::None;
-
-      if (auto pair = getInputSegmentForSegment(seg)) {
-        // We have an input source map and were able to find a merged source
-        // location.
-        auto inputSeg = pair->first;
-        auto inputMap = pair->second;
-        if (inputSeg.representedLocation.hasValue()) {
-          auto loc = inputSeg.representedLocation.getValue();
-          // Our _output_ sourceRoot is empty, so make sure to canonicalize
-          // the path based on the input map's sourceRoot.
-          std::string filename = inputMap->getSourceFullPath(loc.sourceIndex);
-
-          newSeg.representedLocation = SourceMap::Segment::SourceLocation(
-              merged.addSource(
-                  filename, inputMap->getSourceMetadata(loc.sourceIndex)),
-              loc.lineIndex,
-              loc.columnIndex
-              // TODO: Handle name index
-          );
-        }
-      }
-      if (!newSeg.representedLocation.hasValue() &&
-          seg.representedLocation.hasValue()) {
-        // Failed to find a merge location. Use the existing location,
-        // but copy over the source file name.
-        newSeg.representedLocation = seg.representedLocation;
-        newSeg.representedLocation->sourceIndex = merged.addSource(
-            sources[seg.representedLocation->sourceIndex],
-            getSourceMetadata(seg.representedLocation->sourceIndex));
-      }
-
-      newLine.push_back(std::move(newSeg));
-    }
-
-    merged.addMappingsLine(std::move(newLine), i);
-  }
-  merged.functionOffsets_ = functionOffsets_;
-  return merged;
-}
-
-void SourceMapGenerator::outputAsJSON(llvm::raw_ostream &OS) const {
-  if (inputSourceMaps_.empty()) {
+void SourceMapGenerator::outputAsJSON(llvm::raw_ostream &OS) {
+  flushPendingLines();
+  if (!merged_) {
     this->outputAsJSONImpl(OS);
   } else {
-    // If there are input source maps, we must merge them into a new
-    // SourceMapGenerator before output.
-    mergedWithInputSourceMaps().outputAsJSONImpl(OS);
+    // If there are input source maps, the lines were translated into merged_
+    // as they were encoded.
+    merged_->functionOffsets_ = functionOffsets_;
+    merged_->outputAsJSONImpl(OS);
   }
 }
 
@@ -222,7 +270,7 @@ void SourceMapGenerator::outputAsJSONImpl(llvm::raw_ostream &OS) const {
     json.closeArray();
   }
 
-  json.emitKeyValue("mappings", getVLQMappingsString());
+  json.emitKeyValue("mappings", mappings_);
 
   if (!functionOffsets_.empty()) {
     json.emitKey("x_hermes_function_offsets");
@@ -87,7 +87,7 @@ std::unique_ptr<SourceMap> SourceMapParser::parse(
     return nullptr;
   }
 
-  std::vector<SourceMap::SegmentList> lines;
+  std::vector<SourceMap::LineState> lines;
   bool succeed = parseMappings(mappings->str(), lines);
   if (!succeed) {
     return nullptr;
@@ -95,76 +95,93 @@ std::unique_ptr<SourceMap> SourceMapParser::parse(
   return llvm::make_unique<SourceMap>(
       sourceRoot,
       std::move(sources),
+      mappings->str().str(),
       std::move(lines),
       std::move(sourcesMetadata));
 }
 
 bool SourceMapParser::parseMappings(
     llvm::StringRef sourceMappings,
-    std::vector<SourceMap::SegmentList> &lines) {
+    std::vector<SourceMap::LineState> &lines) {
   assert(lines.empty() && "lines is an out parameter so should be empty");
-  SourceMap::SegmentList segments;
   State state;
 
-  uint32_t curSegOffset = 0;
-  while (curSegOffset < sourceMappings.size()) {
+  size_t curLineOffset = 0;
+  while (curLineOffset < sourceMappings.size()) {
     // Source map mappings may omit ";" for the last line.
-    auto endSegOffset = sourceMappings.find_first_of(",;", curSegOffset);
-    if (endSegOffset == llvm::StringLiteral::npos) {
-      endSegOffset = sourceMappings.size();
+    size_t endLineOffset = sourceMappings.find(';', curLineOffset);
+    if (endLineOffset == llvm::StringRef::npos) {
+      endLineOffset = sourceMappings.size();
     }
-    assert(
-        endSegOffset <= sourceMappings.size() &&
-        "endSegOffset cannot exceed sourceMappings size");
-    bool lastSegmentInLine = endSegOffset == sourceMappings.size() ||
-        sourceMappings[endSegOffset] == ';';
-
-    const char *pCur = sourceMappings.data() + curSegOffset;
-    const char *pSegEnd = sourceMappings.data() + endSegOffset;
-
-    if (pCur == pSegEnd && lastSegmentInLine && segments.empty()) {
-      // The line is empty, so avoid doing any extra work.
-      lines.emplace_back(std::move(segments));
-    } else {
-      llvm::Optional<SourceMap::Segment> segmentOpt =
-          parseSegment(state, pCur, pSegEnd);
-      if (!segmentOpt.hasValue()) {
-        return false;
-      }
 
-      state.generatedColumn = segmentOpt->generatedColumn;
-      if (segmentOpt->representedLocation.hasValue()) {
-        state.sourceIndex = segmentOpt->representedLocation->sourceIndex;
-        state.representedLine = segmentOpt->representedLocation->lineIndex;
-        state.representedColumn = segmentOpt->representedLocation->columnIndex;
+    SourceMap::LineState lineState;
+    lineState.offset = curLineOffset;
+    lineState.sourceIndex = state.sourceIndex;
+    lineState.lineIndex = state.representedLine;
+    lineState.columnIndex = state.representedColumn;
+    lineState.nameIndex = state.nameIndex;
+    lines.push_back(lineState);
+
+    // Only decode the line to find the state at its end. The segments are
+    // decoded again if the line is looked up.
+    if (!parseLine(
+            sourceMappings.slice(curLineOffset, endLineOffset),
+            state,
+            nullptr)) {
+      return false;
+    }
+    curLineOffset = endLineOffset + 1;
+  }
+  return true;
+}
 
-        if (segmentOpt->representedLocation->nameIndex.hasValue()) {
-          state.nameIndex =
-              segmentOpt->representedLocation->nameIndex.getValue();
-        }
-      }
+bool SourceMapParser::parseLine(
+    llvm::StringRef line,
+    State &state,
+    std::vector<SourceMap::CompactSegment> *segments) {
+  // generated column should be reset for new line.
+  state.generatedColumn = 0;
+  if (line.empty()) {
+    // The line is empty, so avoid doing any extra work.
+    return true;
+  }
 
-      segments.emplace_back(segmentOpt.getValue());
+  const char *pCur = line.begin();
+  for (;;) {
+    const char *pSegEnd = std::find(pCur, line.end(), ',');
+    llvm::Optional<SourceMap::CompactSegment> segmentOpt =
+        parseSegment(state, pCur, pSegEnd);
+    if (!segmentOpt.hasValue()) {
+      return false;
+    }
 
-      // TODO: assert pCur equals to pSegEnd.
+    state.generatedColumn = segmentOpt->generatedColumn;
+    if (segmentOpt->sourceIndex >= 0) {
+      state.sourceIndex = segmentOpt->sourceIndex;
+      state.representedLine = segmentOpt->lineIndex;
+      state.representedColumn = segmentOpt->columnIndex;
+      if (segmentOpt->nameIndex >= 0) {
+        state.nameIndex = segmentOpt->nameIndex;
+      }
+    }
+    if (segments) {
+      segments->push_back(*segmentOpt);
+    }
 
-      if (lastSegmentInLine) {
-        // generated column should be reset for new line.
-        state.generatedColumn = 0;
+    // TODO: assert pCur equals to pSegEnd.
 
-        lines.emplace_back(std::move(segments));
-      }
+    if (pSegEnd == line.end()) {
+      return true;
     }
-    curSegOffset = endSegOffset + 1;
+    pCur = pSegEnd + 1;
   }
-  return true;
 }
 
-llvm::Optional<SourceMap::Segment> SourceMapParser::parseSegment(
+llvm::Optional<SourceMap::CompactSegment> SourceMapParser::parseSegment(
     const SourceMapParser::State &state,
     const char *&pCur,
     const char *pSegEnd) {
-  SourceMap::Segment segment;
+  SourceMap::CompactSegment segment{-1, -1, -1, -1, -1};
 
   // Parse 1st field: generatedColumn.
   OptValue<int32_t> val = base64vlq::decode(pCur, pSegEnd);
@@ -178,8 +195,11 @@ llvm::Optional<SourceMap::Segment> SourceMapParser::parseSegment(
   if (!val.hasValue()) {
     return segment;
   }
-  segment.representedLocation = SourceMap::Segment::SourceLocation();
-  segment.representedLocation->sourceIndex = state.sourceIndex + val.getValue();
+  segment.sourceIndex = state.sourceIndex + val.getValue();
+  // Negative indices are invalid, and -1 marks an absent field.
+  if (segment.sourceIndex < 0) {
+    return llvm::None;
+  }
 
   // Parse 3rd field: representedLine.
   val = base64vlq::decode(pCur, pSegEnd);
@@ -187,8 +207,7 @@ llvm::Optional<SourceMap::Segment> SourceMapParser::parseSegment(
     // Segment can only be 1, 4 or 5 length.
     return llvm::None;
   }
-  segment.representedLocation->lineIndex =
-      state.representedLine + val.getValue();
+  segment.lineIndex = state.representedLine + val.getValue();
 
   // Parse 4th field: representedColumn.
   val = base64vlq::decode(pCur, pSegEnd);
@@ -196,15 +215,17 @@ llvm::Optional<SourceMap::Segment> SourceMapParser::parseSegment(
     // Segment can only be 1, 4 or 5 length.
     return llvm::None;
   }
-  segment.representedLocation->columnIndex =
-      state.representedColumn + val.getValue();
+  segment.columnIndex = state.representedColumn + val.getValue();
 
   // Parse 5th field: nameIndex.
   val = base64vlq::decode(pCur, pSegEnd);
   if (!val.hasValue()) {
     return segment;
   }
-  segment.representedLocation->nameIndex = state.nameIndex + val.getValue();
+  segment.nameIndex = state.nameIndex + val.getValue();
+  if (segment.nameIndex < 0) {
+    return llvm::None;
+  }
 
   return segment;
 }
@@ -21,6 +21,7 @@ void *BacktrackingBumpPtrAllocator::allocateNewSlab(
   state_->offset = 0;
   if (state_->slab == slabs_.size()) {
     slabs_.push_back(llvm::make_unique<Slab>());
+    updatePeakBytes();
   }
   auto currentSlab =
       reinterpret_cast<uintptr_t>(&slabs_[state_->slab].get()->data);
@@ -7,6 +7,8 @@
 
 #include "hermes/Support/Conversions.h"
 
+#include "hermes/Support/FastDtoa.h"
+
 #include "dtoa/dtoa.h"
 
 #include <cmath>
@@ -59,7 +61,6 @@ int32_t truncateToInt32SlowPath(double d) {
 size_t numberToString(double m, char *dest, size_t destSize) {
   assert(destSize >= NUMBER_TO_STRING_BUF_SIZE);
   (void)destSize;
-  DtoaAllocator<> dalloc{};
 
   if (std::isnan(m)) {
     strcpy(dest, "NaN");
@@ -80,29 +81,51 @@ size_t numberToString(double m, char *dest, size_t destSize) {
     return 9;
   }
 
-  // After special cases, run dtoa to convert.
-  // We do this manually because we need all of the output of dtoa.
+  // After special cases, find the shortest digits of the number.
   // Note that n, k, s are defined per ES5.1 9.8.1
 
   // Iterator for easier population.
   char *destPtr = dest;
 
-  // Decimal point index.
-  int n;
-
-  // 1 if negative, 0 else.
-  int sign;
+  if (m < 0) {
+    *destPtr++ = '-';
+    m = -m;
+  }
 
-  // Points to the end of the string s after it's populated.
-  char *sEnd;
+  // The digits, without trailing zeros.
+  char s[NUMBER_TO_STRING_BUF_SIZE];
 
-  char *s = ::g_dtoa(dalloc, m, 0, 0, &n, &sign, &sEnd);
+  // Length of decimal representation of s.
+  int k;
 
-  if (sign)
-    *destPtr++ = '-';
+  // Decimal point index.
+  int n;
 
-  // Length of decimal representation of s.
-  int k = sEnd - s;
+  if (m < 9007199254740992.0 && m == static_cast<uint64_t>(m)) {
+    // Integers below 2^53 are exact, so their digits are the shortest ones.
+    uint64_t intVal = static_cast<uint64_t>(m);
+    int zeros = 0;
+    for (; intVal % 10 == 0; intVal /= 10)
+      ++zeros;
+    char *p = s + sizeof(s);
+    do {
+      *--p = '0' + intVal % 10;
+      intVal /= 10;
+    } while (intVal);
+    k = s + sizeof(s) - p;
+    memmove(s, p, k);
+    n = k + zeros;
+  } else if (!(k = fastShortestDtoa(m, s, &n))) {
+    // Grisu3 couldn't prove its digits were the shortest, run dtoa.
+    DtoaAllocator<> dalloc{};
+    int sign;
+    // Points to the end of the digits after they are populated.
+    char *sEnd;
+    char *digits = ::g_dtoa(dalloc, m, 0, 0, &n, &sign, &sEnd);
+    k = sEnd - digits;
+    memcpy(s, digits, k);
+    g_freedtoa(dalloc, digits);
+  }
 
   if (k <= n && n <= 21) {
     // Step 6 of 9.8.1.
@@ -163,7 +186,6 @@ size_t numberToString(double m, char *dest, size_t destSize) {
   *destPtr++ = '\0';
   assert(static_cast<size_t>(destPtr - dest) < NUMBER_TO_STRING_BUF_SIZE);
 
-  g_freedtoa(dalloc, s);
   return destPtr - dest - 1;
 }
 } // namespace hermes
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/FastDtoa.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace hermes {
+
+namespace {
+
+/// A floating point number f * 2^e with a 64-bit significand and no
+/// implicit bit.
+struct DiyFp {
+  uint64_t f;
+  int e;
+
+  /// \return the upper 64 bits of the product of the significands, rounded,
+  /// with the matching exponent.
+  DiyFp operator*(const DiyFp &other) const {
+    const uint64_t kM32 = 0xFFFFFFFFu;
+    uint64_t a = f >> 32;
+    uint64_t b = f & kM32;
+    uint64_t c = other.f >> 32;
+    uint64_t d = other.f & kM32;
+    uint64_t ac = a * c;
+    uint64_t bc = b * c;
+    uint64_t ad = a * d;
+    uint64_t bd = b * d;
+    // Add 2^31 to round the discarded lower half.
+    uint64_t tmp = (bd >> 32) + (ad & kM32) + (bc & kM32) + (1u << 31);
+    return {ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), e + other.e + 64};
+  }
+
+  /// \return this number shifted left until its top bit is set.
+  DiyFp normalize() const {
+    assert(f != 0 && "cannot normalize zero");
+    DiyFp res = *this;
+    while (!(res.f & (1ull << 63))) {
+      res.f <<= 1;
+      --res.e;
+    }
+    return res;
+  }
+};
+
+/// A normalized power of ten 10^decimalExponent = f * 2^binaryExponent.
+struct CachedPower {
+  uint64_t f;
+  int16_t binaryExponent;
+  int16_t decimalExponent;
+};
+
+/// The powers of ten from 10^-348 to 10^340 in steps of 8, with their
+/// significands rounded to 64 bits.
+const CachedPower kCachedPowers[] = {
+    {0xfa8fd5a0081c0288ull, -1220, -348},
+    {0xbaaee17fa23ebf76ull, -1193, -340},
+    {0x8b16fb203055ac76ull, -1166, -332},
+    {0xcf42894a5dce35eaull, -1140, -324},
+    {0x9a6bb0aa55653b2dull, -1113, -316},
+    {0xe61acf033d1a45dfull, -1087, -308},
+    {0xab70fe17c79ac6caull, -1060, -300},
+    {0xff77b1fcbebcdc4full, -1034, -292},
+    {0xbe5691ef416bd60cull, -1007, -284},
+    {0x8dd01fad907ffc3cull, -980, -276},
+    {0xd3515c2831559a83ull, -954, -268},
+    {0x9d71ac8fada6c9b5ull, -927, -260},
+    {0xea9c227723ee8bcbull, -901, -252},
+    {0xaecc49914078536dull, -874, -244},
+    {0x823c12795db6ce57ull, -847, -236},
+    {0xc21094364dfb5637ull, -821, -228},
+    {0x9096ea6f3848984full, -794, -220},
+    {0xd77485cb25823ac7ull, -768, -212},
+    {0xa086cfcd97bf97f4ull, -741, -204},
+    {0xef340a98172aace5ull, -715, -196},
+    {0xb23867fb2a35b28eull, -688, -188},
+    {0x84c8d4dfd2c63f3bull, -661, -180},
+    {0xc5dd44271ad3cdbaull, -635, -172},
+    {0x936b9fcebb25c996ull, -608, -164},
+    {0xdbac6c247d62a584ull, -582, -156},
+    {0xa3ab66580d5fdaf6ull, -555, -148},
+    {0xf3e2f893dec3f126ull, -529, -140},
+    {0xb5b5ada8aaff80b8ull, -502, -132},
+    {0x87625f056c7c4a8bull, -475, -124},
+    {0xc9bcff6034c13053ull, -449, -116},
+    {0x964e858c91ba2655ull, -422, -108},
+    {0xdff9772470297ebdull, -396, -100},
+    {0xa6dfbd9fb8e5b88full, -369, -92},
+    {0xf8a95fcf88747d94ull, -343, -84},
+    {0xb94470938fa89bcfull, -316, -76},
+    {0x8a08f0f8bf0f156bull, -289, -68},
+    {0xcdb02555653131b6ull, -263, -60},
+    {0x993fe2c6d07b7facull, -236, -52},
+    {0xe45c10c42a2b3b06ull, -210, -44},
+    {0xaa242499697392d3ull, -183, -36},
+    {0xfd87b5f28300ca0eull, -157, -28},
+    {0xbce5086492111aebull, -130, -20},
+    {0x8cbccc096f5088ccull, -103, -12},
+    {0xd1b71758e219652cull, -77, -4},
+    {0x9c40000000000000ull, -50, 4},
+    {0xe8d4a51000000000ull, -24, 12},
+    {0xad78ebc5ac620000ull, 3, 20},
+    {0x813f3978f8940984ull, 30, 28},
+    {0xc097ce7bc90715b3ull, 56, 36},
+    {0x8f7e32ce7bea5c70ull, 83, 44},
+    {0xd5d238a4abe98068ull, 109, 52},
+    {0x9f4f2726179a2245ull, 136, 60},
+    {0xed63a231d4c4fb27ull, 162, 68},
+    {0xb0de65388cc8ada8ull, 189, 76},
+    {0x83c7088e1aab65dbull, 216, 84},
+    {0xc45d1df942711d9aull, 242, 92},
+    {0x924d692ca61be758ull, 269, 100},
+    {0xda01ee641a708deaull, 295, 108},
+    {0xa26da3999aef774aull, 322, 116},
+    {0xf209787bb47d6b85ull, 348, 124},
+    {0xb454e4a179dd1877ull, 375, 132},
+    {0x865b86925b9bc5c2ull, 402, 140},
+    {0xc83553c5c8965d3dull, 428, 148},
+    {0x952ab45cfa97a0b3ull, 455, 156},
+    {0xde469fbd99a05fe3ull, 481, 164},
+    {0xa59bc234db398c25ull, 508, 172},
+    {0xf6c69a72a3989f5cull, 534, 180},
+    {0xb7dcbf5354e9beceull, 561, 188},
+    {0x88fcf317f22241e2ull, 588, 196},
+    {0xcc20ce9bd35c78a5ull, 614, 204},
+    {0x98165af37b2153dfull, 641, 212},
+    {0xe2a0b5dc971f303aull, 667, 220},
+    {0xa8d9d1535ce3b396ull, 694, 228},
+    {0xfb9b7cd9a4a7443cull, 720, 236},
+    {0xbb764c4ca7a44410ull, 747, 244},
+    {0x8bab8eefb6409c1aull, 774, 252},
+    {0xd01fef10a657842cull, 800, 260},
+    {0x9b10a4e5e9913129ull, 827, 268},
+    {0xe7109bfba19c0c9dull, 853, 276},
+    {0xac2820d9623bf429ull, 880, 284},
+    {0x80444b5e7aa7cf85ull, 907, 292},
+    {0xbf21e44003acdd2dull, 933, 300},
+    {0x8e679c2f5e44ff8full, 960, 308},
+    {0xd433179d9c8cb841ull, 986, 316},
+    {0x9e19db92b4e31ba9ull, 1013, 324},
+    {0xeb96bf6ebadf77d9ull, 1039, 332},
+    {0xaf87023b9bf0ee6bull, 1066, 340},
+};
+
+const int kCachedPowersOffset = 348;
+const int kDecimalExponentDistance = 8;
+
+/// The range of binary exponents of the scaled numbers. The integral part of
+/// the scaled upper boundary fits in 32 bits, and its fractional part
+/// multiplied by 10 in 64 bits.
+const int kMinimalTargetExponent = -60;
+const int kMaximalTargetExponent = -32;
+
+const uint32_t kSmallPowersOfTen[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+/// \return a cached power of ten c * 2^e with e in [\p minExponent,
+/// \p maxExponent].
+const CachedPower &getCachedPower(int minExponent, int maxExponent) {
+  (void)maxExponent;
+  // 1 / log2(10), to estimate the decimal exponent from the binary one.
+  const double kD1Log210 = 0.30102999566398114;
+  int k = static_cast<int>(std::ceil((minExponent + 63) * kD1Log210));
+  int index = (kCachedPowersOffset + k - 1) / kDecimalExponentDistance + 1;
+  const CachedPower &power = kCachedPowers[index];
+  assert(
+      minExponent <= power.binaryExponent &&
+      power.binaryExponent <= maxExponent && "bad cached power");
+  return power;
+}
+
+/// Adjust the last digit of the \p length digits in \p buf towards w, the
+/// scaled number, if that keeps them inside the safe interval, and check
+/// that the result is guaranteed to be the closest shortest representation.
+/// All distances are in units of the scaled numbers.
+/// \param distanceTooHighW the distance from the upper boundary to w.
+/// \param unsafeInterval the width of the unsafe interval.
+/// \param rest the distance from the digits to the upper boundary.
+/// \param tenKappa the weight of the last digit.
+/// \param unit the maximal error of w and the boundaries.
+/// \return true if the digits are the closest shortest representation.
+bool roundWeed(
+    char *buf,
+    unsigned length,
+    uint64_t distanceTooHighW,
+    uint64_t unsafeInterval,
+    uint64_t rest,
+    uint64_t tenKappa,
+    uint64_t unit) {
+  uint64_t smallDistance = distanceTooHighW - unit;
+  uint64_t bigDistance = distanceTooHighW + unit;
+  // Move the digits down towards w while they are certainly closer to it,
+  // ie. closer to w + unit, the farthest w may be.
+  while (rest < smallDistance && unsafeInterval - rest >= tenKappa &&
+         (rest + tenKappa < smallDistance ||
+          smallDistance - rest >= rest + tenKappa - smallDistance)) {
+    --buf[length - 1];
+    rest += tenKappa;
+  }
+  // Give up if the next lower digits could be closer to w - unit, the other
+  // end of where w may be.
+  if (rest < bigDistance && unsafeInterval - rest >= tenKappa &&
+      (rest + tenKappa < bigDistance ||
+       bigDistance - rest > rest + tenKappa - bigDistance)) {
+    return false;
+  }
+  // The digits must be within the safe interval, accounting for the errors
+  // of the boundaries.
+  return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+/// Generate the shortest digits between the scaled boundaries \p low and
+/// \p high, closest to the scaled number \p w.
+/// \param[out] kappa the decimal exponent of the digits relative to the
+///   scaled numbers.
+/// \return the number of digits, or 0 on failure.
+unsigned digitGen(DiyFp low, DiyFp w, DiyFp high, char *buf, int *kappa) {
+  assert(low.e == w.e && w.e == high.e);
+  assert(
+      kMinimalTargetExponent <= w.e && w.e <= kMaximalTargetExponent &&
+      "w not scaled to the target range");
+  // The boundaries are off by at most one unit, so only the digits within
+  // the unsafe interval (tooLow, tooHigh) may represent the number, and
+  // those within the safe interval (tooLow + 2 units, tooHigh - 2 units)
+  // certainly do.
+  uint64_t unit = 1;
+  uint64_t tooLow = low.f - unit;
+  uint64_t tooHigh = high.f + unit;
+  uint64_t unsafeInterval = tooHigh - tooLow;
+  // Split tooHigh into its integral and fractional parts.
+  unsigned shift = -w.e;
+  uint64_t one = 1ull << shift;
+  uint32_t integrals = static_cast<uint32_t>(tooHigh >> shift);
+  uint64_t fractionals = tooHigh & (one - 1);
+
+  // Find the largest power of ten not above the integrals.
+  int divisorExponentPlusOne = 0;
+  while (divisorExponentPlusOne < 10 &&
+         integrals >= kSmallPowersOfTen[divisorExponentPlusOne]) {
+    ++divisorExponentPlusOne;
+  }
+  *kappa = divisorExponentPlusOne;
+  unsigned length = 0;
+  // Generate the digits of the integrals, stopping as soon as the remaining
+  // ones are within the unsafe interval.
+  while (*kappa > 0) {
+    uint32_t divisor = kSmallPowersOfTen[*kappa - 1];
+    buf[length++] = static_cast<char>('0' + integrals / divisor);
+    integrals %= divisor;
+    --*kappa;
+    uint64_t rest = (static_cast<uint64_t>(integrals) << shift) + fractionals;
+    if (rest < unsafeInterval) {
+      bool ok = roundWeed(
+          buf,
+          length,
+          tooHigh - w.f,
+          unsafeInterval,
+          rest,
+          static_cast<uint64_t>(divisor) << shift,
+          unit);
+      return ok ? length : 0;
+    }
+  }
+  // Generate the digits of the fractionals, scaling the unsafe interval and
+  // the error along with them.
+  for (;;) {
+    assert(length < FAST_DTOA_MAX_DIGITS && "too many digits");
+    fractionals *= 10;
+    unit *= 10;
+    unsafeInterval *= 10;
+    buf[length++] = static_cast<char>('0' + (fractionals >> shift));
+    fractionals &= one - 1;
+    --*kappa;
+    if (fractionals < unsafeInterval) {
+      bool ok = roundWeed(
+          buf,
+          length,
+          (tooHigh - w.f) * unit,
+          unsafeInterval,
+          fractionals,
+          one,
+          unit);
+      return ok ? length : 0;
+    }
+  }
+}
+
+} // namespace
+
+unsigned fastShortestDtoa(double v, char *buf, int *decimalPoint) {
+  assert(v > 0 && v <= 1.7976931348623157e308 && "v must be finite positive");
+  const uint64_t kHiddenBit = 1ull << 52;
+  const uint64_t kSignificandMask = kHiddenBit - 1;
+  const int kExponentBias = 1023 + 52;
+  uint64_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  int biasedExponent = static_cast<int>(bits >> 52) & 0x7FF;
+
+  // v = f * 2^e exactly.
+  DiyFp vFp;
+  if (biasedExponent == 0) {
+    vFp = {bits & kSignificandMask, 1 - kExponentBias};
+  } else {
+    vFp = {(bits & kSignificandMask) | kHiddenBit,
+           biasedExponent - kExponentBias};
+  }
+
+  // The boundaries are halfway to the neighbours of v, which is closer below
+  // v when it's a power of two.
+  DiyFp plus = DiyFp{(vFp.f << 1) + 1, vFp.e - 1}.normalize();
+  DiyFp minus;
+  if ((bits & kSignificandMask) == 0 && biasedExponent > 1)
+    minus = {(vFp.f << 2) - 1, vFp.e - 2};
+  else
+    minus = {(vFp.f << 1) - 1, vFp.e - 1};
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+  DiyFp w = vFp.normalize();
+  assert(w.e == plus.e && "boundaries not aligned with v");
+
+  // Scale everything by a power of ten 10^-k, bringing their exponents into
+  // the target range.
+  const CachedPower &tenMk = getCachedPower(
+      kMinimalTargetExponent - (w.e + 64),
+      kMaximalTargetExponent - (w.e + 64));
+  DiyFp tenMkFp{tenMk.f, tenMk.binaryExponent};
+  DiyFp scaledW = w * tenMkFp;
+  DiyFp scaledMinus = minus * tenMkFp;
+  DiyFp scaledPlus = plus * tenMkFp;
+
+  int kappa;
+  unsigned length = digitGen(scaledMinus, scaledW, scaledPlus, buf, &kappa);
+  if (!length)
+    return 0;
+  *decimalPoint = static_cast<int>(length) + kappa - tenMk.decimalExponent;
+  return length;
+}
+
+} // namespace hermes
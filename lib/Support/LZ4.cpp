@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/LZ4.h"
+
+#include <cstring>
+
+namespace hermes {
+
+namespace {
+
+/// Every match copies at least this many bytes.
+constexpr size_t kMinMatch = 4;
+/// The last this many bytes of a block are always literals.
+constexpr size_t kLastLiterals = 5;
+/// The last match must start at least this many bytes before the end.
+constexpr size_t kMFLimit = 12;
+/// Matches are encoded with a 16 bit offset.
+constexpr size_t kMaxOffset = 0xffff;
+/// Log2 of the number of entries in the match finder's hash table.
+constexpr unsigned kHashLog = 12;
+
+inline uint32_t read32(const uint8_t *p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint32_t hashSequence(uint32_t seq) {
+  return (seq * 2654435761u) >> (32 - kHashLog);
+}
+
+/// Append the part of a length that didn't fit in its 4 bit token field.
+void appendExtraLength(std::vector<uint8_t> &out, size_t len) {
+  for (; len >= 255; len -= 255)
+    out.push_back(255);
+  out.push_back(len);
+}
+
+/// Append a sequence made of \p litLen literals at \p lit, followed by a match
+/// of \p matchLen bytes at \p offset, or by nothing if \p matchLen is 0.
+void appendSequence(
+    std::vector<uint8_t> &out,
+    const uint8_t *lit,
+    size_t litLen,
+    size_t offset,
+    size_t matchLen) {
+  size_t tokenIndex = out.size();
+  out.push_back((litLen < 15 ? litLen : 15) << 4);
+  if (litLen >= 15)
+    appendExtraLength(out, litLen - 15);
+  out.insert(out.end(), lit, lit + litLen);
+  if (!matchLen)
+    return;
+
+  out.push_back(offset & 0xff);
+  out.push_back(offset >> 8);
+  size_t len = matchLen - kMinMatch;
+  out[tokenIndex] |= len < 15 ? len : 15;
+  if (len >= 15)
+    appendExtraLength(out, len - 15);
+}
+
+/// Read the extra bytes of a length whose token field was 15 from \p ip,
+/// adding them to \p len. \return false if the input ends first.
+bool readExtraLength(const uint8_t *&ip, const uint8_t *end, size_t &len) {
+  uint8_t b;
+  do {
+    if (ip == end)
+      return false;
+    b = *ip++;
+    len += b;
+  } while (b == 255);
+  return true;
+}
+
+} // namespace
+
+void compressLZ4Block(
+    llvm::ArrayRef<uint8_t> input,
+    std::vector<uint8_t> &out) {
+  const uint8_t *base = input.data();
+  size_t size = input.size();
+  size_t anchor = 0;
+
+  if (size >= kMFLimit) {
+    std::vector<uint32_t> table(1u << kHashLog, 0);
+    size_t searchEnd = size - kMFLimit;
+    size_t matchEnd = size - kLastLiterals;
+    size_t pos = 0;
+    while (pos <= searchEnd) {
+      uint32_t seq = read32(base + pos);
+      uint32_t &slot = table[hashSequence(seq)];
+      size_t cand = slot;
+      slot = pos;
+      if (cand >= pos || pos - cand > kMaxOffset ||
+          read32(base + cand) != seq) {
+        ++pos;
+        continue;
+      }
+
+      size_t len = kMinMatch;
+      while (pos + len < matchEnd && base[cand + len] == base[pos + len])
+        ++len;
+      // Grow the match backwards into the pending literals.
+      while (pos > anchor && cand > 0 && base[pos - 1] == base[cand - 1]) {
+        --pos;
+        --cand;
+        ++len;
+      }
+      appendSequence(out, base + anchor, pos - anchor, pos - cand, len);
+      pos += len;
+      anchor = pos;
+    }
+  }
+
+  appendSequence(out, base + anchor, size - anchor, 0, 0);
+}
+
+bool decompressLZ4Block(
+    llvm::ArrayRef<uint8_t> input,
+    llvm::MutableArrayRef<uint8_t> output) {
+  const uint8_t *ip = input.begin();
+  const uint8_t *ipEnd = input.end();
+  uint8_t *op = output.begin();
+  uint8_t *opEnd = output.end();
+
+  for (;;) {
+    if (ip == ipEnd)
+      return false;
+    uint8_t token = *ip++;
+
+    size_t litLen = token >> 4;
+    if (litLen == 15 && !readExtraLength(ip, ipEnd, litLen))
+      return false;
+    if ((size_t)(ipEnd - ip) < litLen || (size_t)(opEnd - op) < litLen)
+      return false;
+    if (litLen)
+      std::memcpy(op, ip, litLen);
+    ip += litLen;
+    op += litLen;
+
+    // The last sequence has no match.
+    if (ip == ipEnd)
+      return op == opEnd;
+
+    if (ipEnd - ip < 2)
+      return false;
+    size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > (size_t)(op - output.begin()))
+      return false;
+
+    size_t matchLen = token & 15;
+    if (matchLen == 15 && !readExtraLength(ip, ipEnd, matchLen))
+      return false;
+    matchLen += kMinMatch;
+    if ((size_t)(opEnd - op) < matchLen)
+      return false;
+
+    const uint8_t *match = op - offset;
+    if (offset >= matchLen) {
+      std::memcpy(op, match, matchLen);
+      op += matchLen;
+    } else {
+      // The match overlaps the bytes it produces, so copy it byte by byte.
+      for (uint8_t *end = op + matchLen; op != end; ++op, ++match)
+        *op = *match;
+    }
+  }
+}
+
+} // namespace hermes
@@ -11,6 +11,7 @@
 #include "hermes/Support/OSCompat.h"
 
 #include <cassert>
+#include <cstdio>
 #include <vector>
 
 #include <signal.h>
@@ -45,6 +46,7 @@
 #error "CLOCK_THREAD_CPUTIME_ID not supported by clock_gettime"
 #endif
 
+#include <sched.h>
 #include <sys/syscall.h>
 #include <time.h>
 
@@ -105,7 +107,7 @@ void unset_test_vm_allocate_limit() {
 }
 #endif // !NDEBUG
 
-static llvm::ErrorOr<void *> vm_allocate_impl(size_t sz) {
+static llvm::ErrorOr<void *> vm_allocate_impl(size_t sz, int extraFlags = 0) {
 #ifndef NDEBUG
   if (LLVM_UNLIKELY(sz > totalVMAllocLimit)) {
     return make_error_code(OOMError::TestVMLimitReached);
@@ -115,7 +117,12 @@ static llvm::ErrorOr<void *> vm_allocate_impl(size_t sz) {
 #endif // !NDEBUG
 
   void *result = mmap(
-      nullptr, sz, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      nullptr,
+      sz,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | extraFlags,
+      -1,
+      0);
   if (result == MAP_FAILED) {
     // Since mmap is a POSIX API, even on MacOS, errno should use the POSIX
     // generic_category.
@@ -180,6 +187,86 @@ llvm::ErrorOr<void *> vm_allocate_aligned(size_t sz, size_t alignment) {
   return aligned;
 }
 
+size_t huge_page_size() {
+  static const size_t hugePageSize = []() -> size_t {
+    // Most platforms use 2 MiB huge pages; Linux reports the default size.
+    size_t sz = 2 << 20;
+#ifdef __linux__
+    if (FILE *meminfo = fopen("/proc/meminfo", "r")) {
+      char line[128];
+      unsigned long kb;
+      while (fgets(line, sizeof(line), meminfo)) {
+        if (sscanf(line, "Hugepagesize: %lu kB", &kb) == 1) {
+          sz = static_cast<size_t>(kb) << 10;
+          break;
+        }
+      }
+      fclose(meminfo);
+    }
+#endif // __linux__
+    return sz;
+  }();
+  return hugePageSize;
+}
+
+llvm::ErrorOr<void *> vm_allocate_huge_aligned(size_t sz, size_t alignment) {
+#ifdef MAP_HUGETLB
+  const size_t HPS = huge_page_size();
+  if (sz == 0 || sz % HPS != 0 || alignment % HPS != 0) {
+    return make_error_code(std::errc::invalid_argument);
+  }
+
+  // Huge pages are reserved when they are mapped, so first try without the
+  // excess needed to guarantee the alignment, as in vm_allocate_aligned.
+  auto result = vm_allocate_impl(sz, MAP_HUGETLB);
+  if (!result) {
+    return result;
+  }
+  void *mem = *result;
+  if (mem == alignAlloc(mem, alignment)) {
+    return mem;
+  }
+  oscompat::vm_free(mem, sz);
+
+  // Huge-page mappings start on a huge page boundary, and can only be
+  // unmapped in whole huge pages, which the alignment is a multiple of.
+  const size_t excessSize = sz + alignment - HPS;
+  result = vm_allocate_impl(excessSize, MAP_HUGETLB);
+  if (!result) {
+    return result;
+  }
+
+  void *raw = *result;
+  char *aligned = alignAlloc(raw, alignment);
+  size_t excessAtFront = aligned - static_cast<char *>(raw);
+  size_t excessAtBack = excessSize - excessAtFront - sz;
+
+  if (excessAtFront)
+    oscompat::vm_free(raw, excessAtFront);
+  if (excessAtBack)
+    oscompat::vm_free(aligned + sz, excessAtBack);
+
+  return aligned;
+#else
+  (void)sz;
+  (void)alignment;
+  return make_error_code(std::errc::not_supported);
+#endif // MAP_HUGETLB
+}
+
+bool vm_hugepage(void *p, size_t sz) {
+  assert(
+      reinterpret_cast<intptr_t>(p) % page_size() == 0 &&
+      "Precondition: pointer is page-aligned.");
+#ifdef MADV_HUGEPAGE
+  return madvise(p, sz, MADV_HUGEPAGE) == 0;
+#else
+  (void)p;
+  (void)sz;
+  return false;
+#endif // MADV_HUGEPAGE
+}
+
 void vm_free(void *p, size_t sz) {
   auto ret = munmap(p, sz);
 
@@ -513,6 +600,21 @@ std::string thread_name() {
   return threadName;
 }
 
+bool set_thread_affinity(unsigned cpu) {
+#ifdef __linux__
+  if (cpu >= CPU_SETSIZE)
+    return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  // Darwin only supports affinity hints between threads, not to CPUs.
+  (void)cpu;
+  return false;
+#endif
+}
+
 bool set_env(const char *name, const char *value) {
   // Enforce the contract of this function that value must not be empty
   assert(*value != '\0' && "value cannot be empty string");
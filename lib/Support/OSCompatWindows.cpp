@@ -308,6 +308,20 @@ bool vm_madvise(void *p, size_t sz, MAdvice advice) {
   return false;
 }
 
+size_t huge_page_size() {
+  return 2 << 20;
+}
+
+llvm::ErrorOr<void *> vm_allocate_huge_aligned(size_t sz, size_t alignment) {
+  // Not implemented: large pages need a privilege that processes rarely have.
+  return make_error_code(std::errc::not_supported);
+}
+
+bool vm_hugepage(void *p, size_t sz) {
+  // Not implemented.
+  return false;
+}
+
 int pages_in_ram(const void *p, size_t sz, llvm::SmallVectorImpl<int> *runs) {
   // Not yet supported.
   return -1;
@@ -386,6 +400,12 @@ std::string thread_name() {
   return "";
 }
 
+bool set_thread_affinity(unsigned cpu) {
+  if (cpu >= sizeof(DWORD_PTR) * 8)
+    return false;
+  return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+}
+
 bool set_env(const char *name, const char *value) {
   // Setting an env var to empty requires a lot of hacks on Windows
   assert(*value != '\0' && "value cannot be empty string");
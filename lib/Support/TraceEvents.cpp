@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/TraceEvents.h"
+
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/Support/OSCompat.h"
+
+#include "llvm/ADT/SmallString.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+#ifndef _WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace hermes {
+namespace trace {
+
+namespace detail {
+std::atomic<uint32_t> enabledCategories{0};
+} // namespace detail
+
+namespace {
+/// Guards the sink.
+std::mutex &sinkMutex() {
+  static std::mutex mtx;
+  return mtx;
+}
+std::shared_ptr<Sink> &sinkStorage() {
+  static std::shared_ptr<Sink> sink;
+  return sink;
+}
+
+/// \return the time since an arbitrary epoch in microseconds.
+int64_t nowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace
+
+const char *categoryName(Category category) {
+  switch (category) {
+    case Category::Execution:
+      return "execution";
+    case Category::GC:
+      return "gc";
+    case Category::Compile:
+      return "compile";
+  }
+  return "unknown";
+}
+
+llvm::Optional<uint32_t> parseCategories(llvm::StringRef names) {
+  uint32_t categories = 0;
+  while (!names.empty()) {
+    llvm::StringRef name;
+    std::tie(name, names) = names.split(',');
+    name = name.trim();
+    bool found = false;
+    for (uint32_t bit = 1; bit <= kAllCategories; bit <<= 1) {
+      if (name == categoryName(static_cast<Category>(bit))) {
+        categories |= bit;
+        found = true;
+      }
+    }
+    if (!found)
+      return llvm::None;
+  }
+  return categories;
+}
+
+Sink::~Sink() = default;
+
+std::shared_ptr<Sink> detail::getSink() {
+  std::lock_guard<std::mutex> lk(sinkMutex());
+  return sinkStorage();
+}
+
+void setSink(std::shared_ptr<Sink> sink, uint32_t categories) {
+  std::lock_guard<std::mutex> lk(sinkMutex());
+  detail::enabledCategories.store(
+      sink ? categories : 0, std::memory_order_relaxed);
+  sinkStorage() = std::move(sink);
+}
+
+void Scope::beginSlow() {
+  sink_ = detail::getSink();
+  if (sink_)
+    sink_->begin(category_, name_);
+}
+
+void ChromeTraceSink::begin(Category category, const char *name) {
+  uint64_t tid = oscompat::thread_id();
+  int64_t ts = nowMicros();
+  std::lock_guard<std::mutex> lk(mtx_);
+  open_.emplace_back(tid, ts);
+}
+
+void ChromeTraceSink::end(
+    Category category,
+    const char *name,
+    llvm::ArrayRef<Arg> args) {
+  uint64_t tid = oscompat::thread_id();
+  int64_t end = nowMicros();
+  std::lock_guard<std::mutex> lk(mtx_);
+  // Events nest on each thread, so the last one the thread started is ending.
+  auto it = std::find_if(
+      open_.rbegin(),
+      open_.rend(),
+      [tid](const std::pair<uint64_t, int64_t> &e) { return e.first == tid; });
+  assert(it != open_.rend() && "Event ends without beginning");
+  int64_t start = it->second;
+  open_.erase(std::next(it).base());
+  events_.push_back(
+      Event{category, name, tid, start, end - start, args.vec()});
+}
+
+void ChromeTraceSink::serialize(llvm::raw_ostream &OS) {
+  std::lock_guard<std::mutex> lk(mtx_);
+  JSONEmitter json(OS);
+  json.openDict();
+  json.emitKey("traceEvents");
+  json.openArray();
+  for (const Event &event : events_) {
+    json.openDict();
+    json.emitKeyValue("name", event.name);
+    json.emitKeyValue("cat", categoryName(event.category));
+    // A complete event, with its start and duration.
+    json.emitKeyValue("ph", "X");
+    json.emitKeyValue("pid", 0);
+    json.emitKeyValue("tid", event.tid);
+    json.emitKeyValue("ts", event.ts);
+    json.emitKeyValue("dur", event.dur);
+    json.emitKey("args");
+    json.openDict();
+    for (const Arg &arg : event.args) {
+      switch (arg.kind) {
+        case Arg::Kind::Int:
+          json.emitKeyValue(arg.name, arg.i);
+          break;
+        case Arg::Kind::Double:
+          json.emitKeyValue(arg.name, arg.d);
+          break;
+        case Arg::Kind::String:
+          json.emitKeyValue(arg.name, arg.s);
+          break;
+      }
+    }
+    json.closeDict();
+    json.closeDict();
+  }
+  json.closeArray();
+  json.emitKeyValue("displayTimeUnit", "ms");
+  json.closeDict();
+}
+
+#ifndef _WINDOWS
+ATraceSink::ATraceSink() {
+  for (const char *path :
+       {"/sys/kernel/tracing/trace_marker",
+        "/sys/kernel/debug/tracing/trace_marker"}) {
+    fd_ = open(path, O_WRONLY | O_CLOEXEC);
+    if (fd_ != -1)
+      break;
+  }
+}
+
+ATraceSink::~ATraceSink() {
+  if (fd_ != -1)
+    close(fd_);
+}
+
+void ATraceSink::begin(Category category, const char *name) {
+  if (fd_ == -1)
+    return;
+  // Each marker is a single write, so markers from different threads don't
+  // interleave.
+  llvm::SmallString<64> marker;
+  llvm::raw_svector_ostream OS(marker);
+  OS << "B|" << getpid() << '|' << categoryName(category) << ':' << name;
+  (void)write(fd_, marker.data(), marker.size());
+}
+
+void ATraceSink::end(
+    Category category,
+    const char *name,
+    llvm::ArrayRef<Arg> args) {
+  if (fd_ == -1)
+    return;
+  llvm::SmallString<16> marker;
+  llvm::raw_svector_ostream OS(marker);
+  OS << "E|" << getpid();
+  (void)write(fd_, marker.data(), marker.size());
+}
+#else
+ATraceSink::ATraceSink() {}
+ATraceSink::~ATraceSink() {}
+void ATraceSink::begin(Category category, const char *name) {}
+void ATraceSink::end(
+    Category category,
+    const char *name,
+    llvm::ArrayRef<Arg> args) {}
+#endif
+
+} // namespace trace
+} // namespace hermes
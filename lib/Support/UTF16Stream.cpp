@@ -38,22 +38,36 @@ bool UTF16Stream::refill() {
   end_ = storage_.end();
   auto out = storage_.begin();
 
-  // Fast case for any ASCII prefix...
-  while (out != end_ && utf8Begin_ != utf8End_ && *utf8Begin_ < 128) {
-    *out++ = *utf8Begin_++;
-  }
-  // ...and call the library for any non-ASCII remainder. Conversion always
-  // stops at a code point boundary.
-  llvm::ConversionResult cRes = ConvertUTF8toUTF16(
-      &utf8Begin_,
-      utf8End_,
-      (llvm::UTF16 **)&out,
-      (llvm::UTF16 *)end_,
-      llvm::lenientConversion);
-
-  if (cRes != llvm::ConversionResult::targetExhausted) {
-    // Indicate that we have converted the final chunk.
-    utf8Begin_ = utf8End_;
+  while (out != end_ && utf8Begin_ != utf8End_) {
+    // Fast case for a run of ASCII...
+    while (out != end_ && utf8Begin_ != utf8End_ && *utf8Begin_ < 128) {
+      *out++ = *utf8Begin_++;
+    }
+    // ...and call the library for the run of non-ASCII after it, so that the
+    // ASCII following it takes the fast case again. The run ends at a code
+    // point boundary unless the input is malformed.
+    const uint8_t *runEnd = utf8Begin_;
+    while (runEnd != utf8End_ && *runEnd >= 128) {
+      ++runEnd;
+    }
+    if (runEnd == utf8Begin_) {
+      continue;
+    }
+    llvm::ConversionResult cRes = ConvertUTF8toUTF16(
+        &utf8Begin_,
+        runEnd,
+        (llvm::UTF16 **)&out,
+        (llvm::UTF16 *)end_,
+        llvm::lenientConversion);
+    if (cRes == llvm::ConversionResult::targetExhausted) {
+      // Conversion stopped at a code point boundary, resume there.
+      break;
+    }
+    if (cRes != llvm::ConversionResult::conversionOK) {
+      // End the stream at the malformed character.
+      malformed_ = true;
+      utf8Begin_ = utf8End_;
+    }
   }
   end_ = out;
 
@@ -7,6 +7,8 @@
 
 #include "hermes/Support/UTF8.h"
 
+#include <cstring>
+
 namespace hermes {
 
 void encodeUTF8(char *&dst, uint32_t cp) {
@@ -78,6 +80,25 @@ bool convertUTF16ToUTF8WithReplacements(
   for (auto cur = input.begin(), end = input.end();
        cur < end && currNumCharacters < maxCharacters;
        ++cur, ++currNumCharacters) {
+    // Narrow four ASCII code units at a time while they last. The mask has the
+    // same value in every 16-bit lane, so it doesn't depend on endianness.
+    if (end - cur >= 4 && maxCharacters - currNumCharacters >= 4) {
+      uint64_t block;
+      std::memcpy(&block, cur, sizeof(block));
+      if (!(block & 0xFF80FF80FF80FF80u)) {
+        const char narrow[4] = {
+            static_cast<char>(cur[0]),
+            static_cast<char>(cur[1]),
+            static_cast<char>(cur[2]),
+            static_cast<char>(cur[3])};
+        out.append(narrow, 4);
+        // The loop advances by one more.
+        cur += 3;
+        currNumCharacters += 3;
+        continue;
+      }
+    }
+
     char16_t c = cur[0];
     // ASCII fast-path.
     if (LLVM_LIKELY(c <= 0x7F)) {
@@ -134,32 +155,17 @@ void convertUTF16ToUTF8WithSingleSurrogates(
 bool isAllASCII(const uint8_t *start, const uint8_t *end) {
   const uint8_t *cursor = start;
   size_t len = end - start;
-  static_assert(
-      sizeof(uint32_t) == 4 && alignof(uint32_t) <= 4,
-      "uint32_t must be 4 bytes and cannot be more than 4 byte aligned");
-
-  if (len >= 4) {
-    // Step by 1s until aligned for uint32_t.
-    uint8_t mask = 0;
-    while ((uintptr_t)cursor % alignof(uint32_t)) {
-      mask |= *cursor++;
-      len -= 1;
-    }
-    if (mask & 0x80u) {
-      return false;
-    }
 
-    // Now that we are aligned, step by 4s.
-    while (len >= 4) {
-      uint32_t val = *(const uint32_t *)cursor;
-      if (val & 0x80808080u) {
-        return false;
-      }
-      cursor += 4;
-      len -= 4;
+  // Test eight bytes at a time. memcpy compiles to a single unaligned load.
+  while (len >= sizeof(uint64_t)) {
+    uint64_t val;
+    std::memcpy(&val, cursor, sizeof(val));
+    if (val & 0x8080808080808080u) {
+      return false;
     }
+    cursor += sizeof(uint64_t);
+    len -= sizeof(uint64_t);
   }
-  assert(len < 4 && "Length should now be less than 4");
   uint8_t mask = 0;
   while (len--) {
     mask |= *cursor++;
@@ -169,4 +175,68 @@ bool isAllASCII(const uint8_t *start, const uint8_t *end) {
   return true;
 }
 
+namespace {
+
+/// The characters changed when converting ASCII to \p upperCase.
+inline char firstToConvert(bool upperCase) {
+  return upperCase ? 'a' : 'A';
+}
+inline char lastToConvert(bool upperCase) {
+  return upperCase ? 'z' : 'Z';
+}
+
+/// \return the word \p word of ASCII characters with the high bit of each
+/// byte set when the character is in [lo, hi], and all other bits clear.
+inline uint64_t asciiRangeMask(uint64_t word, char lo, char hi) {
+  const uint64_t ones = 0x0101010101010101u;
+  // No byte carries into the next one, since each is below 0x80 and the
+  // values added to it are below 0x80 too.
+  uint64_t atLeastLo = word + ones * (0x80 - lo);
+  uint64_t aboveHi = word + ones * (0x7F - hi);
+  return atLeastLo & ~aboveHi & (ones * 0x80);
+}
+
+} // namespace
+
+const char *
+findASCIICaseChange(const char *start, const char *end, bool upperCase) {
+  char lo = firstToConvert(upperCase);
+  char hi = lastToConvert(upperCase);
+  const char *cursor = start;
+  // Test eight characters at a time, then find the one in the word.
+  while ((size_t)(end - cursor) >= sizeof(uint64_t)) {
+    uint64_t val;
+    std::memcpy(&val, cursor, sizeof(val));
+    if (asciiRangeMask(val, lo, hi))
+      break;
+    cursor += sizeof(uint64_t);
+  }
+  while (cursor != end && !(lo <= *cursor && *cursor <= hi))
+    ++cursor;
+  return cursor;
+}
+
+void convertASCIICase(
+    const char *start,
+    const char *end,
+    char *out,
+    bool upperCase) {
+  char lo = firstToConvert(upperCase);
+  char hi = lastToConvert(upperCase);
+  const char *cursor = start;
+  // Flip the case bit (0x20) of eight characters at a time.
+  while ((size_t)(end - cursor) >= sizeof(uint64_t)) {
+    uint64_t val;
+    std::memcpy(&val, cursor, sizeof(val));
+    val ^= asciiRangeMask(val, lo, hi) >> 2;
+    std::memcpy(out, &val, sizeof(val));
+    cursor += sizeof(uint64_t);
+    out += sizeof(uint64_t);
+  }
+  while (cursor != end) {
+    char c = *cursor++;
+    *out++ = lo <= c && c <= hi ? c ^ 0x20 : c;
+  }
+}
+
 }; // namespace hermes
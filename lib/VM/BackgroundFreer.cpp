@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/BackgroundFreer.h"
+
+#include <cstdlib>
+
+namespace hermes {
+namespace vm {
+
+BackgroundFreer::~BackgroundFreer() {
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    shouldExit_ = true;
+  }
+  workAvailable_.notify_one();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+  // Only non-empty if no worker was ever started.
+  for (void *mem : pending_) {
+    free(mem);
+  }
+}
+
+void BackgroundFreer::enqueue(std::vector<void *> &batch) {
+  if (batch.empty()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (pending_.empty()) {
+      pending_.swap(batch);
+    } else {
+      pending_.insert(pending_.end(), batch.begin(), batch.end());
+      batch.clear();
+    }
+    if (!worker_.joinable()) {
+      worker_ = std::thread(&BackgroundFreer::workerLoop, this);
+    }
+  }
+  workAvailable_.notify_one();
+}
+
+void BackgroundFreer::waitUntilIdle() {
+  std::unique_lock<std::mutex> lk(mtx_);
+  idle_.wait(lk, [this]() { return pending_.empty() && !busy_; });
+}
+
+void BackgroundFreer::workerLoop() {
+  std::vector<void *> batch;
+  std::unique_lock<std::mutex> lk(mtx_);
+  while (true) {
+    workAvailable_.wait(
+        lk, [this]() { return shouldExit_ || !pending_.empty(); });
+    if (pending_.empty()) {
+      // Only reachable once shouldExit_ is set.
+      return;
+    }
+    batch.swap(pending_);
+    busy_ = true;
+    lk.unlock();
+    for (void *mem : batch) {
+      free(mem);
+    }
+    batch.clear();
+    lk.lock();
+    busy_ = false;
+    if (pending_.empty()) {
+      idle_.notify_all();
+    }
+  }
+}
+
+} // namespace vm
+} // namespace hermes
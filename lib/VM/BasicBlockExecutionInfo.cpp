@@ -8,8 +8,10 @@
 #ifdef HERMESVM_PROFILER_BB
 
 #include "hermes/VM/BasicBlockExecutionInfo.h"
+#include "hermes/Support/BasicBlockProfile.h"
 #include "hermes/Support/JSONEmitter.h"
 #include "hermes/Support/OSCompat.h"
+#include "hermes/Support/SHA1.h"
 #include "hermes/VM/CodeBlock.h"
 #include "hermes/VM/Runtime.h"
 
@@ -18,8 +20,6 @@
 
 #include <string>
 
-const static int32_t BASIC_BLOCK_STAT_VERSION = 2;
-
 namespace hermes {
 namespace vm {
 
@@ -47,7 +47,7 @@ static llvm::MD5::MD5Result doMD5Checksum(llvm::ArrayRef<uint8_t> bytecode) {
 void BasicBlockExecutionInfo::dump(llvm::raw_ostream &OS) {
   JSONEmitter json(OS);
   json.openDict();
-  json.emitKeyValue("version", BASIC_BLOCK_STAT_VERSION);
+  json.emitKeyValue("version", kBasicBlockProfileVersion);
   json.emitKeyValue("page_size", (double)hermes::oscompat::page_size());
 
   json.emitKey("functions");
@@ -55,9 +55,24 @@ void BasicBlockExecutionInfo::dump(llvm::raw_ostream &OS) {
 
   for (const auto &funcEntry : basicBlockStats_) {
     json.openDict();
-    auto md5Result = doMD5Checksum(funcEntry.first->getOpcodeArray());
+    CodeBlock *codeBlock = funcEntry.first;
+    auto md5Result = doMD5Checksum(codeBlock->getOpcodeArray());
     json.emitKeyValue("checksum", md5Result.digest().str());
 
+    // The source hash and the start of the function in the source identify
+    // it when the profile is fed back to the compiler, which doesn't know the
+    // checksum yet.
+    auto *bcProvider = codeBlock->getRuntimeModule()->getBytecode();
+    json.emitKeyValue("source_hash", hashAsString(bcProvider->getSourceHash()));
+    if (auto debugOffset = codeBlock->getDebugSourceLocationsOffset()) {
+      auto locations =
+          bcProvider->getDebugInfo()->getLocationsForFunction(*debugOffset);
+      if (!locations.empty()) {
+        json.emitKeyValue("line", locations.front().line);
+        json.emitKeyValue("column", locations.front().column);
+      }
+    }
+
     // hbcdump will be responsible to check overflow scenario(index-zero entry
     // is not empty).
     const auto &funcStat = funcEntry.second;
@@ -737,6 +737,22 @@ CallResult<HermesValue> BoundFunction::_boundCall(
   // bound calls in one go (which is more efficient anyway).
   callerFrame.getScratchRef() = originalCalleeFrame.getThisArgRef();
 
+  if (self->bindsOnlyThis(runtime) &&
+      !vmisa<BoundFunction>(self->getTarget(runtime))) {
+    // The arguments are already in place, so only the callee and "thisArg"
+    // of the existing frame need to change.
+    originalCalleeFrame.getCalleeClosureOrCBRef() =
+        HermesValue::encodeObjectValue(self->getTarget(runtime));
+    if (originalNewTarget.isUndefined())
+      originalCalleeFrame.getThisArgRef() = self->getBoundThis(runtime);
+    res = Callable::call(
+        originalCalleeFrame.getCalleeClosureHandleUnsafe(), runtime);
+    assert(
+        runtime->getCurrentFrame() == callerFrame &&
+        "caller frame not restored");
+    goto bail;
+  }
+
   // Pop the stack down to the first argument, erasing the call frame - we don't
   // need the call frame since we will build a new one.
   runtime->popToSavedStackPointer(&originalCalleeFrame->getArgRefUnsafe(0));
@@ -1218,11 +1234,27 @@ CallResult<HermesValue> JSFunction::_callImpl(
     Handle<Callable> selfHandle,
     Runtime *runtime) {
   auto *self = vmcast<JSFunction>(selfHandle.get());
-  if (auto *jitPtr = self->getCodeBlock()->getJITCompiled())
+  if (auto *jitPtr = self->getCodeBlock()->getJITCompiled()) {
+    self->getCodeBlock()->markJITUsed();
     return (*jitPtr)(runtime);
+  }
   return runtime->interpretFunction(self->getCodeBlock());
 }
 
+CallResult<HermesValue> JSFunction::_newObjectImpl(
+    Handle<Callable> selfHandle,
+    Runtime *runtime,
+    Handle<JSObject> parentHandle) {
+  CodeBlock *codeBlock = vmcast<JSFunction>(selfHandle.get())->getCodeBlock();
+  uint32_t numProperties = codeBlock->getNumConstructedProperties(runtime);
+  auto objRes = JSObject::allocatePropStorage(
+      JSObject::create(runtime, parentHandle), runtime, numProperties);
+  if (LLVM_UNLIKELY(objRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  codeBlock->setLastConstructed(objRes->get());
+  return objRes->getHermesValue();
+}
+
 std::string JSFunction::_snapshotNameImpl(GCCell *cell, GC *gc) {
   auto *const self = vmcast<JSFunction>(cell);
   std::string funcName = Callable::_snapshotNameImpl(self, gc);
@@ -1357,6 +1389,7 @@ GeneratorInnerFunction::GeneratorInnerFunction(Deserializer &d)
   }
   d.readHermesValue(&result_);
   nextIPOffset_ = d.readInt<uint32_t>();
+  savedRegCount_ = d.readInt<uint32_t>();
   action_ = (Action)d.readInt<uint8_t>();
 }
 
@@ -1373,6 +1406,7 @@ void GeneratorInnerFunctionSerialize(Serializer &s, const GCCell *cell) {
   }
   s.writeHermesValue(self->result_);
   s.writeInt<uint32_t>(self->nextIPOffset_);
+  s.writeInt<uint32_t>(self->savedRegCount_);
   s.writeInt<uint8_t>((uint8_t)self->action_);
   s.endObject(cell);
 }
@@ -1469,38 +1503,56 @@ CallResult<HermesValue> GeneratorInnerFunction::callInnerFunction(
 void GeneratorInnerFunction::restoreStack(Runtime *runtime) {
   const uint32_t frameOffset = getFrameOffsetInContext();
   const uint32_t frameSize = getFrameSizeInContext(runtime);
-  // Start at the lower end of the range to be copied.
+  const uint32_t count = savedRegCount_;
+  // Start at the lower end of the range to be copied. The saved slots are the
+  // ones closest to the frame pointer, which are the last in the context.
   PinnedHermesValue *dst = StackFrameLayout::StackIncrement > 0
       ? runtime->getCurrentFrame().ptr()
-      : runtime->getCurrentFrame().ptr() - frameSize;
+      : runtime->getCurrentFrame().ptr() - count;
   assert(
       (StackFrameLayout::StackIncrement > 0 &&
-       dst + frameSize <= runtime->getStackPointer()) ||
+       dst + count <= runtime->getStackPointer()) ||
       (StackFrameLayout::StackIncrement < 0 &&
        dst >= runtime->getStackPointer()) &&
           "reading off the end of the stack");
-  const GCHermesValue *src = &savedContext_.get(runtime)->at(frameOffset);
-  std::memcpy(dst, src, frameSize * sizeof(PinnedHermesValue));
+  const GCHermesValue *src = StackFrameLayout::StackIncrement > 0
+      ? &savedContext_.get(runtime)->at(frameOffset)
+      : &savedContext_.get(runtime)->at(frameOffset + frameSize - count);
+  std::memcpy(dst, src, count * sizeof(PinnedHermesValue));
 }
 
-void GeneratorInnerFunction::saveStack(Runtime *runtime) {
+void GeneratorInnerFunction::saveStack(Runtime *runtime, uint32_t numRegs) {
   const uint32_t frameOffset = getFrameOffsetInContext();
   const uint32_t frameSize = getFrameSizeInContext(runtime);
+  const uint32_t count = std::min(
+      numRegs + StackFrameLayout::CalleeExtraRegistersAtStart, frameSize);
+  ArrayStorage *ctx = savedContext_.get(runtime);
+  // Clear the slots saved by a previous yield which this one doesn't
+  // overwrite, so they don't keep dead values alive.
+  for (uint32_t i = count; i < savedRegCount_; ++i) {
+    uint32_t idx = StackFrameLayout::StackIncrement > 0
+        ? frameOffset + i
+        : frameOffset + frameSize - 1 - i;
+    ctx->at(idx).setNonPtr(HermesValue::encodeUndefinedValue());
+  }
+  savedRegCount_ = count;
   // Start at the lower end of the range to be copied.
   PinnedHermesValue *first = StackFrameLayout::StackIncrement > 0
       ? runtime->getCurrentFrame().ptr()
-      : runtime->getCurrentFrame().ptr() - frameSize;
+      : runtime->getCurrentFrame().ptr() - count;
   assert(
       (StackFrameLayout::StackIncrement > 0 &&
-       first + frameSize <= runtime->getStackPointer()) ||
+       first + count <= runtime->getStackPointer()) ||
       (StackFrameLayout::StackIncrement < 0 &&
        first >= runtime->getStackPointer()) &&
           "reading off the end of the stack");
   // Use GCHermesValue::copy to ensure write barriers are executed.
   GCHermesValue::copy(
       first,
-      first + frameSize,
-      &savedContext_.get(runtime)->at(frameOffset),
+      first + count,
+      StackFrameLayout::StackIncrement > 0
+          ? &ctx->at(frameOffset)
+          : &ctx->at(frameOffset + frameSize - count),
       &runtime->getHeap());
 }
 
@@ -15,8 +15,10 @@
 #include "hermes/Support/Conversions.h"
 #include "hermes/Support/OSCompat.h"
 #include "hermes/Support/PerfSection.h"
+#include "hermes/Support/TraceEvents.h"
 #include "hermes/VM/Debugger/Debugger.h"
 #include "hermes/VM/GCPointer-inline.h"
+#include "hermes/VM/JSObject.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/RuntimeModule.h"
 #include "hermes/VM/SerializedLiteralParser.h"
@@ -134,6 +136,14 @@ CodeBlock *CodeBlock::createCodeBlock(
       {bytecode, header.bytecodeSizeInBytes()}, header.frameSize());
 #endif
 
+  return CodeBlock::create(runtimeModule, header, bytecode, functionID);
+}
+
+void CodeBlock::allocatePropertyCache() {
+  // A lazy function can't run, and so use its cache, before it is compiled,
+  // so the header has its final cache indices by now.
+  assert(!isLazy() && "Property cache of a lazy function");
+
   // Compute size needed for caching from the highest accessed indices.
   // If the highest access index is 0, that function does not use this cache at
   // all so there is no reason to allocate it. If the function does access the
@@ -142,23 +152,24 @@ CodeBlock *CodeBlock::createCodeBlock(
     return highest == 0 ? 0 : highest + 1;
   };
 
-  uint32_t readCacheSize = sizeComputer(header.highestReadCacheIndex());
+  uint32_t readCacheSize =
+      sizeComputer(functionHeader_.highestReadCacheIndex());
   uint32_t cacheSize =
-      readCacheSize + sizeComputer(header.highestWriteCacheIndex());
-
-#ifndef HERMESVM_LEAN
-  bool isCodeBlockLazy = !bytecode;
-  if (!runtimeModule->isInitialized() || isCodeBlockLazy) {
-    readCacheSize = sizeComputer(std::numeric_limits<uint8_t>::max());
-    cacheSize = 2 * readCacheSize;
-  }
-#endif
-
-  return CodeBlock::create(
-      runtimeModule, header, bytecode, functionID, cacheSize, readCacheSize);
+      readCacheSize + sizeComputer(functionHeader_.highestWriteCacheIndex());
+  // Functions that use no cache still get a single entry, so that they don't
+  // come back here.
+  PropertyCacheEntry *cache =
+      runtimeModule_->allocatePropertyCache(std::max(cacheSize, 1u));
+  propertyCache_ = cache;
+  propertyCacheSize_ = cacheSize;
+  writePropCacheOffset_ = readCacheSize;
 }
 
 int32_t CodeBlock::findCatchTargetOffset(uint32_t exceptionOffset) {
+  // Most functions have no handler, which the header tells without looking up
+  // the table, while unwinding through every frame.
+  if (!functionHeader_.flags().hasExceptionHandler)
+    return -1;
   return runtimeModule_->getBytecode()->findCatchTargetOffset(
       functionID_, exceptionOffset);
 }
@@ -245,6 +256,10 @@ SourceErrorManager::SourceCoords CodeBlock::getLazyFunctionLoc(
   auto *func = ((hbc::BCProviderLazy *)runtimeModule_->getBytecode())
                    ->getBytecodeFunction();
   auto *lazyData = func->getLazyCompilationData();
+  // Another thread may be compiling a function of the same source.
+  auto *root = static_cast<hbc::BCProviderFromSrc *>(
+      runtimeModule_->getLazyRootModule()->getBytecode());
+  auto compilerLock = root->getLazyFunctionCache().lockCompiler();
   lazyData->context->getSourceErrorManager().findBufferLineAndLoc(
       start ? lazyData->span.Start : lazyData->span.End, coords);
 #endif
@@ -252,7 +267,6 @@ SourceErrorManager::SourceCoords CodeBlock::getLazyFunctionLoc(
 }
 
 #ifndef HERMESVM_LEAN
-namespace {
 std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
     hbc::LazyCompilationData *lazyData) {
   assert(lazyData);
@@ -268,16 +282,49 @@ std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
 
   return bytecodeModule;
 }
-} // namespace
 
 void CodeBlock::lazyCompileImpl(Runtime *runtime) {
   assert(isLazy() && "Laziness has not been checked");
   PerfSection perf("Lazy function compilation");
   auto *func = ((hbc::BCProviderLazy *)runtimeModule_->getBytecode())
                    ->getBytecodeFunction();
-  auto bcMod = compileLazyFunction(func->getLazyCompilationData());
-  runtimeModule_->initializeLazyMayAllocate(
-      hbc::BCProviderFromSrc::createBCProviderFromSrc(std::move(bcMod)));
+  auto *lazyData = func->getLazyCompilationData();
+  trace::Scope traceScope(trace::Category::Compile, "lazyCompile");
+  if (traceScope.enabled() && lazyData->originalName.isValid())
+    traceScope.addArg("function", lazyData->originalName.str());
+  auto *queue = runtime->getLazyCompileQueue();
+  // The function may have been compiled by another runtime running the same
+  // source, in which case its bytecode is shared.
+  auto &cache = static_cast<hbc::BCProviderFromSrc *>(
+                    runtimeModule_->getLazyRootModule()->getBytecode())
+                    ->getLazyFunctionCache();
+  std::shared_ptr<hbc::BCProviderBase> compiled = cache.find(lazyData);
+  if (!compiled) {
+    // An earlier run of the same source may have stored it on disk.
+    if (auto stored = cache.load(lazyData)) {
+      LLVM_DEBUG(
+          llvm::dbgs() << "Loaded lazy function " << lazyData->originalName
+                       << " from disk\n");
+      compiled = cache.insert(lazyData, std::move(stored));
+    }
+  }
+  if (compiled) {
+    if (queue)
+      queue->cancel(lazyData);
+  } else {
+    std::unique_ptr<hbc::BytecodeModule> bcMod;
+    if (queue) {
+      bcMod = queue->take(cache, lazyData);
+    } else {
+      auto compilerLock = cache.lockCompiler();
+      bcMod = compileLazyFunction(lazyData);
+    }
+    cache.store(lazyData, *bcMod);
+    compiled = cache.insert(
+        lazyData,
+        hbc::BCProviderFromSrc::createBCProviderFromSrc(std::move(bcMod)));
+  }
+  runtimeModule_->initializeLazyMayAllocate(std::move(compiled));
   // Reset all meta data of the CodeBlock to point to the newly
   // generated bytecode module.
   functionID_ = runtimeModule_->getBytecode()->getGlobalFunctionIndex();
@@ -290,12 +337,36 @@ void CodeBlock::lazyCompileImpl(Runtime *runtime) {
 void CodeBlock::markCachedHiddenClasses(
     Runtime *runtime,
     WeakRootAcceptor &acceptor) {
+  // The cache is empty until it has been allocated.
   for (auto &prop :
-       llvm::makeMutableArrayRef(propertyCache(), propertyCacheSize_)) {
+       llvm::makeMutableArrayRef(propertyCache_, propertyCacheSize_)) {
     if (prop.clazz) {
       acceptor.acceptWeak(prop.clazz);
     }
+    for (auto &clazz : prop.polyClazz) {
+      if (clazz) {
+        acceptor.acceptWeak(clazz);
+      }
+    }
+    for (auto &clazz : prop.protoClazz) {
+      if (clazz) {
+        acceptor.acceptWeak(clazz);
+      }
+    }
+  }
+}
+
+uint32_t CodeBlock::getNumConstructedProperties(Runtime *runtime) {
+  if (lastConstructed_) {
+    uint32_t numProperties =
+        lastConstructed_->getClass(runtime)->getNumProperties();
+    if (numProperties > HiddenClass::kDictionaryThreshold)
+      numProperties = HiddenClass::kDictionaryThreshold;
+    if (numProperties > numConstructedProperties_)
+      numConstructedProperties_ = numProperties;
+    lastConstructed_ = nullptr;
   }
+  return numConstructedProperties_;
 }
 
 uint32_t CodeBlock::getVirtualOffset() const {
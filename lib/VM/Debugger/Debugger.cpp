@@ -31,7 +31,8 @@ namespace fhd = ::facebook::hermes::debugger;
 // These instructions won't recursively invoke the interpreter,
 // and we also can't easily determine where they will jump to.
 static inline bool shouldSingleStep(OpCode opCode) {
-  return opCode == OpCode::Throw || opCode == OpCode::SwitchImm;
+  return opCode == OpCode::Throw || opCode == OpCode::SwitchImm ||
+      opCode == OpCode::SwitchStr || opCode == OpCode::SwitchSparse;
 }
 
 static StringView getFunctionName(
@@ -142,6 +143,7 @@ ExecutionStatus Debugger::runDebugger(
     InterpreterState &state) {
   assert(!isDebugging_ && "can't run debugger while debugging is in progress");
   isDebugging_ = true;
+  isActive_ = true;
 
   // We're going to derive a PauseReason to pass to the event observer. OptValue
   // is used to check our logic which is rather complicated.
@@ -248,30 +250,6 @@ ExecutionStatus Debugger::runDebugger(
         return ExecutionStatus::RETURNED;
       }
     } else {
-      auto checkBreakpointCondition =
-          [&](const std::string &condition) -> bool {
-        if (condition.empty()) {
-          // The empty condition is considered unset,
-          // and we always pause on such breakpoints.
-          return true;
-        }
-        EvalResultMetadata metadata;
-        EvalArgs args;
-        args.frameIdx = 0;
-        // No handle here - we will only pass the value to toBoolean,
-        // and no allocations should occur until then.
-        HermesValue conditionResult =
-            evalInFrame(args, condition, state, &metadata);
-        NoAllocScope noAlloc(runtime_);
-        if (metadata.isException) {
-          // Ignore exceptions.
-          // Cleanup is done by evalInFrame.
-          return false;
-        }
-        noAlloc.release();
-        return toBoolean(conditionResult);
-      };
-
       // We've stopped on either a user breakpoint or a debugger statement.
       // Note: if we've stopped on both (breakpoint set on a debugger statement)
       // then we only report the breakpoint and move past it,
@@ -280,9 +258,11 @@ ExecutionStatus Debugger::runDebugger(
         assert(
             breakpointOpt->user.hasValue() &&
             "must be stopped on a user breakpoint");
-        const auto &condition =
-            userBreakpoints_[*breakpointOpt->user].condition;
-        if (checkBreakpointCondition(condition)) {
+        // The empty condition is considered unset, and we always pause on
+        // such breakpoints.
+        BreakpointID id = *breakpointOpt->user;
+        if (userBreakpoints_[id].condition.empty() ||
+            evalBreakpointCondition(id)) {
           pauseReason = PauseReason::Breakpoint;
           breakpoint = *(breakpointOpt->user);
         } else {
@@ -474,6 +454,7 @@ void Debugger::willUnloadModule(RuntimeModule *module) {
   for (auto &bp : userBreakpoints_) {
     if (unloadingBlocks.count(bp.second.codeBlock)) {
       unresolveBreakpointLocation(bp.second);
+      compiledConditions_.erase(bp.first);
     }
   }
 
@@ -615,6 +596,7 @@ void Debugger::setBreakpointCondition(BreakpointID id, std::string condition) {
 
   auto &breakpoint = it->second;
   breakpoint.condition = std::move(condition);
+  compiledConditions_.erase(id);
 }
 
 void Debugger::deleteBreakpoint(BreakpointID id) {
@@ -629,6 +611,7 @@ void Debugger::deleteBreakpoint(BreakpointID id) {
     unsetUserBreakpoint(breakpoint);
   }
   userBreakpoints_.erase(it);
+  compiledConditions_.erase(id);
 }
 
 void Debugger::deleteAllBreakpoints() {
@@ -639,6 +622,7 @@ void Debugger::deleteAllBreakpoints() {
     }
   }
   userBreakpoints_.clear();
+  compiledConditions_.clear();
 }
 
 void Debugger::setBreakpointEnabled(BreakpointID id, bool enable) {
@@ -1036,6 +1020,82 @@ HermesValue Debugger::evalInFrame(
   return *resultHandle;
 }
 
+bool Debugger::evalBreakpointCondition(BreakpointID id) {
+  GCScope gcScope{runtime_};
+  auto frameInfo = runtime_->stackFrameInfoByIndex(0);
+  if (!frameInfo) {
+    return false;
+  }
+
+  // Environment may be undefined if it has not been created yet, in which
+  // case evalInFrame would bail out too.
+  Handle<Environment> env = frameInfo->frame->getDebugEnvironmentHandle();
+  if (!env) {
+    return false;
+  }
+
+  // Interpreting code requires that the `thrownValue_` is empty.
+  // Save it temporarily so we can restore it after evaluating the condition.
+  Handle<> savedThrownValue = runtime_->makeHandle(runtime_->getThrownValue());
+  runtime_->clearThrownValue();
+
+  auto it = compiledConditions_.find(id);
+  if (it == compiledConditions_.end()) {
+    CompiledCondition compiled{};
+    const CodeBlock *cb = frameInfo->frame->getCalleeCodeBlock();
+    // Without variable debug info, or if the condition has a syntax error,
+    // the condition is left uncompiled and the breakpoint never pauses.
+    if (auto scopeChain = scopeChainForBlock(runtime_, cb)) {
+      auto bytecodeRes = compileEvalCode(
+          runtime_, userBreakpoints_[id].condition, *scopeChain, false);
+      if (bytecodeRes != ExecutionStatus::EXCEPTION) {
+        auto globalFunctionIndex = (*bytecodeRes)->getGlobalFunctionIndex();
+        Handle<Domain> domain = toHandle(runtime_, Domain::create(runtime_));
+        auto runtimeModuleRes =
+            RuntimeModule::create(runtime_, domain, std::move(*bytecodeRes));
+        if (runtimeModuleRes != ExecutionStatus::EXCEPTION) {
+          compiled.codeBlock =
+              (*runtimeModuleRes)->getCodeBlockMayAllocate(globalFunctionIndex);
+          // Only read the domain now that nothing allocates before it is
+          // stored where it is marked.
+          compiled.domain = domain.getHermesValue();
+        }
+      }
+    }
+    it = compiledConditions_.insert({id, compiled}).first;
+  }
+
+  bool result = false;
+  if (CodeBlock *codeBlock = it->second.codeBlock) {
+    // Close over the environment of this frame, as the global function of a
+    // local eval does.
+    auto funcRes = JSFunction::create(
+        runtime_,
+        runtime_->makeHandle(vmcast<Domain>(it->second.domain)),
+        Handle<JSObject>::vmcast(&runtime_->functionPrototype),
+        env,
+        codeBlock);
+    if (funcRes != ExecutionStatus::EXCEPTION) {
+      auto func = runtime_->makeHandle<JSFunction>(*funcRes);
+      auto conditionRes = Callable::executeCall0(
+          func, runtime_, Handle<>(&frameInfo->frame->getThisArgRef()));
+      // Ignore exceptions.
+      if (conditionRes != ExecutionStatus::EXCEPTION) {
+        result = toBoolean(*conditionRes);
+      }
+    }
+  }
+
+  runtime_->setThrownValue(savedThrownValue.getHermesValue());
+  return result;
+}
+
+void Debugger::markRoots(SlotAcceptor &acceptor) {
+  for (auto &it : compiledConditions_) {
+    acceptor.accept(it.second.domain);
+  }
+}
+
 llvm::Optional<std::pair<InterpreterState, uint32_t>> Debugger::findCatchTarget(
     const InterpreterState &state) const {
   auto *codeBlock = state.codeBlock;
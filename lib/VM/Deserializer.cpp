@@ -53,14 +53,14 @@ void Deserializer::deserializeCompactTable(CompactTable &table) {
 }
 
 void Deserializer::flushRelocationQueue() {
-  while (!relocationQueue_.empty()) {
-    auto entry = relocationQueue_.front();
-    relocationQueue_.pop_front();
+  for (const RelocationEntry &entry : relocationQueue_) {
     assert(entry.id < objectTable_.size() && "invalid relocation id");
     void *ptr = objectTable_[entry.id];
     assert(ptr && "pointer relocation cannot be resolved");
     updateAddress(entry.address, ptr, entry.kind);
   }
+  relocationQueue_.clear();
+  relocationQueue_.shrink_to_fit();
 }
 
 void Deserializer::init(
@@ -9,12 +9,71 @@
 #include "hermes/VM/DictPropertyMap.h"
 #include "hermes/Support/Statistic.h"
 
+#include "llvm/Support/MathExtras.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 HERMES_SLOW_STATISTIC(NumDictLookups, "Number of dictionary lookups");
 HERMES_SLOW_STATISTIC(NumExtraHashProbes, "Number of extra hash probes");
 
 namespace hermes {
 namespace vm {
 
+namespace detail {
+
+DPMHashPair::GroupMatch DPMHashPair::matchGroup(
+    const DPMHashPair *group,
+    SymbolID id) {
+  static_assert(kGroupSize == 4, "groups are vectors of 4 x uint32_t");
+  const uint32_t idPart = id.unsafeGetRaw() & ID_MASK;
+#if defined(__SSE2__)
+  __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+  // The descriptor part is less than 2^DESC_BITS, so signed compares work.
+  __m128i desc = _mm_srli_epi32(raw, ID_BITS);
+  __m128i valid = _mm_cmpgt_epi32(desc, _mm_set1_epi32(DELETED));
+  __m128i sameId = _mm_cmpeq_epi32(
+      _mm_and_si128(raw, _mm_set1_epi32(ID_MASK)), _mm_set1_epi32(idPart));
+  auto toMask = [](__m128i lanes) -> unsigned {
+    return _mm_movemask_ps(_mm_castsi128_ps(lanes));
+  };
+  return {toMask(_mm_and_si128(valid, sameId)),
+          toMask(_mm_cmpeq_epi32(desc, _mm_set1_epi32(DELETED))),
+          toMask(_mm_cmpeq_epi32(desc, _mm_setzero_si128()))};
+#elif defined(__aarch64__)
+  uint32x4_t raw = vld1q_u32(reinterpret_cast<const uint32_t *>(group));
+  uint32x4_t desc = vshrq_n_u32(raw, ID_BITS);
+  uint32x4_t valid = vcgtq_u32(desc, vdupq_n_u32(DELETED));
+  uint32x4_t sameId =
+      vceqq_u32(vandq_u32(raw, vdupq_n_u32(ID_MASK)), vdupq_n_u32(idPart));
+  const uint32_t laneBits[kGroupSize] = {1, 2, 4, 8};
+  uint32x4_t bits = vld1q_u32(laneBits);
+  auto toMask = [bits](uint32x4_t lanes) -> unsigned {
+    return vaddvq_u32(vandq_u32(lanes, bits));
+  };
+  return {toMask(vandq_u32(valid, sameId)),
+          toMask(vceqq_u32(desc, vdupq_n_u32(DELETED))),
+          toMask(vceqq_u32(desc, vdupq_n_u32(EMPTY)))};
+#else
+  GroupMatch match{0, 0, 0};
+  for (uint32_t i = 0; i != kGroupSize; ++i) {
+    uint32_t desc = group[i].getDesc();
+    if (desc >= FIRST_VALID && (group[i].raw_ & ID_MASK) == idPart)
+      match.candidates |= 1u << i;
+    else if (desc == DELETED)
+      match.deleted |= 1u << i;
+    else if (desc == EMPTY)
+      match.empty |= 1u << i;
+  }
+  return match;
+#endif
+}
+
+} // namespace detail
+
 struct DictPropertyMap::detail {
   /// The upper bound of the search when trying to find the maximum capacity
   /// of this object, given GC::maxAllocationSize().
@@ -143,8 +202,12 @@ std::pair<bool, DictPropertyMap::HashPair *> DictPropertyMap::lookupEntryFor(
     SymbolID symbolID) {
   ++NumDictLookups;
 
-  size_type const mask = self->hashCapacity_ - 1;
-  size_type index = hash(symbolID) & mask;
+  // The table is probed a group of entries at a time, quadratically over the
+  // groups. An entry is always inserted at the first deleted or empty entry
+  // in this order, and entries never become empty again, so a group with an
+  // empty entry ends the search.
+  size_type const groupMask = self->hashCapacity_ / HashPair::kGroupSize - 1;
+  size_type group = hash(symbolID) & groupMask;
 
   // Probing step.
   size_type step = 1;
@@ -156,26 +219,29 @@ std::pair<bool, DictPropertyMap::HashPair *> DictPropertyMap::lookupEntryFor(
   assert(symbolID.isValid() && "looking for an invalid SymbolID");
 
   for (;;) {
-    HashPair *curEntry = tableStart + index;
+    HashPair *groupStart = tableStart + group * HashPair::kGroupSize;
+    auto match = HashPair::matchGroup(groupStart, symbolID);
 
-    if (curEntry->isValid()) {
+    for (unsigned bits = match.candidates; bits; bits &= bits - 1) {
+      HashPair *curEntry = groupStart + llvm::countTrailingZeros(bits);
       if (self->isMatch(curEntry, symbolID))
         return {true, curEntry};
-    } else if (curEntry->isEmpty()) {
+    }
+    // The first time we encounter a deleted entry, record it so we can
+    // potentially reuse it for insertion.
+    if (!deleted && match.deleted)
+      deleted = groupStart + llvm::countTrailingZeros(match.deleted);
+    if (match.empty) {
       // If we encountered an empty pair, the search is over - we failed.
-      // Return either this entry or a deleted one, if we encountered one.
-
-      return {false, deleted ? deleted : curEntry};
-    } else {
-      assert(curEntry->isDeleted() && "unexpected HashPair state");
-      // The first time we encounter a deleted entry, record it so we can
-      // potentially reuse it for insertion.
-      if (!deleted)
-        deleted = curEntry;
+      // Return either the first one or a deleted one, if we encountered one.
+      return {
+          false,
+          deleted ? deleted
+                  : groupStart + llvm::countTrailingZeros(match.empty)};
     }
 
     ++NumExtraHashProbes;
-    index = (index + step) & mask;
+    group = (group + step) & groupMask;
     ++step;
   }
 }
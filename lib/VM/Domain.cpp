@@ -12,6 +12,7 @@
 #include "hermes/VM/JSLib.h"
 #include "hermes/VM/Profiler/SamplingProfiler.h"
 
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Debug.h"
 #define DEBUG_TYPE "serialize"
 
@@ -96,8 +97,7 @@ void DomainDeserialize(Deserializer &d, CellKind kind) {
   void *mem = d.getRuntime()->alloc</*fixedSize*/ true, HasFinalizer::Yes>(
       cellSize<Domain>());
   auto *cell = new (mem) Domain(d);
-  auto &samplingProfiler = SamplingProfiler::getInstance();
-  samplingProfiler->increaseDomainCount();
+  SamplingProfiler::increaseDomainCount();
   d.endObject(cell);
 }
 
@@ -141,16 +141,14 @@ PseudoHandle<Domain> Domain::create(Runtime *runtime) {
   void *mem =
       runtime->alloc</*fixedSize*/ true, HasFinalizer::Yes>(cellSize<Domain>());
   auto self = createPseudoHandle(new (mem) Domain(runtime));
-  auto &samplingProfiler = SamplingProfiler::getInstance();
-  samplingProfiler->increaseDomainCount();
+  SamplingProfiler::increaseDomainCount();
   return self;
 }
 
 void Domain::_finalizeImpl(GCCell *cell, GC *gc) {
   auto *self = vmcast<Domain>(cell);
   self->~Domain();
-  auto &samplingProfiler = SamplingProfiler::getInstance();
-  samplingProfiler->decreaseDomainCount();
+  SamplingProfiler::decreaseDomainCount();
 }
 
 Domain::~Domain() {
@@ -173,7 +171,54 @@ void Domain::markWeakRefs(WeakRefAcceptor &acceptor) {
 size_t Domain::_mallocSizeImpl(GCCell *cell) {
   auto *self = vmcast<Domain>(cell);
   return self->cjsModuleTable_.getMemorySize() +
-      self->runtimeModules_.capacity_in_bytes();
+      self->runtimeModules_.capacity_in_bytes() +
+      self->prefetchedCJSModules_.capacity() / 8;
+}
+
+OptValue<uint32_t> Domain::findSegmentOfModule(uint32_t id) const {
+  for (const RuntimeModule *rm : runtimeModules_) {
+    for (const auto &entry : rm->getBytecode()->getSegmentTable()) {
+      if (id >= entry.firstModule && id - entry.firstModule < entry.moduleCount)
+        return entry.segment;
+    }
+  }
+  return llvm::None;
+}
+
+void Domain::prefetchCJSModuleDependencies(
+    Runtime *runtime,
+    uint32_t cjsModuleOffset) {
+  uint32_t moduleCount = cjsModules_.get(runtime)->size() / CJSModuleSize;
+  if (prefetchedCJSModules_.size() < moduleCount) {
+    prefetchedCJSModules_.resize(moduleCount);
+  }
+
+  // Each module is only visited once, so that requiring all the modules of a
+  // bundle visits every dependency once.
+  const uint32_t rootID = cjsModuleOffset / CJSModuleSize;
+  llvm::SmallVector<uint32_t, 8> worklist;
+  worklist.push_back(rootID);
+  while (!worklist.empty()) {
+    uint32_t id = worklist.pop_back_val();
+    OptValue<uint32_t> offset = getCJSModuleOffset(runtime, id);
+    if (!offset || prefetchedCJSModules_[id]) {
+      continue;
+    }
+    prefetchedCJSModules_[id] = true;
+    // A module which has been required has required its own dependencies.
+    if (id != rootID && getModule(runtime, *offset)) {
+      continue;
+    }
+
+    hbc::BCProvider *bcProvider =
+        getRuntimeModule(runtime, *offset)->getBytecode();
+    if (id != rootID) {
+      bcProvider->willNeedFunction(getFunctionIndex(runtime, *offset));
+    }
+    auto dependencies = bcProvider->getCJSModuleDependencies(
+        id - bcProvider->getCJSModuleOffset());
+    worklist.append(dependencies.begin(), dependencies.end());
+  }
 }
 
 ExecutionStatus Domain::importCJSModuleTable(
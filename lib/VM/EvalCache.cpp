@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/EvalCache.h"
+
+#include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+
+namespace hermes {
+namespace vm {
+
+EvalCache::Key EvalCache::makeKey(
+    llvm::StringRef source,
+    const hbc::CompileFlags &flags,
+    const ScopeChain &scopeChain) {
+  Key key;
+  key.push_back(
+      flags.optimize | flags.debug << 1 | flags.lazy << 2 | flags.strict << 3 |
+      flags.verifyIR << 4 | flags.emitAsyncBreakCheck << 5 |
+      flags.includeLibHermes << 6);
+  key.push_back(
+      flags.staticBuiltins.hasValue() ? 1 + *flags.staticBuiltins : 0);
+  // Identifiers are never empty and can't contain a NUL, so a NUL terminates
+  // every name, and another one the names of every function.
+  key.append(std::to_string(scopeChain.functions.size()));
+  key.push_back(':');
+  for (const ScopeChainItem &function : scopeChain.functions) {
+    for (llvm::StringRef name : function.variables) {
+      key.append(name.begin(), name.end());
+      key.push_back(0);
+    }
+    key.push_back(0);
+  }
+  key.append(source.begin(), source.end());
+  return key;
+}
+
+std::shared_ptr<hbc::BCProviderFromSrc> EvalCache::lookup(
+    llvm::StringRef source,
+    const hbc::CompileFlags &flags,
+    const ScopeChain &scopeChain) {
+  if (capacity_ == 0)
+    return nullptr;
+  auto it = index_.find(makeKey(source, flags, scopeChain));
+  if (it == index_.end()) {
+    ++numMisses_;
+    return nullptr;
+  }
+  ++numHits_;
+  // Make it the most recently used entry.
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->bytecode;
+}
+
+void EvalCache::insert(
+    llvm::StringRef source,
+    const hbc::CompileFlags &flags,
+    const ScopeChain &scopeChain,
+    std::shared_ptr<hbc::BCProviderFromSrc> bytecode) {
+  if (capacity_ == 0)
+    return;
+  Key key = makeKey(source, flags, scopeChain);
+  if (index_.count(key))
+    return;
+  if (entries_.size() == capacity_) {
+    Entry &last = entries_.back();
+    keyBytes_ -= last.key.size();
+    index_.erase(last.key);
+    entries_.pop_back();
+    ++numEvictions_;
+  }
+  keyBytes_ += key.size();
+  entries_.push_front(Entry{key, std::move(bytecode)});
+  index_.emplace(std::move(key), entries_.begin());
+}
+
+void EvalCache::printStats(llvm::raw_ostream &os) const {
+  if (numHits_ == 0 && numMisses_ == 0)
+    return;
+  os << "Eval cache stats:\n"
+     << "{\n"
+     << "\t\"capacity\": " << capacity_ << ",\n"
+     << "\t\"numEntries\": " << entries_.size() << ",\n"
+     << "\t\"sourceBytes\": " << keyBytes_ << ",\n"
+     << "\t\"numHits\": " << numHits_ << ",\n"
+     << "\t\"numMisses\": " << numMisses_ << ",\n"
+     << "\t\"numEvictions\": " << numEvictions_ << "\n"
+     << "}\n";
+}
+
+} // namespace vm
+} // namespace hermes
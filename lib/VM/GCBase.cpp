@@ -13,7 +13,10 @@
 #include "hermes/Support/OSCompat.h"
 #include "hermes/VM/CellKind.h"
 #include "hermes/VM/GCPointer-inline.h"
+#include "hermes/VM/HostModel.h"
+#include "hermes/VM/JSArrayBuffer.h"
 #include "hermes/VM/Runtime.h"
+#include "hermes/VM/StringPrimitive.h"
 #include "hermes/VM/VTable.h"
 
 #include "llvm/Support/Debug.h"
@@ -23,6 +26,7 @@
 #include "llvm/Support/raw_ostream.h"
 
 #include <inttypes.h>
+#include <limits>
 #include <stdexcept>
 #include <system_error>
 
@@ -52,7 +56,8 @@ GCBase::GCBase(
       memEventTracker_(gcConfig.getMemEventTracker()),
 #endif
       tripwireCallback_(gcConfig.getTripwireConfig().getCallback()),
-      tripwireLimit_(gcConfig.getTripwireConfig().getLimit())
+      tripwireLimit_(gcConfig.getTripwireConfig().getLimit()),
+      collectionEventCallback_(gcConfig.getCollectionEventCallback())
 #ifdef HERMESVM_SANITIZE_HANDLES
       ,
       sanitizeRate_(gcConfig.getSanitizeConfig().getSanitizeRate())
@@ -87,6 +92,9 @@ GCBase::GCBase(
   }
   randomEngine_.seed(seed);
 #endif
+  if (gcConfig.getBackgroundFinalization()) {
+    backgroundFreer_.reset(new BackgroundFreer());
+  }
 }
 
 GCBase::GCCycle::GCCycle(
@@ -97,6 +105,7 @@ GCBase::GCCycle::GCCycle(
       gcCallbacksOpt_(gcCallbacksOpt),
       extraInfo_(std::move(extraInfo)) {
   gc_->inGC_ = true;
+  traceScope_.addArg("info", extraInfo_);
   if (gcCallbacksOpt_.hasValue()) {
     gcCallbacksOpt_.getValue()->onGCEvent(
         GCCallbacks::GCEventKind::CollectionStart, extraInfo_);
@@ -109,6 +118,37 @@ GCBase::GCCycle::~GCCycle() {
         GCCallbacks::GCEventKind::CollectionEnd, extraInfo_);
   }
   gc_->inGC_ = false;
+  if (gc_->backgroundFreer_) {
+    gc_->backgroundFreer_->enqueue(gc_->deferredFrees_);
+  }
+}
+
+void GCBase::waitForBackgroundFrees() {
+  if (backgroundFreer_) {
+    backgroundFreer_->waitUntilIdle();
+  }
+}
+
+bool GCBase::hasObservableFinalizer(GCCell *cell) {
+  if (vmisa<HostObject>(cell) || vmisa<FinalizableNativeFunction>(cell))
+    return true;
+  if (auto *str = dyn_vmcast<ExternalASCIIStringPrimitive>(cell))
+    return str->isForeign();
+  if (auto *str = dyn_vmcast<ExternalUTF16StringPrimitive>(cell))
+    return str->isForeign();
+  auto *buffer = dyn_vmcast<JSArrayBuffer>(cell);
+  return buffer && buffer->hasExternalDataBlock();
+}
+
+uint64_t GCBase::finalizeForFastTeardown(GCCell *cell, GC *gc) {
+  const VTable *vt = cell->getVT();
+  if (!hasObservableFinalizer(cell)) {
+    const uint64_t mallocSize = vt->getMallocSize(cell);
+    if (mallocSize < kFastTeardownMinFreedBytes)
+      return mallocSize;
+  }
+  vt->finalizeIfExists(cell, gc);
+  return 0;
 }
 
 void GCBase::runtimeWillExecute() {
@@ -167,6 +207,7 @@ void GCBase::printAllCollectedStats(llvm::raw_ostream &os) {
 
 void GCBase::getHeapInfo(HeapInfo &info) {
   info.numCollections = cumStats_.numCollections;
+  info.phaseTimes = cumStats_.phaseTimes;
 }
 
 #ifndef NDEBUG
@@ -306,6 +347,97 @@ void GCBase::recordGCStats(
       wallTime, cpuTime, finalHeapSize, usedBefore, usedAfter, &cumStats_);
 }
 
+constexpr unsigned GCBase::PhaseHistogram::kNumBuckets;
+constexpr double GCBase::PhaseHistogram::kFirstBucketLimitSecs;
+
+/* static */ double GCBase::PhaseHistogram::bucketLimitSecs(unsigned bucket) {
+  assert(bucket < kNumBuckets && "Bucket out of range");
+  if (bucket == kNumBuckets - 1) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return kFirstBucketLimitSecs * static_cast<double>(1u << bucket);
+}
+
+void GCBase::PhaseHistogram::record(double wallSecs, double cpuSecs) {
+  wallTime.record(wallSecs);
+  cpuTime.record(cpuSecs);
+  unsigned bucket = 0;
+  while (wallSecs >= bucketLimitSecs(bucket)) {
+    ++bucket;
+  }
+  ++buckets[bucket];
+}
+
+GCBase::GCPhaseTimer::GCPhaseTimer(GCBase *gc, GCPhase phase)
+    : gc_(gc),
+      phase_(phase),
+      wallStart_(std::chrono::steady_clock::now()),
+      cpuStart_(oscompat::thread_cpu_time()),
+      traceScope_(trace::Category::GC, gcPhaseName(phase)) {
+  if (gc_->sampleHardwareCounters_)
+    instrumentation::PerfEvents::readThreadCounters(countersStart_);
+}
+
+GCBase::GCPhaseTimer::~GCPhaseTimer() {
+  const auto idx = static_cast<unsigned>(phase_);
+  gc_->collectionEvent_.phaseWallSecs[idx] +=
+      clockDiffSeconds(wallStart_, std::chrono::steady_clock::now());
+  gc_->collectionEvent_.phaseCPUSecs[idx] +=
+      clockDiffSeconds(cpuStart_, oscompat::thread_cpu_time());
+  instrumentation::HardwareCounters countersEnd;
+  if (gc_->sampleHardwareCounters_ &&
+      instrumentation::PerfEvents::readThreadCounters(countersEnd))
+    gc_->phaseCounters_[idx] += countersEnd - countersStart_;
+}
+
+void GCBase::beginCollectionEvent(bool youngGen) {
+  collectionEvent_ = GCCollectionEvent();
+  collectionEvent_.youngGen = youngGen;
+  phaseCounters_ = {};
+}
+
+void GCBase::recordCollectionEvent(
+    double wallTime,
+    double cpuTime,
+    gcheapsize_t usedBefore,
+    gcheapsize_t usedAfter,
+    CumulativeHeapStats *regionStats) {
+  GCCollectionEvent &event = collectionEvent_;
+  event.wallSecs = wallTime;
+  event.cpuSecs = cpuTime;
+  event.usedBefore = usedBefore;
+  event.usedAfter = usedAfter;
+  // A young-gen collection empties the young generation, so what survived it
+  // is what it promoted.
+  event.survivingBytes = event.youngGen ? event.promotedBytes : usedAfter;
+
+  for (unsigned i = 0; i < kNumGCPhases; ++i) {
+    // Leave out the phases the collection did not go through, so that they do
+    // not skew the histograms.
+    if (event.phaseWallSecs[i] == 0.0) {
+      continue;
+    }
+    cumStats_.phaseTimes[i].record(
+        event.phaseWallSecs[i], event.phaseCPUSecs[i]);
+    cumStats_.phaseTimes[i].counters += phaseCounters_[i];
+    if (regionStats) {
+      regionStats->phaseTimes[i].record(
+          event.phaseWallSecs[i], event.phaseCPUSecs[i]);
+      regionStats->phaseTimes[i].counters += phaseCounters_[i];
+    }
+  }
+  if (event.youngGen) {
+    cumStats_.promotedBytes.record(event.promotedBytes);
+    if (regionStats) {
+      regionStats->promotedBytes.record(event.promotedBytes);
+    }
+  }
+
+  if (collectionEventCallback_) {
+    collectionEventCallback_(event);
+  }
+}
+
 void GCBase::oom(std::error_code reason) {
 #ifdef HERMESVM_EXCEPTION_ON_OOM
   HeapInfo heapInfo;
@@ -30,6 +30,8 @@ PinnedHermesValue HandleRootOwner::falseValue_{
 void HandleRootOwner::markGCScopes(SlotAcceptor &acceptor) {
   for (GCScope *gcScope = topGCScope_; gcScope; gcScope = gcScope->prevScope_)
     gcScope->mark(acceptor);
+  for (HandleArrayBase *array = topHandleArray_; array; array = array->prev_)
+    array->mark(acceptor);
 }
 
 void HandleRootOwner::markWeakRefs(WeakRefAcceptor &acceptor) {
@@ -12,6 +12,7 @@
 #include "hermes/Support/UTF8.h"
 #include "hermes/VM/StringPrimitive.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 #include <type_traits>
@@ -78,6 +79,9 @@ void HeapSnapshot::endSection(Section section) {
   json_.closeArray();
   nextSection_ = static_cast<Section>(index(section) + 1);
   sectionOpened_ = false;
+  if (section == Section::Nodes) {
+    indexNodes();
+  }
 }
 
 void HeapSnapshot::beginNode() {
@@ -101,9 +105,7 @@ void HeapSnapshot::endNode(
     return;
   }
   assert(nextSection_ == Section::Nodes && sectionOpened_);
-  auto res = nodeToIndex_.try_emplace(id, nodeCount_++);
-  assert(res.second);
-  (void)res;
+  nodeIDs_.push_back(id);
   json_.emitValue(index(type));
   json_.emitValue(stringTable_.insert(name));
   json_.emitValue(id);
@@ -132,10 +134,8 @@ void HeapSnapshot::addNamedEdge(
   json_.emitValue(index(type));
   json_.emitValue(stringTable_.insert(name));
 
-  auto nodeIt = nodeToIndex_.find(toNode);
-  assert(nodeIt != nodeToIndex_.end());
   // Point to the beginning of the target node in the `nodes` flat array.
-  json_.emitValue(nodeIt->second * V8_SNAPSHOT_NODE_FIELD_COUNT);
+  json_.emitValue(getNodeIndex(toNode) * V8_SNAPSHOT_NODE_FIELD_COUNT);
 }
 
 void HeapSnapshot::addIndexedEdge(
@@ -155,10 +155,8 @@ void HeapSnapshot::addIndexedEdge(
   json_.emitValue(index(type));
   json_.emitValue(edgeIndex);
 
-  auto nodeIt = nodeToIndex_.find(toNode);
-  assert(nodeIt != nodeToIndex_.end());
   // Point to the beginning of the target node in the `nodes` flat array.
-  json_.emitValue(nodeIt->second * V8_SNAPSHOT_NODE_FIELD_COUNT);
+  json_.emitValue(getNodeIndex(toNode) * V8_SNAPSHOT_NODE_FIELD_COUNT);
 }
 
 void HeapSnapshot::addLocation(
@@ -169,11 +167,7 @@ void HeapSnapshot::addLocation(
   assert(
       nextSection_ == Section::Locations && sectionOpened_ &&
       "Shouldn't be emitting locations until the location section starts");
-  auto nodeIt = nodeToIndex_.find(id);
-  assert(
-      nodeIt != nodeToIndex_.end() &&
-      "Couldn't add a location for an object that doesn't exist");
-  json_.emitValue(nodeIt->second * V8_SNAPSHOT_NODE_FIELD_COUNT);
+  json_.emitValue(getNodeIndex(id) * V8_SNAPSHOT_NODE_FIELD_COUNT);
   json_.emitValue(script);
   // The serialized format uses 0-based indexing for line and column, but the
   // parameters are 1-based.
@@ -183,6 +177,38 @@ void HeapSnapshot::addLocation(
   json_.emitValue(column - 1);
 }
 
+void HeapSnapshot::indexNodes() {
+  indicesByID_.resize(nodeIDs_.size());
+  for (NodeIndex i = 0, e = indicesByID_.size(); i < e; ++i) {
+    indicesByID_[i] = i;
+  }
+  std::sort(
+      indicesByID_.begin(),
+      indicesByID_.end(),
+      [this](NodeIndex a, NodeIndex b) { return nodeIDs_[a] < nodeIDs_[b]; });
+#ifndef NDEBUG
+  for (NodeIndex i = 1, e = indicesByID_.size(); i < e; ++i) {
+    assert(
+        nodeIDs_[indicesByID_[i - 1]] != nodeIDs_[indicesByID_[i]] &&
+        "Two nodes have the same ID");
+  }
+#endif
+}
+
+HeapSnapshot::NodeIndex HeapSnapshot::getNodeIndex(NodeID id) const {
+  auto it = std::lower_bound(
+      indicesByID_.begin(),
+      indicesByID_.end(),
+      id,
+      [this](NodeIndex i, NodeID target) {
+        return nodeIDs_[i] < target;
+      });
+  assert(
+      it != indicesByID_.end() && nodeIDs_[*it] == id &&
+      "Couldn't find a node with the given ID");
+  return *it;
+}
+
 void HeapSnapshot::emitMeta() {
   json_.emitKey("snapshot");
   json_.openDict();
@@ -107,6 +107,7 @@ void HiddenClassBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
   mb.addField("parent", &self->parent_);
   mb.addField("propertyMap", &self->propertyMap_);
   mb.addField("forInCache", &self->forInCache_);
+  mb.addField("keysCache", &self->keysCache_);
 }
 
 #ifdef HERMESVM_SERIALIZE
@@ -122,6 +123,7 @@ void HiddenClassSerialize(Serializer &s, const GCCell *cell) {
   s.writeRelocation(self->parent_.get(s.getRuntime()));
   s.writeRelocation(self->propertyMap_.get(s.getRuntime()));
   s.writeRelocation(self->forInCache_.get(s.getRuntime()));
+  s.writeRelocation(self->keysCache_.get(s.getRuntime()));
 
   // Serialize WeakValueMap<Transition, HiddenClass> transitionMap_;
   // Only serialize/deserialize valid entries. We don't know how many valid
@@ -167,6 +169,7 @@ void HiddenClassDeserialize(Deserializer &d, CellKind kind) {
   d.readRelocation(&cell->parent_, RelocationKind::GCPointer);
   d.readRelocation(&cell->propertyMap_, RelocationKind::GCPointer);
   d.readRelocation(&cell->forInCache_, RelocationKind::GCPointer);
+  d.readRelocation(&cell->keysCache_, RelocationKind::GCPointer);
 
   uint32_t relocationId = d.readInt<uint32_t>();
   while (relocationId != 0) {
@@ -355,6 +358,11 @@ OptValue<HiddenClass::PropertyPos> HiddenClass::findProperty(
     }
 
     auto selfHandle = toHandle(runtime, std::move(self));
+    // A missing property doesn't need a map of our own, when it isn't in the
+    // map shared with our siblings.
+    auto shared = findPropertyInSharedMap(selfHandle, runtime, name, desc);
+    if (shared.hasValue() && !*shared)
+      return llvm::None;
     initializeMissingPropertyMap(selfHandle, runtime);
     self = selfHandle;
   }
@@ -374,6 +382,84 @@ OptValue<HiddenClass::PropertyPos> HiddenClass::findProperty(
   }
 }
 
+bool HiddenClass::findPropertyDescriptor(
+    PseudoHandle<HiddenClass> self,
+    Runtime *runtime,
+    SymbolID name,
+    PropertyFlags expectedFlags,
+    NamedPropertyDescriptor &desc) {
+  if (LLVM_UNLIKELY(!self->propertyMap_) && self->numProperties_ != 0) {
+    auto selfHandle = toHandle(runtime, std::move(self));
+    auto shared = findPropertyInSharedMap(selfHandle, runtime, name, desc);
+    if (shared.hasValue())
+      return *shared;
+    self = selfHandle;
+  }
+  return findProperty(std::move(self), runtime, name, expectedFlags, desc)
+      .hasValue();
+}
+
+OptValue<bool> HiddenClass::findPropertyInAncestorMap(
+    const HiddenClass *self,
+    PointerBase *base,
+    SymbolID name,
+    NamedPropertyDescriptor &desc) {
+  // The flags set by the latest flags transition of the property, if any.
+  PropertyFlags flags = PropertyFlags::invalid();
+  const HiddenClass *curr = self;
+  for (unsigned delta = 0; delta <= kMaxSharedMapDelta; ++delta) {
+    if (curr->propertyMap_) {
+      DictPropertyMap *map = curr->propertyMap_.getNonNull(base);
+      auto found = DictPropertyMap::find(map, name);
+      if (!found)
+        return false;
+      desc = DictPropertyMap::getDescriptorPair(map, *found)->second;
+      if (flags.isValid())
+        desc.flags = flags;
+      return true;
+    }
+    if (curr->symbolID_ == name) {
+      PropertyFlags currFlags = curr->propertyFlags_;
+      if (!currFlags.flagsTransition) {
+        desc = NamedPropertyDescriptor{flags.isValid() ? flags : currFlags,
+                                       curr->numProperties_ - 1};
+        return true;
+      }
+      // Keep looking for the slot of the property.
+      if (!flags.isValid()) {
+        flags = currFlags;
+        flags.flagsTransition = 0;
+      }
+    }
+    if (curr->numProperties_ == 0) {
+      assert(!flags.isValid() && "flags transition of a missing property");
+      return false;
+    }
+    curr = curr->parent_.get(base);
+    if (!curr)
+      return llvm::None;
+  }
+  return llvm::None;
+}
+
+OptValue<bool> HiddenClass::findPropertyInSharedMap(
+    Handle<HiddenClass> selfHandle,
+    Runtime *runtime,
+    SymbolID name,
+    NamedPropertyDescriptor &desc) {
+  auto found = findPropertyInAncestorMap(*selfHandle, runtime, name, desc);
+  if (found.hasValue())
+    return found;
+
+  // Create the map of a parent which shares it, so that all its children
+  // can use it instead of creating their own.
+  HiddenClass *parent = selfHandle->parent_.get(runtime);
+  if (!parent || parent->propertyMap_ || !parent->sharesPropertyMap())
+    return llvm::None;
+  initializeMissingPropertyMap(runtime->makeHandle(parent), runtime);
+  return findPropertyInAncestorMap(*selfHandle, runtime, name, desc);
+}
+
 llvm::Optional<NamedPropertyDescriptor> HiddenClass::findPropertyNoAlloc(
     HiddenClass *self,
     PointerBase *base,
@@ -430,6 +516,7 @@ Handle<HiddenClass> HiddenClass::deleteProperty(
       : selfHandle;
 
   --newHandle->numProperties_;
+  newHandle->dictionaryReads_ = 0;
 
   DictPropertyMap::erase(newHandle->propertyMap_.get(runtime), pos);
 
@@ -441,6 +528,25 @@ Handle<HiddenClass> HiddenClass::deleteProperty(
   return newHandle;
 }
 
+llvm::Optional<Handle<HiddenClass>> HiddenClass::lookupTransition(
+    Handle<HiddenClass> selfHandle,
+    Runtime *runtime,
+    const Transition &transition) {
+  TransitionCache &cache = runtime->getTransitionCache();
+  if (HiddenClass *child = cache.lookup(
+          *selfHandle, transition.symbolID, transition.propertyFlags))
+    return runtime->makeHandle(child);
+  auto optChildHandle = selfHandle->transitionMap_.lookup(runtime, transition);
+  if (optChildHandle) {
+    cache.insert(
+        *selfHandle,
+        transition.symbolID,
+        transition.propertyFlags,
+        **optChildHandle);
+  }
+  return optChildHandle;
+}
+
 CallResult<std::pair<Handle<HiddenClass>, SlotIndex>> HiddenClass::addProperty(
     Handle<HiddenClass> selfHandle,
     Runtime *runtime,
@@ -474,13 +580,18 @@ CallResult<std::pair<Handle<HiddenClass>, SlotIndex>> HiddenClass::addProperty(
     }
 
     ++selfHandle->numProperties_;
+    selfHandle->dictionaryReads_ = 0;
     return std::make_pair(selfHandle, newSlot);
   }
 
   // Do we already have a transition for that property+flags pair?
   auto optChildHandle =
-      selfHandle->transitionMap_.lookup(runtime, {name, propertyFlags});
+      lookupTransition(selfHandle, runtime, {name, propertyFlags});
   if (LLVM_LIKELY(optChildHandle)) {
+    // Keep a map shared with the siblings of the child.
+    if (selfHandle->sharesPropertyMap())
+      return std::make_pair(*optChildHandle, selfHandle->numProperties_);
+
     // If the child doesn't have a property map, but we do, update our map and
     // move it to the child.
     if (!optChildHandle.getValue()->propertyMap_ && selfHandle->propertyMap_) {
@@ -557,13 +668,21 @@ CallResult<std::pair<Handle<HiddenClass>, SlotIndex>> HiddenClass::addProperty(
   assert(
       inserted &&
       "transition already exists when adding a new property to hidden class");
+  runtime->getTransitionCache().insert(
+      *selfHandle, name, propertyFlags, *childHandle);
 
   if (toArrayIndex(
           runtime->getIdentifierTable().getStringView(runtime, name))) {
     childHandle->flags_.hasIndexLikeProperties = true;
   }
 
-  if (selfHandle->propertyMap_) {
+  if (selfHandle->propertyMap_ && selfHandle->sharesPropertyMap()) {
+    LLVM_DEBUG(
+        dbgs() << "Adding property " << runtime->formatSymbolID(name)
+               << " to Class:" << selfHandle->getDebugAllocationId()
+               << " shares Map with new Class:"
+               << childHandle->getDebugAllocationId() << "\n");
+  } else if (selfHandle->propertyMap_) {
     assert(
         !DictPropertyMap::find(selfHandle->propertyMap_.get(runtime), name) &&
         "Adding an existing property to hidden class");
@@ -615,6 +734,7 @@ Handle<HiddenClass> HiddenClass::updateProperty(
     DictPropertyMap::getDescriptorPair(
         selfHandle->propertyMap_.get(runtime), pos)
         ->second.flags = newFlags;
+    selfHandle->dictionaryReads_ = 0;
     // If it's still cacheable, make it non-cacheable.
     if (!selfHandle->isDictionaryNoCache()) {
       selfHandle = copyToNewDictionary(selfHandle, runtime, /*noCache*/ true);
@@ -639,8 +759,12 @@ Handle<HiddenClass> HiddenClass::updateProperty(
 
   // Do we already have a transition for that property+flags pair?
   auto optChildHandle =
-      selfHandle->transitionMap_.lookup(runtime, {name, transitionFlags});
+      lookupTransition(selfHandle, runtime, {name, transitionFlags});
   if (LLVM_LIKELY(optChildHandle)) {
+    // Keep a map shared with the siblings of the child.
+    if (selfHandle->sharesPropertyMap())
+      return *optChildHandle;
+
     // If the child doesn't have a property map, but we do, update our map and
     // move it to the child.
     if (!optChildHandle.getValue()->propertyMap_) {
@@ -668,10 +792,7 @@ Handle<HiddenClass> HiddenClass::updateProperty(
   }
 
   // We are updating the existing property and adding a transition to a new
-  // hidden class.
-  descPair->second.flags = newFlags;
-
-  // Allocate the child.
+  // hidden class. Allocate the child.
   auto childHandle = runtime->makeHandle<HiddenClass>(
       runtime->ignoreAllocationFailure(HiddenClass::create(
           runtime,
@@ -688,6 +809,17 @@ Handle<HiddenClass> HiddenClass::updateProperty(
   assert(
       inserted &&
       "transition already exists when updating a property in hidden class");
+  runtime->getTransitionCache().insert(
+      *selfHandle, name, transitionFlags, *childHandle);
+
+  if (selfHandle->sharesPropertyMap()) {
+    LLVM_DEBUG(
+        dbgs() << "Updating property " << runtime->formatSymbolID(name)
+               << " in Class:" << selfHandle->getDebugAllocationId()
+               << " shares Map with new Class:"
+               << childHandle->getDebugAllocationId() << "\n");
+    return childHandle;
+  }
 
   LLVM_DEBUG(
       dbgs() << "Updating property " << runtime->formatSymbolID(name)
@@ -696,6 +828,8 @@ Handle<HiddenClass> HiddenClass::updateProperty(
              << childHandle->getDebugAllocationId() << "\n");
 
   // Move the updated map to the child class.
+  DictPropertyMap::getDescriptorPair(selfHandle->propertyMap_.get(runtime), pos)
+      ->second.flags = newFlags;
   childHandle->propertyMap_.set(
       runtime, selfHandle->propertyMap_.get(runtime), &runtime->getHeap());
   selfHandle->propertyMap_ = nullptr;
@@ -809,6 +943,7 @@ Handle<HiddenClass> HiddenClass::updatePropertyFlagsWithoutTransitions(
   MutableHandle<HiddenClass> classHandle{runtime};
   if (selfHandle->isDictionary()) {
     classHandle = *selfHandle;
+    classHandle->dictionaryReads_ = 0;
   } else {
     classHandle = *copyToNewDictionary(selfHandle, runtime);
   }
@@ -909,9 +1044,11 @@ void HiddenClass::initializeMissingPropertyMap(
   assert(!selfHandle->propertyMap_ && "property map is already initialized");
 
   // Check whether we can steal our parent's map. If we can, we only need
-  // to add or update a single property.
+  // to add or update a single property. A map shared with our siblings stays
+  // with our parent.
   if (selfHandle->parent_ &&
-      selfHandle->parent_.get(runtime)->propertyMap_.get(runtime))
+      selfHandle->parent_.get(runtime)->propertyMap_.get(runtime) &&
+      !selfHandle->parent_.get(runtime)->sharesPropertyMap())
     return stealPropertyMapFromParent(selfHandle, runtime);
 
   LLVM_DEBUG(
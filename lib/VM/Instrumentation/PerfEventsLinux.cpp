@@ -106,6 +106,96 @@ bool PerfCounter::endAndInsertStats(std::string &jsonStats) {
   return true;
 }
 
+namespace {
+
+/// The hardware counters of one thread. They are opened as a group led by
+/// the first one that could be opened, so a single system call reads them
+/// all, and they count the same cycles.
+class ThreadCounters {
+ public:
+  ThreadCounters() {
+    const struct {
+      uint32_t type;
+      uint64_t config;
+      uint64_t HardwareCounters::*field;
+    } events[] = {
+        {PERF_TYPE_HARDWARE,
+         PERF_COUNT_HW_INSTRUCTIONS,
+         &HardwareCounters::instructions},
+        {PERF_TYPE_HARDWARE,
+         PERF_COUNT_HW_CPU_CYCLES,
+         &HardwareCounters::cycles},
+        {PERF_TYPE_HARDWARE,
+         PERF_COUNT_HW_CACHE_MISSES,
+         &HardwareCounters::cacheMisses},
+        {PERF_TYPE_HW_CACHE,
+         (PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)),
+         &HardwareCounters::tlbMisses},
+    };
+    for (const auto &event : events) {
+      perf_event_attr pe;
+      memset(&pe, 0, sizeof(perf_event_attr));
+      pe.type = event.type;
+      pe.size = sizeof(perf_event_attr);
+      pe.config = event.config;
+      pe.exclude_kernel = 1;
+      pe.exclude_hv = 1;
+      pe.read_format = PERF_FORMAT_GROUP;
+      int fd = syscall(
+          __NR_perf_event_open,
+          &pe,
+          0, /* this thread */
+          -1, /* any CPU */
+          leader_, /* group */
+          0 /* flags */);
+      if (fd == -1)
+        continue;
+      if (leader_ == -1)
+        leader_ = fd;
+      fds_[numOpen_] = fd;
+      fields_[numOpen_] = event.field;
+      ++numOpen_;
+    }
+  }
+
+  ~ThreadCounters() {
+    for (unsigned i = 0; i < numOpen_; ++i)
+      close(fds_[i]);
+  }
+
+  bool read(HardwareCounters &counters) const {
+    if (leader_ == -1)
+      return false;
+    // The group is read as the number of counters followed by their values,
+    // in the order they joined the group.
+    uint64_t buf[1 + kMaxCounters];
+    auto res = ::read(leader_, buf, sizeof(buf));
+    if (res <= 0 || buf[0] != numOpen_)
+      return false;
+    counters = HardwareCounters{};
+    for (unsigned i = 0; i < numOpen_; ++i)
+      counters.*fields_[i] = buf[1 + i];
+    return true;
+  }
+
+ private:
+  static constexpr unsigned kMaxCounters = 4;
+  int leader_{-1};
+  unsigned numOpen_{0};
+  int fds_[kMaxCounters];
+  /// The field of HardwareCounters each open counter is read into.
+  uint64_t HardwareCounters::*fields_[kMaxCounters];
+};
+
+} // namespace
+
+bool PerfEvents::readThreadCounters(HardwareCounters &counters) {
+  // Each thread counts itself, and the counters are closed when it exits.
+  static thread_local ThreadCounters threadCounters;
+  return threadCounters.read(counters);
+}
+
 bool PerfEvents::begin() {
   for (auto &counter : counters)
     if (!counter.begin())
@@ -140,6 +230,10 @@ bool PerfEvents::endAndInsertStats(std::string &jsonStats) {
   return false;
 }
 
+bool PerfEvents::readThreadCounters(HardwareCounters &counters) {
+  return false;
+}
+
 } // namespace instrumentation
 } // namespace vm
 } // namespace hermes
@@ -10,6 +10,8 @@
 
 #include "hermes/VM/Interpreter.h"
 
+#include <type_traits>
+
 // Convenient aliases for operand registers.
 #define REG(index) frameRegs[-((int32_t)index)]
 #define O1REG(name) REG(ip->i##name.op1)
@@ -42,4 +44,23 @@
 // one.
 #define NEXTINST(name) ((const Inst *)(&ip->i##name + 1))
 
+#ifdef HERMESVM_TAIL_CALL_DISPATCH
+namespace hermes {
+namespace vm {
+namespace tailcall {
+
+/// Whether the instruction \p op has a handler in Interpreter-tailcall.cpp.
+template <inst::OpCode op>
+struct HasHandler : std::false_type {};
+
+#define TAIL_CALL_OPCODE(name) \
+  template <>                  \
+  struct HasHandler<inst::OpCode::name> : std::true_type {};
+#include "TailCallOpcodes.def"
+
+} // namespace tailcall
+} // namespace vm
+} // namespace hermes
+#endif
+
 #endif // HERMES_VM_INTERPRETER_INTERNAL_H
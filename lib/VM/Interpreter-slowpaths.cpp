@@ -7,6 +7,7 @@
 
 #define DEBUG_TYPE "vm"
 #include "JSLib/JSLibInternal.h"
+#include "hermes/BCGen/HBC/SwitchHash.h"
 #include "hermes/VM/Casting.h"
 #include "hermes/VM/Interpreter.h"
 #include "hermes/VM/StringPrimitive.h"
@@ -129,5 +130,177 @@ ExecutionStatus Interpreter::casePutOwnGetterSetterByVal(
       .getStatus();
 }
 
+ExecutionStatus Interpreter::caseGetByIdSlot(
+    Runtime *runtime,
+    PinnedHermesValue *frameRegs,
+    const Inst *ip) {
+  CodeBlock *curCodeBlock = runtime->getCurrentFrame().getCalleeCodeBlock();
+  auto id = ID(ip->iGetByIdSlot.op5);
+  if (LLVM_LIKELY(O2REG(GetByIdSlot).isObject())) {
+    auto *obj = vmcast<JSObject>(O2REG(GetByIdSlot));
+    auto clazzGCPtr = obj->getClassGCPtr();
+    auto *cacheEntry = curCodeBlock->getReadCacheEntry(ip->iGetByIdSlot.op3);
+    if (cacheEntry->clazz == clazzGCPtr.getStorageType()) {
+      O1REG(GetByIdSlot) =
+          JSObject::getNamedSlotValue(obj, runtime, ip->iGetByIdSlot.op4);
+      return ExecutionStatus::RETURNED;
+    }
+    NamedPropertyDescriptor desc;
+    OptValue<bool> fastPathResult =
+        JSObject::tryGetOwnNamedDescriptorFast(obj, runtime, id, desc);
+    if (fastPathResult.hasValue() && fastPathResult.getValue() &&
+        !desc.flags.accessor) {
+      // Only remember the class if the literal kept its shape, so that a hit
+      // can rely on the slot of the instruction.
+      if (desc.slot == ip->iGetByIdSlot.op4 &&
+          !clazzGCPtr.getNonNull(runtime)->isDictionaryNoCache()) {
+        cacheEntry->clazz = clazzGCPtr.getStorageType();
+      }
+      O1REG(GetByIdSlot) = JSObject::getNamedSlotValue(obj, runtime, desc);
+      return ExecutionStatus::RETURNED;
+    }
+    auto propRes = JSObject::getNamed_RJS(
+        Handle<JSObject>::vmcast(&O2REG(GetByIdSlot)),
+        runtime,
+        id,
+        DEFAULT_PROP_OP_FLAGS(curCodeBlock->isStrictMode()));
+    if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    O1REG(GetByIdSlot) = *propRes;
+    return ExecutionStatus::RETURNED;
+  }
+
+  auto propRes = Interpreter::getByIdTransient_RJS(
+      runtime, Handle<>(&O2REG(GetByIdSlot)), id);
+  if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  O1REG(GetByIdSlot) = *propRes;
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus Interpreter::caseDataViewGet(
+    Runtime *runtime,
+    PinnedHermesValue *frameRegs,
+    const Inst *ip) {
+  uint8_t type = ip->iDataViewGet.op6;
+  if (auto fastRes = dataViewGetFast(
+          runtime,
+          O2REG(DataViewGet),
+          O3REG(DataViewGet),
+          O4REG(DataViewGet),
+          O5REG(DataViewGet),
+          type)) {
+    O1REG(DataViewGet) = *fastRes;
+    return ExecutionStatus::RETURNED;
+  }
+
+  auto callable = Handle<Callable>::dyn_vmcast(Handle<>(&O2REG(DataViewGet)));
+  if (LLVM_UNLIKELY(!callable))
+    return runtime->raiseTypeErrorForValue(
+        Handle<>(&O2REG(DataViewGet)), " is not a function");
+  auto res = type & DataViewType::LittleEndianArg
+      ? Callable::executeCall2(
+            callable,
+            runtime,
+            Handle<>(&O3REG(DataViewGet)),
+            O4REG(DataViewGet),
+            O5REG(DataViewGet))
+      : Callable::executeCall1(
+            callable,
+            runtime,
+            Handle<>(&O3REG(DataViewGet)),
+            O4REG(DataViewGet));
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  O1REG(DataViewGet) = *res;
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus Interpreter::caseDataViewSet(
+    Runtime *runtime,
+    PinnedHermesValue *frameRegs,
+    const Inst *ip) {
+  uint8_t type = ip->iDataViewSet.op6;
+  if (dataViewSetFast(
+          runtime,
+          O1REG(DataViewSet),
+          O2REG(DataViewSet),
+          O3REG(DataViewSet),
+          O4REG(DataViewSet),
+          O5REG(DataViewSet),
+          type))
+    return ExecutionStatus::RETURNED;
+
+  // The result of the call is unused.
+  auto callable = Handle<Callable>::dyn_vmcast(Handle<>(&O1REG(DataViewSet)));
+  if (LLVM_UNLIKELY(!callable))
+    return runtime->raiseTypeErrorForValue(
+        Handle<>(&O1REG(DataViewSet)), " is not a function");
+  return (type & DataViewType::LittleEndianArg
+              ? Callable::executeCall3(
+                    callable,
+                    runtime,
+                    Handle<>(&O2REG(DataViewSet)),
+                    O3REG(DataViewSet),
+                    O4REG(DataViewSet),
+                    O5REG(DataViewSet))
+              : Callable::executeCall2(
+                    callable,
+                    runtime,
+                    Handle<>(&O2REG(DataViewSet)),
+                    O3REG(DataViewSet),
+                    O4REG(DataViewSet)))
+      .getStatus();
+}
+
+uint32_t Interpreter::switchHashSlot(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    PinnedHermesValue *val,
+    const Inst *ip) {
+  bool strings = ip->opCode == OpCode::SwitchStr;
+  uint32_t numSlots = strings ? ip->iSwitchStr.op4 : ip->iSwitchSparse.op4;
+  int32_t defaultOffset = strings ? ip->iSwitchStr.op3 : ip->iSwitchSparse.op3;
+  const uint32_t *keys = (const uint32_t *)llvm::alignAddr(
+      (const uint8_t *)ip +
+          (strings ? ip->iSwitchStr.op2 : ip->iSwitchSparse.op2),
+      sizeof(uint32_t));
+  const uint32_t *offsets = keys + numSlots;
+
+  if (!strings) {
+    if (!val->isNumber())
+      return numSlots;
+    double num = val->getNumber();
+    // Checking the range first also rejects NaN.
+    if (!(num >= INT32_MIN && num <= INT32_MAX) || (int32_t)num != num)
+      return numSlots;
+    int32_t key = (int32_t)num;
+    uint32_t slot = hbc::hashSwitchInt32(key) & (numSlots - 1);
+    if ((int32_t)offsets[slot] == defaultOffset || keys[slot] != (uint32_t)key)
+      return numSlots;
+    return slot;
+  }
+
+  if (!val->isString())
+    return numSlots;
+  const StringPrimitive *str = val->getString();
+  uint32_t hash = str->isASCII() ? hbc::hashSwitchString(str->castToASCIIRef())
+                                 : hbc::hashSwitchString(str->castToUTF16Ref());
+  uint32_t slot = hash & (numSlots - 1);
+  // An empty slot matches nothing.
+  if ((int32_t)offsets[slot] == defaultOffset)
+    return numSlots;
+
+  // Creating the symbol of the case or its string may allocate, so the input
+  // is read again from its register afterwards.
+  SymbolID id = runtimeModule->getSymbolIDFromStringIDMayAllocate(keys[slot]);
+  // Uniqued strings are equal exactly when they are the same symbol.
+  if (val->getString()->isUniqued())
+    return val->getString()->getUniqueID() == id ? slot : numSlots;
+  StringPrimitive *caseStr =
+      runtime->getIdentifierTable().getStringPrim(runtime, id);
+  return caseStr->equals(val->getString()) ? slot : numSlots;
+}
+
 } // namespace vm
 } // namespace hermes
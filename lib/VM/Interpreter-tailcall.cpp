@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// Tail-call dispatch of the simple instructions of the interpreter, enabled
+/// with HERMESVM_TAIL_CALL_DISPATCH.
+///
+/// Every handler runs one instruction and ends in a guaranteed tail call
+/// (clang's musttail) to the handler of the next one. The runtime, frameRegs
+/// and ip are passed in the handler arguments, so the compiler keeps them in
+/// machine registers along the whole chain, instead of reloading them around
+/// the slow paths of interpretFunction.
+///
+/// Only instructions which can't throw, allocate, call or run the debugger
+/// have handlers, and only for their fast paths. They are listed in
+/// TailCallOpcodes.def. Any other instruction is returned to
+/// interpretFunction, which runs it as usual.
+//===----------------------------------------------------------------------===//
+
+#ifdef HERMESVM_TAIL_CALL_DISPATCH
+
+#ifdef __has_attribute
+#if __has_attribute(musttail)
+#define HERMESVM_HAVE_MUSTTAIL
+#endif
+#endif
+#ifndef HERMESVM_HAVE_MUSTTAIL
+#error "HERMESVM_TAIL_CALL_DISPATCH needs a compiler with musttail support"
+#endif
+
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/Casting.h"
+#include "hermes/VM/Interpreter.h"
+#include "hermes/VM/Operations.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/StackFrame-inline.h"
+
+#include "Interpreter-internal.h"
+
+using namespace hermes::inst;
+
+namespace hermes {
+namespace vm {
+namespace tailcall {
+
+#define HANDLER_PARAMS                                           \
+  Runtime *runtime, PinnedHermesValue *frameRegs, const Inst *ip
+
+using Handler = const Inst *(*)(HANDLER_PARAMS);
+
+extern const Handler handlers[];
+
+#define MUSTTAIL __attribute__((musttail))
+
+/// Continue with the handler of the instruction at \p nextIP.
+#define DISPATCH_TO(nextIP)                         \
+  do {                                              \
+    ip = (nextIP);                                  \
+    MUSTTAIL return handlers[(unsigned)ip->opCode]( \
+        runtime, frameRegs, ip);                    \
+  } while (0)
+
+/// Continue at \p target, the destination of a jump. With the JIT, a jump that
+/// doesn't go forward is left to the interpreter, which counts it towards
+/// compiling the loop it closes.
+#ifdef HERMESVM_JIT
+#define BRANCH(target)                 \
+  do {                                 \
+    if (LLVM_UNLIKELY((target) <= ip)) \
+      return ip;                       \
+    DISPATCH_TO(target);               \
+  } while (0)
+#else
+#define BRANCH(target) DISPATCH_TO(target)
+#endif
+
+/// Instructions without a handler of their own go back to the interpreter.
+template <OpCode op>
+const Inst *handle(HANDLER_PARAMS) {
+  static_assert(
+      !HasHandler<op>::value,
+      "TailCallOpcodes.def lists an instruction without a handler");
+  return ip;
+}
+
+template <>
+const Inst *handle<OpCode::Mov>(HANDLER_PARAMS) {
+  O1REG(Mov) = O2REG(Mov);
+  DISPATCH_TO(NEXTINST(Mov));
+}
+
+template <>
+const Inst *handle<OpCode::MovLong>(HANDLER_PARAMS) {
+  O1REG(MovLong) = O2REG(MovLong);
+  DISPATCH_TO(NEXTINST(MovLong));
+}
+
+template <>
+const Inst *handle<OpCode::LoadParam>(HANDLER_PARAMS) {
+  if (LLVM_LIKELY(ip->iLoadParam.op2 <= FRAME.getArgCount())) {
+    // index 0 must load 'this'. Index 1 the first argument, etc.
+    O1REG(LoadParam) = FRAME.getArgRef((int32_t)ip->iLoadParam.op2 - 1);
+  } else {
+    O1REG(LoadParam) = HermesValue::encodeUndefinedValue();
+  }
+  DISPATCH_TO(NEXTINST(LoadParam));
+}
+
+#define LOAD_CONST(name, value)                      \
+  template <>                                        \
+  const Inst *handle<OpCode::name>(HANDLER_PARAMS) { \
+    O1REG(name) = value;                             \
+    DISPATCH_TO(NEXTINST(name));                     \
+  }
+
+LOAD_CONST(
+    LoadConstUInt8,
+    HermesValue::encodeDoubleValue(ip->iLoadConstUInt8.op2))
+LOAD_CONST(LoadConstInt, HermesValue::encodeDoubleValue(ip->iLoadConstInt.op2))
+LOAD_CONST(
+    LoadConstDouble,
+    HermesValue::encodeDoubleValue(ip->iLoadConstDouble.op2))
+LOAD_CONST(LoadConstUndefined, HermesValue::encodeUndefinedValue())
+LOAD_CONST(LoadConstNull, HermesValue::encodeNullValue())
+LOAD_CONST(LoadConstTrue, HermesValue::encodeBoolValue(true))
+LOAD_CONST(LoadConstFalse, HermesValue::encodeBoolValue(false))
+LOAD_CONST(LoadConstZero, HermesValue::encodeDoubleValue(0))
+#undef LOAD_CONST
+
+template <>
+const Inst *handle<OpCode::ToNumber>(HANDLER_PARAMS) {
+  if (LLVM_UNLIKELY(!O2REG(ToNumber).isNumber()))
+    return ip;
+  O1REG(ToNumber) = O2REG(ToNumber);
+  DISPATCH_TO(NEXTINST(ToNumber));
+}
+
+/// Implement an arithmetic instruction for numbers, and the generic one when
+/// both of its operands are numbers.
+#define BINOP(name, oper)                                                  \
+  template <>                                                              \
+  const Inst *handle<OpCode::name##N>(HANDLER_PARAMS) {                    \
+    O1REG(name##N) = HermesValue::encodeDoubleValue(                       \
+        O2REG(name##N).getNumber() oper O3REG(name##N).getNumber());       \
+    DISPATCH_TO(NEXTINST(name##N));                                        \
+  }                                                                        \
+  template <>                                                              \
+  const Inst *handle<OpCode::name>(HANDLER_PARAMS) {                       \
+    if (LLVM_UNLIKELY(!O2REG(name).isNumber() || !O3REG(name).isNumber())) \
+      return ip;                                                           \
+    MUSTTAIL return handle<OpCode::name##N>(runtime, frameRegs, ip);       \
+  }
+
+BINOP(Add, +)
+BINOP(Sub, -)
+BINOP(Mul, *)
+#undef BINOP
+
+template <>
+const Inst *handle<OpCode::Jmp>(HANDLER_PARAMS) {
+  BRANCH(IPADD(ip->iJmp.op1));
+}
+
+template <>
+const Inst *handle<OpCode::JmpLong>(HANDLER_PARAMS) {
+  BRANCH(IPADD(ip->iJmpLong.op1));
+}
+
+/// Implement a conditional jump which can't have a slow path.
+/// \param cond the condition to jump on.
+#define JCOND_IF(name, cond)                         \
+  template <>                                        \
+  const Inst *handle<OpCode::name>(HANDLER_PARAMS) { \
+    if (cond) {                                      \
+      BRANCH(IPADD(ip->i##name.op1));                \
+    }                                                \
+    DISPATCH_TO(NEXTINST(name));                     \
+  }
+
+JCOND_IF(JmpTrue, toBoolean(O2REG(JmpTrue)))
+JCOND_IF(JmpTrueLong, toBoolean(O2REG(JmpTrueLong)))
+JCOND_IF(JmpFalse, !toBoolean(O2REG(JmpFalse)))
+JCOND_IF(JmpFalseLong, !toBoolean(O2REG(JmpFalseLong)))
+JCOND_IF(JmpUndefined, O2REG(JmpUndefined).isUndefined())
+JCOND_IF(JmpUndefinedLong, O2REG(JmpUndefinedLong).isUndefined())
+JCOND_IF(
+    JStrictEqual,
+    strictEqualityTest(O2REG(JStrictEqual), O3REG(JStrictEqual)))
+JCOND_IF(
+    JStrictEqualLong,
+    strictEqualityTest(O2REG(JStrictEqualLong), O3REG(JStrictEqualLong)))
+JCOND_IF(
+    JStrictNotEqual,
+    !strictEqualityTest(O2REG(JStrictNotEqual), O3REG(JStrictNotEqual)))
+JCOND_IF(
+    JStrictNotEqualLong,
+    !strictEqualityTest(
+        O2REG(JStrictNotEqualLong), O3REG(JStrictNotEqualLong)))
+#undef JCOND_IF
+
+/// Implement a comparison jump for numbers, and the generic one when both of
+/// its operands are numbers.
+#define JCOND_IMPL(name, suffix, oper, trueDest, falseDest)                  \
+  template <>                                                                \
+  const Inst *handle<OpCode::name##N##suffix>(HANDLER_PARAMS) {              \
+    if (O2REG(name##N##suffix).getNumber() oper O3REG(name##N##suffix)       \
+            .getNumber()) {                                                  \
+      BRANCH(trueDest);                                                      \
+    }                                                                        \
+    BRANCH(falseDest);                                                       \
+  }                                                                          \
+  template <>                                                                \
+  const Inst *handle<OpCode::name##suffix>(HANDLER_PARAMS) {                 \
+    if (LLVM_UNLIKELY(                                                       \
+            !O2REG(name##suffix).isNumber() ||                               \
+            !O3REG(name##suffix).isNumber()))                                \
+      return ip;                                                             \
+    MUSTTAIL return handle<OpCode::name##N##suffix>(runtime, frameRegs, ip); \
+  }
+
+/// Implement the long and short forms of a comparison jump, and its negation.
+#define JCOND(name, oper)                                                   \
+  JCOND_IMPL(                                                               \
+      J##name, , oper, IPADD(ip->iJ##name.op1), NEXTINST(J##name))          \
+  JCOND_IMPL(                                                               \
+      J##name,                                                              \
+      Long,                                                                 \
+      oper,                                                                 \
+      IPADD(ip->iJ##name##Long.op1),                                        \
+      NEXTINST(J##name##Long))                                              \
+  JCOND_IMPL(                                                               \
+      JNot##name, , oper, NEXTINST(JNot##name), IPADD(ip->iJNot##name.op1)) \
+  JCOND_IMPL(                                                               \
+      JNot##name,                                                           \
+      Long,                                                                 \
+      oper,                                                                 \
+      NEXTINST(JNot##name##Long),                                           \
+      IPADD(ip->iJNot##name##Long.op1))
+
+JCOND(Less, <)
+JCOND(LessEqual, <=)
+JCOND(Greater, >)
+JCOND(GreaterEqual, >=)
+#undef JCOND
+#undef JCOND_IMPL
+
+template <>
+const Inst *handle<OpCode::GetEnvironment>(HANDLER_PARAMS) {
+  Environment *curEnv =
+      FRAME.getCalleeClosureUnsafe()->getEnvironment(runtime);
+  for (unsigned level = ip->iGetEnvironment.op2; level; --level) {
+    assert(curEnv && "invalid environment relative level");
+    curEnv = curEnv->getParentEnvironment(runtime);
+  }
+  O1REG(GetEnvironment) = HermesValue::encodeObjectValue(curEnv);
+  DISPATCH_TO(NEXTINST(GetEnvironment));
+}
+
+template <>
+const Inst *handle<OpCode::GetEnvironmentAndLoad>(HANDLER_PARAMS) {
+  Environment *curEnv =
+      FRAME.getCalleeClosureUnsafe()->getEnvironment(runtime);
+  for (unsigned level = ip->iGetEnvironmentAndLoad.op3; level; --level) {
+    assert(curEnv && "invalid environment relative level");
+    curEnv = curEnv->getParentEnvironment(runtime);
+  }
+  O1REG(GetEnvironmentAndLoad) = HermesValue::encodeObjectValue(curEnv);
+  O2REG(GetEnvironmentAndLoad) = curEnv->slot(ip->iGetEnvironmentAndLoad.op4);
+  DISPATCH_TO(NEXTINST(GetEnvironmentAndLoad));
+}
+
+template <>
+const Inst *handle<OpCode::LoadFromEnvironment>(HANDLER_PARAMS) {
+  O1REG(LoadFromEnvironment) = vmcast<Environment>(O2REG(LoadFromEnvironment))
+                                   ->slot(ip->iLoadFromEnvironment.op3);
+  DISPATCH_TO(NEXTINST(LoadFromEnvironment));
+}
+
+template <>
+const Inst *handle<OpCode::LoadFromEnvironmentL>(HANDLER_PARAMS) {
+  O1REG(LoadFromEnvironmentL) =
+      vmcast<Environment>(O2REG(LoadFromEnvironmentL))
+          ->slot(ip->iLoadFromEnvironmentL.op3);
+  DISPATCH_TO(NEXTINST(LoadFromEnvironmentL));
+}
+
+template <>
+const Inst *handle<OpCode::StoreNPToEnvironment>(HANDLER_PARAMS) {
+  vmcast<Environment>(O1REG(StoreNPToEnvironment))
+      ->slot(ip->iStoreNPToEnvironment.op2)
+      .setNonPtr(O3REG(StoreNPToEnvironment));
+  DISPATCH_TO(NEXTINST(StoreNPToEnvironment));
+}
+
+template <>
+const Inst *handle<OpCode::StoreNPToEnvironmentL>(HANDLER_PARAMS) {
+  vmcast<Environment>(O1REG(StoreNPToEnvironmentL))
+      ->slot(ip->iStoreNPToEnvironmentL.op2)
+      .setNonPtr(O3REG(StoreNPToEnvironmentL));
+  DISPATCH_TO(NEXTINST(StoreNPToEnvironmentL));
+}
+
+const Handler handlers[] = {
+#define DEFINE_OPCODE(name) &handle<OpCode::name>,
+#include "hermes/BCGen/HBC/BytecodeList.def"
+};
+
+#undef BRANCH
+#undef DISPATCH_TO
+#undef MUSTTAIL
+#undef HANDLER_PARAMS
+
+} // namespace tailcall
+
+const Inst *Interpreter::runTailCallHandlers(
+    Runtime *runtime,
+    PinnedHermesValue *frameRegs,
+    const Inst *ip) {
+  return tailcall::handlers[(unsigned)ip->opCode](runtime, frameRegs, ip);
+}
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMESVM_TAIL_CALL_DISPATCH
@@ -11,15 +11,19 @@
 
 #include "hermes/Inst/InstDecode.h"
 #include "hermes/Support/Conversions.h"
+#include "hermes/Support/Math.h"
 #include "hermes/Support/SlowAssert.h"
 #include "hermes/Support/Statistic.h"
 #include "hermes/VM/Callable.h"
 #include "hermes/VM/CodeBlock.h"
 #include "hermes/VM/JIT/JIT.h"
 #include "hermes/VM/JSArray.h"
+#include "hermes/VM/JSDataView.h"
 #include "hermes/VM/JSError.h"
 #include "hermes/VM/JSGenerator.h"
+#include "hermes/VM/JSNativeFunctions.h"
 #include "hermes/VM/JSRegExp.h"
+#include "hermes/VM/JSTypedArray.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/Profiler.h"
 #include "hermes/VM/Runtime-inline.h"
@@ -43,9 +47,15 @@ HERMES_SLOW_STATISTIC(
 HERMES_SLOW_STATISTIC(
     NumGetByIdCacheHits,
     "NumGetByIdCacheHits: Number of property 'read by id' cache hits");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdPolyHits,
+    "NumGetByIdPolyHits: Number of property 'read by id' cache hits on a class other than the first");
 HERMES_SLOW_STATISTIC(
     NumGetByIdProtoHits,
     "NumGetByIdProtoHits: Number of property 'read by id' cache hits for the prototype");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdGlobalHits,
+    "NumGetByIdGlobalHits: Number of property 'read by id' cache hits on a global cell");
 HERMES_SLOW_STATISTIC(
     NumGetByIdCacheEvicts,
     "NumGetByIdCacheEvicts: Number of property 'read by id' cache evictions");
@@ -64,6 +74,12 @@ HERMES_SLOW_STATISTIC(
 HERMES_SLOW_STATISTIC(
     NumGetByIdTransient,
     "NumGetByIdTransient: Number of property 'read by id' of non-objects");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdSlotHits,
+    "NumGetByIdSlotHits: Number of property 'read by id' at a literal slot");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdDictionaryExits,
+    "NumGetByIdDictionaryExits: Number of objects given a regular class again by 'read by id'");
 
 HERMES_SLOW_STATISTIC(
     NumPutById,
@@ -71,6 +87,9 @@ HERMES_SLOW_STATISTIC(
 HERMES_SLOW_STATISTIC(
     NumPutByIdCacheHits,
     "NumPutByIdCacheHits: Number of property 'write by id' cache hits");
+HERMES_SLOW_STATISTIC(
+    NumPutByIdPolyHits,
+    "NumPutByIdPolyHits: Number of property 'write by id' cache hits on a class other than the first");
 HERMES_SLOW_STATISTIC(
     NumPutByIdCacheEvicts,
     "NumPutByIdCacheEvicts: Number of property 'write by id' cache evictions");
@@ -81,6 +100,16 @@ HERMES_SLOW_STATISTIC(
     NumPutByIdTransient,
     "NumPutByIdTransient: Number of property 'write by id' to non-objects");
 
+HERMES_SLOW_STATISTIC(
+    NumGetByValFastPaths,
+    "NumGetByValFastPaths: Number of property 'read by value' fast paths on indexed storage");
+HERMES_SLOW_STATISTIC(
+    NumPutByValFastPaths,
+    "NumPutByValFastPaths: Number of property 'write by value' fast paths on indexed storage");
+HERMES_SLOW_STATISTIC(
+    NumDataViewFastPaths,
+    "NumDataViewFastPaths: Number of DataView get and set calls done inline");
+
 HERMES_SLOW_STATISTIC(
     NumNativeFunctionCalls,
     "NumNativeFunctionCalls: Number of native function calls");
@@ -270,6 +299,16 @@ CallResult<HermesValue> Interpreter::getArgumentsPropByValSlowPath_RJS(
       runtime, lazyReg, valueReg, curFunction, strictMode);
 }
 
+ExecutionStatus Interpreter::handleAsyncBreak(Runtime *runtime) {
+  if (runtime->testAndClearTimeoutAsyncBreakRequest()) {
+    return runtime->notifyTimeout();
+  }
+  if (runtime->testAndClearInterruptAsyncBreakRequest()) {
+    return runtime->notifyInterrupt();
+  }
+  return ExecutionStatus::RETURNED;
+}
+
 ExecutionStatus Interpreter::handleGetPNameList(
     Runtime *runtime,
     PinnedHermesValue *frameRegs,
@@ -406,6 +445,174 @@ OptValue<HermesValue> Interpreter::getByValTransientFast(
   return llvm::None;
 }
 
+/// Read the element at \p index of the typed array \p arr, if it is in
+/// bounds.
+template <typename T, CellKind C>
+static OptValue<HermesValue> getTypedArrayElementFast(
+    Runtime *runtime,
+    JSTypedArray<T, C> *arr,
+    uint32_t index) {
+  if (LLVM_LIKELY(arr->attached(runtime) && index < arr->getLength())) {
+    return SafeNumericEncoder<T>::encode(arr->at(runtime, index));
+  }
+  return llvm::None;
+}
+
+/// Store the number \p value at \p index of the typed array \p arr, if it is
+/// in bounds. Values other than numbers are left to the generic path, since
+/// converting them may call user code.
+template <typename T, CellKind C>
+static bool setTypedArrayElementFast(
+    Runtime *runtime,
+    JSTypedArray<T, C> *arr,
+    uint32_t index,
+    HermesValue value) {
+  if (LLVM_LIKELY(
+          value.isNumber() && arr->attached(runtime) &&
+          index < arr->getLength())) {
+    arr->at(runtime, index) =
+        JSTypedArray<T, C>::toDestType(value.getNumber());
+    return true;
+  }
+  return false;
+}
+
+OptValue<HermesValue> Interpreter::getByValObjectFast(
+    Runtime *runtime,
+    JSObject *obj,
+    HermesValue name) {
+  if (LLVM_UNLIKELY(!obj->hasFastIndexProperties())) {
+    return llvm::None;
+  }
+  OptValue<uint32_t> arrayIndex = toArrayIndexFastPath(name);
+  if (!arrayIndex) {
+    return llvm::None;
+  }
+  switch (obj->getKind()) {
+    case CellKind::ArrayKind:
+    case CellKind::ArgumentsKind: {
+      // A hole has to be looked up in the prototype chain.
+      HermesValue elem = vmcast<ArrayImpl>(obj)->at(runtime, *arrayIndex);
+      if (LLVM_LIKELY(!elem.isEmpty())) {
+        return elem;
+      }
+      return llvm::None;
+    }
+#define TYPED_ARRAY(name, type)     \
+  case CellKind::name##ArrayKind:   \
+    return getTypedArrayElementFast( \
+        runtime, vmcast<name##Array>(obj), *arrayIndex);
+#include "hermes/VM/TypedArrays.def"
+    default:
+      return llvm::None;
+  }
+}
+
+bool Interpreter::putByValObjectFast(
+    Runtime *runtime,
+    JSObject *obj,
+    HermesValue name,
+    HermesValue value) {
+  if (LLVM_UNLIKELY(!obj->hasFastIndexProperties())) {
+    return false;
+  }
+  OptValue<uint32_t> arrayIndex = toArrayIndexFastPath(name);
+  if (!arrayIndex) {
+    return false;
+  }
+  switch (obj->getKind()) {
+    case CellKind::ArrayKind:
+    case CellKind::ArgumentsKind:
+      return vmcast<ArrayImpl>(obj)->trySetExistingElement(
+          runtime, *arrayIndex, value);
+#define TYPED_ARRAY(name, type)     \
+  case CellKind::name##ArrayKind:   \
+    return setTypedArrayElementFast( \
+        runtime, vmcast<name##Array>(obj), *arrayIndex, value);
+#include "hermes/VM/TypedArrays.def"
+    default:
+      return false;
+  }
+}
+
+OptValue<HermesValue> Interpreter::dataViewGetFast(
+    Runtime *runtime,
+    HermesValue callee,
+    HermesValue view,
+    HermesValue offset,
+    HermesValue littleEndian,
+    uint8_t type) {
+  auto *native = dyn_vmcast<NativeFunction>(callee);
+  auto *self = dyn_vmcast<JSDataView>(view);
+  if (!native || !self || !self->attached(runtime)) {
+    return llvm::None;
+  }
+  OptValue<uint32_t> index = toArrayIndexFastPath(offset);
+  if (!index) {
+    return llvm::None;
+  }
+  bool isLittleEndian =
+      (type & DataViewType::LittleEndianArg) && toBoolean(littleEndian);
+  switch (type & ~DataViewType::LittleEndianArg) {
+#define TYPED_ARRAY(name, T)                                               \
+  case DataViewType::name:                                                 \
+    if (native->getFunctionPtr() != dataViewPrototypeGet<T> ||             \
+        (uint64_t)*index + sizeof(T) > self->byteLength()) {               \
+      return llvm::None;                                                   \
+    }                                                                      \
+    return SafeNumericEncoder<T>::encode(                                  \
+        self->get<T>(runtime, *index, isLittleEndian));
+#define TYPED_ARRAY_NO_CLAMP
+#include "hermes/VM/TypedArrays.def"
+    default:
+      return llvm::None;
+  }
+}
+
+bool Interpreter::dataViewSetFast(
+    Runtime *runtime,
+    HermesValue callee,
+    HermesValue view,
+    HermesValue offset,
+    HermesValue value,
+    HermesValue littleEndian,
+    uint8_t type) {
+  // Any other value would be converted by calling into user code.
+  if (!value.isNumber()) {
+    return false;
+  }
+  auto *native = dyn_vmcast<NativeFunction>(callee);
+  auto *self = dyn_vmcast<JSDataView>(view);
+  if (!native || !self || !self->attached(runtime)) {
+    return false;
+  }
+  OptValue<uint32_t> index = toArrayIndexFastPath(offset);
+  if (!index) {
+    return false;
+  }
+  bool isLittleEndian =
+      (type & DataViewType::LittleEndianArg) && toBoolean(littleEndian);
+  switch (type & ~DataViewType::LittleEndianArg) {
+#define TYPED_ARRAY(name, T)                                               \
+  case DataViewType::name:                                                 \
+    if (native->getFunctionPtr() !=                                        \
+            dataViewPrototypeSet<T, CellKind::name##ArrayKind> ||          \
+        (uint64_t)*index + sizeof(T) > self->byteLength()) {               \
+      return false;                                                        \
+    }                                                                      \
+    self->set<T>(                                                          \
+        runtime,                                                           \
+        *index,                                                            \
+        name##Array::toDestType(value.getNumber()),                        \
+        isLittleEndian);                                                   \
+    return true;
+#define TYPED_ARRAY_NO_CLAMP
+#include "hermes/VM/TypedArrays.def"
+    default:
+      return false;
+  }
+}
+
 CallResult<HermesValue> Interpreter::getByValTransient_RJS(
     Runtime *runtime,
     Handle<> base,
@@ -534,12 +741,22 @@ ExecutionStatus Interpreter::putByValTransient_RJS(
   return putByIdTransient_RJS(runtime, base, **idRes, value, strictMode);
 }
 
+/// \return the allocation site of the literal allocated by the instruction \p
+/// ip in \p codeBlock, or nullptr if the GC does not track allocation sites.
+static inline AllocationSite *
+allocationSiteFor(Runtime *runtime, CodeBlock *codeBlock, const Inst *ip) {
+  return runtime->getHeap().isPretenuringEnabled()
+      ? &codeBlock->getAllocationSite(ip)
+      : nullptr;
+}
+
 CallResult<HermesValue> Interpreter::createObjectFromBuffer(
     Runtime *runtime,
     CodeBlock *curCodeBlock,
     unsigned numLiterals,
     unsigned keyBufferIndex,
-    unsigned valBufferIndex) {
+    unsigned valBufferIndex,
+    AllocationSite *site) {
   // Fetch any cached hidden class first.
   auto *runtimeModule = curCodeBlock->getRuntimeModule();
   const llvm::Optional<Handle<HiddenClass>> optCachedHiddenClassHandle =
@@ -547,11 +764,13 @@ CallResult<HermesValue> Interpreter::createObjectFromBuffer(
   // Create a new object using the built-in constructor or cached hidden class.
   // Note that the built-in constructor is empty, so we don't actually need to
   // call it.
+  const bool pretenure = site && site->shouldPretenure();
   auto obj = toHandle(
       runtime,
       optCachedHiddenClassHandle.hasValue()
-          ? JSObject::create(runtime, optCachedHiddenClassHandle.getValue())
-          : JSObject::create(runtime, numLiterals));
+          ? JSObject::create(
+                runtime, optCachedHiddenClassHandle.getValue(), pretenure)
+          : JSObject::create(runtime, numLiterals, pretenure));
 
   MutableHandle<> tmpHandleKey(runtime);
   MutableHandle<> tmpHandleVal(runtime);
@@ -563,7 +782,18 @@ CallResult<HermesValue> Interpreter::createObjectFromBuffer(
   auto keyGen = genPair.first;
   auto valGen = genPair.second;
 
-  if (optCachedHiddenClassHandle.hasValue()) {
+  // Once the hidden class is cached, the values of a literal created
+  // repeatedly are decoded only once, and copied into its slots in bulk.
+  ArrayStorage *values = optCachedHiddenClassHandle.hasValue()
+      ? runtimeModule->getLiteralValuesMayAllocate(
+            RuntimeModule::LiteralValueBuffer::Object,
+            valBufferIndex,
+            numLiterals)
+      : nullptr;
+  if (values) {
+    JSObject::initNamedSlotValues(
+        obj.get(), runtime, values->begin(), values->end());
+  } else if (optCachedHiddenClassHandle.hasValue()) {
     uint32_t propIndex = 0;
     // keyGen should always have the same amount of elements as valGen
     while (valGen.hasNext()) {
@@ -603,7 +833,7 @@ CallResult<HermesValue> Interpreter::createObjectFromBuffer(
       // any allocation in valGen.get() won't invalidate the raw pointer
       // retruned from obj.get().
       auto val = valGen.get(runtime);
-      JSObject::setNamedSlotValue(obj.get(), runtime, propIndex, val);
+      JSObject::initNamedSlotValue(obj.get(), runtime, propIndex, val);
       gcScope.flushToMarker(marker);
       ++propIndex;
     }
@@ -657,6 +887,9 @@ CallResult<HermesValue> Interpreter::createObjectFromBuffer(
     runtimeModule->tryCacheLiteralHiddenClass(keyBufferIndex, clazz);
   }
 
+  if (site && !pretenure) {
+    runtime->getHeap().sampleAllocationSite(*obj, site);
+  }
   return HermesValue::encodeObjectValue(*obj);
 }
 
@@ -665,10 +898,12 @@ CallResult<HermesValue> Interpreter::createArrayFromBuffer(
     CodeBlock *curCodeBlock,
     unsigned numElements,
     unsigned numLiterals,
-    unsigned bufferIndex) {
+    unsigned bufferIndex,
+    AllocationSite *site) {
   // Create a new array using the built-in constructor, and initialize
   // the elements from a literal array buffer.
-  auto arrRes = JSArray::create(runtime, numElements, numElements);
+  const bool pretenure = site && site->shouldPretenure();
+  auto arrRes = JSArray::create(runtime, numElements, numElements, pretenure);
   if (arrRes == ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
@@ -676,14 +911,28 @@ CallResult<HermesValue> Interpreter::createArrayFromBuffer(
   auto arr = toHandle(runtime, std::move(*arrRes));
   JSArray::setStorageEndIndex(arr, runtime, numElements);
 
-  auto iter = curCodeBlock->getArrayBufferIter(bufferIndex, numLiterals);
-  JSArray::size_type i = 0;
-  while (iter.hasNext()) {
-    // NOTE: we must get the value in a separate step to guarantee ordering.
-    auto value = iter.get(runtime);
-    JSArray::unsafeSetExistingElementAt(*arr, runtime, i++, value);
+  // The values of a literal created repeatedly are decoded only once, and
+  // copied into its storage in bulk.
+  if (ArrayStorage *values =
+          curCodeBlock->getRuntimeModule()->getLiteralValuesMayAllocate(
+              RuntimeModule::LiteralValueBuffer::Array,
+              bufferIndex,
+              numLiterals)) {
+    JSArray::unsafeSetExistingElements(
+        *arr, runtime, 0, values->begin(), values->end());
+  } else {
+    auto iter = curCodeBlock->getArrayBufferIter(bufferIndex, numLiterals);
+    JSArray::size_type i = 0;
+    while (iter.hasNext()) {
+      // NOTE: we must get the value in a separate step to guarantee ordering.
+      auto value = iter.get(runtime);
+      JSArray::unsafeSetExistingElementAt(*arr, runtime, i++, value);
+    }
   }
 
+  if (site && !pretenure) {
+    runtime->getHeap().sampleAllocationSite(*arr, site);
+  }
   return HermesValue::encodeObjectValue(*arr);
 }
 
@@ -781,6 +1030,13 @@ static bool isCallType(OpCode opcode) {
 
 #endif
 
+/// \return whether \p opcode is one of Call1 through Call4, which copy their
+/// arguments into the outgoing slots instead of passing registers.
+static inline bool isCallNOpCode(OpCode opcode) {
+  return opcode == OpCode::Call1 || opcode == OpCode::Call2 ||
+      opcode == OpCode::Call3 || opcode == OpCode::Call4;
+}
+
 /// \return the address of the next instruction after \p ip, which must be a
 /// call-type instruction.
 LLVM_ATTRIBUTE_ALWAYS_INLINE
@@ -820,7 +1076,9 @@ static inline const Inst *nextInstCall(const Inst *ip) {
 CallResult<HermesValue> Runtime::interpretFunctionImpl(
     CodeBlock *newCodeBlock) {
   InterpreterState state{newCodeBlock, 0};
-  return Interpreter::interpretFunction<false>(this, state);
+  if (LLVM_UNLIKELY(needsInstrumentedInterpreter()))
+    return Interpreter::interpretFunction<false, true>(this, state);
+  return Interpreter::interpretFunction<false, false>(this, state);
 }
 
 CallResult<HermesValue> Runtime::interpretFunction(CodeBlock *newCodeBlock) {
@@ -837,7 +1095,20 @@ CallResult<HermesValue> Runtime::interpretFunction(CodeBlock *newCodeBlock) {
 
 #ifdef HERMES_ENABLE_DEBUGGER
 ExecutionStatus Runtime::stepFunction(InterpreterState &state) {
-  return Interpreter::interpretFunction<true>(this, state).getStatus();
+  return Interpreter::interpretFunction<true, true>(this, state).getStatus();
+}
+#endif
+
+#ifdef HERMESVM_JIT
+CallResult<HermesValue> Runtime::resumeFunction(
+    CodeBlock *codeBlock,
+    uint32_t offset) {
+  InterpreterState state{codeBlock, offset};
+  const PinnedHermesValue *frame = getCurrentFrame().ptr();
+  if (LLVM_UNLIKELY(needsInstrumentedInterpreter()))
+    return Interpreter::interpretFunction<false, true>(
+        this, state, true, frame);
+  return Interpreter::interpretFunction<false, false>(this, state, true, frame);
 }
 #endif
 
@@ -864,13 +1135,17 @@ static inline double doSub(double x, double y) {
   return x - y;
 }
 
-template <bool SingleStep>
+template <bool SingleStep, bool Instrumented>
 CallResult<HermesValue> Interpreter::interpretFunction(
     Runtime *runtime,
-    InterpreterState &state) {
+    InterpreterState &state,
+    bool resume,
+    const PinnedHermesValue *resumeFrame) {
 #ifndef HERMES_ENABLE_DEBUGGER
   static_assert(!SingleStep, "can't use single-step mode without the debugger");
 #endif
+  static_assert(
+      !SingleStep || Instrumented, "single-stepping is only for the debugger");
   // Make sure that the cache can use an optimization by avoiding a branch to
   // access the property storage.
   static_assert(
@@ -896,7 +1171,7 @@ CallResult<HermesValue> Interpreter::interpretFunction(
     return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
   }
 
-  if (!SingleStep) {
+  if (!SingleStep && !resume) {
     curCodeBlock->lazyCompile(runtime);
     if (auto jitPtr = runtime->jitContext_.compile(runtime, curCodeBlock))
       return (*jitPtr)(runtime);
@@ -923,13 +1198,15 @@ tailCall:
   PROFILER_ENTER_FUNCTION(curCodeBlock);
 
 #ifdef HERMES_ENABLE_DEBUGGER
-  runtime->getDebugger().willEnterCodeBlock(curCodeBlock);
+  // The code block of a resumed frame was entered already.
+  if (Instrumented && !resume)
+    runtime->getDebugger().willEnterCodeBlock(curCodeBlock);
 #endif
 
   // Update function executionCount_ count
   curCodeBlock->incrementExecutionCount();
 
-  if (!SingleStep) {
+  if (!SingleStep && !resume) {
     auto newFrame = runtime->setCurrentFrameToTopOfStack();
     runtime->saveCallerIPInStackFrame();
 
@@ -984,11 +1261,15 @@ tailCall:
     // Point frameRegs to the first register in the frame.
     frameRegs = &runtime->getCurrentFrame().getFirstLocalRef();
     ip = (Inst const *)(curCodeBlock->begin() + state.offset);
+    // The functions this one calls get frames of their own.
+    resume = false;
   }
 
   assert((const uint8_t *)ip < curCodeBlock->end() && "CodeBlock is empty");
 
   INIT_STATE_FOR_CODEBLOCK(curCodeBlock);
+  if (Instrumented)
+    runtime->functionProfilerEnter(curCodeBlock, FRAME.ptr());
 
 #define BEFORE_OP_CODE                                                       \
   {                                                                          \
@@ -1000,8 +1281,33 @@ tailCall:
     HERMES_SLOW_ASSERT(tmpHandle->isUndefined() && "tmpHandle not cleared"); \
     RECORD_OPCODE_START_TIME;                                                \
     INC_OPCODE_COUNT;                                                        \
+    runtime->setCurrentIP(ip);                                               \
   }
 
+// Run the simple instructions from ip on in the tail-call handlers, which keep
+// the interpreter state in machine registers, and continue with the first one
+// they don't run. The handlers are only entered at an instruction they run, so
+// the other instructions don't pay for the call. The opcode profiler has to
+// see every instruction, and the instrumented and single-stepping loops have
+// to stop at every one of them.
+#if defined(HERMESVM_TAIL_CALL_DISPATCH) && !defined(HERMESVM_PROFILER_OPCODE)
+  static const bool tailCallOpcodes[] = {
+#define DEFINE_OPCODE(name) tailcall::HasHandler<OpCode::name>::value,
+#include "hermes/BCGen/HBC/BytecodeList.def"
+  };
+
+#define RUN_TAIL_CALL_HANDLERS                          \
+  do {                                                  \
+    if (!SingleStep && !Instrumented &&                 \
+        tailCallOpcodes[(unsigned)ip->opCode])          \
+      ip = runTailCallHandlers(runtime, frameRegs, ip); \
+  } while (0)
+#else
+#define RUN_TAIL_CALL_HANDLERS \
+  do {                         \
+  } while (0)
+#endif
+
 #ifdef HERMESVM_INDIRECT_THREADING
   static void *opcodeDispatch[] = {
 #define DEFINE_OPCODE(name) &&case_##name,
@@ -1010,6 +1316,7 @@ tailCall:
 
 #define CASE(name) case_##name:
 #define DISPATCH                                \
+  RUN_TAIL_CALL_HANDLERS;                       \
   BEFORE_OP_CODE;                               \
   if (SingleStep) {                             \
     state.codeBlock = curCodeBlock;             \
@@ -1046,6 +1353,7 @@ tailCall:
   } while (0)
 
   for (;;) {
+    RUN_TAIL_CALL_HANDLERS;
     BEFORE_OP_CODE;
 
 #ifdef HERMESVM_INDIRECT_THREADING
@@ -1055,6 +1363,7 @@ tailCall:
 #endif
     {
       const Inst *nextIP;
+      uint32_t savedRegCount;
       uint32_t idVal;
       bool tryProp;
       uint32_t callArgCount;
@@ -1082,7 +1391,8 @@ tailCall:
   }
 
 /// Implement a binary arithmetic instruction with a fast path where both
-/// operands are numbers.
+/// operands are numbers. The slow path is recorded as type feedback for the
+/// JIT.
 /// \param name the name of the instruction. The fast path case will have a
 ///     "n" appended to the name.
 /// \param oper the C++ operator to use to actually perform the arithmetic
@@ -1098,6 +1408,7 @@ tailCall:
         DISPATCH;                                                        \
       }                                                                  \
     }                                                                    \
+    curCodeBlock->recordNonNumberArith(ip);                              \
     runtime->storeCallerIP(ip);                                          \
     res = toNumber_RJS(runtime, Handle<>(&O2REG(name)));                 \
     runtime->clearCallerIP();                                            \
@@ -1195,7 +1506,66 @@ tailCall:
     DISPATCH;                                                                  \
   }
 
-/// Implement a comparison instruction.
+/// Implement an instruction computing a Math method of one argument inline,
+/// with a fast path where the operand is a number. Like BINOP, the slow path
+/// is recorded as type feedback for the JIT.
+/// \param name the name of the instruction.
+/// \param func the C++ function computing the method on a double.
+#define MATHOP1(name, func)                                               \
+  CASE(name) {                                                            \
+    if (LLVM_LIKELY(O2REG(name).isNumber())) {                            \
+      /* Fast-path. */                                                    \
+      O1REG(name) =                                                       \
+          HermesValue::encodeDoubleValue(func(O2REG(name).getNumber()));  \
+      ip = NEXTINST(name);                                                \
+      DISPATCH;                                                           \
+    }                                                                     \
+    curCodeBlock->recordNonNumberArith(ip);                               \
+    runtime->storeCallerIP(ip);                                           \
+    res = toNumber_RJS(runtime, Handle<>(&O2REG(name)));                  \
+    runtime->clearCallerIP();                                             \
+    if (res == ExecutionStatus::EXCEPTION)                                \
+      goto exception;                                                     \
+    O1REG(name) = HermesValue::encodeDoubleValue(func(res->getDouble())); \
+    gcScope.flushToSmallCount(KEEP_HANDLES);                              \
+    ip = NEXTINST(name);                                                  \
+    DISPATCH;                                                             \
+  }
+
+/// Implement an instruction computing a Math method of two arguments inline.
+/// Both operands are converted before computing the result, like BINOP.
+/// \param name the name of the instruction.
+/// \param func the C++ function computing the method on doubles.
+#define MATHOP2(name, func)                                              \
+  CASE(name) {                                                           \
+    if (LLVM_LIKELY(O2REG(name).isNumber() && O3REG(name).isNumber())) { \
+      /* Fast-path. */                                                   \
+      O1REG(name) = HermesValue::encodeDoubleValue(                      \
+          func(O2REG(name).getNumber(), O3REG(name).getNumber()));       \
+      ip = NEXTINST(name);                                               \
+      DISPATCH;                                                          \
+    }                                                                    \
+    curCodeBlock->recordNonNumberArith(ip);                              \
+    runtime->storeCallerIP(ip);                                          \
+    res = toNumber_RJS(runtime, Handle<>(&O2REG(name)));                 \
+    runtime->clearCallerIP();                                            \
+    if (res == ExecutionStatus::EXCEPTION)                               \
+      goto exception;                                                    \
+    double left = res->getDouble();                                      \
+    runtime->storeCallerIP(ip);                                          \
+    res = toNumber_RJS(runtime, Handle<>(&O3REG(name)));                 \
+    runtime->clearCallerIP();                                            \
+    if (res == ExecutionStatus::EXCEPTION)                               \
+      goto exception;                                                    \
+    O1REG(name) =                                                        \
+        HermesValue::encodeDoubleValue(func(left, res->getDouble()));    \
+    gcScope.flushToSmallCount(KEEP_HANDLES);                             \
+    ip = NEXTINST(name);                                                 \
+    DISPATCH;                                                            \
+  }
+
+/// Implement a comparison instruction. Like BINOP, the slow path is recorded
+/// as type feedback for the JIT.
 /// \param name the name of the instruction.
 /// \param oper the C++ operator to use to actually perform the fast arithmetic
 ///     comparison.
@@ -1209,6 +1579,7 @@ tailCall:
       ip = NEXTINST(name);                                                     \
       DISPATCH;                                                                \
     }                                                                          \
+    curCodeBlock->recordNonNumberArith(ip);                                    \
     runtime->storeCallerIP(ip);                                                \
     boolRes =                                                                  \
         operFuncName(runtime, Handle<>(&O2REG(name)), Handle<>(&O3REG(name))); \
@@ -1221,6 +1592,23 @@ tailCall:
     DISPATCH;                                                                  \
   }
 
+/// Continue at \p target, the destination of a jump. A jump that doesn't go
+/// forward closes a loop, so it is counted towards JIT compilation of the
+/// function and may continue running the loop in native code.
+#ifdef HERMESVM_JIT
+#define BRANCH(target)                 \
+  if (LLVM_UNLIKELY((target) <= ip)) { \
+    ip = (target);                     \
+    goto loopBackEdge;                 \
+  }                                    \
+  ip = (target);                       \
+  DISPATCH
+#else
+#define BRANCH(target) \
+  ip = (target);       \
+  DISPATCH
+#endif
+
 /// Implement a comparison conditional jump with a fast path where both
 /// operands are numbers.
 /// \param name the name of the instruction. The fast path case will have a
@@ -1241,11 +1629,9 @@ tailCall:
         if (O2REG(name##N##suffix)                                        \
                 .getNumber() oper O3REG(name##N##suffix)                  \
                 .getNumber()) {                                           \
-          ip = trueDest;                                                  \
-          DISPATCH;                                                       \
+          BRANCH(trueDest);                                               \
         }                                                                 \
-        ip = falseDest;                                                   \
-        DISPATCH;                                                         \
+        BRANCH(falseDest);                                                \
       }                                                                   \
     }                                                                     \
     runtime->storeCallerIP(ip);                                           \
@@ -1258,11 +1644,9 @@ tailCall:
       goto exception;                                                     \
     gcScope.flushToSmallCount(KEEP_HANDLES);                              \
     if (boolRes.getValue()) {                                             \
-      ip = trueDest;                                                      \
-      DISPATCH;                                                           \
+      BRANCH(trueDest);                                                   \
     }                                                                     \
-    ip = falseDest;                                                       \
-    DISPATCH;                                                             \
+    BRANCH(falseDest);                                                    \
   }
 
 /// Implement a strict equality conditional jump
@@ -1273,11 +1657,9 @@ tailCall:
 #define JCOND_STRICT_EQ_IMPL(name, suffix, trueDest, falseDest)         \
   CASE(name##suffix) {                                                  \
     if (strictEqualityTest(O2REG(name##suffix), O3REG(name##suffix))) { \
-      ip = trueDest;                                                    \
-      DISPATCH;                                                         \
+      BRANCH(trueDest);                                                 \
     }                                                                   \
-    ip = falseDest;                                                     \
-    DISPATCH;                                                           \
+    BRANCH(falseDest);                                                  \
   }
 
 /// Implement an equality conditional jump
@@ -1298,11 +1680,9 @@ tailCall:
     }                                                    \
     gcScope.flushToSmallCount(KEEP_HANDLES);             \
     if (res->getBool()) {                                \
-      ip = trueDest;                                     \
-      DISPATCH;                                          \
+      BRANCH(trueDest);                                  \
     }                                                    \
-    ip = falseDest;                                      \
-    DISPATCH;                                            \
+    BRANCH(falseDest);                                   \
   }
 
 /// Implement the long and short forms of a conditional jump, and its negation.
@@ -1497,14 +1877,20 @@ tailCall:
 
     doCall : {
 #ifdef HERMES_ENABLE_DEBUGGER
-      // Check for an async debugger request.
-      if (uint8_t asyncFlags =
-              runtime->testAndClearDebuggerAsyncBreakRequest()) {
-        RUN_DEBUGGER_ASYNC_BREAK(asyncFlags);
-        gcScope.flushToSmallCount(KEEP_HANDLES);
-        DISPATCH;
+      // Check for an async debugger request. The uninstrumented loop leaves
+      // them to AsyncBreakCheck.
+      if (Instrumented) {
+        if (uint8_t asyncFlags =
+                runtime->testAndClearDebuggerAsyncBreakRequest()) {
+          RUN_DEBUGGER_ASYNC_BREAK(asyncFlags);
+          gcScope.flushToSmallCount(KEEP_HANDLES);
+          DISPATCH;
+        }
       }
 #endif
+      // The function profiler may have been enabled since this loop started.
+      if (!Instrumented && LLVM_UNLIKELY(runtime->functionProfilerActive_))
+        goto runInstrumented;
       runtime->storeCallerIP(ip);
 
       // Subtract 1 from callArgCount as 'this' is considered an argument in the
@@ -1517,11 +1903,26 @@ tailCall:
           callArgCount - 1,
           O2REG(Call),
           HermesValue::fromRaw(callNewTarget));
-      (void)newFrame;
 
       SLOW_DEBUG(dumpCallArguments(dbgs(), runtime, newFrame));
 
-      if (auto *func = dyn_vmcast<JSFunction>(O2REG(Call))) {
+      auto *func = dyn_vmcast<JSFunction>(O2REG(Call));
+      if (LLVM_UNLIKELY(!func) && isCallNOpCode(ip->opCode)) {
+        // CallN writes "thisArg" into a slot the caller doesn't read after
+        // the call, so a function that binds only "this" can run its target
+        // in this frame, without a native call in between.
+        auto *bound = dyn_vmcast<BoundFunction>(O2REG(Call));
+        if (bound && bound->bindsOnlyThis(runtime)) {
+          func = dyn_vmcast<JSFunction>(bound->getTarget(runtime));
+          if (func) {
+            ++NumBoundFunctionCalls;
+            newFrame.getCalleeClosureOrCBRef() =
+                HermesValue::encodeObjectValue(func);
+            newFrame.getThisArgRef() = bound->getBoundThis(runtime);
+          }
+        }
+      }
+      if (func) {
         assert(!SingleStep && "can't single-step a call");
 
         CodeBlock *calleeBlock = func->getCodeBlock();
@@ -1570,13 +1971,17 @@ tailCall:
       CASE(CallDirectLongIndex) {
 #ifdef HERMES_ENABLE_DEBUGGER
         // Check for an async debugger request.
-        if (uint8_t asyncFlags =
-                runtime->testAndClearDebuggerAsyncBreakRequest()) {
-          RUN_DEBUGGER_ASYNC_BREAK(asyncFlags);
-          gcScope.flushToSmallCount(KEEP_HANDLES);
-          DISPATCH;
+        if (Instrumented) {
+          if (uint8_t asyncFlags =
+                  runtime->testAndClearDebuggerAsyncBreakRequest()) {
+            RUN_DEBUGGER_ASYNC_BREAK(asyncFlags);
+            gcScope.flushToSmallCount(KEEP_HANDLES);
+            DISPATCH;
+          }
         }
 #endif
+        if (!Instrumented && LLVM_UNLIKELY(runtime->functionProfilerActive_))
+          goto runInstrumented;
         runtime->storeCallerIP(ip);
 
         CodeBlock *calleeBlock = ip->opCode == OpCode::CallDirect
@@ -1670,10 +2075,14 @@ tailCall:
 
       CASE(SaveGenerator) {
         nextIP = IPADD(ip->iSaveGenerator.op1);
+        savedRegCount = ip->iSaveGenerator.op2;
+        ip = NEXTINST(SaveGenerator);
         goto doSaveGen;
       }
       CASE(SaveGeneratorLong) {
         nextIP = IPADD(ip->iSaveGeneratorLong.op1);
+        savedRegCount = ip->iSaveGeneratorLong.op2;
+        ip = NEXTINST(SaveGeneratorLong);
         goto doSaveGen;
       }
 
@@ -1681,10 +2090,9 @@ tailCall:
       auto *innerFn = vmcast<GeneratorInnerFunction>(
           runtime->getCurrentFrame().getCalleeClosure());
 
-      innerFn->saveStack(runtime);
+      innerFn->saveStack(runtime, savedRegCount);
       innerFn->setNextIP(nextIP);
       innerFn->setState(GeneratorInnerFunction::State::SuspendedYield);
-      ip = NEXTINST(SaveGenerator);
       DISPATCH;
     }
 
@@ -1721,19 +2129,37 @@ tailCall:
       CASE(Ret) {
 #ifdef HERMES_ENABLE_DEBUGGER
         // Check for an async debugger request.
-        if (uint8_t asyncFlags =
-                runtime->testAndClearDebuggerAsyncBreakRequest()) {
-          RUN_DEBUGGER_ASYNC_BREAK(asyncFlags);
-          gcScope.flushToSmallCount(KEEP_HANDLES);
-          DISPATCH;
+        if (Instrumented) {
+          if (uint8_t asyncFlags =
+                  runtime->testAndClearDebuggerAsyncBreakRequest()) {
+            RUN_DEBUGGER_ASYNC_BREAK(asyncFlags);
+            gcScope.flushToSmallCount(KEEP_HANDLES);
+            DISPATCH;
+          }
+        }
+#endif
+        if (!Instrumented && LLVM_UNLIKELY(runtime->functionProfilerActive_))
+          goto runInstrumented;
+        // Store the return value.
+        res = O1REG(Ret);
+
+#ifdef HERMESVM_JIT
+      // We arrive here when the rest of the function ran in native code and
+      // returned res.
+      returnFromFunction:
+        if (LLVM_UNLIKELY(FRAME.ptr() == resumeFrame)) {
+          PROFILER_EXIT_FUNCTION(curCodeBlock);
+          if (Instrumented)
+            runtime->functionProfilerExit(FRAME.ptr());
+          return res;
         }
 #endif
+
         runtime->restoreCallerIPFromStackFrame();
 
         PROFILER_EXIT_FUNCTION(curCodeBlock);
-
-        // Store the return value.
-        res = O1REG(Ret);
+        if (Instrumented)
+          runtime->functionProfilerExit(FRAME.ptr());
 
         ip = FRAME.getSavedIP();
         curCodeBlock = FRAME.getSavedCodeBlock();
@@ -1800,6 +2226,8 @@ tailCall:
       CASE(Debugger) {
         SLOW_DEBUG(dbgs() << "debugger statement executed\n");
 #ifdef HERMES_ENABLE_DEBUGGER
+        if (!Instrumented)
+          goto runInstrumented;
         {
           if (!runtime->debugger_.isDebugging()) {
             // Only run the debugger if we're not already debugging.
@@ -1860,6 +2288,9 @@ tailCall:
       CASE(AsyncBreakCheck) {
         if (LLVM_UNLIKELY(runtime->hasAsyncBreak())) {
 #ifdef HERMES_ENABLE_DEBUGGER
+          // Let the instrumented loop take the break at this instruction.
+          if (!Instrumented && runtime->hasDebuggerAsyncBreakRequest())
+            goto runInstrumented;
           if (uint8_t asyncFlags =
                   runtime->testAndClearDebuggerAsyncBreakRequest()) {
             RUN_DEBUGGER_ASYNC_BREAK(asyncFlags);
@@ -1870,6 +2301,13 @@ tailCall:
               goto exception;
             }
           }
+          if (runtime->testAndClearInterruptAsyncBreakRequest()) {
+            // The handler may call into JS.
+            runtime->storeCallerIP(ip);
+            if (runtime->notifyInterrupt() == ExecutionStatus::EXCEPTION) {
+              goto exception;
+            }
+          }
         }
         gcScope.flushToSmallCount(KEEP_HANDLES);
 
@@ -2066,6 +2504,51 @@ tailCall:
         DISPATCH;
       }
 
+      CASE(GetEnvironmentAndLoad) {
+        Environment *curEnv =
+            FRAME.getCalleeClosureUnsafe()->getEnvironment(runtime);
+        for (unsigned level = ip->iGetEnvironmentAndLoad.op3; level; --level) {
+          assert(curEnv && "invalid environment relative level");
+          curEnv = curEnv->getParentEnvironment(runtime);
+        }
+        O1REG(GetEnvironmentAndLoad) = HermesValue::encodeObjectValue(curEnv);
+        O2REG(GetEnvironmentAndLoad) =
+            curEnv->slot(ip->iGetEnvironmentAndLoad.op4);
+        ip = NEXTINST(GetEnvironmentAndLoad);
+        DISPATCH;
+      }
+
+      CASE(GetEnvironmentAndStore) {
+        Environment *curEnv =
+            FRAME.getCalleeClosureUnsafe()->getEnvironment(runtime);
+        for (unsigned level = ip->iGetEnvironmentAndStore.op2; level;
+             --level) {
+          assert(curEnv && "invalid environment relative level");
+          curEnv = curEnv->getParentEnvironment(runtime);
+        }
+        O1REG(GetEnvironmentAndStore) = HermesValue::encodeObjectValue(curEnv);
+        curEnv->slot(ip->iGetEnvironmentAndStore.op3)
+            .set(O4REG(GetEnvironmentAndStore), &runtime->getHeap());
+        ip = NEXTINST(GetEnvironmentAndStore);
+        DISPATCH;
+      }
+
+      CASE(GetEnvironmentAndStoreNP) {
+        Environment *curEnv =
+            FRAME.getCalleeClosureUnsafe()->getEnvironment(runtime);
+        for (unsigned level = ip->iGetEnvironmentAndStoreNP.op2; level;
+             --level) {
+          assert(curEnv && "invalid environment relative level");
+          curEnv = curEnv->getParentEnvironment(runtime);
+        }
+        O1REG(GetEnvironmentAndStoreNP) =
+            HermesValue::encodeObjectValue(curEnv);
+        curEnv->slot(ip->iGetEnvironmentAndStoreNP.op3)
+            .setNonPtr(O4REG(GetEnvironmentAndStoreNP));
+        ip = NEXTINST(GetEnvironmentAndStoreNP);
+        DISPATCH;
+      }
+
       CASE(GetGlobalObject) {
         O1REG(GetGlobalObject) = runtime->global_;
         ip = NEXTINST(GetGlobalObject);
@@ -2130,6 +2613,35 @@ tailCall:
         nextIP = NEXTINST(GetByIdLong);
         goto getById;
       }
+      CASE(GetByIdSlot) {
+        if (LLVM_LIKELY(O2REG(GetByIdSlot).isObject())) {
+          auto *obj = vmcast<JSObject>(O2REG(GetByIdSlot));
+          auto *cacheEntry =
+              curCodeBlock->getReadCacheEntry(ip->iGetByIdSlot.op3);
+          // The entry only caches classes with the property at the slot.
+          if (LLVM_LIKELY(
+                  cacheEntry->clazz ==
+                  obj->getClassGCPtr().getStorageType())) {
+            ++NumGetByIdSlotHits;
+            ++cacheEntry->hits;
+            O1REG(GetByIdSlot) = JSObject::getNamedSlotValue(
+                obj, runtime, ip->iGetByIdSlot.op4);
+            ip = NEXTINST(GetByIdSlot);
+            DISPATCH;
+          }
+          ++cacheEntry->misses;
+        }
+        runtime->storeCallerIP(ip);
+        auto status = caseGetByIdSlot(runtime, frameRegs, ip);
+        runtime->clearCallerIP();
+        if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+          goto exception;
+        }
+        gcScope.flushToSmallCount(KEEP_HANDLES);
+        ip = NEXTINST(GetByIdSlot);
+        DISPATCH;
+      }
+
       CASE(GetByIdShort) {
         tryProp = false;
         idVal = ip->iGetByIdShort.op4;
@@ -2164,10 +2676,8 @@ tailCall:
               gcScope.getHandleCountDbg() == KEEP_HANDLES &&
               "unaccounted handles were created");
           auto objHandle = runtime->makeHandle(obj);
-          auto cacheHCPtr = vmcast_or_null<HiddenClass>(static_cast<GCCell *>(
-              GCPointerBase::storageTypeToPointer(cacheEntry->clazz, runtime)));
           runtime->recordHiddenClass(
-              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), cacheHCPtr);
+              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), *cacheEntry);
           // obj may be moved by GC due to recordHiddenClass
           obj = objHandle.get();
         }
@@ -2178,12 +2688,44 @@ tailCall:
         // return the property.
         if (LLVM_LIKELY(cacheEntry->clazz == clazzGCPtr.getStorageType())) {
           ++NumGetByIdCacheHits;
+          ++cacheEntry->hits;
           O1REG(GetById) =
               JSObject::getNamedSlotValue<PropStorage::Inline::Yes>(
                   obj, runtime, cacheEntry->slot);
           ip = nextIP;
           DISPATCH;
         }
+        if (cacheEntry->globalEpoch == runtime->getGlobalPropertyEpoch() &&
+            LLVM_LIKELY(runtime->isGlobal(obj))) {
+          ++NumGetByIdGlobalHits;
+          ++cacheEntry->hits;
+          O1REG(GetById) = JSObject::getNamedSlotValue(
+              obj, runtime, cacheEntry->globalSlot);
+          ip = nextIP;
+          DISPATCH;
+        }
+        SlotIndex cachedSlot;
+        if (LLVM_LIKELY(cacheEntry->findPolymorphic(
+                clazzGCPtr.getStorageType(), cachedSlot))) {
+          ++NumGetByIdPolyHits;
+          ++cacheEntry->hits;
+          O1REG(GetById) =
+              JSObject::getNamedSlotValue<PropStorage::Inline::Yes>(
+                  obj, runtime, cachedSlot);
+          ip = nextIP;
+          DISPATCH;
+        }
+        // The property may have been found on a prototype before.
+        if (JSObject *holder =
+                JSObject::getCachedPrototypeHolder(obj, runtime, *cacheEntry)) {
+          ++NumGetByIdProtoHits;
+          ++cacheEntry->hits;
+          O1REG(GetById) = JSObject::getNamedSlotValue(
+              holder, runtime, cacheEntry->protoSlot);
+          ip = nextIP;
+          DISPATCH;
+        }
+        ++cacheEntry->misses;
         auto id = ID(idVal);
         NamedPropertyDescriptor desc;
         OptValue<bool> fastPathResult =
@@ -2193,21 +2735,35 @@ tailCall:
             !desc.flags.accessor) {
           ++NumGetByIdFastPaths;
 
+          auto *clazz = clazzGCPtr.getNonNull(runtime);
+          if (LLVM_UNLIKELY(clazz->isDictionary()) &&
+              clazz->noteDictionaryRead() &&
+              JSObject::tryLeaveDictionaryMode(
+                  Handle<JSObject>::vmcast(&O2REG(GetById)), runtime)) {
+            ++NumGetByIdDictionaryExits;
+            // Execute the instruction again, to cache the new class.
+            gcScope.flushToSmallCount(KEEP_HANDLES);
+            DISPATCH;
+          }
+
           // cacheIdx == 0 indicates no caching so don't update the cache in
           // those cases.
-          auto *clazz = clazzGCPtr.getNonNull(runtime);
           if (LLVM_LIKELY(!clazz->isDictionaryNoCache()) &&
               LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
+            // Cache the class, id and property slot.
+            cacheEntry->update(clazzGCPtr.getStorageType(), desc.slot);
 #ifdef HERMES_SLOW_DEBUG
-            if (cacheEntry->clazz &&
-                cacheEntry->clazz != clazzGCPtr.getStorageType())
+            // Only a megamorphic entry evicts the classes it caches.
+            if (cacheEntry->megamorphic)
               ++NumGetByIdCacheEvicts;
 #else
             (void)NumGetByIdCacheEvicts;
 #endif
-            // Cache the class, id and property slot.
-            cacheEntry->clazz = clazzGCPtr.getStorageType();
-            cacheEntry->slot = desc.slot;
+          }
+          if (LLVM_UNLIKELY(runtime->isGlobal(obj)) &&
+              LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
+            cacheEntry->globalEpoch = runtime->getGlobalPropertyEpoch();
+            cacheEntry->globalSlot = desc.slot;
           }
 
           O1REG(GetById) = JSObject::getNamedSlotValue(obj, runtime, desc);
@@ -2215,21 +2771,15 @@ tailCall:
           DISPATCH;
         }
 
-        // The cache may also be populated via the prototype of the object.
-        // This value is only reliable if the fast path was a definite
+        // A dictionary receiver is not checked by the prototype entry of the
+        // cache, which is only reliable if the fast path was a definite
         // not-found.
         if (fastPathResult.hasValue() && !fastPathResult.getValue()) {
-          JSObject *parent = obj->getParent(runtime);
-          // TODO: This isLazy check is because a lazy object is reported as
-          // having no properties and therefore cannot contain the property.
-          // This check does not belong here, it should be merged into
-          // tryGetOwnNamedDescriptorFast().
-          if (parent &&
-              cacheEntry->clazz == parent->getClassGCPtr().getStorageType() &&
-              LLVM_LIKELY(!obj->isLazy())) {
+          if (JSObject *holder = JSObject::getCachedPrototypeHolder(
+                  obj, runtime, *cacheEntry, true)) {
             ++NumGetByIdProtoHits;
-            O1REG(GetById) =
-                JSObject::getNamedSlotValue(parent, runtime, cacheEntry->slot);
+            O1REG(GetById) = JSObject::getNamedSlotValue(
+                holder, runtime, cacheEntry->protoSlot);
             ip = nextIP;
             DISPATCH;
           }
@@ -2316,10 +2866,8 @@ tailCall:
               gcScope.getHandleCountDbg() == KEEP_HANDLES &&
               "unaccounted handles were created");
           auto objHandle = runtime->makeHandle(obj);
-          auto cacheHCPtr = vmcast_or_null<HiddenClass>(static_cast<GCCell *>(
-              GCPointerBase::storageTypeToPointer(cacheEntry->clazz, runtime)));
           runtime->recordHiddenClass(
-              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), cacheHCPtr);
+              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), *cacheEntry);
           // obj may be moved by GC due to recordHiddenClass
           obj = objHandle.get();
         }
@@ -2330,11 +2878,23 @@ tailCall:
         // return the property.
         if (LLVM_LIKELY(cacheEntry->clazz == clazzGCPtr.getStorageType())) {
           ++NumPutByIdCacheHits;
+          ++cacheEntry->hits;
           JSObject::setNamedSlotValue<PropStorage::Inline::Yes>(
               obj, runtime, cacheEntry->slot, O2REG(PutById));
           ip = nextIP;
           DISPATCH;
         }
+        SlotIndex cachedSlot;
+        if (LLVM_LIKELY(cacheEntry->findPolymorphic(
+                clazzGCPtr.getStorageType(), cachedSlot))) {
+          ++NumPutByIdPolyHits;
+          ++cacheEntry->hits;
+          JSObject::setNamedSlotValue<PropStorage::Inline::Yes>(
+              obj, runtime, cachedSlot, O2REG(PutById));
+          ip = nextIP;
+          DISPATCH;
+        }
+        ++cacheEntry->misses;
         auto id = ID(idVal);
         NamedPropertyDescriptor desc;
         OptValue<bool> hasOwnProp =
@@ -2349,16 +2909,15 @@ tailCall:
           auto *clazz = clazzGCPtr.getNonNull(runtime);
           if (LLVM_LIKELY(!clazz->isDictionary()) &&
               LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
+            // Cache the class and property slot.
+            cacheEntry->update(clazzGCPtr.getStorageType(), desc.slot);
 #ifdef HERMES_SLOW_DEBUG
-            if (cacheEntry->clazz &&
-                cacheEntry->clazz != clazzGCPtr.getStorageType())
+            // Only a megamorphic entry evicts the classes it caches.
+            if (cacheEntry->megamorphic)
               ++NumPutByIdCacheEvicts;
 #else
             (void)NumPutByIdCacheEvicts;
 #endif
-            // Cache the class and property slot.
-            cacheEntry->clazz = clazzGCPtr.getStorageType();
-            cacheEntry->slot = desc.slot;
           }
 
           JSObject::setNamedSlotValue(obj, runtime, desc.slot, O2REG(PutById));
@@ -2400,6 +2959,15 @@ tailCall:
       CASE(GetByVal) {
         CallResult<HermesValue> propRes{ExecutionStatus::EXCEPTION};
         if (LLVM_LIKELY(O2REG(GetByVal).isObject())) {
+          if (auto fastRes = getByValObjectFast(
+                  runtime,
+                  vmcast<JSObject>(O2REG(GetByVal)),
+                  O3REG(GetByVal))) {
+            ++NumGetByValFastPaths;
+            O1REG(GetByVal) = *fastRes;
+            ip = NEXTINST(GetByVal);
+            DISPATCH;
+          }
           runtime->storeCallerIP(ip);
           propRes = JSObject::getComputed_RJS(
               Handle<JSObject>::vmcast(&O2REG(GetByVal)),
@@ -2427,6 +2995,15 @@ tailCall:
 
       CASE(PutByVal) {
         if (LLVM_LIKELY(O1REG(PutByVal).isObject())) {
+          if (LLVM_LIKELY(putByValObjectFast(
+                  runtime,
+                  vmcast<JSObject>(O1REG(PutByVal)),
+                  O2REG(PutByVal),
+                  O3REG(PutByVal)))) {
+            ++NumPutByValFastPaths;
+            ip = NEXTINST(PutByVal);
+            DISPATCH;
+          }
           runtime->storeCallerIP(ip);
           auto putRes = JSObject::putComputed_RJS(
               Handle<JSObject>::vmcast(&O1REG(PutByVal)),
@@ -2588,54 +3165,69 @@ tailCall:
         DISPATCH;
       }
 
-      CASE(Jmp) {
-        ip = IPADD(ip->iJmp.op1);
+      CASE(StringConcat) {
+        // The values are in the outgoing registers, where "thisArg" would be
+        // followed by the arguments of a call.
+        runtime->storeCallerIP(ip);
+        res = stringConcat_RJS(
+            runtime,
+            &runtime->stackPointer_[StackFrameLayout::ThisArg],
+            ip->iStringConcat.op2);
+        runtime->clearCallerIP();
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+          goto exception;
+        gcScope.flushToSmallCount(KEEP_HANDLES);
+        O1REG(StringConcat) = res.getValue();
+        ip = NEXTINST(StringConcat);
         DISPATCH;
       }
+
+      CASE(Jmp) {
+        BRANCH(IPADD(ip->iJmp.op1));
+      }
       CASE(JmpLong) {
-        ip = IPADD(ip->iJmpLong.op1);
-        DISPATCH;
+        BRANCH(IPADD(ip->iJmpLong.op1));
       }
       CASE(JmpTrue) {
-        if (toBoolean(O2REG(JmpTrue)))
-          ip = IPADD(ip->iJmpTrue.op1);
-        else
-          ip = NEXTINST(JmpTrue);
+        if (toBoolean(O2REG(JmpTrue))) {
+          BRANCH(IPADD(ip->iJmpTrue.op1));
+        }
+        ip = NEXTINST(JmpTrue);
         DISPATCH;
       }
       CASE(JmpTrueLong) {
-        if (toBoolean(O2REG(JmpTrueLong)))
-          ip = IPADD(ip->iJmpTrueLong.op1);
-        else
-          ip = NEXTINST(JmpTrueLong);
+        if (toBoolean(O2REG(JmpTrueLong))) {
+          BRANCH(IPADD(ip->iJmpTrueLong.op1));
+        }
+        ip = NEXTINST(JmpTrueLong);
         DISPATCH;
       }
       CASE(JmpFalse) {
-        if (!toBoolean(O2REG(JmpFalse)))
-          ip = IPADD(ip->iJmpFalse.op1);
-        else
-          ip = NEXTINST(JmpFalse);
+        if (!toBoolean(O2REG(JmpFalse))) {
+          BRANCH(IPADD(ip->iJmpFalse.op1));
+        }
+        ip = NEXTINST(JmpFalse);
         DISPATCH;
       }
       CASE(JmpFalseLong) {
-        if (!toBoolean(O2REG(JmpFalseLong)))
-          ip = IPADD(ip->iJmpFalseLong.op1);
-        else
-          ip = NEXTINST(JmpFalseLong);
+        if (!toBoolean(O2REG(JmpFalseLong))) {
+          BRANCH(IPADD(ip->iJmpFalseLong.op1));
+        }
+        ip = NEXTINST(JmpFalseLong);
         DISPATCH;
       }
       CASE(JmpUndefined) {
-        if (O2REG(JmpUndefined).isUndefined())
-          ip = IPADD(ip->iJmpUndefined.op1);
-        else
-          ip = NEXTINST(JmpUndefined);
+        if (O2REG(JmpUndefined).isUndefined()) {
+          BRANCH(IPADD(ip->iJmpUndefined.op1));
+        }
+        ip = NEXTINST(JmpUndefined);
         DISPATCH;
       }
       CASE(JmpUndefinedLong) {
-        if (O2REG(JmpUndefinedLong).isUndefined())
-          ip = IPADD(ip->iJmpUndefinedLong.op1);
-        else
-          ip = NEXTINST(JmpUndefinedLong);
+        if (O2REG(JmpUndefinedLong).isUndefined()) {
+          BRANCH(IPADD(ip->iJmpUndefinedLong.op1));
+        }
+        ip = NEXTINST(JmpUndefinedLong);
         DISPATCH;
       }
       CASE(Add) {
@@ -2649,6 +3241,7 @@ tailCall:
             DISPATCH;
           }
         }
+        curCodeBlock->recordNonNumberArith(ip);
         runtime->storeCallerIP(ip);
         res = addOp_RJS(runtime, Handle<>(&O2REG(Add)), Handle<>(&O3REG(Add)));
         runtime->clearCallerIP();
@@ -2795,7 +3388,8 @@ tailCall:
             curCodeBlock,
             ip->iNewObjectWithBuffer.op3,
             ip->iNewObjectWithBuffer.op4,
-            ip->iNewObjectWithBuffer.op5);
+            ip->iNewObjectWithBuffer.op5,
+            allocationSiteFor(runtime, curCodeBlock, ip));
         if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
@@ -2811,7 +3405,8 @@ tailCall:
             curCodeBlock,
             ip->iNewObjectWithBufferLong.op3,
             ip->iNewObjectWithBufferLong.op4,
-            ip->iNewObjectWithBufferLong.op5);
+            ip->iNewObjectWithBufferLong.op5,
+            allocationSiteFor(runtime, curCodeBlock, ip));
         if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
@@ -2842,7 +3437,8 @@ tailCall:
             curCodeBlock,
             ip->iNewArrayWithBuffer.op2,
             ip->iNewArrayWithBuffer.op3,
-            ip->iNewArrayWithBuffer.op4);
+            ip->iNewArrayWithBuffer.op4,
+            allocationSiteFor(runtime, curCodeBlock, ip));
         if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
@@ -2859,7 +3455,8 @@ tailCall:
             curCodeBlock,
             ip->iNewArrayWithBufferLong.op2,
             ip->iNewArrayWithBufferLong.op3,
-            ip->iNewArrayWithBufferLong.op4);
+            ip->iNewArrayWithBufferLong.op4,
+            allocationSiteFor(runtime, curCodeBlock, ip));
         if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
@@ -3192,13 +3789,43 @@ tailCall:
             const uint32_t *loc =
                 (const uint32_t *)tablestart + uintVal - ip->iSwitchImm.op4;
 
-            ip = IPADD(*loc);
-            DISPATCH;
+            BRANCH(IPADD(*loc));
           }
         }
         // Wrong type or out of range, jump to default.
-        ip = IPADD(ip->iSwitchImm.op3);
-        DISPATCH;
+        BRANCH(IPADD(ip->iSwitchImm.op3));
+      }
+      CASE(SwitchStr) {
+        uint32_t slot = Interpreter::switchHashSlot(
+            runtime,
+            curCodeBlock->getRuntimeModule(),
+            &O1REG(SwitchStr),
+            ip);
+        if (LLVM_LIKELY(slot < ip->iSwitchStr.op4)) {
+          // The jump offsets follow the keys of the table.
+          const uint32_t *offsets =
+              (const uint32_t *)llvm::alignAddr(
+                  (const uint8_t *)ip + ip->iSwitchStr.op2, sizeof(uint32_t)) +
+              ip->iSwitchStr.op4;
+          BRANCH(IPADD((int32_t)offsets[slot]));
+        }
+        BRANCH(IPADD(ip->iSwitchStr.op3));
+      }
+      CASE(SwitchSparse) {
+        uint32_t slot = Interpreter::switchHashSlot(
+            runtime,
+            curCodeBlock->getRuntimeModule(),
+            &O1REG(SwitchSparse),
+            ip);
+        if (LLVM_LIKELY(slot < ip->iSwitchSparse.op4)) {
+          const uint32_t *offsets =
+              (const uint32_t *)llvm::alignAddr(
+                  (const uint8_t *)ip + ip->iSwitchSparse.op2,
+                  sizeof(uint32_t)) +
+              ip->iSwitchSparse.op4;
+          BRANCH(IPADD((int32_t)offsets[slot]));
+        }
+        BRANCH(IPADD(ip->iSwitchSparse.op3));
       }
       LOAD_CONST(
           LoadConstUInt8,
@@ -3240,6 +3867,63 @@ tailCall:
       CONDOP(LessEq, <=, lessEqualOp_RJS);
       CONDOP(Greater, >, greaterOp_RJS);
       CONDOP(GreaterEq, >=, greaterEqualOp_RJS);
+      MATHOP1(MathAbs, std::fabs);
+      MATHOP1(MathCeil, std::ceil);
+      MATHOP1(MathFloor, std::floor);
+      MATHOP1(MathSqrt, std::sqrt);
+      MATHOP2(MathMin, hermes::minOp);
+      MATHOP2(MathMax, hermes::maxOp);
+
+      CASE(DataViewGet) {
+        uint8_t type = ip->iDataViewGet.op6;
+        if (auto fastRes = dataViewGetFast(
+                runtime,
+                O2REG(DataViewGet),
+                O3REG(DataViewGet),
+                O4REG(DataViewGet),
+                O5REG(DataViewGet),
+                type)) {
+          ++NumDataViewFastPaths;
+          O1REG(DataViewGet) = *fastRes;
+          ip = NEXTINST(DataViewGet);
+          DISPATCH;
+        }
+        runtime->storeCallerIP(ip);
+        auto status = caseDataViewGet(runtime, frameRegs, ip);
+        runtime->clearCallerIP();
+        if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+          goto exception;
+        }
+        gcScope.flushToSmallCount(KEEP_HANDLES);
+        ip = NEXTINST(DataViewGet);
+        DISPATCH;
+      }
+
+      CASE(DataViewSet) {
+        uint8_t type = ip->iDataViewSet.op6;
+        if (dataViewSetFast(
+                runtime,
+                O1REG(DataViewSet),
+                O2REG(DataViewSet),
+                O3REG(DataViewSet),
+                O4REG(DataViewSet),
+                O5REG(DataViewSet),
+                type)) {
+          ++NumDataViewFastPaths;
+          ip = NEXTINST(DataViewSet);
+          DISPATCH;
+        }
+        runtime->storeCallerIP(ip);
+        auto status = caseDataViewSet(runtime, frameRegs, ip);
+        runtime->clearCallerIP();
+        if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+          goto exception;
+        }
+        gcScope.flushToSmallCount(KEEP_HANDLES);
+        ip = NEXTINST(DataViewSet);
+        DISPATCH;
+      }
+
       JCOND(Less, <, lessOp_RJS);
       JCOND(LessEqual, <=, lessEqualOp_RJS);
       JCOND(Greater, >, greaterOp_RJS);
@@ -3285,6 +3969,42 @@ tailCall:
 
     llvm_unreachable("unreachable");
 
+#ifdef HERMESVM_JIT
+  // We arrive here after a backward branch to the loop header at ip.
+  loopBackEdge:
+    // Entering native code again from a resumed frame would nest another
+    // native frame at every iteration of a loop that keeps leaving it.
+    if (!SingleStep && FRAME.ptr() != resumeFrame) {
+      if (auto jitPtr =
+              runtime->jitContext_.compileLoop(runtime, curCodeBlock, ip)) {
+        res = (*jitPtr)(runtime);
+        if (LLVM_LIKELY(res != ExecutionStatus::EXCEPTION))
+          goto returnFromFunction;
+        // The native code has already looked for a handler in this function.
+        PROFILER_EXIT_FUNCTION(curCodeBlock);
+        if (Instrumented)
+          runtime->functionProfilerExit(FRAME.ptr());
+        goto handleExceptionInParent;
+      }
+    }
+    DISPATCH;
+#endif
+
+  // We arrive here in the uninstrumented loop when the debugger has to run at
+  // ip, or when a call or return finds the function profiler enabled. Hand
+  // the frames of this loop over to the instrumented loop, which runs them
+  // from ip on, and so can step out of them and report their callees.
+  runInstrumented:
+    if (!Instrumented) {
+      InterpreterState resumeState{curCodeBlock, (uint32_t)CUROFFSET};
+      // The instrumented loop enters the current frame again. This loop never
+      // told the function profiler about it.
+      PROFILER_EXIT_FUNCTION(curCodeBlock);
+      return interpretFunction<false, true>(
+          runtime, resumeState, true, resumeFrame);
+    }
+    llvm_unreachable("the instrumented loop never hands its frames over");
+
   // We arrive here if we couldn't allocate the registers for the current frame.
   stackOverflow:
     runtime->raiseStackOverflow(Runtime::StackOverflowKind::JSRegisterStack);
@@ -3292,6 +4012,11 @@ tailCall:
   // We arrive here when we raised an exception in a callee, but we don't want
   // the callee to be able to handle it.
   handleExceptionInParent:
+#ifdef HERMESVM_JIT
+    if (LLVM_UNLIKELY(FRAME.ptr() == resumeFrame))
+      return ExecutionStatus::EXCEPTION;
+#endif
+
     // Restore the caller code block and IP.
     curCodeBlock = FRAME.getSavedCodeBlock();
     ip = FRAME.getSavedIP();
@@ -3383,6 +4108,13 @@ tailCall:
             -1) ||
            !catchable) {
       PROFILER_EXIT_FUNCTION(curCodeBlock);
+      if (Instrumented)
+        runtime->functionProfilerExit(FRAME.ptr());
+
+#ifdef HERMESVM_JIT
+      if (LLVM_UNLIKELY(FRAME.ptr() == resumeFrame))
+        return ExecutionStatus::EXCEPTION;
+#endif
 
       // Restore the code block and IP.
       curCodeBlock = FRAME.getSavedCodeBlock();
@@ -3417,6 +4149,11 @@ tailCall:
     INIT_STATE_FOR_CODEBLOCK(curCodeBlock);
 
     ip = IPADD(handlerOffset - CUROFFSET);
+#ifdef HERMES_ENABLE_DEBUGGER
+    // The debugger may have paused on the exception, and be stepping.
+    if (!Instrumented && runtime->debugger_.isActive())
+      goto runInstrumented;
+#endif
   }
 }
 
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/CodeBudget.h"
+
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/StackFrame-inline.h"
+
+#include "llvm/ADT/DenseSet.h"
+
+namespace hermes {
+namespace vm {
+
+void CodeBudget::add(CodeBlock *codeBlock, const JITCompiledCode &code) {
+  // New code goes right behind the hand, so it is swept last, and counts as
+  // used so that it survives the first sweep.
+  entries_.insert(hand_, Entry{codeBlock, code.blocks, code.size});
+  codeBlock->markJITUsed();
+  bytesUsed_ += code.size;
+}
+
+void CodeBudget::evict(Runtime *runtime, FreeFunction free) {
+  llvm::DenseSet<const CodeBlock *> onStack;
+  for (StackFramePtr frame : runtime->getStackFrames()) {
+    if (const CodeBlock *codeBlock = frame.getCalleeCodeBlock())
+      onStack.insert(codeBlock);
+  }
+
+  // Two sweeps: the first one may only clear the marks.
+  for (size_t visits = entries_.size() * 2; visits && isOverBudget();
+       --visits) {
+    if (hand_ == entries_.end())
+      hand_ = entries_.begin();
+    CodeBlock *codeBlock = hand_->codeBlock;
+    if (codeBlock->testAndClearJITUsed() || onStack.count(codeBlock)) {
+      ++hand_;
+      continue;
+    }
+    codeBlock->clearJITCompiled();
+    ++numEvicted_;
+    hand_ = release(hand_, free);
+  }
+}
+
+void CodeBudget::remove(RuntimeModule *runtimeModule, FreeFunction free) {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->codeBlock->getRuntimeModule() != runtimeModule) {
+      ++it;
+      continue;
+    }
+    bool atHand = it == hand_;
+    it = release(it, free);
+    if (atHand)
+      hand_ = it;
+  }
+}
+
+CodeBudget::EntryList::iterator CodeBudget::release(
+    EntryList::iterator it,
+    FreeFunction free) {
+  free(it->blocks);
+  bytesUsed_ -= it->size;
+  bytesFreed_ += it->size;
+  return entries_.erase(it);
+}
+
+} // namespace vm
+} // namespace hermes
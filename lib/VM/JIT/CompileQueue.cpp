@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/CompileQueue.h"
+
+#include "hermes/Inst/InstDecode.h"
+#include "hermes/VM/RuntimeModule.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+using hermes::inst::Inst;
+using hermes::inst::OpCode;
+
+void JITCompiledCode::install(CodeBlock *codeBlock) const {
+  if (!body) {
+    codeBlock->setDontJIT(true);
+    return;
+  }
+  for (const auto &entry : loopEntries)
+    codeBlock->setJITLoopEntry(entry.first, entry.second);
+  codeBlock->setJITCompiled(body);
+}
+
+/// Create the CodeBlocks that \p codeBlock calls directly or creates closures
+/// for, whose addresses are embedded in the compiled code.
+static void materializeReferencedCodeBlocks(CodeBlock *codeBlock) {
+  RuntimeModule *runtimeModule = codeBlock->getRuntimeModule();
+  for (auto *ip = codeBlock->begin(), *end = codeBlock->end(); ip != end;) {
+    auto *inst = reinterpret_cast<const Inst *>(ip);
+    switch (inst->opCode) {
+#define CASE_FUNCTION_INDEX(name)                               \
+  case OpCode::name:                                            \
+    runtimeModule->getCodeBlockMayAllocate(inst->i##name.op3); \
+    break;
+      CASE_FUNCTION_INDEX(CallDirect)
+      CASE_FUNCTION_INDEX(CallDirectLongIndex)
+      CASE_FUNCTION_INDEX(CreateClosure)
+      CASE_FUNCTION_INDEX(CreateClosureLongIndex)
+      CASE_FUNCTION_INDEX(CreateGeneratorClosure)
+      CASE_FUNCTION_INDEX(CreateGeneratorClosureLongIndex)
+      CASE_FUNCTION_INDEX(CreateGenerator)
+      CASE_FUNCTION_INDEX(CreateGeneratorLongIndex)
+#undef CASE_FUNCTION_INDEX
+      default:
+        break;
+    }
+    ip += decodeInstruction(inst).meta.size;
+  }
+}
+
+CompileQueue::CompileQueue(CompileFunction compile, ReleaseFunction release)
+    : compile_(std::move(compile)), release_(std::move(release)) {}
+
+CompileQueue::~CompileQueue() {
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    shouldExit_ = true;
+    pending_.clear();
+  }
+  workAvailable_.notify_one();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+  for (const auto &blocks : released_)
+    release_(blocks);
+}
+
+void CompileQueue::enqueue(CodeBlock *codeBlock) {
+  if (!queued_.insert(codeBlock).second)
+    return;
+  materializeReferencedCodeBlocks(codeBlock);
+  codeBlock->ensurePropertyCache();
+  codeBlock->freezeTypeFeedback();
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    pending_.push_back(codeBlock);
+    if (!worker_.joinable()) {
+      worker_ = std::thread(&CompileQueue::workerLoop, this);
+    }
+  }
+  workAvailable_.notify_one();
+}
+
+void CompileQueue::installFinishedSlowPath(InstallFunction install) {
+  std::vector<std::pair<CodeBlock *, JITCompiledCode>> finished;
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    finished.swap(finished_);
+    hasFinished_.store(false, std::memory_order_relaxed);
+  }
+  for (const auto &compiled : finished) {
+    install(compiled.first, compiled.second);
+    queued_.erase(compiled.first);
+  }
+}
+
+void CompileQueue::cancel(RuntimeModule *runtimeModule) {
+  using Compiled = std::pair<CodeBlock *, JITCompiledCode>;
+  auto isOwned = [runtimeModule](CodeBlock *codeBlock) {
+    return codeBlock->getRuntimeModule() == runtimeModule;
+  };
+  {
+    std::unique_lock<std::mutex> lk(mtx_);
+    compiled_.wait(lk, [this, &isOwned]() {
+      return !running_ || !isOwned(running_);
+    });
+    pending_.erase(
+        std::remove_if(pending_.begin(), pending_.end(), isOwned),
+        pending_.end());
+    auto firstOwned = std::stable_partition(
+        finished_.begin(),
+        finished_.end(),
+        [&isOwned](const Compiled &compiled) {
+          return !isOwned(compiled.first);
+        });
+    for (auto it = firstOwned; it != finished_.end(); ++it) {
+      if (it->second.body)
+        released_.push_back(it->second.blocks);
+    }
+    finished_.erase(firstOwned, finished_.end());
+    hasFinished_.store(!finished_.empty(), std::memory_order_relaxed);
+  }
+  workAvailable_.notify_one();
+
+  std::vector<CodeBlock *> owned;
+  for (CodeBlock *codeBlock : queued_) {
+    if (isOwned(codeBlock))
+      owned.push_back(codeBlock);
+  }
+  for (CodeBlock *codeBlock : owned)
+    queued_.erase(codeBlock);
+}
+
+void CompileQueue::releaseLater(ExecHeap::BlockPair blocks) {
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    released_.push_back(blocks);
+    if (!worker_.joinable()) {
+      worker_ = std::thread(&CompileQueue::workerLoop, this);
+    }
+  }
+  workAvailable_.notify_one();
+}
+
+void CompileQueue::waitUntilIdle() {
+  std::unique_lock<std::mutex> lk(mtx_);
+  compiled_.wait(lk, [this]() { return pending_.empty() && !running_; });
+}
+
+void CompileQueue::workerLoop() {
+  std::unique_lock<std::mutex> lk(mtx_);
+  while (true) {
+    workAvailable_.wait(lk, [this]() {
+      return shouldExit_ || !pending_.empty() || !released_.empty();
+    });
+    if (shouldExit_) {
+      return;
+    }
+    if (!released_.empty()) {
+      std::vector<ExecHeap::BlockPair> released;
+      released.swap(released_);
+      lk.unlock();
+      for (const auto &blocks : released)
+        release_(blocks);
+      lk.lock();
+      continue;
+    }
+    running_ = pending_.front();
+    pending_.pop_front();
+    lk.unlock();
+    JITCompiledCode code = compile_(running_);
+    lk.lock();
+    finished_.emplace_back(running_, std::move(code));
+    running_ = nullptr;
+    hasFinished_.store(true, std::memory_order_release);
+    compiled_.notify_all();
+  }
+}
+
+} // namespace vm
+} // namespace hermes
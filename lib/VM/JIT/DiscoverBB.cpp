@@ -23,15 +23,24 @@ using hermes::inst::OperandType;
 void discoverBasicBlocks(
     CodeBlock *codeBlock,
     std::vector<uint32_t> &basicBlocks,
-    llvm::DenseMap<uint32_t, unsigned> &labels) {
+    llvm::DenseMap<uint32_t, unsigned> &labels,
+    std::vector<unsigned> &loopHeaders) {
   auto const begin = codeBlock->begin();
   auto const end = codeBlock->end();
 
   llvm::DenseSet<uint32_t> labelSet{};
+  llvm::DenseSet<uint32_t> loopHeaderSet{};
 
   auto addLabel = [begin, &labelSet](const uint8_t *label) {
     labelSet.insert((uint32_t)(label - begin));
   };
+  // Branches that don't go forward close a loop starting at their destination.
+  auto addBranch = [begin, &addLabel, &loopHeaderSet](
+                       const uint8_t *from, int32_t offset) {
+    addLabel(from + offset);
+    if (offset <= 0)
+      loopHeaderSet.insert((uint32_t)(from + offset - begin));
+  };
 
   auto ip = begin;
   // Add the start of the bytecode.
@@ -40,10 +49,35 @@ void discoverBasicBlocks(
   while (ip != end) {
     auto decoded = decodeInstruction((const Inst *)ip);
     bool branch = false;
-    // FIXME: implement SwitchImm.
-    assert(
-        decoded.meta.opCode != OpCode::SwitchImm &&
-        "SwitchImm not implemented yet");
+    if (decoded.meta.opCode == OpCode::SwitchImm) {
+      // Every entry of the jump table is a branch destination. The default
+      // destination is an ordinary Addr32 operand, handled below.
+      auto *inst = (const Inst *)ip;
+      const uint32_t *table = (const uint32_t *)llvm::alignAddr(
+          ip + inst->iSwitchImm.op2, sizeof(uint32_t));
+      for (uint32_t i = 0, e = inst->iSwitchImm.op5 - inst->iSwitchImm.op4;
+           i <= e;
+           ++i) {
+        addBranch(ip, (int32_t)table[i]);
+      }
+    }
+    if (decoded.meta.opCode == OpCode::SwitchStr ||
+        decoded.meta.opCode == OpCode::SwitchSparse) {
+      // The jump offsets of a hashed table follow its keys. Empty slots jump
+      // to the default destination, which is harmless to add again.
+      auto *inst = (const Inst *)ip;
+      bool strings = decoded.meta.opCode == OpCode::SwitchStr;
+      uint32_t tableOffset =
+          strings ? inst->iSwitchStr.op2 : inst->iSwitchSparse.op2;
+      uint32_t numSlots =
+          strings ? inst->iSwitchStr.op4 : inst->iSwitchSparse.op4;
+      const uint32_t *offsets =
+          (const uint32_t *)llvm::alignAddr(
+              ip + tableOffset, sizeof(uint32_t)) +
+          numSlots;
+      for (uint32_t i = 0; i < numSlots; ++i)
+        addBranch(ip, (int32_t)offsets[i]);
+    }
     if (decoded.meta.opCode == OpCode::Catch) {
       addLabel(ip);
       ip += decoded.meta.size;
@@ -55,7 +89,7 @@ void discoverBasicBlocks(
           decoded.meta.operandType[i] == OperandType::Addr32) {
         offset = decoded.operandValue[i].integer;
         // Add the branch destination as a label.
-        addLabel(ip + offset);
+        addBranch(ip, offset);
         branch = true;
       }
     }
@@ -82,6 +116,12 @@ void discoverBasicBlocks(
     labels.try_emplace(basicBlocks[i], i);
     LLVM_DEBUG(llvm::dbgs() << "  BB" << i << " at " << basicBlocks[i] << "\n");
   }
+
+  loopHeaders.clear();
+  loopHeaders.reserve(loopHeaderSet.size());
+  for (uint32_t offset : loopHeaderSet)
+    loopHeaders.push_back(labels[offset]);
+  std::sort(loopHeaders.begin(), loopHeaders.end());
 }
 
 } // namespace vm
@@ -7,13 +7,41 @@
 
 #include "hermes/VM/JIT/ExecHeap.h"
 
+#include "hermes/Support/OSCompat.h"
+
 #include "llvm/Support/raw_ostream.h"
 
 #include <cassert>
 
+#ifdef HERMESVM_JIT_MAP_JIT
+#include <pthread.h>
+#include <sys/mman.h>
+#endif
+
 namespace hermes {
 namespace vm {
 
+#ifndef HERMESVM_JIT_MAP_JIT
+namespace {
+
+/// Set the protection of all pages overlapping [addr, addr + size) to the
+/// llvm::sys::Memory flags \p flags.
+/// \return false on failure.
+bool protectPages(uint8_t *addr, size_t size, unsigned flags) {
+  if (!addr || !size)
+    return true;
+  const uintptr_t pageSize = oscompat::page_size();
+  uintptr_t start = reinterpret_cast<uintptr_t>(addr) & ~(pageSize - 1);
+  uintptr_t end = (reinterpret_cast<uintptr_t>(addr) + size + pageSize - 1) &
+      ~(pageSize - 1);
+  return !llvm::sys::Memory::protectMappedMemory(
+      llvm::sys::MemoryBlock(reinterpret_cast<void *>(start), end - start),
+      flags);
+}
+
+} // anonymous namespace
+#endif
+
 ExecHeap::ExecHeap(
     size_t firstHeapSize,
     size_t secondHeapSize,
@@ -30,13 +58,29 @@ ExecHeap::DualPool *ExecHeap::addPool() {
     return nullptr;
 
   // Allocate a new one.
+#ifdef HERMESVM_JIT_MAP_JIT
+  // The pages are both writable and executable, but each thread only sees one
+  // of the two at a time, see unprotect() and publish().
+  const size_t size = firstHeapSize_ + secondHeapSize_;
+  void *mem = mmap(
+      nullptr,
+      size,
+      PROT_READ | PROT_WRITE | PROT_EXEC,
+      MAP_PRIVATE | MAP_ANON | MAP_JIT,
+      -1,
+      0);
+  if (mem == MAP_FAILED)
+    return nullptr;
+  llvm::sys::OwningMemoryBlock mb{llvm::sys::MemoryBlock(mem, size)};
+#else
+  // New pools are writable; code becomes executable when it is published.
   std::error_code EC;
-  const unsigned kRWX = llvm::sys::Memory::MF_READ |
-      llvm::sys::Memory::MF_WRITE | llvm::sys::Memory::MF_EXEC;
+  const unsigned kRW = llvm::sys::Memory::MF_READ | llvm::sys::Memory::MF_WRITE;
   llvm::sys::OwningMemoryBlock mb{llvm::sys::Memory::allocateMappedMemory(
-      firstHeapSize_ + secondHeapSize_, nullptr, kRWX, EC)};
+      firstHeapSize_ + secondHeapSize_, nullptr, kRW, EC)};
   if (!mb.base())
     return nullptr;
+#endif
 
   pools_.emplace_back(std::move(mb), firstHeapSize_, secondHeapSize_);
   return &pools_.back();
@@ -80,6 +124,33 @@ void ExecHeap::freeRemaining(BlockPair blocks, SizePair keepSizes) {
     pools_.erase(pool);
 }
 
+bool ExecHeap::unprotect(BlockPair blocks, SizePair sizes) {
+#ifdef HERMESVM_JIT_MAP_JIT
+  pthread_jit_write_protect_np(0);
+  return true;
+#else
+  const unsigned kRW = llvm::sys::Memory::MF_READ | llvm::sys::Memory::MF_WRITE;
+  return protectPages(blocks.first, sizes.first, kRW) &&
+      protectPages(blocks.second, sizes.second, kRW);
+#endif
+}
+
+bool ExecHeap::publish(BlockPair blocks, SizePair sizes) {
+#ifdef HERMESVM_JIT_MAP_JIT
+  pthread_jit_write_protect_np(1);
+#else
+  const unsigned kRX = llvm::sys::Memory::MF_READ | llvm::sys::Memory::MF_EXEC;
+  if (!protectPages(blocks.first, sizes.first, kRX) ||
+      !protectPages(blocks.second, sizes.second, kRX))
+    return false;
+#endif
+  if (blocks.first)
+    invalidateInstructionCache(blocks.first, sizes.first);
+  if (blocks.second)
+    invalidateInstructionCache(blocks.second, sizes.second);
+  return true;
+}
+
 ExecHeap::PoolList::iterator ExecHeap::findPool(BlockPair blocks) {
   assert((blocks.first || blocks.second) && "at least one block must be valid");
 
@@ -7,6 +7,7 @@
 
 #include "ExternalCalls.h"
 
+#include "hermes/Support/Math.h"
 #include "hermes/VM/JSArray.h"
 #include "hermes/VM/JSObject.h"
 #include "hermes/VM/JSRegExp.h"
@@ -112,10 +113,20 @@ ExecutionStatus externPutById(
     // If we have a cache hit, reuse the cached offset and immediately
     // return the property.
     if (LLVM_LIKELY(cacheEntry->clazz == clazzGCPtr.getStorageType())) {
+      ++cacheEntry->hits;
       JSObject::setNamedSlotValue<PropStorage::Inline::Yes>(
           obj, runtime, cacheEntry->slot, *prop);
       return ExecutionStatus::RETURNED;
     }
+    SlotIndex cachedSlot;
+    if (LLVM_LIKELY(cacheEntry->findPolymorphic(
+            clazzGCPtr.getStorageType(), cachedSlot))) {
+      ++cacheEntry->hits;
+      JSObject::setNamedSlotValue<PropStorage::Inline::Yes>(
+          obj, runtime, cachedSlot, *prop);
+      return ExecutionStatus::RETURNED;
+    }
+    ++cacheEntry->misses;
     auto *clazz = clazzGCPtr.getNonNull(runtime);
     auto id = SymbolID::unsafeCreate(sid);
     NamedPropertyDescriptor desc;
@@ -128,8 +139,7 @@ ExecutionStatus externPutById(
       if (LLVM_LIKELY(!clazz->isDictionary()) &&
           LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
         // Cache the class and property slot.
-        cacheEntry->clazz = clazzGCPtr.getStorageType();
-        cacheEntry->slot = desc.slot;
+        cacheEntry->update(clazzGCPtr.getStorageType(), desc.slot);
       }
 
       JSObject::setNamedSlotValue(obj, runtime, desc.slot, *prop);
@@ -170,9 +180,30 @@ CallResult<HermesValue> externGetById(
     // If we have a cache hit, reuse the cached offset and immediately
     // return the property.
     if (LLVM_LIKELY(cacheEntry->clazz == clazzGCPtr.getStorageType())) {
+      ++cacheEntry->hits;
       return JSObject::getNamedSlotValue<PropStorage::Inline::Yes>(
           obj, runtime, cacheEntry->slot);
     }
+    if (cacheEntry->globalEpoch == runtime->getGlobalPropertyEpoch() &&
+        LLVM_LIKELY(runtime->isGlobal(obj))) {
+      ++cacheEntry->hits;
+      return JSObject::getNamedSlotValue(
+          obj, runtime, cacheEntry->globalSlot);
+    }
+    SlotIndex cachedSlot;
+    if (LLVM_LIKELY(cacheEntry->findPolymorphic(
+            clazzGCPtr.getStorageType(), cachedSlot))) {
+      ++cacheEntry->hits;
+      return JSObject::getNamedSlotValue<PropStorage::Inline::Yes>(
+          obj, runtime, cachedSlot);
+    }
+    if (JSObject *holder =
+            JSObject::getCachedPrototypeHolder(obj, runtime, *cacheEntry)) {
+      ++cacheEntry->hits;
+      return JSObject::getNamedSlotValue(
+          holder, runtime, cacheEntry->protoSlot);
+    }
+    ++cacheEntry->misses;
     auto id = SymbolID::unsafeCreate(sid);
     NamedPropertyDescriptor desc;
     OptValue<bool> fastPathResult =
@@ -180,36 +211,48 @@ CallResult<HermesValue> externGetById(
     auto *clazz = clazzGCPtr.getNonNull(runtime);
     if (LLVM_LIKELY(fastPathResult.hasValue() && fastPathResult.getValue()) &&
         !desc.flags.accessor) {
+      if (LLVM_UNLIKELY(clazz->isDictionary()) &&
+          clazz->noteDictionaryRead() &&
+          JSObject::tryLeaveDictionaryMode(
+              Handle<JSObject>::vmcast(target), runtime)) {
+        // Look the property up again, to cache the new class.
+        return externGetById(
+            runtime, opFlags, sid, target, cacheIdx, codeBlock);
+      }
+
       // cacheIdx == 0 indicates no caching so don't update the cache in
       // those cases.
       if (LLVM_LIKELY(!clazz->isDictionary()) &&
           LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
         // Cache the class, id and property slot.
-        cacheEntry->clazz = clazzGCPtr.getStorageType();
-        cacheEntry->slot = desc.slot;
+        cacheEntry->update(clazzGCPtr.getStorageType(), desc.slot);
+      }
+      if (LLVM_UNLIKELY(runtime->isGlobal(obj)) &&
+          LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
+        cacheEntry->globalEpoch = runtime->getGlobalPropertyEpoch();
+        cacheEntry->globalSlot = desc.slot;
       }
 
       return JSObject::getNamedSlotValue(obj, runtime, desc);
     }
 
-    // The cache may also be populated via the prototype of the object.
-    // This value is only reliable if the fast path was a definite
+    // A dictionary receiver is not checked by the prototype entry of the
+    // cache, which is only reliable if the fast path was a definite
     // not-found.
     if (fastPathResult.hasValue() && !fastPathResult.getValue()) {
-      JSObject *parent = obj->getParent(runtime);
-      // TODO: This isLazy check is because a lazy object is reported as
-      // having no properties and therefore cannot contain the property.
-      // This check does not belong here, it should be merged into
-      // tryGetOwnNamedDescriptorFast().
-      if (parent &&
-          cacheEntry->clazz == parent->getClassGCPtr().getStorageType() &&
-          LLVM_LIKELY(!obj->isLazy())) {
-        return JSObject::getNamedSlotValue(parent, runtime, cacheEntry->slot);
+      if (JSObject *holder = JSObject::getCachedPrototypeHolder(
+              obj, runtime, *cacheEntry, true)) {
+        return JSObject::getNamedSlotValue(
+            holder, runtime, cacheEntry->protoSlot);
       }
     }
 
     return JSObject::getNamed_RJS(
-        Handle<JSObject>::vmcast(target), runtime, id, opFlags);
+        Handle<JSObject>::vmcast(target),
+        runtime,
+        id,
+        opFlags,
+        cacheIdx != hbc::PROPERTY_CACHING_DISABLED ? cacheEntry : nullptr);
   } else {
     /* Slow path. */
     return Interpreter::getByIdTransient_RJS(
@@ -217,6 +260,21 @@ CallResult<HermesValue> externGetById(
   }
 }
 
+/// Call \p callable, for which the frame has been set up. Builtins and other
+/// native functions, as well as bound functions, are called directly, without
+/// going through their VTable, like the interpreter does.
+/// \param ip the ip of the call, recorded for bound functions.
+static CallResult<HermesValue> callCallable(
+    Runtime *runtime,
+    PinnedHermesValue *callable,
+    const Inst *ip) {
+  if (auto *native = dyn_vmcast<NativeFunction>(*callable))
+    return NativeFunction::_nativeCall(native, runtime);
+  if (auto *bound = dyn_vmcast<BoundFunction>(*callable))
+    return BoundFunction::_boundCall(bound, ip, runtime);
+  return Callable::call(Handle<Callable>::vmcast(callable), runtime);
+}
+
 CallResult<HermesValue> externCall(
     Runtime *runtime,
     PinnedHermesValue *callable,
@@ -244,7 +302,7 @@ CallResult<HermesValue> externCall(
       *callable,
       HermesValue::encodeUndefinedValue());
   runtime->storeCallerIP(ip);
-  auto res = Callable::call(Handle<Callable>::vmcast(callable), runtime);
+  auto res = callCallable(runtime, callable, ip);
   runtime->clearCallerIP();
   return res;
 }
@@ -276,7 +334,7 @@ CallResult<HermesValue> externConstruct(
       *callable,
       *callable);
   runtime->storeCallerIP(ip);
-  auto res = Callable::call(Handle<Callable>::vmcast(callable), runtime);
+  auto res = callCallable(runtime, callable, ip);
   runtime->clearCallerIP();
   return res;
 }
@@ -306,6 +364,49 @@ IMPLEMENT_BIN_OP(Sub, -);
 IMPLEMENT_BIN_OP(Mul, *);
 IMPLEMENT_BIN_OP(Div, /);
 
+/// Implement the slow path call of an instruction computing a Math method of
+/// one argument inline.
+/// \param name the name of the instruction.
+/// \param func the C++ function computing the method on a double.
+#define IMPLEMENT_MATH_OP1(name, func)                             \
+  CallResult<HermesValue> slowPath##name(                          \
+      Runtime *runtime, PinnedHermesValue *op) {                   \
+    GCScopeMarkerRAII marker{runtime};                             \
+    auto res = toNumber_RJS(runtime, Handle<>(op));                \
+    if (res == ExecutionStatus::EXCEPTION)                         \
+      return ExecutionStatus::EXCEPTION;                           \
+    return HermesValue::encodeDoubleValue(func(res->getDouble())); \
+  }
+
+/// Implement the slow path call of an instruction computing a Math method of
+/// two arguments inline.
+/// \param name the name of the instruction.
+/// \param func the C++ function computing the method on doubles.
+#define IMPLEMENT_MATH_OP2(name, func)                                    \
+  CallResult<HermesValue> slowPath##name(                                 \
+      Runtime *runtime, PinnedHermesValue *op1, PinnedHermesValue *op2) { \
+    GCScopeMarkerRAII marker{runtime};                                    \
+                                                                          \
+    CallResult<HermesValue> res{ExecutionStatus::EXCEPTION};              \
+    if ((res = toNumber_RJS(runtime, Handle<>(op1))) ==                   \
+        ExecutionStatus::EXCEPTION)                                       \
+      return ExecutionStatus::EXCEPTION;                                  \
+    double left = res->getDouble();                                       \
+                                                                          \
+    if ((res = toNumber_RJS(runtime, Handle<>(op2))) ==                   \
+        ExecutionStatus::EXCEPTION)                                       \
+      return ExecutionStatus::EXCEPTION;                                  \
+                                                                          \
+    return HermesValue::encodeDoubleValue(func(left, res->getDouble()));  \
+  }
+
+IMPLEMENT_MATH_OP1(MathAbs, std::fabs);
+IMPLEMENT_MATH_OP1(MathCeil, std::ceil);
+IMPLEMENT_MATH_OP1(MathFloor, std::floor);
+IMPLEMENT_MATH_OP1(MathSqrt, std::sqrt);
+IMPLEMENT_MATH_OP2(MathMin, hermes::minOp);
+IMPLEMENT_MATH_OP2(MathMax, hermes::maxOp);
+
 HermesValue externLoadConstStringMayAllocate(
     uint32_t stringID,
     RuntimeModule *runtimeModule) {
@@ -375,6 +476,12 @@ HermesValue externNewObject(Runtime *runtime) {
   return JSObject::create(runtime).getHermesValue();
 }
 
+HermesValue externInitNewObject(Runtime *runtime, void *mem) {
+  // The JIT bumped the allocation pointer itself, bypassing Runtime::alloc.
+  runtime->countAllocation(mem, heapAlignSize(cellSize<JSObject>()));
+  return JSObject::createInPlace(runtime, mem).getHermesValue();
+}
+
 CallResult<HermesValue> externCreateThis(
     Runtime *runtime,
     PinnedHermesValue *proto,
@@ -422,15 +529,18 @@ ExecutionStatus externPutNewOwnById(
     Runtime *runtime,
     PinnedHermesValue *target,
     PinnedHermesValue *prop,
-    uint32_t sid) {
+    uint32_t sid,
+    bool enumerable) {
   GCScopeMarkerRAII marker{runtime};
+  auto propFlags = enumerable ? PropertyFlags::defaultNewNamedPropertyFlags()
+                              : PropertyFlags::nonEnumerablePropertyFlags();
   if (LLVM_LIKELY((*target).isObject())) {
     if (LLVM_UNLIKELY(
             JSObject::defineNewOwnProperty(
                 Handle<JSObject>::vmcast(target),
                 runtime,
                 SymbolID::unsafeCreate(sid),
-                PropertyFlags::defaultNewNamedPropertyFlags(),
+                propFlags,
                 Handle<>(prop)) == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     };
@@ -447,7 +557,7 @@ ExecutionStatus externPutNewOwnById(
                 Handle<JSObject>::vmcast(&scratch),
                 runtime,
                 SymbolID::unsafeCreate(sid),
-                PropertyFlags::defaultNewNamedPropertyFlags(),
+                propFlags,
                 Handle<>(prop)) == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -473,6 +583,10 @@ CallResult<HermesValue> externGetByVal(
   GCScopeMarkerRAII marker{runtime};
 
   if (LLVM_LIKELY(target->isObject())) {
+    if (auto fastRes = Interpreter::getByValObjectFast(
+            runtime, vmcast<JSObject>(*target), *nameVal)) {
+      return *fastRes;
+    }
     return JSObject::getComputed_RJS(
         Handle<JSObject>::vmcast(target), runtime, Handle<>(nameVal));
   } else {
@@ -491,6 +605,10 @@ ExecutionStatus externPutByVal(
   GCScopeMarkerRAII marker{runtime};
 
   if (LLVM_LIKELY(target->isObject())) {
+    if (LLVM_LIKELY(Interpreter::putByValObjectFast(
+            runtime, vmcast<JSObject>(*target), *nameVal, *value))) {
+      return ExecutionStatus::RETURNED;
+    }
     return JSObject::putComputed_RJS(
                Handle<JSObject>::vmcast(target),
                runtime,
@@ -871,5 +989,200 @@ CallResult<HermesValue> externCreateRegExpMayAllocate(
   return re.getHermesValue();
 }
 
+CallResult<HermesValue> externCallDirect(
+    Runtime *runtime,
+    CodeBlock *calleeBlock,
+    uint32_t argCount,
+    PinnedHermesValue *stackPointer,
+    const Inst *ip,
+    PinnedHermesValue *previousFrame) {
+  GCScopeMarkerRAII marker{runtime};
+
+  StackFramePtr frame(previousFrame);
+  (void)StackFramePtr::initFrame(
+      stackPointer,
+      frame,
+      ip,
+      // See externCall for why there is no saved code block.
+      nullptr, /* SavedCodeBlock */
+      argCount - 1,
+      HermesValue::encodeNativePointer(calleeBlock),
+      HermesValue::encodeUndefinedValue());
+  calleeBlock->lazyCompile(runtime);
+  runtime->storeCallerIP(ip);
+  CallResult<HermesValue> res{ExecutionStatus::EXCEPTION};
+  if (auto *jitPtr = calleeBlock->getJITCompiled()) {
+    calleeBlock->markJITUsed();
+    res = (*jitPtr)(runtime);
+  } else {
+    res = runtime->interpretFunction(calleeBlock);
+  }
+  runtime->clearCallerIP();
+  return res;
+}
+
+CallResult<HermesValue> externCallBuiltin(
+    Runtime *runtime,
+    uint32_t builtinIndex,
+    uint32_t argCount,
+    PinnedHermesValue *stackPointer,
+    const Inst *ip,
+    PinnedHermesValue *previousFrame) {
+  GCScopeMarkerRAII marker{runtime};
+
+  NativeFunction *nf = runtime->getBuiltinNativeFunction(builtinIndex);
+  StackFramePtr frame(previousFrame);
+  auto newFrame = StackFramePtr::initFrame(
+      stackPointer, frame, ip, nullptr, argCount - 1, nf, false);
+  // "thisArg" is implicitly assumed to "undefined".
+  newFrame.getThisArgRef() = HermesValue::encodeUndefinedValue();
+  runtime->storeCallerIP(ip);
+  auto res = NativeFunction::_nativeCall(nf, runtime);
+  runtime->clearCallerIP();
+  return res;
+}
+
+CallResult<HermesValue> externStringConcat(
+    Runtime *runtime,
+    PinnedHermesValue *stackPointer,
+    uint32_t count) {
+  GCScopeMarkerRAII marker{runtime};
+  return stringConcat_RJS(
+      runtime, &stackPointer[StackFrameLayout::ThisArg], count);
+}
+
+CallResult<HermesValue> externToInt32(
+    Runtime *runtime,
+    PinnedHermesValue *src) {
+  GCScopeMarkerRAII marker{runtime};
+  return toInt32_RJS(runtime, Handle<>(src));
+}
+
+CallResult<HermesValue> externDelById(
+    Runtime *runtime,
+    PinnedHermesValue *target,
+    uint32_t sid,
+    PropOpFlags flags) {
+  GCScopeMarkerRAII marker{runtime};
+
+  auto id = SymbolID::unsafeCreate(sid);
+  if (LLVM_LIKELY(target->isObject())) {
+    auto res = JSObject::deleteNamed(
+        Handle<JSObject>::vmcast(target), runtime, id, flags);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    return HermesValue::encodeBoolValue(*res);
+  }
+  // This is the "slow path".
+  auto res = toObject(runtime, Handle<>(target));
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+    // Name the property in the message, as the interpreter does.
+    (void)amendPropAccessErrorMsgWithPropName(
+        runtime, Handle<>(target), "delete", id);
+    return ExecutionStatus::EXCEPTION;
+  }
+  PinnedHermesValue &scratch = runtime->getCurrentFrame().getScratchRef();
+  scratch = res.getValue();
+  auto delRes = JSObject::deleteNamed(
+      Handle<JSObject>::vmcast(&scratch), runtime, id, flags);
+  if (LLVM_UNLIKELY(delRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return HermesValue::encodeBoolValue(*delRes);
+}
+
+HermesValue externNewObjectWithParent(
+    Runtime *runtime,
+    PinnedHermesValue *parent) {
+  GCScopeMarkerRAII marker{runtime};
+  return JSObject::create(
+             runtime,
+             parent->isObject()
+                 ? Handle<JSObject>::vmcast(parent)
+                 : parent->isNull()
+                     ? Runtime::makeNullHandle<JSObject>()
+                     : Handle<JSObject>::vmcast(&runtime->objectPrototype))
+      .getHermesValue();
+}
+
+CallResult<HermesValue> externCreateGeneratorClosure(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    uint32_t funcIndex,
+    PinnedHermesValue *env) {
+  GCScopeMarkerRAII marker{runtime};
+  return Interpreter::createGeneratorClosure(
+      runtime, runtimeModule, funcIndex, Handle<Environment>::vmcast(env));
+}
+
+CallResult<HermesValue> externCreateGenerator(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    uint32_t funcIndex,
+    PinnedHermesValue *env,
+    PinnedHermesValue *currentFrame) {
+  GCScopeMarkerRAII marker{runtime};
+  return Interpreter::createGenerator_RJS(
+      runtime,
+      runtimeModule,
+      funcIndex,
+      Handle<Environment>::vmcast(env),
+      StackFramePtr(currentFrame).getNativeArgs());
+}
+
+ExecutionStatus externThrowUndefinedVariable(Runtime *runtime) {
+  return runtime->raiseReferenceError("accessing an uninitialized variable");
+}
+
+uint32_t
+externSwitchImmIndex(PinnedHermesValue *val, uint32_t min, uint32_t max) {
+  uint32_t defaultIndex = max - min + 1;
+  if (LLVM_UNLIKELY(!val->isNumber())) {
+    return defaultIndex;
+  }
+  double numVal = val->getNumber();
+  uint32_t uintVal = (uint32_t)numVal;
+  if (LLVM_LIKELY(numVal == uintVal) && uintVal >= min && uintVal <= max) {
+    return uintVal - min;
+  }
+  return defaultIndex;
+}
+
+uint32_t externSwitchHashSlot(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    PinnedHermesValue *val,
+    const Inst *ip) {
+  GCScopeMarkerRAII marker{runtime};
+  return Interpreter::switchHashSlot(runtime, runtimeModule, val, ip);
+}
+
+CallResult<HermesValue>
+externDeoptimize(Runtime *runtime, CodeBlock *codeBlock, uint32_t offset) {
+  GCScopeMarkerRAII marker{runtime};
+  return runtime->resumeFunction(codeBlock, offset);
+}
+
+void externFunctionProfilerEnter(
+    Runtime *runtime,
+    CodeBlock *codeBlock,
+    PinnedHermesValue *frame) {
+  runtime->functionProfilerEnter(codeBlock, frame);
+}
+
+void externFunctionProfilerExit(Runtime *runtime, PinnedHermesValue *frame) {
+  runtime->functionProfilerExit(frame);
+}
+
+#ifdef HERMESVM_PROFILER_BB
+void externProfilePoint(
+    Runtime *runtime,
+    CodeBlock *codeBlock,
+    uint32_t pointIndex) {
+  runtime->getBasicBlockExecutionInfo().executeBlock(codeBlock, pointIndex);
+}
+#endif
+
 } // namespace vm
 } // namespace hermes
@@ -131,6 +131,30 @@ slowPathMul(Runtime *runtime, PinnedHermesValue *op1, PinnedHermesValue *op2);
 CallResult<HermesValue>
 slowPathDiv(Runtime *runtime, PinnedHermesValue *op1, PinnedHermesValue *op2);
 
+/// Slow paths invoked by JIT compiled code to convert the operands of the
+/// Math instructions to number and compute the Math method. They also accept
+/// numbers, so they can be called in place of an inline expansion.
+CallResult<HermesValue> slowPathMathAbs(
+    Runtime *runtime,
+    PinnedHermesValue *op);
+CallResult<HermesValue> slowPathMathCeil(
+    Runtime *runtime,
+    PinnedHermesValue *op);
+CallResult<HermesValue> slowPathMathFloor(
+    Runtime *runtime,
+    PinnedHermesValue *op);
+CallResult<HermesValue> slowPathMathSqrt(
+    Runtime *runtime,
+    PinnedHermesValue *op);
+CallResult<HermesValue> slowPathMathMin(
+    Runtime *runtime,
+    PinnedHermesValue *op1,
+    PinnedHermesValue *op2);
+CallResult<HermesValue> slowPathMathMax(
+    Runtime *runtime,
+    PinnedHermesValue *op1,
+    PinnedHermesValue *op2);
+
 /// An external call invoked by JIT compiled code to load a constant string,
 /// which is allocated in the GC heap and cannot be pre-fetched at compile time.
 /// \param stringID the string table index of the constant string
@@ -176,6 +200,10 @@ CallResult<HermesValue> externAbstractEqualityTest(
 /// JSObject::create
 HermesValue externNewObject(Runtime *runtime);
 
+/// An external call invoked by JIT compiled code to call
+/// JSObject::createInPlace on memory it has already bump-allocated.
+HermesValue externInitNewObject(Runtime *runtime, void *mem);
+
 /// An external call invoked by JIT compiled code to call
 /// Callable::newObject
 /// \param proto prototype of the object to be created
@@ -206,11 +234,13 @@ ExecutionStatus externPutOwnByIndex(
 /// \param target the target to put a property in.
 /// \param prop the property to be put.
 /// \param sid the SymbolID of the property which must already exist in the map.
+/// \param enumerable whether the new property is enumerable.
 ExecutionStatus externPutNewOwnById(
     Runtime *runtime,
     PinnedHermesValue *target,
     PinnedHermesValue *prop,
-    uint32_t sid);
+    uint32_t sid,
+    bool enumerable);
 
 /// An slow path invoked by JIT compiled code to coerce \p thisVal assumed to
 /// contain 'this' to an object
@@ -396,6 +426,141 @@ CallResult<HermesValue> externCreateRegExpMayAllocate(
     uint32_t bytecodeIdx,
     CodeBlock *codeBlock);
 
+/// An external call invoked by JIT compiled code to call the function
+/// \p calleeBlock directly, without a closure.
+/// \param argCount the count of arguments, including the "thisArg"
+/// \param stackPointer the runtime stack pointer
+/// \param ip the ip in the caller code block to be saved before the call
+/// \param previousFrame the previous frame to be saved before the call
+CallResult<HermesValue> externCallDirect(
+    Runtime *runtime,
+    CodeBlock *calleeBlock,
+    uint32_t argCount,
+    PinnedHermesValue *stackPointer,
+    const Inst *ip,
+    PinnedHermesValue *previousFrame);
+
+/// An external call invoked by JIT compiled code to call the builtin method
+/// \p builtinIndex, with an undefined "thisArg".
+/// \param argCount the count of arguments, including the "thisArg"
+/// \param stackPointer the runtime stack pointer
+/// \param ip the ip in the caller code block to be saved before the call
+/// \param previousFrame the previous frame to be saved before the call
+CallResult<HermesValue> externCallBuiltin(
+    Runtime *runtime,
+    uint32_t builtinIndex,
+    uint32_t argCount,
+    PinnedHermesValue *stackPointer,
+    const Inst *ip,
+    PinnedHermesValue *previousFrame);
+
+/// An external call invoked by JIT compiled code to concatenate the strings of
+/// \p count values, stored in the outgoing registers like call arguments.
+/// \param stackPointer the runtime stack pointer
+CallResult<HermesValue> externStringConcat(
+    Runtime *runtime,
+    PinnedHermesValue *stackPointer,
+    uint32_t count);
+
+/// An external call invoked by JIT compiled code to convert \p src to an
+/// int32 number.
+CallResult<HermesValue> externToInt32(
+    Runtime *runtime,
+    PinnedHermesValue *src);
+
+/// An external call invoked by JIT compiled code to delete a property by
+/// string index.
+/// \param target the object to delete the property from.
+/// \param sid the SymbolID of the property which must already exist in the
+///  string id map.
+/// \param flags property access flags
+CallResult<HermesValue> externDelById(
+    Runtime *runtime,
+    PinnedHermesValue *target,
+    uint32_t sid,
+    PropOpFlags flags);
+
+/// An external call invoked by JIT compiled code to create an object with the
+/// prototype \p parent, or Object.prototype if \p parent is neither an object
+/// nor null.
+HermesValue externNewObjectWithParent(
+    Runtime *runtime,
+    PinnedHermesValue *parent);
+
+/// An external call invoked by JIT compiled code to allocate a
+/// GeneratorFunction.
+/// \param runtimeModule the runtime module of the current code block.
+/// \param funcIndex the index of the function in the function table.
+/// \param env the environment of the closure to be created.
+CallResult<HermesValue> externCreateGeneratorClosure(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    uint32_t funcIndex,
+    PinnedHermesValue *env);
+
+/// An external call invoked by JIT compiled code to allocate a generator,
+/// passing it the arguments of the current frame.
+/// \param runtimeModule the runtime module of the current code block.
+/// \param funcIndex the index of the inner function in the function table.
+/// \param env the environment of the generator to be created.
+/// \param currentFrame the current frame on the stack
+CallResult<HermesValue> externCreateGenerator(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    uint32_t funcIndex,
+    PinnedHermesValue *env,
+    PinnedHermesValue *currentFrame);
+
+/// An external call invoked by JIT compiled code to raise the ReferenceError
+/// for reading a variable before its initialization.
+/// \return ExecutionStatus::EXCEPTION.
+ExecutionStatus externThrowUndefinedVariable(Runtime *runtime);
+
+/// An external call invoked by JIT compiled code to \return the index into the
+/// jump table of a SwitchImm for the value \p val, or one past the last entry
+/// if \p val is not an integer in [\p min, \p max] and the default target
+/// must be used.
+uint32_t
+externSwitchImmIndex(PinnedHermesValue *val, uint32_t min, uint32_t max);
+
+/// An external call invoked by JIT compiled code to \return the slot of the
+/// hashed jump table of the SwitchStr or SwitchSparse \p ip of a function of
+/// \p runtimeModule that matches \p val, or the number of slots if none does
+/// and the default target must be used.
+uint32_t externSwitchHashSlot(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    PinnedHermesValue *val,
+    const Inst *ip);
+
+/// An external call invoked by JIT compiled code to leave native code at the
+/// instruction at \p offset of \p codeBlock, which it cannot run, and run the
+/// rest of the function in the interpreter. The frame of the native code is
+/// the current frame, and its registers hold every live value.
+/// \return the result of the function, to be returned by the native code.
+CallResult<HermesValue>
+externDeoptimize(Runtime *runtime, CodeBlock *codeBlock, uint32_t offset);
+
+/// An external call invoked by JIT compiled code, while the function
+/// profiler is enabled, when \p codeBlock starts running in \p frame.
+void externFunctionProfilerEnter(
+    Runtime *runtime,
+    CodeBlock *codeBlock,
+    PinnedHermesValue *frame);
+
+/// An external call invoked by JIT compiled code, while the function
+/// profiler is enabled, when the function running in \p frame returns.
+void externFunctionProfilerExit(Runtime *runtime, PinnedHermesValue *frame);
+
+#ifdef HERMESVM_PROFILER_BB
+/// An external call invoked by JIT compiled code to record that the basic
+/// block with the profile point \p pointIndex of \p codeBlock was executed.
+void externProfilePoint(
+    Runtime *runtime,
+    CodeBlock *codeBlock,
+    uint32_t pointIndex);
+#endif
+
 } // namespace vm
 } // namespace hermes
 
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/JITPerfMap.h"
+
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/RuntimeModule.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Path.h"
+
+#include <map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+/// The definitions of the jitdump format, see
+/// tools/perf/Documentation/jitdump-specification.txt in the Linux sources.
+namespace jitdump {
+
+constexpr uint32_t kMagic = 0x4A695444;
+constexpr uint32_t kVersion = 1;
+
+#if defined(__x86_64__)
+constexpr uint32_t kELFMachine = 62; // EM_X86_64
+#elif defined(__aarch64__)
+constexpr uint32_t kELFMachine = 183; // EM_AARCH64
+#else
+constexpr uint32_t kELFMachine = 0; // EM_NONE
+#endif
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t totalSize;
+  uint32_t elfMach;
+  uint32_t pad1;
+  uint32_t pid;
+  uint64_t timestamp;
+  uint64_t flags;
+};
+
+enum RecordID : uint32_t {
+  JIT_CODE_LOAD = 0,
+  JIT_CODE_DEBUG_INFO = 2,
+};
+
+struct RecordHeader {
+  uint32_t id;
+  uint32_t totalSize;
+  uint64_t timestamp;
+};
+
+/// Followed by the null terminated name and the code.
+struct CodeLoad {
+  RecordHeader header;
+  uint32_t pid;
+  uint32_t tid;
+  uint64_t vma;
+  uint64_t codeAddr;
+  uint64_t codeSize;
+  uint64_t codeIndex;
+};
+
+/// Followed by \c numEntries DebugEntry.
+struct DebugInfo {
+  RecordHeader header;
+  uint64_t codeAddr;
+  uint64_t numEntries;
+};
+
+/// Followed by the null terminated file name.
+struct DebugEntry {
+  uint64_t codeAddr;
+  uint32_t line;
+  uint32_t discrim;
+};
+
+} // namespace jitdump
+
+/// \return the time in the clock of `perf record -k mono`.
+uint64_t timestamp() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+template <typename T>
+void writeStruct(llvm::raw_ostream &os, const T &value) {
+  os.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void writeString(llvm::raw_ostream &os, llvm::StringRef str) {
+  os << str;
+  os.write('\0');
+}
+
+} // namespace
+
+JITPerfMap::JITPerfMap(llvm::StringRef dir) {
+  auto pid = getpid();
+  llvm::SmallString<128> path{dir};
+  llvm::sys::path::append(path, "perf-" + llvm::Twine(pid) + ".map");
+  mapPath_ = path.str();
+  std::error_code ec;
+  map_.reset(new llvm::raw_fd_ostream(
+      mapPath_, ec, llvm::sys::fs::FileAccess::FA_Write));
+  if (ec)
+    map_.reset();
+
+  path = dir;
+  llvm::sys::path::append(path, "jit-" + llvm::Twine(pid) + ".dump");
+  dumpPath_ = path.str();
+  // perf finds the file through a mapping of it, which needs it to be
+  // readable.
+  int fd = open(dumpPath_.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+  if (fd < 0)
+    return;
+  dump_.reset(new llvm::raw_fd_ostream(fd, /* shouldClose */ true));
+  void *marker = mmap(
+      nullptr,
+      oscompat::page_size(),
+      PROT_READ | PROT_EXEC,
+      MAP_PRIVATE,
+      fd,
+      0);
+  if (marker != MAP_FAILED)
+    dumpMarker_ = marker;
+
+  jitdump::FileHeader header{};
+  header.magic = jitdump::kMagic;
+  header.version = jitdump::kVersion;
+  header.totalSize = sizeof(header);
+  header.elfMach = jitdump::kELFMachine;
+  header.pid = pid;
+  header.timestamp = timestamp();
+  writeStruct(*dump_, header);
+  dump_->flush();
+}
+
+JITPerfMap::~JITPerfMap() {
+  if (dumpMarker_)
+    munmap(dumpMarker_, oscompat::page_size());
+}
+
+void JITPerfMap::add(const CodeBlock *codeBlock, const JITCompiledCode &code) {
+  // Only lazy CodeBlocks need the runtime to get their name, and they are
+  // compiled to bytecode before they can be JIT'ed.
+  assert(!codeBlock->isLazy() && "lazy CodeBlocks can't be JIT'ed");
+  std::string name = codeBlock->getNameString(nullptr);
+  if (name.empty())
+    name = "<anonymous>";
+  name = "JS:" + name;
+  if (auto loc = codeBlock->getSourceLocation()) {
+    name += " " +
+        codeBlock->getRuntimeModule()
+            ->getBytecode()
+            ->getDebugInfo()
+            ->getFilenameByID(loc->filenameId) +
+        ":" + std::to_string(loc->line) + ":" + std::to_string(loc->column);
+  }
+
+  auto *fast = reinterpret_cast<const uint8_t *>(code.body);
+  if (dump_)
+    writeDebugInfo(codeBlock, fast, code);
+  addRange(name, fast, code.codeSizes.first);
+  addRange(name + " [slow path]", code.blocks.second, code.codeSizes.second);
+
+  if (map_)
+    map_->flush();
+  if (dump_)
+    dump_->flush();
+}
+
+void JITPerfMap::addRange(
+    const std::string &name,
+    const uint8_t *addr,
+    size_t size) {
+  if (!size)
+    return;
+  if (map_) {
+    *map_ << llvm::format_hex_no_prefix((uintptr_t)addr, 1) << " "
+          << llvm::format_hex_no_prefix(size, 1) << " " << name << "\n";
+  }
+  if (dump_)
+    writeCodeLoad(name, addr, size);
+}
+
+void JITPerfMap::writeCodeLoad(
+    const std::string &name,
+    const uint8_t *addr,
+    size_t size) {
+  jitdump::CodeLoad record{};
+  record.header.id = jitdump::JIT_CODE_LOAD;
+  record.header.totalSize = sizeof(record) + name.size() + 1 + size;
+  record.header.timestamp = timestamp();
+  record.pid = getpid();
+  record.tid = oscompat::thread_id();
+  record.vma = (uintptr_t)addr;
+  record.codeAddr = (uintptr_t)addr;
+  record.codeSize = size;
+  record.codeIndex = codeIndex_++;
+  writeStruct(*dump_, record);
+  writeString(*dump_, name);
+  dump_->write(reinterpret_cast<const char *>(addr), size);
+}
+
+void JITPerfMap::writeDebugInfo(
+    const CodeBlock *codeBlock,
+    const uint8_t *addr,
+    const JITCompiledCode &code) {
+  auto debugOffset = codeBlock->getDebugSourceLocationsOffset();
+  if (!debugOffset || code.lineTable.empty())
+    return;
+  auto *debugInfo =
+      codeBlock->getRuntimeModule()->getBytecode()->getDebugInfo();
+  auto locations = debugInfo->getLocationsForFunction(*debugOffset);
+  if (locations.empty())
+    return;
+
+  // Both tables are sorted by bytecode offset. Only the code where the source
+  // line changes gets an entry.
+  std::map<uint32_t, std::string> filenames;
+  std::vector<std::pair<jitdump::DebugEntry, const std::string *>> entries;
+  size_t entriesSize = 0;
+  auto loc = locations.begin();
+  for (const auto &native : code.lineTable) {
+    while (loc + 1 != locations.end() && (loc + 1)->address <= native.second)
+      ++loc;
+    auto &filename = filenames[loc->filenameId];
+    if (filename.empty())
+      filename = debugInfo->getFilenameByID(loc->filenameId);
+    if (!entries.empty() && entries.back().first.line == loc->line &&
+        entries.back().second == &filename)
+      continue;
+    entries.push_back(
+        {jitdump::DebugEntry{(uintptr_t)addr + native.first, loc->line, 0},
+         &filename});
+    entriesSize += sizeof(jitdump::DebugEntry) + filename.size() + 1;
+  }
+
+  jitdump::DebugInfo record{};
+  record.header.id = jitdump::JIT_CODE_DEBUG_INFO;
+  record.header.totalSize = sizeof(record) + entriesSize;
+  record.header.timestamp = timestamp();
+  record.codeAddr = (uintptr_t)addr;
+  record.numEntries = entries.size();
+  writeStruct(*dump_, record);
+  for (const auto &entry : entries) {
+    writeStruct(*dump_, entry.first);
+    writeString(*dump_, *entry.second);
+  }
+}
+
+} // namespace vm
+} // namespace hermes
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/JITProfileCache.h"
+
+#include "hermes/Support/SHA1.h"
+#include "hermes/VM/RuntimeModule.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+
+/// The first line of every profile. Bump the version when the meaning of the
+/// profile changes, so that stale profiles are ignored.
+static const char kProfileHeader[] = "hermes-jit-profile 1";
+
+std::string JITProfileCache::getPath(
+    const RuntimeModule *runtimeModule) const {
+  const hbc::BCProvider *bytecode = runtimeModule->getBytecode();
+  if (!bytecode)
+    return "";
+  SHA1 hash = bytecode->getSourceHash();
+  if (std::all_of(hash.begin(), hash.end(), [](uint8_t b) { return !b; }))
+    return "";
+  llvm::SmallString<128> path{dir_};
+  llvm::sys::path::append(path, hashAsString(hash) + ".jitprofile");
+  return path.str().str();
+}
+
+std::vector<uint32_t> JITProfileCache::load(
+    const RuntimeModule *runtimeModule) const {
+  std::vector<uint32_t> functionIDs;
+  std::string path = getPath(runtimeModule);
+  if (path.empty())
+    return functionIDs;
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer)
+    return functionIDs;
+
+  llvm::SmallVector<llvm::StringRef, 32> lines;
+  (*buffer)->getBuffer().split(lines, '\n', -1, false);
+  if (lines.empty() || lines.front() != kProfileHeader)
+    return functionIDs;
+  for (auto it = lines.begin() + 1; it != lines.end(); ++it) {
+    uint32_t functionID;
+    // A corrupt profile is ignored as a whole.
+    if (it->getAsInteger(10, functionID))
+      return {};
+    functionIDs.push_back(functionID);
+  }
+  return functionIDs;
+}
+
+void JITProfileCache::save(const RuntimeModule *runtimeModule) const {
+  std::string path = getPath(runtimeModule);
+  if (path.empty())
+    return;
+
+  std::vector<uint32_t> functionIDs;
+  for (uint32_t i = 0, e = runtimeModule->getNumCodeBlocks(); i < e; ++i) {
+    const CodeBlock *codeBlock = runtimeModule->getCodeBlockIfCreated(i);
+    if (codeBlock && codeBlock->getRuntimeModule() == runtimeModule &&
+        codeBlock->getJITCompiled())
+      functionIDs.push_back(i);
+  }
+  // Keep the previous profile if nothing got hot, e.g. in a short run.
+  if (functionIDs.empty())
+    return;
+
+  // Write a temporary file and rename it, so that another process loading
+  // the same bytecode never sees a partial profile.
+  std::string tmpPath = path + ".tmp";
+  {
+    std::error_code code;
+    llvm::raw_fd_ostream os(
+        tmpPath, code, llvm::sys::fs::FileAccess::FA_Write);
+    if (code)
+      return;
+    os << kProfileHeader << '\n';
+    for (uint32_t functionID : functionIDs)
+      os << functionID << '\n';
+    os.close();
+    if (os.has_error()) {
+      os.clear_error();
+      llvm::sys::fs::remove(tmpPath);
+      return;
+    }
+  }
+  if (llvm::sys::fs::rename(tmpPath, path))
+    llvm::sys::fs::remove(tmpPath);
+}
+
+} // namespace vm
+} // namespace hermes
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_RUNTIMEOFFSETS_H
+#define HERMES_VM_JIT_RUNTIMEOFFSETS_H
+
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/JSObject.h"
+#include "hermes/VM/Runtime.h"
+
+namespace hermes {
+namespace vm {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+
+struct RuntimeOffsets {
+  static constexpr uint32_t stackPointer = offsetof(Runtime, stackPointer_);
+  static constexpr uint32_t currentFrame = offsetof(Runtime, currentFrame_);
+  static constexpr uint32_t globalObject = offsetof(Runtime, global_);
+  static constexpr uint32_t thrownValue = offsetof(Runtime, thrownValue_);
+  static constexpr uint32_t asyncBreakRequestFlag =
+      offsetof(Runtime, asyncBreakRequestFlag_);
+  static constexpr uint32_t functionProfilerActive =
+      offsetof(Runtime, functionProfilerActive_);
+#ifdef HERMES_ENABLE_DEBUGGER
+  static constexpr uint32_t savedIP = offsetof(Runtime, savedIP_);
+#endif
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+  /// The bump pointer and limit of the segment the GC currently allocates
+  /// into.  Both are updated in place when the GC switches segments.
+  static constexpr uint32_t allocLevel =
+      offsetof(Runtime, heap_.allocContext_.activeSegment.level_);
+  static constexpr uint32_t allocEffectiveEnd =
+      offsetof(Runtime, heap_.allocContext_.activeSegment.effectiveEnd_);
+#endif
+};
+
+/// The fields of JSObject that the inline property caches access.
+struct JSObjectOffsets {
+  static constexpr uint32_t clazz = offsetof(JSObject, clazz_);
+  static constexpr uint32_t directProps = offsetof(JSObject, directProps_);
+};
+
+/// The fields that the inline calls to compiled JSFunctions access.
+struct GCCellOffsets {
+  static constexpr uint32_t vtp = offsetof(GCCell, vtp_);
+};
+struct JSFunctionOffsets {
+  static constexpr uint32_t codeBlock = offsetof(JSFunction, codeBlock_);
+};
+struct CodeBlockOffsets {
+  static constexpr uint32_t JITUsed = offsetof(CodeBlock, JITUsed_);
+  static constexpr uint32_t JITCompiled = offsetof(CodeBlock, JITCompiled_);
+};
+
+#pragma GCC diagnostic pop
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_RUNTIMEOFFSETS_H
@@ -0,0 +1,1606 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "FastJIT.h"
+
+#include "../ExternalCalls.h"
+#include "../RuntimeOffsets.h"
+#include "hermes/Inst/InstDecode.h"
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/Interpreter.h"
+#include "hermes/VM/JIT/DiscoverBB.h"
+#include "hermes/VM/Operations.h"
+
+#define DEBUG_TYPE "jit"
+
+namespace hermes {
+namespace vm {
+namespace arm64 {
+using hermes::inst::Inst;
+/// The tags shifted to be compared with the higher 32 bits of a HermesValue,
+/// see the x86-64 FastJIT.
+static constexpr uint32_t FirstTagHW =
+    ((uint32_t)FirstTag << (HermesValue::kNumDataBits - 32));
+static constexpr uint32_t UndefinedTagHW =
+    ((uint32_t)UndefinedTag << (HermesValue::kNumDataBits - 32));
+static constexpr uint32_t BoolTagHW =
+    ((uint32_t)BoolTag << (HermesValue::kNumDataBits - 32));
+
+/// The tag of a bool HermesValue, to be or-ed with the value 0 or 1.
+static constexpr uint64_t BoolTagQ = (uint64_t)BoolTag
+    << HermesValue::kNumDataBits;
+
+FastJIT::FastJIT(JITContext *context, CodeBlock *codeBlock)
+    : context_(context), codeBlock_(codeBlock) {}
+
+JITCompiledCode FastJIT::compile() {
+  LLVM_DEBUG(
+      llvm::dbgs() << "JIT compilation of FunctionID "
+                   << codeBlock_->getFunctionID() << "\n");
+
+  discoverBasicBlocks(codeBlock_, bcBasicBlocks_, bcLabels_, bcLoopHeaders_);
+
+  ExecHeap::SizePair sizes;
+  auto blocks = allocExec(codeBlock_->getOpcodeArray().size(), sizes);
+  if (!blocks)
+    return {};
+  if (!context_->getHeap().unprotect(*blocks, sizes)) {
+    error("executable memory could not be made writable");
+    context_->getHeap().free(*blocks);
+    return {};
+  }
+
+  fast_ = llvm::makeMutableArrayRef(blocks->first, sizes.first);
+  slow_ = llvm::makeMutableArrayRef(blocks->second, sizes.second);
+
+  Emitters emit{Emitter{fast_.begin()}, Emitter{slow_.begin()}};
+  emit = emitPrologue(emit);
+
+  nativeBBAddress_.resize(bcBasicBlocks_.size());
+
+  // Compile every basic block and record its starting address.
+  unsigned bcBasicBlocksCount = bcBasicBlocks_.size() - 1;
+  for (curBytecodeBBIndex_ = 0;
+       curBytecodeBBIndex_ != bcBasicBlocksCount && !error_;
+       ++curBytecodeBBIndex_) {
+    nativeBBAddress_[curBytecodeBBIndex_] = emit.fast.current();
+    emit = compileBB(emit);
+  }
+
+  if (!error_) {
+    // Emit the function epilogue.
+    nativeBBAddress_[curBytecodeBBIndex_] = emit.fast.current();
+    emit = emitEpilogue(emit);
+    emit = emitLoopEntries(emit);
+  }
+
+  if (!error_) {
+    resolveRelocations();
+
+    LLVM_DEBUG(disassembleResult(emit, llvm::dbgs(), true));
+    if (context_->getDumpJITCode())
+      disassembleResult(emit, llvm::outs(), false);
+  }
+
+  // Code sharing pages with this function becomes executable again even if
+  // the compilation failed.
+  if (!context_->getHeap().publish(*blocks, sizes))
+    error("executable memory could not be published");
+
+  JITCompiledCode result;
+  if (!error_) {
+    ExecHeap::SizePair keepSizes = roundExecSizes(
+        {emit.fast.current() - fast_.data(),
+         emit.slow.current() - slow_.data()});
+    context_->getHeap().freeRemaining(*blocks, keepSizes);
+    result.body = (JITCompiledFunctionPtr)fast_.data();
+    result.blocks = *blocks;
+    result.size = keepSizes.first + keepSizes.second;
+    result.codeSizes = {emit.fast.current() - fast_.data(),
+                        emit.slow.current() - slow_.data()};
+    result.lineTable = std::move(lineTable_);
+    for (unsigned i = 0, e = bcLoopHeaders_.size(); i != e; ++i) {
+      result.loopEntries.emplace_back(
+          bcBasicBlocks_[bcLoopHeaders_[i]],
+          (JITCompiledFunctionPtr)nativeLoopEntries_[i]);
+    }
+
+    // Dump the heap at the end.
+    LLVM_DEBUG(context_->getHeap().dump(llvm::dbgs()));
+  } else {
+    context_->getHeap().free(*blocks);
+    if (context_->getCrashOnError()) {
+      hermes_fatal(errorMsg_.c_str());
+    }
+  }
+
+  return result;
+}
+
+void FastJIT::error(const llvm::Twine &msg) {
+  error_ = true;
+  if (errorMsg_.empty())
+    errorMsg_ = msg.str();
+  LLVM_DEBUG(llvm::dbgs() << "FastJIT error: " << msg << "\n");
+}
+
+ExecHeap::SizePair FastJIT::roundExecSizes(ExecHeap::SizePair sizes) const {
+  if (!context_->getBackgroundCompilation())
+    return sizes;
+  const size_t pageSize = oscompat::page_size();
+  return {llvm::alignTo(sizes.first, pageSize),
+          llvm::alignTo(sizes.second, pageSize)};
+}
+
+llvm::Optional<ExecHeap::BlockPair> FastJIT::allocExec(
+    size_t bytecodeLength,
+    ExecHeap::SizePair &sizes) {
+  // Every instruction is four bytes and constants take up to four of them, so
+  // allow for more code per bytecode byte than on x86-64.
+  const size_t size = bytecodeLength * 80 + kMinInstructionSpace;
+  sizes = roundExecSizes({size, size});
+
+  auto blocks = context_->getHeap().alloc(sizes);
+  // If the allocation failed, add a new pool and retry.
+  if (!blocks) {
+    auto newPool = context_->getHeap().addPool();
+    if (!newPool) {
+      error("out of executable memory");
+      return llvm::None;
+    }
+
+    blocks = newPool->alloc(sizes);
+    if (!blocks) {
+      error("bytecode size too large");
+      return llvm::None;
+    }
+  }
+
+  assert(blocks && "allocation should have succeeded");
+  return blocks;
+}
+
+void FastJIT::disassembleRange(
+    const uint8_t *from,
+    const uint8_t *to,
+    llvm::raw_ostream &OS,
+    bool withAddr) const {
+  if (to != from) {
+    context_->getDisassembler().disassembleBuffer(
+        OS, {from, to}, from - fast_.data(), withAddr);
+  }
+}
+
+void FastJIT::disassembleResult(
+    Emitters emit,
+    llvm::raw_ostream &OS,
+    bool withAddr) const {
+  OS << "\n\nCompiled Code of FunctionID: " << codeBlock_->getFunctionID()
+     << "\n";
+  auto *last = fast_.data();
+
+  for (size_t i = 0; i < nativeBBAddress_.size(); ++i) {
+    disassembleRange(last, nativeBBAddress_[i], OS, withAddr);
+    last = nativeBBAddress_[i];
+    OS << "BB" << i << ":\n";
+  }
+  disassembleRange(last, emit.fast.current(), OS, withAddr);
+
+  // The slow paths contain no data, so they can be disassembled in one go.
+  OS << "\n;SLOW PATHS\n";
+  disassembleRange(slow_.data(), emit.slow.current(), OS, withAddr);
+}
+
+void FastJIT::applyRelocation(const Relo &relo, const uint8_t *target) {
+  switch (relo.kind) {
+    case ReloKind::Branch26:
+      Emitter::patchB(relo.address, target);
+      break;
+
+    case ReloKind::None:
+      llvm_unreachable("ReloKind::None can not be relocated. ");
+  }
+}
+
+void FastJIT::resolveRelocations() {
+  for (const auto &relo : relocs_)
+    applyRelocation(relo, nativeBBAddress_[relo.targetBCBBIndex]);
+  relocs_.clear();
+}
+
+Emitter FastJIT::emitNativeFrame(Emitter emit) {
+  // The native frame: fp and lr, the callee save registers and the saved
+  // runtime->currentFrame, padded to keep sp 16-byte aligned.
+  emit.stpPre(Reg::fp, Reg::lr, Reg::sp, -48);
+  emit.addImm(Reg::sp, 0, Reg::fp);
+  emit.stp(RegRuntime, RegFrame, Reg::sp, 16);
+
+  // Move the first parameter (Runtime *) into its register.
+  emit.movRegToReg(Reg::x0, RegRuntime);
+
+  // Save runtime->currentFrame on the native stack.
+  emit.ldr(RegRuntime, RuntimeOffsets::currentFrame, Reg::x9);
+  emit.str(Reg::x9, Reg::sp, 32);
+
+  return emit;
+}
+
+Emitters FastJIT::emitPrologue(Emitters emit) {
+  if (!checkSpace(emit))
+    return emit;
+
+  emit.fast = emitNativeFrame(emit.fast);
+
+  // Load runtime->stackPointer_ top into RegFrame
+  emit.fast.ldr(RegRuntime, RuntimeOffsets::stackPointer, RegFrame);
+  // Store RegFrame into runtime->currentFrame_.
+  emit.fast.str(RegFrame, RegRuntime, RuntimeOffsets::currentFrame);
+
+  // Allocate and clear registers for the frame and update the top of the stack.
+  // runtime->stackPointer = RegFrame - 8*numRegsNeeded.
+  const int numRegsNeeded = codeBlock_->getFrameSize() +
+      StackFrameLayout::CalleeExtraRegistersAtStart;
+  emit.fast.movImm(HermesValue::encodeUndefinedValue().getRaw(), Reg::x9);
+  emit.fast.addOffset(
+      RegFrame, -(int64_t)sizeof(HermesValue) * numRegsNeeded, Reg::x10);
+  if (numRegsNeeded > 0) {
+    // A loop rather than a store per register, to keep the prologue short.
+    emit.fast.movRegToReg(RegFrame, Reg::x11);
+    uint8_t *loop = emit.fast.current();
+    emit.fast.strPre(Reg::x9, Reg::x11, -(int32_t)sizeof(HermesValue));
+    emit.fast.cmpReg(Reg::x11, Reg::x10);
+    emit.fast.bcond(Cond::NE, loop);
+  }
+  emit.fast.str(Reg::x10, RegRuntime, RuntimeOffsets::stackPointer);
+
+  // Report the entry to the function profiler, if it is enabled.
+  uint8_t *slowPathAddr = emit.slow.current();
+  emit.fast.ldrb(RegRuntime, RuntimeOffsets::functionProfilerActive, Reg::x9);
+  emit.fast.cmpImmW(Reg::x9, 0);
+  emit.fast = cjmpFar(emit.fast, Cond::NE, slowPathAddr);
+
+  emit.slow.movRegToReg(RegRuntime, Reg::x0);
+  emit.slow.movImm((uint64_t)codeBlock_, Reg::x1);
+  emit.slow.movRegToReg(RegFrame, Reg::x2);
+  emit.slow = callAbsolute(emit.slow, (void *)externFunctionProfilerEnter);
+  emit.slow.b(emit.fast.current());
+
+  return emit;
+}
+
+Emitters FastJIT::emitEpilogue(Emitters emit) {
+  if (!checkSpace(emit))
+    return emit;
+
+  // x0 and x1 hold the returned CallResult and must be preserved.
+
+  // Report the exit to the function profiler, if it is enabled. Loop entries
+  // leave through here too, for frames the interpreter entered; the
+  // interpreter's own report of their exit is then ignored.
+  uint8_t *slowPathAddr = emit.slow.current();
+  emit.fast.ldrb(RegRuntime, RuntimeOffsets::functionProfilerActive, Reg::x9);
+  emit.fast.cmpImmW(Reg::x9, 0);
+  emit.fast = cjmpFar(emit.fast, Cond::NE, slowPathAddr);
+
+  emit.slow.stpPre(Reg::x0, Reg::x1, Reg::sp, -16);
+  emit.slow.movRegToReg(RegRuntime, Reg::x0);
+  emit.slow.movRegToReg(RegFrame, Reg::x1);
+  emit.slow = callAbsolute(emit.slow, (void *)externFunctionProfilerExit);
+  emit.slow.ldpPost(Reg::sp, 16, Reg::x0, Reg::x1);
+  emit.slow.b(emit.fast.current());
+
+  // Restore the VM stack pointer: runtime->stackPointer = RegFrame.
+  emit.fast.str(RegFrame, RegRuntime, RuntimeOffsets::stackPointer);
+
+  // Restore runtime->currentFrame_ from the native stack.
+  emit.fast.ldr(Reg::sp, 32, Reg::x9);
+  emit.fast.str(Reg::x9, RegRuntime, RuntimeOffsets::currentFrame);
+
+  // Restore callee saved registers.
+  emit.fast.ldp(Reg::sp, 16, RegRuntime, RegFrame);
+  emit.fast.ldpPost(Reg::sp, 48, Reg::fp, Reg::lr);
+  emit.fast.ret();
+
+  return emit;
+}
+
+Emitters FastJIT::emitLoopEntries(Emitters emit) {
+  nativeLoopEntries_.clear();
+  for (unsigned bcBB : bcLoopHeaders_) {
+    if (!checkSpace(emit))
+      return emit;
+
+    nativeLoopEntries_.push_back(emit.slow.current());
+    emit.slow = emitNativeFrame(emit.slow);
+    // The interpreter has already set up runtime->currentFrame_ and allocated
+    // its registers, so only RegFrame needs to be loaded. The epilogue leaves
+    // the frame in place for the interpreter to pop.
+    emit.slow.ldr(RegRuntime, RuntimeOffsets::currentFrame, RegFrame);
+    emit.slow.b(nativeBBAddress_[bcBB]);
+  }
+  return emit;
+}
+
+// Calculate the address of the next instruction given the name of the current
+// one.
+#define NEXTINST(name) ((const Inst *)(&ip->i##name + 1))
+
+Emitters FastJIT::compileBB(Emitters emit) {
+  auto *ip = reinterpret_cast<const Inst *>(
+      codeBlock_->begin() + bcBasicBlocks_[curBytecodeBBIndex_]);
+  auto *to = reinterpret_cast<const Inst *>(
+      codeBlock_->begin() + bcBasicBlocks_[curBytecodeBBIndex_ + 1]);
+
+  while (ip != to) {
+    if (!checkSpace(emit))
+      return emit;
+
+    if (context_->hasPerfMap()) {
+      lineTable_.emplace_back(
+          emit.fast.current() - fast_.data(), codeBlock_->getOffsetOf(ip));
+    }
+
+    LLVM_DEBUG(llvm::dbgs() << ";   " << decodeInstruction(ip) << "\n");
+#ifndef NDEBUG
+    auto sav = emit;
+#endif
+
+    switch (ip->opCode) {
+#define CASE(name)                  \
+  case OpCode::name:                \
+    emit = compile##name(emit, ip); \
+    ip = NEXTINST(name);            \
+    break
+
+/// Implement a comparison jump with a fast path, a slow path, and a long
+/// version. See the x86-64 FastJIT.
+/// \param cc the condition on the flags set by fcmp indicating when to jump.
+#define JCOND_IMPL(name, suffix, cc, slowPathCall) \
+  case OpCode::name##suffix:                       \
+    emit = compileCondJump(                        \
+        emit,                                      \
+        ip,                                        \
+        ip->i##name##suffix.op1,                   \
+        ip->i##name##suffix.op2,                   \
+        ip->i##name##suffix.op3,                   \
+        cc,                                        \
+        (void *)slowPathCall);                     \
+    ip = NEXTINST(name##suffix);                   \
+    break;                                         \
+  case OpCode::name##N##suffix:                    \
+    emit = compileCondJumpN(                       \
+        emit,                                      \
+        ip,                                        \
+        ip->i##name##N##suffix.op1,                \
+        ip->i##name##N##suffix.op2,                \
+        ip->i##name##N##suffix.op3,                \
+        cc);                                       \
+    ip = NEXTINST(name##N##suffix);                \
+    break
+
+#define JCOND(name, cc, slowPathCall)   \
+  JCOND_IMPL(name, , cc, slowPathCall); \
+  JCOND_IMPL(name, Long, cc, slowPathCall);
+
+/// Implement a jump based on equality test and its long version
+/// \param name the name of the instruction.
+/// \param cc the conditional code indicating when to jump.
+/// \param compilation the compilation function for this instruction.
+#define JEQ(name, cc, compilation) \
+  case OpCode::name:               \
+    emit = compilation(            \
+        emit,                      \
+        ip,                        \
+        ip->i##name.op1,           \
+        ip->i##name.op2,           \
+        ip->i##name.op3,           \
+        cc);                       \
+    ip = NEXTINST(name);           \
+    break;                         \
+  case OpCode::name##Long:         \
+    emit = compilation(            \
+        emit,                      \
+        ip,                        \
+        ip->i##name##Long.op1,     \
+        ip->i##name##Long.op2,     \
+        ip->i##name##Long.op3,     \
+        cc);                       \
+    ip = NEXTINST(name##Long);     \
+    break;
+
+/// Implement a bool jump instruction and its long version.
+/// \param name the name of the instruction.
+/// \param cc the conditional code indicating when to jump.
+#define JBOOL(name, cc)                                                     \
+  case OpCode::name:                                                        \
+    emit = compileBoolJmp(emit, ip, ip->i##name.op1, ip->i##name.op2, cc);  \
+    ip = NEXTINST(name);                                                    \
+    break;                                                                  \
+  case OpCode::name##Long:                                                  \
+    emit = compileBoolJmp(                                                  \
+        emit, ip, ip->i##name##Long.op1, ip->i##name##Long.op2, cc);        \
+    ip = NEXTINST(name##Long);                                              \
+    break
+
+#define BINOP(name, fpOp)                                                   \
+  case OpCode::name:                                                        \
+    emit = compileBinOp(emit, ip, (void *)slowPath##name, &Emitter::fpOp);  \
+    ip = NEXTINST(name);                                                    \
+    break;                                                                  \
+  case OpCode::name##N:                                                     \
+    emit = compileBinOpN(emit, ip, &Emitter::fpOp);                         \
+    ip = NEXTINST(name##N);                                                 \
+    break
+
+#define COND_OP(name, cc)                                        \
+  case OpCode::name:                                             \
+    emit = compileCondOp(emit, ip, cc, (void *)slowPath##name);  \
+    ip = NEXTINST(name);                                         \
+    break
+
+#define LOAD_CONST_STRING(name)                               \
+  case OpCode::name:                                          \
+    emit = compileLoadConstString(emit, ip, ip->i##name.op2); \
+    ip = NEXTINST(name);                                      \
+    break
+
+#define LOAD_CONST_INT(name, val)                               \
+  case OpCode::name:                                            \
+    emit = loadHermesValueConstant(emit, ip->i##name.op1, val); \
+    ip = NEXTINST(name);                                        \
+    break
+
+#define EQ_TEST(name, isNeq)                     \
+  case OpCode::name:                             \
+    emit = compileEqTest(emit, ip, isNeq);       \
+    ip = NEXTINST(name);                         \
+    break;                                       \
+  case OpCode::Strict##name:                     \
+    emit = compileStrictEqTest(emit, ip, isNeq); \
+    ip = NEXTINST(Strict##name);                 \
+    break
+
+/// Compile an instruction and its long or short version, see the x86-64
+/// FastJIT.
+#define CASE_WITH_SUFFIX(name, suffix, op)                  \
+  case OpCode::name##suffix:                                \
+    emit = compile##name(emit, ip, ip->i##name##suffix.op); \
+    ip = NEXTINST(name##suffix);                            \
+    break
+
+/// Compile an instruction whose variants differ only in operand sizes with
+/// \p helper, which receives the given operands.
+#define CASE_HELPER(name, helper, ...)       \
+  case OpCode::name:                         \
+    emit = helper(emit, ip, __VA_ARGS__);    \
+    ip = NEXTINST(name);                     \
+    break
+
+/// Compile instructions with the layout (name, Reg8, Reg8, Reg8)
+#define CASE_3REG(name)                                      \
+  case OpCode::name:                                         \
+    emit = compile3RegsInst(emit, ip, (void *)extern##name); \
+    ip = NEXTINST(name);                                     \
+    break
+
+/// Compile an instruction implemented out of line by Interpreter::case<name>.
+#define CASE_OUTOFLINE(name)                                            \
+  case OpCode::name:                                                    \
+    emit = compileOutOfLine(emit, ip, (void *)Interpreter::case##name); \
+    ip = NEXTINST(name);                                                \
+    break
+
+      CASE(DeclareGlobalVar);
+      CASE(CreateEnvironment);
+      CASE_HELPER(CreateClosure, createClosureHelper, ip->iCreateClosure.op3);
+      CASE_HELPER(
+          CreateClosureLongIndex,
+          createClosureHelper,
+          ip->iCreateClosureLongIndex.op3);
+      CASE(GetGlobalObject);
+      CASE_HELPER(PutById, putByIdHelper, false, ip->iPutById.op4);
+      CASE_HELPER(TryPutById, putByIdHelper, true, ip->iTryPutById.op4);
+      CASE_HELPER(PutByIdLong, putByIdHelper, false, ip->iPutByIdLong.op4);
+      CASE_HELPER(
+          TryPutByIdLong, putByIdHelper, true, ip->iTryPutByIdLong.op4);
+      CASE_HELPER(GetById, getByIdHelper, false, ip->iGetById.op4);
+      CASE_HELPER(GetByIdLong, getByIdHelper, false, ip->iGetByIdLong.op4);
+      CASE_HELPER(GetByIdShort, getByIdHelper, false, ip->iGetByIdShort.op4);
+      CASE_HELPER(TryGetById, getByIdHelper, true, ip->iTryGetById.op4);
+      CASE_HELPER(
+          TryGetByIdLong, getByIdHelper, true, ip->iTryGetByIdLong.op4);
+      CASE_HELPER(Call, callHelper, ip->iCall.op3, false);
+      CASE_HELPER(CallLong, callHelper, ip->iCallLong.op3, false);
+      CASE_HELPER(Construct, callHelper, ip->iConstruct.op3, true);
+      CASE_HELPER(ConstructLong, callHelper, ip->iConstructLong.op3, true);
+      CASE_HELPER(Call1, callNHelper, {ip->iCall1.op3});
+      CASE_HELPER(Call2, callNHelper, {ip->iCall2.op3, ip->iCall2.op4});
+      CASE_HELPER(
+          Call3,
+          callNHelper,
+          {ip->iCall3.op3, ip->iCall3.op4, ip->iCall3.op5});
+      CASE_HELPER(
+          Call4,
+          callNHelper,
+          {ip->iCall4.op3, ip->iCall4.op4, ip->iCall4.op5, ip->iCall4.op6});
+      LOAD_CONST_STRING(LoadConstString);
+      LOAD_CONST_STRING(LoadConstStringLongIndex);
+      case OpCode::LoadParam:
+        emit = loadParamHelper(emit, ip->iLoadParam.op1, ip->iLoadParam.op2);
+        ip = NEXTINST(LoadParam);
+        break;
+      case OpCode::LoadParamLong:
+        emit = loadParamHelper(
+            emit, ip->iLoadParamLong.op1, ip->iLoadParamLong.op2);
+        ip = NEXTINST(LoadParamLong);
+        break;
+      BINOP(Add, fadd);
+      BINOP(Sub, fsub);
+      BINOP(Mul, fmul);
+      BINOP(Div, fdiv);
+      CASE_HELPER(
+          MathAbs, compileMathOp1, (void *)slowPathMathAbs, &Emitter::fabs);
+      CASE_HELPER(
+          MathCeil, compileMathOp1, (void *)slowPathMathCeil, &Emitter::frintp);
+      CASE_HELPER(
+          MathFloor,
+          compileMathOp1,
+          (void *)slowPathMathFloor,
+          &Emitter::frintm);
+      CASE_HELPER(
+          MathSqrt, compileMathOp1, (void *)slowPathMathSqrt, &Emitter::fsqrt);
+      // fmin and fmax treat NaN and the zeros as Math.min and Math.max do.
+      CASE_HELPER(
+          MathMin, compileBinOp, (void *)slowPathMathMin, &Emitter::fmin);
+      CASE_HELPER(
+          MathMax, compileBinOp, (void *)slowPathMathMax, &Emitter::fmax);
+      CASE(TypeOf);
+      CASE_HELPER(Mov, compileMov, ip->iMov.op1, ip->iMov.op2);
+      CASE_HELPER(MovLong, compileMov, ip->iMovLong.op1, ip->iMovLong.op2);
+      CASE(ToNumber);
+      CASE(ToInt32);
+      CASE(AddEmptyString);
+      CASE(StringConcat);
+      CASE(Ret);
+
+      // The conditions on the flags of fcmp are false for an unordered
+      // result, except in the negated jumps, which are taken when either
+      // operand is NaN.
+      JCOND(JLess, Cond::MI, slowPathLess);
+      JCOND(JLessEqual, Cond::LS, slowPathLessEq);
+      JCOND(JGreater, Cond::GT, slowPathGreater);
+      JCOND(JGreaterEqual, Cond::GE, slowPathGreaterEq);
+      JCOND(JNotLess, Cond::PL, slowPathGreaterEq);
+      JCOND(JNotLessEqual, Cond::HI, slowPathGreater);
+      JCOND(JNotGreater, Cond::LE, slowPathLessEq);
+      JCOND(JNotGreaterEqual, Cond::LT, slowPathLess);
+
+      // JEqual jumps when the equality test returns non-zero (true)
+      JEQ(JEqual, Cond::NE, compileEqJump);
+      // JNotEqual jumps when the equality test returns zero (false)
+      JEQ(JNotEqual, Cond::EQ, compileEqJump);
+      JEQ(JStrictEqual, Cond::NE, compileStrictEqJump);
+      JEQ(JStrictNotEqual, Cond::EQ, compileStrictEqJump);
+
+      // JmpTrue jumps when the operand register is non-zero (true)
+      JBOOL(JmpTrue, Cond::NE);
+      // JmpFalse jumps when the operand register is zero (false)
+      JBOOL(JmpFalse, Cond::EQ);
+      CASE_HELPER(Jmp, compileJmp, ip->iJmp.op1);
+      CASE_HELPER(JmpLong, compileJmp, ip->iJmpLong.op1);
+      CASE_HELPER(
+          JmpUndefined,
+          compileJmpUndefined,
+          ip->iJmpUndefined.op1,
+          ip->iJmpUndefined.op2);
+      CASE_HELPER(
+          JmpUndefinedLong,
+          compileJmpUndefined,
+          ip->iJmpUndefinedLong.op1,
+          ip->iJmpUndefinedLong.op2);
+
+      EQ_TEST(Eq, /*isNeq*/ false);
+      EQ_TEST(Neq, /*isNeq*/ true);
+
+      COND_OP(Less, Cond::MI);
+      COND_OP(LessEq, Cond::LS);
+      COND_OP(Greater, Cond::GT);
+      COND_OP(GreaterEq, Cond::GE);
+
+      LOAD_CONST_INT(LoadConstZero, HermesValue::encodeDoubleValue(0));
+      LOAD_CONST_INT(
+          LoadConstInt, HermesValue::encodeDoubleValue(ip->iLoadConstInt.op2));
+      LOAD_CONST_INT(
+          LoadConstUInt8,
+          HermesValue::encodeDoubleValue(ip->iLoadConstUInt8.op2));
+      LOAD_CONST_INT(
+          LoadConstDouble,
+          HermesValue::encodeDoubleValue(ip->iLoadConstDouble.op2));
+      LOAD_CONST_INT(LoadConstUndefined, HermesValue::encodeUndefinedValue());
+      LOAD_CONST_INT(LoadConstTrue, HermesValue::encodeBoolValue(true));
+      LOAD_CONST_INT(LoadConstFalse, HermesValue::encodeBoolValue(false));
+      LOAD_CONST_INT(LoadConstNull, HermesValue::encodeNullValue());
+
+      CASE(NewObject);
+      CASE_3REG(CreateThis);
+      CASE(NewArray);
+      CASE(Throw);
+      CASE_3REG(GetByVal);
+      CASE(PutByVal);
+      CASE_HELPER(
+          StoreToEnvironment,
+          storeToEnvironmentHelper,
+          ip->iStoreToEnvironment.op1,
+          ip->iStoreToEnvironment.op2,
+          ip->iStoreToEnvironment.op3,
+          false);
+      CASE_HELPER(
+          StoreToEnvironmentL,
+          storeToEnvironmentHelper,
+          ip->iStoreToEnvironmentL.op1,
+          ip->iStoreToEnvironmentL.op2,
+          ip->iStoreToEnvironmentL.op3,
+          false);
+      CASE_HELPER(
+          StoreNPToEnvironment,
+          storeToEnvironmentHelper,
+          ip->iStoreNPToEnvironment.op1,
+          ip->iStoreNPToEnvironment.op2,
+          ip->iStoreNPToEnvironment.op3,
+          true);
+      CASE_HELPER(
+          StoreNPToEnvironmentL,
+          storeToEnvironmentHelper,
+          ip->iStoreNPToEnvironmentL.op1,
+          ip->iStoreNPToEnvironmentL.op2,
+          ip->iStoreNPToEnvironmentL.op3,
+          true);
+      CASE_WITH_SUFFIX(LoadFromEnvironment, , op3);
+      CASE_WITH_SUFFIX(LoadFromEnvironment, L, op3);
+      CASE_3REG(Mod);
+      CASE_3REG(LShift);
+      CASE_3REG(RShift);
+      CASE_3REG(URshift);
+      CASE_3REG(BitAnd);
+      CASE_3REG(BitOr);
+      CASE_3REG(BitXor);
+      CASE(GetEnvironment);
+      CASE(GetEnvironmentAndLoad);
+      CASE(GetEnvironmentAndStore);
+      CASE(GetEnvironmentAndStoreNP);
+      CASE(Catch);
+      CASE_3REG(IsIn);
+      CASE_3REG(InstanceOf);
+      CASE(GetNewTarget);
+      CASE_OUTOFLINE(PutOwnByVal);
+      CASE_OUTOFLINE(PutOwnGetterSetterByVal);
+      CASE_OUTOFLINE(DirectEval);
+      CASE_OUTOFLINE(GetByIdSlot);
+      CASE_OUTOFLINE(DataViewGet);
+      CASE_OUTOFLINE(DataViewSet);
+      CASE(AsyncBreakCheck);
+      CASE(ProfilePoint);
+      CASE(Debugger);
+      CASE(Unreachable);
+
+      default:
+        // Nothing would run in native code before an unsupported first
+        // instruction.
+        if (ip == reinterpret_cast<const Inst *>(codeBlock_->begin())) {
+          error(
+              llvm::Twine("unsupported opcode ") +
+              llvm::Twine((int)ip->opCode)
+#ifndef NDEBUG
+              + " " + getOpCodeString(ip->opCode)
+#endif
+          );
+          return emit;
+        }
+        // The interpreter runs the rest of the function, so the rest of the
+        // basic block is never reached.
+        return emitDeopt(emit, ip);
+    }
+#undef CASE
+
+    LLVM_DEBUG(
+        disassembleRange(
+            sav.fast.current(), emit.fast.current(), llvm::dbgs(), true);
+        if (sav.slow.current() != emit.slow.current()) {
+          llvm::dbgs() << "; SLOW PATH\n";
+          disassembleRange(
+              sav.slow.current(), emit.slow.current(), llvm::dbgs(), true);
+        });
+  }
+
+  return emit;
+}
+
+Emitters FastJIT::emitDeopt(Emitters emit, const Inst *ip) {
+  // codeBlock -> arg2
+  emit.fast.movImm((uint64_t)codeBlock_, Reg::x1);
+  // offset -> arg3
+  emit.fast.movImm(codeBlock_->getOffsetOf(ip), Reg::x2);
+  // Runtime -> arg1.
+  emit.fast.movRegToReg(RegRuntime, Reg::x0);
+  emit.fast = callAbsolute(emit.fast, (void *)externDeoptimize);
+
+  // The status and the result of the function are in w0 and x1, as the
+  // epilogue expects them.
+  emit.fast = jmpToBytecodeBB(emit.fast, bcBasicBlocks_.size() - 1);
+  return emit;
+}
+
+Emitters FastJIT::loadHermesValueConstant(
+    Emitters emit,
+    uint32_t hermesReg,
+    HermesValue value) {
+  emit.fast.movImm(value.getRaw(), Reg::x9);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::x9, hermesReg);
+  return emit;
+}
+
+Emitter FastJIT::cmpSomeNPTag(Emitter emit, uint32_t regIndex, uint32_t tagHW) {
+  assert(
+      tagHW <= (FirstPointerTag << (HermesValue::kNumDataBits - 32)) &&
+      "String or object tag could not be compared directly with a HermesValue's higher 32 bits.");
+  emit = movHermesRegToNativeReg(emit, regIndex, Reg::x9);
+  emit.lsrImm(Reg::x9, 32, Reg::x10);
+  emit.movImm(tagHW, Reg::x11);
+  emit.cmpRegW(Reg::x10, Reg::x11);
+  return emit;
+}
+
+Emitter
+FastJIT::isNumber(Emitter emit, uint32_t regIndex, const uint8_t *slowPath) {
+  // A number is any value below the first tag.
+  emit = movHermesRegToNativeReg(emit, regIndex, Reg::x9);
+  emit.movImm((uint64_t)FirstTagHW << 32, Reg::x10);
+  emit.cmpReg(Reg::x9, Reg::x10);
+  emit = cjmpFar(emit, Cond::HS, slowPath);
+  return emit;
+}
+
+Emitter FastJIT::callAbsolute(Emitter emit, const void *dest) {
+  emit.movImm((uint64_t)dest, Reg::x16);
+  emit.blr(Reg::x16);
+  return emit;
+}
+
+Emitter FastJIT::callExternal(
+    Emitter emit,
+    const void *dest,
+    uint32_t resultReg,
+    const Inst *ip) {
+  // w0: status
+  // x1: HermesValue
+  emit = callExternalNoReturnedVal(emit, dest, ip);
+
+  // Move the result value to the destination register.
+  emit = movNativeRegToHermesReg(emit, Reg::x1, resultReg);
+  return emit;
+}
+
+Emitter FastJIT::callExternalNoReturnedVal(
+    Emitter emit,
+    const void *dest,
+    const Inst *ip) {
+  // Runtime -> arg1.
+  emit.movRegToReg(RegRuntime, Reg::x0);
+  emit = callAbsolute(emit, dest);
+
+  // Exception?
+  emit.cmpImmW(Reg::x0, 0);
+  emit = cjmpToBytecodeBB(emit, Cond::EQ, getCatchHandlerBBIndex(ip));
+  return emit;
+}
+
+Emitter FastJIT::callExternalWithReturnedVal(
+    Emitter emit,
+    const void *dest,
+    uint32_t resultReg) {
+  // Runtime -> arg1.
+  emit.movRegToReg(RegRuntime, Reg::x0);
+  emit = callAbsolute(emit, dest);
+
+  // Move the result value to the destination register.
+  emit = movNativeRegToHermesReg(emit, Reg::x0, resultReg);
+  return emit;
+}
+
+Emitter FastJIT::jmpToBytecodeBB(Emitter emit, unsigned bytecodeBB) {
+  // If jumping to the next BB, do nothing.
+  if (bytecodeBB == curBytecodeBBIndex_ + 1)
+    return emit;
+
+  // Backwards branch doesn't need a relocation and we can determine the offset.
+  if (bytecodeBB <= curBytecodeBBIndex_) {
+    emit.b(nativeBBAddress_[bytecodeBB]);
+  } else {
+    // Forward branch: emit a jump to itself and record a relocation.
+    emit.b(emit.current());
+    relocs_.emplace_back(ReloKind::Branch26, emit.current() - 4, bytecodeBB);
+  }
+  return emit;
+}
+
+Emitter FastJIT::cjmpToBytecodeBB(Emitter emit, Cond cc, unsigned bytecodeBB) {
+  // Skip the B below unless the condition holds. This is also used in the slow
+  // path, so the B is emitted even if the target is the next BB.
+  emit.bcond(invert(cc), emit.current() + 8);
+  if (bytecodeBB <= curBytecodeBBIndex_) {
+    emit.b(nativeBBAddress_[bytecodeBB]);
+  } else {
+    emit.b(emit.current());
+    relocs_.emplace_back(ReloKind::Branch26, emit.current() - 4, bytecodeBB);
+  }
+  return emit;
+}
+
+Emitter FastJIT::cjmpFar(Emitter emit, Cond cc, const uint8_t *target) {
+  emit.bcond(invert(cc), emit.current() + 8);
+  emit.b(target);
+  return emit;
+}
+
+Emitters FastJIT::getByIdHelper(
+    Emitters emit,
+    const Inst *ip,
+    bool tryProp,
+    uint32_t idVal) {
+  auto flags =
+      !tryProp ? defaultPropOpFlags() : defaultPropOpFlags().plusMustExist();
+  // PropOpFlags  -> arg2
+  emit.fast.movImm(flags.getRaw(), Reg::x1);
+  // IdentifierID (uint32_t) -> arg3
+  emit.fast.movImm(
+      codeBlock_->getRuntimeModule()
+          ->getSymbolIDMustExist(idVal)
+          .unsafeGetIndex(),
+      Reg::x2);
+  // &target -> arg4
+  emit.fast = leaHermesReg(emit.fast, ip->iGetById.op2, Reg::x3);
+  // cacheIdx -> arg5
+  emit.fast.movImm(ip->iGetById.op3, Reg::x4);
+  // current code block -> arg6
+  emit.fast.movImm((uint64_t)codeBlock_, Reg::x5);
+
+  emit.fast =
+      callExternal(emit.fast, (void *)externGetById, ip->iGetById.op1, ip);
+  return emit;
+}
+
+Emitters FastJIT::putByIdHelper(
+    Emitters emit,
+    const Inst *ip,
+    bool tryProp,
+    uint32_t idVal) {
+  auto flags =
+      !tryProp ? defaultPropOpFlags() : defaultPropOpFlags().plusMustExist();
+  // PropOpFlags  -> arg2
+  emit.fast.movImm(flags.getRaw(), Reg::x1);
+  // IdentifierID (uint32_t) -> arg3
+  emit.fast.movImm(
+      codeBlock_->getRuntimeModule()
+          ->getSymbolIDMustExist(idVal)
+          .unsafeGetIndex(),
+      Reg::x2);
+  // &target -> arg4
+  emit.fast = leaHermesReg(emit.fast, ip->iPutById.op1, Reg::x3);
+  // &prop -> arg5
+  emit.fast = leaHermesReg(emit.fast, ip->iPutById.op2, Reg::x4);
+  // cacheIdx -> arg6
+  emit.fast.movImm(ip->iPutById.op3, Reg::x5);
+
+  emit.fast = callExternalNoReturnedVal(emit.fast, (void *)externPutById, ip);
+  return emit;
+}
+
+Emitters FastJIT::callHelper(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t argCount,
+    bool isConstruct) {
+  // &callable -> arg2
+  emit.fast = leaHermesReg(emit.fast, ip->iCall.op2, Reg::x1);
+  // argCount (uint32_t) -> arg3
+  emit.fast.movImm(argCount, Reg::x2);
+  // stack pointer -> arg4
+  emit.fast.ldr(RegRuntime, RuntimeOffsets::stackPointer, Reg::x3);
+  // ip -> arg5
+  emit.fast.movImm((uint64_t)ip, Reg::x4);
+  // currentFrame -> arg6
+  emit.fast.movRegToReg(RegFrame, Reg::x5);
+
+  emit.fast = callExternal(
+      emit.fast,
+      isConstruct ? (void *)externConstruct : (void *)externCall,
+      ip->iCall.op1,
+      ip);
+  return emit;
+}
+
+Emitters FastJIT::callNHelper(
+    Emitters emit,
+    const Inst *ip,
+    llvm::ArrayRef<uint32_t> argRegs) {
+  // The interpreter writes the arguments into the outgoing frame right before
+  // the call, starting with "thisArg".
+  emit.fast.ldr(RegRuntime, RuntimeOffsets::stackPointer, Reg::x10);
+  int32_t argIndex = -1;
+  for (uint32_t argReg : argRegs) {
+    emit.fast = movHermesRegToNativeReg(emit.fast, argReg, Reg::x9);
+    emit.fast.str(
+        Reg::x9,
+        Reg::x10,
+        sizeof(HermesValue) * StackFrameLayout::argOffset(argIndex++));
+  }
+  return callHelper(emit, ip, argRegs.size(), false);
+}
+
+Emitters
+FastJIT::loadParamHelper(Emitters emit, uint32_t resReg, uint32_t paramIndex) {
+  // x9 = undefined
+  emit.fast.movImm(HermesValue::encodeUndefinedValue().getRaw(), Reg::x9);
+  emit.fast.ldrW(
+      RegFrame, sizeof(HermesValue) * StackFrameLayout::ArgCount, Reg::x10);
+  emit.fast.movImm(paramIndex, Reg::x11);
+  emit.fast.cmpRegW(Reg::x10, Reg::x11);
+
+  // Skip the load of the argument if there are fewer; patched below.
+  uint8_t *skip = emit.fast.current();
+  emit.fast.bcond(Cond::LO, skip);
+
+  emit.fast.ldr(
+      RegFrame,
+      sizeof(HermesValue) *
+          StackFrameLayout::argOffset((int32_t)paramIndex - 1),
+      Reg::x9);
+
+  Emitter patch{skip};
+  patch.bcond(Cond::LO, emit.fast.current());
+
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::x9, resReg);
+  return emit;
+}
+
+Emitters FastJIT::createClosureHelper(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t funcIndex) {
+  // Code blocks are allocated in C heap, so their addresses are constant,
+  // and can be embedded in JIT'ed code.
+  // &calleeCodeBlock  -> arg2
+  CodeBlock *calleeBlock =
+      codeBlock_->getRuntimeModule()->getCodeBlockMayAllocate(funcIndex);
+  emit.fast.movImm((uint64_t)calleeBlock, Reg::x1);
+
+  // &env -> arg3
+  emit.fast = leaHermesReg(emit.fast, ip->iCreateClosure.op2, Reg::x2);
+
+  emit.fast = callExternal(
+      emit.fast, (void *)externCreateClosure, ip->iCreateClosure.op1, ip);
+  return emit;
+}
+
+Emitters FastJIT::storeToEnvironmentHelper(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t op1,
+    uint32_t idx,
+    uint32_t op3,
+    bool isNP) {
+  // environment -> arg1
+  emit.fast = leaHermesReg(emit.fast, op1, Reg::x0);
+  // slot index -> arg2
+  emit.fast.movImm(idx, Reg::x1);
+  // value -> arg3
+  emit.fast = leaHermesReg(emit.fast, op3, Reg::x2);
+
+  if (!isNP)
+    // runtime -> arg4
+    emit.fast.movRegToReg(RegRuntime, Reg::x3);
+
+  // the external call returns void
+  emit.fast = callAbsolute(
+      emit.fast,
+      isNP ? (void *)externStoreNPToEnvironment
+           : (void *)externStoreToEnvironment);
+  return emit;
+}
+
+Emitters
+FastJIT::compileOutOfLine(Emitters emit, const Inst *ip, void *caseFn) {
+  // frameRegs is the address of r0.
+  emit.fast = leaHermesReg(emit.fast, 0, Reg::x1);
+  emit.fast.movImm((uint64_t)ip, Reg::x2);
+  emit.fast = callExternalNoReturnedVal(emit.fast, caseFn, ip);
+  return emit;
+}
+
+Emitters
+FastJIT::compile3RegsInst(Emitters emit, const Inst *ip, void *externCallAddr) {
+  emit.fast = leaHermesReg(emit.fast, ip->iCreateThis.op2, Reg::x1);
+  emit.fast = leaHermesReg(emit.fast, ip->iCreateThis.op3, Reg::x2);
+
+  emit.fast =
+      callExternal(emit.fast, externCallAddr, ip->iCreateThis.op1, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileBinOp(
+    Emitters emit,
+    const Inst *ip,
+    void *slowPathBinOp,
+    void (Emitter::*fpOp)(FReg, FReg, FReg)) {
+  // The interpreter has run this instruction on operands that aren't
+  // numbers, so skip the number fast path and call the generic one.
+  if (codeBlock_->sawNonNumberArith(codeBlock_->getOffsetOf(ip)))
+    return compile3RegsInst(emit, ip, slowPathBinOp);
+
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  // isNumber op2?
+  emit.fast = isNumber(emit.fast, ip->iAdd.op2, slowPathAddr);
+  // isNumber op3?
+  emit.fast = isNumber(emit.fast, ip->iAdd.op3, slowPathAddr);
+  emit = compileBinOpN(emit, ip, fpOp);
+
+  // Slow path.
+  // &op2 -> arg2, &op3 -> arg3
+  emit.slow = leaHermesReg(emit.slow, ip->iAdd.op2, Reg::x1);
+  emit.slow = leaHermesReg(emit.slow, ip->iAdd.op3, Reg::x2);
+  emit.slow = callExternal(emit.slow, slowPathBinOp, ip->iAdd.op1, ip);
+  emit.slow.b(emit.fast.current());
+  return emit;
+}
+
+Emitters FastJIT::compileBinOpN(
+    Emitters emit,
+    const Inst *ip,
+    void (Emitter::*fpOp)(FReg, FReg, FReg)) {
+  emit.fast.ldrD(RegFrame, localHermesRegByteOffset(ip->iAdd.op2), FReg::d0);
+  emit.fast.ldrD(RegFrame, localHermesRegByteOffset(ip->iAdd.op3), FReg::d1);
+  (emit.fast.*fpOp)(FReg::d0, FReg::d1, FReg::d0);
+  emit.fast.strD(FReg::d0, RegFrame, localHermesRegByteOffset(ip->iAdd.op1));
+  return emit;
+}
+
+Emitters FastJIT::compileMathOp1(
+    Emitters emit,
+    const Inst *ip,
+    void *slowPathMathOp,
+    void (Emitter::*fpOp)(FReg, FReg)) {
+  // &op2 -> arg2
+  // As in compileBinOp, skip the number fast path if the interpreter has run
+  // this instruction on an operand that isn't a number.
+  if (codeBlock_->sawNonNumberArith(codeBlock_->getOffsetOf(ip))) {
+    emit.fast = leaHermesReg(emit.fast, ip->iMathAbs.op2, Reg::x1);
+    emit.fast = callExternal(emit.fast, slowPathMathOp, ip->iMathAbs.op1, ip);
+    return emit;
+  }
+
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  // isNumber op2?
+  emit.fast = isNumber(emit.fast, ip->iMathAbs.op2, slowPathAddr);
+  emit.fast.ldrD(
+      RegFrame, localHermesRegByteOffset(ip->iMathAbs.op2), FReg::d0);
+  (emit.fast.*fpOp)(FReg::d0, FReg::d0);
+  emit.fast.strD(
+      FReg::d0, RegFrame, localHermesRegByteOffset(ip->iMathAbs.op1));
+
+  // Slow path.
+  emit.slow = leaHermesReg(emit.slow, ip->iMathAbs.op2, Reg::x1);
+  emit.slow = callExternal(emit.slow, slowPathMathOp, ip->iMathAbs.op1, ip);
+  emit.slow.b(emit.fast.current());
+  return emit;
+}
+
+Emitter FastJIT::fcmpHermesRegs(Emitter emit, uint32_t reg1, uint32_t reg2) {
+  emit.ldrD(RegFrame, localHermesRegByteOffset(reg1), FReg::d0);
+  emit.ldrD(RegFrame, localHermesRegByteOffset(reg2), FReg::d1);
+  emit.fcmp(FReg::d0, FReg::d1);
+  return emit;
+}
+
+Emitters FastJIT::compileCondJumpN(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t ipOffset,
+    uint32_t reg1,
+    uint32_t reg2,
+    Cond cc) {
+  emit.fast = fcmpHermesRegs(emit.fast, reg1, reg2);
+  emit.fast = cjmpToBytecodeBB(emit.fast, cc, getBBIndex(ip, ipOffset));
+  return emit;
+}
+
+Emitters FastJIT::compileCondJump(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t ipOffset,
+    uint32_t reg1,
+    uint32_t reg2,
+    Cond cc,
+    void *slowPathCall) {
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  emit.fast = isNumber(emit.fast, reg1, slowPathAddr);
+  emit.fast = isNumber(emit.fast, reg2, slowPathAddr);
+
+  // Fast path
+  emit = compileCondJumpN(emit, ip, ipOffset, reg1, reg2, cc);
+
+  // Slow path
+  emit.slow = leaHermesReg(emit.slow, reg1, Reg::x1);
+  emit.slow = leaHermesReg(emit.slow, reg2, Reg::x2);
+  // The comparison returns a bool HermesValue in x1, which is examined
+  // directly rather than stored.
+  emit.slow = callExternalNoReturnedVal(emit.slow, slowPathCall, ip);
+  // Whether the lower 32 bits of the bool are 1.
+  emit.slow.cmpImmW(Reg::x1, 0);
+  emit.slow =
+      cjmpToBytecodeBB(emit.slow, Cond::NE, getBBIndex(ip, ipOffset));
+  // Jump to next ip if false
+  emit.slow.b(emit.fast.current());
+  return emit;
+}
+
+Emitters FastJIT::compileCondOp(
+    Emitters emit,
+    const Inst *ip,
+    Cond cc,
+    void *slowPathCall) {
+  // The interpreter has run this instruction on operands that aren't
+  // numbers, so skip the number fast path and call the generic one.
+  if (codeBlock_->sawNonNumberArith(codeBlock_->getOffsetOf(ip)))
+    return compile3RegsInst(emit, ip, slowPathCall);
+
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  // isNumber op2?
+  emit.fast = isNumber(emit.fast, ip->iLess.op2, slowPathAddr);
+  // isNumber op3?
+  emit.fast = isNumber(emit.fast, ip->iLess.op3, slowPathAddr);
+
+  // Fast path: set the result and encode it as a bool.
+  emit.fast = fcmpHermesRegs(emit.fast, ip->iLess.op2, ip->iLess.op3);
+  emit.fast.cset(cc, Reg::x9);
+  emit.fast.movImm(BoolTagQ, Reg::x10);
+  emit.fast.orrReg(Reg::x9, Reg::x10, Reg::x9);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::x9, ip->iLess.op1);
+
+  // Slow path
+  emit.slow = leaHermesReg(emit.slow, ip->iLess.op2, Reg::x1);
+  emit.slow = leaHermesReg(emit.slow, ip->iLess.op3, Reg::x2);
+  emit.slow = callExternal(emit.slow, slowPathCall, ip->iLess.op1, ip);
+  emit.slow.b(emit.fast.current());
+  return emit;
+}
+
+Emitters FastJIT::compileEqJump(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t ipOffset,
+    uint32_t reg1,
+    uint32_t reg2,
+    Cond cc) {
+  emit.fast = leaHermesReg(emit.fast, reg1, Reg::x1);
+  emit.fast = leaHermesReg(emit.fast, reg2, Reg::x2);
+  emit.fast = callExternalNoReturnedVal(
+      emit.fast, (void *)externAbstractEqualityTest, ip);
+
+  // x1 is the returned bool HermesValue.
+  emit.fast.cmpImmW(Reg::x1, 0);
+  emit.fast = cjmpToBytecodeBB(emit.fast, cc, getBBIndex(ip, ipOffset));
+  return emit;
+}
+
+Emitters FastJIT::compileStrictEqJump(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t ipOffset,
+    uint32_t reg1,
+    uint32_t reg2,
+    Cond cc) {
+  emit.fast = movHermesRegToNativeReg(emit.fast, reg1, Reg::x0);
+  emit.fast = movHermesRegToNativeReg(emit.fast, reg2, Reg::x1);
+  emit.fast = callAbsolute(emit.fast, (void *)strictEqualityTest);
+
+  // w0 : bool
+  emit.fast.tstByte(Reg::x0);
+  emit.fast = cjmpToBytecodeBB(emit.fast, cc, getBBIndex(ip, ipOffset));
+  return emit;
+}
+
+Emitters FastJIT::compileEqTest(Emitters emit, const Inst *ip, bool isNeq) {
+  emit.fast = leaHermesReg(emit.fast, ip->iEq.op2, Reg::x1);
+  emit.fast = leaHermesReg(emit.fast, ip->iEq.op3, Reg::x2);
+  // The result may need to be toggled, so it isn't stored by the call.
+  emit.fast = callExternalNoReturnedVal(
+      emit.fast, (void *)externAbstractEqualityTest, ip);
+
+  // x1 is the returned bool HermesValue
+  if (isNeq)
+    emit.fast.eorOne(Reg::x1, Reg::x1);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::x1, ip->iEq.op1);
+  return emit;
+}
+
+Emitters
+FastJIT::compileStrictEqTest(Emitters emit, const Inst *ip, bool isNeq) {
+  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iStrictEq.op2, Reg::x0);
+  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iStrictEq.op3, Reg::x1);
+  emit.fast = callAbsolute(emit.fast, (void *)strictEqualityTest);
+
+  // w0 is the returned bool value (not HermesValue)
+  emit.fast.tstByte(Reg::x0);
+  emit.fast.cset(isNeq ? Cond::EQ : Cond::NE, Reg::x9);
+  emit.fast.movImm(BoolTagQ, Reg::x10);
+  emit.fast.orrReg(Reg::x9, Reg::x10, Reg::x9);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::x9, ip->iStrictEq.op1);
+  return emit;
+}
+
+Emitters FastJIT::compileBoolJmp(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t ipOffset,
+    uint32_t regIdx,
+    Cond cc) {
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  // Fast path: the operand is a boolean, its value is in the lowest bit.
+  emit.fast = cmpSomeNPTag(emit.fast, regIdx, BoolTagHW);
+  emit.fast = cjmpFar(emit.fast, Cond::NE, slowPathAddr);
+  emit.fast.tstByte(Reg::x9);
+  emit.fast = cjmpToBytecodeBB(emit.fast, cc, getBBIndex(ip, ipOffset));
+
+  // Slow path: emit an external call to toBoolean
+  emit.slow = movHermesRegToNativeReg(emit.slow, regIdx, Reg::x0);
+  emit.slow = callAbsolute(emit.slow, (void *)toBoolean);
+  emit.slow.tstByte(Reg::x0);
+  emit.slow = cjmpToBytecodeBB(emit.slow, cc, getBBIndex(ip, ipOffset));
+  emit.slow.b(emit.fast.current());
+  return emit;
+}
+
+Emitters FastJIT::compileJmpUndefined(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t ipOffset,
+    uint32_t regIdx) {
+  emit.fast = cmpSomeNPTag(emit.fast, regIdx, UndefinedTagHW);
+  emit.fast = cjmpToBytecodeBB(emit.fast, Cond::EQ, getBBIndex(ip, ipOffset));
+  return emit;
+}
+
+Emitters FastJIT::compileJmp(Emitters emit, const Inst *ip, uint32_t ipOffset) {
+  emit.fast = jmpToBytecodeBB(emit.fast, getBBIndex(ip, ipOffset));
+  return emit;
+}
+
+Emitters
+FastJIT::compileMov(Emitters emit, const Inst *ip, uint32_t dst, uint32_t src) {
+  if (src == dst)
+    return emit;
+  emit.fast = movHermesRegToNativeReg(emit.fast, src, Reg::x9);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::x9, dst);
+  return emit;
+}
+
+Emitters FastJIT::compileLoadConstString(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t stringID) {
+  // stringID -> arg1
+  emit.fast.movImm(stringID, Reg::x0);
+  // runtime module -> arg2
+  emit.fast.movImm((uint64_t)codeBlock_->getRuntimeModule(), Reg::x1);
+  emit.fast =
+      callAbsolute(emit.fast, (void *)externLoadConstStringMayAllocate);
+
+  // Move the result value to the destination register.
+  emit.fast =
+      movNativeRegToHermesReg(emit.fast, Reg::x0, ip->iLoadConstString.op1);
+  return emit;
+}
+
+Emitters FastJIT::compileGetGlobalObject(Emitters emit, const Inst *ip) {
+  emit.fast.ldr(RegRuntime, RuntimeOffsets::globalObject, Reg::x9);
+  emit.fast =
+      movNativeRegToHermesReg(emit.fast, Reg::x9, ip->iGetGlobalObject.op1);
+  return emit;
+}
+
+Emitters FastJIT::compileGetNewTarget(Emitters emit, const Inst *ip) {
+  emit.fast.ldr(
+      RegFrame, sizeof(HermesValue) * StackFrameLayout::NewTarget, Reg::x9);
+  emit.fast =
+      movNativeRegToHermesReg(emit.fast, Reg::x9, ip->iGetNewTarget.op1);
+  return emit;
+}
+
+Emitters FastJIT::compileRet(Emitters emit, const Inst *ip) {
+  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iRet.op1, Reg::x1);
+  emit.fast.movImm(1, Reg::x0);
+  emit.fast = jmpToBytecodeBB(emit.fast, bcBasicBlocks_.size() - 1);
+  return emit;
+}
+
+unsigned FastJIT::getCatchHandlerBBIndex(const Inst *ip) {
+  // The offset between catch handler ip and codeBlock_->begin()
+  int32_t handlerOffset = codeBlock_->findCatchTargetOffset(
+      (const uint8_t *)ip - (const uint8_t *)codeBlock_->begin());
+  assert(
+      bcBasicBlocks_.size() > 0 &&
+      "We should at least have one BB which is epilogue.");
+  if (handlerOffset == -1)
+    return bcBasicBlocks_.size() - 1; // exit block
+  // The last BB is the epilogue which could not be a catch handler BB.
+  assert(
+      handlerOffset >= 0 && (uint32_t)handlerOffset < bcBasicBlocks_.back() &&
+      "The catch handler basic block offset is out of bound.");
+  assert(
+      bcLabels_.find(handlerOffset) != bcLabels_.end() &&
+      "handlerOffset not in bcLabels_");
+  return bcLabels_[handlerOffset];
+}
+
+Emitters FastJIT::compileCatch(Emitters emit, const Inst *ip) {
+  emit.fast.ldr(RegRuntime, RuntimeOffsets::thrownValue, Reg::x9);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::x9, ip->iCatch.op1);
+  // Clear Runtime::thrownValue_
+  emit.fast.movImm(HermesValue::encodeEmptyValue().getRaw(), Reg::x9);
+  emit.fast.str(Reg::x9, RegRuntime, RuntimeOffsets::thrownValue);
+  return emit;
+}
+
+Emitters FastJIT::compileThrow(Emitters emit, const Inst *ip) {
+  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iThrow.op1, Reg::x9);
+  emit.fast.str(Reg::x9, RegRuntime, RuntimeOffsets::thrownValue);
+
+  // Go to the handler like a failed external call, returning an exception if
+  // there is none.
+  emit.fast.movImm(0, Reg::x0);
+  emit.fast = jmpToBytecodeBB(emit.fast, getCatchHandlerBBIndex(ip));
+  return emit;
+}
+
+Emitters FastJIT::compileDeclareGlobalVar(Emitters emit, const Inst *ip) {
+  // StringID (uint32_t) -> arg2
+  emit.fast.movImm(ip->iDeclareGlobalVar.op1, Reg::x1);
+  emit.fast = callExternalNoReturnedVal(
+      emit.fast, (void *)externCallDeclareGlobalVar, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileCreateEnvironment(Emitters emit, const Inst *ip) {
+  // current frame -> arg2
+  emit.fast.movRegToReg(RegFrame, Reg::x1);
+  // uint32_t envSize -> arg3
+  emit.fast.movImm(codeBlock_->getEnvironmentSize(), Reg::x2);
+
+  emit.fast = callExternal(
+      emit.fast,
+      (void *)externCreateEnvironment,
+      ip->iCreateEnvironment.op1,
+      ip);
+  return emit;
+}
+
+Emitters FastJIT::getEnvironmentHelper(
+    Emitters emit,
+    uint32_t resReg,
+    uint32_t numLevels) {
+  // current frame -> arg2
+  emit.fast.movRegToReg(RegFrame, Reg::x1);
+  // the number of levels -> arg3
+  emit.fast.movImm(numLevels, Reg::x2);
+
+  emit.fast = callExternalWithReturnedVal(
+      emit.fast, (void *)externGetEnvironment, resReg);
+  return emit;
+}
+
+Emitters FastJIT::compileGetEnvironment(Emitters emit, const Inst *ip) {
+  return getEnvironmentHelper(
+      emit, ip->iGetEnvironment.op1, ip->iGetEnvironment.op2);
+}
+
+Emitters FastJIT::loadFromEnvironmentHelper(
+    Emitters emit,
+    uint32_t resReg,
+    uint32_t envReg,
+    uint32_t idx) {
+  emit.fast = leaHermesReg(emit.fast, envReg, Reg::x0);
+  emit.fast.movImm(idx, Reg::x1);
+  emit.fast = callAbsolute(emit.fast, (void *)externLoadFromEnvironment);
+
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::x0, resReg);
+  return emit;
+}
+
+Emitters FastJIT::compileLoadFromEnvironment(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t idx) {
+  return loadFromEnvironmentHelper(
+      emit, ip->iLoadFromEnvironment.op1, ip->iLoadFromEnvironment.op2, idx);
+}
+
+Emitters FastJIT::compileGetEnvironmentAndLoad(Emitters emit, const Inst *ip) {
+  emit = getEnvironmentHelper(
+      emit, ip->iGetEnvironmentAndLoad.op1, ip->iGetEnvironmentAndLoad.op3);
+  return loadFromEnvironmentHelper(
+      emit,
+      ip->iGetEnvironmentAndLoad.op2,
+      ip->iGetEnvironmentAndLoad.op1,
+      ip->iGetEnvironmentAndLoad.op4);
+}
+
+Emitters FastJIT::compileGetEnvironmentAndStore(Emitters emit, const Inst *ip) {
+  emit = getEnvironmentHelper(
+      emit, ip->iGetEnvironmentAndStore.op1, ip->iGetEnvironmentAndStore.op2);
+  return storeToEnvironmentHelper(
+      emit,
+      ip,
+      ip->iGetEnvironmentAndStore.op1,
+      ip->iGetEnvironmentAndStore.op3,
+      ip->iGetEnvironmentAndStore.op4,
+      false);
+}
+
+Emitters FastJIT::compileGetEnvironmentAndStoreNP(
+    Emitters emit,
+    const Inst *ip) {
+  emit = getEnvironmentHelper(
+      emit,
+      ip->iGetEnvironmentAndStoreNP.op1,
+      ip->iGetEnvironmentAndStoreNP.op2);
+  return storeToEnvironmentHelper(
+      emit,
+      ip,
+      ip->iGetEnvironmentAndStoreNP.op1,
+      ip->iGetEnvironmentAndStoreNP.op3,
+      ip->iGetEnvironmentAndStoreNP.op4,
+      true);
+}
+
+Emitters FastJIT::compileNewObject(Emitters emit, const Inst *ip) {
+  emit.fast = callExternalWithReturnedVal(
+      emit.fast, (void *)externNewObject, ip->iNewObject.op1);
+  return emit;
+}
+
+Emitters FastJIT::compileNewArray(Emitters emit, const Inst *ip) {
+  emit.fast.movImm(ip->iNewArray.op2, Reg::x1);
+  emit.fast =
+      callExternal(emit.fast, (void *)externNewArray, ip->iNewArray.op1, ip);
+  return emit;
+}
+
+Emitters FastJIT::compilePutByVal(Emitters emit, const Inst *ip) {
+  // object -> arg2
+  emit.fast = leaHermesReg(emit.fast, ip->iPutByVal.op1, Reg::x1);
+  // nameVal -> arg3
+  emit.fast = leaHermesReg(emit.fast, ip->iPutByVal.op2, Reg::x2);
+  // property value -> arg4
+  emit.fast = leaHermesReg(emit.fast, ip->iPutByVal.op3, Reg::x3);
+  // PropOpFlags -> arg5
+  emit.fast.movImm(defaultPropOpFlags().getRaw(), Reg::x4);
+
+  emit.fast = callExternalNoReturnedVal(emit.fast, (void *)externPutByVal, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileTypeOf(Emitters emit, const Inst *ip) {
+  emit.fast = leaHermesReg(emit.fast, ip->iTypeOf.op2, Reg::x1);
+  emit.fast = callExternalWithReturnedVal(
+      emit.fast, (void *)externTypeOf, ip->iTypeOf.op1);
+  return emit;
+}
+
+Emitters FastJIT::compileToNumber(Emitters emit, const Inst *ip) {
+  // isNumber op2?
+  emit.fast = isNumber(emit.fast, ip->iToNumber.op2, emit.slow.current());
+  emit = compileMov(emit, ip, ip->iToNumber.op1, ip->iToNumber.op2);
+
+  // Slow path.
+  // &Source -> arg2.
+  emit.slow = leaHermesReg(emit.slow, ip->iToNumber.op2, Reg::x1);
+  emit.slow = callExternal(
+      emit.slow, (void *)slowPathToNumber, ip->iToNumber.op1, ip);
+  emit.slow.b(emit.fast.current());
+  return emit;
+}
+
+Emitters FastJIT::compileToInt32(Emitters emit, const Inst *ip) {
+  emit.fast = leaHermesReg(emit.fast, ip->iToInt32.op2, Reg::x1);
+  emit.fast =
+      callExternal(emit.fast, (void *)externToInt32, ip->iToInt32.op1, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileAddEmptyString(Emitters emit, const Inst *ip) {
+  // isString op2?
+  emit.fast =
+      movHermesRegToNativeReg(emit.fast, ip->iAddEmptyString.op2, Reg::x9);
+  emit.fast.lsrImm(Reg::x9, HermesValue::kNumDataBits, Reg::x10);
+  emit.fast.movImm(StrTag, Reg::x11);
+  emit.fast.cmpRegW(Reg::x10, Reg::x11);
+  emit.fast = cjmpFar(emit.fast, Cond::NE, emit.slow.current());
+  emit = compileMov(
+      emit, ip, ip->iAddEmptyString.op1, ip->iAddEmptyString.op2);
+
+  // Slow path.
+  // &Source -> arg2.
+  emit.slow = leaHermesReg(emit.slow, ip->iAddEmptyString.op2, Reg::x1);
+  emit.slow = callExternal(
+      emit.slow,
+      (void *)slowPathAddEmptyString,
+      ip->iAddEmptyString.op1,
+      ip);
+  emit.slow.b(emit.fast.current());
+  return emit;
+}
+
+Emitters FastJIT::compileStringConcat(Emitters emit, const Inst *ip) {
+  // stack pointer -> arg2
+  emit.fast.ldr(RegRuntime, RuntimeOffsets::stackPointer, Reg::x1);
+  // count (uint32_t) -> arg3
+  emit.fast.movImm(ip->iStringConcat.op2, Reg::x2);
+
+  emit.fast = callExternal(
+      emit.fast, (void *)externStringConcat, ip->iStringConcat.op1, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileAsyncBreakCheck(Emitters emit, const Inst *ip) {
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  emit.fast.ldrb(RegRuntime, RuntimeOffsets::asyncBreakRequestFlag, Reg::x9);
+  emit.fast.cmpImmW(Reg::x9, 0);
+  emit.fast = cjmpFar(emit.fast, Cond::NE, slowPathAddr);
+
+  // Slow path: an async break was requested. Async debugger requests can't
+  // be serviced here, see Interpreter::handleAsyncBreak.
+  emit.slow = callExternalNoReturnedVal(
+      emit.slow, (void *)Interpreter::handleAsyncBreak, ip);
+  emit.slow.b(emit.fast.current());
+  return emit;
+}
+
+Emitters FastJIT::compileProfilePoint(Emitters emit, const Inst *ip) {
+#ifdef HERMESVM_PROFILER_BB
+  emit.fast.movRegToReg(RegRuntime, Reg::x0);
+  emit.fast.movImm((uint64_t)codeBlock_, Reg::x1);
+  emit.fast.movImm(ip->iProfilePoint.op1, Reg::x2);
+  emit.fast = callAbsolute(emit.fast, (void *)externProfilePoint);
+#endif
+  return emit;
+}
+
+Emitters FastJIT::compileDebugger(Emitters emit, const Inst *ip) {
+#ifdef HERMES_ENABLE_DEBUGGER
+  // The debugger takes over the interpreter loop to pause, so the rest of a
+  // function with a debugger statement runs in the interpreter when it may be
+  // attached.
+  return emitDeopt(emit, ip);
+#else
+  return emit;
+#endif
+}
+
+Emitters FastJIT::compileUnreachable(Emitters emit, const Inst *ip) {
+  emit.fast.udf();
+  return emit;
+}
+
+} // namespace arm64
+} // namespace vm
+} // namespace hermes
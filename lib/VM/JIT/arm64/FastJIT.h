@@ -0,0 +1,470 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_ARM64_FASTJIT_H
+#define HERMES_VM_JIT_ARM64_FASTJIT_H
+
+#include "hermes/BCGen/HBC/StackFrameLayout.h"
+#include "hermes/VM/JIT/CompileQueue.h"
+#include "hermes/VM/JIT/arm64/Emitter.h"
+#include "hermes/VM/JIT/arm64/JIT.h"
+#include "hermes/VM/JSObject.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/Debug.h"
+
+namespace hermes {
+namespace vm {
+
+using hermes::hbc::StackFrameLayout;
+using namespace hermes::inst;
+
+namespace arm64 {
+
+/// Encodes the kind of operation the relocation performs.
+enum class ReloKind : uint8_t {
+  None = 0,
+  /// The B instruction at relo.address is pointed to the target.
+  Branch26,
+};
+
+/// Information about a single relocation in the executable code.
+/// A relocation encodes an operation that is applied to the executable code
+/// after a target address becomes known.
+struct Relo {
+  /// What kind of operation the relocation performs.
+  ReloKind kind;
+  /// The location in the executable code which is updated when the relocation
+  /// is applied.
+  uint8_t *address;
+  /// The relocation target, in other words, the address that wasn't yet known
+  /// when the relocation was created.
+  unsigned targetBCBBIndex;
+
+  Relo(ReloKind kind, uint8_t *address, unsigned int targetBCBBIndex)
+      : kind(kind), address(address), targetBCBBIndex(targetBCBBIndex) {}
+  Relo() = default;
+};
+
+/// A pair of emitters for the fast path and the slow path. This class must be
+/// passed and returned only by value (for performance reasons).
+class Emitters {
+ public:
+  Emitter fast;
+  Emitter slow;
+} HERMES_ATTRIBUTE_WARN_UNUSED_RESULT_TYPE;
+
+/// Callee-save register pointing to "Runtime" throughout the function.
+constexpr auto RegRuntime = Reg::x19;
+/// Callee-save register pointing to the first local Hermes register.
+constexpr auto RegFrame = Reg::x20;
+
+/// An instance of this class is constructed to compile a single CodeBlock to
+/// native code.
+///
+/// This is a port of the x86-64 FastJIT with the same structure: it shares
+/// basic block discovery, the executable heap, RuntimeOffsets and the external
+/// calls, and emits a fast path and a slow path per instruction. The fast
+/// paths are kept simple; most instructions are external calls. Instructions
+/// that aren't supported yet make the function fall back to the interpreter.
+///
+/// Unlike on x86-64 there is no constant pool: constants and call targets are
+/// materialized with MOVZ/MOVK, which needs no data relocations and is
+/// independent of the distance between the fast and slow path heaps.
+class FastJIT {
+ public:
+  FastJIT(JITContext *context, CodeBlock *codeBlock);
+
+  /// Attempt to compile the associated CodeBlock. The CodeBlock itself is not
+  /// modified, so this can run on a background thread.
+  /// \return the compiled code, with a null body on failure.
+  JITCompiledCode compile();
+
+ private:
+  /// Raise the error flag and record an error message.
+  void error(const llvm::Twine &msg);
+
+  /// \return \p sizes rounded up to whole pages when compiling in the
+  ///   background, since the pages of other functions may be running while
+  ///   the pages of this one are writable, and \p sizes otherwise.
+  ExecHeap::SizePair roundExecSizes(ExecHeap::SizePair sizes) const;
+
+  /// Allocate executable memory using a conservative size estimate based on
+  /// bytecode length. On failure it sets the error message and flag.
+  /// \param bytecodeLength the length of the bytecode we will be compiling.
+  /// \param[out] sizes on successful exit contains the size of the two
+  ///     allocated memory blocks (fast paths and slow paths). Undefined on
+  ///     failure.
+  /// \return pointers to both allocated blocks on success.
+  llvm::Optional<ExecHeap::BlockPair> allocExec(
+      size_t bytecodeLength,
+      ExecHeap::SizePair &sizes);
+
+  /// Disassemble a range of executable code.
+  /// \param withAddr whether to dump the addresses and bytes of instructions.
+  void disassembleRange(
+      const uint8_t *from,
+      const uint8_t *to,
+      llvm::raw_ostream &OS,
+      bool withAddr) const;
+
+  /// Disassemble the entire compiled function.
+  /// \param withAddr whether to dump the addresses and bytes of instructions.
+  void disassembleResult(Emitters emit, llvm::raw_ostream &OS, bool withAddr)
+      const;
+
+  /// Apply a single relocation with an already resolved address \p target.
+  void applyRelocation(const Relo &relo, const uint8_t *target);
+
+  /// Resolve all recorded relocations and clear the relocation list \c relocs_.
+  void resolveRelocations();
+
+  /// \return true if we can safely write at least \c kMinInstructionSpace of
+  ///   bytes in the fast and slow path buffers. Set the error flag and message
+  ///   and return false otherwise.
+  inline bool checkSpace(const Emitters &emit);
+
+  /// \return the offset in bytes from RegFrame to access the specified local
+  ///   Hermes register.
+  static inline int32_t localHermesRegByteOffset(uint32_t regIndex) {
+    return sizeof(HermesValue) * StackFrameLayout::localOffset(regIndex);
+  }
+
+  /// \return the basic block's index according to the current \p ip and
+  /// the offset \p ipOffset.
+  unsigned getBBIndex(const Inst *ip, uint32_t ipOffset) {
+    uint32_t bcOffset = (const uint8_t *)ip + ipOffset - codeBlock_->begin();
+    return bcLabels_[bcOffset];
+  }
+
+  /// \return the corresponding catch handler basic block index if it exists,
+  /// or the index of the exit block if not.
+  unsigned getCatchHandlerBBIndex(const Inst *ip);
+
+  /// \return the PropOpFlags for property accesses in this function.
+  PropOpFlags defaultPropOpFlags() const {
+    return codeBlock_->isStrictMode() ? PropOpFlags().plusThrowOnError()
+                                      : PropOpFlags();
+  }
+
+  /// @name Emitters
+  /// Every emitter function receives Emitters as a first parameter
+  /// and returns it after updating it internally. Emitter function assume that
+  /// checkSpace() has already been called, except where noted.
+  /// @{
+
+  /// Emit the start of the function prologue, which sets up the native frame
+  /// and saves the callee save registers and runtime->currentFrame_.
+  Emitter emitNativeFrame(Emitter emit);
+  /// Emit the function prologue. Calls checkSpace() before emitting.
+  Emitters emitPrologue(Emitters emit);
+  /// Emit the function epilogue. Calls checkSpace() before emitting.
+  Emitters emitEpilogue(Emitters emit);
+  /// Emit the entry points at the loop headers into the slow path. Each one
+  /// sets up the native frame like the prologue, but reuses the register frame
+  /// of the interpreter, and jumps to the loop header. Calls checkSpace()
+  /// before emitting every entry point.
+  Emitters emitLoopEntries(Emitters emit);
+
+  /// Emit the code for a basic block. Calls checkSpace() before processing
+  /// every bytecode instruction.
+  Emitters compileBB(Emitters emit);
+
+  /// Leave native code at \p ip, which it cannot run, and run the rest of the
+  /// function in the interpreter. Every Hermes register lives in its slot of
+  /// the frame, so the frame is handed over as it is and the bytecode offset
+  /// of \p ip is all the interpreter needs to continue.
+  Emitters emitDeopt(Emitters emit, const Inst *ip);
+
+  /// Load hermes register \p hermesReg into native register \p nativeReg.
+  Emitter
+  movHermesRegToNativeReg(Emitter emit, uint32_t hermesReg, Reg nativeReg) {
+    emit.ldr(RegFrame, localHermesRegByteOffset(hermesReg), nativeReg);
+    return emit;
+  }
+  /// Store native register \p nativeReg into hermes register \p hermesReg.
+  Emitter
+  movNativeRegToHermesReg(Emitter emit, Reg nativeReg, uint32_t hermesReg) {
+    emit.str(nativeReg, RegFrame, localHermesRegByteOffset(hermesReg));
+    return emit;
+  }
+  /// Load the address of hermes register \p hermesReg into \p nativeReg.
+  Emitter leaHermesReg(Emitter emit, uint32_t hermesReg, Reg nativeReg) {
+    emit.addOffset(RegFrame, localHermesRegByteOffset(hermesReg), nativeReg);
+    return emit;
+  }
+
+  /// Load the specified HermesValue constant \p value into Hermes register
+  /// \p hermesReg.
+  Emitters loadHermesValueConstant(
+      Emitters emit,
+      uint32_t hermesReg,
+      HermesValue value);
+
+  /// Set the flags by comparing the higher 32 bits of hermes register
+  /// \p regIndex with the non-pointer tag \p tagHW. The whole value is left in
+  /// x9.
+  Emitter cmpSomeNPTag(Emitter emit, uint32_t regIndex, uint32_t tagHW);
+
+  /// Emit a jump to \p slowPath if hermes register \p regIndex is not a
+  /// number.
+  Emitter isNumber(Emitter emit, uint32_t regIndex, const uint8_t *slowPath);
+
+  /// Emit a call to the absolute address \p dest, clobbering x16.
+  Emitter callAbsolute(Emitter emit, const void *dest);
+
+  /// Load x0 with the Runtime register and emit a call to an external
+  /// function returning a CallResult<HermesValue>, check for exception and
+  /// store the successful result in \p resultReg.
+  /// \param ip the current ip used to find the corresponding catch handler if
+  /// an exception is returned by the external call.
+  Emitter callExternal(
+      Emitter emit,
+      const void *dest,
+      uint32_t resultReg,
+      const Inst *ip);
+
+  /// Like callExternal(), for functions returning an ExecutionStatus.
+  Emitter
+  callExternalNoReturnedVal(Emitter emit, const void *dest, const Inst *ip);
+
+  /// Load x0 with the Runtime register and emit a call to an external function
+  /// returning a HermesValue that can't fail, storing it in \p resultReg.
+  Emitter callExternalWithReturnedVal(
+      Emitter emit,
+      const void *dest,
+      uint32_t resultReg);
+
+  /// Emit a jump to a bytecode block.
+  /// Receives and \returns the fast path emitter.
+  Emitter jmpToBytecodeBB(Emitter emit, unsigned bytecodeBB);
+
+  /// Emit a jump to a bytecode block when \p cc holds. This is a B.cond over
+  /// a B, since B.cond can't reach all of the fast path heap.
+  Emitter cjmpToBytecodeBB(Emitter emit, Cond cc, unsigned bytecodeBB);
+
+  /// Emit a jump to \p target, typically between the fast and slow path
+  /// heaps, when \p cc holds.
+  Emitter cjmpFar(Emitter emit, Cond cc, const uint8_t *target);
+
+  Emitters
+  getByIdHelper(Emitters emit, const Inst *ip, bool tryProp, uint32_t idVal);
+  Emitters
+  putByIdHelper(Emitters emit, const Inst *ip, bool tryProp, uint32_t idVal);
+  Emitters callHelper(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t argCount,
+      bool isConstruct);
+  /// Store the argument registers \p argRegs of a Call1..Call4 into the
+  /// outgoing frame at the top of the stack, and emit the call.
+  Emitters
+  callNHelper(Emitters emit, const Inst *ip, llvm::ArrayRef<uint32_t> argRegs);
+  Emitters
+  loadParamHelper(Emitters emit, uint32_t resReg, uint32_t paramIndex);
+  Emitters
+  createClosureHelper(Emitters emit, const Inst *ip, uint32_t funcIndex);
+  Emitters storeToEnvironmentHelper(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t op1,
+      uint32_t idx,
+      uint32_t op3,
+      bool isNP);
+  Emitters
+  getEnvironmentHelper(Emitters emit, uint32_t resReg, uint32_t numLevels);
+  Emitters loadFromEnvironmentHelper(
+      Emitters emit,
+      uint32_t resReg,
+      uint32_t envReg,
+      uint32_t idx);
+
+  /// Emit a call to an out-of-line interpreter implementation of the whole
+  /// instruction at \p ip, see the x86-64 FastJIT.
+  Emitters compileOutOfLine(Emitters emit, const Inst *ip, void *caseFn);
+
+  /// Compile instructions with the layout (name, Reg8, Reg8, Reg8) into
+  /// a call to \p externCallAddr with the addresses of the last two operands.
+  Emitters
+  compile3RegsInst(Emitters emit, const Inst *ip, void *externCallAddr);
+
+  /// Compile a binary arithmetic instruction: a fast path on doubles when
+  /// both operands are numbers, a call to \p slowPathBinOp otherwise. If the
+  /// type feedback says the operands weren't always numbers, only the call is
+  /// emitted.
+  /// \param fpOp the FP instruction of the fast path.
+  Emitters compileBinOp(
+      Emitters emit,
+      const Inst *ip,
+      void *slowPathBinOp,
+      void (Emitter::*fpOp)(FReg, FReg, FReg));
+  /// Compile the N version of a binary arithmetic instruction, whose operands
+  /// are known to be numbers.
+  Emitters compileBinOpN(
+      Emitters emit,
+      const Inst *ip,
+      void (Emitter::*fpOp)(FReg, FReg, FReg));
+
+  /// Compile an instruction computing a Math method of one argument inline:
+  /// \p fpOp on the operand when it is a number, a call to \p slowPathMathOp
+  /// otherwise.
+  Emitters compileMathOp1(
+      Emitters emit,
+      const Inst *ip,
+      void *slowPathMathOp,
+      void (Emitter::*fpOp)(FReg, FReg));
+
+  /// Load the number operands \p reg1 and \p reg2 into d0 and d1 and compare
+  /// them.
+  Emitter fcmpHermesRegs(Emitter emit, uint32_t reg1, uint32_t reg2);
+
+  Emitters compileCondJumpN(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t ipOffset,
+      uint32_t reg1,
+      uint32_t reg2,
+      Cond cc);
+  Emitters compileCondJump(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t ipOffset,
+      uint32_t reg1,
+      uint32_t reg2,
+      Cond cc,
+      void *slowPathCall);
+  Emitters
+  compileCondOp(Emitters emit, const Inst *ip, Cond cc, void *slowPathCall);
+  Emitters compileEqJump(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t ipOffset,
+      uint32_t reg1,
+      uint32_t reg2,
+      Cond cc);
+  Emitters compileStrictEqJump(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t ipOffset,
+      uint32_t reg1,
+      uint32_t reg2,
+      Cond cc);
+  Emitters compileEqTest(Emitters emit, const Inst *ip, bool isNeq);
+  Emitters compileStrictEqTest(Emitters emit, const Inst *ip, bool isNeq);
+  Emitters compileBoolJmp(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t ipOffset,
+      uint32_t regIdx,
+      Cond cc);
+  Emitters compileJmpUndefined(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t ipOffset,
+      uint32_t regIdx);
+  Emitters compileJmp(Emitters emit, const Inst *ip, uint32_t ipOffset);
+
+  // Individual instruction emitters.
+  Emitters
+  compileMov(Emitters emit, const Inst *ip, uint32_t dst, uint32_t src);
+  Emitters
+  compileLoadConstString(Emitters emit, const Inst *ip, uint32_t stringID);
+  Emitters compileGetGlobalObject(Emitters emit, const Inst *ip);
+  Emitters compileGetNewTarget(Emitters emit, const Inst *ip);
+  Emitters compileRet(Emitters emit, const Inst *ip);
+  Emitters compileCatch(Emitters emit, const Inst *ip);
+  Emitters compileThrow(Emitters emit, const Inst *ip);
+  Emitters compileDeclareGlobalVar(Emitters emit, const Inst *ip);
+  Emitters compileCreateEnvironment(Emitters emit, const Inst *ip);
+  Emitters compileGetEnvironment(Emitters emit, const Inst *ip);
+  Emitters compileGetEnvironmentAndLoad(Emitters emit, const Inst *ip);
+  Emitters compileGetEnvironmentAndStore(Emitters emit, const Inst *ip);
+  Emitters compileGetEnvironmentAndStoreNP(Emitters emit, const Inst *ip);
+  Emitters
+  compileLoadFromEnvironment(Emitters emit, const Inst *ip, uint32_t idx);
+  Emitters compileNewObject(Emitters emit, const Inst *ip);
+  Emitters compileNewArray(Emitters emit, const Inst *ip);
+  Emitters compilePutByVal(Emitters emit, const Inst *ip);
+  Emitters compileTypeOf(Emitters emit, const Inst *ip);
+  Emitters compileToNumber(Emitters emit, const Inst *ip);
+  Emitters compileToInt32(Emitters emit, const Inst *ip);
+  Emitters compileAddEmptyString(Emitters emit, const Inst *ip);
+  Emitters compileStringConcat(Emitters emit, const Inst *ip);
+  Emitters compileAsyncBreakCheck(Emitters emit, const Inst *ip);
+  Emitters compileProfilePoint(Emitters emit, const Inst *ip);
+  Emitters compileDebugger(Emitters emit, const Inst *ip);
+  Emitters compileUnreachable(Emitters emit, const Inst *ip);
+
+  /// @}
+
+ private:
+  /// The JITContect we are associated with.
+  JITContext *const context_;
+  /// The CodeBlock we are compiling.
+  CodeBlock *const codeBlock_;
+
+  /// Minimum number of instruction buffer space we need available at any
+  /// point.
+  static constexpr unsigned kMinInstructionSpace = 1024;
+
+  /// The starting offset of every bytecode basic block in order. The last
+  /// entry is the end of the bytecode.
+  std::vector<uint32_t> bcBasicBlocks_{};
+
+  /// Map from a bytecode target label offset to a basic block index.
+  llvm::DenseMap<uint32_t, unsigned> bcLabels_{};
+
+  /// The index of every basic block that is the header of a loop, in order.
+  std::vector<unsigned> bcLoopHeaders_{};
+
+  /// The native entry point at every loop header, in the same order.
+  std::vector<uint8_t *> nativeLoopEntries_{};
+
+  /// The offset of the native code of every instruction, with its bytecode
+  /// offset, for the source lines of the perf map.
+  std::vector<std::pair<uint32_t, uint32_t>> lineTable_{};
+
+  /// The native code offset of every compiled bc BB.
+  std::vector<uint8_t *> nativeBBAddress_{};
+
+  /// Relocations.
+  std::vector<Relo> relocs_{};
+
+  /// Index of the bytecode basic block (in \c bcBasicBlocks_) that we are
+  /// currently compiling.
+  unsigned curBytecodeBBIndex_ = 0;
+
+  /// Set if an error occurred.
+  bool error_ = false;
+  /// Optional error message, set the first time we record an error.
+  std::string errorMsg_{};
+
+  // The fast-path execution region.
+  llvm::MutableArrayRef<uint8_t> fast_;
+  // The slow-path execution region.
+  llvm::MutableArrayRef<uint8_t> slow_;
+};
+
+inline bool FastJIT::checkSpace(const Emitters &emit) {
+  if (LLVM_UNLIKELY(fast_.end() - emit.fast.current() < kMinInstructionSpace)) {
+    error("fast-path overflow");
+    return false;
+  }
+  if (LLVM_UNLIKELY(slow_.end() - emit.slow.current() < kMinInstructionSpace)) {
+    error("slow-path overflow");
+    return false;
+  }
+  return true;
+}
+
+} // namespace arm64
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_ARM64_FASTJIT_H
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/arm64/JIT.h"
+
+#include "FastJIT.h"
+
+#include "hermes/Support/TraceEvents.h"
+#include "hermes/VM/JIT/JITPerfMap.h"
+#include "hermes/VM/JIT/JITProfileCache.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/RuntimeModule.h"
+
+namespace hermes {
+namespace vm {
+namespace arm64 {
+
+JITContext::JITContext(bool enable, size_t blockSize, size_t maxMemory)
+    : enabled_(enable), heap_(blockSize / 2, blockSize / 2, maxMemory) {}
+
+JITContext::~JITContext() = default;
+
+void JITContext::setBackgroundCompilation(bool background) {
+  if (!background) {
+    if (queue_) {
+      queue_->installFinished(
+          [this](CodeBlock *codeBlock, const JITCompiledCode &code) {
+            install(codeBlock, code);
+          });
+    }
+    // Joins the worker, which frees the evicted code it was handed.
+    queue_.reset();
+    return;
+  }
+  if (!queue_) {
+    queue_.reset(new CompileQueue(
+        [this](CodeBlock *codeBlock) {
+          trace::Scope traceScope(trace::Category::Compile, "jitCompile");
+          traceScope.addArg("functionID", codeBlock->getFunctionID());
+          FastJIT impl{this, codeBlock};
+          return impl.compile();
+        },
+        [this](ExecHeap::BlockPair blocks) { heap_.free(blocks); }));
+  }
+}
+
+void JITContext::cancelCompilations(RuntimeModule *runtimeModule) {
+  if (queue_)
+    queue_->cancel(runtimeModule);
+  budget_.remove(runtimeModule, [this](ExecHeap::BlockPair blocks) {
+    releaseCode(blocks);
+  });
+}
+
+void JITContext::printStats(llvm::raw_ostream &os) const {
+  os << "JIT stats:\n"
+     << "{\n"
+     << "\t\"codeBudget\": " << budget_.getLimit() << ",\n"
+     << "\t\"codeBytesUsed\": " << budget_.getBytesUsed() << ",\n"
+     << "\t\"codeBytesFreed\": " << budget_.getBytesFreed() << ",\n"
+     << "\t\"numEvicted\": " << budget_.getNumEvicted() << "\n"
+     << "}\n";
+}
+
+void JITContext::setProfileCacheDir(const std::string &dir) {
+  profileCache_.reset(dir.empty() ? nullptr : new JITProfileCache(dir));
+}
+
+void JITContext::setPerfMap(bool enable) {
+  perfMap_.reset(enable ? new JITPerfMap() : nullptr);
+}
+
+void JITContext::loadProfile(Runtime *runtime, RuntimeModule *runtimeModule) {
+  if (!enabled_ || !profileCache_)
+    return;
+  for (uint32_t functionID : profileCache_->load(runtimeModule)) {
+    // The profile may be stale if the bytecode was regenerated from the same
+    // source, e.g. with different flags.
+    if (functionID >= runtimeModule->getNumCodeBlocks())
+      continue;
+    CodeBlock *codeBlock = runtimeModule->getCodeBlockMayAllocate(functionID);
+    if (codeBlock->getRuntimeModule() != runtimeModule ||
+        codeBlock->getJITCompiled() || codeBlock->getDontJIT())
+      continue;
+    compileImpl(runtime, codeBlock);
+  }
+}
+
+void JITContext::saveProfile(RuntimeModule *runtimeModule) {
+  if (profileCache_)
+    profileCache_->save(runtimeModule);
+}
+
+JITCompiledFunctionPtr JITContext::compileImpl(
+    Runtime *runtime,
+    CodeBlock *codeBlock) {
+  if (queue_) {
+    // Finished code is only installed here, at the call or loop back-edge
+    // where the interpreter looks it up.
+    queue_->installFinished(
+        [this](CodeBlock *codeBlock, const JITCompiledCode &code) {
+          install(codeBlock, code);
+        });
+    enforceBudget(runtime);
+    if (!codeBlock->getJITCompiled() && !codeBlock->getDontJIT())
+      queue_->enqueue(codeBlock);
+    return codeBlock->getJITCompiled();
+  }
+  {
+    auto &stats = runtime->getRuntimeStats();
+    const instrumentation::RAIITimer timer{
+        "JIT Compile", stats, stats.jitCompile};
+    JITCompiledCode code;
+    {
+      trace::Scope traceScope(trace::Category::Compile, "jitCompile");
+      traceScope.addArg("functionID", codeBlock->getFunctionID());
+      FastJIT impl{this, codeBlock};
+      code = impl.compile();
+    }
+    install(codeBlock, code);
+  }
+  enforceBudget(runtime);
+  return codeBlock->getJITCompiled();
+}
+
+JITCompiledFunctionPtr JITContext::compileLoopImpl(
+    Runtime *runtime,
+    CodeBlock *codeBlock,
+    const inst::Inst *ip) {
+  if (!codeBlock->getJITCompiled())
+    compileImpl(runtime, codeBlock);
+  auto entry = codeBlock->getJITLoopEntry(codeBlock->getOffsetOf(ip));
+  // Not every backward branch has an entry, e.g. when the compilation failed
+  // or hasn't finished yet. Wait for another batch of iterations before
+  // looking again.
+  if (!entry)
+    codeBlock->clearBackEdgeCount();
+  else
+    codeBlock->markJITUsed();
+  return entry;
+}
+
+void JITContext::install(CodeBlock *codeBlock, const JITCompiledCode &code) {
+  trace::Scope traceScope(trace::Category::Compile, "jitInstall");
+  traceScope.addArg("functionID", codeBlock->getFunctionID());
+  traceScope.addArg("bytes", (int64_t)code.size);
+  code.install(codeBlock);
+  if (!code.body)
+    return;
+  budget_.add(codeBlock, code);
+  if (perfMap_)
+    perfMap_->add(codeBlock, code);
+}
+
+void JITContext::enforceBudget(Runtime *runtime) {
+  if (LLVM_LIKELY(!budget_.isOverBudget()))
+    return;
+  budget_.evict(
+      runtime, [this](ExecHeap::BlockPair blocks) { releaseCode(blocks); });
+}
+
+void JITContext::releaseCode(ExecHeap::BlockPair blocks) {
+  // In background mode the worker is the only user of the heap.
+  if (queue_)
+    queue_->releaseLater(blocks);
+  else
+    heap_.free(blocks);
+}
+
+} // namespace arm64
+} // namespace vm
+} // namespace hermes
@@ -8,8 +8,9 @@
 #include "FastJIT.h"
 
 #include "../ExternalCalls.h"
-#include "RuntimeOffsets.h"
+#include "../RuntimeOffsets.h"
 #include "hermes/Inst/InstDecode.h"
+#include "hermes/Support/OSCompat.h"
 #include "hermes/VM/JIT/DiscoverBB.h"
 #include "hermes/VM/Operations.h"
 
@@ -42,17 +43,22 @@ static constexpr uint32_t BoolTagHW =
 FastJIT::FastJIT(JITContext *context, CodeBlock *codeBlock)
     : context_(context), codeBlock_(codeBlock) {}
 
-void FastJIT::compile() {
+JITCompiledCode FastJIT::compile() {
   LLVM_DEBUG(
       llvm::dbgs() << "JIT compilation of FunctionID "
                    << codeBlock_->getFunctionID() << "\n");
 
-  discoverBasicBlocks(codeBlock_, bcBasicBlocks_, bcLabels_);
+  discoverBasicBlocks(codeBlock_, bcBasicBlocks_, bcLabels_, bcLoopHeaders_);
 
   ExecHeap::SizePair sizes;
-  auto blocks = allocRWX(codeBlock_->getOpcodeArray().size(), sizes);
+  auto blocks = allocExec(codeBlock_->getOpcodeArray().size(), sizes);
   if (!blocks)
-    return;
+    return {};
+  if (!context_->getHeap().unprotect(*blocks, sizes)) {
+    error("executable memory could not be made writable");
+    context_->getHeap().free(*blocks);
+    return {};
+  }
 
   fast_ = llvm::makeMutableArrayRef(blocks->first, sizes.first);
   slow_ = llvm::makeMutableArrayRef(blocks->second, sizes.second);
@@ -81,6 +87,7 @@ void FastJIT::compile() {
   // Emit the function epilogue.
   nativeBBAddress_[curBytecodeBBIndex_] = emit.fast.current();
   emit = emitEpilogue(emit);
+  emit = emitLoopEntries(emit);
 
   resolveRelocations();
 
@@ -88,12 +95,28 @@ void FastJIT::compile() {
   if (context_->getDumpJITCode())
     disassembleResult(emit, llvm::outs(), false);
 
+  // Code sharing pages with this function becomes executable again even if
+  // the compilation failed.
+  if (!context_->getHeap().publish(*blocks, sizes))
+    error("executable memory could not be published");
+
+  JITCompiledCode result;
   if (!error_) {
-    context_->getHeap().freeRemaining(
-        *blocks,
+    ExecHeap::SizePair keepSizes = roundExecSizes(
         {emit.fast.current() - fast_.data(),
          emit.slow.current() - slow_.data()});
-    codeBlock_->setJITCompiled((JITCompiledFunctionPtr)fast_.data());
+    context_->getHeap().freeRemaining(*blocks, keepSizes);
+    result.body = (JITCompiledFunctionPtr)fast_.data();
+    result.blocks = *blocks;
+    result.size = keepSizes.first + keepSizes.second;
+    result.codeSizes = {emit.fast.current() - fast_.data(),
+                        emit.slow.current() - slow_.data()};
+    result.lineTable = std::move(lineTable_);
+    for (unsigned i = 0, e = bcLoopHeaders_.size(); i != e; ++i) {
+      result.loopEntries.emplace_back(
+          bcBasicBlocks_[bcLoopHeaders_[i]],
+          (JITCompiledFunctionPtr)nativeLoopEntries_[i]);
+    }
 
     // Dump the heap at the end.
     LLVM_DEBUG(context_->getHeap().dump(llvm::dbgs()));
@@ -103,22 +126,30 @@ void FastJIT::compile() {
       hermes_fatal(errorMsg_.c_str());
     }
   }
+
+  return result;
 }
 
 void FastJIT::error(const llvm::Twine &msg) {
-  if (!error_)
-    codeBlock_->setDontJIT(true);
   error_ = true;
   if (errorMsg_.empty())
     errorMsg_ = msg.str();
   LLVM_DEBUG(llvm::dbgs() << "FastJIT error: " << msg << "\n");
 }
 
-llvm::Optional<ExecHeap::BlockPair> FastJIT::allocRWX(
+ExecHeap::SizePair FastJIT::roundExecSizes(ExecHeap::SizePair sizes) const {
+  if (!context_->getBackgroundCompilation())
+    return sizes;
+  const size_t pageSize = oscompat::page_size();
+  return {llvm::alignTo(sizes.first, pageSize),
+          llvm::alignTo(sizes.second, pageSize)};
+}
+
+llvm::Optional<ExecHeap::BlockPair> FastJIT::allocExec(
     size_t bytecodeLength,
     ExecHeap::SizePair &sizes) {
-  sizes = ExecHeap::SizePair{bytecodeLength * 50 + kMinInstructionSpace,
-                             bytecodeLength * 50 + kMinInstructionSpace};
+  const size_t size = bytecodeLength * 50 + kMinInstructionSpace;
+  sizes = roundExecSizes({size, size});
 
   auto blocks = context_->getHeap().alloc(sizes);
   // If the allocation failed, add a new pool, initialize it and retry.
@@ -228,24 +259,30 @@ void FastJIT::describeSlowPathSection(Emitter slow, bool data) {
 }
 #endif
 
-Emitters FastJIT::emitPrologue(Emitters emit) {
-  if (!checkSpace(emit))
-    return emit;
-
-  emit.fast.pushqReg(Reg::rbp);
-  emit.fast.movRegToReg<S::Q>(Reg::rsp, Reg::rbp);
+Emitter FastJIT::emitNativeFrame(Emitter emit) {
+  emit.pushqReg(Reg::rbp);
+  emit.movRegToReg<S::Q>(Reg::rsp, Reg::rbp);
 
   // Save callee save registers.
-  emit.fast.pushqReg(RegFrame);
-  emit.fast.pushqReg(RegRuntime);
+  emit.pushqReg(RegFrame);
+  emit.pushqReg(RegRuntime);
 
   // Move the first parameter (Runtime *) into its register.
-  emit.fast.movRegToReg<S::Q>(Reg::rdi, RegRuntime);
+  emit.movRegToReg<S::Q>(Reg::rdi, RegRuntime);
 
   // Push runtime->currentFrame into the native stack.
-  emit.fast.pushqRM(RegRuntime, Reg::NoIndex, RuntimeOffsets::currentFrame);
+  emit.pushqRM(RegRuntime, Reg::NoIndex, RuntimeOffsets::currentFrame);
   // Align the native stack to 16 bytes.
-  emit.fast.pushqReg(Reg::rcx);
+  emit.pushqReg(Reg::rcx);
+
+  return emit;
+}
+
+Emitters FastJIT::emitPrologue(Emitters emit) {
+  if (!checkSpace(emit))
+    return emit;
+
+  emit.fast = emitNativeFrame(emit.fast);
 
   // Load runtime->stackPointer_ top into RegFrame
   emit.fast.movRMToReg<S::Q>(
@@ -271,6 +308,19 @@ Emitters FastJIT::emitPrologue(Emitters emit) {
   emit.fast.movRegToRM<S::Q>(
       Reg::rax, RegRuntime, Reg::NoIndex, RuntimeOffsets::stackPointer);
 
+  // Report the entry to the function profiler, if it is enabled.
+  uint8_t *slowPathAddr = emit.slow.current();
+  emit.fast.cmpImmToRM<S::B>(
+      0, RegRuntime, Reg::NoIndex, RuntimeOffsets::functionProfilerActive);
+  emit.fast.cjump<CCode::NE, OffsetType::Int32>(slowPathAddr);
+
+  emit.slow.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
+  emit.slow.movqImmToReg((uint64_t)codeBlock_, Reg::rsi);
+  emit.slow.movRegToReg<S::Q>(RegFrame, Reg::rdx);
+  emit.slow = callAbsolute(emit.slow, (void *)externFunctionProfilerEnter);
+  emit.slow.jmp<OffsetType::Auto>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
+
   return emit;
 }
 
@@ -278,6 +328,26 @@ Emitters FastJIT::emitEpilogue(Emitters emit) {
   if (!checkSpace(emit))
     return emit;
 
+  // Report the exit to the function profiler, if it is enabled. Loop entries
+  // leave through here too, for frames the interpreter entered; the
+  // interpreter's own report of their exit is then ignored.
+  uint8_t *slowPathAddr = emit.slow.current();
+  emit.fast.cmpImmToRM<S::B>(
+      0, RegRuntime, Reg::NoIndex, RuntimeOffsets::functionProfilerActive);
+  emit.fast.cjump<CCode::NE, OffsetType::Int32>(slowPathAddr);
+
+  // The status and the result in eax and rdx are preserved. Two pushes keep
+  // the native stack aligned.
+  emit.slow.pushqReg(Reg::rax);
+  emit.slow.pushqReg(Reg::rdx);
+  emit.slow.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
+  emit.slow.movRegToReg<S::Q>(RegFrame, Reg::rsi);
+  emit.slow = callAbsolute(emit.slow, (void *)externFunctionProfilerExit);
+  emit.slow.popqReg(Reg::rdx);
+  emit.slow.popqReg(Reg::rax);
+  emit.slow.jmp<OffsetType::Auto>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
+
   // Restore the VM stack pointer: runtime->stackPointer = RegFrame.
   emit.fast.movRegToRM<S::Q>(
       RegFrame, RegRuntime, Reg::NoIndex, RuntimeOffsets::stackPointer);
@@ -297,6 +367,25 @@ Emitters FastJIT::emitEpilogue(Emitters emit) {
   return emit;
 }
 
+Emitters FastJIT::emitLoopEntries(Emitters emit) {
+  nativeLoopEntries_.clear();
+  for (unsigned bcBB : bcLoopHeaders_) {
+    if (!checkSpace(emit))
+      return emit;
+
+    nativeLoopEntries_.push_back(emit.slow.current());
+    emit.slow = emitNativeFrame(emit.slow);
+    // The interpreter has already set up runtime->currentFrame_ and allocated
+    // its registers, so only RegFrame needs to be loaded. The epilogue leaves
+    // the frame in place for the interpreter to pop.
+    emit.slow.movRMToReg<S::Q>(
+        RegRuntime, Reg::NoIndex, RuntimeOffsets::currentFrame, RegFrame);
+    emit.slow.jmp<OffsetType::Auto>(nativeBBAddress_[bcBB]);
+    describeSlowPathSection(emit.slow, false);
+  }
+  return emit;
+}
+
 // Calculate the address of the next instruction given the name of the current
 // one.
 #define NEXTINST(name) ((const Inst *)(&ip->i##name + 1))
@@ -311,6 +400,11 @@ Emitters FastJIT::compileBB(Emitters emit) {
     if (!checkSpace(emit))
       return emit;
 
+    if (context_->hasPerfMap()) {
+      lineTable_.emplace_back(
+          emit.fast.current() - fast_.data(), codeBlock_->getOffsetOf(ip));
+    }
+
     LLVM_DEBUG(llvm::dbgs() << ";   " << decodeInstruction(ip) << "\n");
 #ifndef NDEBUG
     auto sav = emit;
@@ -458,6 +552,13 @@ Emitters FastJIT::compileBB(Emitters emit) {
     ip = NEXTINST(name);                                     \
     break
 
+/// Compile an instruction implemented out of line by Interpreter::case<name>.
+#define CASE_OUTOFLINE(name)                                            \
+  case OpCode::name:                                                    \
+    emit = compileOutOfLine(emit, ip, (void *)Interpreter::case##name); \
+    ip = NEXTINST(name);                                                \
+    break
+
       CASE(DeclareGlobalVar);
       CASE(CreateEnvironment);
       CASE(CreateClosure);
@@ -492,6 +593,7 @@ Emitters FastJIT::compileBB(Emitters emit) {
       CASE(MovLong);
       CASE(ToNumber);
       CASE(AddEmptyString);
+      CASE(StringConcat);
       CASE(Ret);
 
       JCOND(JLess, CCode::B, slowPathLess);
@@ -574,6 +676,9 @@ Emitters FastJIT::compileBB(Emitters emit) {
       CASE_3REG(BitOr);
       CASE_3REG(BitXor);
       CASE(GetEnvironment);
+      CASE(GetEnvironmentAndLoad);
+      CASE(GetEnvironmentAndStore);
+      CASE(GetEnvironmentAndStoreNP);
       CASE(Catch);
       CASE(Negate);
       CASE(GetPNameList);
@@ -581,19 +686,67 @@ Emitters FastJIT::compileBB(Emitters emit) {
       CASE(ReifyArguments);
       CASE(GetArgumentsPropByVal);
       CASE(BitNot);
+      CASE(MathAbs);
+      CASE(MathCeil);
+      CASE(MathFloor);
+      CASE(MathSqrt);
+      CASE(MathMin);
+      CASE(MathMax);
       CASE(GetArgumentsLength);
       CASE_3REG(IsIn);
       CASE_3REG(InstanceOf);
       CASE(CreateRegExp);
+      CASE(Call1);
+      CASE(Call2);
+      CASE(Call3);
+      CASE(Call4);
+      CASE(CallDirect);
+      CASE(CallDirectLongIndex);
+      CASE(CallBuiltin);
+      CASE(CreateClosureLongIndex);
+      CASE(CreateGeneratorClosure);
+      CASE(CreateGeneratorClosureLongIndex);
+      CASE(CreateGenerator);
+      CASE(CreateGeneratorLongIndex);
+      CASE(GetNewTarget);
+      CASE(LoadParamLong);
+      CASE(ToInt32);
+      CASE(NewObjectWithParent);
+      CASE_WITH_SUFFIX(PutNewOwnNEById, , op3);
+      CASE_WITH_SUFFIX(PutNewOwnNEById, Long, op3);
+      CASE(DelById);
+      CASE(DelByIdLong);
+      CASE_OUTOFLINE(PutOwnByVal);
+      CASE_OUTOFLINE(PutOwnGetterSetterByVal);
+      CASE_OUTOFLINE(DirectEval);
+      CASE_OUTOFLINE(GetByIdSlot);
+      CASE_OUTOFLINE(DataViewGet);
+      CASE_OUTOFLINE(DataViewSet);
+      CASE(SwitchImm);
+      CASE(SwitchStr);
+      CASE(SwitchSparse);
+      CASE(ThrowIfUndefinedInst);
+      CASE(AsyncBreakCheck);
+      CASE(ProfilePoint);
+      CASE(Debugger);
+      CASE(Unreachable);
 
       default:
-        error(
-            llvm::Twine("unsupported opcode ") + llvm::Twine((int)ip->opCode)
+        // Nothing would run in native code before an unsupported first
+        // instruction.
+        if (ip == reinterpret_cast<const Inst *>(codeBlock_->begin())) {
+          error(
+              llvm::Twine("unsupported opcode ") +
+              llvm::Twine((int)ip->opCode)
 #ifndef NDEBUG
-            + " " + getOpCodeString(ip->opCode)
+              + " " + getOpCodeString(ip->opCode)
 #endif
-        );
-        return emit;
+          );
+          return emit;
+        }
+        // The interpreter runs the rest of the function, so the rest of the
+        // basic block is never reached.
+        return emitDeopt(emit, ip);
     }
 #undef CASE
 
@@ -611,6 +764,25 @@ Emitters FastJIT::compileBB(Emitters emit) {
   return emit;
 }
 
+Emitters FastJIT::emitDeopt(Emitters emit, const Inst *ip) {
+  // runtime -> arg1
+  emit.fast.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
+  // codeBlock -> arg2
+  emit = loadConstantAddrIntoNativeReg(emit, codeBlock_, Reg::rsi);
+  // offset -> arg3
+  emit.fast.movImmToReg<S::L>(codeBlock_->getOffsetOf(ip), Reg::edx);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externDeoptimize, constAddr);
+  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
+  applyRIP32Offset(emit.fast.current(), constAddr);
+
+  // The status and the result of the function are in eax and rdx, as the
+  // epilogue expects them.
+  emit.fast = jmpToBytecodeBB(emit.fast, bcBasicBlocks_.size() - 1);
+  return emit;
+}
+
 Emitter FastJIT::getConstant(Emitter slow, uint64_t cval, uint8_t *&constAddr) {
   // Find or emit the actual constant as a number.
   auto it = doubleConstants_.find(cval);
@@ -804,33 +976,117 @@ Emitter FastJIT::callExternalWithReturnedVal(
   return emit;
 }
 
+Emitter FastJIT::callCompiledInline(
+    Emitter emit,
+    const Inst *ip,
+    uint32_t argCount,
+    bool isConstruct,
+    const uint8_t *slowPathAddr) {
+  // Clearing the object tag leaves the pointer if the value is an object, and
+  // some of the tag bits otherwise.
+  emit = movHermesRegToNativeReg(emit, ip->iCall.op2, Reg::rax);
+  emit.movqImmToReg((uint64_t)ObjectTag << HermesValue::kNumDataBits, Reg::rdx);
+  emit.xorRegToReg<S::Q>(Reg::rdx, Reg::rax);
+  emit.movRegToReg<S::Q>(Reg::rax, Reg::rcx);
+  emit.shrImm8ToReg(HermesValue::kNumDataBits, Reg::rcx);
+  emit.cjump<CCode::NZ, OffsetType::Int32>(slowPathAddr);
+
+  // Only a plain JSFunction is called directly; subclasses such as generator
+  // functions have their own VTable.
+  emit.movqImmToReg((uint64_t)&JSFunction::vt.base.base, Reg::rdx);
+  emit.cmpRmToReg<S::Q>(Reg::rax, Reg::NoIndex, GCCellOffsets::vtp, Reg::rdx);
+  emit.cjump<CCode::NE, OffsetType::Int32>(slowPathAddr);
+
+  // The body is read at every call, since it is only installed once the
+  // callee gets hot and may be evicted later.
+  emit.movRMToReg<S::Q>(
+      Reg::rax, Reg::NoIndex, JSFunctionOffsets::codeBlock, Reg::rcx);
+  emit.movRMToReg<S::Q>(
+      Reg::rcx, Reg::NoIndex, CodeBlockOffsets::JITCompiled, Reg::rdx);
+  emit.testRegToReg<S::Q>(Reg::rdx, Reg::rdx);
+  emit.cjump<CCode::Z, OffsetType::Int32>(slowPathAddr);
+  emit.movImmToRM<S::B>(1, Reg::rcx, Reg::NoIndex, CodeBlockOffsets::JITUsed);
+
+  // Set up the frame like externCall() does.
+  emit.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::stackPointer, Reg::rsi);
+  auto storeFrameSlot = [&emit](int32_t slot, Reg reg) {
+    emit.movRegToRM<S::Q>(
+        reg, Reg::rsi, Reg::NoIndex, sizeof(HermesValue) * slot);
+  };
+  emit.movqImmToReg(
+      HermesValue::encodeNativePointer(nullptr).getRaw(), Reg::rcx);
+  storeFrameSlot(StackFrameLayout::SavedCodeBlock, Reg::rcx);
+  emit.orRegToReg<S::Q>(RegFrame, Reg::rcx);
+  storeFrameSlot(StackFrameLayout::PreviousFrame, Reg::rcx);
+  emit.movqImmToReg(HermesValue::encodeNativePointer(ip).getRaw(), Reg::rcx);
+  storeFrameSlot(StackFrameLayout::SavedIP, Reg::rcx);
+  emit.movqImmToReg(
+      HermesValue::encodeNativeUInt32(argCount - 1).getRaw(), Reg::rcx);
+  storeFrameSlot(StackFrameLayout::ArgCount, Reg::rcx);
+  emit = movHermesRegToNativeReg(emit, ip->iCall.op2, Reg::rax);
+  storeFrameSlot(StackFrameLayout::CalleeClosureOrCB, Reg::rax);
+  if (!isConstruct) {
+    emit.movqImmToReg(
+        HermesValue::encodeUndefinedValue().getRaw(), Reg::rax);
+  }
+  storeFrameSlot(StackFrameLayout::NewTarget, Reg::rax);
+#ifdef HERMES_ENABLE_DEBUGGER
+  emit.movqImmToReg((uint64_t)ip, Reg::rcx);
+  emit.movRegToRM<S::Q>(
+      Reg::rcx, RegRuntime, Reg::NoIndex, RuntimeOffsets::savedIP);
+#endif
+
+  emit.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
+  emit.callReg(Reg::rdx);
+  return emit;
+}
+
 Emitters FastJIT::callHelper(
     Emitters emit,
     const Inst *ip,
     uint32_t argCount,
     bool isConstruct) {
+  uint8_t *constAddr;
+  emit.slow = getConstant(
+      emit.slow,
+      isConstruct ? (void *)externConstruct : (void *)externCall,
+      constAddr);
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  emit.fast =
+      callCompiledInline(emit.fast, ip, argCount, isConstruct, slowPathAddr);
+
+  // Other callees, and JSFunctions that are interpreted, are called through
+  // the runtime.
   //&callable -> arg2
-  emit.fast = leaHermesReg(emit.fast, ip->iCall.op2, Reg::rsi);
+  emit.slow = leaHermesReg(emit.slow, ip->iCall.op2, Reg::rsi);
 
   // argCount (uint32_t) -> arg3
-  emit.fast.movImmToReg<S::L>(argCount, Reg::edx);
+  emit.slow.movImmToReg<S::L>(argCount, Reg::edx);
 
   // stack pointer -> arg4
-  emit.fast.movRMToReg<S::Q>(
+  emit.slow.movRMToReg<S::Q>(
       RegRuntime, Reg::NoIndex, RuntimeOffsets::stackPointer, Reg::rcx);
 
   // ip -> arg5
-  emit = loadConstantAddrIntoNativeReg(emit, (void *)ip, Reg::r8);
+  emit.slow.movqImmToReg((uint64_t)ip, Reg::r8);
 
   // currentFrame -> arg6
-  emit.fast.movRegToReg<S::Q>(RegFrame, Reg::r9);
+  emit.slow.movRegToReg<S::Q>(RegFrame, Reg::r9);
 
-  uint8_t *constAddr;
-  emit.slow = getConstant(
-      emit.slow,
-      isConstruct ? (void *)externConstruct : (void *)externCall,
-      constAddr);
-  emit.fast = callExternal(emit.fast, constAddr, ip->iCall.op1, ip);
+  // Runtime -> arg1.
+  emit.slow.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
+  emit.slow.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
+  applyRIP32Offset(emit.slow.current(), constAddr);
+  emit.slow.jmp<OffsetType::Auto>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
+
+  // Both paths leave the status in eax and the result in rdx.
+  emit.fast.testRegToReg<S::L>(Reg::eax, Reg::eax);
+  emit.fast = cjmpToBytecodeBB(
+      emit.fast, CJumpOp<CCode::Z>::OP, getCatchHandlerBBIndex(ip));
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rdx, ip->iCall.op1);
   return emit;
 }
 
@@ -847,6 +1103,100 @@ Emitters FastJIT::compileConstructLong(Emitters emit, const Inst *ip) {
   return callHelper(emit, ip, ip->iConstructLong.op3, true);
 }
 
+Emitters FastJIT::callNHelper(
+    Emitters emit,
+    const Inst *ip,
+    llvm::ArrayRef<uint32_t> argRegs) {
+  // The interpreter writes the arguments into the outgoing frame right before
+  // the call, starting with "thisArg".
+  emit.fast.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::stackPointer, Reg::rcx);
+  int32_t argIndex = -1;
+  for (uint32_t argReg : argRegs) {
+    emit.fast = movHermesRegToNativeReg(emit.fast, argReg, Reg::rax);
+    emit.fast.movRegToRM<S::Q>(
+        Reg::rax,
+        Reg::rcx,
+        Reg::NoIndex,
+        sizeof(HermesValue) * StackFrameLayout::argOffset(argIndex++));
+  }
+  return callHelper(emit, ip, argRegs.size(), false);
+}
+
+Emitters FastJIT::compileCall1(Emitters emit, const Inst *ip) {
+  return callNHelper(emit, ip, {ip->iCall1.op3});
+}
+Emitters FastJIT::compileCall2(Emitters emit, const Inst *ip) {
+  return callNHelper(emit, ip, {ip->iCall2.op3, ip->iCall2.op4});
+}
+Emitters FastJIT::compileCall3(Emitters emit, const Inst *ip) {
+  return callNHelper(
+      emit, ip, {ip->iCall3.op3, ip->iCall3.op4, ip->iCall3.op5});
+}
+Emitters FastJIT::compileCall4(Emitters emit, const Inst *ip) {
+  return callNHelper(
+      emit,
+      ip,
+      {ip->iCall4.op3, ip->iCall4.op4, ip->iCall4.op5, ip->iCall4.op6});
+}
+
+Emitters
+FastJIT::callDirectHelper(Emitters emit, const Inst *ip, uint32_t funcIndex) {
+  // Code blocks are allocated in C heap, so the callee can be embedded.
+  // &calleeCodeBlock -> arg2
+  CodeBlock *calleeBlock =
+      codeBlock_->getRuntimeModule()->getCodeBlockMayAllocate(funcIndex);
+  emit = loadConstantAddrIntoNativeReg(emit, calleeBlock, Reg::rsi);
+
+  // argCount (uint32_t) -> arg3
+  emit.fast.movImmToReg<S::L>(ip->iCallDirect.op2, Reg::edx);
+
+  // stack pointer -> arg4
+  emit.fast.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::stackPointer, Reg::rcx);
+
+  // ip -> arg5
+  emit = loadConstantAddrIntoNativeReg(emit, (void *)ip, Reg::r8);
+
+  // currentFrame -> arg6
+  emit.fast.movRegToReg<S::Q>(RegFrame, Reg::r9);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externCallDirect, constAddr);
+  emit.fast = callExternal(emit.fast, constAddr, ip->iCallDirect.op1, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileCallDirect(Emitters emit, const Inst *ip) {
+  return callDirectHelper(emit, ip, ip->iCallDirect.op3);
+}
+Emitters FastJIT::compileCallDirectLongIndex(Emitters emit, const Inst *ip) {
+  return callDirectHelper(emit, ip, ip->iCallDirectLongIndex.op3);
+}
+
+Emitters FastJIT::compileCallBuiltin(Emitters emit, const Inst *ip) {
+  // builtin index -> arg2
+  emit.fast.movImmToReg<S::L>(ip->iCallBuiltin.op2, Reg::esi);
+
+  // argCount (uint32_t) -> arg3
+  emit.fast.movImmToReg<S::L>(ip->iCallBuiltin.op3, Reg::edx);
+
+  // stack pointer -> arg4
+  emit.fast.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::stackPointer, Reg::rcx);
+
+  // ip -> arg5
+  emit = loadConstantAddrIntoNativeReg(emit, (void *)ip, Reg::r8);
+
+  // currentFrame -> arg6
+  emit.fast.movRegToReg<S::Q>(RegFrame, Reg::r9);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externCallBuiltin, constAddr);
+  emit.fast = callExternal(emit.fast, constAddr, ip->iCallBuiltin.op1, ip);
+  return emit;
+}
+
 Emitter FastJIT::jmpToBytecodeBB(Emitter emit, unsigned bytecodeBB) {
   // If jumping to the next BB, do nothing.
   if (bytecodeBB == curBytecodeBBIndex_ + 1)
@@ -881,6 +1231,11 @@ Emitters FastJIT::compileCondOp(
     const Inst *ip,
     uint8_t opCode,
     void *slowPathCall) {
+  // The interpreter has run this instruction on operands that aren't
+  // numbers, so skip the number fast path and call the generic one.
+  if (codeBlock_->sawNonNumberArith(codeBlock_->getOffsetOf(ip)))
+    return compile3RegsInst(emit, ip, slowPathCall);
+
   uint8_t *slowPathConstAddr;
   emit.slow = getConstant(emit.slow, slowPathCall, slowPathConstAddr);
   uint8_t *slowPathAddr = emit.slow.current();
@@ -928,38 +1283,111 @@ FastJIT::compileCondOpN(Emitters emit, const Inst *ip, uint8_t opCode) {
   return emit;
 }
 
-inline Emitters FastJIT::getByIdHelper(
-    Emitters emit,
+Emitter FastJIT::checkPropertyCache(
+    Emitter emit,
+    uint32_t objReg,
+    const PropertyCacheEntry *cacheEntry,
+    uint8_t *slowPathAddr) {
+  using ClassStorageType = PropertyCacheEntry::ClassStorageType;
+  constexpr S classSize = sizeof(ClassStorageType) == 8 ? S::Q : S::L;
+
+  // Clearing the object tag leaves the pointer if the value is an object, and
+  // some of the tag bits otherwise.
+  emit = movHermesRegToNativeReg(emit, objReg, Reg::rax);
+  emit.movqImmToReg((uint64_t)ObjectTag << HermesValue::kNumDataBits, Reg::rdx);
+  emit.xorRegToReg<S::Q>(Reg::rdx, Reg::rax);
+  emit.movRegToReg<S::Q>(Reg::rax, Reg::rcx);
+  emit.shrImm8ToReg(HermesValue::kNumDataBits, Reg::rcx);
+  emit.cjump<CCode::NZ, OffsetType::Int32>(slowPathAddr);
+
+  // The entry is updated by the slow path, so it is read at every access
+  // rather than baked into the code.
+  emit.movqImmToReg((uint64_t)cacheEntry, Reg::rdx);
+  emit.movRMToReg<classSize>(
+      Reg::rax, Reg::NoIndex, JSObjectOffsets::clazz, Reg::rcx);
+  emit.cmpRmToReg<classSize>(
+      Reg::rdx,
+      Reg::NoIndex,
+      offsetof(PropertyCacheEntry, clazz),
+      Reg::rcx);
+  emit.cjump<CCode::NE, OffsetType::Int32>(slowPathAddr);
+
+  // Only the direct slots are accessed inline.
+  emit.movRMToReg<S::L>(
+      Reg::rdx, Reg::NoIndex, offsetof(PropertyCacheEntry, slot), Reg::ecx);
+  emit.cmpImmToRM<S::L, ScaleRegAccess>(
+      JSObject::DIRECT_PROPERTY_SLOTS, Reg::ecx, Reg::none, 0);
+  emit.cjump<CCode::AE, OffsetType::Int32>(slowPathAddr);
+
+  // Count the hit, as the interpreter does.
+  emit.addImmToRM<S::SLQ>(
+      1, Reg::rdx, Reg::NoIndex, offsetof(PropertyCacheEntry, hits));
+  return emit;
+}
+
+Emitter FastJIT::callGetById(
+    Emitter emit,
     const Inst *ip,
     bool tryProp,
-    uint32_t idVal) {
+    uint32_t idVal,
+    const uint8_t *constAddr) {
   auto defaultPropOpFlags = codeBlock_->isStrictMode()
       ? PropOpFlags().plusThrowOnError()
       : PropOpFlags();
   auto flags =
       !tryProp ? defaultPropOpFlags : defaultPropOpFlags.plusMustExist();
   // PropOpFlags  -> arg2
-  emit.fast.movImmToReg<S::L>(flags.getRaw(), Reg::esi);
+  emit.movImmToReg<S::L>(flags.getRaw(), Reg::esi);
 
   // IdentifierID (uint32_t) -> arg3
   // The symbol must already exist in the string id map, so we could just pass
   // the IdentifierID
-  emit.fast.movImmToReg<S::L>(
+  emit.movImmToReg<S::L>(
       codeBlock_->getRuntimeModule()
           ->getSymbolIDMustExist(idVal)
           .unsafeGetIndex(),
       Reg::edx);
   //&target -> arg4
-  emit.fast = leaHermesReg(emit.fast, ip->iGetById.op2, Reg::rcx);
+  emit = leaHermesReg(emit, ip->iGetById.op2, Reg::rcx);
   // cacheIdx -> arg5
   // cacheIdx is uint8_t, but it's more efficient to just set whole 32 bits
-  emit.fast.movImmToReg<S::L>(ip->iGetById.op3, Reg::r8d);
+  emit.movImmToReg<S::L>(ip->iGetById.op3, Reg::r8d);
   // current code block -> arg6
-  emit = loadConstantAddrIntoNativeReg(emit, codeBlock_, Reg::r9);
+  emit.movqImmToReg((uint64_t)codeBlock_, Reg::r9);
 
+  return callExternal(emit, constAddr, ip->iGetById.op1, ip);
+}
+
+inline Emitters FastJIT::getByIdHelper(
+    Emitters emit,
+    const Inst *ip,
+    bool tryProp,
+    uint32_t idVal) {
   uint8_t *constAddr;
   emit.slow = getConstant(emit.slow, (void *)externGetById, constAddr);
-  emit.fast = callExternal(emit.fast, constAddr, ip->iGetById.op1, ip);
+
+  uint8_t cacheIdx = ip->iGetById.op3;
+  if (cacheIdx == hbc::PROPERTY_CACHING_DISABLED) {
+    emit.fast = callGetById(emit.fast, ip, tryProp, idVal, constAddr);
+    return emit;
+  }
+
+  // Inline cache hit: load the cached direct slot.
+  uint8_t *slowPathAddr = emit.slow.current();
+  emit.fast = checkPropertyCache(
+      emit.fast,
+      ip->iGetById.op2,
+      codeBlock_->getReadCacheEntry(cacheIdx),
+      slowPathAddr);
+  emit.fast.movRMToReg<S::Q, 8>(
+      Reg::rax, Reg::rcx, JSObjectOffsets::directProps, Reg::rax);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, ip->iGetById.op1);
+
+  // Miss: the shared helper, which also updates the cache entry.
+  emit.slow = callGetById(emit.slow, ip, tryProp, idVal, constAddr);
+  emit.slow.jmp<OffsetType::Auto>(emit.fast.current());
+
+  describeSlowPathSection(emit.slow, false);
   return emit;
 }
 
@@ -979,37 +1407,74 @@ Emitters FastJIT::compileTryGetByIdLong(Emitters emit, const Inst *ip) {
   return getByIdHelper(emit, ip, true, ip->iTryGetByIdLong.op4);
 }
 
-inline Emitters FastJIT::putByIdHelper(
-    Emitters emit,
+Emitter FastJIT::callPutById(
+    Emitter emit,
     const Inst *ip,
     bool tryProp,
-    uint32_t idVal) {
+    uint32_t idVal,
+    const uint8_t *constAddr) {
   auto defaultPropOpFlags = codeBlock_->isStrictMode()
       ? PropOpFlags().plusThrowOnError()
       : PropOpFlags();
   auto flags =
       !tryProp ? defaultPropOpFlags : defaultPropOpFlags.plusMustExist();
   // PropOpFlags  -> arg2
-  emit.fast.movImmToReg<S::L>(flags.getRaw(), Reg::esi);
+  emit.movImmToReg<S::L>(flags.getRaw(), Reg::esi);
   // IdentifierID (uint32_t) -> arg3
   // The symbol must already exist in the map, so we could just pass the
   // IdentifierID
-  emit.fast.movImmToReg<S::L>(
+  emit.movImmToReg<S::L>(
       codeBlock_->getRuntimeModule()
           ->getSymbolIDMustExist(idVal)
           .unsafeGetIndex(),
       Reg::edx);
   //&target -> arg4
-  emit.fast = leaHermesReg(emit.fast, ip->iPutById.op1, Reg::rcx);
+  emit = leaHermesReg(emit, ip->iPutById.op1, Reg::rcx);
   //&prop -> arg5
-  emit.fast = leaHermesReg(emit.fast, ip->iPutById.op2, Reg::r8);
+  emit = leaHermesReg(emit, ip->iPutById.op2, Reg::r8);
   // cacheIdx -> arg6
   // cacheIdx is uint8_t, but it's more efficient to just set whole 32 bits
-  emit.fast.movImmToReg<S::L>(ip->iPutById.op3, Reg::r9d);
+  emit.movImmToReg<S::L>(ip->iPutById.op3, Reg::r9d);
 
+  return callExternalNoReturnedVal(emit, constAddr, ip);
+}
+
+inline Emitters FastJIT::putByIdHelper(
+    Emitters emit,
+    const Inst *ip,
+    bool tryProp,
+    uint32_t idVal) {
   uint8_t *constAddr;
   emit.slow = getConstant(emit.slow, (void *)externPutById, constAddr);
-  emit.fast = callExternalNoReturnedVal(emit.fast, constAddr, ip);
+
+  uint8_t cacheIdx = ip->iPutById.op3;
+  if (cacheIdx == hbc::PROPERTY_CACHING_DISABLED) {
+    emit.fast = callPutById(emit.fast, ip, tryProp, idVal, constAddr);
+    return emit;
+  }
+
+  // Inline cache hit: store into the cached direct slot. Storing a pointer
+  // needs a write barrier, so that is left to the slow path.
+  uint8_t *slowPathAddr = emit.slow.current();
+  emit.fast = cmpSomeNPTag(
+      emit.fast,
+      ip->iPutById.op2,
+      FirstPointerTag << (HermesValue::kNumDataBits - 32));
+  emit.fast.cjump<CCode::AE, OffsetType::Int32>(slowPathAddr);
+  emit.fast = checkPropertyCache(
+      emit.fast,
+      ip->iPutById.op1,
+      codeBlock_->getWriteCacheEntry(cacheIdx),
+      slowPathAddr);
+  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iPutById.op2, Reg::rdx);
+  emit.fast.movRegToRM<S::Q, 8>(
+      Reg::rdx, Reg::rax, Reg::rcx, JSObjectOffsets::directProps);
+
+  // Miss: the shared helper, which also updates the cache entry.
+  emit.slow = callPutById(emit.slow, ip, tryProp, idVal, constAddr);
+  emit.slow.jmp<OffsetType::Auto>(emit.fast.current());
+
+  describeSlowPathSection(emit.slow, false);
   return emit;
 }
 
@@ -1053,12 +1518,23 @@ Emitters FastJIT::compileCreateEnvironment(Emitters emit, const Inst *ip) {
 }
 
 Emitters FastJIT::compileCreateClosure(Emitters emit, const Inst *ip) {
+  return createClosureHelper(emit, ip, ip->iCreateClosure.op3);
+}
+Emitters FastJIT::compileCreateClosureLongIndex(
+    Emitters emit,
+    const Inst *ip) {
+  return createClosureHelper(emit, ip, ip->iCreateClosureLongIndex.op3);
+}
+
+Emitters FastJIT::createClosureHelper(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t funcIndex) {
   // Code blocks are allocated in C heap, so their addresses are constant,
   // and can be embedded in JIT'ed code.
   // &calleeCodeBlock  -> arg2
   CodeBlock *calleeBlock =
-      codeBlock_->getRuntimeModule()->getCodeBlockMayAllocate(
-          ip->iCreateClosure.op3);
+      codeBlock_->getRuntimeModule()->getCodeBlockMayAllocate(funcIndex);
   emit = loadConstantAddrIntoNativeReg(emit, calleeBlock, Reg::rsi);
 
   //&env -> arg3
@@ -1070,6 +1546,57 @@ Emitters FastJIT::compileCreateClosure(Emitters emit, const Inst *ip) {
   return emit;
 }
 
+Emitters FastJIT::createGeneratorHelper(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t funcIndex,
+    void *externCallAddr) {
+  // runtime module -> arg2
+  emit = loadConstantAddrIntoNativeReg(
+      emit, codeBlock_->getRuntimeModule(), Reg::rsi);
+  // function index -> arg3
+  emit.fast.movImmToReg<S::L>(funcIndex, Reg::edx);
+  // &env -> arg4
+  emit.fast = leaHermesReg(emit.fast, ip->iCreateClosure.op2, Reg::rcx);
+  // current frame -> arg5, only used by externCreateGenerator.
+  emit.fast.movRegToReg<S::Q>(RegFrame, Reg::r8);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, externCallAddr, constAddr);
+  emit.fast = callExternal(emit.fast, constAddr, ip->iCreateClosure.op1, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileCreateGeneratorClosure(Emitters emit, const Inst *ip) {
+  return createGeneratorHelper(
+      emit,
+      ip,
+      ip->iCreateGeneratorClosure.op3,
+      (void *)externCreateGeneratorClosure);
+}
+Emitters FastJIT::compileCreateGeneratorClosureLongIndex(
+    Emitters emit,
+    const Inst *ip) {
+  return createGeneratorHelper(
+      emit,
+      ip,
+      ip->iCreateGeneratorClosureLongIndex.op3,
+      (void *)externCreateGeneratorClosure);
+}
+Emitters FastJIT::compileCreateGenerator(Emitters emit, const Inst *ip) {
+  return createGeneratorHelper(
+      emit, ip, ip->iCreateGenerator.op3, (void *)externCreateGenerator);
+}
+Emitters FastJIT::compileCreateGeneratorLongIndex(
+    Emitters emit,
+    const Inst *ip) {
+  return createGeneratorHelper(
+      emit,
+      ip,
+      ip->iCreateGeneratorLongIndex.op3,
+      (void *)externCreateGenerator);
+}
+
 Emitters FastJIT::compileGetGlobalObject(Emitters emit, const Inst *ip) {
   emit.fast.movRMToReg<S::Q>(
       RegRuntime, Reg::NoIndex, RuntimeOffsets::globalObject, Reg::rax);
@@ -1078,6 +1605,17 @@ Emitters FastJIT::compileGetGlobalObject(Emitters emit, const Inst *ip) {
   return emit;
 }
 
+Emitters FastJIT::compileGetNewTarget(Emitters emit, const Inst *ip) {
+  emit.fast.movRMToReg<S::Q>(
+      RegFrame,
+      Reg::NoIndex,
+      sizeof(HermesValue) * StackFrameLayout::NewTarget,
+      Reg::rax);
+  emit.fast =
+      movNativeRegToHermesReg(emit.fast, Reg::rax, ip->iGetNewTarget.op1);
+  return emit;
+}
+
 Emitters FastJIT::compileLoadConstZero(Emitters emit, const Inst *ip) {
   emit.fast.xorRegToReg<S::Q>(Reg::rax, Reg::rax);
   emit.fast =
@@ -1268,11 +1806,19 @@ Emitters FastJIT::compileJmpUndefinedLong(Emitters emit, const Inst *ip) {
 }
 
 Emitters FastJIT::compileLoadParam(Emitters emit, const Inst *ip) {
+  return loadParamHelper(emit, ip->iLoadParam.op1, ip->iLoadParam.op2);
+}
+Emitters FastJIT::compileLoadParamLong(Emitters emit, const Inst *ip) {
+  return loadParamHelper(emit, ip->iLoadParamLong.op1, ip->iLoadParamLong.op2);
+}
+
+Emitters
+FastJIT::loadParamHelper(Emitters emit, uint32_t resReg, uint32_t paramIndex) {
   // rax = undefined
   emit = loadConstantIntoNativeReg(
       emit, HermesValue::encodeUndefinedValue(), Reg::rax);
   emit.fast.cmpImmToRM<S::L>(
-      ip->iLoadParam.op2,
+      paramIndex,
       RegFrame,
       Reg::NoIndex,
       sizeof(HermesValue) * StackFrameLayout::ArgCount);
@@ -1283,12 +1829,13 @@ Emitters FastJIT::compileLoadParam(Emitters emit, const Inst *ip) {
   emit.fast.movRMToReg<S::Q>(
       RegFrame,
       Reg::NoIndex,
-      sizeof(HermesValue) * StackFrameLayout::argOffset(ip->iLoadParam.op2 - 1),
+      sizeof(HermesValue) *
+          StackFrameLayout::argOffset((int32_t)paramIndex - 1),
       Reg::rax);
 
   applyRelocation(relo, emit.fast.current());
 
-  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, ip->iLoadParam.op1);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, resReg);
   return emit;
 }
 
@@ -1297,6 +1844,11 @@ Emitters FastJIT::compileBinOp(
     const Inst *ip,
     void *slowPathBinOp,
     compileBinOpNPtr binOpNPtr) {
+  // The interpreter has run this instruction on operands that aren't
+  // numbers, so skip the number fast path and call the generic one.
+  if (codeBlock_->sawNonNumberArith(codeBlock_->getOffsetOf(ip)))
+    return compile3RegsInst(emit, ip, slowPathBinOp);
+
   uint8_t *externAddr;
   emit.slow = getConstant(emit.slow, slowPathBinOp, externAddr);
   uint8_t *slowPathAddr = emit.slow.current();
@@ -1449,6 +2001,20 @@ Emitters FastJIT::compileAddEmptyString(Emitters emit, const Inst *ip) {
   return emit;
 }
 
+Emitters FastJIT::compileStringConcat(Emitters emit, const Inst *ip) {
+  // stack pointer -> arg2
+  emit.fast.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::stackPointer, Reg::rsi);
+
+  // count (uint32_t) -> arg3
+  emit.fast.movImmToReg<S::L>(ip->iStringConcat.op2, Reg::edx);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externStringConcat, constAddr);
+  emit.fast = callExternal(emit.fast, constAddr, ip->iStringConcat.op1, ip);
+  return emit;
+}
+
 Emitters FastJIT::compileRet(Emitters emit, const Inst *ip) {
   emit.fast = movHermesRegToNativeReg(emit.fast, ip->iRet.op1, Reg::rdx);
   emit.fast.movImmToReg<S::L>(1, Reg::eax);
@@ -1524,10 +2090,42 @@ Emitters FastJIT::compileCondJump(
 }
 
 Emitters FastJIT::compileNewObject(Emitters emit, const Inst *ip) {
+#if defined(HERMESVM_GC_NONCONTIG_GENERATIONAL) && defined(NDEBUG) && \
+    !defined(HERMESVM_SANITIZE_HANDLES) && !LLVM_ADDRESS_SANITIZER_BUILD
+  // In opt builds GenGC::alloc starts with a bump of the active segment's
+  // level, so do the same inline and only call out to construct the object.
+  // JSObject has no finalizer, so there is no other bookkeeping to do.
+  constexpr uint32_t size = heapAlignSize(cellSize<JSObject>());
+  uint8_t *initConstAddr;
+  emit.slow =
+      getConstant(emit.slow, (void *)externInitNewObject, initConstAddr);
+  uint8_t *newConstAddr;
+  emit.slow = getConstant(emit.slow, (void *)externNewObject, newConstAddr);
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  // rsi : the new cell, rax : the new level.
+  emit.fast.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::allocLevel, Reg::rsi);
+  emit.fast.leaRMToReg<S::Q>(Reg::rsi, Reg::NoIndex, size, Reg::rax);
+  emit.fast.cmpRmToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::allocEffectiveEnd, Reg::rax);
+  emit.fast.cjump<CCode::A, OffsetType::Int32>(slowPathAddr);
+  emit.fast.movRegToRM<S::Q>(
+      Reg::rax, RegRuntime, Reg::NoIndex, RuntimeOffsets::allocLevel);
+  emit.fast = callExternalWithReturnedVal(
+      emit.fast, initConstAddr, ip->iNewObject.op1);
+
+  // Slow path: the segment is full, let the GC find more space.
+  emit.slow = callExternalWithReturnedVal(
+      emit.slow, newConstAddr, ip->iNewObject.op1);
+  emit.slow.jmp<OffsetType::Int32>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
+#else
   uint8_t *constAddr;
   emit.slow = getConstant(emit.slow, (void *)externNewObject, constAddr);
   emit.fast =
       callExternalWithReturnedVal(emit.fast, constAddr, ip->iNewObject.op1);
+#endif
   return emit;
 }
 
@@ -1543,6 +2141,17 @@ FastJIT::compile3RegsInst(Emitters emit, const Inst *ip, void *externCallAddr) {
   return emit;
 }
 
+Emitters
+FastJIT::compile2RegsInst(Emitters emit, const Inst *ip, void *externCallAddr) {
+  emit.fast = leaHermesReg(emit.fast, ip->iMathAbs.op2, Reg::rsi);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, externCallAddr, constAddr);
+
+  emit.fast = callExternal(emit.fast, constAddr, ip->iMathAbs.op1, ip);
+  return emit;
+}
+
 Emitter
 FastJIT::cmpSomePointerTag(Emitter emit, uint32_t regIndex, TagKind tag) {
   emit = movHermesRegToNativeReg(emit, regIndex, Reg::rax);
@@ -1551,6 +2160,17 @@ FastJIT::cmpSomePointerTag(Emitter emit, uint32_t regIndex, TagKind tag) {
   return emit;
 }
 
+Emitters FastJIT::compileNewObjectWithParent(Emitters emit, const Inst *ip) {
+  emit.fast = leaHermesReg(emit.fast, ip->iNewObjectWithParent.op2, Reg::rsi);
+
+  uint8_t *constAddr;
+  emit.slow =
+      getConstant(emit.slow, (void *)externNewObjectWithParent, constAddr);
+  emit.fast = callExternalWithReturnedVal(
+      emit.fast, constAddr, ip->iNewObjectWithParent.op1);
+  return emit;
+}
+
 Emitters FastJIT::compileSelectObject(Emitters emit, const Inst *ip) {
   emit.fast = cmpSomePointerTag(emit.fast, ip->iSelectObject.op3, ObjectTag);
 
@@ -1644,6 +2264,18 @@ FastJIT::compilePutOwnByIndex(Emitters emit, const Inst *ip, uint32_t idx) {
 
 Emitters
 FastJIT::compilePutNewOwnById(Emitters emit, const Inst *ip, uint32_t idx) {
+  return putNewOwnByIdHelper(emit, ip, idx, true);
+}
+Emitters
+FastJIT::compilePutNewOwnNEById(Emitters emit, const Inst *ip, uint32_t idx) {
+  return putNewOwnByIdHelper(emit, ip, idx, false);
+}
+
+Emitters FastJIT::putNewOwnByIdHelper(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t idx,
+    bool enumerable) {
   // Object to put property in -> arg2
   emit.fast = leaHermesReg(emit.fast, ip->iPutOwnByIndex.op1, Reg::rsi);
   // Property to be put -> arg3
@@ -1655,6 +2287,8 @@ FastJIT::compilePutNewOwnById(Emitters emit, const Inst *ip, uint32_t idx) {
           ->getSymbolIDMustExist(idx)
           .unsafeGetIndex(),
       Reg::ecx);
+  // Whether the property is enumerable -> arg5
+  emit.fast.movImmToReg<S::L>(enumerable, Reg::r8d);
 
   uint8_t *constAddr;
   emit.slow = getConstant(emit.slow, (void *)externPutNewOwnById, constAddr);
@@ -1878,6 +2512,35 @@ Emitters FastJIT::compileDelByVal(Emitters emit, const Inst *ip) {
   return compile3RegsInst(emit, ip, (void *)externDelByVal);
 }
 
+Emitters
+FastJIT::delByIdHelper(Emitters emit, const Inst *ip, uint32_t idVal) {
+  // Object to delete the property from -> arg2
+  emit.fast = leaHermesReg(emit.fast, ip->iDelById.op2, Reg::rsi);
+  // SymbolID -> arg3
+  emit.fast.movImmToReg<S::L>(
+      codeBlock_->getRuntimeModule()
+          ->getSymbolIDMustExist(idVal)
+          .unsafeGetIndex(),
+      Reg::edx);
+  // PropOpFlags -> arg4
+  auto defaultPropOpFlags = codeBlock_->isStrictMode()
+      ? PropOpFlags().plusThrowOnError()
+      : PropOpFlags();
+  emit.fast.movImmToReg<S::L>(defaultPropOpFlags.getRaw(), Reg::ecx);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externDelById, constAddr);
+  emit.fast = callExternal(emit.fast, constAddr, ip->iDelById.op1, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileDelById(Emitters emit, const Inst *ip) {
+  return delByIdHelper(emit, ip, ip->iDelById.op3);
+}
+Emitters FastJIT::compileDelByIdLong(Emitters emit, const Inst *ip) {
+  return delByIdHelper(emit, ip, ip->iDelByIdLong.op3);
+}
+
 Emitters FastJIT::storeToEnvironmentHelper(
     Emitters emit,
     uint32_t op1,
@@ -1940,11 +2603,12 @@ Emitters FastJIT::compileStoreNPToEnvironmentL(Emitters emit, const Inst *ip) {
       true);
 }
 
-Emitters FastJIT::compileLoadFromEnvironment(
+Emitters FastJIT::loadFromEnvironmentHelper(
     Emitters emit,
-    const Inst *ip,
+    uint32_t resReg,
+    uint32_t envReg,
     uint32_t idx) {
-  emit.fast = leaHermesReg(emit.fast, ip->iLoadFromEnvironment.op2, Reg::rdi);
+  emit.fast = leaHermesReg(emit.fast, envReg, Reg::rdi);
   emit.fast.movImmToReg<S::L>(idx, Reg::rsi);
   uint8_t *constAddr;
   emit.slow =
@@ -1952,11 +2616,18 @@ Emitters FastJIT::compileLoadFromEnvironment(
   emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
   applyRIP32Offset(emit.fast.current(), constAddr);
 
-  emit.fast = movNativeRegToHermesReg(
-      emit.fast, Reg::rax, ip->iLoadFromEnvironment.op1);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, resReg);
   return emit;
 }
 
+Emitters FastJIT::compileLoadFromEnvironment(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t idx) {
+  return loadFromEnvironmentHelper(
+      emit, ip->iLoadFromEnvironment.op1, ip->iLoadFromEnvironment.op2, idx);
+}
+
 Emitters FastJIT::compileNot(Emitters emit, const Inst *ip) {
   uint8_t *slowPathConstAddr;
   emit.slow = getConstant(emit.slow, (void *)toBoolean, slowPathConstAddr);
@@ -2021,22 +2692,62 @@ inline Emitters FastJIT::encodeBoolHVInNativeReg(Emitters emit, Reg nativeReg) {
   return emit;
 }
 
-Emitters FastJIT::compileGetEnvironment(Emitters emit, const Inst *ip) {
+Emitters FastJIT::getEnvironmentHelper(
+    Emitters emit,
+    uint32_t resReg,
+    uint32_t numLevels) {
   // TODO: emit sequential inline code when levels are small, e.g. 1-3;
   // TODO: otherwise emit a compact loop instead of external call
-  emit.fast.movRegToReg<S::Q>(RegFrame, Reg::rdi);
-  emit.fast.movImmToReg<S::L>(ip->iGetEnvironment.op2, Reg::rsi);
+  emit.fast.movRegToReg<S::Q>(RegFrame, Reg::rsi);
+  emit.fast.movImmToReg<S::L>(numLevels, Reg::edx);
 
   uint8_t *constAddr;
   emit.slow = getConstant(emit.slow, (void *)externGetEnvironment, constAddr);
-  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
-  applyRIP32Offset(emit.fast.current(), constAddr);
-
-  emit.fast =
-      movNativeRegToHermesReg(emit.fast, Reg::rax, ip->iGetEnvironment.op1);
+  emit.fast = callExternalWithReturnedVal(emit.fast, constAddr, resReg);
   return emit;
 }
 
+Emitters FastJIT::compileGetEnvironment(Emitters emit, const Inst *ip) {
+  return getEnvironmentHelper(
+      emit, ip->iGetEnvironment.op1, ip->iGetEnvironment.op2);
+}
+
+Emitters FastJIT::compileGetEnvironmentAndLoad(Emitters emit, const Inst *ip) {
+  emit = getEnvironmentHelper(
+      emit, ip->iGetEnvironmentAndLoad.op1, ip->iGetEnvironmentAndLoad.op3);
+  return loadFromEnvironmentHelper(
+      emit,
+      ip->iGetEnvironmentAndLoad.op2,
+      ip->iGetEnvironmentAndLoad.op1,
+      ip->iGetEnvironmentAndLoad.op4);
+}
+
+Emitters FastJIT::compileGetEnvironmentAndStore(Emitters emit, const Inst *ip) {
+  emit = getEnvironmentHelper(
+      emit, ip->iGetEnvironmentAndStore.op1, ip->iGetEnvironmentAndStore.op2);
+  return storeToEnvironmentHelper(
+      emit,
+      ip->iGetEnvironmentAndStore.op1,
+      ip->iGetEnvironmentAndStore.op3,
+      ip->iGetEnvironmentAndStore.op4,
+      false);
+}
+
+Emitters FastJIT::compileGetEnvironmentAndStoreNP(
+    Emitters emit,
+    const Inst *ip) {
+  emit = getEnvironmentHelper(
+      emit,
+      ip->iGetEnvironmentAndStoreNP.op1,
+      ip->iGetEnvironmentAndStoreNP.op2);
+  return storeToEnvironmentHelper(
+      emit,
+      ip->iGetEnvironmentAndStoreNP.op1,
+      ip->iGetEnvironmentAndStoreNP.op3,
+      ip->iGetEnvironmentAndStoreNP.op4,
+      true);
+}
+
 Emitters FastJIT::compileNegate(Emitters emit, const Inst *ip) {
   uint8_t *externAddr;
   emit.slow = getConstant(emit.slow, (void *)slowPathNegate, externAddr);
@@ -2172,6 +2883,79 @@ Emitters FastJIT::compileBitNot(Emitters emit, const Inst *ip) {
   return emit;
 }
 
+Emitters FastJIT::compileMathAbs(Emitters emit, const Inst *ip) {
+  // As in compileBinOp, skip the number fast path if the interpreter has run
+  // this instruction on an operand that isn't a number.
+  if (codeBlock_->sawNonNumberArith(codeBlock_->getOffsetOf(ip)))
+    return compile2RegsInst(emit, ip, (void *)slowPathMathAbs);
+
+  uint8_t *slowPathConstAddr;
+  emit.slow =
+      getConstant(emit.slow, (void *)slowPathMathAbs, slowPathConstAddr);
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  emit.fast = isNumber(emit.fast, ip->iMathAbs.op2, slowPathAddr);
+  // Clear the sign bit of the double.
+  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iMathAbs.op2, Reg::rax);
+  emit.fast.shlImm8ToReg(1, Reg::rax);
+  emit.fast.shrImm8ToReg(1, Reg::rax);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, ip->iMathAbs.op1);
+
+  // Slow path
+  emit.slow = leaHermesReg(emit.slow, ip->iMathAbs.op2, Reg::rsi);
+  emit.slow = callExternal(emit.slow, slowPathConstAddr, ip->iMathAbs.op1, ip);
+  emit.slow.jmp<OffsetType::Auto>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
+
+  return emit;
+}
+
+Emitters FastJIT::compileMathSqrt(Emitters emit, const Inst *ip) {
+  if (codeBlock_->sawNonNumberArith(codeBlock_->getOffsetOf(ip)))
+    return compile2RegsInst(emit, ip, (void *)slowPathMathSqrt);
+
+  uint8_t *slowPathConstAddr;
+  emit.slow =
+      getConstant(emit.slow, (void *)slowPathMathSqrt, slowPathConstAddr);
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  emit.fast = isNumber(emit.fast, ip->iMathSqrt.op2, slowPathAddr);
+  emit.fast.sqrtfpRMToReg(
+      RegFrame,
+      Reg::NoIndex,
+      localHermesRegByteOffset(ip->iMathSqrt.op2),
+      Reg::XMM0);
+  emit.fast =
+      movNativeRegToHermesReg<true>(emit.fast, Reg::XMM0, ip->iMathSqrt.op1);
+
+  // Slow path
+  emit.slow = leaHermesReg(emit.slow, ip->iMathSqrt.op2, Reg::rsi);
+  emit.slow = callExternal(emit.slow, slowPathConstAddr, ip->iMathSqrt.op1, ip);
+  emit.slow.jmp<OffsetType::Auto>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
+
+  return emit;
+}
+
+// Rounding to an integral double takes roundsd, which needs SSE4.1, and minsd
+// and maxsd neither propagate NaN from both operands nor order -0 below +0,
+// so the other Math instructions call their slow path for every operand.
+Emitters FastJIT::compileMathCeil(Emitters emit, const Inst *ip) {
+  return compile2RegsInst(emit, ip, (void *)slowPathMathCeil);
+}
+
+Emitters FastJIT::compileMathFloor(Emitters emit, const Inst *ip) {
+  return compile2RegsInst(emit, ip, (void *)slowPathMathFloor);
+}
+
+Emitters FastJIT::compileMathMin(Emitters emit, const Inst *ip) {
+  return compile3RegsInst(emit, ip, (void *)slowPathMathMin);
+}
+
+Emitters FastJIT::compileMathMax(Emitters emit, const Inst *ip) {
+  return compile3RegsInst(emit, ip, (void *)slowPathMathMax);
+}
+
 Emitters FastJIT::compileGetArgumentsLength(Emitters emit, const Inst *ip) {
   uint8_t *slowPathConstAddr;
   emit.slow = getConstant(
@@ -2217,6 +3001,175 @@ Emitters FastJIT::compileCreateRegExp(Emitters emit, const Inst *ip) {
   return emit;
 }
 
+Emitters FastJIT::compileToInt32(Emitters emit, const Inst *ip) {
+  emit.fast = leaHermesReg(emit.fast, ip->iToInt32.op2, Reg::rsi);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externToInt32, constAddr);
+  emit.fast = callExternal(emit.fast, constAddr, ip->iToInt32.op1, ip);
+  return emit;
+}
+
+Emitters
+FastJIT::compileOutOfLine(Emitters emit, const Inst *ip, void *caseFn) {
+  uint8_t *externAddr;
+  emit.slow = getConstant(emit.slow, caseFn, externAddr);
+  // As in compileGetPNameList, frameRegs is the address of r0.
+  emit.fast = leaHermesReg(emit.fast, 0, Reg::rsi);
+  emit = loadConstantAddrIntoNativeReg(emit, (void *)ip, Reg::rdx);
+  emit.fast = callExternalNoReturnedVal(emit.fast, externAddr, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileSwitchImm(Emitters emit, const Inst *ip) {
+  uint32_t min = ip->iSwitchImm.op4;
+  uint32_t max = ip->iSwitchImm.op5;
+
+  // eax = the index of the jump table entry to take, or max - min + 1 for
+  // the default destination.
+  emit.fast = leaHermesReg(emit.fast, ip->iSwitchImm.op1, Reg::rdi);
+  emit.fast.movImmToReg<S::L>(min, Reg::esi);
+  emit.fast.movImmToReg<S::L>(max, Reg::edx);
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externSwitchImmIndex, constAddr);
+  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
+  applyRIP32Offset(emit.fast.current(), constAddr);
+
+  // Compare against every entry. The tables emitted by the compiler are
+  // small, and a compare chain needs no relocations beyond the usual ones.
+  const uint32_t *table = (const uint32_t *)llvm::alignAddr(
+      (const uint8_t *)ip + ip->iSwitchImm.op2, sizeof(uint32_t));
+  for (uint32_t i = 0; i <= max - min; ++i) {
+    emit.fast.cmpImmToRM<S::L, ScaleRegAccess>(i, Reg::eax, Reg::none, 0);
+    emit.fast = cjmpToBytecodeBB(
+        emit.fast, CJumpOp<CCode::E>::OP, getBBIndex(ip, table[i]));
+  }
+  emit.fast = jmpToBytecodeBB(emit.fast, getBBIndex(ip, ip->iSwitchImm.op3));
+  return emit;
+}
+
+Emitters FastJIT::compileSwitchStr(Emitters emit, const Inst *ip) {
+  return compileSwitchHash(
+      emit,
+      ip,
+      ip->iSwitchStr.op1,
+      ip->iSwitchStr.op2,
+      ip->iSwitchStr.op3,
+      ip->iSwitchStr.op4);
+}
+
+Emitters FastJIT::compileSwitchSparse(Emitters emit, const Inst *ip) {
+  return compileSwitchHash(
+      emit,
+      ip,
+      ip->iSwitchSparse.op1,
+      ip->iSwitchSparse.op2,
+      ip->iSwitchSparse.op3,
+      ip->iSwitchSparse.op4);
+}
+
+Emitters FastJIT::compileSwitchHash(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t inputReg,
+    uint32_t tableOffset,
+    int32_t defaultOffset,
+    uint32_t numSlots) {
+  // eax = the slot of the case matching the input, or numSlots for the
+  // default destination.
+  emit.fast.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
+  emit = loadConstantAddrIntoNativeReg(
+      emit, codeBlock_->getRuntimeModule(), Reg::rsi);
+  emit.fast = leaHermesReg(emit.fast, inputReg, Reg::rdx);
+  emit = loadConstantAddrIntoNativeReg(emit, (void *)ip, Reg::rcx);
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externSwitchHashSlot, constAddr);
+  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
+  applyRIP32Offset(emit.fast.current(), constAddr);
+
+  // Compare against every slot with a case. The jump offsets of the table
+  // follow its keys, and those of empty slots are the default one.
+  const uint32_t *offsets =
+      (const uint32_t *)llvm::alignAddr(
+          (const uint8_t *)ip + tableOffset, sizeof(uint32_t)) +
+      numSlots;
+  for (uint32_t slot = 0; slot < numSlots; ++slot) {
+    if ((int32_t)offsets[slot] == defaultOffset)
+      continue;
+    emit.fast.cmpImmToRM<S::L, ScaleRegAccess>(slot, Reg::eax, Reg::none, 0);
+    emit.fast = cjmpToBytecodeBB(
+        emit.fast, CJumpOp<CCode::E>::OP, getBBIndex(ip, offsets[slot]));
+  }
+  emit.fast = jmpToBytecodeBB(emit.fast, getBBIndex(ip, defaultOffset));
+  return emit;
+}
+
+Emitters FastJIT::compileThrowIfUndefinedInst(Emitters emit, const Inst *ip) {
+  uint8_t *externConstAddr;
+  emit.slow = getConstant(
+      emit.slow, (void *)externThrowUndefinedVariable, externConstAddr);
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  emit.fast =
+      cmpSomeNPTag(emit.fast, ip->iThrowIfUndefinedInst.op1, UndefinedTagHW);
+  emit.fast.cjump<CCode::E, OffsetType::Int32>(slowPathAddr);
+
+  // Slow path: always throws.
+  emit.slow = callExternalNoReturnedVal(emit.slow, externConstAddr, ip);
+  emit.slow.jmp<OffsetType::Auto>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
+
+  return emit;
+}
+
+Emitters FastJIT::compileAsyncBreakCheck(Emitters emit, const Inst *ip) {
+  uint8_t *externConstAddr;
+  emit.slow = getConstant(
+      emit.slow, (void *)Interpreter::handleAsyncBreak, externConstAddr);
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  emit.fast.cmpImmToRM<S::B>(
+      0, RegRuntime, Reg::NoIndex, RuntimeOffsets::asyncBreakRequestFlag);
+  emit.fast.cjump<CCode::NE, OffsetType::Int32>(slowPathAddr);
+
+  // Slow path: an async break was requested. Async debugger requests can't
+  // be serviced here, see Interpreter::handleAsyncBreak.
+  emit.slow = callExternalNoReturnedVal(emit.slow, externConstAddr, ip);
+  emit.slow.jmp<OffsetType::Auto>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
+
+  return emit;
+}
+
+Emitters FastJIT::compileProfilePoint(Emitters emit, const Inst *ip) {
+#ifdef HERMESVM_PROFILER_BB
+  emit = loadConstantAddrIntoNativeReg(emit, codeBlock_, Reg::rsi);
+  emit.fast.movImmToReg<S::L>(ip->iProfilePoint.op1, Reg::edx);
+  emit.fast.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externProfilePoint, constAddr);
+  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
+  applyRIP32Offset(emit.fast.current(), constAddr);
+#endif
+  return emit;
+}
+
+Emitters FastJIT::compileDebugger(Emitters emit, const Inst *ip) {
+#ifdef HERMES_ENABLE_DEBUGGER
+  // The debugger takes over the interpreter loop to pause, so the rest of a
+  // function with a debugger statement runs in the interpreter when it may be
+  // attached.
+  return emitDeopt(emit, ip);
+#else
+  return emit;
+#endif
+}
+
+Emitters FastJIT::compileUnreachable(Emitters emit, const Inst *ip) {
+  emit.fast.ud2();
+  return emit;
+}
+
 } // namespace x86_64
 } // namespace vm
 } // namespace hermes
@@ -10,9 +10,11 @@
 
 #include "hermes/BCGen/HBC/StackFrameLayout.h"
 #include "hermes/VM/JIT/DenseUInt64.h"
+#include "hermes/VM/JIT/CompileQueue.h"
 #include "hermes/VM/JIT/x86-64/Emitter.h"
 #include "hermes/VM/JIT/x86-64/JIT.h"
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Debug.h"
@@ -66,9 +68,10 @@ class FastJIT {
  public:
   FastJIT(JITContext *context, CodeBlock *codeBlock);
 
-  /// Attempt to compile the associated CodeBlock. On success, the JIT function
-  /// pointer in the CodeBlock will be set to the compiled body.
-  void compile();
+  /// Attempt to compile the associated CodeBlock. The CodeBlock itself is not
+  /// modified, so this can run on a background thread.
+  /// \return the compiled code, with a null body on failure.
+  JITCompiledCode compile();
 
   /// A pointer to binOpN instruction's compilation function.
   typedef Emitters (FastJIT::*compileBinOpNPtr)(Emitters emit, const Inst *ip);
@@ -77,6 +80,11 @@ class FastJIT {
   /// Raise the error flag and record an error message.
   void error(const llvm::Twine &msg);
 
+  /// \return \p sizes rounded up to whole pages when compiling in the
+  ///   background, since the pages of other functions may be running while
+  ///   the pages of this one are writable, and \p sizes otherwise.
+  ExecHeap::SizePair roundExecSizes(ExecHeap::SizePair sizes) const;
+
   /// Allocate executable memory using a conservative size estimate based on
   /// bytecode length. On failure it sets the error message and flag.
   /// \param bytecodeLength the length of the bytecode we will be compiling.
@@ -84,7 +92,7 @@ class FastJIT {
   ///     allocatedmemory memory blocks (fast paths and slow paths). Undefined
   ///     on failure.
   /// \return pointers to both allocated blocks on success.
-  llvm::Optional<ExecHeap::BlockPair> allocRWX(
+  llvm::Optional<ExecHeap::BlockPair> allocExec(
       size_t bytecodeLength,
       ExecHeap::SizePair &sizes);
 
@@ -144,15 +152,29 @@ class FastJIT {
   /// checkSpace() has already been called, except where noted.
   /// @{
 
+  /// Emit the start of the function prologue, which sets up the native frame
+  /// and saves the callee save registers and runtime->currentFrame_.
+  Emitter emitNativeFrame(Emitter emit);
   /// Emit the function prologue. Calls checkSpace() before emitting.
   Emitters emitPrologue(Emitters emit);
   /// Emit the function epilogue. Calls checkSpace() before emitting.
   Emitters emitEpilogue(Emitters emit);
+  /// Emit the entry points at the loop headers into the slow path. Each one
+  /// sets up the native frame like the prologue, but reuses the register frame
+  /// of the interpreter, and jumps to the loop header. Calls checkSpace()
+  /// before emitting every entry point.
+  Emitters emitLoopEntries(Emitters emit);
 
   /// Emit the code for a basic block. Calls checkSpace() before processing
   /// every bytecode instruction.
   Emitters compileBB(Emitters emit);
 
+  /// Leave native code at \p ip, which it cannot run, and run the rest of the
+  /// function in the interpreter. Every Hermes register lives in its slot of
+  /// the frame, so the frame is handed over as it is and the bytecode offset
+  /// of \p ip is all the interpreter needs to continue.
+  Emitters emitDeopt(Emitters emit, const Inst *ip);
+
   /// Lookup or add the specified constant and return its offset.
   /// \param slow the slow-path emitter.
   /// \param cval the constant
@@ -290,15 +312,78 @@ class FastJIT {
   /// Receives and \returns the fast path emitter.
   Emitter cjmpToBytecodeBB(Emitter emit, uint8_t opCode, unsigned bytecodeBB);
 
+  /// Emit the inline property cache check of the object in the Hermes
+  /// register \p objReg against \p cacheEntry, jumping to \p slowPathAddr if
+  /// the value isn't an object, its class isn't the cached one, or the cached
+  /// slot isn't a direct one. On a hit, %rax holds the JSObject and %rcx the
+  /// slot index.
+  Emitter checkPropertyCache(
+      Emitter emit,
+      uint32_t objReg,
+      const PropertyCacheEntry *cacheEntry,
+      uint8_t *slowPathAddr);
+
+  /// Emit a call to externGetById / externPutById, whose address is in the
+  /// constant at \p constAddr.
+  Emitter callGetById(
+      Emitter emit,
+      const Inst *ip,
+      bool tryProp,
+      uint32_t idVal,
+      const uint8_t *constAddr);
+  Emitter callPutById(
+      Emitter emit,
+      const Inst *ip,
+      bool tryProp,
+      uint32_t idVal,
+      const uint8_t *constAddr);
+
   Emitters
   getByIdHelper(Emitters emit, const Inst *ip, bool tryProp, uint32_t idVal);
   Emitters
   putByIdHelper(Emitters emit, const Inst *ip, bool tryProp, uint32_t idVal);
+  /// Emit a call to the compiled body of the callee of the Call or
+  /// Construct \p ip, with \p argCount arguments including "this", jumping
+  /// to \p slowPathAddr if the callee isn't a JSFunction or its code isn't
+  /// compiled. The call leaves the status in %eax and the result in %rdx.
+  Emitter callCompiledInline(
+      Emitter emit,
+      const Inst *ip,
+      uint32_t argCount,
+      bool isConstruct,
+      const uint8_t *slowPathAddr);
   Emitters callHelper(
       Emitters emit,
       const Inst *ip,
       uint32_t argCount,
       bool isConstruct);
+  /// Store the argument registers \p argRegs of a Call1..Call4 into the
+  /// outgoing frame at the top of the stack, and emit the call.
+  Emitters
+  callNHelper(Emitters emit, const Inst *ip, llvm::ArrayRef<uint32_t> argRegs);
+  Emitters
+  callDirectHelper(Emitters emit, const Inst *ip, uint32_t funcIndex);
+  Emitters
+  loadParamHelper(Emitters emit, uint32_t resReg, uint32_t paramIndex);
+  Emitters
+  createClosureHelper(Emitters emit, const Inst *ip, uint32_t funcIndex);
+  Emitters createGeneratorHelper(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t funcIndex,
+      void *externCallAddr);
+  Emitters delByIdHelper(Emitters emit, const Inst *ip, uint32_t idVal);
+  Emitters putNewOwnByIdHelper(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t idVal,
+      bool enumerable);
+
+  /// Emit a call to an out-of-line interpreter implementation of the whole
+  /// instruction at \p ip, with the signature
+  ///   ExecutionStatus caseFn(Runtime *, PinnedHermesValue *frameRegs,
+  ///                          const Inst *ip)
+  Emitters compileOutOfLine(Emitters emit, const Inst *ip, void *caseFn);
   Emitters jmpUndefinedHelper(
       Emitters emit,
       const Inst *ip,
@@ -352,6 +437,22 @@ class FastJIT {
       uint32_t op3,
       bool isNP);
 
+  /// Emit an external call to externGetEnvironment.
+  /// \param resReg the Hermes reg receiving the environment
+  /// \param numLevels the number of levels up the stack
+  Emitters
+  getEnvironmentHelper(Emitters emit, uint32_t resReg, uint32_t numLevels);
+
+  /// Emit an external call to externLoadFromEnvironment.
+  /// \param resReg the Hermes reg receiving the value
+  /// \param envReg the Hermes reg containing the environment
+  /// \param idx the environment index slot number
+  Emitters loadFromEnvironmentHelper(
+      Emitters emit,
+      uint32_t resReg,
+      uint32_t envReg,
+      uint32_t idx);
+
   // Individual instruction emitters
   Emitters compileTypeOf(Emitters emit, const Inst *ip);
 
@@ -370,6 +471,13 @@ class FastJIT {
   Emitters compileCallLong(Emitters emit, const Inst *ip);
   Emitters compileConstruct(Emitters emit, const Inst *ip);
   Emitters compileConstructLong(Emitters emit, const Inst *ip);
+  Emitters compileCall1(Emitters emit, const Inst *ip);
+  Emitters compileCall2(Emitters emit, const Inst *ip);
+  Emitters compileCall3(Emitters emit, const Inst *ip);
+  Emitters compileCall4(Emitters emit, const Inst *ip);
+  Emitters compileCallDirect(Emitters emit, const Inst *ip);
+  Emitters compileCallDirectLongIndex(Emitters emit, const Inst *ip);
+  Emitters compileCallBuiltin(Emitters emit, const Inst *ip);
 
   /// Emit a check that whether the value in the Hermes register \p regIndex is
   /// a number; if not, emit a jump to the slow path \p callStub.
@@ -403,9 +511,23 @@ class FastJIT {
   Emitters compileDeclareGlobalVar(Emitters emit, const Inst *ip);
   Emitters compileCreateEnvironment(Emitters emit, const Inst *ip);
   Emitters compileCreateClosure(Emitters emit, const Inst *ip);
+  Emitters compileCreateClosureLongIndex(Emitters emit, const Inst *ip);
+  Emitters compileCreateGeneratorClosure(Emitters emit, const Inst *ip);
+  Emitters compileCreateGeneratorClosureLongIndex(
+      Emitters emit,
+      const Inst *ip);
+  Emitters compileCreateGenerator(Emitters emit, const Inst *ip);
+  Emitters compileCreateGeneratorLongIndex(Emitters emit, const Inst *ip);
   Emitters compileGetGlobalObject(Emitters emit, const Inst *ip);
+  Emitters compileGetNewTarget(Emitters emit, const Inst *ip);
   Emitters compileLoadConstZero(Emitters emit, const Inst *ip);
   Emitters compileLoadParam(Emitters emit, const Inst *ip);
+  Emitters compileLoadParamLong(Emitters emit, const Inst *ip);
+
+  /// Compile a binary arithmetic instruction: a fast path on doubles when
+  /// both operands are numbers, a call to \p slowPathBinOp otherwise. If the
+  /// type feedback says the operands weren't always numbers, only the call is
+  /// emitted.
   Emitters compileBinOp(
       Emitters emit,
       const Inst *ip,
@@ -418,7 +540,9 @@ class FastJIT {
   Emitters compileMov(Emitters emit, const Inst *ip);
   Emitters compileMovLong(Emitters emit, const Inst *ip);
   Emitters compileToNumber(Emitters emit, const Inst *ip);
+  Emitters compileToInt32(Emitters emit, const Inst *ip);
   Emitters compileAddEmptyString(Emitters emit, const Inst *ip);
+  Emitters compileStringConcat(Emitters emit, const Inst *ip);
   Emitters compileRet(Emitters emit, const Inst *ip);
   Emitters compileCondJumpN(
       Emitters emit,
@@ -474,12 +598,18 @@ class FastJIT {
       void *slowPathCall);
   Emitters compileCondOpN(Emitters emit, const Inst *ip, uint8_t opCode);
   Emitters compileNewObject(Emitters emit, const Inst *ip);
+  Emitters compileNewObjectWithParent(Emitters emit, const Inst *ip);
 
   /// Compile instructions with the layout (name, Reg8, Reg8, Reg8).
   /// Load rsi and rdx with the second and third operand, and emit an external
   /// call at \p externCallAddr.
   Emitters
   compile3RegsInst(Emitters emit, const Inst *ip, void *externCallAddr);
+  /// Compile instructions with the layout (name, Reg8, Reg8).
+  /// Load rsi with the second operand, and emit an external call at
+  /// \p externCallAddr.
+  Emitters
+  compile2RegsInst(Emitters emit, const Inst *ip, void *externCallAddr);
 
   Emitters compileSelectObject(Emitters emit, const Inst *ip);
   Emitters compileNewArray(Emitters emit, const Inst *ip);
@@ -487,6 +617,8 @@ class FastJIT {
   compileNewArrayWithBuffer(Emitters emit, const Inst *ip, uint32_t idx);
   Emitters compilePutOwnByIndex(Emitters emit, const Inst *ip, uint32_t idx);
   Emitters compilePutNewOwnById(Emitters emit, const Inst *ip, uint32_t idx);
+  Emitters
+  compilePutNewOwnNEById(Emitters emit, const Inst *ip, uint32_t idx);
   Emitters compileLoadThisNS(Emitters emit, const Inst *ip);
   Emitters compileCoerceThisNS(Emitters emit, const Inst *ip);
 
@@ -500,6 +632,8 @@ class FastJIT {
   Emitters compileNewObjectWithBufferLong(Emitters emit, const Inst *ip);
   Emitters compilePutByVal(Emitters emit, const Inst *ip);
   Emitters compileDelByVal(Emitters emit, const Inst *ip);
+  Emitters compileDelById(Emitters emit, const Inst *ip);
+  Emitters compileDelByIdLong(Emitters emit, const Inst *ip);
   Emitters compileStoreToEnvironment(Emitters emit, const Inst *ip);
   Emitters compileStoreToEnvironmentL(Emitters emit, const Inst *ip);
   Emitters compileStoreNPToEnvironment(Emitters emit, const Inst *ip);
@@ -508,14 +642,42 @@ class FastJIT {
   compileLoadFromEnvironment(Emitters emit, const Inst *ip, uint32_t idx);
   Emitters compileNot(Emitters emit, const Inst *ip);
   Emitters compileGetEnvironment(Emitters emit, const Inst *ip);
+  Emitters compileGetEnvironmentAndLoad(Emitters emit, const Inst *ip);
+  Emitters compileGetEnvironmentAndStore(Emitters emit, const Inst *ip);
+  Emitters compileGetEnvironmentAndStoreNP(Emitters emit, const Inst *ip);
   Emitters compileNegate(Emitters emit, const Inst *ip);
   Emitters compileGetPNameList(Emitters emit, const Inst *ip);
   Emitters compileGetNextPName(Emitters emit, const Inst *ip);
   Emitters compileReifyArguments(Emitters emit, const Inst *ip);
   Emitters compileGetArgumentsPropByVal(Emitters emit, const Inst *ip);
   Emitters compileBitNot(Emitters emit, const Inst *ip);
+  Emitters compileMathAbs(Emitters emit, const Inst *ip);
+  Emitters compileMathCeil(Emitters emit, const Inst *ip);
+  Emitters compileMathFloor(Emitters emit, const Inst *ip);
+  Emitters compileMathSqrt(Emitters emit, const Inst *ip);
+  Emitters compileMathMin(Emitters emit, const Inst *ip);
+  Emitters compileMathMax(Emitters emit, const Inst *ip);
   Emitters compileGetArgumentsLength(Emitters emit, const Inst *ip);
   Emitters compileCreateRegExp(Emitters emit, const Inst *ip);
+  Emitters compileSwitchImm(Emitters emit, const Inst *ip);
+  Emitters compileSwitchStr(Emitters emit, const Inst *ip);
+  Emitters compileSwitchSparse(Emitters emit, const Inst *ip);
+
+  /// Emit a SwitchStr or SwitchSparse on the value in register \p inputReg,
+  /// whose hashed jump table is at \p tableOffset from \p ip and has
+  /// \p numSlots slots, with \p defaultOffset the offset of its default target.
+  Emitters compileSwitchHash(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t inputReg,
+      uint32_t tableOffset,
+      int32_t defaultOffset,
+      uint32_t numSlots);
+  Emitters compileThrowIfUndefinedInst(Emitters emit, const Inst *ip);
+  Emitters compileAsyncBreakCheck(Emitters emit, const Inst *ip);
+  Emitters compileProfilePoint(Emitters emit, const Inst *ip);
+  Emitters compileDebugger(Emitters emit, const Inst *ip);
+  Emitters compileUnreachable(Emitters emit, const Inst *ip);
 
   /// @}
 
@@ -536,6 +698,16 @@ class FastJIT {
   /// Map from a bytecode target label offset to a basic block index.
   llvm::DenseMap<uint32_t, unsigned> bcLabels_{};
 
+  /// The index of every basic block that is the header of a loop, in order.
+  std::vector<unsigned> bcLoopHeaders_{};
+
+  /// The native entry point at every loop header, in the same order.
+  std::vector<uint8_t *> nativeLoopEntries_{};
+
+  /// The offset of the native code of every instruction, with its bytecode
+  /// offset, for the source lines of the perf map.
+  std::vector<std::pair<uint32_t, uint32_t>> lineTable_{};
+
   /// The native code offset of every compiled bc BB.
   std::vector<uint8_t *> nativeBBAddress_{};
 
@@ -8,24 +8,297 @@
 #include "hermes/VM/JIT/x86-64/JIT.h"
 
 #include "FastJIT.h"
+#include "RegExpJIT.h"
+
+#include "hermes/Support/TraceEvents.h"
+#include "hermes/VM/JIT/JITPerfMap.h"
+#include "hermes/VM/JIT/JITProfileCache.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/RuntimeModule.h"
 
 namespace hermes {
 namespace vm {
 namespace x86_64 {
 
 JITContext::JITContext(bool enable, size_t blockSize, size_t maxMemory)
-    : enabled_(enable), heap_(blockSize / 2, blockSize / 2, maxMemory) {}
+    : enabled_(enable),
+      heap_(blockSize / 2, blockSize / 2, maxMemory),
+      regExpHeap_(blockSize / 2, blockSize / 2, maxMemory) {}
 
 JITContext::~JITContext() = default;
 
+void JITContext::setBackgroundCompilation(bool background) {
+  if (!background) {
+    if (queue_) {
+      queue_->installFinished(
+          [this](CodeBlock *codeBlock, const JITCompiledCode &code) {
+            install(codeBlock, code);
+          });
+    }
+    // Joins the worker, which frees the evicted code it was handed.
+    queue_.reset();
+    return;
+  }
+  if (!queue_) {
+    queue_.reset(new CompileQueue(
+        [this](CodeBlock *codeBlock) {
+          trace::Scope traceScope(trace::Category::Compile, "jitCompile");
+          traceScope.addArg("functionID", codeBlock->getFunctionID());
+          FastJIT impl{this, codeBlock};
+          return impl.compile();
+        },
+        [this](ExecHeap::BlockPair blocks) { heap_.free(blocks); }));
+  }
+}
+
+void JITContext::cancelCompilations(RuntimeModule *runtimeModule) {
+  if (queue_)
+    queue_->cancel(runtimeModule);
+  budget_.remove(runtimeModule, [this](ExecHeap::BlockPair blocks) {
+    releaseCode(blocks);
+  });
+}
+
+void JITContext::printStats(llvm::raw_ostream &os) const {
+  os << "JIT stats:\n"
+     << "{\n"
+     << "\t\"codeBudget\": " << budget_.getLimit() << ",\n"
+     << "\t\"codeBytesUsed\": " << budget_.getBytesUsed() << ",\n"
+     << "\t\"codeBytesFreed\": " << budget_.getBytesFreed() << ",\n"
+     << "\t\"numEvicted\": " << budget_.getNumEvicted() << "\n"
+     << "}\n";
+}
+
+void JITContext::setProfileCacheDir(const std::string &dir) {
+  profileCache_.reset(dir.empty() ? nullptr : new JITProfileCache(dir));
+}
+
+void JITContext::setPerfMap(bool enable) {
+  perfMap_.reset(enable ? new JITPerfMap() : nullptr);
+}
+
+void JITContext::loadProfile(Runtime *runtime, RuntimeModule *runtimeModule) {
+  if (!enabled_ || !profileCache_)
+    return;
+  for (uint32_t functionID : profileCache_->load(runtimeModule)) {
+    // The profile may be stale if the bytecode was regenerated from the same
+    // source, e.g. with different flags.
+    if (functionID >= runtimeModule->getNumCodeBlocks())
+      continue;
+    CodeBlock *codeBlock = runtimeModule->getCodeBlockMayAllocate(functionID);
+    if (codeBlock->getRuntimeModule() != runtimeModule ||
+        codeBlock->getJITCompiled() || codeBlock->getDontJIT())
+      continue;
+    compileImpl(runtime, codeBlock);
+  }
+}
+
+void JITContext::saveProfile(RuntimeModule *runtimeModule) {
+  if (profileCache_)
+    profileCache_->save(runtimeModule);
+}
+
 JITCompiledFunctionPtr JITContext::compileImpl(
     Runtime *runtime,
     CodeBlock *codeBlock) {
-  FastJIT impl{this, codeBlock};
-  impl.compile();
+  if (queue_) {
+    // Finished code is only installed here, at the call or loop back-edge
+    // where the interpreter looks it up.
+    queue_->installFinished(
+        [this](CodeBlock *codeBlock, const JITCompiledCode &code) {
+          install(codeBlock, code);
+        });
+    enforceBudget(runtime);
+    if (!codeBlock->getJITCompiled() && !codeBlock->getDontJIT())
+      queue_->enqueue(codeBlock);
+    return codeBlock->getJITCompiled();
+  }
+  {
+    auto &stats = runtime->getRuntimeStats();
+    const instrumentation::RAIITimer timer{
+        "JIT Compile", stats, stats.jitCompile};
+    JITCompiledCode code;
+    {
+      trace::Scope traceScope(trace::Category::Compile, "jitCompile");
+      traceScope.addArg("functionID", codeBlock->getFunctionID());
+      FastJIT impl{this, codeBlock};
+      code = impl.compile();
+    }
+    install(codeBlock, code);
+  }
+  enforceBudget(runtime);
   return codeBlock->getJITCompiled();
 }
 
+JITCompiledFunctionPtr JITContext::compileLoopImpl(
+    Runtime *runtime,
+    CodeBlock *codeBlock,
+    const inst::Inst *ip) {
+  if (!codeBlock->getJITCompiled())
+    compileImpl(runtime, codeBlock);
+  auto entry = codeBlock->getJITLoopEntry(codeBlock->getOffsetOf(ip));
+  // Not every backward branch has an entry, e.g. when the compilation failed
+  // or hasn't finished yet. Wait for another batch of iterations before
+  // looking again.
+  if (!entry)
+    codeBlock->clearBackEdgeCount();
+  else
+    codeBlock->markJITUsed();
+  return entry;
+}
+
+void JITContext::install(CodeBlock *codeBlock, const JITCompiledCode &code) {
+  trace::Scope traceScope(trace::Category::Compile, "jitInstall");
+  traceScope.addArg("functionID", codeBlock->getFunctionID());
+  traceScope.addArg("bytes", (int64_t)code.size);
+  code.install(codeBlock);
+  if (!code.body)
+    return;
+  budget_.add(codeBlock, code);
+  if (perfMap_)
+    perfMap_->add(codeBlock, code);
+}
+
+void JITContext::enforceBudget(Runtime *runtime) {
+  if (LLVM_LIKELY(!budget_.isOverBudget()))
+    return;
+  budget_.evict(
+      runtime, [this](ExecHeap::BlockPair blocks) { releaseCode(blocks); });
+}
+
+void JITContext::releaseCode(ExecHeap::BlockPair blocks) {
+  // In background mode the worker is the only user of the heap.
+  if (queue_)
+    queue_->releaseLater(blocks);
+  else
+    heap_.free(blocks);
+}
+
+JITRegExp *JITContext::getRegExp(llvm::ArrayRef<uint8_t> bytecode) {
+  /// The number of regexps we track. Past it, new regexps are interpreted.
+  static constexpr size_t kMaxRegExps = 1024;
+  llvm::StringRef key{
+      reinterpret_cast<const char *>(bytecode.data()), bytecode.size()};
+  auto it = regExps_.find(key);
+  if (it != regExps_.end())
+    return &it->second;
+  if (regExps_.size() >= kMaxRegExps)
+    return nullptr;
+  return &regExps_[key];
+}
+
+llvm::Optional<regex::MatchRuntimeResult> JITContext::searchRegExp(
+    JITRegExp *regExp,
+    llvm::ArrayRef<uint8_t> bytecode,
+    const char *first,
+    uint32_t start,
+    uint32_t length,
+    std::vector<regex::CapturedRange> *m,
+    regex::constants::MatchFlagType matchFlags) {
+  return searchRegExpImpl(
+      regExp, regExp->code8, bytecode, first, start, length, m, matchFlags);
+}
+
+llvm::Optional<regex::MatchRuntimeResult> JITContext::searchRegExp(
+    JITRegExp *regExp,
+    llvm::ArrayRef<uint8_t> bytecode,
+    const char16_t *first,
+    uint32_t start,
+    uint32_t length,
+    std::vector<regex::CapturedRange> *m,
+    regex::constants::MatchFlagType matchFlags) {
+  return searchRegExpImpl(
+      regExp, regExp->code16, bytecode, first, start, length, m, matchFlags);
+}
+
+template <typename CharT>
+llvm::Optional<regex::MatchRuntimeResult> JITContext::searchRegExpImpl(
+    JITRegExp *regExp,
+    JITCompiledRegExpPtr<CharT> &code,
+    llvm::ArrayRef<uint8_t> bytecode,
+    const CharT *first,
+    uint32_t start,
+    uint32_t length,
+    std::vector<regex::CapturedRange> *m,
+    regex::constants::MatchFlagType matchFlags) {
+  if (LLVM_UNLIKELY(!code)) {
+    if (!enabled_ || regExp->dontJIT ||
+        regExp->searchCount++ < callThreshold_)
+      return llvm::None;
+    code = reinterpret_cast<JITCompiledRegExpPtr<CharT>>(
+        compileRegExp(regExp, bytecode, sizeof(CharT) == 2));
+    if (!code)
+      return llvm::None;
+  }
+  // The compiled code always matches the end of the input at $.
+  if (matchFlags & regex::constants::matchNotEndOfLine)
+    return llvm::None;
+
+  // Check for match impossibility like regex::searchWithBytecode().
+  auto header =
+      reinterpret_cast<const regex::RegexBytecodeHeader *>(bytecode.data());
+  if ((header->constraints & regex::MatchConstraintNonASCII) &&
+      (matchFlags & regex::constants::matchInputAllAscii))
+    return regex::MatchRuntimeResult::NoMatch;
+  if ((header->constraints & regex::MatchConstraintAnchoredAtStart) &&
+      start != 0)
+    return regex::MatchRuntimeResult::NoMatch;
+  bool onlyAtStart =
+      (header->constraints & regex::MatchConstraintAnchoredAtStart) ||
+      (matchFlags & regex::constants::matchOnlyAtStart);
+
+  if (!regExpStack_)
+    regExpStack_.reset(new uint64_t[kJITRegExpStackEntries * 3]);
+  llvm::SmallVector<const CharT *, 16> captures(
+      2 * (header->markedCount + 1), nullptr);
+  JITRegExpArgs<CharT> args{
+      first,
+      first + length,
+      first + start,
+      onlyAtStart ? first + start : first + length,
+      captures.data(),
+      regExpStack_.get(),
+      regExpStack_.get() + kJITRegExpStackEntries * 3,
+      jitRegExpBacktrackLimit(length)};
+  switch (code(&args)) {
+    case JITRegExpResult::Match:
+      break;
+    case JITRegExpResult::NoMatch:
+      return regex::MatchRuntimeResult::NoMatch;
+    case JITRegExpResult::Fallback:
+      return llvm::None;
+  }
+
+  // The first range is the total match, followed by the capture groups.
+  if (m != nullptr) {
+    m->clear();
+    for (size_t i = 0, e = captures.size(); i != e; i += 2) {
+      if (!captures[i]) {
+        m->push_back(regex::CapturedRange{regex::kNotMatched, 0});
+      } else {
+        m->push_back(regex::CapturedRange{
+            static_cast<uint32_t>(captures[i] - first),
+            static_cast<uint32_t>(captures[i + 1] - first)});
+      }
+    }
+  }
+  return regex::MatchRuntimeResult::Match;
+}
+
+void *JITContext::compileRegExp(
+    JITRegExp *regExp,
+    llvm::ArrayRef<uint8_t> bytecode,
+    bool wide) {
+  void *code = nullptr;
+  if (RegExpJIT::canCompile(bytecode)) {
+    RegExpJIT impl{this, bytecode, wide};
+    code = impl.compile();
+  }
+  if (!code)
+    regExp->dontJIT = true;
+  return code;
+}
+
 } // namespace x86_64
 } // namespace vm
 } // namespace hermes
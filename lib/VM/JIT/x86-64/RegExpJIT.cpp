@@ -0,0 +1,874 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "RegExpJIT.h"
+
+#include "hermes/Regex/Compiler.h"
+#include "hermes/Support/ErrorHandling.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <cstddef>
+#include <cstring>
+
+#define DEBUG_TYPE "jit"
+
+namespace hermes {
+namespace vm {
+namespace x86_64 {
+
+using namespace hermes::regex;
+
+namespace {
+
+/// The current position in the input.
+constexpr auto RegPos = Reg::rbx;
+/// The first code unit of the input.
+constexpr auto RegFirst = Reg::rbp;
+/// The start position of the current match attempt.
+constexpr auto RegStart = Reg::r12;
+/// One past the last code unit of the input.
+constexpr auto RegLast = Reg::r13;
+/// The end of the backtracking stack.
+constexpr auto RegStackEnd = Reg::r14;
+/// The top of the backtracking stack, past its last entry.
+constexpr auto RegStackTop = Reg::r15;
+/// The bottom of the backtracking stack, where every attempt starts.
+constexpr auto RegStackBase = Reg::r8;
+/// The start and end pointers of the match and of every capture group.
+constexpr auto RegCaptures = Reg::r9;
+/// The last start position of a match attempt.
+constexpr auto RegLastStart = Reg::r10;
+/// The remaining number of backtracks.
+constexpr auto RegBudget = Reg::esi;
+/// The JITRegExpArgs, on entry.
+constexpr auto RegArgs = Reg::rdi;
+
+/// The callee-saved registers used by the code, in push order. Note that rbp
+/// and r13 are never used as the base of an operand, since a zero offset
+/// encodes a RIP relative operand with them.
+constexpr Reg kSavedRegs[] =
+    {Reg::rbx, Reg::rbp, Reg::r12, Reg::r13, Reg::r14, Reg::r15};
+
+/// The size of a backtracking entry: the address of its handler, the
+/// position and an aux value, which are loaded into rbx and rax before
+/// jumping to the handler.
+constexpr int32_t kEntrySize = 3 * sizeof(uint64_t);
+
+/// The size of the start and end pointers of a capture group.
+constexpr int32_t kCaptureSize = 2 * sizeof(void *);
+
+using Args = JITRegExpArgs<char>;
+static_assert(
+    sizeof(Args) == sizeof(JITRegExpArgs<char16_t>),
+    "the code assumes the same layout for both code units");
+
+/// \return the width of \p insn if it can be compiled, or 0.
+uint32_t compiledInsnWidth(const Insn *insn) {
+  switch (insn->opcode) {
+    case Opcode::Goal:
+      return sizeof(GoalInsn);
+    case Opcode::LeftAnchor:
+      return sizeof(LeftAnchorInsn);
+    case Opcode::RightAnchor:
+      return sizeof(RightAnchorInsn);
+    case Opcode::MatchAnyButNewline:
+      return sizeof(MatchAnyButNewlineInsn);
+    case Opcode::MatchChar8:
+      return sizeof(MatchChar8Insn);
+    case Opcode::MatchChar16:
+      return sizeof(MatchChar16Insn);
+    case Opcode::MatchNChar8:
+      return llvm::cast<MatchNChar8Insn>(insn)->totalWidth();
+    case Opcode::Alternation:
+      return sizeof(AlternationInsn);
+    case Opcode::Jump32:
+      return sizeof(Jump32Insn);
+    case Opcode::Bracket:
+      return llvm::cast<BracketInsn>(insn)->totalWidth();
+    case Opcode::BeginMarkedSubexpression:
+      return sizeof(BeginMarkedSubexpressionInsn);
+    case Opcode::EndMarkedSubexpression:
+      return sizeof(EndMarkedSubexpressionInsn);
+    case Opcode::WordBoundary:
+      return sizeof(WordBoundaryInsn);
+    case Opcode::BeginSimpleLoop:
+      return sizeof(BeginSimpleLoopInsn);
+    case Opcode::EndSimpleLoop:
+      return sizeof(EndSimpleLoopInsn);
+    case Opcode::Width1Loop:
+      return sizeof(Width1LoopInsn);
+    default:
+      return 0;
+  }
+}
+
+/// \return true if \p n code units of either size fit in a 32-bit offset.
+bool fitsOffset(uint32_t n) {
+  return n <= INT32_MAX / sizeof(char16_t);
+}
+
+} // namespace
+
+RegExpJIT::RegExpJIT(
+    JITContext *context,
+    llvm::ArrayRef<uint8_t> bytecode,
+    bool wide)
+    : context_(context),
+      bytecode_(bytecode),
+      insns_(bytecode.data() + sizeof(RegexBytecodeHeader)),
+      wide_(wide),
+      charSize_(wide ? sizeof(char16_t) : sizeof(char)),
+      syntaxFlags_(
+          reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data())
+              ->syntaxFlags) {}
+
+bool RegExpJIT::canCompile(llvm::ArrayRef<uint8_t> bytecode) {
+  const auto *header =
+      reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data());
+  if (header->syntaxFlags & (constants::icase | constants::unicode))
+    return false;
+  for (size_t offset = sizeof(RegexBytecodeHeader); offset < bytecode.size();) {
+    const auto *insn = reinterpret_cast<const Insn *>(&bytecode[offset]);
+    uint32_t width = compiledInsnWidth(insn);
+    if (!width)
+      return false;
+    if (const auto *loop = llvm::dyn_cast<Width1LoopInsn>(insn)) {
+      switch (reinterpret_cast<const Insn *>(loop + 1)->opcode) {
+        case Opcode::MatchChar8:
+        case Opcode::MatchChar16:
+        case Opcode::MatchAnyButNewline:
+        case Opcode::Bracket:
+          break;
+        default:
+          return false;
+      }
+      // The bounds of the loop are added to the position as immediates.
+      if (!fitsOffset(loop->min) ||
+          (loop->max != UINT32_MAX && !fitsOffset(loop->max)))
+        return false;
+    }
+    offset += width;
+  }
+  return true;
+}
+
+void *RegExpJIT::compile() {
+  // The slow path only holds the exits.
+  ExecHeap::SizePair sizes{
+      bytecode_.size() * 64 + 2 * kMinInstructionSpace, kMinInstructionSpace};
+  ExecHeap &heap = context_->getRegExpHeap();
+  auto blocks = heap.alloc(sizes);
+  // If the allocation failed, add a new pool and retry.
+  if (!blocks) {
+    auto newPool = heap.addPool();
+    if (!newPool) {
+      error("out of executable memory");
+      return nullptr;
+    }
+    blocks = newPool->alloc(sizes);
+    if (!blocks) {
+      error("regexp bytecode size too large");
+      return nullptr;
+    }
+  }
+  if (!heap.unprotect(*blocks, sizes)) {
+    error("executable memory could not be made writable");
+    heap.free(*blocks);
+    return nullptr;
+  }
+
+  fast_ = llvm::makeMutableArrayRef(blocks->first, sizes.first);
+  slow_ = llvm::makeMutableArrayRef(blocks->second, sizes.second);
+  fastEmit_ = Emitter{fast_.begin()};
+  slowEmit_ = Emitter{slow_.begin()};
+
+  emitExits();
+  Fixups toTryStart;
+  emitPrologue(toTryStart);
+  emitBacktrack(toTryStart);
+  emitTryStart();
+  bind(toTryStart, tryStart_);
+
+  const uint32_t end = bytecode_.size() - sizeof(RegexBytecodeHeader);
+  for (uint32_t offset = 0; offset < end && !error_;)
+    offset = emitInsn(offset);
+
+  for (const auto &relo : relocs_) {
+    auto it = labels_.find(relo.second);
+    if (it == labels_.end()) {
+      error("jump to a bytecode offset without code");
+      break;
+    }
+    bind(relo.first, it->second);
+  }
+
+  if (!error_) {
+    LLVM_DEBUG(disassemble(llvm::dbgs()));
+    if (context_->getDumpJITCode())
+      disassemble(llvm::outs());
+  }
+
+  if (!heap.publish(*blocks, sizes))
+    error("executable memory could not be published");
+
+  if (error_) {
+    heap.free(*blocks);
+    if (context_->getCrashOnError())
+      hermes_fatal(errorMsg_.c_str());
+    return nullptr;
+  }
+  heap.freeRemaining(
+      *blocks,
+      {fastEmit_.current() - fast_.data(),
+       slowEmit_.current() - slow_.data()});
+  return fast_.data();
+}
+
+void RegExpJIT::error(const llvm::Twine &msg) {
+  error_ = true;
+  if (errorMsg_.empty())
+    errorMsg_ = msg.str();
+  LLVM_DEBUG(llvm::dbgs() << "RegExpJIT error: " << msg << "\n");
+}
+
+bool RegExpJIT::checkSpace(size_t extra) {
+  if (LLVM_UNLIKELY(
+          (size_t)(fast_.end() - fastEmit_.current()) <
+          kMinInstructionSpace + extra)) {
+    error("fast-path overflow");
+    return false;
+  }
+  return true;
+}
+
+void RegExpJIT::jmpTo(Emitter &emit, Fixups &fixups) {
+  emit.jmp<OffsetType::Int32>(emit.current());
+  fixups.push_back(emit.current() - 4);
+}
+
+template <CCode cc>
+void RegExpJIT::cjumpTo(Emitter &emit, Fixups &fixups) {
+  emit.cjump<cc, OffsetType::Int32>(emit.current());
+  fixups.push_back(emit.current() - 4);
+}
+
+void RegExpJIT::bind(uint8_t *disp, const uint8_t *target) {
+  *reinterpret_cast<int32_t *>(disp) = target - (disp + 4);
+}
+
+void RegExpJIT::bind(Fixups &fixups, const uint8_t *target) {
+  for (uint8_t *disp : fixups)
+    bind(disp, target);
+  fixups.clear();
+}
+
+template <CCode cc>
+void RegExpJIT::cjumpToLabel(Emitter &emit, uint32_t target) {
+  emit.cjump<cc, OffsetType::Int32>(emit.current());
+  relocs_.emplace_back(emit.current() - 4, target);
+}
+
+void RegExpJIT::jmpToLabel(Emitter &emit, uint32_t target) {
+  emit.jmp<OffsetType::Int32>(emit.current());
+  relocs_.emplace_back(emit.current() - 4, target);
+}
+
+void RegExpJIT::emitPush(
+    Emitter &emit,
+    const uint8_t *handler,
+    uint32_t target,
+    Reg pos,
+    Reg aux,
+    bool checkOverflow) {
+  if (checkOverflow) {
+    emit.cmpRmToReg<S::Q, ScaleRegAccess>(
+        RegStackEnd, Reg::NoIndex, 0, RegStackTop);
+    emit.cjump<CCode::AE, OffsetType::Int32>(fallbackExit_);
+  }
+  emit.leaRMToReg<S::Q, S::Q, ScaleRIPAddr32>(
+      Reg::none, Reg::NoIndex, 0, Reg::r11);
+  if (handler)
+    bind(emit.current() - 4, handler);
+  else
+    relocs_.emplace_back(emit.current() - 4, target);
+  emit.movRegToRM<S::Q>(Reg::r11, RegStackTop, Reg::NoIndex, 0);
+  emit.movRegToRM<S::Q>(pos, RegStackTop, Reg::NoIndex, 8);
+  emit.movRegToRM<S::Q>(aux, RegStackTop, Reg::NoIndex, 16);
+  emit.leaRMToReg<S::Q>(RegStackTop, Reg::NoIndex, kEntrySize, RegStackTop);
+}
+
+void RegExpJIT::emitLoadChar(Emitter &emit, Reg base, int32_t offset) {
+  if (wide_)
+    emit.movzxRMToReg<S::W>(base, Reg::NoIndex, offset * charSize_, Reg::eax);
+  else
+    emit.movzxRMToReg<S::B>(base, Reg::NoIndex, offset * charSize_, Reg::eax);
+}
+
+void RegExpJIT::emitExits() {
+  Emitter &slow = slowEmit_;
+
+  const uint8_t *epilogue = slow.current();
+  for (unsigned i = llvm::array_lengthof(kSavedRegs); i != 0; --i)
+    slow.popqReg(kSavedRegs[i - 1]);
+  slow.retq();
+
+  matchExit_ = slow.current();
+  slow.movRegToRM<S::Q>(RegStart, RegCaptures, Reg::NoIndex, 0);
+  slow.movRegToRM<S::Q>(RegPos, RegCaptures, Reg::NoIndex, 8);
+  slow.xorRegToReg<S::L>(Reg::eax, Reg::eax);
+  static_assert((uint32_t)JITRegExpResult::Match == 0, "Match must be 0");
+  slow.jmp<OffsetType::Auto>(epilogue);
+
+  noMatchExit_ = slow.current();
+  slow.movImmToReg<S::L>((uint32_t)JITRegExpResult::NoMatch, Reg::eax);
+  slow.jmp<OffsetType::Auto>(epilogue);
+
+  fallbackExit_ = slow.current();
+  slow.movImmToReg<S::L>((uint32_t)JITRegExpResult::Fallback, Reg::eax);
+  slow.jmp<OffsetType::Auto>(epilogue);
+}
+
+void RegExpJIT::emitPrologue(Fixups &toTryStart) {
+  Emitter &fast = fastEmit_;
+
+  for (Reg reg : kSavedRegs)
+    fast.pushqReg(reg);
+  fast.movRMToReg<S::Q>(RegArgs, Reg::NoIndex, offsetof(Args, first), RegFirst);
+  fast.movRMToReg<S::Q>(RegArgs, Reg::NoIndex, offsetof(Args, last), RegLast);
+  fast.movRMToReg<S::Q>(RegArgs, Reg::NoIndex, offsetof(Args, start), RegStart);
+  fast.movRMToReg<S::Q>(
+      RegArgs, Reg::NoIndex, offsetof(Args, lastStart), RegLastStart);
+  fast.movRMToReg<S::Q>(
+      RegArgs, Reg::NoIndex, offsetof(Args, captures), RegCaptures);
+  fast.movRMToReg<S::Q>(
+      RegArgs, Reg::NoIndex, offsetof(Args, stack), RegStackBase);
+  fast.movRMToReg<S::Q>(
+      RegArgs, Reg::NoIndex, offsetof(Args, stackEnd), RegStackEnd);
+  fast.movRMToReg<S::L>(
+      RegArgs, Reg::NoIndex, offsetof(Args, backtrackLimit), RegBudget);
+  jmpTo(fast, toTryStart);
+}
+
+void RegExpJIT::emitTryStart() {
+  Emitter &fast = fastEmit_;
+  tryStart_ = fast.current();
+
+  // If every match starts with a known code unit, skip the start positions
+  // where it isn't.
+  const Insn *insn = reinterpret_cast<const Insn *>(insns_);
+  while (insn->opcode == Opcode::BeginMarkedSubexpression)
+    insn = reinterpret_cast<const Insn *>(
+        reinterpret_cast<const BeginMarkedSubexpressionInsn *>(insn) + 1);
+  uint32_t first = UINT32_MAX;
+  if (const auto *matchChar = llvm::dyn_cast<MatchChar8Insn>(insn))
+    first = (uint8_t)matchChar->c;
+  else if (const auto *matchChar = llvm::dyn_cast<MatchChar16Insn>(insn))
+    first = wide_ ? matchChar->c : UINT32_MAX;
+  else if (const auto *matchChars = llvm::dyn_cast<MatchNChar8Insn>(insn))
+    first = *reinterpret_cast<const uint8_t *>(matchChars + 1);
+
+  if (first != UINT32_MAX) {
+    const uint8_t *loop = fast.current();
+    Fixups found;
+    fast.cmpRmToReg<S::Q, ScaleRegAccess>(
+        RegLast, Reg::NoIndex, 0, RegStart);
+    fast.cjump<CCode::AE, OffsetType::Int32>(noMatchExit_);
+    if (wide_)
+      fast.cmpImmToRM<S::W>(first, RegStart, Reg::NoIndex, 0);
+    else
+      fast.cmpImmToRM<S::B>(first, RegStart, Reg::NoIndex, 0);
+    cjumpTo<CCode::E>(fast, found);
+    fast.cmpRmToReg<S::Q, ScaleRegAccess>(
+        RegLastStart, Reg::NoIndex, 0, RegStart);
+    fast.cjump<CCode::AE, OffsetType::Int32>(noMatchExit_);
+    fast.leaRMToReg<S::Q>(RegStart, Reg::NoIndex, charSize_, RegStart);
+    fast.jmp<OffsetType::Auto>(loop);
+    bind(found, fast.current());
+  }
+
+  fast.movRegToReg<S::Q>(RegStart, RegPos);
+  fast.movRegToReg<S::Q>(RegStackBase, RegStackTop);
+}
+
+void RegExpJIT::emitBacktrack(Fixups &toTryStart) {
+  Emitter &fast = fastEmit_;
+
+  // Every backtracking entry was popped, which undid the captures: try the
+  // next start position.
+  nextStart_ = fast.current();
+  fast.cmpRmToReg<S::Q, ScaleRegAccess>(
+      RegLastStart, Reg::NoIndex, 0, RegStart);
+  fast.cjump<CCode::AE, OffsetType::Int32>(noMatchExit_);
+  fast.leaRMToReg<S::Q>(RegStart, Reg::NoIndex, charSize_, RegStart);
+  jmpTo(fast, toTryStart);
+
+  backtrack_ = fast.current();
+  fast.cmpRmToReg<S::Q, ScaleRegAccess>(
+      RegStackBase, Reg::NoIndex, 0, RegStackTop);
+  fast.cjump<CCode::E, OffsetType::Auto>(nextStart_);
+  fast.testRegToReg<S::L>(RegBudget, RegBudget);
+  fast.cjump<CCode::E, OffsetType::Int32>(fallbackExit_);
+  fast.leaRMToReg<S::L, S::Q>(Reg::rsi, Reg::NoIndex, -1, RegBudget);
+  fast.leaRMToReg<S::Q>(RegStackTop, Reg::NoIndex, -kEntrySize, RegStackTop);
+  fast.movRMToReg<S::Q>(RegStackTop, Reg::NoIndex, 8, RegPos);
+  fast.movRMToReg<S::Q>(RegStackTop, Reg::NoIndex, 16, Reg::rax);
+  fast.jmpRM(RegStackTop, Reg::NoIndex, 0);
+
+  // Unmatch the capture group whose start and end pointers are at rax, which
+  // backtracking past the start of the group does.
+  undoCapture_ = fast.current();
+  fast.xorRegToReg<S::L>(Reg::ecx, Reg::ecx);
+  fast.movRegToRM<S::Q>(Reg::rcx, Reg::rax, Reg::NoIndex, 0);
+  fast.movRegToRM<S::Q>(Reg::rcx, Reg::rax, Reg::NoIndex, 8);
+  fast.jmp<OffsetType::Auto>(backtrack_);
+}
+
+void RegExpJIT::emitLineTerminatorTest(Emitter &emit, Fixups &hit) {
+  emit.cmpImmToRM<S::L, ScaleRegAccess>('\n', Reg::eax, Reg::NoIndex, 0);
+  cjumpTo<CCode::E>(emit, hit);
+  emit.cmpImmToRM<S::L, ScaleRegAccess>('\r', Reg::eax, Reg::NoIndex, 0);
+  cjumpTo<CCode::E>(emit, hit);
+  if (wide_) {
+    // U+2028 and U+2029.
+    emit.leaRMToReg<S::L, S::Q>(Reg::rax, Reg::NoIndex, -0x2028, Reg::ecx);
+    emit.cmpImmToRM<S::L, ScaleRegAccess>(1, Reg::ecx, Reg::NoIndex, 0);
+    cjumpTo<CCode::BE>(emit, hit);
+  }
+}
+
+void RegExpJIT::emitClassTest(Emitter &emit, uint8_t cls, Fixups &hit) {
+  // Jump to hit if eax is within [lo, hi].
+  auto range = [&](uint32_t lo, uint32_t hi) {
+    if (lo == hi) {
+      emit.cmpImmToRM<S::L, ScaleRegAccess>(lo, Reg::eax, Reg::NoIndex, 0);
+      cjumpTo<CCode::E>(emit, hit);
+      return;
+    }
+    emit.leaRMToReg<S::L, S::Q>(
+        Reg::rax, Reg::NoIndex, -(int32_t)lo, Reg::ecx);
+    emit.cmpImmToRM<S::L, ScaleRegAccess>(hi - lo, Reg::ecx, Reg::NoIndex, 0);
+    cjumpTo<CCode::BE>(emit, hit);
+  };
+
+  switch (cls) {
+    case CharacterClass::Digits:
+      range('0', '9');
+      break;
+    case CharacterClass::Words:
+      range('a', 'z');
+      range('A', 'Z');
+      range('0', '9');
+      range('_', '_');
+      break;
+    case CharacterClass::Spaces:
+      // \t, \n, \v, \f and \r.
+      range(0x09, 0x0D);
+      range(0x20, 0x20);
+      if (wide_) {
+        range(0xA0, 0xA0);
+        range(0x1680, 0x1680);
+        range(0x2000, 0x200A);
+        range(0x2028, 0x2029);
+        range(0x202F, 0x202F);
+        range(0x205F, 0x205F);
+        range(0x3000, 0x3000);
+        range(0xFEFF, 0xFEFF);
+      }
+      break;
+    default:
+      llvm_unreachable("Invalid character class");
+  }
+}
+
+void RegExpJIT::emitWidth1Test(Emitter &emit, const Insn *base, Fixups &fail) {
+  switch (base->opcode) {
+    case Opcode::MatchChar8:
+      emit.cmpImmToRM<S::L, ScaleRegAccess>(
+          (uint8_t)llvm::cast<MatchChar8Insn>(base)->c,
+          Reg::eax,
+          Reg::NoIndex,
+          0);
+      cjumpTo<CCode::NE>(emit, fail);
+      break;
+
+    case Opcode::MatchChar16:
+      // ASCII input doesn't contain the code units above 127 matched by
+      // MatchChar16.
+      if (!wide_) {
+        jmpTo(emit, fail);
+        break;
+      }
+      emit.cmpImmToRM<S::L, ScaleRegAccess>(
+          llvm::cast<MatchChar16Insn>(base)->c, Reg::eax, Reg::NoIndex, 0);
+      cjumpTo<CCode::NE>(emit, fail);
+      break;
+
+    case Opcode::MatchAnyButNewline:
+      emitLineTerminatorTest(emit, fail);
+      break;
+
+    case Opcode::Bracket: {
+      const auto *insn = llvm::cast<BracketInsn>(base);
+      const auto *ranges = reinterpret_cast<const BracketRange32 *>(insn + 1);
+      Fixups hit;
+      for (uint8_t cls : {CharacterClass::Digits,
+                          CharacterClass::Spaces,
+                          CharacterClass::Words}) {
+        if (insn->positiveCharClasses & cls)
+          emitClassTest(emit, cls, hit);
+        if (insn->negativeCharClasses & cls) {
+          Fixups inClass;
+          emitClassTest(emit, cls, inClass);
+          jmpTo(emit, hit);
+          bind(inClass, emit.current());
+        }
+      }
+      for (uint32_t i = 0; i != insn->rangeCount; ++i) {
+        uint32_t lo = ranges[i].start, hi = ranges[i].end;
+        // ASCII input has no code units above 127.
+        if (!wide_ && lo > 127)
+          continue;
+        if (lo == hi) {
+          emit.cmpImmToRM<S::L, ScaleRegAccess>(lo, Reg::eax, Reg::NoIndex, 0);
+          cjumpTo<CCode::E>(emit, hit);
+        } else {
+          emit.leaRMToReg<S::L, S::Q>(
+              Reg::rax, Reg::NoIndex, -(int32_t)lo, Reg::ecx);
+          emit.cmpImmToRM<S::L, ScaleRegAccess>(
+              hi - lo, Reg::ecx, Reg::NoIndex, 0);
+          cjumpTo<CCode::BE>(emit, hit);
+        }
+      }
+      if (!insn->negate) {
+        jmpTo(emit, fail);
+        bind(hit, emit.current());
+      } else {
+        Fixups miss;
+        jmpTo(emit, miss);
+        bind(hit, emit.current());
+        jmpTo(emit, fail);
+        bind(miss, emit.current());
+      }
+      break;
+    }
+
+    default:
+      llvm_unreachable("Invalid width 1 opcode");
+  }
+}
+
+uint32_t RegExpJIT::emitInsn(uint32_t offset) {
+  Emitter &fast = fastEmit_;
+  const Insn *base = reinterpret_cast<const Insn *>(insns_ + offset);
+  const uint32_t width = compiledInsnWidth(base);
+
+  // Brackets are compiled to a few instructions per range, and every other
+  // instruction to much less than kMinInstructionSpace.
+  if (!checkSpace(width * 16))
+    return UINT32_MAX;
+  labels_[offset] = fast.current();
+
+  switch (base->opcode) {
+    case Opcode::Goal:
+      fast.jmp<OffsetType::Int32>(matchExit_);
+      break;
+
+    case Opcode::LeftAnchor: {
+      Fixups ok;
+      fast.cmpRmToReg<S::Q, ScaleRegAccess>(RegFirst, Reg::NoIndex, 0, RegPos);
+      cjumpTo<CCode::E>(fast, ok);
+      if (syntaxFlags_ & constants::multiline) {
+        emitLoadChar(fast, RegPos, -1);
+        emitLineTerminatorTest(fast, ok);
+      }
+      fast.jmp<OffsetType::Int32>(backtrack_);
+      bind(ok, fast.current());
+      break;
+    }
+
+    case Opcode::RightAnchor: {
+      Fixups ok;
+      fast.cmpRmToReg<S::Q, ScaleRegAccess>(RegLast, Reg::NoIndex, 0, RegPos);
+      cjumpTo<CCode::E>(fast, ok);
+      if (syntaxFlags_ & constants::multiline) {
+        emitLoadChar(fast, RegPos, 0);
+        emitLineTerminatorTest(fast, ok);
+      }
+      fast.jmp<OffsetType::Int32>(backtrack_);
+      bind(ok, fast.current());
+      break;
+    }
+
+    case Opcode::MatchAnyButNewline:
+    case Opcode::MatchChar8:
+    case Opcode::MatchChar16:
+    case Opcode::Bracket: {
+      Fixups fail;
+      fast.cmpRmToReg<S::Q, ScaleRegAccess>(RegLast, Reg::NoIndex, 0, RegPos);
+      cjumpTo<CCode::AE>(fast, fail);
+      emitLoadChar(fast, RegPos, 0);
+      emitWidth1Test(fast, base, fail);
+      fast.leaRMToReg<S::Q>(RegPos, Reg::NoIndex, charSize_, RegPos);
+      bind(fail, backtrack_);
+      break;
+    }
+
+    case Opcode::MatchNChar8: {
+      const auto *insn = llvm::cast<MatchNChar8Insn>(base);
+      const auto *chars = reinterpret_cast<const uint8_t *>(insn + 1);
+      const int32_t count = insn->charCount;
+      fast.leaRMToReg<S::Q>(
+          RegPos, Reg::NoIndex, count * charSize_, Reg::rax);
+      fast.cmpRmToReg<S::Q, ScaleRegAccess>(RegLast, Reg::NoIndex, 0, Reg::rax);
+      fast.cjump<CCode::A, OffsetType::Int32>(backtrack_);
+      // Compare up to 4 bytes at a time.
+      int32_t i = 0;
+      if (wide_) {
+        for (; i + 2 <= count; i += 2) {
+          fast.cmpImmToRM<S::L>(
+              chars[i] | (uint32_t)chars[i + 1] << 16,
+              RegPos,
+              Reg::NoIndex,
+              i * charSize_);
+          fast.cjump<CCode::NE, OffsetType::Int32>(backtrack_);
+        }
+        if (i < count) {
+          fast.cmpImmToRM<S::W>(chars[i], RegPos, Reg::NoIndex, i * charSize_);
+          fast.cjump<CCode::NE, OffsetType::Int32>(backtrack_);
+        }
+      } else {
+        for (; i + 4 <= count; i += 4) {
+          uint32_t word;
+          memcpy(&word, chars + i, sizeof(word));
+          fast.cmpImmToRM<S::L>(word, RegPos, Reg::NoIndex, i);
+          fast.cjump<CCode::NE, OffsetType::Int32>(backtrack_);
+        }
+        for (; i < count; ++i) {
+          fast.cmpImmToRM<S::B>(chars[i], RegPos, Reg::NoIndex, i);
+          fast.cjump<CCode::NE, OffsetType::Int32>(backtrack_);
+        }
+      }
+      fast.movRegToReg<S::Q>(Reg::rax, RegPos);
+      break;
+    }
+
+    case Opcode::Alternation:
+      emitAlternation(llvm::cast<AlternationInsn>(base));
+      break;
+
+    case Opcode::Jump32:
+      jmpToLabel(fast, llvm::cast<Jump32Insn>(base)->target);
+      break;
+
+    case Opcode::BeginMarkedSubexpression: {
+      const int32_t capture =
+          llvm::cast<BeginMarkedSubexpressionInsn>(base)->mexp * kCaptureSize;
+      // Backtracking past the start of the group unmatches it.
+      fast.leaRMToReg<S::Q>(RegCaptures, Reg::NoIndex, capture, Reg::rdx);
+      emitPush(fast, undoCapture_, 0, RegPos, Reg::rdx);
+      fast.movRegToRM<S::Q>(RegPos, RegCaptures, Reg::NoIndex, capture);
+      break;
+    }
+
+    case Opcode::EndMarkedSubexpression: {
+      const int32_t capture =
+          llvm::cast<EndMarkedSubexpressionInsn>(base)->mexp * kCaptureSize;
+      fast.movRegToRM<S::Q>(RegPos, RegCaptures, Reg::NoIndex, capture + 8);
+      break;
+    }
+
+    case Opcode::WordBoundary:
+      emitWordBoundary(llvm::cast<WordBoundaryInsn>(base));
+      break;
+
+    case Opcode::BeginSimpleLoop: {
+      const auto *insn = llvm::cast<BeginSimpleLoopInsn>(base);
+      // The loopee constraints are only checked when entering the loop.
+      MatchConstraintSet constraints = insn->loopeeConstraints;
+      if (!wide_ && (constraints & MatchConstraintNonASCII)) {
+        jmpToLabel(fast, insn->notTakenTarget);
+      } else if (constraints & MatchConstraintAnchoredAtStart) {
+        fast.cmpRmToReg<S::Q, ScaleRegAccess>(
+            RegFirst, Reg::NoIndex, 0, RegPos);
+        cjumpToLabel<CCode::NE>(fast, insn->notTakenTarget);
+      }
+      // Every iteration may exit the loop instead.
+      loopBodies_[offset] = fast.current();
+      emitPush(fast, nullptr, insn->notTakenTarget, RegPos, RegPos);
+      break;
+    }
+
+    case Opcode::EndSimpleLoop: {
+      auto it = loopBodies_.find(llvm::cast<EndSimpleLoopInsn>(base)->target);
+      if (it == loopBodies_.end()) {
+        error("EndSimpleLoop without BeginSimpleLoop");
+        return UINT32_MAX;
+      }
+      fast.jmp<OffsetType::Auto>(it->second);
+      break;
+    }
+
+    case Opcode::Width1Loop:
+      return emitWidth1Loop(llvm::cast<Width1LoopInsn>(base));
+
+    default:
+      error("unsupported regexp instruction");
+      return UINT32_MAX;
+  }
+  return offset + width;
+}
+
+void RegExpJIT::emitAlternation(const AlternationInsn *insn) {
+  Emitter &fast = fastEmit_;
+  MatchConstraintSet primary = insn->primaryConstraints;
+  MatchConstraintSet secondary = insn->secondaryConstraints;
+  // ASCII input never satisfies the NonASCII constraint, and the
+  // AnchoredAtStart one is checked here.
+  bool primaryViable = wide_ || !(primary & MatchConstraintNonASCII);
+  bool secondaryViable = wide_ || !(secondary & MatchConstraintNonASCII);
+
+  if (!primaryViable) {
+    if (!secondaryViable) {
+      fast.jmp<OffsetType::Int32>(backtrack_);
+      return;
+    }
+    if (secondary & MatchConstraintAnchoredAtStart) {
+      fast.cmpRmToReg<S::Q, ScaleRegAccess>(RegFirst, Reg::NoIndex, 0, RegPos);
+      fast.cjump<CCode::NE, OffsetType::Int32>(backtrack_);
+    }
+    jmpToLabel(fast, insn->secondaryBranch);
+    return;
+  }
+
+  if (secondaryViable) {
+    Fixups skip;
+    if (secondary & MatchConstraintAnchoredAtStart) {
+      fast.cmpRmToReg<S::Q, ScaleRegAccess>(RegFirst, Reg::NoIndex, 0, RegPos);
+      cjumpTo<CCode::NE>(fast, skip);
+    }
+    emitPush(fast, nullptr, insn->secondaryBranch, RegPos, RegPos);
+    bind(skip, fast.current());
+  }
+  if (primary & MatchConstraintAnchoredAtStart) {
+    // Backtrack to the secondary branch, if it was pushed.
+    fast.cmpRmToReg<S::Q, ScaleRegAccess>(RegFirst, Reg::NoIndex, 0, RegPos);
+    fast.cjump<CCode::NE, OffsetType::Int32>(backtrack_);
+  }
+}
+
+void RegExpJIT::emitWordBoundary(const WordBoundaryInsn *insn) {
+  Emitter &fast = fastEmit_;
+  Fixups isWord, notWord;
+
+  // edx is whether the previous code unit is a word character.
+  fast.xorRegToReg<S::L>(Reg::edx, Reg::edx);
+  fast.cmpRmToReg<S::Q, ScaleRegAccess>(RegFirst, Reg::NoIndex, 0, RegPos);
+  cjumpTo<CCode::E>(fast, notWord);
+  emitLoadChar(fast, RegPos, -1);
+  emitClassTest(fast, CharacterClass::Words, isWord);
+  jmpTo(fast, notWord);
+  bind(isWord, fast.current());
+  fast.movImmToReg<S::L>(1, Reg::edx);
+  bind(notWord, fast.current());
+
+  // r11d is whether the current code unit is a word character.
+  fast.xorRegToReg<S::L>(Reg::r11d, Reg::r11d);
+  fast.cmpRmToReg<S::Q, ScaleRegAccess>(RegLast, Reg::NoIndex, 0, RegPos);
+  cjumpTo<CCode::AE>(fast, notWord);
+  emitLoadChar(fast, RegPos, 0);
+  emitClassTest(fast, CharacterClass::Words, isWord);
+  jmpTo(fast, notWord);
+  bind(isWord, fast.current());
+  fast.movImmToReg<S::L>(1, Reg::r11d);
+  bind(notWord, fast.current());
+
+  fast.cmpRmToReg<S::L, ScaleRegAccess>(Reg::r11d, Reg::NoIndex, 0, Reg::edx);
+  if (insn->invert)
+    fast.cjump<CCode::NE, OffsetType::Int32>(backtrack_);
+  else
+    fast.cjump<CCode::E, OffsetType::Int32>(backtrack_);
+}
+
+uint32_t RegExpJIT::emitWidth1Loop(const Width1LoopInsn *insn) {
+  Emitter &fast = fastEmit_;
+  const Insn *body = reinterpret_cast<const Insn *>(insn + 1);
+  Fixups done;
+
+  // Scan the longest run of matching code units, up to r11.
+  if (insn->max == UINT32_MAX) {
+    fast.movRegToReg<S::Q>(RegLast, Reg::r11);
+  } else {
+    Fixups inRange;
+    fast.leaRMToReg<S::Q>(
+        RegPos, Reg::NoIndex, insn->max * charSize_, Reg::r11);
+    fast.cmpRmToReg<S::Q, ScaleRegAccess>(RegLast, Reg::NoIndex, 0, Reg::r11);
+    cjumpTo<CCode::BE>(fast, inRange);
+    fast.movRegToReg<S::Q>(RegLast, Reg::r11);
+    bind(inRange, fast.current());
+  }
+  fast.movRegToReg<S::Q>(RegPos, Reg::rdx);
+  const uint8_t *loop = fast.current();
+  fast.cmpRmToReg<S::Q, ScaleRegAccess>(Reg::r11, Reg::NoIndex, 0, Reg::rdx);
+  cjumpTo<CCode::AE>(fast, done);
+  emitLoadChar(fast, Reg::rdx, 0);
+  emitWidth1Test(fast, body, done);
+  fast.leaRMToReg<S::Q>(Reg::rdx, Reg::NoIndex, charSize_, Reg::rdx);
+  fast.jmp<OffsetType::Auto>(loop);
+  bind(done, fast.current());
+
+  // The run ends at rdx; rax is where the minimum number of iterations end.
+  if (insn->min) {
+    fast.leaRMToReg<S::Q>(
+        RegPos, Reg::NoIndex, insn->min * charSize_, Reg::rax);
+    fast.cmpRmToReg<S::Q, ScaleRegAccess>(Reg::rax, Reg::NoIndex, 0, Reg::rdx);
+    fast.cjump<CCode::B, OffsetType::Int32>(backtrack_);
+  } else {
+    fast.movRegToReg<S::Q>(RegPos, Reg::rax);
+  }
+
+  // Continue at the end of the run if greedy, or after the minimum otherwise,
+  // and backtrack by moving towards the other one. The retry handler is
+  // entered with the position in rbx and the other end of the range in rax.
+  // Backtracking into the loop is common, so it stays in the fast path.
+  Reg from = insn->greedy ? Reg::rdx : Reg::rax;
+  Reg to = insn->greedy ? Reg::rax : Reg::rdx;
+  Fixups start;
+  Fixups exit;
+  jmpTo(fast, start);
+  const uint8_t *retry = fast.current();
+  fast.leaRMToReg<S::Q>(
+      RegPos, Reg::NoIndex, insn->greedy ? -charSize_ : charSize_, RegPos);
+  fast.cmpRmToReg<S::Q, ScaleRegAccess>(Reg::rax, Reg::NoIndex, 0, RegPos);
+  cjumpTo<CCode::E>(fast, exit);
+  emitPush(fast, retry, 0, RegPos, Reg::rax, false);
+  jmpTo(fast, exit);
+
+  bind(start, fast.current());
+  fast.movRegToReg<S::Q>(from, RegPos);
+  fast.cmpRmToReg<S::Q, ScaleRegAccess>(Reg::rax, Reg::NoIndex, 0, Reg::rdx);
+  cjumpTo<CCode::E>(fast, exit);
+  emitPush(fast, retry, 0, from, to);
+  bind(exit, fast.current());
+
+  return insn->notTakenTarget;
+}
+
+void RegExpJIT::disassemble(llvm::raw_ostream &OS) const {
+  OS << "\n\nCompiled Code of RegExp:\n";
+  context_->getDisassembler().disassembleBuffer(
+      OS, {fast_.data(), fastEmit_.current()}, 0, false);
+  OS << "Slow paths:\n";
+  context_->getDisassembler().disassembleBuffer(
+      OS, {slow_.data(), slowEmit_.current()}, 0, false);
+}
+
+} // namespace x86_64
+} // namespace vm
+} // namespace hermes
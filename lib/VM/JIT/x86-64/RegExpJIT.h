@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_X86_64_REGEXPJIT_H
+#define HERMES_VM_JIT_X86_64_REGEXPJIT_H
+
+#include "hermes/Regex/RegexBytecode.h"
+#include "hermes/VM/JIT/JITRegExp.h"
+#include "hermes/VM/JIT/x86-64/Emitter.h"
+#include "hermes/VM/JIT/x86-64/JIT.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Twine.h"
+
+#include <string>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+namespace x86_64 {
+
+/// An instance of this class is constructed to compile the bytecode of a
+/// regexp to native code searching either ASCII or UTF-16 input.
+///
+/// The code is a backtracking matcher like the interpreter in
+/// regex::Context::match(): it tries every start position in turn, and keeps
+/// its alternatives on a stack of (handler, position, aux) entries. Failing
+/// to match pops the last entry and jumps to its handler with the position
+/// and aux restored, which either resumes matching at another branch or
+/// undoes a capture group and backtracks further. It gives up and leaves the
+/// search to the interpreter when the backtracking budget or the stack run
+/// out.
+///
+/// Only the regexps without the icase and unicode flags, whose instructions
+/// match characters, brackets, anchors and word boundaries, or implement
+/// alternations, capture groups, simple loops and width 1 loops, can be
+/// compiled. Back references, lookarounds and general loops stay in the
+/// interpreter.
+class RegExpJIT {
+ public:
+  /// \param wide whether the code searches UTF-16 input rather than ASCII.
+  RegExpJIT(JITContext *context, llvm::ArrayRef<uint8_t> bytecode, bool wide);
+
+  /// \return true if every instruction of \p bytecode can be compiled.
+  static bool canCompile(llvm::ArrayRef<uint8_t> bytecode);
+
+  /// Compile the regexp into the regexp heap of the context.
+  /// \return the entry point of the code, or null on failure.
+  void *compile();
+
+ private:
+  /// A list of the 32-bit displacements of jumps, or of RIP relative
+  /// operands, to a target that isn't known yet.
+  using Fixups = llvm::SmallVector<uint8_t *, 8>;
+
+  /// Raise the error flag and record an error message.
+  void error(const llvm::Twine &msg);
+
+  /// \return true if we can safely write at least \c kMinInstructionSpace
+  ///   bytes plus \p extra in the fast path. Set the error flag and
+  ///   message and return false otherwise.
+  bool checkSpace(size_t extra);
+
+  /// Emit a jump with a 32-bit displacement to be patched by \p fixups.
+  void jmpTo(Emitter &emit, Fixups &fixups);
+
+  /// Emit a conditional jump with a 32-bit displacement to be patched by
+  /// \p fixups.
+  template <CCode cc>
+  void cjumpTo(Emitter &emit, Fixups &fixups);
+
+  /// Point the 32-bit displacement at \p disp to \p target.
+  static void bind(uint8_t *disp, const uint8_t *target);
+
+  /// Point every displacement in \p fixups to \p target and clear them.
+  static void bind(Fixups &fixups, const uint8_t *target);
+
+  /// Emit a jump to the code of the bytecode offset \p target.
+  void jmpToLabel(Emitter &emit, uint32_t target);
+
+  /// Emit a conditional jump to the code of the bytecode offset \p target.
+  template <CCode cc>
+  void cjumpToLabel(Emitter &emit, uint32_t target);
+
+  /// Push a backtracking entry resuming at \p handler, or at the code of the
+  /// bytecode offset \p target if \p handler is null, with the position
+  /// \p pos and the aux value \p aux. Overwrites r11.
+  /// \param checkOverflow whether to fall back to the interpreter if the
+  ///   stack is full, which is unnecessary right after popping an entry.
+  void emitPush(
+      Emitter &emit,
+      const uint8_t *handler,
+      uint32_t target,
+      Reg pos,
+      Reg aux,
+      bool checkOverflow = true);
+
+  /// Emit the epilogue and the exits returning every JITRegExpResult, in the
+  /// slow path.
+  void emitExits();
+
+  /// Emit the prologue, jumping to the first match attempt with a jump to be
+  /// patched by \p toTryStart.
+  void emitPrologue(Fixups &toTryStart);
+
+  /// Emit the advance to the next start position, jumping back to the match
+  /// attempt with a jump to be patched by \p toTryStart, and the
+  /// backtracking routine. They run after every failed attempt, so they are
+  /// in the fast path, next to the code of the regexp.
+  void emitBacktrack(Fixups &toTryStart);
+
+  /// Emit the start of a match attempt, skipping to the next start position
+  /// where a match may begin.
+  void emitTryStart();
+
+  /// Emit the code jumping to \p hit if the code unit in eax is a line
+  /// terminator. Overwrites ecx.
+  void emitLineTerminatorTest(Emitter &emit, Fixups &hit);
+
+  /// Emit the code jumping to \p hit if the code unit in eax belongs to the
+  /// character class \p cls. Overwrites ecx.
+  void emitClassTest(Emitter &emit, uint8_t cls, Fixups &hit);
+
+  /// Emit the code jumping to \p fail unless the code unit in eax matches
+  /// the width 1 instruction \p insn. Overwrites ecx.
+  void emitWidth1Test(Emitter &emit, const regex::Insn *insn, Fixups &fail);
+
+  /// Emit the code of the instruction at \p offset.
+  /// \return the offset of the next instruction to emit.
+  uint32_t emitInsn(uint32_t offset);
+
+  /// Emit the code of a width 1 loop. \return the offset of its exit.
+  uint32_t emitWidth1Loop(const regex::Width1LoopInsn *insn);
+
+  /// Emit the code of an alternation.
+  void emitAlternation(const regex::AlternationInsn *insn);
+
+  /// Emit the code of a word boundary assertion.
+  void emitWordBoundary(const regex::WordBoundaryInsn *insn);
+
+  /// Emit the code loading the code unit at \p offset code units from the
+  /// position in \p base into eax.
+  void emitLoadChar(Emitter &emit, Reg base, int32_t offset);
+
+  /// Disassemble the generated code to \p OS.
+  void disassemble(llvm::raw_ostream &OS) const;
+
+  /// The JITContext we are associated with.
+  JITContext *const context_;
+  /// The bytecode we are compiling, starting with its header.
+  const llvm::ArrayRef<uint8_t> bytecode_;
+  /// The instructions, following the header.
+  const uint8_t *const insns_;
+  /// Whether the input is UTF-16.
+  const bool wide_;
+  /// The size of a code unit of the input.
+  const int32_t charSize_;
+  /// The syntax flags of the regexp.
+  const uint8_t syntaxFlags_;
+
+  /// Minimum number of instruction buffer space we need available before
+  /// every instruction.
+  static constexpr unsigned kMinInstructionSpace = 1024;
+
+  /// Set if an error occurred.
+  bool error_ = false;
+  /// Optional error message, set the first time we record an error.
+  std::string errorMsg_{};
+
+  /// The fast path code, following the bytecode and holding the handlers of
+  /// the backtracking entries, and the slow path code, with the exits.
+  llvm::MutableArrayRef<uint8_t> fast_;
+  llvm::MutableArrayRef<uint8_t> slow_;
+  Emitter fastEmit_{nullptr};
+  Emitter slowEmit_{nullptr};
+
+  /// The code of every instruction emitted so far, by bytecode offset.
+  llvm::DenseMap<uint32_t, const uint8_t *> labels_{};
+  /// The code of every simple loop after its entry check, by the bytecode
+  /// offset of its BeginSimpleLoop, where its EndSimpleLoop jumps to.
+  llvm::DenseMap<uint32_t, const uint8_t *> loopBodies_{};
+  /// Displacements to the code of bytecode offsets, resolved once every
+  /// instruction was emitted.
+  std::vector<std::pair<uint8_t *, uint32_t>> relocs_{};
+
+  /// The code attempting a match at the start position in r12.
+  const uint8_t *tryStart_{nullptr};
+  /// Advances to the next start position, if any.
+  const uint8_t *nextStart_{nullptr};
+  /// Pops a backtracking entry and jumps to its handler.
+  const uint8_t *backtrack_{nullptr};
+  /// The handler of the entries unmatching a capture group.
+  const uint8_t *undoCapture_{nullptr};
+  /// Return a match ending at the current position.
+  const uint8_t *matchExit_{nullptr};
+  /// Return JITRegExpResult::NoMatch.
+  const uint8_t *noMatchExit_{nullptr};
+  /// Return JITRegExpResult::Fallback.
+  const uint8_t *fallbackExit_{nullptr};
+};
+
+} // namespace x86_64
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_X86_64_REGEXPJIT_H
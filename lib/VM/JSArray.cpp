@@ -44,7 +44,7 @@ void ArrayImpl::_snapshotAddEdgesImpl(
       self->indexedStorage_.getNonNull(gc->getPointerBase());
   const auto len = self->endIndex_ - self->beginIndex_;
   for (uint32_t i = 0; i < len; i++) {
-    const auto &elem = indexedStorage->at(i);
+    const auto &elem = indexedStorage->at(self->storageOffset_ + i);
     if (!elem.isPointer()) {
       continue;
     }
@@ -60,6 +60,9 @@ ArrayImpl::ArrayImpl(Deserializer &d, const VTable *vt) : JSObject(d, vt) {
   beginIndex_ = d.readInt<uint32_t>();
   endIndex_ = d.readInt<uint32_t>();
   d.readRelocation(&indexedStorage_, RelocationKind::GCPointer);
+  storageOffset_ = d.readInt<uint32_t>();
+  numEmpty_ = d.readInt<uint32_t>();
+  onlyNumbers_ = d.readInt<uint8_t>();
 }
 
 void serializeArrayImpl(Serializer &s, const GCCell *cell) {
@@ -68,6 +71,9 @@ void serializeArrayImpl(Serializer &s, const GCCell *cell) {
   s.writeInt<uint32_t>(self->beginIndex_);
   s.writeInt<uint32_t>(self->endIndex_);
   s.writeRelocation(self->indexedStorage_.get(s.getRuntime()));
+  s.writeInt<uint32_t>(self->storageOffset_);
+  s.writeInt<uint32_t>(self->numEmpty_);
+  s.writeInt<uint8_t>(self->onlyNumbers_);
 }
 #endif
 
@@ -80,7 +86,7 @@ bool ArrayImpl::_haveOwnIndexedImpl(
   // Check whether the index is within the storage.
   if (index >= self->beginIndex_ && index < self->endIndex_)
     return !self->indexedStorage_.getNonNull(runtime)
-                ->at(index - self->beginIndex_)
+                ->at(self->toStorageIndex(index))
                 .isEmpty();
 
   return false;
@@ -95,7 +101,7 @@ OptValue<PropertyFlags> ArrayImpl::_getOwnIndexedPropertyFlagsImpl(
   // Check whether the index is within the storage.
   if (index >= self->beginIndex_ && index < self->endIndex_ &&
       !self->indexedStorage_.getNonNull(runtime)
-           ->at(index - self->beginIndex_)
+           ->at(self->toStorageIndex(index))
            .isEmpty()) {
     PropertyFlags indexedElementFlags{};
     indexedElementFlags.enumerable = 1;
@@ -151,10 +157,23 @@ ExecutionStatus ArrayImpl::setStorageEndIndex(
         runtime, newStorage.get(), &runtime->getHeap());
     selfHandle->beginIndex_ = 0;
     selfHandle->endIndex_ = newLength;
+    selfHandle->resetElementKind();
+    selfHandle->numEmpty_ = newLength;
     return ExecutionStatus::RETURNED;
   }
 
   auto beginIndex = self->beginIndex_;
+  auto endIndex = self->endIndex_;
+  auto storageOffset = self->storageOffset_;
+
+  // The elements removed from the end may include empty ones.
+  if (newLength >= beginIndex && newLength < endIndex) {
+    auto *storage = self->indexedStorage_.getNonNull(runtime);
+    for (uint32_t i = newLength; i != endIndex; ++i) {
+      if (storage->at(self->toStorageIndex(i)).isEmpty())
+        --self->numEmpty_;
+    }
+  }
 
   /// resizeWithinCapacity can allocate, wrap the indexedStorage in a handle.
   auto indexedStorage =
@@ -163,14 +182,20 @@ ExecutionStatus ArrayImpl::setStorageEndIndex(
   if (newLength < beginIndex) {
     // the new length is prior to beginIndex, clearing the storage.
     selfHandle->endIndex_ = beginIndex;
+    selfHandle->storageOffset_ = 0;
+    selfHandle->resetElementKind();
     StorageType::resizeWithinCapacity(std::move(indexedStorage), runtime, 0);
     return ExecutionStatus::RETURNED;
   } else if (
-      newLength - beginIndex <=
+      storageOffset + newLength - beginIndex <=
       self->indexedStorage_.getNonNull(runtime)->capacity()) {
     selfHandle->endIndex_ = newLength;
+    if (newLength > endIndex)
+      selfHandle->numEmpty_ += newLength - endIndex;
     StorageType::resizeWithinCapacity(
-        std::move(indexedStorage), runtime, newLength - beginIndex);
+        std::move(indexedStorage),
+        runtime,
+        storageOffset + newLength - beginIndex);
     return ExecutionStatus::RETURNED;
   }
 
@@ -178,16 +203,101 @@ ExecutionStatus ArrayImpl::setStorageEndIndex(
       runtime->makeMutableHandle(selfHandle->indexedStorage_);
 
   if (StorageType::resize(
-          indexedStorageHandle, runtime, newLength - beginIndex) ==
+          indexedStorageHandle,
+          runtime,
+          storageOffset + newLength - beginIndex) ==
       ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
   selfHandle->endIndex_ = newLength;
+  if (newLength > endIndex)
+    selfHandle->numEmpty_ += newLength - endIndex;
   selfHandle->indexedStorage_.set(
       runtime, indexedStorageHandle.get(), &runtime->getHeap());
   return ExecutionStatus::RETURNED;
 }
 
+void ArrayImpl::shiftElements(
+    Handle<ArrayImpl> selfHandle,
+    Runtime *runtime,
+    size_type count) {
+  auto *self = selfHandle.get();
+  assert(!self->flags_.noExtend && "this array cannot be extended");
+  assert(
+      self->beginIndex_ == 0 && count <= self->endIndex_ &&
+      "elements out of range");
+  if (count == 0)
+    return;
+
+  // The removed elements become empty slots at the start of the storage.
+  auto *storage = self->indexedStorage_.getNonNull(runtime);
+  for (size_type i = 0; i != count; ++i) {
+    auto &elem = storage->at(self->storageOffset_ + i);
+    if (elem.isEmpty())
+      --self->numEmpty_;
+    elem.setNonPtr(HermesValue::encodeEmptyValue());
+  }
+  self->storageOffset_ += count;
+  self->endIndex_ -= count;
+  if (self->endIndex_ == 0)
+    self->resetElementKind();
+
+  // Once the empty slots outnumber the elements, move the elements down to
+  // the start of the storage. Every element moved is paid for by an element
+  // removed since the last move, and a queue doesn't grow its storage forever.
+  if (self->storageOffset_ >= self->endIndex_) {
+    auto indexedStorageHandle =
+        runtime->makeMutableHandle(self->indexedStorage_);
+    auto res = StorageType::resizeLeft(
+        indexedStorageHandle, runtime, self->endIndex_);
+    (void)res;
+    assert(
+        res != ExecutionStatus::EXCEPTION &&
+        "shrinking the storage cannot fail");
+    selfHandle->storageOffset_ = 0;
+  }
+}
+
+ExecutionStatus ArrayImpl::unshiftElements(
+    Handle<ArrayImpl> selfHandle,
+    Runtime *runtime,
+    size_type count) {
+  auto *self = selfHandle.get();
+  assert(!self->flags_.noExtend && "this array cannot be extended");
+  assert(self->beginIndex_ == 0 && "elements out of range");
+  if (LLVM_UNLIKELY(
+          (uint64_t)self->endIndex_ + count > StorageType::maxElements()))
+    return runtime->raiseRangeError("Out of memory for array elements");
+  if (!self->indexedStorage_ || self->endIndex_ == 0)
+    return setStorageEndIndex(selfHandle, runtime, count);
+
+  if (self->storageOffset_ < count) {
+    // Reserve empty slots for half as many elements again as there are, so
+    // that the elements are only moved once in a while when adding them one
+    // at a time.
+    size_type numElements = self->endIndex_;
+    size_type reserved = std::min(
+        numElements / 2, StorageType::maxElements() - numElements - count);
+    auto indexedStorageHandle =
+        runtime->makeMutableHandle(self->indexedStorage_);
+    if (StorageType::resizeLeft(
+            indexedStorageHandle,
+            runtime,
+            reserved + count + numElements) == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    self = selfHandle.get();
+    self->indexedStorage_.set(
+        runtime, indexedStorageHandle.get(), &runtime->getHeap());
+    self->storageOffset_ = reserved + count;
+  }
+
+  self->storageOffset_ -= count;
+  self->endIndex_ += count;
+  self->numEmpty_ += count;
+  return ExecutionStatus::RETURNED;
+}
+
 CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
     Handle<JSObject> selfHandle,
     Runtime *runtime,
@@ -196,15 +306,17 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
   auto *self = vmcast<ArrayImpl>(selfHandle.get());
   auto beginIndex = self->beginIndex_;
   auto endIndex = self->endIndex_;
+  auto storageOffset = self->storageOffset_;
 
   if (LLVM_UNLIKELY(self->flags_.frozen))
     return false;
 
   // Check whether the index is within the storage.
   if (LLVM_LIKELY(index >= beginIndex && index < endIndex)) {
-    self->indexedStorage_.getNonNull(runtime)
-        ->at(index - beginIndex)
-        .set(value.get(), &runtime->getHeap());
+    auto &elem = self->indexedStorage_.getNonNull(runtime)->at(
+        self->toStorageIndex(index));
+    self->noteElementWrite(elem, value.get());
+    elem.set(value.get(), &runtime->getHeap());
     return true;
   }
 
@@ -222,6 +334,8 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
     self->indexedStorage_.set(runtime, newStorage.get(), &runtime->getHeap());
     self->beginIndex_ = index;
     self->endIndex_ = index + 1;
+    self->resetElementKind();
+    self->noteNewElement(value.get());
     newStorage->at(0).set(value.get(), &runtime->getHeap());
     return true;
   }
@@ -230,21 +344,24 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
       createPseudoHandle(self->indexedStorage_.getNonNull(runtime));
 
   // Can we do it without reallocation for sure?
-  if (index >= endIndex && index - beginIndex < indexedStorage->capacity()) {
+  if (index >= endIndex &&
+      storageOffset + index - beginIndex < indexedStorage->capacity()) {
     self->endIndex_ = index + 1;
+    self->numEmpty_ += index - endIndex;
+    self->noteNewElement(value.get());
     StorageType::resizeWithinCapacity(
-        std::move(indexedStorage), runtime, index - beginIndex + 1);
+        std::move(indexedStorage),
+        runtime,
+        storageOffset + index - beginIndex + 1);
     // Go from selfHandle because the indexedStorage may have changed.
     self = vmcast<ArrayImpl>(selfHandle.get());
     self->indexedStorage_.getNonNull(runtime)
-        ->at(index - beginIndex)
+        ->at(self->toStorageIndex(index))
         .set(value.get(), &runtime->getHeap());
     return true;
   }
 
   auto indexedStorageHandle = runtime->makeMutableHandle(self->indexedStorage_);
-  // We only shift an array if the shift amount is within the limit.
-  constexpr uint32_t shiftLimit = (1 << 20);
 
   // Is the array empty?
   if (LLVM_UNLIKELY(endIndex == beginIndex)) {
@@ -257,14 +374,15 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
     self = vmcast<ArrayImpl>(selfHandle.get());
     self->beginIndex_ = index;
     self->endIndex_ = index + 1;
-  } else if (LLVM_UNLIKELY(
-                 (index > endIndex && index - endIndex > shiftLimit) ||
-                 (index < beginIndex && beginIndex - index > shiftLimit))) {
-    // The new index is too far away from the current index range.
-    // Shifting will lead to a very large allocation.
-    // This is likely a misuse of the array (e.g. use array as an object).
-    // In this case, we should just treat the index access as
-    // a property access.
+    self->storageOffset_ = 0;
+    self->resetElementKind();
+    self->noteNewElement(value.get());
+  } else if (LLVM_UNLIKELY(self->isSparseIndex(runtime, index))) {
+    // The new index is too far away from the current index range, and filling
+    // in the gap would leave the storage mostly empty. Store the element as a
+    // named property instead: those are hashed, so the memory used stays
+    // proportional to the number of elements rather than to the span of their
+    // indices.
     auto vr = valueToSymbolID(
         runtime, runtime->makeHandle(HermesValue::encodeNumberValue(index)));
     assert(
@@ -285,36 +403,126 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
   } else if (index >= endIndex) {
     // Extending to the right.
     if (StorageType::resize(
-            indexedStorageHandle, runtime, index - beginIndex + 1) ==
+            indexedStorageHandle,
+            runtime,
+            storageOffset + index - beginIndex + 1) ==
         ExecutionStatus::EXCEPTION) {
       return ExecutionStatus::EXCEPTION;
     }
     self = vmcast<ArrayImpl>(selfHandle.get());
     self->endIndex_ = index + 1;
-    indexedStorageHandle->at(index - beginIndex)
+    self->numEmpty_ += index - endIndex;
+    self->noteNewElement(value.get());
+    indexedStorageHandle->at(self->toStorageIndex(index))
         .set(value.get(), &runtime->getHeap());
   } else {
-    // Extending to the left. 'index' will become the new 'beginIndex'.
+    // Extending to the left. 'index' will become the new 'beginIndex'. The
+    // empty slots at the start of the storage are used first.
     assert(index < beginIndex);
 
-    if (StorageType::resizeLeft(
-            indexedStorageHandle,
-            runtime,
-            indexedStorageHandle->size() + beginIndex - index) ==
-        ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
+    if (beginIndex - index > storageOffset) {
+      if (StorageType::resizeLeft(
+              indexedStorageHandle,
+              runtime,
+              indexedStorageHandle->size() + beginIndex - index -
+                  storageOffset) == ExecutionStatus::EXCEPTION) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      storageOffset = beginIndex - index;
     }
     self = vmcast<ArrayImpl>(selfHandle.get());
     self->beginIndex_ = index;
-    indexedStorageHandle->at(0).set(value.get(), &runtime->getHeap());
+    self->storageOffset_ = storageOffset - (beginIndex - index);
+    self->numEmpty_ += beginIndex - index - 1;
+    self->noteNewElement(value.get());
+    indexedStorageHandle->at(self->storageOffset_)
+        .set(value.get(), &runtime->getHeap());
   }
 
   // Update the potentially changed pointer.
   self->indexedStorage_.set(
       runtime, indexedStorageHandle.get(), &runtime->getHeap());
+
+  // The storage may now span elements which were stored as named properties
+  // when they were too far away from the others.
+  if (LLVM_UNLIKELY(!self->flags_.fastIndexProperties) &&
+      endIndex != beginIndex) {
+    absorbIndexLikeProperties(Handle<ArrayImpl>::vmcast(selfHandle), runtime);
+  }
   return true;
 }
 
+bool ArrayImpl::isSparseIndex(Runtime *runtime, uint32_t index) const {
+  assert(
+      (index < beginIndex_ || index >= endIndex_) &&
+      "index is already in storage");
+  uint32_t gap =
+      index >= endIndex_ ? index - endIndex_ : beginIndex_ - index - 1;
+  if (gap <= kMaxDenseGap)
+    return false;
+  // Elements stored as named properties count too, so that the array becomes
+  // dense again as it fills up.
+  uint64_t numElements = (uint64_t)(endIndex_ - beginIndex_ - numEmpty_) +
+      getClass(runtime)->getNumProperties();
+  return gap > numElements * kMaxSparseness;
+}
+
+void ArrayImpl::absorbIndexLikeProperties(
+    Handle<ArrayImpl> selfHandle,
+    Runtime *runtime) {
+  // Collect the elements stored as plain named properties within the storage.
+  // The others remain named properties.
+  llvm::SmallVector<std::pair<uint32_t, SymbolID>, 8> toBeAbsorbed;
+  bool remaining = false;
+  uint32_t beginIndex = selfHandle->beginIndex_;
+  uint32_t endIndex = selfHandle->endIndex_;
+  HiddenClass::forEachProperty(
+      runtime->makeHandle(selfHandle->clazz_),
+      runtime,
+      [runtime, beginIndex, endIndex, &toBeAbsorbed, &remaining](
+          SymbolID id, NamedPropertyDescriptor desc) {
+        auto propNameAsIndex = toArrayIndex(
+            runtime->getIdentifierTable().getStringView(runtime, id));
+        if (!propNameAsIndex)
+          return;
+        if (*propNameAsIndex >= beginIndex && *propNameAsIndex < endIndex &&
+            desc.flags == PropertyFlags::defaultNewNamedPropertyFlags()) {
+          toBeAbsorbed.push_back({*propNameAsIndex, id});
+        } else {
+          remaining = true;
+        }
+      });
+
+  for (const auto &prop : toBeAbsorbed) {
+    NamedPropertyDescriptor desc;
+    bool present =
+        JSObject::getOwnNamedDescriptor(selfHandle, runtime, prop.second, desc);
+    (void)present;
+    assert(present && "index-like property disappeared");
+    // The element is empty in storage, since the named property shadows it.
+    auto *self = selfHandle.get();
+    auto value = getNamedSlotValue(self, runtime, desc);
+    auto &elem = self->indexedStorage_.getNonNull(runtime)->at(
+        self->toStorageIndex(prop.first));
+    assert(elem.isEmpty() && "element shadowed by a named property");
+    self->noteElementWrite(elem, value);
+    elem.set(value, &runtime->getHeap());
+    auto cr = JSObject::deleteNamed(selfHandle, runtime, prop.second);
+    (void)cr;
+    assert(
+        cr != ExecutionStatus::EXCEPTION && *cr &&
+        "Failed to delete a configurable property");
+  }
+
+  // Deleting a property turned the class into a dictionary, which only
+  // describes this array.
+  auto *clazz = selfHandle->clazz_.getNonNull(runtime);
+  if (!remaining && clazz->isDictionary()) {
+    clazz->clearHasIndexLikeProperties();
+    selfHandle->flags_.fastIndexProperties = true;
+  }
+}
+
 bool ArrayImpl::_deleteOwnIndexedImpl(
     Handle<JSObject> selfHandle,
     Runtime *runtime,
@@ -323,13 +531,14 @@ bool ArrayImpl::_deleteOwnIndexedImpl(
 
   if (index >= self->beginIndex_ && index < self->endIndex_) {
     auto &elem = self->indexedStorage_.getNonNull(runtime)->at(
-        index - self->beginIndex_);
+        self->toStorageIndex(index));
 
     // Cannot delete indexed elements if we are sealed.
     if (LLVM_UNLIKELY(self->flags_.sealed))
       if (!elem.isEmpty())
         return false;
 
+    self->noteElementWrite(elem, HermesValue::encodeEmptyValue());
     elem.setNonPtr(HermesValue::encodeEmptyValue());
   }
 
@@ -345,8 +554,10 @@ bool ArrayImpl::_checkAllOwnIndexedImpl(
 
   // If we have any indexed properties at all, they don't satisfy the
   // requirements.
-  for (uint32_t i = 0, e = self->endIndex_ - self->beginIndex_; i != e; ++i) {
-    if (!self->indexedStorage_.getNonNull(runtime)->at(i).isEmpty())
+  for (uint32_t i = self->beginIndex_, e = self->endIndex_; i != e; ++i) {
+    if (!self->indexedStorage_.getNonNull(runtime)
+             ->at(self->toStorageIndex(i))
+             .isEmpty())
       return false;
   }
   return true;
@@ -568,7 +779,8 @@ CallResult<HermesValue> JSArray::create(
     Handle<JSObject> prototypeHandle,
     Handle<HiddenClass> classHandle,
     size_type capacity,
-    size_type length) {
+    size_type length,
+    bool pretenure) {
   assert(length <= capacity && "length must be <= capacity");
 
   // Allocate property storage with size corresponding to number of properties
@@ -582,14 +794,16 @@ CallResult<HermesValue> JSArray::create(
   if (capacity) {
     if (LLVM_UNLIKELY(capacity > StorageType::maxElements()))
       return runtime->raiseRangeError("Out of memory for array elements");
-    auto arrRes = StorageType::create(runtime, capacity);
+    auto arrRes = pretenure ? StorageType::createLongLived(runtime, capacity)
+                            : StorageType::create(runtime, capacity);
     if (arrRes == ExecutionStatus::EXCEPTION) {
       return ExecutionStatus::EXCEPTION;
     }
     indexedStorage = vmcast<StorageType>(*arrRes);
   }
 
-  void *mem = runtime->alloc(cellSize<JSArray>());
+  void *mem = pretenure ? runtime->allocPretenured(cellSize<JSArray>())
+                        : runtime->alloc(cellSize<JSArray>());
   JSArray *self = JSObject::allocateSmallPropStorage<JSArrayPropertyCount>(
       new (mem) JSArray(
           runtime,
@@ -603,14 +817,18 @@ CallResult<HermesValue> JSArray::create(
   return HermesValue::encodeObjectValue(self);
 }
 
-CallResult<PseudoHandle<JSArray>>
-JSArray::create(Runtime *runtime, size_type capacity, size_type length) {
+CallResult<PseudoHandle<JSArray>> JSArray::create(
+    Runtime *runtime,
+    size_type capacity,
+    size_type length,
+    bool pretenure) {
   auto res = JSArray::create(
       runtime,
       Handle<JSObject>::vmcast(&runtime->arrayPrototype),
       Handle<HiddenClass>::vmcast(&runtime->arrayClass),
       capacity,
-      length);
+      length,
+      pretenure);
   if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
     return ExecutionStatus::EXCEPTION;
   return PseudoHandle<JSArray>::create(vmcast<JSArray>(*res));
@@ -821,10 +1039,24 @@ CallResult<HermesValue> JSArrayIterator::create(
 CallResult<HermesValue> JSArrayIterator::nextElement(
     Handle<JSArrayIterator> self,
     Runtime *runtime) {
+  MutableHandle<> value{runtime};
+  auto nextRes = nextValue(self, runtime, value);
+  if (LLVM_UNLIKELY(nextRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // Return CreateIterResultObject(result, false), or
+  // CreateIterResultObject(undefined, true) at the end.
+  return createIterResultObject(runtime, value, !*nextRes).getHermesValue();
+}
+
+CallResult<bool> JSArrayIterator::nextValue(
+    Handle<JSArrayIterator> self,
+    Runtime *runtime,
+    MutableHandle<> &value) {
+  value = HermesValue::encodeUndefinedValue();
   if (!self->iteratedObject_) {
     // 5. If a is undefined, return CreateIterResultObject(undefined, true).
-    return createIterResultObject(runtime, Runtime::getUndefinedValue(), true)
-        .getHermesValue();
+    return false;
   }
 
   // 4. Let a be the value of the [[IteratedObject]] internal slot of O.
@@ -843,6 +1075,10 @@ CallResult<HermesValue> JSArrayIterator::nextElement(
       return runtime->raiseTypeError("TypedArray detached during iteration");
     }
     len = ta->getLength();
+  } else if (auto *arr = dyn_vmcast<JSArray>(a.get())) {
+    // The "length" of an Array is its own non-configurable property, which
+    // Get would read without running any code.
+    len = JSArray::getLength(arr);
   } else {
     // 9. Else,
     // a. Let len be ToLength(Get(a, "length")).
@@ -864,8 +1100,7 @@ CallResult<HermesValue> JSArrayIterator::nextElement(
     // undefined.
     self->iteratedObject_ = nullptr;
     // b. Return CreateIterResultObject(undefined, true).
-    return createIterResultObject(runtime, Runtime::getUndefinedValue(), true)
-        .getHermesValue();
+    return false;
   }
 
   // 11. Set the value of the [[ArrayIteratorNextIndex]] internal slot of O to
@@ -876,25 +1111,36 @@ CallResult<HermesValue> JSArrayIterator::nextElement(
 
   if (self->iterationKind_ == IterationKind::Key) {
     // 12. If itemKind is "key", return CreateIterResultObject(index, false).
-    return createIterResultObject(runtime, indexHandle, false).getHermesValue();
+    value = indexHandle.get();
+    return true;
   }
 
   // 13. Let elementKey be ToString(index).
   // 14. Let elementValue be Get(a, elementKey).
-  auto valueRes = JSObject::getComputed_RJS(a, runtime, indexHandle);
-  if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
+  // Elements present in the storage of an Array are its own data properties,
+  // so they can be read directly.
+  HermesValue stored = HermesValue::encodeEmptyValue();
+  if (auto *arr = dyn_vmcast<JSArray>(a.get())) {
+    if (index < arr->getEndIndex())
+      stored = arr->at(runtime, index);
+  }
+  if (!stored.isEmpty()) {
+    value = stored;
+  } else {
+    auto valueRes = JSObject::getComputed_RJS(a, runtime, indexHandle);
+    if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    value = *valueRes;
   }
-  auto valueHandle = runtime->makeHandle(*valueRes);
 
   switch (self->iterationKind_) {
     case IterationKind::Key:
       llvm_unreachable("Early return already occurred in Key case");
-      return HermesValue::encodeEmptyValue();
+      return false;
     case IterationKind::Value:
       // 16. If itemKind is "value", let result be elementValue.
-      return createIterResultObject(runtime, valueHandle, false)
-          .getHermesValue();
+      return true;
     case IterationKind::Entry: {
       // 17. b. Let result be CreateArrayFromList(«index, elementValue»).
       auto resultRes = JSArray::create(runtime, 2, 2);
@@ -903,17 +1149,18 @@ CallResult<HermesValue> JSArrayIterator::nextElement(
       }
       Handle<JSArray> result = toHandle(runtime, std::move(*resultRes));
       JSArray::setElementAt(result, runtime, 0, indexHandle);
-      JSArray::setElementAt(result, runtime, 1, valueHandle);
+      JSArray::setElementAt(result, runtime, 1, value);
       // 18. Return CreateIterResultObject(result, false).
-      return createIterResultObject(runtime, result, false).getHermesValue();
+      value = result.getHermesValue();
+      return true;
     }
     case IterationKind::NumKinds:
       llvm_unreachable("Invalid iteration kind");
-      return HermesValue::encodeEmptyValue();
+      return false;
   }
 
   llvm_unreachable("Invalid iteration kind");
-  return HermesValue::encodeEmptyValue();
+  return false;
 }
 
 } // namespace vm
@@ -7,9 +7,11 @@
 
 #include "hermes/VM/JSArrayBuffer.h"
 
+#include "hermes/Support/OSCompat.h"
 #include "hermes/VM/BuildMetadata.h"
 
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
 #define DEBUG_TYPE "serialize"
 
 namespace hermes {
@@ -47,7 +49,12 @@ void ArrayBufferBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
 
 #ifdef HERMESVM_SERIALIZE
 JSArrayBuffer::JSArrayBuffer(Deserializer &d)
-    : JSObject(d, &vt.base), data_(nullptr), size_(0), attached_(false) {
+    : JSObject(d, &vt.base),
+      data_(nullptr),
+      size_(0),
+      attached_(false),
+      mapped_(false),
+      externalRelease_(nullptr) {
   size_type size = d.readInt<size_type>();
   attached_ = d.readInt<uint8_t>();
   if (!attached_) {
@@ -163,13 +170,16 @@ JSArrayBuffer::JSArrayBuffer(
     : JSObject(runtime, &vt.base, parent, clazz),
       data_(nullptr),
       size_(0),
-      attached_(false) {}
+      attached_(false),
+      mapped_(false),
+      externalRelease_(nullptr) {}
 
 JSArrayBuffer::~JSArrayBuffer() {
   // We expect this finalizer to be called only by _finalizerImpl,
   // below.  That detaches the buffer; here we just assert that it
   // has been detached, and that resources have been deallocated.
-  assert(!attached_ && !data_ && size_ == 0);
+  assert(
+      !attached_ && !data_ && size_ == 0 && !mapped_ && !externalRelease_);
 }
 
 void JSArrayBuffer::_finalizeImpl(GCCell *cell, GC *gc) {
@@ -228,11 +238,22 @@ void JSArrayBuffer::_snapshotAddNodesImpl(
 void JSArrayBuffer::detach(GC *gc) {
   if (data_) {
     gc->debitExternalMemory(this, size_);
-    free(data_);
+    if (mapped_)
+      oscompat::vm_free(data_, llvm::alignTo(size_, oscompat::page_size()));
+    else if (!externalRelease_)
+      gc->freeNativeMemory(data_);
     data_ = nullptr;
     size_ = 0;
+    mapped_ = false;
   } else {
-    assert(size_ == 0);
+    assert(size_ == 0 && !mapped_);
+  }
+  if (externalRelease_) {
+    // Hand the data block back to the embedder.
+    std::unique_ptr<std::function<void()>> release{externalRelease_};
+    externalRelease_ = nullptr;
+    if (*release)
+      (*release)();
   }
   // Note that whether a buffer is attached is independent of whether
   // it has allocated data.
@@ -257,20 +278,53 @@ JSArrayBuffer::createDataBlock(Runtime *runtime, size_type size, bool zero) {
         "Cannot allocate a data block for the ArrayBuffer");
   }
 
-  // Note that the result of calloc or malloc is immediately checked below, so
-  // we don't use the checked versions.
-  data_ = zero ? static_cast<uint8_t *>(calloc(sizeof(uint8_t), size))
-               : static_cast<uint8_t *>(malloc(sizeof(uint8_t) * size));
-  if (data_ == nullptr) {
-    // Failed to allocate.
-    return runtime->raiseRangeError(
-        "Cannot allocate a data block for the ArrayBuffer");
+  if (zero && size >= kMinMappedSize) {
+    // Freshly mapped pages read as zero, and are only backed by memory once
+    // they are touched.
+    auto result =
+        oscompat::vm_allocate(llvm::alignTo(size, oscompat::page_size()));
+    if (!result) {
+      return runtime->raiseRangeError(
+          "Cannot allocate a data block for the ArrayBuffer");
+    }
+    data_ = static_cast<uint8_t *>(*result);
+    mapped_ = true;
   } else {
-    attached_ = true;
-    size_ = size;
-    runtime->getHeap().creditExternalMemory(this, size);
-    return ExecutionStatus::RETURNED;
+    // Note that the result of calloc or malloc is immediately checked below,
+    // so we don't use the checked versions.
+    data_ = zero ? static_cast<uint8_t *>(calloc(sizeof(uint8_t), size))
+                 : static_cast<uint8_t *>(malloc(sizeof(uint8_t) * size));
+    if (data_ == nullptr) {
+      // Failed to allocate.
+      return runtime->raiseRangeError(
+          "Cannot allocate a data block for the ArrayBuffer");
+    }
+  }
+  attached_ = true;
+  size_ = size;
+  runtime->getHeap().creditExternalMemory(this, size);
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus JSArrayBuffer::setExternalDataBlock(
+    Runtime *runtime,
+    uint8_t *data,
+    size_type size,
+    std::function<void()> release) {
+  detach(&runtime->getHeap());
+  // As in createDataBlock, sizes are limited to 32 bits.
+  if (LLVM_UNLIKELY(size > std::numeric_limits<uint32_t>::max())) {
+    if (release)
+      release();
+    return runtime->raiseRangeError(
+        "Cannot use a data block of this size for the ArrayBuffer");
   }
+  externalRelease_ = new std::function<void()>(std::move(release));
+  data_ = data;
+  size_ = size;
+  attached_ = true;
+  runtime->getHeap().creditExternalMemory(this, size);
+  return ExecutionStatus::RETURNED;
 }
 
 } // namespace vm
@@ -39,7 +39,7 @@ ObjectVTable JSError::vt{
 void ErrorBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
   ObjectBuildMeta(cell, mb);
   const auto *self = static_cast<const JSError *>(cell);
-  mb.addField("funcNames", &self->funcNames_);
+  mb.addField("callees", &self->callees_);
   mb.addField("domains", &self->domains_);
 }
 
@@ -58,13 +58,13 @@ void ErrorSerialize(Serializer &s, const GCCell *cell) {
     ArrayStorage::serializeArrayStorage(s, self->domains_.get(s.getRuntime()));
   }
 
-  // funcNames_ : GCPointer<PropStorage> is also ArrayStorage. Serialize it with
+  // callees_ : GCPointer<PropStorage> is also ArrayStorage. Serialize it with
   // JSError.
-  hasArray = (bool)self->funcNames_;
+  hasArray = (bool)self->callees_;
   s.writeInt<uint8_t>(hasArray);
   if (hasArray) {
     ArrayStorage::serializeArrayStorage(
-        s, self->funcNames_.get(s.getRuntime()));
+        s, self->callees_.get(s.getRuntime()));
   }
   s.writeInt<uint8_t>(self->catchable_);
   s.endObject(cell);
@@ -88,9 +88,9 @@ JSError::JSError(Deserializer &d) : JSObject(d, &vt.base) {
         &d.getRuntime()->getHeap());
   }
 
-  // Deserialize funcNames_.
+  // Deserialize callees_.
   if (d.readInt<uint8_t>()) {
-    funcNames_.set(
+    callees_.set(
         d.getRuntime(),
         ArrayStorage::deserializeArrayStorage(d),
         &d.getRuntime()->getHeap());
@@ -123,11 +123,13 @@ errorStackGetter(void *, Runtime *runtime, NativeArgs args) {
   }
 
 // After the stacktrace string is constructed, only the debugger may want the
-// internal stacktrace_; if there is no debugger it can be freed. We no longer
+// internal stacktrace_; if there is no debugger it can be freed. The callees
+// are no longer needed either, and should not be kept alive. We no longer
 // need the accessor. Redefines the stack property to a regular property.
 #ifndef HERMES_ENABLE_DEBUGGER
   selfHandle->stacktrace_.reset();
 #endif
+  selfHandle->callees_ = nullptr;
 
   MutableHandle<> stacktraceStr{runtime};
   auto strRes = StringPrimitive::create(runtime, stack);
@@ -163,6 +165,7 @@ errorStackSetter(void *, Runtime *runtime, NativeArgs args) {
       // Release stacktrace_ if it's already set.
       stacktrace.reset();
     }
+    errorObject->callees_ = nullptr;
   }
   auto res = toObject(runtime, args.getThisHandle());
   if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
@@ -297,65 +300,6 @@ ExecutionStatus JSError::setMessage(
       .getStatus();
 }
 
-/// \return a list of function names associated with the call stack \p frames.
-/// Function names are read out of the 'name' property of each Callable on the
-/// stack, except that accessors are skipped. If a Callable does not have a
-/// name, or if the name is an accessor, undefined is set. Names are returned in
-/// reverse order (topmost frame is first).
-/// In case of error returns a nullptr handle.
-/// \param skipTopFrame if true, skip the top frame.
-static Handle<PropStorage> getCallStackFunctionNames(
-    Runtime *runtime,
-    bool skipTopFrame,
-    size_t sizeHint) {
-  auto arrRes = PropStorage::create(runtime, sizeHint);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
-    runtime->clearThrownValue();
-    return Runtime::makeNullHandle<PropStorage>();
-  }
-  MutableHandle<PropStorage> names{runtime, vmcast<PropStorage>(*arrRes)};
-
-  GCScope gcScope(runtime);
-  MutableHandle<> name{runtime};
-  auto marker = gcScope.createMarker();
-
-  uint32_t frameIndex = 0;
-  uint32_t namesIndex = 0;
-  for (StackFramePtr cf : runtime->getStackFrames()) {
-    if (frameIndex++ == 0 && skipTopFrame)
-      continue;
-
-    name = HermesValue::encodeUndefinedValue();
-    if (auto callableHandle = Handle<Callable>::dyn_vmcast(
-            Handle<>(&cf.getCalleeClosureOrCBRef()))) {
-      NamedPropertyDescriptor desc;
-      JSObject *propObj = JSObject::getNamedDescriptor(
-          callableHandle,
-          runtime,
-          Predefined::getSymbolID(Predefined::name),
-          desc);
-      if (propObj && !desc.flags.accessor)
-        name = JSObject::getNamedSlotValue(propObj, runtime, desc);
-    } else if (cf.getCalleeClosureOrCBRef().isNativeValue()) {
-      auto *cb =
-          cf.getCalleeClosureOrCBRef().getNativePointer<const CodeBlock>();
-      if (cb->getNameMayAllocate().isValid())
-        name = HermesValue::encodeStringValue(
-            runtime->getStringPrimFromSymbolID(cb->getNameMayAllocate()));
-    }
-    if (PropStorage::resize(names, runtime, namesIndex + 1) ==
-        ExecutionStatus::EXCEPTION) {
-      runtime->clearThrownValue();
-      return Runtime::makeNullHandle<PropStorage>();
-    }
-    names->at(namesIndex).set(name.getHermesValue(), &runtime->getHeap());
-    ++namesIndex;
-    gcScope.flushToMarker(marker);
-  }
-
-  return std::move(names);
-}
-
 ExecutionStatus JSError::recordStackTrace(
     Handle<JSError> selfHandle,
     Runtime *runtime,
@@ -374,6 +318,10 @@ ExecutionStatus JSError::recordStackTrace(
     return ExecutionStatus::RETURNED;
   }
 
+  // Exceptions used for control flow are created much more often than their
+  // stack is read, so only the location and the callee of every frame are
+  // recorded here. Everything else is computed by errorStackGetter.
+  const unsigned maxDepth = runtime->getMaxStackTraceDepth();
   StackTracePtr stack{new StackTrace()};
   auto domainsRes = ArrayStorage::create(runtime, 1);
   if (LLVM_UNLIKELY(domainsRes == ExecutionStatus::EXCEPTION)) {
@@ -381,6 +329,12 @@ ExecutionStatus JSError::recordStackTrace(
   }
   auto domains = runtime->makeMutableHandle<ArrayStorage>(
       vmcast<ArrayStorage>(*domainsRes));
+  auto calleesRes = PropStorage::create(runtime, 8);
+  if (LLVM_UNLIKELY(calleesRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto callees = runtime->makeMutableHandle<PropStorage>(
+      vmcast<PropStorage>(*calleesRes));
 
   // Add the domain to the domains list, provided that it's not the same as the
   // last domain in the list. This allows us to save storage with a constant
@@ -398,59 +352,72 @@ ExecutionStatus JSError::recordStackTrace(
     return ArrayStorage::push_back(domains, runtime, domain);
   };
 
-  if (!skipTopFrame) {
-    if (codeBlock) {
-      stack->emplace_back(codeBlock, codeBlock->getOffsetOf(ip));
-      if (LLVM_UNLIKELY(addDomain(codeBlock) == ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    } else {
-      stack->emplace_back(nullptr, 0);
+  // Record the location \p offset in \p codeBlock, which may be null for a
+  // native function, and the callee of the frame \p cf it is in. Only
+  // Callables are kept, so that their name can be read later; the name of a
+  // CodeBlock is found from the location.
+  auto addFrame = [&stack, &callees, &addDomain, runtime](
+                      StackFramePtr cf,
+                      CodeBlock *codeBlock,
+                      uint32_t offset) -> ExecutionStatus {
+    stack->emplace_back(codeBlock, offset);
+    if (codeBlock &&
+        LLVM_UNLIKELY(addDomain(codeBlock) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
-  }
+    GCScopeMarkerRAII marker{runtime};
+    Handle<> callee = vmisa<Callable>(cf.getCalleeClosureOrCBRef())
+        ? Handle<>(&cf.getCalleeClosureOrCBRef())
+        : Runtime::getUndefinedValue();
+    return PropStorage::push_back(callees, runtime, callee);
+  };
+
+  const StackFramePtr framesEnd = *frames.end();
 
-  const StackFramePtr framesEnd = *runtime->getStackFrames().end();
+  if (!skipTopFrame && frames.begin() != frames.end()) {
+    if (LLVM_UNLIKELY(
+            addFrame(
+                *frames.begin(),
+                codeBlock,
+                codeBlock ? codeBlock->getOffsetOf(ip) : 0) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
 
   // Fill in the call stack.
   // Each stack frame tracks information about the caller.
-  for (StackFramePtr cf : runtime->getStackFrames()) {
+  for (StackFramePtr cf : frames) {
+    if (maxDepth && stack->size() >= maxDepth)
+      break;
+    // The outermost frame has no caller to record.
+    StackFramePtr prev = cf->getPreviousFrame();
+    if (!prev || prev == framesEnd)
+      break;
     CodeBlock *savedCodeBlock = cf.getSavedCodeBlock();
     const Inst *const savedIP = cf.getSavedIP();
     // Go up one frame and get the callee code block but use the current
     // frame's saved IP. This also allows us to account for bound functions,
     // which have savedCodeBlock == nullptr in order to allow proper returns in
     // the interpreter.
-    StackFramePtr prev = cf->getPreviousFrame();
-    if (prev && prev != framesEnd) {
-      if (CodeBlock *parentCB = prev->getCalleeCodeBlock()) {
-        savedCodeBlock = parentCB;
-      }
+    if (CodeBlock *parentCB = prev->getCalleeCodeBlock()) {
+      savedCodeBlock = parentCB;
     }
-    if (savedCodeBlock && savedIP) {
-      stack->emplace_back(savedCodeBlock, savedCodeBlock->getOffsetOf(savedIP));
-      if (LLVM_UNLIKELY(
-              addDomain(savedCodeBlock) == ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    } else {
-      stack->emplace_back(nullptr, 0);
+    ExecutionStatus status = savedCodeBlock && savedIP
+        ? addFrame(prev, savedCodeBlock, savedCodeBlock->getOffsetOf(savedIP))
+        : addFrame(prev, nullptr, 0);
+    if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
   }
-  selfHandle->domains_.set(runtime, domains.get(), &runtime->getHeap());
-
-  // Remove the last entry.
-  stack->pop_back();
-
-  auto funcNames =
-      getCallStackFunctionNames(runtime, skipTopFrame, stack->size());
 
-  // Either the function names is empty, or they have the same count.
   assert(
-      (!funcNames || funcNames->size() == stack->size()) &&
-      "Function names and stack trace must have same size.");
+      callees->size() == stack->size() &&
+      "Callees and stack trace must have same size.");
 
+  selfHandle->domains_.set(runtime, domains.get(), &runtime->getHeap());
   selfHandle->stacktrace_ = std::move(stack);
-  selfHandle->funcNames_.set(runtime, *funcNames, &runtime->getHeap());
+  selfHandle->callees_.set(runtime, callees.get(), &runtime->getHeap());
   return ExecutionStatus::RETURNED;
 }
 
@@ -478,13 +445,24 @@ bool JSError::appendFunctionNameAtIndex(
   MutableHandle<StringPrimitive> name{
       runtime, runtime->getPredefinedString(Predefined::emptyString)};
 
-  // If funcNames_ is set and contains a string primitive, use that.
-  if (selfHandle->funcNames_) {
+  // If callees_ is set and contains a Callable whose 'name' property is a
+  // string primitive, use that. Accessors are skipped.
+  if (selfHandle->callees_) {
     assert(
-        index < selfHandle->funcNames_.get(runtime)->size() &&
+        index < selfHandle->callees_.get(runtime)->size() &&
         "Index out of bounds");
-    name = dyn_vmcast<StringPrimitive>(
-        selfHandle->funcNames_.get(runtime)->at(index));
+    if (auto callableHandle = Handle<Callable>::dyn_vmcast(runtime->makeHandle(
+            selfHandle->callees_.get(runtime)->at(index)))) {
+      NamedPropertyDescriptor desc;
+      JSObject *propObj = JSObject::getNamedDescriptor(
+          callableHandle,
+          runtime,
+          Predefined::getSymbolID(Predefined::name),
+          desc);
+      if (propObj && !desc.flags.accessor)
+        name = dyn_vmcast<StringPrimitive>(
+            JSObject::getNamedSlotValue(propObj, runtime, desc));
+    }
   }
 
   if (!name || name->getStringLength() == 0) {
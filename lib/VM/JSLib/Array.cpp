@@ -17,6 +17,8 @@
 #include "hermes/VM/StringRefUtils.h"
 #include "hermes/VM/StringView.h"
 
+#include <algorithm>
+
 namespace hermes {
 namespace vm {
 
@@ -135,7 +137,6 @@ Handle<JSObject> createArrayConstructor(Runtime *runtime) {
       arrayIsArray,
       1);
 
-#ifndef HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
   defineMethod(
       runtime,
       arrayPrototype,
@@ -287,7 +288,6 @@ Handle<JSObject> createArrayConstructor(Runtime *runtime) {
         arrayFrom,
         1);
   }
-#endif // HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
 
   return cons;
 }
@@ -912,19 +912,72 @@ arrayPrototypePush(void *, Runtime *runtime, NativeArgs args) {
   return len.get();
 }
 
+/// \return the element \p k of \p O if it is held in the storage of an array,
+/// which makes it a plain data property, or empty if it must be looked up.
+/// The callbacks of the iteration methods may change the array, so this is
+/// checked again for every element.
+static inline HermesValue
+getStoredElement(Runtime *runtime, Handle<JSObject> O, double k) {
+  auto *arr = dyn_vmcast<JSArray>(O.get());
+  if (!arr || !arr->hasFastIndexProperties() || k >= arr->getEndIndex())
+    return HermesValue::encodeEmptyValue();
+  return arr->at(runtime, (uint32_t)k);
+}
+
+/// \return \p O if it is an array holding all of its first \p len elements in
+/// its storage, or null otherwise.
+static inline JSArray *getPackedArray(Handle<JSObject> O, uint64_t len) {
+  auto *arr = dyn_vmcast<JSArray>(O.get());
+  return arr && arr->isPackedUpTo(len) ? arr : nullptr;
+}
+
+/// \return \p O if it is a packed array, as with getPackedArray(), of length
+/// \p len, whose first elements can be removed or inserted by moving the start
+/// of its storage without any observable difference: it can be extended and
+/// its length is writable. If \p inserting, no object on its prototype chain
+/// has indexed properties either, since storing the new elements would look
+/// them up. \return null otherwise.
+static JSArray *getDequeArray(
+    Runtime *runtime,
+    Handle<JSObject> O,
+    uint64_t len,
+    bool inserting) {
+  JSArray *arr = getPackedArray(O, len);
+  if (!arr || arr->getEndIndex() != len || !arr->isExtensible())
+    return nullptr;
+
+  NamedPropertyDescriptor lengthDesc;
+  bool lengthPresent = JSObject::getOwnNamedDescriptor(
+      O, runtime, Predefined::getSymbolID(Predefined::length), lengthDesc);
+  (void)lengthPresent;
+  assert(lengthPresent && ".length must be present in JSArray");
+  if (!lengthDesc.flags.writable)
+    return nullptr;
+
+  if (inserting) {
+    for (JSObject *proto = O->getParent(runtime); proto;
+         proto = proto->getParent(runtime)) {
+      if (proto->isHostObject() || proto->isLazy() ||
+          proto->getClass(runtime)->getHasIndexLikeProperties())
+        return nullptr;
+      auto range = JSObject::getOwnIndexedRange(proto, runtime);
+      if (range.first != range.second)
+        return nullptr;
+    }
+  }
+  return vmcast<JSArray>(O.get());
+}
+
 namespace {
-/// General object sorting model used by custom sorting routines.
-/// Provides a model by which to less and swap elements, using the [[Get]],
-/// [[Put]], and [[Delete]] internal methods of a supplied Object. Should be
-/// allocated on the stack, because it creates its own internal GCScope, with
-/// reusable MutableHandle<>-s that are used in the less and swap methods.
-/// These allow for quick accesses without allocating a great number of new
-/// handles every time we want to compare different elements.
+/// Sorting model over the elements collected by Array.prototype.sort from the
+/// object being sorted, which are held in an array that is never exposed to
+/// JS. Only comparing them may run JS; swapping them is cheap.
+/// Should be allocated on the stack, because it creates its own internal
+/// GCScope, with reusable MutableHandle<>-s that are used in the less method.
 /// Usage example:
-///   StandardSortModel sm{runtime, obj, compareFn};
-///   quickSort(sm, 0, length);
-/// Note that this is generic and does nothing different if passed a JSArray.
-class StandardSortModel : public SortModel {
+///   CollectedSortModel sm{runtime, items, compareFn};
+///   stableSort(sm, 0, length);
+class CollectedSortModel : public SortModel {
  private:
   /// Runtime to sort in.
   Runtime *runtime_;
@@ -936,161 +989,57 @@ class StandardSortModel : public SortModel {
   /// If null, then use the built in < operator.
   Handle<Callable> compareFn_;
 
-  /// Object to sort elements [0, length).
-  Handle<JSObject> obj_;
-
-  /// Preallocate handles in the current GCScope so that we don't have to make
-  /// new handles in every method call.
-
-  /// Handles for two indices.
-  MutableHandle<> aHandle_;
-  MutableHandle<> bHandle_;
+  /// The elements to sort, which has no holes.
+  Handle<JSArray> items_;
 
   /// Handles for the values at two indices.
   MutableHandle<> aValue_;
   MutableHandle<> bValue_;
 
-  /// Handles for the objects the values are retrieved from.
-  MutableHandle<JSObject> aDescObjHandle_;
-  MutableHandle<JSObject> bDescObjHandle_;
+  /// The call of compareFn, if it isn't null, prepared once for all the
+  /// comparisons.
+  llvm::Optional<PreparedCall> compareCall_;
 
   /// Marker created after initializing all fields so handles allocated later
   /// can be flushed.
   GCScope::Marker gcMarker_;
 
  public:
-  StandardSortModel(
+  CollectedSortModel(
       Runtime *runtime,
-      Handle<JSObject> obj,
+      Handle<JSArray> items,
       Handle<Callable> compareFn)
       : runtime_(runtime),
         gcScope_(runtime),
         compareFn_(compareFn),
-        obj_(obj),
-        aHandle_(runtime),
-        bHandle_(runtime),
+        items_(items),
         aValue_(runtime),
         bValue_(runtime),
-        aDescObjHandle_(runtime),
-        bDescObjHandle_(runtime),
-        gcMarker_(gcScope_.createMarker()) {}
-
-  /// Use getComputed and putComputed to swap the values at obj[a] and obj[b].
-  ExecutionStatus swap(uint32_t a, uint32_t b) override {
-    // Ensure that we don't leave here with any new handles.
-    GCScopeMarkerRAII gcMarker{gcScope_, gcMarker_};
-
-    aHandle_ = HermesValue::encodeDoubleValue(a);
-    bHandle_ = HermesValue::encodeDoubleValue(b);
-
-    ComputedPropertyDescriptor aDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        obj_, runtime_, aHandle_, aDescObjHandle_, aDesc);
-
-    ComputedPropertyDescriptor bDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        obj_, runtime_, bHandle_, bDescObjHandle_, bDesc);
-
-    if (aDescObjHandle_) {
-      auto res = JSObject::getComputedPropertyValue_RJS(
-          obj_, runtime_, aDescObjHandle_, aDesc);
-      if (res == ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      aValue_ = res.getValue();
-    }
-    if (bDescObjHandle_) {
-      auto res = JSObject::getComputedPropertyValue_RJS(
-          obj_, runtime_, bDescObjHandle_, bDesc);
-      if (res == ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      bValue_ = res.getValue();
-    }
-
-    if (bDescObjHandle_) {
-      if (LLVM_UNLIKELY(
-              JSObject::putComputed_RJS(
-                  obj_,
-                  runtime_,
-                  aHandle_,
-                  bValue_,
-                  PropOpFlags().plusThrowOnError()) ==
-              ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    } else {
-      if (LLVM_UNLIKELY(
-              JSObject::deleteComputed(
-                  obj_, runtime_, aHandle_, PropOpFlags().plusThrowOnError()) ==
-              ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    }
-
-    if (aDescObjHandle_) {
-      if (LLVM_UNLIKELY(
-              JSObject::putComputed_RJS(
-                  obj_,
-                  runtime_,
-                  bHandle_,
-                  aValue_,
-                  PropOpFlags().plusThrowOnError()) ==
-              ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    } else {
-      if (LLVM_UNLIKELY(
-              JSObject::deleteComputed(
-                  obj_, runtime_, bHandle_, PropOpFlags().plusThrowOnError()) ==
-              ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
+        gcMarker_(gcScope_.createMarker()) {
+    if (compareFn_) {
+      compareCall_.emplace(
+          runtime, compareFn_, Runtime::getUndefinedValue(), 2);
     }
+  }
 
+  /// Swap the elements a and b in storage.
+  ExecutionStatus swap(uint32_t a, uint32_t b) override {
+    HermesValue aValue = items_->at(runtime_, a);
+    JSArray::unsafeSetExistingElementAt(
+        items_.get(), runtime_, a, items_->at(runtime_, b));
+    JSArray::unsafeSetExistingElementAt(items_.get(), runtime_, b, aValue);
     return ExecutionStatus::RETURNED;
   }
 
-  /// If compareFn isn't null, return compareFn(obj[a], obj[b]) < 0.
-  /// If compareFn is null, return obj[a] < obj[b].
+  /// If compareFn isn't null, return compareFn(items[a], items[b]) < 0.
+  /// If compareFn is null, return items[a] < items[b].
   CallResult<bool> less(uint32_t a, uint32_t b) override {
     // Ensure that we don't leave here with any new handles.
     GCScopeMarkerRAII gcMarker{gcScope_, gcMarker_};
 
-    aHandle_ = HermesValue::encodeDoubleValue(a);
-    bHandle_ = HermesValue::encodeDoubleValue(b);
-
-    ComputedPropertyDescriptor aDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        obj_, runtime_, aHandle_, aDescObjHandle_, aDesc);
-    if (!aDescObjHandle_) {
-      // Spec defines empty as greater than everything.
-      return false;
-    }
-
-    auto propRes = JSObject::getComputedPropertyValue_RJS(
-        obj_, runtime_, aDescObjHandle_, aDesc);
-    if (propRes == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
-    aValue_ = propRes.getValue();
-    assert(!aValue_->isEmpty());
-
-    ComputedPropertyDescriptor bDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        obj_, runtime_, bHandle_, bDescObjHandle_, bDesc);
-    if (!bDescObjHandle_) {
-      // Spec defines empty as greater than everything.
-      return true;
-    }
-
-    if ((propRes = JSObject::getComputedPropertyValue_RJS(
-             obj_, runtime_, bDescObjHandle_, bDesc)) ==
-        ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
-    bValue_ = propRes.getValue();
-    assert(!bValue_->isEmpty());
+    aValue_ = items_->at(runtime_, a);
+    bValue_ = items_->at(runtime_, b);
+    assert(!aValue_->isEmpty() && !bValue_->isEmpty());
 
     if (aValue_->isUndefined()) {
       // Spec defines undefined as greater than everything.
@@ -1103,12 +1052,11 @@ class StandardSortModel : public SortModel {
 
     if (compareFn_) {
       // If we have a compareFn, just use that.
-      auto callRes = Callable::executeCall2(
-          compareFn_,
-          runtime_,
-          Runtime::getUndefinedValue(),
-          aValue_.get(),
-          bValue_.get());
+      if (LLVM_UNLIKELY(compareCall_->overflowed())) {
+        return runtime_->raiseStackOverflow(
+            Runtime::StackOverflowKind::NativeStack);
+      }
+      auto callRes = compareCall_->call(aValue_.get(), bValue_.get());
       if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
@@ -1135,9 +1083,62 @@ class StandardSortModel : public SortModel {
     }
   }
 };
+
+/// The string a number is compared by when sorting without a comparator.
+struct NumberSortKey {
+  char chars[NUMBER_TO_STRING_BUF_SIZE];
+  uint8_t length;
+  HermesValue value;
+
+  bool operator<(const NumberSortKey &other) const {
+    return std::lexicographical_compare(
+        chars, chars + length, other.chars, other.chars + other.length);
+  }
+};
 } // anonymous namespace
 
-/// ES5.1 15.4.4.11.
+/// Sort the first \p len elements of \p arr without a comparator, if they are
+/// all numbers or all strings, by comparing them directly instead of through
+/// the generic model, which converts both elements to strings for every
+/// comparison. Numbers are converted once, to their sort key.
+/// \return true if the elements were sorted, false if they must be sorted
+///   generically.
+static bool trySortPrimitives(Runtime *runtime, JSArray *arr, uint32_t len) {
+  NoAllocScope noAlloc{runtime};
+  if (arr->getElementKind() == ArrayImpl::ElementKind::PackedNumber) {
+    std::vector<NumberSortKey> keys(len);
+    for (uint32_t i = 0; i != len; ++i) {
+      NumberSortKey &key = keys[i];
+      key.value = arr->at(runtime, i);
+      key.length = numberToString(
+          key.value.getNumber(), key.chars, NUMBER_TO_STRING_BUF_SIZE);
+    }
+    std::stable_sort(keys.begin(), keys.end());
+    for (uint32_t i = 0; i != len; ++i) {
+      JSArray::unsafeSetExistingElementAt(arr, runtime, i, keys[i].value);
+    }
+    return true;
+  }
+
+  std::vector<HermesValue> values;
+  values.reserve(len);
+  for (uint32_t i = 0; i != len; ++i) {
+    HermesValue value = arr->at(runtime, i);
+    if (!value.isString())
+      return false;
+    values.push_back(value);
+  }
+  std::stable_sort(
+      values.begin(), values.end(), [](HermesValue a, HermesValue b) {
+        return a.getString()->compare(b.getString()) < 0;
+      });
+  for (uint32_t i = 0; i != len; ++i) {
+    JSArray::unsafeSetExistingElementAt(arr, runtime, i, values[i]);
+  }
+  return true;
+}
+
+/// ES2023 23.1.3.30. Array.prototype.sort, which must be stable.
 CallResult<HermesValue>
 arrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
   // Null if not a callable compareFn.
@@ -1163,18 +1164,103 @@ arrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
   }
   uint64_t len = *intRes;
 
-  StandardSortModel sm(runtime, O, compareFn);
+  // Fast path: the elements of an array of only numbers or only strings can
+  // be compared without running JS, so they are sorted in place.
+  if (!compareFn) {
+    JSArray *arr = getPackedArray(O, len);
+    if (arr && arr->isExtensible() &&
+        trySortPrimitives(runtime, arr, static_cast<uint32_t>(len))) {
+      return O.getHermesValue();
+    }
+  }
 
-  // Use our custom sort routine. We can't use std::sort because it performs
-  // optimizations that allow it to bypass calls to std::swap, but our swap
-  // function is special, since it needs to use the internal Object functions.
-  if (LLVM_UNLIKELY(quickSort(&sm, 0u, len) == ExecutionStatus::EXCEPTION))
+  // Collect the elements which exist, since holes are moved to the end.
+  auto arrRes = JSArray::create(runtime, 0, 0);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
+  }
+  auto items = toHandle(runtime, std::move(*arrRes));
+  uint32_t itemCount = 0;
+  {
+    GCScope gcScope(runtime);
+    MutableHandle<> kHandle{runtime};
+    MutableHandle<JSObject> propObj{runtime};
+    MutableHandle<> kValue{runtime};
+    ComputedPropertyDescriptor desc;
+    auto marker = gcScope.createMarker();
+    for (uint64_t k = 0; k < len; ++k) {
+      gcScope.flushToMarker(marker);
+      kValue = getStoredElement(runtime, O, k);
+      if (kValue->isEmpty()) {
+        kHandle = HermesValue::encodeNumberValue(k);
+        if (LLVM_UNLIKELY(
+                JSObject::getComputedPrimitiveDescriptor(
+                    O, runtime, kHandle, propObj, desc) ==
+                ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        if (!propObj) {
+          continue;
+        }
+        auto propRes =
+            JSObject::getComputedPropertyValue_RJS(O, runtime, propObj, desc);
+        if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        kValue = *propRes;
+      }
+      JSArray::setElementAt(items, runtime, itemCount++, kValue);
+    }
+  }
+
+  {
+    CollectedSortModel sm(runtime, items, compareFn);
+    if (LLVM_UNLIKELY(
+            stableSort(&sm, 0, itemCount) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+
+  // Write the sorted elements back, followed by the holes.
+  GCScope gcScope(runtime);
+  MutableHandle<> kHandle{runtime};
+  MutableHandle<> kValue{runtime};
+  auto marker = gcScope.createMarker();
+  for (uint32_t k = 0; k != itemCount; ++k) {
+    gcScope.flushToMarker(marker);
+    kValue = items->at(runtime, k);
+    auto *arr = dyn_vmcast<JSArray>(O.get());
+    if (arr && arr->hasFastIndexProperties() &&
+        arr->trySetExistingElement(runtime, k, *kValue)) {
+      continue;
+    }
+    kHandle = HermesValue::encodeNumberValue(k);
+    if (LLVM_UNLIKELY(
+            JSObject::putComputed_RJS(
+                O,
+                runtime,
+                kHandle,
+                kValue,
+                PropOpFlags().plusThrowOnError()) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  for (uint64_t k = itemCount; k < len; ++k) {
+    gcScope.flushToMarker(marker);
+    kHandle = HermesValue::encodeNumberValue(k);
+    if (LLVM_UNLIKELY(
+            JSObject::deleteComputed(
+                O, runtime, kHandle, PropOpFlags().plusThrowOnError()) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
 
   return O.getHermesValue();
 }
 
-inline CallResult<HermesValue>
+CallResult<HermesValue>
 arrayPrototypeForEach(void *, Runtime *runtime, NativeArgs args) {
   GCScope gcScope(runtime);
   auto objRes = toObject(runtime, args.getThisHandle());
@@ -1200,42 +1286,47 @@ arrayPrototypeForEach(void *, Runtime *runtime, NativeArgs args) {
         "Array.prototype.forEach() requires a callable argument");
   }
 
-  // Index to execute the callback on.
-  MutableHandle<> k{runtime, HermesValue::encodeDoubleValue(0)};
+  PreparedCall callback{runtime, callbackFn, args.getArgHandle(1), 3};
+  if (LLVM_UNLIKELY(callback.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
 
-  MutableHandle<JSObject> descObjHandle{runtime};
+  // Index of the elements which aren't in the storage of an array, and the
+  // object where they are found.
+  HandleArray<2> loopHandles{runtime};
+  auto kHandle = loopHandles.mutableHandle(0);
+  auto descObjHandle = loopHandles.mutableHandle<JSObject>(1);
 
   // Loop through and execute the callback on all existing values.
-  // TODO: Implement a fast path for actual arrays.
   auto marker = gcScope.createMarker();
-  while (k->getDouble() < len) {
+  for (double k = 0; k < len; ++k) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, desc);
+    auto kValue = getStoredElement(runtime, O, k);
+    if (kValue.isEmpty()) {
+      kHandle = HermesValue::encodeDoubleValue(k);
+      ComputedPropertyDescriptor desc;
+      JSObject::getComputedPrimitiveDescriptor(
+          O, runtime, kHandle, descObjHandle, desc);
+      if (descObjHandle) {
+        if ((propRes = JSObject::getComputedPropertyValue_RJS(
+                 O, runtime, descObjHandle, desc)) ==
+            ExecutionStatus::EXCEPTION) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        kValue = propRes.getValue();
+      }
+    }
 
-    if (descObjHandle) {
+    if (!kValue.isEmpty()) {
       // kPresent is true, execute callback.
-      if ((propRes = JSObject::getComputedPropertyValue_RJS(
-               O, runtime, descObjHandle, desc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      auto kValue = propRes.getValue();
       if (LLVM_UNLIKELY(
-              Callable::executeCall3(
-                  callbackFn,
-                  runtime,
-                  args.getArgHandle(1),
+              callback.call(
                   kValue,
-                  k.get(),
+                  HermesValue::encodeDoubleValue(k),
                   O.getHermesValue()) == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
     }
-
-    k = HermesValue::encodeDoubleValue(k->getDouble() + 1);
   }
 
   return HermesValue::encodeUndefinedValue();
@@ -1255,7 +1346,6 @@ arrayPrototypeIterator(void *ctx, Runtime *runtime, NativeArgs args) {
   return JSArrayIterator::create(runtime, obj, kind);
 }
 
-#ifndef HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
 CallResult<HermesValue>
 arrayPrototypeSlice(void *, Runtime *runtime, NativeArgs args) {
   GCScope gcScope(runtime);
@@ -1486,7 +1576,25 @@ arrayPrototypeSplice(void *, Runtime *runtime, NativeArgs args) {
   // Number of new items to add to the array.
   uint32_t itemCount = args.getArgCount() > 2 ? args.getArgCount() - 2 : 0;
 
-  if (itemCount < actualDeleteCount) {
+  if (actualStart == 0 && itemCount != actualDeleteCount &&
+      getDequeArray(runtime, O, len, itemCount > actualDeleteCount)) {
+    // Only the start of the storage of a deque-like array moves. Its length is
+    // set right away, so that the items below are stored in its storage.
+    auto arr = Handle<JSArray>::vmcast(O);
+    if (itemCount < actualDeleteCount) {
+      JSArray::shiftElements(arr, runtime, actualDeleteCount - itemCount);
+    } else if (LLVM_UNLIKELY(
+                   JSArray::unshiftElements(
+                       arr, runtime, itemCount - actualDeleteCount) ==
+                   ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (LLVM_UNLIKELY(
+            JSArray::setLengthProperty(
+                arr, runtime, len - actualDeleteCount + itemCount) ==
+            ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+  } else if (itemCount < actualDeleteCount) {
     // Inserting less items than deleting.
 
     // Copy items from (k + actualDeleteCount) to (k + itemCount).
@@ -1877,6 +1985,19 @@ arrayPrototypeShift(void *, Runtime *runtime, NativeArgs args) {
     return HermesValue::encodeUndefinedValue();
   }
 
+  // Only the start of the storage of a deque-like array moves, so that using
+  // it as a queue takes constant time per element.
+  if (getDequeArray(runtime, O, len, false)) {
+    auto arr = Handle<JSArray>::vmcast(O);
+    auto first = runtime->makeHandle(arr->at(runtime, 0));
+    JSArray::shiftElements(arr, runtime, 1);
+    if (LLVM_UNLIKELY(
+            JSArray::setLengthProperty(arr, runtime, len - 1) ==
+            ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    return first.get();
+  }
+
   auto idxVal = runtime->makeHandle(HermesValue::encodeDoubleValue(0));
   if (LLVM_UNLIKELY(
           (propRes = JSObject::getComputed_RJS(O, runtime, idxVal)) ==
@@ -2012,6 +2133,23 @@ indexOfHelper(Runtime *runtime, NativeArgs args, const bool reverse) {
 
   // Search for the element.
   auto searchElement = args.getArgHandle(0);
+
+  // A packed array has no holes to look up in the prototype chain, so its
+  // elements can be compared without running any code or allocating.
+  if (JSArray *arr = getPackedArray(O, len)) {
+    HermesValue search = searchElement.get();
+    if (arr->getElementKind() == ArrayImpl::ElementKind::PackedNumber &&
+        !search.isNumber()) {
+      return HermesValue::encodeDoubleValue(-1);
+    }
+    double step = reverse ? -1 : 1;
+    for (double i = k->getDouble(); reverse ? i >= 0 : i < len; i += step) {
+      if (strictEqualityTest(search, arr->at(runtime, (uint32_t)i)))
+        return HermesValue::encodeDoubleValue(i);
+    }
+    return HermesValue::encodeDoubleValue(-1);
+  }
+
   auto marker = gcScope.createMarker();
   while (true) {
     gcScope.flushToMarker(marker);
@@ -2077,6 +2215,24 @@ arrayPrototypeUnshift(void *, Runtime *runtime, NativeArgs args) {
           "Array.prototype.unshift result out of space");
     }
 
+    // Only the start of the storage of a deque-like array moves, and room is
+    // reserved there for the next calls.
+    if (getDequeArray(runtime, O, len, true)) {
+      auto arr = Handle<JSArray>::vmcast(O);
+      if (LLVM_UNLIKELY(
+              JSArray::unshiftElements(arr, runtime, argCount) ==
+              ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      for (uint32_t j = 0; j != argCount; ++j)
+        JSArray::setElementAt(arr, runtime, j, args.getArgHandle(j));
+      auto newLen = HermesValue::encodeDoubleValue(len + argCount);
+      if (LLVM_UNLIKELY(
+              JSArray::setLengthProperty(arr, runtime, len + argCount) ==
+              ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      return newLen;
+    }
+
     // Loop indices.
     MutableHandle<> k{runtime, HermesValue::encodeDoubleValue(len)};
     MutableHandle<> j{runtime, HermesValue::encodeDoubleValue(0)};
@@ -2195,37 +2351,42 @@ everySomeHelper(Runtime *runtime, NativeArgs args, const bool every) {
         "Array.prototype.every() requires a callable argument");
   }
 
-  // Index to check the callback on.
-  MutableHandle<> k{runtime, HermesValue::encodeDoubleValue(0)};
+  PreparedCall callback{runtime, callbackFn, args.getArgHandle(1), 3};
+  if (LLVM_UNLIKELY(callback.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
 
-  // Value at index k;
-  MutableHandle<JSObject> descObjHandle{runtime};
-  MutableHandle<> kValue{runtime};
+  // Index to check the callback on, the object where its value is found and
+  // the value at index k.
+  HandleArray<3> loopHandles{runtime};
+  auto k = loopHandles.mutableHandle(0);
+  k = HermesValue::encodeDoubleValue(0);
+  auto descObjHandle = loopHandles.mutableHandle<JSObject>(1);
+  auto kValue = loopHandles.mutableHandle(2);
 
   // Loop through and run the callback.
   auto marker = gcScope.createMarker();
   while (k->getDouble() < len) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, desc);
+    kValue = getStoredElement(runtime, O, k->getDouble());
+    if (kValue->isEmpty()) {
+      ComputedPropertyDescriptor desc;
+      JSObject::getComputedPrimitiveDescriptor(
+          O, runtime, k, descObjHandle, desc);
+      if (descObjHandle) {
+        if ((propRes = JSObject::getComputedPropertyValue_RJS(
+                 O, runtime, descObjHandle, desc)) ==
+            ExecutionStatus::EXCEPTION) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        kValue = propRes.getValue();
+      }
+    }
 
-    if (descObjHandle) {
+    if (!kValue->isEmpty()) {
       // kPresent is true, call the callback on the kth element.
-      if ((propRes = JSObject::getComputedPropertyValue_RJS(
-               O, runtime, descObjHandle, desc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      kValue = propRes.getValue();
-      auto callRes = Callable::executeCall3(
-          callbackFn,
-          runtime,
-          args.getArgHandle(1),
-          kValue.get(),
-          k.get(),
-          O.getHermesValue());
+      auto callRes =
+          callback.call(kValue.get(), k.get(), O.getHermesValue());
       if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
@@ -2296,45 +2457,55 @@ arrayPrototypeMap(void *, Runtime *runtime, NativeArgs args) {
     return ExecutionStatus::EXCEPTION;
   }
   auto A = toHandle(runtime, std::move(*arrRes));
+  // Results are stored directly, and skipped indices stay empty.
+  if (LLVM_UNLIKELY(
+          JSArray::setStorageEndIndex(A, runtime, len) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
 
-  // Current index to execute callback on.
-  MutableHandle<> k{runtime, HermesValue::encodeDoubleValue(0)};
+  PreparedCall callback{runtime, callbackFn, args.getArgHandle(1), 3};
+  if (LLVM_UNLIKELY(callback.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
 
-  MutableHandle<JSObject> descObjHandle{runtime};
+  // Index of the elements which aren't in the storage of an array, and the
+  // object where they are found.
+  HandleArray<2> loopHandles{runtime};
+  auto kHandle = loopHandles.mutableHandle(0);
+  auto descObjHandle = loopHandles.mutableHandle<JSObject>(1);
 
   // Main loop to execute callback and store the results in A.
-  // TODO: Implement a fast path for actual arrays.
   auto marker = gcScope.createMarker();
-  while (k->getDouble() < len) {
+  for (double k = 0; k < len; ++k) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, desc);
+    auto kValue = getStoredElement(runtime, O, k);
+    if (kValue.isEmpty()) {
+      kHandle = HermesValue::encodeDoubleValue(k);
+      ComputedPropertyDescriptor desc;
+      JSObject::getComputedPrimitiveDescriptor(
+          O, runtime, kHandle, descObjHandle, desc);
+      if (descObjHandle) {
+        if ((propRes = JSObject::getComputedPropertyValue_RJS(
+                 O, runtime, descObjHandle, desc)) ==
+            ExecutionStatus::EXCEPTION) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        kValue = propRes.getValue();
+      }
+    }
 
-    if (descObjHandle) {
+    if (!kValue.isEmpty()) {
       // kPresent is true, execute callback and store result in A[k].
-      if ((propRes = JSObject::getComputedPropertyValue_RJS(
-               O, runtime, descObjHandle, desc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      auto kValue = propRes.getValue();
-      auto callRes = Callable::executeCall3(
-          callbackFn,
-          runtime,
-          args.getArgHandle(1),
-          kValue,
-          k.get(),
-          O.getHermesValue());
+      auto callRes = callback.call(
+          kValue, HermesValue::encodeDoubleValue(k), O.getHermesValue());
       if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
-      JSArray::setElementAt(
-          A, runtime, k->getDouble(), runtime->makeHandle(*callRes));
+      // A is never seen by the callback.
+      JSArray::unsafeSetExistingElementAt(
+          *A, runtime, static_cast<uint32_t>(k), *callRes);
     }
-
-    k = HermesValue::encodeDoubleValue(k->getDouble() + 1);
   }
 
   return A.getHermesValue();
@@ -2375,39 +2546,44 @@ arrayPrototypeFilter(void *, Runtime *runtime, NativeArgs args) {
   }
   auto A = toHandle(runtime, std::move(*arrRes));
 
-  // Index in the original array.
-  MutableHandle<> k{runtime, HermesValue::encodeDoubleValue(0)};
+  PreparedCall callback{runtime, callbackFn, args.getArgHandle(1), 3};
+  if (LLVM_UNLIKELY(callback.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
+
   // Index to copy to in the new array.
   uint32_t to = 0;
 
-  // Value at index k.
-  MutableHandle<JSObject> descObjHandle{runtime};
-  MutableHandle<> kValue{runtime};
+  // Index of the elements which aren't in the storage of an array, the object
+  // where they are found, and the value at index k.
+  HandleArray<3> loopHandles{runtime};
+  auto kHandle = loopHandles.mutableHandle(0);
+  auto descObjHandle = loopHandles.mutableHandle<JSObject>(1);
+  auto kValue = loopHandles.mutableHandle(2);
 
   auto marker = gcScope.createMarker();
-  while (k->getDouble() < len) {
+  for (double k = 0; k < len; ++k) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, desc);
-
-    if (descObjHandle) {
-      // kPresent is true
-      if ((propRes = JSObject::getComputedPropertyValue_RJS(
-               O, runtime, descObjHandle, desc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
+    kValue = getStoredElement(runtime, O, k);
+    if (kValue->isEmpty()) {
+      kHandle = HermesValue::encodeDoubleValue(k);
+      ComputedPropertyDescriptor desc;
+      JSObject::getComputedPrimitiveDescriptor(
+          O, runtime, kHandle, descObjHandle, desc);
+      if (descObjHandle) {
+        if ((propRes = JSObject::getComputedPropertyValue_RJS(
+                 O, runtime, descObjHandle, desc)) ==
+            ExecutionStatus::EXCEPTION) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        kValue = propRes.getValue();
       }
-      kValue = propRes.getValue();
-      // Call the callback.
-      auto callRes = Callable::executeCall3(
-          callbackFn,
-          runtime,
-          args.getArgHandle(1),
-          kValue.get(),
-          k.get(),
-          O.getHermesValue());
+    }
+
+    if (!kValue->isEmpty()) {
+      // kPresent is true, call the callback.
+      auto callRes = callback.call(
+          kValue.get(), HermesValue::encodeDoubleValue(k), O.getHermesValue());
       if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
@@ -2417,8 +2593,6 @@ arrayPrototypeFilter(void *, Runtime *runtime, NativeArgs args) {
         ++to;
       }
     }
-
-    k = HermesValue::encodeDoubleValue(k->getDouble() + 1);
   }
 
   if (LLVM_UNLIKELY(
@@ -2517,6 +2691,10 @@ arrayPrototypeFind(void *ctx, Runtime *runtime, NativeArgs args) {
   // "this" argument to the callback function.
   auto T = args.getArgHandle(1);
 
+  PreparedCall callback{runtime, predicate, T, 3};
+  if (LLVM_UNLIKELY(callback.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
+
   MutableHandle<> kHandle{runtime, HermesValue::encodeNumberValue(0)};
   MutableHandle<> kValue{runtime};
   auto marker = gcScope.createMarker();
@@ -2528,13 +2706,8 @@ arrayPrototypeFind(void *ctx, Runtime *runtime, NativeArgs args) {
       return ExecutionStatus::EXCEPTION;
     }
     kValue = *propRes;
-    auto callRes = Callable::executeCall3(
-        predicate,
-        runtime,
-        T,
-        kValue.getHermesValue(),
-        kHandle.getHermesValue(),
-        O.getHermesValue());
+    auto callRes = callback.call(
+        kValue.getHermesValue(), kHandle.getHermesValue(), O.getHermesValue());
     if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -2594,6 +2767,11 @@ reduceHelper(Runtime *runtime, NativeArgs args, const bool reverse) {
                     HermesValue::encodeDoubleValue(reverse ? len - 1 : 0)};
   MutableHandle<JSObject> kDescObjHandle{runtime};
 
+  PreparedCall callback{
+      runtime, callbackFn, Runtime::getUndefinedValue(), 4};
+  if (LLVM_UNLIKELY(callback.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
+
   MutableHandle<> accumulator{runtime};
 
   auto marker = gcScope.createMarker();
@@ -2651,25 +2829,24 @@ reduceHelper(Runtime *runtime, NativeArgs args, const bool reverse) {
       }
     }
 
-    ComputedPropertyDescriptor kDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, kDescObjHandle, kDesc);
-    if (kDescObjHandle) {
-      // kPresent is true, run the accumulation step.
-      if ((propRes = JSObject::getComputedPropertyValue_RJS(
-               O, runtime, kDescObjHandle, kDesc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
+    auto kValue = getStoredElement(runtime, O, k->getDouble());
+    if (kValue.isEmpty()) {
+      ComputedPropertyDescriptor kDesc;
+      JSObject::getComputedPrimitiveDescriptor(
+          O, runtime, k, kDescObjHandle, kDesc);
+      if (kDescObjHandle) {
+        if ((propRes = JSObject::getComputedPropertyValue_RJS(
+                 O, runtime, kDescObjHandle, kDesc)) ==
+            ExecutionStatus::EXCEPTION) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        kValue = propRes.getValue();
       }
-      auto kValue = propRes.getValue();
-      auto callRes = Callable::executeCall4(
-          callbackFn,
-          runtime,
-          Runtime::getUndefinedValue(),
-          accumulator.get(),
-          kValue,
-          k.get(),
-          O.getHermesValue());
+    }
+    if (!kValue.isEmpty()) {
+      // kPresent is true, run the accumulation step.
+      auto callRes = callback.call(
+          accumulator.get(), kValue, k.get(), O.getHermesValue());
       if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
@@ -2872,7 +3049,23 @@ arrayPrototypeIncludes(void *, Runtime *runtime, NativeArgs args) {
     }
   }
 
-  MutableHandle<> kHandle{runtime};
+  // A packed array has no holes to look up in the prototype chain, so its
+  // elements can be compared without running any code or allocating.
+  if (JSArray *arr = getPackedArray(O, len)) {
+    HermesValue search = args.getArg(0);
+    if (arr->getElementKind() == ArrayImpl::ElementKind::PackedNumber &&
+        !search.isNumber()) {
+      return HermesValue::encodeBoolValue(false);
+    }
+    for (; k < len; ++k) {
+      if (isSameValueZero(search, arr->at(runtime, (uint32_t)k)))
+        return HermesValue::encodeBoolValue(true);
+    }
+    return HermesValue::encodeBoolValue(false);
+  }
+
+  HandleArray<1> loopHandles{runtime};
+  auto kHandle = loopHandles.mutableHandle(0);
 
   // 7. Repeat, while k < len
   auto marker = gcScope.createMarker();
@@ -3227,7 +3420,6 @@ CallResult<HermesValue> arrayFrom(void *, Runtime *runtime, NativeArgs args) {
   // 19. Return A.
   return A.getHermesValue();
 }
-#endif // HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
 
 } // namespace vm
 } // namespace hermes
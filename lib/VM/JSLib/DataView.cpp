@@ -172,15 +172,12 @@ dataViewConstructor(void *, Runtime *runtime, NativeArgs args) {
   return self.getHermesValue();
 }
 
-Handle<JSObject> createDataViewConstructor(Runtime *runtime) {
+/// Define the properties of the DataView constructor \p cons and of
+/// DataView.prototype.
+static void populateDataView(Runtime *runtime, Handle<JSObject> cons) {
   auto proto = Handle<JSObject>::vmcast(&runtime->dataViewPrototype);
-  auto cons = defineSystemConstructor<JSDataView>(
-      runtime,
-      Predefined::getSymbolID(Predefined::DataView),
-      dataViewConstructor,
-      proto,
-      1,
-      CellKind::DataViewKind);
+  defineSystemConstructorProperties(
+      runtime, cons, Predefined::getSymbolID(Predefined::DataView), proto, 1);
 
   // DataView.prototype.xxx() methods.
   defineAccessor(
@@ -240,8 +237,19 @@ Handle<JSObject> createDataViewConstructor(Runtime *runtime) {
       dpf);
 
   // DataView.xxx() methods.
+}
 
-  return cons;
+Handle<JSObject> createDataViewConstructor(Runtime *runtime) {
+  return defineLazySystemConstructor(
+      runtime,
+      Predefined::getSymbolID(Predefined::DataView),
+      dataViewConstructor,
+      Handle<JSObject>::vmcast(&runtime->dataViewPrototype),
+      Handle<JSObject>::vmcast(&runtime->functionPrototype),
+      1,
+      JSDataView::create,
+      CellKind::DataViewKind,
+      populateDataView);
 }
 
 } // namespace vm
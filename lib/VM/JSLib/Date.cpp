@@ -375,6 +375,11 @@ Handle<JSObject> createDateConstructor(Runtime *runtime) {
   return cons;
 }
 
+/// \return the cache of time zone offsets used for the Dates of \p runtime.
+static LocalTimeOffsetCache &offsetCache(Runtime *runtime) {
+  return runtime->getCommonStorage()->localTimeOffsetCache;
+}
+
 /// Takes \p args in UTC time of the form:
 /// (year, month, [, date [, hours [, minutes [, seconds [, ms]]]]])
 /// and returns the unclipped time in milliseconds since Jan 1 1970 UTC.
@@ -468,7 +473,7 @@ dateConstructor(void *, Runtime *runtime, NativeArgs args) {
       // makeTimeFromArgs interprets arguments as UTC.
       // We want them as local time, so pretend that they are,
       // and call utcTime to get the final UTC value we want to store.
-      finalDate = timeClip(utcTime(*cr));
+      finalDate = timeClip(utcTime(*cr, offsetCache(runtime)));
     }
 
     JSDate::setPrimitiveValue(
@@ -486,7 +491,7 @@ dateConstructor(void *, Runtime *runtime, NativeArgs args) {
     storage->env->callsToDateAsFunction.pop_front();
   } else {
     double t = curTime();
-    double local = localTime(t);
+    double local = localTime(t, offsetCache(runtime));
     dateTimeString(local, local - t, str);
   }
   if (LLVM_UNLIKELY(storage->shouldTrace)) {
@@ -576,7 +581,7 @@ datePrototypeToStringHelper(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   llvm::SmallString<32> str{};
   if (!opts->isUTC) {
-    double local = localTime(t);
+    double local = localTime(t, offsetCache(runtime));
     opts->toStringFn(local, local - t, str);
   } else {
     opts->toStringFn(t, 0, str);
@@ -665,7 +670,7 @@ datePrototypeGetterHelper(void *ctx, Runtime *runtime, NativeArgs args) {
   // Store the original value of t to be used in offset calculations.
   double utc = t;
   if (!opts->isUTC) {
-    t = localTime(t);
+    t = localTime(t, offsetCache(runtime));
   }
 
   double result{std::numeric_limits<double>::quiet_NaN()};
@@ -732,7 +737,7 @@ datePrototypeSetMilliseconds(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(t, offsetCache(runtime));
   }
   auto res = toNumber_RJS(runtime, args.getArgHandle(0));
   if (res == ExecutionStatus::EXCEPTION) {
@@ -743,7 +748,8 @@ datePrototypeSetMilliseconds(void *ctx, Runtime *runtime, NativeArgs args) {
       day(t), makeTime(hourFromTime(t), minFromTime(t), secFromTime(t), ms));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(date)));
+    v = HermesValue::encodeDoubleValue(
+        timeClip(utcTime(date, offsetCache(runtime))));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(date));
   }
@@ -763,7 +769,7 @@ datePrototypeSetSeconds(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(t, offsetCache(runtime));
   }
   auto res = toNumber_RJS(runtime, args.getArgHandle(0));
   if (res == ExecutionStatus::EXCEPTION) {
@@ -785,7 +791,8 @@ datePrototypeSetSeconds(void *ctx, Runtime *runtime, NativeArgs args) {
       makeDate(day(t), makeTime(hourFromTime(t), minFromTime(t), s, milli));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(date)));
+    v = HermesValue::encodeDoubleValue(
+        timeClip(utcTime(date, offsetCache(runtime))));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(date));
   }
@@ -805,7 +812,7 @@ datePrototypeSetMinutes(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(t, offsetCache(runtime));
   }
   auto res = toNumber_RJS(runtime, args.getArgHandle(0));
   if (res == ExecutionStatus::EXCEPTION) {
@@ -836,7 +843,8 @@ datePrototypeSetMinutes(void *ctx, Runtime *runtime, NativeArgs args) {
   double date = makeDate(day(t), makeTime(hourFromTime(t), m, s, milli));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(date)));
+    v = HermesValue::encodeDoubleValue(
+        timeClip(utcTime(date, offsetCache(runtime))));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(date));
   }
@@ -856,7 +864,7 @@ datePrototypeSetHours(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(t, offsetCache(runtime));
   }
   auto res = toNumber_RJS(runtime, args.getArgHandle(0));
   if (res == ExecutionStatus::EXCEPTION) {
@@ -897,7 +905,8 @@ datePrototypeSetHours(void *ctx, Runtime *runtime, NativeArgs args) {
   double date = makeDate(day(t), makeTime(h, m, s, milli));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(date)));
+    v = HermesValue::encodeDoubleValue(
+        timeClip(utcTime(date, offsetCache(runtime))));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(date));
   }
@@ -916,7 +925,7 @@ datePrototypeSetDate(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(t, offsetCache(runtime));
   }
   auto res = toNumber_RJS(runtime, args.getArgHandle(0));
   if (res == ExecutionStatus::EXCEPTION) {
@@ -927,7 +936,8 @@ datePrototypeSetDate(void *ctx, Runtime *runtime, NativeArgs args) {
       makeDay(yearFromTime(t), monthFromTime(t), dt), timeWithinDay(t));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(newDate)));
+    v = HermesValue::encodeDoubleValue(
+        timeClip(utcTime(newDate, offsetCache(runtime))));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(newDate));
   }
@@ -947,7 +957,7 @@ datePrototypeSetMonth(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(t, offsetCache(runtime));
   }
   auto res = toNumber_RJS(runtime, args.getArgHandle(0));
   if (res == ExecutionStatus::EXCEPTION) {
@@ -967,7 +977,8 @@ datePrototypeSetMonth(void *ctx, Runtime *runtime, NativeArgs args) {
   double newDate = makeDate(makeDay(yearFromTime(t), m, dt), timeWithinDay(t));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(newDate)));
+    v = HermesValue::encodeDoubleValue(
+        timeClip(utcTime(newDate, offsetCache(runtime))));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(newDate));
   }
@@ -987,7 +998,7 @@ datePrototypeSetFullYear(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(t, offsetCache(runtime));
   }
   if (std::isnan(t)) {
     t = 0;
@@ -1020,7 +1031,8 @@ datePrototypeSetFullYear(void *ctx, Runtime *runtime, NativeArgs args) {
   double newDate = makeDate(makeDay(y, m, dt), timeWithinDay(t));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(newDate)));
+    v = HermesValue::encodeDoubleValue(
+        timeClip(utcTime(newDate, offsetCache(runtime))));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(newDate));
   }
@@ -1039,7 +1051,7 @@ datePrototypeSetYear(void *ctx, Runtime *runtime, NativeArgs args) {
         "Date.prototype.setYear() called on non-Date object");
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
-  t = localTime(t);
+  t = localTime(t, offsetCache(runtime));
   if (std::isnan(t)) {
     t = 0;
   }
@@ -1055,8 +1067,10 @@ datePrototypeSetYear(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double yint = oscompat::trunc(y);
   double yr = 0 <= yint && yint <= 99 ? yint + 1900 : y;
-  double date = utcTime(makeDate(
-      makeDay(yr, monthFromTime(t), dateFromTime(t)), timeWithinDay(t)));
+  double date = utcTime(
+      makeDate(
+          makeDay(yr, monthFromTime(t), dateFromTime(t)), timeWithinDay(t)),
+      offsetCache(runtime));
   auto v = HermesValue::encodeDoubleValue(timeClip(date));
   JSDate::setPrimitiveValue(self.get(), runtime, v);
   return v;
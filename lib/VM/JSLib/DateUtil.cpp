@@ -415,6 +415,55 @@ double utcTime(double t) {
   return t - ltza - daylightSavingTA(t - ltza);
 }
 
+double LocalTimeOffsetCache::localTZA() {
+  if (!hasLocalTZA_) {
+    ltza_ = vm::localTZA();
+    hasLocalTZA_ = true;
+  }
+  return ltza_;
+}
+
+double LocalTimeOffsetCache::daylightSavingTA(double t) {
+  if (dstStart_ <= t && t <= dstEnd_) {
+    return dstOffset_;
+  }
+  double offset = vm::daylightSavingTA(t);
+  if (std::isnan(offset)) {
+    return offset;
+  }
+  // A time close to the cached range with the same adjustment can't be
+  // separated from it by a transition, so the range grows to include it.
+  if (dstStart_ <= dstEnd_ && offset == dstOffset_) {
+    if (t > dstEnd_ && t - dstEnd_ <= kMaxRangeExtension) {
+      dstEnd_ = t;
+      return offset;
+    }
+    if (t < dstStart_ && dstStart_ - t <= kMaxRangeExtension) {
+      dstStart_ = t;
+      return offset;
+    }
+  }
+  dstStart_ = t;
+  dstEnd_ = t;
+  dstOffset_ = offset;
+  return offset;
+}
+
+void LocalTimeOffsetCache::reset() {
+  hasLocalTZA_ = false;
+  dstStart_ = 1;
+  dstEnd_ = 0;
+}
+
+double localTime(double t, LocalTimeOffsetCache &cache) {
+  return t + cache.localTZA() + cache.daylightSavingTA(t);
+}
+
+double utcTime(double t, LocalTimeOffsetCache &cache) {
+  double ltza = cache.localTZA();
+  return t - ltza - cache.daylightSavingTA(t - ltza);
+}
+
 //===----------------------------------------------------------------------===//
 // ES5.1 15.9.1.10
 
@@ -545,11 +594,43 @@ void timeToISOString(double t, double tza, llvm::SmallVectorImpl<char> &buf) {
   }
 }
 
+/// Append \p x to \p buf as exactly \p width decimal digits.
+static void appendDigits(
+    llvm::SmallVectorImpl<char> &buf,
+    int32_t x,
+    uint32_t width) {
+  size_t end = buf.size() + width;
+  buf.resize(end);
+  for (size_t i = end; i > end - width; --i) {
+    buf[i - 1] = '0' + x % 10;
+    x /= 10;
+  }
+}
+
 static void datetimeToISOString(
     double t,
     double tza,
     llvm::SmallVectorImpl<char> &buf,
     char separator) {
+  int32_t y = yearFromTime(t);
+  if (tza == 0 && y >= 0 && y <= 9999) {
+    // Write the common UTC form directly instead of formatting each field.
+    appendDigits(buf, y, 4);
+    buf.push_back('-');
+    appendDigits(buf, monthFromTime(t) + 1, 2);
+    buf.push_back('-');
+    appendDigits(buf, dateFromTime(t), 2);
+    buf.push_back(separator);
+    appendDigits(buf, hourFromTime(t), 2);
+    buf.push_back(':');
+    appendDigits(buf, minFromTime(t), 2);
+    buf.push_back(':');
+    appendDigits(buf, secFromTime(t), 2);
+    buf.push_back('.');
+    appendDigits(buf, msFromTime(t), 3);
+    buf.push_back('Z');
+    return;
+  }
   dateToISOString(t, tza, buf);
   buf.push_back(separator);
   timeToISOString(t, tza, buf);
@@ -717,16 +798,58 @@ static inline bool isDigit(char16_t c) {
 /// \return true if successful, false if failed.
 template <class InputIter>
 static bool scanInt(InputIter &it, const InputIter end, int32_t &x) {
-  llvm::SmallString<16> str{};
-  if (it == end) {
+  if (it == end || !isDigit(*it)) {
     return false;
   }
+  int32_t result = 0;
   for (; it != end && isDigit(*it); ++it) {
-    str += static_cast<char>(*it);
+    int32_t digit = *it - u'0';
+    if (result > (std::numeric_limits<int32_t>::max() - digit) / 10) {
+      return false;
+    }
+    result = result * 10 + digit;
   }
-  llvm::StringRef ref{str};
-  // getAsInteger returns false to signify success.
-  return !ref.getAsInteger(10, x);
+  x = result;
+  return true;
+}
+
+/// Read the \p width digits of \p str starting at \p pos into \p x.
+/// \return true if they are all digits.
+static bool readFixedDigits(
+    const StringView &str,
+    uint32_t pos,
+    uint32_t width,
+    int32_t &x) {
+  int32_t result = 0;
+  for (uint32_t i = pos, e = pos + width; i < e; ++i) {
+    char16_t c = str[i];
+    if (!isDigit(c)) {
+      return false;
+    }
+    result = result * 10 + (c - u'0');
+  }
+  x = result;
+  return true;
+}
+
+/// Parse the string produced by toISOString() for years 0 to 9999,
+/// YYYY-MM-DDTHH:mm:ss.sssZ, without going through the general ISO parser.
+/// \return the time, or NaN if \p str has any other form.
+static double parseISODateTimeFast(StringView str) {
+  constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+  if (str.length() != 24 || str[4] != u'-' || str[7] != u'-' ||
+      str[10] != u'T' || str[13] != u':' || str[16] != u':' ||
+      str[19] != u'.' || str[23] != u'Z') {
+    return nan;
+  }
+  int32_t y, m, d, h, min, s, ms;
+  if (!readFixedDigits(str, 0, 4, y) || !readFixedDigits(str, 5, 2, m) ||
+      !readFixedDigits(str, 8, 2, d) || !readFixedDigits(str, 11, 2, h) ||
+      !readFixedDigits(str, 14, 2, min) || !readFixedDigits(str, 17, 2, s) ||
+      !readFixedDigits(str, 20, 3, ms)) {
+    return nan;
+  }
+  return makeDate(makeDay(y, m - 1, d), makeTime(h, min, s, ms));
 }
 
 static double parseISODate(StringView u16str) {
@@ -1003,7 +1126,12 @@ complete:
 }
 
 double parseDate(StringView str) {
-  double result = parseISODate(str);
+  double result = parseISODateTimeFast(str);
+  if (!std::isnan(result)) {
+    return result;
+  }
+
+  result = parseISODate(str);
   if (!std::isnan(result)) {
     return result;
   }
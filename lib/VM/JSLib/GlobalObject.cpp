@@ -126,8 +126,14 @@ CallResult<HermesValue> parseInt(void *, Runtime *runtime, NativeArgs args) {
     return HermesValue::encodeNaNValue();
   }
 
+  StringView digits = strView.slice(begin, realEnd);
+  double result;
+  if (radix == 10 &&
+      parseDecimalIntegerFast(digits, result) == digits.length()) {
+    return HermesValue::encodeDoubleValue(sign * result);
+  }
   return HermesValue::encodeDoubleValue(
-      sign * parseIntWithRadix(strView.slice(begin, realEnd), radix));
+      sign * parseIntWithRadix(digits, radix));
 }
 
 // Check if str1 is a prefix of str2.
@@ -168,6 +174,20 @@ CallResult<HermesValue> parseFloat(void *, Runtime *runtime, NativeArgs args) {
   }
   StringView str16 = origStr.slice(begin, end);
 
+  // Most numbers have few enough digits to be converted exactly here.
+  if (!str16.empty()) {
+    StringView digits = str16;
+    bool negative = false;
+    if (digits[0] == u'+' || digits[0] == u'-') {
+      negative = digits[0] == u'-';
+      digits = digits.slice(1);
+    }
+    double result;
+    if (parseDecimalFast(digits, result)) {
+      return HermesValue::encodeDoubleValue(negative ? -result : result);
+    }
+  }
+
   // Check for special values.
   // parseFloat allows for partial match, hence we have to check for
   // substring.
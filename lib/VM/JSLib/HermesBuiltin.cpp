@@ -6,6 +6,7 @@
  */
 
 #include "JSLibInternal.h"
+#include "Object.h"
 
 #include "hermes/Support/Base64vlq.h"
 #include "hermes/VM/Callable.h"
@@ -13,6 +14,7 @@
 #include "hermes/VM/JSArrayBuffer.h"
 #include "hermes/VM/JSLib.h"
 #include "hermes/VM/Operations.h"
+#include "hermes/VM/PrimitiveBox.h"
 #include "hermes/VM/StackFrame-inline.h"
 #include "hermes/VM/StringView.h"
 
@@ -209,6 +211,115 @@ hermesBuiltinEnsureObject(void *, Runtime *runtime, NativeArgs args) {
   return runtime->raiseTypeError(args.getArgHandle(1));
 }
 
+/// Step the iterator of a for-of loop, which must be an object, and return
+/// the value of the next result, or \p doneMarker if the iterator is done.
+/// \p doneMarker is an object that the loop never lets escape, so it can't be
+/// confused with any value the iterator produces.
+/// The builtin iterators whose next() method has not been replaced produce
+/// their values directly, without allocating iterator result objects.
+///
+/// \code
+///   HermesBuiltin.iteratorStep = function(iterator, nextMethod, doneMarker)
+/// \endcode
+CallResult<HermesValue>
+hermesBuiltinIteratorStep(void *, Runtime *runtime, NativeArgs args) {
+  Handle<JSObject> iterator = args.dyncastArg<JSObject>(0);
+  if (LLVM_UNLIKELY(!iterator)) {
+    return runtime->raiseTypeError("iterator is not an object");
+  }
+  Handle<Callable> nextMethod = args.dyncastArg<Callable>(1);
+  if (LLVM_UNLIKELY(!nextMethod)) {
+    return runtime->raiseTypeErrorForValue(
+        args.getArgHandle(1), " is not a function");
+  }
+
+  MutableHandle<> value{runtime};
+  CallResult<bool> nextRes{false};
+  auto *native = dyn_vmcast<NativeFunction>(nextMethod.get());
+  NativeFunctionPtr nextFn = native ? native->getFunctionPtr() : nullptr;
+  if (nextFn == arrayIteratorPrototypeNext &&
+      vmisa<JSArrayIterator>(*iterator)) {
+    nextRes = JSArrayIterator::nextValue(
+        Handle<JSArrayIterator>::vmcast(iterator), runtime, value);
+  } else if (
+      nextFn == mapIteratorPrototypeNext && vmisa<JSMapIterator>(*iterator)) {
+    nextRes = JSMapIterator::nextValue(
+        Handle<JSMapIterator>::vmcast(iterator), runtime, value);
+  } else if (
+      nextFn == setIteratorPrototypeNext && vmisa<JSSetIterator>(*iterator)) {
+    nextRes = JSSetIterator::nextValue(
+        Handle<JSSetIterator>::vmcast(iterator), runtime, value);
+  } else if (
+      nextFn == stringIteratorPrototypeNext &&
+      vmisa<JSStringIterator>(*iterator)) {
+    nextRes = JSStringIterator::nextValue(
+        Handle<JSStringIterator>::vmcast(iterator), runtime, value);
+  } else {
+    // IteratorStep() and IteratorValue() of any other iterator.
+    auto resultRes = Callable::executeCall0(nextMethod, runtime, iterator);
+    if (LLVM_UNLIKELY(resultRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (LLVM_UNLIKELY(!resultRes->isObject())) {
+      return runtime->raiseTypeError(
+          "iterator.next() did not return an object");
+    }
+    Handle<JSObject> result = runtime->makeHandle<JSObject>(*resultRes);
+    auto doneRes = JSObject::getNamed_RJS(
+        result, runtime, Predefined::getSymbolID(Predefined::done));
+    if (LLVM_UNLIKELY(doneRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (toBoolean(*doneRes)) {
+      return args.getArg(2);
+    }
+    auto valueRes = JSObject::getNamed_RJS(
+        result, runtime, Predefined::getSymbolID(Predefined::value));
+    if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    return *valueRes;
+  }
+  if (LLVM_UNLIKELY(nextRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return *nextRes ? value.get() : args.getArg(2);
+}
+
+/// \return true if \p array is an array and \p method is the original
+/// Array.prototype method identified by \p kind, an
+/// ArrayCallbackMethod::Enum. The optimizer lowers calls of these methods
+/// with a known callback to loops, which are only entered when this holds.
+///
+/// \code
+///   HermesBuiltin.isArrayCallbackMethod = function(array, method, kind)
+/// \endcode
+CallResult<HermesValue>
+hermesBuiltinIsArrayCallbackMethod(void *, Runtime *, NativeArgs args) {
+  auto *native = dyn_vmcast<NativeFunction>(args.getArg(1));
+  if (!vmisa<JSArray>(args.getArg(0)) || !native || !args.getArg(2).isNumber())
+    return HermesValue::encodeBoolValue(false);
+
+  NativeFunctionPtr expected;
+  switch ((unsigned)args.getArg(2).getNumber()) {
+    case ArrayCallbackMethod::forEach:
+      expected = arrayPrototypeForEach;
+      break;
+    case ArrayCallbackMethod::map:
+      expected = arrayPrototypeMap;
+      break;
+    case ArrayCallbackMethod::filter:
+      expected = arrayPrototypeFilter;
+      break;
+    case ArrayCallbackMethod::reduce:
+      expected = arrayPrototypeReduce;
+      break;
+    default:
+      return HermesValue::encodeBoolValue(false);
+  }
+  return HermesValue::encodeBoolValue(native->getFunctionPtr() == expected);
+}
+
 /// Throw a type error with the argument as a message.
 ///
 /// \code
@@ -263,6 +374,14 @@ hermesBuiltinCopyDataProperties(void *, Runtime *runtime, NativeArgs args) {
             runtime->makeHandle(*toObject(runtime, untypedSource)));
   Handle<JSObject> excludedItems = args.dyncastArg<JSObject>(2);
 
+  // Plain objects are copied straight from their slots.
+  auto copyRes = copyPlainDataProperties(
+      runtime, target, source, excludedItems, /* set */ false);
+  if (LLVM_UNLIKELY(copyRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  if (*copyRes)
+    return target.getHermesValue();
+
   MutableHandle<> nameHandle{runtime};
   MutableHandle<> valueHandle{runtime};
 
@@ -499,6 +618,70 @@ hermesBuiltinApply(void *, Runtime *runtime, NativeArgs args) {
                        : Callable::call(fn, runtime);
 }
 
+/// \code
+///   HermesBuiltin.applyArguments = function(fn, thisVal, apply(opt)) {}
+/// \endcode
+/// Call \c fn with \c thisVal and the parameters of the caller, as if by
+/// `fn.apply(thisVal, arguments)` in the caller, without creating an
+/// arguments object.
+/// If \c apply is provided, it is the value of `fn.apply` in the caller, and
+/// the parameters are only forwarded if it is Function.prototype.apply.
+/// Otherwise it is called with a new arguments object of the caller.
+CallResult<HermesValue>
+hermesBuiltinApplyArguments(void *, Runtime *runtime, NativeArgs args) {
+  GCScopeMarkerRAII marker{runtime};
+
+  // Obtain the caller's stack frame.
+  auto frames = runtime->getStackFrames();
+  auto it = frames.begin();
+  ++it;
+  // Check for the extremely unlikely case where there is no caller frame.
+  if (LLVM_UNLIKELY(it == frames.end()))
+    return HermesValue::encodeUndefinedValue();
+  StackFramePtr caller = *it;
+  uint32_t argCount = caller.getArgCount();
+
+  if (args.getArgCount() > 2) {
+    auto *nativeApply = dyn_vmcast<NativeFunction>(args.getArg(2));
+    if (!nativeApply ||
+        nativeApply->getFunctionPtr() != functionPrototypeApply) {
+      Handle<Callable> apply = args.dyncastArg<Callable>(2);
+      if (LLVM_UNLIKELY(!apply)) {
+        return runtime->raiseTypeErrorForValue(
+            args.getArgHandle(2), " is not a function");
+      }
+      auto argRes = Arguments::create(
+          runtime,
+          argCount,
+          caller.getCalleeClosureHandleUnsafe(),
+          caller.getCalleeCodeBlock()->isStrictMode());
+      if (LLVM_UNLIKELY(argRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      Arguments *argObj = vmcast<Arguments>(*argRes);
+      for (uint32_t i = 0; i != argCount; ++i) {
+        Arguments::unsafeSetExistingElementAt(
+            argObj, runtime, i, caller.getArgRef(i));
+      }
+      return Callable::executeCall2(
+          apply, runtime, args.getArgHandle(0), args.getArg(1), *argRes);
+    }
+  }
+
+  Handle<Callable> fn = args.dyncastArg<Callable>(0);
+  if (LLVM_UNLIKELY(!fn)) {
+    return runtime->raiseTypeError("Can't apply() to non-callable");
+  }
+
+  ScopedNativeCallFrame newFrame{runtime, argCount, *fn, false, args.getArg(1)};
+  if (LLVM_UNLIKELY(newFrame.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
+  for (uint32_t i = 0; i != argCount; ++i) {
+    newFrame->getArgRef(i) = caller.getArgRef(i);
+  }
+  return Callable::call(fn, runtime);
+}
+
 /// HermesBuiltin.exportAll(exports, source) will copy exported named
 /// properties from `source` to `exports`, defining them on `exports` as
 /// non-configurable.
@@ -590,6 +773,16 @@ void createHermesBuiltins(
       P::ensureObject,
       hermesBuiltinEnsureObject,
       2);
+  defineInternMethod(
+      B::HermesBuiltin_iteratorStep,
+      P::iteratorStep,
+      hermesBuiltinIteratorStep,
+      3);
+  defineInternMethod(
+      B::HermesBuiltin_isArrayCallbackMethod,
+      P::isArrayCallbackMethod,
+      hermesBuiltinIsArrayCallbackMethod,
+      3);
   defineInternMethod(
       B::HermesBuiltin_throwTypeError,
       P::throwTypeError,
@@ -616,6 +809,11 @@ void createHermesBuiltins(
       hermesBuiltinArraySpread,
       2);
   defineInternMethod(B::HermesBuiltin_apply, P::apply, hermesBuiltinApply, 2);
+  defineInternMethod(
+      B::HermesBuiltin_applyArguments,
+      P::applyArguments,
+      hermesBuiltinApplyArguments,
+      2);
   defineInternMethod(
       B::HermesBuiltin_exportAll, P::exportAll, hermesBuiltinExportAll);
   defineInternMethod(
@@ -205,6 +205,28 @@ hermesInternalGetInstrumentedStats(void *, Runtime *runtime, NativeArgs args) {
     }                                                          \
   } while (false)
 
+/// Adds the hardware counters in \p COUNTERS as properties named \p PREFIX
+/// followed by the name of each counter.
+#define SET_PROP_COUNTERS(PREFIX, COUNTERS)                        \
+  do {                                                             \
+    const instrumentation::HardwareCounters &counters = COUNTERS;  \
+    const std::pair<const char *, uint64_t> values[] = {           \
+        {"Instructions", counters.instructions},                   \
+        {"Cycles", counters.cycles},                               \
+        {"CacheMisses", counters.cacheMisses},                     \
+        {"TLBMisses", counters.tlbMisses}};                        \
+    for (const auto &value : values) {                             \
+      SET_PROP_NEW((PREFIX + value.first).c_str(), value.second);  \
+    }                                                              \
+  } while (false)
+
+  SET_PROP_NEW("js_jitCompileTime", stats.jitCompile.wallDuration);
+  SET_PROP_NEW("js_jitCompileCPUTime", stats.jitCompile.cpuDuration);
+  SET_PROP_NEW("js_jitCompileCount", stats.jitCompile.count);
+  SET_PROP_NEW("js_moduleInitTime", stats.moduleInit.wallDuration);
+  SET_PROP_NEW("js_moduleInitCPUTime", stats.moduleInit.cpuDuration);
+  SET_PROP_NEW("js_moduleInitCount", stats.moduleInit.count);
+
   {
     GCBase::HeapInfo info;
     heap.getHeapInfo(info);
@@ -213,6 +235,39 @@ hermesInternalGetInstrumentedStats(void *, Runtime *runtime, NativeArgs args) {
     SET_PROP_NEW("js_heapSize", info.heapSize);
     SET_PROP_NEW("js_mallocSizeEstimate", info.mallocSizeEstimate);
     SET_PROP_NEW("js_vaSize", info.va);
+
+    // The times of the phases of all collections, with histograms of their
+    // wall times keyed by the upper limit, in microseconds, of each non-empty
+    // bucket.
+    using Histogram = GCBase::PhaseHistogram;
+    for (unsigned i = 0; i < kNumGCPhases; ++i) {
+      const Histogram &hist = info.phaseTimes[i];
+      if (hist.wallTime.count() == 0) {
+        continue;
+      }
+      const std::string name =
+          std::string("js_gc_") + gcPhaseName(static_cast<GCPhase>(i));
+      SET_PROP_NEW((name + "Time").c_str(), hist.wallTime.sum());
+      SET_PROP_NEW((name + "MaxTime").c_str(), hist.wallTime.max());
+      SET_PROP_NEW((name + "CPUTime").c_str(), hist.cpuTime.sum());
+      if (stats.shouldSample && hist.counters.cycles != 0) {
+        SET_PROP_COUNTERS(name, hist.counters);
+      }
+      for (unsigned b = 0; b < Histogram::kNumBuckets; ++b) {
+        if (hist.buckets[b] == 0) {
+          continue;
+        }
+        // The last bucket is unbounded: key it by its lower limit.
+        const bool last = b == Histogram::kNumBuckets - 1;
+        const auto limitUs = static_cast<int64_t>(
+            Histogram::bucketLimitSecs(last ? b - 1 : b) * 1e6);
+        SET_PROP_NEW(
+            (name + (last ? "TimeAtLeast" : "TimeBelow") +
+             std::to_string(limitUs))
+                .c_str(),
+            hist.buckets[b]);
+      }
+    }
   }
 
   if (stats.shouldSample) {
@@ -230,8 +285,30 @@ hermesInternalGetInstrumentedStats(void *, Runtime *runtime, NativeArgs args) {
             stats.incomingFunction.sampled.involCtxSwitches));
     // Sampled because it doesn't vary much, not because it's expensive to get.
     SET_PROP_NEW("js_pageSize", oscompat::page_size());
+
+    // The hardware counters of the instrumented parts of the execution, to
+    // compare their instructions per cycle across versions. They are only
+    // present where the CPU and the kernel let the thread count them.
+    const struct {
+      const char *name;
+      const instrumentation::RuntimeStats::Statistic &stat;
+    } statistics[] = {
+        {"js_hostFunction", stats.hostFunction},
+        {"js_evaluateJS", stats.evaluateJS},
+        {"js_incomingFunction", stats.incomingFunction},
+        {"js_jitCompile", stats.jitCompile},
+        {"js_moduleInit", stats.moduleInit},
+    };
+    for (const auto &statistic : statistics) {
+      if (statistic.stat.sampled.hardware.cycles != 0) {
+        SET_PROP_COUNTERS(
+            std::string(statistic.name), statistic.stat.sampled.hardware);
+      }
+    }
   }
 
+#undef SET_PROP_COUNTERS
+
 /// Adds a property to \c resultHandle. \p KEY and \p VALUE provide its name and
 /// value as a C string and ASCIIRef respectively. If property definition fails,
 /// the exceptional execution status will be propogated to the outer function.
@@ -374,6 +451,55 @@ hermesInternalGetRuntimeProperties(void *, Runtime *runtime, NativeArgs args) {
   return resultHandle.getHermesValue();
 }
 
+/// \return an object mapping each category of the memory held by the runtime
+/// outside of the JS heap to its size in bytes.
+CallResult<HermesValue>
+hermesInternalGetNativeMemoryInfo(void *, Runtime *runtime, NativeArgs args) {
+  GCScope gcScope(runtime);
+  auto resultHandle = toHandle(runtime, JSObject::create(runtime));
+  MutableHandle<> tmpHandle{runtime};
+
+  Runtime::NativeMemoryInfo info;
+  runtime->getNativeMemoryInfo(info);
+
+  /// Add the size \p value keyed under \p key to resultHandle.
+  /// \return an ExecutionStatus.
+  auto addSize = [&](const char *key, size_t value) {
+    GCScopeMarkerRAII marker{gcScope};
+    auto keySym = symbolForCStr(runtime, key);
+    if (LLVM_UNLIKELY(keySym == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    tmpHandle = HermesValue::encodeNumberValue(value);
+    return JSObject::defineNewOwnProperty(
+        resultHandle,
+        runtime,
+        **keySym,
+        PropertyFlags::defaultNewNamedPropertyFlags(),
+        tmpHandle);
+  };
+
+  const std::pair<const char *, size_t> sizes[] = {
+      {"identifierTable", info.identifierTable},
+      {"runtimeModules", info.runtimeModules},
+      {"codeBlocks", info.codeBlocks},
+      {"propertyCaches", info.propertyCaches},
+      {"hiddenClassTransitions", info.hiddenClassTransitions},
+      {"hiddenClassPropertyMaps", info.hiddenClassPropertyMaps},
+      {"jitCode", info.jitCode},
+      {"bytecode", info.bytecode},
+      {"bytecodeResident", info.bytecodeResident},
+  };
+  for (const auto &size : sizes) {
+    if (LLVM_UNLIKELY(
+            addSize(size.first, size.second) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+
+  return resultHandle.getHermesValue();
+}
+
 #ifdef HERMESVM_PLATFORM_LOGGING
 static void logGCStats(Runtime *runtime, const char *msg) {
   // The GC stats can exceed the android logcat length limit, of
@@ -732,6 +858,7 @@ Handle<JSObject> createHermesInternalObject(
       P::getInstrumentedStats, hermesInternalGetInstrumentedStats);
   defineInternMethod(
       P::getRuntimeProperties, hermesInternalGetRuntimeProperties);
+  defineInternMethod(P::getNativeMemoryInfo, hermesInternalGetNativeMemoryInfo);
   defineInternMethod(P::ttiReached, hermesInternalTTIReached);
   defineInternMethod(P::ttrcReached, hermesInternalTTRCReached);
 #ifdef HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
@@ -17,6 +17,29 @@
 namespace hermes {
 namespace vm {
 
+/// Define the global property \p name with the value \p constructor.
+static void defineGlobalConstructor(
+    Runtime *runtime,
+    SymbolID name,
+    Handle<NativeConstructor> constructor) {
+  DefinePropertyFlags dpf{};
+
+  dpf.setEnumerable = 1;
+  dpf.setWritable = 1;
+  dpf.setConfigurable = 1;
+  dpf.setValue = 1;
+  dpf.enumerable = 0;
+  dpf.writable = 1;
+  dpf.configurable = 1;
+
+  auto res = JSObject::defineOwnProperty(
+      runtime->getGlobal(), runtime, name, dpf, constructor);
+  assert(
+      res != ExecutionStatus::EXCEPTION && *res &&
+      "defineOwnProperty() failed");
+  (void)res;
+}
+
 Handle<NativeConstructor> defineSystemConstructor(
     Runtime *runtime,
     SymbolID name,
@@ -37,8 +60,23 @@ Handle<NativeConstructor> defineSystemConstructor(
           creator,
           targetKind));
 
+  defineSystemConstructorProperties(
+      runtime, constructor, name, prototypeObjectHandle, paramCount);
+
+  // Define the global.
+  defineGlobalConstructor(runtime, name, constructor);
+
+  return constructor;
+}
+
+void defineSystemConstructorProperties(
+    Runtime *runtime,
+    Handle<JSObject> constructor,
+    SymbolID name,
+    Handle<JSObject> prototypeObjectHandle,
+    unsigned paramCount) {
   auto st = Callable::defineNameLengthAndPrototype(
-      constructor,
+      Handle<Callable>::vmcast(constructor),
       runtime,
       name,
       paramCount,
@@ -48,24 +86,33 @@ Handle<NativeConstructor> defineSystemConstructor(
   (void)st;
   assert(
       st != ExecutionStatus::EXCEPTION && "defineLengthAndPrototype() failed");
+}
 
-  // Define the global.
-  DefinePropertyFlags dpf{};
+Handle<NativeConstructor> defineLazySystemConstructor(
+    Runtime *runtime,
+    SymbolID name,
+    NativeFunctionPtr nativeFunctionPtr,
+    Handle<JSObject> prototypeObjectHandle,
+    Handle<JSObject> constructorProtoObjectHandle,
+    unsigned paramCount,
+    NativeConstructor::CreatorFunction *creator,
+    CellKind targetKind,
+    Runtime::LazyBuiltinInit *init) {
+  auto constructor = toHandle(
+      runtime,
+      NativeConstructor::create(
+          runtime,
+          constructorProtoObjectHandle,
+          nullptr,
+          nativeFunctionPtr,
+          paramCount,
+          creator,
+          targetKind));
 
-  dpf.setEnumerable = 1;
-  dpf.setWritable = 1;
-  dpf.setConfigurable = 1;
-  dpf.setValue = 1;
-  dpf.enumerable = 0;
-  dpf.writable = 1;
-  dpf.configurable = 1;
+  JSObject::makeLazyBuiltin(runtime, constructor, prototypeObjectHandle, init);
 
-  auto res = JSObject::defineOwnProperty(
-      runtime->getGlobal(), runtime, name, dpf, constructor);
-  assert(
-      res != ExecutionStatus::EXCEPTION && *res &&
-      "defineOwnProperty() failed");
-  (void)res;
+  // Define the global.
+  defineGlobalConstructor(runtime, name, constructor);
 
   return constructor;
 }
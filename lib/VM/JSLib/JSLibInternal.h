@@ -75,6 +75,31 @@ Handle<NativeConstructor> defineSystemConstructor(
       targetKind);
 }
 
+/// Define the 'name', 'length' and 'prototype' properties of the system
+/// constructor \p constructor, and the 'constructor' property of its
+/// prototype \p prototypeObjectHandle, as defineSystemConstructor() does.
+void defineSystemConstructorProperties(
+    Runtime *runtime,
+    Handle<JSObject> constructor,
+    SymbolID name,
+    Handle<JSObject> prototypeObjectHandle,
+    unsigned paramCount);
+
+/// Declare a new system constructor like defineSystemConstructor(), except that
+/// the constructor and \p prototypeObjectHandle are left without properties
+/// until either of them is first used. Then \p init is called to define them,
+/// and it must call defineSystemConstructorProperties().
+Handle<NativeConstructor> defineLazySystemConstructor(
+    Runtime *runtime,
+    SymbolID name,
+    NativeFunctionPtr nativeFunctionPtr,
+    Handle<JSObject> prototypeObjectHandle,
+    Handle<JSObject> constructorProtoObjectHandle,
+    unsigned paramCount,
+    NativeConstructor::CreatorFunction *creator,
+    CellKind targetKind,
+    Runtime::LazyBuiltinInit *init);
+
 /// Define a method in an object instance.
 /// Currently, it's only used to define global %HermesInternal object in
 /// createHermesInternalObject(), with different flags, i.e. writable = 0 and
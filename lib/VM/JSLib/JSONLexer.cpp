@@ -7,6 +7,7 @@
 
 #include "JSONLexer.h"
 
+#include "hermes/Support/Conversions.h"
 #include "hermes/VM/StringPrimitive.h"
 
 #include "dtoa/dtoa.h"
@@ -23,14 +24,48 @@ static bool isJSONWhiteSpace(char16_t ch) {
   return (ch == u'\t' || ch == u'\r' || ch == u'\n' || ch == u' ');
 }
 
-ExecutionStatus JSONLexer::advance() {
-  // Skip whitespaces.
-  while (curCharPtr_.hasChar() && isJSONWhiteSpace(*curCharPtr_)) {
-    ++curCharPtr_;
+/// \return the number of characters at the start of \p str which stand for
+/// themselves in a JSONString: anything but a quote, a backslash or a control
+/// character. Blocks of characters are checked without branching, which the
+/// compiler vectorizes, and only the block which ends the run is checked again
+/// one character at a time.
+static size_t plainStringRunLength(llvm::ArrayRef<char16_t> str) {
+  constexpr size_t kBlockSize = 16;
+  const char16_t *begin = str.begin();
+  const char16_t *end = str.end();
+  const char16_t *cur = begin;
+  for (; (size_t)(end - cur) >= kBlockSize; cur += kBlockSize) {
+    bool special = false;
+    for (size_t i = 0; i < kBlockSize; ++i) {
+      special |= (cur[i] == u'"') | (cur[i] == u'\\') | (cur[i] < 0x20);
+    }
+    if (special)
+      break;
+  }
+  while (cur != end && *cur != u'"' && *cur != u'\\' && *cur >= 0x20)
+    ++cur;
+  return cur - begin;
+}
+
+ExecutionStatus JSONLexer::advanceImpl(bool forKey) {
+  // Skip whitespaces, a run of the available characters at a time.
+  while (curCharPtr_.hasChar()) {
+    llvm::ArrayRef<char16_t> chars = curCharPtr_.available();
+    size_t count = 0;
+    while (count < chars.size() && isJSONWhiteSpace(chars[count])) {
+      ++count;
+    }
+    if (count == 0) {
+      break;
+    }
+    curCharPtr_ += count;
   }
 
   // End of buffer.
   if (!curCharPtr_.hasChar()) {
+    if (LLVM_UNLIKELY(curCharPtr_.isMalformed())) {
+      return errorEndOfInput();
+    }
     token_.setEof();
     return ExecutionStatus::RETURNED;
   }
@@ -66,7 +101,7 @@ ExecutionStatus JSONLexer::advance() {
       return scanNumber();
 
     case u'"':
-      return scanString();
+      return scanString(forKey);
 
     default:
       return errorWithChar(u"Unexpected token: ", *curCharPtr_);
@@ -77,7 +112,7 @@ CallResult<char16_t> JSONLexer::consumeUnicode() {
   uint16_t val = 0;
   for (unsigned i = 0; i < 4; ++i) {
     if (!curCharPtr_.hasChar()) {
-      return error("Unexpected end of input");
+      return errorEndOfInput();
     }
     int ch = *curCharPtr_ | 32;
     if (ch >= '0' && ch <= '9') {
@@ -124,15 +159,34 @@ ExecutionStatus JSONLexer::scanNumber() {
   return ExecutionStatus::RETURNED;
 }
 
-ExecutionStatus JSONLexer::scanString() {
+ExecutionStatus JSONLexer::scanString(bool forKey) {
   assert(*curCharPtr_ == '"');
   ++curCharPtr_;
   SmallU16String<32> tmpStorage;
 
   while (curCharPtr_.hasChar()) {
+    // Copy the run of characters which need no processing at once.
+    llvm::ArrayRef<char16_t> chars = curCharPtr_.available();
+    if (size_t run = plainStringRunLength(chars)) {
+      tmpStorage.append(chars.begin(), chars.begin() + run);
+      curCharPtr_ += run;
+      continue;
+    }
+
     if (*curCharPtr_ == '"') {
       // End of string.
       ++curCharPtr_;
+      if (forKey && !toArrayIndex(tmpStorage.begin(), tmpStorage.end())) {
+        // The key will be interned to define the property anyway, which
+        // doesn't need a StringPrimitive if the identifier already exists.
+        auto symRes = runtime_->getIdentifierTable().getSymbolHandle(
+            runtime_, tmpStorage.arrayRef());
+        if (LLVM_UNLIKELY(symRes == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        token_.setSymbol(symRes->get());
+        return ExecutionStatus::RETURNED;
+      }
       // If the string exists in the identifier table, use that one.
       if (auto existing =
               runtime_->getIdentifierTable().getExistingStringPrimitiveOrNull(
@@ -152,7 +206,7 @@ ExecutionStatus JSONLexer::scanString() {
     if (*curCharPtr_ == u'\\') {
       ++curCharPtr_;
       if (!curCharPtr_.hasChar()) {
-        return error("Unexpected end of input");
+        return errorEndOfInput();
       }
       switch (*curCharPtr_) {
         case u'"':
@@ -196,12 +250,9 @@ ExecutionStatus JSONLexer::scanString() {
         default:
           return errorWithChar(u"Invalid escape sequence: ", *curCharPtr_);
       }
-    } else {
-      tmpStorage.push_back(*curCharPtr_);
-      ++curCharPtr_;
     }
   }
-  return error("Unexpected end of input");
+  return errorEndOfInput();
 }
 
 ExecutionStatus JSONLexer::scanWord(const char *word, JSONTokenKind kind) {
@@ -213,7 +264,7 @@ ExecutionStatus JSONLexer::scanWord(const char *word, JSONTokenKind kind) {
     ++word;
   }
   if (*word) {
-    return error(u"Unexpected end of input");
+    return errorEndOfInput();
   }
   token_.setPunctuator(kind);
   return ExecutionStatus::RETURNED;
@@ -46,6 +46,7 @@ class JSONToken {
   JSONTokenKind kind_{JSONTokenKind::None};
   double numberValue_{};
   MutableHandle<StringPrimitive> stringValue_;
+  MutableHandle<SymbolID> symbolValue_;
 
   /// The starting character of this token.
   char16_t firstChar_{};
@@ -54,7 +55,8 @@ class JSONToken {
   const JSONToken &operator=(const JSONToken &) = delete;
 
  public:
-  explicit JSONToken(Runtime *runtime) : stringValue_(runtime) {}
+  explicit JSONToken(Runtime *runtime)
+      : stringValue_(runtime), symbolValue_(runtime) {}
 
   JSONTokenKind getKind() const {
     return kind_;
@@ -67,9 +69,18 @@ class JSONToken {
 
   Handle<StringPrimitive> getString() const {
     assert(getKind() == JSONTokenKind::String);
+    assert(stringValue_ && "String was interned as an identifier");
     return stringValue_;
   }
 
+  /// \return the identifier of a string scanned as the key of a property, or
+  /// an invalid SymbolID if it was created as a StringPrimitive, which
+  /// getString() returns.
+  SymbolID getSymbol() const {
+    assert(getKind() == JSONTokenKind::String);
+    return symbolValue_.get();
+  }
+
   char16_t getFirstChar() const {
     return firstChar_;
   }
@@ -95,6 +106,12 @@ class JSONToken {
   void setString(Handle<StringPrimitive> str) {
     kind_ = JSONTokenKind::String;
     stringValue_ = str.get();
+    symbolValue_ = SymbolID{};
+  }
+  void setSymbol(SymbolID sym) {
+    kind_ = JSONTokenKind::String;
+    stringValue_ = nullptr;
+    symbolValue_ = sym;
   }
 };
 
@@ -121,7 +138,17 @@ class JSONLexer {
   /// Scan the next token, and store it in token_.
   /// \return Exception if error occurs.
   /// All whitespace is skipped before the new token.
-  LLVM_NODISCARD ExecutionStatus advance();
+  LLVM_NODISCARD ExecutionStatus advance() {
+    return advanceImpl(false);
+  }
+
+  /// Scan the next token like advance(), where it may be the key of a
+  /// property. A string which isn't an array index is then interned as an
+  /// identifier, returned by JSONToken::getSymbol(), without creating a
+  /// StringPrimitive if the identifier already exists.
+  LLVM_NODISCARD ExecutionStatus advanceForKey() {
+    return advanceImpl(true);
+  }
 
   /// Raise a JSON parse exception with message \p msg.
   /// token_ will also be invalidated.
@@ -139,11 +166,23 @@ class JSONLexer {
   }
 
  private:
+  /// Raise a JSON parse exception for input which ended in the middle of a
+  /// token, or where the UTF8 input was malformed.
+  LLVM_NODISCARD ExecutionStatus errorEndOfInput() {
+    return error(
+        curCharPtr_.isMalformed() ? "Invalid UTF-8 in input"
+                                  : "Unexpected end of input");
+  }
+
+  /// Scan the next token, interning strings if \p forKey.
+  LLVM_NODISCARD ExecutionStatus advanceImpl(bool forKey);
+
   /// Parse a JSONNumber.
   LLVM_NODISCARD ExecutionStatus scanNumber();
 
-  /// Parse a JSONString.
-  LLVM_NODISCARD ExecutionStatus scanString();
+  /// Parse a JSONString, interning it as an identifier if \p forKey and it
+  /// isn't an array index.
+  LLVM_NODISCARD ExecutionStatus scanString(bool forKey);
 
   /// Parse a reserved keyword.
   LLVM_NODISCARD ExecutionStatus scanWord(const char *word, JSONTokenKind kind);
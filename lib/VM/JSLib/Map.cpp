@@ -17,7 +17,8 @@
 namespace hermes {
 namespace vm {
 
-Handle<JSObject> createMapConstructor(Runtime *runtime) {
+/// Define the properties of the Map constructor \p cons and of Map.prototype.
+static void populateMap(Runtime *runtime, Handle<JSObject> cons) {
   auto mapPrototype = Handle<JSMap>::vmcast(&runtime->mapPrototype);
 
   // Map.prototype.xxx methods.
@@ -131,15 +132,21 @@ Handle<JSObject> createMapConstructor(Runtime *runtime) {
       runtime->getPredefinedStringHandle(Predefined::Map),
       dpf);
 
-  auto cons = defineSystemConstructor<JSMap>(
+  defineSystemConstructorProperties(
+      runtime, cons, Predefined::getSymbolID(Predefined::Map), mapPrototype, 0);
+}
+
+Handle<JSObject> createMapConstructor(Runtime *runtime) {
+  return defineLazySystemConstructor(
       runtime,
       Predefined::getSymbolID(Predefined::Map),
       mapConstructor,
-      mapPrototype,
+      Handle<JSObject>::vmcast(&runtime->mapPrototype),
+      Handle<JSObject>::vmcast(&runtime->functionPrototype),
       0,
-      CellKind::MapKind);
-
-  return cons;
+      JSMap::create,
+      CellKind::MapKind,
+      populateMap);
 }
 
 CallResult<HermesValue>
@@ -242,7 +249,10 @@ mapPrototypeClear(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Method Map.prototype.clear called on incompatible receiver");
   }
-  JSMap::clear(selfHandle, runtime);
+  if (LLVM_UNLIKELY(
+          JSMap::clear(selfHandle, runtime) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return HermesValue::encodeUndefinedValue();
 }
 
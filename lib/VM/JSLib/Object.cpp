@@ -672,6 +672,68 @@ objectIsExtensible(void *, Runtime *runtime, NativeArgs args) {
   return HermesValue::encodeBoolValue(*extRes);
 }
 
+CallResult<HermesValue> getCachedEnumerableOwnKeys(
+    Runtime *runtime,
+    Handle<JSObject> objHandle) {
+  HiddenClass *clazz = objHandle->getClass(runtime);
+  assert(
+      objHandle->getKind() == CellKind::ObjectKind && !clazz->isDictionary() &&
+      "only the classes of plain objects cache their keys");
+  if (ArrayStorage *keys = clazz->getKeysCache(runtime)) {
+    return HermesValue::encodeObjectValue(keys);
+  }
+
+  auto clazzHandle = runtime->makeHandle(clazz);
+  auto namesRes = getOwnPropertyKeysAsStrings(
+      objHandle, runtime, OwnKeysFlags().plusIncludeNonSymbols());
+  if (LLVM_UNLIKELY(namesRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto names = runtime->makeHandle<JSArray>(*namesRes);
+  uint32_t len = JSArray::getLength(*names);
+  auto keysRes = ArrayStorage::create(runtime, len, len);
+  if (LLVM_UNLIKELY(keysRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto *keys = vmcast<ArrayStorage>(*keysRes);
+  for (uint32_t i = 0; i != len; ++i) {
+    keys->at(i).set(names->at(runtime, i), &runtime->getHeap());
+  }
+  clazzHandle->setKeysCache(keys, runtime);
+  return *keysRes;
+}
+
+/// \return the names of the enumerable string-keyed own properties of
+/// \p objHandle, as getOwnPropertyKeysAsStrings() returns them, taken from
+/// the cache in the class of plain objects which aren't dictionaries.
+static CallResult<HermesValue> getEnumerableOwnKeys(
+    Runtime *runtime,
+    Handle<JSObject> objHandle) {
+  if (objHandle->getKind() != CellKind::ObjectKind ||
+      objHandle->getClass(runtime)->isDictionary()) {
+    return getOwnPropertyKeysAsStrings(
+        objHandle, runtime, OwnKeysFlags().plusIncludeNonSymbols());
+  }
+
+  auto keysRes = getCachedEnumerableOwnKeys(runtime, objHandle);
+  if (LLVM_UNLIKELY(keysRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto keysHandle = runtime->makeHandle<ArrayStorage>(*keysRes);
+  ArrayStorage::size_type len = keysHandle->size();
+  auto arrRes = JSArray::create(runtime, len, len);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto arr = toHandle(runtime, std::move(*arrRes));
+  MutableHandle<> name{runtime};
+  for (ArrayStorage::size_type i = 0; i != len; ++i) {
+    name = keysHandle->at(i);
+    JSArray::setElementAt(arr, runtime, i, name);
+  }
+  return arr.getHermesValue();
+}
+
 /// ES8.0 7.3.21.
 /// EnumerableOwnProperties gets the requested properties based on \p kind.
 CallResult<HermesValue> enumerableOwnProperties_RJS(
@@ -680,8 +742,7 @@ CallResult<HermesValue> enumerableOwnProperties_RJS(
     EnumerableOwnPropertiesKind kind) {
   GCScope gcScope{runtime};
 
-  auto namesRes = getOwnPropertyKeysAsStrings(
-      objHandle, runtime, OwnKeysFlags().plusIncludeNonSymbols());
+  auto namesRes = getEnumerableOwnKeys(runtime, objHandle);
   if (namesRes == ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
@@ -802,6 +863,130 @@ objectEntries(void *, Runtime *runtime, NativeArgs args) {
       EnumerableOwnPropertiesKind::KeyValue);
 }
 
+CallResult<bool> copyPlainDataProperties(
+    Runtime *runtime,
+    Handle<JSObject> target,
+    Handle<JSObject> source,
+    Handle<JSObject> excludedItems,
+    bool set) {
+  if (source->getKind() != CellKind::ObjectKind)
+    return false;
+  auto clazz = runtime->makeHandle(source->getClass(runtime));
+  if (clazz->isDictionary() || clazz->getHasIndexLikeProperties())
+    return false;
+
+  // Collect the properties in [[OwnPropertyKeys]] order: the strings, then
+  // the symbols, each in the order they were added.
+  using Property = std::pair<SymbolID, NamedPropertyDescriptor>;
+  llvm::SmallVector<Property, 16> props;
+  llvm::SmallVector<Property, 4> symbolProps;
+  bool plain = true;
+  bool allDefault = true;
+  HiddenClass::forEachProperty(
+      clazz,
+      runtime,
+      [&props, &symbolProps, &plain, &allDefault](
+          SymbolID id, NamedPropertyDescriptor desc) {
+        if (desc.flags.accessor || desc.flags.internalSetter)
+          plain = false;
+        if (desc.flags != PropertyFlags::defaultNewNamedPropertyFlags())
+          allDefault = false;
+        if (InternalProperty::isInternal(id)) {
+          allDefault = false;
+          return;
+        }
+        (isSymbolPrimitive(id) ? symbolProps : props).emplace_back(id, desc);
+      });
+  if (!plain)
+    return false;
+  props.append(symbolProps.begin(), symbolProps.end());
+
+  // [[Set]] only adds the properties if nothing on the prototype chain of the
+  // target intercepts them.
+  auto addedBySet = [runtime, target, &props]() {
+    MutableHandle<JSObject> proto{runtime, target->getParent(runtime)};
+    for (; proto; proto = proto->getParent(runtime)) {
+      if (proto->isLazy() || proto->isHostObject())
+        return false;
+      for (const Property &prop : props) {
+        NamedPropertyDescriptor desc;
+        if (JSObject::getOwnNamedDescriptor(proto, runtime, prop.first, desc) &&
+            (desc.flags.accessor || !desc.flags.writable)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+  if (allDefault && !excludedItems && (!set || addedBySet())) {
+    auto adoptRes = JSObject::tryAdoptClassAndSlots(target, runtime, source);
+    if (LLVM_UNLIKELY(adoptRes == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    if (*adoptRes)
+      return true;
+  }
+
+  MutableHandle<> valueHandle{runtime};
+  GCScopeMarkerRAII marker{runtime};
+  for (const Property &prop : props) {
+    marker.flush();
+    SymbolID name = prop.first;
+    NamedPropertyDescriptor desc = prop.second;
+
+    if (LLVM_LIKELY(source->getClass(runtime) == *clazz)) {
+      if (!desc.flags.enumerable)
+        continue;
+    } else {
+      // Setters on the target have changed the source: look the property up
+      // again, as the generic path would.
+      if (!JSObject::getOwnNamedDescriptor(source, runtime, name, desc) ||
+          !desc.flags.enumerable) {
+        continue;
+      }
+    }
+
+    if (excludedItems) {
+      auto cr = JSObject::hasNamedOrIndexed(excludedItems, runtime, name);
+      if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      if (*cr)
+        continue;
+    }
+
+    if (LLVM_LIKELY(!desc.flags.accessor)) {
+      valueHandle = JSObject::getNamedSlotValue(*source, runtime, desc);
+    } else {
+      auto cr =
+          JSObject::getNamedPropertyValue_RJS(source, runtime, source, desc);
+      if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      valueHandle = *cr;
+    }
+
+    if (set) {
+      if (LLVM_UNLIKELY(
+              JSObject::putNamed_RJS(
+                  target,
+                  runtime,
+                  name,
+                  valueHandle,
+                  PropOpFlags().plusThrowOnError()) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    } else if (LLVM_UNLIKELY(
+                   JSObject::defineOwnProperty(
+                       target,
+                       runtime,
+                       name,
+                       DefinePropertyFlags::getDefaultNewPropertyFlags(),
+                       valueHandle) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  return true;
+}
+
 CallResult<HermesValue>
 objectAssign(void *, Runtime *runtime, NativeArgs args) {
   vm::GCScope gcScope(runtime);
@@ -846,6 +1031,20 @@ objectAssign(void *, Runtime *runtime, NativeArgs args) {
     }
     fromHandle = vmcast<JSObject>(objRes.getValue());
 
+    // Plain objects are copied straight from their slots.
+    auto copyRes = copyPlainDataProperties(
+        runtime,
+        toHandle,
+        fromHandle,
+        Runtime::makeNullHandle<JSObject>(),
+        /* set */ true);
+    if (LLVM_UNLIKELY(copyRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (*copyRes) {
+      continue;
+    }
+
     // 5.b.ii. Let keys be from.[[OwnPropertyKeys]]().
     auto cr = JSObject::getOwnPropertyKeys(
         fromHandle,
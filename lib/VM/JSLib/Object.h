@@ -18,7 +18,7 @@ namespace hermes {
 namespace vm {
 
 // This file declares some functions in Object which are also used by
-// Reflect.
+// Reflect and JSON.
 
 CallResult<bool>
 defineProperty(Runtime *runtime, NativeArgs args, PropOpFlags opFlags);
@@ -35,6 +35,30 @@ CallResult<HermesValue> getOwnPropertyKeysAsStrings(
     Runtime *runtime,
     OwnKeysFlags okFlags);
 
+/// \return the ArrayStorage of the names of the enumerable string-keyed own
+/// properties of \p objHandle, as getOwnPropertyKeysAsStrings() returns them.
+/// \p objHandle must be a plain object which isn't a dictionary: the names
+/// are cached in its class, which never changes its properties, and must not
+/// be modified.
+CallResult<HermesValue> getCachedEnumerableOwnKeys(
+    Runtime *runtime,
+    Handle<JSObject> objHandle);
+
+/// Copy the enumerable own properties of \p source to \p target, reading them
+/// directly from the slots of \p source, when it is a plain object whose class
+/// isn't a dictionary and has no accessors or index-like names. If \p target
+/// is a new empty object, it simply takes the class of \p source.
+/// \param excludedItems if not null, properties it has are not copied.
+/// \param set whether to [[Set]] the properties like Object.assign(), instead
+///   of defining them like CopyDataProperties.
+/// \return false, without copying anything, if \p source doesn't qualify.
+CallResult<bool> copyPlainDataProperties(
+    Runtime *runtime,
+    Handle<JSObject> target,
+    Handle<JSObject> source,
+    Handle<JSObject> excludedItems,
+    bool set);
+
 /// "Kind" provided to enumerableOwnProperties to request different
 /// representation of the properties in the object.
 enum class EnumerableOwnPropertiesKind {
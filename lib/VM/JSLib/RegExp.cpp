@@ -14,6 +14,7 @@
 
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/SmallXString.h"
+#include "hermes/VM/StringBuilder.h"
 #include "hermes/VM/StringPrimitive.h"
 #include "hermes/VM/StringView.h"
 
@@ -125,7 +126,6 @@ Handle<JSObject> createRegExpConstructor(Runtime *runtime) {
   defineGetter(cons, Predefined::dollarPlus, regExpLastParenGetter);
   defineGetter(cons, Predefined::lastParen, regExpLastParenGetter);
 
-#ifndef HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
   defineMethod(
       runtime,
       proto,
@@ -172,7 +172,6 @@ Handle<JSObject> createRegExpConstructor(Runtime *runtime) {
       dpf);
 
   defineGetter(proto, Predefined::flags, regExpFlagsGetter);
-#endif // HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
 
   return cons;
 }
@@ -365,12 +364,14 @@ setLastIndex(Handle<JSObject> regexp, Runtime *runtime, double value) {
   return setLastIndex(regexp, runtime, HermesValue::encodeNumberValue(value));
 }
 
-// ES6 21.2.5.2.2
-CallResult<Handle<JSArray>> directRegExpExec(
+/// The part of ES6 21.2.5.2.2 RegExpBuiltinExec that reads lastIndex, runs
+/// the matcher of \p regexp on \p S and updates lastIndex, without creating
+/// the result array.
+/// \return the match, which is empty if there is none.
+static CallResult<RegExpMatch> regExpBuiltinMatch(
     Handle<JSRegExp> regexp,
     Runtime *runtime,
     Handle<StringPrimitive> S) {
-  MutableHandle<JSArray> A{runtime};
   GCScope gcScope{runtime};
 
   // Let length be the number of code units in S.
@@ -438,7 +439,7 @@ CallResult<Handle<JSArray>> directRegExpExec(
         return ExecutionStatus::EXCEPTION;
       }
     }
-    return Runtime::makeNullHandle<JSArray>();
+    return matchResult;
   }
 
   // We have a match!
@@ -469,6 +470,23 @@ CallResult<Handle<JSArray>> directRegExpExec(
       return ExecutionStatus::EXCEPTION;
     }
   }
+  return matchResult;
+}
+
+// ES6 21.2.5.2.2
+CallResult<Handle<JSArray>> directRegExpExec(
+    Handle<JSRegExp> regexp,
+    Runtime *runtime,
+    Handle<StringPrimitive> S) {
+  MutableHandle<JSArray> A{runtime};
+  GCScope gcScope{runtime};
+
+  CallResult<RegExpMatch> matchResult = regExpBuiltinMatch(regexp, runtime, S);
+  if (LLVM_UNLIKELY(matchResult == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  const RegExpMatch &match = *matchResult;
+  if (match.empty())
+    return Runtime::makeNullHandle<JSArray>();
 
   const auto dpf = DefinePropertyFlags::getDefaultNewPropertyFlags();
 
@@ -966,7 +984,6 @@ CallResult<HermesValue> getSubstitution(
   return StringPrimitive::create(runtime, result);
 }
 
-#ifndef HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
 // ES6 21.2.5.14
 // Note there is no requirement that 'this' be a RegExp object.
 CallResult<HermesValue>
@@ -1204,6 +1221,242 @@ regExpPrototypeSymbolSearch(void *, Runtime *runtime, NativeArgs args) {
       resultObj, runtime, Predefined::getSymbolID(Predefined::index));
 }
 
+/// Steps m and n of ES6.0 21.2.5.8: compute the replacement of \p matched,
+/// found at \p position in \p S with the capture groups \p captures, by
+/// calling \p replaceFn, or by substituting them into \p replaceValueStr if
+/// \p replaceFn is null.
+/// \return the replacement string.
+static CallResult<HermesValue> getReplacement(
+    Runtime *runtime,
+    Handle<Callable> replaceFn,
+    Handle<StringPrimitive> replaceValueStr,
+    Handle<StringPrimitive> matched,
+    uint32_t position,
+    Handle<ArrayStorage> captures,
+    Handle<StringPrimitive> S) {
+  if (!replaceFn) {
+    // n. Else,
+    // i. Let replacement be GetSubstitution(matched, S, position, captures,
+    // replaceValue).
+    return getSubstitution(
+        runtime, matched, S, position, captures, replaceValueStr);
+  }
+  // m. If functionalReplace is true, then
+  CallResult<HermesValue> callRes{ExecutionStatus::EXCEPTION};
+  {
+    // i. Let replacerArgs be «matched».
+    // Arguments: matched, captures, position, S.
+    size_t replacerArgsCount = 1 + captures->size() + 2;
+    if (LLVM_UNLIKELY(replacerArgsCount >= UINT32_MAX))
+      return runtime->raiseStackOverflow(
+          Runtime::StackOverflowKind::JSRegisterStack);
+    ScopedNativeCallFrame newFrame{runtime,
+                                   static_cast<uint32_t>(replacerArgsCount),
+                                   *replaceFn,
+                                   false,
+                                   HermesValue::encodeUndefinedValue()};
+    if (LLVM_UNLIKELY(newFrame.overflowed()))
+      return runtime->raiseStackOverflow(
+          Runtime::StackOverflowKind::NativeStack);
+
+    uint32_t argIdx = 0;
+    newFrame->getArgRef(argIdx++) = matched.getHermesValue();
+    // ii. Append in list order the elements of captures to the end of the
+    // List replacerArgs.
+    for (; argIdx <= captures->size(); ++argIdx) {
+      newFrame->getArgRef(argIdx) = captures->at(argIdx - 1);
+    }
+    // iii. Append position and S as the last two elements of replacerArgs.
+    newFrame->getArgRef(argIdx++) = HermesValue::encodeNumberValue(position);
+    newFrame->getArgRef(argIdx++) = S.getHermesValue();
+
+    // iv. Let replValue be Call(replaceValue, undefined, replacerArgs).
+    callRes = Callable::call(replaceFn, runtime);
+    if (callRes == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  // v. Let replacement be ToString(replValue).
+  auto strRes = toString_RJS(runtime, runtime->makeHandle(callRes.getValue()));
+  if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return strRes->getHermesValue();
+}
+
+/// \return true if \p rx is a JSRegExp whose "exec" is a data property
+/// holding the builtin RegExp.prototype.exec, so that RegExpExec(rx, S)
+/// amounts to RegExpBuiltinExec(rx, S).
+static bool hasBuiltinExec(Runtime *runtime, Handle<JSObject> rx) {
+  if (!vmisa<JSRegExp>(rx.get()))
+    return false;
+  auto exec = JSObject::tryGetNamedNoAlloc(
+      rx.get(), runtime, Predefined::getSymbolID(Predefined::exec));
+  if (!exec)
+    return false;
+  // An accessor is stored as a PropertyAccessor, which is not a function.
+  auto *fn = dyn_vmcast<NativeFunction>(*exec);
+  return fn && fn->getFunctionPtr() == regExpPrototypeExec;
+}
+
+/// Steps 11 to 18 of ES6.0 21.2.5.8 when RegExpExec(rx, S) is known to be
+/// RegExpBuiltinExec(rx, S). The matches are collected as ranges of \p S
+/// instead of result arrays, and the matched strings and captures are only
+/// created when \p replaceFn or the substitution patterns of
+/// \p replaceValueStr need them. A plain replacement string is written into
+/// the result along with the unmatched parts of \p S, without any
+/// intermediate string.
+/// Reading the fresh result arrays has no side effects, and the callbacks
+/// only run once every match was found, so this is not observable.
+static CallResult<HermesValue> regExpBuiltinReplace(
+    Runtime *runtime,
+    Handle<JSRegExp> rx,
+    Handle<StringPrimitive> S,
+    bool global,
+    bool fullUnicode,
+    Handle<Callable> replaceFn,
+    Handle<StringPrimitive> replaceValueStr) {
+  const uint32_t lengthS = S->getStringLength();
+
+  // 11. - 13. Collect the ranges of every match. Each match has nGroups
+  // entries, the whole match followed by its capture groups.
+  llvm::SmallVector<OptValue<RegExpMatchRange>, 16> matches;
+  uint32_t nGroups = 0;
+  for (;;) {
+    GCScopeMarkerRAII marker{runtime};
+    auto matchRes = regExpBuiltinMatch(rx, runtime, S);
+    if (LLVM_UNLIKELY(matchRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    const RegExpMatch &match = *matchRes;
+    if (match.empty())
+      break;
+    nGroups = match.size();
+    matches.append(match.begin(), match.end());
+    if (!global)
+      break;
+    // If matchStr is the empty String, advance lastIndex past it.
+    if (match.front()->length == 0) {
+      auto propRes = runtime->getNamed(rx, PropCacheID::RegExpLastIndex);
+      if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      auto thisIndex = toLength(runtime, runtime->makeHandle(*propRes));
+      if (LLVM_UNLIKELY(thisIndex == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      double nextIndex = advanceStringIndex(
+          S.get(), thisIndex->getNumberAs<uint64_t>(), fullUnicode);
+      if (LLVM_UNLIKELY(
+              setLastIndex(rx, runtime, nextIndex) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+  }
+  if (matches.empty())
+    return S.getHermesValue();
+  const size_t nMatches = matches.size() / nGroups;
+
+  bool plainReplace = false;
+  if (!replaceFn) {
+    auto view = StringPrimitive::createStringView(runtime, replaceValueStr);
+    plainReplace = std::find(view.begin(), view.end(), u'$') == view.end();
+  }
+
+  // The builtin exec finds the matches in order without overlap, so every
+  // position is at least the previous nextSourcePosition.
+  if (plainReplace) {
+    const uint32_t replLength = replaceValueStr->getStringLength();
+    uint32_t matchedLength = 0;
+    for (size_t i = 0; i < matches.size(); i += nGroups)
+      matchedLength += matches[i]->length;
+    SafeUInt32 resultLength{lengthS - matchedLength};
+    for (size_t i = 0; i < nMatches; ++i)
+      resultLength.add(replLength);
+    auto builder = StringBuilder::createStringBuilder(
+        runtime, resultLength, S->isASCII() && replaceValueStr->isASCII());
+    if (LLVM_UNLIKELY(builder == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    uint32_t nextSourcePosition = 0;
+    for (size_t i = 0; i < matches.size(); i += nGroups) {
+      const RegExpMatchRange &range = *matches[i];
+      assert(
+          range.location >= nextSourcePosition &&
+          "builtin exec matches should not overlap");
+      builder->appendStringPrim(
+          S, nextSourcePosition, range.location - nextSourcePosition);
+      builder->appendStringPrim(replaceValueStr);
+      nextSourcePosition = range.location + range.length;
+    }
+    builder->appendStringPrim(
+        S, nextSourcePosition, lengthS - nextSourcePosition);
+    return builder->getStringPrimitive().getHermesValue();
+  }
+
+  // 14. Let accumulatedResult be the empty String value.
+  SmallU16String<32> accumulatedResult{};
+  // 15. Let nextSourcePosition be 0.
+  uint32_t nextSourcePosition = 0;
+  auto stringView = StringPrimitive::createStringView(runtime, S);
+  // 16. Repeat, for each result in results,
+  MutableHandle<StringPrimitive> matched{runtime};
+  MutableHandle<ArrayStorage> capturesHandle{runtime};
+  for (size_t i = 0; i < matches.size(); i += nGroups) {
+    GCScopeMarkerRAII marker{runtime};
+    const RegExpMatchRange &range = *matches[i];
+    auto strRes =
+        StringPrimitive::slice(runtime, S, range.location, range.length);
+    if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    matched = vmcast<StringPrimitive>(*strRes);
+    auto arrRes = ArrayStorage::create(runtime, nGroups - 1);
+    if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    capturesHandle = vmcast<ArrayStorage>(*arrRes);
+    for (uint32_t n = 1; n < nGroups; ++n) {
+      GCScopeMarkerRAII marker2{runtime};
+      const auto &group = matches[i + n];
+      // Capture groups that did not match anything are undefined.
+      MutableHandle<> capN{runtime, HermesValue::encodeUndefinedValue()};
+      if (group) {
+        strRes = StringPrimitive::slice(
+            runtime, S, group->location, group->length);
+        if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        capN = *strRes;
+      }
+      if (LLVM_UNLIKELY(
+              ArrayStorage::push_back(capturesHandle, runtime, capN) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    auto replRes = getReplacement(
+        runtime,
+        replaceFn,
+        replaceValueStr,
+        matched,
+        range.location,
+        capturesHandle,
+        S);
+    if (LLVM_UNLIKELY(replRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    stringView.slice(nextSourcePosition, range.location - nextSourcePosition)
+        .copyUTF16String(accumulatedResult);
+    vmcast<StringPrimitive>(*replRes)->copyUTF16String(accumulatedResult);
+    nextSourcePosition = range.location + range.length;
+  }
+  // 17. - 18. Append the rest of S.
+  stringView.slice(nextSourcePosition).copyUTF16String(accumulatedResult);
+  return StringPrimitive::createEfficient(runtime, accumulatedResult);
+}
+
 /// ES6.0 21.2.5.8
 CallResult<HermesValue>
 regExpPrototypeSymbolReplace(void *, Runtime *runtime, NativeArgs args) {
@@ -1270,6 +1523,19 @@ regExpPrototypeSymbolReplace(void *, Runtime *runtime, NativeArgs args) {
       return ExecutionStatus::EXCEPTION;
     }
   }
+  // The builtin exec has no observable side effects between the matches, so
+  // the matches can be replaced without creating their result arrays.
+  if (hasBuiltinExec(runtime, rx)) {
+    return regExpBuiltinReplace(
+        runtime,
+        Handle<JSRegExp>::vmcast(rx),
+        S,
+        global,
+        fullUnicode,
+        replaceFn,
+        replaceValueStr);
+  }
+
   // 11. Let results be a new empty List.
   auto arrRes = ArrayStorage::create(runtime, 16 /* capacity */);
   if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
@@ -1455,58 +1721,19 @@ regExpPrototypeSymbolReplace(void *, Runtime *runtime, NativeArgs args) {
       n++;
     }
     // m. If functionalReplace is true, then
-    MutableHandle<StringPrimitive> replacement{runtime};
-    if (replaceFn) {
-      CallResult<HermesValue> callRes{ExecutionStatus::EXCEPTION};
-      {
-        // i. Let replacerArgs be «matched».
-        // Arguments: matched, captures, position, S.
-        size_t replacerArgsCount = 1 + nCaptures + 2;
-        if (LLVM_UNLIKELY(replacerArgsCount >= UINT32_MAX))
-          return runtime->raiseStackOverflow(
-              Runtime::StackOverflowKind::JSRegisterStack);
-        ScopedNativeCallFrame newFrame{runtime,
-                                       static_cast<uint32_t>(replacerArgsCount),
-                                       *replaceFn,
-                                       false,
-                                       HermesValue::encodeUndefinedValue()};
-        if (LLVM_UNLIKELY(newFrame.overflowed()))
-          return runtime->raiseStackOverflow(
-              Runtime::StackOverflowKind::NativeStack);
-
-        uint32_t argIdx = 0;
-        newFrame->getArgRef(argIdx++) = matched.getHermesValue();
-        // ii. Append in list order the elements of captures to the end of the
-        // List replacerArgs.
-        for (; argIdx <= capturesHandle->size(); ++argIdx) {
-          newFrame->getArgRef(argIdx) = capturesHandle->at(argIdx - 1);
-        }
-        // iii. Append position and S as the last two elements of replacerArgs.
-        newFrame->getArgRef(argIdx++) =
-            HermesValue::encodeNumberValue(position);
-        newFrame->getArgRef(argIdx++) = S.getHermesValue();
-
-        // iv. Let replValue be Call(replaceValue, undefined, replacerArgs).
-        callRes = Callable::call(replaceFn, runtime);
-        if (callRes == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-      }
-      // v. Let replacement be ToString(replValue).
-      auto strRes =
-          toString_RJS(runtime, runtime->makeHandle(callRes.getValue()));
-      if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      replacement = strRes->get();
-    } else {
-      // n. Else,
-      // i. Let replacement be GetSubstitution(matched, S, position, captures,
-      // replaceValue).
-      auto callRes = getSubstitution(
-          runtime, matched, S, position, capturesHandle, replaceValueStr);
-      replacement = vmcast<StringPrimitive>(callRes.getValue());
+    // n. Else,
+    auto replRes = getReplacement(
+        runtime,
+        replaceFn,
+        replaceValueStr,
+        matched,
+        position,
+        capturesHandle,
+        S);
+    if (LLVM_UNLIKELY(replRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
+    auto replacement = runtime->makeHandle<StringPrimitive>(*replRes);
     // o. ReturnIfAbrupt(replacement).
     // p. If position ≥ nextSourcePosition, then
     if (position >= nextSourcePosition) {
@@ -1599,7 +1826,6 @@ regExpFlagsGetter(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   return StringPrimitive::create(runtime, result);
 }
-#endif // HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
 
 } // namespace vm
 } // namespace hermes
@@ -9,6 +9,7 @@
 
 #include "hermes/Support/JSON.h"
 #include "hermes/Support/UTF16Stream.h"
+#include "hermes/Support/UTF8.h"
 #include "hermes/VM/ArrayLike.h"
 #include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/Callable.h"
@@ -16,10 +17,14 @@
 #include "hermes/VM/PrimitiveBox.h"
 
 #include "JSONLexer.h"
+#include "Object.h"
 
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/SaveAndRestore.h"
 
+#include <algorithm>
+#include <string>
+
 namespace hermes {
 namespace vm {
 
@@ -97,6 +102,101 @@ class RuntimeJSONParser {
   ExecutionStatus filter(Handle<JSObject> val, Handle<> key);
 };
 
+/// The output buffer of JSONStringifyer. It holds ASCII, which is what most
+/// JSON is, until a character which isn't is appended and the buffer is
+/// widened to UTF-16, once. An ASCII buffer takes half the memory, and becomes
+/// an ASCII string, which may adopt it instead of copying it.
+class JSONOutput {
+ public:
+  /// \return the number of characters in the buffer.
+  size_t size() const {
+    return isASCII_ ? ascii_.size() : utf16_.size();
+  }
+
+  /// \return whether every character in the buffer is ASCII.
+  bool isASCII() const {
+    return isASCII_;
+  }
+
+  void clear() {
+    ascii_.clear();
+    utf16_.clear();
+    isASCII_ = true;
+  }
+
+  /// Truncate the buffer to its first \p size characters.
+  void resize(size_t size) {
+    assert(size <= this->size() && "the buffer can only be truncated");
+    if (isASCII_)
+      ascii_.resize(size);
+    else
+      utf16_.resize(size);
+  }
+
+  void push_back(char16_t ch) {
+    if (LLVM_LIKELY(isASCII_)) {
+      if (LLVM_LIKELY(ch < 128)) {
+        ascii_.push_back(static_cast<char>(ch));
+        return;
+      }
+      widen();
+    }
+    utf16_.push_back(ch);
+  }
+
+  void append(std::initializer_list<char16_t> chars) {
+    for (char16_t ch : chars)
+      push_back(ch);
+  }
+
+  /// Append the ASCII characters \p str.
+  void append(ASCIIRef str) {
+    if (LLVM_LIKELY(isASCII_))
+      ascii_.append(str.begin(), str.end());
+    else
+      utf16_.append(str.begin(), str.end());
+  }
+
+  /// Append the characters \p str, widening the buffer unless they are ASCII.
+  void append(UTF16Ref str) {
+    if (isASCII_) {
+      if (isAllASCII(str.begin(), str.end())) {
+        ascii_.append(str.begin(), str.end());
+        return;
+      }
+      widen();
+    }
+    utf16_.append(str.begin(), str.end());
+  }
+
+  /// Create a string of the characters in the buffer, which is left in an
+  /// unspecified state.
+  CallResult<HermesValue> toString(Runtime *runtime) {
+    if (isASCII_)
+      return StringPrimitive::createEfficient(runtime, std::move(ascii_));
+    return StringPrimitive::createEfficient(runtime, std::move(utf16_));
+  }
+
+ private:
+  /// Copy the ASCII characters to the UTF-16 buffer, which is used from now
+  /// on.
+  void widen() {
+    assert(isASCII_ && "the buffer is already UTF-16");
+    utf16_.reserve(ascii_.size() * 2);
+    utf16_.assign(ascii_.begin(), ascii_.end());
+    ascii_.clear();
+    ascii_.shrink_to_fit();
+    isASCII_ = false;
+  }
+
+  /// The characters while all of them are ASCII.
+  std::string ascii_{};
+  /// The characters once one of them isn't ASCII.
+  std::u16string utf16_{};
+  /// Whether the characters are in ascii_ rather than utf16_.
+  bool isASCII_{true};
+};
+
 /// This class wraps the functionality required to stringify an object
 /// as JSON.
 class JSONStringifyer {
@@ -115,7 +215,7 @@ class JSONStringifyer {
   MutableHandle<StringPrimitive> gap_;
 
   /// The PropertyList, constructed from the "replacer" argument in stringify.
-  MutableHandle<JSArray> propertyList_;
+  MutableHandle<ArrayStorage> propertyList_;
 
   /// The stack, used at runtime by operationJA and operationJO to store
   /// `value_` for recursions.
@@ -136,8 +236,9 @@ class JSONStringifyer {
   /// Handle used by operationStr to store the value.
   MutableHandle<> operationStrValue_;
 
-  /// Handle used by operationJO to store K.
-  MutableHandle<JSArray> operationJOK_;
+  /// Handle used by operationJO to store K. It may be the names cached in
+  /// the class of the object, which must not be modified.
+  MutableHandle<ArrayStorage> operationJOK_;
 
   /// The holder argument passed to operationStr.
   /// We define a member variable here to avoid creating a new handle
@@ -155,7 +256,7 @@ class JSONStringifyer {
       RuntimeJSONParser::MAX_RECURSION_DEPTH};
 
   /// The output buffer. The serialization process will append into it.
-  llvm::SmallVector<char16_t, 32> output_{};
+  JSONOutput output_{};
 
  public:
   explicit JSONStringifyer(Runtime *runtime)
@@ -387,10 +488,11 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
       "Wrong entrance to parseObject");
   auto object = toHandle(runtime_, JSObject::create(runtime_));
 
-  if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
+  if (LLVM_UNLIKELY(lexer_.advanceForKey() == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
   if (lexer_.getCurToken()->getKind() != JSONTokenKind::RBrace) {
+    MutableHandle<SymbolID> keySym{runtime_};
     MutableHandle<StringPrimitive> key{runtime_};
     GCScope gcScope{runtime_};
     auto marker = gcScope.createMarker();
@@ -401,7 +503,11 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
               lexer_.getCurToken()->getKind() != JSONTokenKind::String)) {
         return lexer_.error("Expect a string key in JSON object");
       }
-      key = lexer_.getCurToken()->getString().get();
+      // Keys which aren't array indexes were interned by the lexer.
+      keySym = lexer_.getCurToken()->getSymbol();
+      if (keySym->isInvalid()) {
+        key = lexer_.getCurToken()->getString().get();
+      }
 
       if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
@@ -420,15 +526,25 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
         return ExecutionStatus::EXCEPTION;
       }
 
-      (void)JSObject::defineOwnComputedPrimitive(
-          object,
-          runtime_,
-          key,
-          DefinePropertyFlags::getDefaultNewPropertyFlags(),
-          runtime_->makeHandle(*parRes));
+      if (keySym->isValid()) {
+        (void)JSObject::defineOwnProperty(
+            object,
+            runtime_,
+            *keySym,
+            DefinePropertyFlags::getDefaultNewPropertyFlags(),
+            runtime_->makeHandle(*parRes));
+      } else {
+        (void)JSObject::defineOwnComputedPrimitive(
+            object,
+            runtime_,
+            key,
+            DefinePropertyFlags::getDefaultNewPropertyFlags(),
+            runtime_->makeHandle(*parRes));
+      }
 
       if (lexer_.getCurToken()->getKind() == JSONTokenKind::Comma) {
-        if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
+        if (LLVM_UNLIKELY(
+                lexer_.advanceForKey() == ExecutionStatus::EXCEPTION)) {
           return ExecutionStatus::EXCEPTION;
         }
         continue;
@@ -607,11 +723,11 @@ ExecutionStatus JSONStringifyer::initializeReplacer(Handle<> replacer) {
     return runtime_->raiseRangeError("replacer array is too large");
   }
   uint32_t len = static_cast<uint32_t>(*lenRes);
-  auto arrRes = JSArray::create(runtime_, len, 0);
+  auto arrRes = ArrayStorage::create(runtime_, len);
   if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  propertyList_ = arrRes.getValue().get();
+  propertyList_ = vmcast<ArrayStorage>(*arrRes);
 
   // Iterate through all indexes, in ascending order.
   GCScope gcScope{runtime_};
@@ -646,17 +762,19 @@ ExecutionStatus JSONStringifyer::initializeReplacer(Handle<> replacer) {
       continue;
     // We only add item to propertyList if item is not already an element.
     bool exists = false;
-    auto len = propertyList_->getEndIndex();
+    auto len = propertyList_->size();
     for (uint32_t i = 0; i < len; ++i) {
-      if (propertyList_->at(runtime_, i)
-              .getString()
-              ->equals(tmpHandle_->getString())) {
+      if (propertyList_->at(i).getString()->equals(tmpHandle_->getString())) {
         exists = true;
         break;
       }
     }
     if (!exists) {
-      JSArray::setElementAt(propertyList_, runtime_, len, tmpHandle_);
+      if (LLVM_UNLIKELY(
+              ArrayStorage::push_back(propertyList_, runtime_, tmpHandle_) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
     }
   }
   return ExecutionStatus::RETURNED;
@@ -875,6 +993,18 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
 }
 
 void JSONStringifyer::operationQuote(StringView value) {
+  // Most strings have no character to escape, and are appended at once.
+  if (value.isASCII()) {
+    ASCIIRef str{value.castToCharPtr(), value.length()};
+    if (std::none_of(str.begin(), str.end(), [](char ch) {
+          return ch < ' ' || ch == '"' || ch == '\\';
+        })) {
+      output_.push_back(u'"');
+      output_.append(str);
+      output_.push_back(u'"');
+      return;
+    }
+  }
   quoteStringForJSON(output_, value);
 }
 
@@ -965,19 +1095,39 @@ ExecutionStatus JSONStringifyer::operationJO() {
   } else {
     // JO.6.
     tmpHandle_ = stackValue_->at(stackValue_->size() - 1);
-    auto cr = JSObject::getOwnPropertyNames(
-        Handle<JSObject>::vmcast(tmpHandle_), runtime_, true);
-    if (cr == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
+    auto obj = Handle<JSObject>::vmcast(tmpHandle_);
+    if (obj->getKind() == CellKind::ObjectKind &&
+        !obj->getClass(runtime_)->isDictionary()) {
+      // The names of plain objects are cached in their class, and shared by
+      // every object of the same shape.
+      auto keysRes = getCachedEnumerableOwnKeys(runtime_, obj);
+      if (LLVM_UNLIKELY(keysRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      operationJOK_ = vmcast<ArrayStorage>(*keysRes);
+    } else {
+      auto cr = JSObject::getOwnPropertyNames(obj, runtime_, true);
+      if (cr == ExecutionStatus::EXCEPTION) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      Handle<JSArray> names = *cr;
+      uint32_t len = names->getEndIndex();
+      auto keysRes = ArrayStorage::create(runtime_, len, len);
+      if (LLVM_UNLIKELY(keysRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      operationJOK_ = vmcast<ArrayStorage>(*keysRes);
+      for (uint32_t i = 0; i < len; ++i) {
+        operationJOK_->at(i).set(names->at(runtime_, i), &runtime_->getHeap());
+      }
     }
-    operationJOK_ = **cr;
   }
 
   marker.flush();
 
   // JO.8.
   bool hasElement = false;
-  for (uint32_t index = 0, len = operationJOK_->getEndIndex(); index < len;
+  for (uint32_t index = 0, len = operationJOK_->size(); index < len;
        ++index) {
     // JO.8.a.
     // We are speculating that the Str operation will not return undefined,
@@ -992,7 +1142,7 @@ ExecutionStatus JSONStringifyer::operationJO() {
       indent();
     }
 
-    tmpHandle_ = operationJOK_->at(runtime_, index);
+    tmpHandle_ = operationJOK_->at(index);
     if (LLVM_UNLIKELY(!tmpHandle_->isString())) {
       // property may come from getOwnPropertyNames, which may contain numbers.
       // getOwnPropertyNames and propertyList_ are both only populated
@@ -1030,7 +1180,7 @@ ExecutionStatus JSONStringifyer::operationJO() {
     marker.flush();
     auto result = operationStr(*tmpHandle_);
 
-    operationJOK_ = vmcast<JSArray>(stackJO_->at(stackJO_->size() - 1));
+    operationJOK_ = vmcast<ArrayStorage>(stackJO_->at(stackJO_->size() - 1));
     assert(stackJO_->size() && "Cannot pop from an empty stack");
     stackJO_->pop_back();
 
@@ -1095,7 +1245,10 @@ void JSONStringifyer::appendToOutput(SymbolID identifierID) {
 }
 
 void JSONStringifyer::appendToOutput(const StringPrimitive *str) {
-  str->copyUTF16String(output_);
+  if (str->isASCII())
+    output_.append(str->castToASCIIRef());
+  else
+    output_.append(str->castToUTF16Ref());
 }
 
 CallResult<HermesValue> JSONStringifyer::stringify(Handle<> value) {
@@ -1123,7 +1276,7 @@ CallResult<HermesValue> JSONStringifyer::stringify(Handle<> value) {
     return ExecutionStatus::EXCEPTION;
   }
   if (status.getValue()) {
-    return StringPrimitive::create(runtime_, output_);
+    return output_.toString(runtime_);
   } else {
     return HermesValue::encodeUndefinedValue();
   }
@@ -17,7 +17,8 @@
 namespace hermes {
 namespace vm {
 
-Handle<JSObject> createSetConstructor(Runtime *runtime) {
+/// Define the properties of the Set constructor \p cons and of Set.prototype.
+static void populateSet(Runtime *runtime, Handle<JSObject> cons) {
   auto setPrototype = Handle<JSSet>::vmcast(&runtime->setPrototype);
 
   // Set.prototype.xxx methods.
@@ -123,15 +124,25 @@ Handle<JSObject> createSetConstructor(Runtime *runtime) {
       runtime->getPredefinedStringHandle(Predefined::Set),
       dpf);
 
-  auto cons = defineSystemConstructor<JSSet>(
+  defineSystemConstructorProperties(
       runtime,
+      cons,
       Predefined::getSymbolID(Predefined::Set),
-      setConstructor,
       setPrototype,
-      0,
-      CellKind::SetKind);
+      0);
+}
 
-  return cons;
+Handle<JSObject> createSetConstructor(Runtime *runtime) {
+  return defineLazySystemConstructor(
+      runtime,
+      Predefined::getSymbolID(Predefined::Set),
+      setConstructor,
+      Handle<JSObject>::vmcast(&runtime->setPrototype),
+      Handle<JSObject>::vmcast(&runtime->functionPrototype),
+      0,
+      JSSet::create,
+      CellKind::SetKind,
+      populateSet);
 }
 
 CallResult<HermesValue>
@@ -232,7 +243,10 @@ setPrototypeClear(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Method Set.prototype.clear called on incompatible receiver");
   }
-  JSSet::clear(selfHandle, runtime);
+  if (LLVM_UNLIKELY(
+          JSSet::clear(selfHandle, runtime) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return HermesValue::encodeUndefinedValue();
 }
 
@@ -265,6 +265,154 @@ quicksort_top:
   return ExecutionStatus::RETURNED;
 }
 
+/// The size of the blocks which stableSort() sorts by insertion before it
+/// merges them.
+const uint32_t STABLE_BLOCK_SIZE = 20;
+
+/// Swap the \p n elements starting at \p a with the ones starting at \p b.
+LLVM_NODISCARD ExecutionStatus
+swapRange(SortModel *sm, uint32_t a, uint32_t b, uint32_t n) {
+  for (uint32_t i = 0; i != n; ++i) {
+    if (sm->swap(a + i, b + i) == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  return ExecutionStatus::RETURNED;
+}
+
+/// Exchange the blocks [a, m) and [m, b), keeping the order of the elements
+/// within each of them.
+LLVM_NODISCARD ExecutionStatus
+rotate(SortModel *sm, uint32_t a, uint32_t m, uint32_t b) {
+  uint32_t i = m - a;
+  uint32_t j = b - m;
+  while (i != j) {
+    if (i > j) {
+      if (swapRange(sm, m - i, m, j) == ExecutionStatus::EXCEPTION) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      i -= j;
+    } else {
+      if (swapRange(sm, m - i, m + j - i, i) == ExecutionStatus::EXCEPTION) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      j -= i;
+    }
+  }
+  return swapRange(sm, m - i, m, i);
+}
+
+/// Merge the sorted ranges [a, m) and [m, b) in place, keeping equal elements
+/// in order. This is the SymMerge algorithm of Kim and Kutzner, which only
+/// needs \c less and \c swap, and makes O(n log n) comparisons.
+LLVM_NODISCARD ExecutionStatus
+symMerge(SortModel *sm, uint32_t a, uint32_t m, uint32_t b) {
+  CallResult<bool> res{false};
+  // The ranges are already in order, which is common in partially sorted
+  // input.
+  res = sm->less(m, m - 1);
+  if (res == ExecutionStatus::EXCEPTION) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (!*res) {
+    return ExecutionStatus::RETURNED;
+  }
+
+  if (m - a == 1) {
+    // Move [a] after the elements of [m, b) which are less than it.
+    uint32_t i = m;
+    uint32_t j = b;
+    while (i < j) {
+      uint32_t h = i + (j - i) / 2;
+      res = sm->less(h, a);
+      if (res == ExecutionStatus::EXCEPTION) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res) {
+        i = h + 1;
+      } else {
+        j = h;
+      }
+    }
+    for (uint32_t k = a; k + 1 < i; ++k) {
+      if (sm->swap(k, k + 1) == ExecutionStatus::EXCEPTION) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    return ExecutionStatus::RETURNED;
+  }
+  if (b - m == 1) {
+    // Move [m] before the elements of [a, m) which are greater than it.
+    uint32_t i = a;
+    uint32_t j = m;
+    while (i < j) {
+      uint32_t h = i + (j - i) / 2;
+      res = sm->less(m, h);
+      if (res == ExecutionStatus::EXCEPTION) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (!*res) {
+        i = h + 1;
+      } else {
+        j = h;
+      }
+    }
+    for (uint32_t k = m; k > i; --k) {
+      if (sm->swap(k, k - 1) == ExecutionStatus::EXCEPTION) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    return ExecutionStatus::RETURNED;
+  }
+
+  // Find the largest block ending at m and the block of the same size
+  // starting at m, symmetric around the middle of [a, b), such that every
+  // element of the first is greater than every element of the second, and
+  // exchange them. What's left on each side is then merged recursively.
+  uint32_t mid = a + (b - a) / 2;
+  uint64_t n = (uint64_t)mid + m;
+  uint32_t start;
+  uint32_t r;
+  if (m > mid) {
+    start = n - b;
+    r = mid;
+  } else {
+    start = a;
+    r = m;
+  }
+  uint64_t p = n - 1;
+  while (start < r) {
+    uint32_t c = start + (r - start) / 2;
+    res = sm->less(p - c, c);
+    if (res == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (!*res) {
+      start = c + 1;
+    } else {
+      r = c;
+    }
+  }
+
+  uint32_t end = n - start;
+  if (start < m && m < end) {
+    if (rotate(sm, start, m, end) == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  if (a < start && start < mid) {
+    if (symMerge(sm, a, start, mid) == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  if (mid < end && end < b) {
+    if (symMerge(sm, mid, end, b) == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  return ExecutionStatus::RETURNED;
+}
+
 } // namespace
 
 ExecutionStatus quickSort(SortModel *sm, uint32_t begin, uint32_t end) {
@@ -275,5 +423,37 @@ ExecutionStatus quickSort(SortModel *sm, uint32_t begin, uint32_t end) {
   }
 }
 
+ExecutionStatus stableSort(SortModel *sm, uint32_t begin, uint32_t end) {
+  // Sort blocks by insertion, then merge them pairwise in passes of doubling
+  // size.
+  uint64_t a = begin;
+  for (; a + STABLE_BLOCK_SIZE <= end; a += STABLE_BLOCK_SIZE) {
+    if (insertionSort(sm, a, a + STABLE_BLOCK_SIZE) ==
+        ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  if (insertionSort(sm, a, end) == ExecutionStatus::EXCEPTION) {
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  for (uint64_t blockSize = STABLE_BLOCK_SIZE; blockSize < end - begin;
+       blockSize *= 2) {
+    a = begin;
+    for (; a + 2 * blockSize <= end; a += 2 * blockSize) {
+      if (symMerge(sm, a, a + blockSize, a + 2 * blockSize) ==
+          ExecutionStatus::EXCEPTION) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    if (a + blockSize < end) {
+      if (symMerge(sm, a, a + blockSize, end) == ExecutionStatus::EXCEPTION) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+  }
+  return ExecutionStatus::RETURNED;
+}
+
 } // namespace vm
 } // namespace hermes
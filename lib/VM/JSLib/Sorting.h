@@ -41,6 +41,15 @@ class SortModel {
 /// with ExecutionStatus::EXCEPTION if any compare or swap operations fail.
 ExecutionStatus quickSort(SortModel *sm, uint32_t begin, uint32_t end);
 
+/// Stable merge sort of the elements in the range [begin, end): elements which
+/// are neither less nor greater than each other keep their order. It makes
+/// O(n log n) comparisons, but O(n log^2 n) swaps, since it merges in place,
+/// so it is meant for models where swapping is cheap compared to \c less.
+/// Runs which are already in order are merged with a single comparison.
+/// Returns immediately with ExecutionStatus::EXCEPTION if any compare or swap
+/// operations fail.
+ExecutionStatus stableSort(SortModel *sm, uint32_t begin, uint32_t end);
+
 } // namespace vm
 } // namespace hermes
 
@@ -12,6 +12,7 @@
 #include "JSLibInternal.h"
 
 #include "hermes/Platform/Unicode/PlatformUnicode.h"
+#include "hermes/Support/UTF8.h"
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/PrimitiveBox.h"
@@ -219,7 +220,6 @@ Handle<JSObject> createStringConstructor(Runtime *runtime) {
       stringRaw,
       1);
 
-#ifndef HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
   defineMethod(
       runtime,
       stringPrototype,
@@ -311,7 +311,6 @@ Handle<JSObject> createStringConstructor(Runtime *runtime) {
       (void *)true,
       stringPrototypeIncludesOrStartsWith,
       1);
-#endif // HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
 
   return cons;
 }
@@ -582,8 +581,11 @@ stringPrototypeCharCodeAt(void *, Runtime *runtime, NativeArgs args) {
   if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto S = toHandle(runtime, std::move(*strRes));
-  auto intRes = toInteger(runtime, runtime->makeHandle(args.getArg(0)));
+  // The string is kept out of the GCScope of the caller.
+  HandleArray<1> handles{runtime};
+  handles[0] = strRes->getHermesValue();
+  auto S = handles.handle<StringPrimitive>(0);
+  auto intRes = toInteger(runtime, args.getArgHandle(0));
   if (LLVM_UNLIKELY(intRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
@@ -746,13 +748,8 @@ static CallResult<RegExpMatch> splitMatch(
     return match;
   }
 
-  auto sliced = SStr.slice(q);
-  auto searchResult =
-      std::search(sliced.begin(), sliced.end(), RStr.begin(), RStr.end());
-
-  if (searchResult != sliced.end()) {
-    uint32_t i = q + (searchResult - sliced.begin());
-    match.push_back({{i, RHandle->getStringLength()}});
+  if (auto i = SStr.find(RStr, q)) {
+    match.push_back({{*i, RHandle->getStringLength()}});
   }
   return match;
 }
@@ -859,7 +856,7 @@ CallResult<HermesValue> splitInternal(
     if (LLVM_UNLIKELY(matchResult == ExecutionStatus::EXCEPTION))
       return ExecutionStatus::EXCEPTION;
 
-    auto match = *matchResult;
+    const RegExpMatch &match = *matchResult;
 
     if (match.empty()) {
       // There's no matches at or after index q, so we're done searching.
@@ -966,7 +963,10 @@ stringPrototypeSubstring(void *, Runtime *runtime, NativeArgs args) {
   if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto S = toHandle(runtime, std::move(*strRes));
+  // The string is kept out of the GCScope of the caller.
+  HandleArray<1> handles{runtime};
+  handles[0] = strRes->getHermesValue();
+  auto S = handles.handle<StringPrimitive>(0);
   double len = S->getStringLength();
 
   auto intRes = toInteger(runtime, args.getArgHandle(0));
@@ -1000,6 +1000,35 @@ static CallResult<HermesValue> convertCase(
     Handle<StringPrimitive> S,
     const bool upperCase,
     const bool useCurrentLocale) {
+  if (!useCurrentLocale && S->isASCII()) {
+    // ASCII strings are converted eight characters at a time, starting from
+    // the first one which changes.
+    ASCIIRef str = S->getStringRef<char>();
+    const char *change =
+        findASCIICaseChange(str.begin(), str.end(), upperCase);
+    if (change == str.end()) {
+      // We don't have to allocate anything.
+      return S.getHermesValue();
+    }
+    if (str.size() == 1) {
+      // Use the Runtime stored representations of single-character strings.
+      return runtime->getCharacterString(str[0] ^ 0x20).getHermesValue();
+    }
+
+    size_t unchanged = change - str.begin();
+    size_t len = str.size();
+    auto res = StringPrimitive::create(runtime, len, true);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    // The allocation may have moved S.
+    const char *src = S->castToASCIIPointer();
+    char *dest = vmcast<StringPrimitive>(*res)->castToASCIIPointerForWrite();
+    std::copy(src, src + unchanged, dest);
+    convertASCIICase(src + unchanged, src + len, dest + unchanged, upperCase);
+    return *res;
+  }
+
   // Copying is unavoidable in this function, do it early on.
   SmallU16String<32> buff;
   // Must copy instead of just getting the reference, because later operations
@@ -1455,7 +1484,6 @@ stringPrototypeSymbolIterator(void *, Runtime *runtime, NativeArgs args) {
   return JSStringIterator::create(runtime, string);
 }
 
-#ifndef HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
 CallResult<HermesValue>
 stringPrototypeMatch(void *, Runtime *runtime, NativeArgs args) {
   // 1. Let O be RequireObjectCoercible(this value).
@@ -1699,11 +1727,8 @@ stringPrototypeReplace(void *, Runtime *runtime, NativeArgs args) {
   auto strView = StringPrimitive::createStringView(runtime, string);
   if (!strView.empty()) {
     auto searchView = StringPrimitive::createStringView(runtime, searchString);
-    auto searchResult = std::search(
-        strView.begin(), strView.end(), searchView.begin(), searchView.end());
-
-    if (searchResult != strView.end()) {
-      pos = searchResult - strView.begin();
+    if (auto searchResult = strView.find(searchView)) {
+      pos = *searchResult;
     } else {
       return string.getHermesValue();
     }
@@ -1753,13 +1778,20 @@ stringPrototypeReplace(void *, Runtime *runtime, NativeArgs args) {
   // units of string, replStr, and the trailing substring of string starting at
   // index tailPos. If pos is 0, the first element of the concatenation will be
   // the empty String.
-  SmallU16String<32> newString{};
-  strView.slice(0, pos).copyUTF16String(newString);
-  StringPrimitive::createStringView(runtime, replStr)
-      .copyUTF16String(newString);
-  strView.slice(tailPos).copyUTF16String(newString);
+  uint32_t stringLength = string->getStringLength();
+  SafeUInt32 newLength{pos};
+  newLength.add(replStr->getStringLength());
+  newLength.add(stringLength - tailPos);
+  auto builder = StringBuilder::createStringBuilder(
+      runtime, newLength, string->isASCII() && replStr->isASCII());
+  if (LLVM_UNLIKELY(builder == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  builder->appendStringPrim(string, 0, pos);
+  builder->appendStringPrim(replStr);
+  builder->appendStringPrim(string, tailPos, stringLength - tailPos);
   // 15. Return newString.
-  return StringPrimitive::create(runtime, newString);
+  return builder->getStringPrimitive().getHermesValue();
 }
 
 CallResult<HermesValue>
@@ -1836,9 +1868,12 @@ stringPrototypeCharAt(void *, Runtime *runtime, NativeArgs args) {
   if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto S = toHandle(runtime, std::move(*strRes));
+  // The string is kept out of the GCScope of the caller.
+  HandleArray<1> handles{runtime};
+  handles[0] = strRes->getHermesValue();
+  auto S = handles.handle<StringPrimitive>(0);
 
-  auto intRes = toInteger(runtime, runtime->makeHandle(args.getArg(0)));
+  auto intRes = toInteger(runtime, args.getArgHandle(0));
   if (LLVM_UNLIKELY(intRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
@@ -1864,7 +1899,10 @@ stringPrototypeSlice(void *, Runtime *runtime, NativeArgs args) {
   if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto S = toHandle(runtime, std::move(*strRes));
+  // The string is kept out of the GCScope of the caller.
+  HandleArray<1> handles{runtime};
+  handles[0] = strRes->getHermesValue();
+  auto S = handles.handle<StringPrimitive>(0);
   double len = S->getStringLength();
 
   auto intRes = toInteger(runtime, args.getArgHandle(0));
@@ -2082,15 +2120,8 @@ CallResult<HermesValue> stringPrototypeIncludesOrStartsWith(
   // k, return false.
   auto SView = StringPrimitive::createStringView(runtime, S);
   auto searchStrView = StringPrimitive::createStringView(runtime, searchStr);
-  auto foundIter = std::search(
-      SView.begin() + start,
-      SView.end(),
-      searchStrView.begin(),
-      searchStrView.end());
-  // Note: searchStrView.empty check is needed in the special case that S is
-  // empty, searchStr is empty, and start = 0
   return HermesValue::encodeBoolValue(
-      foundIter != SView.end() || searchStrView.empty());
+      SView.find(searchStrView, static_cast<uint32_t>(start)).hasValue());
 }
 
 /// Shared implementation of string.indexOf and string.lastIndexOf
@@ -2118,21 +2149,26 @@ stringDirectedIndexOf(Runtime *runtime, NativeArgs args, bool reverse) {
   if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto S = toHandle(runtime, std::move(*strRes));
+  // The strings and the position are kept out of the GCScope of the caller.
+  HandleArray<3> handles{runtime};
+  handles[0] = strRes->getHermesValue();
+  auto S = handles.handle<StringPrimitive>(0);
 
   auto searchStrRes = toString_RJS(runtime, args.getArgHandle(0));
   if (searchStrRes == ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto searchStr = toHandle(runtime, std::move(*searchStrRes));
+  handles[1] = searchStrRes->getHermesValue();
+  auto searchStr = handles.handle<StringPrimitive>(1);
 
   double pos;
   if (reverse) {
-    auto intRes = toNumber_RJS(runtime, runtime->makeHandle(args.getArg(1)));
+    auto intRes = toNumber_RJS(runtime, args.getArgHandle(1));
     if (LLVM_UNLIKELY(intRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-    Handle<> numPos = runtime->makeHandle(intRes.getValue());
+    handles[2] = intRes.getValue();
+    auto numPos = handles.handle(2);
     if (std::isnan(numPos->getNumber())) {
       pos = std::numeric_limits<double>::infinity();
     } else {
@@ -2144,7 +2180,7 @@ stringDirectedIndexOf(Runtime *runtime, NativeArgs args, bool reverse) {
       pos = intRes->getNumber();
     }
   } else {
-    auto intRes = toInteger(runtime, runtime->makeHandle(args.getArg(1)));
+    auto intRes = toInteger(runtime, args.getArgHandle(1));
     if (LLVM_UNLIKELY(intRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -2155,32 +2191,17 @@ stringDirectedIndexOf(Runtime *runtime, NativeArgs args, bool reverse) {
   uint32_t start = static_cast<uint32_t>(std::min(std::max(pos, 0.), len));
 
   // TODO: good candidate for Boyer-Moore on large needles/haystacks
-  // TODO: good candidate for memchr on length-1 needles
   auto SView = StringPrimitive::createStringView(runtime, S);
   auto searchStrView = StringPrimitive::createStringView(runtime, searchStr);
-  double ret = -1;
+  llvm::Optional<uint32_t> found;
   if (reverse) {
     uint32_t lastPossibleMatchEnd =
         std::min(SView.length(), start + searchStrView.length());
-    auto foundIter = std::search(
-        SView.rbegin() + (SView.length() - lastPossibleMatchEnd),
-        SView.rend(),
-        searchStrView.rbegin(),
-        searchStrView.rend());
-    if (foundIter != SView.rend() || searchStrView.empty()) {
-      ret = SView.rend() - foundIter - searchStrView.length();
-    }
+    found = SView.findLast(searchStrView, lastPossibleMatchEnd);
   } else {
-    auto foundIter = std::search(
-        SView.begin() + start,
-        SView.end(),
-        searchStrView.begin(),
-        searchStrView.end());
-    if (foundIter != SView.end() || searchStrView.empty()) {
-      ret = foundIter - SView.begin();
-    }
+    found = SView.find(searchStrView, start);
   }
-  return HermesValue::encodeDoubleValue(ret);
+  return HermesValue::encodeDoubleValue(found ? *found : -1);
 }
 
 CallResult<HermesValue>
@@ -2192,7 +2213,6 @@ CallResult<HermesValue>
 stringPrototypeLastIndexOf(void *, Runtime *runtime, NativeArgs args) {
   return stringDirectedIndexOf(runtime, args, true);
 }
-#endif // HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
 
 } // namespace vm
 } // namespace hermes
@@ -17,6 +17,11 @@
 #include "hermes/VM/StringBuilder.h"
 #include "hermes/VM/StringView.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
 namespace hermes {
 namespace vm {
 
@@ -232,6 +237,9 @@ CallResult<HermesValue> mapFilterLoop(
     Handle<JSArray> values,
     JSTypedArrayBase::size_type insert,
     JSTypedArrayBase::size_type len) {
+  PreparedCall callback{runtime, callbackfn, thisArg, 3};
+  if (LLVM_UNLIKELY(callback.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
   MutableHandle<> storage(runtime);
   GCScopeMarkerRAII marker{runtime};
   for (JSTypedArrayBase::size_type i = 0; i < len; ++i) {
@@ -241,13 +249,8 @@ CallResult<HermesValue> mapFilterLoop(
       return runtime->raiseTypeError("Detached the TypedArray in the callback");
     }
     auto val = JSObject::getOwnIndexed(*self, runtime, i);
-    auto callRes = Callable::executeCall3(
-        callbackfn,
-        runtime,
-        thisArg,
-        val,
-        HermesValue::encodeNumberValue(i),
-        self.getHermesValue());
+    auto callRes = callback.call(
+        val, HermesValue::encodeNumberValue(i), self.getHermesValue());
     if (callRes == ExecutionStatus::EXCEPTION) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -286,6 +289,9 @@ class TypedArraySortModel : public SortModel {
   MutableHandle<HermesValue> aHandle_;
   MutableHandle<HermesValue> bHandle_;
 
+  /// The call of compareFn, prepared once for all the comparisons.
+  llvm::Optional<PreparedCall> compareCall_;
+
   /// Marker created after initializing all fields so handles allocated later
   /// can be flushed.
   GCScope::Marker gcMarker_;
@@ -301,7 +307,12 @@ class TypedArraySortModel : public SortModel {
         self_(obj),
         aHandle_(runtime),
         bHandle_(runtime),
-        gcMarker_(gcScope_.createMarker()) {}
+        gcMarker_(gcScope_.createMarker()) {
+    if (WithCompareFn) {
+      compareCall_.emplace(
+          runtime, compareFn_, Runtime::getUndefinedValue(), 2);
+    }
+  }
 
   // Swap elements at indices a and b.
   virtual ExecutionStatus swap(uint32_t a, uint32_t b) override {
@@ -336,8 +347,11 @@ class TypedArraySortModel : public SortModel {
     assert(compareFn_ && "Cannot use this version if the compareFn is null");
     // ES7 22.2.3.26 2a.
     // Let v be toNumber_RJS(Call(comparefn, undefined, x, y)).
-    auto callRes = Callable::executeCall2(
-        compareFn_, runtime_, Runtime::getUndefinedValue(), aVal, bVal);
+    if (LLVM_UNLIKELY(compareCall_->overflowed())) {
+      return runtime_->raiseStackOverflow(
+          Runtime::StackOverflowKind::NativeStack);
+    }
+    auto callRes = compareCall_->call(aVal, bVal);
     if (callRes == ExecutionStatus::EXCEPTION) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -354,6 +368,134 @@ class TypedArraySortModel : public SortModel {
   }
 };
 
+/// The order of the elements of a TypedArray sorted without a comparator. It
+/// is numeric, with -0 before +0 and NaN after every other value, so integers
+/// are simply compared.
+template <typename T>
+struct TypedArrayLess {
+  bool operator()(T a, T b) const {
+    return a < b;
+  }
+};
+
+template <typename T>
+struct FloatTypedArrayLess {
+  bool operator()(T a, T b) const {
+    if (LLVM_UNLIKELY(std::isnan(b)))
+      return !std::isnan(a);
+    if (LLVM_UNLIKELY(a == 0) && LLVM_UNLIKELY(b == 0))
+      return std::signbit(a) && !std::signbit(b);
+    return a < b;
+  }
+};
+
+template <>
+struct TypedArrayLess<float> : FloatTypedArrayLess<float> {};
+template <>
+struct TypedArrayLess<double> : FloatTypedArrayLess<double> {};
+
+/// Convert \p number to the element type \p T into \p result.
+/// \return false if no element of type \p T is equal to \p number.
+template <typename T>
+bool toExactElement(double number, T &result) {
+  static_assert(std::is_integral<T>::value, "Only for integer elements");
+  if (!(number >= std::numeric_limits<T>::min() &&
+        number <= std::numeric_limits<T>::max())) {
+    return false;
+  }
+  result = static_cast<T>(number);
+  return result == number;
+}
+
+bool toExactElement(double number, float &result) {
+  if (std::fabs(number) > std::numeric_limits<float>::max() &&
+      !std::isinf(number)) {
+    return false;
+  }
+  result = static_cast<float>(number);
+  return result == number;
+}
+
+bool toExactElement(double number, double &result) {
+  result = number;
+  return true;
+}
+
+/// The number of elements which findElement() and findLastElement() compare
+/// before checking whether any of them matched.
+constexpr size_t kFindBlockSize = 16;
+
+/// \return the index of the first element of \p data in [from, to) equal to
+/// \p value, or -1. Blocks of elements are compared without branching, which
+/// the compiler vectorizes, and only a block with a match is searched again.
+template <typename T>
+int64_t findElement(const T *data, size_t from, size_t to, T value) {
+  if (sizeof(T) == 1) {
+    auto *found = static_cast<const T *>(std::memchr(
+        data + from, static_cast<unsigned char>(value), to - from));
+    return found ? found - data : -1;
+  }
+  for (; to - from >= kFindBlockSize; from += kFindBlockSize) {
+    bool any = false;
+    for (size_t i = 0; i < kFindBlockSize; ++i)
+      any |= data[from + i] == value;
+    if (any)
+      break;
+  }
+  for (; from < to; ++from) {
+    if (data[from] == value)
+      return from;
+  }
+  return -1;
+}
+
+/// \return the index of the last element of \p data in [0, to) equal to
+/// \p value, or -1, comparing them a block at a time like findElement().
+template <typename T>
+int64_t findLastElement(const T *data, size_t to, T value) {
+  for (; to >= kFindBlockSize; to -= kFindBlockSize) {
+    bool any = false;
+    for (size_t i = 1; i <= kFindBlockSize; ++i)
+      any |= data[to - i] == value;
+    if (any)
+      break;
+  }
+  for (; to > 0; --to) {
+    if (data[to - 1] == value)
+      return to - 1;
+  }
+  return -1;
+}
+
+enum class IndexOfMode { includes, indexOf, lastIndexOf };
+
+/// \return the index of the element of the \p len elements of \p data found
+/// by \p mode starting at \p k, which must be in range, or -1.
+template <typename T>
+int64_t indexOfElement(
+    const T *data,
+    size_t len,
+    size_t k,
+    double search,
+    IndexOfMode mode) {
+  T value;
+  if (LLVM_UNLIKELY(std::isnan(search))) {
+    // Only includes() finds NaN, since it is not strictly equal to itself.
+    if (mode != IndexOfMode::includes)
+      return -1;
+    for (; k < len; ++k) {
+      if (data[k] != data[k])
+        return k;
+    }
+    return -1;
+  }
+  if (!toExactElement(search, value))
+    return -1;
+  if (mode == IndexOfMode::lastIndexOf)
+    return findLastElement(data, k + 1, value);
+  return findElement(data, k, len, value);
+}
+
 // ES7 22.2.3.23.1
 CallResult<HermesValue> typedArrayPrototypeSetObject(
     Runtime *runtime,
@@ -738,44 +880,21 @@ typedArrayPrototypeCopyWithin(void *, Runtime *runtime, NativeArgs args) {
   // 14. Let count be min(final-from, len-to).
   double count = std::min(fin - from, len - to);
 
-  int direction;
-  if (from < to && to < from + count) {
-    // 15. If from<to and to<from+count
-    // a. Let direction be -1.
-    direction = -1;
-    // b. Let from be from + count -1.
-    from = from + count - 1;
-    // c. Let to be to + count -1.
-    to = to + count - 1;
-  } else {
-    // 16. Else,
-    // a. Let direction = 1.
-    direction = 1;
-  }
-
-  // Need to case on the TypedArray type to avoid encoding using HermesValues.
-  // We need to preserve the bit-level encoding of values, and HermesValues
-  // destroy information, e.g. which NaN is being used.
-#define TYPED_ARRAY(name, type)                                            \
-  case CellKind::name##ArrayKind: {                                        \
-    auto *arr = vmcast<JSTypedArray<type, CellKind::name##ArrayKind>>(*O); \
-    if (!arr->attached(runtime)) {                                         \
-      return runtime->raiseTypeError(                                      \
-          "Underlying ArrayBuffer detached after calling copyWithin");     \
-    }                                                                      \
-    while (count > 0) {                                                    \
-      arr->at(runtime, to) = arr->at(runtime, from);                       \
-      from += direction;                                                   \
-      to += direction;                                                     \
-      --count;                                                             \
-    }                                                                      \
-    break;                                                                 \
-  }
-
-  switch (O->getKind()) {
-#include "hermes/VM/TypedArrays.def"
-    default:
-      llvm_unreachable("Invalid TypedArray after ValidateTypedArray call");
+  // 15-17. Copy the elements in the direction which doesn't overwrite the
+  // ones yet to be copied. Copying their bytes preserves the bit-level
+  // encoding of the values, which HermesValues would destroy, e.g. which NaN
+  // is being used, and memmove() copies overlapping ranges correctly.
+  if (!O->attached(runtime)) {
+    return runtime->raiseTypeError(
+        "Underlying ArrayBuffer detached after calling copyWithin");
+  }
+  if (count > 0) {
+    const size_t width = O->getByteWidth();
+    uint8_t *data = O->begin(runtime);
+    std::memmove(
+        data + static_cast<size_t>(to) * width,
+        data + static_cast<size_t>(from) * width,
+        static_cast<size_t>(count) * width);
   }
 
   return O.getHermesValue();
@@ -798,13 +917,13 @@ typedArrayPrototypeEverySome(void *ctx, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError("callbackfn must be a Callable");
   }
   auto thisArg = args.getArgHandle(1);
+  PreparedCall callback{runtime, callbackfn, thisArg, 3};
+  if (LLVM_UNLIKELY(callback.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
   // Run the callback over every element.
   auto marker = gcScope.createMarker();
   for (JSTypedArrayBase::size_type i = 0; i < self->getLength(); ++i) {
-    auto callRes = Callable::executeCall3(
-        callbackfn,
-        runtime,
-        thisArg,
+    auto callRes = callback.call(
         JSObject::getOwnIndexed(*self, runtime, i),
         HermesValue::encodeNumberValue(i),
         self.getHermesValue());
@@ -876,7 +995,7 @@ typedArrayPrototypeFill(void *, Runtime *runtime, NativeArgs args) {
   // Fill with the same raw bytes as the first one.
   switch (elementSize) {
     case 1:
-      std::fill(begin + k, begin + last, *(begin + k));
+      std::memset(begin + k, *(begin + k), last - k);
       break;
     case 2: {
       auto *src = reinterpret_cast<uint16_t *>(begin);
@@ -915,12 +1034,14 @@ typedArrayPrototypeFind(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   auto thisArg = args.getArgHandle(1);
   GCScope gcScope(runtime);
+  PreparedCall callback{runtime, callbackfn, thisArg, 3};
+  if (LLVM_UNLIKELY(callback.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
   auto marker = gcScope.createMarker();
   for (JSTypedArrayBase::size_type i = 0; i < len; ++i) {
     auto val = JSObject::getOwnIndexed(*self, runtime, i);
     auto idx = HermesValue::encodeNumberValue(i);
-    auto callRes = Callable::executeCall3(
-        callbackfn, runtime, thisArg, val, idx, self.getHermesValue());
+    auto callRes = callback.call(val, idx, self.getHermesValue());
     if (callRes == ExecutionStatus::EXCEPTION) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -948,6 +1069,9 @@ typedArrayPrototypeForEach(void *, Runtime *runtime, NativeArgs args) {
   }
   auto thisArg = args.getArgHandle(1);
   GCScope gcScope(runtime);
+  PreparedCall callback{runtime, callbackfn, thisArg, 3};
+  if (LLVM_UNLIKELY(callback.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
   auto marker = gcScope.createMarker();
   for (JSTypedArrayBase::size_type i = 0; i < len; ++i) {
     // The callback function can detach the TypedArray.
@@ -956,13 +1080,9 @@ typedArrayPrototypeForEach(void *, Runtime *runtime, NativeArgs args) {
           "Detached the ArrayBuffer in the callback");
     }
     HermesValue val = JSObject::getOwnIndexed(*self, runtime, i);
-    if (Callable::executeCall3(
-            callbackfn,
-            runtime,
-            thisArg,
-            val,
-            HermesValue::encodeNumberValue(i),
-            self.getHermesValue()) == ExecutionStatus::EXCEPTION) {
+    if (callback.call(
+            val, HermesValue::encodeNumberValue(i), self.getHermesValue()) ==
+        ExecutionStatus::EXCEPTION) {
       return ExecutionStatus::EXCEPTION;
     }
     gcScope.flushToMarker(marker);
@@ -970,7 +1090,6 @@ typedArrayPrototypeForEach(void *, Runtime *runtime, NativeArgs args) {
   return HermesValue::encodeUndefinedValue();
 }
 
-enum class IndexOfMode { includes, indexOf, lastIndexOf };
 CallResult<HermesValue>
 typedArrayPrototypeIndexOf(void *ctx, Runtime *runtime, NativeArgs args) {
   const auto indexOfMode = *reinterpret_cast<const IndexOfMode *>(&ctx);
@@ -1021,24 +1140,32 @@ typedArrayPrototypeIndexOf(void *ctx, Runtime *runtime, NativeArgs args) {
   } else {
     k = fromIndex >= 0 ? fromIndex : std::max(len + fromIndex, 0.0);
   }
-  auto delta = indexOfMode == IndexOfMode::lastIndexOf ? -1 : 1;
-  auto inRange = [indexOfMode](double k, double len) {
-    if (indexOfMode == IndexOfMode::lastIndexOf) {
-      return k >= 0;
-    } else {
-      return k < len;
-    }
-  };
-  for (; inRange(k, len); k += delta) {
-    auto curr = JSObject::getOwnIndexed(*self, runtime, k);
-    bool comp = indexOfMode == IndexOfMode::includes
-        ? isSameValueZero(curr, searchElement)
-        : strictEqualityTest(curr, searchElement);
-    if (comp) {
-      return ret(true, k);
-    }
+  if (indexOfMode == IndexOfMode::lastIndexOf ? k < 0 : k >= len) {
+    return ret();
+  }
+  // Converting fromIndex may have detached the buffer.
+  if (LLVM_UNLIKELY(!self->attached(runtime))) {
+    return ret();
   }
-  return ret();
+  // Compare the elements in the buffer against the search element converted
+  // to their type, which is equivalent to converting each element to a
+  // number, since the conversion is exact.
+  int64_t index;
+  switch (self->getKind()) {
+#define TYPED_ARRAY(name, type)                          \
+  case CellKind::name##ArrayKind:                        \
+    index = indexOfElement<type>(                        \
+        vmcast<name##Array>(self.get())->begin(runtime), \
+        static_cast<size_t>(len),                        \
+        static_cast<size_t>(k),                          \
+        searchElement.getNumber(),                       \
+        indexOfMode);                                    \
+    break;
+#include "hermes/VM/TypedArrays.def"
+    default:
+      llvm_unreachable("Invalid TypedArray after ValidateTypedArray call");
+  }
+  return index < 0 ? ret() : ret(true, index);
 }
 
 CallResult<HermesValue>
@@ -1242,8 +1369,10 @@ typedArrayPrototypeReduce(void *ctx, Runtime *runtime, NativeArgs args) {
     i += right ? -1 : 1;
   }
 
-  Handle<> undefinedThis = Runtime::getUndefinedValue();
   GCScope scope(runtime);
+  PreparedCall callback{runtime, callbackfn, Runtime::getUndefinedValue(), 4};
+  if (LLVM_UNLIKELY(callback.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
   auto marker = scope.createMarker();
   for (; inRange(i, len); i += right ? -1 : 1) {
     if (!self->attached(runtime)) {
@@ -1251,10 +1380,7 @@ typedArrayPrototypeReduce(void *ctx, Runtime *runtime, NativeArgs args) {
       // continue.
       return runtime->raiseTypeError("Detached the TypedArray in the callback");
     }
-    auto callRes = Callable::executeCall4(
-        callbackfn,
-        runtime,
-        undefinedThis,
+    auto callRes = callback.call(
         accumulator.getHermesValue(),
         JSObject::getOwnIndexed(*self, runtime, i),
         HermesValue::encodeNumberValue(i),
@@ -1276,22 +1402,17 @@ typedArrayPrototypeReverse(void *, Runtime *runtime, NativeArgs args) {
     return ExecutionStatus::EXCEPTION;
   }
   auto self = args.vmcastThis<JSTypedArrayBase>();
-  const JSTypedArrayBase::size_type len = self->getLength();
-  const JSTypedArrayBase::size_type middle = len / 2;
-  MutableHandle<> lowerHandle(runtime);
-  MutableHandle<> upperHandle(runtime);
-  for (JSTypedArrayBase::size_type lower = 0; lower != middle; ++lower) {
-    auto upper = len - lower - 1;
-    lowerHandle = JSObject::getOwnIndexed(*self, runtime, lower);
-    upperHandle = JSObject::getOwnIndexed(*self, runtime, upper);
-    if (JSObject::setOwnIndexed(self, runtime, lower, upperHandle) ==
-        ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
-    if (JSObject::setOwnIndexed(self, runtime, upper, lowerHandle) ==
-        ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
+  // Swap the elements in the buffer, which preserves their encoding.
+  switch (self->getKind()) {
+#define TYPED_ARRAY(name, type)                           \
+  case CellKind::name##ArrayKind: {                       \
+    auto *arr = vmcast<name##Array>(self.get());          \
+    std::reverse(arr->begin(runtime), arr->end(runtime)); \
+    break;                                                \
+  }
+#include "hermes/VM/TypedArrays.def"
+    default:
+      llvm_unreachable("Invalid TypedArray after ValidateTypedArray call");
   }
   return self.getHermesValue();
 }
@@ -1312,18 +1433,29 @@ typedArrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError("TypedArray sort argument must be callable");
   }
 
-  // Use our custom sort routine. We can't use std::sort because it performs
-  // optimizations that allow it to bypass calls to std::swap, but our swap
-  // function is special, since it needs to use the internal Object functions.
-  if (compareFn) {
-    TypedArraySortModel<true> sm(runtime, self, compareFn);
-    if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
-      return ExecutionStatus::EXCEPTION;
-  } else {
-    TypedArraySortModel<false> sm(runtime, self, compareFn);
-    if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
-      return ExecutionStatus::EXCEPTION;
+  if (!compareFn) {
+    // Without a comparator the elements are compared as numbers, which
+    // doesn't run JS, so they are sorted directly in the buffer.
+    switch (self->getKind()) {
+#define TYPED_ARRAY(name, type)                                          \
+  case CellKind::name##ArrayKind: {                                      \
+    auto *arr = vmcast<name##Array>(self.get());                         \
+    std::sort(                                                           \
+        arr->begin(runtime), arr->end(runtime), TypedArrayLess<type>()); \
+    break;                                                               \
   }
+#include "hermes/VM/TypedArrays.def"
+      default:
+        llvm_unreachable("Invalid TypedArray after ValidateTypedArray call");
+    }
+    return self.getHermesValue();
+  }
+
+  // Use our custom sort routine, since the comparator may observe the array
+  // as it is being sorted, and must see equal elements keep their order.
+  TypedArraySortModel<true> sm(runtime, self, compareFn);
+  if (LLVM_UNLIKELY(stableSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
   return self.getHermesValue();
 }
 
@@ -1548,26 +1680,14 @@ typedArrayPrototypeToLocaleString(void *, Runtime *runtime, NativeArgs args) {
   return HermesValue::encodeStringValue(*builder->getStringPrimitive());
 }
 
-Handle<JSObject> createTypedArrayBaseConstructor(Runtime *runtime) {
+/// Define the properties of the %TypedArray% constructor \p cons and of
+/// %TypedArray%.prototype.
+static void populateTypedArrayBase(Runtime *runtime, Handle<JSObject> cons) {
   auto proto = Handle<JSObject>::vmcast(&runtime->typedArrayBasePrototype);
 
-  // Create NativeConstructor manually to avoid global object assignment.
-  // Use NativeConstructor because %TypedArray% is supposed to be
-  // a constructor function object, but must not be called directly with "new".
-  auto cons = toHandle(
-      runtime,
-      NativeConstructor::create(
-          runtime,
-          Handle<JSObject>::vmcast(&runtime->functionPrototype),
-          nullptr,
-          typedArrayBaseConstructor,
-          0,
-          JSObject::createWithException,
-          CellKind::ObjectKind));
-
   // Define %TypedArray%.prototype to be proto.
   auto st = Callable::defineNameLengthAndPrototype(
-      cons,
+      Handle<Callable>::vmcast(cons),
       runtime,
       Predefined::getSymbolID(Predefined::TypedArray),
       0,
@@ -1849,24 +1969,40 @@ Handle<JSObject> createTypedArrayBaseConstructor(Runtime *runtime) {
       nullptr,
       typedArrayOf,
       0);
+}
 
+Handle<JSObject> createTypedArrayBaseConstructor(Runtime *runtime) {
+  // Create NativeConstructor manually to avoid global object assignment.
+  // Use NativeConstructor because %TypedArray% is supposed to be
+  // a constructor function object, but must not be called directly with "new".
+  auto cons = toHandle(
+      runtime,
+      NativeConstructor::create(
+          runtime,
+          Handle<JSObject>::vmcast(&runtime->functionPrototype),
+          nullptr,
+          typedArrayBaseConstructor,
+          0,
+          JSObject::createWithException,
+          CellKind::ObjectKind));
+
+  JSObject::makeLazyBuiltin(
+      runtime,
+      cons,
+      Handle<JSObject>::vmcast(&runtime->typedArrayBasePrototype),
+      populateTypedArrayBase);
   return cons;
 }
 
+/// Define the properties of the constructor \p cons of the typed array
+/// with elements of type \p T, and of its prototype.
 template <typename T, CellKind C>
-Handle<JSObject> createTypedArrayConstructor(Runtime *runtime) {
+static void populateTypedArray(Runtime *runtime, Handle<JSObject> cons) {
   using TA = JSTypedArray<T, C>;
   auto proto = TA::getPrototype(runtime);
 
-  auto cons = defineSystemConstructor(
-      runtime,
-      TA::getName(runtime),
-      typedArrayConstructor<T, C>,
-      proto,
-      Handle<JSObject>::vmcast(&runtime->typedArrayBaseConstructor),
-      3,
-      TA::create,
-      C);
+  defineSystemConstructorProperties(
+      runtime, cons, TA::getName(runtime), proto, 3);
 
   DefinePropertyFlags dpf{};
   dpf.setEnumerable = 1;
@@ -1894,7 +2030,21 @@ Handle<JSObject> createTypedArrayConstructor(Runtime *runtime) {
       Predefined::getSymbolID(Predefined::BYTES_PER_ELEMENT),
       bytesPerElement,
       dpf);
-  return cons;
+}
+
+template <typename T, CellKind C>
+Handle<JSObject> createTypedArrayConstructor(Runtime *runtime) {
+  using TA = JSTypedArray<T, C>;
+  return defineLazySystemConstructor(
+      runtime,
+      TA::getName(runtime),
+      typedArrayConstructor<T, C>,
+      TA::getPrototype(runtime),
+      Handle<JSObject>::vmcast(&runtime->typedArrayBaseConstructor),
+      3,
+      TA::create,
+      C,
+      populateTypedArray<T, C>);
 }
 
 /// Forward instantiations
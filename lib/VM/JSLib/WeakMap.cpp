@@ -14,7 +14,9 @@
 namespace hermes {
 namespace vm {
 
-Handle<JSObject> createWeakMapConstructor(Runtime *runtime) {
+/// Define the properties of the WeakMap constructor \p cons and of
+/// WeakMap.prototype.
+static void populateWeakMap(Runtime *runtime, Handle<JSObject> cons) {
   auto weakMapPrototype = Handle<JSObject>::vmcast(&runtime->weakMapPrototype);
 
   defineMethod(
@@ -59,13 +61,12 @@ Handle<JSObject> createWeakMapConstructor(Runtime *runtime) {
       runtime->getPredefinedStringHandle(Predefined::WeakMap),
       dpf);
 
-  auto cons = defineSystemConstructor<JSWeakMap>(
+  defineSystemConstructorProperties(
       runtime,
+      cons,
       Predefined::getSymbolID(Predefined::WeakMap),
-      weakMapConstructor,
       weakMapPrototype,
-      0,
-      CellKind::WeakMapKind);
+      0);
 
   // ES6.0 23.3.3.1
   defineProperty(
@@ -73,8 +74,19 @@ Handle<JSObject> createWeakMapConstructor(Runtime *runtime) {
       weakMapPrototype,
       Predefined::getSymbolID(Predefined::constructor),
       cons);
+}
 
-  return cons;
+Handle<JSObject> createWeakMapConstructor(Runtime *runtime) {
+  return defineLazySystemConstructor(
+      runtime,
+      Predefined::getSymbolID(Predefined::WeakMap),
+      weakMapConstructor,
+      Handle<JSObject>::vmcast(&runtime->weakMapPrototype),
+      Handle<JSObject>::vmcast(&runtime->functionPrototype),
+      0,
+      JSWeakMap::create,
+      CellKind::WeakMapKind,
+      populateWeakMap);
 }
 
 CallResult<HermesValue>
@@ -14,7 +14,9 @@
 namespace hermes {
 namespace vm {
 
-Handle<JSObject> createWeakSetConstructor(Runtime *runtime) {
+/// Define the properties of the WeakSet constructor \p cons and of
+/// WeakSet.prototype.
+static void populateWeakSet(Runtime *runtime, Handle<JSObject> cons) {
   auto weakSetPrototype = Handle<JSObject>::vmcast(&runtime->weakSetPrototype);
 
   defineMethod(
@@ -51,13 +53,12 @@ Handle<JSObject> createWeakSetConstructor(Runtime *runtime) {
       runtime->getPredefinedStringHandle(Predefined::WeakSet),
       dpf);
 
-  auto cons = defineSystemConstructor<JSWeakSet>(
+  defineSystemConstructorProperties(
       runtime,
+      cons,
       Predefined::getSymbolID(Predefined::WeakSet),
-      weakSetConstructor,
       weakSetPrototype,
-      0,
-      CellKind::WeakSetKind);
+      0);
 
   // ES6.0 23.4.3.1
   defineProperty(
@@ -65,8 +66,19 @@ Handle<JSObject> createWeakSetConstructor(Runtime *runtime) {
       weakSetPrototype,
       Predefined::getSymbolID(Predefined::constructor),
       cons);
+}
 
-  return cons;
+Handle<JSObject> createWeakSetConstructor(Runtime *runtime) {
+  return defineLazySystemConstructor(
+      runtime,
+      Predefined::getSymbolID(Predefined::WeakSet),
+      weakSetConstructor,
+      Handle<JSObject>::vmcast(&runtime->weakSetPrototype),
+      Handle<JSObject>::vmcast(&runtime->functionPrototype),
+      0,
+      JSWeakSet::create,
+      CellKind::WeakSetKind,
+      populateWeakSet);
 }
 
 CallResult<HermesValue>
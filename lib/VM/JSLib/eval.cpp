@@ -28,12 +28,10 @@
 namespace hermes {
 namespace vm {
 
-CallResult<HermesValue> evalInEnvironment(
+CallResult<std::shared_ptr<hbc::BCProvider>> compileEvalCode(
     Runtime *runtime,
     llvm::StringRef utf8code,
-    Handle<Environment> environment,
     const ScopeChain &scopeChain,
-    Handle<> thisArg,
     bool singleFunction) {
 #ifdef HERMESVM_LEAN
   return runtime->raiseEvalUnsupported(utf8code);
@@ -48,8 +46,11 @@ CallResult<HermesValue> evalInEnvironment(
   compileFlags.lazy =
       utf8code.size() >= hbc::kDefaultSizeThresholdForLazyCompilation;
 
-  std::unique_ptr<hbc::BCProviderFromSrc> bytecode;
-  {
+  // The same source is often compiled again, e.g. by templating libraries.
+  EvalCache &cache = runtime->getEvalCache();
+  std::shared_ptr<hbc::BCProviderFromSrc> bytecode =
+      cache.lookup(utf8code, compileFlags, scopeChain);
+  if (!bytecode) {
     std::unique_ptr<hermes::Buffer> buffer;
     if (compileFlags.lazy) {
       buffer.reset(new hermes::OwnedMemoryBuffer(
@@ -64,21 +65,37 @@ CallResult<HermesValue> evalInEnvironment(
     if (!bytecode_err.first) {
       return runtime->raiseSyntaxError(TwineChar16(bytecode_err.second));
     }
-    if (singleFunction && !bytecode_err.first->isSingleFunction()) {
-      return runtime->raiseSyntaxError("Invalid function expression");
-    }
     bytecode = std::move(bytecode_err.first);
+    cache.insert(utf8code, compileFlags, scopeChain, bytecode);
+  }
+  if (singleFunction && !bytecode->isSingleFunction()) {
+    return runtime->raiseSyntaxError("Invalid function expression");
+  }
+  return std::shared_ptr<hbc::BCProvider>(std::move(bytecode));
+#endif
+}
+
+CallResult<HermesValue> evalInEnvironment(
+    Runtime *runtime,
+    llvm::StringRef utf8code,
+    Handle<Environment> environment,
+    const ScopeChain &scopeChain,
+    Handle<> thisArg,
+    bool singleFunction) {
+  auto bytecodeRes =
+      compileEvalCode(runtime, utf8code, scopeChain, singleFunction);
+  if (LLVM_UNLIKELY(bytecodeRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
   }
 
   // TODO: pass a sourceURL derived from a '//# sourceURL' comment.
   llvm::StringRef sourceURL{};
   return runtime->runBytecode(
-      std::move(bytecode),
+      std::move(*bytecodeRes),
       RuntimeModuleFlags{},
       sourceURL,
       environment,
       thisArg);
-#endif
 }
 
 CallResult<HermesValue> directEval(
@@ -7,6 +7,7 @@
 
 #include "JSLibInternal.h"
 
+#include "hermes/Support/TraceEvents.h"
 #include "hermes/Support/UTF8.h"
 #include "hermes/VM/Handle.h"
 #include "hermes/VM/JSLib.h"
@@ -41,6 +42,11 @@ CallResult<HermesValue> runRequireCall(
         Predefined::getSymbolID(Predefined::exports));
   }
 
+  trace::Scope traceScope(trace::Category::Execution, "require");
+  traceScope.addArg("cjsModuleOffset", cjsModuleOffset);
+  // Read in the modules this one requires while it is being initialized,
+  // instead of when each of them is first required.
+  domain->prefetchCJSModuleDependencies(runtime, cjsModuleOffset);
   GCScope gcScope{runtime};
   // If not initialized yet, start initializing and set the module object.
   Handle<JSObject> module = toHandle(runtime, JSObject::create(runtime));
@@ -148,6 +154,19 @@ CallResult<HermesValue> requireFast(void *, Runtime *runtime, NativeArgs args) {
   uint32_t index = args.getArg(0).getNumberAs<uint32_t>();
   OptValue<uint32_t> cjsModuleOffset =
       domain->getCJSModuleOffset(runtime, index);
+  if (LLVM_UNLIKELY(!cjsModuleOffset) && runtime->getSegmentLoader()) {
+    // The module may live in a segment that hasn't been loaded yet.
+    if (auto segment = domain->findSegmentOfModule(index)) {
+      if (auto bytecode = runtime->getSegmentLoader()(*segment)) {
+        if (LLVM_UNLIKELY(
+                RuntimeModule::create(runtime, domain, std::move(bytecode)) ==
+                ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        cjsModuleOffset = domain->getCJSModuleOffset(runtime, index);
+      }
+    }
+  }
   if (LLVM_UNLIKELY(!cjsModuleOffset)) {
     return runtime->raiseTypeError(
         TwineChar16("Unable to find module with ID: ") + index);
@@ -18,6 +18,9 @@
 
 #include "llvm/ADT/SmallSet.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace hermes {
 namespace vm {
 
@@ -152,7 +155,11 @@ PseudoHandle<JSObject> JSObject::create(
 }
 
 PseudoHandle<JSObject> JSObject::create(Runtime *runtime) {
-  void *mem = runtime->alloc</*fixedSize*/ true>(cellSize<JSObject>());
+  return createInPlace(
+      runtime, runtime->alloc</*fixedSize*/ true>(cellSize<JSObject>()));
+}
+
+PseudoHandle<JSObject> JSObject::createInPlace(Runtime *runtime, void *mem) {
   JSObject *objProto = runtime->objectPrototypeRawPtr;
   return createPseudoHandle(new (mem) JSObject(
       runtime,
@@ -164,8 +171,11 @@ PseudoHandle<JSObject> JSObject::create(Runtime *runtime) {
 
 PseudoHandle<JSObject> JSObject::create(
     Runtime *runtime,
-    unsigned propertyCount) {
-  void *mem = runtime->alloc</*fixedSize*/ true>(cellSize<JSObject>());
+    unsigned propertyCount,
+    bool pretenure) {
+  void *mem = pretenure
+      ? runtime->allocPretenured(cellSize<JSObject>())
+      : runtime->alloc</*fixedSize*/ true>(cellSize<JSObject>());
   JSObject *objProto = runtime->objectPrototypeRawPtr;
   return runtime->ignoreAllocationFailure(JSObject::allocatePropStorage(
       createPseudoHandle(new (mem) JSObject(
@@ -180,8 +190,9 @@ PseudoHandle<JSObject> JSObject::create(
 
 PseudoHandle<JSObject> JSObject::create(
     Runtime *runtime,
-    Handle<HiddenClass> clazz) {
-  auto obj = JSObject::create(runtime, clazz->getNumProperties());
+    Handle<HiddenClass> clazz,
+    bool pretenure) {
+  auto obj = JSObject::create(runtime, clazz->getNumProperties(), pretenure);
   obj->clazz_.set(runtime, *clazz, &runtime->getHeap());
   // If the hidden class has index like property, we need to clear the fast path
   // flag.
@@ -200,14 +211,46 @@ void JSObject::initializeLazyObject(
     Runtime *runtime,
     Handle<JSObject> lazyObject) {
   assert(lazyObject->flags_.lazyObject && "object must be lazy");
+  if (Runtime::LazyBuiltin *lazy = runtime->findLazyBuiltin(
+          lazyObject->flags_.objectID, lazyObject.get())) {
+    // Initialize the constructor and the prototype together, since the
+    // initializer defines the properties of both.
+    GCScopeMarkerRAII marker{runtime};
+    auto cons = runtime->makeHandle(lazy->constructor);
+    auto *init = lazy->init;
+    lazy->init = nullptr;
+    lazy->constructor->flags_.lazyObject = 0;
+    lazy->prototype->flags_.lazyObject = 0;
+    init(runtime, cons);
+    return;
+  }
+
   // object is now assumed to be a regular object.
   lazyObject->flags_.lazyObject = 0;
 
-  // only functions can be lazy.
+  // only functions and builtins can be lazy.
   assert(vmisa<Callable>(lazyObject.get()) && "unexpected lazy object");
   Callable::defineLazyProperties(Handle<Callable>::vmcast(lazyObject), runtime);
 }
 
+void JSObject::makeLazyBuiltin(
+    Runtime *runtime,
+    Handle<JSObject> cons,
+    Handle<JSObject> proto,
+    void (*init)(Runtime *runtime, Handle<JSObject> cons)) {
+  assert(
+      cons->getClass(runtime)->getNumProperties() == 0 &&
+      proto->getClass(runtime)->getNumProperties() == 0 &&
+      "lazy builtins must not have properties");
+  uint32_t index = runtime->addLazyBuiltin(*cons, *proto, init);
+  assert(
+      index < (1u << ObjectFlags::kHashWidth) && "too many lazy builtins");
+  cons->flags_.lazyObject = 1;
+  cons->flags_.objectID = index;
+  proto->flags_.lazyObject = 1;
+  proto->flags_.objectID = index;
+}
+
 ObjectID JSObject::getObjectID(JSObject *self, Runtime *runtime) {
   if (LLVM_LIKELY(self->flags_.objectID))
     return self->flags_.objectID;
@@ -358,6 +401,102 @@ void JSObject::addInternalProperties(
   }
 }
 
+/// Invalidate the global cells of the property caches if \p self is the global
+/// object, one of whose properties is deleted or reconfigured, or whose slots
+/// move.
+static void noteGlobalSlotsChanged(JSObject *self, Runtime *runtime) {
+  if (LLVM_UNLIKELY(runtime->isGlobal(self)))
+    runtime->invalidateGlobalPropertyCells();
+}
+
+bool JSObject::tryLeaveDictionaryMode(
+    Handle<JSObject> selfHandle,
+    Runtime *runtime) {
+  auto clazz = runtime->makeHandle(selfHandle->clazz_);
+  assert(clazz->isDictionary() && "object must be in dictionary mode");
+  // Only plain objects, whose classes all start from the root class.
+  if (selfHandle->getKind() != CellKind::ObjectKind ||
+      clazz->getNumProperties() > HiddenClass::kDictionaryThreshold)
+    return false;
+
+  GCScopeMarkerRAII marker{runtime};
+  using Property = std::pair<SymbolID, NamedPropertyDescriptor>;
+  llvm::SmallVector<Property, 16> props;
+  HiddenClass::forEachProperty(
+      clazz, runtime, [&props](SymbolID id, NamedPropertyDescriptor desc) {
+        props.emplace_back(id, desc);
+      });
+
+  // The old class keeps the names alive until the object is switched over.
+  MutableHandle<HiddenClass> newClazz{
+      runtime,
+      runtime->getHiddenClassForPrototypeRaw(selfHandle->getParent(runtime))};
+  for (const Property &prop : props) {
+    auto addResult = HiddenClass::addProperty(
+        newClazz, runtime, prop.first, prop.second.flags);
+    if (LLVM_UNLIKELY(addResult == ExecutionStatus::EXCEPTION)) {
+      runtime->clearThrownValue();
+      return false;
+    }
+    newClazz = *addResult->first;
+  }
+  assert(
+      !newClazz->isDictionary() &&
+      newClazz->getNumProperties() == props.size() &&
+      "the properties should fit in a regular class");
+
+  // Move the values to the slots of the new class. Nothing below allocates,
+  // and the new slots are a prefix of the storage the old ones already use.
+  llvm::SmallVector<HermesValue, 16> values;
+  SlotIndex oldSlots = 0;
+  for (const Property &prop : props) {
+    values.push_back(getNamedSlotValue(*selfHandle, runtime, prop.second));
+    oldSlots = std::max(oldSlots, prop.second.slot + 1);
+  }
+  for (SlotIndex i = 0; i != oldSlots; ++i) {
+    setNamedSlotValue(
+        *selfHandle,
+        runtime,
+        i,
+        i < values.size() ? values[i] : HermesValue::encodeUndefinedValue());
+  }
+  selfHandle->clazz_.set(runtime, *newClazz, &runtime->getHeap());
+  noteGlobalSlotsChanged(*selfHandle, runtime);
+  return true;
+}
+
+CallResult<bool> JSObject::tryAdoptClassAndSlots(
+    Handle<JSObject> selfHandle,
+    Runtime *runtime,
+    Handle<JSObject> source) {
+  HiddenClass *clazz = selfHandle->clazz_.getNonNull(runtime);
+  if (selfHandle->getKind() != CellKind::ObjectKind ||
+      selfHandle->flags_.noExtend || clazz->isDictionary() ||
+      clazz->getNumProperties() != 0 || selfHandle->propStorage_) {
+    return false;
+  }
+  assert(
+      source->getKind() == CellKind::ObjectKind &&
+      !source->clazz_.getNonNull(runtime)->isDictionary() &&
+      "source must be a plain object which isn't a dictionary");
+
+  // The slots of a class which isn't a dictionary are numbered from 0, in the
+  // order its properties were added.
+  unsigned numSlots = source->clazz_.getNonNull(runtime)->getNumProperties();
+  if (LLVM_UNLIKELY(
+          allocatePropStorage(selfHandle, runtime, numSlots) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  for (SlotIndex i = 0; i != numSlots; ++i) {
+    setNamedSlotValue(
+        *selfHandle, runtime, i, getNamedSlotValue(*source, runtime, i));
+  }
+  selfHandle->clazz_.set(
+      runtime, source->clazz_.getNonNull(runtime), &runtime->getHeap());
+  return true;
+}
+
 CallResult<HermesValue> JSObject::getNamedPropertyValue_RJS(
     Handle<JSObject> selfHandle,
     Runtime *runtime,
@@ -834,7 +973,7 @@ JSObject *JSObject::getNamedDescriptor(
     SymbolID name,
     PropertyFlags expectedFlags,
     NamedPropertyDescriptor &desc) {
-  if (findProperty(selfHandle, runtime, name, expectedFlags, desc))
+  if (findPropertyDescriptor(selfHandle, runtime, name, expectedFlags, desc))
     return *selfHandle;
 
   // Check here for host object flag.  This means that "normal" own
@@ -854,7 +993,7 @@ JSObject *JSObject::getNamedDescriptor(
     // Initialize the object and perform the lookup again.
     JSObject::initializeLazyObject(runtime, selfHandle);
 
-    if (findProperty(selfHandle, runtime, name, expectedFlags, desc))
+    if (findPropertyDescriptor(selfHandle, runtime, name, expectedFlags, desc))
       return *selfHandle;
   }
   if (selfHandle->parent_) {
@@ -867,7 +1006,7 @@ JSObject *JSObject::getNamedDescriptor(
               !mutableSelfHandle->flags_.lazyObject &&
               !mutableSelfHandle->flags_.hostObject)) {
       findProp:
-        if (findProperty(
+        if (findPropertyDescriptor(
                 mutableSelfHandle,
                 runtime,
                 name,
@@ -943,6 +1082,43 @@ ExecutionStatus JSObject::getComputedDescriptor(
       selfHandle, runtime, *converted, propObj, desc);
 }
 
+void JSObject::cachePrototypeLoad(
+    JSObject *self,
+    PointerBase *base,
+    JSObject *holder,
+    SlotIndex slot,
+    PropertyCacheEntry *cacheEntry) {
+  assert(holder != self && "the holder must be a prototype of self");
+  PropertyCacheEntry::ClassStorageType
+      classes[PropertyCacheEntry::kMaxProtoDepth + 1];
+  // A dictionary receiver is looked up on every access instead.
+  classes[0] = self->getClass(base)->isDictionary()
+      ? PropertyCacheEntry::ClassStorageType{}
+      : self->clazz_.getStorageType();
+  unsigned depth = 0;
+  for (JSObject *obj = self; obj != holder;) {
+    // The objects in between must not have the property, and keep not
+    // having it for as long as their class doesn't change.
+    if (obj->flags_.lazyObject || obj->flags_.hostObject ||
+        (obj != self && obj->getClass(base)->isDictionary())) {
+      return;
+    }
+    if (++depth > PropertyCacheEntry::kMaxProtoDepth) {
+      return;
+    }
+    obj = obj->parent_.get(base);
+    assert(obj && "the holder must be on the prototype chain of self");
+    classes[depth] = obj->clazz_.getStorageType();
+  }
+  std::copy(classes, classes + depth + 1, cacheEntry->protoClazz);
+  std::fill(
+      cacheEntry->protoClazz + depth + 1,
+      std::end(cacheEntry->protoClazz),
+      PropertyCacheEntry::ClassStorageType{});
+  cacheEntry->protoSlot = slot;
+  cacheEntry->protoDepth = depth;
+}
+
 CallResult<HermesValue> JSObject::getNamedWithReceiver_RJS(
     Handle<JSObject> selfHandle,
     Runtime *runtime,
@@ -967,8 +1143,13 @@ CallResult<HermesValue> JSObject::getNamedWithReceiver_RJS(
   if (LLVM_LIKELY(!desc.flags.accessor && !desc.flags.hostObject)) {
     // Populate the cache if requested.
     if (cacheEntry && !propObj->getClass(runtime)->isDictionaryNoCache()) {
-      cacheEntry->clazz = propObj->getClassGCPtr().getStorageType();
-      cacheEntry->slot = desc.slot;
+      if (propObj == *selfHandle) {
+        cacheEntry->update(
+            propObj->getClassGCPtr().getStorageType(), desc.slot);
+      } else {
+        cachePrototypeLoad(
+            *selfHandle, runtime, propObj, desc.slot, cacheEntry);
+      }
     }
     return getNamedSlotValue(propObj, runtime, desc);
   }
@@ -1620,6 +1801,7 @@ CallResult<bool> JSObject::deleteNamed(
   auto newClazz = HiddenClass::deleteProperty(
       runtime->makeHandle(selfHandle->clazz_), runtime, *pos);
   selfHandle->clazz_.set(runtime, *newClazz, &runtime->getHeap());
+  noteGlobalSlotsChanged(*selfHandle, runtime);
 
   return true;
 }
@@ -1719,6 +1901,7 @@ CallResult<bool> JSObject::deleteComputed(
     auto newClazz = HiddenClass::deleteProperty(
         runtime->makeHandle(selfHandle->clazz_), runtime, *pos);
     selfHandle->clazz_.set(runtime, *newClazz, &runtime->getHeap());
+    noteGlobalSlotsChanged(*selfHandle, runtime);
   }
   return true;
 }
@@ -2225,6 +2408,9 @@ CallResult<bool> JSObject::preventExtensions(
     Handle<JSObject> selfHandle,
     Runtime *runtime,
     PropOpFlags opFlags) {
+  // The properties of a lazy object must be defined while it is extensible.
+  if (LLVM_UNLIKELY(selfHandle->flags_.lazyObject))
+    initializeLazyObject(runtime, selfHandle);
   JSObject::preventExtensions(*selfHandle);
   return true;
 }
@@ -2290,6 +2476,7 @@ void JSObject::updatePropertyFlagsWithoutTransitions(
       flagsToSet,
       props);
   selfHandle->clazz_.set(runtime, *newClazz, &runtime->getHeap());
+  noteGlobalSlotsChanged(*selfHandle, runtime);
 }
 
 CallResult<bool> JSObject::isExtensible(
@@ -2450,6 +2637,7 @@ CallResult<bool> JSObject::updateOwnProperty(
         propertyPos,
         desc.flags);
     selfHandle->clazz_.set(runtime, *newClazz, &runtime->getHeap());
+    noteGlobalSlotsChanged(*selfHandle, runtime);
   }
 
   if (updateStatus->first == PropertyUpdateStatus::done)
@@ -10,8 +10,10 @@
 #include "hermes/Regex/Compiler.h"
 #include "hermes/Regex/Executor.h"
 #include "hermes/Regex/RegexTraits.h"
+#include "hermes/Support/TraceEvents.h"
 #include "hermes/Support/UTF8.h"
 #include "hermes/VM/BuildMetadata.h"
+#include "hermes/VM/JIT/JIT.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/RegExpMatch.h"
 #include "hermes/VM/StringView.h"
@@ -167,7 +169,14 @@ ExecutionStatus JSRegExp::initialize(
     llvm::SmallVector<char16_t, 16> patternText16;
     patternText.copyUTF16String(patternText16);
 
+    RegExpCache &cache = runtime->getRegExpCache();
+    if (const auto *cached = cache.lookup(patternText16, nativeFlags)) {
+      return selfHandle->initializeBytecode(*cached, runtime);
+    }
+
     // Build the regex.
+    trace::Scope traceScope(trace::Category::Compile, "regExpCompile");
+    traceScope.addArg("patternLength", (int64_t)patternText16.size());
     regex::Regex<regex::UTF16RegexTraits> regex(
         patternText16.begin(), patternText16.end(), nativeFlags);
 
@@ -179,7 +188,13 @@ ExecutionStatus JSRegExp::initialize(
     }
     // The regex is valid. Compile and store its bytecode.
     auto bytecode = regex.compile();
-    return selfHandle->initializeBytecode(bytecode, runtime);
+    if (LLVM_UNLIKELY(
+            selfHandle->initializeBytecode(bytecode, runtime) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    cache.insert(patternText16, nativeFlags, std::move(bytecode));
+    return ExecutionStatus::RETURNED;
   }
 }
 
@@ -194,6 +209,7 @@ ExecutionStatus JSRegExp::initializeBytecode(
   bytecodeSize_ = sz;
   bytecode_ = (uint8_t *)checkedMalloc(sz);
   memcpy(bytecode_, bytecode.data(), sz);
+  jitRegExp_ = nullptr;
   return ExecutionStatus::RETURNED;
 }
 
@@ -247,18 +263,31 @@ template <typename CharT, typename Traits>
 CallResult<RegExpMatch> performSearch(
     Runtime *runtime,
     llvm::ArrayRef<uint8_t> bytecode,
+    JITRegExp *jitRegExp,
     const CharT *start,
     uint32_t stringLength,
     uint32_t searchStartOffset,
     regex::constants::MatchFlagType matchFlags) {
   std::vector<regex::CapturedRange> nativeMatchRanges;
-  auto matchResult = regex::searchWithBytecode(
-      bytecode,
-      start,
-      searchStartOffset,
-      stringLength,
-      &nativeMatchRanges,
-      matchFlags);
+  llvm::Optional<regex::MatchRuntimeResult> jitResult;
+  if (jitRegExp) {
+    jitResult = runtime->getJITContext().searchRegExp(
+        jitRegExp,
+        bytecode,
+        start,
+        searchStartOffset,
+        stringLength,
+        &nativeMatchRanges,
+        matchFlags);
+  }
+  auto matchResult = jitResult ? *jitResult
+                               : regex::searchWithBytecode(
+                                     bytecode,
+                                     start,
+                                     searchStartOffset,
+                                     stringLength,
+                                     &nativeMatchRanges,
+                                     matchFlags);
   if (matchResult == regex::MatchRuntimeResult::StackOverflow) {
     runtime->raiseRangeError("Maximum regex stack depth reached");
     return ExecutionStatus::EXCEPTION;
@@ -306,12 +335,19 @@ CallResult<RegExpMatch> JSRegExp::search(
     matchFlags |= regex::constants::matchOnlyAtStart;
   }
 
+  auto &jit = runtime->getJITContext();
+  if (!selfHandle->jitRegExp_ && jit.isEnabled()) {
+    selfHandle->jitRegExp_ = jit.getRegExp(
+        llvm::makeArrayRef(selfHandle->bytecode_, selfHandle->bytecodeSize_));
+  }
+
   CallResult<RegExpMatch> matchResult = RegExpMatch{};
   if (input.isASCII()) {
     matchFlags |= regex::constants::matchInputAllAscii;
     matchResult = performSearch<char, regex::ASCIIRegexTraits>(
         runtime,
         llvm::makeArrayRef(selfHandle->bytecode_, selfHandle->bytecodeSize_),
+        selfHandle->jitRegExp_,
         input.castToCharPtr(),
         input.length(),
         searchStartOffset,
@@ -320,6 +356,7 @@ CallResult<RegExpMatch> JSRegExp::search(
     matchResult = performSearch<char16_t, regex::UTF16RegexTraits>(
         runtime,
         llvm::makeArrayRef(selfHandle->bytecode_, selfHandle->bytecodeSize_),
+        selfHandle->jitRegExp_,
         input.castToChar16Ptr(),
         input.length(),
         searchStartOffset,
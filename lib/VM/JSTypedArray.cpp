@@ -189,6 +189,36 @@ ExecutionStatus JSTypedArrayBase::setToCopyOfBuffer(
   return ExecutionStatus::RETURNED;
 }
 
+namespace {
+/// Convert the \p count elements of \p src starting at \p srcIndex to the
+/// element type of \p DstArray, into \p dst starting at \p dstIndex. This is
+/// equivalent to setting each element to the number read from the other,
+/// without encoding each of them as a HermesValue, so the compiler can
+/// vectorize the conversion.
+template <typename DstArray>
+void convertElements(
+    Runtime *runtime,
+    DstArray *dst,
+    JSTypedArrayBase::size_type dstIndex,
+    JSTypedArrayBase *src,
+    JSTypedArrayBase::size_type srcIndex,
+    JSTypedArrayBase::size_type count) {
+  auto *to = dst->begin(runtime) + dstIndex;
+  switch (src->getKind()) {
+#define TYPED_ARRAY(name, type)                                             \
+  case CellKind::name##ArrayKind: {                                         \
+    const type *from = vmcast<name##Array>(src)->begin(runtime) + srcIndex; \
+    for (JSTypedArrayBase::size_type i = 0; i != count; ++i)                \
+      to[i] = DstArray::toDestType(from[i]);                                \
+    break;                                                                  \
+  }
+#include "hermes/VM/TypedArrays.def"
+    default:
+      llvm_unreachable("Invalid TypedArray kind");
+  }
+}
+} // namespace
+
 ExecutionStatus JSTypedArrayBase::setToCopyOfTypedArray(
     Runtime *runtime,
     Handle<JSTypedArrayBase> dst,
@@ -211,13 +241,15 @@ ExecutionStatus JSTypedArrayBase::setToCopyOfTypedArray(
         runtime, dst, dstIndex, src, srcIndex, count);
   } else {
     // Else must do type conversions.
-    MutableHandle<> storage(runtime);
-    for (auto k = srcIndex; k < srcIndex + count; ++k) {
-      storage = JSObject::getOwnIndexed(*src, runtime, k);
-      if (JSObject::setOwnIndexed(dst, runtime, dstIndex++, storage) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
+    switch (dst->getKind()) {
+#define TYPED_ARRAY(name, type)                                               \
+  case CellKind::name##ArrayKind:                                             \
+    convertElements(                                                          \
+        runtime, vmcast<name##Array>(*dst), dstIndex, *src, srcIndex, count); \
+    break;
+#include "hermes/VM/TypedArrays.def"
+      default:
+        llvm_unreachable("Invalid TypedArray kind");
     }
   }
   return ExecutionStatus::RETURNED;
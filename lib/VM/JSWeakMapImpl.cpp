@@ -102,6 +102,7 @@ HermesValue JSWeakMapImplBase::getValue(
 
 void JSWeakMapImplBase::_markWeakImpl(GCCell *cell, WeakRefAcceptor &acceptor) {
   auto *self = reinterpret_cast<JSWeakMapImplBase *>(cell);
+  self->freeableKeys_.clear();
   for (auto it = self->map_.begin(); it != self->map_.end(); ++it) {
     // We must mark the weak ref regardless of whether the ref is valid here,
     // because JSWeakMapImplBase still has a pointer from map_ into the
@@ -115,18 +116,33 @@ void JSWeakMapImplBase::_markWeakImpl(GCCell *cell, WeakRefAcceptor &acceptor) {
       // Set the hasFreeableSlots_ to indicate that this slot can be
       // cleaned up the next time we add an element to this map.
       self->hasFreeableSlots_ = true;
+      self->freeableKeys_.push_back(it->first);
     }
   }
 }
 
 /// Mark weak references and remove any invalid weak refs.
 void JSWeakMapImplBase::findAndDeleteFreeSlots(PointerBase *base) {
-  for (auto it = map_.begin(); it != map_.end(); ++it) {
-    if (!it->first.ref.isValid()) {
-      // If invalid, clear the value and remove the key from the map.
+  if (LLVM_UNLIKELY(freeableKeys_.empty())) {
+    // The map was deserialized since its weak refs were last marked.
+    for (auto it = map_.begin(); it != map_.end(); ++it) {
+      if (!it->first.ref.isValid()) {
+        // If invalid, clear the value and remove the key from the map.
+        deleteInternal(base, it);
+      }
+    }
+    hasFreeableSlots_ = false;
+    return;
+  }
+
+  for (const WeakRefKey &key : freeableKeys_) {
+    DenseMapT::iterator it = map_.find(key);
+    // The entry may have been deleted explicitly since it was recorded.
+    if (it != map_.end() && !it->first.ref.isValid()) {
       deleteInternal(base, it);
     }
   }
+  freeableKeys_.clear();
   hasFreeableSlots_ = false;
 }
 
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMESVM_LEAN
+#include "hermes/VM/LazyCompileQueue.h"
+
+#include "hermes/VM/CodeBlock.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+
+LazyCompileQueue::~LazyCompileQueue() {
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    shouldExit_ = true;
+    pending_.clear();
+  }
+  workAvailable_.notify_one();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+void LazyCompileQueue::enqueue(
+    std::shared_ptr<hbc::BCProvider> root,
+    std::shared_ptr<hbc::BCProvider> provider,
+    hbc::BytecodeFunction *lazyFunction) {
+  auto *lazyData = lazyFunction->getLazyCompilationData();
+  assert(lazyData && "Only lazy functions may be precompiled");
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (!entries_
+             .try_emplace(
+                 lazyData, Entry{std::move(root), std::move(provider)})
+             .second)
+      return;
+    pending_.push_back(lazyData);
+    if (!worker_.joinable()) {
+      worker_ = std::thread(&LazyCompileQueue::workerLoop, this);
+    }
+  }
+  workAvailable_.notify_one();
+}
+
+std::unique_ptr<hbc::BytecodeModule> LazyCompileQueue::take(
+    hbc::LazyFunctionCache &cache,
+    hbc::LazyCompilationData *lazyData) {
+  {
+    std::unique_lock<std::mutex> lk(mtx_);
+    compiled_.wait(lk, [this, lazyData]() { return running_ != lazyData; });
+    auto it = entries_.find(lazyData);
+    if (it != entries_.end()) {
+      auto result = std::move(it->second.result);
+      entries_.erase(it);
+      if (result)
+        return result;
+      pending_.erase(std::find(pending_.begin(), pending_.end(), lazyData));
+    }
+  }
+  // The worker didn't get to it yet.
+  auto compilerLock = cache.lockCompiler();
+  return compileLazyFunction(lazyData);
+}
+
+void LazyCompileQueue::cancel(hbc::LazyCompilationData *lazyData) {
+  std::unique_lock<std::mutex> lk(mtx_);
+  compiled_.wait(lk, [this, lazyData]() { return running_ != lazyData; });
+  auto it = entries_.find(lazyData);
+  if (it == entries_.end())
+    return;
+  if (!it->second.result) {
+    pending_.erase(std::find(pending_.begin(), pending_.end(), lazyData));
+  }
+  entries_.erase(it);
+}
+
+void LazyCompileQueue::waitUntilIdle() {
+  std::unique_lock<std::mutex> lk(mtx_);
+  compiled_.wait(lk, [this]() { return pending_.empty() && !running_; });
+}
+
+void LazyCompileQueue::workerLoop() {
+  std::unique_lock<std::mutex> lk(mtx_);
+  while (true) {
+    workAvailable_.wait(
+        lk, [this]() { return shouldExit_ || !pending_.empty(); });
+    if (shouldExit_) {
+      return;
+    }
+    running_ = pending_.front();
+    pending_.pop_front();
+    auto *root = static_cast<hbc::BCProviderFromSrc *>(
+        entries_[running_].root.get());
+    lk.unlock();
+    std::unique_ptr<hbc::BytecodeModule> result;
+    {
+      auto compilerLock = root->getLazyFunctionCache().lockCompiler();
+      result = compileLazyFunction(running_);
+    }
+    lk.lock();
+    // The entry can't have been taken or cancelled while it was running.
+    entries_[running_].result = std::move(result);
+    running_ = nullptr;
+    compiled_.notify_all();
+  }
+}
+
+} // namespace vm
+} // namespace hermes
+#endif // HERMESVM_LEAN
@@ -305,26 +305,6 @@ static CallResult<PseudoHandle<StringPrimitive>> numberToString(
 static CallResult<PseudoHandle<StringPrimitive>> numberToString(
     Runtime *runtime,
     double m) {
-  char buf8[hermes::NUMBER_TO_STRING_BUF_SIZE];
-
-  // Optimization: Fast-case for positive integers < 2^31
-  int32_t n = static_cast<int32_t>(m);
-  if (m == static_cast<double>(n) && n > 0) {
-    // Write base 10 digits in reverse from end of buf8.
-    char *p = buf8 + sizeof(buf8);
-    do {
-      *--p = '0' + (n % 10);
-      n /= 10;
-    } while (n);
-    size_t len = buf8 + sizeof(buf8) - p;
-    // Temporarily stop the propagation of removing.
-    auto result = StringPrimitive::create(runtime, ASCIIRef(p, len));
-    if (LLVM_UNLIKELY(result == ExecutionStatus::EXCEPTION)) {
-      return ExecutionStatus::EXCEPTION;
-    }
-    return createPseudoHandle(vmcast<StringPrimitive>(*result));
-  }
-
   auto getPredefined = [runtime](Predefined::Str predefinedID) {
     return createPseudoHandle(runtime->getPredefinedString(predefinedID));
   };
@@ -338,14 +318,39 @@ static CallResult<PseudoHandle<StringPrimitive>> numberToString(
   if (m == -std::numeric_limits<double>::infinity())
     return getPredefined(Predefined::NegativeInfinity);
 
-  // After special cases, run the generic routine to convert.
-  size_t len = hermes::numberToString(m, buf8, sizeof(buf8));
+  // Numbers converted again and again, like the indices of arrays used as
+  // property keys, hit the cache.
+  if (StringPrimitive *cached = runtime->getCachedNumberString(m))
+    return createPseudoHandle(cached);
+
+  char buf8[hermes::NUMBER_TO_STRING_BUF_SIZE];
+  const char *p;
+  size_t len;
+
+  // Optimization: Fast-case for positive integers < 2^31
+  int32_t n = static_cast<int32_t>(m);
+  if (m == static_cast<double>(n) && n > 0) {
+    // Write base 10 digits in reverse from end of buf8.
+    char *q = buf8 + sizeof(buf8);
+    do {
+      *--q = '0' + (n % 10);
+      n /= 10;
+    } while (n);
+    p = q;
+    len = buf8 + sizeof(buf8) - q;
+  } else {
+    // After special cases, run the generic routine to convert.
+    p = buf8;
+    len = hermes::numberToString(m, buf8, sizeof(buf8));
+  }
 
-  auto result = StringPrimitive::create(runtime, ASCIIRef(buf8, len));
+  auto result = StringPrimitive::create(runtime, ASCIIRef(p, len));
   if (LLVM_UNLIKELY(result == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  return createPseudoHandle(vmcast<StringPrimitive>(*result));
+  auto *str = vmcast<StringPrimitive>(*result);
+  runtime->cacheNumberString(m, str);
+  return createPseudoHandle(str);
 }
 
 CallResult<PseudoHandle<StringPrimitive>> toString_RJS(
@@ -393,6 +398,32 @@ double parseIntWithRadix(const StringView str, int radix) {
   return res ? res.getValue() : std::numeric_limits<double>::quiet_NaN();
 }
 
+uint32_t parseDecimalFast(const StringView str, double &result) {
+  if (str.isASCII()) {
+    const char *begin = str.castToCharPtr();
+    const char *end =
+        hermes::parseDecimalFast(begin, begin + str.length(), result);
+    return end ? end - begin : 0;
+  }
+  const char16_t *begin = str.castToChar16Ptr();
+  const char16_t *end =
+      hermes::parseDecimalFast(begin, begin + str.length(), result);
+  return end ? end - begin : 0;
+}
+
+uint32_t parseDecimalIntegerFast(const StringView str, double &result) {
+  if (str.isASCII()) {
+    const char *begin = str.castToCharPtr();
+    const char *end =
+        hermes::parseDecimalIntegerFast(begin, begin + str.length(), result);
+    return end ? end - begin : 0;
+  }
+  const char16_t *begin = str.castToChar16Ptr();
+  const char16_t *end =
+      hermes::parseDecimalIntegerFast(begin, begin + str.length(), result);
+  return end ? end - begin : 0;
+}
+
 /// ES5.1 9.3.1
 static inline double stringToNumber(
     Runtime *runtime,
@@ -438,6 +469,21 @@ static inline double stringToNumber(
   // Trim the string.
   StringView str16 = orig.slice(begin, end);
 
+  // Most numbers have few enough digits to be converted exactly here.
+  {
+    StringView digits = str16;
+    bool negative = false;
+    if (digits[0] == u'+' || digits[0] == u'-') {
+      negative = digits[0] == u'-';
+      digits = digits.slice(1);
+    }
+    double result;
+    uint32_t parsed = parseDecimalFast(digits, result);
+    if (parsed && parsed == digits.length()) {
+      return negative ? -result : result;
+    }
+  }
+
   // Slow check for special values.
   // This should only run if user created a string with extra whitespace,
   // since normal uses would get caught by the initial check.
@@ -1004,6 +1050,32 @@ addOp_RJS(Runtime *runtime, Handle<> xHandle, Handle<> yHandle) {
   return HermesValue::encodeDoubleValue(xNum + yNum);
 }
 
+CallResult<HermesValue>
+stringConcat_RJS(Runtime *runtime, PinnedHermesValue *args, uint32_t count) {
+  SafeUInt32 length;
+  bool isASCII = true;
+  for (uint32_t i = 0; i < count; ++i) {
+    if (LLVM_UNLIKELY(!args[i].isString())) {
+      auto strRes = toString_RJS(runtime, Handle<>(&args[i]));
+      if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      args[i] = strRes->getHermesValue();
+    }
+    StringPrimitive *str = args[i].getString();
+    length.add(str->getStringLength());
+    isASCII &= str->isASCII();
+  }
+
+  auto builder = StringBuilder::createStringBuilder(runtime, length, isASCII);
+  if (LLVM_UNLIKELY(builder == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  for (uint32_t i = 0; i < count; ++i)
+    builder->appendStringPrim(Handle<StringPrimitive>::vmcast(&args[i]));
+  return builder->getStringPrimitive().getHermesValue();
+}
+
 static const size_t MIN_RADIX = 2;
 static const size_t MAX_RADIX = 36;
 
@@ -13,246 +13,192 @@
 #include "hermes/VM/Operations.h"
 
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
 #define DEBUG_TYPE "serialize"
 
 namespace hermes {
 namespace vm {
-//===----------------------------------------------------------------------===//
-// class HashMapEntry
-
-VTable HashMapEntry::vt{CellKind::HashMapEntryKind, cellSize<HashMapEntry>()};
-
-void HashMapEntryBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
-  const auto *self = static_cast<const HashMapEntry *>(cell);
-  mb.addField("key", &self->key);
-  mb.addField("value", &self->value);
-  mb.addField("prevIterationEntry", &self->prevIterationEntry);
-  mb.addField("nextIterationEntry", &self->nextIterationEntry);
-  mb.addField("nextEntryInBucket", &self->nextEntryInBucket);
-}
-
-#ifdef HERMESVM_SERIALIZE
-HashMapEntry::HashMapEntry(Deserializer &d)
-    : GCCell(&d.getRuntime()->getHeap(), &vt) {
-  d.readHermesValue(&key);
-  d.readHermesValue(&value);
-  d.readRelocation(&prevIterationEntry, RelocationKind::GCPointer);
-  d.readRelocation(&nextIterationEntry, RelocationKind::GCPointer);
-  d.readRelocation(&nextEntryInBucket, RelocationKind::GCPointer);
-}
-
-void HashMapEntrySerialize(Serializer &s, const GCCell *cell) {
-  auto *self = vmcast<const HashMapEntry>(cell);
-  s.writeHermesValue(self->key);
-  s.writeHermesValue(self->value);
-  s.writeRelocation(self->prevIterationEntry.get(s.getRuntime()));
-  s.writeRelocation(self->nextIterationEntry.get(s.getRuntime()));
-  s.writeRelocation(self->nextEntryInBucket.get(s.getRuntime()));
-  s.endObject(cell);
-}
-
-void HashMapEntryDeserialize(Deserializer &d, CellKind kind) {
-  assert(kind == CellKind::HashMapEntryKind && "Expected HashMapEntry");
-  void *mem = d.getRuntime()->alloc(cellSize<HashMapEntry>());
-  auto *cell = new (mem) HashMapEntry(d);
-  d.endObject(cell);
-}
-#endif
-
-CallResult<HermesValue> HashMapEntry::create(Runtime *runtime) {
-  void *mem = runtime->alloc(cellSize<HashMapEntry>());
-  return HermesValue::encodeObjectValue(new (mem) HashMapEntry(runtime));
-}
-
 //===----------------------------------------------------------------------===//
 // class OrderedHashMap
 
+constexpr uint32_t OrderedHashMap::kEmptySlot;
+constexpr uint32_t OrderedHashMap::INITIAL_CAPACITY;
+
 VTable OrderedHashMap::vt{CellKind::OrderedHashMapKind,
-                          cellSize<OrderedHashMap>()};
+                          cellSize<OrderedHashMap>(),
+                          _finalizeImpl,
+                          nullptr,
+                          _mallocSizeImpl};
 
 void OrderedHashMapBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
   const auto *self = static_cast<const OrderedHashMap *>(cell);
-  mb.addField("hashTable", &self->hashTable_);
-  mb.addField("firstIterationEntry", &self->firstIterationEntry_);
-  mb.addField("lastIterationEntry", &self->lastIterationEntry_);
+  mb.addField("entries", &self->entries_);
+  mb.addField("epoch", &self->epoch_);
 }
 
 #ifdef HERMESVM_SERIALIZE
 OrderedHashMap::OrderedHashMap(Deserializer &d)
     : GCCell(&d.getRuntime()->getHeap(), &vt) {
-  if (d.readInt<uint8_t>()) {
-    hashTable_.set(
-        d.getRuntime(),
-        ArrayStorage::deserializeArrayStorage(d),
-        &d.getRuntime()->getHeap());
-  }
-
-  d.readRelocation(&firstIterationEntry_, RelocationKind::GCPointer);
-  d.readRelocation(&lastIterationEntry_, RelocationKind::GCPointer);
-  capacity_ = d.readInt<uint32_t>();
+  d.readRelocation(&entries_, RelocationKind::GCPointer);
+  d.readRelocation(&epoch_, RelocationKind::GCPointer);
   size_ = d.readInt<uint32_t>();
+  index_.resize(d.readInt<uint32_t>());
+  for (IndexSlot &slot : index_) {
+    slot.entry = d.readInt<uint32_t>();
+    slot.hash = d.readInt<uint32_t>();
+  }
 }
 
 void OrderedHashMapSerialize(Serializer &s, const GCCell *cell) {
   auto *self = vmcast<const OrderedHashMap>(cell);
-  // If we have an ArrayStorage, it doesn't store any native pointers. Serialize
-  // it here.
-  bool hasArray = (bool)self->hashTable_;
-  s.writeInt<uint8_t>(hasArray);
-  if (hasArray) {
-    ArrayStorage::serializeArrayStorage(
-        s, self->hashTable_.get(s.getRuntime()));
-  }
-
-  s.writeRelocation(self->firstIterationEntry_.get(s.getRuntime()));
-  s.writeRelocation(self->lastIterationEntry_.get(s.getRuntime()));
-  s.writeInt<uint32_t>(self->capacity_);
+  s.writeRelocation(self->entries_.get(s.getRuntime()));
+  s.writeRelocation(self->epoch_.get(s.getRuntime()));
   s.writeInt<uint32_t>(self->size_);
+  s.writeInt<uint32_t>(self->index_.size());
+  for (const auto &slot : self->index_) {
+    s.writeInt<uint32_t>(slot.entry);
+    s.writeInt<uint32_t>(slot.hash);
+  }
 
   s.endObject(cell);
 }
 
 void OrderedHashMapDeserialize(Deserializer &d, CellKind kind) {
   assert(kind == CellKind::OrderedHashMapKind && "ExpectedOrderedHashMap");
-  void *mem = d.getRuntime()->alloc(cellSize<OrderedHashMap>());
+  void *mem = d.getRuntime()->alloc</*fixedSize*/ true, HasFinalizer::Yes>(
+      cellSize<OrderedHashMap>());
   auto *cell = new (mem) OrderedHashMap(d);
 
   d.endObject(cell);
 }
 #endif
 
-OrderedHashMap::OrderedHashMap(
-    Runtime *runtime,
-    Handle<ArrayStorage> hashTableStorage)
+OrderedHashMap::OrderedHashMap(Runtime *runtime, Handle<SegmentedArray> entries)
     : GCCell(&runtime->getHeap(), &vt),
-      hashTable_(runtime, hashTableStorage.get(), &runtime->getHeap()) {}
+      entries_(runtime, entries.get(), &runtime->getHeap()),
+      index_(INITIAL_CAPACITY, IndexSlot{kEmptySlot, 0}) {}
 
 CallResult<HermesValue> OrderedHashMap::create(Runtime *runtime) {
-  auto arrRes =
-      ArrayStorage::create(runtime, INITIAL_CAPACITY, INITIAL_CAPACITY);
+  auto arrRes = SegmentedArray::create(runtime, INITIAL_CAPACITY);
   if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto hashTableStorage = runtime->makeHandle<ArrayStorage>(*arrRes);
+  auto entries = runtime->makeHandle<SegmentedArray>(*arrRes);
 
-  void *mem = runtime->alloc(cellSize<OrderedHashMap>());
+  void *mem = runtime->alloc</*fixedSize*/ true, HasFinalizer::Yes>(
+      cellSize<OrderedHashMap>());
   return HermesValue::encodeObjectValue(
-      new (mem) OrderedHashMap(runtime, hashTableStorage));
+      new (mem) OrderedHashMap(runtime, entries));
 }
 
-void OrderedHashMap::removeLinkedListNode(
-    Runtime *runtime,
-    HashMapEntry *entry,
-    GC *gc) {
-  assert(
-      entry != lastIterationEntry_.get(runtime) &&
-      "Cannot remove the last entry");
-  if (entry->prevIterationEntry) {
-    entry->prevIterationEntry.get(runtime)->nextIterationEntry.set(
-        runtime, entry->nextIterationEntry, gc);
-  }
-  if (entry->nextIterationEntry) {
-    entry->nextIterationEntry.get(runtime)->prevIterationEntry.set(
-        runtime, entry->prevIterationEntry, gc);
-  }
-  if (entry == firstIterationEntry_.get(runtime)) {
-    firstIterationEntry_.set(runtime, entry->nextIterationEntry, gc);
+uint32_t OrderedHashMap::indexCapacityFor(uint32_t numEntries) {
+  // Keep the load factor at most 1/2, counting the next entry, so that the
+  // probes stay short and always reach an empty slot.
+  uint64_t capacity = llvm::PowerOf2Ceil(2 * (uint64_t)numEntries + 2);
+  assert(capacity <= UINT32_MAX && "index table too large");
+  return std::max((uint32_t)capacity, INITIAL_CAPACITY);
+}
+
+OptValue<uint32_t> OrderedHashMap::lookup(
+    PointerBase *base,
+    uint32_t hash,
+    HermesValue key) const {
+  const SegmentedArray *entries = entries_.getNonNull(base);
+  const uint32_t mask = index_.size() - 1;
+  for (uint32_t i = hash & mask;; i = (i + 1) & mask) {
+    const IndexSlot &slot = index_[i];
+    if (slot.entry == kEmptySlot)
+      return llvm::None;
+    if (slot.hash == hash) {
+      HermesValue entryKey = entries->at(slot.entry * 2);
+      // Tombstones have an empty key, which matches no key.
+      if (!entryKey.isEmpty() && isSameValueZero(entryKey, key))
+        return i;
+    }
   }
-  entry->prevIterationEntry = nullptr;
 }
 
-HashMapEntry *OrderedHashMap::lookupInBucket(
-    Runtime *runtime,
-    uint32_t bucket,
-    HermesValue key) {
+void OrderedHashMap::rebuildIndex(
+    PointerBase *base,
+    uint32_t capacity,
+    llvm::ArrayRef<uint32_t> newIndexOf) {
   assert(
-      hashTable_.get(runtime)->size() == capacity_ && "Inconsistent capacity");
-  auto *entry = dyn_vmcast<HashMapEntry>(hashTable_.get(runtime)->at(bucket));
-  while (entry && !isSameValueZero(entry->key, key)) {
-    entry = entry->nextEntryInBucket.get(runtime);
+      (capacity & (capacity - 1)) == 0 && "capacity must be power of 2");
+  const SegmentedArray *entries = entries_.getNonNull(base);
+  std::vector<IndexSlot> index(capacity, IndexSlot{kEmptySlot, 0});
+  const uint32_t mask = capacity - 1;
+  // Every entry that is not deleted has exactly one slot in the old table,
+  // which also holds its hash.
+  for (const IndexSlot &slot : index_) {
+    if (slot.entry == kEmptySlot)
+      continue;
+    uint32_t entry = slot.entry;
+    if (!newIndexOf.empty()) {
+      entry = newIndexOf[entry];
+      if (entry == kEmptySlot)
+        continue;
+    } else if (entries->at(entry * 2).isEmpty()) {
+      continue;
+    }
+    uint32_t i = slot.hash & mask;
+    while (index[i].entry != kEmptySlot)
+      i = (i + 1) & mask;
+    index[i] = IndexSlot{entry, slot.hash};
   }
-  return entry;
+  index_ = std::move(index);
 }
 
-ExecutionStatus OrderedHashMap::rehashIfNecessary(
+ExecutionStatus OrderedHashMap::compact(
     Handle<OrderedHashMap> self,
     Runtime *runtime) {
-  uint32_t newCapacity = self->capacity_;
-  // NOTE: we have ensured that self->capacity_ * 4 never overflows uint32_t by
-  // setting MAX_CAPACITY to the apropriate value. self->size_ is always <=
-  // self->capacity_, so this applies to self->size_ as well.
-  static_assert(
-      MAX_CAPACITY < UINT32_MAX / 4,
-      "Avoid overflow checks on multiplying capacity by 4");
-  if (self->size_ * 4 > self->capacity_ * 3) {
-    // Load factor is more than 0.75, need to increase the capacity.
-    newCapacity = self->capacity_ * 2;
-    if (LLVM_UNLIKELY(newCapacity > MAX_CAPACITY)) {
-      // We maintain the invariant that the capacity_ is a power of two.
-      // Therefore, if doubling would exceed the max, we revert to the
-      // previous value.  (Assert the invariant to make it clear.)
-      assert(
-          (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-          "capacity_ must be power of 2");
-      newCapacity = self->capacity_;
+  // Allocate the record of the epoch being ended first, so that failing
+  // leaves the map as it was.
+  MutableHandle<SegmentedArray> survivors{runtime};
+  if (self->epoch_) {
+    auto epochRes = ArrayStorage::create(runtime, 1, 1);
+    if (LLVM_UNLIKELY(epochRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
-  } else if (
-      self->size_ * 4 < self->capacity_ && self->capacity_ > INITIAL_CAPACITY) {
-    // Load factor is less than 0.25, and we are not at initial cap.
-    newCapacity = self->capacity_ / 2;
-  }
-  if (newCapacity == self->capacity_) {
-    // No need to rehash.
-    return ExecutionStatus::RETURNED;
-  }
-  assert(
-      self->size_ && self->firstIterationEntry_ && self->lastIterationEntry_ &&
-      "We should never be rehashing when there are no elements");
-
-  // Set new capacity first to update the hash function.
-  self->capacity_ = newCapacity;
-
-  // Create a new hash table.
-  auto arrRes = ArrayStorage::create(runtime, newCapacity, newCapacity);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
+    auto nextEpoch = runtime->makeHandle<ArrayStorage>(*epochRes);
+    auto arrRes =
+        SegmentedArray::create(runtime, self->size_ + 1, self->size_ + 1);
+    if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    survivors = vmcast<SegmentedArray>(*arrRes);
+    survivors->at(0).set(nextEpoch.getHermesValue(), &runtime->getHeap());
   }
-  auto newHashTable = runtime->makeHandle<ArrayStorage>(*arrRes);
-
-  // Now re-add all entries to the hash table.
-  MutableHandle<HashMapEntry> entry{runtime};
-  MutableHandle<HashMapEntry> oldNextInBucket{runtime};
-  MutableHandle<> keyHandle{runtime};
-  GCScopeMarkerRAII marker{runtime};
-  for (unsigned i = 0, len = self->hashTable_.get(runtime)->size(); i < len;
-       ++i) {
-    entry = dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(i));
-    while (entry) {
-      marker.flush();
-      keyHandle = entry->key;
-      uint32_t bucket = hashToBucket(self, runtime, keyHandle);
-      oldNextInBucket = entry->nextEntryInBucket.get(runtime);
-      if (newHashTable->at(bucket).isEmpty()) {
-        // Empty bucket.
-        entry->nextEntryInBucket = nullptr;
-      } else {
-        // There are already a bucket head.
-        entry->nextEntryInBucket.set(
-            runtime,
-            vmcast<HashMapEntry>(newHashTable->at(bucket)),
-            &runtime->getHeap());
-      }
-      // Update bucket head to the new entry.
-      newHashTable->at(bucket).set(entry.getHermesValue(), &runtime->getHeap());
 
-      entry = *oldNextInBucket;
+  // Move the entries that are not deleted down over the tombstones.
+  SegmentedArray *entries = self->entries_.getNonNull(runtime);
+  const uint32_t numEntries = entries->size() / 2;
+  std::vector<uint32_t> newIndexOf(numEntries, kEmptySlot);
+  uint32_t live = 0;
+  for (uint32_t i = 0; i < numEntries; ++i) {
+    if (entries->at(i * 2).isEmpty())
+      continue;
+    if (survivors) {
+      survivors->at(live + 1).setNonPtr(HermesValue::encodeNumberValue(i));
     }
+    if (live != i) {
+      entries->at(live * 2).set(entries->at(i * 2), &runtime->getHeap());
+      entries->at(live * 2 + 1).set(
+          entries->at(i * 2 + 1), &runtime->getHeap());
+    }
+    newIndexOf[i] = live++;
+  }
+  assert(live == self->size_ && "Inconsistent size");
+  SegmentedArray::resizeWithinCapacity(
+      createPseudoHandle(entries), runtime, live * 2);
+  self->rebuildIndex(runtime, indexCapacityFor(live), newIndexOf);
+
+  // End the current epoch.
+  if (survivors) {
+    auto *nextEpoch = vmcast<ArrayStorage>(survivors->at(0));
+    self->epoch_.getNonNull(runtime)->at(0).set(
+        survivors.getHermesValue(), &runtime->getHeap());
+    self->epoch_.set(runtime, nextEpoch, &runtime->getHeap());
   }
-
-  self->hashTable_.set(runtime, newHashTable.get(), &runtime->getHeap());
-  assert(
-      self->hashTable_.get(runtime)->size() == self->capacity_ &&
-      "Inconsistent capacity");
   return ExecutionStatus::RETURNED;
 }
 
@@ -260,27 +206,20 @@ bool OrderedHashMap::has(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
-}
-
-HashMapEntry *OrderedHashMap::find(
-    Handle<OrderedHashMap> self,
-    Runtime *runtime,
-    Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
+  uint32_t hash = hashKey(runtime, key);
+  return self->lookup(runtime, hash, key.getHermesValue()).hasValue();
 }
 
 HermesValue OrderedHashMap::get(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  auto *entry = find(self, runtime, key);
-  if (!entry) {
+  uint32_t hash = hashKey(runtime, key);
+  auto slot = self->lookup(runtime, hash, key.getHermesValue());
+  if (!slot) {
     return HermesValue::encodeUndefinedValue();
   }
-  return entry->value;
+  return self->getValue(runtime, self->index_[*slot].entry);
 }
 
 ExecutionStatus OrderedHashMap::insert(
@@ -288,158 +227,145 @@ ExecutionStatus OrderedHashMap::insert(
     Runtime *runtime,
     Handle<> key,
     Handle<> value) {
-  uint32_t bucket = hashToBucket(self, runtime, key);
-  if (auto *entry =
-          self->lookupInBucket(runtime, bucket, key.getHermesValue())) {
+  uint32_t hash = hashKey(runtime, key);
+  if (auto slot = self->lookup(runtime, hash, key.getHermesValue())) {
     // Element already exists, update value and return.
-    entry->value.set(value.get(), &runtime->getHeap());
+    uint32_t entry = self->index_[*slot].entry;
+    self->entries_.getNonNull(runtime)->at(entry * 2 + 1).set(
+        value.get(), &runtime->getHeap());
     return ExecutionStatus::RETURNED;
   }
-  // Create a new entry, set the key and value.
-  auto crtRes = HashMapEntry::create(runtime);
-  if (LLVM_UNLIKELY(crtRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
+
+  // Make room for the new entry in the index table.
+  uint32_t numEntries = self->numEntries(runtime);
+  if ((uint64_t)numEntries * 2 + 2 > self->index_.size()) {
+    if (self->size_ * 2 <= numEntries) {
+      // At least half of the entries are tombstones, drop them instead.
+      if (LLVM_UNLIKELY(compact(self, runtime) == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+    } else {
+      self->rebuildIndex(runtime, self->index_.size() * 2, {});
+    }
+    numEntries = self->numEntries(runtime);
   }
-  auto newMapEntry = runtime->makeHandle<HashMapEntry>(*crtRes);
-  newMapEntry->key.set(key.get(), &runtime->getHeap());
-  newMapEntry->value.set(value.get(), &runtime->getHeap());
-  auto *curBucketFront =
-      dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(bucket));
-  if (curBucketFront) {
-    // If the bucket we are inserting to is not empty, we maintain the
-    // linked list properly.
-    newMapEntry->nextEntryInBucket.set(
-        runtime, curBucketFront, &runtime->getHeap());
+
+  // Append the entry.
+  MutableHandle<SegmentedArray> entries{runtime,
+                                        self->entries_.getNonNull(runtime)};
+  if (LLVM_UNLIKELY(
+          SegmentedArray::resize(entries, runtime, numEntries * 2 + 2) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
   }
-  // Set the newly inserted entry as the front of this bucket chain.
-  self->hashTable_.get(runtime)->at(bucket).set(
-      newMapEntry.getHermesValue(), &runtime->getHeap());
-
-  if (!self->firstIterationEntry_) {
-    // If we are inserting the first ever element, update
-    // first iteration entry pointer.
-    self->firstIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-  } else {
-    // Connect the new entry with the last entry.
-    self->lastIterationEntry_.get(runtime)->nextIterationEntry.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-    newMapEntry->prevIterationEntry.set(
-        runtime, self->lastIterationEntry_, &runtime->getHeap());
-
-    HashMapEntry *previousLastEntry = self->lastIterationEntry_.get(runtime);
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-
-    if (previousLastEntry && previousLastEntry->isDeleted()) {
-      // If the last entry was a deleted entry, we no longer need to keep it.
-      self->removeLinkedListNode(
-          runtime, previousLastEntry, &runtime->getHeap());
-    }
+  self->entries_.set(runtime, entries.get(), &runtime->getHeap());
+  entries->at(numEntries * 2).set(key.get(), &runtime->getHeap());
+  entries->at(numEntries * 2 + 1).set(value.get(), &runtime->getHeap());
+
+  // Index it in the first slot that is empty or refers to a tombstone.
+  const uint32_t mask = self->index_.size() - 1;
+  uint32_t i = hash & mask;
+  while (self->index_[i].entry != kEmptySlot &&
+         !entries->at(self->index_[i].entry * 2).isEmpty()) {
+    i = (i + 1) & mask;
   }
+  self->index_[i] = IndexSlot{numEntries, hash};
 
   self->size_++;
-  return self->rehashIfNecessary(self, runtime);
+  return ExecutionStatus::RETURNED;
 }
 
 bool OrderedHashMap::erase(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  uint32_t bucket = hashToBucket(self, runtime, key);
-  HashMapEntry *prevEntry = nullptr;
-  auto *entry =
-      dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(bucket));
-  while (entry && !isSameValueZero(entry->key, key.getHermesValue())) {
-    prevEntry = entry;
-    entry = entry->nextEntryInBucket.get(runtime);
-  }
-  if (!entry) {
+  uint32_t hash = hashKey(runtime, key);
+  auto slot = self->lookup(runtime, hash, key.getHermesValue());
+  if (!slot) {
     // Element does not exist.
     return false;
   }
 
-  if (prevEntry) {
-    // The entry we are deleting has a previous entry, update the link.
-    prevEntry->nextEntryInBucket.set(
-        runtime, entry->nextEntryInBucket, &runtime->getHeap());
-  } else {
-    // The entry we are erasing is the front entry in the bucket, we need
-    // to update the bucket head to the next entry in the bucket, if not
-    // any, set to empty value.
-    self->hashTable_.get(runtime)->at(bucket).set(
-        entry->nextEntryInBucket ? HermesValue::encodeObjectValue(
-                                       entry->nextEntryInBucket.get(runtime))
-                                 : HermesValue::encodeEmptyValue(),
-        &runtime->getHeap());
-  }
-
-  entry->markDeleted();
+  // Leave a tombstone. Its index slot is kept, so that the lookups probing
+  // past it carry on.
+  SegmentedArray *entries = self->entries_.getNonNull(runtime);
+  uint32_t entry = self->index_[*slot].entry;
+  entries->at(entry * 2).setNonPtr(HermesValue::encodeEmptyValue());
+  entries->at(entry * 2 + 1).setNonPtr(HermesValue::encodeEmptyValue());
   self->size_--;
 
-  // Now delete the entry from the iteration linked list.
-  // If we are deleting the last entry, don't remove it from the list yet.
-  // This will ensure that if any iterator out there is currently pointing to
-  // this entry, it will be able to follow on if we add new entries in the
-  // future.
-  if (entry != self->lastIterationEntry_.get(runtime)) {
-    self->removeLinkedListNode(runtime, entry, &runtime->getHeap());
+  // Release the memory of the deleted entries once they are most of the map.
+  // Failing to is harmless, the next insertion will try again.
+  uint32_t numEntries = self->numEntries(runtime);
+  if (numEntries > INITIAL_CAPACITY && self->size_ * 4 < numEntries) {
+    (void)compact(self, runtime);
   }
 
-  self->rehashIfNecessary(self, runtime);
-
   return true;
 }
 
-HashMapEntry *OrderedHashMap::iteratorNext(
+CallResult<bool> OrderedHashMap::iteratorNext(
+    Handle<OrderedHashMap> self,
     Runtime *runtime,
-    HashMapEntry *entry) const {
-  if (entry == nullptr) {
-    // Starting a new iteration from the first entry.
-    entry = firstIterationEntry_.get(runtime);
-  } else {
-    // Advance to the next entry.
-    entry = entry->nextIterationEntry.get(runtime);
+    MutableHandle<ArrayStorage> &epoch,
+    uint32_t &index) {
+  if (!epoch) {
+    // Starting a new iteration from the first entry. From now on, compactions
+    // must record how they move the entries.
+    if (!self->epoch_) {
+      auto arrRes = ArrayStorage::create(runtime, 1, 1);
+      if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      self->epoch_.set(
+          runtime, vmcast<ArrayStorage>(*arrRes), &runtime->getHeap());
+    }
+    epoch = self->epoch_.getNonNull(runtime);
+    index = 0;
   }
 
-  // Make sure the entry we returned (if not nullptr) must not be deleted.
-  while (entry && entry->isDeleted()) {
-    entry = entry->nextIterationEntry.get(runtime);
+  // Follow the compactions since the epoch of the position. The entries
+  // before it that survived a compaction come before it after the compaction.
+  while (!epoch->at(0).isEmpty()) {
+    auto *survivors = vmcast<SegmentedArray>(epoch->at(0));
+    uint32_t lo = 1, hi = survivors->size();
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (survivors->at(mid).getNumber() < index)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    index = lo - 1;
+    epoch = vmcast<ArrayStorage>(survivors->at(0));
   }
-  return entry;
+  assert(
+      epoch.get() == self->epoch_.get(runtime) &&
+      "Position should be in the current epoch");
+
+  // Skip the tombstones.
+  const SegmentedArray *entries = self->entries_.getNonNull(runtime);
+  const uint32_t numEntries = entries->size() / 2;
+  while (index < numEntries && entries->at(index * 2).isEmpty())
+    ++index;
+  return index < numEntries;
 }
 
-void OrderedHashMap::clear(Runtime *runtime) {
-  if (!firstIterationEntry_) {
+ExecutionStatus OrderedHashMap::clear(
+    Handle<OrderedHashMap> self,
+    Runtime *runtime) {
+  if (!self->size_) {
     // Empty set.
-    return;
+    return ExecutionStatus::RETURNED;
   }
 
-  // Clear the hash table.
-  for (unsigned i = 0; i < capacity_; ++i) {
-    auto entry = dyn_vmcast<HashMapEntry>(hashTable_.get(runtime)->at(i));
-    // Delete every element reachable from the hash table.
-    while (entry) {
-      entry->markDeleted();
-      entry = entry->nextEntryInBucket.get(runtime);
-    }
-    // Clear every element in the hash table.
-    hashTable_.get(runtime)->at(i).setNonPtr(HermesValue::encodeEmptyValue());
+  // Delete every entry, and drop them all. Iterators then continue with the
+  // entries inserted after the clear.
+  SegmentedArray *entries = self->entries_.getNonNull(runtime);
+  for (uint32_t i = 0, e = entries->size(); i < e; ++i) {
+    entries->at(i).setNonPtr(HermesValue::encodeEmptyValue());
   }
-  // Resize the hash table to the initial size.
-  ArrayStorage::resizeWithinCapacity(
-      createPseudoHandle(hashTable_.get(runtime)), runtime, INITIAL_CAPACITY);
-  capacity_ = INITIAL_CAPACITY;
-
-  // After clearing, we will still keep the last deleted entry
-  // in case there is an iterator out there
-  // pointing to the middle of the iteration chain. We need it to be
-  // able to merge back eventually.
-  firstIterationEntry_.set(runtime, lastIterationEntry_, &runtime->getHeap());
-  firstIterationEntry_.get(runtime)->prevIterationEntry = nullptr;
-  size_ = 0;
+  self->size_ = 0;
+  return compact(self, runtime);
 }
 
 } // namespace vm
@@ -247,12 +247,26 @@ CallResult<HermesValue> JSStringIterator::create(
 CallResult<HermesValue> JSStringIterator::nextElement(
     Handle<JSStringIterator> self,
     Runtime *runtime) {
+  MutableHandle<> value{runtime};
+  auto nextRes = nextValue(self, runtime, value);
+  if (LLVM_UNLIKELY(nextRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // Return CreateIterResultObject(resultString, false), or
+  // CreateIterResultObject(undefined, true) at the end.
+  return createIterResultObject(runtime, value, !*nextRes).getHermesValue();
+}
+
+CallResult<bool> JSStringIterator::nextValue(
+    Handle<JSStringIterator> self,
+    Runtime *runtime,
+    MutableHandle<> &value) {
+  value = HermesValue::encodeUndefinedValue();
   // 4. Let s be the value of the [[IteratedString]] internal slot of O.
   auto s = runtime->makeHandle(self->iteratedString_);
   if (!s) {
     // 5. If s is undefined, return CreateIterResultObject(undefined, true).
-    return createIterResultObject(runtime, Runtime::getUndefinedValue(), true)
-        .getHermesValue();
+    return false;
   }
 
   // 6. Let position be the value of the [[StringIteratorNextIndex]] internal
@@ -266,8 +280,7 @@ CallResult<HermesValue> JSStringIterator::nextElement(
     // undefined.
     self->iteratedString_ = nullptr;
     // 8b. Return CreateIterResultObject(undefined, true).
-    return createIterResultObject(runtime, Runtime::getUndefinedValue(), true)
-        .getHermesValue();
+    return false;
   }
 
   MutableHandle<StringPrimitive> resultString{runtime};
@@ -302,7 +315,8 @@ CallResult<HermesValue> JSStringIterator::nextElement(
   self->nextIndex_ = position + resultString->getStringLength();
 
   // 14. Return CreateIterResultObject(resultString, false).
-  return createIterResultObject(runtime, resultString, false).getHermesValue();
+  value = resultString.getHermesValue();
+  return true;
 }
 
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _WINDOWS
+
+#include "hermes/VM/Profiler/AllocationProfiler.h"
+
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/VM/JSNativeFunctions.h"
+#include "hermes/VM/RuntimeModule-inline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace hermes {
+namespace vm {
+
+AllocationProfiler::AllocationProfiler(
+    Runtime *runtime,
+    uint64_t samplingInterval)
+    : runtime_(runtime),
+      samplingInterval_(samplingInterval),
+      randomEngine_(std::random_device()()),
+      distanceDistribution_(1.0 / samplingInterval) {
+  assert(samplingInterval > 0 && "Sampling interval must be positive");
+}
+
+int64_t AllocationProfiler::nextSampleDistance() {
+  return 1 + static_cast<int64_t>(distanceDistribution_(randomEngine_));
+}
+
+void AllocationProfiler::recordSample(const void *mem, uint32_t size) {
+  uint32_t depth = runtime_->getSamplingProfiler()->captureStack(
+      runtime_, stackStorage_);
+
+  // An allocation of size bytes is sampled with probability
+  // 1 - e^(-size / samplingInterval_), so each sample stands for the bytes of
+  // 1 / probability such allocations.
+  double probability = -std::expm1(-(double)size / samplingInterval_);
+  uint64_t estimate = static_cast<uint64_t>(size / probability);
+
+  // Leaf frame is in stack[0], so walk backward from the root.
+  uint32_t node = kRoot;
+  for (uint32_t i = depth; i-- > 0;) {
+    const SamplingProfiler::StackFrame &frame = stackStorage_.stack[i];
+    uint32_t nextIndex = nodes_.size();
+    auto result = nodeIndex_.insert(
+        {SamplingProfiler::getCallTreeKey(node, frame), nextIndex});
+    if (result.second) {
+      nodes_.push_back(Node{frame, node, 0});
+    }
+    node = result.first->second;
+  }
+  (node == kRoot ? rootAllocatedBytes_ : nodes_[node].allocatedBytes) +=
+      estimate;
+
+  // Tracking the object's id makes the GC report its moves and death.
+  HeapSnapshot::NodeID objectID =
+      runtime_->getHeap().getIDTracker().getObjectID(mem);
+  samples_.push_back(Sample{objectID, node, estimate, nextOrdinal_++});
+}
+
+/// Emit the "callFrame" of \p frame, or of the root if it is null.
+static void emitCallFrame(
+    JSONEmitter &json,
+    const SamplingProfiler::StackFrame *frame) {
+  std::string functionName = "(root)";
+  std::string url;
+  // Chrome numbers lines and columns from 0, and uses -1 for unknown.
+  int64_t line = -1;
+  int64_t column = -1;
+  if (frame) {
+    switch (frame->kind) {
+      case SamplingProfiler::StackFrame::FrameKind::JSFunction: {
+        hbc::BCProvider *bcProvider = frame->jsFrame.module->getBytecode();
+        uint32_t funcId = frame->jsFrame.functionId;
+        functionName =
+            bcProvider
+                ->getStringRefFromID(
+                    bcProvider->getFunctionHeader(funcId).functionName())
+                .str();
+        const hbc::DebugOffsets *debugOffsets =
+            bcProvider->getDebugOffsets(funcId);
+        if (debugOffsets != nullptr &&
+            debugOffsets->sourceLocations != hbc::DebugOffsets::NO_OFFSET) {
+          OptValue<hbc::DebugSourceLocation> locOpt =
+              bcProvider->getDebugInfo()->getLocationForAddress(
+                  debugOffsets->sourceLocations, frame->jsFrame.offset);
+          if (locOpt.hasValue()) {
+            const hbc::DebugSourceLocation &loc = locOpt.getValue();
+            url = bcProvider->getDebugInfo()->getFilenameByID(loc.filenameId);
+            line = static_cast<int64_t>(loc.line) - 1;
+            column = static_cast<int64_t>(loc.column) - 1;
+          }
+        }
+        break;
+      }
+
+      case SamplingProfiler::StackFrame::FrameKind::NativeFunction:
+        functionName =
+            std::string("[Native] ") + getFunctionName(frame->nativeFrame);
+        break;
+
+      case SamplingProfiler::StackFrame::FrameKind::FinalizableNativeFunction:
+        functionName = "[HostFunction]";
+        break;
+
+      case SamplingProfiler::StackFrame::FrameKind::GCFrame:
+        functionName = "(garbage collector)";
+        break;
+
+      default:
+        llvm_unreachable("Unknown frame kind");
+    }
+  }
+
+  json.emitKey("callFrame");
+  json.openDict();
+  json.emitKeyValue("functionName", functionName);
+  json.emitKeyValue("scriptId", "0");
+  json.emitKeyValue("url", url);
+  json.emitKeyValue("lineNumber", line);
+  json.emitKeyValue("columnNumber", column);
+  json.closeDict();
+}
+
+void AllocationProfiler::serialize(llvm::raw_ostream &OS) {
+  // Find out which sampled objects are still alive: the GC stops tracking the
+  // ids of the objects it frees.
+  llvm::DenseMap<HeapSnapshot::NodeID, bool> alive;
+  for (const Sample &sample : samples_) {
+    alive[sample.objectID] = false;
+  }
+  runtime_->getHeap().getIDTracker().forEachID(
+      [&alive](const void *, HeapSnapshot::NodeID id) {
+        auto it = alive.find(id);
+        if (it != alive.end()) {
+          it->second = true;
+        }
+      });
+  samples_.erase(
+      std::remove_if(
+          samples_.begin(),
+          samples_.end(),
+          [&alive](const Sample &sample) { return !alive[sample.objectID]; }),
+      samples_.end());
+
+  // Index 0 is the root, followed by the nodes in order; kRoot + 1 wraps
+  // around to the root's index.
+  std::vector<uint64_t> liveBytes(nodes_.size() + 1);
+  std::vector<std::vector<uint32_t>> children(nodes_.size() + 1);
+  for (const Sample &sample : samples_) {
+    liveBytes[sample.node + 1] += sample.size;
+  }
+  for (uint32_t i = 0, e = nodes_.size(); i < e; ++i) {
+    children[nodes_[i].parent + 1].push_back(i + 1);
+  }
+
+  JSONEmitter json(OS);
+  json.openDict();
+  json.emitKey("head");
+  // Chrome node ids start at 1.
+  std::function<void(uint32_t)> emitNode = [&](uint32_t index) {
+    json.openDict();
+    emitCallFrame(json, index == 0 ? nullptr : &nodes_[index - 1].frame);
+    json.emitKeyValue("selfSize", liveBytes[index]);
+    json.emitKeyValue(
+        "allocatedSize",
+        index == 0 ? rootAllocatedBytes_ : nodes_[index - 1].allocatedBytes);
+    json.emitKeyValue("id", index + 1);
+    json.emitKey("children");
+    json.openArray();
+    for (uint32_t child : children[index]) {
+      emitNode(child);
+    }
+    json.closeArray();
+    json.closeDict();
+  };
+  emitNode(0);
+
+  json.emitKey("samples");
+  json.openArray();
+  for (const Sample &sample : samples_) {
+    json.openDict();
+    json.emitKeyValue("size", sample.size);
+    json.emitKeyValue("nodeId", sample.node + 2);
+    json.emitKeyValue("ordinal", sample.ordinal);
+    json.closeDict();
+  }
+  json.closeArray();
+  json.closeDict();
+}
+
+} // namespace vm
+} // namespace hermes
+
+#endif // not _WINDOWS
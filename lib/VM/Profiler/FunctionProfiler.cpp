@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/Profiler/FunctionProfiler.h"
+
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/RuntimeModule-inline.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+
+FunctionProfiler::FunctionProfiler(Runtime *runtime) : runtime_(runtime) {}
+
+uint32_t FunctionProfiler::getFunction(CodeBlock *codeBlock) {
+  auto result = functionIndex_.insert({codeBlock, (uint32_t)functions_.size()});
+  if (!result.second)
+    return result.first->second;
+
+  // The name is resolved now, since the code block may be freed before the
+  // profile is written.
+  std::string name;
+  llvm::raw_string_ostream OS(name);
+  std::string funcName = codeBlock->getNameString(runtime_);
+  OS << (funcName.empty() ? "(anonymous)" : funcName);
+  hbc::BCProvider *bcProvider = codeBlock->getRuntimeModule()->getBytecode();
+  OptValue<hbc::DebugSourceLocation> loc = codeBlock->getSourceLocation();
+  if (loc.hasValue()) {
+    OS << "("
+       << bcProvider->getDebugInfo()->getFilenameByID(loc.getValue().filenameId)
+       << ":" << loc.getValue().line << ":" << loc.getValue().column << ")";
+  } else {
+    // Without debug info, the virtual offset can be symbolicated with a
+    // source map.
+    OS << "("
+       << bcProvider->getVirtualOffsetForFunction(codeBlock->getFunctionID())
+       << ")";
+  }
+  OS.flush();
+  // ';' separates the frames of a folded stack.
+  std::replace(name.begin(), name.end(), ';', ',');
+  functions_.emplace_back(std::move(name));
+  return result.first->second;
+}
+
+void FunctionProfiler::enter(
+    CodeBlock *codeBlock,
+    const PinnedHermesValue *frame) {
+  TimePoint wallNow = std::chrono::steady_clock::now();
+  std::chrono::microseconds cpuNow = oscompat::thread_cpu_time();
+  uint32_t function = getFunction(codeBlock);
+  while (!stack_.empty() && stack_.back().frame <= frame) {
+    if (stack_.back().frame == frame &&
+        nodes_[stack_.back().node].function == function)
+      return;
+    pop(wallNow, cpuNow);
+  }
+
+  uint32_t parent = stack_.empty() ? kRoot : stack_.back().node;
+  auto result = nodeIndex_.insert(
+      {std::make_pair(parent, function), (uint32_t)nodes_.size()});
+  if (result.second)
+    nodes_.push_back(Node{function, parent, 0, 0});
+  uint32_t node = result.first->second;
+  ++nodes_[node].calls;
+  ++functions_[function].calls;
+  ++functions_[function].active;
+  stack_.push_back(Activation{frame, node, wallNow, cpuNow, 0, 0});
+}
+
+void FunctionProfiler::exit(const PinnedHermesValue *frame) {
+  if (stack_.empty() || stack_.back().frame > frame)
+    return;
+  TimePoint wallNow = std::chrono::steady_clock::now();
+  std::chrono::microseconds cpuNow = oscompat::thread_cpu_time();
+  while (!stack_.empty() && stack_.back().frame <= frame)
+    pop(wallNow, cpuNow);
+}
+
+void FunctionProfiler::pop(
+    TimePoint wallEnd,
+    std::chrono::microseconds cpuEnd) {
+  const Activation &act = stack_.back();
+  uint64_t wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      wallEnd - act.wallStart)
+                      .count();
+  uint64_t cpu = (cpuEnd - act.cpuStart).count();
+  Node &node = nodes_[act.node];
+  Function &function = functions_[node.function];
+  // Clocks are read once per event, so a child never outlasts its parent.
+  node.selfWall += wall - act.childWall;
+  function.selfWall += wall - act.childWall;
+  function.selfCPU += cpu - act.childCPU;
+  if (--function.active == 0) {
+    function.totalWall += wall;
+    function.totalCPU += cpu;
+  }
+  stack_.pop_back();
+  if (!stack_.empty()) {
+    stack_.back().childWall += wall;
+    stack_.back().childCPU += cpu;
+  }
+}
+
+void FunctionProfiler::dumpFoldedStacks(llvm::raw_ostream &OS) const {
+  std::vector<uint32_t> path;
+  for (uint32_t i = 0, e = nodes_.size(); i < e; ++i) {
+    path.clear();
+    for (uint32_t node = i; node != kRoot; node = nodes_[node].parent)
+      path.push_back(node);
+    for (auto iter = path.rbegin(); iter != path.rend(); ++iter) {
+      if (iter != path.rbegin())
+        OS << ";";
+      OS << functions_[nodes_[*iter].function].name;
+    }
+    OS << " " << nodes_[i].selfWall / 1000 << "\n";
+  }
+}
+
+void FunctionProfiler::dumpSummary(llvm::raw_ostream &OS) const {
+  std::vector<const Function *> sorted;
+  for (const Function &function : functions_)
+    sorted.push_back(&function);
+  std::stable_sort(
+      sorted.begin(),
+      sorted.end(),
+      [](const Function *a, const Function *b) {
+        return a->selfWall > b->selfWall;
+      });
+
+  JSONEmitter json(OS, /* pretty */ true);
+  json.openArray();
+  for (const Function *function : sorted) {
+    json.openDict();
+    json.emitKeyValue("function", function->name);
+    json.emitKeyValue("calls", function->calls);
+    json.emitKeyValue("selfWallMicros", function->selfWall / 1000);
+    json.emitKeyValue("totalWallMicros", function->totalWall / 1000);
+    json.emitKeyValue("selfCPUMicros", function->selfCPU);
+    json.emitKeyValue("totalCPUMicros", function->totalCPU);
+    json.closeDict();
+  }
+  json.closeArray();
+  OS << "\n";
+}
+
+} // namespace vm
+} // namespace hermes
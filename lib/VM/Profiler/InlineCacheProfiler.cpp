@@ -43,8 +43,10 @@ bool InlineCacheProfiler::insertICMiss(
     uint32_t instOffset,
     SymbolID &propertyID,
     ClassId objectHiddenClassId,
-    ClassId cachedHiddenClassId) {
+    ClassId cachedHiddenClassId,
+    PropertyCacheEntry::State cacheState) {
   ICMiss &icMiss = getICMissBySourceLocation(codeblock, instOffset);
+  icMiss.cacheState = cacheState;
   // record the hidden class pair for the source location
   auto hcPair =
       std::pair<ClassId, ClassId>(objectHiddenClassId, cachedHiddenClassId);
@@ -58,10 +60,12 @@ bool InlineCacheProfiler::insertICMiss(
 
 bool InlineCacheProfiler::insertICHit(
     CodeBlock *codeblock,
-    uint32_t instOffset) {
+    uint32_t instOffset,
+    PropertyCacheEntry::State cacheState) {
   // if not exist, create inline caching entry for the source location
   ICMiss &icMiss = getICMissBySourceLocation(codeblock, instOffset);
   icMiss.incrementHit();
+  icMiss.cacheState = cacheState;
 
   ++totalHits_;
   return true;
@@ -175,7 +179,9 @@ void InlineCacheProfiler::dumpInfoOfSourceLocation(
            << (1. * icMiss.missCount) / (icMiss.missCount + icMiss.hitCount);
     std::string missRatio = stream.str();
     ostream << "total access: " << icMiss.missCount + icMiss.hitCount
-            << ", miss ratio: " << missRatio << "\n";
+            << ", miss ratio: " << missRatio
+            << ", cache: " << propertyCacheStateName(icMiss.cacheState)
+            << "\n";
   } else {
     ostream << "[No Loc]\n";
   }
@@ -187,7 +193,7 @@ void InlineCacheProfiler::dumpInfoOfSourceLocation(
 /// The source locations are ranked in the descending order of IC misses.
 ///
 /// An example of output for a specific source location is as follows:
-/// [filename:line:column] total access: 2661, miss ratio: 0.3
+/// [file:line:col] total access: 2661, miss ratio: 0.3, cache: polymorphic
 ///  property: children, inline cache misses: 427
 ///    <type, domNamespace, children, childIndex, context, footer>
 ///    <domNamespace, type, children, childIndex, context, footer>
@@ -9,13 +9,17 @@
 
 #include "hermes/VM/Profiler/SamplingProfiler.h"
 
+#include "hermes/Inst/InstDecode.h"
 #include "hermes/Support/ThreadLocal.h"
 #include "hermes/VM/Callable.h"
 #include "hermes/VM/HostModel.h"
+#include "hermes/VM/JSNativeFunctions.h"
 #include "hermes/VM/Profiler/ChromeTraceSerializerPosix.h"
 #include "hermes/VM/RuntimeModule-inline.h"
 #include "hermes/VM/StackFrame-inline.h"
 
+#include "llvm/Support/Format.h"
+
 #include <assert.h>
 #include <fcntl.h>
 #include <pthread.h>
@@ -23,6 +27,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -36,6 +41,26 @@ constexpr uint32_t kMaxGCEventExtraInfoCount = 10;
 
 volatile std::atomic<SamplingProfiler *> SamplingProfiler::sProfilerInstance_{
     nullptr};
+volatile std::atomic<SamplingProfiler *> SamplingProfiler::sSamplingProfiler_{
+    nullptr};
+
+/// Serializes the signal handshake of all the profilers, and the
+/// registration of the signal handler.
+static std::mutex signalLock;
+/// Number of enabled profilers. Protected by signalLock.
+static uint32_t numEnabledProfilers = 0;
+
+/// Guards the list of live profilers and the number of live domains.
+static std::mutex profilersLock;
+/// All live profilers, which each reserve a slot per live domain.
+/// Protected by profilersLock.
+static std::vector<SamplingProfiler *> &liveProfilers() {
+  static std::vector<SamplingProfiler *> profilers;
+  return profilers;
+}
+/// Number of constructed but not destructed Domain objects.
+/// Protected by profilersLock.
+static size_t numLiveDomains = 0;
 
 void SamplingProfiler::registerRuntime(Runtime *runtime) {
   std::lock_guard<std::mutex> lockGuard(profilerLock_);
@@ -58,22 +83,34 @@ void SamplingProfiler::unregisterRuntime(Runtime *runtime) {
 }
 
 void SamplingProfiler::increaseDomainCount() {
-  std::lock_guard<std::mutex> lockGuard(profilerLock_);
-  // Reserve an empty slot. Use push_back to get exponential capacity expansion.
-  domains_.push_back(nullptr);
+  std::lock_guard<std::mutex> profilersGuard(profilersLock);
+  ++numLiveDomains;
+  // Any profiler may sample the new domain, so all of them need a slot.
+  for (SamplingProfiler *profiler : liveProfilers()) {
+    std::lock_guard<std::mutex> lockGuard(profiler->profilerLock_);
+    // Reserve an empty slot. Use push_back to get exponential capacity
+    // expansion.
+    profiler->domains_.push_back(nullptr);
+  }
 }
 
 void SamplingProfiler::decreaseDomainCount() {
-  std::lock_guard<std::mutex> lockGuard(profilerLock_);
-  // Shrink domains_ because a Domain has been destroyed.
-  // The destroyed domain should not be held by SamplingProfiler so
-  // there must have a corresponding reserved empty slot in domains_. Since
-  // domains_ is used from front the last slot in domains_ should be null.
-  assert(!domains_.empty() && "Why there is no domain?");
-  assert(
-      domains_.back() == nullptr &&
-      "The destroyed domain should not be referenced.");
-  domains_.pop_back();
+  std::lock_guard<std::mutex> profilersGuard(profilersLock);
+  assert(numLiveDomains > 0 && "Why there is no domain?");
+  --numLiveDomains;
+  for (SamplingProfiler *profiler : liveProfilers()) {
+    std::lock_guard<std::mutex> lockGuard(profiler->profilerLock_);
+    auto &domains = profiler->domains_;
+    // Shrink domains_ because a Domain has been destroyed.
+    // The destroyed domain should not be held by SamplingProfiler so
+    // there must have a corresponding reserved empty slot in domains_. Since
+    // domains_ is used from front the last slot in domains_ should be null.
+    assert(!domains.empty() && "Why there is no domain?");
+    assert(
+        domains.back() == nullptr &&
+        "The destroyed domain should not be referenced.");
+    domains.pop_back();
+  }
 }
 
 void SamplingProfiler::registerDomain(Domain *domain) {
@@ -105,19 +142,25 @@ int SamplingProfiler::invokeSignalAction(void (*handler)(int)) {
 }
 
 bool SamplingProfiler::registerSignalHandlers() {
-  if (isSigHandlerRegistered_) {
+  std::lock_guard<std::mutex> signalGuard(signalLock);
+  if (numEnabledProfilers > 0) {
+    ++numEnabledProfilers;
     return true;
   }
   if (invokeSignalAction(profilingSignalHandler) != 0) {
     perror("signal handler registration failed");
     return false;
   }
-  isSigHandlerRegistered_ = true;
+  ++numEnabledProfilers;
   return true;
 }
 
 bool SamplingProfiler::unregisterSignalHandler() {
-  if (!isSigHandlerRegistered_) {
+  std::lock_guard<std::mutex> signalGuard(signalLock);
+  assert(numEnabledProfilers > 0 && "No signal handler registered");
+  if (numEnabledProfilers > 1) {
+    // Other profilers are still sampling.
+    --numEnabledProfilers;
     return true;
   }
   // Restore to default.
@@ -125,13 +168,16 @@ bool SamplingProfiler::unregisterSignalHandler() {
     perror("signal handler unregistration failed");
     return false;
   }
-  isSigHandlerRegistered_ = false;
+  --numEnabledProfilers;
   return true;
 }
 
 void SamplingProfiler::profilingSignalHandler(int signo) {
   // Fetch runtime used by this sampling thread.
-  auto profilerInstance = sProfilerInstance_.load();
+  auto profilerInstance = sSamplingProfiler_.load();
+  assert(
+      profilerInstance != nullptr &&
+      "Why is the signal sent without a profiler?");
   Runtime *curThreadRuntime = profilerInstance->threadLocalRuntime_.get();
   if (curThreadRuntime == nullptr) {
     // Runtime may have unregistered itself before signal.
@@ -139,12 +185,14 @@ void SamplingProfiler::profilingSignalHandler(int signo) {
   }
   // Sampling stack will touch GC objects(like closure) so
   // only do so if heap is valid.
+  profilerInstance->sampledOpCode_ = kNumOpCodes;
   if (LLVM_LIKELY(!curThreadRuntime->getHeap().inGC())) {
-    assert(
-        profilerInstance != nullptr &&
-        "Why is sProfilerInstance_ not initialized yet?");
+    const Inst *leafIP;
     profilerInstance->sampledStackDepth_ = profilerInstance->walkRuntimeStack(
-        curThreadRuntime, profilerInstance->sampleStorage_);
+        curThreadRuntime, profilerInstance->sampleStorage_, 0, &leafIP);
+    if (leafIP) {
+      profilerInstance->sampledOpCode_ = static_cast<uint32_t>(leafIP->opCode);
+    }
   } else {
     // GC in process. Copy pre-captured stack instead.
     if (profilerInstance->preGCStackDepth_ > 0) {
@@ -170,54 +218,251 @@ bool SamplingProfiler::sampleStack() {
 
   for (const auto &entry : activeRuntimeThreads_) {
     auto targetThreadId = entry.second;
-    // Signal target runtime thread to sample stack.
-    pthread_kill(targetThreadId, SIGPROF);
-
-    // Threading: samplingDoneSem_ will synchronize with signal handler to
-    // to make sure there will NOT be two SIGPROF signals sent to the same
-    // runtime thread at the same time which prevents signal coalescing.
-    if (!samplingDoneSem_.wait()) {
-      return false;
+    {
+      // Only the walk itself is serialized with the other profilers; the
+      // samples are stored under profilerLock_ alone.
+      std::lock_guard<std::mutex> signalGuard(signalLock);
+      sSamplingProfiler_.store(this);
+      // Signal target runtime thread to sample stack.
+      pthread_kill(targetThreadId, SIGPROF);
+
+      // Threading: samplingDoneSem_ will synchronize with signal handler to
+      // to make sure there will NOT be two SIGPROF signals sent to the same
+      // runtime thread at the same time which prevents signal coalescing.
+      if (!samplingDoneSem_.wait()) {
+        return false;
+      }
     }
 
     if (sampledStackDepth_ > 0) {
       assert(
           sampledStackDepth_ <= sampleStorage_.stack.size() &&
           "How can we sample more frames than storage?");
-      sampledStacks_.emplace_back(
-          sampleStorage_.tid,
-          sampleStorage_.timeStamp,
-          sampleStorage_.stack.begin(),
-          sampleStorage_.stack.begin() + sampledStackDepth_);
+      countLeafFrame();
+      if (streaming_) {
+        aggregateSample(sampleStorage_, sampledStackDepth_);
+      } else {
+        sampledStacks_.emplace_back(
+            sampleStorage_.tid,
+            sampleStorage_.timeStamp,
+            sampleStorage_.stack.begin(),
+            sampleStorage_.stack.begin() + sampledStackDepth_);
+      }
     }
 
     // Only sample the first thread for now.
     // TODO: support sampling more than all active threads.
     break;
   }
+  if (streaming_ &&
+      std::chrono::steady_clock::now() - lastFlushTime_ >= flushInterval_) {
+    flushCallTree();
+  }
   return true;
 }
 
+void SamplingProfiler::countLeafFrame() {
+  const StackFrame &leaf = sampleStorage_.stack[0];
+  switch (leaf.kind) {
+    case StackFrame::FrameKind::JSFunction:
+      ++opCodeSamples_[sampledOpCode_];
+      break;
+
+    case StackFrame::FrameKind::NativeFunction:
+      ++builtinSamples_[(void *)leaf.nativeFrame];
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*static*/ std::pair<uint64_t, uint64_t> SamplingProfiler::getCallTreeKey(
+    uint32_t parent,
+    const StackFrame &frame) {
+  uint64_t payload;
+  switch (frame.kind) {
+    case SamplingProfiler::StackFrame::FrameKind::JSFunction:
+      payload = ((uint64_t)frame.jsFrame.functionId << 32) |
+          frame.jsFrame.offset;
+      break;
+
+    case SamplingProfiler::StackFrame::FrameKind::NativeFunction:
+      payload = reinterpret_cast<uintptr_t>(frame.nativeFrame);
+      break;
+
+    case SamplingProfiler::StackFrame::FrameKind::FinalizableNativeFunction:
+      payload = reinterpret_cast<uintptr_t>(frame.finalizableNativeFrame);
+      break;
+
+    case SamplingProfiler::StackFrame::FrameKind::GCFrame:
+      payload = reinterpret_cast<uintptr_t>(frame.gcFrame);
+      break;
+
+    default:
+      llvm_unreachable("Unknown frame kind");
+  }
+  // The parent index fits in 32 bits, so the key never collides with the
+  // empty and tombstone keys of the DenseMap.
+  return {((uint64_t)parent << 8) | static_cast<uint64_t>(frame.kind),
+          payload};
+}
+
+void SamplingProfiler::aggregateSample(
+    const StackTrace &sample,
+    uint32_t depth) {
+  // Only the outermost frames of a stack deeper than the whole tree are kept.
+  depth = std::min(depth, maxCallTreeNodes_);
+  if (callTree_.size() + depth > maxCallTreeNodes_) {
+    flushCallTree();
+  }
+
+  // Leaf frame is in sample[0], so walk backward from the root.
+  uint32_t node = kNoParent;
+  for (uint32_t i = depth; i-- > 0;) {
+    const StackFrame &frame = sample.stack[i];
+    uint32_t nextIndex = callTree_.size();
+    auto result =
+        callTreeIndex_.insert({getCallTreeKey(node, frame), nextIndex});
+    if (result.second) {
+      callTree_.push_back(CallTreeNode{frame, node, 0});
+    }
+    node = result.first->second;
+  }
+  ++callTree_[node].selfCount;
+}
+
+/// \return the name of \p frame in a folded stack line.
+static std::string getFoldedFrameName(
+    const SamplingProfiler::StackFrame &frame) {
+  std::string name;
+  llvm::raw_string_ostream OS(name);
+  switch (frame.kind) {
+    case SamplingProfiler::StackFrame::FrameKind::JSFunction: {
+      hbc::BCProvider *bcProvider = frame.jsFrame.module->getBytecode();
+      uint32_t funcId = frame.jsFrame.functionId;
+      llvm::StringRef funcName = bcProvider->getStringRefFromID(
+          bcProvider->getFunctionHeader(funcId).functionName());
+      OS << (funcName.empty() ? "(anonymous)" : funcName);
+
+      const hbc::DebugOffsets *debugOffsets =
+          bcProvider->getDebugOffsets(funcId);
+      OptValue<hbc::DebugSourceLocation> sourceLocOpt = llvm::None;
+      if (debugOffsets != nullptr &&
+          debugOffsets->sourceLocations != hbc::DebugOffsets::NO_OFFSET) {
+        sourceLocOpt = bcProvider->getDebugInfo()->getLocationForAddress(
+            debugOffsets->sourceLocations, frame.jsFrame.offset);
+      }
+      if (sourceLocOpt.hasValue()) {
+        const hbc::DebugSourceLocation &loc = sourceLocOpt.getValue();
+        OS << "(" << bcProvider->getDebugInfo()->getFilenameByID(loc.filenameId)
+           << ":" << loc.line << ":" << loc.column << ")";
+      } else {
+        // Without debug info, emit the virtual address for source map
+        // symbolication.
+        OS << "(" << bcProvider->getVirtualOffsetForFunction(funcId) << "+"
+           << frame.jsFrame.offset << ")";
+      }
+      break;
+    }
+
+    case SamplingProfiler::StackFrame::FrameKind::NativeFunction:
+      OS << "[Native] " << getFunctionName(frame.nativeFrame);
+      break;
+
+    case SamplingProfiler::StackFrame::FrameKind::FinalizableNativeFunction:
+      OS << "[HostFunction]";
+      break;
+
+    case SamplingProfiler::StackFrame::FrameKind::GCFrame:
+      if (frame.gcFrame != nullptr) {
+        OS << "[GC " << *frame.gcFrame << "]";
+      } else {
+        OS << "[GC]";
+      }
+      break;
+
+    default:
+      llvm_unreachable("Unknown frame kind");
+  }
+  OS.flush();
+  // ';' separates the frames of a folded stack.
+  std::replace(name.begin(), name.end(), ';', ',');
+  return name;
+}
+
+void SamplingProfiler::flushCallTree() {
+  lastFlushTime_ = std::chrono::steady_clock::now();
+  if (callTree_.empty()) {
+    return;
+  }
+
+  std::vector<std::string> names;
+  names.reserve(callTree_.size());
+  for (const CallTreeNode &node : callTree_) {
+    names.push_back(getFoldedFrameName(node.frame));
+  }
+
+  std::string chunk;
+  llvm::raw_string_ostream OS(chunk);
+  std::vector<uint32_t> path;
+  for (uint32_t i = 0, e = callTree_.size(); i < e; ++i) {
+    if (callTree_[i].selfCount == 0) {
+      continue;
+    }
+    path.clear();
+    for (uint32_t node = i; node != kNoParent; node = callTree_[node].parent) {
+      path.push_back(node);
+    }
+    for (auto iter = path.rbegin(); iter != path.rend(); ++iter) {
+      if (iter != path.rbegin()) {
+        OS << ";";
+      }
+      OS << names[*iter];
+    }
+    OS << " " << callTree_[i].selfCount << "\n";
+  }
+  OS.flush();
+
+  callTree_.clear();
+  callTreeIndex_.clear();
+  // The flushed frames no longer need their RuntimeModules.
+  for (Domain *&domain : domains_) {
+    domain = nullptr;
+  }
+  streamSink_(chunk);
+}
+
 void SamplingProfiler::timerLoop() {
   while (true) {
     if (!sampleStack()) {
       return;
     }
 
-    // TODO: make sampling rate configurable.
+    std::chrono::microseconds interval;
+    {
+      std::lock_guard<std::mutex> lockGuard(profilerLock_);
+      interval = samplingInterval_;
+    }
     // TODO: add random fluctuation to interval value.
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(interval);
   }
 }
 
 uint32_t SamplingProfiler::walkRuntimeStack(
     const Runtime *runtime,
     StackTrace &sampleStorage,
-    uint32_t startIndex) {
+    uint32_t startIndex,
+    const Inst **leafIP) {
   unsigned count = startIndex;
 
-  // TODO: capture leaf frame IP.
-  const Inst *ip = nullptr;
+  // The interpreter publishes the instruction it is executing, which belongs
+  // to the leaf frame if it lies in the leaf frame's code block.
+  const Inst *ip = runtime->getCurrentIP();
+  if (leafIP) {
+    *leafIP = nullptr;
+  }
+  bool isLeaf = true;
   // Whether we successfully captured a stack frame or not.
   bool capturedFrame = true;
   for (ConstStackFramePtr frame : runtime->getStackFrames()) {
@@ -226,6 +471,14 @@ uint32_t SamplingProfiler::walkRuntimeStack(
     // Check if it is pure JS frame.
     auto *calleeCodeBlock = frame.getCalleeCodeBlock();
     if (calleeCodeBlock != nullptr) {
+      if (reinterpret_cast<const uint8_t *>(ip) < calleeCodeBlock->begin() ||
+          reinterpret_cast<const uint8_t *>(ip) >= calleeCodeBlock->end()) {
+        // The published IP is stale when the leaf frame is not interpreted,
+        // e.g. when it runs compiled code.
+        ip = nullptr;
+      } else if (leafIP && isLeaf) {
+        *leafIP = ip;
+      }
       frameStorage.kind = StackFrame::FrameKind::JSFunction;
       frameStorage.jsFrame.functionId = calleeCodeBlock->getFunctionID();
       frameStorage.jsFrame.offset =
@@ -248,6 +501,7 @@ uint32_t SamplingProfiler::walkRuntimeStack(
     }
     // Update ip to caller for next iteration.
     ip = frame.getSavedIP();
+    isLeaf = false;
     if (capturedFrame) {
       ++count;
       if (count >= sampleStorage.stack.size()) {
@@ -260,14 +514,33 @@ uint32_t SamplingProfiler::walkRuntimeStack(
   return count;
 }
 
+uint32_t SamplingProfiler::captureStack(
+    const Runtime *runtime,
+    StackTrace &storage) {
+  std::lock_guard<std::mutex> lockGuard(profilerLock_);
+  return walkRuntimeStack(runtime, storage);
+}
+
 /*static*/ const std::shared_ptr<SamplingProfiler>
     &SamplingProfiler::getInstance() {
-  // Do not use make_shared here because that requires
-  // making constructor public.
-  static std::shared_ptr<SamplingProfiler> instance(new SamplingProfiler());
+  static std::shared_ptr<SamplingProfiler> instance = [] {
+    // Do not use make_shared here because that requires
+    // making constructor public.
+    std::shared_ptr<SamplingProfiler> profiler(new SamplingProfiler());
+#if defined(__ANDROID__) && defined(HERMES_FACEBOOK_BUILD)
+    profilo_api()->register_external_tracer_callback(
+        TRACER_TYPE_JAVASCRIPT, collectStackForLoom);
+#endif
+    sProfilerInstance_.store(profiler.get());
+    return profiler;
+  }();
   return instance;
 }
 
+/*static*/ std::shared_ptr<SamplingProfiler> SamplingProfiler::create() {
+  return std::shared_ptr<SamplingProfiler>(new SamplingProfiler());
+}
+
 #if defined(__ANDROID__) && defined(HERMES_FACEBOOK_BUILD)
 /*static*/ StackCollectionRetcode SamplingProfiler::collectStackForLoom(
     ucontext_t *ucontext,
@@ -342,14 +615,20 @@ uint32_t SamplingProfiler::walkRuntimeStack(
 #endif
 
 SamplingProfiler::SamplingProfiler() : sampleStorage_(kMaxStackDepth) {
-#if defined(__ANDROID__) && defined(HERMES_FACEBOOK_BUILD)
-  profilo_api()->register_external_tracer_callback(
-      TRACER_TYPE_JAVASCRIPT, collectStackForLoom);
-#endif
-  sProfilerInstance_.store(this);
   // Reserve max possible unique GC event extra info count to
   // avoid rehashing.
   gcEventExtraInfoSet_.reserve(kMaxGCEventExtraInfoCount);
+  std::lock_guard<std::mutex> profilersGuard(profilersLock);
+  // Domains created before this profiler may be sampled too.
+  domains_.resize(numLiveDomains, nullptr);
+  liveProfilers().push_back(this);
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  disable();
+  std::lock_guard<std::mutex> profilersGuard(profilersLock);
+  auto &profilers = liveProfilers();
+  profilers.erase(std::find(profilers.begin(), profilers.end(), this));
 }
 
 void SamplingProfiler::dumpSampledStack(llvm::raw_ostream &OS) {
@@ -400,12 +679,67 @@ void SamplingProfiler::dumpChromeTrace(llvm::raw_ostream &OS) {
   clear();
 }
 
+void SamplingProfiler::dumpOpCodeAndBuiltinHistograms(llvm::raw_ostream &OS) {
+  std::lock_guard<std::mutex> lockGuard(profilerLock_);
+
+  // Print the non-zero counts of \p entries, most frequent first, as a share
+  // of their total.
+  const auto dumpHistogram =
+      [&OS](std::vector<std::pair<std::string, uint64_t>> &entries) {
+        uint64_t total = 0;
+        for (const auto &entry : entries) {
+          total += entry.second;
+        }
+        std::stable_sort(
+            entries.begin(),
+            entries.end(),
+            [](const std::pair<std::string, uint64_t> &a,
+               const std::pair<std::string, uint64_t> &b) {
+              return a.second > b.second;
+            });
+        OS << total << " samples\n";
+        for (const auto &entry : entries) {
+          OS << llvm::format_decimal(entry.second, 10) << " "
+             << llvm::format("%5.1f%%", 100.0 * entry.second / total) << " "
+             << entry.first << "\n";
+        }
+      };
+
+  std::vector<std::pair<std::string, uint64_t>> entries;
+  for (uint32_t op = 0; op < kNumOpCodes; ++op) {
+    if (opCodeSamples_[op]) {
+      entries.emplace_back(
+          inst::getOpCodeString(static_cast<inst::OpCode>(op)).str(),
+          opCodeSamples_[op]);
+    }
+  }
+  if (opCodeSamples_[kNumOpCodes]) {
+    entries.emplace_back("(unknown)", opCodeSamples_[kNumOpCodes]);
+  }
+  OS << "Sampled opcodes: ";
+  dumpHistogram(entries);
+
+  entries.clear();
+  for (const auto &entry : builtinSamples_) {
+    entries.emplace_back(
+        getFunctionName(reinterpret_cast<NativeFunctionPtr>(entry.first)),
+        entry.second);
+  }
+  OS << "Sampled builtins: ";
+  dumpHistogram(entries);
+}
+
 bool SamplingProfiler::enable() {
   std::lock_guard<std::mutex> lockGuard(profilerLock_);
   if (enabled_) {
     return true;
   }
-  if (!samplingDoneSem_.open(kSamplingDoneSemaphoreName)) {
+  // Give every semaphore its own name so that profilers enabled at the same
+  // time never share one.
+  static std::atomic<uint32_t> nextSemaphoreId{0};
+  std::string semaphoreName = std::string(kSamplingDoneSemaphoreName) +
+      std::to_string(nextSemaphoreId++);
+  if (!samplingDoneSem_.open(semaphoreName.c_str())) {
     return false;
   }
   if (!registerSignalHandlers()) {
@@ -413,30 +747,88 @@ bool SamplingProfiler::enable() {
   }
   enabled_ = true;
   // Start timer thread.
-  std::thread(&SamplingProfiler::timerLoop, this).detach();
+  timerThread_ = std::thread(&SamplingProfiler::timerLoop, this);
   return true;
 }
 
-bool SamplingProfiler::disable() {
+void SamplingProfiler::setSamplingInterval(std::chrono::microseconds interval) {
   std::lock_guard<std::mutex> lockGuard(profilerLock_);
-  if (!enabled_) {
-    // Already disabled.
-    return true;
+  samplingInterval_ = interval;
+}
+
+bool SamplingProfiler::enableStreaming(
+    uint32_t maxNodes,
+    std::chrono::milliseconds flushInterval,
+    StreamSink sink) {
+  assert(maxNodes > 0 && "Streaming requires room for at least one frame");
+  {
+    std::lock_guard<std::mutex> lockGuard(profilerLock_);
+    if (enabled_) {
+      // The sampling mode can only change while the profiler is disabled.
+      return false;
+    }
+    streaming_ = true;
+    maxCallTreeNodes_ = maxNodes;
+    flushInterval_ = flushInterval;
+    lastFlushTime_ = std::chrono::steady_clock::now();
+    streamSink_ = std::move(sink);
+    // Allocate the storage up front rather than while sampling.
+    callTree_.clear();
+    callTree_.reserve(maxNodes);
+    callTreeIndex_.clear();
+    callTreeIndex_.reserve(maxNodes);
   }
-  if (!samplingDoneSem_.close()) {
+  if (!enable()) {
+    std::lock_guard<std::mutex> lockGuard(profilerLock_);
+    streaming_ = false;
+    streamSink_ = nullptr;
     return false;
   }
-  // Unregister handlers before shutdown.
-  if (!unregisterSignalHandler()) {
-    return false;
+  return true;
+}
+
+void SamplingProfiler::flushStream() {
+  std::lock_guard<std::mutex> lockGuard(profilerLock_);
+  if (streaming_) {
+    flushCallTree();
+  }
+}
+
+bool SamplingProfiler::disable() {
+  std::thread timerThread;
+  {
+    std::lock_guard<std::mutex> lockGuard(profilerLock_);
+    if (!enabled_) {
+      // Already disabled.
+      return true;
+    }
+    if (!samplingDoneSem_.close()) {
+      return false;
+    }
+    // Unregister handlers before shutdown.
+    if (!unregisterSignalHandler()) {
+      return false;
+    }
+    // Telling timer thread to exit.
+    enabled_ = false;
+    timerThread = std::move(timerThread_);
+    if (streaming_) {
+      flushCallTree();
+      streaming_ = false;
+      streamSink_ = nullptr;
+      callTree_ = std::vector<CallTreeNode>();
+      callTreeIndex_.shrink_and_clear();
+    }
   }
-  // Telling timer thread to exit.
-  enabled_ = false;
+  // The timer thread needs profilerLock_ to notice that it has to exit.
+  timerThread.join();
   return true;
 }
 
 void SamplingProfiler::clear() {
   sampledStacks_.clear();
+  std::fill(std::begin(opCodeSamples_), std::end(opCodeSamples_), 0);
+  builtinSamples_.clear();
   // Release all strong roots to domains.
   // Note: we can't clear domains_ because we have to maintain the storage size.
   for (Domain *&domain : domains_) {
@@ -20,6 +20,10 @@ namespace vm {
   return instance;
 }
 
+/*static*/ std::shared_ptr<SamplingProfiler> SamplingProfiler::create() {
+  return std::shared_ptr<SamplingProfiler>(new SamplingProfiler());
+}
+
 } // namespace vm
 } // namespace hermes
 
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/RegExpCache.h"
+
+namespace hermes {
+namespace vm {
+
+RegExpCache::Key RegExpCache::makeKey(UTF16Ref pattern, uint8_t flags) {
+  Key key;
+  key.reserve(pattern.size() + 1);
+  key.push_back(flags);
+  key.append(pattern.begin(), pattern.end());
+  return key;
+}
+
+const std::vector<uint8_t> *RegExpCache::lookup(
+    UTF16Ref pattern,
+    uint8_t flags) {
+  if (capacity_ == 0)
+    return nullptr;
+  auto it = index_.find(makeKey(pattern, flags));
+  if (it == index_.end()) {
+    ++numMisses_;
+    return nullptr;
+  }
+  ++numHits_;
+  // Make it the most recently used entry.
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return &it->second->bytecode;
+}
+
+void RegExpCache::insert(
+    UTF16Ref pattern,
+    uint8_t flags,
+    std::vector<uint8_t> bytecode) {
+  if (capacity_ == 0)
+    return;
+  Key key = makeKey(pattern, flags);
+  if (index_.count(key))
+    return;
+  if (entries_.size() == capacity_) {
+    Entry &last = entries_.back();
+    bytecodeBytes_ -= last.bytecode.size();
+    index_.erase(last.key);
+    entries_.pop_back();
+    ++numEvictions_;
+  }
+  bytecodeBytes_ += bytecode.size();
+  entries_.push_front(Entry{key, std::move(bytecode)});
+  index_.emplace(std::move(key), entries_.begin());
+}
+
+void RegExpCache::printStats(llvm::raw_ostream &os) const {
+  if (numHits_ == 0 && numMisses_ == 0)
+    return;
+  os << "RegExp cache stats:\n"
+     << "{\n"
+     << "\t\"capacity\": " << capacity_ << ",\n"
+     << "\t\"numEntries\": " << entries_.size() << ",\n"
+     << "\t\"bytecodeBytes\": " << bytecodeBytes_ << ",\n"
+     << "\t\"numHits\": " << numHits_ << ",\n"
+     << "\t\"numMisses\": " << numMisses_ << ",\n"
+     << "\t\"numEvictions\": " << numEvictions_ << "\n"
+     << "}\n";
+}
+
+} // namespace vm
+} // namespace hermes
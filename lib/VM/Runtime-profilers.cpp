@@ -8,19 +8,148 @@
 #define DEBUG_TYPE "vm"
 #include "hermes/VM/Runtime.h"
 
+#include "hermes/Inst/InstDecode.h"
+#include "hermes/Support/JSONEmitter.h"
 #include "hermes/VM/Callable.h"
+#include "hermes/VM/PropertyCache.h"
+#include "hermes/VM/RuntimeModule-inline.h"
 #include "hermes/VM/SmallXString.h"
 #include "hermes/VM/StringView.h"
 
+#include "llvm/ADT/DenseMap.h"
+
+#include <algorithm>
+
 #ifdef HERMESVM_PROFILER_OPCODE
 #include <iomanip>
 #include <iostream>
-#include "hermes/Inst/InstDecode.h"
+#include <utility>
 #endif
 
 namespace hermes {
 namespace vm {
 
+void Runtime::dumpPropertyCacheStats(llvm::raw_ostream &OS) {
+  using namespace inst;
+
+  /// The accesses sharing a cache entry: the compiler assigns one entry per
+  /// property name and function, not per access.
+  struct EntryStats {
+    const PropertyCacheEntry *entry;
+    CodeBlock *codeBlock;
+    /// Offset of the first access using the entry.
+    uint32_t offset;
+    /// String id of the property name.
+    uint32_t stringID;
+    bool isWrite;
+    uint32_t sites;
+  };
+  std::vector<EntryStats> stats;
+  llvm::DenseMap<const PropertyCacheEntry *, size_t> statsIndex;
+
+  for (auto &rm : runtimeModuleList_) {
+    for (unsigned i = 0, e = rm.getNumCodeBlocks(); i < e; ++i) {
+      CodeBlock *codeBlock = rm.getCodeBlockIfCreated(i);
+      // A function which never accessed a cached property has no counts.
+      if (!codeBlock || !codeBlock->hasPropertyCache())
+        continue;
+      for (auto *ip = codeBlock->begin(), *end = codeBlock->end(); ip != end;) {
+        auto *inst = reinterpret_cast<const Inst *>(ip);
+        uint8_t cacheIdx = 0;
+        uint32_t stringID = 0;
+        bool isWrite = false;
+        switch (inst->opCode) {
+#define CASE_CACHED_ACCESS(name, strOp, write) \
+  case OpCode::name:                           \
+    cacheIdx = inst->i##name.op3;              \
+    stringID = inst->i##name.strOp;            \
+    isWrite = write;                           \
+    break;
+          CASE_CACHED_ACCESS(GetByIdShort, op4, false)
+          CASE_CACHED_ACCESS(GetById, op4, false)
+          CASE_CACHED_ACCESS(GetByIdLong, op4, false)
+          CASE_CACHED_ACCESS(GetByIdSlot, op5, false)
+          CASE_CACHED_ACCESS(TryGetById, op4, false)
+          CASE_CACHED_ACCESS(TryGetByIdLong, op4, false)
+          CASE_CACHED_ACCESS(PutById, op4, true)
+          CASE_CACHED_ACCESS(PutByIdLong, op4, true)
+          CASE_CACHED_ACCESS(TryPutById, op4, true)
+          CASE_CACHED_ACCESS(TryPutByIdLong, op4, true)
+#undef CASE_CACHED_ACCESS
+          default:
+            break;
+        }
+        if (cacheIdx != hbc::PROPERTY_CACHING_DISABLED) {
+          const PropertyCacheEntry *entry = isWrite
+              ? codeBlock->getWriteCacheEntry(cacheIdx)
+              : codeBlock->getReadCacheEntry(cacheIdx);
+          auto result = statsIndex.insert({entry, stats.size()});
+          if (result.second) {
+            stats.push_back(EntryStats{
+                entry,
+                codeBlock,
+                static_cast<uint32_t>(ip - codeBlock->begin()),
+                stringID,
+                isWrite,
+                0});
+          }
+          ++stats[result.first->second].sites;
+        }
+        ip += decodeInstruction(inst).meta.size;
+      }
+    }
+  }
+
+  stats.erase(
+      std::remove_if(
+          stats.begin(),
+          stats.end(),
+          [](const EntryStats &s) {
+            return s.entry->hits == 0 && s.entry->misses == 0;
+          }),
+      stats.end());
+  std::stable_sort(
+      stats.begin(),
+      stats.end(),
+      [](const EntryStats &a, const EntryStats &b) {
+        return a.entry->misses > b.entry->misses;
+      });
+
+  JSONEmitter json(OS, /* pretty */ true);
+  json.openArray();
+  for (const EntryStats &s : stats) {
+    CodeBlock *codeBlock = s.codeBlock;
+    hbc::BCProvider *bcProvider = codeBlock->getRuntimeModule()->getBytecode();
+    json.openDict();
+    json.emitKeyValue("function", codeBlock->getNameString(this));
+    OptValue<hbc::DebugSourceLocation> loc =
+        codeBlock->getSourceLocation(s.offset);
+    if (loc.hasValue()) {
+      json.emitKeyValue(
+          "url",
+          bcProvider->getDebugInfo()->getFilenameByID(
+              loc.getValue().filenameId));
+      json.emitKeyValue("line", loc.getValue().line);
+      json.emitKeyValue("column", loc.getValue().column);
+    } else {
+      for (const char *key : {"url", "line", "column"}) {
+        json.emitKey(key);
+        json.emitNullValue();
+      }
+    }
+    json.emitKeyValue("property", bcProvider->getStringRefFromID(s.stringID));
+    json.emitKeyValue("kind", s.isWrite ? "write" : "read");
+    json.emitKeyValue("sites", s.sites);
+    json.emitKeyValue("hits", s.entry->hits);
+    json.emitKeyValue("misses", s.entry->misses);
+    json.emitKeyValue("evictions", s.entry->evictions);
+    json.emitKeyValue("state", propertyCacheStateName(s.entry->getState()));
+    json.closeDict();
+  }
+  json.closeArray();
+  OS << "\n";
+}
+
 #ifdef HERMESVM_PROFILER_OPCODE
 void Runtime::dumpOpcodeStats(llvm::raw_ostream &os) const {
   std::ostringstream stream;
@@ -67,6 +196,38 @@ void Runtime::dumpOpcodeStats(llvm::raw_ostream &os) const {
            << inst::getOpCodeString(static_cast<inst::OpCode>(op)).data()
            << std::setw(22) << t[op] << std::setw(11) << f[op] << "\n";
   }
+
+  // Get all non-zero occurence pairs, as (previous, current) opcode pairs.
+  std::vector<std::pair<size_t, size_t>> pairs;
+  for (size_t i = 0; i < static_cast<uint32_t>(inst::OpCode::_last); ++i) {
+    for (size_t j = 0; j < static_cast<uint32_t>(inst::OpCode::_last); ++j) {
+      if (opcodePairFrequency[i][j])
+        pairs.emplace_back(i, j);
+    }
+  }
+  const auto *pf = opcodePairFrequency;
+  sort(
+      pairs.begin(),
+      pairs.end(),
+      [pf](std::pair<size_t, size_t> p1, std::pair<size_t, size_t> p2) {
+        return pf[p1.first][p1.second] > pf[p2.first][p2.second];
+      });
+  if (pairs.size() > kNumDumpedOpcodePairs)
+    pairs.resize(kNumDumpedOpcodePairs);
+
+  stream << "\nOpcode pairs sorted by frequency:\n"
+         << std::left << std::setfill(' ') << std::setw(25) << "==First=="
+         << std::setw(25) << "==Second=="
+         << "==Frequency=="
+         << "\n";
+  for (const auto &pair : pairs) {
+    stream
+        << std::left << std::setfill(' ') << std::setw(25)
+        << inst::getOpCodeString(static_cast<inst::OpCode>(pair.first)).data()
+        << std::setw(25)
+        << inst::getOpCodeString(static_cast<inst::OpCode>(pair.second)).data()
+        << pf[pair.first][pair.second] << "\n";
+  }
   os << stream.str();
 }
 #endif
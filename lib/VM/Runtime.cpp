@@ -25,6 +25,7 @@
 #include "hermes/Support/MemoryBuffer.h"
 #include "hermes/Support/OSCompat.h"
 #include "hermes/Support/PerfSection.h"
+#include "hermes/Support/TraceEvents.h"
 #include "hermes/VM/AlignedStorage.h"
 #include "hermes/VM/BuildMetadata.h"
 #include "hermes/VM/Callable.h"
@@ -39,6 +40,8 @@
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/PointerBase.h"
 #include "hermes/VM/PredefinedStringIDs.h"
+#include "hermes/VM/Profiler/AllocationProfiler.h"
+#include "hermes/VM/Profiler/FunctionProfiler.h"
 #include "hermes/VM/Profiler/SamplingProfiler.h"
 #include "hermes/VM/RuntimeModule-inline.h"
 #include "hermes/VM/StackFrame-inline.h"
@@ -87,7 +90,10 @@ std::shared_ptr<Runtime> Runtime::create(const RuntimeConfig &runtimeConfig) {
   GC::Size sz{gcConfig.getMinHeapSize(), gcConfig.getMaxHeapSize()};
   // TODO(T31421960): This can become a unique_ptr with C++14 lambda
   // initializers.
-  std::shared_ptr<StorageProvider> provider{StorageProvider::mmapProvider()};
+  std::shared_ptr<StorageProvider> provider{
+      gcConfig.getPooledStorage()
+          ? StorageProvider::pooledProvider(gcConfig.getHugePages())
+          : StorageProvider::mmapProvider(gcConfig.getHugePages())};
   // When not using the flat address space, allocate runtime normally.
   Runtime *rt = new Runtime(provider.get(), runtimeConfig);
   // Return a shared pointer with a custom deleter to delete the underlying
@@ -177,6 +183,11 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
       bytecodeWarmupPercent_(runtimeConfig.getBytecodeWarmupPercent()),
       trackIO_(runtimeConfig.getTrackIO()),
       vmExperimentFlags_(runtimeConfig.getVMExperimentFlags()),
+      maxStackTraceDepth_(runtimeConfig.getMaxStackTraceDepth()),
+      fastTeardown_(runtimeConfig.getFastTeardown()),
+      regExpCache_(runtimeConfig.getRegExpCacheSize()),
+      evalCache_(runtimeConfig.getEvalCacheSize()),
+      nativeLibraryFunctions_(runtimeConfig.getNativeLibraryFunctions()),
       runtimeStats_(runtimeConfig.getEnableSampledStats()),
       commonStorage_(createRuntimeCommonStorage(
           runtimeConfig.getTraceEnvironmentInteractions())),
@@ -187,6 +198,18 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
   assert(
       (void *)this == (void *)(HandleRootOwner *)this &&
       "cast to HandleRootOwner should be no-op");
+  jitContext_.setCallThreshold(runtimeConfig.getJITCallThreshold());
+  jitContext_.setLoopThreshold(runtimeConfig.getJITLoopThreshold());
+  jitContext_.setBackgroundCompilation(
+      runtimeConfig.getJITBackgroundCompilation());
+  jitContext_.setProfileCacheDir(runtimeConfig.getJITProfileCacheDir());
+  jitContext_.setCodeBudget(runtimeConfig.getJITCodeBudget());
+  jitContext_.setPerfMap(runtimeConfig.getJITPerfMap());
+  heap_.setSampleHardwareCounters(runtimeStats_.shouldSample);
+#ifndef HERMESVM_LEAN
+  if (runtimeConfig.getLazyPrecompilation())
+    lazyCompileQueue_ = llvm::make_unique<LazyCompileQueue>();
+#endif
   auto maxNumRegisters = runtimeConfig.getMaxNumRegisters();
   if (LLVM_UNLIKELY(maxNumRegisters > kMaxSupportedNumRegisters)) {
     hermes_fatal("RuntimeConfig maxNumRegisters too big");
@@ -198,12 +221,18 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
     // Round up to page size as required by vm_allocate.
     const auto numBytesForRegisters = llvm::alignTo(
         sizeof(PinnedHermesValue) * maxNumRegisters, oscompat::page_size());
-    auto result = oscompat::vm_allocate(numBytesForRegisters);
+    // The stack grows down, towards an inaccessible guard page. Writing past
+    // the reserve without checking faults there instead of corrupting
+    // whatever is mapped below.
+    const size_t guardBytes = oscompat::page_size();
+    auto result = oscompat::vm_allocate(guardBytes + numBytesForRegisters);
     if (!result) {
       hermes_fatal("failed to allocate register stack");
     }
-    registerStack_ = static_cast<PinnedHermesValue *>(result.get());
-    registerStackBytesToUnmap_ = numBytesForRegisters;
+    oscompat::vm_protect(result.get(), guardBytes, oscompat::ProtectMode::None);
+    registerStack_ = reinterpret_cast<PinnedHermesValue *>(
+        static_cast<char *>(result.get()) + guardBytes);
+    registerStackBytesToUnmap_ = guardBytes + numBytesForRegisters;
     crashMgr_->registerMemory(registerStack_, numBytesForRegisters);
   } else {
     registerStackBytesToUnmap_ = 0;
@@ -215,6 +244,7 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
     registerStackEnd_ -= bytesOff / sizeof(PinnedHermesValue);
     assert(registerStackEnd_ >= registerStack_ && "register stack too small");
   }
+  registerStackLimit_ = registerStack_ + STACK_RESERVE;
   stackPointer_ = registerStackEnd_;
 
   // Setup the "root" stack frame.
@@ -271,7 +301,7 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
   // modules.
   specialCodeBlockRuntimeModule_->initializeWithoutCJSModulesMayAllocate(
       hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
-          generateSpecialRuntimeBytecode())
+          getSharedSpecialRuntimeBytecode())
           .first);
   emptyCodeBlock_ = specialCodeBlockRuntimeModule_->getCodeBlockMayAllocate(0);
   returnThisCodeBlock_ =
@@ -310,6 +340,8 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
 
 #ifdef HERMESVM_SERIALIZE
   if (runtimeConfig.getSerializeAfterInitFile()) {
+    // The initializers of lazy builtins can't be serialized.
+    initializeLazyBuiltins();
     assert(
         runtimeConfig.getExternalPointersVectorCallBack() &&
         "missing function pointer to map external pointers.");
@@ -335,10 +367,92 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
 #endif
 }
 
+void Runtime::setSamplingProfiler(std::shared_ptr<SamplingProfiler> profiler) {
+  samplingProfiler_->unregisterRuntime(this);
+  samplingProfiler_ = std::move(profiler);
+  samplingProfiler_->registerRuntime(this);
+}
+
+bool Runtime::enableAllocationSampling(uint64_t samplingInterval) {
+#ifndef _WINDOWS
+  allocationProfiler_ =
+      llvm::make_unique<AllocationProfiler>(this, samplingInterval);
+  allocationBytesUntilSample_ = allocationProfiler_->nextSampleDistance();
+  return true;
+#else
+  return false;
+#endif
+}
+
+void Runtime::disableAllocationSampling() {
+  allocationBytesUntilSample_ = INT64_MAX;
+#ifndef _WINDOWS
+  allocationProfiler_.reset();
+#endif
+}
+
+void Runtime::dumpSampledAllocations(llvm::raw_ostream &OS) {
+#ifndef _WINDOWS
+  if (allocationProfiler_) {
+    allocationProfiler_->serialize(OS);
+  }
+#endif
+}
+
+void Runtime::sampleAllocation(const void *mem, uint32_t size) {
+#ifndef _WINDOWS
+  assert(allocationProfiler_ && "Allocation sampled while disabled");
+  allocationProfiler_->recordSample(mem, size);
+  allocationBytesUntilSample_ = allocationProfiler_->nextSampleDistance();
+#else
+  allocationBytesUntilSample_ = INT64_MAX;
+#endif
+}
+
+void Runtime::enableFunctionProfiling() {
+  functionProfiler_ = llvm::make_unique<FunctionProfiler>(this);
+  functionProfilerActive_ = true;
+}
+
+void Runtime::disableFunctionProfiling() {
+  functionProfilerActive_ = false;
+  functionProfiler_.reset();
+}
+
+void Runtime::dumpFunctionProfile(llvm::raw_ostream &OS) {
+  if (functionProfiler_) {
+    functionProfiler_->dumpFoldedStacks(OS);
+  }
+}
+
+void Runtime::dumpFunctionProfileSummary(llvm::raw_ostream &OS) {
+  if (functionProfiler_) {
+    functionProfiler_->dumpSummary(OS);
+  }
+}
+
+void Runtime::functionProfilerEnterSlow(
+    CodeBlock *codeBlock,
+    const PinnedHermesValue *frame) {
+  functionProfiler_->enter(codeBlock, frame);
+}
+
+void Runtime::functionProfilerExitSlow(const PinnedHermesValue *frame) {
+  functionProfiler_->exit(frame);
+}
+
+std::atomic<uint64_t> Runtime::fastTeardownLeakedBytes_{0};
+
 Runtime::~Runtime() {
   samplingProfiler_->unregisterRuntime(this);
 
-  heap_.finalizeAll();
+  if (fastTeardown_) {
+    // The segments of the heap are released as a whole below.
+    fastTeardownLeakedBytes_.fetch_add(
+        heap_.finalizeObservable(), std::memory_order_relaxed);
+  } else {
+    heap_.finalizeAll();
+  }
 #ifndef NDEBUG
   // Now that all objects are finalized, there shouldn't be any native memory
   // keys left in the ID tracker for memory profiling. Assert that the only IDs
@@ -346,15 +460,21 @@ Runtime::~Runtime() {
   heap_.getIDTracker().forEachID([this](
                                      const void *mem, HeapSnapshot::NodeID id) {
     assert(
-        heap_.validPointer(mem) &&
+        (fastTeardown_ || heap_.validPointer(mem)) &&
         "A pointer is left in the ID tracker that is from non-JS memory. Was untrackNative called?");
   });
 #endif
   crashMgr_->unregisterCallback(crashCallbackKey_);
   if (registerStackBytesToUnmap_ > 0) {
     crashMgr_->unregisterMemory(registerStack_);
-    oscompat::vm_free(registerStack_, registerStackBytesToUnmap_);
+    oscompat::vm_free(
+        reinterpret_cast<char *>(registerStack_) - oscompat::page_size(),
+        registerStackBytesToUnmap_);
   }
+#ifndef HERMESVM_LEAN
+  // Stop precompiling functions of the modules about to be deleted.
+  lazyCompileQueue_.reset();
+#endif
   // Remove inter-module dependencies so we can delete them in any order.
   for (auto &module : runtimeModuleList_) {
     module.prepareForRuntimeShutdown();
@@ -445,6 +565,10 @@ void Runtime::markRoots(RootAcceptor &acceptor, bool markLongLived) {
       for (auto &hv : charStrings_)
         acceptor.accept(hv);
     }
+    // The cached number strings are usually young, so mark them in every
+    // collection.
+    for (auto &entry : numberStringCache_)
+      acceptor.accept(entry.str);
     acceptor.endRootSection();
   }
 
@@ -453,6 +577,10 @@ void Runtime::markRoots(RootAcceptor &acceptor, bool markLongLived) {
     acceptor.beginRootSection(RootAcceptor::Section::Builtins);
     for (NativeFunction *&nf : builtins_)
       acceptor.accept((void *&)nf);
+    for (LazyBuiltin &lazy : lazyBuiltins_) {
+      acceptor.accept((void *&)lazy.constructor);
+      acceptor.accept((void *&)lazy.prototype);
+    }
     acceptor.endRootSection();
   }
 
@@ -473,6 +601,15 @@ void Runtime::markRoots(RootAcceptor &acceptor, bool markLongLived) {
     acceptor.endRootSection();
   }
 
+#ifdef HERMES_ENABLE_DEBUGGER
+  {
+    MarkRootsPhaseTimer timer(this, RootAcceptor::Section::DebugEnvironment);
+    acceptor.beginRootSection(RootAcceptor::Section::DebugEnvironment);
+    debugger_.markRoots(acceptor);
+    acceptor.endRootSection();
+  }
+#endif
+
   {
     MarkRootsPhaseTimer timer(this, RootAcceptor::Section::IdentifierTable);
     acceptor.beginRootSection(RootAcceptor::Section::IdentifierTable);
@@ -525,6 +662,7 @@ void Runtime::markWeakRoots(WeakRootAcceptor &acceptor) {
   acceptor.beginRootSection(RootAcceptor::Section::WeakRefs);
   for (auto &rm : runtimeModuleList_)
     rm.markWeakRoots(acceptor);
+  transitionCache_.markWeakRoots(acceptor);
   markWeakRefs(acceptor);
   for (auto &fn : customMarkWeakRootFuncs_)
     fn(&getHeap(), acceptor);
@@ -569,6 +707,10 @@ void Runtime::printHeapStats(llvm::raw_ostream &os) {
   if (shouldStabilizeInstructionCount())
     return;
   getHeap().printAllCollectedStats(os);
+  if (jitContext_.isEnabled())
+    jitContext_.printStats(os);
+  regExpCache_.printStats(os);
+  evalCache_.printStats(os);
 #ifndef NDEBUG
   printArrayCensus(llvm::outs());
 #endif
@@ -738,6 +880,39 @@ size_t Runtime::mallocSize() const {
   return totalSize;
 }
 
+void Runtime::getNativeMemoryInfo(NativeMemoryInfo &info) {
+  info = NativeMemoryInfo{};
+  info.identifierTable =
+      sizeof(IdentifierTable) + identifierTable_.additionalMemorySize();
+
+  const size_t pageSize = oscompat::page_size();
+  for (const RuntimeModule &rtm : runtimeModuleList_) {
+    info.runtimeModules += sizeof(RuntimeModule) + rtm.tableMemorySize();
+    info.codeBlocks += rtm.codeBlockMemorySize();
+    info.propertyCaches += rtm.propertyCacheMemorySize();
+    auto buf = rtm.getBytecode()->getRawBuffer();
+    info.bytecode += buf.size();
+    if (buf.size()) {
+      // The first and last pages may be shared with other data.
+      int pages = oscompat::pages_in_ram(buf.data(), buf.size());
+      if (pages > 0)
+        info.bytecodeResident +=
+            std::min<size_t>(pages * pageSize, buf.size());
+    }
+  }
+
+  heap_.forAllObjs([&info](GCCell *cell) {
+    if (cell->getKind() == CellKind::HiddenClassKind) {
+      info.hiddenClassTransitions += cell->getVT()->getMallocSize(cell);
+    } else if (cell->getKind() == CellKind::DictPropertyMapKind) {
+      // Property maps are only ever created for hidden classes.
+      info.hiddenClassPropertyMaps += cell->getAllocatedSize();
+    }
+  });
+
+  info.jitCode = jitContext_.getExecMemorySize();
+}
+
 #ifdef HERMESVM_SANITIZE_HANDLES
 void Runtime::potentiallyMoveHeap() {
   // Do a dummy allocation which could force a heap move if handle sanitization
@@ -823,6 +998,8 @@ CallResult<HermesValue> Runtime::runBytecode(
     Handle<Environment> environment,
     Handle<> thisArg) {
   clearThrownValue();
+  trace::Scope traceScope(trace::Category::Execution, "runBytecode");
+  traceScope.addArg("sourceURL", sourceURL);
 
 #ifdef HERMESVM_SERIALIZE
   // If we are constructed from serialize data with a ClosureFunction, execute
@@ -882,8 +1059,13 @@ CallResult<HermesValue> Runtime::runBytecode(
 
   Handle<Domain> domain = toHandle(this, Domain::create(this));
 
-  auto runtimeModuleRes = RuntimeModule::create(
-      this, domain, std::move(bytecode), flags, sourceURL);
+  CallResult<RuntimeModule *> runtimeModuleRes{ExecutionStatus::EXCEPTION};
+  {
+    instrumentation::RAIITimer timer{
+        "Module Init", runtimeStats_, runtimeStats_.moduleInit};
+    runtimeModuleRes = RuntimeModule::create(
+        this, domain, std::move(bytecode), flags, sourceURL);
+  }
   if (LLVM_UNLIKELY(runtimeModuleRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
@@ -947,8 +1129,91 @@ ExecutionStatus Runtime::loadSegment(
   return ExecutionStatus::RETURNED;
 }
 
+#ifdef HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
+namespace {
+/// A builtin property keeping its native implementation, saved before the JS
+/// library replaces it.
+struct NativeLibraryFunction {
+  /// The object holding the property.
+  Handle<JSObject> holder;
+  /// The name of the property.
+  SymbolID name;
+  /// The flags of the property.
+  PropertyFlags flags;
+  /// The native function, or the accessor of native getter and setter.
+  Handle<> value;
+};
+} // namespace
+
+/// Look up the builtin named by \p path, the names of the properties leading
+/// to it from the global object separated by dots, where "@@name" stands for
+/// the well-known symbol Symbol.name.
+/// \return the property, or None if there is no such own property.
+static llvm::Optional<NativeLibraryFunction> lookupNativeLibraryFunction(
+    Runtime *runtime,
+    llvm::StringRef path) {
+  auto getSymbol = [runtime](llvm::StringRef name) -> OptValue<SymbolID> {
+    bool wellKnown = name.consume_front("@@");
+    auto symRes = runtime->getIdentifierTable().getSymbolHandle(
+        runtime, ASCIIRef(name.data(), name.size()));
+    if (LLVM_UNLIKELY(symRes == ExecutionStatus::EXCEPTION))
+      return llvm::None;
+    if (!wellKnown)
+      return **symRes;
+    auto consRes = JSObject::getNamed_RJS(
+        runtime->getGlobal(),
+        runtime,
+        Predefined::getSymbolID(Predefined::Symbol));
+    if (consRes == ExecutionStatus::EXCEPTION || !consRes->isObject())
+      return llvm::None;
+    auto propRes = JSObject::getNamed_RJS(
+        runtime->makeHandle<JSObject>(*consRes), runtime, **symRes);
+    if (propRes == ExecutionStatus::EXCEPTION || !propRes->isSymbol())
+      return llvm::None;
+    return propRes->getSymbol();
+  };
+
+  MutableHandle<JSObject> holder{runtime, runtime->getGlobal().get()};
+  llvm::StringRef rest = path;
+  for (;;) {
+    auto split = rest.split('.');
+    auto name = getSymbol(split.first);
+    if (!name)
+      return llvm::None;
+    if (split.second.empty()) {
+      NamedPropertyDescriptor desc;
+      if (!JSObject::getOwnNamedDescriptor(holder, runtime, *name, desc))
+        return llvm::None;
+      return NativeLibraryFunction{
+          runtime->makeHandle(holder.get()),
+          *name,
+          desc.flags,
+          runtime->makeHandle(
+              JSObject::getNamedSlotValue(holder.get(), runtime, desc))};
+    }
+    auto propRes = JSObject::getNamed_RJS(holder, runtime, *name);
+    if (propRes == ExecutionStatus::EXCEPTION || !propRes->isObject())
+      return llvm::None;
+    holder = vmcast<JSObject>(*propRes);
+    rest = split.second;
+  }
+}
+#endif
+
 void Runtime::runInternalBytecode() {
 #ifdef HERMESVM_USE_JS_LIBRARY_IMPLEMENTATION
+  GCScope scope(this);
+  // Save the native implementations selected to be kept, before the JS
+  // library replaces them. Unknown names are ignored.
+  llvm::SmallVector<NativeLibraryFunction, 4> natives;
+  for (const std::string &path : nativeLibraryFunctions_) {
+    if (auto native = lookupNativeLibraryFunction(this, path))
+      natives.push_back(*native);
+    else
+      LLVM_DEBUG(llvm::dbgs() << "No native builtin " << path << "\n");
+    clearThrownValue();
+  }
+
   auto module = getInternalBytecode();
   auto bcProvider = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
                         llvm::make_unique<Buffer>(module.data(), module.size()))
@@ -967,6 +1232,29 @@ void Runtime::runInternalBytecode() {
   assert(
       res != ExecutionStatus::EXCEPTION && "Internal bytecode threw exception");
   (void)res;
+
+  // Put the kept native implementations back.
+  for (const NativeLibraryFunction &native : natives) {
+    DefinePropertyFlags dpf{};
+    dpf.setEnumerable = 1;
+    dpf.enumerable = native.flags.enumerable;
+    dpf.setConfigurable = 1;
+    dpf.configurable = native.flags.configurable;
+    if (native.flags.accessor) {
+      dpf.setGetter = 1;
+      dpf.setSetter = 1;
+    } else {
+      dpf.setValue = 1;
+      dpf.setWritable = 1;
+      dpf.writable = native.flags.writable;
+    }
+    auto defRes = JSObject::defineOwnProperty(
+        native.holder, this, native.name, dpf, native.value);
+    assert(
+        defRes != ExecutionStatus::EXCEPTION && *defRes &&
+        "Restoring a native builtin failed");
+    (void)defRes;
+  }
 #endif
 }
 
@@ -1279,6 +1567,12 @@ std::unique_ptr<Buffer> Runtime::generateSpecialRuntimeBytecode() {
   return buffer;
 }
 
+std::unique_ptr<Buffer> Runtime::getSharedSpecialRuntimeBytecode() {
+  static const std::unique_ptr<Buffer> shared =
+      generateSpecialRuntimeBytecode();
+  return llvm::make_unique<Buffer>(shared->data(), shared->size());
+}
+
 void Runtime::initPredefinedStrings() {
   assert(!getTopGCScope() && "There shouldn't be any handles allocated yet");
 
@@ -1432,6 +1726,34 @@ ExecutionStatus Runtime::forEachBuiltin(const std::function<ExecutionStatus(
   return ExecutionStatus::RETURNED;
 }
 
+uint32_t Runtime::addLazyBuiltin(
+    JSObject *cons,
+    JSObject *proto,
+    LazyBuiltinInit *init) {
+  lazyBuiltins_.push_back({cons, proto, init});
+  return lazyBuiltins_.size();
+}
+
+Runtime::LazyBuiltin *Runtime::findLazyBuiltin(uint32_t index, JSObject *obj) {
+  if (index == 0 || index > lazyBuiltins_.size())
+    return nullptr;
+  LazyBuiltin &lazy = lazyBuiltins_[index - 1];
+  if (!lazy.init || (lazy.constructor != obj && lazy.prototype != obj))
+    return nullptr;
+  return &lazy;
+}
+
+void Runtime::initializeLazyBuiltins() {
+  GCScope gcScope{this};
+  auto marker = gcScope.createMarker();
+  for (size_t i = 0; i < lazyBuiltins_.size(); ++i) {
+    gcScope.flushToMarker(marker);
+    if (lazyBuiltins_[i].init)
+      JSObject::initializeLazyObject(
+          this, makeHandle(lazyBuiltins_[i].constructor));
+  }
+}
+
 void Runtime::initBuiltinTable() {
   GCScopeMarkerRAII gcScope{this};
 
@@ -1794,12 +2116,22 @@ void Runtime::recordHiddenClass(
     const Inst *cacheMissInst,
     SymbolID symbolID,
     HiddenClass *objectHiddenClass,
-    HiddenClass *cachedHiddenClass) {
+    const PropertyCacheEntry &cacheEntry) {
   auto offset = codeBlock->getOffsetOf(cacheMissInst);
+  auto cacheState = cacheEntry.getState();
+  auto toHiddenClass = [this](PropertyCacheEntry::ClassStorageType clazz) {
+    return vmcast_or_null<HiddenClass>(static_cast<GCCell *>(
+        GCPointerBase::storageTypeToPointer(clazz, this)));
+  };
+  HiddenClass *cachedHiddenClass = toHiddenClass(cacheEntry.clazz);
 
-  // inline caching hit
-  if (objectHiddenClass == cachedHiddenClass) {
-    inlineCacheProfiler_.insertICHit(codeBlock, offset);
+  // inline caching hit, on any of the cached classes
+  bool hit = objectHiddenClass == cachedHiddenClass;
+  for (auto clazz : cacheEntry.polyClazz) {
+    hit = hit || objectHiddenClass == toHiddenClass(clazz);
+  }
+  if (hit) {
+    inlineCacheProfiler_.insertICHit(codeBlock, offset, cacheState);
     return;
   }
 
@@ -1817,7 +2149,12 @@ void Runtime::recordHiddenClass(
   }
   // add the record to inline caching profiler
   inlineCacheProfiler_.insertICMiss(
-      codeBlock, offset, symbolID, objectHiddenClassId, cachedHiddenClassId);
+      codeBlock,
+      offset,
+      symbolID,
+      objectHiddenClassId,
+      cachedHiddenClassId,
+      cacheState);
 }
 
 void Runtime::getInlineCacheProfilerInfo(llvm::raw_ostream &ostream) {
@@ -1919,6 +2256,9 @@ void Runtime::serializeRuntimeFields(Serializer &s) {
   // Ignore for now.
   // TODO: come back later.
 
+  // Field NumberStringCacheEntry numberStringCache_[]: not serialized, the
+  // cache starts empty.
+
   // Field std::vector<PinnedHermesValue> charStrings_{};
   s.writeInt<uint32_t>(charStrings_.size());
   for (auto &str : charStrings_) {
@@ -2113,5 +2453,19 @@ ExecutionStatus Runtime::notifyTimeout() {
   return raiseTimeoutError();
 }
 
+ExecutionStatus Runtime::notifyInterrupt() {
+  if (!interruptHandler_)
+    return ExecutionStatus::RETURNED;
+  if (inInterruptHandler_) {
+    // Keep the request pending, rather than recursing.
+    triggerInterruptAsyncBreak();
+    return ExecutionStatus::RETURNED;
+  }
+  inInterruptHandler_ = true;
+  ExecutionStatus status = interruptHandler_();
+  inInterruptHandler_ = false;
+  return status;
+}
+
 } // namespace vm
 } // namespace hermes
@@ -8,6 +8,7 @@
 #include "hermes/VM/RuntimeModule.h"
 
 #include "hermes/Support/PerfSection.h"
+#include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/CodeBlock.h"
 #include "hermes/VM/Domain.h"
 #include "hermes/VM/HiddenClass.h"
@@ -63,6 +64,17 @@ SymbolID RuntimeModule::createSymbolFromStringIDMayAllocate(
 
 RuntimeModule::~RuntimeModule() {
   runtime_->removeRuntimeModule(this);
+  runtime_->getJITContext().saveProfile(this);
+  runtime_->getJITContext().cancelCompilations(this);
+#ifndef HERMESVM_LEAN
+  if (auto *queue = runtime_->getLazyCompileQueue()) {
+    if (bcProvider_ && bcProvider_->isLazy()) {
+      queue->cancel(((hbc::BCProviderLazy *)bcProvider_.get())
+                        ->getBytecodeFunction()
+                        ->getLazyCompilationData());
+    }
+  }
+#endif
 
   // We may reference other CodeBlocks through lazy compilation, but we only
   // own the ones that reference us.
@@ -94,6 +106,7 @@ CallResult<RuntimeModule *> RuntimeModule::create(
         ExecutionStatus::EXCEPTION) {
       return ExecutionStatus::EXCEPTION;
     }
+    runtime->getJITContext().loadProfile(runtime, result);
   }
   return result;
 }
@@ -127,11 +140,30 @@ CodeBlock *RuntimeModule::getCodeBlockSlowPath(unsigned index) {
   functionMap_[index] = CodeBlock::createCodeBlock(
       this,
       bcProvider_->getFunctionHeader(index),
-      bcProvider_->getBytecode(index),
+      getFunctionBytecode(index),
       index);
   return functionMap_[index];
 }
 
+const uint8_t *RuntimeModule::getFunctionBytecode(unsigned index) {
+  const uint8_t *bytecode = bcProvider_->getBytecode(index);
+#ifdef HERMES_ENABLE_DEBUGGER
+  if (flags_.sharedBytecode) {
+    // Breakpoints are patched into the bytecode, so give the function a
+    // private copy before it can run. Jump tables are found by aligning
+    // addresses, so the copy keeps the alignment of the original.
+    size_t size = bcProvider_->getFunctionHeader(index).bytecodeSizeInBytes();
+    size_t misalign = reinterpret_cast<uintptr_t>(bytecode) % sizeof(uint32_t);
+    auto *copy = static_cast<uint8_t *>(privateBytecodeAllocator_.Allocate(
+                     size + misalign, alignof(uint32_t))) +
+        misalign;
+    std::memcpy(copy, bytecode, size);
+    return copy;
+  }
+#endif
+  return bytecode;
+}
+
 #ifndef HERMESVM_LEAN
 RuntimeModule *RuntimeModule::createLazyModule(
     Runtime *runtime,
@@ -163,6 +195,11 @@ RuntimeModule *RuntimeModule::createLazyModule(
   RM->stringIDMap_.push_back(parent->getSymbolIDFromStringIDMayAllocate(
       bcFunction->getHeader().functionName));
 
+  // The function is about to get a closure, so it is likely to be called soon.
+  if (auto *queue = runtime->getLazyCompileQueue())
+    queue->enqueue(
+        parent->lazyRoot_->bcProvider_, parent->bcProvider_, bcFunction);
+
   return RM;
 }
 
@@ -174,7 +211,7 @@ SymbolID RuntimeModule::getLazyName() {
 }
 
 void RuntimeModule::initializeLazyMayAllocate(
-    std::unique_ptr<hbc::BCProvider> bytecode) {
+    std::shared_ptr<hbc::BCProvider> bytecode) {
   // Clear the old data provider first.
   bcProvider_ = nullptr;
 
@@ -229,11 +266,18 @@ void RuntimeModule::importStringIDMapMayAllocate() {
       translations.size() <= strTableSize &&
       "Should not have more strings than identifiers");
 
-  // Preallocate enough space to store all identifiers to prevent
-  // unnecessary allocations. NOTE: If this module is not the first module,
-  // then this is an underestimate.
-  runtime_->getIdentifierTable().reserve(translations.size());
-  {
+  // Identifiers of a persistent module are mapped on first use by
+  // getSymbolIDMustExist(), since most of those of a large bundle are never
+  // used in a given session.
+  bool eager = !flags_.persistent ||
+      (runtime_->getVMExperimentFlags() & experiments::EagerIdentifiers);
+
+  if (eager) {
+    // Preallocate enough space to store all identifiers to prevent
+    // unnecessary allocations. NOTE: If this module is not the first module,
+    // then this is an underestimate.
+    runtime_->getIdentifierTable().reserve(translations.size());
+
     StringID strID = 0;
     uint32_t trnID = 0;
 
@@ -281,6 +325,14 @@ void RuntimeModule::importStringIDMapMayAllocate() {
   bcProvider_->dontNeedIdentifierTranslations();
 }
 
+SymbolID RuntimeModule::importIdentifier(StringID stringID) {
+  assert(
+      flags_.persistent &&
+      "Identifiers are only mapped on first use in persistent modules");
+  return createSymbolFromStringIDMayAllocate(
+      stringID, bcProvider_->getStringTableEntry(stringID), llvm::None);
+}
+
 void RuntimeModule::initializeFunctionMap() {
   assert(bcProvider_ && "Uninitialized RuntimeModule");
   assert(
@@ -355,6 +407,11 @@ void RuntimeModule::markRoots(SlotAcceptor &acceptor, bool markLongLived) {
   for (auto &it : templateMap_) {
     acceptor.acceptPtr(it.second);
   }
+  for (auto &it : literalValues_) {
+    if (it.second) {
+      acceptor.acceptPtr(it.second);
+    }
+  }
 
   if (markLongLived) {
     for (auto symbol : stringIDMap_) {
@@ -371,6 +428,7 @@ void RuntimeModule::markWeakRoots(WeakRootAcceptor &acceptor) {
     // previously in this top-level markRoots invocation.
     if (cbPtr != nullptr && cbPtr->getRuntimeModule() == this) {
       cbPtr->markCachedHiddenClasses(runtime_, acceptor);
+      cbPtr->markLastConstructed(acceptor);
     }
   }
   for (auto &entry : objectLiteralHiddenClasses_) {
@@ -411,6 +469,40 @@ void RuntimeModule::tryCacheLiteralHiddenClass(
   }
 }
 
+ArrayStorage *RuntimeModule::getLiteralValuesMayAllocate(
+    LiteralValueBuffer buffer,
+    uint32_t bufferIndex,
+    unsigned numLiterals) {
+  auto key = getLiteralValuesKey(buffer, bufferIndex, numLiterals);
+  auto it = literalValues_.find(key);
+  if (it == literalValues_.end()) {
+    literalValues_[key] = nullptr;
+    return nullptr;
+  }
+  if (it->second) {
+    return it->second;
+  }
+
+  auto values = runtime_->makeHandle<ArrayStorage>(
+      runtime_->ignoreAllocationFailure(
+          ArrayStorage::create(runtime_, numLiterals, numLiterals)));
+  SerializedLiteralParser parser{
+      buffer == LiteralValueBuffer::Array
+          ? bcProvider_->getArrayBuffer().slice(bufferIndex)
+          : bcProvider_->getObjectValueBuffer().slice(bufferIndex),
+      numLiterals,
+      this};
+  GCScopeMarkerRAII marker{runtime_};
+  for (unsigned i = 0; parser.hasNext(); ++i) {
+    // Decode the value first, since decoding a string may allocate.
+    auto value = parser.get(runtime_);
+    values->at(i).set(value, &runtime_->getHeap());
+    marker.flush();
+  }
+  it->second = values.get();
+  return values.get();
+}
+
 #ifdef HERMESVM_SERIALIZE
 RuntimeModule::RuntimeModule(Runtime *runtime, WeakRefSlot *domainSlot)
     : runtime_(runtime), domain_(domainSlot) {
@@ -444,7 +536,8 @@ void RuntimeModule::serialize(Serializer &s) {
   s.writeInt<size_t>(sourceURL_.size());
   // Write string contents, not including null at the end.
   s.writeData(sourceURL_.data(), sourceURL_.size());
-  // TODO: objectLiteralHiddenClasses_ and templateMap_ are effectively caches.
+  // TODO: objectLiteralHiddenClasses_, templateMap_ and literalValues_ are
+  // effectively caches.
   // We may want to Serialize/Deserialize them too. But for now let's skip them.
 
   s.endObject(this);
@@ -485,10 +578,7 @@ RuntimeModule *RuntimeModule::deserialize(Deserializer &d) {
 #endif
 
 size_t RuntimeModule::additionalMemorySize() const {
-  size_t total = stringIDMap_.capacity() * sizeof(SymbolID) +
-      functionMap_.capacity() * sizeof(CodeBlock *) +
-      objectLiteralHiddenClasses_.getMemorySize() +
-      templateMap_.getMemorySize();
+  size_t total = tableMemorySize();
   // Add the size of each CodeBlock
   for (const CodeBlock *cb : functionMap_) {
     // Skip the null code blocks, they are lazily inserted the first time
@@ -501,6 +591,25 @@ size_t RuntimeModule::additionalMemorySize() const {
   return total;
 }
 
+size_t RuntimeModule::tableMemorySize() const {
+  return stringIDMap_.capacity() * sizeof(SymbolID) +
+      functionMap_.capacity() * sizeof(CodeBlock *) +
+      objectLiteralHiddenClasses_.getMemorySize() +
+      templateMap_.getMemorySize() + literalValues_.getMemorySize();
+}
+
+size_t RuntimeModule::codeBlockMemorySize() const {
+  size_t total = 0;
+  for (const CodeBlock *cb : functionMap_) {
+    if (cb && cb->getRuntimeModule() == this)
+      total += sizeof(CodeBlock);
+  }
+#ifdef HERMES_ENABLE_DEBUGGER
+  total += privateBytecodeAllocator_.getTotalMemory();
+#endif
+  return total;
+}
+
 namespace detail {
 
 StringID mapStringMayAllocate(RuntimeModule &module, const char *str) {
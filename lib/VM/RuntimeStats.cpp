@@ -29,6 +29,7 @@ RuntimeStats::Sampled RAIITimer::trySampling() const {
       !oscompat::num_context_switches(
           result.volCtxSwitches, result.involCtxSwitches))
     return {};
+  PerfEvents::readThreadCounters(result.hardware);
   return result;
 }
 
@@ -63,6 +64,7 @@ void RAIITimer::flush() {
       currentSampled.volCtxSwitches - sampledStart_.volCtxSwitches;
   stat_.sampled.involCtxSwitches +=
       currentSampled.involCtxSwitches - sampledStart_.involCtxSwitches;
+  stat_.sampled.hardware += currentSampled.hardware - sampledStart_.hardware;
   wallTimeStart_ = currentWallTime;
   cpuTimeStart_ = currentCPUTime;
   sampledStart_ = currentSampled;
@@ -228,6 +228,32 @@ void SegmentedArray::resizeWithinCapacity(
   }
 }
 
+void SegmentedArray::setRange(
+    Runtime *runtime,
+    size_type index,
+    GCHermesValue *first,
+    GCHermesValue *last) {
+  assert(index + (last - first) <= size() && "range exceeds the size");
+  GC *gc = &runtime->getHeap();
+  if (index < kValueToSegmentThreshold) {
+    size_type count = std::min<size_type>(
+        last - first, kValueToSegmentThreshold - index);
+    GCHermesValue::uninitialized_copy(
+        first, first + count, inlineStorage() + index, gc);
+    first += count;
+    index += count;
+  }
+  while (first != last) {
+    InteriorIndex interior = toInterior(index);
+    size_type count =
+        std::min<size_type>(last - first, Segment::kMaxLength - interior);
+    GCHermesValue::uninitialized_copy(
+        first, first + count, &segmentAt(toSegment(index))->at(interior), gc);
+    first += count;
+    index += count;
+  }
+}
+
 ExecutionStatus SegmentedArray::throwExcessiveCapacityError(
     Runtime *runtime,
     size_type capacity) {
@@ -28,9 +28,11 @@ void dumpStackFrame(
   OS << "  PreviousFrame   : " << format_ptr(frame.getPreviousFramePointer())
      << "\n"
      << "  SavedIP         : " << format_ptr(frame.getSavedIP()) << "\n"
-     << "  SavedCodeBlock  : " << format_ptr(frame.getSavedCodeBlock()) << "\n"
-     << "  DebugEnvironment: " << frame.getDebugEnvironmentRef() << "\n"
-     << "  ArgCount        : " << frame.getArgCount() << "\n"
+     << "  SavedCodeBlock  : " << format_ptr(frame.getSavedCodeBlock()) << "\n";
+#ifdef HERMES_ENABLE_DEBUGGER
+  OS << "  DebugEnvironment: " << frame.getDebugEnvironmentRef() << "\n";
+#endif
+  OS << "  ArgCount        : " << frame.getArgCount() << "\n"
      << "  NewTarget       : " << frame.getNewTargetRef() << "\n"
      << "  CalleeClosure   : " << frame.getCalleeClosureOrCBRef() << "\n"
      << "  ThisArg         : " << frame.getThisArgRef() << "\n"
@@ -17,8 +17,11 @@
 #include "llvm/Support/MathExtras.h"
 
 #include <cassert>
+#include <cstring>
 #include <limits>
+#include <mutex>
 #include <stack>
+#include <vector>
 
 namespace hermes {
 namespace vm {
@@ -36,8 +39,151 @@ char *alignAlloc(void *p) {
 
 class VMAllocateStorageProvider final : public StorageProvider {
  public:
+  explicit VMAllocateStorageProvider(HugePagesMode hugePages);
+
+  llvm::ErrorOr<void *> newStorage(const char *name) override;
+  void deleteStorage(void *storage) override;
+
+ private:
+  /// Allocate a storage, backed by explicit huge pages if they are requested
+  /// and available.
+  llvm::ErrorOr<void *> allocate();
+
+  /// How the storages are backed by huge pages.  Downgraded from explicit to
+  /// transparent once explicit huge pages fail to be allocated, so that later
+  /// storages do not retry.
+  HugePagesMode hugePages_;
+};
+
+/// The storages deleted by pooled providers, retained for reuse up to a limit.
+/// Shared by every runtime in the process.
+class StoragePool {
+ public:
+  /// \return the pool of the process.  It is never destroyed, so that
+  /// runtimes destroyed during static destruction can still release their
+  /// storages.
+  static StoragePool &get() {
+    static StoragePool *pool = new StoragePool();
+    return *pool;
+  }
+
+  /// See StorageProvider::configureStoragePool.
+  void configure(size_t maxBytes, StoragePoolZeroing zeroing) {
+    std::vector<void *> excess;
+    {
+      std::lock_guard<std::mutex> lk{mtx_};
+      maxStorages_ = maxBytes / AlignedStorage::size();
+      zeroing_ = zeroing;
+      takeExcess(excess);
+    }
+    unmap(excess);
+  }
+
+  /// \return a retained storage, or null if there is none.
+  void *take() {
+    std::lock_guard<std::mutex> lk{mtx_};
+    if (storages_.empty()) {
+      return nullptr;
+    }
+    void *storage = storages_.back();
+    storages_.pop_back();
+    return storage;
+  }
+
+  /// Retain \p storage for reuse if the pool has room for it, otherwise
+  /// unmap it.
+  void give(void *storage) {
+    StoragePoolZeroing zeroing;
+    {
+      std::lock_guard<std::mutex> lk{mtx_};
+      if (storages_.size() >= maxStorages_) {
+        unmap(storage);
+        return;
+      }
+      zeroing = zeroing_;
+    }
+    // Zero the storage without holding the lock.
+    switch (zeroing) {
+      case StoragePoolZeroing::None:
+        break;
+      case StoragePoolZeroing::Eager:
+        std::memset(storage, 0, AlignedStorage::size());
+        break;
+      case StoragePoolZeroing::Release:
+        oscompat::vm_unused(storage, AlignedStorage::size());
+        break;
+    }
+    oscompat::vm_name(storage, AlignedStorage::size(), "hermes-storage-pool");
+    std::lock_guard<std::mutex> lk{mtx_};
+    // The pool may have filled up, or shrunk, in the meantime.
+    if (storages_.size() >= maxStorages_) {
+      unmap(storage);
+      return;
+    }
+    storages_.push_back(storage);
+  }
+
+  /// See StorageProvider::storagePoolBytes.
+  size_t bytes() {
+    std::lock_guard<std::mutex> lk{mtx_};
+    return storages_.size() * AlignedStorage::size();
+  }
+
+  /// See StorageProvider::drainStoragePool.
+  size_t drain() {
+    std::vector<void *> storages;
+    {
+      std::lock_guard<std::mutex> lk{mtx_};
+      storages.swap(storages_);
+    }
+    unmap(storages);
+    return storages.size() * AlignedStorage::size();
+  }
+
+ private:
+  StoragePool() = default;
+
+  /// Move the storages beyond the limit into \p excess.
+  /// \pre mtx_ is held.
+  void takeExcess(std::vector<void *> &excess) {
+    while (storages_.size() > maxStorages_) {
+      excess.push_back(storages_.back());
+      storages_.pop_back();
+    }
+  }
+
+  static void unmap(void *storage) {
+    oscompat::vm_free_aligned(storage, AlignedStorage::size());
+  }
+
+  static void unmap(const std::vector<void *> &storages) {
+    for (void *storage : storages) {
+      unmap(storage);
+    }
+  }
+
+  std::mutex mtx_;
+
+  /// The retained storages.
+  std::vector<void *> storages_;
+
+  size_t maxStorages_{StorageProvider::kDefaultStoragePoolMaxBytes /
+                      AlignedStorage::size()};
+
+  StoragePoolZeroing zeroing_{StoragePoolZeroing::None};
+};
+
+class PooledStorageProvider final : public StorageProvider {
+ public:
+  explicit PooledStorageProvider(HugePagesMode hugePages)
+      : delegate_(hugePages) {}
+
   llvm::ErrorOr<void *> newStorage(const char *name) override;
   void deleteStorage(void *storage) override;
+
+ private:
+  /// Maps the storages that the pool cannot provide.
+  VMAllocateStorageProvider delegate_;
 };
 
 class MallocStorageProvider final : public StorageProvider {
@@ -80,11 +226,38 @@ class PreAllocatedStorageProvider final : public StorageProvider {
   std::stack<char *, std::vector<char *>> freeList_;
 };
 
-llvm::ErrorOr<void *> VMAllocateStorageProvider::newStorage(const char *name) {
-  assert(AlignedStorage::size() % oscompat::page_size() == 0);
+VMAllocateStorageProvider::VMAllocateStorageProvider(HugePagesMode hugePages)
+    : hugePages_(hugePages) {
+  // Huge pages only help if whole huge pages fit in, and are aligned within, a
+  // storage.
+  if (AlignedStorage::size() % oscompat::huge_page_size() != 0) {
+    hugePages_ = kHugePagesNone;
+  }
+}
+
+llvm::ErrorOr<void *> VMAllocateStorageProvider::allocate() {
+  if (hugePages_ == kHugePagesExplicit) {
+    auto result = oscompat::vm_allocate_huge_aligned(
+        AlignedStorage::size(), AlignedStorage::size());
+    if (result) {
+      return result;
+    }
+    // The reserved huge pages have run out, or were never configured.
+    hugePages_ = kHugePagesTransparent;
+  }
   // Allocate the space, hoping it will be the correct alignment.
   auto result = oscompat::vm_allocate_aligned(
       AlignedStorage::size(), AlignedStorage::size());
+  if (result && hugePages_ == kHugePagesTransparent) {
+    // Failure just means the storage is backed by normal pages.
+    oscompat::vm_hugepage(*result, AlignedStorage::size());
+  }
+  return result;
+}
+
+llvm::ErrorOr<void *> VMAllocateStorageProvider::newStorage(const char *name) {
+  assert(AlignedStorage::size() % oscompat::page_size() == 0);
+  auto result = allocate();
   if (!result) {
     return result;
   }
@@ -104,6 +277,21 @@ void VMAllocateStorageProvider::deleteStorage(void *storage) {
   oscompat::vm_free_aligned(storage, AlignedStorage::size());
 }
 
+llvm::ErrorOr<void *> PooledStorageProvider::newStorage(const char *name) {
+  if (void *storage = StoragePool::get().take()) {
+    oscompat::vm_name(storage, AlignedStorage::size(), name);
+    return storage;
+  }
+  return delegate_.newStorage(name);
+}
+
+void PooledStorageProvider::deleteStorage(void *storage) {
+  if (!storage) {
+    return;
+  }
+  StoragePool::get().give(storage);
+}
+
 llvm::ErrorOr<void *> MallocStorageProvider::newStorage(const char *name) {
   // name is unused, can't name malloc memory.
   (void)name;
@@ -208,8 +396,36 @@ StorageProvider::preAllocatedProvider(
 }
 
 /* static */
-std::unique_ptr<StorageProvider> StorageProvider::mmapProvider() {
-  return std::unique_ptr<StorageProvider>(new VMAllocateStorageProvider);
+std::unique_ptr<StorageProvider> StorageProvider::mmapProvider(
+    HugePagesMode hugePages) {
+  return std::unique_ptr<StorageProvider>(
+      new VMAllocateStorageProvider(hugePages));
+}
+
+/* static */
+std::unique_ptr<StorageProvider> StorageProvider::pooledProvider(
+    HugePagesMode hugePages) {
+  return std::unique_ptr<StorageProvider>(
+      new PooledStorageProvider(hugePages));
+}
+
+constexpr size_t StorageProvider::kDefaultStoragePoolMaxBytes;
+
+/* static */
+void StorageProvider::configureStoragePool(
+    size_t maxBytes,
+    StoragePoolZeroing zeroing) {
+  StoragePool::get().configure(maxBytes, zeroing);
+}
+
+/* static */
+size_t StorageProvider::storagePoolBytes() {
+  return StoragePool::get().bytes();
+}
+
+/* static */
+size_t StorageProvider::drainStoragePool() {
+  return StoragePool::get().drain();
 }
 
 /* static */
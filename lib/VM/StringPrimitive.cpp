@@ -16,6 +16,8 @@
 #include "hermes/VM/StringBuilder.h"
 #include "hermes/VM/StringView.h"
 
+#include <algorithm>
+
 namespace hermes {
 namespace vm {
 
@@ -146,9 +148,9 @@ void serializeExternalStringImpl(Serializer &s, const GCCell *cell) {
           .unsafeGetRaw());
   // Writes the actual string.
   s.writeData(self->getRawPointer(), self->getStringLength() * sizeof(T));
-  // contents_.data() is tracked by IDTracker for heapsnapshot. We should do
-  // relocation for it.
-  s.endObject((void *)self->contents_.data());
+  // The characters are tracked by IDTracker for heapsnapshot. We should do
+  // relocation for them.
+  s.endObject((void *)self->getRawPointer());
 
   s.endObject(cell);
 }
@@ -404,6 +406,17 @@ CallResult<HermesValue> StringPrimitive::slice(
   assert(
       start + length <= str->getStringLength() && "Invalid length for slice");
 
+  if (length >= SLICE_STRING_MIN_SIZE) {
+    if (str->isASCII()) {
+      if (BufferedASCIIStringPrimitive::canSlice(str.get(), length))
+        return BufferedASCIIStringPrimitive::slice(runtime, str, start, length)
+            .getHermesValue();
+    } else if (BufferedUTF16StringPrimitive::canSlice(str.get(), length)) {
+      return BufferedUTF16StringPrimitive::slice(runtime, str, start, length)
+          .getHermesValue();
+    }
+  }
+
   SafeUInt32 safeLen(length);
 
   auto builder =
@@ -565,6 +578,45 @@ CallResult<HermesValue> ExternalStringPrimitive<T>::create(
   return res;
 }
 
+template <typename T>
+ExternalStringPrimitive<T>::ExternalStringPrimitive(
+    Runtime *runtime,
+    uint32_t length,
+    std::unique_ptr<Foreign> foreign)
+    : SymbolStringPrimitive(
+          runtime,
+          &vt,
+          cellSize<ExternalStringPrimitive<T>>(),
+          length),
+      foreign_(std::move(foreign)) {
+  assert(
+      getStringLength() >= EXTERNAL_STRING_MIN_SIZE &&
+      "ExternalStringPrimitive length must be at least EXTERNAL_STRING_MIN_SIZE");
+}
+
+template <typename T>
+CallResult<HermesValue> ExternalStringPrimitive<T>::createForeign(
+    Runtime *runtime,
+    const T *chars,
+    uint32_t length,
+    std::function<void()> release) {
+  if (LLVM_UNLIKELY(length > MAX_STRING_LENGTH)) {
+    if (release)
+      release();
+    return runtime->raiseRangeError("String length exceeds limit");
+  }
+  // Own the characters first, so that they are released if the cell cannot
+  // be allocated.
+  auto foreign = llvm::make_unique<Foreign>(chars, std::move(release));
+  void *mem = runtime->alloc</*fixedSize*/ true, HasFinalizer::Yes>(
+      cellSize<ExternalStringPrimitive<T>>());
+  auto *extStr = new (mem)
+      ExternalStringPrimitive<T>(runtime, length, std::move(foreign));
+  runtime->getHeap().creditExternalMemory(
+      extStr, extStr->calcExternalMemorySize());
+  return HermesValue::encodeStringValue(extStr);
+}
+
 template <typename T>
 CallResult<HermesValue> ExternalStringPrimitive<T>::createLongLived(
     Runtime *runtime,
@@ -604,7 +656,7 @@ void ExternalStringPrimitive<T>::_finalizeImpl(GCCell *cell, GC *gc) {
   ExternalStringPrimitive<T> *self = vmcast<ExternalStringPrimitive<T>>(cell);
   // Remove the external string from the snapshot tracking system if it's being
   // tracked.
-  gc->getIDTracker().untrackNative(self->contents_.data());
+  gc->getIDTracker().untrackNative(self->getRawPointer());
   gc->debitExternalMemory(self, self->calcExternalMemorySize());
   self->~ExternalStringPrimitive<T>();
 }
@@ -631,7 +683,7 @@ void ExternalStringPrimitive<T>::_snapshotAddEdgesImpl(
   snap.addNamedEdge(
       HeapSnapshot::EdgeType::Internal,
       "externalString",
-      gc->getNativeID(self->contents_.data()));
+      gc->getNativeID(self->getRawPointer()));
 }
 
 template <typename T>
@@ -644,8 +696,8 @@ void ExternalStringPrimitive<T>::_snapshotAddNodesImpl(
   snap.endNode(
       HeapSnapshot::NodeType::Native,
       "ExternalStringPrimitive",
-      gc->getNativeID(self->contents_.data()),
-      self->contents_.size());
+      gc->getNativeID(self->getRawPointer()),
+      self->bufferSize());
 }
 
 template class ExternalStringPrimitive<char16_t>;
@@ -671,11 +723,46 @@ template <typename T>
 PseudoHandle<StringPrimitive> BufferedStringPrimitive<T>::create(
     Runtime *runtime,
     uint32_t length,
-    Handle<ExternalStringPrimitive<T>> storage) {
+    Handle<ExternalStringPrimitive<T>> storage,
+    uint32_t offset) {
   void *mem = runtime->alloc</*fixedSize*/ true, HasFinalizer::No>(
       sizeof(BufferedStringPrimitive<T>));
-  return createPseudoHandle<StringPrimitive>(
-      new (mem) BufferedStringPrimitive<T>(runtime, length, storage.get()));
+  return createPseudoHandle<StringPrimitive>(new (mem)
+      BufferedStringPrimitive<T>(runtime, length, storage.get(), offset));
+}
+
+template <typename T>
+ExternalStringPrimitive<T> *BufferedStringPrimitive<T>::getSliceBuffer(
+    const StringPrimitive *str) {
+  if (auto *buffered = dyn_vmcast<BufferedStringPrimitive<T>>(str))
+    return buffered->getConcatBuffer();
+  return dyn_vmcast<ExternalStringPrimitive<T>>(str);
+}
+
+template <typename T>
+bool BufferedStringPrimitive<T>::canSlice(
+    const StringPrimitive *str,
+    uint32_t length) {
+  auto *buffer = getSliceBuffer(str);
+  // Copy the slice rather than keep alive a much longer buffer.
+  return buffer && buffer->bufferSize() / SLICE_MAX_BUFFER_RATIO <= length;
+}
+
+template <typename T>
+PseudoHandle<StringPrimitive> BufferedStringPrimitive<T>::slice(
+    Runtime *runtime,
+    Handle<StringPrimitive> strHnd,
+    uint32_t start,
+    uint32_t length) {
+  assert(canSlice(strHnd.get(), length) && "slice must share the buffer");
+  uint32_t offset = start;
+  if (auto *buffered = dyn_vmcast<BufferedStringPrimitive<T>>(strHnd.get()))
+    offset += buffered->offset_;
+  return create(
+      runtime,
+      length,
+      runtime->makeHandle(getSliceBuffer(strHnd.get())),
+      offset);
 }
 
 #ifndef NDEBUG
@@ -715,7 +802,8 @@ template <typename T>
 PseudoHandle<StringPrimitive> BufferedStringPrimitive<T>::create(
     Runtime *runtime,
     Handle<StringPrimitive> leftHnd,
-    Handle<StringPrimitive> rightHnd) {
+    Handle<StringPrimitive> rightHnd,
+    size_t capacity) {
   typename ExternalStringPrimitive<T>::CopyableStdString contents{};
   uint32_t len;
 
@@ -727,7 +815,7 @@ PseudoHandle<StringPrimitive> BufferedStringPrimitive<T>::create(
     assertValidLength(left, right);
     len = left->getStringLength() + right->getStringLength();
 
-    contents.reserve(len);
+    contents.reserve(std::max<size_t>(len, capacity));
     appendToCopyableString(contents, left);
     appendToCopyableString(contents, right);
   }
@@ -755,19 +843,34 @@ PseudoHandle<StringPrimitive> BufferedStringPrimitive<T>::append(
       "cannot append UTF16 to ASCII");
 
   // Can't append if this is not the end of the string.
-  if (self->getStringLength() != storage->contents_.size()) {
+  if (!self->endsConcatBuffer()) {
     noAlloc.release();
     return BufferedStringPrimitive<T>::create(runtime, selfHnd, rightHnd);
   }
 
+  // Don't grow a large buffer in place, since the earlier stages of the chain
+  // keep it alive: start a new one with twice the room, copying as much as
+  // growing would.
+  size_t newSize = storage->contents_.size() + right->getStringLength();
+  if (newSize > storage->contents_.capacity() &&
+      storage->contents_.size() >= NEW_BUFFER_MIN_SIZE) {
+    noAlloc.release();
+    return BufferedStringPrimitive<T>::create(
+        runtime, selfHnd, rightHnd, newSize * 2);
+  }
+
   auto oldExternalMem = storage->calcExternalMemorySize();
   appendToCopyableString(storage->contents_, right);
   runtime->getHeap().creditExternalMemory(
       storage, storage->calcExternalMemorySize() - oldExternalMem);
 
+  uint32_t offset = self->offset_;
   noAlloc.release();
   return BufferedStringPrimitive<T>::create(
-      runtime, storage->contents_.size(), runtime->makeHandle(storage));
+      runtime,
+      storage->contents_.size() - offset,
+      runtime->makeHandle(storage),
+      offset);
 }
 
 PseudoHandle<StringPrimitive> internalConcatStringPrimitives(
@@ -781,8 +884,7 @@ PseudoHandle<StringPrimitive> internalConcatStringPrimitives(
 
   if (left->isASCII() && right->isASCII()) {
     if (auto *bufLeft = dyn_vmcast<BufferedASCIIStringPrimitive>(left)) {
-      if (bufLeft->getStringLength() ==
-          bufLeft->getConcatBuffer()->contents_.size())
+      if (bufLeft->endsConcatBuffer())
         return BufferedASCIIStringPrimitive::append(
             Handle<BufferedASCIIStringPrimitive>::vmcast(leftHnd),
             runtime,
@@ -791,8 +893,7 @@ PseudoHandle<StringPrimitive> internalConcatStringPrimitives(
     return BufferedASCIIStringPrimitive::create(runtime, leftHnd, rightHnd);
   } else {
     if (auto *bufLeft = dyn_vmcast<BufferedUTF16StringPrimitive>(left)) {
-      if (bufLeft->getStringLength() ==
-          bufLeft->getConcatBuffer()->contents_.size()) {
+      if (bufLeft->endsConcatBuffer()) {
         return BufferedUTF16StringPrimitive::append(
             Handle<BufferedUTF16StringPrimitive>::vmcast(leftHnd),
             runtime,
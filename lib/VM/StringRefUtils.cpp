@@ -16,8 +16,17 @@
 
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/ConvertUTF.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace hermes {
 namespace vm {
 
@@ -25,6 +34,238 @@ using llvm::ConversionResult;
 using llvm::UTF16;
 using llvm::UTF8;
 
+namespace {
+
+#if defined(__SSE2__) || defined(__aarch64__)
+#define HERMES_STRING_VECTORS
+
+/// Compares a vector of characters of type T at once.
+template <typename T>
+struct CharVector;
+
+/// The result of CharVector<T>::matchPairs() has kBitsPerLane bits set for
+/// every lane which matched, and clear for the others.
+template <>
+struct CharVector<char> {
+  static constexpr unsigned kLanes = 16;
+#if defined(__SSE2__)
+  static constexpr unsigned kBitsPerLane = 1;
+#else
+  static constexpr unsigned kBitsPerLane = 4;
+#endif
+
+  /// \return the mask of the lanes i where \p a[i] is \p x and \p b[i] is
+  /// \p y.
+  static uint64_t matchPairs(const char *a, const char *b, char x, char y) {
+#if defined(__SSE2__)
+    __m128i eq = _mm_and_si128(
+        _mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(a)),
+            _mm_set1_epi8(x)),
+        _mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(b)),
+            _mm_set1_epi8(y)));
+    return static_cast<unsigned>(_mm_movemask_epi8(eq));
+#else
+    uint8x16_t eq = vandq_u8(
+        vceqq_u8(
+            vld1q_u8(reinterpret_cast<const uint8_t *>(a)),
+            vdupq_n_u8(static_cast<uint8_t>(x))),
+        vceqq_u8(
+            vld1q_u8(reinterpret_cast<const uint8_t *>(b)),
+            vdupq_n_u8(static_cast<uint8_t>(y))));
+    // Narrow every byte to a nibble, since NEON has no movemask.
+    return vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+#endif
+  }
+};
+
+template <>
+struct CharVector<char16_t> {
+  static constexpr unsigned kLanes = 8;
+#if defined(__SSE2__)
+  static constexpr unsigned kBitsPerLane = 2;
+#else
+  static constexpr unsigned kBitsPerLane = 8;
+#endif
+
+  static uint64_t
+  matchPairs(const char16_t *a, const char16_t *b, char16_t x, char16_t y) {
+#if defined(__SSE2__)
+    __m128i eq = _mm_and_si128(
+        _mm_cmpeq_epi16(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(a)),
+            _mm_set1_epi16(static_cast<short>(x))),
+        _mm_cmpeq_epi16(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(b)),
+            _mm_set1_epi16(static_cast<short>(y))));
+    return static_cast<unsigned>(_mm_movemask_epi8(eq));
+#else
+    uint16x8_t eq = vandq_u16(
+        vceqq_u16(
+            vld1q_u16(reinterpret_cast<const uint16_t *>(a)), vdupq_n_u16(x)),
+        vceqq_u16(
+            vld1q_u16(reinterpret_cast<const uint16_t *>(b)), vdupq_n_u16(y)));
+    return vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(eq)), 0);
+#endif
+  }
+};
+
+/// \return the mask of the lane \p lane of a CharVector<T>.
+template <typename T>
+inline uint64_t laneMask(unsigned lane) {
+  return ((uint64_t(1) << CharVector<T>::kBitsPerLane) - 1)
+      << (lane * CharVector<T>::kBitsPerLane);
+}
+#endif // __SSE2__ || __aarch64__
+
+/// \return whether \p c can be a character of type T, so that it may be
+/// compared a vector at a time.
+template <typename T>
+inline bool fitsChar(char16_t c) {
+  return c <= static_cast<char16_t>(std::numeric_limits<T>::max());
+}
+
+} // anonymous namespace
+
+bool stringRefEquals(ASCIIRef str1, UTF16Ref str2) {
+  if (str1.size() != str2.size()) {
+    return false;
+  }
+  const char *a = str1.data();
+  const char16_t *b = str2.data();
+  size_t i = 0;
+  size_t size = str1.size();
+#if defined(__SSE2__)
+  for (; i + 16 <= size; i += 16) {
+    // Widen 16 ASCII characters to two vectors of UTF-16 ones.
+    __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+    __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_cmpeq_epi16(
+        _mm_unpacklo_epi8(chars, zero),
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i)));
+    __m128i hi = _mm_cmpeq_epi16(
+        _mm_unpackhi_epi8(chars, zero),
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i + 8)));
+    if (_mm_movemask_epi8(_mm_and_si128(lo, hi)) != 0xffff)
+      return false;
+  }
+#elif defined(__aarch64__)
+  for (; i + 16 <= size; i += 16) {
+    uint8x16_t chars = vld1q_u8(reinterpret_cast<const uint8_t *>(a + i));
+    uint16x8_t lo = vceqq_u16(
+        vmovl_u8(vget_low_u8(chars)),
+        vld1q_u16(reinterpret_cast<const uint16_t *>(b + i)));
+    uint16x8_t hi = vceqq_u16(
+        vmovl_u8(vget_high_u8(chars)),
+        vld1q_u16(reinterpret_cast<const uint16_t *>(b + i + 8)));
+    if (vminvq_u16(vandq_u16(lo, hi)) != 0xffff)
+      return false;
+  }
+#endif
+  return std::equal(a + i, a + size, b + i);
+}
+
+template <typename T1, typename T2>
+llvm::Optional<uint32_t> stringRefFind(
+    llvm::ArrayRef<T1> haystack,
+    llvm::ArrayRef<T2> needle,
+    uint32_t start) {
+  size_t size = haystack.size();
+  size_t needleSize = needle.size();
+  if (start > size || size - start < needleSize)
+    return llvm::None;
+  if (needleSize == 0)
+    return start;
+
+  const T1 *chars = haystack.data();
+  char16_t first = needle.front();
+  char16_t last = needle.back();
+  size_t i = start;
+#ifdef HERMES_STRING_VECTORS
+  using Vector = CharVector<T1>;
+  if (fitsChar<T1>(first) && fitsChar<T1>(last)) {
+    // Each candidate is verified against the whole needle.
+    for (; i + needleSize - 1 + Vector::kLanes <= size; i += Vector::kLanes) {
+      uint64_t mask = Vector::matchPairs(
+          chars + i, chars + i + needleSize - 1, first, last);
+      while (mask) {
+        unsigned lane = llvm::countTrailingZeros(mask) / Vector::kBitsPerLane;
+        if (std::equal(needle.begin(), needle.end(), chars + i + lane))
+          return i + lane;
+        mask &= ~laneMask<T1>(lane);
+      }
+    }
+  }
+#endif
+  for (; i + needleSize <= size; ++i) {
+    if (chars[i] == first &&
+        std::equal(needle.begin(), needle.end(), chars + i))
+      return i;
+  }
+  return llvm::None;
+}
+
+template <typename T1, typename T2>
+llvm::Optional<uint32_t> stringRefFindLast(
+    llvm::ArrayRef<T1> haystack,
+    llvm::ArrayRef<T2> needle,
+    uint32_t end) {
+  size_t limit = std::min<size_t>(haystack.size(), end);
+  size_t needleSize = needle.size();
+  if (limit < needleSize)
+    return llvm::None;
+  if (needleSize == 0)
+    return limit;
+
+  const T1 *chars = haystack.data();
+  char16_t first = needle.front();
+  char16_t last = needle.back();
+  // The number of positions which are still candidates.
+  size_t count = limit - needleSize + 1;
+#ifdef HERMES_STRING_VECTORS
+  using Vector = CharVector<T1>;
+  if (fitsChar<T1>(first) && fitsChar<T1>(last)) {
+    for (; count >= Vector::kLanes; count -= Vector::kLanes) {
+      size_t base = count - Vector::kLanes;
+      uint64_t mask = Vector::matchPairs(
+          chars + base, chars + base + needleSize - 1, first, last);
+      while (mask) {
+        unsigned lane =
+            (63 - llvm::countLeadingZeros(mask)) / Vector::kBitsPerLane;
+        if (std::equal(needle.begin(), needle.end(), chars + base + lane))
+          return base + lane;
+        mask &= ~laneMask<T1>(lane);
+      }
+    }
+  }
+#endif
+  while (count-- > 0) {
+    if (chars[count] == first &&
+        std::equal(needle.begin(), needle.end(), chars + count))
+      return count;
+  }
+  return llvm::None;
+}
+
+template llvm::Optional<uint32_t>
+stringRefFind(ASCIIRef haystack, ASCIIRef needle, uint32_t start);
+template llvm::Optional<uint32_t>
+stringRefFind(ASCIIRef haystack, UTF16Ref needle, uint32_t start);
+template llvm::Optional<uint32_t>
+stringRefFind(UTF16Ref haystack, ASCIIRef needle, uint32_t start);
+template llvm::Optional<uint32_t>
+stringRefFind(UTF16Ref haystack, UTF16Ref needle, uint32_t start);
+template llvm::Optional<uint32_t>
+stringRefFindLast(ASCIIRef haystack, ASCIIRef needle, uint32_t end);
+template llvm::Optional<uint32_t>
+stringRefFindLast(ASCIIRef haystack, UTF16Ref needle, uint32_t end);
+template llvm::Optional<uint32_t>
+stringRefFindLast(UTF16Ref haystack, ASCIIRef needle, uint32_t end);
+template llvm::Optional<uint32_t>
+stringRefFindLast(UTF16Ref haystack, UTF16Ref needle, uint32_t end);
+
 UTF16Ref createUTF16Ref(const char16_t *str) {
   return UTF16Ref(str, utf16_traits::length(str));
 }
@@ -28,6 +28,44 @@ UTF16Ref StringView::getUTF16Ref(
   return UTF16Ref(ptr, length());
 }
 
+llvm::Optional<uint32_t> StringView::find(
+    const StringView &needle,
+    uint32_t start) const {
+  if (isASCII()) {
+    ASCIIRef haystack(castToCharPtr(), length());
+    if (needle.isASCII())
+      return stringRefFind(
+          haystack, ASCIIRef(needle.castToCharPtr(), needle.length()), start);
+    return stringRefFind(
+        haystack, UTF16Ref(needle.castToChar16Ptr(), needle.length()), start);
+  }
+  UTF16Ref haystack(castToChar16Ptr(), length());
+  if (needle.isASCII())
+    return stringRefFind(
+        haystack, ASCIIRef(needle.castToCharPtr(), needle.length()), start);
+  return stringRefFind(
+      haystack, UTF16Ref(needle.castToChar16Ptr(), needle.length()), start);
+}
+
+llvm::Optional<uint32_t> StringView::findLast(
+    const StringView &needle,
+    uint32_t end) const {
+  if (isASCII()) {
+    ASCIIRef haystack(castToCharPtr(), length());
+    if (needle.isASCII())
+      return stringRefFindLast(
+          haystack, ASCIIRef(needle.castToCharPtr(), needle.length()), end);
+    return stringRefFindLast(
+        haystack, UTF16Ref(needle.castToChar16Ptr(), needle.length()), end);
+  }
+  UTF16Ref haystack(castToChar16Ptr(), length());
+  if (needle.isASCII())
+    return stringRefFindLast(
+        haystack, ASCIIRef(needle.castToCharPtr(), needle.length()), end);
+  return stringRefFindLast(
+      haystack, UTF16Ref(needle.castToChar16Ptr(), needle.length()), end);
+}
+
 llvm::raw_ostream &operator<<(llvm::raw_ostream &os, const StringView &sv) {
   if (sv.isASCII()) {
     return os << llvm::StringRef(sv.castToCharPtr(), sv.length());
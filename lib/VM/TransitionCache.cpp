@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/TransitionCache.h"
+
+namespace hermes {
+namespace vm {
+
+TransitionCache::TransitionCache() : entries_(kNumEntries) {}
+
+unsigned
+TransitionCache::hash(HiddenClass *parent, SymbolID name, PropertyFlags flags) {
+  // Classes are at least 8-byte aligned.
+  uint64_t h = reinterpret_cast<uintptr_t>(parent) >> 3;
+  h = (h ^ name.unsafeGetRaw()) * 0x9e3779b97f4a7c15ull;
+  h ^= flags._flags;
+  return (h ^ (h >> 32)) & (kNumEntries - 1);
+}
+
+HiddenClass *TransitionCache::lookup(
+    HiddenClass *parent,
+    SymbolID name,
+    PropertyFlags flags) {
+  rehashIfNeeded();
+  unsigned index = hash(parent, name, flags);
+  for (unsigned i = 0; i != kNumProbes; ++i) {
+    const Entry &entry = entries_[(index + i) & (kNumEntries - 1)];
+    if (entry.parent == parent && entry.name == name && entry.flags == flags)
+      return entry.child;
+  }
+  return nullptr;
+}
+
+void TransitionCache::insert(
+    HiddenClass *parent,
+    SymbolID name,
+    PropertyFlags flags,
+    HiddenClass *child) {
+  rehashIfNeeded();
+  unsigned index = hash(parent, name, flags);
+  Entry *target = nullptr;
+  for (unsigned i = 0; i != kNumProbes; ++i) {
+    Entry &entry = entries_[(index + i) & (kNumEntries - 1)];
+    if (!entry.parent ||
+        (entry.parent == parent && entry.name == name &&
+         entry.flags == flags)) {
+      target = &entry;
+      break;
+    }
+  }
+  if (!target) {
+    target = &entries_[(index + nextEvict_) & (kNumEntries - 1)];
+    nextEvict_ = (nextEvict_ + 1) % kNumProbes;
+  }
+  target->parent = parent;
+  target->name = name;
+  target->flags = flags;
+  target->child = child;
+}
+
+void TransitionCache::markWeakRoots(WeakRootAcceptor &acceptor) {
+  for (Entry &entry : entries_) {
+    if (!entry.parent)
+      continue;
+    acceptor.acceptWeak(reinterpret_cast<void *&>(entry.parent));
+    acceptor.acceptWeak(reinterpret_cast<void *&>(entry.child));
+    if (!entry.parent || !entry.child)
+      entry = Entry{};
+  }
+  needsRehash_ = true;
+}
+
+void TransitionCache::rehash() {
+  needsRehash_ = false;
+  std::vector<Entry> old(kNumEntries);
+  old.swap(entries_);
+  for (const Entry &entry : old) {
+    if (entry.parent)
+      insert(entry.parent, entry.name, entry.flags, entry.child);
+  }
+}
+
+} // namespace vm
+} // namespace hermes
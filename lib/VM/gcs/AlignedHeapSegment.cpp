@@ -14,6 +14,8 @@
 #include "hermes/VM/CompleteMarkState-inline.h"
 #include "hermes/VM/CompleteMarkState.h"
 #include "hermes/VM/DeadRegion.h"
+#include "hermes/VM/FillerCell.h"
+#include "hermes/VM/FreeListNC.h"
 #include "hermes/VM/GC.h"
 #include "hermes/VM/GCBase-inline.h"
 #include "hermes/VM/GCBase.h"
@@ -109,6 +111,20 @@ void AlignedHeapSegment::resetLevel() {
 template void AlignedHeapSegment::resetLevel<AdviseUnused::Yes>();
 template void AlignedHeapSegment::resetLevel<AdviseUnused::No>();
 
+void AlignedHeapSegment::markUnusedAboveLevel() {
+#ifdef NDEBUG
+  const size_t PS = oscompat::page_size();
+  auto nextPage = reinterpret_cast<char *>(
+      llvm::alignTo(reinterpret_cast<uintptr_t>(level_), PS));
+  if (nextPage >= hiLim()) {
+    return;
+  }
+  contents()->protectGuardPage(oscompat::ProtectMode::ReadWrite);
+  storage_.markUnused(nextPage, hiLim());
+  contents()->protectGuardPage(oscompat::ProtectMode::None);
+#endif
+}
+
 void AlignedHeapSegment::setEffectiveEnd(char *effectiveEnd) {
   assert(
       start() <= effectiveEnd && effectiveEnd <= end() &&
@@ -220,6 +236,22 @@ void AlignedHeapSegment::completeMarking(GC *gc, CompleteMarkState *markState) {
   assert(markState->varSizeMarkStack_.empty());
 }
 
+void AlignedHeapSegment::forMarkedObjs(
+    const std::function<void(GCCell *)> &callback) {
+  if (used() == 0) {
+    return;
+  }
+
+  MarkBitArrayNC &markBits = markBitArray();
+  size_t indexLimit = markBits.addressToIndex(level_ - 1) + 1;
+  for (size_t ind = markBits.findNextMarkedBitFrom(
+           markBits.addressToIndex(start()));
+       ind < indexLimit;
+       ind = markBits.findNextMarkedBitFrom(ind + 1)) {
+    callback(reinterpret_cast<GCCell *>(markBits.indexToAddress(ind)));
+  }
+}
+
 void AlignedHeapSegment::sweepAndInstallForwardingPointers(
     GC *gc,
     SweepResult *sweepResult) {
@@ -284,6 +316,86 @@ void AlignedHeapSegment::sweepAndInstallForwardingPointers(
   if (adjacentPtr < level_) {
     new (adjacentPtr) DeadRegion(level_ - adjacentPtr);
   }
+
+  sweepResult->segmentVTablesEnd.push_back(
+      sweepResult->displacedVtablePtrs.size());
+}
+
+bool AlignedHeapSegment::canSweepInPlace(double minLiveFraction) const {
+  MarkBitArrayNC &markBits = markBitArray();
+  const size_t indexLimit = markBits.addressToIndex(level() - 1) + 1;
+  const char *adjacentPtr = start();
+  size_t liveBytes = 0;
+  for (size_t ind =
+           markBits.findNextMarkedBitFrom(markBits.addressToIndex(start()));
+       ind < indexLimit;
+       ind = markBits.findNextMarkedBitFrom(ind + 1)) {
+    const char *ptr = markBits.indexToAddress(ind);
+    if (ptr != adjacentPtr &&
+        static_cast<size_t>(ptr - adjacentPtr) < sizeof(FillerCell)) {
+      return false;
+    }
+    auto cellSize = reinterpret_cast<const GCCell *>(ptr)->getAllocatedSize();
+    liveBytes += cellSize;
+    adjacentPtr = ptr + cellSize;
+  }
+  return liveBytes > 0 && liveBytes >= minLiveFraction * used();
+}
+
+void AlignedHeapSegment::sweepInPlace(
+    GC *gc,
+    SweepResult *sweepResult,
+    FreeList *freeList) {
+  deleteDeadObjectIDs(gc);
+  sweptInPlace_ = true;
+  MarkBitArrayNC &markBits = markBitArray();
+  const size_t indexLimit = markBits.addressToIndex(level() - 1) + 1;
+  char *adjacentPtr = start();
+
+  auto *chunk = sweepResult->compactionResult.activeChunk();
+  auto allocator = chunk->allocator();
+  for (size_t ind =
+           markBits.findNextMarkedBitFrom(markBits.addressToIndex(start()));
+       ind < indexLimit;
+       ind = markBits.findNextMarkedBitFrom(ind + 1)) {
+    char *ptr = markBits.indexToAddress(ind);
+    GCCell *cell = reinterpret_cast<GCCell *>(ptr);
+    auto cellSize = cell->getAllocatedSize();
+
+    if (ptr != adjacentPtr) {
+      // Account for the FillerCell that compact() will put in the gap.
+      auto res = allocator.alloc(ptr - adjacentPtr);
+      (void)res;
+      assert(res.ptr == adjacentPtr && "Gap must be allocated in place");
+      new (adjacentPtr) DeadRegion(ptr - adjacentPtr);
+      freeList->add(adjacentPtr, ptr - adjacentPtr);
+    }
+    auto res = allocator.alloc(cellSize);
+    (void)res;
+    assert(res.ptr == cell && "Cells must not move when swept in place");
+
+#ifndef NDEBUG
+    assert(generation_ && "Must have an owning generation");
+    generation_->incNumReachableObjects();
+    if (auto *hiddenClass = dyn_vmcast<HiddenClass>(cell)) {
+      generation_->incNumHiddenClasses();
+      generation_->incNumLeafHiddenClasses(hiddenClass->isKnownLeaf());
+    }
+    gc->trackReachable(cell->getKind(), cellSize);
+#endif
+
+    sweepResult->displacedVtablePtrs.push_back(cell->getVT());
+    cell->setForwardingPointer(cell);
+    adjacentPtr = ptr + cellSize;
+  }
+  allocator.recordLevel();
+
+  if (adjacentPtr < level_) {
+    new (adjacentPtr) DeadRegion(level_ - adjacentPtr);
+  }
+
+  sweepResult->segmentVTablesEnd.push_back(
+      sweepResult->displacedVtablePtrs.size());
 }
 
 void AlignedHeapSegment::deleteDeadObjectIDs(GC *gc) {
@@ -357,7 +469,9 @@ void AlignedHeapSegment::updateReferences(
   }
 }
 
-void AlignedHeapSegment::compact(SweepResult::VTablesRemaining &vTables) {
+void AlignedHeapSegment::compact(
+    GC *gc,
+    SweepResult::VTablesRemaining &vTables) {
   // If we're using ASAN, we've poisoned the unallocated portion of the space;
   // unpoison that now, since we may copy into it.
   __asan_unpoison_memory_region(level(), end() - level());
@@ -378,7 +492,10 @@ void AlignedHeapSegment::compact(SweepResult::VTablesRemaining &vTables) {
           "Cell was invalid after placing the vtable back in");
       // Must read this now, since the memmove below might overwrite it.
       auto cellSize = cell->getAllocatedSize();
-      const bool canBeCompacted = cell->getVT()->canBeTrimmed();
+      // Cells in a segment swept in place keep their full size, since the
+      // space freed by trimming them could not be reused.
+      const bool canBeCompacted =
+          !sweptInPlace_ && cell->getVT()->canBeTrimmed();
       const auto trimmedSize = cell->getVT()->getTrimmedSize(cell, cellSize);
       if (newAddr != ptr) {
         std::memmove(newAddr, ptr, trimmedSize);
@@ -394,10 +511,19 @@ void AlignedHeapSegment::compact(SweepResult::VTablesRemaining &vTables) {
       ind += (cellSize >> LogHeapAlign);
     } else {
       auto *deadRegion = reinterpret_cast<DeadRegion *>(ptr);
-      ptr += deadRegion->size();
-      ind += (deadRegion->size() >> LogHeapAlign);
+      const gcheapsize_t size = deadRegion->size();
+      // Live cells follow the region unless it ends at the level, in which
+      // case it is beyond the new level, and need not be parseable.
+      // Clear the region first, so that no stale pointers remain in the heap.
+      if (sweptInPlace_ && ptr + size < level()) {
+        std::memset(ptr, 0, size);
+        new (ptr) FillerCell(gc, size);
+      }
+      ptr += size;
+      ind += (size >> LogHeapAlign);
     }
   }
+  sweptInPlace_ = false;
 }
 
 void AlignedHeapSegment::forObjsInRange(
@@ -24,16 +24,47 @@ void CardTable::dirtyCardsForAddressRange(const void *low, const void *high) {
   dirtyRange(addressToIndex(low), addressToIndex(high));
 }
 
-OptValue<size_t> CardTable::findNextCardWithStatus(
+/* static */ OptValue<size_t> CardTable::findNextWithStatus(
+    const CardStatus *table,
     CardStatus status,
     size_t fromIndex,
-    size_t endIndex) const {
-  const char *fromIndexPtr = reinterpret_cast<const char *>(cards_) + fromIndex;
-  const void *card =
+    size_t endIndex) {
+  const char *fromIndexPtr = reinterpret_cast<const char *>(table) + fromIndex;
+  const void *entry =
       memchr(fromIndexPtr, static_cast<char>(status), endIndex - fromIndex);
-  return (card == nullptr)
+  return (entry == nullptr)
       ? OptValue<size_t>()
-      : OptValue<size_t>(reinterpret_cast<const CardStatus *>(card) - cards_);
+      : OptValue<size_t>(reinterpret_cast<const CardStatus *>(entry) - table);
+}
+
+OptValue<size_t> CardTable::findNextDirtyCard(size_t fromIndex, size_t endIndex)
+    const {
+  if (fromIndex >= endIndex) {
+    return llvm::None;
+  }
+  const size_t summaryEnd = ((endIndex - 1) >> kLogCardsPerSummary) + 1;
+  size_t index = fromIndex;
+  while (index < endIndex) {
+    // Skip the runs of cards that are all clean without looking at them.
+    const auto summaryIndex = findNextWithStatus(
+        summary_,
+        CardStatus::Dirty,
+        index >> kLogCardsPerSummary,
+        summaryEnd);
+    if (!summaryIndex) {
+      return llvm::None;
+    }
+    index = std::max(index, *summaryIndex << kLogCardsPerSummary);
+    const size_t runEnd =
+        std::min(endIndex, (*summaryIndex + 1) << kLogCardsPerSummary);
+    if (const auto card =
+            findNextCardWithStatus(CardStatus::Dirty, index, runEnd)) {
+      return card;
+    }
+    // The summary was stale: every card it covers has since been cleaned.
+    index = runEnd;
+  }
+  return llvm::None;
 }
 
 void CardTable::clear() {
@@ -72,8 +103,30 @@ void CardTable::cleanOrDirtyRange(
     size_t from,
     size_t to,
     CardStatus cleanOrDirty) {
-  for (size_t index = from; index <= to; index++) {
-    cards_[index] = cleanOrDirty;
+  if (from > to) {
+    return;
+  }
+  memset(&cards_[from], static_cast<char>(cleanOrDirty), to - from + 1);
+
+  // Keep the summary conservative: a dirty card always has a dirty summary
+  // entry, but an entry may only be cleaned if all of its cards are.  The
+  // cards outside [kFirstUsedIndex, kValidIndices) are never dirtied, so an
+  // entry is also cleaned if the range covers all of its used cards.
+  size_t summaryFrom = from >> kLogCardsPerSummary;
+  size_t summaryTo = to >> kLogCardsPerSummary;
+  if (cleanOrDirty == CardStatus::Clean) {
+    if ((from & (kCardsPerSummary - 1)) != 0 && from > kFirstUsedIndex) {
+      summaryFrom++;
+    }
+    if (((to + 1) & (kCardsPerSummary - 1)) != 0 && to < kValidIndices - 1) {
+      if (summaryTo == 0) {
+        return;
+      }
+      summaryTo--;
+    }
+  }
+  for (size_t index = summaryFrom; index <= summaryTo; index++) {
+    summary_[index] = cleanOrDirty;
   }
 }
 
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/FreeListNC.h"
+
+#include "hermes/VM/FillerCell.h"
+
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace hermes {
+namespace vm {
+
+const gcheapsize_t FreeList::kMinRegionSize = heapAlignSize(sizeof(FillerCell));
+constexpr gcheapsize_t FreeList::kMaxExactSize;
+constexpr size_t FreeList::kNumRangeClasses;
+constexpr size_t FreeList::kNumExactClasses;
+constexpr size_t FreeList::kNumClasses;
+constexpr size_t FreeList::kMaxProbes;
+
+void FreeList::clear() {
+  for (auto &regions : classes_) {
+    regions.clear();
+  }
+  bytes_ = 0;
+}
+
+void FreeList::add(char *start, gcheapsize_t size) {
+  assert(isSizeHeapAligned(size) && "Free regions must be heap-aligned");
+  if (size < kMinRegionSize) {
+    return;
+  }
+  classes_[sizeClass(size)].push_back({start, size});
+  bytes_ += size;
+}
+
+FreeList::Region FreeList::take(gcheapsize_t size) {
+  for (size_t cls = sizeClass(size); cls < kNumClasses; ++cls) {
+    auto &regions = classes_[cls];
+    // Examine the most recently added regions first, as they are the cheapest
+    // to remove.
+    const size_t numRegions = regions.size();
+    const size_t numProbes = std::min(numRegions, kMaxProbes);
+    for (size_t probe = 0; probe < numProbes; ++probe) {
+      const size_t i = numRegions - 1 - probe;
+      if (!fits(regions[i].size, size)) {
+        continue;
+      }
+      Region res = regions[i];
+      regions[i] = regions.back();
+      regions.pop_back();
+      bytes_ -= res.size;
+      return res;
+    }
+  }
+  return {nullptr, 0};
+}
+
+/*static*/ size_t FreeList::sizeClass(gcheapsize_t size) {
+  if (size < kMaxExactSize) {
+    return size >> LogHeapAlign;
+  }
+  // Sizes in [kMaxExactSize * 2^k, kMaxExactSize * 2^(k+1)) map to the k'th
+  // range class, and the largest class takes everything above.
+  const size_t rangeClass =
+      llvm::Log2_32(size) - llvm::Log2_32_Ceil(kMaxExactSize);
+  return kNumExactClasses + std::min(rangeClass, kNumRangeClasses - 1);
+}
+
+} // namespace vm
+} // namespace hermes
@@ -36,6 +36,16 @@ void GCGeneration::finalizeUnreachableObjects() {
       cellsWithFinalizers().size() - numFinalizedObjects_);
 }
 
+uint64_t GCGeneration::finalizeObservableObjects() {
+  numFinalizedObjects_ = 0;
+  uint64_t leakedBytes = 0;
+  for (GCCell *cell : cellsWithFinalizers()) {
+    leakedBytes += GCBase::finalizeForFastTeardown(cell, gc_);
+  }
+  cellsWithFinalizers().clear();
+  return leakedBytes;
+}
+
 void GCGeneration::updateFinalizableCellListReferences() {
   for (auto &cell : cellsWithFinalizers()) {
     cell = cell->getForwardingPointer();
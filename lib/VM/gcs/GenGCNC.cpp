@@ -25,6 +25,7 @@
 #include "hermes/VM/GCPointer-inline.h"
 #include "hermes/VM/HeapSnapshot.h"
 #include "hermes/VM/HermesValue-inline.h"
+#include "hermes/VM/ParallelMarkState.h"
 #include "hermes/VM/Serializer.h"
 #include "hermes/VM/SlotAcceptorDefault-inline.h"
 #include "hermes/VM/StringPrimitive.h"
@@ -40,10 +41,12 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cinttypes>
 #include <clocale>
 #include <cstdint>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -110,11 +113,25 @@ GenGC::GenGC(
           this,
           generationSizes_.oldGenSize(),
           gcConfig.getShouldReleaseUnused()),
+      largeObjects_(this),
       allocContextFromYG_(gcConfig.getAllocInYoung()),
       revertToYGAtTTI_(gcConfig.getRevertToYGAtTTI()),
       occupancyTarget_(gcConfig.getOccupancyTarget()),
+      gcTimeTarget_(gcConfig.getGCTimeTarget()),
+      lastFullCollectionStart_(steady_clock::now()),
       oomThreshold_(gcConfig.getEffectiveOOMThreshold()),
-      weightedUsed_(static_cast<double>(gcConfig.getInitHeapSize())) {
+      weightedUsed_(static_cast<double>(gcConfig.getInitHeapSize())),
+      markingThreads_(gcConfig.getMarkingThreads()),
+      compactionThreads_(gcConfig.getCompactionThreads()),
+      cardScanThreads_(gcConfig.getCardScanThreads()),
+      incrementalMarkBudgetMs_(gcConfig.getIncrementalMarkBudgetMs()),
+      pretenuring_(gcConfig.getPretenuring()),
+#ifndef HERMESVM_COMPRESSED_POINTERS
+      largeObjectSpace_(gcConfig.getLargeObjectSpace()),
+#else
+      largeObjectSpace_(false),
+#endif
+      youngGenPauseTargetMs_(gcConfig.getYoungGenPauseTargetMs()) {
   growTo(gcConfig.getInitHeapSize());
   claimAllocContext();
   updateCrashManagerHeapExtents();
@@ -221,9 +238,18 @@ void GenGC::finalizeAll() {
   AllocContextYieldThenClaim yielder(this);
   // Must clear the mark bits, so all objects are considered unreachable.
   clearMarkBits();
+  // The code blocks owning the sampled sites may be freed by the finalizers.
+  allocationSiteSamples_.clear();
   finalizeUnreachableObjects();
 }
 
+uint64_t GenGC::finalizeObservable() {
+  AllocContextYieldThenClaim yielder(this);
+  allocationSiteSamples_.clear();
+  return youngGen_.finalizeObservableObjects() +
+      oldGen_.finalizeObservableObjects();
+}
+
 namespace {
 
 template <typename T>
@@ -341,13 +367,26 @@ void GenGC::collect(bool canEffectiveOOM) {
 
   {
     CollectionSection fullCollection(this, "Full collection", gcCallbacks_);
+    beginCollectionEvent(/* youngGen */ false);
 
     fullCollection.addArg("fullGCUsedBefore", usedBefore);
     fullCollection.addArg("fullGCSizeBefore", sizeBefore);
 
-    markPhase();
+    {
+      GCPhaseTimer timer(this, GCPhase::Mark);
+      markPhase();
+    }
 
-    finalizeUnreachableObjects();
+    resolveAllocationSiteSamples(/*fullGC*/ true);
+
+    {
+      GCPhaseTimer timer(this, GCPhase::Finalization);
+      finalizeUnreachableObjects();
+    }
+
+    // Large objects never move: drop the charge of the dead ones before the
+    // old gen's charge is set aside.
+    largeObjects_.sweep();
 
     auto ygExtMem = youngGen_.externalMemory();
     auto ogExtMem = oldGen_.externalMemory();
@@ -360,17 +399,25 @@ void GenGC::collect(bool canEffectiveOOM) {
     // The sweep results for the generations, to be filled in.
     SweepResult sweepResult({oldGen_.allSegments(), youngGen_.allSegments()});
 
-    sweepAndInstallForwardingPointers(&sweepResult);
+    {
+      GCPhaseTimer timer(this, GCPhase::Sweep);
+      sweepAndInstallForwardingPointers(&sweepResult);
+    }
     updateReferences(sweepResult);
 
     // Re-instate the external charge.
     youngGen_.creditExternalMemory(ygExtMem);
     oldGen_.creditExternalMemory(ogExtMem);
 
-    compact(sweepResult);
+    {
+      GCPhaseTimer timer(this, GCPhase::Compact);
+      compact(sweepResult);
+    }
 
     oldGen_.updateCardTablesAfterCompaction(
         /* youngGenIsEmpty */ youngGen_.usedDirect() == 0);
+    largeObjects_.updateCardTablesAfterCompaction(
+        /* youngGenIsEmpty */ youngGen_.usedDirect() == 0);
 
     gcCallbacks_->freeSymbols(markedSymbols_);
 
@@ -378,7 +425,7 @@ void GenGC::collect(bool canEffectiveOOM) {
     // consult if we need to shrink the heap.
     updateWeightedUsed();
 
-    updateHeapSize();
+    updateHeapSize(fullCollection.wallStart());
 
     // In case we started in direct OG allocation, we want to revert to YG alloc
     // if we reach a full collection.  (Usually, a TTI call will have already
@@ -568,6 +615,25 @@ void GenGC::markPhase() {
   markedSymbols_.clear();
   markedSymbols_.resize(gcCallbacks_->getSymbolsEnd(), false);
 
+  // The marks of an incremental cycle can only be reused if the young
+  // generation is empty, as the cycle does not track young-gen cells.
+  // Otherwise, the cycle is abandoned, and marking starts from scratch.
+  if (incrementalMarkActive_) {
+    incrementalMarkActive_ = false;
+    if (youngGen_.usedDirect() == 0) {
+      auto finishMarkingStart = steady_clock::now();
+      {
+        PerfSection fullGCFinishIncrementalMarkSystraceRegion(
+            "fullGCFinishIncrementalMark");
+        finishIncrementalMark();
+      }
+      markTransitiveSecs_ +=
+          GCBase::clockDiffSeconds(finishMarkingStart, steady_clock::now());
+      return;
+    }
+    incrementalMarkStack_.clear();
+  }
+
   FullMSCMarkInitialAcceptor acceptor(*this);
   DroppingAcceptor<FullMSCMarkInitialAcceptor> nameAcceptor{acceptor};
   clearMarkBits();
@@ -618,6 +684,11 @@ void GenGC::clearMarkBits() {
 }
 
 void GenGC::completeMarking() {
+  if (markingThreads_ > 1) {
+    completeMarkingParallel();
+    return;
+  }
+
   // completeMarking returns a boolean that is true if and only if the mark
   // stack overflowed whilst trying to complete marking.  When this happens, we
   // must restart marking from the beginning (in increasing order of virtual
@@ -633,6 +704,200 @@ void GenGC::completeMarking() {
   } while (markState_.markStackOverflow_);
 }
 
+void GenGC::completeMarkingParallel() {
+  ParallelMarkState parallelMarkState(
+      this, markingThreads_, markedSymbols_.size());
+
+  // At this point exactly the cells directly reachable from the roots are
+  // marked; they are the initial gray set.
+  auto addGray = [&parallelMarkState](GCCell *cell) {
+    parallelMarkState.addGray(cell);
+  };
+  for (auto *segment : segmentIndex_) {
+    segment->forMarkedObjs(addGray);
+  }
+
+  parallelMarkState.run();
+  parallelMarkState.flushMarkedSymbols();
+}
+
+/// Marks the old-gen referents of the cells scanned by incremental marking.
+/// Young-gen referents are skipped: a cycle only finishes when the young
+/// generation is empty, by which time they have been promoted above
+/// incrementalMarkStart_.  Symbols are skipped too, since they are not covered
+/// by write barriers; a finishing cycle considers them all reachable.
+struct GenGC::IncrementalMarkAcceptor final : public SlotAcceptorDefault {
+  using SlotAcceptorDefault::accept;
+  using SlotAcceptorDefault::SlotAcceptorDefault;
+
+  void accept(void *&ptr) override {
+    gc.incrementalMarkShade(ptr);
+  }
+  void accept(HermesValue &hv) override {
+    if (hv.isPointer()) {
+      gc.incrementalMarkShade(hv.getPointer());
+    }
+  }
+};
+
+void GenGC::markIncrementally() {
+  if (incrementalMarkBudgetMs_ == 0) {
+    return;
+  }
+
+  /// Yield, then reclaim, the allocation context.  (This is a noop
+  /// if the context has already been yielded.)
+  AllocContextYieldThenClaim yielder(this);
+
+  if (!incrementalMarkActive_ &&
+      oldGen_.used() < kIncrementalMarkStartOccupancy * oldGen_.size()) {
+    return;
+  }
+
+  bool done;
+  {
+    GCCycle cycle(this);
+    PerfSection incrementalMarkSystraceRegion("incrementalMark");
+    const auto incrementStart = steady_clock::now();
+    if (!incrementalMarkActive_) {
+      startIncrementalMark();
+    }
+    done = drainIncrementalMarkStack(
+        incrementStart + std::chrono::milliseconds(incrementalMarkBudgetMs_));
+    markTransitiveSecs_ +=
+        GCBase::clockDiffSeconds(incrementStart, steady_clock::now());
+  }
+
+  if (done) {
+    // Nothing is left to mark from the snapshot: finish the cycle with a full
+    // collection, whose marking phase only needs to rescan the roots and the
+    // cells allocated during the cycle.
+    collect(/* canEffectiveOOM */ false);
+  }
+}
+
+void GenGC::startIncrementalMark() {
+  assert(
+      youngGen_.usedDirect() == 0 &&
+      "Incremental marking must start right after a young-gen collection");
+  assert(incrementalMarkStack_.empty() && "Leftover incremental mark stack");
+
+  oldGen_.forUsedSegments([](AlignedHeapSegment &segment) {
+    segment.markBitArray().clear();
+  });
+  largeObjects_.clearMarkBits();
+  incrementalMarkStart_ = oldGen_.levelDirect();
+  incrementalMarkActive_ = true;
+
+  IncrementalMarkAcceptor acceptor(*this);
+  DroppingAcceptor<IncrementalMarkAcceptor> nameAcceptor{acceptor};
+  markRoots(nameAcceptor, /*markLongLived*/ true);
+}
+
+bool GenGC::drainIncrementalMarkStack(steady_clock::time_point deadline) {
+  IncrementalMarkAcceptor acceptor(*this);
+  unsigned untilClockCheck = kIncrementalMarkCellsPerClockCheck;
+  while (!incrementalMarkStack_.empty()) {
+    if (--untilClockCheck == 0) {
+      if (steady_clock::now() >= deadline) {
+        return false;
+      }
+      untilClockCheck = kIncrementalMarkCellsPerClockCheck;
+    }
+    GCCell *cell = incrementalMarkStack_.back();
+    incrementalMarkStack_.pop_back();
+    GCBase::markCell(cell, this, acceptor);
+  }
+  return true;
+}
+
+void GenGC::finishIncrementalMark() {
+  assert(youngGen_.usedDirect() == 0 && "Young gen must be empty");
+
+  youngGen_.forUsedSegments([](AlignedHeapSegment &segment) {
+    segment.markBitArray().clear();
+  });
+
+  // Every old-gen cell allocated during the cycle is considered reachable.
+  // Segments that were added to the old generation during the cycle may still
+  // hold mark bits from earlier uses, so clear those first.
+  const size_t startSegmentNum = incrementalMarkStart_.segmentNum;
+  size_t segmentNum = 0;
+  oldGen_.forUsedSegments([this, startSegmentNum, &segmentNum](
+                              AlignedHeapSegment &segment) {
+    const size_t curSegmentNum = segmentNum++;
+    if (curSegmentNum < startSegmentNum) {
+      return;
+    }
+    char *ptr = segment.start();
+    if (curSegmentNum == startSegmentNum) {
+      ptr = incrementalMarkStart_.ptr;
+    } else {
+      segment.markBitArray().clear();
+    }
+    while (ptr < segment.level()) {
+      GCCell *cell = reinterpret_cast<GCCell *>(ptr);
+      ptr += cell->getAllocatedSize();
+      if (!AlignedHeapSegment::getCellMarkBit(cell)) {
+        AlignedHeapSegment::setCellMarkBit(cell);
+        incrementalMarkStack_.push_back(cell);
+      }
+    }
+  });
+
+  IncrementalMarkAcceptor acceptor(*this);
+  DroppingAcceptor<IncrementalMarkAcceptor> nameAcceptor{acceptor};
+  {
+    PerfSection fullGCMarkRootsSystraceRegion("fullGCMarkRoots");
+    markRoots(nameAcceptor, /*markLongLived*/ true);
+  }
+
+  youngGen_.clearUnmarkedPropertyMaps();
+  oldGen_.clearUnmarkedPropertyMaps();
+
+  const bool done = drainIncrementalMarkStack(steady_clock::time_point::max());
+  assert(done && "Unbounded drain must empty the mark stack");
+  (void)done;
+
+  // SymbolIDs are written without barriers, so the cycle cannot know which
+  // symbols are still referenced: keep all of them.
+  for (size_t i = 0, e = markedSymbols_.size(); i < e; ++i) {
+    markSymbol(SymbolID::unsafeCreate(i));
+  }
+}
+
+void GenGC::incrementalMarkShade(void *ptr) {
+  if (!ptr || youngGen_.contains(ptr)) {
+    return;
+  }
+  assert(dbgContains(ptr));
+  GCCell *cell = reinterpret_cast<GCCell *>(ptr);
+  if (!AlignedHeapSegment::getCellMarkBit(cell)) {
+    AlignedHeapSegment::setCellMarkBit(cell);
+    incrementalMarkStack_.push_back(cell);
+  }
+}
+
+void GenGC::sampleAllocationSite(GCCell *cell, AllocationSite *site) {
+  assert(pretenuring_ && "Allocation sites are only sampled for pretenuring");
+  if (site->isSampling() || !youngGen_.contains(cell)) {
+    return;
+  }
+  site->startSample();
+  allocationSiteSamples_.push_back({cell, site});
+}
+
+void GenGC::resolveAllocationSiteSamples(bool fullGC) {
+  for (const AllocationSiteSample &sample : allocationSiteSamples_) {
+    // In a young-gen collection, every surviving young-gen cell has been
+    // evacuated, leaving a forwarding pointer behind.
+    bool survived = fullGC ? AlignedHeapSegment::getCellMarkBit(sample.cell)
+                           : sample.cell->hasMarkedForwardingPointer();
+    sample.site->recordSample(survived);
+  }
+  allocationSiteSamples_.clear();
+}
+
 void GenGC::finalizeUnreachableObjects() {
   youngGen_.finalizeUnreachableObjects();
   oldGen_.finalizeUnreachableObjects();
@@ -652,26 +917,79 @@ void GenGC::sweepAndInstallForwardingPointers(SweepResult *sweepResult) {
 void GenGC::updateReferences(const SweepResult &sweepResult) {
   auto updateRefsStart = steady_clock::now();
   PerfSection fullGCUpdateReferencesSystraceRegion("fullGCUpdateReferences");
-  std::unique_ptr<FullMSCUpdateAcceptor> acceptor =
-      getFullMSCUpdateAcceptor(*this);
-  DroppingAcceptor<SlotAcceptor> nameAcceptor{*acceptor};
-  markRoots(nameAcceptor, /*markLongLived*/ true);
-  markWeakRoots(*acceptor);
-
-  SweepResult::VTablesRemaining vTables(
-      sweepResult.displacedVtablePtrs.begin(),
-      sweepResult.displacedVtablePtrs.end());
+  {
+    // The weak references are timed as a phase of their own.
+    GCPhaseTimer timer(this, GCPhase::UpdateReferences);
+    std::unique_ptr<FullMSCUpdateAcceptor> acceptor =
+        getFullMSCUpdateAcceptor(*this);
+    DroppingAcceptor<SlotAcceptor> nameAcceptor{*acceptor};
+    markRoots(nameAcceptor, /*markLongLived*/ true);
+    markWeakRoots(*acceptor);
 
-  // We swept the old gen into itself before sweeping the young gen.  We must
-  // preserve this order here, to match up cells with their displaced VTable
-  // pointers.
-  oldGen_.updateReferences(this, vTables);
-  youngGen_.updateReferences(this, vTables);
+    if (compactionThreads_ > 1 && !getIDTracker().isTrackingIDs()) {
+      updateReferencesParallel(sweepResult);
+    } else {
+      SweepResult::VTablesRemaining vTables(
+          sweepResult.displacedVtablePtrs.begin(),
+          sweepResult.displacedVtablePtrs.end());
+
+      // We swept the old gen into itself before sweeping the young gen.  We
+      // must preserve this order here, to match up cells with their displaced
+      // VTable pointers.
+      oldGen_.updateReferences(this, vTables);
+      youngGen_.updateReferences(this, vTables);
+    }
+    largeObjects_.updateReferences(acceptor.get());
+  }
 
   updateWeakReferences(/*fullGC*/ true);
   updateReferencesSecs_ +=
       GCBase::clockDiffSeconds(updateRefsStart, steady_clock::now());
-  unmarkWeakReferences();
+}
+
+void GenGC::updateReferencesParallel(const SweepResult &sweepResult) {
+  // Collect the segments in sweep order (old gen first), so that the i'th
+  // segment can be matched with its range of displaced VTable pointers.
+  std::vector<AlignedHeapSegment *> segments;
+  auto addSegment = [&segments](AlignedHeapSegment &segment) {
+    segments.push_back(&segment);
+  };
+  oldGen_.forUsedSegments(addSegment);
+  youngGen_.forUsedSegments(addSegment);
+  assert(
+      segments.size() == sweepResult.segmentVTablesEnd.size() &&
+      "Every used segment should have been swept");
+
+  oldGen_.updateFinalizableCellListReferences();
+  youngGen_.updateFinalizableCellListReferences();
+
+  // Each segment only writes to the fields of its own live cells, and only
+  // reads the forwarding pointers of others, so segments can be updated
+  // concurrently.  Threads claim segments dynamically, since the amount of
+  // live data per segment varies widely.
+  std::atomic<size_t> nextSegment{0};
+  auto updateSegments = [this, &segments, &sweepResult, &nextSegment]() {
+    std::unique_ptr<FullMSCUpdateAcceptor> acceptor =
+        getFullMSCUpdateAcceptor(*this);
+    const auto &ends = sweepResult.segmentVTablesEnd;
+    const auto vTablesBegin = sweepResult.displacedVtablePtrs.begin();
+    for (size_t i; (i = nextSegment.fetch_add(1)) < segments.size();) {
+      SweepResult::VTablesRemaining vTables(
+          vTablesBegin + (i == 0 ? 0 : ends[i - 1]), vTablesBegin + ends[i]);
+      segments[i]->updateReferences(this, acceptor.get(), vTables);
+      assert(!vTables.hasNext() && "Not all vtable pointers consumed.");
+    }
+  };
+
+  std::vector<std::thread> helpers;
+  helpers.reserve(compactionThreads_ - 1);
+  for (unsigned i = 1; i < compactionThreads_; ++i) {
+    helpers.emplace_back(updateSegments);
+  }
+  updateSegments();
+  for (auto &helper : helpers) {
+    helper.join();
+  }
 }
 
 void GenGC::compact(const SweepResult &sweepResult) {
@@ -692,15 +1010,22 @@ void GenGC::compact(const SweepResult &sweepResult) {
   // preserve this order here, so that we re-associate the correct VTable
   // pointers, and match up the chunks we used with the segments they were
   // created from.
-  auto doCompaction = [&vTables](AlignedHeapSegment &segment) {
-    segment.compact(vTables);
+  auto doCompaction = [this, &vTables](AlignedHeapSegment &segment) {
+    segment.compact(this, vTables);
   };
 
+#ifndef NDEBUG
+  // Segments swept in place get FillerCells constructed in them, which were
+  // not allocated through alloc().
+  lastAllocWasFixedSize_ = FixedSizeValue::Unknown;
+#endif
+
   oldGen_.forUsedSegments(doCompaction);
   youngGen_.forUsedSegments(doCompaction);
 
   oldGen_.recordLevelAfterCompaction(chunks);
   youngGen_.recordLevelAfterCompaction(chunks);
+  largeObjects_.compact();
 
   assert(!vTables.hasNext() && "Not all vtable pointers replaced.");
   assert(!chunks.hasNext() && "Not all chunks written back to their segments.");
@@ -708,7 +1033,9 @@ void GenGC::compact(const SweepResult &sweepResult) {
   youngGen_.compactFinalizableObjectList();
 
   assert(youngGen_.extSizeFromFinalizerList() == youngGen_.externalMemory());
-  assert(oldGen_.extSizeFromFinalizerList() == oldGen_.externalMemory());
+  assert(
+      oldGen_.extSizeFromFinalizerList() + largeObjects_.externalCharge() ==
+      oldGen_.externalMemory());
 
   // At this point, finalizers have been run, and any unreachable objects with
   // external memory charges have had those charges adjusted.  So the
@@ -750,6 +1077,7 @@ void GenGC::checkWellFormedHeap() const {
   gc->markWeakRoots(acceptor);
   youngGen_.checkWellFormed(gc);
   oldGen_.checkWellFormed(gc);
+  largeObjects_.checkWellFormed(gc);
 }
 #endif
 
@@ -772,9 +1100,54 @@ void GenGC::moveWeakReferences(ptrdiff_t delta) {
 }
 
 size_t GenGC::youngGenSize(size_t totalHeapSize) const {
+  if (youngGenTargetSize_) {
+    return youngGen_.adjustSize(youngGenTargetSize_);
+  }
   return youngGen_.adjustSize(totalHeapSize / kYoungGenFractionDenom);
 }
 
+void GenGC::updateYoungGenSize(
+    double pauseSecs,
+    size_t usedBefore,
+    size_t promotedBytes) {
+  const TimePoint now = steady_clock::now();
+  const TimePoint previousEnd = lastYoungGenCollectionEnd_;
+  lastYoungGenCollectionEnd_ = now;
+  if (!youngGenPauseTargetMs_) {
+    return;
+  }
+
+  const size_t curSize = youngGen_.sizeDirect();
+  size_t newSize = curSize;
+  if (pauseSecs * 1000.0 > youngGenPauseTargetMs_) {
+    newSize = curSize / kYoungGenResizeFactor;
+  } else if (previousEnd != TimePoint{}) {
+    const double survivalRate = usedBefore
+        ? static_cast<double>(promotedBytes) / static_cast<double>(usedBefore)
+        : 0.0;
+    const double gcTimeRatio =
+        pauseSecs / GCBase::clockDiffSeconds(previousEnd, now);
+    if (survivalRate < kYoungGenLowSurvivalRate &&
+        gcTimeRatio > kYoungGenHighGCTimeRatio) {
+      newSize = curSize * kYoungGenResizeFactor;
+    }
+  }
+  // The young gen was just evacuated, but may still be charged for external
+  // memory.
+  newSize = youngGen_.adjustSize(std::max(newSize, youngGen_.usedDirect()));
+
+  if (newSize > curSize) {
+    youngGen_.growTo(newSize);
+    ++youngGenCollectionCumStats_.numGrowths;
+  } else if (newSize < curSize) {
+    youngGen_.shrinkTo(newSize);
+    ++youngGenCollectionCumStats_.numShrinks;
+  } else {
+    return;
+  }
+  youngGenTargetSize_ = newSize;
+}
+
 void GenGC::growTo(size_t hint) {
   // The generations' sizes should be monotonic with respect to the hint.  The
   // Young Generation satisfies this because youngGenSize is monotonic.  The Old
@@ -782,7 +1155,7 @@ void GenGC::growTo(size_t hint) {
   // Generation's alignment boundary.
   const auto sizes = generationSizes_.adjustSize(hint);
 
-  const auto ygSize = sizes.first;
+  const auto ygSize = youngGenSize(hint);
   // Ensure old gen fits.
   const auto ogSize = oldGen_.adjustSize(sizes.second);
 
@@ -792,7 +1165,7 @@ void GenGC::growTo(size_t hint) {
 
 void GenGC::shrinkTo(size_t hint) {
   const auto sizes = generationSizes_.adjustSize(hint);
-  const auto ygSize = sizes.first;
+  const auto ygSize = youngGenSize(hint);
   // This should only be called when this assertion is guaranteed: for example,
   // when the young gen is empty.
   assert(youngGen_.usedDirect() <= ygSize);
@@ -804,6 +1177,39 @@ void GenGC::shrinkTo(size_t hint) {
   oldGen_.shrinkTo(ogSize);
 }
 
+size_t GenGC::notifyMemoryPressure(MemoryPressureLevel level) {
+  AllocContextYieldThenClaim yielder(this);
+  const size_t sizeBefore = sizeDirect();
+  collect(/* canEffectiveOOM */ false);
+
+  // shrinkTo needs the young gen to fit its new size, which a full collection
+  // does not guarantee.
+  if (youngGen_.usedDirect() == 0) {
+    const size_t used = usedDirect();
+    shrinkTo(
+        level == MemoryPressureLevel::Critical ? used
+                                               : usedToDesiredSize(used));
+    // Don't let the history of larger heaps keep the heap from shrinking at
+    // the next full collection.
+    weightedUsed_ = static_cast<double>(used);
+  }
+
+  size_t released = oldGen_.releaseSegmentCache();
+  if (level == MemoryPressureLevel::Critical) {
+    auto markUnused = [](AlignedHeapSegment &segment) {
+      segment.markUnusedAboveLevel();
+    };
+    youngGen_.forUsedSegments(markUnused);
+    oldGen_.forUsedSegments(markUnused);
+  }
+
+  const size_t sizeAfter = sizeDirect();
+  if (sizeAfter < sizeBefore) {
+    released += sizeBefore - sizeAfter;
+  }
+  return released;
+}
+
 #ifndef NDEBUG
 size_t GenGC::countUsedWeakRefs() const {
   size_t count = 0;
@@ -816,14 +1222,6 @@ size_t GenGC::countUsedWeakRefs() const {
 }
 #endif
 
-void GenGC::unmarkWeakReferences() {
-  for (auto &slot : weakSlots_) {
-    if (slot.state() == WeakSlotState::Marked) {
-      slot.unmark();
-    }
-  }
-}
-
 void GenGC::updateWeakReference(WeakRefSlot *slotPtr, bool fullGC) {
   // Skip free slots.
   if (slotPtr->state() == WeakSlotState::Free) {
@@ -869,10 +1267,70 @@ void GenGC::updateWeakReference(WeakRefSlot *slotPtr, bool fullGC) {
   }
 }
 
+void GenGC::updateWeakSlotsForFullGC(
+    size_t begin,
+    size_t end,
+    std::vector<WeakRefSlot *> &deadSlots) {
+  for (size_t i = begin; i < end; ++i) {
+    WeakRefSlot *slotPtr = &weakSlots_[i];
+    switch (slotPtr->state()) {
+      case WeakSlotState::Free:
+        break;
+      case WeakSlotState::Unmarked:
+        // A slot which is no longer reachable.
+        deadSlots.push_back(slotPtr);
+        break;
+      case WeakSlotState::Marked:
+        if (slotPtr->hasPointer()) {
+          GCCell *cell = (GCCell *)slotPtr->getPointer();
+          if (AlignedHeapSegment::getCellMarkBit(cell)) {
+            slotPtr->setPointer(cell->getForwardingPointer());
+          } else {
+            slotPtr->clearPointer();
+          }
+        }
+        slotPtr->unmark();
+        break;
+    }
+  }
+}
+
 void GenGC::updateWeakReferences(bool fullGC) {
+  GCPhaseTimer timer(this, GCPhase::WeakReferences);
   if (fullGC) {
-    for (auto &slot : weakSlots_) {
-      updateWeakReference(&slot, fullGC); // fullGC is true.
+    // Apps using WeakMaps as caches can have a very large number of slots, so
+    // split them into contiguous ranges processed on separate threads.  Only
+    // the (typically few) dead slots are freed serially afterwards.
+    const size_t numSlots = weakSlots_.size();
+    const unsigned numThreads = std::max<size_t>(
+        1,
+        std::min<size_t>(
+            compactionThreads_, numSlots / kMinWeakSlotsPerThread));
+    const size_t slotsPerThread = (numSlots + numThreads - 1) / numThreads;
+    std::vector<std::vector<WeakRefSlot *>> deadSlots(numThreads);
+    auto updateRange = [this, numSlots, slotsPerThread, &deadSlots](
+                           unsigned i) {
+      const size_t begin = std::min(numSlots, i * slotsPerThread);
+      const size_t end = std::min(numSlots, begin + slotsPerThread);
+      updateWeakSlotsForFullGC(begin, end, deadSlots[i]);
+    };
+
+    std::vector<std::thread> helpers;
+    helpers.reserve(numThreads - 1);
+    for (unsigned i = 1; i < numThreads; ++i) {
+      helpers.emplace_back(updateRange, i);
+    }
+    updateRange(0);
+    for (auto &helper : helpers) {
+      helper.join();
+    }
+
+    // Free in increasing order, so that the last slot ends up at the head of
+    // the free list, as shrinkWeakSlots expects.
+    for (const auto &dead : deadSlots) {
+      for (WeakRefSlot *slotPtr : dead) {
+        freeWeakSlot(slotPtr);
+      }
     }
   } else {
     for (auto slotPtr : weakRefSlotsWithPossibleYoungReferent_) {
@@ -949,7 +1407,39 @@ void GenGC::updateWeightedUsed() {
       ((1.0 - kWeightedUsedAlpha) * weightedUsed_);
 }
 
-void GenGC::updateHeapSize() {
+void GenGC::updateOccupancyTarget(TimePoint collectionStart) {
+  // The window ends when this collection started, whose time is not yet in
+  // the cumulative stats, and covers the previous full collection and the
+  // young-gen collections since.
+  const double elapsedSecs =
+      GCBase::clockDiffSeconds(lastFullCollectionStart_, collectionStart);
+  const double gcSecs = getGCTime() - gcTimeAtLastFullCollection_;
+  lastFullCollectionStart_ = collectionStart;
+  gcTimeAtLastFullCollection_ = getGCTime();
+  if (gcTimeTarget_ <= 0.0 || elapsedSecs <= 0.0) {
+    return;
+  }
+
+  // The GC time is about proportional to the number of collections, hence
+  // inversely proportional to the free space per live byte, which is
+  // (1 - occupancy) / occupancy.  Scale it by the ratio of the time spent in
+  // the GC to the target, within limits, so that the heap converges on the
+  // target over a few full collections rather than oscillating.
+  const double maxFactor = kMaxOccupancyAdaptFactor;
+  const double factor = std::max(
+      std::min((gcSecs / elapsedSecs) / gcTimeTarget_, maxFactor),
+      1.0 / maxFactor);
+  const double freePerLive =
+      factor * (1.0 - occupancyTarget_) / occupancyTarget_;
+  const double minTarget = kMinAdaptiveOccupancyTarget;
+  const double maxTarget = kMaxAdaptiveOccupancyTarget;
+  occupancyTarget_ =
+      std::max(std::min(1.0 / (1.0 + freePerLive), maxTarget), minTarget);
+}
+
+void GenGC::updateHeapSize(TimePoint collectionStart) {
+  updateOccupancyTarget(collectionStart);
+
   // Should we alter the total heap size?
   if (usedDirect() >
       static_cast<gcheapsize_t>(sizeDirect() * occupancyTarget())) {
@@ -980,20 +1470,24 @@ void GenGC::updateCrashManagerHeapExtents() {
 void GenGC::forAllObjs(const std::function<void(GCCell *)> &callback) {
   youngGen_.forAllObjs(callback);
   oldGen_.forAllObjs(callback);
+  largeObjects_.forAllObjs(callback);
 }
 
 #ifndef NDEBUG
 void GenGC::youngGenCollect() {
   AllocContextYieldThenClaim yielder(this);
   youngGen_.collect();
+  markIncrementally();
 }
 
 unsigned GenGC::computeNumAllocatedObjects() const {
-  return youngGen_.numAllocatedObjects() + oldGen_.numAllocatedObjects();
+  return youngGen_.numAllocatedObjects() + oldGen_.numAllocatedObjects() +
+      largeObjects_.numAllocatedObjects();
 }
 
 unsigned GenGC::computeNumReachableObjects() const {
-  return youngGen_.numReachableObjects() + oldGen_.numReachableObjects();
+  return youngGen_.numReachableObjects() + oldGen_.numReachableObjects() +
+      largeObjects_.numReachableObjects();
 }
 
 unsigned GenGC::computeNumHiddenClasses() const {
@@ -1011,6 +1505,7 @@ unsigned GenGC::computeNumFinalizedObjects() const {
 void GenGC::resetNumReachableObjectsInGens() {
   youngGen_.resetNumReachableObjects();
   oldGen_.resetNumReachableObjects();
+  largeObjects_.resetNumReachableObjects();
 }
 
 void GenGC::resetNumAllHiddenClassesInGens() {
@@ -1022,6 +1517,7 @@ void GenGC::setNumAllocatedObjectsAfterFullCollectionNC(
     const CompactionResult &compactionResult) {
   youngGen_.resetNumAllocatedObjects();
   oldGen_.resetNumAllocatedObjects();
+  largeObjects_.resetNumAllocatedObjects();
 
   for (auto &chunk : compactionResult.usedChunks()) {
     chunk.recordNumAllocated();
@@ -1082,6 +1578,14 @@ void GenGC::writeBarrierRange(HermesValue *start, uint32_t numHVs) {
 
   AlignedHeapSegment::cardTableCovering(firstPtr)->dirtyCardsForAddressRange(
       firstPtr, lastPtr);
+
+  if (LLVM_UNLIKELY(incrementalMarkActive_)) {
+    for (uint32_t i = 0; i < numHVs; ++i) {
+      if (start[i].isPointer()) {
+        incrementalMarkShade(start[i].getPointer());
+      }
+    }
+  }
 }
 
 void GenGC::writeBarrierRangeFill(
@@ -1101,6 +1605,10 @@ void GenGC::writeBarrierRangeFill(
       AlignedStorage::start(firstPtr) == AlignedStorage::start(lastPtr) &&
       "Range should be contained in the same segment");
 
+  if (LLVM_UNLIKELY(incrementalMarkActive_)) {
+    incrementalMarkShade(valuePtr);
+  }
+
   if (youngGen_.contains(valuePtr)) {
     AlignedHeapSegment::cardTableCovering(firstPtr)->dirtyCardsForAddressRange(
         firstPtr, lastPtr);
@@ -1587,6 +2095,7 @@ void GenGC::serializeHeap(Serializer &s) {
   };
 
   oldGen_.forAllObjs(serializeObject);
+  largeObjects_.forAllObjs(serializeObject);
 
   // Write a 255 at the end to signal that we finish serializing heap objects.
   s.writeInt<uint8_t>(255);
@@ -1653,7 +2162,11 @@ void GenGC::printStats(llvm::raw_ostream &os, bool trailingComma) {
      << "\t\t\t\"ygMaxGCCPUPause\": "
      << formatSecs(youngGenCollectionCumStats_.gcCPUTime.max()).secs << ",\n"
      << "\t\t\t\"ygFinalSize\": "
-     << formatSize(youngGenCollectionCumStats_.finalHeapSize).bytes << ",\n";
+     << formatSize(youngGenCollectionCumStats_.finalHeapSize).bytes << ",\n"
+     << "\t\t\t\"ygNumGrowths\": " << youngGenCollectionCumStats_.numGrowths
+     << ",\n"
+     << "\t\t\t\"ygNumShrinks\": " << youngGenCollectionCumStats_.numShrinks
+     << ",\n";
 
   youngGen_.printStats(os, /*trailingComma*/ true);
 
@@ -1780,6 +2293,13 @@ void GenGC::CollectionSection::recordGCStats(
       usedBefore,
       usedAfter,
       regionStats);
+  // And pass on the record of its phases.
+  gc_->recordCollectionEvent(
+      wallElapsedSecs_,
+      cpuElapsedSecs_,
+      gcUsedBefore_,
+      gc_->usedDirect(),
+      regionStats);
 
   LLVM_DEBUG(
       dbgs() << "End garbage collection. numCollected="
@@ -2312,5 +2832,44 @@ void *GenGC::allocSlow(uint32_t sz, bool fixedSize, HasFinalizer hasFinalizer) {
   return res.ptr;
 }
 
+void *GenGC::allocLarge(uint32_t sz) {
+  AllocContextYieldThenClaim yielder(this);
+  const size_t charge = LargeObjectSpace::chargeForSize(sz);
+  if (oldGen_.available() < charge) {
+    collect(/* canEffectiveOOM */ true);
+    if (oldGen_.available() < charge && !oldGen_.growToFit(charge)) {
+      oom(make_error_code(OOMError::MaxHeapReached));
+    }
+  }
+
+  AllocResult res = largeObjects_.alloc(sz);
+  if (LLVM_UNLIKELY(!res.success)) {
+    // The storage provider may be out of segments; freeing dead large objects
+    // returns theirs.
+    collect(/* canEffectiveOOM */ true);
+    res = largeObjects_.alloc(sz);
+    if (!res.success) {
+      oom(make_error_code(OOMError::MaxHeapReached));
+    }
+  }
+
+  if (incrementalMarkActive_) {
+    // Like the old-gen cells allocated during the cycle, the cell is
+    // considered reachable, and its referents are marked once it has been
+    // initialized.
+    GCCell *cell = static_cast<GCCell *>(res.ptr);
+    AlignedHeapSegment::setCellMarkBit(cell);
+    incrementalMarkStack_.push_back(cell);
+  }
+
+  // The cell is not in a generation, so it is not counted by
+  // bytesAllocatedSinceLastGC.
+  totalAllocatedBytes_ += heapAlignSize(sz);
+#ifdef HERMES_SLOW_DEBUG
+  totalAllocatedBytesDebug_ += heapAlignSize(sz);
+#endif
+  return res.ptr;
+}
+
 } // namespace vm
 } // namespace hermes
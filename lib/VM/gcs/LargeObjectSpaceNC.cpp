@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#define DEBUG_TYPE "gc"
+#include "hermes/VM/LargeObjectSpaceNC.h"
+
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/AlignedStorage.h"
+#include "hermes/VM/CompleteMarkState-inline.h"
+#include "hermes/VM/GC.h"
+#include "hermes/VM/GCBase-inline.h"
+#include "hermes/VM/SlotAcceptorDefault-inline.h"
+#include "hermes/VM/YoungGenNC-inline.h"
+
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+
+constexpr uint32_t LargeObjectSpace::kMinAllocSize;
+
+/* static */ const char *LargeObjectSpace::kSegmentName =
+    "hermes-large-object-segment";
+
+/* static */ size_t LargeObjectSpace::chargeForSize(uint32_t size) {
+  return llvm::alignTo(heapAlignSize(size), oscompat::page_size());
+}
+
+AllocResult LargeObjectSpace::alloc(uint32_t size) {
+  auto result = AlignedStorage::create(&gc_->storageProvider_, kSegmentName);
+  if (!result) {
+    return {nullptr, false};
+  }
+  segments_.emplace_back(std::move(result.get()));
+  AlignedHeapSegment &segment = segments_.back();
+  segment.growTo(heapAlignSize(size));
+  segment.clearExternalMemoryCharge();
+  AllocResult res = segment.alloc(size);
+  assert(res.success && "The segment was sized for the cell");
+  segment.cardTable().dirtyCardsForAddressRange(
+      segment.start(), segment.level() - 1);
+  // The segments may have been reallocated.
+  segmentsMoved();
+
+  const size_t charge = chargeForSize(size);
+  externalCharge_ += charge;
+  gc_->oldGen_.creditExternalMemory(charge);
+#ifndef NDEBUG
+  ++numAllocatedObjects_;
+#endif
+  return res;
+}
+
+void LargeObjectSpace::forAllObjs(
+    const std::function<void(GCCell *)> &callback) {
+  for (AlignedHeapSegment &segment : segments_) {
+    segment.forAllObjs(callback);
+  }
+}
+
+void LargeObjectSpace::clearMarkBits() {
+  for (AlignedHeapSegment &segment : segments_) {
+    segment.markBitArray().clear();
+  }
+}
+
+void LargeObjectSpace::markYoungGenPointers() {
+  struct LargeObjEvacAcceptor final : public SlotAcceptorDefault {
+    using SlotAcceptorDefault::accept;
+    using SlotAcceptorDefault::SlotAcceptorDefault;
+
+    void accept(void *&ptr) {
+      if (gc.youngGen_.contains(ptr)) {
+        gc.youngGen_.ensureReferentCopied(reinterpret_cast<GCCell **>(&ptr));
+      }
+    }
+    void accept(HermesValue &hv) {
+      if (hv.isPointer() && gc.youngGen_.contains(hv.getPointer())) {
+        gc.youngGen_.ensureReferentCopied(&hv);
+      }
+    }
+  };
+
+  LargeObjEvacAcceptor acceptor(*gc_);
+  SlotVisitor<LargeObjEvacAcceptor> visitor(acceptor);
+
+  // Evacuating referents allocates in the old generation, never here, so the
+  // segments cannot change while they are scanned.
+  for (AlignedHeapSegment &segment : segments_) {
+    CardTable &cardTable = segment.cardTable();
+    GCCell *cell = cellIn(segment);
+    size_t from = cardTable.addressToIndex(segment.start());
+    const size_t to = cardTable.addressToIndex(segment.level() - 1) + 1;
+
+    while (const auto oiBegin = cardTable.findNextDirtyCard(from, to)) {
+      const auto iBegin = *oiBegin;
+      const auto oiEnd = cardTable.findNextCleanCard(iBegin, to);
+      const auto iEnd = oiEnd ? *oiEnd : to;
+      GCBase::markCellWithinRange(
+          visitor,
+          cell,
+          cell->getVT(),
+          gc_,
+          cardTable.indexToAddress(iBegin),
+          cardTable.indexToAddress(iEnd));
+      from = iEnd;
+    }
+    cardTable.clear();
+  }
+}
+
+void LargeObjectSpace::sweep() {
+  assert(displacedVTables_.empty() && "Leftover VTables from a previous sweep");
+  GCBase::IDTracker &tracker = gc_->getIDTracker();
+  for (AlignedHeapSegment &segment : segments_) {
+    GCCell *cell = cellIn(segment);
+    if (!AlignedHeapSegment::getCellMarkBit(cell)) {
+      if (tracker.isTrackingIDs()) {
+        tracker.untrackObject(cell);
+      }
+      const size_t charge = chargeForSize(cell->getAllocatedSize());
+      assert(externalCharge_ >= charge && "Charge underflow");
+      externalCharge_ -= charge;
+      gc_->oldGen_.debitExternalMemory(charge);
+      continue;
+    }
+#ifndef NDEBUG
+    ++numReachableObjects_;
+    gc_->trackReachable(cell->getKind(), cell->getAllocatedSize());
+#endif
+    displacedVTables_.push_back(cell->getVT());
+    cell->setForwardingPointer(cell);
+  }
+}
+
+void LargeObjectSpace::updateReferences(FullMSCUpdateAcceptor *acceptor) {
+  auto vTable = displacedVTables_.begin();
+  for (AlignedHeapSegment &segment : segments_) {
+    GCCell *cell = cellIn(segment);
+    if (AlignedHeapSegment::getCellMarkBit(cell)) {
+      assert(vTable != displacedVTables_.end() && "Missing displaced VTable");
+      GCBase::markCell(cell, *vTable++, gc_, *acceptor);
+    }
+  }
+}
+
+void LargeObjectSpace::compact() {
+  std::vector<AlignedHeapSegment> live;
+  std::vector<const char *> dead;
+  auto vTable = displacedVTables_.begin();
+  for (AlignedHeapSegment &segment : segments_) {
+    GCCell *cell = cellIn(segment);
+    if (AlignedHeapSegment::getCellMarkBit(cell)) {
+      assert(vTable != displacedVTables_.end() && "Missing displaced VTable");
+      cell->setForwardingPointer(reinterpret_cast<const GCCell *>(*vTable++));
+      assert(cell->isValid() && "Cell was invalid after restoring its VTable");
+      live.push_back(std::move(segment));
+    } else {
+      dead.push_back(segment.lowLim());
+    }
+  }
+  assert(vTable == displacedVTables_.end() && "Not all VTables restored");
+  displacedVTables_.clear();
+
+  std::sort(dead.begin(), dead.end());
+  gc_->forgetSegments(dead);
+  // Destroying the segments of the dead cells returns their storage to the
+  // provider.
+  segments_ = std::move(live);
+  segmentsMoved();
+}
+
+void LargeObjectSpace::updateCardTablesAfterCompaction(bool youngIsEmpty) {
+  for (AlignedHeapSegment &segment : segments_) {
+    if (youngIsEmpty) {
+      segment.cardTable().clear();
+    } else {
+      // As in the old generation, conservatively assume that any card may
+      // hold a pointer into the young generation.
+      segment.cardTable().dirtyCardsForAddressRange(
+          segment.start(), segment.level() - 1);
+    }
+  }
+}
+
+#ifdef HERMES_SLOW_DEBUG
+void LargeObjectSpace::checkWellFormed(const GenGC *gc) const {
+  size_t charge = 0;
+  for (const AlignedHeapSegment &segment : segments_) {
+    segment.checkWellFormed(gc);
+    assert(
+        cellIn(segment)->nextCell() == reinterpret_cast<GCCell *>(
+                                           segment.level()) &&
+        "A large object segment must hold exactly one cell");
+    charge += chargeForSize(cellIn(segment)->getAllocatedSize());
+  }
+  assert(charge == externalCharge_ && "Inconsistent external charge");
+}
+#endif
+
+void LargeObjectSpace::segmentsMoved() {
+  for (AlignedHeapSegment &segment : segments_) {
+    gc_->segmentMoved(&segment);
+  }
+}
+
+} // namespace vm
+} // namespace hermes
+
+#undef DEBUG_TYPE
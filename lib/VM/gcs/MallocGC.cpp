@@ -230,35 +230,44 @@ void MallocGC::collect() {
   auto allocatedBefore = allocatedBytes_;
 
   resetStats();
+  beginCollectionEvent(/* youngGen */ false);
 
   // Begin the collection phases.
   {
     GCCycle cycle{this};
     MarkingAcceptor acceptor(*this);
     DroppingAcceptor<MarkingAcceptor> nameAcceptor{acceptor};
-    markRoots(nameAcceptor, true);
+    {
+      GCPhaseTimer timer(this, GCPhase::Mark);
+      markRoots(nameAcceptor, true);
 #ifdef HERMES_SLOW_DEBUG
-    clearUnmarkedPropertyMaps();
+      clearUnmarkedPropertyMaps();
 #endif
-    while (!acceptor.worklist_.empty()) {
-      CellHeader *header = acceptor.worklist_.back();
-      acceptor.worklist_.pop_back();
-      assert(header->isMarked() && "Pointer on the worklist isn't marked");
-      GCCell *cell = header->data();
-      // Since `markCell` adds onto worklist_, this cannot be expressed as a
-      // normal loop.
-      GCBase::markCell(cell, this, acceptor);
-      allocatedBytes_ += cell->getAllocatedSize();
+      while (!acceptor.worklist_.empty()) {
+        CellHeader *header = acceptor.worklist_.back();
+        acceptor.worklist_.pop_back();
+        assert(header->isMarked() && "Pointer on the worklist isn't marked");
+        GCCell *cell = header->data();
+        // Since `markCell` adds onto worklist_, this cannot be expressed as a
+        // normal loop.
+        GCBase::markCell(cell, this, acceptor);
+        allocatedBytes_ += cell->getAllocatedSize();
+      }
     }
 
-    // Update weak roots references.
-    markWeakRoots(acceptor);
+    {
+      GCPhaseTimer timer(this, GCPhase::WeakReferences);
+      // Update weak roots references.
+      markWeakRoots(acceptor);
 
-    // Update and remove weak references.
-    updateWeakReferences();
-    resetWeakReferences();
+      // Update and remove weak references.
+      updateWeakReferences();
+      resetWeakReferences();
+    }
     // Free the unused symbols.
     gcCallbacks_->freeSymbols(acceptor.markedSymbols_);
+    // The dead cells are finalized and freed as they are swept.
+    GCPhaseTimer sweepTimer(this, GCPhase::Sweep);
     // By the end of the marking loop, all pointers left in pointers_ are dead.
     for (CellHeader *header : pointers_) {
 #ifndef HERMESVM_SANITIZE_HANDLES
@@ -339,9 +348,22 @@ void MallocGC::collect() {
       allocatedBytes_,
       allocatedBefore,
       allocatedBytes_);
+  recordCollectionEvent(
+      wallElapsedSecs,
+      cpuElapsedSecs,
+      allocatedBefore,
+      allocatedBytes_,
+      /* regionStats */ nullptr);
   checkTripwire(allocatedBytes_);
 }
 
+size_t MallocGC::notifyMemoryPressure(MemoryPressureLevel) {
+  const gcheapsize_t allocatedBefore = allocatedBytes_;
+  collect();
+  return allocatedBefore > allocatedBytes_ ? allocatedBefore - allocatedBytes_
+                                           : 0;
+}
+
 void MallocGC::finalizeAll() {
   for (CellHeader *header : pointers_) {
     GCCell *cell = header->data();
@@ -349,6 +371,14 @@ void MallocGC::finalizeAll() {
   }
 }
 
+uint64_t MallocGC::finalizeObservable() {
+  uint64_t leakedBytes = 0;
+  for (CellHeader *header : pointers_) {
+    leakedBytes += finalizeForFastTeardown(header->data(), this);
+  }
+  return leakedBytes;
+}
+
 void MallocGC::printStats(llvm::raw_ostream &os, bool trailingComma) {
   if (!recordGcStats_) {
     return;
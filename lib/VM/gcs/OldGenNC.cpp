@@ -13,6 +13,7 @@
 #include "hermes/VM/AllocResult.h"
 #include "hermes/VM/CompactionResult-inline.h"
 #include "hermes/VM/CompleteMarkState-inline.h"
+#include "hermes/VM/FillerCell.h"
 #include "hermes/VM/GC.h"
 #include "hermes/VM/GCBase-inline.h"
 #include "hermes/VM/GCPointer-inline.h"
@@ -25,7 +26,9 @@
 #include "llvm/Support/MathExtras.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
+#include <thread>
 #include <vector>
 
 namespace hermes {
@@ -243,6 +246,12 @@ bool OldGen::ensureFits(size_t amount) {
   return seedSegmentCacheForSize(levelOffset() + amount);
 }
 
+size_t OldGen::releaseSegmentCache() {
+  const size_t released = segmentCache_.size() * AlignedStorage::size();
+  segmentCache_.clear();
+  return released;
+}
+
 size_t OldGen::effectiveSize() {
   size_t trailingExternalMem = trailingExternalMemory();
   if (trailingExternalMem > size()) {
@@ -365,6 +374,11 @@ void OldGen::markYoungGenPointers(OldGen::Location originalLevel) {
   verifyCardTableBoundaries();
 #endif // HERMES_SLOW_DEBUG
 
+  if (gc_->cardScanThreads_ > 1) {
+    markYoungGenPointersParallel(originalLevel, gc_->cardScanThreads_);
+    return;
+  }
+
   struct OldGenObjEvacAcceptor final : public SlotAcceptorDefault {
     using SlotAcceptorDefault::accept;
     using SlotAcceptorDefault::SlotAcceptorDefault;
@@ -495,6 +509,143 @@ void OldGen::markYoungGenPointers(OldGen::Location originalLevel) {
   }
 }
 
+void OldGen::markYoungGenPointersParallel(
+    OldGen::Location originalLevel,
+    unsigned numThreads) {
+  /// The slots found by one scanning thread that point into the young
+  /// generation.
+  struct YoungGenSlots {
+    std::vector<GCCell **> ptrs;
+    std::vector<HermesValue *> hvs;
+#ifdef HERMESVM_COMPRESSED_POINTERS
+    std::vector<BasedPointer *> basedPtrs;
+#endif
+  };
+
+  struct YoungGenSlotsAcceptor final : public SlotAcceptorDefault {
+    using SlotAcceptorDefault::accept;
+
+    YoungGenSlots &slots;
+
+    YoungGenSlotsAcceptor(GC &gc, YoungGenSlots &slots)
+        : SlotAcceptorDefault(gc), slots(slots) {}
+
+    void accept(void *&ptr) override {
+      if (gc.youngGen_.contains(ptr)) {
+        slots.ptrs.push_back(reinterpret_cast<GCCell **>(&ptr));
+      }
+    }
+#ifdef HERMESVM_COMPRESSED_POINTERS
+    void accept(BasedPointer &ptr) override {
+      // Don't use the default from SlotAcceptorDefault since the address of the
+      // reference is recorded.
+      if (gc.youngGen_.contains(gc.getPointerBase()->basedToPointer(ptr))) {
+        slots.basedPtrs.push_back(&ptr);
+      }
+    }
+#endif
+    void accept(HermesValue &hv) override {
+      if (hv.isPointer() && gc.youngGen_.contains(hv.getPointer())) {
+        slots.hvs.push_back(&hv);
+      }
+    }
+  };
+
+  // Determine the segments to scan, and how far, up front: unlike in the serial
+  // version, nothing is allocated in this generation while scanning.
+  std::vector<std::pair<AlignedHeapSegment *, const char *>> toScan;
+  {
+    auto segs = GCSegmentRange::concat(
+        OldGenFilledSegmentRange::create(this),
+        GCSegmentRange::singleton(&activeSegment()));
+    size_t i = 0;
+    while (AlignedHeapSegment *seg = segs->next()) {
+      if (originalLevel.segmentNum < i)
+        break;
+      toScan.emplace_back(
+          seg,
+          i == originalLevel.segmentNum ? originalLevel.ptr : seg->level());
+      i++;
+    }
+  }
+
+  // Each thread scans whole segments, which it claims dynamically, since the
+  // number of dirty cards varies widely between segments.
+  std::vector<YoungGenSlots> threadSlots(numThreads);
+  std::atomic<size_t> nextSegment{0};
+  auto scanSegments = [this, &toScan, &nextSegment](YoungGenSlots &slots) {
+    YoungGenSlotsAcceptor acceptor(*gc_, slots);
+    SlotVisitor<YoungGenSlotsAcceptor> visitor(acceptor);
+    for (size_t i; (i = nextSegment.fetch_add(1)) < toScan.size();) {
+      AlignedHeapSegment *seg = toScan[i].first;
+      const char *const origSegLevel = toScan[i].second;
+      auto &cardTable = seg->cardTable();
+
+      size_t from = cardTable.addressToIndex(seg->start());
+      size_t to = cardTable.addressToIndex(origSegLevel - 1) + 1;
+
+      while (const auto oiBegin = cardTable.findNextDirtyCard(from, to)) {
+        const auto iBegin = *oiBegin;
+        const auto oiEnd = cardTable.findNextCleanCard(iBegin, to);
+        const auto iEnd = oiEnd ? *oiEnd : to;
+
+        const char *const begin = cardTable.indexToAddress(iBegin);
+        const char *const end = cardTable.indexToAddress(iEnd);
+        const void *const boundary = std::min(end, origSegLevel);
+
+        // See markYoungGenPointers for the treatment of the objects that
+        // straddle the boundaries of the dirty range.
+        GCCell *const firstObj = cardTable.firstObjForCard(iBegin);
+        GCCell *obj = firstObj;
+        GCBase::markCellWithinRange(
+            visitor, obj, obj->getVT(), gc_, begin, end);
+        for (GCCell *next = obj->nextCell(); next < boundary;
+             next = next->nextCell()) {
+          obj = next;
+          GCBase::markCell(visitor, obj, obj->getVT(), gc_);
+        }
+        if (LLVM_LIKELY(obj != firstObj)) {
+          GCBase::markCellWithinRange(
+              visitor, obj, obj->getVT(), gc_, begin, end);
+        }
+
+        from = iEnd;
+      }
+      cardTable.clear();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  for (unsigned t = 1; t < numThreads; ++t) {
+    YoungGenSlots *slots = &threadSlots[t];
+    threads.emplace_back([&scanSegments, slots]() { scanSegments(*slots); });
+  }
+  scanSegments(threadSlots[0]);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Evacuate the referents.  This allocates in this generation, which is not
+  // thread-safe.
+#ifdef HERMESVM_COMPRESSED_POINTERS
+  YoungGen::EvacAcceptor acceptor(*gc_, gc_->youngGen_);
+#endif
+  for (YoungGenSlots &slots : threadSlots) {
+    for (GCCell **ptr : slots.ptrs) {
+      gc_->youngGen_.ensureReferentCopied(ptr);
+    }
+    for (HermesValue *hv : slots.hvs) {
+      gc_->youngGen_.ensureReferentCopied(hv);
+    }
+#ifdef HERMESVM_COMPRESSED_POINTERS
+    for (BasedPointer *ptr : slots.basedPtrs) {
+      acceptor.accept(*ptr);
+    }
+#endif
+  }
+}
+
 void OldGen::youngGenTransitiveClosure(
     const Location &toScanLoc,
     YoungGen::EvacAcceptor &acceptor) {
@@ -565,8 +716,28 @@ void OldGen::verifyCardTableBoundaries() const {
 void OldGen::sweepAndInstallForwardingPointers(
     GC *gc,
     SweepResult *sweepResult) {
-  forUsedSegments([gc, sweepResult](AlignedHeapSegment &segment) {
-    segment.sweepAndInstallForwardingPointers(gc, sweepResult);
+  // The free regions of the previous collection may be compacted away.
+  freeList_.clear();
+
+  // Each segment in the dense prefix is swept into the chunk created from it.
+  // The compaction result starts with the chunk of the first segment, and
+  // must be advanced for the others.
+  bool inDensePrefix = true;
+  bool isFirst = true;
+  FreeList *freeList = &freeList_;
+  forUsedSegments([gc, sweepResult, freeList, &inDensePrefix, &isFirst](
+                      AlignedHeapSegment &segment) {
+    inDensePrefix = inDensePrefix &&
+        segment.canSweepInPlace(kSweepInPlaceMinLiveFraction);
+    if (inDensePrefix) {
+      if (!isFirst) {
+        sweepResult->compactionResult.nextChunk();
+      }
+      segment.sweepInPlace(gc, sweepResult, freeList);
+    } else {
+      segment.sweepAndInstallForwardingPointers(gc, sweepResult);
+    }
+    isFirst = false;
   });
 }
 
@@ -609,6 +780,64 @@ void OldGen::recordLevelAfterCompaction(
   updateCardTableBoundary();
 }
 
+AllocResult OldGen::allocFromFreeList(
+    uint32_t size,
+    HasFinalizer hasFinalizer) {
+#ifdef HERMES_EXTRA_DEBUG
+  // Only the boundary table of the active segment is unprotected around
+  // allocations, but free regions may be in any segment.
+  if (gc_->doMetadataProtection_) {
+    return {nullptr, false};
+  }
+#endif
+
+  const gcheapsize_t allocSize = heapAlignSize(size);
+  FreeList::Region region = freeList_.take(allocSize);
+  if (!region) {
+    return {nullptr, false};
+  }
+
+  char *const resPtr = region.start;
+  char *const allocEnd = resPtr + allocSize;
+  char *const regionEnd = resPtr + region.size;
+  if (allocEnd < regionEnd) {
+#ifndef NDEBUG
+    // The FillerCell is variable-sized, whatever the caller is allocating.
+    const auto lastAllocWasFixedSize = gc_->lastAllocWasFixedSize_;
+    gc_->lastAllocWasFixedSize_ = GC::FixedSizeValue::Unknown;
+    // The region was a single FillerCell; its remainder is another one.
+    allocContext().numAllocatedObjects++;
+#endif
+    new (allocEnd) FillerCell(gc_, regionEnd - allocEnd);
+#ifndef NDEBUG
+    gc_->lastAllocWasFixedSize_ = lastAllocWasFixedSize;
+#endif
+    freeList_.add(allocEnd, regionEnd - allocEnd);
+  }
+
+  // The region may have crossed cards whose first object now starts later.
+  // When allocating directly in the OG, the boundaries are recreated before
+  // the next young-gen collection instead.
+  if (gc_->allocContextFromYG_) {
+    CardTable *cardTable = AlignedHeapSegment::cardTableCovering(resPtr);
+    auto updateBoundaries = [cardTable](char *start, char *end) {
+      CardTable::Boundary boundary = cardTable->nextBoundary(start);
+      if (boundary.address() < end) {
+        cardTable->updateBoundaries(&boundary, start, end);
+      }
+    };
+    updateBoundaries(resPtr, allocEnd);
+    if (allocEnd < regionEnd) {
+      updateBoundaries(allocEnd, regionEnd);
+    }
+  }
+
+  if (hasFinalizer == HasFinalizer::Yes) {
+    cellsWithFinalizers().push_back(reinterpret_cast<GCCell *>(resPtr));
+  }
+  return {resPtr, true};
+}
+
 AllocResult OldGen::fullCollectThenAlloc(
     uint32_t allocSize,
     HasFinalizer hasFinalizer) {
@@ -860,7 +1089,8 @@ void OldGen::checkWellFormed(const GC *gc) const {
     totalExtSize += extSize;
   });
 
-  assert(totalExtSize == externalMemory());
+  assert(
+      totalExtSize + gc->largeObjects_.externalCharge() == externalMemory());
   checkFinalizableObjectsListWellFormed();
 }
 #endif
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/ParallelMarkState.h"
+
+#include "hermes/VM/GC.h"
+#include "hermes/VM/GCBase-inline.h"
+#include "hermes/VM/HermesValue-inline.h"
+#include "hermes/VM/SlotAcceptorDefault-inline.h"
+
+#include <thread>
+
+namespace hermes {
+namespace vm {
+
+constexpr size_t ParallelMarkState::kPublishThreshold;
+constexpr size_t ParallelMarkState::kStealChunk;
+
+/// The state owned by a single marking thread.
+struct ParallelMarkState::Worker {
+  /// The position of this worker in ParallelMarkState::workers_.
+  const unsigned index;
+
+  /// Gray cells only this worker can access.
+  std::vector<GCCell *> stack;
+
+  /// Protects published.
+  std::mutex publishedLock;
+
+  /// Gray cells that other workers are allowed to steal.
+  std::deque<GCCell *> published;
+
+  /// Every bit corresponds to a symbol id, and is set if this worker found the
+  /// symbol during marking.  Kept per worker because GC::markSymbol is not
+  /// thread-safe.
+  std::vector<bool> markedSymbols;
+
+  Worker(unsigned index, size_t numSymbols)
+      : index(index), markedSymbols(numSymbols, false) {}
+};
+
+/// Marks the referents of a cell, pushing the newly marked ones on the private
+/// stack of the worker doing the scanning.
+struct ParallelMarkState::MarkAcceptor final : public SlotAcceptorDefault {
+  Worker &worker;
+
+  MarkAcceptor(GC &gc, Worker &worker)
+      : SlotAcceptorDefault(gc), worker(worker) {}
+
+  using SlotAcceptorDefault::accept;
+
+  void accept(void *&ptr) override {
+    if (ptr) {
+      mark(ptr);
+    }
+  }
+
+  void accept(HermesValue &hv) override {
+    if (hv.isPointer()) {
+      void *ptr = hv.getPointer();
+      if (ptr) {
+        mark(ptr);
+      }
+    } else if (hv.isSymbol()) {
+      accept(hv.getSymbol());
+    }
+  }
+
+  void accept(SymbolID sym) override {
+    if (LLVM_UNLIKELY(sym.isInvalid()))
+      return;
+    uint32_t index = sym.unsafeGetIndex();
+    assert(
+        index < worker.markedSymbols.size() &&
+        "symbolID out of reported range");
+    worker.markedSymbols[index] = true;
+  }
+
+ private:
+  void mark(void *ptr) {
+    assert(gc.dbgContains(ptr));
+#ifdef HERMES_EXTRA_DEBUG
+    if (!reinterpret_cast<GCCell *>(ptr)->isValid()) {
+      hermes_fatal("HermesGC: marking pointer to invalid object.");
+    }
+#endif
+    MarkBitArrayNC *markBits = AlignedHeapSegment::markBitArrayCovering(ptr);
+    if (markBits->markAtomic(markBits->addressToIndex(ptr))) {
+      worker.stack.push_back(reinterpret_cast<GCCell *>(ptr));
+    }
+  }
+};
+
+ParallelMarkState::ParallelMarkState(
+    GC *gc,
+    unsigned numWorkers,
+    size_t numSymbols)
+    : gc_(gc) {
+  assert(numWorkers > 0 && "Need at least one marking thread");
+  workers_.reserve(numWorkers);
+  for (unsigned i = 0; i < numWorkers; ++i) {
+    workers_.emplace_back(new Worker(i, numSymbols));
+  }
+}
+
+ParallelMarkState::~ParallelMarkState() = default;
+
+void ParallelMarkState::addGray(GCCell *cell) {
+  // Spread the initial cells round-robin over the published deques, so that
+  // every worker has something to start on.  No locking is needed, as the
+  // workers have not been started yet.
+  Worker &worker = *workers_[nextSeedWorker_];
+  nextSeedWorker_ = (nextSeedWorker_ + 1) % workers_.size();
+  worker.published.push_back(cell);
+  numPublished_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ParallelMarkState::run() {
+  numIdle_ = 0;
+
+  std::vector<std::thread> threads;
+  threads.reserve(workers_.size() - 1);
+  for (unsigned i = 1; i < workers_.size(); ++i) {
+    Worker *worker = workers_[i].get();
+    threads.emplace_back([this, worker]() { workerLoop(*worker); });
+  }
+  workerLoop(*workers_[0]);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  assert(numPublished_ == 0 && "Marking finished with published work left");
+}
+
+void ParallelMarkState::flushMarkedSymbols() {
+  for (auto &worker : workers_) {
+    const std::vector<bool> &marked = worker->markedSymbols;
+    for (size_t i = 0, e = marked.size(); i < e; ++i) {
+      if (marked[i]) {
+        gc_->markSymbol(SymbolID::unsafeCreate(i));
+      }
+    }
+  }
+}
+
+void ParallelMarkState::workerLoop(Worker &worker) {
+  MarkAcceptor acceptor(*gc_, worker);
+  const unsigned numWorkers = workers_.size();
+
+  while (true) {
+    while (!worker.stack.empty()) {
+      GCCell *cell = worker.stack.back();
+      worker.stack.pop_back();
+      GCBase::markCell(cell, gc_, acceptor);
+      maybePublish(worker);
+    }
+
+    if (steal(worker)) {
+      continue;
+    }
+
+    // Out of work.  Wait until either some other worker publishes more, or
+    // every worker is idle, which means marking is complete: only non-idle
+    // workers publish, and a worker only becomes idle after failing to find
+    // published work anywhere, including its own deque.
+    numIdle_.fetch_add(1);
+    while (true) {
+      if (numIdle_.load() == numWorkers) {
+        return;
+      }
+      if (numPublished_.load() != 0) {
+        numIdle_.fetch_sub(1);
+        if (steal(worker)) {
+          break;
+        }
+        numIdle_.fetch_add(1);
+      }
+      std::this_thread::yield();
+    }
+  }
+}
+
+void ParallelMarkState::maybePublish(Worker &worker) {
+  if (LLVM_LIKELY(worker.stack.size() < kPublishThreshold) ||
+      workers_.size() == 1) {
+    return;
+  }
+  // Publish the oldest cells (at the bottom of the stack), which tend to
+  // root the largest unexplored subgraphs.
+  auto begin = worker.stack.begin();
+  auto end = begin + kStealChunk;
+  {
+    std::lock_guard<std::mutex> lk(worker.publishedLock);
+    worker.published.insert(worker.published.end(), begin, end);
+    numPublished_.fetch_add(kStealChunk);
+  }
+  worker.stack.erase(begin, end);
+}
+
+bool ParallelMarkState::steal(Worker &worker) {
+  const unsigned numWorkers = workers_.size();
+  // Start with the worker's own deque, then try the others in order, starting
+  // from the next one so that thieves spread out over their victims.
+  for (unsigned i = 0; i < numWorkers; ++i) {
+    Worker &victim = *workers_[(worker.index + i) % numWorkers];
+    std::lock_guard<std::mutex> lk(victim.publishedLock);
+    if (victim.published.empty()) {
+      continue;
+    }
+    // Take at most half of what a victim has published, so it can continue
+    // with the rest.
+    size_t n = &victim == &worker
+        ? std::min(victim.published.size(), kStealChunk)
+        : std::min((victim.published.size() + 1) / 2, kStealChunk);
+    auto begin = victim.published.begin();
+    worker.stack.insert(worker.stack.end(), begin, begin + n);
+    victim.published.erase(begin, begin + n);
+    numPublished_.fetch_sub(n);
+    return true;
+  }
+  return false;
+}
+
+} // namespace vm
+} // namespace hermes
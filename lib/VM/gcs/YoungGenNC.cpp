@@ -228,6 +228,7 @@ AllocResult YoungGen::allocSlow(
   if (LLVM_LIKELY(nextGen_->ensureFits(usedDirect()))) {
     // There is enough space; do the young-gen collection.
     collect();
+    gc_->markIncrementally();
     AllocResult res = allocRaw(allocSize, hasFinalizer);
     if (res.success) {
       return res;
@@ -267,8 +268,11 @@ AllocResult YoungGen::fullCollectThenAlloc(
   if (allocSize <= sizeDirect() && nextGen_->growToFit(usedDirect())) {
     collect();
     AllocResult res = allocRaw(allocSize, hasFinalizer);
-    assert(res.success && "preceding test should guarantee success.");
-    return res;
+    // This can only fail if adaptive sizing shrank the young generation in
+    // the collection.
+    if (LLVM_LIKELY(res.success)) {
+      return res;
+    }
   }
 
   // The allocation is not going to fit into the young generation, if it is not
@@ -289,6 +293,8 @@ void YoungGen::collect() {
   assert(gc_->noAllocLevel_ == 0 && "no GC allowed right now");
   GenGC::CollectionSection ygCollection(
       gc_, "YoungGen collection", gc_->getGCCallbacks());
+  gc_->beginCollectionEvent(/* youngGen */ true);
+  const auto collectionStart = steady_clock::now();
 
 #ifdef HERMES_EXTRA_DEBUG
   /// Protect the card table boundary table, to detect corrupting mutator
@@ -332,7 +338,9 @@ void YoungGen::collect() {
   auto markOldToYoungStart = steady_clock::now();
   {
     PerfSection ygMarkOldToYoungSystraceRegion("ygMarkOldToYoung");
+    GenGC::GCPhaseTimer timer(gc_, GCPhase::CardScan);
     nextGen_->markYoungGenPointers(toScan);
+    gc_->largeObjects_.markYoungGenPointers();
   }
 
   auto markRootsStart = steady_clock::now();
@@ -340,12 +348,14 @@ void YoungGen::collect() {
   DroppingAcceptor<EvacAcceptor> nameAcceptor{acceptor};
   {
     PerfSection ygMarkRootsSystraceRegion("ygMarkRoots");
+    GenGC::GCPhaseTimer timer(gc_, GCPhase::YoungEvacuation);
     gc_->markRoots(nameAcceptor, /*markLongLived*/ false);
   }
 
   auto scanTransitiveStart = steady_clock::now();
   {
     PerfSection ygScanTransitiveSystraceRegion("ygScanTransitive");
+    GenGC::GCPhaseTimer timer(gc_, GCPhase::YoungEvacuation);
     nextGen_->youngGenTransitiveClosure(toScan, acceptor);
   }
 
@@ -362,11 +372,15 @@ void YoungGen::collect() {
     gc_->updateWeakReferences(/*fullGC*/ false);
   }
 
+  // Likewise, find which of the sampled allocations survived.
+  gc_->resolveAllocationSiteSamples(/*fullGC*/ false);
+
   // Call the finalizers of unreachable objects. Assumes all cells that survived
   // the young gen collection are moved to the old gen collection.
   auto finalizersStart = steady_clock::now();
   {
     PerfSection ygFinalizeSystraceRegion("ygFinalize");
+    GenGC::GCPhaseTimer timer(gc_, GCPhase::Finalization);
     finalizeUnreachableAndTransferReachableObjects();
   }
   auto finalizersEnd = steady_clock::now();
@@ -387,8 +401,10 @@ void YoungGen::collect() {
   // been moved to the old generation, and we're considering the
   // objects already in the old generation to be reachable, so the
   // total number of reachable objects is just the old-gen allocated
-  // objects.
-  gc_->recordNumReachableObjects(nextGen_->numAllocatedObjects());
+  // objects, plus the large objects.
+  gc_->recordNumReachableObjects(
+      nextGen_->numAllocatedObjects() +
+      gc_->largeObjects_.numAllocatedObjects());
 
   // The hidden classes found reachable in the young gen were moved to
   // the old gen; move the stat, and record it in the GCBase variable.
@@ -410,6 +426,16 @@ void YoungGen::collect() {
   resetNumAllHiddenClasses();
 #endif // !NDEBUG
 
+  // Track the bytes of promoted objects.
+  size_t promotedBytes = (nextGen_->used() - oldGenUsedBefore);
+  gc_->collectionEvent_.promotedBytes = promotedBytes;
+
+  // The young generation is empty, which makes this the time to resize it.
+  gc_->updateYoungGenSize(
+      GCBase::clockDiffSeconds(collectionStart, steady_clock::now()),
+      youngGenUsedBefore,
+      promotedBytes);
+
   ygCollection.recordGCStats(
       sizeDirect(),
       youngGenUsedBefore,
@@ -425,8 +451,6 @@ void YoungGen::collect() {
   updateWeakRefsSecs_ +=
       GCBase::clockDiffSeconds(updateWeakRefsStart, finalizersStart);
   finalizersSecs_ += GCBase::clockDiffSeconds(finalizersStart, finalizersEnd);
-  // Track the bytes of promoted objects.
-  size_t promotedBytes = (nextGen_->used() - oldGenUsedBefore);
   cumPromotedBytes_ += promotedBytes;
   ygCollection.addArg("ygPromoted", promotedBytes);
   ygCollection.addArg("ogUsedAfter", nextGen_->used());
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_PUBLIC_GCCOLLECTIONEVENT_H
+#define HERMES_PUBLIC_GCCOLLECTIONEVENT_H
+
+#include <array>
+#include <cstdint>
+
+namespace hermes {
+namespace vm {
+
+/// The phases of a collection that are timed separately.  Not every kind of
+/// collection goes through every phase.
+enum class GCPhase : uint8_t {
+  /// Finding the live cells: marking from the roots, and transitively.
+  Mark,
+  /// Computing where the live cells of a full collection move to.
+  Sweep,
+  /// Updating the pointers to the cells that move in a full collection.
+  UpdateReferences,
+  /// Moving the live cells of a full collection.
+  Compact,
+  /// Clearing the weak references to dead cells.
+  WeakReferences,
+  /// Running the finalizers of the dead cells.
+  Finalization,
+  /// Copying the live young-gen cells into the old generation.
+  YoungEvacuation,
+  /// Scanning the dirty cards of the old generation for pointers into the
+  /// young generation.
+  CardScan,
+};
+
+/// The number of values of GCPhase.
+constexpr unsigned kNumGCPhases = static_cast<unsigned>(GCPhase::CardScan) + 1;
+
+/// \return a short name for \p phase, suitable for use in property names.
+inline const char *gcPhaseName(GCPhase phase) {
+  switch (phase) {
+    case GCPhase::Mark:
+      return "mark";
+    case GCPhase::Sweep:
+      return "sweep";
+    case GCPhase::UpdateReferences:
+      return "updateRefs";
+    case GCPhase::Compact:
+      return "compact";
+    case GCPhase::WeakReferences:
+      return "weakRefs";
+    case GCPhase::Finalization:
+      return "finalize";
+    case GCPhase::YoungEvacuation:
+      return "youngEvacuation";
+    case GCPhase::CardScan:
+      return "cardScan";
+  }
+  return "unknown";
+}
+
+/// A record of a single collection, passed to the collection event callback
+/// of the GCConfig once the collection has finished.  Times are in seconds.
+struct GCCollectionEvent {
+  /// Whether this was a young-gen collection, as opposed to a collection of
+  /// the whole heap.
+  bool youngGen{false};
+
+  /// The time the whole collection took.
+  double wallSecs{0.0};
+  double cpuSecs{0.0};
+
+  /// The time spent in each phase, indexed by GCPhase.  The phases do not
+  /// cover the whole collection, so they may add up to less than the total.
+  std::array<double, kNumGCPhases> phaseWallSecs{};
+  std::array<double, kNumGCPhases> phaseCPUSecs{};
+
+  /// The bytes allocated in the heap before, and after, the collection.
+  uint64_t usedBefore{0};
+  uint64_t usedAfter{0};
+
+  /// The bytes of young-gen cells that survived the collection by being
+  /// moved to the old generation.
+  uint64_t promotedBytes{0};
+
+  /// The bytes of the cells in the collected region that survived it.
+  uint64_t survivingBytes{0};
+
+  double phaseWallSecsOf(GCPhase phase) const {
+    return phaseWallSecs[static_cast<unsigned>(phase)];
+  }
+  double phaseCPUSecsOf(GCPhase phase) const {
+    return phaseCPUSecs[static_cast<unsigned>(phase)];
+  }
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_PUBLIC_GCCOLLECTIONEVENT_H
@@ -9,6 +9,7 @@
 #define HERMES_PUBLIC_GCCONFIG_H
 
 #include "hermes/Public/CtorConfig.h"
+#include "hermes/Public/GCCollectionEvent.h"
 #include "hermes/Public/GCTripwireContext.h"
 #include "hermes/Public/MemoryEventTracker.h"
 
@@ -71,6 +72,14 @@ enum ReleaseUnused {
   kReleaseUnusedYoungAlways /// Also young gen, also on young gen collections.
 };
 
+/// Whether to back the heap with huge pages, which reduces the TLB misses of
+/// collections on large heaps.
+enum HugePagesMode {
+  kHugePagesNone = 0, /// Use normal pages.
+  kHugePagesTransparent, /// Advise the OS to use transparent huge pages.
+  kHugePagesExplicit /// Use reserved huge pages, falling back to transparent.
+};
+
 /// Parameters for GC Initialisation.  Check documentation in README.md
 /// constexpr indicates that the default value is constexpr.
 #define GC_FIELDS(F)                                                      \
@@ -86,6 +95,12 @@ enum ReleaseUnused {
   /* Sizing heuristic: fraction of heap to be occupied by live data. */   \
   F(constexpr, double, OccupancyTarget, 0.5)                              \
                                                                           \
+  /* If non-zero, the occupancy target is adapted after each full */      \
+  /* collection so that about this fraction of the time is spent in */    \
+  /* the GC: the heap grows when collections take more, and shrinks */    \
+  /* when they take less.  0 keeps the occupancy target fixed. */         \
+  F(constexpr, double, GCTimeTarget, 0)                                   \
+                                                                          \
   /* Number of consecutive full collections considered to be an OOM. */   \
   F(constexpr,                                                            \
     unsigned,                                                             \
@@ -120,6 +135,62 @@ enum ReleaseUnused {
   /* Whether to use mprotect on GC metadata between GCs. */               \
   F(constexpr, bool, ProtectMetadata, false)                              \
                                                                           \
+  /* Number of threads used to transitively mark the heap during full */  \
+  /* collections.  1 means marking happens on the collecting thread. */   \
+  F(constexpr, unsigned, MarkingThreads, 1)                               \
+                                                                          \
+  /* Number of threads used to update references to moved objects */      \
+  /* during the compaction phase of full collections. */                  \
+  F(constexpr, unsigned, CompactionThreads, 1)                            \
+                                                                          \
+  /* Number of threads used to scan the old generation's dirty cards */   \
+  /* for pointers into the young generation in young-gen collections. */  \
+  F(constexpr, unsigned, CardScanThreads, 1)                              \
+                                                                          \
+  /* If non-zero, the old generation is marked incrementally, after */    \
+  /* young-gen collections, spending at most this many milliseconds */    \
+  /* per increment.  0 means full collections mark the whole heap. */     \
+  F(constexpr, unsigned, IncrementalMarkBudgetMs, 0)                      \
+                                                                          \
+  /* Whether object and array literals from allocation sites whose */     \
+  /* objects have been seen to survive young-gen collections are */       \
+  /* allocated directly in the old generation. */                         \
+  F(constexpr, bool, Pretenuring, false)                                  \
+                                                                          \
+  /* If non-zero, the young generation is sized adaptively: it shrinks */ \
+  /* when a young-gen pause exceeds this many milliseconds, and grows */  \
+  /* when few objects survive and young-gen collections take up a */      \
+  /* large share of the time.  0 keeps it a fixed fraction of the */      \
+  /* heap. */                                                             \
+  F(constexpr, unsigned, YoungGenPauseTargetMs, 0)                        \
+                                                                          \
+  /* Whether native memory released by the finalizers of dead cells */    \
+  /* (e.g. ArrayBuffer storage) is freed on a background thread after */  \
+  /* the collection, rather than during the pause. */                     \
+  F(constexpr, bool, BackgroundFinalization, false)                       \
+                                                                          \
+  /* Whether variable-sized cells of at least a sixteenth of a segment */ \
+  /* (e.g. the storage of large arrays) are allocated in segments of */   \
+  /* their own, which are never copied by the GC. */                      \
+  F(constexpr, bool, LargeObjectSpace, false)                             \
+                                                                          \
+  /* Whether the heap segments are backed by huge pages.  Ignored by */   \
+  /* storage providers that do not map segments themselves. */            \
+  F(constexpr, HugePagesMode, HugePages, kHugePagesNone)                  \
+                                                                          \
+  /* Whether the storage of the heap segments is recycled through a */    \
+  /* pool shared by the runtimes of the process, rather than mapped */    \
+  /* afresh by each runtime.  See StorageProvider::pooledProvider. */     \
+  F(constexpr, bool, PooledStorage, false)                                \
+                                                                          \
+  /* Called after every collection with a record of its phase times, */   \
+  /* for telemetry.  It must not allocate in, or otherwise access, the */ \
+  /* JS heap. */                                                          \
+  F(HERMES_NON_CONSTEXPR,                                                 \
+    std::function<void(const GCCollectionEvent &)>,                       \
+    CollectionEventCallback,                                              \
+    nullptr)                                                              \
+                                                                          \
   /* Pointer to the memory profiler (Memory Event Tracker). */            \
   F(HERMES_NON_CONSTEXPR,                                                 \
     std::shared_ptr<MemoryEventTracker>,                                  \
@@ -143,6 +214,12 @@ _HERMES_CTORCONFIG_STRUCT(GCConfig, GC_FIELDS, {
 
   // Make sure the max is at least the Init.
   MaxHeapSize_ = std::max(InitHeapSize_, MaxHeapSize_);
+
+  // Marking, compaction and card scanning always use at least the collecting
+  // thread.
+  MarkingThreads_ = std::max(MarkingThreads_, 1u);
+  CompactionThreads_ = std::max(CompactionThreads_, 1u);
+  CardScanThreads_ = std::max(CardScanThreads_, 1u);
 });
 
 #undef GC_FIELDS
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_PUBLIC_MEMORYPRESSURE_H
+#define HERMES_PUBLIC_MEMORYPRESSURE_H
+
+namespace hermes {
+namespace vm {
+
+/// How urgently the embedder wants the runtime to give memory back to the
+/// system.
+enum class MemoryPressureLevel {
+  /// Collect garbage and drop memory that is cheap to get back, such as
+  /// cached segments, but keep the heap sized for the current live data.
+  Moderate,
+  /// Additionally shrink the heap to fit the live data, and return every
+  /// unused page of it to the OS.  The next allocations are likely to be
+  /// slower, as the heap grows back.
+  Critical,
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_PUBLIC_MEMORYPRESSURE_H
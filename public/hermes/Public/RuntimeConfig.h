@@ -13,10 +13,10 @@
 #include "hermes/Public/GCConfig.h"
 
 #include <memory>
-
-#ifdef HERMESVM_SERIALIZE
+#include <string>
 #include <vector>
 
+#ifdef HERMESVM_SERIALIZE
 namespace llvm {
 class MemoryBuffer;
 class raw_ostream;
@@ -47,12 +47,75 @@ class Deserializer;
   /* Whether or not the JIT is enabled */                              \
   F(constexpr, bool, EnableJIT, false)                                 \
                                                                        \
+  /* Number of interpreted calls after which a function is JIT'ed */   \
+  F(constexpr, unsigned, JITCallThreshold, 10)                         \
+                                                                       \
+  /* Number of interpreted loop iterations after which a function is   \
+     JIT'ed and the running loop continues in native code */           \
+  F(constexpr, unsigned, JITLoopThreshold, 1000)                       \
+                                                                       \
+  /* Whether hot functions are JIT'ed on a background thread */        \
+  F(constexpr, bool, JITBackgroundCompilation, false)                  \
+                                                                       \
+  /* Directory where the functions JIT'ed for each bytecode file are   \
+     remembered, to compile them right away in the next launch. Empty  \
+     disables it. */                                                   \
+  F(HERMES_NON_CONSTEXPR, std::string, JITProfileCacheDir, "")         \
+                                                                       \
+  /* Directory where the functions compiled lazily from source are     \
+     kept, to load them instead of compiling them again in the next    \
+     launch. Empty disables it. */                                     \
+  F(HERMES_NON_CONSTEXPR, std::string, LazyCacheDir, "")               \
+                                                                       \
+  /* Bytes of executable memory the JIT'ed code may use before the     \
+     code of the least recently used functions is freed. 0 means no    \
+     limit. */                                                         \
+  F(constexpr, unsigned, JITCodeBudget, 0)                             \
+                                                                       \
+  /* Whether the JIT'ed code is described to the Linux perf tool, in   \
+     /tmp/perf-<pid>.map and /tmp/jit-<pid>.dump */                    \
+  F(constexpr, bool, JITPerfMap, false)                                \
+                                                                       \
+  /* Whether lazy functions are compiled on a background thread once   \
+     a closure is created for them, ahead of their first call */       \
+  F(constexpr, bool, LazyPrecompilation, false)                        \
+                                                                       \
+  /* The number of compiled regexps cached by their pattern and        \
+     flags, for RegExps constructed from strings. 0 disables it. */    \
+  F(constexpr, unsigned, RegExpCacheSize, 64)                          \
+                                                                       \
+  /* With the JS library implementation, the builtins keeping their    \
+     native implementation rather than the JS one, by their path from  \
+     the global object, like "Array.prototype.map", or                 \
+     "RegExp.prototype.@@replace" for a well-known symbol. */          \
+  F(HERMES_NON_CONSTEXPR,                                              \
+    std::vector<std::string>,                                          \
+    NativeLibraryFunctions,                                            \
+    std::vector<std::string>())                                        \
+                                                                       \
   /* Whether to allow eval and Function ctor */                        \
   F(constexpr, bool, EnableEval, true)                                 \
                                                                        \
   /* Whether to verify the IR generated by eval and Function ctor */   \
   F(constexpr, bool, VerifyEvalIR, false)                              \
                                                                        \
+  /* The number of sources compiled by eval and Function ctor whose    \
+     bytecode is cached to be run again. 0 disables it. */             \
+  F(constexpr, unsigned, EvalCacheSize, 32)                            \
+                                                                       \
+  /* The largest number of frames recorded in the stack trace of an     \
+     Error. 0 means no limit. */                                       \
+  F(constexpr, unsigned, MaxStackTraceDepth, 0)                        \
+                                                                       \
+  /* Whether destroying the runtime only runs the finalizers which are \
+     observable outside of it, like those of HostObjects and external  \
+     strings, or which free at least 64 KiB. The small blocks of       \
+     native memory the others would free are leaked, and counted by    \
+     HermesRuntime::getFastTeardownLeakedBytes(): a process which      \
+     creates many runtimes should check it and be restarted, or turn   \
+     this off, once the total grows too large. */                      \
+  F(constexpr, bool, FastTeardown, false)                              \
+                                                                       \
   /* Support for ES6 Symbol. */                                        \
   F(constexpr, bool, ES6Symbol, true)                                  \
                                                                        \
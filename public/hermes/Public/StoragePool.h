@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_PUBLIC_STORAGEPOOL_H
+#define HERMES_PUBLIC_STORAGEPOOL_H
+
+namespace hermes {
+namespace vm {
+
+/// What the process-wide pool of segment storages does with the contents of a
+/// storage released by one runtime, before another runtime reuses it.
+enum class StoragePoolZeroing {
+  /// Reuse the storage as it was left.  This is the fastest, as the pages stay
+  /// resident, but leaves the heap contents of a runtime in memory until the
+  /// storage is overwritten by the next one.
+  None,
+  /// Zero the storage when it is released.  The pages stay resident, but every
+  /// page of the storage is touched, including those the runtime never used.
+  Eager,
+  /// Return the pages of the storage to the OS when it is released.  Linux
+  /// zero-fills them again on demand.  Only the cost of mapping the storage is
+  /// saved.
+  Release,
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_PUBLIC_STORAGEPOOL_H
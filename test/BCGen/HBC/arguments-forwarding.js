@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -fstatic-builtins -target=HBC -dump-bytecode %s | %FileCheck %s
+// RUN: %hermesc -O -target=HBC -dump-bytecode %s | %FileCheck --check-prefix=CHKNOSB %s
+
+// Calls that only pass `arguments` along don't reify it.
+
+function viaApply(f) {
+  return f.apply(this, arguments);
+}
+// CHECK-LABEL: Function<viaApply>
+// CHECK-NOT: ReifyArguments
+// CHECK: CallBuiltin {{.*}}"HermesBuiltin.applyArguments", 4
+// CHECK-NOT: ReifyArguments
+// CHECK: Ret
+// CHKNOSB-LABEL: Function<viaApply>
+// CHKNOSB-NOT: ReifyArguments
+// CHKNOSB: CallBuiltin {{.*}}"HermesBuiltin.applyArguments", 4
+// CHKNOSB-NOT: ReifyArguments
+// CHKNOSB: Ret
+
+function viaSlice() {
+  return Array.prototype.slice.call(arguments, 1);
+}
+// CHECK-LABEL: Function<viaSlice>
+// CHECK-NOT: ReifyArguments
+// CHECK: CallBuiltin {{.*}}"HermesBuiltin.copyRestArgs", 2
+// CHECK-NOT: ReifyArguments
+// CHECK: Ret
+// CHKNOSB-LABEL: Function<viaSlice>
+// CHKNOSB: ReifyArguments
+
+function viaSpread(f) {
+  return f(...arguments);
+}
+// CHECK-LABEL: Function<viaSpread>
+// CHECK-NOT: ReifyArguments
+// CHECK: CallBuiltin {{.*}}"HermesBuiltin.applyArguments", 3
+// CHECK-NOT: ReifyArguments
+// CHECK: Ret
+// CHKNOSB-LABEL: Function<viaSpread>
+// CHKNOSB: ReifyArguments
+
+// The arguments object escapes, so it must be created.
+function escapes(f) {
+  f.apply(this, arguments);
+  return arguments;
+}
+// CHECK-LABEL: Function<escapes>
+// CHECK: ReifyArguments
@@ -29,9 +29,9 @@ try {
 //CHECK-NEXT:    LoadConstFalse    r1
 //CHECK-NEXT:    GetGlobalObject   r2
 //CHECK-NEXT:    PutById           r2, r1, 1, "condition"
-//CHECK-NEXT:L8:
-//CHECK-NEXT:    ProfilePoint      7
 //CHECK-NEXT:L6:
+//CHECK-NEXT:    ProfilePoint      7
+//CHECK-NEXT:L7:
 //CHECK-NEXT:    ProfilePoint      5
 //CHECK-NEXT:    TryGetById        r1, r2, 1, "print"
 //CHECK-NEXT:    GetByIdShort      r6, r2, 2, "condition"
@@ -41,7 +41,7 @@ try {
 //CHECK-NEXT:L1:
 //CHECK-NEXT:    ProfilePoint      3
 //CHECK-NEXT:    Call2             r0, r1, r3, r4
-//CHECK-NEXT:L7:
+//CHECK-NEXT:L8:
 //CHECK-NEXT:    ProfilePoint      2
 //CHECK-NEXT:    TryGetById        r4, r2, 1, "print"
 //CHECK-NEXT:    LoadConstString   r1, "rethrowing"
@@ -67,6 +67,7 @@ try {
 //CHECK-NEXT:    Ret               r0
 
 //CHECK-LABEL:Exception Handlers:
-//CHECK-NEXT:0: start = L6, end = L7, target = L2
-//CHECK-NEXT:1: start = L8, end = L9, target = L4
-//CHECK-NEXT:2: start = L2, end = L4, target = L4
+//CHECK-NEXT:0: start = L6, end = L7, target = L4
+//CHECK-NEXT:1: start = L7, end = L8, target = L2
+//CHECK-NEXT:2: start = L8, end = L9, target = L4
+//CHECK-NEXT:3: start = L2, end = L4, target = L4
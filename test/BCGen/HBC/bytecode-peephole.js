@@ -0,0 +1,31 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O0 -bytecode-peephole -dump-bytecode %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 -bytecode-peephole %s | %FileCheck --match-full-lines --check-prefix=CHKRUN %s
+
+// Without optimizations, the branches on constants survive until ISel, which
+// only keeps the jump to the side they always take.
+
+function constBranch(x) {
+  if (true) {
+    x = x + 1;
+  } else {
+    x = x - 1;
+  }
+  while (0) {
+    x = x * 2;
+  }
+  return x;
+}
+// CHECK-LABEL: Function<constBranch>({{.*}}):
+// CHECK-NOT:     JmpTrue{{.*}}
+// CHECK-NOT:     JmpFalse{{.*}}
+// CHECK:         Ret {{.*}}
+
+print(constBranch(1));
+// CHKRUN: 2
@@ -0,0 +1,28 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -compact-registers -dump-bytecode %s | %FileCheck --match-full-lines %s
+// RUN: %hermesc -O -compact-registers -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines --check-prefix=CHKRUN %s
+
+// The values passed to the calls are written directly into the argument
+// registers, and compaction drops the registers they used to live in, while
+// the argument registers move down with them.
+
+function add3(a, b, c) {
+  return a + b + c;
+}
+
+function calls(x, y) {
+  var s = add3(x * 2, y * 3, x + y);
+  s = add3(s, x - y, y - x) + add3(s * s, 1, x);
+  return add3(s, x, s);
+}
+// CHECK-LABEL: Function<calls>(3 params, {{[0-9]+}} registers, 0 symbols):
+// CHECK: {{.*}}Call{{.*}}
+
+print(calls(3, 4));
+// CHKRUN: 1311
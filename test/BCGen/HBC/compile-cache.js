@@ -0,0 +1,31 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: rm -rf %t.cache
+RUN: %hermesc -O -emit-binary -compile-cache=%t.cache -out %t.1.hbc %s
+RUN: %hermes %t.1.hbc | %FileCheck --match-full-lines %s
+RUN: ls %t.cache | %FileCheck --match-full-lines --check-prefix=CACHE %s
+RUN: %hermesc -O -emit-binary -compile-cache=%t.cache -out %t.2.hbc %s
+RUN: cmp %t.1.hbc %t.2.hbc
+RUN: for f in %t.cache/*.hbc; do echo stale > $f; done
+RUN: %hermesc -O -emit-binary -compile-cache=%t.cache -out %t.3.hbc %s
+RUN: %FileCheck --check-prefix=HIT %s < %t.3.hbc
+RUN: %hermesc -O0 -emit-binary -compile-cache=%t.cache -out %t.4.hbc %s
+RUN: %hermes %t.4.hbc | %FileCheck --match-full-lines %s
+RUN: test $(ls %t.cache | wc -l) -eq 2
+*/
+
+// The second compilation with the same flags is a copy of the cache entry,
+// wherever its output goes, while different flags make a new entry.
+
+print("compiled");
+// CHECK: compiled
+
+// CACHE: {{[0-9a-f]{40}}}.hbc
+
+// HIT: stale
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-bytecode %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines --check-prefix=CHKRUN %s
+
+// Calls of the DataView get and set methods read or write the buffer inline
+// when the method is the original one, and call it otherwise.
+
+function get(view, i) {
+  return [
+    view.getInt8(i),
+    view.getUint8(i),
+    view.getInt16(i),
+    view.getUint16(i, true),
+    view.getInt32(i, false),
+    view.getUint32(i, true),
+  ].join(' ');
+}
+// CHECK-LABEL: Function<get>({{.*}}):
+// CHECK-NOT:     Call{{[0-9]}} {{.*}}
+// CHECK:         DataViewGet {{.*}}
+
+function getFloat(view, i, le) {
+  return view.getFloat32(i, le) + ' ' + view.getFloat64(i, le);
+}
+// CHECK-LABEL: Function<getFloat>({{.*}}):
+// CHECK-NOT:     Call{{[0-9]}} {{.*}}
+// CHECK:         DataViewGet {{.*}}
+
+function set(view, i, v, le) {
+  view.setInt8(i, v);
+  view.setUint16(i + 1, v, le);
+  view.setInt32(i + 3, v, le);
+  view.setFloat32(i + 7, v);
+  view.setFloat64(i + 11, v, le);
+}
+// CHECK-LABEL: Function<set>({{.*}}):
+// CHECK-NOT:     Call{{[0-9]}} {{.*}}
+// CHECK:         DataViewSet {{.*}}
+
+// The result of a set is only returned by a call.
+function setResult(view, i, v) {
+  return view.setUint8(i, v);
+}
+// CHECK-LABEL: Function<setResult>({{.*}}):
+// CHECK-NOT:     DataViewSet {{.*}}
+// CHECK:         Call3 {{.*}}
+
+// So are the calls of other methods.
+function other(view) {
+  return view.getBigInt64(0);
+}
+// CHECK-LABEL: Function<other>({{.*}}):
+// CHECK-NOT:     DataViewGet {{.*}}
+// CHECK:         Call2 {{.*}}
+
+var view = new DataView(new ArrayBuffer(20));
+for (var i = 0; i < 20; ++i)
+  view.setUint8(i, i * 13);
+print(get(view, 0), '/', get(view, 5));
+// CHKRUN: 0 0 13 3328 858663 656018688 / 65 65 16718 20033 1095654248 1750814273
+
+set(view, 0, -2, true);
+print(get(view, 0), '/', get(view, 7), '/', getFloat(view, 11, true));
+// CHKRUN-NEXT: -2 254 -258 65278 -16842754 4278189822 / -64 192 -16384 192 -1073741824 192 / 0 -2
+set(view, 0, 1.5, false);
+print(getFloat(view, 7, false), getFloat(view, 11, false));
+// CHKRUN-NEXT: 1.5 0.12500002978777047 1.9375 1.5
+print(getFloat(view, 0.5, true), get(view, '2'));
+// CHKRUN-NEXT: 9.183689745645554e-41 0.000032424926758256596 1 1 256 1 16777216 1
+
+// Offsets past the end throw.
+try {
+  get(view, 17);
+} catch (e) {
+  print(e.name);
+}
+// CHKRUN-NEXT: RangeError
+try {
+  set(view, 10, 1, true);
+} catch (e) {
+  print(e.name);
+}
+// CHKRUN-NEXT: RangeError
+
+// Values are converted by the method.
+set(view, 0, {valueOf: () => 3}, true);
+print(view.getInt8(0), setResult(view, 1, '7'), view.getUint8(1));
+// CHKRUN-NEXT: 3 undefined 7
+
+// Replaced methods and other receivers are called.
+var getInt8 = DataView.prototype.getInt8;
+DataView.prototype.getInt8 = function(i) {
+  return 'int8 at ' + i;
+};
+print(get(view, 0).split(' ').slice(0, 3).join(' '));
+// CHKRUN-NEXT: int8 at 0
+DataView.prototype.getInt8 = getInt8;
+var fake = {
+  getInt8: i => 'a' + i,
+  getUint8: i => 'b' + i,
+  getInt16: i => 'c',
+  getUint16: (i, le) => le,
+  getInt32: (i, le) => le,
+  getUint32: () => 'd',
+};
+print(get(fake, 1));
+// CHKRUN-NEXT: a1 b1 c true false d
+try {
+  get({}, 0);
+} catch (e) {
+  print(e.name);
+}
+// CHKRUN-NEXT: TypeError
@@ -49,7 +49,7 @@ function *loop(x) {
 // CHECK-NEXT:     AddN              r11, r10, r4
 // CHECK-NEXT:     StoreToEnvironment r0, 0, r11
 // CHECK-NEXT:     GetByVal          r12, r7, r10
-// CHECK-NEXT:     SaveGenerator     L3
+// CHECK-NEXT:     SaveGenerator     L3, 7
 // CHECK-NEXT:     Ret               r12
 // CHECK-NEXT: L3:
 // CHECK-NEXT:     ResumeGenerator   r7, r13
@@ -87,7 +87,7 @@ function *args() {
 // CHECK-NEXT:     JmpTrue           L1, r4
 // CHECK-NEXT:     Mov               r2, r0
 // CHECK-NEXT:     GetArgumentsPropByVal r4, r1, r2
-// CHECK-NEXT:     SaveGenerator     L2
+// CHECK-NEXT:     SaveGenerator     L2, 1
 // CHECK-NEXT:     Ret               r4
 // CHECK-NEXT: L2:
 // CHECK-NEXT:     ResumeGenerator   r2, r5
@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -fflatten-environments -dump-bytecode %s | %FileCheck --match-full-lines --check-prefix=BC %s
+// RUN: %hermes -O -fflatten-environments %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// middle has no captured variables, so it doesn't create an environment and
+// inner reaches count in the environment of outer directly. inner accesses it
+// on both sides of a branch, so the environment is resolved once, on entry.
+
+function outer() {
+  var count = 0;
+  function middle() {
+    function inner(flag) {
+      if (flag) {
+        count += 1;
+      } else {
+        count += 2;
+      }
+      return count;
+    }
+    return inner;
+  }
+  return middle;
+}
+
+var inner = outer()();
+print(inner(true), inner(false), inner(true));
+// CHECK: 1 3 4
+
+// BC-LABEL: Function<outer>{{.*}}
+// BC:         CreateEnvironment {{.*}}
+
+// BC-LABEL: Function<middle>{{.*}}
+// BC-NOT:     CreateEnvironment {{.*}}
+// BC:         GetEnvironment {{.*}}, 0
+// BC-NOT:     CreateEnvironment {{.*}}
+// BC:         CreateClosure {{.*}}
+
+// BC-LABEL: Function<inner>{{.*}}
+// BC:         GetEnvironment {{.*}}, 0
+// BC-NOT:     GetEnvironment {{.*}}
+// BC:         Ret {{.*}}
@@ -0,0 +1,47 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -bytecode-peephole -dump-bytecode %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -bytecode-peephole %s | %FileCheck --match-full-lines --check-prefix=CHKRUN %s
+
+// A GetEnvironment is fused with the load or store from the environment it
+// fetched that follows it.
+
+function counter() {
+  var count = 0;
+  var last;
+  return {
+    next: function() {
+      return ++count;
+    },
+    get: function() {
+      return count;
+    },
+    remember: function(v) {
+      last = v;
+    },
+    recall: function() {
+      return last;
+    },
+  };
+}
+// CHECK-LABEL: Function<get>({{.*}}):
+// CHECK-NEXT: Offset in debug table: {{.*}}
+// CHECK-NEXT:     GetEnvironmentAndLoad r{{[0-9]+}}, r{{[0-9]+}}, 0, 0
+// CHECK-NEXT:     Ret               r{{[0-9]+}}
+
+// CHECK-LABEL: Function<remember>({{.*}}):
+// CHECK:          GetEnvironmentAndStore r{{[0-9]+}}, 0, 1, r{{[0-9]+}}
+
+var c = counter();
+c.next();
+c.next();
+print(c.get());
+// CHKRUN: 2
+c.remember('x');
+print(c.recall());
+// CHKRUN-NEXT: x
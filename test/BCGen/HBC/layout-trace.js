@@ -0,0 +1,29 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -emit-binary -out %t.traced.hbc %s
+// RUN: %hermesc -O -emit-binary -layout-trace=%s.trace -layout-trace-bytecode=%t.traced.hbc -out %t.hbc %s
+// RUN: (! cmp -s %t.traced.hbc %t.hbc)
+// RUN: %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// The trace touches the pages of the traced bytecode backwards, so the
+// function bodies are laid out in reverse.
+
+function first(x) {
+  return x + 1;
+}
+
+function second(x) {
+  return first(x) * 2;
+}
+
+function third(x) {
+  return second(x) - 3;
+}
+
+print(first(1), second(2), third(3));
+//CHECK: 2 6 5
@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -literal-slots -dump-bytecode %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -literal-slots %s | %FileCheck --match-full-lines --check-prefix=CHKRUN %s
+
+// Loads from an object literal read the slot of the property in the literal,
+// as long as the object still has the class of the literal.
+
+function sum(g) {
+  var o = {a: 1, b: 2, c: 3};
+  g(o);
+  return o.b + o.c;
+}
+// CHECK-LABEL: Function<sum>({{.*}}):
+// CHECK:         NewObjectWithBuffer {{.*}}
+// CHECK:         GetByIdSlot {{.*}}, 1, "b"
+// CHECK-NEXT:    GetByIdSlot {{.*}}, 2, "c"
+
+print(sum(function(o) {}));
+// CHKRUN: 5
+print(sum(function(o) { o.b = 10; }));
+// CHKRUN-NEXT: 13
+print(sum(function(o) { delete o.a; }));
+// CHKRUN-NEXT: 5
+print(sum(function(o) { o.d = 4; }));
+// CHKRUN-NEXT: 5
+print(sum(function(o) {
+  Object.defineProperty(o, 'c', {get: function() { return 30; }});
+}));
+// CHKRUN-NEXT: 32
+print(sum(function(o) {}));
+// CHKRUN-NEXT: 5
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -fstatic-builtins -dump-bytecode %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -fstatic-builtins %s | %FileCheck --match-full-lines --check-prefix=CHKRUN %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines --check-prefix=CHKRUN %s
+
+// With static builtins, calls to some Math methods passing exactly the
+// arguments they read are computed inline instead of calling the builtin.
+
+function abs(x) {
+  return Math.abs(x);
+}
+// CHECK-LABEL: Function<abs>({{.*}}):
+// CHECK-NOT:     CallBuiltin {{.*}}
+// CHECK:         MathAbs {{.*}}
+
+function floorCeil(x) {
+  return Math.floor(x) + Math.ceil(x);
+}
+// CHECK-LABEL: Function<floorCeil>({{.*}}):
+// CHECK-NOT:     CallBuiltin {{.*}}
+// CHECK:         MathFloor {{.*}}
+// CHECK-NEXT:    MathCeil {{.*}}
+
+function sqrt(x) {
+  return Math.sqrt(x);
+}
+// CHECK-LABEL: Function<sqrt>({{.*}}):
+// CHECK-NOT:     CallBuiltin {{.*}}
+// CHECK:         MathSqrt {{.*}}
+
+function min(x, y) {
+  return Math.min(x, y);
+}
+// CHECK-LABEL: Function<min>({{.*}}):
+// CHECK-NOT:     CallBuiltin {{.*}}
+// CHECK:         MathMin {{.*}}
+
+function max(x, y) {
+  return Math.max(x, y);
+}
+// CHECK-LABEL: Function<max>({{.*}}):
+// CHECK-NOT:     CallBuiltin {{.*}}
+// CHECK:         MathMax {{.*}}
+
+// Other argument counts still call the builtin.
+function max3(x, y, z) {
+  return Math.max(x, y, z);
+}
+// CHECK-LABEL: Function<max3>({{.*}}):
+// CHECK:         CallBuiltin {{.*}}, "Math.max", 4
+
+function absNone() {
+  return Math.abs();
+}
+// CHECK-LABEL: Function<absNone>({{.*}}):
+// CHECK:         CallBuiltin {{.*}}, "Math.abs", 1
+
+function valueOf(name, value) {
+  return {
+    valueOf: function() {
+      print(name);
+      return value;
+    },
+  };
+}
+
+print(abs(-3), abs(2.5), 1 / abs(-0), abs('-7'), abs(undefined));
+// CHKRUN: 3 2.5 Infinity 7 NaN
+print(floorCeil(1.5), floorCeil(-1.5), floorCeil(2), floorCeil('x'));
+// CHKRUN-NEXT: 3 -3 4 NaN
+print(1 / Math.ceil(-0.5), 1 / Math.floor(-0), Math.floor(-Infinity));
+// CHKRUN-NEXT: -Infinity -Infinity -Infinity
+print(sqrt(16), sqrt(-1), sqrt(Infinity), 1 / sqrt(-0));
+// CHKRUN-NEXT: 4 NaN Infinity -Infinity
+print(min(1, 2), min(2, 1), min(NaN, 1), min(1, NaN), min('3', 4));
+// CHKRUN-NEXT: 1 1 NaN NaN 3
+print(max(1, 2), max(2, 1), max(NaN, 1), max(1, NaN), max(-Infinity, null));
+// CHKRUN-NEXT: 2 2 NaN NaN 0
+print(1 / min(0, -0), 1 / min(-0, 0), 1 / max(0, -0), 1 / max(-0, 0));
+// CHKRUN-NEXT: -Infinity -Infinity Infinity Infinity
+print(max3(1, 3, 2), absNone());
+// CHKRUN-NEXT: 3 NaN
+
+// Both operands are converted, in order, even when the first is NaN.
+print(min(valueOf('a', NaN), valueOf('b', 1)));
+// CHKRUN-NEXT: a
+// CHKRUN-NEXT: b
+// CHKRUN-NEXT: NaN
+print(max(valueOf('c', 5), valueOf('d', 6)));
+// CHKRUN-NEXT: c
+// CHKRUN-NEXT: d
+// CHKRUN-NEXT: 6
+try {
+  floorCeil({
+    valueOf: function() {
+      throw new Error('thrown by valueOf');
+    },
+  });
+} catch (e) {
+  print(e.message);
+}
+// CHKRUN-NEXT: thrown by valueOf
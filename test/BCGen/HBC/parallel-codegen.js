@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -emit-binary -out %t.1.hbc %s
+// RUN: %hermesc -O -emit-binary -j 4 -out %t.4.hbc %s && cmp %t.1.hbc %t.4.hbc
+// RUN: diff <(%hermesc -dump-bytecode %s) <(%hermesc -dump-bytecode -j 3 %s)
+// RUN: %hermesc -O -emit-binary -j 4 -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// Generating code on several threads gives the same bytecode.
+
+function sum(n) {
+  var s = 0;
+  for (var i = 0; i < n; ++i)
+    s += i;
+  return s;
+}
+
+function pick(x) {
+  var r = x ? "yes" : 10;
+  return r;
+}
+
+function swap(a, b, n) {
+  while (n--) {
+    var t = a;
+    a = b;
+    b = t;
+  }
+  return [a, b];
+}
+
+function outer() {
+  var count = 0;
+  return {
+    inc: function() { return ++count; },
+    get: function() { return count; },
+  };
+}
+
+var c = outer();
+c.inc();
+c.inc();
+print(sum(10), pick(true), pick(false), swap(1, 2, 3), c.get());
+//CHECK: 45 yes 10 2,1 2
@@ -0,0 +1,34 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -emit-binary -out %t.traced.hbc %s
+// RUN: %hermesc -O -emit-binary -prefetch-trace=%s.trace -layout-trace-bytecode=%t.traced.hbc -out %t.hbc %s
+// RUN: %hermes %t.hbc | %FileCheck --match-full-lines %s
+// RUN: %hermes -b %t.hbc -dump-bytecode | %FileCheck --match-full-lines %s --check-prefix=TABLE
+// RUN: %hermes -b %t.traced.hbc -dump-bytecode | %FileCheck --match-full-lines %s --check-prefix=NOTABLE
+
+// The trace touches every page of the traced bytecode in order, so the
+// prefetch table starts with everything before the function bodies.
+
+function first(x) {
+  return x + 1;
+}
+
+function second(x) {
+  return first(x) * 2;
+}
+
+print(first(1), second(2));
+//CHECK: 2 6
+
+// TABLE: Prefetch range count: {{[1-9][0-9]*}}
+// TABLE: Prefetch Table:
+// TABLE-NEXT:   [0, {{[0-9]+}})
+// TABLE-NEXT:   [{{[0-9]+}}, {{[0-9]+}})
+
+// NOTABLE: Prefetch range count: 0
+// NOTABLE-NOT: Prefetch Table:
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-bytecode %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines --check-prefix=CHKRUN %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines --check-prefix=CHKRUN %s
+
+// Template literals and chains of string additions build their result with a
+// single StringConcat instead of one string per part.
+
+function template(name, count) {
+  return `Hello ${name}, you have ${count} messages`;
+}
+// CHECK-LABEL: Function<template>({{.*}}):
+// CHECK-NOT:     Call{{.*}}
+// CHECK:         StringConcat {{.*}}, 5
+
+function chain(a, b) {
+  return 'x=' + a + ', y=' + b + '!';
+}
+// CHECK-LABEL: Function<chain>({{.*}}):
+// CHECK-NOT:     Add {{.*}}
+// CHECK:         AddEmptyString {{.*}}
+// CHECK:         AddEmptyString {{.*}}
+// CHECK:         StringConcat {{.*}}, 5
+
+// The operands are still converted where they were added.
+function order(a, f) {
+  return 'a' + a + f() + '!';
+}
+// CHECK-LABEL: Function<order>({{.*}}):
+// CHECK:         AddEmptyString {{.*}}
+// CHECK:         Call{{.*}}
+// CHECK:         AddEmptyString {{.*}}
+// CHECK:         StringConcat {{.*}}, 4
+
+var log = [];
+function obj(name, value) {
+  return {
+    valueOf: function() {
+      log.push('valueOf ' + name);
+      return value;
+    },
+    toString: function() {
+      log.push('toString ' + name);
+      return '<' + name + '>';
+    },
+  };
+}
+
+print(template('Ann', 3));
+// CHKRUN: Hello Ann, you have 3 messages
+print(chain(1, true), chain(null, undefined));
+// CHKRUN-NEXT: x=1, y=true! x=null, y=undefined!
+print(chain('é', '😀'), template('世', ''));
+// CHKRUN-NEXT: x=é, y=😀! Hello 世, you have  messages
+
+// Additions convert with valueOf, template literals with toString, each in
+// order.
+print(chain(obj('a', 1), obj('b', 2)), log.join());
+// CHKRUN-NEXT: x=1, y=2! valueOf a,valueOf b
+log = [];
+print(template(obj('n', 1), obj('c', 2)), log.join());
+// CHKRUN-NEXT: Hello <n>, you have <c> messages toString n,toString c
+log = [];
+var result = order(obj('a', 1), function() {
+  log.push('call');
+  return 'c';
+});
+print(result, log.join());
+// CHKRUN-NEXT: a1c! valueOf a,call
+
+try {
+  chain('s', Symbol());
+} catch (e) {
+  print(e.constructor.name);
+}
+// CHKRUN-NEXT: TypeError
+try {
+  template({
+    toString: function() {
+      throw new Error('thrown by toString');
+    },
+  });
+} catch (e) {
+  print(e.message);
+}
+// CHKRUN-NEXT: thrown by toString
@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-bytecode %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines --check-prefix=CHKRUN %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines --check-prefix=CHKRUN %s
+
+// Switches on many strings, or on sparse integers, dispatch through a hashed
+// jump table instead of a chain of comparisons.
+
+function reducer(type) {
+  switch (type) {
+    case 'ADD_TODO':
+      return 1;
+    case 'REMOVE_TODO':
+      return 2;
+    case 'TOGGLE_TODO':
+      return 3;
+    case 'EDIT_TODO':
+      return 4;
+    case 'CLEAR_COMPLETED':
+      return 5;
+    case 'SET_FILTER':
+      return 6;
+    case 'FETCH_START':
+      return 7;
+    case 'FETCH_SUCCESS':
+      return 8;
+    case 'FETCH_FAILURE':
+      return 9;
+    case 'RESET':
+      return 10;
+    case 'ÉTÉ':
+      return 11;
+  }
+  return 0;
+}
+// CHECK-LABEL: Function<reducer>({{.*}}):
+// CHECK-NOT:     JStrictEqual{{.*}}
+// CHECK:         SwitchStr {{.*}}, 32
+
+function sparse(x) {
+  switch (x) {
+    case 0:
+      return 'zero';
+    case 7:
+      return 'seven';
+    case 100:
+      return 'hundred';
+    case 1000:
+      return 'thousand';
+    case -5:
+      return 'minus five';
+    case 65536:
+      return '2^16';
+    case 123456:
+      return 'digits';
+    case -100000:
+      return 'minus lots';
+    case 2147483647:
+      return 'int max';
+    case -2147483648:
+      return 'int min';
+  }
+  return 'none';
+}
+// CHECK-LABEL: Function<sparse>({{.*}}):
+// CHECK-NOT:     JStrictEqual{{.*}}
+// CHECK:         SwitchSparse {{.*}}, 128
+
+// Cases of different kinds keep the chain of comparisons.
+function mixed(x) {
+  switch (x) {
+    case 'a':
+      return 1;
+    case 'b':
+      return 2;
+    case 'c':
+      return 3;
+    case 'd':
+      return 4;
+    case 'e':
+      return 5;
+    case 'f':
+      return 6;
+    case 'g':
+      return 7;
+    case 'h':
+      return 8;
+    case 'i':
+      return 9;
+    case 10:
+      return 10;
+  }
+  return 0;
+}
+// CHECK-LABEL: Function<mixed>({{.*}}):
+// CHECK-NOT:     Switch{{.*}}
+// CHECK:         JStrictEqual{{.*}}
+
+print(
+  reducer('ADD_TODO'),
+  reducer('RESET'),
+  reducer(['FETCH_', 'SUCCESS'].join('')),
+  reducer('ÉTÉ'),
+  reducer('EDIT'),
+  reducer(''),
+  reducer(1),
+  reducer({toString: () => 'RESET'})
+);
+// CHKRUN: 1 10 8 11 0 0 0 0
+
+print(
+  sparse(0),
+  sparse(-0),
+  sparse(1000),
+  sparse(1000.5),
+  sparse(-5),
+  sparse(2147483647),
+  sparse(-2147483648),
+  sparse(2147483648),
+  sparse(NaN),
+  sparse('100'),
+  sparse(8)
+);
+// CHKRUN: zero zero thousand none minus five int max int min none none none none
+
+print(mixed('c'), mixed(10), mixed('10'));
+// CHKRUN: 3 10 0
@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -emit-binary -out %t.hbc %s
+// RUN: %hbcdump -validate %t.hbc | %FileCheck --match-full-lines %s
+// RUN: %hermesc -O -emit-binary -compress-bytecode -out %t.compressed.hbc %s
+// RUN: %hbcdump -validate %t.compressed.hbc | %FileCheck --match-full-lines %s
+// RUN: head -c 200 %t.hbc > %t.short.hbc
+// RUN: (! %hbcdump -validate %t.short.hbc 2>&1 ) | %FileCheck --match-full-lines %s --check-prefix=SHORT
+// RUN: (! %hermes %t.short.hbc 2>&1 ) | %FileCheck %s --check-prefix=LOAD
+
+// Strict validation walks every function; loading a truncated file is
+// rejected by the header checks alone.
+
+function pick(x) {
+  switch (x) {
+    case 0: return 'a';
+    case 1: return 'b';
+    case 2: return 'c';
+    case 3: return 'd';
+    default: return 'e';
+  }
+}
+
+function guarded(f) {
+  try {
+    return f();
+  } catch (e) {
+    return 'caught';
+  }
+}
+
+print(pick(1), guarded(function() { throw 1; }), 'a long string '.repeat(30));
+
+// CHECK: Bytecode is valid
+// SHORT: Error: invalid bytecode: Bytecode file header is out of bounds
+// LOAD: {{.*}}Bytecode file header is out of bounds{{.*}}
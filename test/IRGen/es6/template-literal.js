@@ -10,13 +10,10 @@
 function f1() {
   return `hello${1 + 1}world`;
 }
-//CHKIR-LABEL:function f1()
+//CHKIR-LABEL:function f1() : string
 //CHKIR-NEXT:frame = []
 //CHKIR-NEXT:%BB0:
-//CHKIR-NEXT:  %0 = TryLoadGlobalPropertyInst globalObject : object, "HermesInternal" : string
-//CHKIR-NEXT:  %1 = LoadPropertyInst %0, "concat" : string
-//CHKIR-NEXT:  %2 = CallInst %1, "hello" : string, 2 : number, "world" : string
-//CHKIR-NEXT:  %3 = ReturnInst %2
+//CHKIR-NEXT:  %0 = ReturnInst "hello2world" : string
 //CHKIR-NEXT:function_end
 
 function f2() {
@@ -55,3 +52,23 @@ function f5(x) {
 //CHKIR-NEXT:  %0 = AddEmptyStringInst %x
 //CHKIR-NEXT:  %1 = ReturnInst %0 : string
 //CHKIR-NEXT:function_end
+
+function f6(x, y) {
+  return `hello ${x} and ${y}`;
+}
+//CHKIR-LABEL:function f6(x, y) : string
+//CHKIR-NEXT:frame = []
+//CHKIR-NEXT:%BB0:
+//CHKIR-NEXT:  %0 = StringConcatInst undefined : undefined, "hello " : string, %x, " and " : string, %y
+//CHKIR-NEXT:  %1 = ReturnInst %0 : string
+//CHKIR-NEXT:function_end
+
+function f7(x) {
+  return `${x}!`;
+}
+//CHKIR-LABEL:function f7(x) : string
+//CHKIR-NEXT:frame = []
+//CHKIR-NEXT:%BB0:
+//CHKIR-NEXT:  %0 = StringConcatInst undefined : undefined, %x, "!" : string
+//CHKIR-NEXT:  %1 = ReturnInst %0 : string
+//CHKIR-NEXT:function_end
@@ -0,0 +1,22 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -commonjs -fstatic-require -fstatic-builtins -O -dump-bytecode %s %S/m3.js | %FileCheck --match-full-lines %s
+// RUN: %hermes -commonjs -fstatic-require -fstatic-builtins -O %s %S/m3.js | %FileCheck --match-full-lines --check-prefix=CHKRUN %s
+
+// Check that the types of the arguments flow into the exported functions.
+
+'use strict';
+
+var m3 = require('./m3.js');
+print(m3.add(1, 2), m3.scale(m3.add(3, 4)));
+
+// CHECK-LABEL: Function<add>({{.*}}):
+// CHECK-NOT:   Function<
+// CHECK:         AddN {{.*}}
+
+// CHKRUN: 3 14
@@ -0,0 +1,21 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: true
+
+'use strict';
+
+function add(a, b) {
+  return a + b;
+}
+
+function scale(x) {
+  return x * 2;
+}
+
+exports.add = add;
+exports.scale = scale;
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-ir %s | %FileCheck %s
+// RUN: %hermes -O -dump-lra %s | %FileCheck --check-prefix=CHKLRA %s
+// RUN: %hermes -O %s | %FileCheck --check-prefix=CHKRUN --match-full-lines %s
+
+// A closure created in a loop which is only called is created once, before
+// the loop.
+
+function sumCalls(n, k) {
+  var s = 0;
+  for (var i = 0; i < n; i++) {
+    var add = function(x) {
+      return x + k;
+    };
+    s += add(i) * add(1);
+  }
+  return s;
+}
+//CHECK-LABEL: function sumCalls(n, k)
+//CHECK: CreateFunctionInst %add()
+//CHECK: PhiInst
+//CHECK-NOT: CreateFunctionInst
+//CHECK: ReturnInst
+
+// Closures which escape, or which can get hold of themselves, are created in
+// every iteration.
+
+function collect(n) {
+  var fs = [];
+  for (var i = 0; i < n; i++) {
+    var f = function() {
+      return fs.length;
+    };
+    fs.push(f);
+  }
+  return fs;
+}
+//CHECK-LABEL: function collect(n)
+//CHECK: PhiInst
+//CHECK: CreateFunctionInst %f()
+//CHECK: ReturnInst
+
+function countCalls(n) {
+  var s = 0;
+  for (var i = 0; i < n; i++) {
+    var g = function() {
+      var self = arguments.callee;
+      self.calls = (self.calls | 0) + 1;
+      return self.calls;
+    };
+    s += g() + g();
+  }
+  return s;
+}
+//CHECK-LABEL: function countCalls(n)
+//CHECK: PhiInst
+//CHECK: CreateFunctionInst %g()
+//CHECK: ReturnInst
+
+// A closure which is only used on one path is created on that path.
+
+function callIf(c, k) {
+  var h = function(x) {
+    return x * k;
+  };
+  if (c)
+    return h(2) + h(3);
+  return 0;
+}
+//CHKLRA-LABEL: function callIf(c, k)
+//CHKLRA: CondBranchInst
+//CHKLRA: HBCCreateFunctionInst %h()
+//CHKLRA: ReturnInst
+
+var fs = collect(3);
+print(sumCalls(4, 1), fs.length, fs[0] === fs[1], fs[2]());
+//CHKRUN: 20 3 false 3
+print(countCalls(3), callIf(true, 5), callIf(false, 5));
+//CHKRUN-NEXT: 9 25 0
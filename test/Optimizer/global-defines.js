@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -dump-ir -O -D __DEV__=false -D process.env.NODE_ENV=production %s | %FileCheck --match-full-lines %s
+// RUN: %hermesc -dump-ir -O -D "process.env.NODE_ENV='development'" %s | %FileCheck --match-full-lines --check-prefix=CHKDEV %s
+
+function main() {
+  if (__DEV__) {
+    print(function dev() { return 'dev'; });
+  }
+  if (process.env.NODE_ENV !== 'production') {
+    print('not production');
+  }
+  return process.env;
+}
+
+function shadowed(__DEV__) {
+  return __DEV__;
+}
+
+//CHECK-LABEL:function main()
+//CHECK-NOT:{{.*}}print{{.*}}
+//CHECK:  {{.*}} TryLoadGlobalPropertyInst globalObject : object, "process" : string
+//CHECK-NEXT:  {{.*}} LoadPropertyInst {{.*}}, "env" : string
+//CHECK-NEXT:  {{.*}} ReturnInst {{.*}}
+//CHECK-NEXT:function_end
+
+//CHECK-LABEL:function shadowed(__DEV__)
+//CHECK-NEXT:frame = []
+//CHECK-NEXT:%BB0:
+//CHECK-NEXT:  %0 = ReturnInst %__DEV__
+//CHECK-NEXT:function_end
+
+//CHECK-NOT:function dev()
+
+//CHKDEV-LABEL:function main()
+//CHKDEV:  {{.*}} "not production" : string
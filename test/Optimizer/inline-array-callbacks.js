@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-ir %s | %FileCheck %s
+// RUN: %hermes -O %s | %FileCheck --check-prefix=CHKRUN --match-full-lines %s
+
+// Calls of the array methods with a function expression loop over the array
+// when the method is the original one, with the function inlined.
+
+function sum(arr) {
+  var s = 0;
+  arr.forEach(x => {
+    s += x;
+  });
+  return s;
+}
+//CHECK-LABEL: function sum(arr)
+//CHECK: CallBuiltinInst [HermesBuiltin.isArrayCallbackMethod]{{.*}}, %arr, %{{[0-9]+}}, 0 : number
+//CHECK-NEXT: CondBranchInst
+//CHECK: LoadPropertyInst %arr, "length" : string
+//CHECK: function_end
+
+// A function which is used elsewhere is still called by the method.
+
+function notInlined(arr) {
+  var f = x => x + 1;
+  return arr.map(f).concat(f(0));
+}
+//CHECK-LABEL: function notInlined(arr)
+//CHECK-NOT: isArrayCallbackMethod
+//CHECK: function_end
+
+function doubled(arr) {
+  return arr.map(x => x * 2);
+}
+
+function odd(arr) {
+  return arr.filter(x => x & 1);
+}
+
+function total(arr) {
+  return arr.reduce((a, x) => a + x, 10);
+}
+
+function types(arr) {
+  return arr.map(x => typeof x);
+}
+
+function plusK(arr, o) {
+  return arr.map(function(x) {
+    return this.k + x;
+  }, o);
+}
+
+print(sum([1, 2, 3]), sum([]), notInlined([1, 2]).join());
+//CHKRUN: 6 0 2,3,1
+
+var d = doubled([1, , 3]);
+print(d.length, d.join(), 1 in d);
+//CHKRUN: 3 2,,6 false
+print(odd([1, 2, 3, 4, 5]).join(), odd([, 2, , 3]).length, total([1, 2, 3]));
+//CHKRUN: 1,3,5 1 16
+print(types([undefined, 1, , 'a']).join(), plusK([1, 2], {k: 10}).join());
+//CHKRUN: undefined,number,,string 11,12
+
+// Holes are looked up in the prototype.
+Array.prototype[1] = 'p';
+print(types([0, , 2]).join());
+//CHKRUN: number,string,number
+delete Array.prototype[1];
+
+// The length is read once, before any element.
+var grown = [1, 2];
+grown.forEach(x => {
+  grown.push(x);
+});
+print(grown.join());
+//CHKRUN: 1,2,1,2
+
+// The methods of other objects are called.
+print(sum({forEach: f => f(42)}), total({reduce: (f, a) => f(a, 5)}));
+//CHKRUN: 42 15
+
+// So are replaced methods.
+var forEach = Array.prototype.forEach;
+Array.prototype.forEach = function(f) {
+  f(100);
+};
+print(sum([1, 2, 3]));
+//CHKRUN: 100
+Array.prototype.forEach = forEach;
+print(sum([1, 2, 3]));
+//CHKRUN: 6
+
+// Exceptions thrown by the callback propagate.
+try {
+  [1, 2].forEach(x => {
+    if (x === 2)
+      throw new Error('at ' + x);
+  });
+} catch (e) {
+  print(e.message);
+}
+//CHKRUN: at 2
@@ -0,0 +1,26 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-ir -profile-use=%s.profile %s 2> %t.err | %FileCheck %s
+// RUN: %FileCheck --check-prefix=WARN %s < %t.err
+
+// A profile of a different version of the source is ignored: the functions
+// it found hot may have moved.
+
+function outer(a, b) {
+  function add(x, y) {
+    return x + y;
+  }
+  return add(a, b) + add(b, a);
+}
+
+//CHECK-LABEL: function outer(a, b)
+//CHECK: CallInst
+//CHECK: CallInst
+//CHECK: ReturnInst
+
+//WARN: Warning: ignoring 1 functions of the profile {{.*}} which were profiled with a different source
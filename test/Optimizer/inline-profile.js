@@ -0,0 +1,35 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-ir %s | %FileCheck --check-prefix=NOPROF %s
+// RUN: %hermesc -O -dump-ir -profile-use=%s.profile %s | %FileCheck %s
+
+// Functions called from several places are only inlined if the profile
+// found them to be hot.
+
+function outer(a, b) {
+  function add(x, y) {
+    return x + y;
+  }
+  function sub(x, y) {
+    return x - y;
+  }
+  return add(a, b) + add(b, a) + sub(a, b) + sub(b, a);
+}
+
+//NOPROF-LABEL: function outer(a, b)
+//NOPROF: CallInst
+//NOPROF: CallInst
+//NOPROF: CallInst
+//NOPROF: CallInst
+//NOPROF: ReturnInst
+
+//CHECK-LABEL: function outer(a, b)
+//CHECK: CallInst
+//CHECK: CallInst
+//CHECK-NOT: CallInst
+//CHECK: ReturnInst
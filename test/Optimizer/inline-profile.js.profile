@@ -0,0 +1,24 @@
+{
+  "version": 2,
+  "page_size": 4096,
+  "functions": [
+    {
+      "checksum": "00000000000000000000000000000000",
+      "line": 15,
+      "column": 3,
+      "basic_blocks": [
+        {"profile_index": 0, "execution_count": 0, "order": 0},
+        {"profile_index": 1, "execution_count": 5000, "order": 2}
+      ]
+    },
+    {
+      "checksum": "11111111111111111111111111111111",
+      "line": 18,
+      "column": 3,
+      "basic_blocks": [
+        {"profile_index": 0, "execution_count": 0, "order": 0},
+        {"profile_index": 1, "execution_count": 10, "order": 3}
+      ]
+    }
+  ]
+}
@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-ir %s | %FileCheck %s
+// RUN: %hermes -O %s | %FileCheck --check-prefix=CHKRUN --match-full-lines %s
+
+// Loads of captured variables which the loop doesn't write are hoisted.
+
+function makeScaler(n) {
+  var scale = +n;
+  function sumScaled(count) {
+    var sum = 0;
+    for (var i = 0; i < 100; i++)
+      sum += scale * i;
+    return sum;
+  }
+  scale++;
+  return sumScaled;
+}
+//CHECK-LABEL: function sumScaled(count)
+//CHECK: LoadFrameInst [scale@makeScaler]
+//CHECK: PhiInst
+//CHECK-NOT: LoadFrameInst
+//CHECK: ReturnInst
+
+// The load can't be hoisted when the loop calls a function, which might
+// assign the variable.
+
+function makeCounter() {
+  var count = 0;
+  function inc() {
+    count++;
+  }
+  function run() {
+    var sum = 0;
+    for (var i = 0; i < 10; i++) {
+      sum += count;
+      inc();
+    }
+    return sum;
+  }
+  return run;
+}
+//CHECK-LABEL: function run()
+//CHECK: PhiInst
+//CHECK: LoadFrameInst [count@makeCounter]
+//CHECK: ReturnInst
+
+// The length of an array literal which isn't modified in the loop.
+
+function sumIndices() {
+  var arr = [1, 2, 3];
+  var sum = 0;
+  for (var i = 0; i < arr.length; i++)
+    sum += i;
+  return sum;
+}
+//CHECK-LABEL: function sumIndices()
+//CHECK: AllocArrayInst
+//CHECK-NEXT: LoadPropertyInst %{{.*}}, "length" : string
+//CHECK: PhiInst
+//CHECK-NOT: LoadPropertyInst
+//CHECK: ReturnInst
+
+print(makeScaler(2)(), makeCounter()(), sumIndices());
+//CHKRUN: 14850 45 3
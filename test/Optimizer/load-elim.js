@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-ir %s | %FileCheck %s
+// RUN: %hermes -O %s | %FileCheck --check-prefix=CHKRUN --match-full-lines %s
+
+// Loads of a variable which was loaded before, on the only path to them, are
+// replaced by the first load.
+
+function makeReader() {
+  var x = 1;
+  function read(c) {
+    var a = x;
+    if (c)
+      return a * x;
+    return a;
+  }
+  x = 3;
+  return read;
+}
+//CHECK-LABEL: function read(c)
+//CHECK: LoadFrameInst [x@makeReader]
+//CHECK-NOT: LoadFrameInst
+//CHECK: function_end
+
+// A call may assign the variable.
+
+function makeCounter() {
+  var n = 0;
+  function inc() {
+    n++;
+  }
+  function twice(f) {
+    var a = n;
+    f();
+    return a + n;
+  }
+  return [inc, twice];
+}
+//CHECK-LABEL: function twice(f)
+//CHECK: LoadFrameInst [n@makeCounter]
+//CHECK: CallInst
+//CHECK: LoadFrameInst [n@makeCounter]
+
+// Properties of object literals are own data properties, even when the object
+// escapes, until something may change them.
+
+var sunk;
+function sink(o) {
+  sunk = o;
+  o.a = 10;
+}
+
+function literal(x, f) {
+  var o = {a: x, self: null};
+  o.self = o;
+  var sum = o.a + o.self.a;
+  f(o);
+  return sum + o.a;
+}
+//CHECK-LABEL: function literal(x, f)
+//CHECK: [[O:%[0-9]+]] = AllocObjectInst
+//CHECK-NOT: LoadPropertyInst [[O]]
+//CHECK: CallInst
+//CHECK: LoadPropertyInst [[O]]{{.*}}, "a" : string
+
+function lengths() {
+  var arr = [1, 2, 3];
+  return arr.length * arr.length;
+}
+//CHECK-LABEL: function lengths()
+//CHECK: LoadPropertyInst %{{.*}}, "length" : string
+//CHECK-NOT: LoadPropertyInst
+//CHECK: ReturnInst
+
+// Other properties may be getters.
+
+function getters(o) {
+  return o.a + o.a;
+}
+//CHECK-LABEL: function getters(o)
+//CHECK: LoadPropertyInst %o{{.*}}, "a" : string
+//CHECK-NEXT: LoadPropertyInst %o{{.*}}, "a" : string
+
+var counter = makeCounter();
+var count = 0;
+print(
+  makeReader()(true),
+  makeReader()(false),
+  counter[1](counter[0]),
+  literal(2, sink),
+  sunk.a,
+  lengths(),
+  getters({
+    get a() {
+      return ++count;
+    },
+  })
+);
+//CHKRUN: 9 3 1 14 10 9 3
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-ir %s | %FileCheck %s
+// RUN: %hermes -O %s | %FileCheck --check-prefix=CHKRUN --match-full-lines %s
+
+// Objects that never escape are replaced by their properties.
+
+function destructure(x, y) {
+  var o = {a: x, b: y};
+  o.b = o.a;
+  return o.a + o.b;
+}
+//CHECK-LABEL: function destructure(x, y)
+//CHECK-NOT: AllocObjectInst
+//CHECK: ReturnInst
+//CHECK-NEXT: function_end
+
+function inlined(a, b) {
+  function point(x, y) {
+    return {x: x, y: y};
+  }
+  var p = point(a, b);
+  return p.x * p.y;
+}
+//CHECK-LABEL: function inlined(a, b)
+//CHECK-NOT: AllocObjectInst
+//CHECK: ReturnInst
+//CHECK-NEXT: function_end
+
+function conditional(c, x) {
+  var o = {v: 1};
+  if (c)
+    o.v = x;
+  return o.v;
+}
+//CHECK-LABEL: function conditional(c, x)
+//CHECK-NOT: AllocObjectInst
+//CHECK: ReturnInst
+//CHECK-NEXT: function_end
+
+// Properties that aren't defined yet come from the prototype.
+function inherited() {
+  var o = {a: 1};
+  return o.b;
+}
+//CHECK-LABEL: function inherited()
+//CHECK: AllocObjectInst
+
+function escapes(x) {
+  var o = {a: x};
+  print(o);
+  return o.a;
+}
+//CHECK-LABEL: function escapes(x)
+//CHECK: AllocObjectInst
+
+print(destructure(1, 2), inlined(3, 4), conditional(true, 5),
+      conditional(false, 5), inherited());
+//CHKRUN: 2 12 5 1 undefined
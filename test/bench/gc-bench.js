@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %gc-bench -size=1000 -rounds=5 -init-heap-mb=1 \
+// RUN:   | %FileCheck --match-full-lines %s
+// RUN: %gc-bench -size=1000 -rounds=5 -workload=churn -workload=list \
+// RUN:   | %FileCheck --match-full-lines --check-prefix=SELECTED %s
+// RUN: not %gc-bench -workload=nothing 2>&1 \
+// RUN:   | %FileCheck --match-full-lines --check-prefix=UNKNOWN %s
+
+// CHECK:      {
+// CHECK-NEXT:   "size": 1000,
+// CHECK-NEXT:   "rounds": 5,
+// CHECK-NEXT:   "workloads": {
+// CHECK-NEXT:     "list": {
+// CHECK-NEXT:       "wallMs": {{.*}},
+// CHECK-NEXT:       "gcFraction": {{.*}},
+// CHECK-NEXT:       "allocatedMB": {{.*}},
+// CHECK-NEXT:       "allocationMBPerSec": {{.*}},
+// CHECK-NEXT:       "heapSizeMB": {{.*}},
+// CHECK-NEXT:       "peakRSSMB": {{.*}},
+// CHECK-NEXT:       "young": {
+// CHECK-NEXT:         "count": {{[0-9]+}},
+// CHECK-NEXT:         "totalMs": {{.*}},
+// CHECK-NEXT:         "p50Ms": {{.*}},
+// CHECK-NEXT:         "p90Ms": {{.*}},
+// CHECK-NEXT:         "p99Ms": {{.*}},
+// CHECK-NEXT:         "maxMs": {{.*}}
+// CHECK-NEXT:       },
+// CHECK-NEXT:       "full": {
+// CHECK-NEXT:         "count": {{[0-9]+}},
+// CHECK:            }
+// CHECK-NEXT:     },
+// CHECK-NEXT:     "tree": {
+// CHECK:          "array": {
+// CHECK:          "weakmap": {
+// CHECK:          "churn": {
+// CHECK:        }
+// CHECK-NEXT: }
+
+// SELECTED:      "workloads": {
+// SELECTED-NEXT:   "churn": {
+// SELECTED:        "list": {
+// SELECTED-NOT:    "tree": {
+
+// UNKNOWN: Error: unknown workload nothing
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hvm-bench-runner -iterations=3 %s | %FileCheck --match-full-lines %s
+// RUN: %hvm-bench-runner -iterations=2 -warmup=0 -warm %s \
+// RUN:   | %FileCheck --match-full-lines --check-prefix=WARM %s
+// RUN: not %hvm-bench-runner -iterations=2 -o /dev/null \
+// RUN:   -baseline=%S/Inputs/runner-baseline.json %s 2>&1 \
+// RUN:   | %FileCheck --match-full-lines --check-prefix=REGRESSION %s
+// RUN: %hvm-bench-runner -iterations=1 -warmup=0 \
+// RUN:   %S/../../tools/hvm-bench/macro/coldStart.js \
+// RUN:   | %FileCheck --match-full-lines --check-prefix=MACRO %s
+
+var a = [];
+for (var i = 0; i < 10000; ++i) {
+  a.push({i: i});
+}
+print('not in the report');
+
+// CHECK:      {
+// CHECK-NEXT:   "iterations": 3,
+// CHECK-NEXT:   "warmup": 1,
+// CHECK-NEXT:   "warm": false,
+// CHECK-NEXT:   "benchmarks": {
+// CHECK-NEXT:     "runner.js": {
+// CHECK-NEXT:       "wallTime": {
+// CHECK-NEXT:         "median": {{.*}},
+// CHECK-NEXT:         "mean": {{.*}},
+// CHECK-NEXT:         "stddev": {{.*}},
+// CHECK-NEXT:         "ci95Low": {{.*}},
+// CHECK-NEXT:         "ci95High": {{.*}},
+// CHECK-NEXT:         "min": {{.*}},
+// CHECK-NEXT:         "max": {{.*}}
+// CHECK-NEXT:       },
+// CHECK-NEXT:       "cpuTime": {
+// CHECK:            "gcWallTime": {
+// CHECK:            "maxGCPause": {
+// CHECK:            "numGCs": {
+// CHECK:            "allocatedBytes": {
+// CHECK:            "heapSize": {
+// CHECK:            "wallTimes": [
+// CHECK-NEXT:         {{.*}},
+// CHECK-NEXT:         {{.*}},
+// CHECK-NEXT:         {{.*}}
+// CHECK-NEXT:       ]
+// CHECK-NEXT:     }
+// CHECK-NEXT:   }
+// CHECK-NEXT: }
+// CHECK-NOT: not in the report
+
+// WARM:        "warmup": 0,
+// WARM-NEXT:   "warm": true,
+// WARM:        "wallTimes": [
+// WARM-NEXT:     {{.*}},
+// WARM-NEXT:     {{.*}}
+// WARM-NEXT:   ]
+
+// REGRESSION: Regression in runner.js: median wall time 0.000001s -> {{.*}}
+
+// MACRO:      "coldStart.js": {
+// MACRO-NEXT:   "wallTime": {
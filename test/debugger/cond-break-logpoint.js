@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hdb %s < %s.debug | %FileCheck --match-full-lines %s
+// REQUIRES: debugger
+
+// Conditions are compiled once and evaluated in the scope of every hit, so a
+// condition that prints something and is false logs without pausing.
+
+print('logpoint');
+// CHECK-LABEL: logpoint
+
+function square(x) {
+  var y = x * x;
+  return y;
+}
+
+debugger;
+for (var i = 0; i < 4; ++i) {
+  square(i);
+}
+print('done');
+
+// CHECK-NEXT: Break on 'debugger' statement in global: {{.*}}:22:1
+// CHECK-NEXT: Set breakpoint 1 at {{.*}}:19:3 if print(x, y), y > 4
+// CHECK-NEXT: Set breakpoint 2 at {{.*}}:18:3 if (
+// CHECK-NEXT: Set breakpoint 3 at {{.*}}:24:3 if nope.x
+// CHECK-NEXT: Continuing execution
+// CHECK-NEXT: 0 0
+// CHECK-NEXT: 1 1
+// CHECK-NEXT: 2 4
+// CHECK-NEXT: 3 9
+// CHECK-NEXT: Break on breakpoint 1 in square: {{.*}}:19:3
+// CHECK-NEXT: Continuing execution
+// CHECK-NEXT: done
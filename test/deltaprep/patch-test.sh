@@ -0,0 +1,42 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+#
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+# RUN: bash %s %S %T %hbc-deltaprep %hermes
+# shellcheck shell=bash
+
+# Exit on any failure.
+set -e
+set -o pipefail
+
+SRCDIR=$1
+TMPDIR=$2
+DELTAPREP=$3
+HERMES=$4
+
+# Compile the source and an update of it.
+sed "s/print('concat')/print('concatenate')/" "${SRCDIR}/file1.js" \
+  > "${TMPDIR}/file1-updated.js"
+echo "print('updated');" >> "${TMPDIR}/file1-updated.js"
+${HERMES} -emit-binary -out "${TMPDIR}/file1.hbc" "${SRCDIR}/file1.js"
+${HERMES} -emit-binary -out "${TMPDIR}/file1-updated.hbc" \
+  "${TMPDIR}/file1-updated.js"
+
+# Create a patch, which is smaller than the update.
+${DELTAPREP} "${TMPDIR}/file1-updated.hbc" -create-patch="${TMPDIR}/file1.hbc" \
+  -out "${TMPDIR}/file1.patch"
+test "$(wc -c < "${TMPDIR}/file1.patch")" -lt \
+  "$(wc -c < "${TMPDIR}/file1-updated.hbc")"
+
+# Apply it in place to a copy of the file, and verify it matches the update.
+cp "${TMPDIR}/file1.hbc" "${TMPDIR}/file1-patched.hbc"
+${DELTAPREP} "${TMPDIR}/file1-patched.hbc" \
+  -apply-patch="${TMPDIR}/file1.patch" -out "${TMPDIR}/file1-patched.hbc"
+diff -q "${TMPDIR}/file1-updated.hbc" "${TMPDIR}/file1-patched.hbc"
+
+# The patch does not apply to another file, which is left as it was.
+cp "${TMPDIR}/file1-updated.hbc" "${TMPDIR}/file1-other.hbc"
+! ${DELTAPREP} "${TMPDIR}/file1-other.hbc" \
+  -apply-patch="${TMPDIR}/file1.patch" -out "${TMPDIR}/file1-other.hbc"
+diff -q "${TMPDIR}/file1-updated.hbc" "${TMPDIR}/file1-other.hbc"
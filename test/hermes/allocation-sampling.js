@@ -0,0 +1,35 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -allocation-sampling-interval=256 %s 2> %t.profile | %FileCheck --match-full-lines %s
+// RUN: %FileCheck --check-prefix=PROFILE %s < %t.profile
+
+// With a sampling interval much smaller than what the functions allocate,
+// both of them are sampled, and the objects kept alive are reported.
+
+function retain(n) {
+  var kept = [];
+  for (var i = 0; i < n; ++i)
+    kept.push({index: i, name: 'kept' + i});
+  return kept;
+}
+
+function discard(n) {
+  var last;
+  for (var i = 0; i < n; ++i)
+    last = {index: i, name: 'dropped' + i};
+  return last;
+}
+
+var kept = retain(2000);
+discard(2000);
+print(kept.length);
+// CHECK: 2000
+
+// PROFILE: {"head":{"callFrame":{"functionName":"(root)"{{.*}}
+// PROFILE-SAME: "functionName":"retain"
+// PROFILE-SAME: "samples":[{"size":{{.*}}
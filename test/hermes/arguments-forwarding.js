@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -fstatic-builtins %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// Calls that only pass `arguments` along are compiled without creating the
+// arguments object. Check that they behave the same.
+
+print('forwarding');
+// CHECK-LABEL: forwarding
+
+function show() {
+  var s = this === undefined ? 'undefined' : String(this.name);
+  for (var i = 0; i < arguments.length; ++i)
+    s += ' ' + arguments[i];
+  print(s);
+  return arguments.length;
+}
+
+function viaApply() {
+  return show.apply(this, arguments);
+}
+print(viaApply.call({name: 'apply'}, 1, 2, 3));
+// CHECK-NEXT: apply 1 2 3
+// CHECK-NEXT: 3
+print(viaApply());
+// CHECK-NEXT: undefined
+// CHECK-NEXT: 0
+
+function viaApplyWithLength() {
+  print(arguments.length, arguments[0]);
+  return show.apply(undefined, arguments);
+}
+viaApplyWithLength('a', 'b');
+// CHECK-NEXT: 2 a
+// CHECK-NEXT: undefined a b
+
+// An object with its own apply gets an arguments object.
+var custom = {
+  apply: function(thisVal, args) {
+    print('custom', thisVal, Object.prototype.toString.call(args), args[1]);
+  },
+};
+function viaCustomApply() {
+  return custom.apply('t', arguments);
+}
+viaCustomApply(1, 2);
+// CHECK-NEXT: custom t [object Arguments] 2
+
+function viaBadApply() {
+  return (3).apply(undefined, arguments);
+}
+try {
+  viaBadApply();
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+
+function viaNonCallable() {
+  return Function.prototype.apply.apply({}, arguments);
+}
+try {
+  viaNonCallable();
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+
+function viaSlice() {
+  return Array.prototype.slice.call(arguments);
+}
+print(JSON.stringify(viaSlice(1, 'x', null)));
+// CHECK-NEXT: [1,"x",null]
+
+function viaSliceFrom() {
+  return [].slice.call(arguments, 1);
+}
+print(JSON.stringify(viaSliceFrom(1, 2, 3)), viaSliceFrom(1).length);
+// CHECK-NEXT: [2,3] 0
+
+function viaSliceNegative() {
+  return Array.prototype.slice.call(arguments, -1);
+}
+print(JSON.stringify(viaSliceNegative(1, 2, 3)));
+// CHECK-NEXT: [3]
+
+function viaSpread() {
+  return show(...arguments);
+}
+print(viaSpread(4, 5));
+// CHECK-NEXT: undefined 4 5
+// CHECK-NEXT: 2
+
+var o = {name: 'method', show: show};
+function viaSpreadMethod() {
+  return o.show(...arguments);
+}
+viaSpreadMethod(6);
+// CHECK-NEXT: method 6
+
+// Modifying the arguments object must be visible to the callee.
+function viaModified() {
+  arguments[0] = 'changed';
+  return show.apply(undefined, arguments);
+}
+viaModified('original', 2);
+// CHECK-NEXT: undefined changed 2
@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Large zeroed buffers are mapped from the OS instead of being cleared, which
+// must not be observable.
+
+print('array-buffer-large');
+// CHECK-LABEL: array-buffer-large
+
+var size = 8 * 1024 * 1024 + 3;
+var buffer = new ArrayBuffer(size);
+var bytes = new Uint8Array(buffer);
+print(buffer.byteLength, bytes[0], bytes[size >> 1], bytes[size - 1]);
+// CHECK-NEXT: 8388611 0 0 0
+
+bytes[0] = 1;
+bytes[size >> 1] = 2;
+bytes[size - 1] = 3;
+var words = new Int32Array(buffer, 4096, 1024);
+words[1023] = -1;
+print(bytes[0], bytes[size >> 1], bytes[size - 1], bytes[4096 + 4095]);
+// CHECK-NEXT: 1 2 3 255
+
+// Slices copy into a block which is not zeroed first.
+var slice = new Uint8Array(buffer.slice(size - 2));
+print(slice.length, slice[0], slice[1]);
+// CHECK-NEXT: 2 0 3
+var big = new Uint8Array(buffer.slice(size >> 1));
+print(big.length, big[0], big[1], big[big.length - 1]);
+// CHECK-NEXT: 4194306 2 0 3
+
+// Typed arrays allocate their own buffers the same way.
+var floats = new Float64Array(1 << 18);
+print(floats.length, floats[0], floats[floats.length - 1]);
+// CHECK-NEXT: 262144 0 0
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// shift, unshift and splice at the start of an array only move the start of
+// its storage, which must not be observable.
+
+print('array-deque');
+// CHECK-LABEL: array-deque
+
+// A queue which keeps growing at the back and shrinking at the front.
+var q = [];
+var sum = 0;
+for (var i = 0; i < 10000; ++i) {
+  q.push(i, i + 1);
+  sum += q.shift();
+}
+print(q.length, sum, q[0], q[q.length - 1]);
+// CHECK-NEXT: 10000 25000000 5000 10000
+while (q.length)
+  sum -= q.shift();
+print(q.length, sum, q.shift(), q.length);
+// CHECK-NEXT: 0 -50000000 undefined 0
+
+// Adding at the front one element at a time.
+var d = [];
+for (var i = 0; i < 1000; ++i)
+  d.unshift(i);
+print(d.length, d[0], d[999], d.indexOf(500));
+// CHECK-NEXT: 1000 999 0 499
+print(d.unshift(-1, -2), d[0], d[1], d[2]);
+// CHECK-NEXT: 1002 -1 -2 999
+
+// Mixing both ends, and indexing in between.
+var m = [1, 2, 3];
+m.unshift(0);
+m.shift();
+m.shift();
+m.unshift('a', 'b');
+m.push(4);
+m[m.length] = 5;
+print(m.join(), m.length, Object.keys(m).join());
+// CHECK-NEXT: a,b,2,3,4,5 6 0,1,2,3,4,5
+m.length = 2;
+print(m.join(), m.shift(), m.join());
+// CHECK-NEXT: a,b a b
+m[3] = 'x';
+print(m.length, m.unshift('y'), m.join(), 2 in m);
+// CHECK-NEXT: 4 5 y,b,,,x false
+
+// Splicing at the start.
+var s = [0, 1, 2, 3, 4, 5];
+print(s.splice(0, 2).join(), s.join());
+// CHECK-NEXT: 0,1 2,3,4,5
+print(s.splice(0, 1, 'a', 'b', 'c').join(), s.join());
+// CHECK-NEXT: 2 a,b,c,3,4,5
+print(s.splice(0, 3, 'z').join(), s.join());
+// CHECK-NEXT: a,b,c z,3,4,5
+print(s.splice(0, 0, 'y').join(), s.join(), s.length);
+// CHECK-NEXT:  y,z,3,4,5 5
+
+// Holes and indexed properties on the prototype are still looked up.
+var h = [1, , 3];
+h.shift();
+print(h.length, 0 in h, h[1]);
+// CHECK-NEXT: 2 false 3
+Array.prototype[3] = 'proto';
+var p = [1, 2, 3];
+p.unshift(0);
+print(p.length, p.hasOwnProperty(3), p[3]);
+// CHECK-NEXT: 4 true 3
+delete Array.prototype[3];
+
+// Arrays whose elements cannot be moved throw as before.
+var f = Object.freeze([1, 2]);
+try {
+  f.shift();
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+var n = [1, 2];
+Object.defineProperty(n, 'length', {writable: false});
+try {
+  n.unshift(0);
+} catch (e) {
+  print(e.name, n.join());
+}
+// CHECK-NEXT: TypeError 1,2
@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// The array methods read packed arrays straight from their storage, so the
+// element kind must follow every way of making holes and filling them.
+
+print('packed');
+// CHECK-LABEL: packed
+var a = [1, 2, 3, 4];
+print(a.indexOf(3), a.indexOf('3'), a.includes(4), a.includes('4'));
+// CHECK-NEXT: 2 -1 true false
+a.push('x');
+print(a.indexOf('x'), a.lastIndexOf(1), a.includes(NaN));
+// CHECK-NEXT: 4 0 false
+a.push(NaN);
+print(a.indexOf(NaN), a.includes(NaN));
+// CHECK-NEXT: -1 true
+
+print('holes');
+// CHECK-LABEL: holes
+Array.prototype[1] = 'proto';
+var b = [0, 1, 2];
+delete b[1];
+print(b.indexOf('proto'), b.includes('proto'));
+// CHECK-NEXT: 1 true
+b[1] = 'own';
+print(b.indexOf('proto'), b.indexOf('own'));
+// CHECK-NEXT: -1 1
+var c = [0];
+c[2] = 2;
+print(c.indexOf('proto'), c.includes(undefined));
+// CHECK-NEXT: 1 false
+c.length = 1;
+c.push(5, 6);
+print(c.indexOf('proto'), c.indexOf(6));
+// CHECK-NEXT: -1 2
+delete Array.prototype[1];
+
+print('callbacks');
+// CHECK-LABEL: callbacks
+var d = [1, 2, 3, 4];
+print(d.map(function(x, i, arr) {
+  if (i === 0)
+    arr.length = 2;
+  return x * 10;
+}).join());
+// CHECK-NEXT: 10,20,,
+var e = [1, 2, 3];
+var seen = [];
+e.forEach(function(x, i, arr) {
+  if (i === 0)
+    delete arr[1];
+  seen.push(x);
+});
+print(seen.join());
+// CHECK-NEXT: 1,3
+var f = [1, 2, 3];
+print(f.reduce(function(acc, x, i, arr) {
+  if (i === 1)
+    Object.defineProperty(arr, 2, {get: function() { return 100; }});
+  return acc + x;
+}));
+// CHECK-NEXT: 103
+print([1, 2, 3].every(function(x, i, arr) {
+  arr[i + 1] = 'x';
+  return typeof x === 'number';
+}));
+// CHECK-NEXT: false
@@ -537,7 +537,7 @@ var a = [{}, {}];
 a.__defineGetter__(1, function() { a.length = 0; return 0; });
 a.sort();
 print('sorting', a, 'did not crash');
-// CHECK-NEXT: sorting  did not crash
+// CHECK-NEXT: sorting 0,[object Object] did not crash
 
 print('splice');
 // CHECK-LABEL: splice
@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// The iteration methods of Array.prototype call their callback for every
+// element in one reused call frame.
+
+print('callbacks');
+// CHECK-LABEL: callbacks
+var a = [1, 2, 3, 4];
+print(a.map(function(x, i, o) {
+  return x * 10 + i + (o === a ? 0 : 100);
+}));
+// CHECK-NEXT: 10,21,32,43
+print(a.filter(function(x) {
+  return x & 1;
+}));
+// CHECK-NEXT: 1,3
+print(a.reduce(function(acc, x, i) {
+  return acc + x * i;
+}, 0), a.reduceRight(function(acc, x) {
+  return acc + x;
+}));
+// CHECK-NEXT: 20 10
+print(a.every(function(x) {
+  return x > 0;
+}), a.some(function(x) {
+  return x > 3;
+}));
+// CHECK-NEXT: true true
+var thisArgs = [];
+a.forEach(function() {
+  thisArgs.push(this.tag);
+}, {tag: 't'});
+print(thisArgs);
+// CHECK-NEXT: t,t,t,t
+
+print('bound and native callbacks');
+// CHECK-LABEL: bound and native callbacks
+var bound = function(p, x, i) {
+  return p + x + i + this.s;
+}.bind({s: '!'}, '>');
+print(a.map(bound));
+// CHECK-NEXT: >10!,>21!,>32!,>43!
+print(['1', '2', '3'].map(Number), [3, -1, 2].map(Math.abs));
+// CHECK-NEXT: 1,2,3 3,1,2
+
+print('nested');
+// CHECK-LABEL: nested
+print([[1, 2], [3]].map(function(inner) {
+  return inner.map(function(x) {
+    return [x].map(function(y) {
+      return y * 2;
+    });
+  }).join('+');
+}));
+// CHECK-NEXT: 2+4,6
+
+print('holes');
+// CHECK-LABEL: holes
+var holey = [1, , 3];
+Array.prototype[1] = 'p';
+print(holey.map(function(x) {
+  return x + x;
+}));
+// CHECK-NEXT: 2,pp,6
+delete Array.prototype[1];
+var mapped = holey.map(function(x) {
+  return x;
+});
+print(mapped.length, 1 in mapped, holey.filter(function() {
+  return true;
+}).length);
+// CHECK-NEXT: 3 false 2
+var obj = {length: 3, 0: 'a', 2: 'c'};
+Object.defineProperty(obj, 1, {
+  get: function() {
+    return 'b';
+  },
+});
+print(Array.prototype.map.call(obj, function(x) {
+  return x.toUpperCase();
+}));
+// CHECK-NEXT: A,B,C
+
+print('mutation');
+// CHECK-LABEL: mutation
+var b = [1, 2, 3, 4, 5];
+var seen = [];
+b.forEach(function(x, i) {
+  seen.push(x);
+  if (i === 0) {
+    b.pop();
+    b[2] = 30;
+  }
+});
+print(seen);
+// CHECK-NEXT: 1,2,30,4
+b = [1, 2, 3];
+print(b.map(function(x, i) {
+  b.push(x);
+  return x;
+}), b);
+// CHECK-NEXT: 1,2,3 1,2,3,1,2,3
+b = [1, 2, 3, 4];
+print(b.filter(function(x, i) {
+  if (i === 1)
+    Object.defineProperty(b, 2, {
+      get: function() {
+        return 'g';
+      },
+    });
+  return true;
+}));
+// CHECK-NEXT: 1,2,g,4
+
+print('exceptions');
+// CHECK-LABEL: exceptions
+try {
+  [1, 2, 3].map(function(x) {
+    if (x === 2)
+      throw new Error('at ' + x);
+    return x;
+  });
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: at 2
+function recurse(n) {
+  return [n].map(recurse);
+}
+try {
+  recurse(0);
+} catch (e) {
+  print(e instanceof RangeError);
+}
+// CHECK-NEXT: true
+print([5, 6].map(function(x) {
+  return x + 1;
+}));
+// CHECK-NEXT: 6,7
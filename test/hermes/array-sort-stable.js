@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Array.prototype.sort and TypedArray.prototype.sort are stable, and sort
+// arrays of only numbers or only strings without a comparator directly.
+
+function records(n) {
+  var a = [];
+  for (var i = 0; i < n; ++i)
+    a.push({key: (i * 7) % 5, id: i});
+  return a;
+}
+
+function isStable(a) {
+  for (var i = 1; i < a.length; ++i) {
+    if (a[i - 1].key > a[i].key)
+      return false;
+    if (a[i - 1].key === a[i].key && a[i - 1].id > a[i].id)
+      return false;
+  }
+  return true;
+}
+
+print('stable');
+// CHECK-LABEL: stable
+var sizes = [0, 1, 5, 21, 40, 100, 1000];
+for (var i = 0; i < sizes.length; ++i) {
+  var a = records(sizes[i]);
+  a.sort(function(x, y) { return x.key - y.key; });
+  print(sizes[i], isStable(a));
+}
+// CHECK-NEXT: 0 true
+// CHECK-NEXT: 1 true
+// CHECK-NEXT: 5 true
+// CHECK-NEXT: 21 true
+// CHECK-NEXT: 40 true
+// CHECK-NEXT: 100 true
+// CHECK-NEXT: 1000 true
+var a = ['bb', 'a', 'cc', 'b', 'aa', 'c'];
+print(a.sort(function(x, y) { return x.length - y.length; }));
+// CHECK-NEXT: a,b,c,bb,cc,aa
+
+print('numbers');
+// CHECK-LABEL: numbers
+print([10, 9, 1, 100, -1, 2.5, -0, 0].sort());
+// CHECK-NEXT: -1,0,0,1,10,100,2.5,9
+print([NaN, Infinity, 1e21, 5, -Infinity].sort());
+// CHECK-NEXT: -Infinity,1e+21,5,Infinity,NaN
+var n = [];
+for (var i = 0; i < 100; ++i)
+  n.push((i * 37) % 100);
+n.sort();
+print(n.slice(0, 12));
+// CHECK-NEXT: 0,1,10,11,12,13,14,15,16,17,18,19
+
+print('strings');
+// CHECK-LABEL: strings
+print(['b', 'B', 'a', '', 'ab', 'é', 'A'].sort());
+// CHECK-NEXT: ,A,B,a,ab,b,é
+print(['10', 9, '1', 2].sort());
+// CHECK-NEXT: 1,10,2,9
+
+print('holes');
+// CHECK-LABEL: holes
+var h = [3, , undefined, 1, , 2];
+h.sort();
+print(h.length, h, 4 in h, 5 in h);
+// CHECK-NEXT: 6 1,2,3,,, false false
+var o = {0: 'c', 2: 'a', 5: undefined, 6: 'b', length: 7};
+Array.prototype.sort.call(o);
+print(o[0], o[1], o[2], o[3], 4 in o, 6 in o);
+// CHECK-NEXT: a b c undefined false false
+
+print('typed');
+// CHECK-LABEL: typed
+print(new Float64Array([3, NaN, -0, 0, -Infinity, 1, NaN, -2]).sort()
+  .map(function(x) { return 1 / x === -Infinity ? -1e9 : x; }).join());
+// CHECK-NEXT: -Infinity,-2,-1000000000,0,1,3,NaN,NaN
+print(new Int8Array([5, -3, 127, -128, 0]).sort());
+// CHECK-NEXT: -128,-3,0,5,127
+print(new Uint32Array([4294967295, 1, 2147483648]).sort());
+// CHECK-NEXT: 1,2147483648,4294967295
+var t = new Uint8Array(40);
+for (var i = 0; i < t.length; ++i)
+  t[i] = i;
+t.sort(function(x, y) { return (x & 3) - (y & 3); });
+print(t.slice(0, 11));
+// CHECK-NEXT: 0,4,8,12,16,20,24,28,32,36,1
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// Functions that bind only 'this' call their target with the caller's
+// arguments in place.
+
+function show() {
+  return [this.tag].concat(Array.prototype.slice.call(arguments)).join(',');
+}
+var obj = {tag: 'o'};
+var onlyThis = show.bind(obj);
+
+print('only this');
+// CHECK-LABEL: only this
+print(onlyThis(), onlyThis(1), onlyThis(1, 2, 3));
+// CHECK-NEXT: o o,1 o,1,2,3
+print(onlyThis(1, 2, 3, 4, 5, 6));
+// CHECK-NEXT: o,1,2,3,4,5,6
+var holder = {tag: 'h', f: onlyThis};
+print(holder.f(1), holder.tag, holder.f(2), holder.tag);
+// CHECK-NEXT: o,1 h o,2 h
+print(onlyThis.call({tag: 'c'}, 1), onlyThis.apply(null, [2, 3]));
+// CHECK-NEXT: o,1 o,2,3
+print([1, 2].map(onlyThis));
+// CHECK-NEXT: o,1,0,1,2,o,2,1,1,2
+
+print('strict this');
+// CHECK-LABEL: strict this
+function strictThis() {
+  'use strict';
+  return typeof this + ':' + this;
+}
+print(strictThis.bind(5)(), strictThis.bind(undefined)(), strictThis.bind()());
+// CHECK-NEXT: number:5 undefined:undefined undefined:undefined
+
+print('bound arguments');
+// CHECK-LABEL: bound arguments
+var withArgs = show.bind(obj, 'a', 'b');
+print(withArgs(), withArgs(1, 2, 3, 4, 5));
+// CHECK-NEXT: o,a,b o,a,b,1,2,3,4,5
+var twice = onlyThis.bind({tag: 'ignored'}, 'x');
+print(twice(1), show.bind(obj).bind(null)(2));
+// CHECK-NEXT: o,x,1 o,2
+
+print('construct');
+// CHECK-LABEL: construct
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+var BoundPoint = Point.bind({tag: 'unused'});
+var p = new BoundPoint(1, 2);
+print(p.x, p.y, p instanceof Point, p instanceof BoundPoint);
+// CHECK-NEXT: 1 2 true true
+p = new (Point.bind(null, 3))(4);
+print(p.x, p.y);
+// CHECK-NEXT: 3 4
+
+print('natives and exceptions');
+// CHECK-LABEL: natives and exceptions
+var join = Array.prototype.join.bind(['p', 'q']);
+print(join('-'), Math.max.bind(null)(1, 3, 2));
+// CHECK-NEXT: p-q 3
+var thrower = function(m) {
+  throw new Error(m + this.tag);
+}.bind(obj);
+try {
+  thrower('e:');
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: e:o
+var depth = 0;
+var recurse = function() {
+  ++depth;
+  return recurse();
+}.bind(null);
+try {
+  recurse();
+} catch (e) {
+  print(e instanceof RangeError, depth > 100);
+}
+// CHECK-NEXT: true true
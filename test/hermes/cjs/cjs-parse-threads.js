@@ -0,0 +1,33 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -commonjs -parse-threads=2 %S/cjs-parse-threads.js %S/cjs-multiple-2.js %S/cjs-dynamic-2.js | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -commonjs -parse-threads=3 %S/cjs-parse-threads.js %S/cjs-multiple-2.js %S/cjs-dynamic-2.js | %FileCheck --match-full-lines %s
+// RUN: %hermes -commonjs -parse-threads=1 %S/cjs-parse-threads.js %S/cjs-multiple-2.js %S/cjs-dynamic-2.js | %FileCheck --match-full-lines %s
+
+// Modules parsed on other threads use the labels of the main context.
+function count() {
+  'use strict';
+  return arguments.length;
+}
+print('count', count(1, 2, 3));
+// CHECK-LABEL: count 3
+
+outer: for (var i = 0; i < 3; ++i) {
+  for (var j = 0; j < 3; ++j) {
+    if (j === 1) continue outer;
+    if (i === 2) break outer;
+    print(i, j);
+  }
+}
+// CHECK-NEXT: 0 0
+// CHECK-NEXT: 1 0
+
+var module2 = require('./cjs-multiple-2.js');
+// CHECK-NEXT: initializing module 2
+print('module2.y=', module2.y, require('./cjs-dynamic-2.js'));
+// CHECK-NEXT: module2.y= asdf 3
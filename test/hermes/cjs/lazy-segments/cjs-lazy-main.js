@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -commonjs -fstatic-require -fstatic-builtins %S/ -emit-binary -out %T/lazy.hbc && %hermes %T/lazy.hbc | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -commonjs -fstatic-require -fstatic-builtins %S/ -dump-bytecode | %FileCheck --match-full-lines %s -check-prefix BC
+// RUN: %hermes -O -commonjs -fstatic-require -fstatic-builtins %S/ -emit-binary -out %T/lazy.hbc && rm %T/lazy.hbc.7 && %hermes %T/lazy.hbc | %FileCheck --match-full-lines %s -check-prefix MISSING
+
+// Requiring a module of a segment that hasn't been loaded with loadSegment()
+// loads the segment on demand.
+
+print('main: init');
+// CHECK-LABEL: main: init
+// MISSING-LABEL: main: init
+
+try {
+  print('main: b.y =', require('./cjs-lazy-b.js').y);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: b: init
+// CHECK-NEXT: a: init
+// CHECK-NEXT: main: b.y = 7
+// MISSING-NEXT: TypeError
+
+print('main: a.x =', require('./cjs-lazy-a.js').x);
+// CHECK-NEXT: main: a.x = 3
+// MISSING-NEXT: a: init
+// MISSING-NEXT: main: a.x = 3
+
+// BC-LABEL: Segment count: 3
+// BC-LABEL: Segments:
+// BC-DAG: Segment 0 -> 1 modules from index {{[0-9]+}}
+// BC-DAG: Segment 3 -> 1 modules from index {{[0-9]+}}
+// BC-DAG: Segment 7 -> 1 modules from index {{[0-9]+}}
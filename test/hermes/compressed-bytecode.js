@@ -0,0 +1,44 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -emit-binary -compress-bytecode -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+// RUN: %hermes -emit-binary -compress-bytecode -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// Bytecode files in compressed form run like the uncompressed ones.
+
+print('compressed');
+// CHECK-LABEL: compressed
+function fib(n) {
+  return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+print(fib(20));
+// CHECK-NEXT: 6765
+
+function thrower(x) {
+  try {
+    throw new Error('e' + x);
+  } catch (e) {
+    return e.message;
+  } finally {
+    print('finally');
+  }
+}
+print(thrower(1));
+// CHECK-NEXT: finally
+// CHECK-NEXT: e1
+
+var strings = [];
+for (var i = 0; i < 5; ++i) strings.push('s' + i);
+print(strings.join(), JSON.stringify({a: [1, 2], b: 'x'}), /b+/.exec('abbc'));
+// CHECK-NEXT: s0,s1,s2,s3,s4 {"a":[1,2],"b":"x"} bb
+
+function* gen() {
+  yield 1;
+  yield 2;
+}
+print([...gen()], (function() { return arguments.length; })(1, 2, 3));
+// CHECK-NEXT: 1,2 3
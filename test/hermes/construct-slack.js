@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Constructed objects get storage for as many properties as the previous
+// objects of their constructor had, which must not be visible.
+
+function Point(n) {
+  this.x0 = n; this.x1 = n + 1; this.x2 = n + 2; this.x3 = n + 3;
+  this.x4 = n + 4; this.x5 = n + 5; this.x6 = n + 6; this.x7 = n + 7;
+  this.x8 = n + 8; this.x9 = n + 9;
+}
+
+print('fields');
+// CHECK-LABEL: fields
+var points = [];
+for (var i = 0; i < 5; ++i)
+  points.push(new Point(i * 10));
+print(points[4].x9, points[0].x0, Object.keys(points[2]).length);
+// CHECK-NEXT: 49 0 10
+print(JSON.stringify(points[1]));
+// CHECK-NEXT: {"x0":10,"x1":11,"x2":12,"x3":13,"x4":14,"x5":15,"x6":16,"x7":17,"x8":18,"x9":19}
+
+print('varying');
+// CHECK-LABEL: varying
+function Bag(n) {
+  for (var i = 0; i < n; ++i)
+    this['p' + i] = i;
+}
+var big = new Bag(20);
+var small = new Bag(2);
+print(Object.keys(small).join(), small.p5, Object.keys(big).length);
+// CHECK-NEXT: p0,p1 undefined 20
+small.q = 'q';
+print(Object.keys(small).join(), big.p19);
+// CHECK-NEXT: p0,p1,q 19
+
+print('returned');
+// CHECK-LABEL: returned
+function Other() {
+  this.a = 1; this.b = 2; this.c = 3; this.d = 4; this.e = 5;
+  return {other: true};
+}
+new Other();
+var o = new Other();
+print(JSON.stringify(o));
+// CHECK-NEXT: {"other":true}
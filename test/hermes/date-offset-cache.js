@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: TZ="PST8PDT" %hermes -O %s | %FileCheck --match-full-lines %s
+"use strict";
+
+// Local time conversions reuse cached time zone offsets, and the string
+// produced by toISOString() is parsed without the general ISO parser.
+
+print('dst');
+// CHECK-LABEL: dst
+// Step across the transitions of Mar 12 and Nov 5, 2017 forwards and back.
+var hours = [];
+var start = Date.UTC(2017, 2, 11);
+for (var i = 0; i < 48; i += 6)
+  hours.push(new Date(start + i * 3600000).getHours());
+print(hours);
+// CHECK-NEXT: 16,22,4,10,16,22,5,11
+hours = [];
+start = Date.UTC(2017, 10, 6);
+for (var i = 48; i > 0; i -= 6)
+  hours.push(new Date(start - i * 3600000).getHours());
+print(hours);
+// CHECK-NEXT: 17,23,5,11,17,23,4,10
+print(new Date(2017, 2, 12, 12).getTimezoneOffset(),
+      new Date(2017, 0, 12, 12).getTimezoneOffset(),
+      new Date(2017, 6, 12, 12).getTimezoneOffset());
+// CHECK-NEXT: 420 480 420
+var d = new Date(2017, 2, 1);
+var offsets = [];
+for (var day = 0; day < 30; day += 5) {
+  d.setDate(day + 1);
+  offsets.push(d.getTimezoneOffset());
+}
+print(offsets);
+// CHECK-NEXT: 480,480,480,420,420,420
+
+print('iso');
+// CHECK-LABEL: iso
+var iso = new Date(Date.UTC(2019, 6, 4, 3, 2, 1, 9)).toISOString();
+print(iso, Date.parse(iso));
+// CHECK-NEXT: 2019-07-04T03:02:01.009Z 1562209321009
+d = new Date(0);
+d.setUTCFullYear(5);
+print(d.toISOString().slice(0, 4),
+      new Date(Date.UTC(-1, 0, 1)).toISOString().slice(0, 7));
+// CHECK-NEXT: 0005 -000001
+print(Date.parse('2019-07-04T03:02:01.00xZ'),
+      Date.parse('2019-07-04T03:02:01.009+01:00'),
+      Date.parse('2019-07-04 03:02:01.009Z'),
+      Date.parse('2019-07-04T03:02:01.0091Z'));
+// CHECK-NEXT: NaN 1562205721009 1562209321009 1562209321009
@@ -0,0 +1,44 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -non-strict -O -target=HBC %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -non-strict -target=HBC %s | %FileCheck --match-full-lines %s
+
+// A debugger statement in a callee hands the frames of the interpreter loop
+// over to the instrumented loop, which has to return to and unwind into the
+// callers.
+
+function inner(x) {
+  debugger;
+  return x + 1;
+}
+function outer(x) {
+  var r = inner(x);
+  return r * 2;
+}
+print(outer(1));
+// CHECK: 4
+
+function thrower() {
+  debugger;
+  throw new Error('thrown');
+}
+function catcher() {
+  try {
+    thrower();
+  } catch (e) {
+    return e.message;
+  }
+}
+print(catcher());
+// CHECK-NEXT: thrown
+
+var sum = 0;
+for (var i = 0; i < 3; ++i)
+  sum += outer(i);
+print(sum);
+// CHECK-NEXT: 12
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Objects which became dictionaries get a regular class again once they are
+// only read, which must keep their properties, values and order.
+
+function readAll(o, n) {
+  var sum = 0;
+  for (var i = 0; i < n; ++i)
+    sum += o.a + o.c + o.d;
+  return sum;
+}
+
+print('delete');
+// CHECK-LABEL: delete
+var o = {a: 1, b: 2, c: 3, d: 4, e: 5, f: 6};
+delete o.b;
+delete o.e;
+print(readAll(o, 200));
+// CHECK-NEXT: 1600
+print(JSON.stringify(o), Object.keys(o).length);
+// CHECK-NEXT: {"a":1,"c":3,"d":4,"f":6} 4
+o.b = 7;
+o.a = 10;
+delete o.d;
+print(JSON.stringify(o));
+// CHECK-NEXT: {"a":10,"c":3,"f":6,"b":7}
+
+print('accessors');
+// CHECK-LABEL: accessors
+var p = {x: 1, y: 2, z: 3};
+Object.defineProperty(p, 'd', {get: function() { return this.x * 100; }});
+delete p.y;
+for (var i = 0; i < 200; ++i)
+  p.x + p.z;
+print(p.d, p.x, p.z, 'y' in p);
+// CHECK-NEXT: 100 1 3 false
+var desc = Object.getOwnPropertyDescriptor(p, 'd');
+print(typeof desc.get, desc.enumerable, desc.configurable);
+// CHECK-NEXT: function false false
+
+print('shared');
+// CHECK-LABEL: shared
+var records = [];
+for (var i = 0; i < 10; ++i) {
+  var r = {id: i, tmp: 0, name: 'r' + i};
+  delete r.tmp;
+  records.push(r);
+}
+var ids = 0;
+for (var j = 0; j < 100; ++j) {
+  for (var i = 0; i < records.length; ++i)
+    ids += records[i].id;
+}
+print(ids, records[3].name, Object.keys(records[9]).join());
+// CHECK-NEXT: 4500 r3 id,name
+
+print('frozen');
+// CHECK-LABEL: frozen
+var f = {a: 1, b: 2, c: 3};
+delete f.b;
+Object.freeze(f);
+for (var i = 0; i < 200; ++i)
+  f.a + f.c;
+f.a = 5;
+print(f.a, Object.isFrozen(f));
+// CHECK-NEXT: 1 true
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -eval-cache-size=1 %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -eval-cache-size=0 %s | %FileCheck --match-full-lines %s
+
+// Sources compiled again by eval and Function share their bytecode, but each
+// run gets its own functions and variables.
+
+print('function');
+// CHECK-LABEL: function
+var fns = [];
+for (var i = 0; i < 3; ++i)
+  fns.push(new Function('a', 'b', 'var c = a + b; return c * ' + 2));
+print(fns[0](1, 2), fns[2](3, 4), fns[0] !== fns[1]);
+// CHECK-NEXT: 6 14 true
+var f1 = new Function('return {}');
+var f2 = new Function('return {}');
+print(f1() !== f2(), f1.name);
+// CHECK-NEXT: true anonymous
+
+print('eval');
+// CHECK-LABEL: eval
+var counters = [];
+for (var i = 0; i < 3; ++i)
+  counters.push(eval('(function() { var n = 0; return () => ++n; })()'));
+counters[0]();
+counters[0]();
+print(counters[0](), counters[1]());
+// CHECK-NEXT: 3 1
+
+print('scope');
+// CHECK-LABEL: scope
+function withX(x) {
+  return eval('x + 1');
+}
+function withY(y) {
+  var x = 10;
+  return eval('x + 1');
+}
+var x = 100;
+print(withX(1), withY(2), (0, eval)('x + 1'), withX(5));
+// CHECK-NEXT: 2 11 101 6
+
+print('errors');
+// CHECK-LABEL: errors
+for (var i = 0; i < 2; ++i) {
+  try {
+    eval('(');
+  } catch (e) {
+    print(e.name);
+  }
+}
+// CHECK-NEXT: SyntaxError
+// CHECK-NEXT: SyntaxError
+try {
+  new Function('a', '}, function(){');
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: SyntaxError
@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// for-of steps the builtin iterators without allocating iterator result
+// objects, and still behaves like the iterator protocol.
+
+function collect(iterable) {
+  var result = [];
+  for (var x of iterable)
+    result.push(x);
+  return result;
+}
+
+print('arrays');
+// CHECK-LABEL: arrays
+print(collect([1, 'a', undefined, null]).length);
+// CHECK-NEXT: 4
+Array.prototype[1] = 'p';
+print(collect([0, , 2]));
+// CHECK-NEXT: 0,p,2
+delete Array.prototype[1];
+var arr = [1, 2, 3];
+Object.defineProperty(arr, 1, {
+  get: function() {
+    return 'g';
+  },
+});
+print(collect(arr));
+// CHECK-NEXT: 1,g,3
+arr = [1, 2, 3];
+var seen = [];
+for (var x of arr) {
+  seen.push(x);
+  if (x === 1)
+    arr.push(4);
+  if (x === 3)
+    arr.length = 0;
+}
+print(seen);
+// CHECK-NEXT: 1,2,3
+print(collect([5, 6].entries()).join(';'), collect([5, 6].keys()));
+// CHECK-NEXT: 0,5;1,6 0,1
+print(collect(new Uint8Array([7, 8])), collect({length: 2, 0: 'x', 1: 'y',
+  [Symbol.iterator]: Array.prototype.values}));
+// CHECK-NEXT: 7,8 x,y
+(function() {
+  print(collect(arguments));
+})(1, 2);
+// CHECK-NEXT: 1,2
+
+print('maps and sets');
+// CHECK-LABEL: maps and sets
+var m = new Map([['a', 1], ['b', 2], ['c', 3]]);
+seen = [];
+for (var e of m) {
+  seen.push(e.join(':'));
+  if (e[0] === 'a') {
+    m.delete('b');
+    m.set('d', 4);
+  }
+}
+print(seen);
+// CHECK-NEXT: a:1,c:3,d:4
+print(collect(m.keys()), collect(m.values()), collect(new Set([1, 1, 2])));
+// CHECK-NEXT: a,c,d 1,3,4 1,2
+
+print('strings');
+// CHECK-LABEL: strings
+print(collect('ab😀c').length, collect('').length);
+// CHECK-NEXT: 4 0
+
+print('replaced next');
+// CHECK-LABEL: replaced next
+var ArrayIteratorProto = Object.getPrototypeOf([][Symbol.iterator]());
+var origNext = ArrayIteratorProto.next;
+ArrayIteratorProto.next = function() {
+  var r = origNext.call(this);
+  if (!r.done)
+    r.value *= 10;
+  return r;
+};
+print(collect([1, 2]));
+// CHECK-NEXT: 10,20
+ArrayIteratorProto.next = origNext;
+var it = [1, 2][Symbol.iterator]();
+it.next = function() {
+  return {done: true};
+};
+print(collect(it).length);
+// CHECK-NEXT: 0
+
+print('iterators yielding themselves');
+// CHECK-LABEL: iterators yielding themselves
+var count = 0;
+var self = {
+  [Symbol.iterator]: function() {
+    return this;
+  },
+  next: function() {
+    return {value: this, done: ++count > 2};
+  },
+};
+var values = collect(self);
+print(values.length, values[0] === self);
+// CHECK-NEXT: 2 true
+var a = [];
+it = a.values();
+a.push(it);
+values = collect(it);
+print(values.length, values[0] === it);
+// CHECK-NEXT: 1 true
+
+print('protocol');
+// CHECK-LABEL: protocol
+var log = [];
+var custom = {
+  [Symbol.iterator]: function() {
+    var i = 0;
+    return {
+      next: function() {
+        log.push('next');
+        return {
+          get done() {
+            log.push('done');
+            return i >= 1;
+          },
+          get value() {
+            log.push('value');
+            return i++;
+          },
+        };
+      },
+      return: function() {
+        log.push('return');
+        return {};
+      },
+    };
+  },
+};
+for (var x of custom);
+print(log);
+// CHECK-NEXT: next,done,value,next,done
+log = [];
+for (var x of custom)
+  break;
+print(log);
+// CHECK-NEXT: next,done,value,return
+function* gen() {
+  try {
+    yield 1;
+    yield 2;
+  } finally {
+    print('closed');
+  }
+}
+for (var x of gen()) {
+  print(x);
+  break;
+}
+// CHECK-NEXT: 1
+// CHECK-NEXT: closed
+try {
+  for (var x of {
+    [Symbol.iterator]: function() {
+      return {
+        next: function() {
+          return 1;
+        },
+      };
+    },
+  });
+} catch (e) {
+  print(e.name, e.message);
+}
+// CHECK-NEXT: TypeError iterator.next() did not return an object
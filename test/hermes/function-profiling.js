@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O0 -function-profiling %s 2> %t.stacks | %FileCheck --match-full-lines %s
+// RUN: %FileCheck --check-prefix=STACKS %s < %t.stacks
+// RUN: %hermes -O0 -function-profiling-summary %s 2> %t.summary
+// RUN: %FileCheck --check-prefix=INNER %s < %t.summary
+// RUN: %FileCheck --check-prefix=THROWER %s < %t.summary
+// RUN: %FileCheck --check-prefix=MAPPED %s < %t.summary
+
+// Every call to a JS function is measured, including the calls an exception
+// unwinds, and written as folded stacks or as a summary per function.
+
+function inner(n) {
+  var sum = 0;
+  for (var i = 0; i < n; ++i)
+    sum += i;
+  return sum;
+}
+function outer() {
+  var sum = 0;
+  for (var i = 0; i < 10; ++i)
+    sum += inner(100);
+  return sum;
+}
+function thrower() {
+  throw new Error('thrown');
+}
+
+print(outer());
+// CHECK: 49500
+try {
+  thrower();
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: thrown
+// Native functions call back into the instrumented interpreter loop too.
+print([1, 2, 3].map(function mapped(x) { return x * 2; }).join());
+// CHECK-NEXT: 2,4,6
+
+// STACKS-DAG: {{^global\([^;]*\) [0-9]+$}}
+// STACKS-DAG: {{^global\([^;]*\);outer\([^;]*\) [0-9]+$}}
+// STACKS-DAG: {{^global\([^;]*\);outer\([^;]*\);inner\([^;]*\) [0-9]+$}}
+// STACKS-DAG: {{^global\([^;]*\);thrower\([^;]*\) [0-9]+$}}
+
+// INNER: "function": "inner({{.*}}function-profiling.js:{{[0-9]+}}:{{[0-9]+}})"
+// INNER-NEXT: "calls": 10
+
+// THROWER: "function": "thrower({{.*}})"
+// THROWER-NEXT: "calls": 1
+
+// MAPPED: "function": "mapped({{.*}})"
+// MAPPED-NEXT: "calls": 3
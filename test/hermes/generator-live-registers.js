@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// Generators save only the registers live after each yield.
+
+print('live values');
+// CHECK-LABEL: live values
+function* live(a, b) {
+  var sum = a + b;
+  var obj = {k: 'v'};
+  var x = yield sum;
+  var y = yield x * 2;
+  yield obj.k + sum + x + y + a;
+}
+var g = live(1, 2);
+print(g.next().value, g.next(5).value, g.next(7).value, g.next().done);
+// CHECK-NEXT: 3 10 v3571 true
+
+print('loops');
+// CHECK-LABEL: loops
+function* counter(n) {
+  var total = 0;
+  for (var i = 0; i < n; ++i) {
+    var big = [i, i * i];
+    total += yield big[1];
+  }
+  return total;
+}
+g = counter(4);
+var out = [g.next().value];
+for (var r = g.next(1); !r.done; r = g.next(1))
+  out.push(r.value);
+print(out, r.value);
+// CHECK-NEXT: 0,1,4,9 4
+
+print('exceptions');
+// CHECK-LABEL: exceptions
+function* guarded(v) {
+  var before = 'b' + v;
+  try {
+    var inside = 'i' + v;
+    yield 1;
+    yield 2;
+  } catch (e) {
+    yield before + inside + e;
+  } finally {
+    yield 'f' + v;
+  }
+  return before;
+}
+g = guarded(0);
+print(g.next().value, g.throw('!').value, g.next().value, g.next().value);
+// CHECK-NEXT: 1 b0i0! f0 b0
+g = guarded(1);
+g.next();
+print(g.return('r').value, g.next().value, g.next().done);
+// CHECK-NEXT: f1 r true
+
+print('many yields');
+// CHECK-LABEL: many yields
+function* shrink() {
+  var a = {}, b = {}, c = {};
+  yield 1;
+  var s = [a, b, c].length;
+  yield s;
+  yield s + 1;
+}
+print([...shrink()]);
+// CHECK-NEXT: 1,3,4
@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -dump-property-cache-stats %s 2> %t.stats | %FileCheck --match-full-lines %s
+// RUN: %FileCheck --check-prefix=STATS %s < %t.stats
+
+// Reads of global variables are cached in global cells, which stay valid
+// after a delete has made the class of the global object uncacheable, and
+// are invalidated by deleting or reconfiguring a global property.
+
+print('global-property-cells');
+// CHECK-LABEL: global-property-cells
+
+var limit = 0;
+globalThis.temp = 1;
+// The global object is now a dictionary which can't be cached by class.
+delete globalThis.temp;
+
+function readLimit() {
+  return limit;
+}
+function readCounter() {
+  try {
+    return counter;
+  } catch (e) {
+    return e.name;
+  }
+}
+
+var sum = 0;
+for (var i = 0; i < 50; ++i) {
+  limit = i;
+  sum += readLimit();
+}
+print(sum);
+// CHECK-NEXT: 1225
+
+globalThis.counter = 1;
+var results = [readCounter(), readCounter()];
+// Adding properties keeps the slots of the others.
+globalThis.other1 = 0;
+globalThis.other2 = 0;
+results.push(readCounter());
+// Deleting the property makes the read throw.
+delete globalThis.counter;
+results.push(readCounter());
+// Adding it back may give it another slot.
+globalThis.other3 = 0;
+globalThis.counter = 2;
+results.push(readCounter(), readCounter());
+// Reconfiguring it into an accessor calls the getter.
+Object.defineProperty(globalThis, 'counter', {
+  get: function() {
+    return 'getter';
+  },
+  configurable: true,
+});
+results.push(readCounter(), readCounter());
+// And back into a data property.
+Object.defineProperty(globalThis, 'counter', {value: 3, configurable: true});
+results.push(readCounter(), readCounter());
+print(results.join());
+// CHECK-NEXT: 1,1,1,ReferenceError,2,2,getter,getter,3,3
+
+// STATS:          "function": "readLimit",
+// STATS-NEXT:     "url": "{{.*}}global-property-cells.js",
+// STATS-NEXT:     "line": 24,
+// STATS-NEXT:     "column": {{[0-9]+}},
+// STATS-NEXT:     "property": "limit",
+// STATS-NEXT:     "kind": "read",
+// STATS-NEXT:     "sites": 1,
+// STATS-NEXT:     "hits": 49,
+// STATS-NEXT:     "misses": 1,
+// STATS-NEXT:     "evictions": 0,
+// STATS-NEXT:     "state": "monomorphic"
@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -target=HBC %s | %FileCheck --match-full-lines %s
+
+// Indexed reads and writes that go directly to the storage of arrays,
+// arguments objects and typed arrays, and the cases that must not.
+
+print('indexed-access-fast-paths');
+// CHECK-LABEL: indexed-access-fast-paths
+
+function get(o, i) {
+  return o[i];
+}
+
+function put(o, i, v) {
+  o[i] = v;
+}
+
+var arr = [1, 2, 3];
+put(arr, 1, 20);
+print(get(arr, 0), get(arr, 1), get(arr, 2), get(arr, 3));
+// CHECK-NEXT: 1 20 3 undefined
+
+// Holes are looked up in the prototype chain, and filling them in goes
+// through the setters there.
+var holey = [1, , 3];
+Array.prototype[1] = 'proto';
+print(get(holey, 1));
+// CHECK-NEXT: proto
+delete Array.prototype[1];
+Object.defineProperty(Array.prototype, 1, {
+  set: function(v) { print('setter', v); },
+  configurable: true,
+});
+put(holey, 1, 2);
+// CHECK-NEXT: setter 2
+print(get(holey, 1));
+// CHECK-NEXT: undefined
+delete Array.prototype[1];
+
+// Frozen arrays can't be written.
+var frozen = Object.freeze([1, 2]);
+put(frozen, 0, 10);
+print(get(frozen, 0));
+// CHECK-NEXT: 1
+
+// Index-like named properties take the generic path.
+var withGetter = [1, 2];
+Object.defineProperty(withGetter, 0, {get: function() { return 'getter'; }});
+print(get(withGetter, 0), get(withGetter, 1));
+// CHECK-NEXT: getter 2
+
+(function() {
+  put(arguments, 0, 'a');
+  print(get(arguments, 0), get(arguments, 1), get(arguments, 2));
+})(1, 2);
+// CHECK-NEXT: a 2 undefined
+
+var i8 = new Int8Array(2);
+put(i8, 0, 200);
+put(i8, 5, 1);
+print(get(i8, 0), get(i8, 1), get(i8, 5));
+// CHECK-NEXT: -56 0 undefined
+
+var clamped = new Uint8ClampedArray(1);
+put(clamped, 0, 300);
+print(get(clamped, 0));
+// CHECK-NEXT: 255
+
+var f64 = new Float64Array(1);
+put(f64, 0, 0.5);
+print(get(f64, 0));
+// CHECK-NEXT: 0.5
+
+// Non-numbers are converted through the generic path.
+put(f64, 0, {valueOf: function() { print('valueOf'); return 1.5; }});
+// CHECK-NEXT: valueOf
+print(get(f64, 0));
+// CHECK-NEXT: 1.5
+
+// Keys that are not array indices.
+print(get(arr, 'length'), get(arr, -1), get(arr, 1.5));
+// CHECK-NEXT: 3 undefined undefined
@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// REQUIRES: jslib
+// RUN: %hermes -O -Xnative-library-functions=Array.prototype.map,String.prototype.indexOf,RegExp.prototype.@@replace,Array.prototype.nope,Nope.x %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines --check-prefix=JS %s
+
+// The builtins of the JS library can keep their native implementation.
+
+function kind(f) {
+  return /\[native code\]/.test(String(f)) ? 'native' : 'js';
+}
+
+print(
+  kind(Array.prototype.map),
+  kind(Array.prototype.filter),
+  kind(String.prototype.indexOf),
+  kind(RegExp.prototype[Symbol.replace])
+);
+// CHECK: native js native native
+// JS: js js js js
+
+print(
+  [1, 2].map(function(x) {
+    return x * 2;
+  }),
+  'abc'.indexOf('c'),
+  'aXa'.replace(/a/g, 'b')
+);
+// CHECK-NEXT: 2,4 2 bXb
+// JS-NEXT: 2,4 2 bXb
+
+var desc = Object.getOwnPropertyDescriptor(Array.prototype, 'map');
+print(desc.writable, desc.enumerable, desc.configurable);
+// CHECK-NEXT: true false true
+// JS-NEXT: true false true
@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// JSON.parse interns the keys of objects directly, and copies runs of plain
+// characters in strings at once.
+
+print('keys');
+// CHECK-LABEL: keys
+var o = JSON.parse('{"b": 1, "a": 2, "10": 3, "2": 4, "b": 5, "01": 6}');
+print(Object.keys(o).join(), o.b, o[2], o['01']);
+// CHECK-NEXT: 2,10,b,a,01 5 4 6
+var p = JSON.parse('{"__proto__": {"x": 1}, "length": 7}');
+print(Object.getPrototypeOf(p) === Object.prototype, p.__proto__.x, p.length);
+// CHECK-NEXT: true 1 7
+var e = JSON.parse('{"k\\u0065y": 1, "a\\"b": 2, "": 3, "\\u00e9t\\u00e9": 4}');
+print(e.key, e['a"b'], e[''], e['été']);
+// CHECK-NEXT: 1 2 3 4
+var rows = JSON.parse('[{"id": 1, "name": "x"}, {"id": 2, "name": "y"}, ' +
+  '{"name": "z", "id": 3}]');
+print(rows.map(function(r) { return Object.keys(r).join('+'); }).join());
+// CHECK-NEXT: id+name,id+name,name+id
+
+print('strings');
+// CHECK-LABEL: strings
+var long = 'abcdefghijklmnopqrstuvwxyz0123456789';
+var s = JSON.parse('"' + long + '\\n' + long + '\\\\' + long + '"');
+print(s.length, s.indexOf('\n'), s.indexOf('\\'), s.slice(-3));
+// CHECK-NEXT: 110 36 73 789
+print(JSON.parse('"' + long + '\\u00e9' + long.slice(0, 5) + '"').slice(34));
+// CHECK-NEXT: 89éabcde
+try {
+  JSON.parse('"' + long + '\t"');
+} catch (err) {
+  print(err.name);
+}
+// CHECK-NEXT: SyntaxError
+try {
+  JSON.parse('"' + long);
+} catch (err) {
+  print(err.name);
+}
+// CHECK-NEXT: SyntaxError
+
+print('whitespace');
+// CHECK-LABEL: whitespace
+print(JSON.stringify(JSON.parse(' \n\t {\r\n    "a" :\n\n [ 1 ,\t 2 ] }  \n')));
+// CHECK-NEXT: {"a":[1,2]}
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// JSON.stringify takes the keys of plain objects from their class, and builds
+// ASCII output until a character which isn't is written.
+
+print('shapes');
+// CHECK-LABEL: shapes
+var rows = [];
+for (var i = 0; i < 3; ++i)
+  rows.push({id: i, name: 'r' + i, 2: 'two', tags: [i, 'x']});
+print(JSON.stringify(rows));
+// CHECK-NEXT: [{"2":"two","id":0,"name":"r0","tags":[0,"x"]},{"2":"two","id":1,"name":"r1","tags":[1,"x"]},{"2":"two","id":2,"name":"r2","tags":[2,"x"]}]
+var o = {a: 1, b: 2, c: 3};
+delete o.b;
+print(JSON.stringify(o), JSON.stringify({}));
+// CHECK-NEXT: {"a":1,"c":3} {}
+var h = {a: 1, b: 2};
+Object.defineProperty(h, 'hidden', {value: 3, enumerable: false});
+Object.defineProperty(h, 'g', {
+  get: function() { return this.a * 10; },
+  enumerable: true,
+});
+print(JSON.stringify(h));
+// CHECK-NEXT: {"a":1,"b":2,"g":10}
+
+print('mutation');
+// CHECK-LABEL: mutation
+var m = {x: 1, y: 2, z: 3};
+print(JSON.stringify(m, function(k, v) {
+  if (k === 'x') {
+    delete this.y;
+    this.w = 4;
+  }
+  return v;
+}));
+// CHECK-NEXT: {"x":1,"z":3}
+print(JSON.stringify({x: 1, y: 2, z: 3}));
+// CHECK-NEXT: {"x":1,"y":2,"z":3}
+print(JSON.stringify({x: 1, y: 2, z: 3}, ['z', 'x', 'z', 5]));
+// CHECK-NEXT: {"z":3,"x":1}
+print(JSON.stringify({a: {toJSON: function() { return 'j'; }}, b: undefined}));
+// CHECK-NEXT: {"a":"j"}
+
+print('output');
+// CHECK-LABEL: output
+print(JSON.stringify({'q"k': 'tab\there', e: '\u0001\\'}));
+// CHECK-NEXT: {"q\"k":"tab\there","e":"\u0001\\"}
+var wide = JSON.stringify({ascii: 'abc', wide: 'café', after: 'x'});
+print(wide.length, wide.charCodeAt(wide.indexOf('caf') + 3));
+// CHECK-NEXT: 41 233
+print(JSON.stringify({a: [1, {b: 'Ω'}]}, null, 2));
+// CHECK-NEXT: {
+// CHECK-NEXT:   "a": [
+// CHECK-NEXT:     1,
+// CHECK-NEXT:     {
+// CHECK-NEXT:       "b": "Ω"
+// CHECK-NEXT:     }
+// CHECK-NEXT:   ]
+// CHECK-NEXT: }
+var big = [];
+for (var i = 0; i < 2000; ++i)
+  big.push({k: i});
+var s = JSON.stringify(big);
+print(s.length, s.slice(-11), JSON.parse(s)[1999].k);
+// CHECK-NEXT: 20891 {"k":1999}] 1999
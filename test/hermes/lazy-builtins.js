@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// Builtins like Map and the typed arrays are only populated when they are
+// first used, which must not be observable.
+
+print('lazy-builtins');
+// CHECK-LABEL: lazy-builtins
+
+// An instance is created before its prototype is used.
+var m = new Map([[1, 'one']]);
+print(m.get(1), m.size, m instanceof Map);
+// CHECK-NEXT: one 1 true
+print(Object.getOwnPropertyNames(Map).join());
+// CHECK-NEXT: name,length,prototype
+print(Map.name, Map.length, Map.prototype.constructor === Map);
+// CHECK-NEXT: Map 0 true
+
+// Properties keep the order in which they were always defined.
+print(Object.getOwnPropertyNames(WeakSet.prototype).join());
+// CHECK-NEXT: add,delete,has,constructor
+print(Object.getOwnPropertyNames(Set.prototype).join());
+// CHECK-NEXT: add,clear,delete,entries,forEach,has,size,values,keys,constructor
+
+// Freezing an unused builtin freezes its properties.
+Object.freeze(WeakMap.prototype);
+print(Object.isFrozen(WeakMap.prototype), typeof WeakMap.prototype.get);
+// CHECK-NEXT: true function
+WeakMap.prototype.get = null;
+print(typeof WeakMap.prototype.get);
+// CHECK-NEXT: function
+
+// The prototype of an unused typed array is populated through its instances.
+var u8 = new Uint8Array(3);
+print(u8.length, Uint8Array.BYTES_PER_ELEMENT, u8.BYTES_PER_ELEMENT);
+// CHECK-NEXT: 3 1 1
+print(Object.getPrototypeOf(Int16Array).name);
+// CHECK-NEXT: TypedArray
+print(Float64Array.from([1.5, 2]).join());
+// CHECK-NEXT: 1.5,2
+
+// A builtin removed from the global object still works.
+var DV = DataView;
+delete this.DataView;
+print(typeof this.DataView);
+// CHECK-NEXT: undefined
+var dv = new DV(new ArrayBuffer(4));
+dv.setInt16(0, -2);
+print(dv.getInt16(0), dv.byteLength);
+// CHECK-NEXT: -2 4
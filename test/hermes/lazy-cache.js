@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: rm -rf %t.cache && mkdir -p %t.cache
+// RUN: %hermes -lazy -lazy-cache=%t.cache %s | %FileCheck --match-full-lines %s
+// RUN: ls %t.cache | %FileCheck --check-prefix=CACHE %s
+// RUN: %hermes -lazy -lazy-cache=%t.cache %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -lazy -lazy-cache=%t.cache -debug-only=codeblock %s 2>&1 | %FileCheck --check-prefix=DEBUG %s
+// REQUIRES: debug_options
+
+// Functions compiled lazily are stored in the cache, and loaded from it by
+// the next run of the same source.
+
+function fib(n) {
+  if (n < 2)
+    return n;
+  return fib(n - 1) + fib(n - 2);
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+}
+
+function describe(o) {
+  var keys = [];
+  for (var k in o)
+    keys.push(k + '=' + o[k]);
+  return keys.join(',');
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+}
+
+print(fib(15));
+//CHECK: 610
+print(describe({a: 1, b: 'x'}));
+//CHECK-NEXT: a=1,b=x
+
+//CACHE: {{[0-9a-f]+}}.hbc
+//CACHE-NEXT: {{[0-9a-f]+}}.hbc
+
+//DEBUG-DAG: Loaded lazy function fib from disk
+//DEBUG-DAG: Loaded lazy function describe from disk
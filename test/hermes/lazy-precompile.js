@@ -0,0 +1,30 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -lazy -lazy-precompile -non-strict -target=HBC %s | %FileCheck --match-full-lines %s
+
+// The results don't depend on whether the background compilations finish
+// before the calls.
+
+function outer(n) {
+  function inner(x) {
+    return x * 2;
+  }
+  function unused() {
+    return 'unused';
+  }
+  var capture = function(y) { return inner(y) + n; };
+  return capture;
+}
+
+// CHECK-LABEL: main
+print("main");
+var f = outer(1);
+// CHECK-NEXT: 7
+print(f(3));
+// CHECK-NEXT: 13
+print(outer(3)(5));
@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -lazy %s | %FileCheck --match-full-lines %s
+
+// Function bodies are skipped by scanning their tokens, which has to find the
+// matching '}' without being confused by braces in other tokens.
+
+function templates(x) {
+  var s = `{${x + `}${"{"}`}}` + '}' + "{";
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+  return s;
+}
+
+function regexps(s) {
+  var re = /[}]\}\{/;
+  var n = s.length / 2 / 1;
+  if (n) { /* } */ }
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+  return re.test(s) + " " + n;
+}
+
+function ambiguous(a) {
+  // The '/' after ')' can't be told apart from a regexp without parsing.
+  if (a) /}/.test(a);
+  var b = (a) / 1;
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+  return b;
+}
+
+function outer() {
+  function inner() {
+    var o = {a: {b: 1}};
+    /* Some text to pad out the function so that it won't be eagerly
+     * compiled for being too short. Lorem ipsum dolor sit amet, consectetur
+     * adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore.
+     */
+    return o.a.b;
+  }
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+  return inner() + 1;
+}
+
+function neverCalled() {
+  var x = = 1;
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+}
+
+print(templates(1));
+// CHECK: {1}{}}{
+print(regexps("x}}{"));
+// CHECK-NEXT: true 2
+print(ambiguous(4));
+// CHECK-NEXT: 4
+print(outer());
+// CHECK-NEXT: 2
+try {
+  neverCalled();
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: SyntaxError
@@ -0,0 +1,49 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// The lexer skips long runs of plain characters a block at a time. Check
+// that the characters ending a run are found wherever they fall in a block.
+
+print("start");
+// CHECK: start
+
+var abcdefghijklmnopqrstuvwxyz_$0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ = 1;
+var abcdefghijklmnopqrstuvwxyz_$0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZé = 2;
+var abcdefghijklmnopqrstuvwxyz_$0123456789ABCDEFGHIJKLMNOPQRST = 3;
+print(abcdefghijklmnopqrstuvwxyz_$0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ,
+      abcdefghijklmnopqrstuvwxyz_$0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZé,
+      abcdefghijklmnopqrstuvwxyz_$0123456789ABCDEFGHIJKLMNOPQRST);
+// CHECK-NEXT: 1 2 3
+
+print("0123456789abcdef0123456789abcdef0123456789".length);
+// CHECK-NEXT: 42
+print('0123456789abcdef0123456789abcde"f0123456789');
+// CHECK-NEXT: 0123456789abcdef0123456789abcde"f0123456789
+print("0123456789abcdef0123456789abcdef\x41\n0123456789abcdef01234567\t|");
+// CHECK-NEXT: 0123456789abcdef0123456789abcdefA
+// CHECK-NEXT: 0123456789abcdef01234567	|
+print("0123456789abcdef0123456789abcdefé0123456789abcdef0123456789".length);
+// CHECK-NEXT: 59
+
+/* A block comment long enough to be skipped a block at a time, with a *
+ * star in it, ** and a few more ***/ print("after block comment");
+// CHECK-NEXT: after block comment
+
+var x = 1
+/* A block comment with a new line in it, so that a semicolon is inserted
+ */ ++x;
+print(x);
+// CHECK-NEXT: 2
+
+// A line comment long enough to be skipped a block at a time, é, with a tail
+print("after line comment");
+// CHECK-NEXT: after line comment
+
+                                                       print("indented");
+// CHECK-NEXT: indented
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// Literals created repeatedly are filled from values decoded once, so every
+// copy must still be independent.
+
+print('arrays');
+// CHECK-LABEL: arrays
+function mixed() {
+  return [1, 'two', true, null, 4.5, 'two', false];
+}
+var copies = [];
+for (var i = 0; i < 4; ++i)
+  copies.push(mixed());
+copies[1][0] = 'changed';
+copies[2].push('more');
+print(copies[0], copies[3]);
+// CHECK-NEXT: 1,two,true,,4.5,two,false 1,two,true,,4.5,two,false
+print(copies[1], copies[2].length, copies[0] === copies[3]);
+// CHECK-NEXT: changed,two,true,,4.5,two,false 8 false
+
+function numbers() {
+  return [3, 1, 2];
+}
+function strings() {
+  return [10, 9, 'a'];
+}
+for (var i = 0; i < 3; ++i)
+  print(numbers().sort(), strings().sort());
+// CHECK-NEXT: 1,2,3 10,9,a
+// CHECK-NEXT: 1,2,3 10,9,a
+// CHECK-NEXT: 1,2,3 10,9,a
+
+// A literal long enough to span the segments of the array storage.
+var elements = [];
+for (var i = 0; i < 5000; ++i)
+  elements.push(i % 3 ? i : "'s" + i + "'");
+var big = eval('(function() { return [' + elements.join(',') + ']; })');
+for (var i = 0; i < 3; ++i) {
+  var arr = big();
+  print(arr.length, arr[0], arr[4095], arr[4096], arr[4097], arr[4999]);
+  arr[4097] = 0;
+}
+// CHECK-NEXT: 5000 s0 s4095 4096 4097 4999
+// CHECK-NEXT: 5000 s0 s4095 4096 4097 4999
+// CHECK-NEXT: 5000 s0 s4095 4096 4097 4999
+
+print('objects');
+// CHECK-LABEL: objects
+function make() {
+  return {a: 1, b: 'two', c: true, d: null, e: 5.5, f: 'six', g: 7};
+}
+var objs = [];
+for (var i = 0; i < 4; ++i)
+  objs.push(make());
+objs[1].a = 'changed';
+objs[2].f = 6;
+delete objs[2].b;
+print(JSON.stringify(objs[0]));
+// CHECK-NEXT: {"a":1,"b":"two","c":true,"d":null,"e":5.5,"f":"six","g":7}
+print(JSON.stringify(objs[3]));
+// CHECK-NEXT: {"a":1,"b":"two","c":true,"d":null,"e":5.5,"f":"six","g":7}
+print(objs[1].a, objs[2].f, 'b' in objs[2], objs[0] === objs[3]);
+// CHECK-NEXT: changed 6 false false
+
+function small() {
+  return {x: 'x', y: 2};
+}
+for (var i = 0; i < 3; ++i) {
+  var o = small();
+  print(o.x, o.y, Object.keys(o));
+  o.x = i;
+}
+// CHECK-NEXT: x 2 x,y
+// CHECK-NEXT: x 2 x,y
+// CHECK-NEXT: x 2 x,y
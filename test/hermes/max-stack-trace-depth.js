@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -max-stack-trace-depth=3 %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines --check-prefix=CHKALL %s
+// Check that only the innermost frames are recorded in the stack trace, and
+// that function names are read from their 'name' property.
+
+function recurse(n) {
+  if (n === 0)
+    throw new Error("deep");
+  return recurse(n - 1);
+}
+
+function named() {
+  throw new TypeError("named");
+}
+Object.defineProperty(named, 'name', {value: 'renamed'});
+
+try {
+  recurse(5);
+} catch (e) {
+  print(e.stack);
+}
+// CHECK:      Error: deep
+// CHECK-NEXT:     at recurse ({{.*}})
+// CHECK-NEXT:     at recurse ({{.*}})
+// CHECK-NEXT:     at recurse ({{.*}})
+// CHECK-NEXT: TypeError: named
+// CHKALL:      Error: deep
+// CHKALL-NEXT:     at recurse ({{.*}})
+// CHKALL-NEXT:     at recurse ({{.*}})
+// CHKALL-NEXT:     at recurse ({{.*}})
+// CHKALL-NEXT:     at recurse ({{.*}})
+// CHKALL-NEXT:     at recurse ({{.*}})
+// CHKALL-NEXT:     at recurse ({{.*}})
+// CHKALL-NEXT:     at global ({{.*}})
+// CHKALL-NEXT: TypeError: named
+
+try {
+  named();
+} catch (e) {
+  print(e.stack);
+}
+// CHECK-NEXT:     at renamed ({{.*}})
+// CHECK-NEXT:     at global ({{.*}})
+// CHKALL-NEXT:     at renamed ({{.*}})
+// CHKALL-NEXT:     at global ({{.*}})
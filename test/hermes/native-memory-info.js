@@ -0,0 +1,36 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+"use strict";
+
+// The memory held outside of the JS heap is reported by category.
+
+print('native memory');
+// CHECK-LABEL: native memory
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+var points = [];
+for (var i = 0; i < 10; ++i)
+  points.push(new Point(i, i));
+
+var info = HermesInternal.getNativeMemoryInfo();
+print(Object.keys(info).join());
+// CHECK-NEXT: identifierTable,runtimeModules,codeBlocks,propertyCaches,hiddenClassTransitions,hiddenClassPropertyMaps,jitCode,bytecode,bytecodeResident
+print(Object.keys(info).every(function(k) {
+  return typeof info[k] === 'number' && info[k] >= 0;
+}));
+// CHECK-NEXT: true
+print(info.identifierTable > 0, info.runtimeModules > 0, info.codeBlocks > 0);
+// CHECK-NEXT: true true true
+print(info.propertyCaches > 0, info.hiddenClassPropertyMaps > 0);
+// CHECK-NEXT: true true
+print(info.bytecode > 0, info.bytecodeResident <= info.bytecode);
+// CHECK-NEXT: true true
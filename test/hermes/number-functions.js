@@ -407,3 +407,26 @@ print(Number.parseInt === parseInt);
 // CHECK-NEXT: true
 print(Number.parseFloat === parseFloat);
 // CHECK-NEXT: true
+
+print('decimal conversion');
+// CHECK-LABEL: decimal conversion
+print(Number('12345678901234567'), Number(' -0.000123e+2 '), 1 / Number('-0'));
+// CHECK-NEXT: 12345678901234568 -0.0123 -Infinity
+print(Number('1.'), Number('.5'), Number('+.5'), Number('007'), Number('1e'));
+// CHECK-NEXT: 1 0.5 0.5 7 NaN
+print(Number('.'), Number('+'), Number('1e5x'), Number('0x1F'), Number('-1E-3'));
+// CHECK-NEXT: NaN NaN NaN 31 -0.001
+print(Number('9007199254740993'), Number('123456789012345678901234'));
+// CHECK-NEXT: 9007199254740992 1.2345678901234569e+23
+print(Number('0.1'), Number('1e22'), Number('1e23'), Number('4.35e-30'));
+// CHECK-NEXT: 0.1 1e+22 1e+23 4.35e-30
+print(parseFloat('3.14159265358979abc'), parseFloat('-12345678.5e-3x'));
+// CHECK-NEXT: 3.14159265358979 -12345.6785
+print(parseFloat('1e+'), parseFloat('5.e2'), parseFloat('-.25'), parseFloat('+-1'));
+// CHECK-NEXT: 1 500 -0.25 NaN
+print(parseFloat('0.00000000000000000000000012345'), parseFloat('1e400'));
+// CHECK-NEXT: 1.2345e-25 Infinity
+print(parseInt('1234567890123'), parseInt('-00042abc'), parseInt('99999999999999999999'));
+// CHECK-NEXT: 1234567890123 -42 100000000000000000000
+print(parseInt('9007199254740993'), parseInt('12.5'), parseInt('0x10'), parseInt('010', 10));
+// CHECK-NEXT: 9007199254740992 12 16 10
@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Numbers are converted with an integer fast path and Grisu3, falling back to
+// dtoa, and their strings are cached.
+
+print('integers');
+// CHECK-LABEL: integers
+print(String(7), String(-7), String(2147483648), String(-2147483649));
+// CHECK-NEXT: 7 -7 2147483648 -2147483649
+print(String(9007199254740991), String(-9007199254740992));
+// CHECK-NEXT: 9007199254740991 -9007199254740992
+print(String(2 ** 53 + 2), String(2 ** 60), String(1e20), String(1e21));
+// CHECK-NEXT: 9007199254740994 1152921504606847000 100000000000000000000 1e+21
+
+print('fractions');
+// CHECK-LABEL: fractions
+print(String(0.1), String(-1.5), String(1 / 3), String(0.1 + 0.2));
+// CHECK-NEXT: 0.1 -1.5 0.3333333333333333 0.30000000000000004
+print(String(1e-6), String(1e-7), String(1.5e-7), String(123e-20));
+// CHECK-NEXT: 0.000001 1e-7 1.5e-7 1.23e-18
+print(String(5e-324), String(2.2250738585072014e-308));
+// CHECK-NEXT: 5e-324 2.2250738585072014e-308
+print(String(1.7976931348623157e308), String(1e23), String(-1e23));
+// CHECK-NEXT: 1.7976931348623157e+308 1e+23 -1e+23
+
+print('special');
+// CHECK-LABEL: special
+print(String(NaN), String(-0), String(Infinity), String(-Infinity));
+// CHECK-NEXT: NaN 0 Infinity -Infinity
+
+print('cache');
+// CHECK-LABEL: cache
+var strs = [];
+for (var i = 0; i < 1000; ++i)
+  strs.push(String(i * 0.5));
+var ok = true;
+for (var i = 0; i < 1000; ++i) {
+  if (String(i * 0.5) !== strs[i] || strs[i] !== '' + i * 0.5)
+    ok = false;
+}
+print(ok, strs[3], strs[999]);
+// CHECK-NEXT: true 1.5 499.5
+var o = {};
+for (var i = 0; i < 100; ++i)
+  o[i + 0.25] = i;
+print(o['42.25'], Object.keys(o).length, Object.keys(o)[99]);
+// CHECK-NEXT: 42 100 99.25
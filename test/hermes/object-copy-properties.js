@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Object.assign() and object spread copy plain objects straight from their
+// slots, and new empty targets take the class of the source.
+
+print('spread');
+// CHECK-LABEL: spread
+var src = {a: 1, b: 2, c: 3, d: 4, e: 5, f: 6};
+var copy = {...src};
+print(JSON.stringify(copy));
+// CHECK-NEXT: {"a":1,"b":2,"c":3,"d":4,"e":5,"f":6}
+copy.a = 10;
+copy.g = 7;
+delete copy.f;
+print(JSON.stringify(src), JSON.stringify(copy));
+// CHECK-NEXT: {"a":1,"b":2,"c":3,"d":4,"e":5,"f":6} {"a":10,"b":2,"c":3,"d":4,"e":5,"g":7}
+print(JSON.stringify({x: 0, ...src, a: 'a'}));
+// CHECK-NEXT: {"x":0,"a":"a","b":2,"c":3,"d":4,"e":5,"f":6}
+var {b, ...rest} = src;
+print(b, JSON.stringify(rest));
+// CHECK-NEXT: 2 {"a":1,"c":3,"d":4,"e":5,"f":6}
+
+print('flags');
+// CHECK-LABEL: flags
+var hidden = {a: 1, b: 2};
+Object.defineProperty(hidden, 'a', {enumerable: false});
+Object.defineProperty(hidden, 'c', {value: 3, enumerable: true});
+copy = {...hidden};
+var desc = Object.getOwnPropertyDescriptor(copy, 'c');
+print(JSON.stringify(copy), desc.writable);
+// CHECK-NEXT: {"b":2,"c":3} true
+copy = Object.assign({}, hidden);
+var desc = Object.getOwnPropertyDescriptor(copy, 'c');
+print(JSON.stringify(copy), desc.writable);
+// CHECK-NEXT: {"b":2,"c":3} true
+
+print('symbols');
+// CHECK-LABEL: symbols
+var sym = Symbol('s');
+var order = [];
+src = {};
+src[sym] = 's';
+src.x = 'x';
+var target = {
+  set x(v) {
+    order.push('x');
+  },
+};
+Object.defineProperty(target, sym, {
+  set: function(v) {
+    order.push('sym');
+  },
+});
+Object.assign(target, src);
+print(order);
+// CHECK-NEXT: x,sym
+copy = {...src};
+print(copy[sym], copy.x, Object.getOwnPropertySymbols(copy).length);
+// CHECK-NEXT: s x 1
+
+print('accessors');
+// CHECK-LABEL: accessors
+src = {
+  a: 1,
+  get b() {
+    return this.a + 1;
+  },
+};
+print(JSON.stringify({...src}), JSON.stringify(Object.assign({}, src)));
+// CHECK-NEXT: {"a":1,"b":2} {"a":1,"b":2}
+
+print('setters change the source');
+// CHECK-LABEL: setters change the source
+src = {a: 1, b: 2, c: 3};
+target = {
+  set a(v) {
+    delete src.b;
+    Object.defineProperty(src, 'c', {
+      get: function() {
+        return 'getter';
+      },
+    });
+  },
+};
+Object.assign(target, src);
+print(JSON.stringify(target), 'b' in target);
+// CHECK-NEXT: {"c":"getter"} false
+
+print('prototype');
+// CHECK-LABEL: prototype
+src = JSON.parse('{"__proto__": {"p": 1}, "q": 2}');
+copy = Object.assign({}, src);
+print(copy.p, copy.q, Object.keys(copy));
+// CHECK-NEXT: 1 2 q
+copy = {...src};
+print(copy.p, copy.q, Object.keys(copy));
+// CHECK-NEXT: undefined 2 __proto__,q
+var proto = {};
+Object.defineProperty(proto, 'r', {value: 0});
+try {
+  Object.assign(Object.create(proto), {r: 1});
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+copy = Object.assign(Object.create({s: 0}), {s: 1});
+print(copy.s, Object.keys(copy));
+// CHECK-NEXT: 1 s
+
+print('targets');
+// CHECK-LABEL: targets
+try {
+  Object.assign(Object.freeze({}), {a: 1});
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+target = {z: 0};
+Object.assign(target, {a: 1}, null, {b: 2});
+print(JSON.stringify(target));
+// CHECK-NEXT: {"z":0,"a":1,"b":2}
+target = {a: 1};
+delete target.a;
+Object.assign(target, {b: 2});
+print(JSON.stringify(target));
+// CHECK-NEXT: {"b":2}
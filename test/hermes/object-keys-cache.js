@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Object.keys() of plain objects is cached in their class, which must follow
+// every way of changing the properties of an object.
+
+function make(i) {
+  return {b: i, a: i + 1, 2: i + 2, 1: i + 3};
+}
+
+print('shape');
+// CHECK-LABEL: shape
+for (var i = 0; i < 3; ++i)
+  print(Object.keys(make(i)).join());
+// CHECK-NEXT: 1,2,b,a
+// CHECK-NEXT: 1,2,b,a
+// CHECK-NEXT: 1,2,b,a
+var keys = Object.keys(make(0));
+keys.push('z');
+print(Object.keys(make(1)).length);
+// CHECK-NEXT: 4
+print(JSON.stringify(Object.values(make(10))));
+// CHECK-NEXT: [13,12,10,11]
+print(JSON.stringify(Object.entries(make(20))[3]));
+// CHECK-NEXT: ["a",21]
+
+print('changes');
+// CHECK-LABEL: changes
+var o = make(0);
+o.c = 1;
+print(Object.keys(o).join());
+// CHECK-NEXT: 1,2,b,a,c
+Object.defineProperty(o, 'b', {enumerable: false});
+print(Object.keys(o).join());
+// CHECK-NEXT: 1,2,a,c
+delete o.a;
+print(Object.keys(o).join());
+// CHECK-NEXT: 1,2,c
+print(Object.keys(make(0)).join());
+// CHECK-NEXT: 1,2,b,a
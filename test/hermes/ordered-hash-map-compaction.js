@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Deleting most entries of a Map or Set compacts its storage. Iterators live
+// across the compaction must carry on from the same element.
+
+print('delete while iterating');
+// CHECK-LABEL: delete while iterating
+var m = new Map();
+for (var i = 0; i < 1000; ++i)
+  m.set(i, i * 2);
+var it = m.keys();
+for (var i = 0; i < 10; ++i)
+  it.next();
+for (var i = 0; i < 990; ++i)
+  if (i % 100 !== 50)
+    m.delete(i);
+var rest = [];
+for (var k of it)
+  rest.push(k);
+print(m.size, rest.join());
+// CHECK-NEXT: 20 50,150,250,350,450,550,650,750,850,950,990,991,992,993,994,995,996,997,998,999
+print(m.get(550), m.get(551), m.has(990), m.has(10));
+// CHECK-NEXT: 1100 undefined true false
+
+print('insert after compaction');
+// CHECK-LABEL: insert after compaction
+var s = new Set();
+for (var i = 0; i < 100; ++i)
+  s.add('k' + i);
+var it1 = s.values();
+var it2 = s.values();
+it2.next();
+for (var i = 0; i < 100; ++i)
+  s.delete('k' + i);
+s.add('x');
+s.add('y');
+var a = [];
+for (var v of it1)
+  a.push(v);
+print(a.join(), it2.next().value, s.size);
+// CHECK-NEXT: x,y x 2
+
+print('clear');
+// CHECK-LABEL: clear
+m = new Map([[1, 'a'], [2, 'b'], [3, 'c']]);
+it = m.entries();
+print(it.next().value);
+// CHECK-NEXT: 1,a
+m.clear();
+m.set(4, 'd');
+print(it.next().value, it.next().done, m.size);
+// CHECK-NEXT: 4,d true 1
+
+print('forEach');
+// CHECK-LABEL: forEach
+s = new Set();
+for (var i = 0; i < 64; ++i)
+  s.add(i);
+var seen = [];
+s.forEach(function(v) {
+  seen.push(v);
+  if (v === 0) {
+    for (var j = 1; j < 60; ++j)
+      s.delete(j);
+    s.add(100);
+  }
+});
+print(seen.join());
+// CHECK-NEXT: 0,60,61,62,63,100
+
+print('churn');
+// CHECK-LABEL: churn
+m = new Map();
+var sum = 0;
+for (var i = 0; i < 20000; ++i) {
+  m.set(i, i);
+  if (i >= 10)
+    m.delete(i - 10);
+}
+m.forEach(function(v) {
+  sum += v;
+});
+print(m.size, sum, m.has(19990), m.has(19989), m.get(-0) === undefined);
+// CHECK-NEXT: 10 199945 true false true
+m.set(-0, 'zero');
+print(m.get(0), [...m.keys()].pop());
+// CHECK-NEXT: zero 0
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -target=HBC %s | %FileCheck --match-full-lines %s
+
+// Property accesses that see several object layouts, through the polymorphic
+// and the megamorphic states of their cache.
+
+print('polymorphic-property-cache');
+// CHECK-LABEL: polymorphic-property-cache
+
+function getX(o) {
+  return o.x;
+}
+
+function setX(o, v) {
+  o.x = v;
+}
+
+function make(n) {
+  // Objects with the same properties in different orders have different
+  // hidden classes, and x in a different slot.
+  switch (n) {
+    case 0: return {x: 0};
+    case 1: return {a: 1, x: 1};
+    case 2: return {a: 2, b: 2, x: 2};
+    case 3: return {a: 3, b: 3, c: 3, x: 3};
+    case 4: return {a: 4, b: 4, c: 4, d: 4, x: 4};
+    default: return {a: 5, b: 5, c: 5, d: 5, e: 5, x: n};
+  }
+}
+
+function run(numShapes) {
+  var objs = [];
+  for (var i = 0; i < numShapes; ++i) {
+    objs.push(make(i));
+  }
+  var sum = 0;
+  for (var iter = 0; iter < 3; ++iter) {
+    for (var i = 0; i < objs.length; ++i) {
+      setX(objs[i], getX(objs[i]) + 1);
+      sum += getX(objs[i]);
+    }
+  }
+  return sum;
+}
+
+print(run(1));
+// CHECK-NEXT: 6
+print(run(4));
+// CHECK-NEXT: 42
+print(run(6));
+// CHECK-NEXT: 81
+gc();
+print(run(6));
+// CHECK-NEXT: 81
+
+// A polymorphic site that also reads from prototypes.
+function Proto() {}
+Proto.prototype.x = 'proto';
+var mixed = [new Proto(), {x: 'own'}, {y: 1, x: 'own2'}, new Proto()];
+var out = [];
+for (var iter = 0; iter < 2; ++iter) {
+  for (var i = 0; i < mixed.length; ++i) {
+    out.push(getX(mixed[i]));
+  }
+}
+print(out.join());
+// CHECK-NEXT: proto,own,own2,proto,proto,own,own2,proto
+Proto.prototype.x = 'changed';
+print(getX(mixed[0]), getX(mixed[1]));
+// CHECK-NEXT: changed own
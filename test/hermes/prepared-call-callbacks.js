@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Builtins that call a callback many times prepare its call frame once and
+// reuse it for every call.
+
+print('sort');
+// CHECK-LABEL: sort
+print([3, 1, 2, 5, 4].sort(function(a, b) {
+  return a - b;
+}));
+// CHECK-NEXT: 1,2,3,4,5
+var desc = function(dir, a, b) {
+  return (b - a) * dir * this.scale;
+}.bind({scale: 1}, 1);
+print([3, 1, 2].sort(desc), new Int8Array([3, -1, 2]).sort(desc));
+// CHECK-NEXT: 3,2,1 3,2,-1
+try {
+  [2, 1].sort(function() {
+    throw new Error('cmp');
+  });
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: cmp
+print([[2, 1], [4, 3]].sort(function(a, b) {
+  return a.sort(function(x, y) {
+    return x - y;
+  })[0] - b.sort()[0];
+}).join(';'));
+// CHECK-NEXT: 1,2;3,4
+
+print('maps and sets');
+// CHECK-LABEL: maps and sets
+var seen = [];
+var m = new Map([['a', 1], ['b', 2]]);
+m.forEach(function(tag, v, k, o) {
+  seen.push(tag + k + v + (o === m) + this.x);
+}.bind({x: '!'}, '>'));
+print(seen);
+// CHECK-NEXT: >a1true!,>b2true!
+seen = [];
+new Set([1, 2]).forEach(function(v, k) {
+  seen.push(v + k);
+});
+print(seen);
+// CHECK-NEXT: 2,4
+
+print('typed arrays');
+// CHECK-LABEL: typed arrays
+var ta = new Uint8Array([1, 2, 3, 4]);
+print(ta.map(function(x, i) {
+  return x * 10 + i;
+}), ta.filter(function(x) {
+  return x & 1;
+}));
+// CHECK-NEXT: 10,21,32,43 1,3
+print(ta.every(function(x) {
+  return x > 0;
+}), ta.some(function(x) {
+  return x > 4;
+}), ta.find(function(x) {
+  return x > 2;
+}), ta.findIndex(function(x) {
+  return x > 2;
+}));
+// CHECK-NEXT: true false 3 2
+print(ta.reduce(function(acc, x, i) {
+  return acc + x * i;
+}, 0), ta.reduceRight(function(acc, x) {
+  return acc + x;
+}));
+// CHECK-NEXT: 20 10
+seen = [];
+ta.forEach(function(x) {
+  seen.push(x + this.d);
+}, {d: 1});
+print(seen);
+// CHECK-NEXT: 2,3,4,5
+
+print('recursion');
+// CHECK-LABEL: recursion
+function recurse(n) {
+  return [n, n + 1].sort(recurse);
+}
+try {
+  recurse(0);
+} catch (e) {
+  print(e instanceof RangeError);
+}
+// CHECK-NEXT: true
+print(new Float64Array([2, 1]).sort(function(a, b) {
+  return a - b;
+}));
+// CHECK-NEXT: 1,2
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -dump-property-cache-stats %s 2> %t.stats | %FileCheck --match-full-lines %s
+// RUN: %FileCheck --check-prefix=STATS %s < %t.stats
+
+// Each property cache entry reports its hits and misses, with the location of
+// the access using it. Entries with the most misses come first.
+
+function getX(o) {
+  return o.x;
+}
+function getY(o) {
+  return o.y;
+}
+
+var shapes = [
+  {x: 1},
+  {a: 0, x: 1},
+  {b: 0, x: 1},
+  {c: 0, x: 1},
+  {d: 0, x: 1},
+  {e: 0, x: 1},
+];
+var sum = 0;
+for (var i = 0; i < 60; ++i) {
+  sum += getX(shapes[i % shapes.length]);
+  sum += getY({y: 1});
+}
+print(sum);
+// CHECK: 120
+
+// STATS:      [
+// STATS-NEXT:   {
+// STATS-NEXT:     "function": "getX",
+// STATS-NEXT:     "url": "{{.*}}property-cache-stats.js",
+// STATS-NEXT:     "line": 15,
+// STATS-NEXT:     "column": {{[0-9]+}},
+// STATS-NEXT:     "property": "x",
+// STATS-NEXT:     "kind": "read",
+// STATS-NEXT:     "sites": 1,
+// STATS-NEXT:     "hits": {{[0-9]+}},
+// STATS-NEXT:     "misses": {{[1-9][0-9]+}},
+// STATS-NEXT:     "evictions": {{[1-9][0-9]*}},
+// STATS-NEXT:     "state": "megamorphic"
+// STATS-NEXT:   },
+// STATS:          "function": "getY",
+// STATS-NEXT:     "url": "{{.*}}property-cache-stats.js",
+// STATS-NEXT:     "line": 18,
+// STATS-NEXT:     "column": {{[0-9]+}},
+// STATS-NEXT:     "property": "y",
+// STATS-NEXT:     "kind": "read",
+// STATS-NEXT:     "sites": 1,
+// STATS-NEXT:     "hits": 59,
+// STATS-NEXT:     "misses": 1,
+// STATS-NEXT:     "evictions": 0,
+// STATS-NEXT:     "state": "monomorphic"
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -target=HBC %s | %FileCheck --match-full-lines %s
+
+// Property loads that find the property on a prototype, and the changes to
+// the prototype chain that must make their cache entries miss.
+
+print('prototype-property-cache');
+// CHECK-LABEL: prototype-property-cache
+
+function getM(o) {
+  return o.m;
+}
+
+function callM(o) {
+  return o.m();
+}
+
+function Base() {}
+Base.prototype.m = function() { return 'base'; };
+function Derived() {}
+Derived.prototype = Object.create(Base.prototype);
+
+var d = new Derived();
+var results = [];
+for (var i = 0; i < 3; ++i) {
+  results.push(callM(d));
+}
+print(results.join());
+// CHECK-NEXT: base,base,base
+
+// Replacing the method keeps the class of the prototype.
+Base.prototype.m = function() { return 'base2'; };
+print(callM(d));
+// CHECK-NEXT: base2
+
+// Shadowing the method on the intermediate prototype.
+Derived.prototype.m = function() { return 'derived'; };
+print(callM(d));
+// CHECK-NEXT: derived
+
+// Shadowing the method on the receiver.
+var own = new Derived();
+print(callM(own));
+// CHECK-NEXT: derived
+own.m = function() { return 'own'; };
+print(callM(own));
+// CHECK-NEXT: own
+
+// Deleting the method from the prototype.
+var e = new Derived();
+print(callM(e));
+// CHECK-NEXT: derived
+delete Derived.prototype.m;
+print(callM(e));
+// CHECK-NEXT: base2
+
+// Prototypes with the same class hold different values.
+var p1 = {m: 1};
+var p2 = {m: 2};
+var o1 = Object.create(p1);
+var o2 = Object.create(p2);
+print(getM(o1), getM(o2), getM(o1), getM(o2));
+// CHECK-NEXT: 1 2 1 2
+Object.setPrototypeOf(o1, p2);
+print(getM(o1));
+// CHECK-NEXT: 2
+Object.setPrototypeOf(o1, {});
+print(getM(o1));
+// CHECK-NEXT: undefined
+
+// A method of Object.prototype.
+var plain = {a: 1};
+print(plain.toString(), plain.toString());
+// CHECK-NEXT: [object Object] [object Object]
+plain.toString = function() { return 'mine'; };
+print(plain.toString());
+// CHECK-NEXT: mine
+
+// A dictionary receiver looks itself up, but still finds the prototype.
+var dict = Object.create(p1);
+for (var i = 0; i < 100; ++i) {
+  dict['p' + i] = i;
+}
+print(getM(dict), getM(dict));
+// CHECK-NEXT: 1 1
+dict.m = 'dict';
+print(getM(dict));
+// CHECK-NEXT: dict
+
+// A chain deeper than the cache follows.
+var deep = {m: 'deep'};
+for (var i = 0; i < 5; ++i) {
+  deep = Object.create(deep);
+}
+print(getM(deep), getM(deep));
+// CHECK-NEXT: deep deep
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -regexp-cache-size=2 %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -regexp-cache-size=0 %s | %FileCheck --match-full-lines %s
+
+// RegExps constructed from the same pattern and flags share their compiled
+// bytecode, but nothing else.
+
+print('reuse');
+// CHECK-LABEL: reuse
+var count = 0;
+for (var i = 0; i < 100; ++i) {
+  var re = new RegExp('a(b+)c', 'g');
+  if (re.exec('xabbc abc')[1] === 'bb' && re.lastIndex === 5)
+    ++count;
+}
+print(count);
+// CHECK-NEXT: 100
+var r1 = new RegExp('b', 'g');
+var r2 = new RegExp('b', 'g');
+r1.exec('abcb');
+print(r1.lastIndex, r2.lastIndex, r1 !== r2, r1.source, r2.flags);
+// CHECK-NEXT: 2 0 true b g
+
+print('flags');
+// CHECK-LABEL: flags
+var patterns = ['x.y', '^x', 'X', '^Y$', '(?:'];
+var flags = ['', 'i', 'm', 'im', 'y'];
+var results = [];
+for (var round = 0; round < 3; ++round) {
+  var line = [];
+  for (var p = 0; p < patterns.length; ++p) {
+    for (var f = 0; f < flags.length; ++f) {
+      var re;
+      try {
+        re = new RegExp(patterns[p], flags[f]);
+      } catch (e) {
+        line.push('E');
+        continue;
+      }
+      line.push(re.test('a\nx\ny\nxzy') ? 1 : 0);
+    }
+  }
+  results.push(line.join(''));
+}
+print(results[0]);
+// CHECK-NEXT: 11110001100101000010EEEEE
+print(results[0] === results[1] && results[1] === results[2]);
+// CHECK-NEXT: true
+
+print('errors');
+// CHECK-LABEL: errors
+for (var i = 0; i < 2; ++i) {
+  try {
+    new RegExp('a(', '');
+  } catch (e) {
+    print(e.name);
+  }
+}
+// CHECK-NEXT: SyntaxError
+// CHECK-NEXT: SyntaxError
@@ -0,0 +1,49 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Regexes which backtrack exponentially run in linear time once they exceed
+// their backtracking budget, with the same results.
+
+print('nested');
+// CHECK-LABEL: nested
+var as = 'a'.repeat(100000);
+print(/(a+)+b/.test(as));
+// CHECK-NEXT: false
+print(/(a+)+b/.exec('a'.repeat(30) + 'b')[1].length);
+// CHECK-NEXT: 30
+var m = /(x+x+)+y/.exec('x'.repeat(5000) + 'zxxxy');
+print(m.index, m[0], m[1]);
+// CHECK-NEXT: 5001 xxxy xxx
+
+print('words');
+// CHECK-LABEL: words
+var words = 'hello world '.repeat(3) + 'again!';
+print(/^(\w+\s?)*$/.test(words));
+// CHECK-NEXT: false
+print(/^(\w+\s?)*$/.exec(words.slice(0, -1))[1]);
+// CHECK-NEXT: again
+
+print('alternation');
+// CHECK-LABEL: alternation
+print(/(a|aa)+c/.test('a'.repeat(60)));
+// CHECK-NEXT: false
+m = /(a|aa)+c/.exec('a'.repeat(61) + 'c');
+print(m.index, m[0].length, m[1]);
+// CHECK-NEXT: 0 62 a
+
+print('sticky');
+// CHECK-LABEL: sticky
+var re = /(?:a|b)*c/y;
+re.lastIndex = 1;
+print(re.test('a'.repeat(50000)), re.lastIndex);
+// CHECK-NEXT: false 0
+var s = 'b' + 'a'.repeat(50000) + 'c';
+re.lastIndex = 1;
+print(re.test(s), re.lastIndex);
+// CHECK-NEXT: true 50002
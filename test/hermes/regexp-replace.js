@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// RegExps with the builtin exec are replaced from their match ranges,
+// without the result arrays of exec.
+
+print('plain');
+// CHECK-LABEL: plain
+print('a-b-c'.replace(/-/g, '+'));
+// CHECK-NEXT: a+b+c
+print('a-b-c'.replace(/-/, '+'));
+// CHECK-NEXT: a+b-c
+print('abc'.replace(/x/g, '+'));
+// CHECK-NEXT: abc
+print('[' + 'aaa'.replace(/a/g, '') + ']');
+// CHECK-NEXT: []
+print('abc'.replace(/(?:)/g, '-'));
+// CHECK-NEXT: -a-b-c-
+print('abc'.replace(/b*/g, '-'));
+// CHECK-NEXT: -a--c-
+print('xሴyሴ'.replace(/ሴ/g, 'z'));
+// CHECK-NEXT: xzyz
+print('xaya'.replace(/a/g, 'AB').length);
+// CHECK-NEXT: 6
+print(escape('😀'.replace(/(?:)/gu, '-')));
+// CHECK-NEXT: -%uD83D%uDE00-
+print(escape('😀'.replace(/(?:)/g, '-')));
+// CHECK-NEXT: -%uD83D-%uDE00-
+
+print('substitutions');
+// CHECK-LABEL: substitutions
+print('john smith'.replace(/(\w+)\s(\w+)/, '$2, $1'));
+// CHECK-NEXT: smith, john
+print('abc'.replace(/b/g, "[$`|$&|$']"));
+// CHECK-NEXT: a[a|b|c]c
+print('a1b2'.replace(/(\d)|x/g, '<$1$$>'));
+// CHECK-NEXT: a<1$>b<2$>
+print('ab'.replace(/(x)?b/g, '[$1]'));
+// CHECK-NEXT: a[]
+
+print('function');
+// CHECK-LABEL: function
+print('a1b22'.replace(/(\d)(\d)?/g, function(m, p1, p2, pos, s) {
+  return '[' + m + ',' + p1 + ',' + p2 + ',' + pos + ',' + s + ']';
+}));
+// CHECK-NEXT: a[1,1,undefined,1,a1b22]b[22,2,2,3,a1b22]
+var re = /a/g;
+var seen = [];
+print('aaa'.replace(re, function(m, pos) {
+  seen.push(re.lastIndex);
+  return pos;
+}), seen);
+// CHECK-NEXT: 012 0,0,0
+
+print('lastIndex');
+// CHECK-LABEL: lastIndex
+re = /a/y;
+re.lastIndex = 1;
+print('aaba'.replace(re, 'x'), re.lastIndex);
+// CHECK-NEXT: axba 2
+print('aaba'.replace(re, 'x'), re.lastIndex);
+// CHECK-NEXT: aaba 0
+re = /a/;
+re.lastIndex = 3;
+print('aaba'.replace(re, 'x'), re.lastIndex);
+// CHECK-NEXT: xaba 3
+re = /a/g;
+re.lastIndex = 3;
+print('aaba'.replace(re, 'x'), re.lastIndex);
+// CHECK-NEXT: xxbx 0
+
+print('custom exec');
+// CHECK-LABEL: custom exec
+re = /a/g;
+var calls = 0;
+re.exec = function(s) {
+  ++calls;
+  return RegExp.prototype.exec.call(this, s);
+};
+print('aba'.replace(re, 'x'), calls);
+// CHECK-NEXT: xbx 3
+re = /a/;
+Object.defineProperty(re, 'exec', {
+  get: function() {
+    ++calls;
+    return RegExp.prototype.exec;
+  },
+});
+print('aba'.replace(re, 'x'), calls);
+// CHECK-NEXT: xba 4
+
+print('split');
+// CHECK-LABEL: split
+print('a1b2c'.split(/(\d)/).join('|'));
+// CHECK-NEXT: a|1|b|2|c
+print('a1b'.split(/(\d)|(x)/).join('|'));
+// CHECK-NEXT: a|1||b
+
+print('string pattern');
+// CHECK-LABEL: string pattern
+print('a-b-c'.replace('-', '+'));
+// CHECK-NEXT: a+b-c
+print('a-b-c'.replace('-', '[$&$$]'));
+// CHECK-NEXT: a[-$]b-c
+print('a-ሴ'.replace('-', '+').length, 'a-b'.replace('-', 'ሴ').length);
+// CHECK-NEXT: 3 3
+print('abc'.replace('c', function(m, pos) { return pos; }));
+// CHECK-NEXT: ab2
@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Searches skip the locations where a regex can't start matching, by its
+// literal prefix or the set of its first characters.
+
+var pad = Array(5000).join('x');
+var wide = Array(5000).join('é');
+
+print('prefix');
+// CHECK-LABEL: prefix
+print(/hello/.exec(pad + 'hell hello').index);
+// CHECK-NEXT: 5004
+print(/h(el)lo/.exec(wide + 'hello')[1], /hello/.test(pad + 'hell'));
+// CHECK-NEXT: el false
+print((pad + 'abab' + wide + 'abab').replace(/ab/g, '-').length);
+// CHECK-NEXT: 10002
+print(/ét/.exec(pad + 'éét').index);
+// CHECK-NEXT: 5000
+print(/HELLO/i.exec(pad + 'hello').index, /aa+b/.exec('aaaab').index);
+// CHECK-NEXT: 4999 0
+
+print('first chars');
+// CHECK-LABEL: first chars
+print(/[0-9]+/.exec(pad + 'ab123c')[0], /\d\w/.exec(wide + '7_').index);
+// CHECK-NEXT: 123 4999
+print(/[a-c]x/.exec(pad + 'bx').index, /[^x]/.exec(pad + 'y').index);
+// CHECK-NEXT: 4999 4999
+print(/\s+/.exec(pad + '  ').index, /[A-Z]/i.exec(pad + 'q').index);
+// CHECK-NEXT: 4999 0
+
+print('sticky and unicode');
+// CHECK-LABEL: sticky and unicode
+var sticky = /b/y;
+sticky.lastIndex = 1;
+print(sticky.test('abab'), sticky.lastIndex, sticky.test('abab'));
+// CHECK-NEXT: true 2 false
+var emoji = '😀';
+print(/a/u.exec(emoji + emoji + 'a').index, /\ude00/u.test(emoji));
+// CHECK-NEXT: 4 false
+var g = /o/g;
+var found = [];
+while (g.exec(pad + 'foo'))
+  found.push(g.lastIndex);
+print(found.join());
+// CHECK-NEXT: 5001,5002
@@ -0,0 +1,27 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -sample-profiling -sample-profiling-histograms %s 2> %t.trace | %FileCheck --match-full-lines %s
+// RUN: %FileCheck --check-prefix=HISTOGRAMS %s < %t.trace
+
+// Samples are counted by the opcode or builtin running in the leaf frame.
+
+function spin(ms) {
+  var end = Date.now() + ms;
+  var n = 0;
+  while (Date.now() < end)
+    ++n;
+  return n > 0;
+}
+
+print(spin(300));
+// CHECK: true
+
+// HISTOGRAMS: Sampled opcodes: {{[0-9]+}} samples
+// HISTOGRAMS-NEXT: {{ *[0-9]+ +[0-9.]+% [A-Za-z()]+$}}
+// HISTOGRAMS: Sampled builtins: {{[0-9]+}} samples
+// HISTOGRAMS: {{ *[0-9]+ +[0-9.]+% dateNow$}}
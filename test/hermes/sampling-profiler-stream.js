@@ -0,0 +1,29 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -sample-profiling -sample-profiling-stream-nodes=8 %s 2> %t.stacks | %FileCheck --match-full-lines %s
+// RUN: %FileCheck --check-prefix=STACKS %s < %t.stacks
+
+// Streamed samples are aggregated into a tiny call tree, which has to be
+// flushed many times over while the loop runs.
+
+function spin(ms) {
+  var end = Date.now() + ms;
+  var n = 0;
+  while (Date.now() < end)
+    ++n;
+  return n > 0;
+}
+
+function outer() {
+  return spin(300);
+}
+
+print(outer());
+// CHECK: true
+
+// STACKS: {{^global\(.*;outer\(.*;spin\(.* [0-9]+$}}
@@ -299,6 +299,10 @@ print('A\u180e\u03a3\u180e'.toLowerCase() === 'a\u180e\u03c2\u180e');
 // CHECK-NEXT: true
 print('A\u180e\u03a3\u180eB'.toLowerCase() === 'a\u180e\u03c3\u180eb');
 // CHECK-NEXT: true
+print('The Quick Brown Fox, 0123456789 XYZ!'.toLowerCase());
+// CHECK-NEXT: the quick brown fox, 0123456789 xyz!
+print('ABCDEFGHIJKLMNOPQRSTUVWXYZ@[`{'.toLowerCase());
+// CHECK-NEXT: abcdefghijklmnopqrstuvwxyz@[`{
 
 print('toLocaleLowerCase');
 // CHECK-LABEL: toLocaleLowerCase
@@ -340,6 +344,10 @@ print(result.length);
 // CHECK-NEXT: 200
 print(Array.prototype.every.call(result, function(c) {return c === 'S';}));
 // CHECK-NEXT: true
+print('The Quick Brown Fox, 0123456789 xyz!'.toUpperCase());
+// CHECK-NEXT: THE QUICK BROWN FOX, 0123456789 XYZ!
+print('abcdefghijklmnopqrstuvwxyz@[`{'.toUpperCase());
+// CHECK-NEXT: ABCDEFGHIJKLMNOPQRSTUVWXYZ@[`{
 
 print('toLocaleUpperCase');
 // CHECK-LABEL: toLocaleUpperCase
@@ -553,6 +561,15 @@ print('\u212B'.localeCompare('A\u030A')); // Angstrom sign vs A + O-ring
 // CHECK-NEXT: 0
 print('S\u0323\u0307'.localeCompare('S\u0307\u0323')); // diacritic ordering
 // CHECK-NEXT: 0
+print('a'.localeCompare('A'), 'B'.localeCompare('a'));
+// CHECK-NEXT: -1 1
+print('abc'.localeCompare('ab'));
+// CHECK-NEXT: 1
+print('a b'.localeCompare('ab'), 'a\u0001b'.localeCompare('ab'));
+// CHECK-NEXT: -1 0
+var words = ['banana', 'Apple', 'apple', 'cherry', 'a', 'A', '_x', '10', '9'];
+print(words.sort(function(x, y) {return x.localeCompare(y);}).join());
+// CHECK-NEXT: _x,10,9,a,A,apple,Apple,banana,cherry
 
 print('match');
 // CHECK-LABEL: match
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Searches scan a vector of characters at a time, so check matches at every
+// position around the vector boundaries, in ASCII and UTF-16 strings.
+
+function naiveIndexOf(s, t, from) {
+  for (var i = Math.max(from, 0); i + t.length <= s.length; ++i) {
+    if (s.substr(i, t.length) === t)
+      return i;
+  }
+  return -1;
+}
+
+function naiveLastIndexOf(s, t, from) {
+  for (var i = Math.min(from, s.length - t.length); i >= 0; --i) {
+    if (s.substr(i, t.length) === t)
+      return i;
+  }
+  return -1;
+}
+
+function check(s, t) {
+  var errors = 0;
+  for (var from = 0; from <= s.length; from += 7) {
+    if (s.indexOf(t, from) !== naiveIndexOf(s, t, from))
+      ++errors;
+    if (s.lastIndexOf(t, from) !== naiveLastIndexOf(s, t, from))
+      ++errors;
+    if (s.includes(t, from) !== (naiveIndexOf(s, t, from) >= 0))
+      ++errors;
+  }
+  return errors;
+}
+
+function run(filler, needles) {
+  var errors = 0;
+  for (var len = 0; len < 40; ++len) {
+    var base = filler.repeat(len);
+    for (var n = 0; n < needles.length; ++n) {
+      var t = needles[n];
+      for (var pos = 0; pos <= len; pos += 9) {
+        errors += check(base.slice(0, pos) + t + base.slice(pos), t);
+        errors += check(base.slice(0, pos) + t + base.slice(pos) + t, t);
+      }
+      errors += check(base, t);
+    }
+  }
+  return errors;
+}
+
+print('ascii');
+// CHECK-LABEL: ascii
+print(run('a', ['b', 'ab', 'ba', 'aab', 'bcdefghijklmnopqrstuvwxyz', '']));
+// CHECK-NEXT: 0
+
+print('utf16');
+// CHECK-LABEL: utf16
+print(run('ā', ['b', 'Ă', 'aā', 'ābā', '']));
+// CHECK-NEXT: 0
+
+print('mixed');
+// CHECK-LABEL: mixed
+print(run('a', ['ā', 'aā', 'baĀ']));
+// CHECK-NEXT: 0
+print(run('āx', ['x', 'xy', 'yā']));
+// CHECK-NEXT: 0
+
+print('equality');
+// CHECK-LABEL: equality
+var ascii = 'abcdefghijklmnopqrstuvwxyz0123456789';
+var utf16 = ('ā' + ascii).slice(1);
+print(ascii === utf16, ascii.startsWith(utf16), (ascii + '!').endsWith(utf16));
+// CHECK-NEXT: true true false
+print((utf16 + 'z').endsWith(ascii.slice(3) + 'z'), utf16 === ascii + 'a');
+// CHECK-NEXT: true false
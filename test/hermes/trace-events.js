@@ -0,0 +1,31 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -trace-events=%t.json %s | %FileCheck --match-full-lines %s
+// RUN: %FileCheck --check-prefix=TRACE %s < %t.json
+// RUN: %hermes -O -trace-events=%t.gc.json -trace-event-categories=gc %s
+// RUN: %FileCheck --check-prefix=GC %s < %t.gc.json
+
+// The events of the enabled categories are written in the Chrome trace event
+// format, with their arguments.
+
+var re = new RegExp('a+b', 'g');
+print(re.test('caab'));
+// CHECK: true
+gc();
+print('done');
+// CHECK-NEXT: done
+
+// TRACE: {"traceEvents":[
+// TRACE-DAG: "name":"regExpCompile","cat":"compile","ph":"X"
+// TRACE-DAG: "args":{"patternLength":3}
+// TRACE-DAG: "name":"collection","cat":"gc","ph":"X"
+// TRACE-DAG: "name":"runBytecode","cat":"execution","ph":"X"
+
+// GC-NOT: "cat":"compile"
+// GC: "cat":"gc"
+// GC-NOT: "cat":"execution"
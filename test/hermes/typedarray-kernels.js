@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// The TypedArray methods which work directly on the buffer must give the
+// same results as converting every element to a number.
+
+print('indexOf');
+// CHECK-LABEL: indexOf
+var big = new Int16Array(100);
+big[3] = 7;
+big[70] = 7;
+big[99] = -300;
+print(big.indexOf(7), big.indexOf(7, 4), big.lastIndexOf(7),
+  big.lastIndexOf(7, 69));
+// CHECK-NEXT: 3 70 70 3
+print(big.indexOf(-300), big.indexOf(7.5), big.indexOf(65536 + 7),
+  big.includes(-0));
+// CHECK-NEXT: 99 -1 -1 true
+var u8 = new Uint8Array([1, 255, 3, 255]);
+print(u8.indexOf(255), u8.indexOf(-1), u8.lastIndexOf(255), u8.includes(256));
+// CHECK-NEXT: 1 -1 3 false
+var f = new Float32Array([0.5, NaN, -0, 1.1, Infinity]);
+print(f.indexOf(NaN), f.includes(NaN), f.indexOf(0), f.indexOf(1.1));
+// CHECK-NEXT: -1 true 2 -1
+print(f.indexOf(Math.fround(1.1)), f.indexOf(Infinity), f.indexOf(1e300));
+// CHECK-NEXT: 3 4 -1
+var u32 = new Uint32Array([4294967295, 0]);
+print(u32.indexOf(-1), u32.indexOf(4294967295), u32.lastIndexOf(0, -1));
+// CHECK-NEXT: -1 0 1
+print(new Int8Array(40).lastIndexOf(0, -41), new Int8Array(4).indexOf(0, 4));
+// CHECK-NEXT: -1 -1
+
+print('copyWithin');
+// CHECK-LABEL: copyWithin
+var c = new Int32Array([1, 2, 3, 4, 5, 6, 7, 8]);
+print(c.copyWithin(2, 0, 5));
+// CHECK-NEXT: 1,2,1,2,3,4,5,8
+print(c.copyWithin(0, 3));
+// CHECK-NEXT: 2,3,4,5,8,4,5,8
+print(new Float64Array([1, 2, 3]).copyWithin(-1, 0));
+// CHECK-NEXT: 1,2,1
+
+print('reverse');
+// CHECK-LABEL: reverse
+print(new Uint16Array([1, 2, 3, 4, 5]).reverse());
+// CHECK-NEXT: 5,4,3,2,1
+print(new Float32Array([0.5, -2]).reverse(), new Int8Array(0).reverse().length);
+// CHECK-NEXT: -2,0.5 0
+
+print('set');
+// CHECK-LABEL: set
+var d = new Uint8ClampedArray(5);
+d.set(new Float64Array([-5, 1.5, 300, NaN]), 1);
+print(d);
+// CHECK-NEXT: 0,0,2,255,0
+var i8 = new Int8Array(3);
+i8.set(new Uint16Array([255, 128, 65535]));
+print(i8);
+// CHECK-NEXT: -1,-128,-1
+var f32 = new Float32Array(2);
+f32.set(new Int32Array([16777217, -3]));
+print(f32);
+// CHECK-NEXT: 16777216,-3
+
+print('fill');
+// CHECK-LABEL: fill
+print(new Int8Array(5).fill(-3, 1, 4), new Uint8Array(3).fill(257));
+// CHECK-NEXT: 0,-3,-3,-3,0 1,1,1
@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -jit -jit-background -jit-call-threshold=1 \
+RUN:     -jit-loop-threshold=100 -jit-crash-on-error %s \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// The results don't depend on when the background compilations finish.
+
+function add(a, b) {
+  return a + b;
+}
+
+function calls(n) {
+  var res = 0;
+  for (var i = 0; i < n; ++i)
+    res = add(res, i);
+  return res;
+}
+print(calls(100000));
+// CHECK: 4999950000
+
+function loop(n) {
+  var res = 0;
+  for (var i = 0; i < n; ++i)
+    res += i % 7;
+  return res;
+}
+print(loop(100000));
+// CHECK-NEXT: 299995
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -jit -jit-call-threshold=2 -jit-crash-on-error %s \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// Calls from compiled code go straight to compiled callees, and through the
+// runtime to everything else.
+
+function add(a, b) {
+  return a + b;
+}
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+function thrower(x) {
+  if (x > 5)
+    throw new Error("too big: " + x);
+  return x;
+}
+
+function run(f, n) {
+  var res = 0;
+  for (var i = 0; i < n; ++i)
+    res += f(i, 1);
+  return res;
+}
+
+// The callee is interpreted on the first calls, then compiled.
+print(run(add, 10));
+// CHECK: 55
+
+// Another callee at the same call site.
+print(run(function(a, b) { return a * b; }, 10));
+// CHECK-NEXT: 45
+
+// Builtins and bound functions.
+print(run(Math.max, 10));
+// CHECK-NEXT: 46
+print(run(add.bind(null, 100), 10));
+// CHECK-NEXT: 1045
+
+function construct(n) {
+  var res = 0;
+  for (var i = 0; i < n; ++i) {
+    var p = new Point(i, 2);
+    res += p.x * p.y;
+  }
+  return res;
+}
+print(construct(10));
+// CHECK-NEXT: 90
+
+function catcher(n) {
+  try {
+    return run(thrower, n);
+  } catch (e) {
+    return e.message;
+  }
+}
+print(catcher(5));
+// CHECK-NEXT: 10
+print(catcher(10));
+// CHECK-NEXT: too big: 6
+
+function notCallable() {
+  try {
+    run(undefined, 1);
+  } catch (e) {
+    return e.constructor.name;
+  }
+}
+print(notCallable());
+// CHECK-NEXT: TypeError
@@ -6,7 +6,7 @@
  */
 
 /*
-RUN: %hermes -O -jit %s
+RUN: %hermes -O -jit -jit-call-threshold=0 %s
 REQUIRES: jit
 */
 
@@ -0,0 +1,43 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -jit -jit-call-threshold=1 -jit-code-budget=1 \
+RUN:     -jit-crash-on-error -gc-print-stats %s 2>&1 \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// With a budget smaller than any function, every compiled function that is
+// not running is evicted and compiled again once it gets hot again.
+
+function add(a, b) {
+  return a + b;
+}
+
+function mul(a, b) {
+  return a * b;
+}
+
+function calls(n) {
+  var res = 0;
+  for (var i = 0; i < n; ++i)
+    res = add(res, mul(i, 2));
+  return res;
+}
+print(calls(1000));
+// CHECK: 999000
+print(calls(1000));
+// CHECK-NEXT: 999000
+
+// CHECK: JIT stats:
+// CHECK-NEXT: {
+// CHECK-NEXT: 	"codeBudget": 1,
+// CHECK-NEXT: 	"codeBytesUsed": {{[0-9]+}},
+// CHECK-NEXT: 	"codeBytesFreed": {{[1-9][0-9]*}},
+// CHECK-NEXT: 	"numEvicted": {{[1-9][0-9]*}}
+// CHECK-NEXT: }
@@ -0,0 +1,35 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -jit -jit-call-threshold=3 -jit-crash-on-error %s \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// The DataView instructions in compiled code, with and without the fast path.
+
+function roundTrip(view, i, v, le) {
+  view.setInt16(i, v, le);
+  view.setFloat64(i + 2, v);
+  return view.getInt16(i, le) + ' ' + view.getFloat64(i + 2);
+}
+
+var view = new DataView(new ArrayBuffer(16));
+for (var i = 0; i < 3; ++i)
+  roundTrip(view, i, i, true);
+
+print(roundTrip(view, 0, -3, true), roundTrip(view, 1, 2.5, false));
+// CHECK: -3 -3 2 2.5
+print(roundTrip(view, '0', {valueOf: () => 7}));
+// CHECK-NEXT: 7 7
+try {
+  roundTrip(view, 10, 1);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: RangeError
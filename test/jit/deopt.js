@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -jit -jit-crash-on-error %s \
+RUN:     | %FileCheck --match-full-lines %s
+RUN: %hermes -O -jit -jit-loop-threshold=100 -jit-crash-on-error %s \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit, debugger
+*/
+
+// With the debugger compiled in, native code leaves a function at its debugger
+// statement and the interpreter runs the rest of it in the same frame.
+
+function sum(n) {
+  var res = 0;
+  for (var i = 0; i < n; ++i)
+    res += i;
+  debugger;
+  for (var i = 0; i < n; ++i)
+    res += i;
+  return res;
+}
+print(sum(1000));
+// CHECK: 999000
+
+function caught(x) {
+  var log = "a";
+  debugger;
+  try {
+    log += "b";
+    throw x + 1;
+  } catch (e) {
+    log += e;
+  }
+  return log;
+}
+print(caught(1));
+// CHECK-NEXT: ab2
+
+function uncaught(x) {
+  debugger;
+  throw new Error("thrown after " + x);
+}
+try {
+  uncaught("deopt");
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: thrown after deopt
+
+function outer(n) {
+  var res = 0;
+  for (var i = 0; i < n; ++i)
+    res += sum(i);
+  return res;
+}
+print(outer(100));
+// CHECK-NEXT: 323400
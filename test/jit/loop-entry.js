@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -jit -jit-loop-threshold=100 -jit-crash-on-error %s \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// Functions that are only called once, but continue their hot loops in
+// native code.
+
+function sum(n) {
+  var res = 0;
+  for (var i = 0; i < n; ++i)
+    res += i;
+  return res;
+}
+print(sum(10000));
+// CHECK: 49995000
+
+function nested(n) {
+  var res = 0;
+  for (var i = 0; i < n; ++i) {
+    for (var j = 0; j < n; ++j)
+      res += i * j;
+  }
+  return res + ' ' + i + ' ' + j;
+}
+print(nested(100));
+// CHECK-NEXT: 24502500 100 100
+
+function throwsFromLoop(n) {
+  for (var i = 0; ; ++i) {
+    if (i === n)
+      throw new Error('done at ' + i);
+  }
+}
+try {
+  throwsFromLoop(1000);
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: done at 1000
+
+function catchesInLoop(n) {
+  var caught = 0;
+  for (var i = 0; i < n; ++i) {
+    try {
+      if (i % 10 === 0)
+        throw i;
+    } catch (e) {
+      caught += e;
+    }
+  }
+  return caught;
+}
+print(catchesInLoop(1000));
+// CHECK-NEXT: 49500
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -fstatic-builtins -jit -jit-call-threshold=3 \
+RUN:     -jit-crash-on-error %s \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// The Math instructions emitted with static builtins, compiled both after the
+// interpreter only saw numbers and after it saw other operands.
+
+function numbers(x, y) {
+  return [
+    Math.abs(x),
+    Math.floor(x),
+    Math.ceil(x),
+    Math.sqrt(y),
+    Math.min(x, y),
+    Math.max(x, y),
+  ].join(' ');
+}
+
+function others(x, y) {
+  return [
+    Math.abs(x),
+    Math.floor(x),
+    Math.ceil(x),
+    Math.sqrt(y),
+    Math.min(x, y),
+    Math.max(x, y),
+  ].join(' ');
+}
+
+function zeros(x, y) {
+  return [1 / Math.min(x, y), 1 / Math.max(x, y), 1 / Math.abs(x)].join(' ');
+}
+
+for (var i = 0; i < 3; ++i) {
+  numbers(i, i);
+  zeros(i, i);
+  others('-1.5', '4');
+}
+
+print(numbers(-2.5, 9));
+// CHECK: 2.5 -3 -2 3 -2.5 9
+print(numbers('-2.5', '9'));
+// CHECK-NEXT: 2.5 -3 -2 3 -2.5 9
+print(numbers(NaN, -1));
+// CHECK-NEXT: NaN NaN NaN NaN NaN NaN
+print(others(-2.5, 9));
+// CHECK-NEXT: 2.5 -3 -2 3 -2.5 9
+print(others({valueOf: function() { return 7.5; }}, null));
+// CHECK-NEXT: 7.5 7 8 0 0 7.5
+print(zeros(-0, 0), zeros(0, -0));
+// CHECK-NEXT: -Infinity Infinity Infinity -Infinity Infinity Infinity
@@ -0,0 +1,32 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: rm -rf %t.cache && mkdir -p %t.cache
+RUN: %hermes -O -emit-binary -out %t.hbc %s
+RUN: %hermes -jit -jit-profile-cache=%t.cache -jit-crash-on-error %t.hbc \
+RUN:     | %FileCheck --match-full-lines %s
+RUN: ls %t.cache | %FileCheck --match-full-lines --check-prefix=CACHE %s
+RUN: %hermes -dump-jitcode -jit-call-threshold=1000000 \
+RUN:     -jit-profile-cache=%t.cache -jit-crash-on-error %t.hbc \
+RUN:     | %FileCheck --check-prefix=WARM %s
+REQUIRES: jit
+*/
+
+// The second run compiles fib as soon as the bytecode is loaded, since the
+// first one found it hot, even though it never gets hot enough by itself.
+
+function fib(n) {
+  return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+print(fib(20));
+// CHECK: 6765
+
+// CACHE: {{[0-9a-f]+}}.jitprofile
+
+// WARM: Compiled Code of FunctionID: {{[0-9]+}}
+// WARM: 6765
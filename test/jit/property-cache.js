@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -jit -jit-call-threshold=1 -jit-crash-on-error %s \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// Property accesses in compiled code check the cache inline, and must fall
+// back to the shared helper on every kind of miss.
+
+function getX(o) {
+  return o.x;
+}
+function setX(o, v) {
+  o.x = v;
+}
+
+var a = {x: 1};
+var b = {y: 2, x: 3};
+var c = {p0: 0, p1: 1, p2: 2, p3: 3, p4: 4, x: 5};
+var res = [];
+for (var i = 0; i < 3; ++i) {
+  res.push(getX(a), getX(b), getX(c), getX(1), getX('s'));
+}
+print(res.join(' '));
+// CHECK: 1 3 5 undefined undefined
+
+for (var i = 0; i < 3; ++i) {
+  setX(a, i);
+  setX(b, 'str' + i);
+  setX(c, {v: i});
+}
+print(a.x, b.x, c.x.v);
+// CHECK-NEXT: 2 str2 2
+
+// A class transition after the entry was filled makes it miss.
+a.z = 10;
+setX(a, 7);
+print(getX(a), a.z);
+// CHECK-NEXT: 7 10
+
+// Writing a pointer into a cached slot.
+var obj = {};
+setX(a, obj);
+print(getX(a) === obj);
+// CHECK-NEXT: true
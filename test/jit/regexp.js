@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -jit -jit-call-threshold=1 -jit-crash-on-error %s \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// Regexps searched often enough to be compiled to native code, which must
+// agree with the interpreter.
+
+function run(re, str) {
+  var res;
+  for (var i = 0; i < 3; ++i) {
+    re.lastIndex = 0;
+    res = re.exec(str);
+  }
+  print(JSON.stringify(res && [res.index].concat(res)));
+}
+
+run(/abc/, 'xxabcx');
+// CHECK: [2,"abc"]
+run(/abc/, 'ababab');
+// CHECK-NEXT: null
+run(/[a-c]+\d/, 'zzcab9');
+// CHECK-NEXT: [2,"cab9"]
+run(/[^\s]\w*/, '  hello world');
+// CHECK-NEXT: [2,"hello"]
+run(/^b/m, 'a\nb');
+// CHECK-NEXT: [2,"b"]
+run(/a$/, 'a\nb');
+// CHECK-NEXT: null
+run(/a$/m, 'a\nb');
+// CHECK-NEXT: [0,"a"]
+run(/\bfoo\b/, 'xfoo foo');
+// CHECK-NEXT: [5,"foo"]
+run(/\Boo\B/, 'oo foox');
+// CHECK-NEXT: [4,"oo"]
+run(/a{2,3}/, 'aaaa');
+// CHECK-NEXT: [0,"aaa"]
+run(/a{2,3}?/, 'aaaa');
+// CHECK-NEXT: [0,"aa"]
+run(/x.*y/, 'x1y2y3');
+// CHECK-NEXT: [0,"x1y2y"]
+run(/x.*?y/, 'x1y2y3');
+// CHECK-NEXT: [0,"x1y"]
+run(/(?:ab)*c/, 'ababac abc');
+// CHECK-NEXT: [5,"c"]
+run(/(a)|(b)/, 'cb');
+// CHECK-NEXT: [1,"b",null,"b"]
+run(/(\d+)-(\d+)/, 'tel 555-1234');
+// CHECK-NEXT: [4,"555-1234","555","1234"]
+run(/cat|dog|bird/, 'hotdog');
+// CHECK-NEXT: [3,"dog"]
+run(/b/y, 'ab');
+// CHECK-NEXT: null
+run(/café|été/, "l'été");
+// CHECK-NEXT: [2,"été"]
+run(/(\w+)é/, 'naïve café');
+// CHECK-NEXT: [6,"café","caf"]
+run(/\s+/, 'a\u3000 b');
+// CHECK-NEXT: [1,"　 "]
+
+// Not compiled: back references, lookaheads, icase and unicode.
+run(/(a)\1/, 'xaa');
+// CHECK-NEXT: [1,"aa","a"]
+run(/a(?=b)/, 'acab');
+// CHECK-NEXT: [2,"a"]
+run(/ABC/i, 'xabc');
+// CHECK-NEXT: [1,"abc"]
+run(/\u{1F600}/u, 'x\u{1F600}');
+// CHECK-NEXT: [1,"😀"]
+
+// Long inputs. The native code gives up when its backtracking stack runs out,
+// and the interpreter finishes the search.
+function runLength(re, str) {
+  for (var i = 0; i < 3; ++i)
+    var res = re.exec(str);
+  print(res && res.index + ' ' + res[0].length);
+}
+var s = 'a'.repeat(100000) + 'b';
+runLength(/a*b/, s);
+// CHECK-NEXT: 0 100001
+runLength(/(?:a|b)*c/, s);
+// CHECK-NEXT: null
+runLength(/(?:a|b)*b/, s);
+// CHECK-NEXT: 0 100001
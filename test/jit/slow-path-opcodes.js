@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -jit -jit-call-threshold=0 -jit-crash-on-error %s \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// Instructions that the JIT compiles into calls to their slow paths.
+
+function calls(f) {
+  return f(1) + f(1, 2) + f(1, 2, 3) + f(1, 2, 3, 4);
+}
+print(calls(function(a, b, c, d) { return arguments.length; }));
+// CHECK: 10
+
+function switchImm(x) {
+  switch (x) {
+    case 0: return 'zero';
+    case 1: return 'one';
+    case 2: return 'two';
+    case 3: return 'three';
+    case 5: return 'five';
+    default: return 'other';
+  }
+}
+print(switchImm(0), switchImm(3), switchImm(4), switchImm(5), switchImm('1'));
+// CHECK-NEXT: zero three other five other
+
+function switchStr(x) {
+  switch (x) {
+    case 'a': return 1;
+    case 'bb': return 2;
+    case 'ccc': return 3;
+    case 'dddd': return 4;
+    case 'e': return 5;
+    case 'f': return 6;
+    case 'g': return 7;
+    case 'h': return 8;
+    case 'i': return 9;
+    case 'j': return 10;
+    default: return 0;
+  }
+}
+print(switchStr('a'), switchStr('c' + 'cc'), switchStr('j'), switchStr('k'),
+  switchStr(1));
+// CHECK-NEXT: 1 3 10 0 0
+
+function switchSparse(x) {
+  switch (x) {
+    case 1: return 'a';
+    case 10: return 'b';
+    case 100: return 'c';
+    case 1000: return 'd';
+    case 10000: return 'e';
+    case 100000: return 'f';
+    case -1: return 'g';
+    case -10: return 'h';
+    case -100: return 'i';
+    case -1000: return 'j';
+    default: return 'other';
+  }
+}
+print(switchSparse(1), switchSparse(100000), switchSparse(-1000),
+  switchSparse(2), switchSparse('1'));
+// CHECK-NEXT: a f j other other
+
+function toInt32(x) {
+  return x | 0;
+}
+print(toInt32(3.7), toInt32('12'), toInt32(2147483648));
+// CHECK-NEXT: 3 12 -2147483648
+
+function delById(o) {
+  var res = delete o.x;
+  return res + ' ' + o.x;
+}
+print(delById({x: 1}));
+// CHECK-NEXT: true undefined
+
+function computedKeys(k) {
+  var o = {[k]: 1, get [k + 'g']() { return 2; }};
+  return o[k] + o[k + 'g'];
+}
+print(computedKeys('a'));
+// CHECK-NEXT: 3
+
+function newTarget() {
+  return new.target === undefined;
+}
+print(newTarget(), new newTarget() instanceof newTarget);
+// CHECK-NEXT: true true
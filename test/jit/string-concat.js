@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -jit -jit-call-threshold=3 -jit-crash-on-error %s \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// StringConcat, emitted for template literals and chains of string additions,
+// in compiled code.
+
+function template(name, count) {
+  return `${name} has ${count} item${count === 1 ? '' : 's'}`;
+}
+
+function chain(a, b) {
+  return '[' + a + ', ' + b + ']';
+}
+
+for (var i = 0; i < 3; ++i) {
+  template('warmup', i);
+  chain(i, i);
+}
+
+print(template('Ann', 1), template('Bob', 2));
+// CHECK: Ann has 1 item Bob has 2 items
+print(chain('é', {}), chain(null, [1, 2]));
+// CHECK-NEXT: [é, [object Object]] [null, 1,2]
+try {
+  template(Symbol(), 0);
+} catch (e) {
+  print(e.constructor.name);
+}
+// CHECK-NEXT: TypeError
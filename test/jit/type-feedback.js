@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -jit -jit-call-threshold=3 -jit-crash-on-error %s \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// Arithmetic that the interpreter saw on strings is compiled without the
+// number fast path, and must still work when it later gets numbers.
+
+function add(a, b) {
+  return a + b;
+}
+function less(a, b) {
+  return a < b;
+}
+function mul(a, b) {
+  return a * b;
+}
+
+for (var i = 0; i < 3; ++i) {
+  add('a', i);
+  less('a', 'b');
+  mul('2', i);
+}
+
+print(add('x', 'y'), add(1, 2), add(1.5, 'z'));
+// CHECK: xy 3 1.5z
+print(less('a', 'b'), less(2, 1), less(1, 2));
+// CHECK-NEXT: true false true
+print(mul('3', 4), mul(2.5, 2), mul({}, 1));
+// CHECK-NEXT: 12 5 NaN
@@ -68,7 +68,7 @@ using SLG = hermes::hbc::SerializedLiteralGenerator;
  * If you have added or modified sections, make sure they're counted properly.
  */
 static_assert(
-    BYTECODE_VERSION == 72,
+    BYTECODE_VERSION == 87,
     "Bytecode version changed. Please verify that hbc-attribute counts correctly..");
 
 static llvm::cl::opt<std::string> InputFilename(
@@ -153,9 +153,27 @@ class UsageCounter : public BytecodeVisitor {
   void emitGlobalInfo() {
     appendRecord("headers:global:bundle", 0, sizeof(BytecodeFileHeader));
     appendRecord("headers:global:debuginfo", 0, sizeof(DebugInfoHeader));
+    countCJSModuleDependencies();
     // FIXME: Some padding is not included.
   }
 
+  /// Counts the CJS module dependency table. It holds an offset for each
+  /// static module, followed by the dependencies, and is left out when no
+  /// module has any.
+  void countCJSModuleDependencies() {
+    unsigned moduleCount = bcProvider_->getCJSModuleTableStatic().size();
+    unsigned dependencyCount = 0;
+    for (unsigned i = 0; i < moduleCount; ++i) {
+      dependencyCount += bcProvider_->getCJSModuleDependencies(i).size();
+    }
+    if (dependencyCount == 0)
+      return;
+    appendRecord(
+        "data:cjs:dependency_offsets", 0, moduleCount * sizeof(uint32_t));
+    appendRecord(
+        "data:cjs:dependencies", 0, dependencyCount * sizeof(uint32_t));
+  }
+
   void beforeStart(unsigned funcId, const uint8_t *bytecodeStart) override {
     currentFuncId_ = funcId;
     emitted_.clear();
@@ -405,6 +423,30 @@ class UsageCounter : public BytecodeVisitor {
       functionEnd_ = newEnd;
   }
 
+  /// Like visitSwitchImm, for SwitchStr and SwitchSparse, whose table holds a
+  /// key and a jump offset for each of its \p numSlots slots.
+  void visitSwitchHash(
+      const inst::Inst *inst,
+      uint32_t tableOffset,
+      uint32_t numSlots) {
+    const auto *curJmpTableView =
+        reinterpret_cast<const uint32_t *>(llvm::alignAddr(
+            (const uint8_t *)inst + tableOffset, sizeof(uint32_t)));
+
+    uintptr_t newEnd = (uintptr_t)&curJmpTableView[2 * numSlots];
+    if (newEnd > functionEnd_)
+      functionEnd_ = newEnd;
+
+    // The keys of SwitchStr are the IDs of the strings of its cases. Empty
+    // slots jump to the default target.
+    if (inst->opCode != inst::OpCode::SwitchStr)
+      return;
+    for (uint32_t slot = 0; slot < numSlots; ++slot) {
+      if ((int32_t)curJmpTableView[numSlots + slot] != inst->iSwitchStr.op3)
+        countStringLiteral(curJmpTableView[slot]);
+    }
+  }
+
   void preVisitInstruction(inst::OpCode opcode, const uint8_t *ip, int length)
       override {
     auto inst = (inst::Inst const *)ip;
@@ -421,6 +463,13 @@ class UsageCounter : public BytecodeVisitor {
       case OpCode::SwitchImm:
         visitSwitchImm(inst);
         break;
+      case OpCode::SwitchStr:
+        visitSwitchHash(inst, inst->iSwitchStr.op2, inst->iSwitchStr.op4);
+        break;
+      case OpCode::SwitchSparse:
+        visitSwitchHash(
+            inst, inst->iSwitchSparse.op2, inst->iSwitchSparse.op4);
+        break;
       case OpCode::NewObjectWithBuffer:
         countSerializedLiterals(
             bcProvider_->getObjectKeyBuffer(),
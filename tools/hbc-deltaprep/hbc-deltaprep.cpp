@@ -14,6 +14,7 @@
 
 #include "hermes/BCGen/HBC/BytecodeFileFormat.h"
 #include "hermes/BCGen/HBC/BytecodeFormConverter.h"
+#include "hermes/BCGen/HBC/BytecodePatch.h"
 #include "hermes/BCGen/HBC/HBC.h"
 
 using namespace hermes::hbc;
@@ -26,9 +27,19 @@ static llvm::cl::opt<BytecodeForm> Form(
             BytecodeForm::Execution,
             "execution",
             "form suitable for execution")),
-    llvm::cl::Required,
     llvm::cl::desc("Form to convert to (execution or delta)"));
 
+static llvm::cl::opt<std::string> CreatePatch(
+    "create-patch",
+    llvm::cl::desc(
+        "Write a patch turning the given bytecode file into the input file"),
+    llvm::cl::value_desc("base file"));
+
+static llvm::cl::opt<std::string> ApplyPatch(
+    "apply-patch",
+    llvm::cl::desc("Apply the given patch to the input file"),
+    llvm::cl::value_desc("patch file"));
+
 static llvm::cl::opt<std::string> InputFilename(
     llvm::cl::desc("input file"),
     llvm::cl::Required,
@@ -48,6 +59,40 @@ int main(int argc, char **argv) {
   llvm::cl::ParseCommandLineOptions(
       argc, argv, "Hermes bytecode deltaprep tool\n");
 
+  unsigned numModes =
+      Form.getNumOccurrences() + !CreatePatch.empty() + !ApplyPatch.empty();
+  if (numModes != 1) {
+    llvm::errs() << "Error: exactly one of -form, -create-patch and "
+                    "-apply-patch must be given\n";
+    return -1;
+  }
+
+  if (!ApplyPatch.empty()) {
+    // The base file is mapped rather than read, and replaced atomically when
+    // it is the output.
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> patchBufOrErr =
+        llvm::MemoryBuffer::getFile(
+            ApplyPatch, -1, false /* RequiresNullTerminator */);
+    if (!patchBufOrErr) {
+      llvm::errs() << "Error: fail to open file: " << ApplyPatch << ": "
+                   << patchBufOrErr.getError().message() << "\n";
+      return -1;
+    }
+    auto patch = (*patchBufOrErr)->getBuffer();
+    std::string error;
+    if (!applyBytecodePatch(
+            InputFilename,
+            llvm::makeArrayRef(
+                reinterpret_cast<const uint8_t *>(patch.data()), patch.size()),
+            OutputFilename,
+            &error)) {
+      llvm::errs() << "Error: failed to apply patch " << ApplyPatch << " to "
+                   << InputFilename << ": " << error << '\n';
+      return -1;
+    }
+    return 0;
+  }
+
   // Read the file and then copy the bytes into a mutable buffer.
   // TODO: switch to WritableMemoryBuffer after updating LLVM. Or use mmap()
   // with a private mapping.
@@ -60,6 +105,46 @@ int main(int argc, char **argv) {
     return -1;
   }
   auto bytes = (*fileBufOrErr)->getBuffer();
+
+  if (!CreatePatch.empty()) {
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> baseBufOrErr =
+        llvm::MemoryBuffer::getFile(
+            CreatePatch, -1, false /* RequiresNullTerminator */);
+    if (!baseBufOrErr) {
+      llvm::errs() << "Error: fail to open file: " << CreatePatch << ": "
+                   << baseBufOrErr.getError().message() << "\n";
+      return -1;
+    }
+    auto base = (*baseBufOrErr)->getBuffer();
+
+    std::string patch;
+    llvm::raw_string_ostream patchOS(patch);
+    std::string error;
+    if (!createBytecodePatch(
+            llvm::makeArrayRef(
+                reinterpret_cast<const uint8_t *>(base.data()), base.size()),
+            llvm::makeArrayRef(
+                reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size()),
+            patchOS,
+            &error)) {
+      llvm::errs() << "Error: failed to create patch from " << CreatePatch
+                   << " to " << InputFilename << ": " << error << '\n';
+      return -1;
+    }
+    patchOS.flush();
+
+    std::error_code EC;
+    llvm::raw_fd_ostream fileOS(
+        OutputFilename.data(), EC, llvm::sys::fs::F_None);
+    if (EC) {
+      llvm::errs() << "Error: fail to open file " << OutputFilename << ": "
+                   << EC.message() << '\n';
+      return -1;
+    }
+    fileOS << patch;
+    return 0;
+  }
+
   std::vector<uint8_t> mutableBytes(bytes.begin(), bytes.end());
 
   std::string error;
@@ -121,7 +121,9 @@ static ExecutionStatus diffFiles(
     auto lastFuncStart = start;
     uint32_t lastFuncId = 0;
     for (uint32_t funcId = 0; funcId < functionCount; ++funcId) {
+      // Function bodies may be laid out in any order.
       auto funcStart = bytecode->getBytecode(funcId);
+      start = std::min(start, funcStart);
       if (funcStart > lastFuncStart) {
         lastFuncStart = funcStart;
         lastFuncId = funcId;
@@ -81,7 +81,8 @@ BasicBlockStaticInstCountMap &HBCParser::getBasicBlockStaticInstCountMap(
 /// by traversing all branch instructions.
 class BasicBlockRangeVisitor : public hermes::hbc::BytecodeVisitor {
  private:
-  // Whether current instruction is branch instruction(Jump, SwitchImm) or not.
+  // Whether current instruction is branch instruction(Jump, SwitchImm,
+  // SwitchStr, SwitchSparse) or not.
   bool isBranchInst_{false};
   std::unordered_set<const uint8_t *> basicBlockStartAddresses_{};
 
@@ -92,7 +93,8 @@ class BasicBlockRangeVisitor : public hermes::hbc::BytecodeVisitor {
   }
 
   void preVisitInstruction(OpCode opcode, const uint8_t *ip, int length) {
-    isBranchInst_ = opcode == OpCode::SwitchImm;
+    isBranchInst_ = opcode == OpCode::SwitchImm ||
+        opcode == OpCode::SwitchStr || opcode == OpCode::SwitchSparse;
   }
 
   void
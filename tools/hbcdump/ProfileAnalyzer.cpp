@@ -10,6 +10,7 @@
 #include "hermes/BCGen/HBC/BytecodeStream.h"
 #include "hermes/BCGen/HBC/HBC.h"
 #include "hermes/Parser/JSONParser.h"
+#include "hermes/Support/BasicBlockProfile.h"
 
 #include <set>
 #include <vector>
@@ -180,16 +181,16 @@ ProfileData ProfileAnalyzer::deserializeTrace(
   auto *json = llvm::dyn_cast<JSONObject>(jsonParser.parse().getValue());
   checkInvalidTraceObjectAndExit(json, "root is not JSONObject");
 
-  // TODO: share BASIC_BLOCK_STAT_VERSION with VM.
-  const static int32_t BASIC_BLOCK_STAT_VERSION = 2;
   ProfileData profileData;
   auto *version = dyn_cast<JSONNumber>(json->at("version"));
   checkInvalidTraceObjectAndExit(
       version, "fail to fetch 'version' entry from root object");
   profileData.version = (uint16_t)version->getValue();
-  if (profileData.version != BASIC_BLOCK_STAT_VERSION) {
+  if (profileData.version < kMinBasicBlockProfileVersion ||
+      profileData.version > kBasicBlockProfileVersion) {
     llvm::errs() << "Mismatch profile trace version. Expected "
-                 << BASIC_BLOCK_STAT_VERSION << " but got "
+                 << kMinBasicBlockProfileVersion << " to "
+                 << kBasicBlockProfileVersion << " but got "
                  << profileData.version;
     exit(-3);
   }
@@ -648,10 +649,18 @@ void ProfileAnalyzer::dumpIO() {
   os_ << executionInfo.size() << " functions accessed out of total "
       << funcCount << " functions\n";
 
-  uint32_t funcRegionStartOffset = bcProvider->getFunctionHeader(0).offset();
-  uint32_t funcRegionEndOffset =
-      bcProvider->getFunctionHeader(funcCount - 1).offset() +
-      bcProvider->getFunctionHeader(funcCount - 1).bytecodeSizeInBytes() - 1;
+  // Function bodies may be laid out in any order.
+  uint32_t funcRegionStartOffset = UINT32_MAX;
+  uint32_t funcRegionEndOffset = 0;
+  for (uint32_t funcId = 0; funcId < funcCount; ++funcId) {
+    hbc::RuntimeFunctionHeader functionHeader =
+        bcProvider->getFunctionHeader(funcId);
+    funcRegionStartOffset =
+        std::min(funcRegionStartOffset, functionHeader.offset());
+    funcRegionEndOffset = std::max(
+        funcRegionEndOffset,
+        functionHeader.offset() + functionHeader.bytecodeSizeInBytes() - 1);
+  }
 
   uint32_t funcRegionStartPage = getPageIndexFromOffset(funcRegionStartOffset);
   uint32_t funcRegionEndPage = getPageIndexFromOffset(funcRegionEndOffset);
@@ -68,6 +68,12 @@ static llvm::cl::opt<std::string> ProfileFile(
     llvm::cl::desc(
         "Log file in json format generated by basic block profiler"));
 
+static llvm::cl::opt<bool> Validate(
+    "validate",
+    llvm::cl::init(false),
+    llvm::cl::desc(
+        "Check every section and function body of the bytecode and exit"));
+
 static llvm::cl::opt<bool> ShowSectionRanges(
     "show-section-ranges",
     llvm::cl::init(false),
@@ -403,6 +409,20 @@ int main(int argc, char **argv) {
     return -1;
   }
 
+  if (Validate) {
+    const auto &fileBuf = *fileBufOrErr.get();
+    std::string error;
+    if (!BCProviderFromBuffer::bytecodeStreamStrictCheck(
+            {reinterpret_cast<const uint8_t *>(fileBuf.getBufferStart()),
+             fileBuf.getBufferSize()},
+            &error)) {
+      llvm::errs() << "Error: invalid bytecode: " << error << "\n";
+      return 1;
+    }
+    llvm::outs() << "Bytecode is valid\n";
+    return 0;
+  }
+
   auto buffer =
       llvm::make_unique<hermes::MemoryBuffer>(fileBufOrErr.get().get());
   const uint8_t *bytecodeStart = buffer->data();
@@ -10,6 +10,7 @@
 #include "hermes/ConsoleHost/RuntimeFlags.h"
 #include "hermes/Support/OSCompat.h"
 #include "hermes/Support/PageAccessTracker.h"
+#include "hermes/Support/TraceEvents.h"
 
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
@@ -25,6 +26,7 @@
 using namespace hermes;
 
 namespace cl {
+using llvm::cl::list;
 using llvm::cl::opt;
 
 static opt<bool> EnableJIT(
@@ -42,6 +44,79 @@ static opt<bool> JITCrashOnError(
     llvm::cl::desc("crash on any JIT compilation error"),
     llvm::cl::init(false));
 
+static opt<bool> JITBackground(
+    "jit-background",
+    llvm::cl::desc("JIT compile hot functions on a background thread"),
+    llvm::cl::init(false));
+
+static opt<unsigned> JITCallThreshold(
+    "jit-call-threshold",
+    llvm::cl::desc("number of interpreted calls before a function is JIT'ed"),
+    llvm::cl::init(10));
+
+static opt<unsigned> JITLoopThreshold(
+    "jit-loop-threshold",
+    llvm::cl::desc(
+        "number of interpreted loop iterations before a function is JIT'ed"),
+    llvm::cl::init(1000));
+
+static opt<std::string> JITProfileCacheDir(
+    "jit-profile-cache",
+    llvm::cl::desc(
+        "directory where the JIT'ed functions are remembered across runs"),
+    llvm::cl::value_desc("dir"));
+
+static opt<unsigned> JITCodeBudget(
+    "jit-code-budget",
+    llvm::cl::desc(
+        "bytes of JIT'ed code kept before evicting the least recently used "
+        "functions (0 = no limit)"),
+    llvm::cl::init(0));
+
+static opt<bool> JITPerfMap(
+    "jit-perf-map",
+    llvm::cl::desc(
+        "describe the JIT'ed code in /tmp/perf-<pid>.map and "
+        "/tmp/jit-<pid>.dump for the Linux perf tool"),
+    llvm::cl::init(false));
+
+static opt<bool> LazyPrecompile(
+    "lazy-precompile",
+    llvm::cl::desc(
+        "compile lazy functions on a background thread before their first "
+        "call"),
+    llvm::cl::init(false));
+
+static opt<unsigned> RegExpCacheSize(
+    "regexp-cache-size",
+    llvm::cl::desc(
+        "number of compiled regexps cached by their pattern and flags "
+        "(0 = disabled)"),
+    llvm::cl::init(64));
+
+static opt<unsigned> EvalCacheSize(
+    "eval-cache-size",
+    llvm::cl::desc(
+        "number of sources compiled by eval and Function whose bytecode is "
+        "cached (0 = disabled)"),
+    llvm::cl::init(32));
+
+static opt<unsigned> MaxStackTraceDepth(
+    "max-stack-trace-depth",
+    llvm::cl::desc(
+        "largest number of frames recorded in the stack trace of an Error "
+        "(0 = no limit)"),
+    llvm::cl::init(0));
+
+static list<std::string> NativeLibraryFunctions(
+    "Xnative-library-functions",
+    llvm::cl::desc(
+        "builtins keeping their native implementation rather than the one "
+        "of the JS library, like Array.prototype.map or "
+        "RegExp.prototype.@@replace"),
+    llvm::cl::CommaSeparated,
+    llvm::cl::Hidden);
+
 static opt<unsigned> Repeat(
     "Xrepeat",
     llvm::cl::desc("Repeat execution N number of times"),
@@ -101,6 +176,7 @@ static int executeHBCBytecodeFromCL(
                   .withInitHeapSize(cl::InitHeapSize.bytes)
                   .withMaxHeapSize(cl::MaxHeapSize.bytes)
                   .withOccupancyTarget(cl::OccupancyTarget)
+                  .withGCTimeTarget(cl::GCTimeTarget)
                   .withSanitizeConfig(
                       vm::GCSanitizeConfig::Builder()
                           .withSanitizeRate(cl::GCSanitizeRate)
@@ -113,6 +189,19 @@ static int executeHBCBytecodeFromCL(
                   .withRevertToYGAtTTI(cl::GCRevertToYGAtTTI)
                   .build())
           .withEnableJIT(cl::DumpJITCode || cl::EnableJIT)
+          .withJITCallThreshold(cl::JITCallThreshold)
+          .withJITLoopThreshold(cl::JITLoopThreshold)
+          .withJITBackgroundCompilation(cl::JITBackground)
+          .withJITProfileCacheDir(cl::JITProfileCacheDir)
+          .withJITCodeBudget(cl::JITCodeBudget)
+          .withJITPerfMap(cl::JITPerfMap)
+          .withLazyPrecompilation(cl::LazyPrecompile)
+          .withRegExpCacheSize(cl::RegExpCacheSize)
+          .withEvalCacheSize(cl::EvalCacheSize)
+          .withMaxStackTraceDepth(cl::MaxStackTraceDepth)
+          .withNativeLibraryFunctions(std::vector<std::string>(
+              cl::NativeLibraryFunctions.begin(),
+              cl::NativeLibraryFunctions.end()))
           .withEnableEval(cl::EnableEval)
           .withVerifyEvalIR(cl::VerifyIR)
           .withVMExperimentFlags(cl::VMExperimentFlags)
@@ -132,6 +221,20 @@ static int executeHBCBytecodeFromCL(
   options.patchProfilerSymbols = cl::PatchProfilerSymbols;
   options.profilerSymbolsFile = cl::ProfilerSymbolsFile;
 #endif
+  options.sampleProfilingStreamNodes = cl::SampleProfilingStreamNodes;
+  options.sampleProfilingHistograms = cl::SampleProfilingHistograms;
+  options.dumpPropertyCacheStats = cl::DumpPropertyCacheStats;
+  options.functionProfiling = cl::FunctionProfiling;
+  options.functionProfilingSummary = cl::FunctionProfilingSummary;
+  options.traceEventsFile = cl::TraceEvents;
+  if (auto categories = trace::parseCategories(cl::TraceEventCategories)) {
+    options.traceEventCategories = *categories;
+  } else {
+    llvm::errs() << "Unknown trace event category in: "
+                 << cl::TraceEventCategories << "\n";
+    return EXIT_FAILURE;
+  }
+  options.allocationSamplingInterval = cl::AllocationSamplingInterval;
   options.timeLimit = cl::ExecutionTimeLimit;
   options.dumpJITCode = cl::DumpJITCode;
   options.jitCrashOnError = cl::JITCrashOnError;
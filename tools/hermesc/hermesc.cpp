@@ -26,7 +26,8 @@ int main(int argc, char **argv) {
   llvm::llvm_shutdown_obj Y;
   llvm::cl::AddExtraVersionPrinter(driver::printHermesCompilerVersion);
   llvm::cl::ParseCommandLineOptions(argc, argv, "Hermes driver\n");
-  driver::CompileResult res = driver::compileFromCommandLineOptions();
+  driver::CompileResult res = driver::compileFromCommandLineOptions(
+      llvm::ArrayRef<const char *>(argv, argc));
   if (res.bytecodeProvider) {
     llvm::errs() << "Execution not supported with hermesc\n";
     return EXIT_FAILURE;
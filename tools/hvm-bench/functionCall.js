@@ -0,0 +1,35 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Calls small functions that do almost no work, so the time is dominated by
+// setting up and tearing down the stack frames.
+
+function add(a, b) {
+    return a + b;
+}
+
+function inc(a) {
+    return add(a, 1);
+}
+
+function doCalls() {
+    var sum = 0;
+    for (var i = 0; i < 100000; i++) {
+        sum = inc(sum);
+    }
+    return sum;
+}
+
+function doCallsNTimes(n) {
+    var sum = 0;
+    for (var i = 0; i < n; i++) {
+        sum += doCalls();
+    }
+    return sum;
+}
+
+print(doCallsNTimes(1000));
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// This benchmark measures the pauses of the garbage collector on heaps of
+/// controlled shapes.
+///
+/// Each workload first builds an object graph of a given shape and size, then
+/// for a number of rounds replaces part of it, so that the GC sees both a
+/// large long-lived heap and a steady stream of garbage:
+///
+///   list     a deep linked list, whose head is copied every round.
+///   tree     a wide tree, one of whose subtrees is rebuilt every round.
+///   array    a large array of objects, a slice of which is replaced every
+///            round, next to a temporary array of numbers.
+///   weakmap  many WeakMaps whose keys die and are replaced every round.
+///   churn    a long-lived array, into which new objects are stored at random
+///            indices every round, creating old-to-young pointers.
+///
+/// Every workload runs in a fresh runtime, which records every collection.
+/// The report, in JSON, gives for each workload the pause percentiles of the
+/// young-gen and full collections, the time spent in the GC, the allocation
+/// throughput and the peak RSS of the process so far (run a single workload to
+/// get its own peak).
+//===----------------------------------------------------------------------===//
+#include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/Runtime.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace hermes;
+using namespace hermes::vm;
+
+static llvm::cl::list<std::string> Workloads(
+    "workload",
+    llvm::cl::desc("Workload to run (list, tree, array, weakmap or churn); "
+                   "may be repeated, and defaults to all of them"),
+    llvm::cl::ZeroOrMore);
+
+static llvm::cl::opt<unsigned> Size(
+    "size",
+    llvm::cl::desc("Number of objects in the long-lived object graph"),
+    llvm::cl::init(200000));
+
+static llvm::cl::opt<unsigned> Rounds(
+    "rounds",
+    llvm::cl::desc("Number of rounds replacing part of the object graph"),
+    llvm::cl::init(200));
+
+static llvm::cl::opt<unsigned> InitHeapMB(
+    "init-heap-mb",
+    llvm::cl::desc("Initial size of the heap, in MB"),
+    llvm::cl::init(32));
+
+static llvm::cl::opt<unsigned> MaxHeapMB(
+    "max-heap-mb",
+    llvm::cl::desc("Maximum size of the heap, in MB"),
+    llvm::cl::init(1024));
+
+namespace {
+
+/// Defines rand(n), a deterministic pseudo-random integer below n, and
+/// PART, the number of objects replaced by most workloads in a round.
+const char *const kPrelude = R"(
+var PART = Math.max(1, Math.floor(SIZE / 10));
+var seed = 1;
+function rand(n) {
+  seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+  return seed % n;
+}
+)";
+
+struct Workload {
+  const char *name;
+  /// The source of the workload, which uses the globals SIZE and ROUNDS and
+  /// the prelude.
+  const char *source;
+};
+
+const Workload kWorkloads[] = {
+    {"list", R"(
+var head = null;
+for (var i = 0; i < SIZE; i++) {
+  head = {value: i, next: head};
+}
+for (var r = 0; r < ROUNDS; r++) {
+  var node = head;
+  var newHead = null;
+  var tail = null;
+  for (var i = 0; i < PART; i++) {
+    var copy = {value: node.value + 1, next: null};
+    if (tail) {
+      tail.next = copy;
+    } else {
+      newHead = copy;
+    }
+    tail = copy;
+    node = node.next;
+  }
+  tail.next = node;
+  head = newHead;
+}
+)"},
+    {"tree", R"(
+var WIDTH = 16;
+function build(depth) {
+  var node = {payload: depth, children: []};
+  if (depth > 0) {
+    for (var i = 0; i < WIDTH; i++) {
+      node.children.push(build(depth - 1));
+    }
+  }
+  return node;
+}
+var depth = Math.max(1, Math.round(Math.log(SIZE) / Math.log(WIDTH)));
+var root = build(depth);
+for (var r = 0; r < ROUNDS; r++) {
+  var parent = root;
+  while (parent.payload > 2 && rand(4)) {
+    parent = parent.children[rand(WIDTH)];
+  }
+  parent.children[rand(WIDTH)] = build(parent.payload - 1);
+}
+)"},
+    {"array", R"(
+var arr = [];
+for (var i = 0; i < SIZE; i++) {
+  arr.push({index: i, round: -1});
+}
+for (var r = 0; r < ROUNDS; r++) {
+  var start = (r * PART) % SIZE;
+  for (var i = start; i < start + PART && i < SIZE; i++) {
+    arr[i] = {index: i, round: r};
+  }
+  var numbers = new Array(PART);
+  for (var i = 0; i < numbers.length; i++) {
+    numbers[i] = i * r + 0.5;
+  }
+}
+)"},
+    {"weakmap", R"(
+var maps = [];
+for (var m = 0; m < 64; m++) {
+  maps.push(new WeakMap());
+}
+var keys = [];
+for (var i = 0; i < SIZE; i++) {
+  var key = {id: i};
+  keys.push(key);
+  maps[i % maps.length].set(key, {value: i});
+}
+for (var r = 0; r < ROUNDS; r++) {
+  for (var k = 0; k < PART / 2; k++) {
+    var i = rand(SIZE);
+    var key = {id: i};
+    keys[i] = key;
+    maps[i % maps.length].set(key, {value: r});
+  }
+}
+)"},
+    {"churn", R"(
+var old = [];
+for (var i = 0; i < SIZE; i++) {
+  old.push({round: -1});
+}
+for (var r = 0; r < ROUNDS; r++) {
+  for (var k = 0; k < PART; k++) {
+    old[rand(SIZE)] = {round: r, k: k};
+  }
+}
+)"},
+};
+
+/// \return the \p p-th percentile of \p sorted, by the nearest rank.
+double percentile(const std::vector<double> &sorted, double p) {
+  if (sorted.empty())
+    return 0;
+  size_t rank = (size_t)std::ceil(p / 100 * sorted.size());
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+/// Emit the pause statistics of \p pauses, in milliseconds.
+void emitPauses(JSONEmitter &json, std::vector<double> pauses) {
+  std::sort(pauses.begin(), pauses.end());
+  double total = 0;
+  for (double pause : pauses)
+    total += pause;
+  json.openDict();
+  json.emitKeyValue("count", (unsigned)pauses.size());
+  json.emitKeyValue("totalMs", total * 1000);
+  json.emitKeyValue("p50Ms", percentile(pauses, 50) * 1000);
+  json.emitKeyValue("p90Ms", percentile(pauses, 90) * 1000);
+  json.emitKeyValue("p99Ms", percentile(pauses, 99) * 1000);
+  json.emitKeyValue("maxMs", pauses.empty() ? 0 : pauses.back() * 1000);
+  json.closeDict();
+}
+
+/// Run \p workload in a fresh runtime and emit its report to \p json.
+/// \return whether it ran successfully.
+bool runWorkload(JSONEmitter &json, const Workload &workload) {
+  std::vector<double> youngPauses;
+  std::vector<double> fullPauses;
+  auto runtime = Runtime::create(
+      RuntimeConfig::Builder()
+          .withGCConfig(GCConfig::Builder()
+                            .withInitHeapSize((gcheapsize_t)InitHeapMB << 20)
+                            .withMaxHeapSize((gcheapsize_t)MaxHeapMB << 20)
+                            .withShouldRecordStats(true)
+                            .withName("gc-bench")
+                            .withCollectionEventCallback(
+                                [&](const GCCollectionEvent &event) {
+                                  (event.youngGen ? youngPauses : fullPauses)
+                                      .push_back(event.wallSecs);
+                                })
+                            .build())
+          .build());
+
+  std::string source = "var SIZE = " + std::to_string(Size) + ";\n";
+  source += "var ROUNDS = " + std::to_string(Rounds) + ";\n";
+  source += kPrelude;
+  source += workload.source;
+  hbc::CompileFlags flags;
+  flags.optimize = true;
+
+  GCScope scope(runtime.get());
+  auto start = std::chrono::steady_clock::now();
+  auto res = runtime->run(source, workload.name, flags);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  if (res == ExecutionStatus::EXCEPTION) {
+    llvm::errs() << "Error running workload " << workload.name << ":\n";
+    runtime->printException(
+        llvm::errs(), runtime->makeHandle(runtime->getThrownValue()));
+    return false;
+  }
+
+  GCBase::HeapInfo info;
+  runtime->getHeap().getHeapInfo(info);
+  double gcSecs = 0;
+  for (double pause : youngPauses)
+    gcSecs += pause;
+  for (double pause : fullPauses)
+    gcSecs += pause;
+
+  json.emitKey(workload.name);
+  json.openDict();
+  json.emitKeyValue("wallMs", elapsed.count() * 1000);
+  json.emitKeyValue("gcFraction", gcSecs / elapsed.count());
+  json.emitKeyValue(
+      "allocatedMB", (double)info.totalAllocatedBytes / (1 << 20));
+  json.emitKeyValue(
+      "allocationMBPerSec",
+      (double)info.totalAllocatedBytes / (1 << 20) / elapsed.count());
+  json.emitKeyValue("heapSizeMB", (double)info.heapSize / (1 << 20));
+  json.emitKeyValue("peakRSSMB", (double)oscompat::peak_rss() / (1 << 20));
+  json.emitKey("young");
+  emitPauses(json, youngPauses);
+  json.emitKey("full");
+  emitPauses(json, fullPauses);
+  json.closeDict();
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM initLLVM(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "Hermes GC benchmark\n");
+
+  std::vector<const Workload *> selected;
+  for (const std::string &name : Workloads) {
+    auto it = std::find_if(
+        std::begin(kWorkloads),
+        std::end(kWorkloads),
+        [&](const Workload &w) { return name == w.name; });
+    if (it == std::end(kWorkloads)) {
+      llvm::errs() << "Error: unknown workload " << name << "\n";
+      return 2;
+    }
+    selected.push_back(it);
+  }
+  if (selected.empty()) {
+    for (const Workload &workload : kWorkloads)
+      selected.push_back(&workload);
+  }
+
+  bool success = true;
+  JSONEmitter json(llvm::outs(), /* pretty */ true);
+  json.openDict();
+  json.emitKeyValue("size", (unsigned)Size);
+  json.emitKeyValue("rounds", (unsigned)Rounds);
+  json.emitKey("workloads");
+  json.openDict();
+  for (const Workload *workload : selected)
+    success &= runWorkload(json, *workload);
+  json.closeDict();
+  json.closeDict();
+  llvm::outs() << "\n";
+  return success ? 0 : 1;
+}
@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// Runs the JavaScript benchmarks given on the command line a number of times
+/// in-process and reports statistics of their wall and CPU times, garbage
+/// collections and heap as JSON, so that runs on different commits can be
+/// compared.
+///
+/// Every benchmark is compiled once, outside of the measurements. Each
+/// iteration then runs it either in a fresh runtime (the default), or with
+/// -warm in a runtime shared by all the iterations of the benchmark, which
+/// measures the steady state instead of the first run. The first -warmup
+/// iterations are run but not measured.
+///
+/// For every measurement the median, the mean, the standard deviation and a
+/// 95% confidence interval of the mean are reported. Given the output of a
+/// previous run with -baseline, the benchmarks whose confidence interval of
+/// the wall time lies entirely above the one of the baseline are reported as
+/// regressions, and the exit status is 1.
+///
+/// The scripts in tools/hvm-bench are micro-benchmarks of single builtins.
+/// The ones in tools/hvm-bench/macro model whole applications, to measure
+/// behaviors like GC pressure, polymorphic property accesses and cold start.
+//===----------------------------------------------------------------------===//
+#include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+#include "hermes/Parser/JSONParser.h"
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/Support/MemoryBuffer.h"
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/JSObject.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/RuntimeStats.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace hermes;
+
+static llvm::cl::list<std::string> InputFilenames(
+    llvm::cl::desc("<benchmark .js files>"),
+    llvm::cl::Positional,
+    llvm::cl::OneOrMore);
+
+static llvm::cl::opt<unsigned> Iterations(
+    "iterations",
+    llvm::cl::desc("Number of measured runs of each benchmark"),
+    llvm::cl::init(10));
+
+static llvm::cl::opt<unsigned> Warmup(
+    "warmup",
+    llvm::cl::desc("Number of runs of each benchmark before measuring"),
+    llvm::cl::init(1));
+
+static llvm::cl::opt<bool> Warm(
+    "warm",
+    llvm::cl::desc("Run all iterations of a benchmark in the same runtime "
+                   "instead of a fresh runtime each"),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<bool> Optimize(
+    "O",
+    llvm::cl::desc("Compile the benchmarks with optimizations"),
+    llvm::cl::init(true));
+
+static llvm::cl::opt<std::string> OutputFilename(
+    "o",
+    llvm::cl::desc("File to write the JSON report to"),
+    llvm::cl::init("-"));
+
+static llvm::cl::opt<std::string> BaselineFilename(
+    "baseline",
+    llvm::cl::desc("JSON report of a previous run to check for regressions"),
+    llvm::cl::init(""));
+
+namespace {
+
+/// The measurements of one run of a benchmark.
+struct Sample {
+  double wallTime;
+  double cpuTime;
+  double gcWallTime;
+  /// The longest collection of the runtime so far, which is only the ones of
+  /// this run in a fresh runtime.
+  double maxGCPause;
+  double numGCs;
+  double allocatedBytes;
+  double heapSize;
+};
+
+/// The names of the fields of \c Sample in the report, in order.
+const char *const kMeasurementNames[] = {
+    "wallTime",
+    "cpuTime",
+    "gcWallTime",
+    "maxGCPause",
+    "numGCs",
+    "allocatedBytes",
+    "heapSize",
+};
+
+double Sample::*const kMeasurements[] = {
+    &Sample::wallTime,
+    &Sample::cpuTime,
+    &Sample::gcWallTime,
+    &Sample::maxGCPause,
+    &Sample::numGCs,
+    &Sample::allocatedBytes,
+    &Sample::heapSize,
+};
+
+/// Summary statistics of the values of one measurement over the runs.
+struct Summary {
+  double median{0};
+  double mean{0};
+  double stddev{0};
+  /// Bounds of the 95% confidence interval of the mean.
+  double ciLow{0};
+  double ciHigh{0};
+  double min{0};
+  double max{0};
+};
+
+/// \return the two-sided 95% critical value of Student's t distribution with
+/// \p df degrees of freedom.
+double studentT95(unsigned df) {
+  static const double table[] = {
+      12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+      2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+      2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+  };
+  const unsigned tableSize = sizeof(table) / sizeof(table[0]);
+  assert(df > 0 && "no degrees of freedom");
+  return df <= tableSize ? table[df - 1] : 1.960;
+}
+
+Summary summarize(std::vector<double> values) {
+  Summary s;
+  if (values.empty())
+    return s;
+  std::sort(values.begin(), values.end());
+  size_t n = values.size();
+  s.min = values.front();
+  s.max = values.back();
+  s.median = n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+  double sum = 0;
+  for (double v : values)
+    sum += v;
+  s.mean = sum / n;
+  s.ciLow = s.ciHigh = s.mean;
+  if (n > 1) {
+    double squares = 0;
+    for (double v : values)
+      squares += (v - s.mean) * (v - s.mean);
+    s.stddev = std::sqrt(squares / (n - 1));
+    double halfWidth = studentT95(n - 1) * s.stddev / std::sqrt((double)n);
+    s.ciLow = s.mean - halfWidth;
+    s.ciHigh = s.mean + halfWidth;
+  }
+  return s;
+}
+
+/// The result of running one benchmark.
+struct BenchmarkResult {
+  std::string name;
+  /// Empty if the benchmark ran successfully, else why it didn't.
+  std::string error;
+  std::vector<Sample> samples;
+};
+
+/// A print() that discards its arguments, so that the output of the
+/// benchmarks doesn't get mixed with the report.
+vm::CallResult<vm::HermesValue>
+quietPrint(void *, vm::Runtime *, vm::NativeArgs) {
+  return vm::HermesValue::encodeUndefinedValue();
+}
+
+std::shared_ptr<vm::Runtime> createRuntime() {
+  auto runtime = vm::Runtime::create(
+      vm::RuntimeConfig::Builder()
+          .withGCConfig(vm::GCConfig::Builder()
+                            .withShouldRecordStats(true)
+                            .withName("hvm-bench-runner")
+                            .build())
+          .build());
+
+  vm::GCScope scope(runtime.get());
+  auto dpf = vm::DefinePropertyFlags::getNewNonEnumerableFlags();
+  auto name = vm::Predefined::getSymbolID(vm::Predefined::print);
+  auto res = vm::JSObject::defineOwnProperty(
+      runtime->getGlobal(),
+      runtime.get(),
+      name,
+      dpf,
+      vm::NativeFunction::createWithoutPrototype(
+          runtime.get(), nullptr, quietPrint, name, 1));
+  (void)res;
+  assert(
+      res != vm::ExecutionStatus::EXCEPTION && *res &&
+      "global.defineOwnProperty() failed");
+  return runtime;
+}
+
+/// \return the total wall time of the collections so far, in seconds.
+double gcWallTime(const vm::GCBase::HeapInfo &info) {
+  return info.fullStats.gcWallTime.sum() + info.youngGenStats.gcWallTime.sum();
+}
+
+/// Run \p bytecode once in \p runtime. \return whether it succeeded; if not,
+/// set \p error to the exception it threw.
+bool runOnce(
+    vm::Runtime *runtime,
+    const std::shared_ptr<hbc::BCProvider> &bytecode,
+    llvm::StringRef sourceURL,
+    Sample &sample,
+    std::string &error) {
+  vm::GCScope scope(runtime);
+  auto &stats = runtime->getRuntimeStats();
+  vm::GCBase::HeapInfo before;
+  runtime->getHeap().getHeapInfo(before);
+  const vm::instrumentation::RuntimeStats::Statistic start = stats.evaluateJS;
+
+  vm::CallResult<vm::HermesValue> res{vm::ExecutionStatus::EXCEPTION};
+  {
+    vm::instrumentation::RAIITimer timer{"Benchmark", stats, stats.evaluateJS};
+    res = runtime->runBytecode(
+        std::shared_ptr<hbc::BCProvider>{bytecode},
+        vm::RuntimeModuleFlags{},
+        sourceURL,
+        vm::Runtime::makeNullHandle<vm::Environment>());
+  }
+
+  if (res == vm::ExecutionStatus::EXCEPTION) {
+    llvm::raw_string_ostream os{error};
+    runtime->printException(os, runtime->makeHandle(runtime->getThrownValue()));
+    os.flush();
+    return false;
+  }
+
+  vm::GCBase::HeapInfo after;
+  runtime->getHeap().getHeapInfo(after);
+  sample.wallTime = stats.evaluateJS.wallDuration - start.wallDuration;
+  sample.cpuTime = stats.evaluateJS.cpuDuration - start.cpuDuration;
+  sample.gcWallTime = gcWallTime(after) - gcWallTime(before);
+  sample.maxGCPause = std::max(
+      after.fullStats.gcWallTime.max(), after.youngGenStats.gcWallTime.max());
+  sample.numGCs = after.numCollections - before.numCollections;
+  sample.allocatedBytes =
+      after.totalAllocatedBytes - before.totalAllocatedBytes;
+  sample.heapSize = after.heapSize;
+  return true;
+}
+
+BenchmarkResult runBenchmark(const std::string &filename) {
+  BenchmarkResult result;
+  result.name = llvm::sys::path::filename(filename).str();
+
+  auto fileBuf = llvm::MemoryBuffer::getFile(filename);
+  if (!fileBuf) {
+    result.error = "failed to open " + filename;
+    return result;
+  }
+  hbc::CompileFlags flags;
+  flags.optimize = Optimize;
+  auto compiled = hbc::BCProviderFromSrc::createBCProviderFromSrc(
+      llvm::make_unique<OwnedMemoryBuffer>(std::move(*fileBuf)),
+      filename,
+      flags);
+  if (!compiled.first) {
+    result.error = compiled.second;
+    return result;
+  }
+  std::shared_ptr<hbc::BCProvider> bytecode = std::move(compiled.first);
+
+  std::shared_ptr<vm::Runtime> runtime;
+  for (unsigned i = 0, e = Warmup + Iterations; i < e; ++i) {
+    if (!runtime || !Warm)
+      runtime = createRuntime();
+    Sample sample;
+    if (!runOnce(runtime.get(), bytecode, filename, sample, result.error))
+      return result;
+    if (i >= Warmup)
+      result.samples.push_back(sample);
+  }
+  return result;
+}
+
+void emitSummary(JSONEmitter &json, const Summary &s) {
+  json.openDict();
+  json.emitKeyValue("median", s.median);
+  json.emitKeyValue("mean", s.mean);
+  json.emitKeyValue("stddev", s.stddev);
+  json.emitKeyValue("ci95Low", s.ciLow);
+  json.emitKeyValue("ci95High", s.ciHigh);
+  json.emitKeyValue("min", s.min);
+  json.emitKeyValue("max", s.max);
+  json.closeDict();
+}
+
+void emitReport(
+    llvm::raw_ostream &os,
+    const std::vector<BenchmarkResult> &results) {
+  JSONEmitter json(os, /* pretty */ true);
+  json.openDict();
+  json.emitKeyValue("iterations", (unsigned)Iterations);
+  json.emitKeyValue("warmup", (unsigned)Warmup);
+  json.emitKeyValue("warm", (bool)Warm);
+  json.emitKey("benchmarks");
+  json.openDict();
+  for (const BenchmarkResult &result : results) {
+    json.emitKey(result.name);
+    json.openDict();
+    if (!result.error.empty()) {
+      json.emitKeyValue("error", result.error);
+      json.closeDict();
+      continue;
+    }
+    for (unsigned m = 0; m < llvm::array_lengthof(kMeasurements); ++m) {
+      std::vector<double> values;
+      for (const Sample &sample : result.samples)
+        values.push_back(sample.*kMeasurements[m]);
+      json.emitKey(kMeasurementNames[m]);
+      emitSummary(json, summarize(values));
+    }
+    json.emitKey("wallTimes");
+    json.openArray();
+    for (const Sample &sample : result.samples)
+      json.emitValue(sample.wallTime);
+    json.closeArray();
+    json.closeDict();
+  }
+  json.closeDict();
+  json.closeDict();
+  os << "\n";
+}
+
+/// Compare the wall times of \p results with the report in \p filename.
+/// \return the number of regressions, which are printed to stderr.
+unsigned checkBaseline(
+    llvm::StringRef filename,
+    const std::vector<BenchmarkResult> &results) {
+  using namespace hermes::parser;
+  auto fileBuf = llvm::MemoryBuffer::getFile(filename);
+  if (!fileBuf) {
+    llvm::errs() << "Error: failed to open baseline " << filename << "\n";
+    return 1;
+  }
+  JSLexer::Allocator alloc;
+  JSONFactory factory(alloc);
+  SourceErrorManager sm;
+  JSONParser parser(factory, (*fileBuf)->getBuffer(), sm);
+  auto parsed = parser.parse();
+  auto *report = llvm::dyn_cast_or_null<JSONObject>(parsed ? *parsed : nullptr);
+  auto *benchmarks = report
+      ? llvm::dyn_cast_or_null<JSONObject>(report->get("benchmarks"))
+      : nullptr;
+  if (!benchmarks) {
+    llvm::errs() << "Error: invalid baseline " << filename << "\n";
+    return 1;
+  }
+
+  /// \return the field \p key of the wall time summary \p bench.
+  auto wallTime = [](const JSONObject *bench, llvm::StringRef key) {
+    auto *summary = llvm::dyn_cast_or_null<JSONObject>(bench->get("wallTime"));
+    auto *value = summary
+        ? llvm::dyn_cast_or_null<JSONNumber>(summary->get(key))
+        : nullptr;
+    return value ? llvm::Optional<double>(value->getValue()) : llvm::None;
+  };
+
+  unsigned numRegressions = 0;
+  for (const BenchmarkResult &result : results) {
+    auto *bench =
+        llvm::dyn_cast_or_null<JSONObject>(benchmarks->get(result.name));
+    if (!bench || !result.error.empty())
+      continue;
+    auto baseMedian = wallTime(bench, "median");
+    auto baseHigh = wallTime(bench, "ci95High");
+    if (!baseMedian || !baseHigh)
+      continue;
+    std::vector<double> values;
+    for (const Sample &sample : result.samples)
+      values.push_back(sample.wallTime);
+    Summary now = summarize(values);
+    if (now.ciLow <= *baseHigh)
+      continue;
+    ++numRegressions;
+    llvm::errs() << "Regression in " << result.name << ": median wall time "
+                 << llvm::format("%.6f", *baseMedian) << "s -> "
+                 << llvm::format("%.6f", now.median) << "s ("
+                 << llvm::format("%+.1f", (now.median / *baseMedian - 1) * 100)
+                 << "%)\n";
+  }
+  return numRegressions;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM initLLVM(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "Hermes benchmark runner\n");
+
+  if (Iterations == 0) {
+    llvm::errs() << "Error: -iterations must be at least 1\n";
+    return 2;
+  }
+
+  std::vector<BenchmarkResult> results;
+  bool success = true;
+  for (const std::string &filename : InputFilenames) {
+    results.push_back(runBenchmark(filename));
+    if (!results.back().error.empty()) {
+      llvm::errs() << "Error running " << filename << ":\n"
+                   << results.back().error << "\n";
+      success = false;
+    }
+  }
+
+  std::error_code ec;
+  llvm::raw_fd_ostream os(OutputFilename, ec, llvm::sys::fs::F_Text);
+  if (ec) {
+    llvm::errs() << "Error: failed to open " << OutputFilename << ": "
+                 << ec.message() << "\n";
+    return 2;
+  }
+  emitReport(os, results);
+
+  if (!BaselineFilename.empty() && checkBaseline(BaselineFilename, results))
+    return 1;
+  return success ? 0 : 1;
+}
@@ -32,6 +32,10 @@
 ///
 /// If, on the other hand, it is faster, then we can focus on higher level
 /// optimizations.
+///
+/// To compare the dispatch strategies of the interpreter, run it from builds
+/// with and without HERMESVM_TAIL_CALL_DISPATCH. With it, the loops of this
+/// benchmark run in the tail-call handlers of Interpreter-tailcall.cpp.
 //===----------------------------------------------------------------------===//
 #include "hermes/BCGen/HBC/BytecodeGenerator.h"
 #include "hermes/VM/CodeBlock.h"
@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+// A JSON-heavy API client: pages of a feed are served as JSON text, parsed,
+// normalized into a store of entities by id, merged with the entities seen
+// before, turned into view models, and the client's requests are serialized
+// back to JSON. Most of the allocations live until the next page replaces
+// them, which keeps the GC busy.
+
+(function() {
+  var numPages = 120;
+  var pageSize = 50;
+
+  function makeUser(id) {
+    return {
+      id: 'user:' + id,
+      name: 'User ' + id,
+      avatar: {uri: 'https://example.com/a/' + id + '.png', width: 64},
+      verified: id % 3 === 0,
+      followers: id * 37,
+    };
+  }
+
+  // The server side: render a page of the feed to JSON.
+  function serveFeedPage(page) {
+    var stories = [];
+    for (var i = 0; i < pageSize; i++) {
+      var id = page * pageSize + i;
+      var comments = [];
+      for (var j = 0; j < id % 5; j++) {
+        comments.push({
+          id: 'comment:' + id + ':' + j,
+          author: makeUser((id + j) % 97),
+          text: 'Comment ' + j + ' on story ' + id,
+          likes: (id * j) % 13,
+        });
+      }
+      stories.push({
+        id: 'story:' + id,
+        author: makeUser(id % 97),
+        title: 'Story number ' + id,
+        body: 'Lorem ipsum dolor sit amet, consectetur adipiscing elit ' + id,
+        createdAt: 1500000000 + id * 60,
+        tags: ['news', id % 2 ? 'sports' : 'tech', 'tag' + (id % 10)],
+        comments: comments,
+        attachment:
+          id % 4 === 0
+            ? {type: 'photo', uri: 'https://example.com/p/' + id + '.jpg'}
+            : null,
+      });
+    }
+    return JSON.stringify({
+      data: {feed: {stories: stories, cursor: 'cursor:' + (page + 1)}},
+    });
+  }
+
+  var store = {};
+
+  // Replace every object with an id by a reference to it in the store,
+  // merging its fields into the copy already there.
+  function normalize(value) {
+    if (Array.isArray(value)) {
+      var arr = [];
+      for (var i = 0; i < value.length; i++) {
+        arr.push(normalize(value[i]));
+      }
+      return arr;
+    }
+    if (value === null || typeof value !== 'object') {
+      return value;
+    }
+    var record = {};
+    for (var key in value) {
+      record[key] = normalize(value[key]);
+    }
+    if (typeof value.id !== 'string') {
+      return record;
+    }
+    var existing = store[value.id];
+    if (existing) {
+      for (key in record) {
+        existing[key] = record[key];
+      }
+    } else {
+      store[value.id] = record;
+    }
+    return {__ref: value.id};
+  }
+
+  function resolve(ref) {
+    return store[ref.__ref];
+  }
+
+  function storyViewModel(ref) {
+    var story = resolve(ref);
+    var author = resolve(story.author);
+    var numLikes = 0;
+    var commenters = [];
+    for (var i = 0; i < story.comments.length; i++) {
+      var comment = resolve(story.comments[i]);
+      numLikes += comment.likes;
+      commenters.push(resolve(comment.author).name);
+    }
+    return {
+      key: story.id,
+      heading: story.title + ' by ' + author.name,
+      badge: author.verified ? 'verified' : '',
+      summary: story.body.slice(0, 40),
+      date: new Date(story.createdAt * 1000).toISOString(),
+      tags: story.tags.join(', '),
+      commentSummary: commenters.length + ' comments, ' + numLikes + ' likes',
+      hasPhoto: story.attachment !== null,
+    };
+  }
+
+  var checksum = 0;
+  var cursor = null;
+  for (var page = 0; page < numPages; page++) {
+    var request = JSON.stringify({
+      query: 'FeedQuery',
+      variables: {first: pageSize, after: cursor, scale: 2},
+    });
+    checksum += request.length;
+
+    var response = JSON.parse(serveFeedPage(page));
+    var feed = normalize(response.data.feed);
+    cursor = feed.cursor;
+    var views = [];
+    for (var i = 0; i < feed.stories.length; i++) {
+      views.push(storyViewModel(feed.stories[i]));
+    }
+    // Persist the page as the client would cache it.
+    checksum += JSON.stringify(views).length;
+  }
+
+  print('done', checksum, Object.keys(store).length);
+})();
@@ -0,0 +1,426 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+// The cold start of an application bundle: the module system defines every
+// module of the bundle, then requires the entry point, which initializes the
+// modules it needs at startup (constants, string tables, style sheets, a
+// component registry and the first screen) while most of the bundle is only
+// defined. It runs once, so it is meant to be run in a fresh runtime, which is
+// what the harness does by default.
+
+var __modules = {};
+
+function __d(factory, id, dependencies) {
+  __modules[id] = {
+    factory: factory,
+    dependencies: dependencies,
+    exports: undefined,
+    initialized: false,
+  };
+}
+
+function __r(id) {
+  var module = __modules[id];
+  if (!module.initialized) {
+    module.initialized = true;
+    var exports = {};
+    var moduleObject = {exports: exports};
+    module.factory(__r, moduleObject, exports, module.dependencies);
+    module.exports = moduleObject.exports;
+  }
+  return module.exports;
+}
+
+// 0: constants.
+__d(
+  function(require, module, exports) {
+    exports.Colors = {
+      primary: '#1877f2',
+      secondary: '#42b72a',
+      background: '#ffffff',
+      text: '#1c1e21',
+      muted: '#606770',
+      error: '#fa383e',
+    };
+    exports.Spacing = {xs: 2, s: 4, m: 8, l: 16, xl: 32};
+    exports.Routes = ['Home', 'Feed', 'Profile', 'Settings', 'Search'];
+    exports.Flags = Object.freeze({
+      newFeed: true,
+      darkMode: false,
+      prefetch: true,
+    });
+  },
+  0,
+  [],
+);
+
+// 1: string tables.
+__d(
+  function(require, module, exports) {
+    var tables = {};
+    var locales = ['en', 'fr', 'de', 'es', 'it', 'pt', 'ja', 'ko'];
+    var keys = [
+      'welcome',
+      'login',
+      'logout',
+      'feed',
+      'profile',
+      'settings',
+      'search',
+      'like',
+      'comment',
+      'share',
+      'save',
+      'cancel',
+      'retry',
+      'error',
+      'loading',
+      'empty',
+    ];
+    for (var i = 0; i < locales.length; i++) {
+      var table = {};
+      for (var j = 0; j < keys.length; j++) {
+        table[keys[j]] = locales[i] + ':' + keys[j];
+      }
+      tables[locales[i]] = table;
+    }
+    exports.translate = function(locale, key) {
+      return (tables[locale] || tables.en)[key] || key;
+    };
+  },
+  1,
+  [],
+);
+
+// 2: style sheets.
+__d(
+  function(require, module, exports, deps) {
+    var constants = require(deps[0]);
+    var nextId = 1;
+    var registry = {};
+    exports.create = function(styles) {
+      var result = {};
+      for (var name in styles) {
+        var id = nextId++;
+        registry[id] = Object.freeze(styles[name]);
+        result[name] = id;
+      }
+      return result;
+    };
+    exports.flatten = function(id) {
+      return registry[id];
+    };
+    exports.common = exports.create({
+      container: {flex: 1, backgroundColor: constants.Colors.background},
+      row: {flexDirection: 'row', padding: constants.Spacing.m},
+      title: {fontSize: 20, fontWeight: 'bold', color: constants.Colors.text},
+      subtitle: {fontSize: 14, color: constants.Colors.muted},
+      button: {
+        padding: constants.Spacing.m,
+        borderRadius: 4,
+        backgroundColor: constants.Colors.primary,
+      },
+      error: {color: constants.Colors.error},
+    });
+  },
+  2,
+  [0],
+);
+
+// 3: event emitter.
+__d(
+  function(require, module) {
+    function EventEmitter() {
+      this._listeners = {};
+    }
+    EventEmitter.prototype.addListener = function(type, listener) {
+      (this._listeners[type] || (this._listeners[type] = [])).push(listener);
+      var listeners = this._listeners[type];
+      return {
+        remove: function() {
+          listeners.splice(listeners.indexOf(listener), 1);
+        },
+      };
+    };
+    EventEmitter.prototype.emit = function(type) {
+      var listeners = this._listeners[type];
+      if (!listeners) {
+        return;
+      }
+      var args = Array.prototype.slice.call(arguments, 1);
+      for (var i = 0; i < listeners.length; i++) {
+        listeners[i].apply(null, args);
+      }
+    };
+    module.exports = EventEmitter;
+  },
+  3,
+  [],
+);
+
+// 4: component base.
+__d(
+  function(require, module) {
+    function Component(props) {
+      this.props = props;
+      this.state = {};
+    }
+    Component.prototype.setState = function(partial) {
+      var state = {};
+      for (var key in this.state) {
+        state[key] = this.state[key];
+      }
+      for (key in partial) {
+        state[key] = partial[key];
+      }
+      this.state = state;
+    };
+    Component.extend = function(name, methods) {
+      function Subclass(props) {
+        Component.call(this, props);
+        if (this.init) {
+          this.init();
+        }
+      }
+      Subclass.prototype = Object.create(Component.prototype);
+      Subclass.prototype.constructor = Subclass;
+      Subclass.displayName = name;
+      for (var key in methods) {
+        Subclass.prototype[key] = methods[key];
+      }
+      return Subclass;
+    };
+    module.exports = Component;
+  },
+  4,
+  [],
+);
+
+// 5: element factory.
+__d(
+  function(require, module, exports) {
+    exports.createElement = function(type, props) {
+      var children = [];
+      for (var i = 2; i < arguments.length; i++) {
+        children.push(arguments[i]);
+      }
+      return {type: type, props: props || {}, children: children};
+    };
+    exports.render = function render(element) {
+      if (typeof element !== 'object' || element === null) {
+        return 1;
+      }
+      var count = 1;
+      if (typeof element.type === 'function') {
+        var instance = new element.type(element.props);
+        return count + render(instance.render());
+      }
+      for (var i = 0; i < element.children.length; i++) {
+        count += render(element.children[i]);
+      }
+      return count;
+    };
+  },
+  5,
+  [],
+);
+
+// 6: navigation.
+__d(
+  function(require, module, exports, deps) {
+    var EventEmitter = require(deps[0]);
+    var constants = require(deps[1]);
+    var emitter = new EventEmitter();
+    var stack = [constants.Routes[0]];
+    exports.push = function(route) {
+      stack.push(route);
+      emitter.emit('change', route);
+    };
+    exports.pop = function() {
+      var route = stack.pop();
+      emitter.emit('change', stack[stack.length - 1]);
+      return route;
+    };
+    exports.current = function() {
+      return stack[stack.length - 1];
+    };
+    exports.onChange = function(listener) {
+      return emitter.addListener('change', listener);
+    };
+  },
+  6,
+  [3, 0],
+);
+
+// 7: network (not needed at startup).
+__d(
+  function(require, module, exports) {
+    var pending = {};
+    var nextRequestId = 1;
+    exports.fetch = function(url, options) {
+      var id = nextRequestId++;
+      pending[id] = {url: url, options: options || {}, retries: 0};
+      return id;
+    };
+    exports.cancel = function(id) {
+      delete pending[id];
+    };
+  },
+  7,
+  [],
+);
+
+// 8: date formatting (not needed at startup).
+__d(
+  function(require, module, exports) {
+    var months = [
+      'Jan',
+      'Feb',
+      'Mar',
+      'Apr',
+      'May',
+      'Jun',
+      'Jul',
+      'Aug',
+      'Sep',
+      'Oct',
+      'Nov',
+      'Dec',
+    ];
+    exports.format = function(timestamp) {
+      var date = new Date(timestamp);
+      return months[date.getUTCMonth()] + ' ' + date.getUTCDate();
+    };
+    exports.relative = function(timestamp, now) {
+      var seconds = Math.floor((now - timestamp) / 1000);
+      if (seconds < 60) {
+        return 'just now';
+      }
+      if (seconds < 3600) {
+        return Math.floor(seconds / 60) + 'm';
+      }
+      return Math.floor(seconds / 3600) + 'h';
+    };
+  },
+  8,
+  [],
+);
+
+// 9: settings screen (not needed at startup).
+__d(
+  function(require, module, exports, deps) {
+    var Component = require(deps[0]);
+    var React = require(deps[1]);
+    module.exports = Component.extend('SettingsScreen', {
+      render: function() {
+        return React.createElement(
+          'view',
+          null,
+          React.createElement('text', null, 'Settings'),
+        );
+      },
+    });
+  },
+  9,
+  [4, 5],
+);
+
+// 10: the home screen.
+__d(
+  function(require, module, exports, deps) {
+    var Component = require(deps[0]);
+    var React = require(deps[1]);
+    var styles = require(deps[2]);
+    var i18n = require(deps[3]);
+
+    var StoryRow = Component.extend('StoryRow', {
+      render: function() {
+        return React.createElement(
+          'view',
+          {style: styles.common.row},
+          React.createElement(
+            'text',
+            {style: styles.common.title},
+            this.props.story.title,
+          ),
+          React.createElement(
+            'text',
+            {style: styles.common.subtitle},
+            this.props.story.author,
+          ),
+          React.createElement(
+            'view',
+            {style: styles.common.button},
+            i18n.translate(this.props.locale, 'like'),
+          ),
+        );
+      },
+    });
+
+    module.exports = Component.extend('HomeScreen', {
+      init: function() {
+        var stories = [];
+        for (var i = 0; i < 30; i++) {
+          stories.push({id: i, title: 'Story ' + i, author: 'Author ' + i});
+        }
+        this.setState({stories: stories, locale: this.props.locale});
+      },
+      render: function() {
+        var rows = [];
+        for (var i = 0; i < this.state.stories.length; i++) {
+          rows.push(
+            React.createElement(StoryRow, {
+              story: this.state.stories[i],
+              locale: this.state.locale,
+            }),
+          );
+        }
+        return React.createElement.apply(
+          null,
+          ['view', {style: styles.common.container}].concat(rows),
+        );
+      },
+    });
+  },
+  10,
+  [4, 5, 2, 1],
+);
+
+// 11: the entry point.
+__d(
+  function(require, module, exports, deps) {
+    var React = require(deps[0]);
+    var navigation = require(deps[1]);
+    var HomeScreen = require(deps[2]);
+    var constants = require(deps[3]);
+
+    var renders = 0;
+    navigation.onChange(function() {
+      renders++;
+    });
+    var locale = constants.Flags.newFeed ? 'fr' : 'en';
+    var count = React.render(
+      React.createElement(HomeScreen, {locale: locale}),
+    );
+    navigation.push(constants.Routes[1]);
+    navigation.pop();
+    exports.result = count + renders;
+  },
+  11,
+  [5, 6, 10, 0],
+);
+
+var numInitialized = 0;
+var result = __r(11).result;
+for (var id in __modules) {
+  if (__modules[id].initialized) {
+    numInitialized++;
+  }
+}
+print('done', result, numInitialized);
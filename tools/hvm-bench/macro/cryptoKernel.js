@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+// A crypto kernel on typed arrays: messages filled by a xorshift generator
+// are hashed with SHA-256 and checksummed with a table-driven CRC-32, as a
+// client would before uploading them. Nearly everything is integer arithmetic
+// on typed arrays, with almost no allocation.
+
+(function() {
+  var numMessages = 40;
+  var messageSize = 16 * 1024;
+
+  var K = new Uint32Array([
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+  ]);
+
+  var W = new Uint32Array(64);
+
+  // Hash the 64-byte blocks of bytes into the state H.
+  function sha256Blocks(H, bytes, length) {
+    for (var offset = 0; offset + 64 <= length; offset += 64) {
+      var i;
+      for (i = 0; i < 16; i++) {
+        var p = offset + i * 4;
+        W[i] =
+          (bytes[p] << 24) |
+          (bytes[p + 1] << 16) |
+          (bytes[p + 2] << 8) |
+          bytes[p + 3];
+      }
+      for (i = 16; i < 64; i++) {
+        var w15 = W[i - 15];
+        var w2 = W[i - 2];
+        var s0 = ((w15 >>> 7) | (w15 << 25)) ^ ((w15 >>> 18) | (w15 << 14)) ^
+          (w15 >>> 3);
+        var s1 = ((w2 >>> 17) | (w2 << 15)) ^ ((w2 >>> 19) | (w2 << 13)) ^
+          (w2 >>> 10);
+        W[i] = (W[i - 16] + s0 + W[i - 7] + s1) | 0;
+      }
+      var a = H[0];
+      var b = H[1];
+      var c = H[2];
+      var d = H[3];
+      var e = H[4];
+      var f = H[5];
+      var g = H[6];
+      var h = H[7];
+      for (i = 0; i < 64; i++) {
+        var S1 = ((e >>> 6) | (e << 26)) ^ ((e >>> 11) | (e << 21)) ^
+          ((e >>> 25) | (e << 7));
+        var ch = (e & f) ^ (~e & g);
+        var t1 = (h + S1 + ch + K[i] + W[i]) | 0;
+        var S0 = ((a >>> 2) | (a << 30)) ^ ((a >>> 13) | (a << 19)) ^
+          ((a >>> 22) | (a << 10));
+        var maj = (a & b) ^ (a & c) ^ (b & c);
+        var t2 = (S0 + maj) | 0;
+        h = g;
+        g = f;
+        f = e;
+        e = (d + t1) | 0;
+        d = c;
+        c = b;
+        b = a;
+        a = (t1 + t2) | 0;
+      }
+      H[0] += a;
+      H[1] += b;
+      H[2] += c;
+      H[3] += d;
+      H[4] += e;
+      H[5] += f;
+      H[6] += g;
+      H[7] += h;
+    }
+  }
+
+  var padded = new Uint8Array(messageSize + 128);
+
+  function sha256(message) {
+    var H = new Uint32Array([
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c,
+      0x1f83d9ab, 0x5be0cd19,
+    ]);
+    var length = message.length;
+    padded.set(message);
+    padded[length] = 0x80;
+    var paddedLength = (length + 9 + 63) & ~63;
+    padded.fill(0, length + 1, paddedLength);
+    var bits = length * 8;
+    padded[paddedLength - 4] = bits >>> 24;
+    padded[paddedLength - 3] = bits >>> 16;
+    padded[paddedLength - 2] = bits >>> 8;
+    padded[paddedLength - 1] = bits;
+    sha256Blocks(H, padded, paddedLength);
+    return H;
+  }
+
+  var crcTable = new Int32Array(256);
+  for (var n = 0; n < 256; n++) {
+    var crc = n;
+    for (var k = 0; k < 8; k++) {
+      crc = crc & 1 ? 0xedb88320 ^ (crc >>> 1) : crc >>> 1;
+    }
+    crcTable[n] = crc;
+  }
+
+  function crc32(bytes) {
+    var crc = -1;
+    for (var i = 0; i < bytes.length; i++) {
+      crc = crcTable[(crc ^ bytes[i]) & 0xff] ^ (crc >>> 8);
+    }
+    return (crc ^ -1) >>> 0;
+  }
+
+  var state = 0x12345678;
+  function xorshift() {
+    state ^= state << 13;
+    state ^= state >>> 17;
+    state ^= state << 5;
+    return state >>> 0;
+  }
+
+  var message = new Uint8Array(messageSize);
+  var words = new Uint32Array(message.buffer);
+  var digest = 0;
+  for (var m = 0; m < numMessages; m++) {
+    for (var i = 0; i < words.length; i++) {
+      words[i] = xorshift();
+    }
+    var H = sha256(message);
+    digest = (digest ^ H[0] ^ H[7] ^ crc32(message)) >>> 0;
+  }
+
+  print('done', digest.toString(16));
+})();
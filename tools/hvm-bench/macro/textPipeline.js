@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+// A regex and text processing pipeline: an access log is split into lines,
+// each line is parsed with a regex, the requests are aggregated, the paths
+// are tokenized and counted, and a report is rendered as escaped HTML with
+// template substitutions done by replace() callbacks.
+
+(function() {
+  var numRounds = 8;
+  var numLines = 3000;
+
+  var methods = ['GET', 'POST', 'PUT', 'DELETE'];
+  var paths = [
+    '/api/v1/users',
+    '/api/v1/users/profile',
+    '/api/v2/feed?cursor=abc&limit=20',
+    '/static/js/main.bundle.js',
+    '/search?q=hermes+engine&lang=en',
+    '/login',
+  ];
+  var lines = [];
+  for (var i = 0; i < numLines; i++) {
+    lines.push(
+      '10.0.' +
+        (i % 256) +
+        '.' +
+        ((i * 7) % 256) +
+        ' user' +
+        (i % 50) +
+        ' [15/Oct/2019:10:' +
+        (10 + (i % 50)) +
+        ':00 +0000] "' +
+        methods[i % methods.length] +
+        ' ' +
+        paths[i % paths.length] +
+        ' HTTP/1.1" ' +
+        (i % 17 === 0 ? 500 : i % 5 === 0 ? 404 : 200) +
+        ' ' +
+        ((i * 131) % 10000),
+    );
+  }
+  var log = lines.join('\n');
+
+  var lineRegExp = /^(\S+) (\S+) \[([^\]]+)\] "(\w+) ([^"]*?) HTTP\/[\d.]+" (\d{3}) (\d+)$/;
+  var templateRegExp = /\{\{\s*(\w+)\s*\}\}/g;
+  var escapes = {'&': '&amp;', '<': '&lt;', '>': '&gt;', '"': '&quot;'};
+
+  function escapeHTML(s) {
+    return s.replace(/[&<>"]/g, function(c) {
+      return escapes[c];
+    });
+  }
+
+  function fill(template, values) {
+    return template.replace(templateRegExp, function(match, name) {
+      return escapeHTML(String(values[name]));
+    });
+  }
+
+  var rowTemplate =
+    '<tr class="{{ cls }}"><td>{{path}}</td><td>{{ count }}</td>' +
+    '<td>{{bytes}}</td></tr>';
+  var checksum = 0;
+
+  for (var round = 0; round < numRounds; round++) {
+    var byPath = {};
+    var words = {};
+    var numErrors = 0;
+    var entries = log.split('\n');
+    for (var i = 0; i < entries.length; i++) {
+      var m = lineRegExp.exec(entries[i]);
+      if (!m) {
+        continue;
+      }
+      var status = parseInt(m[6], 10);
+      if (status >= 500) {
+        numErrors++;
+      }
+      var path = m[5].split('?')[0];
+      var stats = byPath[path] || (byPath[path] = {count: 0, bytes: 0});
+      stats.count++;
+      stats.bytes += parseInt(m[7], 10);
+
+      var tokens = m[5].toLowerCase().split(/[\/?&=+.]+/);
+      for (var j = 0; j < tokens.length; j++) {
+        var token = tokens[j];
+        if (token.length > 1 && !/^\d+$/.test(token)) {
+          words[token] = (words[token] || 0) + 1;
+        }
+      }
+    }
+
+    var rows = [];
+    var keys = Object.keys(byPath).sort();
+    for (var k = 0; k < keys.length; k++) {
+      rows.push(
+        fill(rowTemplate, {
+          cls: k % 2 ? 'odd' : 'even',
+          path: keys[k] + ' <' + methods[k % methods.length] + '>',
+          count: byPath[keys[k]].count,
+          bytes: byPath[keys[k]].bytes,
+        }),
+      );
+    }
+    var topWords = Object.keys(words)
+      .sort(function(a, b) {
+        return words[b] - words[a] || (a < b ? -1 : 1);
+      })
+      .slice(0, 10)
+      .join(' ');
+    var html =
+      '<table>' +
+      rows.join('') +
+      '</table><p>' +
+      escapeHTML(topWords + ' & ' + numErrors + ' errors') +
+      '</p>';
+    checksum += html.length;
+  }
+
+  print('done', checksum);
+})();
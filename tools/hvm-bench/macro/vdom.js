@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+// A virtual DOM render loop: every frame renders a list of rows from changing
+// data into a new tree of short-lived vnodes, diffs it against the previous
+// frame and applies the patches to a mock DOM. Elements of different kinds
+// have props of different shapes, so the property accesses of the diff are
+// polymorphic.
+
+(function() {
+  var numFrames = 300;
+  var numRows = 200;
+
+  function h(tag, props, children) {
+    return {tag: tag, props: props, children: children, key: props.key};
+  }
+
+  function text(value) {
+    return {tag: '#text', props: null, children: null, value: String(value)};
+  }
+
+  function createElement(vnode) {
+    var node = {tag: vnode.tag, attrs: {}, children: [], text: vnode.value};
+    if (vnode.props) {
+      for (var name in vnode.props) {
+        node.attrs[name] = vnode.props[name];
+      }
+    }
+    if (vnode.children) {
+      for (var i = 0; i < vnode.children.length; i++) {
+        node.children.push(createElement(vnode.children[i]));
+      }
+    }
+    return node;
+  }
+
+  var numPatches = 0;
+
+  function patchProps(node, oldProps, newProps) {
+    var name;
+    for (name in newProps) {
+      if (oldProps[name] !== newProps[name]) {
+        node.attrs[name] = newProps[name];
+        numPatches++;
+      }
+    }
+    for (name in oldProps) {
+      if (!(name in newProps)) {
+        delete node.attrs[name];
+        numPatches++;
+      }
+    }
+  }
+
+  function patch(node, oldVnode, newVnode) {
+    if (oldVnode.tag !== newVnode.tag) {
+      numPatches++;
+      return createElement(newVnode);
+    }
+    if (newVnode.tag === '#text') {
+      if (oldVnode.value !== newVnode.value) {
+        node.text = newVnode.value;
+        numPatches++;
+      }
+      return node;
+    }
+    patchProps(node, oldVnode.props, newVnode.props);
+    patchChildren(node, oldVnode.children, newVnode.children);
+    return node;
+  }
+
+  function patchChildren(node, oldChildren, newChildren) {
+    // Match the children by key where they have one, else by index.
+    var oldByKey = {};
+    var i;
+    for (i = 0; i < oldChildren.length; i++) {
+      var key = oldChildren[i].key;
+      if (key !== undefined) {
+        oldByKey[key] = i;
+      }
+    }
+    var children = [];
+    for (i = 0; i < newChildren.length; i++) {
+      var newChild = newChildren[i];
+      var oldIndex =
+        newChild.key !== undefined ? oldByKey[newChild.key] : i;
+      if (oldIndex !== undefined && oldIndex < oldChildren.length) {
+        children.push(
+          patch(node.children[oldIndex], oldChildren[oldIndex], newChild),
+        );
+      } else {
+        children.push(createElement(newChild));
+        numPatches++;
+      }
+    }
+    if (children.length !== node.children.length) {
+      numPatches++;
+    }
+    node.children = children;
+  }
+
+  function renderRow(item, selected) {
+    return h(
+      'tr',
+      {key: item.id, className: item.id === selected ? 'selected' : ''},
+      [
+        h('td', {className: 'id'}, [text(item.id)]),
+        h('td', {className: 'label', title: item.label}, [text(item.label)]),
+        h('td', {className: 'count', style: 'width: 10%'}, [
+          text(item.count),
+        ]),
+        item.done
+          ? h('td', {className: 'done', checked: true}, [text('done')])
+          : h('td', {className: 'todo', onclick: item.id}, [
+              h('a', {href: '#' + item.id}, [text('mark done')]),
+            ]),
+      ],
+    );
+  }
+
+  function render(state) {
+    var rows = [];
+    for (var i = 0; i < state.items.length; i++) {
+      rows.push(renderRow(state.items[i], state.selected));
+    }
+    return h('div', {id: 'app'}, [
+      h('h1', {className: 'title'}, [text('Items: ' + state.items.length)]),
+      h('table', {className: 'table'}, [h('tbody', {}, rows)]),
+    ]);
+  }
+
+  var labels = ['alpha', 'beta', 'gamma', 'delta', 'epsilon', 'zeta'];
+  var state = {items: [], selected: -1};
+  var nextId = 0;
+  for (var i = 0; i < numRows; i++) {
+    state.items.push({
+      id: nextId++,
+      label: labels[i % labels.length] + ' ' + i,
+      count: 0,
+      done: false,
+    });
+  }
+
+  var vtree = render(state);
+  var dom = createElement(vtree);
+  for (var frame = 0; frame < numFrames; frame++) {
+    // Update some rows, select one, and every few frames replace a row and
+    // move another one, as user interactions would.
+    var items = state.items.slice();
+    for (var j = frame % 7; j < items.length; j += 7) {
+      var item = items[j];
+      items[j] = {
+        id: item.id,
+        label: item.label,
+        count: item.count + 1,
+        done: item.done || (item.count + frame) % 11 === 0,
+      };
+    }
+    if (frame % 5 === 0) {
+      items.splice(frame % items.length, 1);
+      items.push({
+        id: nextId++,
+        label: labels[frame % labels.length] + ' new',
+        count: 0,
+        done: false,
+      });
+      items.unshift(items.pop());
+    }
+    state = {items: items, selected: items[frame % items.length].id};
+    var newVtree = render(state);
+    dom = patch(dom, vtree, newVtree);
+    vtree = newVtree;
+  }
+
+  print('done', numPatches);
+})();
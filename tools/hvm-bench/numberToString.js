@@ -0,0 +1,35 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 2000;
+  var len = 1000;
+  var fractions = [];
+  for (var i = 0; i < len; i++) {
+    fractions.push(i / 7 + 0.1);
+  }
+
+  var total = 0;
+  for (var i = 0; i < numIter; i++) {
+    // Small integers converted again and again, like indices used as keys.
+    for (var j = 0; j < 32; j++) {
+      total += String(j).length;
+    }
+    // Doubles needing their shortest digits.
+    for (var j = 0; j < len; j++) {
+      total += String(fractions[j]).length;
+    }
+    // Large integers and negative numbers.
+    for (var j = 0; j < 32; j++) {
+      total += String(-1e12 * j - j).length;
+    }
+  }
+
+  print('done');
+})();
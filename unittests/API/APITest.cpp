@@ -9,6 +9,10 @@
 #include <hermes/CompileJS.h>
 #include <hermes/hermes.h>
 
+#include <cstring>
+#include <sstream>
+#include <thread>
+
 using namespace facebook::jsi;
 using namespace facebook::hermes;
 
@@ -110,6 +114,88 @@ TEST_F(HermesRuntimeTest, PreparedJavaScriptBytecodeTest) {
   EXPECT_EQ(rt->global().getProperty(*rt, "q").getNumber(), 2);
 }
 
+TEST_F(HermesRuntimeTest, SharedBytecodeTest) {
+  std::string bytecode;
+  ASSERT_TRUE(hermes::compileJS(
+      "function f(x) {"
+      "  switch (x) { case 0: return 'a'; case 1: return 'b';"
+      "               case 2: return 'c'; case 3: return 'd'; }"
+      "  return 'e';"
+      "}"
+      "var s = '';"
+      "for (var i = 0; i < 5; ++i) s += f(i);",
+      bytecode));
+  auto buffer = std::make_shared<StringBuffer>(bytecode);
+  rt->evaluateSharedBytecode(buffer, "");
+  EXPECT_EQ(
+      rt->global().getProperty(*rt, "s").getString(*rt).utf8(*rt), "abcde");
+  // Nothing was written into the shared buffer.
+  EXPECT_EQ(0, std::memcmp(buffer->data(), bytecode.data(), bytecode.size()));
+
+  bool caught = false;
+  try {
+    rt->evaluateSharedBytecode(std::make_shared<StringBuffer>("x = 1"), "");
+  } catch (const facebook::jsi::JSIException &err) {
+    caught = true;
+  }
+  EXPECT_TRUE(caught) << "evaluateSharedBytecode should reject source";
+}
+
+TEST_F(HermesRuntimeTest, PrepareBytecodeOffThreadTest) {
+  eval("var q = 0;");
+  std::string bytecode;
+  ASSERT_TRUE(hermes::compileJS("q += 2", bytecode));
+  std::shared_ptr<const PreparedJavaScript> prep;
+  std::thread loader([&bytecode, &prep] {
+    prep = HermesRuntime::prepareBytecode(
+        std::make_shared<StringBuffer>(bytecode), "");
+  });
+  loader.join();
+  EXPECT_EQ(rt->global().getProperty(*rt, "q").getNumber(), 0);
+  rt->evaluatePreparedJavaScript(prep);
+  EXPECT_EQ(rt->global().getProperty(*rt, "q").getNumber(), 2);
+
+  bool caught = false;
+  try {
+    HermesRuntime::prepareBytecode(std::make_shared<StringBuffer>("q"), "");
+  } catch (const facebook::jsi::JSIException &err) {
+    caught = true;
+  }
+  EXPECT_TRUE(caught) << "prepareBytecode should reject source";
+}
+
+TEST_F(HermesRuntimeTest, PreparedJavaScriptSharedByRuntimesTest) {
+  // Large enough to be compiled lazily.
+  std::string source(1 << 17, ' ');
+  source +=
+      "function f(n) { return g(n) + 1; }"
+      "function g(n) { return n * 2; }";
+  auto prep = rt->prepareJavaScript(std::make_unique<StringBuffer>(source), "");
+
+  // The runtimes compile the lazy functions concurrently.
+  auto run = [&prep](int n, int *result) {
+    auto runtime = makeHermesRuntime();
+    runtime->evaluatePreparedJavaScript(prep);
+    *result = runtime->global()
+                  .getPropertyAsFunction(*runtime, "f")
+                  .call(*runtime, n)
+                  .getNumber();
+  };
+  int results[2] = {0, 0};
+  std::thread first(run, 1, &results[0]);
+  std::thread second(run, 2, &results[1]);
+  first.join();
+  second.join();
+  EXPECT_EQ(3, results[0]);
+  EXPECT_EQ(5, results[1]);
+
+  // This runtime finds them compiled.
+  rt->evaluatePreparedJavaScript(prep);
+  EXPECT_EQ(
+      7,
+      rt->global().getPropertyAsFunction(*rt, "f").call(*rt, 3).getNumber());
+}
+
 TEST_F(HermesRuntimeTest, PreparedJavaScriptInvalidSourceThrows) {
   const char *badSource = "this is definitely not valid javascript";
   bool caught = false;
@@ -192,6 +278,224 @@ TEST_F(HermesRuntimeTest, ReferencesCanEscapeScope) {
   EXPECT_EQ(rootsDelta, 1);
 }
 
+TEST_F(HermesRuntimeTest, ReuseRootsOfReleasedObjects) {
+  Object kept(*rt);
+  auto rootsDelta = HermesTestHelper::calculateRootsListChange(*rt, [&]() {
+    for (int i = 0; i < 100000; i++) {
+      Object obj(*rt);
+      obj.setProperty(*rt, "kept", kept);
+    }
+  });
+  // The released objects are freed without waiting for a collection, so
+  // the list stays within a few chunks.
+  EXPECT_LT(rootsDelta, 2048);
+}
+
+TEST_F(HermesRuntimeTest, GetAndSetPropertiesTest) {
+  Object obj = eval("({a: 1, b: 'two', get c() { return this.a + 2; }})")
+                   .getObject(*rt);
+  PropNameID names[] = {PropNameID::forAscii(*rt, "a"),
+                        PropNameID::forAscii(*rt, "b"),
+                        PropNameID::forAscii(*rt, "c"),
+                        PropNameID::forAscii(*rt, "d")};
+  Value values[4];
+  rt->getProperties(obj, names, 4, values);
+  EXPECT_EQ(values[0].getNumber(), 1);
+  EXPECT_EQ(values[1].getString(*rt).utf8(*rt), "two");
+  EXPECT_EQ(values[2].getNumber(), 3);
+  EXPECT_TRUE(values[3].isUndefined());
+
+  Value newValues[] = {Value(10), Value(true)};
+  rt->setProperties(obj, &names[0], newValues, 2);
+  EXPECT_EQ(obj.getProperty(*rt, "a").getNumber(), 10);
+  EXPECT_TRUE(obj.getProperty(*rt, "b").getBool());
+  EXPECT_EQ(obj.getProperty(*rt, "c").getNumber(), 12);
+
+  Object throwing = eval("({x: 1, get y() { throw new Error('y'); }})")
+                        .getObject(*rt);
+  PropNameID throwingNames[] = {PropNameID::forAscii(*rt, "x"),
+                                PropNameID::forAscii(*rt, "y")};
+  Value throwingValues[2];
+  EXPECT_THROW(
+      rt->getProperties(throwing, throwingNames, 2, throwingValues), JSError);
+  EXPECT_EQ(throwingValues[0].getNumber(), 1);
+}
+
+TEST_F(HermesRuntimeTest, CachedPropNameIDAccessTest) {
+  eval(
+      "var objs = [{x: 1, y: 2}, {x: 3, y: 4}, {y: 5, x: 6},"
+      "            Object.create({x: 7}), {get x() { return 8; }},"
+      "            Object.freeze({x: 9}), [10]];");
+  Array objs = rt->global().getPropertyAsObject(*rt, "objs").getArray(*rt);
+  PropNameID x = PropNameID::forAscii(*rt, "x");
+  const double expected[] = {1, 3, 6, 7, 8, 9};
+  // Each shape is seen twice, the second time from the cache.
+  for (int round = 0; round < 2; ++round) {
+    for (size_t i = 0; i < 6; ++i) {
+      Object obj = objs.getValueAtIndex(*rt, i).getObject(*rt);
+      EXPECT_EQ(obj.getProperty(*rt, x).getNumber(), expected[i]);
+    }
+  }
+
+  // A change of shape is not answered from the cache.
+  Object first = objs.getValueAtIndex(*rt, 0).getObject(*rt);
+  eval("Object.defineProperty(objs[0], 'x', {get: function() { return 0; }})");
+  EXPECT_EQ(first.getProperty(*rt, x).getNumber(), 0);
+
+  // Writes go through the cache, but not to read-only properties.
+  Object second = objs.getValueAtIndex(*rt, 1).getObject(*rt);
+  for (int i = 0; i < 3; ++i) {
+    second.setProperty(*rt, x, i);
+    EXPECT_EQ(eval("objs[1].x").getNumber(), i);
+  }
+  Object frozen = objs.getValueAtIndex(*rt, 5).getObject(*rt);
+  EXPECT_THROW(frozen.setProperty(*rt, x, 0), JSError);
+  EXPECT_EQ(frozen.getProperty(*rt, x).getNumber(), 9);
+
+  // Index-like names still reach the indexed storage of arrays.
+  Object array = objs.getValueAtIndex(*rt, 6).getObject(*rt);
+  PropNameID zero = PropNameID::forAscii(*rt, "0");
+  EXPECT_EQ(array.getProperty(*rt, zero).getNumber(), 10);
+  array.setProperty(*rt, zero, 11);
+  EXPECT_EQ(eval("objs[6][0]").getNumber(), 11);
+}
+
+TEST_F(HermesRuntimeTest, ExternalStringTest) {
+  std::string ascii(1000, 'a');
+  std::u16string utf16(1000, u'é');
+  int released = 0;
+  {
+    String asciiStr = rt->createExternalStringFromAscii(
+        ascii.data(), ascii.size(), [&released] { ++released; });
+    String utf16Str = rt->createExternalStringFromUtf16(
+        utf16.data(), utf16.size(), [&released] { ++released; });
+    EXPECT_EQ(asciiStr.utf8(*rt), ascii);
+    rt->global().setProperty(*rt, "s", utf16Str);
+    EXPECT_EQ(eval("s.length").getNumber(), 1000);
+    EXPECT_EQ(eval("s.charCodeAt(999)").getNumber(), 0xe9);
+    EXPECT_EQ(eval("s.slice(100, 900).charCodeAt(0)").getNumber(), 0xe9);
+    EXPECT_EQ(eval("(s + 'x').length").getNumber(), 1001);
+    EXPECT_EQ(released, 0);
+  }
+  eval("s = undefined; gc();");
+  EXPECT_EQ(released, 2);
+
+  // Short strings are copied, and their characters released right away.
+  String shortStr =
+      rt->createExternalStringFromAscii("short", 5, [&released] {
+        ++released;
+      });
+  EXPECT_EQ(released, 3);
+  EXPECT_EQ(shortStr.utf8(*rt), "short");
+}
+
+TEST_F(HermesRuntimeTest, ExternalArrayBufferTest) {
+  std::vector<uint8_t> frame(64, 1);
+  int released = 0;
+  ArrayBuffer buffer = rt->createExternalArrayBuffer(
+      frame.data(), frame.size(), [&released] { ++released; });
+  EXPECT_EQ(buffer.size(*rt), 64);
+  EXPECT_EQ(buffer.data(*rt), frame.data());
+  rt->global().setProperty(*rt, "frame", buffer);
+  // JS reads and writes the native bytes in place.
+  EXPECT_EQ(eval("new Uint8Array(frame)[63]").getNumber(), 1);
+  eval("new Uint8Array(frame)[0] = 42;");
+  EXPECT_EQ(frame[0], 42);
+
+  rt->detachArrayBuffer(buffer);
+  EXPECT_EQ(released, 1);
+  EXPECT_EQ(eval("frame.byteLength").getNumber(), 0);
+
+  // A buffer that is collected releases its bytes too.
+  {
+    ArrayBuffer collected = rt->createExternalArrayBuffer(
+        frame.data(), frame.size(), [&released] { ++released; });
+  }
+  eval("gc()");
+  EXPECT_EQ(released, 2);
+}
+
+TEST_F(HermesRuntimeTest, IndexedHostObjectTest) {
+  class Point : public IndexedHostObject {
+   public:
+    double coords[2] = {1, 2};
+    int namedGets = 0;
+
+    std::vector<PropNameID> getIndexedPropertyNames(Runtime &rt) override {
+      return PropNameID::names(rt, "x", "y");
+    }
+    Value getIndexed(Runtime &, unsigned index) override {
+      return coords[index];
+    }
+    void setIndexed(Runtime &, unsigned index, const Value &value) override {
+      coords[index] = value.getNumber();
+    }
+    Value get(Runtime &rt, const PropNameID &name) override {
+      ++namedGets;
+      return String::createFromUtf8(rt, name.utf8(rt));
+    }
+  };
+
+  auto point = std::make_shared<Point>();
+  rt->global().setProperty(*rt, "p", rt->createIndexedHostObject(point));
+  EXPECT_EQ(
+      eval("var sum = 0; for (var i = 0; i < 100; ++i) sum += p.x + p.y; sum")
+          .getNumber(),
+      300);
+  eval("p.x = 5; p['y'] = 6;");
+  EXPECT_EQ(point->coords[0], 5);
+  EXPECT_EQ(point->coords[1], 6);
+  // Other names go through get().
+  EXPECT_EQ(eval("p.z").getString(*rt).utf8(*rt), "z");
+  EXPECT_EQ(point->namedGets, 1);
+  EXPECT_EQ(
+      rt->global().getPropertyAsObject(*rt, "p").getHostObject<Point>(*rt),
+      point);
+}
+
+TEST_F(HermesRuntimeTest, InterruptTest) {
+  // Interrupts without a handler are ignored.
+  rt->requestInterrupt();
+  EXPECT_EQ(
+      eval("var n = 0; for (var i = 0; i < 10; ++i) ++n; n").getNumber(), 10);
+
+  int interrupts = 0;
+  rt->setInterruptHandler([&interrupts](HermesRuntime &rt) {
+    ++interrupts;
+    // Run a microtask, which may itself run loops.
+    rt.global().getPropertyAsFunction(rt, "microtask").call(rt);
+  });
+  eval(
+      "var ticks = 0;"
+      "function microtask() { for (var j = 0; j < 3; ++j); ++ticks; }");
+  // A long loop is preempted to run the handler. The request comes from the
+  // loop itself here, as it would from a scheduler thread.
+  rt->global().setProperty(
+      *rt,
+      "preempt",
+      Function::createFromHostFunction(
+          *rt,
+          PropNameID::forAscii(*rt, "preempt"),
+          0,
+          [this](Runtime &, const Value &, const Value *, size_t) {
+            rt->requestInterrupt();
+            return Value();
+          }));
+  EXPECT_EQ(
+      eval("for (var i = 0; i < 5; ++i) { var seen = ticks; preempt(); "
+           "  while (ticks === seen); } ticks")
+          .getNumber(),
+      5);
+  EXPECT_EQ(interrupts, 5);
+
+  // An exception thrown by the handler is thrown where it was taken.
+  rt->setInterruptHandler([](HermesRuntime &rt) {
+    throw JSError(rt, "preempted");
+  });
+  EXPECT_THROW(eval("preempt(); while (true);"), JSError);
+  rt->setInterruptHandler(nullptr);
+}
+
 TEST_F(HermesRuntimeTest, HostObjectWithOwnProperties) {
   class HostObjectWithPropertyNames : public HostObject {
     std::vector<PropNameID> getPropertyNames(Runtime &rt) override {
@@ -377,4 +681,169 @@ TEST_F(HermesRuntimeTest, GlobalObjectTest) {
   EXPECT_EQ(eval("f(10)").getNumber(), 15);
 }
 
+TEST_F(HermesRuntimeTest, JsonUtf8Test) {
+  const char json[] = "{\"name\": \"caf\xC3\xA9\", \"n\": [1, 2]}";
+  Value val = Value::createFromJsonUtf8(
+      *rt, reinterpret_cast<const uint8_t *>(json), sizeof(json) - 1);
+  Object obj = val.getObject(*rt);
+  EXPECT_EQ(
+      obj.getProperty(*rt, "name").getString(*rt).utf8(*rt), "caf\xC3\xA9");
+  EXPECT_EQ(
+      obj.getProperty(*rt, "n").getObject(*rt).getArray(*rt).size(*rt), 2u);
+
+  // Malformed UTF-8 is an error, even after a complete value.
+  for (const char *bad : {"\"abc\xFF\"", "\"abc\"\xFF", "[1, \"\xE2\x82"}) {
+    EXPECT_THROW(
+        Value::createFromJsonUtf8(
+            *rt, reinterpret_cast<const uint8_t *>(bad), strlen(bad)),
+        JSError);
+  }
+}
+
+TEST_F(HermesRuntimeTest, FunctionProfilingEnabledMidRunTest) {
+  HermesRuntime *hermes = rt.get();
+  rt->global().setProperty(
+      *rt,
+      "enableProfiling",
+      Function::createFromHostFunction(
+          *rt,
+          PropNameID::forAscii(*rt, "enableProfiling"),
+          0,
+          [hermes](Runtime &, const Value &, const Value *, size_t) {
+            hermes->enableFunctionProfiling();
+            return Value::undefined();
+          }));
+  // The calls of leaf run inline in the interpreter loop which was running
+  // when the profiler was enabled.
+  rt->evaluateJavaScript(
+      std::make_unique<StringBuffer>(
+          "function leaf(x) { return x + 1; }"
+          "function run() {"
+          "  enableProfiling();"
+          "  var s = 0;"
+          "  for (var i = 0; i < 5; i++) s = leaf(s);"
+          "  return s;"
+          "}"
+          "run();"),
+      "");
+
+  std::ostringstream summary;
+  rt->dumpFunctionProfileSummary(summary);
+  const std::string json = summary.str();
+  auto leaf = json.find("\"function\": \"leaf(");
+  ASSERT_NE(std::string::npos, leaf) << json;
+  EXPECT_EQ(json.find("\"calls\": 5", leaf), json.find("\"calls\"", leaf))
+      << json;
+}
+
+TEST_F(HermesRuntimeTest, MemoryPressureTest) {
+  Object live = eval("({values: new Array(1000).fill(1)})").getObject(*rt);
+  eval("var garbage = []; for (var i = 0; i < 10000; i++) garbage.push({i});");
+  eval("garbage = null");
+
+  EXPECT_GT(
+      rt->notifyMemoryPressure(::hermes::vm::MemoryPressureLevel::Critical),
+      0u);
+  rt->notifyMemoryPressure(::hermes::vm::MemoryPressureLevel::Moderate);
+
+  // The runtime keeps working, and the heap grows back as needed.
+  EXPECT_EQ(
+      live.getProperty(*rt, "values")
+          .getObject(*rt)
+          .getProperty(*rt, "length")
+          .getNumber(),
+      1000);
+  EXPECT_EQ(
+      eval("var a = []; for (var i = 0; i < 10000; i++) a.push({i}); a.length")
+          .getNumber(),
+      10000);
+}
+
+TEST(HermesRuntimeStoragePoolTest, RuntimesReusePooledStorage) {
+  HermesRuntime::drainStoragePool();
+  HermesRuntime::configureStoragePool(
+      64 << 20, ::hermes::vm::StoragePoolZeroing::Eager);
+  auto config = ::hermes::vm::RuntimeConfig::Builder()
+                    .withGCConfig(::hermes::vm::GCConfig::Builder()
+                                      .withPooledStorage(true)
+                                      .build())
+                    .build();
+  for (int i = 0; i < 3; ++i) {
+    auto rt = makeHermesRuntime(config);
+    EXPECT_EQ(
+        rt->evaluateJavaScript(
+              std::make_unique<StringBuffer>("[1, 2, 3].length"), "")
+            .getNumber(),
+        3);
+  }
+  // The storage of the last runtime was retained when it was destroyed.
+  EXPECT_GT(HermesRuntime::drainStoragePool(), 0u);
+  // Restore the defaults.
+  HermesRuntime::configureStoragePool(
+      64 << 20, ::hermes::vm::StoragePoolZeroing::None);
+}
+
+TEST(HermesRuntimeTeardownTest, FastTeardownFinalizesObservableCells) {
+  auto config =
+      ::hermes::vm::RuntimeConfig::Builder().withFastTeardown(true).build();
+  auto hostObject = std::make_shared<HostObject>();
+  std::weak_ptr<HostObject> weakHostObject = hostObject;
+  std::vector<uint8_t> frame(16, 0);
+  std::string chars(1024, 'x');
+  int released = 0;
+  const uint64_t leakedBefore = HermesRuntime::getFastTeardownLeakedBytes();
+  {
+    auto rt = makeHermesRuntime(config);
+    rt->global().setProperty(
+        *rt, "host", Object::createFromHostObject(*rt, std::move(hostObject)));
+    rt->global().setProperty(
+        *rt,
+        "frame",
+        rt->createExternalArrayBuffer(
+            frame.data(), frame.size(), [&released] { ++released; }));
+    rt->global().setProperty(
+        *rt,
+        "str",
+        rt->createExternalStringFromAscii(
+            chars.data(), chars.size(), [&released] { ++released; }));
+    rt->evaluateJavaScript(
+        std::make_unique<StringBuffer>(
+            "var objs = [];"
+            "for (var i = 0; i < 1000; i++)"
+            "  objs.push({i: i, m: new Map([[i, 'v' + i]])});"),
+        "");
+  }
+  // The embedder is told about the cells it created, even though the memory
+  // of the others is leaked, and counted.
+  EXPECT_TRUE(weakHostObject.expired());
+  EXPECT_EQ(released, 2);
+  EXPECT_LT(leakedBefore, HermesRuntime::getFastTeardownLeakedBytes());
+}
+
+#ifndef _WINDOWS
+TEST(HermesRuntimeSamplingProfilerTest, RuntimesSampledIndependently) {
+  auto rt1 = makeHermesRuntime();
+  auto rt2 = makeHermesRuntime();
+  rt1->enableOwnSamplingProfiler(std::chrono::microseconds(500));
+  rt2->enableOwnSamplingProfiler(std::chrono::milliseconds(2));
+  auto spin = [](HermesRuntime &rt) {
+    rt.evaluateJavaScript(
+        std::make_unique<StringBuffer>(
+            "var end = Date.now() + 50; while (Date.now() < end) {}"),
+        "");
+  };
+  spin(*rt1);
+  // Disabling one runtime's profiler leaves the other one sampling.
+  rt1->disableOwnSamplingProfiler();
+  spin(*rt2);
+  rt2->disableOwnSamplingProfiler();
+
+  std::ostringstream trace1, trace2;
+  rt1->dumpOwnSampledTrace(trace1);
+  rt2->dumpOwnSampledTrace(trace2);
+  EXPECT_NE(trace1.str().find("\"sf\""), std::string::npos);
+  EXPECT_NE(trace2.str().find("\"sf\""), std::string::npos);
+}
+#endif
+
 } // namespace
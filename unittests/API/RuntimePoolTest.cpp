@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <hermes/RuntimePool.h>
+#include <hermes/hermes.h>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+using namespace facebook::jsi;
+using namespace facebook::hermes;
+
+namespace {
+
+RuntimePool::Config poolConfig(unsigned numRuntimes) {
+  RuntimePool::Config config;
+  config.numRuntimes = numRuntimes;
+  config.init = [](HermesRuntime &rt) {
+    rt.evaluateJavaScript(
+        std::make_shared<StringBuffer>(
+            "var calls = 0; function square(x) { ++calls; return x * x; }"),
+        "init.js");
+  };
+  return config;
+}
+
+TEST(RuntimePoolTest, RunsTasks) {
+  RuntimePool pool(poolConfig(4));
+  EXPECT_EQ(pool.size(), 4);
+
+  std::vector<std::future<double>> results;
+  for (int i = 0; i < 100; ++i) {
+    results.push_back(pool.run([i](HermesRuntime &rt) {
+      return rt.global()
+          .getPropertyAsFunction(rt, "square")
+          .call(rt, i)
+          .getNumber();
+    }));
+  }
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(results[i].get(), i * i);
+
+  auto prepared = std::make_shared<StringBuffer>("square(3)");
+  pool.evaluatePreparedJavaScript(
+          makeHermesRuntime()->prepareJavaScript(prepared, "eval.js"))
+      .get();
+
+  RuntimePool::Stats stats = pool.getStats();
+  EXPECT_EQ(stats.tasksPending, 0);
+  uint64_t tasksRun = 0;
+  for (const auto &runtimeStats : stats.runtimes)
+    tasksRun += runtimeStats.tasksRun;
+  EXPECT_EQ(tasksRun, 101);
+}
+
+TEST(RuntimePoolTest, PinnedTasks) {
+  RuntimePool pool(poolConfig(3));
+  for (int i = 0; i < 10; ++i) {
+    pool.submitTo(1, [](HermesRuntime &rt) {
+      rt.global().getPropertyAsFunction(rt, "square").call(rt, 2);
+    });
+  }
+  // Tasks pinned to a runtime run in order, after the earlier ones.
+  auto calls = [&pool](unsigned index) {
+    std::promise<double> result;
+    pool.submitTo(index, [&result](HermesRuntime &rt) {
+      result.set_value(rt.global().getProperty(rt, "calls").getNumber());
+    });
+    return result.get_future().get();
+  };
+  EXPECT_EQ(calls(1), 10);
+  EXPECT_EQ(calls(0), 0);
+  EXPECT_EQ(calls(2), 0);
+}
+
+TEST(RuntimePoolTest, Exceptions) {
+  RuntimePool pool(poolConfig(2));
+  auto prepared = makeHermesRuntime()->prepareJavaScript(
+      std::make_shared<StringBuffer>("throw new Error('oops')"), "throw.js");
+  EXPECT_THROW(
+      pool.evaluatePreparedJavaScript(prepared).get(), JSINativeException);
+  auto result = pool.run([](HermesRuntime &) -> bool {
+    throw std::logic_error("returned");
+  });
+  EXPECT_THROW(result.get(), std::logic_error);
+
+  pool.submit([](HermesRuntime &) { throw std::runtime_error("dropped"); });
+  // The pool keeps running.
+  EXPECT_TRUE(pool.run([](HermesRuntime &) { return true; }).get());
+
+  RuntimePool::Config config = poolConfig(2);
+  config.init = [](HermesRuntime &) { throw std::runtime_error("init"); };
+  EXPECT_THROW(RuntimePool{config}, std::runtime_error);
+}
+
+TEST(RuntimePoolTest, StealsFromBusyRuntimes) {
+  RuntimePool pool(poolConfig(2));
+  // Block runtime 0, so that the tasks queued to it are stolen by runtime 1.
+  std::promise<void> unblock;
+  std::shared_future<void> unblocked = unblock.get_future().share();
+  pool.submitTo(0, [unblocked](HermesRuntime &) { unblocked.wait(); });
+  std::vector<std::future<bool>> results;
+  for (int i = 0; i < 10; ++i)
+    results.push_back(pool.run([](HermesRuntime &) { return true; }));
+  for (auto &result : results)
+    EXPECT_TRUE(result.get());
+  unblock.set_value();
+
+  RuntimePool::Stats stats = pool.getStats();
+  EXPECT_GT(stats.runtimes[1].tasksStolen, 0);
+}
+
+} // namespace
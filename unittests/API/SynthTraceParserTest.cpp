@@ -6,6 +6,7 @@
  */
 
 #ifdef HERMESVM_API_TRACE
+#include <hermes/SynthTraceBinary.h>
 #include <hermes/SynthTraceParser.h>
 
 #include <gtest/gtest.h>
@@ -167,6 +168,79 @@ TEST_F(SynthTraceParserTest, SynthMissingVersion) {
   EXPECT_NO_THROW(parseSynthTrace(bufFromStr(src)));
 }
 
+TEST_F(SynthTraceParserTest, BinaryRoundTrip) {
+  using TimeSinceStart = SynthTrace::TimeSinceStart;
+  std::string out;
+  SynthTrace trace(258);
+  ::hermes::vm::RuntimeConfig conf =
+      ::hermes::vm::RuntimeConfig::Builder()
+          .withGCConfig(::hermes::vm::GCConfig::Builder()
+                            .withMaxHeapSize(1 << 20)
+                            .withName("foo")
+                            .build())
+          .withVMExperimentFlags(123)
+          .build();
+  {
+    BinaryTraceWriter writer(
+        std::make_unique<llvm::raw_string_ostream>(out), 258, conf);
+    trace.setRecordStream(&writer);
+    trace.emplace_back<SynthTrace::CreateObjectRecord>(TimeSinceStart(1), 5);
+    trace.emplace_back<SynthTrace::SetPropertyRecord>(
+        TimeSinceStart(2), 5, "a", trace.encodeString("str"));
+    trace.emplace_back<SynthTrace::CallFromNativeRecord>(
+        TimeSinceStart(300),
+        7,
+        SynthTrace::encodeUndefined(),
+        std::vector<SynthTrace::TraceValue>{trace.encodeString("str"),
+                                            SynthTrace::encodeNumber(-1.5),
+                                            SynthTrace::encodeObject(5),
+                                            SynthTrace::encodeBool(true)});
+    trace.emplace_back<SynthTrace::ReturnToNativeRecord>(
+        TimeSinceStart(400), SynthTrace::encodeNull());
+    trace.setRecordStream(nullptr);
+    EXPECT_EQ(trace.records().size(), 0);
+    ::hermes::vm::MockedEnvironment env(42, {1, 2}, {3}, {"today"});
+    writer.finish(env);
+  }
+
+  auto result = parseSynthTrace(bufFromStr(out));
+  const SynthTrace &parsed = std::get<0>(result);
+  const hermes::vm::RuntimeConfig &rtconf = std::get<1>(result);
+  const hermes::vm::MockedEnvironment &env = std::get<2>(result);
+
+  EXPECT_EQ(parsed.globalObjID(), 258);
+  EXPECT_EQ(rtconf.getGCConfig().getMaxHeapSize(), 1 << 20);
+  EXPECT_EQ(rtconf.getGCConfig().getName(), "foo");
+  EXPECT_EQ(rtconf.getVMExperimentFlags(), 123);
+
+  ASSERT_EQ(parsed.records().size(), 4);
+  const auto &set =
+      static_cast<const SynthTrace::SetPropertyRecord &>(*parsed.records()[1]);
+  EXPECT_EQ(set.propName_, "a");
+  EXPECT_EQ(parsed.decodeString(set.value_), "str");
+  const auto &call = static_cast<const SynthTrace::CallFromNativeRecord &>(
+      *parsed.records()[2]);
+  EXPECT_EQ(call.time_, TimeSinceStart(300));
+  EXPECT_EQ(call.functionID_, 7);
+  ASSERT_EQ(call.args_.size(), 4);
+  EXPECT_TRUE(SynthTrace::equal(call.args_[0], set.value_));
+  EXPECT_EQ(call.args_[1].getNumber(), -1.5);
+  EXPECT_EQ(SynthTrace::decodeObject(call.args_[2]), 5);
+  EXPECT_TRUE(call.args_[3].getBool());
+  EXPECT_EQ(
+      parsed.records()[3]->getType(), SynthTrace::RecordType::ReturnToNative);
+
+  EXPECT_EQ(env.mathRandomSeed, 42);
+  EXPECT_EQ(env.callsToDateNow, std::deque<uint64_t>({1, 2}));
+  EXPECT_EQ(env.callsToNewDate, std::deque<uint64_t>({3}));
+  EXPECT_EQ(env.callsToDateAsFunction.front(), "today");
+
+  // A truncated trace is rejected.
+  EXPECT_THROW(
+      parseSynthTrace(bufFromStr(out.substr(0, out.size() - 3))),
+      std::invalid_argument);
+}
+
 } // namespace
 
 #endif
@@ -114,6 +114,30 @@ TEST(DebugInfo, TestLargeDeltas) {
   }
 }
 
+TEST(DebugInfo, TestRepeatedLookups) {
+  auto dbg = makeGenerator();
+
+  auto offset1 = dbg.appendSourceLocations(
+      Loc{0, 1, 1, 1, 0}, 0, {Loc{2, 1, 2, 3, 1}, Loc{6, 1, 4, 5, 2}});
+  auto offset2 = dbg.appendSourceLocations(
+      Loc{0, 1, 10, 1, 0}, 1, {Loc{4, 1, 11, 2, 1}});
+
+  DebugInfo info = dbg.serializeWithMove();
+
+  // Lookups out of order and between the addresses of two locations resolve
+  // to the last location at or before the address, whether or not the
+  // function was decoded by an earlier lookup.
+  for (int i = 0; i < 2; ++i) {
+    checkAddress(&info, offset1, 7, 1, 4, 5, 2);
+    checkAddress(&info, offset1, 1, 1, 1, 1, 0);
+    checkAddress(&info, offset2, 5, 1, 11, 2, 1);
+    checkAddress(&info, offset1, 3, 1, 2, 3, 1);
+    checkAddress(&info, offset2, 0, 1, 10, 1, 0);
+  }
+  EXPECT_EQ(7u, info.getLocationForAddress(offset1, 7)->address);
+  EXPECT_EQ(3u, info.getLocationsForFunction(offset1).size());
+}
+
 TEST(DebugInfo, TestGetAddress) {
   // Smoke test to make sure that the getAddressForLocation works.
   auto dbg = makeGenerator();
@@ -7,6 +7,7 @@
 
 #include "llvm/Support/raw_ostream.h"
 
+#include "hermes/BCGen/HBC/BytecodeCompression.h"
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
 #include "hermes/BCGen/HBC/BytecodeDisassembler.h"
 #include "hermes/BCGen/HBC/BytecodeGenerator.h"
@@ -129,9 +130,8 @@ TEST(HBCBytecodeGen, IntegrationTest) {
   SourceMapGenerator sourceMap;
   sourceMap.addSource("main.js");
   BM->populateSourceMap(&sourceMap);
-  const auto &mappings = sourceMap.getMappingsLines();
-  EXPECT_EQ(mappings.size(), 1u);
-  EXPECT_EQ(mappings[0].size(), 2u);
+  EXPECT_EQ(sourceMap.getNumMappingsLines(), 1u);
+  EXPECT_EQ(sourceMap.getMappingsLineSize(0), 2u);
 }
 
 TEST(HBCBytecodeGen, StripDebugInfo) {
@@ -289,11 +289,20 @@ TEST(HBCBytecodeGen, ExceptionTableTest) {
                       llvm::make_unique<StringBuffer>(OS.str()))
                       .first;
 
-  ASSERT_EQ(bytecode->getExceptionTable(0).size(), 3u);
+  // The overlapping handlers are split so that the table is sorted.
+  auto table = bytecode->getExceptionTable(0);
+  ASSERT_EQ(table.size(), 3u);
+  EXPECT_EQ(table[1].start, 10u);
+  EXPECT_EQ(table[1].end, 20u);
+  EXPECT_EQ(table[1].target, 200u);
+  EXPECT_EQ(bytecode->findCatchTargetOffset(0, 0), 100);
   EXPECT_EQ(bytecode->findCatchTargetOffset(0, 5), 100);
+  EXPECT_EQ(bytecode->findCatchTargetOffset(0, 10), 200);
   EXPECT_EQ(bytecode->findCatchTargetOffset(0, 15), 200);
+  EXPECT_EQ(bytecode->findCatchTargetOffset(0, 20), -1);
   EXPECT_EQ(bytecode->findCatchTargetOffset(0, 25), -1);
   EXPECT_EQ(bytecode->findCatchTargetOffset(0, 55), 300);
+  EXPECT_EQ(bytecode->findCatchTargetOffset(0, 60), -1);
 }
 
 TEST(HBCBytecodeGen, ArrayBufferTest) {
@@ -471,4 +480,51 @@ TEST(HBCBytecodeGen, SerializeBytecodeOptions) {
   EXPECT_TRUE(bytecodeStaticBuiltins->getBytecodeOptions().staticBuiltins);
 }
 
+TEST(HBCBytecodeGen, CompressedBytecode) {
+  // Enough functions for their bodies to span several compressed blocks.
+  std::string source;
+  for (int i = 0; i < 2000; ++i) {
+    source += "function f" + std::to_string(i) +
+        "(a, b) { var s = 0; for (var i = a; i < b; ++i) s += i * " +
+        std::to_string(i) + "; return s; }\n";
+  }
+  auto bytecodeVec = bytecodeForSource(source.c_str());
+
+  std::string compressed;
+  llvm::raw_string_ostream OS{compressed};
+  std::string error;
+  ASSERT_TRUE(compressBytecode(bytecodeVec, OS, &error)) << error;
+  OS.flush();
+  EXPECT_LT(compressed.size(), bytecodeVec.size() / 2);
+  ASSERT_TRUE(BCProviderFromBuffer::isBytecodeStream(llvm::ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(compressed.data()),
+      compressed.size())));
+
+  auto expected = BCProviderFromBuffer::createBCProviderFromBuffer(
+                      llvm::make_unique<StringBuffer>(std::string(
+                          bytecodeVec.begin(), bytecodeVec.end())))
+                      .first;
+  auto ret = BCProviderFromBuffer::createBCProviderFromBuffer(
+      llvm::make_unique<StringBuffer>(compressed));
+  ASSERT_TRUE(ret.first) << ret.second;
+  auto &actual = ret.first;
+  ASSERT_EQ(expected->getFunctionCount(), actual->getFunctionCount());
+  EXPECT_EQ(expected->getSourceHash(), actual->getSourceHash());
+  EXPECT_TRUE(actual->getEpilogue().empty());
+  for (uint32_t i = 0, e = actual->getFunctionCount(); i < e; ++i) {
+    uint32_t size = actual->getFunctionHeader(i).bytecodeSizeInBytes();
+    EXPECT_EQ(
+        llvm::makeArrayRef(expected->getBytecode(i), size),
+        llvm::makeArrayRef(actual->getBytecode(i), size));
+  }
+  EXPECT_EQ(expected->getRawBuffer(), actual->getRawBuffer());
+
+  // A file cut short is rejected when it is loaded.
+  compressed.resize(compressed.size() - 1);
+  ret = BCProviderFromBuffer::createBCProviderFromBuffer(
+      llvm::make_unique<StringBuffer>(compressed));
+  EXPECT_FALSE(ret.first);
+  EXPECT_FALSE(ret.second.empty());
+}
+
 } // end anonymous namespace
@@ -109,7 +109,7 @@ void verifySegment(
 
 TEST(SourceMap, Basic) {
   SourceMapGenerator map;
-  EXPECT_EQ(map.getMappingsLines().size(), 0u);
+  EXPECT_EQ(map.getNumMappingsLines(), 0u);
 
   std::vector<std::string> sources{"file1", "file2"};
   for (const auto &source : sources) {
@@ -136,9 +136,9 @@ TEST(SourceMap, Basic) {
     map.addMappingsLine(segments, i++);
   }
 
-  ASSERT_EQ(map.getMappingsLines().size(), 2u);
-  EXPECT_EQ(map.getMappingsLines()[0].size(), 5u);
-  EXPECT_EQ(map.getMappingsLines()[1].size(), 4u);
+  ASSERT_EQ(map.getNumMappingsLines(), 2u);
+  EXPECT_EQ(map.getMappingsLineSize(0), 5u);
+  EXPECT_EQ(map.getMappingsLineSize(1), 4u);
 
   std::vector<uint32_t> functionOffsets1 = {20, 23, 50, 789};
   std::vector<uint32_t> functionOffsets2 = {1, 255, 300, 500};
@@ -381,6 +381,26 @@ TEST(SourceMap, MergedWithInputSourceMaps) {
   }
 }
 
+/// Test that lines added out of order, or with missing lines before them, are
+/// encoded in order once the lines before them are added or the map is output.
+TEST(SourceMap, OutOfOrderLines) {
+  SourceMapGenerator gen;
+  gen.addSource("file1");
+  gen.addMappingsLine({loc(0, 0, 3, 0), loc(2, 0, 3, 4)}, 1);
+  gen.addMappingsLine({loc(1, 0, 1, 1)}, 0);
+  gen.addMappingsLine({loc(0, 0, 5, 2)}, 3);
+  EXPECT_EQ(gen.getNumMappingsLines(), 4u);
+  EXPECT_EQ(gen.getMappingsLineSize(1), 2u);
+  EXPECT_EQ(gen.getMappingsLineSize(2), 0u);
+
+  std::string storage;
+  llvm::raw_string_ostream OS(storage);
+  gen.outputAsJSON(OS);
+  EXPECT_EQ(
+      OS.str(),
+      R"#({"version":3,"sources":["file1"],"mappings":"CAAC;AAED,EAAI;;AAEF;"})#");
+}
+
 class SimpleJSONParser {
   std::shared_ptr<JSLexer::Allocator> alloc_;
   JSONFactory factory_;
@@ -530,6 +550,45 @@ TEST(SourceMap, EmptyLines) {
       *sourceMap, generatedLine, sources, loc(28, sourceIndex, 2, 10));
 }
 
+/// Test that a map loaded from a cache file maps every address as the parsed
+/// map, which decodes its lines lazily, does.
+TEST(SourceMap, Cache) {
+  for (const char *testMap : {TestMap, TestMapEmptyLines}) {
+    std::unique_ptr<SourceMap> sourceMap = SourceMapParser::parse(testMap);
+    ASSERT_TRUE(sourceMap);
+    std::string storage;
+    llvm::raw_string_ostream OS(storage);
+    sourceMap->writeCache(OS);
+    OS.flush();
+
+    std::unique_ptr<SourceMap> cached =
+        SourceMap::loadCache(llvm::MemoryBuffer::getMemBufferCopy(storage));
+    ASSERT_TRUE(cached);
+    EXPECT_EQ(cached->getNumLines(), sourceMap->getNumLines());
+    EXPECT_EQ(
+        cached->getAllFullPathSources(), sourceMap->getAllFullPathSources());
+    for (uint32_t line = 0; line <= sourceMap->getNumLines() + 1; ++line) {
+      for (uint32_t column = 1; column < 40; ++column) {
+        auto expected = sourceMap->getLocationForAddress(line, column);
+        auto actual = cached->getLocationForAddress(line, column);
+        ASSERT_EQ(actual.hasValue(), expected.hasValue());
+        if (expected.hasValue()) {
+          EXPECT_EQ(actual->fileName, expected->fileName);
+          EXPECT_EQ(actual->line, expected->line);
+          EXPECT_EQ(actual->column, expected->column);
+        }
+      }
+    }
+
+    // A truncated or corrupted cache is rejected.
+    EXPECT_FALSE(SourceMap::loadCache(llvm::MemoryBuffer::getMemBufferCopy(
+        llvm::StringRef(storage).drop_back())));
+    storage[0] ^= 1;
+    EXPECT_FALSE(
+        SourceMap::loadCache(llvm::MemoryBuffer::getMemBufferCopy(storage)));
+  }
+}
+
 TEST(SourceMap, VLQRandos) {
   // clang-format off
   const std::vector<int32_t> inputs = {0, 1, -1, 2, -2, 5298, -23498,
@@ -87,3 +87,29 @@ TEST(AllocatorTest, CanAllocateHuge) {
   auto *p = alloc.Allocate<char[size]>();
   memset(p, 'x', size);
 }
+
+TEST(AllocatorTest, PeakBytes) {
+  BumpPtrAllocator alloc;
+  size_t initial = alloc.getBytes();
+  EXPECT_EQ(initial, alloc.getPeakBytes());
+  constexpr unsigned size = 1 << 24;
+  {
+    AllocationScope scope(alloc);
+    alloc.Allocate<char[size]>();
+    EXPECT_EQ(initial + size, alloc.getBytes());
+  }
+  // Huge allocations are freed with their scope, but the peak remains.
+  EXPECT_EQ(initial, alloc.getBytes());
+  EXPECT_EQ(initial + size, alloc.getPeakBytes());
+
+  // Memory reused from a popped scope doesn't raise the peak.
+  {
+    AllocationScope scope(alloc);
+    alloc.Allocate<char>(size / 2);
+  }
+  {
+    AllocationScope scope(alloc);
+    alloc.Allocate<char>(size / 2);
+  }
+  EXPECT_EQ(initial + size, alloc.getPeakBytes());
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/LZ4.h"
+
+#include "gtest/gtest.h"
+
+#include <random>
+
+using namespace hermes;
+
+namespace {
+
+/// Compress \p input, check that it expands back to \p input and \return the
+/// size of the compressed block.
+size_t roundTrip(const std::vector<uint8_t> &input) {
+  std::vector<uint8_t> compressed;
+  compressLZ4Block(input, compressed);
+  std::vector<uint8_t> output(input.size());
+  EXPECT_TRUE(decompressLZ4Block(compressed, output));
+  EXPECT_EQ(input, output);
+  return compressed.size();
+}
+
+TEST(LZ4Test, RoundTrip) {
+  // Sizes around the minimum length of a block with a match.
+  for (size_t size : {0, 1, 4, 11, 12, 13, 17, 100, 65536}) {
+    roundTrip(std::vector<uint8_t>(size, 'a'));
+  }
+
+  std::vector<uint8_t> text;
+  const char sentence[] = "The quick brown fox jumps over the lazy dog. ";
+  while (text.size() < 70000) {
+    text.insert(text.end(), sentence, sentence + sizeof(sentence) - 1);
+    text.push_back(text.size() % 7);
+  }
+  EXPECT_LT(roundTrip(text), text.size() / 4);
+
+  std::minstd_rand rng(42);
+  std::vector<uint8_t> noise(10000);
+  for (auto &b : noise) {
+    b = rng();
+  }
+  // Incompressible data only grows by the cost of its literal length.
+  EXPECT_LE(roundTrip(noise), noise.size() + noise.size() / 255 + 16);
+}
+
+TEST(LZ4Test, OverlappingMatch) {
+  // A single literal followed by a match at offset 1 repeating it.
+  std::vector<uint8_t> block{
+      0x1f, 'x', 0x01, 0x00, 0x00, 0x50, 'a', 'b', 'c', 'd', 'e'};
+  std::vector<uint8_t> output(1 + 19 + 5);
+  ASSERT_TRUE(decompressLZ4Block(block, output));
+  EXPECT_EQ(
+      std::string(20, 'x') + "abcde",
+      std::string(output.begin(), output.end()));
+}
+
+TEST(LZ4Test, Malformed) {
+  std::vector<uint8_t> input(1000);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = i % 13;
+  }
+  std::vector<uint8_t> compressed;
+  compressLZ4Block(input, compressed);
+
+  // Wrong output sizes.
+  std::vector<uint8_t> shorter(input.size() - 1);
+  EXPECT_FALSE(decompressLZ4Block(compressed, shorter));
+  std::vector<uint8_t> longer(input.size() + 1);
+  EXPECT_FALSE(decompressLZ4Block(compressed, longer));
+
+  // Truncated input.
+  std::vector<uint8_t> output(input.size());
+  for (size_t size = 0; size < compressed.size(); ++size) {
+    EXPECT_FALSE(decompressLZ4Block(
+        llvm::makeArrayRef(compressed).take_front(size), output));
+  }
+
+  // A match reaching before the start of the output.
+  std::vector<uint8_t> badOffset{0x10, 'x', 0x02, 0x00, 0x00};
+  EXPECT_FALSE(decompressLZ4Block(badOffset, output));
+}
+
+} // namespace
@@ -50,4 +50,27 @@ TEST(OSCompatTest, CurrentRSS) {
   // isn't tracked with fine granularity.
   EXPECT_GE(oscompat::current_rss(), beginRSS);
 }
+
+TEST(OSCompatTest, HugePages) {
+  const size_t hugePageSize = oscompat::huge_page_size();
+  EXPECT_EQ(0u, hugePageSize % oscompat::page_size());
+
+  // Explicit huge pages are only available if the system reserved some, but
+  // must not be handed out misaligned.
+  const size_t alignment = 2 * hugePageSize;
+  auto result = oscompat::vm_allocate_huge_aligned(hugePageSize, alignment);
+  if (result) {
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(result.get()) % alignment);
+    static_cast<char *>(result.get())[hugePageSize - 1] = 1;
+    oscompat::vm_free_aligned(result.get(), hugePageSize);
+  }
+
+  // Transparent huge pages are only advice: whatever the result, the memory
+  // stays usable.
+  auto mem = oscompat::vm_allocate_aligned(hugePageSize, hugePageSize);
+  ASSERT_TRUE(mem);
+  oscompat::vm_hugepage(mem.get(), hugePageSize);
+  static_cast<char *>(mem.get())[hugePageSize - 1] = 1;
+  oscompat::vm_free_aligned(mem.get(), hugePageSize);
+}
 } // namespace
@@ -109,6 +109,30 @@ TEST(StringTest, UTF16ToUTF8StringWithReplacements) {
   EXPECT_EQ(false, strAndFullyWritten.second);
 }
 
+// Verify that runs of ASCII converted in blocks agree with the code unit at a
+// time conversion, whichever position the non-ASCII code unit is in.
+TEST(StringTest, UTF16ToUTF8StringWithReplacementsBlocks) {
+  for (size_t pos = 0; pos <= 11; ++pos) {
+    std::u16string input(11, u'x');
+    std::string expected(11, 'x');
+    if (pos < input.size()) {
+      input[pos] = 0x2603;
+      expected.replace(pos, 1, "\xE2\x98\x83");
+    }
+    std::string out;
+    EXPECT_TRUE(convertUTF16ToUTF8WithReplacements(out, input));
+    EXPECT_EQ(expected, out);
+    // Truncation inside a block of ASCII.
+    for (size_t maxChars = 1; maxChars < input.size(); ++maxChars) {
+      EXPECT_FALSE(convertUTF16ToUTF8WithReplacements(out, input, maxChars));
+      std::string truncated;
+      convertUTF16ToUTF8WithReplacements(
+          truncated, llvm::makeArrayRef(input.data(), maxChars));
+      EXPECT_EQ(truncated, out);
+    }
+  }
+}
+
 TEST(StringTest, IsAllASCIITest) {
   std::deque<uint8_t> ascii = {32, 23, 18};
   std::deque<uint8_t> notAscii = {234, 1, 0};
@@ -206,6 +230,51 @@ TEST(UTF16StreamTest, UTF8InputTest) {
   }
 }
 
+TEST(UTF16StreamTest, UTF8MixedInputTest) {
+  // Alternating runs of ASCII and non-ASCII, longer than a chunk.
+  std::vector<uint8_t> str8;
+  static const int kReps = 5000;
+  for (int i = 0; i < kReps; ++i) {
+    str8.insert(str8.end(), {'a', 'b', 0xC3, 0xA9, 0xE2, 0x82, 0xAC});
+  }
+  UTF16Stream stream(llvm::ArrayRef<uint8_t>(str8.data(), str8.size()));
+  for (int i = 0; i < kReps; ++i) {
+    for (char16_t ch : {u'a', u'b', u'\u00E9', u'\u20AC'}) {
+      EXPECT_TRUE(stream.hasChar());
+      EXPECT_EQ(ch, *stream);
+      ++stream;
+    }
+  }
+  EXPECT_FALSE(stream.hasChar());
+  EXPECT_FALSE(stream.isMalformed());
+}
+
+TEST(UTF16StreamTest, UTF8MalformedInputTest) {
+  {
+    // The stream ends at the invalid byte.
+    uint8_t str8[] = {'a', 0xC3, 0xA9, 0xFF, 'b'};
+    UTF16Stream stream(llvm::ArrayRef<uint8_t>(str8, str8 + sizeof(str8)));
+    EXPECT_TRUE(stream.hasChar());
+    EXPECT_EQ('a', *stream);
+    ++stream;
+    EXPECT_TRUE(stream.hasChar());
+    EXPECT_EQ(0xE9, *stream);
+    ++stream;
+    EXPECT_FALSE(stream.hasChar());
+    EXPECT_TRUE(stream.isMalformed());
+  }
+  {
+    // A truncated sequence at the end.
+    uint8_t str8[] = {'a', 0xE2, 0x82};
+    UTF16Stream stream(llvm::ArrayRef<uint8_t>(str8, str8 + sizeof(str8)));
+    EXPECT_TRUE(stream.hasChar());
+    EXPECT_EQ('a', *stream);
+    ++stream;
+    EXPECT_FALSE(stream.hasChar());
+    EXPECT_TRUE(stream.isMalformed());
+  }
+}
+
 size_t countRemainingCharsInStream(UTF16Stream &&str) {
   size_t size = 0;
   while (str.hasChar()) {
@@ -155,4 +155,45 @@ TEST_F(ArrayTest, TestLength) {
   EXPECT_CALLRESULT_DOUBLE(
       5.0, JSObject::getNamed_RJS(array, runtime, lengthID));
 }
+
+/// An element far away from the others is stored as a named property, until
+/// the storage spans it again.
+TEST_F(ArrayTest, SparseElements) {
+  GCScope scope(runtime, "ArrayTest.SparseElements", 128);
+  auto arrayRes = JSArray::create(runtime, 0, 0);
+  ASSERT_EQ(arrayRes.getStatus(), ExecutionStatus::RETURNED);
+  auto array = toHandle(runtime, std::move(*arrayRes));
+
+  MutableHandle<> index{runtime};
+  MutableHandle<> value{runtime};
+  auto put = [&](double i, double v) {
+    GCScopeMarkerRAII marker{runtime};
+    index = HermesValue::encodeDoubleValue(i);
+    value = HermesValue::encodeDoubleValue(v);
+    ASSERT_TRUE(*JSObject::putComputed_RJS(array, runtime, index, value));
+  };
+
+  put(0, 0);
+  put(10000, 1);
+  EXPECT_EQ(1u, array->getEndIndex());
+  EXPECT_EQ(10001u, JSArray::getLength(array.get()));
+  EXPECT_FALSE(array->hasFastIndexProperties());
+  EXPECT_CALLRESULT_VALUE(
+      1.0_hd,
+      JSObject::getComputed_RJS(
+          array, runtime, runtime->makeHandle(10000.0_hd)));
+
+  // Filling the array brings it close enough to be stored with the others.
+  for (uint32_t i = 1; i <= 2000; ++i)
+    put(i, i);
+  EXPECT_EQ(2001u, array->getEndIndex());
+  EXPECT_FALSE(array->hasFastIndexProperties());
+  put(10001, 2);
+  EXPECT_EQ(10002u, array->getEndIndex());
+  EXPECT_TRUE(array->hasFastIndexProperties());
+  EXPECT_EQ(1.0_hd, array->at(runtime, 10000));
+  EXPECT_EQ(2.0_hd, array->at(runtime, 10001));
+  EXPECT_EQ(2000.0_hd, array->at(runtime, 2000));
+  EXPECT_EQ(10002u, JSArray::getLength(array.get()));
+}
 } // namespace
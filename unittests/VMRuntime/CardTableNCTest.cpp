@@ -233,6 +233,71 @@ TEST_F(CardTableNCTest, NextDirtyCard) {
   }
 }
 
+TEST_F(CardTableNCTest, NextDirtyCardAcrossSummaries) {
+  const size_t from = CardTable::kFirstUsedIndex;
+  const size_t last = CardTable::kValidIndices - 1;
+  // A dirty card far from the start, in the middle of a summarized run.
+  const size_t far = last - CardTable::kCardsPerSummary / 2;
+  table->dirtyCardForAddress(table->indexToAddress(far));
+
+  auto dirty = table->findNextDirtyCard(from, CardTable::kValidIndices);
+  ASSERT_TRUE(dirty);
+  EXPECT_EQ(far, *dirty);
+  EXPECT_FALSE(table->findNextDirtyCard(far + 1, CardTable::kValidIndices));
+  EXPECT_FALSE(table->findNextDirtyCard(from, far));
+}
+
+TEST_F(CardTableNCTest, NextDirtyCardAfterPartialClean) {
+  // Dirty two runs of cards, and clean part of the first one.  The summary of
+  // the first run stays dirty, but the search must still skip its clean cards.
+  const size_t run = CardTable::kCardsPerSummary;
+  const size_t first = llvm::alignTo(CardTable::kFirstUsedIndex, run);
+  table->dirtyCardsForAddressRange(
+      table->indexToAddress(first), table->indexToAddress(first + 2 * run) - 1);
+  for (size_t i = first; i < first + 2 * run; i++) {
+    ASSERT_TRUE(table->isCardForIndexDirty(i)) << i;
+  }
+
+  table->updateAfterCompaction(table->indexToAddress(first + run / 2));
+  for (size_t i = first; i < first + run / 2; i++) {
+    EXPECT_TRUE(table->isCardForIndexDirty(i)) << i;
+  }
+  for (size_t i = first + run / 2; i < first + 2 * run; i++) {
+    EXPECT_FALSE(table->isCardForIndexDirty(i)) << i;
+  }
+  EXPECT_FALSE(
+      table->findNextDirtyCard(first + run / 2, CardTable::kValidIndices));
+
+  table->dirtyCardForAddress(table->indexToAddress(first + run + 1));
+  auto dirty =
+      table->findNextDirtyCard(first + run / 2, CardTable::kValidIndices);
+  ASSERT_TRUE(dirty);
+  EXPECT_EQ(first + run + 1, *dirty);
+
+  table->clear();
+  EXPECT_FALSE(table->findNextDirtyCard(0, CardTable::kValidIndices));
+}
+
+TEST_F(CardTableNCTest, ClearCleansPartlyUsedSummaries) {
+  // The first used card is usually not at the start of a summarized run, but
+  // the cards before it are never dirtied, so clearing cleans its summary.
+  const size_t from = CardTable::kFirstUsedIndex;
+  const size_t last = CardTable::kValidIndices - 1;
+  table->dirtyCardForAddress(table->indexToAddress(from));
+  table->dirtyCardForAddress(table->indexToAddress(last));
+  EXPECT_TRUE(table->isSummaryForIndexDirty(from));
+  EXPECT_TRUE(table->isSummaryForIndexDirty(last));
+
+  table->clear();
+  EXPECT_FALSE(table->isSummaryForIndexDirty(from));
+  EXPECT_FALSE(table->isSummaryForIndexDirty(last));
+
+  // Cleaning only part of the used cards of a run keeps its summary.
+  table->updateAfterCompaction(table->indexToAddress(from + 1));
+  EXPECT_TRUE(table->isCardForIndexDirty(from));
+  EXPECT_TRUE(table->isSummaryForIndexDirty(from));
+}
+
 } // namespace
 
 #endif // HERMESVM_GC_NONCONTIG_GENERATIONAL
@@ -268,6 +268,44 @@ TEST(DateUtilTest, LocalTimeTest) {
   hermes::oscompat::unset_env("TZ");
 }
 
+TEST(DateUtilTest, LocalTimeOffsetCacheTest) {
+#ifdef _WINDOWS
+  hermes::oscompat::set_env("TZ", "PST8PDT");
+#else
+  hermes::oscompat::set_env("TZ", "America/Los_Angeles");
+#endif
+  LocalTimeOffsetCache cache;
+  EXPECT_EQ(localTZA(), cache.localTZA());
+
+  // Walk across the DST transitions of Mar 12, 2017 and Nov 5, 2017 in both
+  // directions, in steps both smaller and larger than the range extension.
+  const double start = 1485907200000; // Feb 1, 2017
+  const double end = 1512086400000; // Dec 1, 2017
+  for (double step : {MS_PER_HOUR * 7, MS_PER_DAY * 25}) {
+    for (double t = start; t <= end; t += step) {
+      EXPECT_EQ(daylightSavingTA(t), cache.daylightSavingTA(t));
+      EXPECT_EQ(localTime(t), localTime(t, cache));
+      EXPECT_EQ(utcTime(t), utcTime(t, cache));
+    }
+    for (double t = end; t >= start; t -= step) {
+      EXPECT_EQ(daylightSavingTA(t), cache.daylightSavingTA(t));
+    }
+  }
+
+  // The cache keeps the offsets it computed until it is reset.
+#ifdef _WINDOWS
+  hermes::oscompat::set_env("TZ", "JST-9");
+#else
+  hermes::oscompat::set_env("TZ", "Asia/Tokyo");
+#endif
+  EXPECT_EQ(-2.88e+7, cache.localTZA());
+  cache.reset();
+  EXPECT_EQ(3.24e+7, cache.localTZA());
+  EXPECT_EQ(0, cache.daylightSavingTA(1489530532000)); // Mar 14, 2017
+
+  hermes::oscompat::unset_env("TZ");
+}
+
 TEST(DateUtilTest, HoursMinutesSecondsMsTest) {
   // Uses the formulae from spec, perform sanity check.
   double t = 0;
@@ -440,6 +440,35 @@ TEST_F(GCBasicsTest, ExtraBytes) {
   }
 }
 
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+/// Test that initializing stores only skip the write barriers in the young
+/// generation, and that the values they store stay reachable either way.
+TEST_F(GCBasicsTest, InitializeSkipsOnlyYoungGenBarriers) {
+  auto &gc = rt.gc;
+  Array *old = Array::create(rt, 1);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&old));
+  gc.youngGenCollect();
+  ASSERT_FALSE(gc.inYoungGen(old));
+  EXPECT_FALSE(gc.canSkipWriteBarriers(old->values()));
+
+  Array *young = Array::create(rt, 1);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&young));
+  EXPECT_TRUE(gc.canSkipWriteBarriers(young->values()));
+
+  // The initialized values are the only references to the dummy.
+  Dummy *dummy = Dummy::create(rt);
+  ASSERT_TRUE(gc.inYoungGen(young) && gc.inYoungGen(dummy));
+  young->values()[0].initialize(HermesValue::encodeObjectValue(dummy), &gc);
+  GCHermesValue::uninitialized_copy(
+      young->values(), young->values() + 1, old->values(), &gc);
+  gc.youngGenCollect();
+
+  ASSERT_FALSE(gc.inYoungGen(young));
+  EXPECT_TRUE(vmisa<Dummy>(old->values()[0]));
+  EXPECT_EQ(young->values()[0].getRaw(), old->values()[0].getRaw());
+}
+#endif
+
 /// Test that the id is set to a unique number for each allocated object.
 TEST_F(GCBasicsTest, TestIDIsUnique) {
   auto *cell = Dummy::create(rt);
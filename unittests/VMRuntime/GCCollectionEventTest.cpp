@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "gtest/gtest.h"
+
+#include "Array.h"
+#include "TestHelpers.h"
+#include "hermes/VM/BuildMetadata.h"
+#include "hermes/VM/GC.h"
+
+#include <vector>
+
+using namespace hermes::vm;
+using namespace hermes::unittest;
+
+namespace {
+
+const MetadataTableForTests getMetadataTable() {
+  static const Metadata storage[] = {
+      Metadata(),
+      buildMetadata(
+          CellKind::FillerCellKind, ::hermes::unittest::ArrayBuildMeta)};
+  return MetadataTableForTests(storage);
+}
+
+} // namespace
+
+namespace hermes {
+namespace vm {
+template <>
+struct IsGCObject<Array> : public std::true_type {};
+} // namespace vm
+} // namespace hermes
+
+namespace {
+
+/// \return the number of collections recorded in \p hist.
+unsigned bucketTotal(const GCBase::PhaseHistogram &hist) {
+  unsigned total = 0;
+  for (unsigned count : hist.buckets) {
+    total += count;
+  }
+  return total;
+}
+
+TEST(GCCollectionEventTest, CallbackReceivesEveryCollection) {
+  std::vector<GCCollectionEvent> events;
+  auto runtime = DummyRuntime::create(
+      getMetadataTable(),
+      GCConfig::Builder(kTestGCConfigBuilder)
+          .withCollectionEventCallback(
+              [&events](const GCCollectionEvent &event) {
+                events.push_back(event);
+              })
+          .build());
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  Array *live = Array::create(rt, 16);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&live));
+  Array::create(rt, 16);
+
+  gc.collect();
+  gc.collect();
+  ASSERT_EQ(2u, events.size());
+
+  for (const GCCollectionEvent &event : events) {
+    EXPECT_FALSE(event.youngGen);
+    EXPECT_GT(event.wallSecs, 0.0);
+    EXPECT_GT(event.phaseWallSecsOf(GCPhase::Mark), 0.0);
+    EXPECT_LE(event.phaseWallSecsOf(GCPhase::Mark), event.wallSecs);
+    EXPECT_EQ(event.usedAfter, event.survivingBytes);
+    EXPECT_LE(event.usedAfter, event.usedBefore);
+    // Young-gen phases are not part of a full collection.
+    EXPECT_EQ(0.0, event.phaseWallSecsOf(GCPhase::YoungEvacuation));
+    EXPECT_EQ(0.0, event.phaseWallSecsOf(GCPhase::CardScan));
+  }
+  // The dead array was collected by the first collection.
+  EXPECT_LT(events[0].usedAfter, events[0].usedBefore);
+  EXPECT_EQ(events[0].usedAfter, events[1].usedBefore);
+}
+
+TEST(GCCollectionEventTest, PhaseHistogramsInHeapInfo) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kTestGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  gc.collect();
+  gc.collect();
+  gc.collect();
+
+  GCBase::HeapInfo info;
+  gc.getHeapInfo(info);
+  const auto &mark = info.phaseTimes[static_cast<unsigned>(GCPhase::Mark)];
+  EXPECT_EQ(3u, mark.wallTime.count());
+  EXPECT_EQ(3u, mark.cpuTime.count());
+  EXPECT_EQ(3u, bucketTotal(mark));
+  EXPECT_EQ(
+      0u,
+      info.phaseTimes[static_cast<unsigned>(GCPhase::YoungEvacuation)]
+          .wallTime.count());
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+  EXPECT_EQ(3u, info.fullStats.phaseTimesOf(GCPhase::Compact).wallTime.count());
+#endif
+}
+
+TEST(GCCollectionEventTest, PhaseHardwareCounters) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kTestGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  // Counters are only read when asked for.
+  gc.collect();
+  GCBase::HeapInfo info;
+  gc.getHeapInfo(info);
+  const auto &mark = info.phaseTimes[static_cast<unsigned>(GCPhase::Mark)];
+  EXPECT_EQ(0u, mark.counters.instructions);
+
+  gc.setSampleHardwareCounters(true);
+  gc.collect();
+  gc.getHeapInfo(info);
+  instrumentation::HardwareCounters counters;
+  if (instrumentation::PerfEvents::readThreadCounters(counters)) {
+    EXPECT_GT(mark.counters.instructions, 0u);
+    EXPECT_LE(mark.counters.instructions, counters.instructions);
+  } else {
+    EXPECT_EQ(0u, mark.counters.instructions);
+  }
+}
+
+TEST(GCCollectionEventTest, HistogramBuckets) {
+  using Histogram = GCBase::PhaseHistogram;
+  Histogram hist;
+  hist.record(0.0, 0.0);
+  hist.record(Histogram::kFirstBucketLimitSecs, 0.0);
+  hist.record(Histogram::kFirstBucketLimitSecs * 1.5, 0.0);
+  hist.record(1000.0, 0.0);
+  EXPECT_EQ(1u, hist.buckets[0]);
+  EXPECT_EQ(2u, hist.buckets[1]);
+  EXPECT_EQ(1u, hist.buckets[Histogram::kNumBuckets - 1]);
+  EXPECT_EQ(4u, bucketTotal(hist));
+  EXPECT_EQ(4u, hist.wallTime.count());
+  EXPECT_DOUBLE_EQ(1000.0, hist.wallTime.max());
+}
+
+#if defined(HERMESVM_GC_NONCONTIG_GENERATIONAL) && !defined(NDEBUG)
+TEST(GCCollectionEventTest, YoungGenCollectionRecordsPromotion) {
+  std::vector<GCCollectionEvent> events;
+  auto runtime = DummyRuntime::create(
+      getMetadataTable(),
+      GCConfig::Builder(kTestGCConfigBuilder)
+          .withCollectionEventCallback(
+              [&events](const GCCollectionEvent &event) {
+                events.push_back(event);
+              })
+          .build());
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  Array *live = Array::create(rt, 16);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&live));
+  Array::create(rt, 16);
+
+  gc.youngGenCollect();
+  ASSERT_EQ(1u, events.size());
+  const GCCollectionEvent &event = events[0];
+  EXPECT_TRUE(event.youngGen);
+  // Only the live array was promoted.
+  EXPECT_GE(event.promotedBytes, live->getAllocatedSize());
+  EXPECT_LT(event.promotedBytes, 2 * live->getAllocatedSize());
+  EXPECT_EQ(event.promotedBytes, event.survivingBytes);
+  EXPECT_GT(event.phaseWallSecsOf(GCPhase::YoungEvacuation), 0.0);
+  EXPECT_GT(event.phaseWallSecsOf(GCPhase::CardScan), 0.0);
+  EXPECT_EQ(0.0, event.phaseWallSecsOf(GCPhase::Compact));
+
+  GCBase::HeapInfo info;
+  gc.getHeapInfo(info);
+  EXPECT_EQ(1u, info.youngGenStats.promotedBytes.count());
+  EXPECT_EQ(event.promotedBytes, info.youngGenStats.promotedBytes.sum());
+  EXPECT_EQ(
+      1u,
+      info.youngGenStats.phaseTimesOf(GCPhase::YoungEvacuation)
+          .wallTime.count());
+  EXPECT_EQ(0u, info.fullStats.phaseTimesOf(GCPhase::Mark).wallTime.count());
+}
+#endif
+
+} // namespace
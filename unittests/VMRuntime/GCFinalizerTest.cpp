@@ -57,10 +57,35 @@ struct DummyCell final : public GCCell {
   DummyCell(GC *gc) : GCCell(gc, &vt) {}
 };
 
+/// Owns malloc'd native memory, which it releases through the GC.
+struct NativeMemoryCell final : public GCCell {
+  static const VTable vt;
+  void *mem;
+  int *numFinalized;
+
+  static void finalize(GCCell *cell, GC *gc) {
+    auto *self = static_cast<NativeMemoryCell *>(cell);
+    gc->freeNativeMemory(self->mem);
+    ++(*self->numFinalized);
+  }
+
+  static NativeMemoryCell *create(DummyRuntime &runtime, int *numFinalized) {
+    return new (runtime.allocWithFinalizer(sizeof(NativeMemoryCell)))
+        NativeMemoryCell(&runtime.getHeap(), numFinalized);
+  }
+
+  NativeMemoryCell(GC *gc, int *numFinalized)
+      : GCCell(gc, &vt), mem(malloc(64)), numFinalized(numFinalized) {}
+};
+
 const VTable FinalizerCell::vt{CellKind::FillerCellKind,
                                sizeof(FinalizerCell),
                                FinalizerCell::finalize};
 
+const VTable NativeMemoryCell::vt{CellKind::FillerCellKind,
+                                  sizeof(NativeMemoryCell),
+                                  NativeMemoryCell::finalize};
+
 const VTable DummyCell::vt{CellKind::UninitializedKind, sizeof(DummyCell)};
 
 MetadataTableForTests getMetadataTable() {
@@ -120,6 +145,31 @@ TEST(GCFinalizerTest, MultipleCollect) {
   ASSERT_EQ(3, finalized);
 }
 
+TEST(GCFinalizerTest, BackgroundFinalization) {
+  int finalized = 0;
+  const GCConfig config = GCConfig::Builder(kTestGCConfigSmall)
+                              .withBackgroundFinalization(true)
+                              .build();
+  auto runtime = DummyRuntime::create(getMetadataTable(), config);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  for (int i = 0; i < 100; ++i) {
+    NativeMemoryCell::create(rt, &finalized);
+  }
+  GCCell *r = NativeMemoryCell::create(rt, &finalized);
+  rt.pointerRoots.push_back(&r);
+  gc.collect();
+  gc.waitForBackgroundFrees();
+  ASSERT_EQ(100, finalized);
+
+  // Every collection hands its own batch to the background thread.
+  rt.pointerRoots.clear();
+  gc.collect();
+  gc.waitForBackgroundFrees();
+  ASSERT_EQ(101, finalized);
+}
+
 TEST(GCFinalizerTest, FinalizeAllOnRuntimeDestructDummyRuntime) {
   int finalized = 0;
   {
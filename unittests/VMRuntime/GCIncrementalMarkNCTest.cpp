@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+#ifndef NDEBUG
+
+#include "gtest/gtest.h"
+
+#include "Array.h"
+#include "TestHelpers.h"
+#include "hermes/VM/BuildMetadata.h"
+#include "hermes/VM/GC.h"
+
+using namespace hermes::vm;
+using namespace hermes::unittest;
+
+namespace {
+
+const MetadataTableForTests getMetadataTable() {
+  static const Metadata storage[] = {
+      Metadata(),
+      buildMetadata(
+          CellKind::FillerCellKind, ::hermes::unittest::ArrayBuildMeta)};
+  return MetadataTableForTests(storage);
+}
+
+} // namespace
+
+namespace hermes {
+namespace vm {
+template <>
+struct IsGCObject<Array> : public std::true_type {};
+} // namespace vm
+} // namespace hermes
+
+namespace {
+
+/// Number of chains hanging off the root array.  Large enough that marking
+/// them takes more than one increment of the budget below.
+constexpr unsigned kNumChains = 2048;
+/// Length of each chain.
+constexpr unsigned kChainLength = 10;
+/// Number of rounds of mutation and young-gen collection.
+constexpr unsigned kNumRounds = 64;
+
+const GCConfig kIncrementalGCConfig = GCConfig::Builder(kTestGCConfigBuilder)
+                                          .withInitHeapSize(kInitHeapLarge)
+                                          .withMaxHeapSize(kMaxHeapLarge)
+                                          .withIncrementalMarkBudgetMs(1)
+                                          .build();
+
+/// Allocate a chain of \p length two-element arrays.  Element 0 points to the
+/// next link, and element 1 holds the link's position in the chain.
+Array *makeChain(DummyRuntime &rt, unsigned length) {
+  auto &gc = rt.gc;
+  Array *head = nullptr;
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&head));
+  for (unsigned i = length; i-- > 0;) {
+    Array *link = Array::create(rt, 2);
+    if (head) {
+      link->values()[0].set(HermesValue::encodeObjectValue(head), &gc);
+    }
+    link->values()[1].set(HermesValue::encodeNumberValue(i), &gc);
+    head = link;
+  }
+  rt.pointerRoots.pop_back();
+  return head;
+}
+
+Array *chainAt(Array *root, unsigned c) {
+  return reinterpret_cast<Array *>(root->values()[c].getPointer());
+}
+
+/// Check that the chain starting at \p link is a chain built by makeChain.
+void expectChainIntact(Array *link, unsigned length) {
+  for (unsigned i = 0; i < length; ++i) {
+    ASSERT_TRUE(link != nullptr);
+    EXPECT_EQ(i, link->values()[1].getNumber());
+    link = link->values()[0].isPointer()
+        ? reinterpret_cast<Array *>(link->values()[0].getPointer())
+        : nullptr;
+  }
+  EXPECT_EQ(nullptr, link);
+}
+
+/// Exchange the tails of chains while old-gen marking is (likely) in progress,
+/// and check that no cell hidden behind an already scanned one is freed.
+TEST(GCIncrementalMarkNCTest, MutationsDuringMarkingAreTracked) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kIncrementalGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  Array *root = Array::create(rt, kNumChains);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&root));
+  for (unsigned c = 0; c < kNumChains; ++c) {
+    Array *chain = makeChain(rt, kChainLength);
+    root->values()[c].set(HermesValue::encodeObjectValue(chain), &gc);
+  }
+
+  for (unsigned round = 0; round < kNumRounds; ++round) {
+    // Swapping the links after the heads keeps every chain well-formed, but
+    // moves the only reference to each tail into a different cell.
+    for (unsigned c = round % 2; c + 1 < kNumChains; c += 2) {
+      GCHermesValue &a = chainAt(root, c)->values()[0];
+      GCHermesValue &b = chainAt(root, c + 1)->values()[0];
+      HermesValue tmp = a;
+      a.set(b, &gc);
+      b.set(tmp, &gc);
+    }
+    // Replace a few chains with new ones, promoting them during the cycle.
+    for (unsigned c = round; c < kNumChains; c += kNumRounds) {
+      Array *chain = makeChain(rt, kChainLength);
+      root->values()[c].set(HermesValue::encodeObjectValue(chain), &gc);
+    }
+    gc.youngGenCollect();
+  }
+
+  for (unsigned c = 0; c < kNumChains; ++c) {
+    expectChainIntact(chainAt(root, c), kChainLength);
+  }
+
+  // Collections from the runtime keep working, whether or not a cycle is in
+  // progress.  Two are needed for exact counts, as the first may be finishing
+  // a cycle, which keeps the cells allocated during it.
+  gc.collect();
+  gc.collect();
+  GCBase::DebugHeapInfo debugInfo;
+  gc.getDebugHeapInfo(debugInfo);
+  EXPECT_EQ(1u + kNumChains * kChainLength, debugInfo.numReachableObjects);
+  for (unsigned c = 0; c < kNumChains; ++c) {
+    expectChainIntact(chainAt(root, c), kChainLength);
+  }
+}
+
+/// With a young generation emptied right before, a full collection finishes
+/// the incremental cycle instead of marking from scratch.
+TEST(GCIncrementalMarkNCTest, FullCollectionFinishesCycle) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kIncrementalGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  Array *root = Array::create(rt, kNumChains);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&root));
+  for (unsigned c = 0; c < kNumChains; ++c) {
+    Array *chain = makeChain(rt, kChainLength);
+    root->values()[c].set(HermesValue::encodeObjectValue(chain), &gc);
+    // Garbage, so that the old generation fills up with unreachable cells.
+    makeChain(rt, kChainLength);
+  }
+
+  // Drop every other chain, then let a cycle run.
+  for (unsigned c = 0; c < kNumChains; c += 2) {
+    root->values()[c].set(HermesValue::encodeEmptyValue(), &gc);
+  }
+  gc.youngGenCollect();
+  gc.collect();
+  gc.collect();
+
+  GCBase::DebugHeapInfo debugInfo;
+  gc.getDebugHeapInfo(debugInfo);
+  EXPECT_EQ(1u + kNumChains / 2 * kChainLength, debugInfo.numReachableObjects);
+  for (unsigned c = 1; c < kNumChains; c += 2) {
+    expectChainIntact(chainAt(root, c), kChainLength);
+  }
+}
+
+} // namespace
+
+#endif // !NDEBUG
+#endif // HERMESVM_GC_NONCONTIG_GENERATIONAL
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+#ifndef HERMESVM_COMPRESSED_POINTERS
+#ifndef NDEBUG
+
+#include "gtest/gtest.h"
+
+#include "Array.h"
+#include "TestHelpers.h"
+#include "hermes/VM/BuildMetadata.h"
+#include "hermes/VM/GC.h"
+#include "hermes/VM/LargeObjectSpaceNC.h"
+
+using namespace hermes::vm;
+using namespace hermes::unittest;
+
+namespace {
+
+const MetadataTableForTests getMetadataTable() {
+  static const Metadata storage[] = {
+      Metadata(),
+      buildMetadata(
+          CellKind::FillerCellKind, ::hermes::unittest::ArrayBuildMeta)};
+  return MetadataTableForTests(storage);
+}
+
+} // namespace
+
+namespace hermes {
+namespace vm {
+template <>
+struct IsGCObject<Array> : public std::true_type {};
+} // namespace vm
+} // namespace hermes
+
+namespace {
+
+const GCConfig kLargeObjectGCConfig = GCConfig::Builder(kTestGCConfigBuilder)
+                                          .withInitHeapSize(kInitHeapLarge)
+                                          .withMaxHeapSize(kMaxHeapLarge)
+                                          .withLargeObjectSpace(true)
+                                          .build();
+
+/// The smallest array that is allocated in the large object space.
+const unsigned kLargeLength =
+    LargeObjectSpace::kMinAllocSize / sizeof(GCHermesValue);
+
+/// Array::create allocates with a finalizer, which keeps cells out of the
+/// large object space.  The finalizer of Array does nothing, so skip it.
+Array *createWithoutFinalizer(DummyRuntime &rt, unsigned length) {
+  auto *self = new (rt.alloc</*fixedSize*/ false>(Array::allocSize(length)))
+      Array(&rt.getHeap(), length);
+  GCHermesValue::fill(
+      self->values(),
+      self->values() + length,
+      HermesValue::encodeEmptyValue());
+  return self;
+}
+
+TEST(GCLargeObjectSpaceNCTest, LargeCellsDoNotMove) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kLargeObjectGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+  ASSERT_TRUE(gc.isLargeObjectSpaceEnabled());
+
+  Array *large = createWithoutFinalizer(rt, kLargeLength);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&large));
+  Array *const original = large;
+  EXPECT_FALSE(gc.inYoungGen(large));
+  EXPECT_EQ(1u, gc.numLargeObjects());
+
+  gc.youngGenCollect();
+  EXPECT_EQ(original, large);
+  gc.collect();
+  EXPECT_EQ(original, large);
+  EXPECT_EQ(1u, gc.numLargeObjects());
+  EXPECT_EQ(kLargeLength, large->length);
+}
+
+TEST(GCLargeObjectSpaceNCTest, YoungReferentsAreEvacuated) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kLargeObjectGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  Array *large = createWithoutFinalizer(rt, kLargeLength);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&large));
+  Array *first = createWithoutFinalizer(rt, 1);
+  Array *last = createWithoutFinalizer(rt, 1);
+  ASSERT_TRUE(gc.inYoungGen(first));
+  large->values()[0].set(HermesValue::encodeObjectValue(first), &gc);
+  large->values()[kLargeLength - 1].set(
+      HermesValue::encodeObjectValue(last), &gc);
+
+  gc.youngGenCollect();
+  Array *firstMoved = vmcast<Array>(large->values()[0]);
+  Array *lastMoved = vmcast<Array>(large->values()[kLargeLength - 1]);
+  EXPECT_FALSE(gc.inYoungGen(firstMoved));
+  EXPECT_FALSE(gc.inYoungGen(lastMoved));
+
+  // A full collection updates the pointers from the large cell to the cells
+  // it compacts.
+  gc.collect();
+  EXPECT_EQ(1u, vmcast<Array>(large->values()[0])->length);
+  EXPECT_EQ(1u, vmcast<Array>(large->values()[kLargeLength - 1])->length);
+}
+
+TEST(GCLargeObjectSpaceNCTest, DeadCellsAreReleased) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kLargeObjectGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  Array *live = createWithoutFinalizer(rt, kLargeLength);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&live));
+  createWithoutFinalizer(rt, kLargeLength);
+  createWithoutFinalizer(rt, kLargeLength);
+  EXPECT_EQ(3u, gc.numLargeObjects());
+
+  // Young-gen collections treat large cells as old.
+  gc.youngGenCollect();
+  EXPECT_EQ(3u, gc.numLargeObjects());
+
+  gc.collect();
+  EXPECT_EQ(1u, gc.numLargeObjects());
+  EXPECT_EQ(kLargeLength, live->length);
+}
+
+TEST(GCLargeObjectSpaceNCTest, SmallAndFinalizableCellsAreNotLarge) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kLargeObjectGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  createWithoutFinalizer(rt, kLargeLength / 2);
+  Array::create(rt, kLargeLength);
+  EXPECT_EQ(0u, gc.numLargeObjects());
+}
+
+TEST(GCLargeObjectSpaceNCTest, DisabledByDefault) {
+  auto runtime = DummyRuntime::create(
+      getMetadataTable(),
+      GCConfig::Builder(kTestGCConfigBuilder)
+          .withInitHeapSize(kInitHeapLarge)
+          .withMaxHeapSize(kMaxHeapLarge)
+          .build());
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+  EXPECT_FALSE(gc.isLargeObjectSpaceEnabled());
+
+  createWithoutFinalizer(rt, kLargeLength);
+  EXPECT_EQ(0u, gc.numLargeObjects());
+}
+
+} // namespace
+
+#endif // !NDEBUG
+#endif // HERMESVM_COMPRESSED_POINTERS
+#endif // HERMESVM_GC_NONCONTIG_GENERATIONAL
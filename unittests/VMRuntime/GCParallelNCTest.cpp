@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+#ifndef NDEBUG
+
+#include "gtest/gtest.h"
+
+#include "Array.h"
+#include "TestHelpers.h"
+#include "hermes/VM/BuildMetadata.h"
+#include "hermes/VM/GC.h"
+#include "hermes/VM/WeakRef.h"
+
+#include <vector>
+
+using namespace hermes::vm;
+using namespace hermes::unittest;
+
+namespace {
+
+const MetadataTableForTests getMetadataTable() {
+  static const Metadata storage[] = {
+      Metadata(),
+      buildMetadata(
+          CellKind::FillerCellKind, ::hermes::unittest::ArrayBuildMeta)};
+  return MetadataTableForTests(storage);
+}
+
+} // namespace
+
+namespace hermes {
+namespace vm {
+template <>
+struct IsGCObject<Array> : public std::true_type {};
+} // namespace vm
+} // namespace hermes
+
+namespace {
+
+/// Number of independent chains hanging off the root array.  Scanning the root
+/// pushes more cells than ParallelMarkState::kPublishThreshold, so the other
+/// workers have to steal to take part.
+constexpr unsigned kNumChains = 512;
+/// Length of each chain.
+constexpr unsigned kChainLength = 10;
+
+/// Allocate a chain of \p length two-element arrays.  Element 0 points to the
+/// next link, and element 1 holds the link's position in the chain.  Every link
+/// also gets an unreachable sibling allocated next to it.
+Array *makeChain(DummyRuntime &rt, unsigned length) {
+  auto &gc = rt.gc;
+  Array *head = nullptr;
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&head));
+  for (unsigned i = length; i-- > 0;) {
+    Array::create(rt, 2);
+    Array *link = Array::create(rt, 2);
+    if (head) {
+      link->values()[0].set(HermesValue::encodeObjectValue(head), &gc);
+    }
+    link->values()[1].set(HermesValue::encodeNumberValue(i), &gc);
+    head = link;
+  }
+  rt.pointerRoots.pop_back();
+  return head;
+}
+
+/// Check that the chain starting at \p link is the one built by makeChain.
+void expectChainIntact(Array *link, unsigned length) {
+  for (unsigned i = 0; i < length; ++i) {
+    ASSERT_TRUE(link != nullptr);
+    EXPECT_EQ(i, link->values()[1].getNumber());
+    link = link->values()[0].isPointer()
+        ? reinterpret_cast<Array *>(link->values()[0].getPointer())
+        : nullptr;
+  }
+  EXPECT_EQ(nullptr, link);
+}
+
+/// Build kNumChains chains off a root array in a heap configured by
+/// \p builder, and check that full collections keep exactly the reachable
+/// ones, with their contents intact.
+void checkFullCollections(GCConfig::Builder builder) {
+  auto runtime = DummyRuntime::create(
+      getMetadataTable(),
+      builder.withInitHeapSize(kInitHeapSize)
+          .withMaxHeapSize(kMaxHeapSize)
+          .build());
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+  GCBase::DebugHeapInfo debugInfo;
+
+  Array *root = Array::create(rt, kNumChains);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&root));
+
+  for (unsigned c = 0; c < kNumChains; ++c) {
+    Array *chain = makeChain(rt, kChainLength);
+    root->values()[c].set(HermesValue::encodeObjectValue(chain), &gc);
+  }
+
+  gc.collect();
+  gc.getDebugHeapInfo(debugInfo);
+  EXPECT_EQ(1u + kNumChains * kChainLength, debugInfo.numReachableObjects);
+  for (unsigned c = 0; c < kNumChains; ++c) {
+    expectChainIntact(
+        reinterpret_cast<Array *>(root->values()[c].getPointer()),
+        kChainLength);
+  }
+
+  // Drop half of the chains; a second collection must free exactly those.
+  for (unsigned c = 0; c < kNumChains; c += 2) {
+    root->values()[c].set(HermesValue::encodeEmptyValue(), &gc);
+  }
+  gc.collect();
+  gc.getDebugHeapInfo(debugInfo);
+  EXPECT_EQ(1u + kNumChains / 2 * kChainLength, debugInfo.numReachableObjects);
+  EXPECT_EQ(kNumChains / 2 * kChainLength, debugInfo.numCollectedObjects);
+  for (unsigned c = 1; c < kNumChains; c += 2) {
+    expectChainIntact(
+        reinterpret_cast<Array *>(root->values()[c].getPointer()),
+        kChainLength);
+  }
+}
+
+TEST(GCParallelNCTest, ParallelMarking) {
+  checkFullCollections(
+      GCConfig::Builder(kTestGCConfigBuilder).withMarkingThreads(4));
+}
+
+TEST(GCParallelNCTest, ParallelUpdateReferences) {
+  checkFullCollections(
+      GCConfig::Builder(kTestGCConfigBuilder).withCompactionThreads(4));
+}
+
+TEST(GCParallelNCTest, ParallelMarkingAndUpdateReferences) {
+  checkFullCollections(GCConfig::Builder(kTestGCConfigBuilder)
+                           .withMarkingThreads(4)
+                           .withCompactionThreads(4));
+}
+
+TEST(GCParallelNCTest, ParallelWeakReferences) {
+  auto runtime = DummyRuntime::create(
+      getMetadataTable(),
+      GCConfig::Builder(kTestGCConfigBuilder)
+          .withInitHeapSize(kInitHeapSize)
+          .withMaxHeapSize(kMaxHeapSize)
+          .withCompactionThreads(4)
+          .build());
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  // Enough slots for every thread to get a range of its own (see
+  // GenGC::kMinWeakSlotsPerThread).  The referents of the even weak refs are
+  // kept alive.
+  const size_t numRefs = 4 * 4096;
+  Array *live = Array::create(rt, numRefs / 2);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&live));
+  std::vector<WeakRef<Array>> refs;
+  refs.reserve(numRefs);
+  for (size_t i = 0; i < numRefs; ++i) {
+    Array *target = Array::create(rt, 0);
+    if (i % 2 == 0) {
+      live->values()[i / 2].set(HermesValue::encodeObjectValue(target), &gc);
+    }
+    refs.emplace_back(&gc, target);
+  }
+  size_t numMarked = numRefs;
+  rt.markExtraWeak = [&refs, &numMarked](WeakRefAcceptor &acceptor) {
+    for (size_t i = 0; i < numMarked; ++i) {
+      acceptor.accept(refs[i]);
+    }
+  };
+
+  gc.collect();
+  for (size_t i = 0; i < numRefs; ++i) {
+    ASSERT_EQ(i % 2 == 0, refs[i].isValid());
+    if (i % 2 == 0) {
+      EXPECT_EQ(
+          live->values()[i / 2].getPointer(),
+          refs[i].unsafeGetHermesValue().getPointer());
+    }
+  }
+
+  // Stop marking the second half of the refs, which frees their slots.
+  numMarked = numRefs / 2;
+  gc.collect();
+  refs.erase(refs.begin() + numMarked, refs.end());
+  for (size_t i = 0; i < numMarked; ++i) {
+    ASSERT_EQ(i % 2 == 0, refs[i].isValid());
+  }
+
+  // The freed slots are reused.
+  Array *target = Array::create(rt, 0);
+  WeakRef<Array> reused{&gc, target};
+  EXPECT_TRUE(reused.isValid());
+}
+
+TEST(GCParallelNCTest, ParallelCardScanning) {
+  auto runtime = DummyRuntime::create(
+      getMetadataTable(),
+      GCConfig::Builder(kTestGCConfigBuilder)
+          .withInitHeapSize(kInitHeapSize)
+          .withMaxHeapSize(kMaxHeapSize)
+          .withCardScanThreads(4)
+          .build());
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  // One old-gen array per chain, so that the young-gen pointers stored into
+  // them are spread over many cards and segments.
+  Array *root = Array::create(rt, kNumChains);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&root));
+  for (unsigned c = 0; c < kNumChains; ++c) {
+    Array *holder = Array::create(rt, 1);
+    root->values()[c].set(HermesValue::encodeObjectValue(holder), &gc);
+  }
+  gc.youngGenCollect();
+
+  // Every chain is only reachable from an old-gen array, via a dirty card.
+  for (unsigned round = 0; round < 2; ++round) {
+    for (unsigned c = 0; c < kNumChains; ++c) {
+      Array *chain = makeChain(rt, 2);
+      auto *holder = reinterpret_cast<Array *>(root->values()[c].getPointer());
+      ASSERT_FALSE(gc.inYoungGen(holder));
+      holder->values()[0].set(HermesValue::encodeObjectValue(chain), &gc);
+    }
+    gc.youngGenCollect();
+    for (unsigned c = 0; c < kNumChains; ++c) {
+      auto *holder = reinterpret_cast<Array *>(root->values()[c].getPointer());
+      expectChainIntact(
+          reinterpret_cast<Array *>(holder->values()[0].getPointer()), 2);
+    }
+  }
+}
+
+} // namespace
+
+#endif // !NDEBUG
+#endif // HERMESVM_GC_NONCONTIG_GENERATIONAL
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+
+#include "gtest/gtest.h"
+
+#include "Array.h"
+#include "TestHelpers.h"
+#include "hermes/VM/AllocationSite.h"
+#include "hermes/VM/BuildMetadata.h"
+#include "hermes/VM/GC.h"
+
+using namespace hermes::vm;
+using namespace hermes::unittest;
+
+namespace {
+
+const MetadataTableForTests getMetadataTable() {
+  static const Metadata storage[] = {
+      Metadata(),
+      buildMetadata(
+          CellKind::FillerCellKind, ::hermes::unittest::ArrayBuildMeta)};
+  return MetadataTableForTests(storage);
+}
+
+} // namespace
+
+namespace hermes {
+namespace vm {
+template <>
+struct IsGCObject<Array> : public std::true_type {};
+} // namespace vm
+} // namespace hermes
+
+namespace {
+
+const GCConfig kPretenuringGCConfig = GCConfig::Builder(kTestGCConfigBuilder)
+                                          .withPretenuring(true)
+                                          .build();
+
+TEST(GCPretenuringNCTest, SurvivingSiteIsPretenured) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kPretenuringGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+  ASSERT_TRUE(gc.isPretenuringEnabled());
+
+  AllocationSite site;
+  Array *live = nullptr;
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&live));
+  const uint32_t minSamples = AllocationSite::kMinSamples;
+  for (uint32_t i = 0; i < minSamples; ++i) {
+    EXPECT_FALSE(site.shouldPretenure());
+    live = Array::create(rt, 1);
+    ASSERT_TRUE(gc.inYoungGen(live));
+    gc.sampleAllocationSite(live, &site);
+    EXPECT_TRUE(site.isSampling());
+    // Only one object per site is sampled at a time.
+    gc.sampleAllocationSite(Array::create(rt, 1), &site);
+    gc.youngGenCollect();
+    EXPECT_FALSE(site.isSampling());
+    EXPECT_EQ(i + 1, site.numSurvived());
+  }
+  EXPECT_TRUE(site.shouldPretenure());
+}
+
+TEST(GCPretenuringNCTest, DyingSiteIsNotPretenured) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kPretenuringGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  AllocationSite site;
+  const uint32_t minSamples = AllocationSite::kMinSamples;
+  for (uint32_t i = 0; i < 4 * minSamples; ++i) {
+    gc.sampleAllocationSite(Array::create(rt, 1), &site);
+    gc.youngGenCollect();
+    EXPECT_EQ(0u, site.numSurvived());
+    // The counts decay once enough samples are known.
+    EXPECT_GT(minSamples, site.numSamples());
+  }
+  EXPECT_FALSE(site.shouldPretenure());
+}
+
+TEST(GCPretenuringNCTest, FullCollectionResolvesSamples) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kPretenuringGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  AllocationSite liveSite;
+  AllocationSite deadSite;
+  Array *live = Array::create(rt, 1);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&live));
+  gc.sampleAllocationSite(live, &liveSite);
+  gc.sampleAllocationSite(Array::create(rt, 1), &deadSite);
+  gc.collect();
+
+  EXPECT_FALSE(liveSite.isSampling());
+  EXPECT_EQ(1u, liveSite.numSamples());
+  EXPECT_EQ(1u, liveSite.numSurvived());
+  EXPECT_FALSE(deadSite.isSampling());
+  EXPECT_EQ(1u, deadSite.numSamples());
+  EXPECT_EQ(0u, deadSite.numSurvived());
+}
+
+TEST(GCPretenuringNCTest, OldGenCellsAreNotSampled) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kPretenuringGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  AllocationSite site;
+  Array *live = Array::create(rt, 1);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&live));
+  gc.youngGenCollect();
+  ASSERT_FALSE(gc.inYoungGen(live));
+  gc.sampleAllocationSite(live, &site);
+  EXPECT_FALSE(site.isSampling());
+}
+
+} // namespace
+
+#endif // HERMESVM_GC_NONCONTIG_GENERATIONAL
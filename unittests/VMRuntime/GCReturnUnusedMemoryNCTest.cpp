@@ -96,6 +96,39 @@ TEST(GCReturnUnusedMemoryNCTest, CollectReturnsFreeMemory) {
 #endif // _WINDOWS
 }
 
+TEST(GCReturnUnusedMemoryNCTest, MemoryPressureReturnsFreeMemory) {
+#ifndef _WINDOWS
+  std::unique_ptr<StorageProvider> provider = StorageProvider::mmapProvider();
+  // Collections alone keep the memory of dead cells.
+  auto runtime = DummyRuntime::create(
+      getMetadataTable(),
+      TestGCConfigFixedSize(
+          16 << 20,
+          GCConfig::Builder(kTestGCConfigBuilder)
+              .withShouldReleaseUnused(kReleaseUnusedNone)),
+      std::move(provider));
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  using HalfCell = EmptyCell<AlignedHeapSegment::maxSize() / 2>;
+
+  auto *cell1 = HalfCell::createLongLived(rt);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&cell1));
+  auto *cell2 = HalfCell::createLongLived(rt);
+  (void)cell1->touch();
+  (void)cell2->touch();
+
+  gc.collect();
+  size_t collected = gcRegionFootprint(gc);
+  ASSERT_NE(collected, FAILED);
+
+  gc.notifyMemoryPressure(MemoryPressureLevel::Critical);
+  size_t pressured = gcRegionFootprint(gc);
+  ASSERT_NE(pressured, FAILED);
+  EXPECT_GT(collected, pressured);
+#endif // _WINDOWS
+}
+
 } // namespace
 
 #endif // HERMESVM_GC_NONCONTIG_GENERATIONAL, NDEBUG
@@ -15,6 +15,9 @@
 
 #include "gtest/gtest.h"
 
+#include <chrono>
+#include <thread>
+
 using namespace hermes::vm;
 using namespace hermes::unittest;
 
@@ -276,6 +279,113 @@ TEST(GCSizingMinHeapTest, TestHeapDoesNotShrinkPastMinSize) {
 
   EXPECT_GE(info.heapSize, kMinHeap);
 }
+
+TEST(GCSizingYoungGenTest, FixedFractionByDefault) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kTestGCConfigLarge);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  for (unsigned i = 0; i < 10; i++) {
+    gc.youngGenCollect();
+  }
+  GCBase::HeapInfo info;
+  gc.getHeapInfo(info);
+  EXPECT_EQ(0u, info.youngGenStats.numGrowths);
+  EXPECT_EQ(0u, info.youngGenStats.numShrinks);
+}
+
+TEST(GCSizingYoungGenTest, GrowsWhenCollectionsAreFrequentAndCheap) {
+  auto runtime = DummyRuntime::create(
+      getMetadataTable(),
+      GCConfig::Builder(kTestGCConfigBuilder)
+          .withInitHeapSize(kInitHeapLarge)
+          .withMaxHeapSize(kMaxHeapLarge)
+          // Long enough to never be exceeded by these collections.
+          .withYoungGenPauseTargetMs(10000)
+          .build());
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  gc.youngGenCollect();
+  GCBase::HeapInfo info;
+  gc.getHeapInfo(info);
+  const gcheapsize_t initialSize = info.youngGenStats.finalHeapSize;
+
+  // Back-to-back collections of an empty young gen spend almost all of the
+  // time in the GC, and nothing survives them.
+  for (unsigned i = 0; i < 10; i++) {
+    gc.youngGenCollect();
+  }
+  gc.getHeapInfo(info);
+  EXPECT_LT(0u, info.youngGenStats.numGrowths);
+  EXPECT_EQ(0u, info.youngGenStats.numShrinks);
+  EXPECT_LT(initialSize, info.youngGenStats.finalHeapSize);
+  EXPECT_GE(kMaxHeapLarge / 8, info.youngGenStats.finalHeapSize);
+
+  // A full collection resizes the heap, but keeps the adapted young gen.
+  const gcheapsize_t adaptedSize = info.youngGenStats.finalHeapSize;
+  gc.collect();
+  gc.youngGenCollect();
+  gc.getHeapInfo(info);
+  EXPECT_LE(adaptedSize, info.youngGenStats.finalHeapSize);
+}
+
+TEST(GCSizingTimeTargetTest, FixedOccupancyByDefault) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kTestGCConfigLarge);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  for (unsigned i = 0; i < 5; i++) {
+    gc.collect();
+  }
+  EXPECT_EQ(GCConfig::getDefaultOccupancyTarget(), gc.occupancyTarget());
+}
+
+TEST(GCSizingTimeTargetTest, GrowsWhenCollectionsTakeTooLong) {
+  auto runtime = DummyRuntime::create(
+      getMetadataTable(),
+      GCConfig::Builder(kTestGCConfigBuilder)
+          .withInitHeapSize(kInitHeapLarge)
+          .withMaxHeapSize(kMaxHeapLarge)
+          .withGCTimeTarget(0.01)
+          .build());
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  // Back-to-back collections spend almost all of the time in the GC, so the
+  // occupancy target drops to leave more free space.  The first collection
+  // only starts the window.
+  gc.collect();
+  double occupancyTarget = gc.occupancyTarget();
+  for (unsigned i = 0; i < 5; i++) {
+    gc.collect();
+    EXPECT_GE(occupancyTarget, gc.occupancyTarget());
+    occupancyTarget = gc.occupancyTarget();
+  }
+  EXPECT_GT(GCConfig::getDefaultOccupancyTarget(), occupancyTarget);
+  EXPECT_LE(0.1, occupancyTarget);
+}
+
+TEST(GCSizingTimeTargetTest, ShrinksWhenCollectionsAreRare) {
+  auto runtime = DummyRuntime::create(
+      getMetadataTable(),
+      GCConfig::Builder(kTestGCConfigBuilder)
+          .withInitHeapSize(kInitHeapLarge)
+          .withMaxHeapSize(kMaxHeapLarge)
+          .withGCTimeTarget(0.5)
+          .build());
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  // Collecting an empty heap takes much less than the time between the
+  // collections, so the occupancy target rises to use less memory.
+  for (unsigned i = 0; i < 5; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    gc.collect();
+  }
+  EXPECT_LT(GCConfig::getDefaultOccupancyTarget(), gc.occupancyTarget());
+  EXPECT_GE(0.9, gc.occupancyTarget());
+}
 #endif
 
 } // namespace
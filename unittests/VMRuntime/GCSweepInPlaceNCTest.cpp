@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+
+#include "gtest/gtest.h"
+
+#include "Array.h"
+#include "TestHelpers.h"
+#include "hermes/VM/BuildMetadata.h"
+#include "hermes/VM/GC.h"
+
+#include <vector>
+
+using namespace hermes::vm;
+using namespace hermes::unittest;
+
+namespace {
+
+const MetadataTableForTests getMetadataTable() {
+  static const Metadata storage[] = {
+      Metadata(),
+      buildMetadata(
+          CellKind::FillerCellKind, ::hermes::unittest::ArrayBuildMeta)};
+  return MetadataTableForTests(storage);
+}
+
+} // namespace
+
+namespace hermes {
+namespace vm {
+template <>
+struct IsGCObject<Array> : public std::true_type {};
+} // namespace vm
+} // namespace hermes
+
+namespace {
+
+/// The number of values in each of the large arrays allocated below.
+constexpr unsigned kLargeLength = 64;
+
+TEST(GCSweepInPlaceNCTest, DenseSegmentIsNotMoved) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kTestGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  // One small array among many large ones, all promoted to the old
+  // generation before the small one dies.
+  constexpr unsigned kNumLive = 16;
+  std::vector<Array *> live(kNumLive, nullptr);
+  Array *dead = nullptr;
+  live[0] = Array::create(rt, kLargeLength);
+  dead = Array::create(rt, 1);
+  for (unsigned i = 1; i < kNumLive; ++i) {
+    live[i] = Array::create(rt, kLargeLength);
+  }
+  for (auto &arr : live) {
+    rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&arr));
+  }
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&dead));
+  gc.youngGenCollect();
+  ASSERT_FALSE(gc.inYoungGen(dead));
+
+  const std::vector<Array *> before = live;
+  dead = nullptr;
+  gc.collect();
+
+  for (unsigned i = 0; i < kNumLive; ++i) {
+    EXPECT_EQ(before[i], live[i]);
+    EXPECT_EQ(kLargeLength, live[i]->length);
+  }
+
+  // The hole left behind must be parseable by the next collections.
+  gc.youngGenCollect();
+  gc.collect();
+  for (unsigned i = 0; i < kNumLive; ++i) {
+    EXPECT_EQ(before[i], live[i]);
+  }
+}
+
+TEST(GCSweepInPlaceNCTest, FreeRegionIsReused) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kTestGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  // Two dead arrays between large live ones, so that the sweep leaves two
+  // free regions behind.
+  constexpr unsigned kNumLive = 16;
+  constexpr unsigned kDeadLength = 8;
+  std::vector<Array *> live(kNumLive, nullptr);
+  Array *dead0 = nullptr;
+  Array *dead1 = nullptr;
+  live[0] = Array::create(rt, kLargeLength);
+  dead0 = Array::create(rt, kDeadLength);
+  live[1] = Array::create(rt, kLargeLength);
+  dead1 = Array::create(rt, kDeadLength);
+  for (unsigned i = 2; i < kNumLive; ++i) {
+    live[i] = Array::create(rt, kLargeLength);
+  }
+  for (auto &arr : live) {
+    rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&arr));
+  }
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&dead0));
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&dead1));
+  gc.youngGenCollect();
+
+  Array *const hole0 = dead0;
+  Array *const hole1 = dead1;
+  dead0 = nullptr;
+  dead1 = nullptr;
+  gc.collect();
+
+  auto createLongLived = [&rt](unsigned length) {
+    return new (rt.allocLongLived<HasFinalizer::Yes>(Array::allocSize(length)))
+        Array(&rt.getHeap(), length);
+  };
+
+  // An exact fit takes a whole region, and a smaller allocation leaves a
+  // (parseable) remainder behind.
+  Array *exact = createLongLived(kDeadLength);
+  Array *smaller = createLongLived(1);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&exact));
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&smaller));
+  EXPECT_TRUE(exact == hole0 || exact == hole1);
+  EXPECT_TRUE(smaller == hole0 || smaller == hole1);
+  EXPECT_NE(exact, smaller);
+
+  gc.youngGenCollect();
+  gc.collect();
+  EXPECT_EQ(kDeadLength, exact->length);
+  EXPECT_EQ(1u, smaller->length);
+  for (unsigned i = 0; i < kNumLive; ++i) {
+    EXPECT_EQ(kLargeLength, live[i]->length);
+  }
+}
+
+TEST(GCSweepInPlaceNCTest, SparseSegmentIsCompacted) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kTestGCConfig);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  // A single large array behind many dead ones of the same size.
+  constexpr unsigned kNumDead = 16;
+  std::vector<Array *> dead(kNumDead, nullptr);
+  for (auto &arr : dead) {
+    arr = Array::create(rt, kLargeLength);
+    rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&arr));
+  }
+  Array *live = Array::create(rt, kLargeLength);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&live));
+  gc.youngGenCollect();
+  ASSERT_FALSE(gc.inYoungGen(live));
+
+  Array *const first = dead[0];
+  Array *const before = live;
+  for (auto &arr : dead) {
+    arr = nullptr;
+  }
+  gc.collect();
+
+  EXPECT_NE(before, live);
+  EXPECT_EQ(first, live);
+  EXPECT_EQ(kLargeLength, live->length);
+}
+
+} // namespace
+
+#endif // HERMESVM_GC_NONCONTIG_GENERATIONAL
@@ -146,6 +146,29 @@ TEST_F(HandleTest, MarkTest) {
   ASSERT_EQ(2u, gcScope.getHandleCountDbg());
 }
 
+TEST_F(HandleTest, HandleArrayTest) {
+  GCScope gcScope{runtime};
+  HandleArray<2> handles{runtime};
+  ASSERT_TRUE(handles[0].isUndefined());
+  ASSERT_TRUE(handles[1].isUndefined());
+
+  {
+    GCScopeMarkerRAII marker{gcScope};
+    handles[0] =
+        StringPrimitive::createNoThrow(runtime, "hello").getHermesValue();
+  }
+  // The handles of the array are not allocated in the scope.
+  auto mutableObj = handles.mutableHandle<JSObject>(1);
+  ASSERT_EQ(0u, gcScope.getHandleCountDbg());
+  ASSERT_EQ(nullptr, mutableObj.get());
+
+  // The string is only reachable from the array, which is updated if it moves.
+  runtime->collect();
+  auto str = handles.handle<StringPrimitive>(0);
+  ASSERT_EQ(5u, str->getStringLength());
+  ASSERT_EQ(u'h', StringPrimitive::createStringView(runtime, str)[0]);
+}
+
 /// Make sure that related Handle-s can be assigned.
 TEST_F(HandleTest, ScopedPointerConstructorTest) {
   auto function = runtime->makeHandle<JSFunction>(
@@ -437,6 +437,58 @@ TEST(HeapSnapshotTest, SnapshotTest) {
   // String table is checked by the nodes and edges checks.
 }
 
+TEST(HeapSnapshotTest, EdgesFindNodesOutOfIDOrder) {
+  std::string result("");
+  llvm::raw_string_ostream str(result);
+  {
+    JSONEmitter json(str);
+    HeapSnapshot snap(json);
+    // Each node has an edge to the next one, and the last one to the first.
+    const HeapSnapshot::NodeID ids[] = {10, 4, 7};
+    const auto traverse = [&snap, &ids]() {
+      for (unsigned i = 0; i < 3; ++i) {
+        snap.beginNode();
+        snap.addNamedEdge(
+            HeapSnapshot::EdgeType::Internal, "next", ids[(i + 1) % 3]);
+        snap.endNode(HeapSnapshot::NodeType::Object, "node", ids[i], 8);
+      }
+    };
+    snap.beginSection(HeapSnapshot::Section::Nodes);
+    traverse();
+    snap.endSection(HeapSnapshot::Section::Nodes);
+    snap.beginSection(HeapSnapshot::Section::Edges);
+    traverse();
+    snap.endSection(HeapSnapshot::Section::Edges);
+  }
+  str.flush();
+
+  JSONFactory::Allocator alloc;
+  JSONFactory jsonFactory{alloc};
+  SourceErrorManager sm;
+  JSONParser parser{jsonFactory, result, sm};
+  auto optSnapshot = parser.parse();
+  ASSERT_TRUE(optSnapshot) << "Heap snapshot is not valid JSON";
+  JSONObject *root = llvm::cast<JSONObject>(optSnapshot.getValue());
+  JSONArray &nodes = *llvm::cast<JSONArray>(root->at("nodes"));
+  JSONArray &edges = *llvm::cast<JSONArray>(root->at("edges"));
+  JSONArray &strings = *llvm::cast<JSONArray>(root->at("strings"));
+
+  ASSERT_EQ(nodes.size(), 3 * HeapSnapshot::V8_SNAPSHOT_NODE_FIELD_COUNT);
+  ASSERT_EQ(edges.size(), 3 * HeapSnapshot::V8_SNAPSHOT_EDGE_FIELD_COUNT);
+  auto nextEdge = edges.begin();
+  for (unsigned i = 0; i < 3; ++i) {
+    TEST_EDGE(
+        nextEdge,
+        nodes,
+        strings,
+        HeapSnapshot::EdgeType::Internal,
+        "next",
+        0,
+        (i + 1) % 3);
+    nextEdge += HeapSnapshot::V8_SNAPSHOT_EDGE_FIELD_COUNT;
+  }
+}
+
 } // namespace heapsnapshottest
 } // namespace unittest
 } // namespace hermes
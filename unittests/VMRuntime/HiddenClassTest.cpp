@@ -449,4 +449,102 @@ TEST_F(HiddenClassTest, ForEachProperty) {
   EXPECT_EQ(expectedProperties, propertiesNoAlloc);
 }
 
+TEST_F(HiddenClassTest, TransitionCache) {
+  GCScope gcScope{runtime, "HiddenClassTest.TransitionCache", 48};
+
+  auto rootHnd = runtime->makeHandle<HiddenClass>(
+      runtime->ignoreAllocationFailure(HiddenClass::createRoot(runtime)));
+  auto aHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"a"));
+  auto flags = PropertyFlags::defaultNewNamedPropertyFlags();
+
+  auto addRes = HiddenClass::addProperty(rootHnd, runtime, *aHnd, flags);
+  ASSERT_RETURNED(addRes);
+  auto aClazz = addRes->first;
+
+  // The transition is still found after a collection, which may have moved
+  // both classes.
+  runtime->collect();
+  auto againRes = HiddenClass::addProperty(rootHnd, runtime, *aHnd, flags);
+  ASSERT_RETURNED(againRes);
+  EXPECT_EQ(*aClazz, *againRes->first);
+
+  // Fill the cache with transitions from the same class, whose children die,
+  // so that entries are evicted and dropped.
+  for (unsigned i = 0; i < 2048; ++i) {
+    GCScopeMarkerRAII marker{runtime};
+    std::string name = "p" + std::to_string(i);
+    auto symRes = runtime->getIdentifierTable().getSymbolHandle(
+        runtime, createASCIIRef(name.c_str()));
+    ASSERT_RETURNED(symRes.getStatus());
+    ASSERT_RETURNED(
+        HiddenClass::addProperty(rootHnd, runtime, **symRes, flags)
+            .getStatus());
+  }
+  runtime->collect();
+  auto evictedRes = HiddenClass::addProperty(rootHnd, runtime, *aHnd, flags);
+  ASSERT_RETURNED(evictedRes);
+  EXPECT_EQ(*aClazz, *evictedRes->first);
+  EXPECT_EQ(1u, evictedRes->first->getNumProperties());
+}
+
+TEST_F(HiddenClassTest, SharedPropertyMap) {
+  GCScope gcScope{runtime, "HiddenClassTest.SharedPropertyMap", 64};
+  auto flags = PropertyFlags::defaultNewNamedPropertyFlags();
+  auto symbol = [this](const char *name) {
+    return **runtime->getIdentifierTable().getSymbolHandle(
+        runtime, createASCIIRef(name));
+  };
+
+  // p = {p0, ..., p9}, with two children x = {...p, x} and y = {...p, y}.
+  MutableHandle<HiddenClass> p{
+      runtime,
+      vmcast<HiddenClass>(
+          runtime->ignoreAllocationFailure(HiddenClass::createRoot(runtime)))};
+  for (unsigned i = 0; i < 10; ++i) {
+    std::string name = "p" + std::to_string(i);
+    auto addRes =
+        HiddenClass::addProperty(p, runtime, symbol(name.c_str()), flags);
+    ASSERT_RETURNED(addRes.getStatus());
+    p = *addRes->first;
+  }
+  auto xRes = HiddenClass::addProperty(p, runtime, symbol("x"), flags);
+  ASSERT_RETURNED(xRes.getStatus());
+  auto x = xRes->first;
+  auto yRes = HiddenClass::addProperty(p, runtime, symbol("y"), flags);
+  ASSERT_RETURNED(yRes.getStatus());
+  auto y = yRes->first;
+
+  // No class has a map yet, and p is too far from the root to walk.
+  NamedPropertyDescriptor desc;
+  EXPECT_FALSE(
+      HiddenClass::tryFindPropertyFast(*y, runtime, symbol("p0"), desc)
+          .hasValue());
+
+  // Looking up a property of x creates the map of p, which y shares.
+  ASSERT_TRUE(HiddenClass::findPropertyDescriptor(
+      createPseudoHandle(*x), runtime, symbol("p0"), flags, desc));
+  EXPECT_EQ(0u, desc.slot);
+  auto found =
+      HiddenClass::tryFindPropertyFast(*y, runtime, symbol("p5"), desc);
+  ASSERT_TRUE(found.hasValue() && *found);
+  EXPECT_EQ(5u, desc.slot);
+  found = HiddenClass::tryFindPropertyFast(*y, runtime, symbol("y"), desc);
+  ASSERT_TRUE(found.hasValue() && *found);
+  EXPECT_EQ(10u, desc.slot);
+  found = HiddenClass::tryFindPropertyFast(*y, runtime, symbol("x"), desc);
+  ASSERT_TRUE(found.hasValue());
+  EXPECT_FALSE(*found);
+
+  // The position of a property needs a map of its own, which doesn't take
+  // the map of p from y.
+  ASSERT_TRUE(HiddenClass::findProperty(
+                  createPseudoHandle(*x), runtime, symbol("x"), flags, desc)
+                  .hasValue());
+  EXPECT_EQ(10u, desc.slot);
+  found = HiddenClass::tryFindPropertyFast(*y, runtime, symbol("p9"), desc);
+  ASSERT_TRUE(found.hasValue() && *found);
+  EXPECT_EQ(9u, desc.slot);
+}
+
 } // namespace
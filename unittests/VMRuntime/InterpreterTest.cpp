@@ -211,6 +211,52 @@ TEST_F(InterpreterTest, SimpleSmokeTest) {
   ASSERT_EQ(8.0, status.getValue().getDouble());
 }
 
+TEST_F(InterpreterTest, PropertyCacheAllocatedOnFirstUse) {
+  auto *runtimeModule = RuntimeModule::createUninitialized(runtime, domain);
+
+  /*
+   get_global   reg0
+   get_named    reg1, reg0, "x"
+   ret          reg1
+   */
+
+  StringID xID = 1;
+
+  BytecodeModuleGenerator BMG;
+  auto BFG = BytecodeFunctionGenerator::create(BMG, 2);
+
+  BFG->emitGetGlobalObject(0);
+  BFG->emitGetById(1, 0, 1, xID);
+  BFG->emitRet(1);
+  BFG->setHighestReadCacheIndex(1);
+  BFG->setHighestWriteCacheIndex(0);
+
+  BFG->bytecodeGenerationComplete();
+  auto codeBlock = createCodeBlock(runtimeModule, runtime, BFG.get());
+
+  ASSERT_EQ(detail::mapStringMayAllocate(*runtimeModule, "x"), xID);
+  (void)JSObject::putNamed_RJS(
+      runtime->getGlobal(),
+      runtime,
+      runtimeModule->getSymbolIDFromStringIDMayAllocate(xID),
+      runtime->makeHandle(HermesValue::encodeDoubleValue(5)));
+
+  // Nothing is allocated for the cache until the function reads a property.
+  EXPECT_EQ(0u, codeBlock->additionalMemorySize());
+
+  CallResult<HermesValue> status{ExecutionStatus::EXCEPTION};
+  {
+    ScopedNativeCallFrame frame(
+        runtime, 0, nullptr, false, HermesValue::encodeUndefinedValue());
+    status = runtime->interpretFunction(codeBlock);
+  }
+  ASSERT_EQ(ExecutionStatus::RETURNED, status.getStatus());
+  EXPECT_EQ(5.0, status.getValue().getDouble());
+
+  // Entry 0 stands for no caching, entry 1 is the cache of the get_named.
+  EXPECT_EQ(2 * sizeof(PropertyCacheEntry), codeBlock->additionalMemorySize());
+}
+
 TEST_F(InterpreterTest, IterativeFactorialTest) {
   auto runtimeModule = RuntimeModule::createUninitialized(runtime, domain);
 
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/CodeBudget.h"
+
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/JSObject.h"
+#include "hermes/VM/Runtime.h"
+
+#include "../TestHelpers.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace hermes::vm;
+
+namespace {
+
+/// \return the CodeBlock of the global function \p name.
+CodeBlock *getFunctionCodeBlock(Runtime &runtime, const char *name) {
+  GCScope gcScope{&runtime};
+  auto sym = runtime.getIdentifierTable().getSymbolHandle(
+      &runtime, createASCIIRef(name));
+  EXPECT_EQ(ExecutionStatus::RETURNED, sym);
+  auto propRes =
+      JSObject::getNamed_RJS(runtime.getGlobal(), &runtime, *sym.getValue());
+  EXPECT_EQ(ExecutionStatus::RETURNED, propRes.getStatus());
+  auto *func = dyn_vmcast<JSFunction>(*propRes);
+  return func ? func->getCodeBlock() : nullptr;
+}
+
+/// Fake code of \p size bytes at \p addr, which is never executed.
+JITCompiledCode fakeCode(uint8_t *addr, size_t size) {
+  JITCompiledCode code;
+  code.body = reinterpret_cast<JITCompiledFunctionPtr>(addr);
+  code.blocks = {addr, nullptr};
+  code.size = size;
+  return code;
+}
+
+TEST(CodeBudgetTest, EvictLeastRecentlyUsed) {
+  auto rt = Runtime::create(kTestRTConfigLargeHeap);
+  Runtime &runtime = *rt;
+  hermes::hbc::CompileFlags runFlags;
+  runFlags.optimize = true;
+  (void)runtime.run("function foo() {}\nfunction bar() {}", "", runFlags);
+  CodeBlock *foo = getFunctionCodeBlock(runtime, "foo");
+  CodeBlock *bar = getFunctionCodeBlock(runtime, "bar");
+  ASSERT_TRUE(foo && bar);
+
+  uint8_t fooCode[1], barCode[1];
+  std::vector<ExecHeap::BlockPair> freed;
+  auto release = [&freed](ExecHeap::BlockPair blocks) {
+    freed.push_back(blocks);
+  };
+
+  CodeBudget budget;
+  budget.setLimit(150);
+  for (auto compiled : {std::make_pair(foo, fakeCode(fooCode, 100)),
+                        std::make_pair(bar, fakeCode(barCode, 100))}) {
+    compiled.second.install(compiled.first);
+    budget.add(compiled.first, compiled.second);
+  }
+  EXPECT_EQ(200u, budget.getBytesUsed());
+  EXPECT_TRUE(budget.isOverBudget());
+
+  // Both are marked as used when added; only bar is used again after the
+  // first sweep clears the marks.
+  for (auto *codeBlock : {foo, bar})
+    codeBlock->testAndClearJITUsed();
+  bar->markJITUsed();
+  budget.evict(&runtime, release);
+
+  EXPECT_FALSE(budget.isOverBudget());
+  EXPECT_EQ(100u, budget.getBytesUsed());
+  EXPECT_EQ(100u, budget.getBytesFreed());
+  EXPECT_EQ(1u, budget.getNumEvicted());
+  ASSERT_EQ(1u, freed.size());
+  EXPECT_EQ(fooCode, freed[0].first);
+  EXPECT_EQ(nullptr, foo->getJITCompiled());
+  EXPECT_NE(nullptr, bar->getJITCompiled());
+
+  // Destroying the module frees the rest, without counting as an eviction.
+  budget.remove(bar->getRuntimeModule(), release);
+  EXPECT_EQ(0u, budget.getBytesUsed());
+  EXPECT_EQ(200u, budget.getBytesFreed());
+  EXPECT_EQ(1u, budget.getNumEvicted());
+  ASSERT_EQ(2u, freed.size());
+  EXPECT_EQ(barCode, freed[1].first);
+}
+
+TEST(CodeBudgetTest, Unlimited) {
+  CodeBudget budget;
+  EXPECT_EQ(0u, budget.getLimit());
+  EXPECT_FALSE(budget.isOverBudget());
+}
+
+} // namespace
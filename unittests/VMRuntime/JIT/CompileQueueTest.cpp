@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/CompileQueue.h"
+
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/JSObject.h"
+#include "hermes/VM/Runtime.h"
+
+#include "../TestHelpers.h"
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+/// Install the finished code the way the JITContext does, without accounting.
+void installCode(CodeBlock *codeBlock, const JITCompiledCode &code) {
+  code.install(codeBlock);
+}
+
+/// A release function for queues whose compilations never produce code.
+void releaseNothing(ExecHeap::BlockPair) {}
+
+/// Run \p source and return the CodeBlock of the global function foo it
+/// defines.
+CodeBlock *getFunctionCodeBlock(Runtime &runtime, const char *source) {
+  hermes::hbc::CompileFlags runFlags;
+  runFlags.optimize = true;
+  (void)runtime.run(source, "", runFlags);
+
+  GCScope gcScope{&runtime};
+  auto sym = runtime.getIdentifierTable().getSymbolHandle(
+      &runtime, createASCIIRef("foo"));
+  EXPECT_EQ(ExecutionStatus::RETURNED, sym);
+  auto propRes =
+      JSObject::getNamed_RJS(runtime.getGlobal(), &runtime, *sym.getValue());
+  EXPECT_EQ(ExecutionStatus::RETURNED, propRes.getStatus());
+  auto *func = dyn_vmcast<JSFunction>(*propRes);
+  return func ? func->getCodeBlock() : nullptr;
+}
+
+TEST(CompileQueueTest, InstallAtBoundary) {
+  auto rt = Runtime::create(kTestRTConfigLargeHeap);
+  Runtime &runtime = *rt;
+  CodeBlock *cb = getFunctionCodeBlock(
+      runtime,
+      "function foo(x) { function bar() { return x; } return bar; }\n"
+      "foo(1);");
+  ASSERT_TRUE(cb);
+
+  std::atomic<unsigned> compilations{0};
+  CompileQueue queue(
+      [&compilations](CodeBlock *) {
+        ++compilations;
+        // A failed compilation, which is installed as "don't JIT".
+        return JITCompiledCode{};
+      },
+      releaseNothing);
+
+  EXPECT_FALSE(cb->getDontJIT());
+  queue.enqueue(cb);
+  // Enqueueing again while the first compilation is pending is a no-op.
+  queue.enqueue(cb);
+  queue.waitUntilIdle();
+  EXPECT_EQ(1u, compilations);
+
+  // Nothing changes until the result is installed.
+  EXPECT_FALSE(cb->getDontJIT());
+  queue.installFinished(installCode);
+  EXPECT_TRUE(cb->getDontJIT());
+}
+
+TEST(CompileQueueTest, Cancel) {
+  auto rt = Runtime::create(kTestRTConfigLargeHeap);
+  Runtime &runtime = *rt;
+  CodeBlock *cb = getFunctionCodeBlock(runtime, "function foo() {}\nfoo();");
+  ASSERT_TRUE(cb);
+
+  CompileQueue queue(
+      [](CodeBlock *) { return JITCompiledCode{}; }, releaseNothing);
+  queue.enqueue(cb);
+  queue.cancel(cb->getRuntimeModule());
+  queue.waitUntilIdle();
+  queue.installFinished(installCode);
+  EXPECT_FALSE(cb->getDontJIT());
+}
+
+} // namespace
@@ -57,10 +57,15 @@ TEST(DiscoverBBTest, SmokeTest) {
 
   std::vector<uint32_t> basicBlocks;
   llvm::DenseMap<uint32_t, unsigned> labels;
+  std::vector<unsigned> loopHeaders;
 
-  discoverBasicBlocks(cb, basicBlocks, labels);
+  discoverBasicBlocks(cb, basicBlocks, labels, loopHeaders);
   EXPECT_EQ(6, basicBlocks.size());
   EXPECT_EQ(6, labels.size());
+  // Both loops are closed by a backward branch to their header.
+  ASSERT_EQ(2, loopHeaders.size());
+  EXPECT_LT(loopHeaders[0], loopHeaders[1]);
+  EXPECT_LT(0u, loopHeaders[0]);
 }
 
 } // namespace
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/JITPerfMap.h"
+
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/JSObject.h"
+#include "hermes/VM/Runtime.h"
+
+#include "../TestHelpers.h"
+#include "gtest/gtest.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <cstring>
+
+using namespace hermes::vm;
+
+namespace {
+
+/// \return the CodeBlock of the global function \p name.
+CodeBlock *getFunctionCodeBlock(Runtime &runtime, const char *name) {
+  GCScope gcScope{&runtime};
+  auto sym = runtime.getIdentifierTable().getSymbolHandle(
+      &runtime, createASCIIRef(name));
+  EXPECT_EQ(ExecutionStatus::RETURNED, sym);
+  auto propRes =
+      JSObject::getNamed_RJS(runtime.getGlobal(), &runtime, *sym.getValue());
+  EXPECT_EQ(ExecutionStatus::RETURNED, propRes.getStatus());
+  auto *func = dyn_vmcast<JSFunction>(*propRes);
+  return func ? func->getCodeBlock() : nullptr;
+}
+
+TEST(JITPerfMapTest, DescribeCode) {
+  auto rt = Runtime::create(kTestRTConfigLargeHeap);
+  Runtime &runtime = *rt;
+  hermes::hbc::CompileFlags runFlags;
+  runFlags.optimize = true;
+  (void)runtime.run("function foo() {\n  return 1;\n}", "test.js", runFlags);
+  CodeBlock *foo = getFunctionCodeBlock(runtime, "foo");
+  ASSERT_TRUE(foo);
+
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("jitperfmap", dir));
+
+  // Fake code, which is never executed.
+  uint8_t fastCode[16] = {1, 2, 3}, slowCode[8] = {4, 5, 6};
+  JITCompiledCode code;
+  code.body = reinterpret_cast<JITCompiledFunctionPtr>(fastCode);
+  code.blocks = {fastCode, slowCode};
+  code.codeSizes = {sizeof(fastCode), sizeof(slowCode)};
+  code.lineTable = {{0, 0}};
+
+  std::string mapPath, dumpPath;
+  {
+    JITPerfMap perfMap{dir};
+    mapPath = perfMap.getMapPath();
+    dumpPath = perfMap.getDumpPath();
+    perfMap.add(foo, code);
+  }
+
+  auto map = llvm::MemoryBuffer::getFile(mapPath);
+  ASSERT_TRUE(bool(map));
+  llvm::SmallVector<llvm::StringRef, 2> lines;
+  (*map)->getBuffer().split(lines, '\n', -1, false);
+  ASSERT_EQ(2u, lines.size());
+  std::string fastPrefix;
+  llvm::raw_string_ostream(fastPrefix)
+      << llvm::format_hex_no_prefix((uintptr_t)fastCode, 1) << " 10 JS:foo";
+  EXPECT_TRUE(lines[0].startswith(fastPrefix)) << lines[0].str();
+  EXPECT_TRUE(lines[1].endswith(" [slow path]")) << lines[1].str();
+
+  auto dump = llvm::MemoryBuffer::getFile(dumpPath);
+  ASSERT_TRUE(bool(dump));
+  llvm::StringRef data = (*dump)->getBuffer();
+  ASSERT_LE(40u, data.size());
+  uint32_t magic;
+  memcpy(&magic, data.data(), sizeof(magic));
+  EXPECT_EQ(0x4A695444u, magic);
+
+  // Walk the records after the header: a JIT_CODE_LOAD per block, each with
+  // a copy of the code, preceded by the source lines of the first one.
+  unsigned numLoads = 0;
+  for (size_t offset = 40; offset < data.size();) {
+    uint32_t id, totalSize;
+    memcpy(&id, data.data() + offset, sizeof(id));
+    memcpy(&totalSize, data.data() + offset + 4, sizeof(totalSize));
+    ASSERT_LE(offset + totalSize, data.size());
+    if (id == 0) {
+      bool fast = numLoads++ == 0;
+      const uint8_t *expected = fast ? fastCode : slowCode;
+      size_t codeSize = fast ? sizeof(fastCode) : sizeof(slowCode);
+      EXPECT_EQ(
+          0,
+          memcmp(
+              data.data() + offset + totalSize - codeSize,
+              expected,
+              codeSize));
+    } else {
+      EXPECT_EQ(2u, id);
+      EXPECT_EQ(0u, numLoads);
+    }
+    offset += totalSize;
+  }
+  EXPECT_EQ(2u, numLoads);
+
+  llvm::sys::fs::remove(mapPath);
+  llvm::sys::fs::remove(dumpPath);
+  llvm::sys::fs::remove(dir);
+}
+
+} // namespace
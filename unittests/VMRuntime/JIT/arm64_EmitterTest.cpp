@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/NativeDisassembler.h"
+#include "hermes/VM/JIT/arm64/Emitter.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+using namespace hermes::vm::arm64;
+
+namespace {
+// The LLVM used for disassembly is only required to support the host target.
+#if defined(HERMESVM_JIT_DISASSEMBLER) && defined(__aarch64__)
+
+TEST(arm64_EmitterTest, Test) {
+  alignas(4) uint8_t buf[16384];
+  Emitter emitter{buf};
+
+  std::string str;
+  llvm::raw_string_ostream OS{str};
+  auto dis =
+      NativeDisassembler::create(NativeDisassembler::aarch64_unknown_linux_gnu);
+
+  auto trim = [](std::string str) {
+    // Strip the address
+    if (str.compare(0, 6, "00000:") == 0)
+      str.erase(0, 6);
+    // Strip leading spaces
+    while (!str.empty() && isspace(str.front()))
+      str.erase(0, 1);
+
+    // Skip trailing comment
+    auto com = str.rfind("//");
+    if (com != std::string::npos)
+      str.erase(com);
+
+    while (!str.empty() && isspace(str.back()))
+      str.pop_back();
+    for (char &ch : str)
+      if (ch == '\t')
+        ch = ' ';
+    return str;
+  };
+
+#define CHECK(expected)                                         \
+  str.clear();                                                  \
+  dis->disassembleBuffer(                                       \
+      OS, llvm::makeArrayRef(buf, emitter.current()), 0, true); \
+  emitter = Emitter{buf};                                       \
+  EXPECT_STREQ(expected, trim(OS.str()).c_str())
+
+  emitter.movImm(0x1234, Reg::x1);
+  CHECK("81 46 82 d2                   mov x1, #4660");
+  emitter.movImm(0xfff9000000000000ull, Reg::x2);
+  CHECK("22 ff ff d2                   mov x2, #-1970324836974592");
+  emitter.movImm(-24, Reg::x17);
+  CHECK("f1 02 80 92                   mov x17, #-24");
+  emitter.movRegToReg(Reg::x19, Reg::x0);
+  CHECK("e0 03 13 aa                   mov x0, x19");
+  emitter.addImm(Reg::sp, 0, Reg::fp);
+  CHECK("fd 03 00 91                   mov x29, sp");
+  emitter.subImm(Reg::x20, 40, Reg::x1);
+  CHECK("81 a2 00 d1                   sub x1, x20, #40");
+  emitter.addReg(Reg::x20, Reg::x17, Reg::x2);
+  CHECK("82 02 11 8b                   add x2, x20, x17");
+  emitter.orrReg(Reg::x9, Reg::x10, Reg::x9);
+  CHECK("29 01 0a aa                   orr x9, x9, x10");
+  emitter.eorOne(Reg::x1, Reg::x1);
+  CHECK("21 00 40 d2                   eor x1, x1, #0x1");
+  emitter.lsrImm(Reg::x9, 32, Reg::x10);
+  CHECK("2a fd 60 d3                   lsr x10, x9, #32");
+  emitter.cmpReg(Reg::x9, Reg::x10);
+  CHECK("3f 01 0a eb                   cmp x9, x10");
+  emitter.cmpRegW(Reg::x10, Reg::x11);
+  CHECK("5f 01 0b 6b                   cmp w10, w11");
+  emitter.cmpImmW(Reg::x0, 0);
+  CHECK("1f 00 00 71                   cmp w0, #0");
+  emitter.tstByte(Reg::x0);
+  CHECK("1f 1c 00 72                   tst w0, #0xff");
+  emitter.cset(Cond::MI, Reg::x9);
+  CHECK("e9 57 9f 1a                   cset w9, mi");
+  emitter.ldr(Reg::x20, -24, Reg::x9);
+  CHECK("89 82 5e f8                   ldur x9, [x20, #-24]");
+  emitter.ldr(Reg::x19, 32, Reg::x1);
+  CHECK("61 12 40 f9                   ldr x1, [x19, #32]");
+  emitter.str(Reg::x9, Reg::x20, -24);
+  CHECK("89 82 1e f8                   stur x9, [x20, #-24]");
+  emitter.ldrW(Reg::x20, 24, Reg::x10);
+  CHECK("8a 1a 40 b9                   ldr w10, [x20, #24]");
+  emitter.ldrb(Reg::x19, 1234, Reg::x9);
+  CHECK("69 4a 53 39                   ldrb w9, [x19, #1234]");
+  emitter.ldrD(Reg::x20, -32, FReg::d0);
+  CHECK("80 02 5e fc                   ldur d0, [x20, #-32]");
+  emitter.strD(FReg::d0, Reg::x20, -40);
+  CHECK("80 82 1d fc                   stur d0, [x20, #-40]");
+  emitter.strPre(Reg::x9, Reg::x11, -8);
+  CHECK("69 8d 1f f8                   str x9, [x11, #-8]!");
+  emitter.stpPre(Reg::fp, Reg::lr, Reg::sp, -48);
+  CHECK("fd 7b bd a9                   stp x29, x30, [sp, #-48]!");
+  emitter.stp(Reg::x19, Reg::x20, Reg::sp, 16);
+  CHECK("f3 53 01 a9                   stp x19, x20, [sp, #16]");
+  emitter.ldp(Reg::sp, 16, Reg::x19, Reg::x20);
+  CHECK("f3 53 41 a9                   ldp x19, x20, [sp, #16]");
+  emitter.ldpPost(Reg::sp, 48, Reg::fp, Reg::lr);
+  CHECK("fd 7b c3 a8                   ldp x29, x30, [sp], #48");
+  emitter.fadd(FReg::d0, FReg::d1, FReg::d0);
+  CHECK("00 28 61 1e                   fadd d0, d0, d1");
+  emitter.fdiv(FReg::d0, FReg::d1, FReg::d0);
+  CHECK("00 18 61 1e                   fdiv d0, d0, d1");
+  emitter.fcmp(FReg::d0, FReg::d1);
+  CHECK("00 20 61 1e                   fcmp d0, d1");
+  emitter.b(buf + 16);
+  CHECK("04 00 00 14                   b #16");
+  emitter.bcond(Cond::NE, buf + 8);
+  CHECK("41 00 00 54                   b.ne #8");
+  emitter.blr(Reg::x16);
+  CHECK("00 02 3f d6                   blr x16");
+  emitter.ret();
+  CHECK("c0 03 5f d6                   ret");
+
+  // Sequences of more than one instruction.
+  emitter.movImm(0x123456789abcdef0ull, Reg::x4);
+  EXPECT_EQ(16, emitter.current() - buf);
+  emitter = Emitter{buf};
+  emitter.ldr(Reg::x20, -40000, Reg::x0);
+  EXPECT_EQ(8, emitter.current() - buf);
+}
+
+#endif
+
+} // namespace
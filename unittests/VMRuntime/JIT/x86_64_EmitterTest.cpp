@@ -291,6 +291,15 @@ TEST(x86_64_EmitterTest, Test) {
   emitter.cmpImmToRM<S::SLQ, ScaleRegAccess>(300, Reg::rax, Reg::NoIndex, 0);
   CHECK("48 3d 2c 01 00 00             cmpq $300, %rax");
 
+  emitter.cmpRmToReg<S::B>(Reg::rbx, Reg::NoIndex, 0, Reg::al);
+  CHECK("3a 03                         cmpb (%rbx), %al");
+  emitter.cmpRmToReg<S::W>(Reg::rbx, Reg::NoIndex, 0, Reg::ax);
+  CHECK("66 3b 03                      cmpw (%rbx), %ax");
+  emitter.cmpRmToReg<S::L>(Reg::rbx, Reg::NoIndex, 0, Reg::eax);
+  CHECK("3b 03                         cmpl (%rbx), %eax");
+  emitter.cmpRmToReg<S::Q>(Reg::rbx, Reg::NoIndex, 16, Reg::rax);
+  CHECK("48 3b 43 10                   cmpq 16(%rbx), %rax");
+
   emitter.testImmToRM<S::B, ScaleRegAccess>(-1, Reg::al, Reg::NoIndex, 0);
   CHECK("a8 ff                         testb $-1, %al");
   emitter.testImmToRM<S::W, ScaleRegAccess>(300, Reg::ax, Reg::NoIndex, 0);
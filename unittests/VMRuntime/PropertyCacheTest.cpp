@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/PropertyCache.h"
+
+#include "hermes/VM/PointerBase-inline.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+using State = PropertyCacheEntry::State;
+
+/// \return a distinct, non-null class value for the cache to hold.  The cache
+/// never dereferences the classes it holds, so these need not be real.
+PropertyCacheEntry::ClassStorageType fakeClass(uint32_t n) {
+#ifdef HERMESVM_COMPRESSED_POINTERS
+  return BasedPointer::fromRawValue(n * 8);
+#else
+  return reinterpret_cast<void *>(static_cast<uintptr_t>(n) * 8);
+#endif
+}
+
+TEST(PropertyCacheTest, Monomorphic) {
+  PropertyCacheEntry entry;
+  SlotIndex slot;
+  EXPECT_EQ(State::Uninitialized, entry.getState());
+  EXPECT_FALSE(entry.find(fakeClass(1), slot));
+
+  entry.update(fakeClass(1), 3);
+  EXPECT_EQ(State::Monomorphic, entry.getState());
+  EXPECT_EQ(fakeClass(1), entry.clazz);
+  ASSERT_TRUE(entry.find(fakeClass(1), slot));
+  EXPECT_EQ(3u, slot);
+  EXPECT_FALSE(entry.findPolymorphic(fakeClass(1), slot));
+
+  // Updating the same class changes its slot, not the state.
+  entry.update(fakeClass(1), 5);
+  EXPECT_EQ(State::Monomorphic, entry.getState());
+  EXPECT_EQ(5u, entry.slot);
+}
+
+TEST(PropertyCacheTest, Polymorphic) {
+  PropertyCacheEntry entry;
+  SlotIndex slot;
+  for (uint32_t i = 1; i <= PropertyCacheEntry::kNumWays; ++i) {
+    entry.update(fakeClass(i), i * 10);
+  }
+  EXPECT_EQ(State::Polymorphic, entry.getState());
+  // The first class seen stays where the fast paths look first.
+  EXPECT_EQ(fakeClass(1), entry.clazz);
+  for (uint32_t i = 1; i <= PropertyCacheEntry::kNumWays; ++i) {
+    ASSERT_TRUE(entry.find(fakeClass(i), slot)) << i;
+    EXPECT_EQ(i * 10, slot);
+    EXPECT_EQ(i != 1, entry.findPolymorphic(fakeClass(i), slot)) << i;
+  }
+  EXPECT_FALSE(entry.find(fakeClass(PropertyCacheEntry::kNumWays + 1), slot));
+
+  // A way whose class was collected is reused.
+  entry.polyClazz[0] = PropertyCacheEntry::ClassStorageType{};
+  entry.update(fakeClass(100), 7);
+  EXPECT_EQ(State::Polymorphic, entry.getState());
+  ASSERT_TRUE(entry.findPolymorphic(fakeClass(100), slot));
+  EXPECT_EQ(7u, slot);
+}
+
+TEST(PropertyCacheTest, Megamorphic) {
+  PropertyCacheEntry entry;
+  SlotIndex slot;
+  for (uint32_t i = 1; i <= PropertyCacheEntry::kNumWays + 1; ++i) {
+    entry.update(fakeClass(i), i);
+  }
+  EXPECT_EQ(State::Megamorphic, entry.getState());
+  // Only the most recent class is cached.
+  ASSERT_TRUE(entry.find(fakeClass(PropertyCacheEntry::kNumWays + 1), slot));
+  EXPECT_EQ(PropertyCacheEntry::kNumWays + 1, slot);
+  for (uint32_t i = 1; i <= PropertyCacheEntry::kNumWays; ++i) {
+    EXPECT_FALSE(entry.find(fakeClass(i), slot)) << i;
+  }
+
+  // A megamorphic entry keeps replacing its one class.
+  entry.update(fakeClass(1), 1);
+  EXPECT_EQ(State::Megamorphic, entry.getState());
+  EXPECT_TRUE(entry.find(fakeClass(1), slot));
+  EXPECT_FALSE(entry.find(fakeClass(PropertyCacheEntry::kNumWays + 1), slot));
+}
+
+} // namespace
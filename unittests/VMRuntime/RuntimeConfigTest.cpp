@@ -30,4 +30,20 @@ TEST(RuntimeTest, configRegisterCountOverflow) {
       "RuntimeConfig maxNumRegisters too big");
 }
 
+TEST(RuntimeTest, registerStackReserve) {
+  auto rt = Runtime::create(
+      RuntimeConfig::Builder().withMaxNumRegisters(1024).build());
+  uint32_t avail = rt->availableStackSize();
+  EXPECT_TRUE(rt->checkAvailableStack(avail - STACK_RESERVE));
+  EXPECT_FALSE(rt->checkAvailableStack(avail - STACK_RESERVE + 1));
+  EXPECT_FALSE(rt->checkAvailableStack(UINT32_MAX));
+
+  // Unchecked allocations may dip into the reserve, after which nothing else
+  // can be allocated.
+  rt->allocUninitializedStack(avail - 1);
+  EXPECT_FALSE(rt->checkAvailableStack(0));
+  rt->popStack(avail - 1);
+  EXPECT_TRUE(rt->checkAvailableStack(avail - STACK_RESERVE));
+}
+
 } // anonymous namespace
@@ -16,6 +16,8 @@
 
 #include "llvm/ADT/STLExtras.h"
 
+#include <vector>
+
 using namespace hermes;
 using namespace hermes::vm;
 
@@ -206,6 +208,119 @@ TEST(StorageProviderTest, WithExcess) {
   // A request for a second storage *can* fail, but is not required to.
 }
 
+TEST(StorageProviderTest, HugePagesFallBack) {
+  // Whether or not huge pages are configured on this machine, storages are
+  // allocated, aligned, and usable.
+  for (HugePagesMode mode : {kHugePagesTransparent, kHugePagesExplicit}) {
+    std::shared_ptr<StorageProvider> provider{
+        StorageProvider::mmapProvider(mode)};
+    for (size_t i = 0; i < 3; ++i) {
+      auto result = provider->newStorage("HugePages");
+      ASSERT_TRUE(result);
+      StorageGuard storage{provider, result.get()};
+      EXPECT_EQ(
+          0u,
+          reinterpret_cast<uintptr_t>(storage.raw()) %
+              AlignedStorage::size());
+      char *mem = static_cast<char *>(storage.raw());
+      mem[0] = 1;
+      mem[AlignedStorage::size() - 1] = 1;
+    }
+  }
+}
+
+/// Restores the default configuration of the storage pool, and empties it, on
+/// scope exit.
+class StoragePoolGuard final {
+ public:
+  StoragePoolGuard() {
+    StorageProvider::drainStoragePool();
+  }
+  ~StoragePoolGuard() {
+    StorageProvider::configureStoragePool(
+        StorageProvider::kDefaultStoragePoolMaxBytes);
+    StorageProvider::drainStoragePool();
+  }
+};
+
+TEST(StorageProviderTest, PooledStorageIsReusedAcrossProviders) {
+  StoragePoolGuard guard;
+  StorageProvider::configureStoragePool(2 * AlignedStorage::size());
+
+  void *first;
+  {
+    auto provider = StorageProvider::pooledProvider();
+    auto result = provider->newStorage("Pooled");
+    ASSERT_TRUE(result);
+    first = result.get();
+    static_cast<char *>(first)[0] = 42;
+    provider->deleteStorage(first);
+  }
+  EXPECT_EQ(AlignedStorage::size(), StorageProvider::storagePoolBytes());
+
+  // A provider created after the first is gone gets its storage back, as it
+  // was left.
+  auto provider = StorageProvider::pooledProvider();
+  auto result = provider->newStorage("Pooled");
+  ASSERT_TRUE(result);
+  EXPECT_EQ(first, result.get());
+  EXPECT_EQ(42, static_cast<char *>(result.get())[0]);
+  EXPECT_EQ(0u, StorageProvider::storagePoolBytes());
+  provider->deleteStorage(result.get());
+}
+
+TEST(StorageProviderTest, PooledStorageRetentionCap) {
+  StoragePoolGuard guard;
+  StorageProvider::configureStoragePool(2 * AlignedStorage::size());
+
+  auto provider = StorageProvider::pooledProvider();
+  std::vector<void *> storages;
+  for (size_t i = 0; i < 3; ++i) {
+    auto result = provider->newStorage();
+    ASSERT_TRUE(result);
+    storages.push_back(result.get());
+  }
+  for (void *storage : storages) {
+    provider->deleteStorage(storage);
+  }
+  // The storage beyond the cap was unmapped.
+  EXPECT_EQ(2 * AlignedStorage::size(), StorageProvider::storagePoolBytes());
+
+  // Lowering the cap releases the excess.
+  StorageProvider::configureStoragePool(AlignedStorage::size());
+  EXPECT_EQ(AlignedStorage::size(), StorageProvider::storagePoolBytes());
+
+  EXPECT_EQ(AlignedStorage::size(), StorageProvider::drainStoragePool());
+  EXPECT_EQ(0u, StorageProvider::storagePoolBytes());
+}
+
+TEST(StorageProviderTest, PooledStorageZeroing) {
+  StoragePoolGuard guard;
+  auto provider = StorageProvider::pooledProvider();
+  for (auto zeroing :
+       {StoragePoolZeroing::Eager,
+#ifdef __linux__
+        // Only Linux guarantees that released pages read back as zero.
+        StoragePoolZeroing::Release
+#endif
+       }) {
+    StorageProvider::configureStoragePool(AlignedStorage::size(), zeroing);
+    auto result = provider->newStorage();
+    ASSERT_TRUE(result);
+    char *mem = static_cast<char *>(result.get());
+    mem[0] = 1;
+    mem[AlignedStorage::size() - 1] = 1;
+    provider->deleteStorage(mem);
+
+    result = provider->newStorage();
+    ASSERT_TRUE(result);
+    EXPECT_EQ(mem, result.get());
+    EXPECT_EQ(0, mem[0]);
+    EXPECT_EQ(0, mem[AlignedStorage::size() - 1]);
+    provider->deleteStorage(mem);
+  }
+}
+
 #ifndef NDEBUG
 
 class SetVALimit final {
@@ -324,4 +324,86 @@ TEST_F(StringPrimTest, FastConcatTest) {
   EXPECT_TRUE(utf16Ref.size() == utfStr3.size());
   EXPECT_TRUE(std::equal(utfStr3.begin(), utfStr3.end(), utf16Ref.begin()));
 }
+
+TEST_F(StringPrimTest, ConcatNewBufferTest) {
+  CallResult<HermesValue> cr{ExecutionStatus::EXCEPTION};
+  std::string bigStrA(BufferedASCIIStringPrimitive::NEW_BUFFER_MIN_SIZE, 'a');
+  std::string strB(1000, 'b');
+
+  auto a = StringPrimitive::createNoThrow(runtime, bigStrA);
+  auto b = StringPrimitive::createNoThrow(runtime, strB);
+  cr = StringPrimitive::concat(runtime, a, b);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  auto first = runtime->makeHandle<BufferedASCIIStringPrimitive>(*cr);
+
+  // Append until the buffer of the first stage overflows.
+  MutableHandle<StringPrimitive> last{runtime, first.get()};
+  std::string expected = bigStrA + strB;
+  for (unsigned i = 0; i < 1000 &&
+       vmcast<BufferedASCIIStringPrimitive>(last.get())
+               ->testGetConcatBuffer() == first->testGetConcatBuffer();
+       ++i) {
+    cr = StringPrimitive::concat(runtime, last, b);
+    ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+    last = vmcast<StringPrimitive>(*cr);
+    expected += strB;
+  }
+
+  // The first stage doesn't keep the new buffer alive, and every stage still
+  // has its own contents.
+  EXPECT_NE(
+      first->testGetConcatBuffer(),
+      vmcast<BufferedASCIIStringPrimitive>(last.get())->testGetConcatBuffer());
+  EXPECT_EQ(bigStrA.size() + strB.size(), first->getStringLength());
+  auto ref = last->getStringRef<char>();
+  ASSERT_EQ(expected.size(), ref.size());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), ref.begin()));
+}
+
+TEST_F(StringPrimTest, SliceSharedBufferTest) {
+  CallResult<HermesValue> cr{ExecutionStatus::EXCEPTION};
+  std::string bigStr;
+  for (uint32_t i = 0; i < StringPrimitive::EXTERNAL_STRING_THRESHOLD; ++i)
+    bigStr.push_back('a' + i % 26);
+  auto big = StringPrimitive::createNoThrow(runtime, bigStr);
+  ASSERT_TRUE(vmisa<ExternalASCIIStringPrimitive>(big.get()));
+
+  // A long slice shares the characters of the string.
+  uint32_t start = 1000;
+  uint32_t length = bigStr.size() - start;
+  cr = StringPrimitive::slice(runtime, big, start, length);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  auto tail = runtime->makeHandle<BufferedASCIIStringPrimitive>(*cr);
+  EXPECT_EQ(big.get(), tail->testGetConcatBuffer());
+  auto ref = tail->getStringRef<char>();
+  ASSERT_EQ(length, ref.size());
+  EXPECT_TRUE(std::equal(ref.begin(), ref.end(), bigStr.begin() + start));
+
+  // And so does a slice of the slice.
+  cr = StringPrimitive::slice(runtime, tail, 10, length - 10);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  auto tail2 = runtime->makeHandle<BufferedASCIIStringPrimitive>(*cr);
+  EXPECT_EQ(big.get(), tail2->testGetConcatBuffer());
+  ref = tail2->getStringRef<char>();
+  EXPECT_TRUE(std::equal(ref.begin(), ref.end(), bigStr.begin() + start + 10));
+
+  // A short slice is copied.
+  cr = StringPrimitive::slice(runtime, big, start, 300);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  EXPECT_FALSE(vmisa<BufferedASCIIStringPrimitive>(*cr));
+
+  // Appending to the slice leaves the string and the other slice unchanged.
+  auto b = StringPrimitive::createNoThrow(runtime, "small");
+  cr = StringPrimitive::concat(runtime, tail, b);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  auto appended = runtime->makeHandle<StringPrimitive>(*cr);
+  std::string expected = bigStr.substr(start) + "small";
+  ref = appended->getStringRef<char>();
+  ASSERT_EQ(expected.size(), ref.size());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), ref.begin()));
+  EXPECT_EQ(bigStr.size(), big->getStringLength());
+  ref = big->getStringRef<char>();
+  EXPECT_TRUE(std::equal(bigStr.begin(), bigStr.end(), ref.begin()));
+  EXPECT_EQ(length - 10, tail2->getStringLength());
+}
 } // namespace
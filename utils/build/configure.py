@@ -28,6 +28,9 @@ def parse_args():
     parser.add_argument("--icu", type=str, dest="icu_root", default="")
     parser.add_argument("--fbsource", type=str, dest="fbsource_dir", default="")
     parser.add_argument("--opcode-stats", dest="opcode_stats", action="store_true")
+    parser.add_argument(
+        "--tail-call-dispatch", dest="tail_call_dispatch", action="store_true"
+    )
     parser.add_argument(
         "--basic-block-profiler", dest="basic_block_profiler", action="store_true"
     )
@@ -99,6 +102,8 @@ def main():
         cmake_flags += ["-DLLVM_USE_SANITIZER=Address"]
     if args.opcode_stats:
         cmake_flags += ["-DHERMESVM_PROFILER_OPCODE=On"]
+    if args.tail_call_dispatch:
+        cmake_flags += ["-DHERMESVM_TAIL_CALL_DISPATCH=On"]
     if args.basic_block_profiler:
         cmake_flags += ["-DHERMESVM_PROFILER_BB=On"]
     if args.warnings_as_errors:
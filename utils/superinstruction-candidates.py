@@ -0,0 +1,107 @@
+#!/usr/bin/env python
+# Copyright (c) Facebook, Inc. and its affiliates.
+#
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+"""
+Rank the opcode pairs recorded by a Hermes build with HERMESVM_PROFILER_OPCODE
+as candidates for fused superinstructions.
+
+Usage: superinstruction-candidates.py [-n COUNT] STATS_FILE...
+
+Each STATS_FILE is the output of Runtime::dumpOpcodeStats(), e.g. from running
+`hermes` on a benchmark. The pair frequencies of all the files are summed, pairs
+that can't be fused are dropped, and the rest are printed with their share of
+all the executed pairs. Since each dump only lists its most frequent pairs, the
+shares are of the listed pairs. Pairs the compiler already fuses are marked
+with the fused instruction, and only show up in profiles of bytecode compiled
+without -bytecode-peephole.
+"""
+
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+import argparse
+import collections
+import sys
+
+
+PAIRS_HEADER = "Opcode pairs sorted by frequency:"
+
+# Opcodes whose successor in the profile is not the next instruction in the
+# bytecode, so they can't start a superinstruction.
+NON_FALLTHROUGH_PREFIXES = ("J", "Ret", "Throw", "Switch")
+
+# Pairs which the compiler already fuses into one instruction with
+# -bytecode-peephole, and the fused instruction.
+FUSED_PAIRS = {
+    ("GetEnvironment", "LoadFromEnvironment"): "GetEnvironmentAndLoad",
+    ("GetEnvironment", "StoreToEnvironment"): "GetEnvironmentAndStore",
+    ("GetEnvironment", "StoreNPToEnvironment"): "GetEnvironmentAndStoreNP",
+}
+
+
+def loadPairs(filename, counts):
+    """
+    Add the opcode pair frequencies in the stats dump \p filename to counts.
+    """
+    inPairs = False
+    with open(filename) as f:
+        for line in f:
+            if line.startswith(PAIRS_HEADER):
+                inPairs = True
+                continue
+            if not inPairs or line.startswith("=="):
+                continue
+            toks = line.split()
+            if len(toks) != 3:
+                # The end of the section.
+                inPairs = False
+                continue
+            counts[(toks[0], toks[1])] += int(toks[2])
+
+
+def isFusable(pair):
+    return not pair[0].startswith(NON_FALLTHROUGH_PREFIXES)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Rank opcode pairs as superinstruction candidates."
+    )
+    parser.add_argument("-n", type=int, default=20, help="pairs to print")
+    parser.add_argument("files", nargs="+", help="opcode stats dumps")
+    args = parser.parse_args()
+
+    counts = collections.Counter()
+    for filename in args.files:
+        loadPairs(filename, counts)
+    if not counts:
+        print("No opcode pairs found; was the profiler enabled?")
+        return 1
+
+    total = sum(counts.values())
+    candidates = [
+        (pair, count) for pair, count in counts.most_common() if isFusable(pair)
+    ]
+    cumulative = 0
+    print(
+        "%-40s %12s %8s %8s  %s" % ("Pair", "Frequency", "Share", "Total", "Fused")
+    )
+    for pair, count in candidates[: args.n]:
+        cumulative += count
+        print(
+            "%-40s %12d %7.2f%% %7.2f%%  %s"
+            % (
+                pair[0] + "+" + pair[1],
+                count,
+                100.0 * count / total,
+                100.0 * cumulative / total,
+                FUSED_PAIRS.get(pair, ""),
+            )
+        )
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())